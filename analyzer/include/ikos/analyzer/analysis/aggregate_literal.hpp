@@ -43,6 +43,7 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include <boost/variant.hpp>
@@ -51,7 +52,10 @@
 #include <ikos/core/literal.hpp>
 #include <ikos/core/semantic/dumpable.hpp>
 
+#include <ikos/ar/semantic/value.hpp>
+
 #include <ikos/analyzer/exception.hpp>
+#include <ikos/analyzer/support/assert.hpp>
 #include <ikos/analyzer/support/number.hpp>
 
 namespace ikos {
@@ -65,19 +69,78 @@ public:
   using ScalarLiteral = core::Literal< VariableRef, MemoryLocationRef >;
 
   /// \brief Field of an aggregate
+  ///
+  /// A field can represent a run of `repeat` copies of the same value, at
+  /// offsets `offset + i * stride` for `0 <= i < repeat`. This keeps large
+  /// constant initializers (e.g, lookup tables, zero-filled arrays) compact.
   struct Field {
     MachineInt offset;
     ScalarLiteral value;
     MachineInt size;
+    std::size_t repeat;
+    MachineInt stride;
+
+    /// \brief Create a single field
+    Field(MachineInt offset_, ScalarLiteral value_, MachineInt size_)
+        : offset(std::move(offset_)),
+          value(std::move(value_)),
+          size(size_),
+          repeat(1),
+          stride(std::move(size_)) {}
+
+    /// \brief Create a run of fields
+    Field(MachineInt offset_,
+          ScalarLiteral value_,
+          MachineInt size_,
+          std::size_t repeat_,
+          MachineInt stride_)
+        : offset(std::move(offset_)),
+          value(std::move(value_)),
+          size(std::move(size_)),
+          repeat(repeat_),
+          stride(std::move(stride_)) {}
+
+    /// \brief Return the offset of the last element of the run
+    MachineInt last_offset() const {
+      return offset + stride * MachineInt(repeat - 1,
+                                          stride.bit_width(),
+                                          stride.sign());
+    }
 
     bool operator==(const Field& o) const {
-      return offset == o.offset && value == o.value && size == o.size;
+      return offset == o.offset && value == o.value && size == o.size &&
+             repeat == o.repeat && (repeat == 1 || stride == o.stride);
     }
   };
 
-  /// \brief List of fields
+  /// \brief List of fields, sorted by offset
   using Fields = std::vector< Field >;
 
+  /// \brief Append a field to a list of fields
+  ///
+  /// The field is merged into the last run if it holds the same value, at the
+  /// next offset of the run.
+  static void append(Fields& fields, Field field) {
+    if (!fields.empty() && field.repeat == 1) {
+      Field& last = fields.back();
+      if (last.value == field.value && last.size == field.size &&
+          last.offset < field.offset) {
+        if (last.repeat == 1) {
+          MachineInt stride = field.offset - last.offset;
+          if (stride >= last.size) {
+            last.repeat = 2;
+            last.stride = std::move(stride);
+            return;
+          }
+        } else if (last.last_offset() + last.stride == field.offset) {
+          last.repeat++;
+          return;
+        }
+      }
+    }
+    fields.push_back(std::move(field));
+  }
+
 private:
   /// \brief Constant aggregate literal
   struct CstLit {
@@ -96,6 +159,19 @@ private:
     bool operator==(const UndefinedLit&) const { return true; }
   };
 
+  /// \brief Raw data aggregate literal
+  ///
+  /// The elements are read from the constant when needed, instead of being
+  /// copied into a list of fields.
+  struct DataLit {
+    ar::DataArrayConstant* cst;
+    MachineInt element_size;
+
+    bool operator==(const DataLit& o) const {
+      return cst == o.cst && element_size == o.element_size;
+    }
+  };
+
   /// \brief Variable aggregate literal
   struct VarLit {
     VariableRef var;
@@ -105,7 +181,8 @@ private:
 
 private:
   /// \brief Union type for aggregate literals
-  using Lit = boost::variant< CstLit, ZeroLit, UndefinedLit, VarLit >;
+  using Lit =
+      boost::variant< CstLit, DataLit, ZeroLit, UndefinedLit, VarLit >;
 
 private:
   /// \brief Literal value
@@ -152,6 +229,17 @@ public:
     return AggregateLiteral(Lit(CstLit{fields}), size);
   }
 
+  /// \brief Create a raw data aggregate literal
+  ///
+  /// \param cst The array constant holding the data
+  /// \param element_size The size of an element, in bytes
+  /// \param size The size of the array, in bytes
+  static AggregateLiteral data(ar::DataArrayConstant* cst,
+                               MachineInt element_size,
+                               MachineInt size) {
+    return AggregateLiteral(Lit(DataLit{cst, std::move(element_size)}), size);
+  }
+
   /// \brief Create a zero-initialized aggregate literal
   static AggregateLiteral zero(MachineInt size) {
     return AggregateLiteral(Lit(ZeroLit{}), size);
@@ -186,6 +274,11 @@ public:
     return boost::apply_visitor(IsType< CstLit >(), this->_lit);
   }
 
+  /// \brief Return true if it's a raw data aggregate literal
+  bool is_data() const {
+    return boost::apply_visitor(IsType< DataLit >(), this->_lit);
+  }
+
   /// \brief Return true if it's a zero-initialized aggregate literal
   bool is_zero() const {
     return boost::apply_visitor(IsType< ZeroLit >(), this->_lit);
@@ -206,6 +299,10 @@ private:
   struct GetFields : public boost::static_visitor< const Fields& > {
     const Fields& operator()(const CstLit& lit) const { return lit.fields; }
 
+    const Fields& operator()(const DataLit&) const {
+      ikos_unreachable("trying to call fields() on raw data");
+    }
+
     const Fields& operator()(const ZeroLit&) const {
       ikos_unreachable("trying to call fields() on literal zero");
     }
@@ -238,6 +335,10 @@ private:
       ikos_unreachable("trying to call var() on a constant");
     }
 
+    VariableRef operator()(const DataLit&) const {
+      ikos_unreachable("trying to call var() on raw data");
+    }
+
     VariableRef operator()(const ZeroLit&) const {
       ikos_unreachable("trying to call var() on literal zero");
     }
@@ -253,12 +354,28 @@ public:
   /// \brief Get the variable
   VariableRef var() const { return boost::apply_visitor(GetVar(), this->_lit); }
 
+public:
+  /// \brief Get the array constant holding the raw data
+  ar::DataArrayConstant* data_cst() const {
+    ikos_assert_msg(this->is_data(), "literal is not raw data");
+    return boost::get< DataLit >(this->_lit).cst;
+  }
+
+  /// \brief Get the size of an element of the raw data, in bytes
+  const MachineInt& data_element_size() const {
+    ikos_assert_msg(this->is_data(), "literal is not raw data");
+    return boost::get< DataLit >(this->_lit).element_size;
+  }
+
 public:
   /// \brief Aggregate literal visitor
   ///
   /// Visitors should implement the following methods:
   ///
   /// R cst(const Fields& fields, const MachineInt& size);
+  /// R data(ar::DataArrayConstant* cst,
+  ///        const MachineInt& element_size,
+  ///        const MachineInt& size);
   /// R zero(const MachineInt& size);
   /// R undefined(const MachineInt& size);
   /// R var(VariableRef variable, const MachineInt& size);
@@ -287,6 +404,10 @@ private:
 
     ResultType operator()(const CstLit& lit) { return v.cst(lit.fields, size); }
 
+    ResultType operator()(const DataLit& lit) {
+      return v.data(lit.cst, lit.element_size, size);
+    }
+
     ResultType operator()(const ZeroLit&) { return v.zero(size); }
 
     ResultType operator()(const UndefinedLit&) { return v.undefined(size); }
@@ -309,6 +430,10 @@ private:
       return v.cst(lit.fields, size);
     }
 
+    ResultType operator()(const DataLit& lit) const {
+      return v.data(lit.cst, lit.element_size, size);
+    }
+
     ResultType operator()(const ZeroLit&) const { return v.zero(size); }
 
     ResultType operator()(const UndefinedLit&) const {
@@ -352,13 +477,23 @@ private:
       o << "cst_aggregate{fields=";
       for (auto it = lit.fields.begin(), et = lit.fields.end(); it != et;) {
         o << "(offset=" << it->offset << ", value=" << it->value
-          << ", size=" << it->size << ")";
+          << ", size=" << it->size;
+        if (it->repeat > 1) {
+          o << ", repeat=" << it->repeat << ", stride=" << it->stride;
+        }
+        o << ")";
         if (++it != et) {
           o << ", ";
         }
       }
     }
 
+    void operator()(const DataLit& lit) const {
+      o << "data_aggregate{data=";
+      lit.cst->dump(o);
+      o << ", element_size=" << lit.element_size;
+    }
+
     void operator()(const ZeroLit&) const { o << "zero_aggregate{"; }
 
     void operator()(const UndefinedLit&) const { o << "undefined_aggregate{"; }
@@ -45,11 +45,14 @@
 
 #include <memory>
 
+#include <boost/optional.hpp>
+
 #include <llvm/ADT/DenseMap.h>
 
 #include <ikos/ar/semantic/statement.hpp>
 
 #include <ikos/analyzer/support/assert.hpp>
+#include <ikos/analyzer/util/sharded_map.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -63,13 +66,16 @@ private:
   /// \brief Call statement
   ar::CallBase* _call = nullptr;
 
+  /// \brief Number of calls in the calling context
+  unsigned _depth = 0;
+
 private:
   /// \brief Create an empty call context
   CallContext() = default;
 
   /// \brief Create a call context
   CallContext(CallContext* parent, ar::CallBase* call)
-      : _parent(parent), _call(call) {
+      : _parent(parent), _call(call), _depth(parent->_depth + 1) {
     ikos_assert(this->_parent != nullptr && this->_call != nullptr);
   }
 
@@ -107,6 +113,9 @@ public:
     return this->_call;
   }
 
+  /// \brief Return the number of calls in the calling context
+  unsigned depth() const { return this->_depth; }
+
 private:
   friend class CallContextFactory;
 
@@ -115,15 +124,25 @@ private:
 /// \brief Management of calling contexts
 class CallContextFactory {
 private:
-  llvm::DenseMap< std::pair< CallContext*, ar::CallBase* >,
-                  std::unique_ptr< CallContext > >
+  using Key = std::pair< CallContext*, ar::CallBase* >;
+
+  ShardedMap< llvm::DenseMap< Key, std::unique_ptr< CallContext > >,
+              DenseMapInfoHash< Key > >
       _map;
 
   std::unique_ptr< CallContext > _empty_call_context;
 
+  /// \brief Maximum depth of calling contexts, or boost::none
+  boost::optional< unsigned > _max_depth;
+
 public:
   /// \brief Constructor
-  CallContextFactory();
+  ///
+  /// \param max_depth Maximum depth of calling contexts. Longer call strings
+  /// are truncated to their last `max_depth` calls. Zero means that all calls
+  /// share the empty calling context.
+  explicit CallContextFactory(boost::optional< unsigned > max_depth =
+                                  boost::none);
 
   /// \brief Deleted copy constructor
   CallContextFactory(const CallContextFactory&) = delete;
@@ -145,10 +164,23 @@ public:
 
   /// \brief Get or Create the call context with the given parameters
   ///
+  /// The resulting call string is truncated to the maximum depth.
+  ///
   /// \param parent Parent call context
   /// \param call Call statement
   CallContext* get_context(CallContext* parent, ar::CallBase* call);
 
+  /// \brief Return true if the call contexts created from the given parent
+  /// are truncated, and thus might be shared by different call strings
+  bool is_truncated(CallContext* parent) const {
+    return this->_max_depth && parent->depth() >= *this->_max_depth;
+  }
+
+private:
+  /// \brief Get or Create the call context for the given call, without
+  /// truncation
+  CallContext* get_or_create(CallContext* parent, ar::CallBase* call);
+
 }; // end class CallContextFactory
 
 } // end namespace analyzer
@@ -0,0 +1,116 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Call graph analysis
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <iosfwd>
+#include <vector>
+
+#include <llvm/ADT/DenseMap.h>
+
+#include <ikos/analyzer/analysis/context.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Compute the recursive components of the call graph
+///
+/// This analysis is intended to be used before the interprocedural analysis.
+///
+/// It computes the strongly connected components of the call graph of the
+/// bundle, using Tarjan's algorithm. Only direct calls are considered, since
+/// the interprocedural analysis resolves indirect calls on the fly.
+///
+/// A component is recursive if it contains several functions, or a single
+/// function calling itself. Calls entering a recursive component from outside
+/// share a single fix-point per callee (see InlineCallExecutionEngine).
+class CallGraphAnalysis {
+private:
+  /// \brief Analysis context
+  Context& _ctx;
+
+  /// \brief Recursive components, in reverse topological order
+  std::vector< std::vector< ar::Function* > > _components;
+
+  /// \brief Map from function to the index of its recursive component
+  llvm::DenseMap< ar::Function*, std::size_t > _map;
+
+public:
+  /// \brief Constructor
+  explicit CallGraphAnalysis(Context& ctx);
+
+  /// \brief Deleted copy constructor
+  CallGraphAnalysis(const CallGraphAnalysis&) = delete;
+
+  /// \brief Deleted move constructor
+  CallGraphAnalysis(CallGraphAnalysis&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  CallGraphAnalysis& operator=(const CallGraphAnalysis&) = delete;
+
+  /// \brief Deleted move assignment operator
+  CallGraphAnalysis& operator=(CallGraphAnalysis&&) = delete;
+
+  /// \brief Destructor
+  ~CallGraphAnalysis();
+
+  /// \brief Run the analysis
+  void run();
+
+  /// \brief Return true if the given function belongs to a recursive
+  /// component
+  bool is_recursive(ar::Function* fun) const {
+    return this->_map.find(fun) != this->_map.end();
+  }
+
+  /// \brief Return true if the given functions belong to the same recursive
+  /// component
+  bool same_component(ar::Function* f, ar::Function* g) const;
+
+  /// \brief Dump the recursive components, for debugging purpose
+  void dump(std::ostream& o) const;
+
+}; // end class CallGraphAnalysis
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -45,11 +45,22 @@
 
 #include <boost/filesystem.hpp>
 
+#include <ikos/core/fixpoint/wto.hpp>
+
 #include <ikos/ar/semantic/bundle.hpp>
+#include <ikos/ar/semantic/code.hpp>
 
 #include <ikos/analyzer/analysis/option.hpp>
 
 namespace ikos {
+
+// forward declarations
+namespace core {
+namespace machine_int {
+class TraceWriter;
+} // end namespace machine_int
+} // end namespace core
+
 namespace analyzer {
 
 // forward declarations
@@ -59,9 +70,15 @@ class VariableFactory;
 class LiteralFactory;
 class CallContextFactory;
 class LivenessAnalysis;
+class VariablePackingAnalysis;
 class FunctionPointerAnalysis;
 class PointerAnalysis;
 class FixpointProfileAnalysis;
+class CallGraphAnalysis;
+class TrivialChecksAnalysis;
+class FunctionCache;
+class LibrarySummaries;
+class MemoryGovernor;
 
 /// \brief Global analysis context
 ///
@@ -92,9 +109,15 @@ public:
   /// \brief Call context factory
   CallContextFactory* call_context_factory;
 
+  /// \brief Weak topological orders, shared by all fixpoint iterators
+  core::WtoCache< ar::Code* >* wto_cache;
+
   /// \brief Liveness analysis
   LivenessAnalysis* liveness;
 
+  /// \brief Variable packing pre-analysis
+  VariablePackingAnalysis* variable_packing;
+
   /// \brief Function pointer analysis
   FunctionPointerAnalysis* function_pointer;
 
@@ -104,6 +127,31 @@ public:
   /// \brief Fixpoint Profile Analysis;
   FixpointProfileAnalysis* fixpoint_profiler;
 
+  /// \brief Recursive components of the call graph
+  CallGraphAnalysis* call_graph;
+
+  /// \brief Checks decided syntactically, or null
+  TrivialChecksAnalysis* trivial_checks;
+
+  /// \brief Cache of function results, for incremental analyses
+  FunctionCache* function_cache;
+
+  /// \brief Summaries of library functions, used instead of analyzing them
+  const LibrarySummaries* library_summaries;
+
+  /// \brief Summaries of the analyzed functions, for a library summary package
+  LibrarySummaries* library_summary_output;
+
+  /// \brief Memory governor, or null if there is no soft memory limit
+  MemoryGovernor* memory_governor;
+
+  /// \brief Trace of the operations on the machine integer abstract domain
+  /// during the analysis of domain_trace_function, or null
+  core::machine_int::TraceWriter* domain_trace;
+
+  /// \brief Function recorded in domain_trace, or null
+  ar::Function* domain_trace_function;
+
 public:
   /// \brief Constructor
   Context(ar::Bundle* bundle_,
@@ -113,7 +161,8 @@ public:
           MemoryFactory& mem_factory_,
           VariableFactory& var_factory_,
           LiteralFactory& lit_factory_,
-          CallContextFactory& call_context_factory_)
+          CallContextFactory& call_context_factory_,
+          core::WtoCache< ar::Code* >& wto_cache_)
       : bundle(bundle_),
         opts(std::move(opts_)),
         wd(std::move(wd_)),
@@ -122,10 +171,47 @@ public:
         var_factory(&var_factory_),
         lit_factory(&lit_factory_),
         call_context_factory(&call_context_factory_),
+        wto_cache(&wto_cache_),
         liveness(nullptr),
+        variable_packing(nullptr),
         function_pointer(nullptr),
         pointer(nullptr),
-        fixpoint_profiler(nullptr) {}
+        fixpoint_profiler(nullptr),
+        call_graph(nullptr),
+        trivial_checks(nullptr),
+        function_cache(nullptr),
+        library_summaries(nullptr),
+        library_summary_output(nullptr),
+        memory_governor(nullptr),
+        domain_trace(nullptr),
+        domain_trace_function(nullptr) {}
+
+  /// \brief Create a context sharing the program, the output database, the
+  /// factories and the pre-analyses of another context, with different
+  /// analysis options
+  Context(const Context& other, AnalysisOptions opts_)
+      : bundle(other.bundle),
+        opts(std::move(opts_)),
+        wd(other.wd),
+        output_db(other.output_db),
+        mem_factory(other.mem_factory),
+        var_factory(other.var_factory),
+        lit_factory(other.lit_factory),
+        call_context_factory(other.call_context_factory),
+        wto_cache(other.wto_cache),
+        liveness(other.liveness),
+        variable_packing(other.variable_packing),
+        function_pointer(other.function_pointer),
+        pointer(other.pointer),
+        fixpoint_profiler(other.fixpoint_profiler),
+        call_graph(other.call_graph),
+        trivial_checks(other.trivial_checks),
+        function_cache(other.function_cache),
+        library_summaries(other.library_summaries),
+        library_summary_output(other.library_summary_output),
+        memory_governor(other.memory_governor),
+        domain_trace(other.domain_trace),
+        domain_trace_function(other.domain_trace_function) {}
 
   /// \brief Deleted copy constructor
   Context(const Context&) = delete;
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Estimate of the cost of the value analysis, before running it
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include <llvm/ADT/DenseMap.h>
+
+#include <ikos/ar/semantic/function.hpp>
+
+#include <ikos/analyzer/analysis/context.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Estimated cost of the value analysis of a function
+struct FunctionCostEstimate {
+  /// \brief Function
+  ar::Function* function;
+
+  /// \brief Number of statements
+  std::uint64_t statements;
+
+  /// \brief Maximum nesting depth of the cycles of the weak topological order
+  unsigned wto_depth;
+
+  /// \brief Number of distinct functions with a definition directly called
+  std::uint64_t fan_out;
+
+  /// \brief Number of calling contexts in which the function is analyzed
+  std::uint64_t contexts;
+
+  /// \brief Number of internal and local variables
+  std::uint64_t variables;
+
+  /// \brief Estimated cost, in the unit of the fixpoint profile analysis
+  double cost;
+};
+
+/// \brief Estimate the cost of the value analysis of each function
+///
+/// This is intended to be used with -estimate, after the fixpoint profile
+/// analysis and, for the inter-procedural analysis, the call graph analysis.
+///
+/// The cost of a function is the cost of a fixpoint on its body (see
+/// FixpointProfileAnalysis::estimate_cost), multiplied by its number of
+/// calling contexts and by a factor depending on the machine integer domain
+/// and the number of variables of the function.
+///
+/// The number of calling contexts counts the call strings from the entry
+/// points, truncated to the context depth. Calls within a recursive component
+/// share their fix-point, and do not create new calling contexts.
+class CostEstimateAnalysis {
+private:
+  /// \brief Analysis context
+  Context& _ctx;
+
+  /// \brief Estimates of the analyzed functions
+  std::vector< FunctionCostEstimate > _estimates;
+
+public:
+  /// \brief Constructor
+  explicit CostEstimateAnalysis(Context& ctx);
+
+  /// \brief Deleted copy constructor
+  CostEstimateAnalysis(const CostEstimateAnalysis&) = delete;
+
+  /// \brief Deleted move constructor
+  CostEstimateAnalysis(CostEstimateAnalysis&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  CostEstimateAnalysis& operator=(const CostEstimateAnalysis&) = delete;
+
+  /// \brief Deleted move assignment operator
+  CostEstimateAnalysis& operator=(CostEstimateAnalysis&&) = delete;
+
+  /// \brief Destructor
+  ~CostEstimateAnalysis();
+
+  /// \brief Run the analysis
+  void run();
+
+  /// \brief Return the estimates of the analyzed functions, by decreasing
+  /// cost
+  const std::vector< FunctionCostEstimate >& estimates() const {
+    return this->_estimates;
+  }
+
+  /// \brief Return the estimated cost of the whole analysis
+  double total_cost() const;
+
+  /// \brief Dump the estimates, one function per line
+  void dump(std::ostream& o) const;
+
+private:
+  /// \brief Compute the number of calling contexts of each function reachable
+  /// from the entry points, in the inter-procedural analysis
+  llvm::DenseMap< ar::Function*, std::uint64_t > calling_contexts() const;
+
+  /// \brief Return the factor of the machine integer domain for a function
+  /// with the given number of variables
+  double domain_factor(std::uint64_t variables) const;
+
+}; // end class CostEstimateAnalysis
+
+} // end namespace analyzer
+} // end namespace ikos
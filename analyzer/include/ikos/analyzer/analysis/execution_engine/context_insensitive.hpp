@@ -51,7 +51,8 @@ namespace analyzer {
 
 /// \brief Context insensitive call semantic
 ///
-/// It safely ignores function calls, except for direct intrinsic calls.
+/// It safely ignores function calls, except for direct intrinsic calls and
+/// direct calls to library functions with a summary, see LibrarySummaries.
 ///
 /// Some assumptions are made about the program, see
 /// NumericalExecutionEngine::exec_unknown_intern_call() for more info.
@@ -90,6 +91,11 @@ public:
         this->_engine.exec_extern_call(call, fun);
         return;
       }
+
+      if (this->_engine.exec_summarized_call(call, fun)) {
+        // Library function with a summary
+        return;
+      }
     }
 
     // Otherwise
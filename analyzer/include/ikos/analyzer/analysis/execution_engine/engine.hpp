@@ -78,6 +78,11 @@ public:
   /// \brief Leave a basic block
   virtual void exec_leave(ar::BasicBlock* bb) = 0;
 
+  /// \brief Leave a statement
+  ///
+  /// This is called after the transfer function of every statement.
+  virtual void exec_leave(ar::Statement* s) = 0;
+
   /// \brief Execute an edge from `src` to `dest`
   virtual void exec_edge(ar::BasicBlock* src, ar::BasicBlock* dest) = 0;
 
@@ -229,6 +234,7 @@ inline void transfer_function(ExecEngine& exec_engine,
   };
   StatementVisitor visitor{exec_engine, call_exec_engine};
   ar::apply_visitor(visitor, stmt);
+  exec_engine.exec_leave(stmt);
 }
 
 } // end namespace analyzer
@@ -46,24 +46,49 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <boost/container/flat_map.hpp>
+#include <boost/optional.hpp>
 
 #include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/MapVector.h>
 
 #include <ikos/ar/semantic/function.hpp>
 #include <ikos/ar/verify/type.hpp>
 
+#include <ikos/analyzer/analysis/call_context.hpp>
+#include <ikos/analyzer/analysis/call_graph.hpp>
 #include <ikos/analyzer/analysis/execution_engine/engine.hpp>
 #include <ikos/analyzer/analysis/execution_engine/numerical.hpp>
+#include <ikos/analyzer/analysis/pointer/function.hpp>
 #include <ikos/analyzer/analysis/pointer/value.hpp>
 #include <ikos/analyzer/util/demangle.hpp>
 #include <ikos/analyzer/util/log.hpp>
+#include <ikos/analyzer/util/stack.hpp>
+#include <ikos/analyzer/util/thread_pool.hpp>
 
 namespace ikos {
 namespace analyzer {
 
+/// \brief Statistics of the callee summary cache of the inliner
+struct InlineCallCacheStats {
+  /// \brief Number of calls reusing a previously computed fix-point
+  std::atomic< std::uint64_t > hits{0};
+
+  /// \brief Number of calls requiring a new fix-point on the callee
+  std::atomic< std::uint64_t > misses{0};
+
+  /// \brief Number of calls reusing the fix-point of another calling context,
+  /// see AnalysisOptions::group_contexts
+  std::atomic< std::uint64_t > grouped{0};
+};
+
 /// \brief Inliner of function calls.
 ///
 /// The inlining of a function is done dynamically by matching formal and actual
@@ -71,6 +96,44 @@ namespace analyzer {
 /// the callee returns by simulating call-by-ref and updating the return value
 /// at the call site. The inlining also supports function pointers by resolving
 /// first the set of possible callees and joining the results.
+///
+/// The fix-point on a callee is kept as a summary for the call site: if the
+/// callee is called again with the same entry invariant (i.e, the call
+/// context did not change during an iteration on the caller), the previous
+/// exit invariant is reused instead of analyzing the callee again.
+///
+/// When the depth of calling contexts is limited (see CallContextFactory),
+/// calls from deep calling contexts lead to truncated contexts that might be
+/// shared by different call strings. The fix-points of such callees are
+/// shared between all their callers, and computed on the join of all the
+/// entry invariants seen so far.
+///
+/// Calls entering a recursive component of the call graph (see
+/// CallGraphAnalysis) from outside are shared the same way, in the empty call
+/// context, so that a recursive cluster is analyzed once instead of at every
+/// call site. After a few runs, the entry invariant is widened instead of
+/// joined, to bound the number of runs.
+///
+/// The targets of an indirect call with several potential callees are
+/// analyzed independently from the same entry invariant: each of them owns the
+/// fix-points on its callees with a truncated call context. Their fix-points
+/// are computed in parallel if threads are available, and their exit
+/// invariants are joined in the order of a sequential analysis, so that the
+/// result does not depend on the number of threads.
+///
+/// With AnalysisOptions::group_contexts, the fix-points on a callee are also
+/// shared between calling contexts with the same entry invariant. A call that
+/// misses the summary of its call site reuses the fix-point computed for
+/// another call site or caller, if any. The checks are still run once per
+/// calling context, on the shared fix-point. Targets of an indirect call with
+/// several potential callees own the fix-points on their callees, so they are
+/// not shared.
+///
+/// If enabled (see AnalysisOptions::use_frame_projection), the internal and
+/// local variables of the caller, its frame, are removed from the entry
+/// invariant of the callee, since the callee cannot access them. Their values
+/// are restored after the call from the invariant before the call, projected
+/// on the frame.
 template < typename FunctionAnalyzer, typename AbstractDomain >
 class InlineCallExecutionEngine final : public CallExecutionEngine {
 public:
@@ -79,14 +142,66 @@ public:
   using NumericalExecutionEngineT = NumericalExecutionEngine< AbstractDomain >;
 
 private:
-  /// \brief Map from callee function to FunctionAnalyzer
-  using CalleeMap =
-      boost::container::flat_map< ar::Function*,
-                                  std::unique_ptr< FunctionAnalyzer > >;
+  /// \brief Fix-point on a callee
+  struct Callee {
+    /// \brief Entry invariant of the callee
+    AbstractDomain entry_inv;
+
+    /// \brief Function analyzer of the callee
+    ///
+    /// This is shared between calling contexts with group_contexts.
+    std::shared_ptr< FunctionAnalyzer > analyzer;
+
+    /// \brief Number of runs of the fix-point
+    unsigned runs = 1;
+  };
+
+  /// \brief Map from callee function to Callee
+  using CalleeMap = boost::container::flat_map< ar::Function*, Callee >;
 
   /// \brief Map from call statement to CalleeMap
   using CallMap = llvm::DenseMap< ar::CallBase*, CalleeMap >;
 
+  /// \brief Target of a call statement
+  struct CallTarget {
+    /// \brief Called function
+    ar::Function* callee;
+
+    /// \brief Execution engine on the entry invariant of the callee, then on
+    /// the post invariant of the call
+    NumericalExecutionEngineT engine;
+
+    /// \brief Inliner of the fix-point on the callee, or null if `engine`
+    /// already holds the post invariant
+    const InlineCallExecutionEngineT* inliner;
+
+    /// \brief Fix-point on the callee that remains to be computed, or null
+    FunctionAnalyzer* pending;
+  };
+
+public:
+  /// \brief Map from truncated call context and callee to Callee
+  ///
+  /// Callees entering a recursive component use the empty call context.
+  ///
+  /// This preserves the insertion order, for a deterministic output.
+  using SharedCalleeMap =
+      llvm::MapVector< std::pair< CallContext*, ar::Function* >, Callee >;
+
+  /// \brief Map from callee to the fix-points that can be shared between
+  /// calling contexts, see AnalysisOptions::group_contexts
+  using GroupedCalleeMap =
+      llvm::DenseMap< ar::Function*, std::vector< Callee > >;
+
+private:
+  /// \brief Number of runs of a shared fix-point on a recursive component
+  /// before widening its entry invariant
+  static constexpr unsigned RecursiveWideningDelay = 2;
+
+  /// \brief Maximum number of fix-points kept per callee for the calling
+  /// contexts with the same entry invariant
+  static constexpr std::size_t MaxGroupedCallees = 8;
+
 private:
   /// \brief Analysis context
   Context& _ctx;
@@ -106,27 +221,55 @@ private:
   /// \brief Store previously-computed fixpoints on callees
   CallMap _calls;
 
+  /// \brief Statistics of the callee summary cache
+  InlineCallCacheStats& _cache_stats;
+
+  /// \brief Fix-points on callees with a truncated call context
+  SharedCalleeMap& _shared_callees;
+
+  /// \brief Fix-points on callees shared between calling contexts
+  GroupedCalleeMap& _grouped_callees;
+
   /// \brief True if the calling context is stable
   bool _context_stable;
 
   /// \brief True if the fixpoint on _caller is reached
   bool _convergence_achieved;
 
+  /// \brief Number of threads computing the fix-points on the targets of an
+  /// indirect call
+  unsigned _jobs;
+
+  /// \brief Internal and local variables of the caller, computed lazily
+  boost::optional< std::vector< Variable* > > _frame_vars;
+
+  /// \brief Integer variables of the frame of the caller, including the
+  /// offsets of its pointers, computed lazily
+  boost::optional< std::vector< Variable* > > _frame_int_vars;
+
 public:
   /// \brief Constructor
   InlineCallExecutionEngine(Context& ctx,
                             NumericalExecutionEngineT& engine,
                             const FunctionAnalyzer& caller,
+                            InlineCallCacheStats& cache_stats,
+                            SharedCalleeMap& shared_callees,
+                            GroupedCalleeMap& grouped_callees,
                             bool context_stable,
-                            bool convergence_achieved)
+                            bool convergence_achieved,
+                            unsigned jobs)
       : _ctx(ctx),
         _engine(engine),
         _caller(caller),
         _exit_inv(AbstractDomain::bottom()),
         _return_stmt(nullptr),
         _calls(),
+        _cache_stats(cache_stats),
+        _shared_callees(shared_callees),
+        _grouped_callees(grouped_callees),
         _context_stable(context_stable),
-        _convergence_achieved(convergence_achieved) {}
+        _convergence_achieved(convergence_achieved),
+        _jobs(jobs) {}
 
   /// \brief Mark that the calling context is stable
   void mark_context_stable() { this->_context_stable = true; }
@@ -137,11 +280,56 @@ public:
   /// \brief Clear the list of callees
   void clear() { this->_calls.clear(); }
 
-  /// \brief Run the checks on the callees
-  void run_checks() const {
+  /// \brief Run the checks on the callees, for the caller in the given call
+  /// context
+  ///
+  /// This is not the call context of the caller if its fix-point is shared
+  /// with other calling contexts.
+  void run_checks(CallContext* context) const {
+    for (auto it = this->_calls.begin(), et = this->_calls.end(); it != et;
+         ++it) {
+      CallContext* callee_context =
+          _ctx.call_context_factory->get_context(context, it->first);
+      this->run_checks(it->second, callee_context);
+    }
+  }
+
+  /// \brief Call `f` on the fix-point of each callee
+  ///
+  /// This does not include the callees with a truncated call context.
+  template < typename Function >
+  void for_each_callee(Function f) const {
     for (auto it = this->_calls.begin(), et = this->_calls.end(); it != et;
          ++it) {
-      this->run_checks(it->second);
+      for (auto callee_it = it->second.begin(), callee_et = it->second.end();
+           callee_it != callee_et;
+           ++callee_it) {
+        f(callee_it->second.analyzer.get());
+      }
+    }
+  }
+
+  /// \brief Call `f` on the fix-point of each callee with a truncated call
+  /// context
+  template < typename Function >
+  void for_each_shared_callee(Function f) const {
+    for (auto it = this->_shared_callees.begin(),
+              et = this->_shared_callees.end();
+         it != et;
+         ++it) {
+      f(it->second.analyzer.get());
+    }
+  }
+
+  /// \brief Run the checks on the callees with a truncated call context
+  ///
+  /// This should only be called once, at the end of the analysis
+  void run_shared_checks() const {
+    for (auto it = this->_shared_callees.begin(),
+              et = this->_shared_callees.end();
+         it != et;
+         ++it) {
+      run_on_large_stack([&it] { it->second.analyzer->run_checks(); });
     }
   }
 
@@ -151,11 +339,25 @@ public:
   /// \brief Return the return statement, or null
   ar::ReturnValue* return_stmt() const { return this->_return_stmt; }
 
+  /// \brief Return the statistics of the callee summary cache
+  InlineCallCacheStats& cache_stats() const { return this->_cache_stats; }
+
+  /// \brief Return the fix-points on callees with a truncated call context
+  SharedCalleeMap& shared_callees() const { return this->_shared_callees; }
+
+  /// \brief Return the fix-points on callees shared between calling contexts
+  GroupedCalleeMap& grouped_callees() const { return this->_grouped_callees; }
+
+  /// \brief Return the number of threads computing the fix-points on the
+  /// targets of an indirect call
+  unsigned jobs() const { return this->_jobs; }
+
 private:
-  /// \brief Run the checks on the given CalleeMap
-  void run_checks(const CalleeMap& callees) const {
+  /// \brief Run the checks on the given CalleeMap, in the given call context
+  void run_checks(const CalleeMap& callees, CallContext* context) const {
     for (auto it = callees.begin(), et = callees.end(); it != et; ++it) {
-      it->second->run_checks();
+      run_on_large_stack(
+          [&it, context] { it->second.analyzer->run_checks(context); });
     }
   }
 
@@ -170,6 +372,7 @@ public:
   void exec_exit(ar::Function* fun) override {
     this->_engine.deallocate_local_variables(fun->local_variable_begin(),
                                              fun->local_variable_end());
+    this->_engine.forget_unreachable_memory();
     this->_exit_inv = this->_engine.inv();
   }
 
@@ -258,6 +461,21 @@ private:
         if (!points_to.is_bottom() && !points_to.is_top()) {
           this->inv().normal().pointers().refine(ptr_var, points_to);
         }
+      } else if (_ctx.function_pointer != nullptr) {
+        // Refine the set of potential callees with the targets pre-computed
+        // by the function pointer analysis, for this call site
+        const PointsToSet& targets = _ctx.function_pointer->callees(call);
+
+        if (!targets.is_top()) {
+          PointsToSet points_to =
+              this->inv().normal().pointers().points_to(ptr_var);
+          points_to.meet_with(targets);
+
+          // Function pointer analysis and value analysis can be inconsistent
+          if (!points_to.is_empty()) {
+            this->inv().normal().pointers().refine(ptr_var, targets);
+          }
+        }
       }
 
       // Get the callees
@@ -293,8 +511,19 @@ private:
     AbstractDomain post(this->inv());
     post.set_normal_flow_to_bottom();
 
-    // Check if the call is correct
-    bool resolved = false;
+    // Invariant on the frame of the caller, restored after the call
+    boost::optional< AbstractDomain > frame;
+    if (_ctx.opts.use_frame_projection) {
+      frame = this->inv();
+      frame->ignore_exceptions();
+    }
+
+    // Targets of the call, in the order of the points-to set
+    std::vector< CallTarget > targets;
+    targets.reserve(callees.size());
+
+    // Targets of an indirect call are analyzed independently
+    bool isolated = callees.size() > 1;
 
     // For each callee
     for (MemoryLocation* mem : callees) {
@@ -319,14 +548,28 @@ private:
         engine.inv().ignore_exceptions();
         engine.exec_extern_call(call, callee);
         engine.inv().merge_propagated_in_caught_exceptions();
-        post.join_with(engine.inv());
-
-        resolved = true;
+        targets.push_back(
+            CallTarget{callee, std::move(engine), nullptr, nullptr});
         continue;
       }
       ikos_assert(callee->is_definition());
 
+      if (_ctx.library_summaries != nullptr) {
+        // Use the summary of a library function instead of inlining it
+        NumericalExecutionEngineT engine(this->_engine.fork());
+        engine.inv().ignore_exceptions();
+        if (engine.exec_summarized_call(call, callee)) {
+          engine.inv().merge_propagated_in_caught_exceptions();
+          targets.push_back(
+              CallTarget{callee, std::move(engine), nullptr, nullptr});
+          continue;
+        }
+      }
+
       if (this->_caller.is_currently_analyzed(callee)) {
+        // The fix-points of the previous targets are kept for the checks
+        this->run_pending(targets);
+
         // TODO(jnavas): we can be more precise by making top only lhs of
         // call_stmt, actual parameters of pointer type and any global variable
         // that might be touched by the recursive function.
@@ -342,15 +585,40 @@ private:
       // Assign parameters
       engine.match_down(call, callee);
 
+      if (frame) {
+        // The callee cannot access the frame of the caller
+        engine.forget_variables(this->frame_variables());
+      }
+
       //
       // Analyze recursively the callee
       //
 
       const InlineCallExecutionEngineT* callee_inliner = nullptr;
-
-      if (this->_convergence_achieved) {
+      FunctionAnalyzer* pending = nullptr;
+
+      CallContextFactory& contexts = *_ctx.call_context_factory;
+
+      if (this->enters_recursive_component(callee)) {
+        // Share the fix-point on the recursive component between call sites
+        callee_inliner = this->shared_callee(call,
+                                             callee,
+                                             engine.inv(),
+                                             contexts.get_empty(),
+                                             /* widen = */ true);
+      } else if (contexts.is_truncated(this->_caller.call_context())) {
+        // The call context of the callee might be shared with other calls
+        CallContext* context =
+            contexts.get_context(this->_caller.call_context(), call);
+        callee_inliner = this->shared_callee(call,
+                                             callee,
+                                             engine.inv(),
+                                             context,
+                                             /* widen = */ false);
+      } else if (this->_convergence_achieved) {
         // Use the previously computed fix-point
-        FunctionAnalyzer* callee_analyzer = callee_map.at(callee).get();
+        FunctionAnalyzer* callee_analyzer =
+            callee_map.at(callee).analyzer.get();
 
         if (this->_context_stable) {
           // Calling context is stable
@@ -359,53 +627,338 @@ private:
 
         callee_inliner = &callee_analyzer->inliner();
       } else {
-        // Erase the previous fix-point
-        callee_map.erase(callee);
+        auto it = callee_map.find(callee);
+
+        if (it != callee_map.end() &&
+            it->second.entry_inv.equals(engine.inv())) {
+          // Same entry invariant, reuse the previously computed fix-point
+          this->_cache_stats.hits++;
+          callee_inliner = &it->second.analyzer->inliner();
+        } else if (const Callee* group =
+                       isolated ? nullptr
+                                : this->grouped_callee(callee, engine.inv())) {
+          // Same entry invariant in another calling context
+          this->_cache_stats.grouped++;
+          group->analyzer->mark_grouped();
+          callee_inliner = &group->analyzer->inliner();
+          callee_map.erase(callee);
+          callee_map.emplace(callee, Callee{group->entry_inv, group->analyzer});
+        } else {
+          this->_cache_stats.misses++;
+
+          // Erase the previous fix-point
+          callee_map.erase(callee);
+
+          auto callee_analyzer = std::make_shared<
+              FunctionAnalyzer >(_ctx,
+                                 _caller,
+                                 call,
+                                 callee,
+                                 this->_context_stable &&
+                                     this->_convergence_achieved,
+                                 isolated);
+
+          callee_inliner = &callee_analyzer->inliner();
+
+          // The fix-point is computed after all targets are collected
+          pending = callee_analyzer.get();
+
+          if (_ctx.opts.group_contexts && !isolated) {
+            this->add_grouped_callee(callee,
+                                     Callee{engine.inv(), callee_analyzer});
+          }
+
+          // insert in the callee map
+          callee_map.emplace(callee,
+                             Callee{engine.inv(), std::move(callee_analyzer)});
+        }
+      }
 
-        auto callee_analyzer = std::make_unique<
-            FunctionAnalyzer >(_ctx,
-                               _caller,
-                               call,
-                               callee,
-                               this->_context_stable &&
-                                   this->_convergence_achieved);
+      targets.push_back(
+          CallTarget{callee, std::move(engine), callee_inliner, pending});
 
-        callee_inliner = &callee_analyzer->inliner();
+      if (pending == nullptr) {
+        // The fix-point might be replaced by the analysis of the next targets
+        this->return_from(call, targets.back(), frame);
+      }
+    }
+
+    if (targets.empty()) {
+      // ASSUMPTION: the callee has no side effects.
+      // Just set lhs and all actual parameters of pointer type to TOP.
+      this->_engine.exec_unknown_extern_call(call);
+      return;
+    }
 
-        // Run analysis on callee
-        log::debug("Analyzing function '" + demangle(callee->name()) + "'");
-        callee_analyzer->run(engine.inv());
+    // Run analysis on callees
+    this->run_pending(targets);
 
-        // insert in the callee map
-        callee_map.emplace(callee, std::move(callee_analyzer));
+    // Join the post invariants, in the order of the targets
+    for (CallTarget& target : targets) {
+      if (target.inliner != nullptr) {
+        this->return_from(call, target, frame);
       }
 
-      engine.set_inv(callee_inliner->exit_invariant());
+      // Exception states are collected even if the normal flow is bottom
+      post.join_with(target.engine.inv());
+    }
 
-      // Merge exceptions in caught_exceptions, in case it's an invoke
-      engine.inv().merge_propagated_in_caught_exceptions();
+    this->_engine.set_inv(std::move(post));
+  }
 
-      if (engine.inv().is_normal_flow_bottom()) {
-        post.join_with(engine.inv()); // collect the exception states
+  /// \brief Set the engine of the given target to the post invariant of the
+  /// call, from the exit invariant of its fix-point
+  ///
+  /// \param call Call statement
+  /// \param target Target with a computed fix-point
+  /// \param frame Invariant on the frame of the caller, or boost::none
+  void return_from(ar::CallBase* call,
+                   CallTarget& target,
+                   const boost::optional< AbstractDomain >& frame) {
+    NumericalExecutionEngineT& engine = target.engine;
+    engine.set_inv(target.inliner->exit_invariant());
+
+    // Merge exceptions in caught_exceptions, in case it's an invoke
+    engine.inv().merge_propagated_in_caught_exceptions();
+
+    if (frame) {
+      // Restore the frame of the caller
+      this->restore_frame(engine.inv().normal(), frame->normal());
+      if (!engine.inv().is_caught_exceptions_bottom()) {
+        this->restore_frame(engine.inv().caught_exceptions(), frame->normal());
+      }
+    }
 
-        resolved = true;
-        continue;
+    if (!engine.inv().is_normal_flow_bottom()) {
+      engine.match_up(call, target.inliner->return_stmt());
+    }
+    target.inliner = nullptr;
+  }
+
+  /// \brief Compute the pending fix-points on the given targets
+  ///
+  /// The fix-points are computed in parallel if there are several of them
+  /// and threads are available. Each of them only reads the entry invariant
+  /// of its target.
+  void run_pending(std::vector< CallTarget >& targets) {
+    std::vector< CallTarget* > pending;
+    for (CallTarget& target : targets) {
+      if (target.pending != nullptr) {
+        pending.push_back(&target);
       }
+    }
 
-      engine.match_up(call, callee_inliner->return_stmt());
-      post.join_with(engine.inv());
+    if (this->_jobs > 1 && pending.size() > 1) {
+      ThreadPool pool(std::min< std::size_t >(this->_jobs, pending.size()));
+      for (CallTarget* target : pending) {
+        pool.push([target](std::size_t) { run_pending(*target); });
+      }
+      pool.run();
+    } else {
+      for (CallTarget* target : pending) {
+        run_pending(*target);
+      }
+    }
 
-      resolved = true;
+    for (CallTarget* target : pending) {
+      target->pending = nullptr;
     }
+  }
 
-    if (!resolved) {
-      // ASSUMPTION: the callee has no side effects.
-      // Just set lhs and all actual parameters of pointer type to TOP.
-      this->_engine.exec_unknown_extern_call(call);
+  /// \brief Compute the pending fix-point on the given target
+  static void run_pending(CallTarget& target) {
+    if (ikos_unlikely(log::is_enabled_for(LogLevel::Debug))) {
+      log::debug("Analyzing function '" + demangle(target.callee) + "'");
+    }
+    run_on_large_stack(
+        [&target] { target.pending->run(target.engine.inv()); });
+  }
+
+  /// \brief Restore the frame of the caller, from the invariant before the
+  /// call
+  ///
+  /// Only the frame is restored: the invariant before the call also holds
+  /// the variables of previous callees, which the callee may have updated.
+  template < typename MemoryDomain >
+  void restore_frame(MemoryDomain& inv, const MemoryDomain& frame) {
+    if (inv.is_bottom()) {
+      return;
+    }
+    if (frame.is_bottom()) {
+      inv.set_to_bottom();
       return;
     }
 
-    this->_engine.set_inv(std::move(post));
+    auto ints = frame.integers();
+    ints.project(this->frame_int_variables());
+    inv.integers().meet_with(ints);
+
+    for (Variable* var : this->frame_variables()) {
+      if (var->type()->is_pointer()) {
+        inv.pointers().refine(var, frame.pointers().get(var));
+      }
+      inv.uninitialized().refine(var, frame.uninitialized().get(var));
+    }
+  }
+
+  /// \brief Return the integer variables of the frame of the caller,
+  /// including the offsets of its pointers
+  const std::vector< Variable* >& frame_int_variables() {
+    if (this->_frame_int_vars) {
+      return *this->_frame_int_vars;
+    }
+
+    std::vector< Variable* > vars;
+    for (Variable* var : this->frame_variables()) {
+      if (var->type()->is_integer()) {
+        vars.push_back(var);
+      } else if (var->type()->is_pointer()) {
+        vars.push_back(var->offset_var());
+      }
+    }
+    this->_frame_int_vars = std::move(vars);
+    return *this->_frame_int_vars;
+  }
+
+  /// \brief Return the internal and local variables of the caller
+  const std::vector< Variable* >& frame_variables() {
+    if (this->_frame_vars) {
+      return *this->_frame_vars;
+    }
+
+    ar::Function* fun = this->_caller.function();
+    std::vector< Variable* > vars;
+    for (auto it = fun->param_begin(), et = fun->param_end(); it != et; ++it) {
+      vars.push_back(_ctx.var_factory->get_internal(*it));
+    }
+    for (auto it = fun->local_variable_begin(), et = fun->local_variable_end();
+         it != et;
+         ++it) {
+      vars.push_back(_ctx.var_factory->get_local(*it));
+    }
+    for (ar::BasicBlock* bb : *fun->body()) {
+      for (ar::Statement* stmt : *bb) {
+        if (stmt->has_result()) {
+          if (auto iv = dyn_cast< ar::InternalVariable >(stmt->result())) {
+            vars.push_back(_ctx.var_factory->get_internal(iv));
+          }
+        }
+      }
+    }
+
+    std::sort(vars.begin(), vars.end());
+    vars.erase(std::unique(vars.begin(), vars.end()), vars.end());
+    this->_frame_vars = std::move(vars);
+    return *this->_frame_vars;
+  }
+
+  /// \brief Return the fix-point on the given callee computed in another
+  /// calling context with the same entry invariant, or null
+  const Callee* grouped_callee(ar::Function* callee,
+                               const AbstractDomain& entry_inv) const {
+    if (!_ctx.opts.group_contexts) {
+      return nullptr;
+    }
+    auto it = this->_grouped_callees.find(callee);
+    if (it == this->_grouped_callees.end()) {
+      return nullptr;
+    }
+    for (const Callee& group : it->second) {
+      if (group.entry_inv.equals(entry_inv)) {
+        return &group;
+      }
+    }
+    return nullptr;
+  }
+
+  /// \brief Keep the given fix-point on a callee for the other calling
+  /// contexts, dropping the oldest one if there are too many
+  void add_grouped_callee(ar::Function* callee, Callee group) {
+    std::vector< Callee >& groups = this->_grouped_callees[callee];
+    if (groups.size() >= MaxGroupedCallees) {
+      groups.erase(groups.begin());
+    }
+    groups.push_back(std::move(group));
+  }
+
+  /// \brief Return true if a call to the given callee enters a recursive
+  /// component of the call graph from outside
+  bool enters_recursive_component(ar::Function* callee) const {
+    return _ctx.call_graph != nullptr && _ctx.call_graph->is_recursive(callee) &&
+           !_ctx.call_graph->same_component(this->_caller.function(), callee);
+  }
+
+  /// \brief Return the inliner of the shared fix-point on the given callee
+  ///
+  /// The fix-point is computed again, on the join of the entry invariants, if
+  /// the given entry invariant is not included in the previous one. If
+  /// `widen` is true, the entry invariants are widened after
+  /// RecursiveWideningDelay runs.
+  ///
+  /// \param call Call statement
+  /// \param callee Called function
+  /// \param entry_inv Entry invariant of the callee
+  /// \param context Call context identifying the shared fix-point
+  /// \param widen Widen the entry invariants
+  const InlineCallExecutionEngineT* shared_callee(
+      ar::CallBase* call,
+      ar::Function* callee,
+      const AbstractDomain& entry_inv,
+      CallContext* context,
+      bool widen) {
+    auto key = std::make_pair(context, callee);
+    auto it = this->_shared_callees.find(key);
+
+    if (this->_convergence_achieved) {
+      // Use the previously computed fix-point
+      ikos_assert(it != this->_shared_callees.end());
+      return &it->second.analyzer->inliner();
+    }
+
+    if (it != this->_shared_callees.end() &&
+        entry_inv.leq(it->second.entry_inv)) {
+      // Included in the previous entry invariant, reuse the fix-point
+      this->_cache_stats.hits++;
+      return &it->second.analyzer->inliner();
+    }
+
+    this->_cache_stats.misses++;
+
+    AbstractDomain inv(entry_inv);
+    unsigned runs = 1;
+    if (it != this->_shared_callees.end()) {
+      runs = it->second.runs + 1;
+      if (widen && it->second.runs >= RecursiveWideningDelay) {
+        AbstractDomain prev(it->second.entry_inv);
+        prev.widen_with(inv);
+        inv = std::move(prev);
+      } else {
+        inv.join_with(it->second.entry_inv);
+      }
+    }
+
+    auto callee_analyzer =
+        std::make_unique< FunctionAnalyzer >(_ctx,
+                                             _caller,
+                                             call,
+                                             callee,
+                                             /* context_stable = */ false,
+                                             /* isolated = */ false);
+    const InlineCallExecutionEngineT* callee_inliner =
+        &callee_analyzer->inliner();
+
+    // Run analysis on callee
+    if (ikos_unlikely(log::is_enabled_for(LogLevel::Debug))) {
+      log::debug("Analyzing function '" + demangle(callee) + "'");
+    }
+    run_on_large_stack([&callee_analyzer, &inv] { callee_analyzer->run(inv); });
+
+    // Replace the previous fix-point. Note that `it` might be invalidated by
+    // the analysis of the callee.
+    this->_shared_callees[key] = Callee{std::move(inv),
+                                        std::move(callee_analyzer),
+                                        runs};
+    return callee_inliner;
   }
 
 }; // end class InlineCallExecutionEngine
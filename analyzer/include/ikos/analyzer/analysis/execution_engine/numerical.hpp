@@ -47,6 +47,10 @@
 
 #pragma once
 
+#include <vector>
+
+#include <boost/optional.hpp>
+
 #include <ikos/ar/semantic/intrinsic.hpp>
 #include <ikos/ar/verify/type.hpp>
 
@@ -57,6 +61,7 @@
 #include <ikos/core/domain/nullity/abstract_domain.hpp>
 #include <ikos/core/domain/pointer/abstract_domain.hpp>
 #include <ikos/core/domain/uninitialized/abstract_domain.hpp>
+#include <ikos/core/number/fixed_machine_int.hpp>
 
 #include <ikos/analyzer/analysis/context.hpp>
 #include <ikos/analyzer/analysis/execution_engine/engine.hpp>
@@ -64,6 +69,7 @@
 #include <ikos/analyzer/analysis/liveness.hpp>
 #include <ikos/analyzer/analysis/option.hpp>
 #include <ikos/analyzer/analysis/pointer/value.hpp>
+#include <ikos/analyzer/database/library_summary.hpp>
 #include <ikos/analyzer/support/assert.hpp>
 #include <ikos/analyzer/support/cast.hpp>
 
@@ -139,6 +145,8 @@ template < typename AbstractDomain >
 class NumericalExecutionEngine final : public ExecutionEngine {
 private:
   using IntInterval = core::machine_int::Interval;
+  using IntCongruence = core::machine_int::Congruence;
+  using IntIntervalCongruence = core::machine_int::IntervalCongruence;
   using IntVariable = core::VariableExpression< MachineInt, Variable* >;
   using IntLinearExpression = core::LinearExpression< MachineInt, Variable* >;
   using IntLinearConstraint = core::LinearConstraint< MachineInt, Variable* >;
@@ -152,6 +160,15 @@ private:
   using IntPredicate = core::machine_int::Predicate;
   using PtrPredicate = core::pointer::Predicate;
 
+private:
+  /// \brief Runs of constant aggregate fields longer than this are written
+  /// as one summarized write instead of one write per element
+  static constexpr std::size_t MaxExpandedRun = 64;
+
+  /// \brief Raw data arrays longer than this are written as one summarized
+  /// write of the range of their elements, instead of one write per element
+  static constexpr std::size_t MaxExpandedData = 1024;
+
 private:
   /// \brief Current invariant
   AbstractDomain _inv;
@@ -183,6 +200,13 @@ private:
   /// \brief Optional pointer information
   const PointerInfo* _pointer_info;
 
+  /// \brief Literals of the last code executed, or null
+  const CodeLiterals* _code_literals;
+
+  /// \brief True if the value of integer variables can be queried cheaply,
+  /// see int_singleton()
+  bool _cheap_int_queries;
+
 public:
   /// \brief Constructor
   ///
@@ -207,7 +231,10 @@ public:
         _call_context(call_context),
         _precision(precision),
         _liveness(liveness),
-        _pointer_info(pointer_info) {}
+        _pointer_info(pointer_info),
+        _code_literals(nullptr),
+        _cheap_int_queries(machine_int_domain_option_is_non_relational(
+            ctx.opts.machine_int_domain)) {}
 
 private:
   /// \brief Private copy constructor
@@ -249,6 +276,17 @@ public:
   /// \brief Return the pointer information, or null
   const PointerInfo* pointer_info() const { return this->_pointer_info; }
 
+private:
+  /// \brief Return the literals of the result and operands of a statement
+  StatementLiterals literals(ar::Statement* s) {
+    ar::Code* code = s->code();
+    if (this->_code_literals == nullptr ||
+        this->_code_literals->code() != code) {
+      this->_code_literals = &this->_lit_factory.get(code);
+    }
+    return this->_code_literals->get(s);
+  }
+
 public:
   /// \name Helpers for memory statements
   /// @{
@@ -771,6 +809,47 @@ private:
     return ScalarLit::pointer_var(var);
   }
 
+  /// \brief Write a run of aggregate fields in the memory, in one operation
+  ///
+  /// A contiguous run of zeros is written as a single zero cell. Otherwise, the
+  /// value is written at the offset range `offset + stride * [0, repeat - 1]`,
+  /// which performs a weak update on the overlapping cells.
+  void mem_write_run(const ScalarLit& write_ptr,
+                     const ScalarLit& ptr,
+                     const AggregateLit::Field& field) {
+    this->pointer_shift(write_ptr, ptr, ScalarLit::machine_int(field.offset));
+
+    if (field.stride == field.size && field.value.is_machine_int() &&
+        field.value.machine_int().is_zero()) {
+      bool size_overflow;
+      bool bit_width_overflow;
+      MachineInt repeat(field.repeat, field.size.bit_width(), Unsigned);
+      MachineInt size = mul(field.size, repeat, size_overflow);
+      MachineInt eight(8, size.bit_width(), Unsigned);
+      MachineInt bit_width = mul(size, eight, bit_width_overflow);
+      if (!size_overflow && !bit_width_overflow &&
+          bit_width.fits< unsigned >()) {
+        MachineInt zero(0, bit_width.to< unsigned >(), Signed);
+        this->_inv.normal().mem_write(this->_var_factory,
+                                      write_ptr.var(),
+                                      ScalarLit::machine_int(zero),
+                                      size);
+        return;
+      }
+    }
+
+    Variable* offset_var =
+        this->_inv.normal().pointers().offset_var(write_ptr.var());
+    this->_inv.normal().integers().set(
+        offset_var,
+        IntIntervalCongruence(IntInterval(field.offset, field.last_offset()),
+                              IntCongruence(field.stride, field.offset)));
+    this->_inv.normal().mem_write(this->_var_factory,
+                                  write_ptr.var(),
+                                  field.value,
+                                  field.size);
+  }
+
   /// \brief Write an aggregate in the memory
   void mem_write_aggregate(const ScalarLit& ptr,
                            const AggregateLit& aggregate) {
@@ -790,13 +869,81 @@ private:
                                 "shadow.mem_write_aggregate.ptr"));
 
       for (const auto& field : aggregate.fields()) {
-        this->pointer_shift(write_ptr,
-                            ptr,
-                            ScalarLit::machine_int(field.offset));
-        this->_inv.normal().mem_write(this->_var_factory,
-                                      write_ptr.var(),
-                                      field.value,
-                                      field.size);
+        if (field.repeat > MaxExpandedRun) {
+          this->mem_write_run(write_ptr, ptr, field);
+          continue;
+        }
+
+        MachineInt offset = field.offset;
+        for (std::size_t i = 0; i < field.repeat; i++) {
+          this->pointer_shift(write_ptr, ptr, ScalarLit::machine_int(offset));
+          this->_inv.normal().mem_write(this->_var_factory,
+                                        write_ptr.var(),
+                                        field.value,
+                                        field.size);
+          offset += field.stride;
+        }
+      }
+
+      // clean-up
+      this->_inv.normal().forget_surface(write_ptr.var());
+    } else if (aggregate.is_data()) {
+      ar::DataArrayConstant* cst = aggregate.data_cst();
+      const MachineInt& element_size = aggregate.data_element_size();
+      std::size_t n = cst->num_elements();
+
+      // Pointer to write the aggregate in the memory
+      ScalarLit write_ptr = ScalarLit::pointer_var(
+          this->_var_factory
+              .get_named_shadow(this->void_ptr_type(),
+                                "shadow.mem_write_aggregate.ptr"));
+
+      MachineInt offset(0, element_size.bit_width(), element_size.sign());
+
+      if (n <= MaxExpandedData) {
+        for (std::size_t i = 0; i < n; i++) {
+          this->pointer_shift(write_ptr, ptr, ScalarLit::machine_int(offset));
+          this->_inv.normal().mem_write(this->_var_factory,
+                                        write_ptr.var(),
+                                        ScalarLit::machine_int(
+                                            cst->element(i)),
+                                        element_size);
+          offset += element_size;
+        }
+      } else {
+        MachineInt lb = cst->element(0);
+        MachineInt ub = lb;
+        for (std::size_t i = 1; i < n; i++) {
+          MachineInt element = cst->element(i);
+          if (element < lb) {
+            lb = std::move(element);
+          } else if (element > ub) {
+            ub = std::move(element);
+          }
+        }
+
+        if (lb == ub) {
+          this->mem_write_run(write_ptr,
+                              ptr,
+                              AggregateLit::Field{offset,
+                                                  ScalarLit::machine_int(lb),
+                                                  element_size,
+                                                  n,
+                                                  element_size});
+        } else {
+          Variable* range = this->_var_factory.get_named_shadow(
+              cst->element_type(), "shadow.mem_write_aggregate.data");
+          this->_inv.normal().integers().set(range, IntInterval(lb, ub));
+          this->mem_write_run(write_ptr,
+                              ptr,
+                              AggregateLit::Field{offset,
+                                                  ScalarLit::machine_int_var(
+                                                      range),
+                                                  element_size,
+                                                  n,
+                                                  element_size});
+          this->_inv.normal().integers().forget(range);
+        }
       }
 
       // clean-up
@@ -862,6 +1009,22 @@ public:
   }
 
 private:
+  /// \brief Apply the given function on the normal state and on the
+  /// exceptional states that are not bottom
+  ///
+  /// This avoids materializing the exceptional states in code without
+  /// exceptions.
+  template < typename Function >
+  void apply_on_states(Function f) {
+    f(this->_inv.normal());
+    if (!this->_inv.is_caught_exceptions_bottom()) {
+      f(this->_inv.caught_exceptions());
+    }
+    if (!this->_inv.is_propagated_exceptions_bottom()) {
+      f(this->_inv.propagated_exceptions());
+    }
+  }
+
   /// \brief Randomly throw unknown exceptions with the current invariant
   ///
   /// Equivalent to if (rand()) { throw rand(); }
@@ -877,34 +1040,98 @@ public:
       return;
     }
 
+    std::vector< LocalVariable* > vars;
+    std::vector< MemoryLocation* > addrs;
+    std::vector< Variable* > alloc_size_vars;
     for (auto it = begin; it != end; ++it) {
-      LocalVariable* var = this->_var_factory.get_local(*it);
       MemoryLocation* addr = this->_mem_factory.get_local(*it);
+      vars.push_back(this->_var_factory.get_local(*it));
+      addrs.push_back(addr);
+      alloc_size_vars.push_back(this->_var_factory.get_alloc_size(addr));
+    }
 
-      // Forget the allocated size
-      AllocSizeVariable* alloc_size_var =
-          this->_var_factory.get_alloc_size(addr);
-      this->_inv.normal().integers().forget(alloc_size_var);
-      this->_inv.caught_exceptions().integers().forget(alloc_size_var);
-      this->_inv.propagated_exceptions().integers().forget(alloc_size_var);
+    if (vars.empty()) {
+      return;
+    }
 
-      // Set the memory location lifetime to deallocated
-      this->_inv.normal().lifetime().assign_deallocated(addr);
-      this->_inv.caught_exceptions().lifetime().assign_deallocated(addr);
-      this->_inv.propagated_exceptions().lifetime().assign_deallocated(addr);
+    this->apply_on_states([&](auto& inv) {
+      // Forget the allocated sizes at once
+      inv.integers().forget_vars(alloc_size_vars);
 
-      if (this->_precision >= Precision::Memory) {
-        // Forget the memory content
-        this->_inv.normal().forget_mem(addr);
-        this->_inv.caught_exceptions().forget_mem(addr);
-        this->_inv.propagated_exceptions().forget_mem(addr);
+      for (std::size_t i = 0; i < vars.size(); i++) {
+        // Set the memory location lifetime to deallocated
+        inv.lifetime().assign_deallocated(addrs[i]);
+
+        if (this->_precision >= Precision::Memory) {
+          // Forget the memory content
+          inv.forget_mem(addrs[i]);
+        }
+
+        // Forget local variable pointer
+        inv.forget_surface(vars[i]);
+      }
+    });
+  }
+
+  /// \brief Forget the surface of the given variables
+  ///
+  /// Integer variables are removed from the numerical domain at once.
+  void forget_variables(const std::vector< Variable* >& vars) {
+    std::vector< Variable* > ints;
+    for (Variable* var : vars) {
+      if (var->type()->is_integer()) {
+        ints.push_back(var);
+      }
+    }
+
+    this->apply_on_states([&](auto& inv) {
+      if (!ints.empty()) {
+        inv.integers().forget_vars(ints);
       }
+      for (Variable* var : vars) {
+        if (var->type()->is_integer()) {
+          inv.uninitialized().forget(var);
+        } else {
+          inv.forget_surface(var);
+        }
+      }
+    });
+  }
+
+  /// \brief Forget the memory locations that are no longer reachable
+  ///
+  /// Only local and dynamically allocated memory locations are collected.
+  /// Other memory locations (e.g, global variables) are always reachable.
+  void forget_unreachable_memory() {
+    if (this->_precision < Precision::Memory) {
+      return;
+    }
 
-      // Forget local variable pointer
-      this->_inv.normal().forget_surface(var);
-      this->_inv.caught_exceptions().forget_surface(var);
-      this->_inv.propagated_exceptions().forget_surface(var);
+    this->apply_on_states(
+        [this](auto& inv) { this->forget_unreachable_memory(inv); });
+  }
+
+private:
+  /// \brief Forget the unreachable memory locations in the given invariant
+  template < typename MemoryDomain >
+  void forget_unreachable_memory(MemoryDomain& inv) {
+    std::vector< MemoryLocation* > addrs =
+        inv.forget_unreachable_mem([](MemoryLocation* addr) {
+          return !isa< LocalMemoryLocation >(addr) &&
+                 !isa< DynAllocMemoryLocation >(addr);
+        });
+
+    if (addrs.empty()) {
+      return;
     }
+
+    // Forget the allocated sizes
+    std::vector< Variable* > alloc_size_vars;
+    alloc_size_vars.reserve(addrs.size());
+    for (MemoryLocation* addr : addrs) {
+      alloc_size_vars.push_back(this->_var_factory.get_alloc_size(addr));
+    }
+    inv.integers().forget_vars(alloc_size_vars);
   }
 
 public:
@@ -916,58 +1143,51 @@ public:
   void exec_enter(ar::BasicBlock*) override {}
 
   /// \brief Leave a basic block
+  void exec_leave(ar::BasicBlock*) override {}
+
+  /// \brief Leave a statement
   ///
-  /// Use the liveness analysis to remove dead variables
-  void exec_leave(ar::BasicBlock* bb) override {
+  /// Use the liveness analysis to remove the variables dead after the
+  /// statement, and the memory cells of the stack slot no longer loaded
+  void exec_leave(ar::Statement* s) override {
     if (this->_liveness == nullptr) {
       return;
     }
 
-    boost::optional< const LivenessAnalysis::VariableRefList& > dead =
-        this->_liveness->dead_at_end(bb);
-
-    if (!dead) {
+    // Do not remove the returned variable
+    if (isa< ar::ReturnValue >(s)) {
       return;
     }
 
-    // Do not remove the returned variable
-    Variable* returned_var = nullptr;
-    if (!bb->empty() && isa< ar::ReturnValue >(bb->back())) {
-      auto ret = cast< ar::ReturnValue >(bb->back());
-
-      if (ret->has_operand()) {
-        const Literal& v = this->_lit_factory.get(ret->operand());
-        if (v.is_scalar() && v.scalar().is_var()) {
-          returned_var = v.scalar().var();
-        } else if (v.is_aggregate() && v.aggregate().is_var()) {
-          returned_var = v.aggregate().var();
-        }
+    if (this->_precision >= Precision::Memory) {
+      if (ar::LocalVariable* slot = this->_liveness->dead_slot_after(s)) {
+        MemoryLocation* addr = this->_mem_factory.get_local(slot);
+        this->apply_on_states([=](auto& inv) { inv.forget_mem(addr); });
       }
     }
 
-    for (Variable* var : *dead) {
-      if (var == returned_var) { // Ignore
-        continue;
-      }
+    boost::optional< const LivenessAnalysis::VariableRefList& > dead =
+        this->_liveness->dead_after(s);
+
+    if (!dead) {
+      return;
+    }
 
+    for (Variable* var : *dead) {
       // Special case for aggregate internal variables: Clean-up the memory
       if (this->_precision >= Precision::Memory) {
         if (auto iv = dyn_cast< InternalVariable >(var)) {
           ar::InternalVariable* ar_iv = iv->internal_var();
           if (ar_iv->type()->is_aggregate()) {
             MemoryLocation* addr = this->_mem_factory.get_aggregate(ar_iv);
-            this->_inv.normal().forget_mem(addr);
-            this->_inv.caught_exceptions().forget_mem(addr);
-            this->_inv.propagated_exceptions().forget_mem(addr);
+            this->apply_on_states([=](auto& inv) { inv.forget_mem(addr); });
           }
         }
       }
-
-      // Clean-up memory surface
-      this->_inv.normal().forget_surface(var);
-      this->_inv.caught_exceptions().forget_surface(var);
-      this->_inv.propagated_exceptions().forget_surface(var);
     }
+
+    // Clean-up memory surface
+    this->forget_variables(*dead);
   }
 
   /// \brief Execute an edge from `src` to `dest`
@@ -998,8 +1218,8 @@ public:
     // initialize lazily global objects
     this->init_global_operand(s->operand());
 
-    this->assign(this->_lit_factory.get(s->result()),
-                 this->_lit_factory.get(s->operand()));
+    StatementLiterals lits = this->literals(s);
+    this->assign(lits.result(), lits.operand(0));
   }
 
   /// \brief Execute an UnaryOperation statement
@@ -1009,8 +1229,9 @@ public:
       return;
     }
 
-    const Literal& lhs = this->_lit_factory.get(s->result());
-    const Literal& rhs = this->_lit_factory.get(s->operand());
+    StatementLiterals lits = this->literals(s);
+    const Literal& lhs = lits.result();
+    const Literal& rhs = lits.operand(0);
 
     switch (s->op()) {
       case ar::UnaryOperation::UTrunc:
@@ -1259,9 +1480,10 @@ public:
       return;
     }
 
-    const ScalarLit& lhs = this->_lit_factory.get_scalar(s->result());
-    const ScalarLit& left = this->_lit_factory.get_scalar(s->left());
-    const ScalarLit& right = this->_lit_factory.get_scalar(s->right());
+    StatementLiterals lits = this->literals(s);
+    const ScalarLit& lhs = lits.scalar_result();
+    const ScalarLit& left = lits.scalar_operand(0);
+    const ScalarLit& right = lits.scalar_operand(1);
 
     switch (s->op()) {
       case ar::BinaryOperation::UAdd:
@@ -1366,6 +1588,32 @@ private:
     ikos_assert_msg(lhs.is_machine_int_var(),
                     "left hand side is not an integer variable");
 
+    // Fast path: if both operands are constants, compute the result
+    // concretely instead of building a linear expression
+    boost::optional< MachineInt > left_value = this->int_singleton(left);
+    boost::optional< MachineInt > right_value;
+    if (left_value) {
+      right_value = this->int_singleton(right);
+    }
+    if (left_value && right_value) {
+      if (boost::optional< MachineInt > n =
+              fixed_width_bin_operation(op, *left_value, *right_value)) {
+        this->_inv.normal().integers().assign(lhs.var(), *n);
+        return;
+      }
+
+      IntInterval result = apply_bin_operator(op,
+                                              IntInterval(*left_value),
+                                              IntInterval(*right_value));
+      if (result.is_bottom()) {
+        this->_inv.normal().integers().set(lhs.var(), result);
+        return;
+      } else if (boost::optional< MachineInt > n = result.singleton()) {
+        this->_inv.normal().integers().assign(lhs.var(), *n);
+        return;
+      }
+    }
+
     if (left.is_machine_int()) {
       if (right.is_machine_int()) {
         this->_inv.normal().integers().assign(lhs.var(), left.machine_int());
@@ -1400,6 +1648,54 @@ private:
     }
   }
 
+  /// \brief Compute `left op right` on integers of a common bit-width (see
+  /// core::dispatch_fixed_width), for the operators that never fail
+  ///
+  /// Return boost::none for other bit-widths and operators.
+  static boost::optional< MachineInt > fixed_width_bin_operation(
+      IntBinaryOperator op, const MachineInt& left, const MachineInt& right) {
+    return core::dispatch_fixed_width(
+        left.bit_width(),
+        left.sign(),
+        [&](auto width) -> boost::optional< MachineInt > {
+          using IntT = core::FixedMachineInt< decltype(width)::bit_width,
+                                              decltype(width)::sign >;
+          IntT x(left);
+          IntT y(right);
+          switch (op) {
+            case IntBinaryOperator::Add:
+              return (x + y).to_machine_int();
+            case IntBinaryOperator::Sub:
+              return (x - y).to_machine_int();
+            case IntBinaryOperator::Mul:
+              return (x * y).to_machine_int();
+            case IntBinaryOperator::And:
+              return (x & y).to_machine_int();
+            case IntBinaryOperator::Or:
+              return (x | y).to_machine_int();
+            case IntBinaryOperator::Xor:
+              return (x ^ y).to_machine_int();
+            default:
+              return boost::none;
+          }
+        },
+        boost::optional< MachineInt >());
+  }
+
+  /// \brief Return the value of an integer operand, if it is a singleton
+  ///
+  /// Variables are only queried with non-relational domains: on relational
+  /// domains, the query would close the invariant on each statement.
+  boost::optional< MachineInt > int_singleton(const ScalarLit& lit) const {
+    if (lit.is_machine_int()) {
+      return lit.machine_int();
+    } else if (lit.is_machine_int_var() && this->_cheap_int_queries) {
+      return this->_inv.normal().integers().to_interval(lit.var()).singleton();
+    } else {
+      return boost::none;
+    }
+  }
+
   /// \brief Execute a floating point binary operation
   void exec_float_bin_operation(const ScalarLit& lhs,
                                 const ScalarLit& /*left*/,
@@ -1428,8 +1724,9 @@ private:
 public:
   /// \brief Execute a Comparison statement
   void exec(ar::Comparison* s) override {
-    const ScalarLit& left = this->_lit_factory.get_scalar(s->left());
-    const ScalarLit& right = this->_lit_factory.get_scalar(s->right());
+    StatementLiterals lits = this->literals(s);
+    const ScalarLit& left = lits.scalar_operand(0);
+    const ScalarLit& right = lits.scalar_operand(1);
 
     if (left.is_undefined() || right.is_undefined()) {
       this->_inv.set_normal_flow_to_bottom();
@@ -1511,6 +1808,20 @@ private:
   void exec_int_comparison(IntPredicate pred,
                            const ScalarLit& left,
                            const ScalarLit& right) {
+    // Fast path: if both operands are constants, evaluate the comparison
+    // concretely instead of adding a constraint
+    boost::optional< MachineInt > left_value = this->int_singleton(left);
+    boost::optional< MachineInt > right_value;
+    if (left_value) {
+      right_value = this->int_singleton(right);
+    }
+    if (left_value && right_value) {
+      if (!compare(pred, *left_value, *right_value)) {
+        this->_inv.set_normal_flow_to_bottom();
+      }
+      return;
+    }
+
     if (left.is_machine_int()) {
       if (right.is_machine_int()) {
         if (!compare(pred, left.machine_int(), right.machine_int())) {
@@ -1608,9 +1919,9 @@ public:
       return;
     }
 
-    const ScalarLit& lhs = this->_lit_factory.get_scalar(s->result());
-    const ScalarLit& array_size =
-        this->_lit_factory.get_scalar(s->array_size());
+    StatementLiterals lits = this->literals(s);
+    const ScalarLit& lhs = lits.scalar_result();
+    const ScalarLit& array_size = lits.scalar_operand(0);
     ikos_assert_msg(lhs.is_pointer_var(),
                     "left hand side is not a pointer variable");
 
@@ -1657,8 +1968,9 @@ public:
     // initialize lazily global objects
     this->init_global_operand(s->pointer());
 
-    const ScalarLit& lhs = this->_lit_factory.get_scalar(s->result());
-    const ScalarLit& base = this->_lit_factory.get_scalar(s->pointer());
+    StatementLiterals lits = this->literals(s);
+    const ScalarLit& lhs = lits.scalar_result();
+    const ScalarLit& base = lits.scalar_operand(0);
     ikos_assert_msg(lhs.is_pointer_var(),
                     "left hand side is not a pointer variable");
 
@@ -1674,9 +1986,10 @@ public:
     unsigned bit_width = this->_data_layout.pointers.bit_width;
     IntLinearExpression offset_expr(MachineInt::zero(bit_width, Unsigned));
 
-    for (auto it = s->term_begin(), et = s->term_end(); it != et; ++it) {
+    std::size_t i = 1;
+    for (auto it = s->term_begin(), et = s->term_end(); it != et; ++it, ++i) {
       auto term = *it;
-      const ScalarLit& offset = this->_lit_factory.get_scalar(term.second);
+      const ScalarLit& offset = lits.scalar_operand(i);
 
       if (offset.is_undefined()) {
         this->_inv.set_normal_flow_to_bottom();
@@ -1712,13 +2025,14 @@ public:
     // initialize lazily global objects
     this->init_global_operand(s->operand());
 
-    const ScalarLit& ptr = this->_lit_factory.get_scalar(s->operand());
+    StatementLiterals lits = this->literals(s);
+    const ScalarLit& ptr = lits.scalar_operand(0);
 
     if (!this->prepare_mem_access(ptr)) {
       return;
     }
 
-    const Literal& result = this->_lit_factory.get(s->result());
+    const Literal& result = lits.result();
 
     MachineInt size(this->_data_layout.store_size_in_bytes(s->result()->type()),
                     this->_data_layout.pointers.bit_width,
@@ -1764,7 +2078,8 @@ public:
     // initialize lazily global objects
     this->init_global_operand(s->pointer());
 
-    const ScalarLit& ptr = this->_lit_factory.get_scalar(s->pointer());
+    StatementLiterals lits = this->literals(s);
+    const ScalarLit& ptr = lits.scalar_operand(0);
 
     if (!this->prepare_mem_access(ptr)) {
       return;
@@ -1779,7 +2094,7 @@ public:
     // initialize lazily global objects
     this->init_global_operand(s->value());
 
-    const Literal& val = this->_lit_factory.get(s->value());
+    const Literal& val = lits.operand(1);
 
     MachineInt size(this->_data_layout.store_size_in_bytes(s->value()->type()),
                     this->_data_layout.pointers.bit_width,
@@ -1814,9 +2129,10 @@ public:
 
   /// \brief Execute an ExtractElement statement
   void exec(ar::ExtractElement* s) override {
-    const Literal& lhs = this->_lit_factory.get(s->result());
-    const AggregateLit& rhs = this->_lit_factory.get_aggregate(s->aggregate());
-    const ScalarLit& offset = this->_lit_factory.get_scalar(s->offset());
+    StatementLiterals lits = this->literals(s);
+    const Literal& lhs = lits.result();
+    const AggregateLit& rhs = lits.aggregate_operand(0);
+    const ScalarLit& offset = lits.scalar_operand(1);
     ikos_assert_msg(rhs.is_var(), "right hand side is not a variable");
 
     if (this->_precision < Precision::Memory) {
@@ -1860,10 +2176,11 @@ public:
 
   /// \brief Execute an InsertElement statement
   void exec(ar::InsertElement* s) override {
-    const AggregateLit& lhs = this->_lit_factory.get_aggregate(s->result());
-    const AggregateLit& rhs = this->_lit_factory.get_aggregate(s->aggregate());
-    const ScalarLit& offset = this->_lit_factory.get_scalar(s->offset());
-    const Literal& element = this->_lit_factory.get(s->element());
+    StatementLiterals lits = this->literals(s);
+    const AggregateLit& lhs = lits.aggregate_result();
+    const AggregateLit& rhs = lits.aggregate_operand(0);
+    const ScalarLit& offset = lits.scalar_operand(1);
+    const Literal& element = lits.operand(2);
     ikos_assert_msg(lhs.is_var(), "left hand side is not a variable");
 
     if (this->_precision < Precision::Memory) {
@@ -2004,6 +2321,9 @@ public:
       case ar::Intrinsic::IkosCounterIncr: {
         this->exec_ikos_counter_incr(call);
       } break;
+      case ar::Intrinsic::IkosCounterForget: {
+        this->exec_ikos_counter_forget(call);
+      } break;
       case ar::Intrinsic::IkosPrintInvariant:
       case ar::Intrinsic::IkosPrintValues: {
         this->exec_unknown_call(call,
@@ -2415,6 +2735,57 @@ public:
     }
   }
 
+  /// \brief Execute a call to a function with a library summary
+  ///
+  /// Return false if there is no summary for the given function, see
+  /// LibrarySummaries.
+  bool exec_summarized_call(ar::CallBase* call, ar::Function* fun) {
+    if (this->_ctx.library_summaries == nullptr) {
+      return false;
+    }
+    const LibrarySummary* summary = this->_ctx.library_summaries->lookup(fun);
+    if (summary == nullptr) {
+      return false;
+    }
+
+    this->exec_unknown_call(call,
+                            /* may_write_params = */ summary->writes_memory,
+                            /* ignore_unknown_write = */ false,
+                            /* may_write_globals = */ summary->writes_memory,
+                            /* may_throw_exc = */ summary->may_throw);
+
+    if (this->_inv.is_normal_flow_bottom()) {
+      return true;
+    }
+    if (!summary->returns) {
+      this->_inv.set_normal_flow_to_bottom();
+      return true;
+    }
+    if (!call->has_result() ||
+        !isa< ar::IntegerType >(call->result()->type())) {
+      return true;
+    }
+
+    // Refine the result with the bounds of the summary
+    const ScalarLit& ret = this->_lit_factory.get_scalar(call->result());
+    if (!ret.is_machine_int_var()) {
+      return true;
+    }
+    auto type = cast< ar::IntegerType >(call->result()->type());
+    MachineInt lb = MachineInt::min(type->bit_width(), type->sign());
+    MachineInt ub = MachineInt::max(type->bit_width(), type->sign());
+    if (summary->return_lb && *summary->return_lb > lb.to_z_number() &&
+        *summary->return_lb <= ub.to_z_number()) {
+      lb = MachineInt(*summary->return_lb, type->bit_width(), type->sign());
+    }
+    if (summary->return_ub && *summary->return_ub < ub.to_z_number() &&
+        *summary->return_ub >= lb.to_z_number()) {
+      ub = MachineInt(*summary->return_ub, type->bit_width(), type->sign());
+    }
+    this->_inv.normal().integers().refine(ret.var(), IntInterval(lb, ub));
+    return true;
+  }
+
 private:
   /// @}
   /// \name Execution of intrinsic functions
@@ -2532,6 +2903,20 @@ private:
     this->_inv.normal().uninitialized().assign_initialized(ret.var());
   }
 
+  /// \brief Execute a call to ikos.counter.forget
+  void exec_ikos_counter_forget(ar::CallBase* call) {
+    ikos_assert(!call->has_result());
+    ikos_assert(call->num_arguments() == 1);
+
+    const ScalarLit& counter = this->_lit_factory.get_scalar(call->argument(0));
+
+    ikos_assert_msg(counter.is_machine_int_var(),
+                    "operand is not an integer variable");
+
+    this->_inv.normal().integers().forget_counter(counter.var());
+    this->_inv.normal().uninitialized().forget(counter.var());
+  }
+
   /// \brief Execute a dynamic allocation
   void exec_dynamic_alloc(ar::CallBase* call,
                           ar::Value* size,
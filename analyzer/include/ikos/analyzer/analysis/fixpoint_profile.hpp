@@ -43,17 +43,22 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include <boost/optional.hpp>
 
+#include <llvm/ADT/ArrayRef.h>
 #include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
 
 #include <ikos/core/number/machine_int.hpp>
 
 #include <ikos/ar/semantic/code.hpp>
 
 #include <ikos/analyzer/analysis/context.hpp>
+#include <ikos/analyzer/analysis/tuning_profile.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -77,7 +82,33 @@ class FixpointProfile;
 /// \endcode
 ///
 /// It will mark the constant '10' as a widening hint.
+///
+/// Each cycle head gets a sequence of widening thresholds: the constant of the
+/// loop guard first, then the constant operands of the comparisons in the
+/// cycle and the sizes of the local arrays of the function, in increasing
+/// order. The i-th widening on a cycle uses the i-th threshold.
+///
+/// It also selects the widening points: the heads of the weak topological
+/// order are not always a minimal cycle cutset, e.g. when all the cycles
+/// through an outer head go through the head of a nested cycle. Heads are
+/// visited from the innermost cycles, and a head is only a widening point if
+/// one of its cycles avoids the widening points already selected. Other heads
+/// join for a few more iterations before widening: nested cycles are iterated
+/// again from their entry invariant on each iteration of their parent, so the
+/// parent still needs a widening to converge in the worst case.
+///
+/// Finally, the tuning profile of a previous run (-tuning) can override the
+/// widening delay and limit the widening thresholds of a cycle, and lower the
+/// precision of a function, see TuningProfile.
 class FixpointProfileAnalysis {
+public:
+  /// \brief Maximum number of widening thresholds for a cycle head
+  static const std::size_t MaxWideningThresholds;
+
+  /// \brief Number of additional joins before widening on a cycle head that
+  /// is not a widening point
+  static const unsigned MaxJoinIterations;
+
 private:
   /// \brief Analysis context
   Context& _ctx;
@@ -85,6 +116,12 @@ private:
   /// \brief Map that associates a function to a fixpoint profile
   llvm::DenseMap< ar::Function*, std::unique_ptr< FixpointProfile > > _map;
 
+  /// \brief Map that associates a function to its estimated cost
+  llvm::DenseMap< ar::Function*, std::uint64_t > _costs;
+
+  /// \brief Tuning profile of a previous run
+  TuningProfile _tuning;
+
 public:
   /// \brief Constructor
   FixpointProfileAnalysis(Context& ctx) : _ctx(ctx) {}
@@ -110,26 +147,65 @@ public:
   /// \brief Return the profile associated with a function
   boost::optional< const FixpointProfile& > profile(ar::Function*) const;
 
+  /// \brief Remove the profile associated with a function
+  ///
+  /// This is not thread-safe.
+  void release(ar::Function*);
+
+  /// \brief Return an estimate of the cost of a fixpoint on the given
+  /// function, used to report the progress of the analysis
+  ///
+  /// Each statement costs one per expected iteration: cycles are expected to
+  /// be iterated twice, plus once per widening threshold. Returns 1 for a
+  /// function without definition.
+  std::uint64_t cost(ar::Function*) const;
+
 private:
   /// \brief Analyze a function
-  std::unique_ptr< FixpointProfile > analyze_function(ar::Function*);
+  ///
+  /// This is thread-safe.
+  std::unique_ptr< FixpointProfile > analyze_function(ar::Function*) const;
+
+  /// \brief Apply the tuning profile on the given cycle heads
+  void tune(FixpointProfile&, const std::vector< ar::BasicBlock* >& heads) const;
+
+  /// \brief Estimate the cost of a fixpoint on a function
+  ///
+  /// This is thread-safe.
+  std::uint64_t estimate_cost(ar::Function*, const FixpointProfile*) const;
 
 }; // end class FixpointProfileAnalysis
 
+/// \brief Return the estimated cost of a fixpoint on the given function, or 1
+/// if the fixpoint profile analysis did not run
+inline std::uint64_t fixpoint_cost(const Context& ctx, ar::Function* fun) {
+  return ctx.fixpoint_profiler != nullptr ? ctx.fixpoint_profiler->cost(fun)
+                                          : 1;
+}
+
 /// \brief A fixpoint profile
 ///
 /// A fixpoint profile is associated with a function.
 /// Inside a function, if there are some cycles, it will associate the head of
-/// each cycle with a widening hint, if found.
+/// each cycle with a sequence of widening thresholds, if found.
 class FixpointProfile {
 private:
   /// \brief Function associated to the profile
   ar::Function* _function;
 
-  /// \brief Map of widening hints associated to a given block
-  llvm::DenseMap< ar::BasicBlock*, std::unique_ptr< core::MachineInt > >
+  /// \brief Map of widening thresholds associated to a given block
+  llvm::DenseMap< ar::BasicBlock*, std::vector< core::MachineInt > >
       _widening_hints;
 
+  /// \brief Cycle heads that are not widening points
+  llvm::DenseSet< ar::BasicBlock* > _join_heads;
+
+  /// \brief Widening delays from the tuning profile
+  llvm::DenseMap< ar::BasicBlock*, unsigned > _widening_delays;
+
+  /// \brief Lower precision from the tuning profile, or boost::none
+  boost::optional< Precision > _precision;
+
   /// \brief Constructor
   FixpointProfile(ar::Function* fun) : _function(fun) {}
 
@@ -137,11 +213,38 @@ public:
   /// \brief Return the function associated to the profile
   ar::Function* function() const { return this->_function; }
 
-  /// \brief Return an widening hint for a given basic block, if exists
-  boost::optional< const core::MachineInt& > widening_hint(
+  /// \brief Return the sequence of widening thresholds for a given basic block
+  llvm::ArrayRef< core::MachineInt > widening_thresholds(
       ar::BasicBlock*) const;
 
-  /// \brief Return true if there is at least one widening hint
+  /// \brief Return true if the given cycle head is a widening point
+  bool is_widening_point(ar::BasicBlock*) const;
+
+  /// \brief Return the number of increasing iterations that join instead of
+  /// widening on the given cycle head, after the first one
+  unsigned widening_delay(ar::BasicBlock*) const;
+
+  /// \brief Return true if the given increasing iteration on a cycle head
+  /// should join instead of widening
+  ///
+  /// The first iteration always joins. Heads that are not widening points join
+  /// for widening_delay() more iterations.
+  bool join_iteration(ar::BasicBlock*, unsigned iteration) const;
+
+  /// \brief Return the widening hint for a given basic block at the given
+  /// increasing iteration, if exists
+  ///
+  /// The first widening happens after the join iterations and uses the first
+  /// threshold.
+  boost::optional< const core::MachineInt& > widening_hint(
+      ar::BasicBlock*, unsigned iteration) const;
+
+  /// \brief Return the precision of the function from the tuning profile, if
+  /// it should be lower than the precision of the analysis
+  boost::optional< Precision > precision() const { return this->_precision; }
+
+  /// \brief Return true if there is no widening hint, all cycle heads are
+  /// widening points and there is no tuning
   bool empty() const;
 
   /// \brief Dump the fixpoint profile, for debugging purpose
@@ -61,12 +61,14 @@ namespace analyzer {
 /// \brief Class that handles a set of readable/writable addresses
 ///
 /// We can declare hardware addresses with an argument or by giving a file
+///
+/// Ranges are kept sorted and merged, so that lookups are binary searches.
 class HardwareAddresses {
 private:
   using Interval = core::machine_int::Interval;
 
 private:
-  /// \brief Range of hardware addresses
+  /// \brief Disjoint and non-adjacent ranges of hardware addresses, sorted
   std::vector< Interval > _address_ranges;
 
   const ar::DataLayout& _data_layout;
@@ -84,7 +86,7 @@ public:
   /// \brief Add a range from a file
   void add_range_from_file(const std::string&);
 
-  /// \brief Get all the ranges
+  /// \brief Get all the ranges, sorted and merged
   const std::vector< Interval >& ranges() const {
     return this->_address_ranges;
   }
@@ -99,9 +101,13 @@ public:
   void dump(std::ostream& o) const;
 
 private:
-  /// \brief Add a range
+  /// \brief Add a range, merging it with overlapping and adjacent ranges
   void add_range(Interval);
 
+  /// \brief Return the first range that does not end before the given address
+  std::vector< Interval >::const_iterator lower_bound(
+      const core::MachineInt& addr) const;
+
 }; // end class HardwareAddresses
 
 /// \brief Exception for HardwareAddresses
@@ -45,14 +45,20 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include <boost/variant.hpp>
 #include <boost/version.hpp>
 
+#include <llvm/ADT/DenseMap.h>
+
 #include <ikos/core/literal.hpp>
 
+#include <ikos/ar/semantic/code.hpp>
 #include <ikos/ar/semantic/data_layout.hpp>
+#include <ikos/ar/semantic/function.hpp>
 #include <ikos/ar/semantic/value.hpp>
 
 #include <ikos/analyzer/analysis/aggregate_literal.hpp>
@@ -60,6 +66,7 @@
 #include <ikos/analyzer/analysis/variable.hpp>
 #include <ikos/analyzer/exception.hpp>
 #include <ikos/analyzer/support/number.hpp>
+#include <ikos/analyzer/util/sharded_map.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -309,6 +316,105 @@ public:
 
 }; // end class AggregateLiteralError
 
+class LiteralFactory;
+
+/// \brief Literals of the result and operands of a statement
+///
+/// This is a view on a row of a CodeLiterals table.
+class StatementLiterals {
+private:
+  /// \brief Literal factory
+  LiteralFactory* _lfac;
+
+  /// \brief Statement
+  ar::Statement* _stmt;
+
+  /// \brief Literal of the result (or null), followed by the operands
+  ///
+  /// A literal is null if it could not be created.
+  const Literal* const* _row;
+
+public:
+  /// \brief Constructor
+  StatementLiterals(LiteralFactory& lfac,
+                    ar::Statement* stmt,
+                    const Literal* const* row)
+      : _lfac(&lfac), _stmt(stmt), _row(row) {}
+
+  /// \brief Return the literal of the result
+  const Literal& result() const;
+
+  /// \brief Return the literal of the i-th operand
+  const Literal& operand(std::size_t i) const;
+
+  /// \brief Return the scalar literal of the result
+  ///
+  /// \throw AggregateLiteralError
+  const ScalarLit& scalar_result() const;
+
+  /// \brief Return the scalar literal of the i-th operand
+  ///
+  /// \throw AggregateLiteralError
+  const ScalarLit& scalar_operand(std::size_t i) const;
+
+  /// \brief Return the aggregate literal of the result
+  ///
+  /// \throw ScalarLiteralError
+  const AggregateLit& aggregate_result() const;
+
+  /// \brief Return the aggregate literal of the i-th operand
+  ///
+  /// \throw ScalarLiteralError
+  const AggregateLit& aggregate_operand(std::size_t i) const;
+
+}; // end class StatementLiterals
+
+/// \brief Literals of the statements of a code
+///
+/// Flat table of the literals of the result and operands of every statement,
+/// built once per code. Reading it requires no lock, and only one lookup per
+/// statement.
+class CodeLiterals {
+private:
+  /// \brief Literal factory
+  LiteralFactory& _lfac;
+
+  /// \brief Code
+  ar::Code* _code;
+
+  /// \brief Rows of literals, see StatementLiterals
+  std::vector< const Literal* > _literals;
+
+  /// \brief Map from statement to the index of its row in _literals
+  llvm::DenseMap< ar::Statement*, unsigned > _rows;
+
+public:
+  /// \brief Build the table of the given code
+  CodeLiterals(LiteralFactory& lfac, ar::Code* code);
+
+  /// \brief Deleted copy constructor
+  CodeLiterals(const CodeLiterals&) = delete;
+
+  /// \brief Deleted move constructor
+  CodeLiterals(CodeLiterals&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  CodeLiterals& operator=(const CodeLiterals&) = delete;
+
+  /// \brief Deleted move assignment operator
+  CodeLiterals& operator=(CodeLiterals&&) = delete;
+
+  /// \brief Destructor
+  ~CodeLiterals();
+
+  /// \brief Return the code
+  ar::Code* code() const { return this->_code; }
+
+  /// \brief Return the literals of the given statement of the code
+  StatementLiterals get(ar::Statement* stmt) const;
+
+}; // end class CodeLiterals
+
 /// \brief Create literals from AR values
 class LiteralFactory {
 private:
@@ -316,7 +422,13 @@ private:
   ///
   /// Must be a data structure that does not invalidate references on
   /// insertions.
-  using Map = std::unordered_map< ar::Value*, Literal >;
+  using Map = ShardedMap< std::unordered_map< ar::Value*, Literal >,
+                          DenseMapInfoHash< ar::Value* > >;
+
+  /// \brief Map from ar::Code* to CodeLiterals
+  using CodeMap =
+      ShardedMap< llvm::DenseMap< ar::Code*, std::unique_ptr< CodeLiterals > >,
+                  DenseMapInfoHash< ar::Code* > >;
 
 private:
   /// \brief Variable factory
@@ -328,6 +440,9 @@ private:
   /// \brief Map from ar::Value* to Literal
   Map _map;
 
+  /// \brief Map from ar::Code* to the literals of its statements
+  CodeMap _code_map;
+
 public:
   /// \brief Constructor
   LiteralFactory(VariableFactory& vfac, const ar::DataLayout& data_layout);
@@ -362,6 +477,17 @@ public:
   /// This also adds the translation into the cache
   const Literal& get(ar::Value* value);
 
+  /// \brief Return the literals of the statements of the given code
+  ///
+  /// The table is built on the first call.
+  const CodeLiterals& get(ar::Code* code);
+
+  /// \brief Remove the literals of the body, local variables and parameters
+  /// of the given function
+  ///
+  /// References on these literals are invalidated.
+  void release(ar::Function* fun);
+
 private:
   /// \brief Translate an ar::Value* into a Literal
   Literal create_literal(ar::Value* value);
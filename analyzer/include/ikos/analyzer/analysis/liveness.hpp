@@ -46,6 +46,7 @@
 #pragma once
 
 #include <iosfwd>
+#include <utility>
 #include <vector>
 
 #include <boost/optional.hpp>
@@ -68,6 +69,31 @@ private:
   /// \brief Map from basic block to a list of variables
   using VariableRefMap = llvm::DenseMap< ar::BasicBlock*, VariableRefList >;
 
+  /// \brief Map from statement to a list of variables
+  using StatementVariableRefMap =
+      llvm::DenseMap< ar::Statement*, VariableRefList >;
+
+  /// \brief Map from statement to a local variable
+  using StatementLocalVariableMap =
+      llvm::DenseMap< ar::Statement*, ar::LocalVariable* >;
+
+public:
+  /// \brief Results of the analysis on a code
+  ///
+  /// Each code is analyzed by a separate task that only writes in its own
+  /// results. They are moved into the maps once all tasks are done.
+  struct CodeResults {
+    /// \brief List of live variables at the entry of each basic block
+    std::vector< std::pair< ar::BasicBlock*, VariableRefList > > live_at_entry;
+
+    /// \brief List of variables dead after each statement, if any
+    std::vector< std::pair< ar::Statement*, VariableRefList > > dead_after;
+
+    /// \brief Stack slot dead after each load or store, if any
+    std::vector< std::pair< ar::Statement*, ar::LocalVariable* > >
+        dead_slot_after;
+  };
+
 private:
   /// \brief Analysis context
   Context& _ctx;
@@ -75,8 +101,18 @@ private:
   /// \brief List of live variables at the entry of a basic block
   VariableRefMap _live_at_entry_map;
 
-  /// \brief List of dead variables at the end of a basic block
-  VariableRefMap _dead_at_end_map;
+  /// \brief List of variables dead after a statement
+  ///
+  /// These are the variables used or defined by the statement that are not
+  /// used afterwards.
+  StatementVariableRefMap _dead_after_map;
+
+  /// \brief Stack slot dead after a load or store
+  ///
+  /// A stack slot is a local variable whose address is only used as the
+  /// pointer operand of loads and stores. It is dead after a statement if it
+  /// is not loaded afterwards, hence its memory cells can be forgotten.
+  StatementLocalVariableMap _dead_slot_after_map;
 
 public:
   /// \brief Constructor
@@ -103,18 +139,28 @@ public:
   boost::optional< const VariableRefList& > live_at_entry(
       ar::BasicBlock* bb) const;
 
-  /// \brief Return a list of dead variables at the end of the given block
+  /// \brief Return a list of variables dead after the given statement
   ///
-  /// Returns boost::none if we have no information
-  boost::optional< const VariableRefList& > dead_at_end(
-      ar::BasicBlock* bb) const;
+  /// Returns boost::none if no variable dies after the statement
+  boost::optional< const VariableRefList& > dead_after(
+      ar::Statement* stmt) const;
+
+  /// \brief Return the stack slot dead after the given load or store, or null
+  ar::LocalVariable* dead_slot_after(ar::Statement* stmt) const;
 
   /// \brief Run the analysis
   void run();
 
+  /// \brief Remove the results on the given code
+  ///
+  /// This is not thread-safe.
+  void release(ar::Code* code);
+
 private:
   /// \brief Run the analysis on the given code
-  void run(ar::Code* code);
+  ///
+  /// This is thread-safe.
+  CodeResults run(ar::Code* code) const;
 
 public:
   /// \brief Dump the liveness analysis results, for debugging purpose
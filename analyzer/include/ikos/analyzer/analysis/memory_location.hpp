@@ -45,6 +45,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -55,6 +56,9 @@
 #include <ikos/core/semantic/dumpable.hpp>
 #include <ikos/core/semantic/indexable.hpp>
 #include <ikos/core/semantic/memory_location.hpp>
+#ifdef IKOS_ANALYZER_FLAT_POINTS_TO_SET
+#include <ikos/core/value/pointer/points_to_set.hpp>
+#endif
 
 #include <ikos/ar/semantic/function.hpp>
 #include <ikos/ar/semantic/statement.hpp>
@@ -62,6 +66,7 @@
 
 #include <ikos/analyzer/analysis/call_context.hpp>
 #include <ikos/analyzer/support/number.hpp>
+#include <ikos/analyzer/util/sharded_map.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -92,6 +97,18 @@ protected:
   /// \brief Kind of the MemoryLocation
   MemoryLocationKind _kind;
 
+private:
+  /// \brief Dense identifier, given by the MemoryFactory
+  core::Index _id = 0;
+
+  /// \brief Function of the memory location, or null for the global scope
+  ar::Function* _scope = nullptr;
+
+  /// \brief Dense identifier within the scope, given by the MemoryFactory
+  std::size_t _scope_id = 0;
+
+  friend class MemoryFactory;
+
 protected:
   /// \brief Protected constructor
   explicit MemoryLocation(MemoryLocationKind kind);
@@ -115,6 +132,24 @@ public:
   /// \brief Return the kind of the object
   MemoryLocationKind kind() const { return this->_kind; }
 
+  /// \brief Return the dense identifier of the memory location
+  ///
+  /// Identifiers are sequential, starting at 0, in order of creation.
+  core::Index id() const { return this->_id; }
+
+  /// \brief Return the scope of the memory location
+  ///
+  /// Local memory locations and aggregates of a function body belong to the
+  /// scope of their function. Other memory locations belong to the global
+  /// scope, represented by null.
+  ar::Function* scope() const { return this->_scope; }
+
+  /// \brief Return the dense identifier of the memory location within its
+  /// scope
+  ///
+  /// Identifiers are sequential, starting at 0, in order of creation.
+  std::size_t scope_id() const { return this->_scope_id; }
+
   /// \brief Dump the memory location, for debugging purpose
   virtual void dump(std::ostream&) const = 0;
 
@@ -299,29 +334,51 @@ public:
 /// \brief Management of memory locations
 class MemoryFactory {
 private:
-  llvm::DenseMap< ar::LocalVariable*, std::unique_ptr< LocalMemoryLocation > >
-      _local_memory_map;
+  /// \brief Sharded map using the given key and memory location type
+  template < typename Key, typename T >
+  using MemoryMap = ShardedMap< llvm::DenseMap< Key, std::unique_ptr< T > >,
+                                DenseMapInfoHash< Key > >;
 
-  llvm::DenseMap< ar::GlobalVariable*, std::unique_ptr< GlobalMemoryLocation > >
-      _global_memory_map;
+  MemoryMap< ar::LocalVariable*, LocalMemoryLocation > _local_memory_map;
 
-  llvm::DenseMap< ar::Function*, std::unique_ptr< FunctionMemoryLocation > >
-      _function_memory_map;
+  MemoryMap< ar::GlobalVariable*, GlobalMemoryLocation > _global_memory_map;
 
-  llvm::DenseMap< ar::InternalVariable*,
-                  std::unique_ptr< AggregateMemoryLocation > >
+  MemoryMap< ar::Function*, FunctionMemoryLocation > _function_memory_map;
+
+  MemoryMap< ar::InternalVariable*, AggregateMemoryLocation >
       _aggregate_memory_map;
 
-  llvm::StringMap< std::unique_ptr< VaArgMemoryLocation > > _va_arg_map;
+  ShardedMap< llvm::StringMap< std::unique_ptr< VaArgMemoryLocation > >,
+              DenseMapInfoHash< llvm::StringRef > >
+      _va_arg_map;
 
   std::unique_ptr< AbsoluteZeroMemoryLocation > _absolute_zero_memory;
 
   std::unique_ptr< ArgvMemoryLocation > _argv_memory;
 
-  llvm::DenseMap< std::pair< ar::CallBase*, CallContext* >,
-                  std::unique_ptr< DynAllocMemoryLocation > >
+  MemoryMap< std::pair< ar::CallBase*, CallContext* >, DynAllocMemoryLocation >
       _dyn_alloc_map;
 
+  /// \brief Identifier of the next memory location
+  std::atomic< core::Index > _next_id;
+
+  /// \brief Identifier of the next memory location of each scope
+  MemoryMap< ar::Function*, std::atomic< std::size_t > > _next_scope_id;
+
+private:
+  /// \brief Give the next identifiers to a new memory location of the given
+  /// scope
+  template < typename T >
+  std::unique_ptr< T > with_id(T* mem, ar::Function* scope = nullptr) {
+    auto m = static_cast< MemoryLocation* >(mem);
+    m->_id = this->_next_id++;
+    m->_scope = scope;
+    m->_scope_id = (*this->_next_scope_id.get_or_create(scope, [] {
+      return std::make_unique< std::atomic< std::size_t > >(0);
+    }))++;
+    return std::unique_ptr< T >(mem);
+  }
+
 public:
   /// \brief Default constructor for factory
   MemoryFactory();
@@ -380,13 +437,28 @@ namespace core {
 
 /// \brief Implement IndexableTraits for MemoryLocation*
 ///
-/// The index of MemoryLocation* is the address of the pointer
+/// The index of MemoryLocation* is its dense identifier, which keeps patricia
+/// trees shallow and points-to sets ordered by creation.
 template <>
 struct IndexableTraits< analyzer::MemoryLocation* > {
-  static Index index(const analyzer::MemoryLocation* m) {
-    return reinterpret_cast< Index >(m);
+  static Index index(const analyzer::MemoryLocation* m) { return m->id(); }
+
+  static Index scope(const analyzer::MemoryLocation* m) {
+    return reinterpret_cast< Index >(m->scope());
   }
+
+  static std::size_t dense_index(const analyzer::MemoryLocation* m) {
+    return m->scope_id();
+  }
+};
+
+#ifdef IKOS_ANALYZER_FLAT_POINTS_TO_SET
+/// \brief Store points-to sets in sorted arrays of memory locations
+template <>
+struct PointsToSetTraits< analyzer::MemoryLocation* > {
+  using SetT = FlatSet< analyzer::MemoryLocation* >;
 };
+#endif
 
 /// \brief Implement DumpableTraits for MemoryLocation*
 template <>
@@ -43,6 +43,8 @@
 
 #pragma once
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/optional.hpp>
@@ -63,13 +65,18 @@ class SettingsTable;
 /// \brief Machine integer abstract domain
 enum class MachineIntDomainOption {
   Interval,
+  DenseInterval,
   Congruence,
   IntervalCongruence,
+  IntervalEquality,
   DBM,
+  SplitDBM,
   VarPackDBM,
   VarPackDBMCongruence,
+  StaticPackDBM,
   Gauge,
   GaugeIntervalCongruence,
+  PowersetInterval,
   ApronInterval,
   ApronOctagon,
   ApronPolkaPolyhedra,
@@ -90,20 +97,30 @@ inline const char* machine_int_domain_option_str(MachineIntDomainOption d) {
   switch (d) {
     case MachineIntDomainOption::Interval:
       return "interval";
+    case MachineIntDomainOption::DenseInterval:
+      return "dense-interval";
     case MachineIntDomainOption::Congruence:
       return "congruence";
     case MachineIntDomainOption::IntervalCongruence:
       return "interval-congruence";
+    case MachineIntDomainOption::IntervalEquality:
+      return "interval-equality";
     case MachineIntDomainOption::DBM:
       return "dbm";
+    case MachineIntDomainOption::SplitDBM:
+      return "split-dbm";
     case MachineIntDomainOption::VarPackDBM:
       return "var-pack-dbm";
     case MachineIntDomainOption::VarPackDBMCongruence:
       return "var-pack-dbm-congruence";
+    case MachineIntDomainOption::StaticPackDBM:
+      return "static-pack-dbm";
     case MachineIntDomainOption::Gauge:
       return "gauge";
     case MachineIntDomainOption::GaugeIntervalCongruence:
       return "gauge-interval-congruence";
+    case MachineIntDomainOption::PowersetInterval:
+      return "powerset-interval";
     case MachineIntDomainOption::ApronInterval:
       return "apron-interval";
     case MachineIntDomainOption::ApronOctagon:
@@ -155,6 +172,45 @@ inline bool machine_int_domain_option_has_narrowing(MachineIntDomainOption d) {
   }
 }
 
+/// \brief Return true if the MachineIntDomainOption is non-relational
+///
+/// Querying the interval of a variable is then cheap, since it does not
+/// require a closure.
+inline bool machine_int_domain_option_is_non_relational(
+    MachineIntDomainOption d) {
+  switch (d) {
+    case MachineIntDomainOption::Interval:
+    case MachineIntDomainOption::DenseInterval:
+    case MachineIntDomainOption::Congruence:
+    case MachineIntDomainOption::IntervalCongruence:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// \brief Return true if the MachineIntDomainOption relies on APRON
+inline bool machine_int_domain_option_is_apron(MachineIntDomainOption d) {
+  switch (d) {
+    case MachineIntDomainOption::ApronInterval:
+    case MachineIntDomainOption::ApronOctagon:
+    case MachineIntDomainOption::ApronPolkaPolyhedra:
+    case MachineIntDomainOption::ApronPolkaLinearEqualities:
+    case MachineIntDomainOption::ApronPplPolyhedra:
+    case MachineIntDomainOption::ApronPplLinearCongruences:
+    case MachineIntDomainOption::ApronPkgridPolyhedraLinearCongruences:
+    case MachineIntDomainOption::VarPackApronOctagon:
+    case MachineIntDomainOption::VarPackApronPolkaPolyhedra:
+    case MachineIntDomainOption::VarPackApronPolkaLinearEqualities:
+    case MachineIntDomainOption::VarPackApronPplPolyhedra:
+    case MachineIntDomainOption::VarPackApronPplLinearCongruences:
+    case MachineIntDomainOption::VarPackApronPkgridPolyhedraLinearCongruences:
+      return true;
+    default:
+      return false;
+  }
+}
+
 /// \brief Represents the precision of an analysis
 enum class Precision {
   /// \brief Only track values in "registers", ie. ar::InternalVariable
@@ -260,6 +316,36 @@ enum class DisplayOption {
   None,
 };
 
+/// \brief Shard of a distributed analysis
+///
+/// The entry points (interprocedural) or the functions (intraprocedural) are
+/// split into shards, analyzed separately, for instance on different nodes.
+/// The output databases are then merged with ikos-merge.
+struct ShardOption {
+  /// \brief Index of the shard, in [0, count)
+  unsigned index;
+
+  /// \brief Number of shards
+  unsigned count;
+
+  /// \brief Return the functions of the shard, preserving their order
+  ///
+  /// Functions are assigned to shards in a round-robin fashion after sorting
+  /// them by name, so that every shard picks a disjoint subset of the same
+  /// list, whatever the order of the symbol table.
+  std::vector< ar::Function* > select(
+      const std::vector< ar::Function* >& functions) const;
+};
+
+/// \brief Return a string representing a shard, i.e "<index>/<count>"
+std::string shard_str(const ShardOption& shard);
+
+/// \brief Return a string representing the abstract domains of specific
+/// functions, i.e "<function>:<domain>,...", sorted by function name
+std::string function_domains_str(
+    const std::unordered_map< ar::Function*, MachineIntDomainOption >&
+        function_domains);
+
 /// \brief Hold all the analysis options
 struct AnalysisOptions {
 public:
@@ -272,9 +358,43 @@ public:
   /// \brief List of entry points that start with uninitialized global variables
   std::vector< ar::Function* > no_init_globals;
 
+  /// \brief List of functions to check, or empty to check all functions
+  ///
+  /// The intraprocedural analysis only analyzes these functions. The
+  /// interprocedural analysis only analyzes the entry points that might call
+  /// them, and only checks their statements.
+  std::vector< ar::Function* > functions;
+
   /// \brief Machine integer abstract domain
   MachineIntDomainOption machine_int_domain;
 
+  /// \brief Machine integer abstract domain of specific functions, overriding
+  /// machine_int_domain, see value::function_machine_int_domain()
+  ///
+  /// Only used by the intraprocedural analysis.
+  std::unordered_map< ar::Function*, MachineIntDomainOption > function_domains;
+
+  /// \brief Machine integer abstract domain of the numeric kernels, or
+  /// boost::none, see value::is_numeric_kernel()
+  ///
+  /// Only used by the intraprocedural analysis.
+  boost::optional< MachineIntDomainOption > kernel_domain;
+
+  /// \brief Maximum number of variables in a pack of the variable packing
+  /// domains, or 0 for no limit
+  ///
+  /// See core::numeric::VarPackingSettings.
+  std::size_t max_pack_size;
+
+  /// \brief Maximum size of the APRON polyhedra, or 0 for no limit
+  ///
+  /// See core::numeric::apron::Limits.
+  std::size_t apron_max_size;
+
+  /// \brief Maximum duration of an operation on APRON polyhedra, in
+  /// milliseconds, or 0 for no limit
+  unsigned apron_timeout;
+
   /// \brief Is the analysis interprocedural or intraprocedural
   Procedural procedural;
 
@@ -284,6 +404,10 @@ public:
   /// \brief Wether we should use a pointer analysis or not
   bool use_pointer;
 
+  /// \brief Wether the variables of the caller are removed from the entry
+  /// invariant of inlined callees, and restored on return
+  bool use_frame_projection;
+
   /// \brief Precision of the analysis
   Precision precision;
 
@@ -302,7 +426,101 @@ public:
   /// \brief Value of argc, or boost::none
   boost::optional< int > argc;
 
+  /// \brief Maximum depth of calling contexts, or boost::none
+  boost::optional< unsigned > context_depth;
+
+  /// \brief Keep only the invariants at cycle heads during the value analysis
+  bool low_memory;
+
+  /// \brief Release the liveness results, weak topological order, fixpoint
+  /// profile and literals of each function once its results are written
+  ///
+  /// Requires the intraprocedural analysis.
+  bool release_functions;
+
+  /// \brief Also release the AR body of each function that is not referenced
+  /// by another function or global variable, see release_functions
+  bool release_bodies;
+
+  /// \brief Use the sparse analysis on the def-use chains of the integer
+  /// internal variables instead of the dense fixpoint, see
+  /// value::SparseFunctionFixpoint
+  ///
+  /// Requires the register precision and the intraprocedural analysis.
+  bool sparse;
+
+  /// \brief Maximum time in seconds for the fixpoint on a function in a given
+  /// call context, or boost::none
+  boost::optional< unsigned > function_timeout;
+
+  /// \brief Maximum number of basic block analyses for the fixpoint on a
+  /// function in a given call context, or boost::none
+  boost::optional< unsigned > function_max_steps;
+
+  /// \brief Time in seconds after which the interprocedural analysis skips
+  /// the remaining entry points, or boost::none
+  ///
+  /// Entry points are then analyzed in decreasing order of checked
+  /// statements per unit of estimated cost, to complete as many checks as
+  /// possible before the deadline.
+  boost::optional< unsigned > deadline;
+
+  /// \brief More precise abstract domain used to re-analyze the functions, or
+  /// entry points for the interprocedural analysis, with warnings or errors,
+  /// or boost::none
+  boost::optional< MachineIntDomainOption > refine_domain;
+
+  /// \brief Maximum time in seconds for the fixpoint on a function in a given
+  /// call context during the re-analysis, or boost::none
+  boost::optional< unsigned > refine_timeout;
+
+  /// \brief Tuning profile generated from the telemetry of a previous run, or
+  /// boost::none, see TuningProfile
+  boost::optional< std::string > tuning_file;
+
+  /// \brief Record statistics on the fixpoint iterations on cycles
+  bool fixpoint_stats;
+
+  /// \brief Record statistics on the transfer functions per statement kind
+  bool transfer_stats;
+
+  /// \brief Record the peak sizes of the abstract states, per function
+  bool state_stats;
+
+  /// \brief Maximum number of cells per memory location, or boost::none
+  boost::optional< unsigned > max_cells;
+
+  /// \brief Merge the checks of a statement across call contexts, keeping at
+  /// most the given number of call contexts per check, or boost::none
+  boost::optional< unsigned > aggregate_checks;
+
+  /// \brief Skip the checks on a function in a call context when its entry
+  /// invariant is included in the one of a call context without warnings
+  bool skip_safe_contexts;
+
+  /// \brief Share the fix-point on a callee between the calling contexts with
+  /// the same entry invariant, see InlineCallExecutionEngine
+  bool group_contexts;
+
+  /// \brief Decide the syntactically safe checks once per statement, before
+  /// the value analysis, see TrivialChecksAnalysis
+  bool trivial_checks;
+
+  /// \brief Number of threads used by the value analysis
+  unsigned jobs;
+
+  /// \brief Shard of a distributed analysis, or boost::none
+  boost::optional< ShardOption > shard;
+
 public:
+  /// \brief Return the options of the re-analysis with the more precise
+  /// abstract domain, see refine_domain
+  AnalysisOptions refined() const;
+
+  /// \brief Return the options of the analysis of a function with the given
+  /// abstract domain, see function_domains and kernel_domain
+  AnalysisOptions with_domain(MachineIntDomainOption domain) const;
+
   /// \brief Save the options in the output database
   void save(SettingsTable&);
 
@@ -100,7 +100,10 @@ public:
   void add(std::unique_ptr< PointerConstraint > cst);
 
   /// \brief Solve pointer constraints
-  void solve();
+  ///
+  /// Independent components of the constraint system are solved in parallel
+  /// using the given number of threads.
+  void solve(unsigned jobs = 1);
 
   /// \brief Export results
   void results(PointerInfo&) const;
@@ -335,7 +338,8 @@ private:
                                  VarOp::create(field.value.var(), zero())));
           }
         }
-      } else if (aggregate.is_zero() || aggregate.is_undefined()) {
+      } else if (aggregate.is_data() || aggregate.is_zero() ||
+                 aggregate.is_undefined()) {
         return; // nothing to do
       } else if (aggregate.is_var()) {
         this->mem_copy(ptr, this->aggregate_pointer(aggregate));
@@ -698,6 +702,7 @@ private:
         case ar::Intrinsic::IkosNonDetUi32:
         case ar::Intrinsic::IkosCounterInit:
         case ar::Intrinsic::IkosCounterIncr:
+        case ar::Intrinsic::IkosCounterForget:
         case ar::Intrinsic::IkosPrintInvariant:
         case ar::Intrinsic::IkosPrintValues:
           break; // do nothing
@@ -48,8 +48,14 @@
 
 #pragma once
 
+#include <functional>
+#include <unordered_map>
+
+#include <ikos/ar/semantic/statement.hpp>
+
 #include <ikos/analyzer/analysis/context.hpp>
 #include <ikos/analyzer/analysis/pointer/value.hpp>
+#include <ikos/analyzer/util/sharded_map.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -65,6 +71,11 @@ private:
   /// \brief Pointer information
   PointerInfo _info;
 
+  /// \brief Potential callees of each indirect call, computed on demand
+  ShardedMap< std::unordered_map< ar::CallBase*, PointsToSet >,
+              std::hash< ar::CallBase* > >
+      _callees;
+
 public:
   /// \brief Constructor
   explicit FunctionPointerAnalysis(Context& ctx);
@@ -87,12 +98,27 @@ public:
   /// \brief Run the analysis
   void run();
 
+  /// \brief Return the potential callees of an indirect call
+  ///
+  /// This is the set of functions pointed by the called operand whose type
+  /// matches the call, or top if the called operand is unknown. The set is
+  /// computed once per call site, so that the interprocedural analysis does
+  /// not filter large sets of targets at each iteration.
+  ///
+  /// This is thread-safe.
+  const PointsToSet& callees(ar::CallBase* call);
+
   /// \brief Dump the function pointer analysis results, for debugging purpose
   void dump(std::ostream& o) const;
 
   /// \brief Return the result of the analysis
   const PointerInfo& results() const { return this->_info; }
 
+  /// \brief Return the result of the analysis, to load it from a cache
+  ///
+  /// See PointerCache.
+  PointerInfo& results() { return this->_info; }
+
 }; // end class FunctionPointerAnalysis
 
 } // end namespace analyzer
@@ -104,6 +104,11 @@ public:
   /// \brief Return the result of the analysis
   const PointerInfo& results() const { return this->_info; }
 
+  /// \brief Return the result of the analysis, to load it from a cache
+  ///
+  /// See PointerCache.
+  PointerInfo& results() { return this->_info; }
+
 }; // end class PointerAnalysis
 
 } // end namespace analyzer
@@ -0,0 +1,116 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Syntactic pre-pass deciding the trivially safe checks
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <llvm/ADT/DenseSet.h>
+
+#include <ikos/ar/semantic/statement.hpp>
+
+#include <ikos/analyzer/analysis/context.hpp>
+#include <ikos/analyzer/checker/name.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Decide the checks that are safe syntactically
+///
+/// This is intended to be used before the value analysis, with
+/// -trivial-checks.
+///
+/// A division by a non-zero integer constant and a shift by a constant count
+/// smaller than the bit-width are safe in any calling context. These checks
+/// are written once, with the empty calling context, and the checkers skip
+/// them during the value analysis.
+///
+/// Statements in unreachable code, or in functions that are never analyzed,
+/// are also reported as safe.
+class TrivialChecksAnalysis {
+private:
+  /// \brief Analysis context
+  Context& _ctx;
+
+  /// \brief Statements with a safe division by zero check
+  llvm::DenseSet< ar::Statement* > _division_by_zero;
+
+  /// \brief Statements with a safe shift count check
+  llvm::DenseSet< ar::Statement* > _shift_count;
+
+public:
+  /// \brief Constructor
+  explicit TrivialChecksAnalysis(Context& ctx);
+
+  /// \brief Deleted copy constructor
+  TrivialChecksAnalysis(const TrivialChecksAnalysis&) = delete;
+
+  /// \brief Deleted move constructor
+  TrivialChecksAnalysis(TrivialChecksAnalysis&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  TrivialChecksAnalysis& operator=(const TrivialChecksAnalysis&) = delete;
+
+  /// \brief Deleted move assignment operator
+  TrivialChecksAnalysis& operator=(TrivialChecksAnalysis&&) = delete;
+
+  /// \brief Destructor
+  ~TrivialChecksAnalysis();
+
+  /// \brief Run the analysis, and write the safe checks
+  void run();
+
+  /// \brief Return true if the check of the given checker on the given
+  /// statement was already written as safe
+  bool is_safe(CheckerName checker, ar::Statement* stmt) const;
+
+private:
+  /// \brief Return true if the division by zero check is safe
+  static bool is_safe_division(ar::BinaryOperation* stmt);
+
+  /// \brief Return true if the shift count check is safe
+  static bool is_safe_shift(ar::BinaryOperation* stmt);
+
+}; // end class TrivialChecksAnalysis
+
+} // end namespace analyzer
+} // end namespace ikos
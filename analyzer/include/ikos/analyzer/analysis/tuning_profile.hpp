@@ -0,0 +1,142 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Tuning profile of the fixpoints, from the telemetry of a previous run
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+#include <boost/optional.hpp>
+
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/function.hpp>
+
+#include <ikos/analyzer/analysis/option.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Tuning of the fixpoint iterations on a cycle
+struct LoopTuning {
+  /// \brief Number of increasing iterations that join instead of widening,
+  /// after the first one
+  unsigned widening_delay;
+
+  /// \brief Maximum number of widening thresholds
+  std::size_t max_thresholds;
+};
+
+/// \brief Tuning profile of the fixpoints, from the telemetry of a previous run
+///
+/// The tuning profile is a sidecar file generated by the ikos driver from the
+/// fixpoint statistics and the exhausted budgets of a previous run, see
+/// `ikos --tuning-profile`. Each line is a tab-separated entry:
+///
+///   function <name> <precision>
+///   loop <function name> <file> <line> <column> <widening delay> <thresholds>
+///
+/// Lines starting with `#` are comments. A cycle is identified by the source
+/// location of the first statement of its head with debug information.
+class TuningProfile {
+private:
+  /// \brief Source location of a cycle head: file, line and column
+  using LoopKey = std::tuple< std::string, unsigned, unsigned >;
+
+  /// \brief Hash of a LoopKey
+  struct LoopKeyHash {
+    std::size_t operator()(const LoopKey& key) const;
+  };
+
+  /// \brief Tuning of a function
+  struct FunctionTuning {
+    /// \brief Lower precision, or boost::none
+    boost::optional< Precision > precision;
+
+    /// \brief Tuning of its cycles
+    std::unordered_map< LoopKey, LoopTuning, LoopKeyHash > loops;
+  };
+
+private:
+  /// \brief Tuning of each function, by name
+  std::unordered_map< std::string, FunctionTuning > _functions;
+
+public:
+  /// \brief Create an empty tuning profile
+  TuningProfile() = default;
+
+  /// \brief Deleted copy constructor
+  TuningProfile(const TuningProfile&) = delete;
+
+  /// \brief Deleted move constructor
+  TuningProfile(TuningProfile&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  TuningProfile& operator=(const TuningProfile&) = delete;
+
+  /// \brief Deleted move assignment operator
+  TuningProfile& operator=(TuningProfile&&) = delete;
+
+  /// \brief Destructor
+  ~TuningProfile() = default;
+
+  /// \brief Load the tuning profile from the given file
+  ///
+  /// Throws an ArgumentError if the file cannot be read or is malformed.
+  void load(const std::string& filepath);
+
+  /// \brief Return true if the profile has no entry
+  bool empty() const { return this->_functions.empty(); }
+
+  /// \brief Return the lower precision of the given function, or boost::none
+  boost::optional< Precision > precision(ar::Function*) const;
+
+  /// \brief Return the tuning of the cycle with the given head, or boost::none
+  boost::optional< const LoopTuning& > loop(ar::Function*,
+                                            ar::BasicBlock* head) const;
+
+}; // end class TuningProfile
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -45,10 +45,14 @@
 
 #include <ikos/analyzer/analysis/value/machine_int_domain.hpp>
 #include <ikos/core/domain/exception/exception.hpp>
+#include <ikos/core/domain/lifetime/dummy.hpp>
 #include <ikos/core/domain/lifetime/lifetime.hpp>
 #include <ikos/core/domain/memory/value.hpp>
 #include <ikos/core/domain/nullity/nullity.hpp>
+#include <ikos/core/domain/nullity/packed.hpp>
 #include <ikos/core/domain/pointer/pointer.hpp>
+#include <ikos/core/domain/uninitialized/dummy.hpp>
+#include <ikos/core/domain/uninitialized/packed.hpp>
 #include <ikos/core/domain/uninitialized/uninitialized.hpp>
 
 #include <ikos/analyzer/analysis/memory_location.hpp>
@@ -59,7 +63,11 @@ namespace analyzer {
 namespace value {
 
 /// \brief Nullity abstract domain for the value analysis
+#ifdef IKOS_ANALYZER_PACKED_NULLITY_UNINITIALIZED
+using NullityAbstractDomain = core::nullity::PackedNullityDomain< Variable* >;
+#else
 using NullityAbstractDomain = core::nullity::NullityDomain< Variable* >;
+#endif
 
 /// \brief Pointer abstract domain for the value analysis
 using PointerAbstractDomain =
@@ -69,12 +77,30 @@ using PointerAbstractDomain =
                                   NullityAbstractDomain >;
 
 /// \brief Uninitialized abstract domain for the value analysis
+///
+/// Binaries compiled with IKOS_ANALYZER_PRUNED_DOMAINS do not keep track of
+/// uninitialized variables, see `checker_needs_uninitialized()`.
+#if defined(IKOS_ANALYZER_PRUNED_DOMAINS)
+using UninitializedAbstractDomain =
+    core::uninitialized::DummyDomain< Variable* >;
+#elif defined(IKOS_ANALYZER_PACKED_NULLITY_UNINITIALIZED)
+using UninitializedAbstractDomain =
+    core::uninitialized::PackedUninitializedDomain< Variable* >;
+#else
 using UninitializedAbstractDomain =
     core::uninitialized::UninitializedDomain< Variable* >;
+#endif
 
 /// \brief Lifetime abstract domain for the value analysis
+///
+/// Binaries compiled with IKOS_ANALYZER_PRUNED_DOMAINS do not keep track of
+/// memory location lifetimes, see `checker_needs_lifetime()`.
+#ifdef IKOS_ANALYZER_PRUNED_DOMAINS
+using LifetimeAbstractDomain = core::lifetime::DummyDomain< MemoryLocation* >;
+#else
 using LifetimeAbstractDomain =
     core::lifetime::LifetimeDomain< MemoryLocation* >;
+#endif
 
 /// \brief Memory abstract domain for the value analysis
 using MemoryAbstractDomain =
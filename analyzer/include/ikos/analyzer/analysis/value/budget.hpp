@@ -0,0 +1,153 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Time and step budget of a fixpoint computation
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <boost/optional.hpp>
+
+#include <ikos/ar/semantic/function.hpp>
+
+#include <ikos/analyzer/analysis/call_context.hpp>
+#include <ikos/analyzer/analysis/context.hpp>
+#include <ikos/analyzer/analysis/option.hpp>
+#include <ikos/analyzer/util/memory_governor.hpp>
+#include <ikos/analyzer/util/timer.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+/// \brief Kind of budget
+enum class BudgetKind {
+  Time,
+  Steps,
+  Memory,
+};
+
+/// \brief Return a string representation of a budget kind
+const char* budget_kind_str(BudgetKind kind);
+
+/// \brief Time, step and memory budget of a fixpoint computation
+///
+/// A step is the analysis of one basic block. Once the budget is exhausted,
+/// the fixpoint iterator should degrade its precision to converge quickly.
+///
+/// The memory budget is shared by all fixpoints: it is exhausted once the
+/// memory governor reports that the soft memory limit is exceeded.
+class AnalysisBudget {
+private:
+  /// \brief Maximum time, or boost::none
+  boost::optional< Timer::Duration > _timeout;
+
+  /// \brief Maximum number of steps, or boost::none
+  boost::optional< std::uint64_t > _max_steps;
+
+  /// \brief Start time
+  Timer::TimePoint _start;
+
+  /// \brief Number of steps
+  std::uint64_t _steps;
+
+  /// \brief Memory governor, or null
+  const MemoryGovernor* _memory_governor;
+
+  /// \brief Exhausted budget, or boost::none
+  boost::optional< BudgetKind > _exhausted;
+
+public:
+  /// \brief Create a budget from the analysis options
+  explicit AnalysisBudget(const AnalysisOptions& opts,
+                          const MemoryGovernor* memory_governor = nullptr);
+
+  /// \brief Default copy constructor
+  AnalysisBudget(const AnalysisBudget&) = default;
+
+  /// \brief Default move constructor
+  AnalysisBudget(AnalysisBudget&&) = default;
+
+  /// \brief Default copy assignment operator
+  AnalysisBudget& operator=(const AnalysisBudget&) = default;
+
+  /// \brief Default move assignment operator
+  AnalysisBudget& operator=(AnalysisBudget&&) = default;
+
+  /// \brief Destructor
+  ~AnalysisBudget() = default;
+
+  /// \brief Return true if the budget is unlimited
+  bool unlimited() const {
+    return !this->_timeout && !this->_max_steps &&
+           this->_memory_governor == nullptr;
+  }
+
+  /// \brief Reset the budget and start the timer
+  void start();
+
+  /// \brief Count one step, and check if the budget is exhausted
+  void step();
+
+  /// \brief Return true if the budget is exhausted
+  bool exhausted() const { return static_cast< bool >(this->_exhausted); }
+
+  /// \brief Return the kind of the exhausted budget
+  BudgetKind exhausted_kind() const;
+
+  /// \brief Return the number of steps since start()
+  std::uint64_t steps() const { return this->_steps; }
+
+  /// \brief Return the elapsed time since start()
+  Timer::Duration elapsed() const;
+
+}; // end class AnalysisBudget
+
+/// \brief Report an exhausted budget in the log and the output database
+void report_exhausted_budget(Context& ctx,
+                             ar::Function* fun,
+                             CallContext* call_context,
+                             const AnalysisBudget& budget);
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,114 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Statistics on the fixpoint iterations of the value analysis
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+
+#include <ikos/core/fixpoint/fwd_fixpoint_iterator.hpp>
+
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/function.hpp>
+
+#include <ikos/analyzer/analysis/call_context.hpp>
+#include <ikos/analyzer/analysis/context.hpp>
+#include <ikos/analyzer/analysis/option.hpp>
+#include <ikos/analyzer/analysis/value/abstract_domain.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+/// \brief Statistics on the fixpoint iterations on the cycles of a function
+///
+/// The statistics of a cycle are accumulated over all its fixpoint
+/// computations, e.g. a nested cycle is iterated once per iteration of its
+/// parent cycle. The time of a cycle includes the time of its nested cycles.
+class FixpointStats {
+private:
+  /// \brief Is the collection enabled?
+  bool _enabled;
+
+  /// \brief Statistics for each cycle head
+  std::unordered_map< ar::BasicBlock*, core::FixpointCycleStats > _map;
+
+public:
+  /// \brief Create the statistics from the analysis options
+  explicit FixpointStats(const AnalysisOptions& opts);
+
+  /// \brief No copy constructor
+  FixpointStats(const FixpointStats&) = delete;
+
+  /// \brief No move constructor
+  FixpointStats(FixpointStats&&) = delete;
+
+  /// \brief No copy assignment operator
+  FixpointStats& operator=(const FixpointStats&) = delete;
+
+  /// \brief No move assignment operator
+  FixpointStats& operator=(FixpointStats&&) = delete;
+
+  /// \brief Destructor
+  ~FixpointStats() = default;
+
+  /// \brief Return true if the collection is enabled
+  bool enabled() const { return this->_enabled; }
+
+  /// \brief Return the size of the given invariant
+  ///
+  /// Abstract domains do not provide a generic size, so this is the length of
+  /// the textual representation. Returns 0 if the collection is disabled.
+  std::size_t size(const AbstractDomain& inv) const;
+
+  /// \brief Add the statistics of a fixpoint computation on a cycle
+  void add(ar::BasicBlock* head, const core::FixpointCycleStats& stats);
+
+  /// \brief Insert the statistics in the output database, and clear them
+  void report(Context& ctx, ar::Function* fun, CallContext* call_context);
+
+}; // end class FixpointStats
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
@@ -43,11 +43,45 @@
 
 #pragma once
 
-#include <ikos/core/domain/machine_int/polymorphic_domain.hpp>
+#include <memory>
 
 #include <ikos/analyzer/analysis/option.hpp>
 #include <ikos/analyzer/analysis/variable.hpp>
 
+namespace ikos {
+namespace core {
+namespace numeric {
+
+// forward declaration
+template < typename VariableRef >
+class VariablePacking;
+
+} // end namespace numeric
+} // end namespace core
+
+namespace analyzer {
+namespace value {
+
+/// \brief Fixed packs of variables, see VariablePackingAnalysis
+using VariablePackingPtr =
+    std::shared_ptr< const core::numeric::VariablePacking< Variable* > >;
+
+/// \brief Maximum number of disjuncts of the bounded powerset domains
+constexpr std::size_t PowersetMaxDisjuncts = 8;
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
+
+#ifdef IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN
+
+// Binary specialized for one machine integer abstract domain, see CMakeLists
+#include <ikos/analyzer/analysis/value/static_machine_int_domain.hpp>
+
+#else
+
+#include <ikos/core/domain/machine_int/polymorphic_domain.hpp>
+
 namespace ikos {
 namespace analyzer {
 namespace value {
@@ -60,13 +94,19 @@ using MachineIntAbstractDomain =
 /// @{
 
 MachineIntAbstractDomain make_top_machine_int_interval();
+MachineIntAbstractDomain make_top_machine_int_dense_interval();
 MachineIntAbstractDomain make_top_machine_int_congruence();
 MachineIntAbstractDomain make_top_machine_int_interval_congruence();
+MachineIntAbstractDomain make_top_machine_int_interval_equality();
 MachineIntAbstractDomain make_top_machine_int_dbm();
+MachineIntAbstractDomain make_top_machine_int_split_dbm();
 MachineIntAbstractDomain make_top_machine_int_var_pack_dbm();
 MachineIntAbstractDomain make_top_machine_int_var_pack_dbm_congruence();
+MachineIntAbstractDomain make_top_machine_int_static_pack_dbm(
+    VariablePackingPtr packing);
 MachineIntAbstractDomain make_top_machine_int_gauge();
 MachineIntAbstractDomain make_top_machine_int_gauge_interval_congruence();
+MachineIntAbstractDomain make_top_machine_int_powerset_interval();
 MachineIntAbstractDomain make_top_machine_int_apron_interval();
 MachineIntAbstractDomain make_top_machine_int_apron_octagon();
 MachineIntAbstractDomain make_top_machine_int_apron_polka_polyhedra();
@@ -86,26 +126,78 @@ make_top_machine_int_var_pack_apron_pkgrid_polyhedra_lin_cong();
 
 /// @}
 
+#ifdef IKOS_ANALYZER_DOMAIN_PLUGINS
+
+// Domains built as loadable modules, see CMakeLists
+
+/// \brief Constructor of the top value of a machine integer abstract domain
+using MakeTopMachineIntDomainFn =
+    MachineIntAbstractDomain (*)(const VariablePackingPtr& packing);
+
+/// \brief Return the family of the given domain
+///
+/// Domains of a family are in the module `ikos-analyzer-domain-<family>`.
+const char* machine_int_domain_family(MachineIntDomainOption d);
+
+/// \brief Load the module of the given domain, if it is not already loaded
+///
+/// Throws a LogicError if the module cannot be loaded.
+MakeTopMachineIntDomainFn load_machine_int_domain(MachineIntDomainOption d);
+
 /// \brief Create the top machine integer domain of the given choice
+///
+/// `packing` is only used by the static variable packing domains, and can be
+/// null if the variable packing pre-analysis did not run.
+MachineIntAbstractDomain make_top_machine_int_domain(
+    MachineIntDomainOption d, const VariablePackingPtr& packing);
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
+
+/// \brief Entry point of a module
+///
+/// Returns the constructor of the given domain, or null if the domain is not
+/// in the module.
+extern "C" ikos::analyzer::value::MakeTopMachineIntDomainFn
+ikos_analyzer_machine_int_domain_plugin(
+    ikos::analyzer::MachineIntDomainOption d);
+
+#else
+
+/// \brief Create the top machine integer domain of the given choice
+///
+/// `packing` is only used by the static variable packing domains, and can be
+/// null if the variable packing pre-analysis did not run.
 inline MachineIntAbstractDomain make_top_machine_int_domain(
-    MachineIntDomainOption d) {
+    MachineIntDomainOption d, const VariablePackingPtr& packing) {
   switch (d) {
     case MachineIntDomainOption::Interval:
       return make_top_machine_int_interval();
+    case MachineIntDomainOption::DenseInterval:
+      return make_top_machine_int_dense_interval();
     case MachineIntDomainOption::Congruence:
       return make_top_machine_int_congruence();
     case MachineIntDomainOption::IntervalCongruence:
       return make_top_machine_int_interval_congruence();
+    case MachineIntDomainOption::IntervalEquality:
+      return make_top_machine_int_interval_equality();
     case MachineIntDomainOption::DBM:
       return make_top_machine_int_dbm();
+    case MachineIntDomainOption::SplitDBM:
+      return make_top_machine_int_split_dbm();
     case MachineIntDomainOption::VarPackDBM:
       return make_top_machine_int_var_pack_dbm();
     case MachineIntDomainOption::VarPackDBMCongruence:
       return make_top_machine_int_var_pack_dbm_congruence();
+    case MachineIntDomainOption::StaticPackDBM:
+      return make_top_machine_int_static_pack_dbm(packing);
     case MachineIntDomainOption::Gauge:
       return make_top_machine_int_gauge();
     case MachineIntDomainOption::GaugeIntervalCongruence:
       return make_top_machine_int_gauge_interval_congruence();
+    case MachineIntDomainOption::PowersetInterval:
+      return make_top_machine_int_powerset_interval();
     case MachineIntDomainOption::ApronInterval:
       return make_top_machine_int_apron_interval();
     case MachineIntDomainOption::ApronOctagon:
@@ -141,3 +233,7 @@ inline MachineIntAbstractDomain make_top_machine_int_domain(
 } // end namespace value
 } // end namespace analyzer
 } // end namespace ikos
+
+#endif // IKOS_ANALYZER_DOMAIN_PLUGINS
+
+#endif // IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN
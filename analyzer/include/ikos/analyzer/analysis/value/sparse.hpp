@@ -0,0 +1,172 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Sparse value analysis of a function, over the def-use chains of its
+ * integer internal variables
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include <ikos/core/value/machine_int/interval.hpp>
+
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/function.hpp>
+#include <ikos/ar/semantic/value.hpp>
+
+#include <ikos/analyzer/analysis/call_context.hpp>
+#include <ikos/analyzer/analysis/context.hpp>
+#include <ikos/analyzer/analysis/value/abstract_domain.hpp>
+#include <ikos/analyzer/analysis/value/budget.hpp>
+#include <ikos/analyzer/analysis/value/fixpoint_stats.hpp>
+#include <ikos/analyzer/checker/checker.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+/// \brief Def-use graph of the integer internal variables of a function
+class DefUseGraph;
+
+/// \brief Sparse value analysis of a function
+///
+/// Instead of an abstract state per basic block, the analysis keeps one
+/// interval per definition of an integer internal variable. Internal
+/// variables are in SSA form, except for the assignments inserted for phi
+/// nodes, so the value of a variable holds wherever it is used. Definitions
+/// are computed with a worklist over the def-use chains, see
+/// core::SparseFixpointIterator.
+///
+/// Comparisons in the block of a definition, or in its chain of unique
+/// predecessors, refine the operands of the definition.
+///
+/// This is only sound with the register precision (-prec=reg), since memory
+/// is not modelled. The checks build the invariant of each basic block from
+/// the intervals of the variables it uses.
+class SparseFunctionFixpoint {
+private:
+  /// \brief Machine integer interval
+  using Interval = core::machine_int::Interval;
+
+private:
+  /// \brief Analysis context
+  Context& _ctx;
+
+  /// \brief Analyzed function
+  ar::Function* _function;
+
+  /// \brief Empty call context
+  CallContext* _empty_call_context;
+
+  /// \brief Def-use graph
+  std::unique_ptr< DefUseGraph > _graph;
+
+  /// \brief Initial invariant
+  AbstractDomain _init_inv;
+
+  /// \brief Interval of each integer internal variable with a definition
+  std::unordered_map< ar::InternalVariable*, Interval > _values;
+
+  /// \brief Time and step budget
+  ///
+  /// A step is the analysis of one definition.
+  AnalysisBudget _budget;
+
+  /// \brief Statistics on the fixpoint iterations
+  ///
+  /// Cycles of the def-use graph are reported on the basic block of their
+  /// head definition.
+  FixpointStats _fixpoint_stats;
+
+public:
+  /// \brief Create a sparse fixpoint on the given function
+  SparseFunctionFixpoint(Context& ctx, ar::Function* function);
+
+  /// \brief Deleted copy constructor
+  SparseFunctionFixpoint(const SparseFunctionFixpoint&) = delete;
+
+  /// \brief Deleted move constructor
+  SparseFunctionFixpoint(SparseFunctionFixpoint&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  SparseFunctionFixpoint& operator=(const SparseFunctionFixpoint&) = delete;
+
+  /// \brief Deleted move assignment operator
+  SparseFunctionFixpoint& operator=(SparseFunctionFixpoint&&) = delete;
+
+  /// \brief Destructor
+  ~SparseFunctionFixpoint();
+
+  /// \brief Return true if the function is analyzed with a lower precision
+  /// because of the soft memory limit
+  ///
+  /// The sparse analysis always uses the register precision.
+  bool degraded() const { return false; }
+
+  /// \brief Compute the fixpoint
+  void run(AbstractDomain inv);
+
+  /// \brief Run the checks with the previously computed fixpoint
+  void run_checks(CheckerList& checkers);
+
+private:
+  /// \brief Record the summary of the function, see LibrarySummaries
+  void record_summary() const;
+
+  /// \brief Return the invariant at the entry of the given basic block
+  AbstractDomain block_invariant(ar::BasicBlock* bb) const;
+
+  /// \brief Run the checks on the given basic block
+  void check_block(CheckerList& checkers,
+                   ar::BasicBlock* bb,
+                   const AbstractDomain& pre);
+
+  /// \brief Run the checks on a basic block with a bottom pre invariant
+  void check_unreachable_block(CheckerList& checkers,
+                               ar::BasicBlock* bb,
+                               const AbstractDomain& pre);
+
+};// end class SparseFunctionFixpoint
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
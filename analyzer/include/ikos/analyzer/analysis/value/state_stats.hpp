@@ -0,0 +1,126 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Statistics on the sizes of the abstract states
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include <ikos/core/domain/numeric/var_packing_domain.hpp>
+
+#include <ikos/ar/semantic/function.hpp>
+
+#include <ikos/analyzer/analysis/call_context.hpp>
+#include <ikos/analyzer/analysis/context.hpp>
+#include <ikos/analyzer/analysis/option.hpp>
+#include <ikos/analyzer/analysis/value/abstract_domain.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+/// \brief Statistics on the sizes of the abstract states of a function
+///
+/// Abstract states are sampled at the entry of the function, which is a call
+/// boundary for inlined callees, and at the head of cycles, after each
+/// increasing iteration. Only the peak sizes are kept.
+///
+/// The number of patricia tree nodes is the number of live nodes allocated by
+/// the current thread, and thus includes the nodes of all the abstract states
+/// alive at the time of the sample, e.g. the invariants of the callers.
+///
+/// The statistics on the variable packs (see core::numeric::VarPackingStats)
+/// cover all the operations between the creation and the report, including
+/// the analysis of inlined callees.
+class StateStats {
+private:
+  /// \brief Is the collection enabled?
+  bool _enabled;
+
+  /// \brief Number of samples
+  std::size_t _samples = 0;
+
+  /// \brief Peak number of memory cells
+  std::size_t _peak_cells = 0;
+
+  /// \brief Peak total size of the points-to sets
+  std::size_t _peak_points_to = 0;
+
+  /// \brief Peak number of live patricia tree nodes
+  std::size_t _peak_nodes = 0;
+
+  /// \brief Statistics on the variable packs of the enclosing analysis
+  core::numeric::VarPackingStats _enclosing_packs = {0, 0};
+
+public:
+  /// \brief Create the statistics from the analysis options
+  explicit StateStats(const AnalysisOptions& opts);
+
+  /// \brief No copy constructor
+  StateStats(const StateStats&) = delete;
+
+  /// \brief No move constructor
+  StateStats(StateStats&&) = delete;
+
+  /// \brief No copy assignment operator
+  StateStats& operator=(const StateStats&) = delete;
+
+  /// \brief No move assignment operator
+  StateStats& operator=(StateStats&&) = delete;
+
+  /// \brief Destructor
+  ~StateStats() = default;
+
+  /// \brief Return true if the collection is enabled
+  bool enabled() const { return this->_enabled; }
+
+  /// \brief Sample the size of the given abstract state
+  void sample(const AbstractDomain& inv);
+
+  /// \brief Insert the statistics in the output database, and clear them
+  void report(Context& ctx, ar::Function* fun, CallContext* call_context);
+
+}; // end class StateStats
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,274 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Machine integer abstract domain selected at compile time
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+// This file is included by machine_int_domain.hpp, after the definition of
+// VariablePackingPtr, when IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN is defined.
+
+#include <ikos/core/support/assert.hpp>
+#include <ikos/core/support/compiler.hpp>
+
+#if defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_INTERVAL)
+#include <ikos/core/domain/machine_int/interval.hpp>
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_DENSE_INTERVAL)
+#include <ikos/core/domain/machine_int/dense_interval.hpp>
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_CONGRUENCE)
+#include <ikos/core/domain/machine_int/congruence.hpp>
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_INTERVAL_CONGRUENCE)
+#include <ikos/core/domain/machine_int/interval_congruence.hpp>
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_INTERVAL_EQUALITY)
+#include <ikos/core/domain/machine_int/interval_equality.hpp>
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_DBM)
+#include <ikos/core/domain/machine_int/numeric_domain_adapter.hpp>
+#include <ikos/core/domain/numeric/dbm.hpp>
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_SPLIT_DBM)
+#include <ikos/core/domain/machine_int/numeric_domain_adapter.hpp>
+#include <ikos/core/domain/numeric/split_dbm.hpp>
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_VAR_PACK_DBM)
+#include <ikos/core/domain/machine_int/numeric_domain_adapter.hpp>
+#include <ikos/core/domain/numeric/var_packing_dbm.hpp>
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_VAR_PACK_DBM_CONGRUENCE)
+#include <ikos/core/domain/machine_int/numeric_domain_adapter.hpp>
+#include <ikos/core/domain/numeric/var_packing_dbm_congruence.hpp>
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_STATIC_PACK_DBM)
+#include <ikos/core/domain/machine_int/numeric_domain_adapter.hpp>
+#include <ikos/core/domain/numeric/dbm.hpp>
+#include <ikos/core/domain/numeric/static_var_packing_domain.hpp>
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_GAUGE)
+#include <ikos/core/domain/machine_int/numeric_domain_adapter.hpp>
+#include <ikos/core/domain/numeric/gauge.hpp>
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_GAUGE_INTERVAL_CONGRUENCE)
+#include <ikos/core/domain/machine_int/numeric_domain_adapter.hpp>
+#include <ikos/core/domain/numeric/gauge_interval_congruence.hpp>
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_POWERSET_INTERVAL)
+#include <ikos/core/domain/machine_int/numeric_domain_adapter.hpp>
+#include <ikos/core/domain/numeric/bounded_powerset.hpp>
+#include <ikos/core/domain/numeric/interval.hpp>
+#else
+#error "unknown static machine integer abstract domain"
+#endif
+
+#include <ikos/analyzer/analysis/option.hpp>
+#include <ikos/analyzer/analysis/variable.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+#if defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_INTERVAL)
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain =
+    core::machine_int::IntervalDomain< Variable* >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::Interval;
+
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_DENSE_INTERVAL)
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain =
+    core::machine_int::DenseIntervalDomain< Variable* >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::DenseInterval;
+
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_CONGRUENCE)
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain =
+    core::machine_int::CongruenceDomain< Variable* >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::Congruence;
+
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_INTERVAL_CONGRUENCE)
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain =
+    core::machine_int::IntervalCongruenceDomain< Variable* >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::IntervalCongruence;
+
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_INTERVAL_EQUALITY)
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain =
+    core::machine_int::IntervalEqualityDomain< Variable* >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::IntervalEquality;
+
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_DBM)
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain = core::machine_int::NumericDomainAdapter<
+    Variable*,
+    core::numeric::DBM< ZNumber, Variable* > >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::DBM;
+
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_SPLIT_DBM)
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain = core::machine_int::NumericDomainAdapter<
+    Variable*,
+    core::numeric::SplitDBM< ZNumber, Variable* > >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::SplitDBM;
+
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_VAR_PACK_DBM)
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain = core::machine_int::NumericDomainAdapter<
+    Variable*,
+    core::numeric::VarPackingDBM< ZNumber, Variable* > >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::VarPackDBM;
+
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_VAR_PACK_DBM_CONGRUENCE)
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain = core::machine_int::NumericDomainAdapter<
+    Variable*,
+    core::numeric::VarPackingDBMCongruence< ZNumber, Variable* > >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::VarPackDBMCongruence;
+
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_STATIC_PACK_DBM)
+
+/// \brief Numeric abstract domain with static variable packing
+using StaticPackDBM = core::numeric::StaticVarPackingDomain<
+    ZNumber,
+    Variable*,
+    core::numeric::DBM< ZNumber, Variable* > >;
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain =
+    core::machine_int::NumericDomainAdapter< Variable*, StaticPackDBM >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::StaticPackDBM;
+
+/// \brief Create the top machine integer domain
+///
+/// `packing` can be null if the variable packing pre-analysis did not run.
+inline MachineIntAbstractDomain make_top_machine_int_domain(
+    MachineIntDomainOption d, const VariablePackingPtr& packing) {
+  ikos_assert(d == StaticMachineIntDomainOption);
+  ikos_ignore(d);
+  return MachineIntAbstractDomain(StaticPackDBM::top(packing));
+}
+
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_GAUGE)
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain = core::machine_int::NumericDomainAdapter<
+    Variable*,
+    core::numeric::GaugeDomain< ZNumber, Variable* > >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::Gauge;
+
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_GAUGE_INTERVAL_CONGRUENCE)
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain = core::machine_int::NumericDomainAdapter<
+    Variable*,
+    core::numeric::GaugeIntervalCongruenceDomain< ZNumber, Variable* > >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::GaugeIntervalCongruence;
+
+#elif defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_POWERSET_INTERVAL)
+
+/// \brief Machine integer abstract domain used for the value analysis
+using MachineIntAbstractDomain = core::machine_int::NumericDomainAdapter<
+    Variable*,
+    core::numeric::BoundedPowersetDomain<
+        ZNumber,
+        Variable*,
+        core::numeric::IntervalDomain< ZNumber, Variable* >,
+        PowersetMaxDisjuncts > >;
+
+/// \brief Machine integer abstract domain option of this binary
+constexpr MachineIntDomainOption StaticMachineIntDomainOption =
+    MachineIntDomainOption::PowersetInterval;
+
+#endif
+
+#if !defined(IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN_STATIC_PACK_DBM)
+
+/// \brief Create the top machine integer domain
+///
+/// The domain choice is checked at startup, see ikos_analyzer.cpp
+inline MachineIntAbstractDomain make_top_machine_int_domain(
+    MachineIntDomainOption d, const VariablePackingPtr& /*packing*/) {
+  ikos_assert(d == StaticMachineIntDomainOption);
+  ikos_ignore(d);
+  return MachineIntAbstractDomain::top();
+}
+
+#endif
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
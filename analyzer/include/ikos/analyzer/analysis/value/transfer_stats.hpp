@@ -0,0 +1,163 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Statistics on the transfer functions of the value analysis
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include <ikos/ar/semantic/function.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+
+#include <ikos/analyzer/analysis/call_context.hpp>
+#include <ikos/analyzer/analysis/context.hpp>
+#include <ikos/analyzer/analysis/execution_engine/engine.hpp>
+#include <ikos/analyzer/analysis/option.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+/// \brief Statistics on the transfer functions executed on a function, per
+/// statement kind
+///
+/// Only the transfer functions executed during the fixpoint computation are
+/// recorded, not the ones executed while running the checks. The time of a
+/// call includes the analysis of the callee, if it is inlined.
+class TransferStats {
+public:
+  /// \brief Kind of statement
+  ///
+  /// This is the kind of the AR statement, except that calls to intrinsic
+  /// functions are separated from other calls.
+  enum Kind {
+    Assignment,
+    UnaryOperation,
+    BinaryOperation,
+    Comparison,
+    ReturnValue,
+    Unreachable,
+    Allocate,
+    PointerShift,
+    Load,
+    Store,
+    ExtractElement,
+    InsertElement,
+    ShuffleVector,
+    Call,
+    IntrinsicCall,
+    Invoke,
+    LandingPad,
+    Resume,
+    NumKinds,
+  };
+
+private:
+  /// \brief Counters of a statement kind
+  struct Counters {
+    std::uint64_t count = 0;
+    std::chrono::steady_clock::duration time =
+        std::chrono::steady_clock::duration::zero();
+  };
+
+private:
+  /// \brief Is the collection enabled?
+  bool _enabled;
+
+  /// \brief Counters for each statement kind
+  std::array< Counters, NumKinds > _counters;
+
+public:
+  /// \brief Create the statistics from the analysis options
+  explicit TransferStats(const AnalysisOptions& opts);
+
+  /// \brief No copy constructor
+  TransferStats(const TransferStats&) = delete;
+
+  /// \brief No move constructor
+  TransferStats(TransferStats&&) = delete;
+
+  /// \brief No copy assignment operator
+  TransferStats& operator=(const TransferStats&) = delete;
+
+  /// \brief No move assignment operator
+  TransferStats& operator=(TransferStats&&) = delete;
+
+  /// \brief Destructor
+  ~TransferStats() = default;
+
+  /// \brief Return true if the collection is enabled
+  bool enabled() const { return this->_enabled; }
+
+  /// \brief Execute the transfer function for a statement, and record it
+  template < typename ExecEngine, typename CallExecEngine >
+  void transfer_function(ExecEngine& exec_engine,
+                         CallExecEngine& call_exec_engine,
+                         ar::Statement* stmt) {
+    if (!this->_enabled) {
+      analyzer::transfer_function(exec_engine, call_exec_engine, stmt);
+      return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    analyzer::transfer_function(exec_engine, call_exec_engine, stmt);
+    Counters& counters = this->_counters[kind(stmt)];
+    counters.count++;
+    counters.time += std::chrono::steady_clock::now() - start;
+  }
+
+  /// \brief Insert the statistics in the output database, and clear them
+  void report(Context& ctx, ar::Function* fun, CallContext* call_context);
+
+  /// \brief Return the kind of the given statement
+  static Kind kind(ar::Statement* stmt);
+
+  /// \brief Return the name of the given statement kind
+  static const char* kind_str(Kind kind);
+
+}; // end class TransferStats
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
@@ -45,7 +45,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -68,6 +70,7 @@
 #include <ikos/analyzer/analysis/memory_location.hpp>
 #include <ikos/analyzer/support/cast.hpp>
 #include <ikos/analyzer/support/number.hpp>
+#include <ikos/analyzer/util/sharded_map.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -125,6 +128,18 @@ protected:
   /// \brief The offset variable, or nullptr if it is not a pointer
   std::unique_ptr< Variable > _offset_var;
 
+private:
+  /// \brief Dense identifier, given by the VariableFactory
+  core::Index _id = 0;
+
+  /// \brief Function of the variable, or null for the global scope
+  ar::Function* _scope = nullptr;
+
+  /// \brief Dense identifier within the scope, given by the VariableFactory
+  std::size_t _scope_id = 0;
+
+  friend class VariableFactory;
+
 protected:
   /// \brief Protected constructor
   Variable(VariableKind kind, ar::Type* type);
@@ -151,6 +166,23 @@ public:
   /// \brief Return the type of the variable
   ar::Type* type() const { return this->_type; }
 
+  /// \brief Return the dense identifier of the variable
+  ///
+  /// Identifiers are sequential, starting at 0, in order of creation.
+  core::Index id() const { return this->_id; }
+
+  /// \brief Return the scope of the variable
+  ///
+  /// Local variables, internal variables of a function body and their offset
+  /// variables belong to the scope of their function. Other variables belong
+  /// to the global scope, represented by null.
+  ar::Function* scope() const { return this->_scope; }
+
+  /// \brief Return the dense identifier of the variable within its scope
+  ///
+  /// Identifiers are sequential, starting at 0, in order of creation.
+  std::size_t scope_id() const { return this->_scope_id; }
+
   /// \brief Return the offset variable, or nullptr if it is not a pointer
   Variable* offset_var() const { return this->_offset_var.get(); }
 
@@ -464,39 +496,64 @@ private:
   /// This is an unsigned integer with the bit-width of a pointer
   ar::IntegerType* _size_type;
 
-  llvm::DenseMap< ar::LocalVariable*, std::unique_ptr< LocalVariable > >
-      _local_variable_map;
+  /// \brief Sharded map using the given key and variable type
+  template < typename Key, typename T >
+  using VariableMap =
+      ShardedMap< llvm::DenseMap< Key, std::unique_ptr< T > >,
+                  DenseMapInfoHash< Key > >;
 
-  llvm::DenseMap< ar::GlobalVariable*, std::unique_ptr< GlobalVariable > >
-      _global_variable_map;
+  using CellMapKey = std::tuple< MemoryLocation*, MachineInt, MachineInt >;
 
-  llvm::DenseMap< ar::InternalVariable*, std::unique_ptr< InternalVariable > >
-      _internal_variable_map;
+  VariableMap< ar::LocalVariable*, LocalVariable > _local_variable_map;
 
-  llvm::DenseMap< ar::InlineAssemblyConstant*,
-                  std::unique_ptr< InlineAssemblyPointerVariable > >
+  VariableMap< ar::GlobalVariable*, GlobalVariable > _global_variable_map;
+
+  VariableMap< ar::InternalVariable*, InternalVariable > _internal_variable_map;
+
+  VariableMap< ar::InlineAssemblyConstant*, InlineAssemblyPointerVariable >
       _inline_asm_pointer_map;
 
-  llvm::DenseMap< ar::Function*, std::unique_ptr< FunctionPointerVariable > >
-      _function_pointer_map;
+  VariableMap< ar::Function*, FunctionPointerVariable > _function_pointer_map;
 
-  std::unordered_map< std::tuple< MemoryLocation*, MachineInt, MachineInt >,
-                      std::unique_ptr< CellVariable >,
-                      CellMapKeyHash >
+  ShardedMap< std::unordered_map< CellMapKey,
+                                  std::unique_ptr< CellVariable >,
+                                  CellMapKeyHash >,
+              CellMapKeyHash >
       _cell_map;
 
-  llvm::DenseMap< MemoryLocation*, std::unique_ptr< AllocSizeVariable > >
-      _alloc_size_map;
+  VariableMap< MemoryLocation*, AllocSizeVariable > _alloc_size_map;
 
-  llvm::DenseMap< ar::Function*, std::unique_ptr< ReturnVariable > >
-      _return_variable_map;
+  VariableMap< ar::Function*, ReturnVariable > _return_variable_map;
 
-  llvm::StringMap< std::unique_ptr< NamedShadowVariable > >
+  ShardedMap< llvm::StringMap< std::unique_ptr< NamedShadowVariable > >,
+              DenseMapInfoHash< llvm::StringRef > >
       _named_shadow_variable_map;
 
   std::vector< std::unique_ptr< UnnamedShadowVariable > >
       _unnamed_shadow_variable_vec;
 
+  /// \brief Mutex protecting _unnamed_shadow_variable_vec
+  std::mutex _unnamed_shadow_mutex;
+
+  /// \brief Identifier of the next variable
+  std::atomic< core::Index > _next_id;
+
+  /// \brief Identifier of the next variable of each scope
+  VariableMap< ar::Function*, std::atomic< std::size_t > > _next_scope_id;
+
+private:
+  /// \brief Give the next identifiers to a new variable of the given scope
+  template < typename T >
+  std::unique_ptr< T > with_id(T* var, ar::Function* scope = nullptr) {
+    auto v = static_cast< Variable* >(var);
+    v->_id = this->_next_id++;
+    v->_scope = scope;
+    v->_scope_id = (*this->_next_scope_id.get_or_create(scope, [] {
+      return std::make_unique< std::atomic< std::size_t > >(0);
+    }))++;
+    return std::unique_ptr< T >(var);
+  }
+
 public:
   /// \brief Constructor
   explicit VariableFactory(ar::Bundle* bundle);
@@ -565,8 +622,14 @@ namespace core {
 /// The index of Variable* is the address of the pointer.
 template <>
 struct IndexableTraits< analyzer::Variable* > {
-  static Index index(const analyzer::Variable* v) {
-    return reinterpret_cast< Index >(v);
+  static Index index(const analyzer::Variable* v) { return v->id(); }
+
+  static Index scope(const analyzer::Variable* v) {
+    return reinterpret_cast< Index >(v->scope());
+  }
+
+  static std::size_t dense_index(const analyzer::Variable* v) {
+    return v->scope_id();
   }
 };
 
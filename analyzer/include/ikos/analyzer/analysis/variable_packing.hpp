@@ -0,0 +1,129 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Syntactic pre-analysis computing fixed packs of variables
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <iosfwd>
+#include <memory>
+
+#include <ikos/core/domain/numeric/static_var_packing_domain.hpp>
+
+#include <ikos/analyzer/analysis/context.hpp>
+#include <ikos/analyzer/analysis/variable.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Compute fixed packs of numerical variables for a whole bundle
+///
+/// This is a cheap syntactic pre-analysis, similar to the one of Astrée.
+/// Within a function, the numerical variables (integers and pointer offsets)
+/// that appear together in an assignment, an addition, a subtraction, a
+/// comparison or a pointer shift are put in the same pack. Packs never span
+/// several functions, and their size is bounded by `MaxPackSize`.
+///
+/// The packs are used by the static variable packing domains, that never merge
+/// packs at runtime.
+class VariablePackingAnalysis {
+public:
+  /// \brief Fixed packs of variables
+  using VariablePackingT = core::numeric::VariablePacking< Variable* >;
+
+  /// \brief Maximum number of variables in a pack
+  static const std::size_t MaxPackSize = 16;
+
+private:
+  /// \brief Analysis context
+  Context& _ctx;
+
+  /// \brief Packs of variables
+  std::shared_ptr< VariablePackingT > _packing;
+
+public:
+  /// \brief Constructor
+  explicit VariablePackingAnalysis(Context& ctx);
+
+  /// \brief Deleted copy constructor
+  VariablePackingAnalysis(const VariablePackingAnalysis&) = delete;
+
+  /// \brief Deleted move constructor
+  VariablePackingAnalysis(VariablePackingAnalysis&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  VariablePackingAnalysis& operator=(const VariablePackingAnalysis&) = delete;
+
+  /// \brief Deleted move assignment operator
+  VariablePackingAnalysis& operator=(VariablePackingAnalysis&&) = delete;
+
+  /// \brief Destructor
+  ~VariablePackingAnalysis();
+
+  /// \brief Return the packs of variables
+  std::shared_ptr< const VariablePackingT > packing() const {
+    return this->_packing;
+  }
+
+  /// \brief Run the analysis
+  void run();
+
+private:
+  /// \brief Run the analysis on the given code
+  void run(ar::Code* code);
+
+  /// \brief Pack the numerical variables of `x` and `y`, if any
+  void pack(ar::Value* x, ar::Value* y);
+
+  /// \brief Get the numerical variable of an ar::Value
+  ///
+  /// Returns the variable itself for integers, the offset variable for
+  /// pointers, or nullptr if the value is not an internal or local variable.
+  Variable* numerical_variable(ar::Value* value) const;
+
+public:
+  /// \brief Dump the packs, for debugging purpose
+  void dump(std::ostream& o) const;
+
+}; // end class VariablePackingAnalysis
+
+} // end namespace analyzer
+} // end namespace ikos
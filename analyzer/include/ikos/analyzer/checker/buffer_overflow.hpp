@@ -44,6 +44,7 @@
 #pragma once
 
 #include <utility>
+#include <vector>
 
 #include <llvm/ADT/SmallVector.h>
 
@@ -104,6 +105,12 @@ public:
   /// \brief Get the checker description
   const char* description() const override;
 
+  /// \brief Return true if the checker handles the given statement kind
+  bool handles(ar::Statement::StatementKind kind) const override;
+
+  /// \brief End the checks for the given function
+  void leave(ar::Function* fun, CallContext* call_context) override;
+
   /// \brief Check a statement
   void check(ar::Statement* stmt,
              const value::AbstractDomain& inv,
@@ -115,9 +122,31 @@ private:
     CheckKind kind;
     Result result;
     llvm::SmallVector< ar::Value*, 2 > operands;
-    JsonDict info;
   };
 
+  /// \brief Result of the check of a memory location, for a memory access
+  struct MemoryLocationCheck {
+    MemoryLocation* addr;
+    Result result;
+    BufferOverflowCheckKind kind;
+    boost::optional< IntInterval > size; // Size of the memory location
+    boost::optional< IntInterval > diff; // offset + access_size - size
+  };
+
+  /// \brief Information on the last checked memory access
+  struct MemoryAccessInfo {
+    IntInterval offset;
+    IntInterval access_size;
+    boost::optional< MachineInt > array_element_size;
+    std::vector< MemoryLocationCheck > points_to;
+  };
+
+  /// \brief Information on the last checked memory access
+  ///
+  /// This is only turned into json for warnings and errors. The buffers are
+  /// reused across statements, and released when leaving a function.
+  MemoryAccessInfo _access_info;
+
   /// \brief Check a memory access (read/write) for buffer overflow
   ///
   /// The method checks that the memory access is valid and writes the result
@@ -152,7 +181,7 @@ private:
   CheckResult check_mem_access(ar::Statement* stmt,
                                ar::Value* pointer,
                                ar::Value* access_size,
-                               value::AbstractDomain inv);
+                               const value::AbstractDomain& inv);
 
   /// \brief Check a memory access (read/write)
   ///
@@ -170,7 +199,7 @@ private:
   /// \param offset_var The pointer offset
   /// \param offset_plus_size Shadow variable, = offset + access size
   /// \param offset_intv Offset int interval
-  /// \param block_info Json dictionnary for adding extra information
+  /// \param location_check Result of the check, for adding extra information
   std::pair< Result, BufferOverflowCheckKind > check_memory_location_access(
       ar::Statement* stmt,
       ar::Value* pointer,
@@ -181,7 +210,10 @@ private:
       Variable* offset_var,
       Variable* offset_plus_size,
       const IntInterval& offset_intv,
-      JsonDict& block_info);
+      MemoryLocationCheck& location_check);
+
+  /// \brief Build the information of the last checked memory access
+  void mem_access_info(JsonDict& info);
 
   /// \brief Check a string copy for overflow
   ///
@@ -43,7 +43,10 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
+#include <unordered_set>
+#include <vector>
 
 #include <ikos/ar/semantic/statement.hpp>
 
@@ -51,8 +54,11 @@
 #include <ikos/analyzer/analysis/context.hpp>
 #include <ikos/analyzer/analysis/literal.hpp>
 #include <ikos/analyzer/analysis/value/abstract_domain.hpp>
+#include <ikos/analyzer/checker/int_facts.hpp>
 #include <ikos/analyzer/checker/name.hpp>
+#include <ikos/analyzer/checker/pointer_facts.hpp>
 #include <ikos/analyzer/database/output.hpp>
+#include <ikos/analyzer/util/timer.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -75,6 +81,22 @@ protected:
   /// \brief Option to display the checks
   DisplayOption _display_checks;
 
+  /// \brief Literals of the last code checked, or null
+  const CodeLiterals* _code_literals;
+
+  /// \brief Facts about pointers, shared with the other checkers of the list
+  std::shared_ptr< PointerFactsCache > _pointer_facts;
+
+  /// \brief Facts about integer operands, shared with the other checkers of
+  /// the list
+  std::shared_ptr< IntFactsCache > _int_facts;
+
+  /// \brief Information of the current check
+  ///
+  /// The buffer is reused across statements, and released when leaving a
+  /// function.
+  JsonDict _info;
+
 protected:
   /// \brief Constructor
   explicit Checker(Context& ctx)
@@ -82,7 +104,10 @@ protected:
         _lit_factory(*ctx.lit_factory),
         _checks(ctx.output_db->checks),
         _display_invariants(ctx.opts.display_invariants),
-        _display_checks(ctx.opts.display_checks) {}
+        _display_checks(ctx.opts.display_checks),
+        _code_literals(nullptr),
+        _pointer_facts(std::make_shared< PointerFactsCache >()),
+        _int_facts(std::make_shared< IntFactsCache >()) {}
 
 public:
   /// \brief Deleted copy constructor
@@ -116,7 +141,9 @@ public:
   virtual void enter(ar::Function*, CallContext*) {}
 
   /// \brief End the checks for the given function
-  virtual void leave(ar::Function*, CallContext*) {}
+  ///
+  /// Overrides should call Checker::leave() to release the scratch buffers.
+  virtual void leave(ar::Function*, CallContext*) { this->_info = JsonDict(); }
 
   /// \brief Start the checks for the given basic block
   virtual void enter(ar::BasicBlock*,
@@ -128,11 +155,83 @@ public:
                      const value::AbstractDomain&,
                      CallContext*) {}
 
+  /// \brief Return true if the checker needs to check statements of the given
+  /// kind
+  ///
+  /// This is used to only call `check()` on relevant statements.
+  virtual bool handles(ar::Statement::StatementKind /*kind*/) const {
+    return true;
+  }
+
   /// \brief Check a statement
   virtual void check(ar::Statement* stmt,
                      const value::AbstractDomain& inv,
                      CallContext* call_context) = 0;
 
+  /// \brief Share the given cache of facts about pointers
+  void set_pointer_facts(std::shared_ptr< PointerFactsCache > pointer_facts) {
+    this->_pointer_facts = std::move(pointer_facts);
+  }
+
+  /// \brief Share the given cache of facts about integer operands
+  void set_int_facts(std::shared_ptr< IntFactsCache > int_facts) {
+    this->_int_facts = std::move(int_facts);
+  }
+
+protected:
+  /// \brief Return the literals of the result and operands of a statement
+  StatementLiterals literals(ar::Statement* stmt) {
+    ar::Code* code = stmt->code();
+    if (this->_code_literals == nullptr ||
+        this->_code_literals->code() != code) {
+      this->_code_literals = &this->_lit_factory.get(code);
+    }
+    return this->_code_literals->get(stmt);
+  }
+
+  /// \brief Return the facts about the given pointer, at the given statement
+  PointerFacts& pointer_facts(ar::Statement* stmt,
+                              Variable* ptr,
+                              const value::AbstractDomain& inv) {
+    return this->_pointer_facts->get(stmt, ptr, inv);
+  }
+
+  /// \brief Return the facts about the given integer variable, at the given
+  /// statement
+  IntFacts& int_facts(ar::Statement* stmt,
+                      Variable* var,
+                      const value::AbstractDomain& inv) {
+    return this->_int_facts->get(stmt, var, inv);
+  }
+
+  /// \brief Insert a check in the database
+  ///
+  /// The information of the check is only built for warnings and errors, by
+  /// calling `build_info(JsonDict&)` on a buffer reused across statements.
+  template < typename BuildInfo >
+  void insert_check(CheckKind kind,
+                    Result result,
+                    ar::Statement* stmt,
+                    CallContext* call_context,
+                    llvm::ArrayRef< ar::Value* > operands,
+                    const BuildInfo& build_info) {
+    if (result != Result::Warning && result != Result::Error) {
+      this->_checks
+          .insert(kind, this->name(), result, stmt, call_context, operands);
+      return;
+    }
+
+    this->_info.clear();
+    build_info(this->_info);
+    this->_checks.insert(kind,
+                         this->name(),
+                         result,
+                         stmt,
+                         call_context,
+                         operands,
+                         this->_info);
+  }
+
 protected:
   // Helpers to display checks and invariants
 
@@ -194,5 +293,92 @@ protected:
 /// \brief Create a checker, given its name
 std::unique_ptr< Checker > make_checker(Context& ctx, CheckerName name);
 
+/// \brief List of the checkers requested by the user
+///
+/// Statements are dispatched to the checkers handling their kind, using lists
+/// built once per statement kind. The time spent in each checker is measured.
+class CheckerList {
+private:
+  /// \brief Number of statement kinds
+  static constexpr std::size_t NumStatementKinds =
+      static_cast< std::size_t >(ar::Statement::ResumeKind) + 1;
+
+  /// \brief Index of a checker in the list
+  using CheckerIndex = std::size_t;
+
+public:
+  /// \brief Iterator over the checkers
+  using Iterator = std::vector< std::unique_ptr< Checker > >::const_iterator;
+
+private:
+  /// \brief Analysis context
+  Context& _ctx;
+
+  /// \brief Checkers
+  std::vector< std::unique_ptr< Checker > > _checkers;
+
+  /// \brief Checkers handling each statement kind
+  std::array< std::vector< CheckerIndex >, NumStatementKinds > _dispatch;
+
+  /// \brief Time spent in `Checker::check()`, for each checker
+  std::vector< Timer::Duration > _times;
+
+  /// \brief Functions to check, or empty to check all functions
+  std::unordered_set< ar::Function* > _selected;
+
+  /// \brief Facts about pointers, shared by the checkers
+  std::shared_ptr< PointerFactsCache > _pointer_facts;
+
+  /// \brief Facts about integer operands, shared by the checkers
+  std::shared_ptr< IntFactsCache > _int_facts;
+
+public:
+  /// \brief Create the checkers requested by the user
+  explicit CheckerList(Context& ctx);
+
+  /// \brief Deleted copy constructor
+  CheckerList(const CheckerList&) = delete;
+
+  /// \brief Default move constructor
+  CheckerList(CheckerList&&) noexcept = default;
+
+  /// \brief Deleted copy assignment operator
+  CheckerList& operator=(const CheckerList&) = delete;
+
+  /// \brief Deleted move assignment operator
+  CheckerList& operator=(CheckerList&&) = delete;
+
+  /// \brief Destructor
+  ~CheckerList() = default;
+
+  /// \brief Begin iterator over the checkers
+  Iterator begin() const { return this->_checkers.cbegin(); }
+
+  /// \brief End iterator over the checkers
+  Iterator end() const { return this->_checkers.cend(); }
+
+  /// \brief Return true if a checker handles the given statement kind
+  bool handles(ar::Statement::StatementKind kind) const {
+    return !this->_dispatch[kind].empty();
+  }
+
+  /// \brief Check a statement with the checkers handling its kind
+  ///
+  /// Statements outside of the functions selected by the user are ignored,
+  /// see AnalysisOptions::functions.
+  void check(ar::Statement* stmt,
+             const value::AbstractDomain& inv,
+             CallContext* call_context);
+
+  /// \brief Add the times spent in the checkers of another list
+  ///
+  /// Both lists must have been created with the same context.
+  void merge_times(const CheckerList& other);
+
+  /// \brief Insert the time spent in each checker in the times table
+  void report_times() const;
+
+}; // end class CheckerList
+
 } // end namespace analyzer
 } // end namespace ikos
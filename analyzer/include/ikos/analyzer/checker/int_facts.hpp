@@ -0,0 +1,127 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Facts about integer operands, shared by the arithmetic checkers
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2011-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <deque>
+
+#include <boost/optional.hpp>
+
+#include <ikos/ar/semantic/statement.hpp>
+
+#include <ikos/analyzer/analysis/value/abstract_domain.hpp>
+#include <ikos/analyzer/analysis/variable.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Facts about a machine integer variable, under a given invariant
+///
+/// Facts are computed lazily, on the first query, and kept for the next ones.
+class IntFacts {
+public:
+  using IntInterval = core::machine_int::Interval;
+  using Congruence = core::machine_int::Congruence;
+
+private:
+  /// \brief Machine integer variable
+  Variable* _var;
+
+  /// \brief Invariant
+  const value::AbstractDomain& _inv;
+
+  /// \brief Cached facts
+  boost::optional< bool > _uninitialized;
+  boost::optional< IntInterval > _interval;
+  boost::optional< Congruence > _congruence;
+
+public:
+  /// \brief Constructor
+  IntFacts(Variable* var, const value::AbstractDomain& inv)
+      : _var(var), _inv(inv) {}
+
+  /// \brief Return the machine integer variable
+  Variable* variable() const { return this->_var; }
+
+  /// \brief Return true if the variable is uninitialized
+  bool is_uninitialized();
+
+  /// \brief Return the interval of the variable
+  const IntInterval& interval();
+
+  /// \brief Return the congruence of the variable
+  const Congruence& congruence();
+
+}; // end class IntFacts
+
+/// \brief Facts about the integer operands of the statement being checked
+///
+/// The signed and unsigned integer overflow checkers and the division by zero
+/// checker query the same operands of arithmetic statements. The cache is
+/// shared by the checkers of a CheckerList, so that each operand is only
+/// queried once. It is invalidated like PointerFactsCache.
+class IntFactsCache {
+private:
+  /// \brief Statement being checked
+  ar::Statement* _stmt = nullptr;
+
+  /// \brief Invariant of the statement being checked
+  const value::AbstractDomain* _inv = nullptr;
+
+  /// \brief Facts about the integer operands of the statement
+  std::deque< IntFacts > _facts;
+
+public:
+  /// \brief Return the facts about the given variable, at the given statement
+  IntFacts& get(ar::Statement* stmt,
+                Variable* var,
+                const value::AbstractDomain& inv);
+
+  /// \brief Invalidate the cache
+  void clear();
+
+}; // end class IntFactsCache
+
+} // end namespace analyzer
+} // end namespace ikos
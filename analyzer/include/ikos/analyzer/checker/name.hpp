@@ -145,5 +145,18 @@ inline const char* checker_short_name(CheckerName checker) {
   }
 }
 
+/// \brief Return true if the given checker relies on the uninitialized
+/// variable abstract domain
+inline bool checker_needs_uninitialized(CheckerName checker) {
+  return checker == CheckerName::UninitializedVariable;
+}
+
+/// \brief Return true if the given checker relies on the lifetime abstract
+/// domain
+inline bool checker_needs_lifetime(CheckerName checker) {
+  return checker == CheckerName::BufferOverflow ||
+         checker == CheckerName::DoubleFree;
+}
+
 } // end namespace analyzer
 } // end namespace ikos
@@ -70,6 +70,9 @@ public:
   /// \brief Get the checker description
   const char* description() const override;
 
+  /// \brief Return true if the checker handles the given statement kind
+  bool handles(ar::Statement::StatementKind kind) const override;
+
   /// \brief Check a statement
   void check(ar::Statement* stmt,
              const value::AbstractDomain& inv,
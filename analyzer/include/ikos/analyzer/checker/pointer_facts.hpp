@@ -0,0 +1,142 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Facts about pointers, shared by the memory safety checkers
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2011-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <deque>
+
+#include <boost/optional.hpp>
+
+#include <ikos/ar/semantic/statement.hpp>
+
+#include <ikos/analyzer/analysis/value/abstract_domain.hpp>
+#include <ikos/analyzer/analysis/variable.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Facts about a pointer variable, under a given invariant
+///
+/// Facts are computed lazily, on the first query, and kept for the next ones.
+class PointerFacts {
+public:
+  using PointsToSet = core::PointsToSet< MemoryLocation* >;
+  using IntInterval = core::machine_int::Interval;
+  using Congruence = core::machine_int::Congruence;
+
+private:
+  /// \brief Pointer variable
+  Variable* _ptr;
+
+  /// \brief Invariant
+  const value::AbstractDomain& _inv;
+
+  /// \brief Cached facts
+  boost::optional< bool > _uninitialized;
+  boost::optional< core::Nullity > _nullity;
+  boost::optional< PointsToSet > _points_to;
+  boost::optional< IntInterval > _offset_interval;
+  boost::optional< Congruence > _offset_congruence;
+
+public:
+  /// \brief Constructor
+  PointerFacts(Variable* ptr, const value::AbstractDomain& inv)
+      : _ptr(ptr), _inv(inv) {}
+
+  /// \brief Return the pointer variable
+  Variable* pointer() const { return this->_ptr; }
+
+  /// \brief Return the variable representing the offset of the pointer
+  Variable* offset_var() const {
+    return this->_inv.normal().pointers().offset_var(this->_ptr);
+  }
+
+  /// \brief Return true if the pointer is uninitialized
+  bool is_uninitialized();
+
+  /// \brief Return the nullity of the pointer
+  core::Nullity nullity();
+
+  /// \brief Return true if the pointer is null
+  bool is_null() { return this->nullity().is_null(); }
+
+  /// \brief Return the points-to set of the pointer
+  const PointsToSet& points_to();
+
+  /// \brief Return the interval of the pointer offset
+  const IntInterval& offset_interval();
+
+  /// \brief Return the congruence of the pointer offset
+  const Congruence& offset_congruence();
+
+}; // end class PointerFacts
+
+/// \brief Facts about the pointers of the statement being checked
+///
+/// The cache is shared by the checkers of a CheckerList, so that a pointer
+/// checked by several checkers is only queried once. It is invalidated when
+/// the statement or the invariant changes, and by CheckerList::check().
+class PointerFactsCache {
+private:
+  /// \brief Statement being checked
+  ar::Statement* _stmt = nullptr;
+
+  /// \brief Invariant of the statement being checked
+  const value::AbstractDomain* _inv = nullptr;
+
+  /// \brief Facts about the pointers of the statement
+  std::deque< PointerFacts > _facts;
+
+public:
+  /// \brief Return the facts about the given pointer, at the given statement
+  PointerFacts& get(ar::Statement* stmt,
+                    Variable* ptr,
+                    const value::AbstractDomain& inv);
+
+  /// \brief Invalidate the cache
+  void clear();
+
+}; // end class PointerFactsCache
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,205 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Persistent cache of function results, for incremental analyses
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <llvm/ADT/StringMap.h>
+
+#include <ikos/ar/semantic/function.hpp>
+
+#include <ikos/analyzer/analysis/call_context.hpp>
+#include <ikos/analyzer/analysis/option.hpp>
+#include <ikos/analyzer/database/sqlite.hpp>
+#include <ikos/analyzer/database/table/checks.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Persistent cache of the checks of functions
+///
+/// The checks of each analyzed function are saved in a cache file, along with
+/// a hash of the function. Later runs with the same analysis options reuse the
+/// checks of functions that are unchanged, instead of analyzing them again.
+///
+/// For the intraprocedural analysis, the results of a function do not depend on
+/// its callers, and the cache is keyed by function.
+///
+/// For the interprocedural analysis, the cache is keyed by entry point, with a
+/// hash covering all the functions and global variables reachable from the
+/// entry point. A change in a function thus invalidates the results of all the
+/// entry points that might call it, directly or transitively.
+class FunctionCache {
+private:
+  /// \brief A check, where the statement and the operands are identified by
+  /// their position in the function
+  struct Check {
+    sqlite::DbInt64 kind;
+    sqlite::DbInt64 checker;
+    sqlite::DbInt64 status;
+    sqlite::DbInt64 block;                   // Basic block number
+    sqlite::DbInt64 statement;               // Statement number in the block
+    std::vector< sqlite::DbInt64 > operands; // Operand numbers
+    std::string info;
+    std::string function;     // Function of the statement, for entry points
+    std::string call_context; // Serialized call context, for entry points
+  };
+
+  /// \brief Cached results of a function
+  struct Entry {
+    std::string hash;
+    std::vector< Check > checks;
+  };
+
+private:
+  /// \brief Cache database
+  sqlite::DbConnection _db;
+
+  /// \brief String representing the analysis options
+  std::string _config;
+
+  /// \brief Entries loaded from the cache file
+  llvm::StringMap< Entry > _old_entries;
+
+  /// \brief Entries of the current run, written by save()
+  llvm::StringMap< Entry > _new_entries;
+
+  /// \brief Entry points loaded from the cache file
+  llvm::StringMap< Entry > _old_entry_points;
+
+  /// \brief Entry points of the current run, written by save()
+  llvm::StringMap< Entry > _new_entry_points;
+
+  /// \brief Mutex protecting the entries, for parallel analyses
+  std::mutex _mutex;
+
+  /// \brief Interval between checkpoints, or zero to disable checkpoints
+  std::chrono::seconds _checkpoint_interval{0};
+
+  /// \brief Time of the last checkpoint
+  std::chrono::steady_clock::time_point _last_checkpoint;
+
+public:
+  /// \brief Open the given cache file
+  ///
+  /// Entries computed with different analysis options are discarded.
+  FunctionCache(std::string filename, const AnalysisOptions& opts);
+
+  /// \brief Deleted copy constructor
+  FunctionCache(const FunctionCache&) = delete;
+
+  /// \brief Deleted move constructor
+  FunctionCache(FunctionCache&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  FunctionCache& operator=(const FunctionCache&) = delete;
+
+  /// \brief Deleted move assignment operator
+  FunctionCache& operator=(FunctionCache&&) = delete;
+
+  /// \brief Destructor
+  ~FunctionCache();
+
+  /// \brief Return the hash of the given function
+  static std::string hash(ar::Function* fun);
+
+  /// \brief Look for the checks of an unchanged function
+  ///
+  /// Return true and fill `buffer` with the checks on success.
+  bool lookup(ar::Function* fun,
+              CallContext* call_context,
+              ChecksTable::Buffer& buffer);
+
+  /// \brief Record the checks of the given function
+  void record(ar::Function* fun, const ChecksTable::Buffer& buffer);
+
+  /// \brief Look for the checks of an entry point, for the interprocedural
+  /// analysis
+  ///
+  /// \param entry_point The entry point
+  /// \param hash Hash of the code reachable from the entry point
+  /// \param factory Factory to rebuild the call contexts of the checks
+  /// \param buffer Filled with the checks on success
+  ///
+  /// Return true on success.
+  bool lookup_entry_point(ar::Function* entry_point,
+                          const std::string& hash,
+                          CallContextFactory& factory,
+                          ChecksTable::Buffer& buffer);
+
+  /// \brief Record the checks of an entry point, for the interprocedural
+  /// analysis
+  void record_entry_point(ar::Function* entry_point,
+                          const std::string& hash,
+                          const ChecksTable::Buffer& buffer);
+
+  /// \brief Periodically write the cache file during the analysis
+  ///
+  /// A checkpoint writes the entries of the current run, and keeps the
+  /// entries loaded from the cache file that were not visited yet. This allows
+  /// an interrupted analysis to resume from the last checkpoint.
+  void enable_checkpoints(std::chrono::seconds interval);
+
+  /// \brief Write the entries of the current run in the cache file
+  void save();
+
+private:
+  /// \brief Write a checkpoint if the interval has elapsed
+  ///
+  /// The mutex must be held.
+  void checkpoint_if_due();
+
+  /// \brief Write the cache file
+  ///
+  /// \param keep_old_entries Also write the entries loaded from the cache file
+  /// that were not visited by the current run
+  void write(bool keep_old_entries);
+
+}; // end class FunctionCache
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,154 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Columnar output files for large database tables
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2011-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ikos/analyzer/support/string_ref.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace columnar {
+
+/// \brief Tag of a value in a column
+///
+/// Each column of a table is stored in three files:
+///   * `<table>.<column>.tag`: one tag per row (1 byte)
+///   * `<table>.<column>.val`: one value per row (8 bytes, little endian),
+///     either an integer, a double, or the offset of a text or binary data in
+///     the text file
+///   * `<table>.<column>.txt`: texts and binary data, each prefixed by its
+///     length (4 bytes, little endian)
+///
+/// Column numbers start at 0, in the order of the table columns. Values are
+/// written in the order of insertion, so rows are not sorted by id.
+enum class Tag : std::uint8_t {
+  Null = 0,
+  Integer = 1,
+  Real = 2,
+  Text = 3,
+  Blob = 4
+};
+
+/// \brief Write the rows of a table in columnar files
+class TableWriter {
+private:
+  /// \brief Files of a column
+  struct Column {
+    std::ofstream tags;
+    std::ofstream values;
+    std::ofstream texts;
+    std::uint64_t texts_size = 0;
+  };
+
+private:
+  /// \brief Table name
+  std::string _table_name;
+
+  /// \brief Columns
+  std::vector< std::unique_ptr< Column > > _columns;
+
+  /// \brief Index of the current column
+  std::size_t _current_column = 0;
+
+public:
+  /// \brief Constructor
+  ///
+  /// \param directory The directory of the columnar files
+  /// \param table_name The table name
+  /// \param columns Number of columns
+  TableWriter(const std::string& directory, StringRef table_name, int columns);
+
+  /// \brief Deleted copy constructor
+  TableWriter(const TableWriter&) = delete;
+
+  /// \brief Deleted move constructor
+  TableWriter(TableWriter&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  TableWriter& operator=(const TableWriter&) = delete;
+
+  /// \brief Deleted move assignment operator
+  TableWriter& operator=(TableWriter&&) = delete;
+
+  /// \brief Destructor
+  ~TableWriter();
+
+  /// \brief Insert a string
+  void add(StringRef s);
+
+  /// \brief Insert NULL
+  void add_null();
+
+  /// \brief Insert an integer
+  void add(std::int64_t n);
+
+  /// \brief Insert a double
+  void add(double d);
+
+  /// \brief Insert binary data
+  void add_blob(StringRef b);
+
+  /// \brief Mark the end of a row
+  void end_row();
+
+private:
+  /// \brief Return the current column, and move to the next one
+  Column& next_column();
+
+  /// \brief Write a tag and a value in the given column
+  static void write(Column& column, Tag tag, std::uint64_t value);
+
+  /// \brief Insert a text or binary data, with the given tag
+  void add_text(Tag tag, StringRef s);
+
+}; // end class TableWriter
+
+} // end namespace columnar
+} // end namespace analyzer
+} // end namespace ikos
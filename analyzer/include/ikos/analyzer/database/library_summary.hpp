@@ -0,0 +1,164 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Summaries of library functions, reused across analyses
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <mutex>
+#include <string>
+
+#include <boost/optional.hpp>
+
+#include <llvm/ADT/StringMap.h>
+
+#include <ikos/core/number/z_number.hpp>
+
+#include <ikos/ar/semantic/function.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Summary of a library function
+///
+/// The summary holds for any calling context: it is computed by the
+/// intraprocedural analysis, with a top entry state.
+struct LibrarySummary {
+  /// \brief False if the function never returns normally
+  bool returns = true;
+
+  /// \brief True if the function might write in memory
+  ///
+  /// This is false if the function has no store and no call.
+  bool writes_memory = true;
+
+  /// \brief True if the function might throw an exception
+  ///
+  /// This is false if the function has no call and no resume.
+  bool may_throw = true;
+
+  /// \brief Lower bound of the returned integer, if known
+  boost::optional< core::ZNumber > return_lb;
+
+  /// \brief Upper bound of the returned integer, if known
+  boost::optional< core::ZNumber > return_ub;
+};
+
+/// \brief Summaries of library functions
+///
+/// A library bundle is analyzed once with the intraprocedural analysis, and
+/// the summaries of its functions are saved in a summary package, see
+/// save(). Analyses of applications linking the library load the package and
+/// use the summaries instead of analyzing the library functions again.
+///
+/// Each summary is keyed by the name of the function and versioned by the
+/// hash of its body, so a summary is only used on the exact same code.
+class LibrarySummaries {
+private:
+  /// \brief Summary of a function, with the hash of the function
+  struct Entry {
+    std::string hash;
+    LibrarySummary summary;
+  };
+
+private:
+  /// \brief Summaries, by function name
+  llvm::StringMap< Entry > _entries;
+
+  /// \brief Mutex protecting the entries, for parallel analyses
+  mutable std::mutex _mutex;
+
+public:
+  /// \brief Version of the format of the summary packages
+  static constexpr int FormatVersion = 1;
+
+public:
+  /// \brief Create an empty set of summaries
+  LibrarySummaries();
+
+  /// \brief Deleted copy constructor
+  LibrarySummaries(const LibrarySummaries&) = delete;
+
+  /// \brief Deleted move constructor
+  LibrarySummaries(LibrarySummaries&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  LibrarySummaries& operator=(const LibrarySummaries&) = delete;
+
+  /// \brief Deleted move assignment operator
+  LibrarySummaries& operator=(LibrarySummaries&&) = delete;
+
+  /// \brief Destructor
+  ~LibrarySummaries();
+
+  /// \brief Load the summaries of the given summary package
+  ///
+  /// Throws an ArgumentError if the file is not a summary package of the
+  /// current format version.
+  void load(const std::string& filename);
+
+  /// \brief Save the summaries in the given summary package
+  void save(const std::string& filename) const;
+
+  /// \brief Return the number of summaries
+  std::size_t size() const;
+
+  /// \brief Return the summary of the given function, or null if there is no
+  /// summary for this version of the function
+  const LibrarySummary* lookup(ar::Function* fun) const;
+
+  /// \brief Record the summary of the given function
+  ///
+  /// \param fun The function
+  /// \param returns False if the exit block is unreachable
+  /// \param return_lb Lower bound of the returned integer, if known
+  /// \param return_ub Upper bound of the returned integer, if known
+  ///
+  /// The effects of the function are computed from its body.
+  void record(ar::Function* fun,
+              bool returns,
+              boost::optional< core::ZNumber > return_lb,
+              boost::optional< core::ZNumber > return_ub);
+
+}; // end class LibrarySummaries
+
+} // end namespace analyzer
+} // end namespace ikos
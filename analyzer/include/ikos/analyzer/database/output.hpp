@@ -44,19 +44,35 @@
 #pragma once
 
 #include <ikos/analyzer/database/sqlite.hpp>
+#include <ikos/analyzer/database/table/budgets.hpp>
 #include <ikos/analyzer/database/table/call_contexts.hpp>
 #include <ikos/analyzer/database/table/checks.hpp>
 #include <ikos/analyzer/database/table/files.hpp>
+#include <ikos/analyzer/database/table/fixpoints.hpp>
 #include <ikos/analyzer/database/table/functions.hpp>
 #include <ikos/analyzer/database/table/memory_locations.hpp>
 #include <ikos/analyzer/database/table/operands.hpp>
 #include <ikos/analyzer/database/table/settings.hpp>
+#include <ikos/analyzer/database/table/state_sizes.hpp>
 #include <ikos/analyzer/database/table/statements.hpp>
 #include <ikos/analyzer/database/table/times.hpp>
+#include <ikos/analyzer/database/table/transfer_functions.hpp>
 
 namespace ikos {
 namespace analyzer {
 
+/// \brief Output format
+enum class OutputFormat {
+  /// \brief Write all tables in the SQLite database
+  SQLite,
+
+  /// \brief Write the checks, statements, operands and call contexts tables
+  /// in columnar files, next to the SQLite database
+  ///
+  /// \see columnar::TableWriter
+  Columnar,
+};
+
 /// \brief Output database
 class OutputDatabase {
 public:
@@ -70,10 +86,22 @@ public:
   CallContextsTable call_contexts;
   MemoryLocationsTable memory_locations;
   ChecksTable checks;
+  BudgetsTable budgets;
+  FixpointsTable fixpoints;
+  TransferFunctionsTable transfer_functions;
+  StateSizesTable state_sizes;
 
 public:
   /// \brief Constructor
-  explicit OutputDatabase(sqlite::DbConnection& db_);
+  ///
+  /// \param db_ The database connection
+  /// \param defer_indexes True to create the table indexes in
+  /// create_indexes(), once all rows are inserted
+  explicit OutputDatabase(sqlite::DbConnection& db_,
+                          bool defer_indexes = false);
+
+  /// \brief Create the indexes of all tables
+  void create_indexes();
 
 }; // end class OutputDatabase
 
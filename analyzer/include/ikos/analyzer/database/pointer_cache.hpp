@@ -0,0 +1,113 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Persistent cache of the pointer analyses results
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <string>
+
+#include <ikos/analyzer/analysis/context.hpp>
+#include <ikos/analyzer/analysis/pointer/value.hpp>
+#include <ikos/analyzer/database/sqlite.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Persistent cache of the results of the pointer analyses
+///
+/// The function pointer analysis and the pointer analysis of the
+/// intraprocedural analysis only depend on the program, not on the checkers
+/// or the abstract domain. Their results are saved in a cache file, along with
+/// the hash of the bundle, and reloaded by later runs on the same program.
+///
+/// Variables and memory locations are identified by the name of their
+/// function or global variable, and their position in it. The results of an
+/// analysis referring to other kinds of variables or memory locations are not
+/// cached.
+class PointerCache {
+private:
+  /// \brief Cache database
+  sqlite::DbConnection _db;
+
+  /// \brief Analysis context
+  Context& _ctx;
+
+  /// \brief String representing the bundle and the analysis options
+  std::string _config;
+
+  /// \brief True if the cache file holds results for the current config
+  bool _valid = false;
+
+public:
+  /// \brief Open the given cache file
+  ///
+  /// Results computed on a different program are discarded.
+  PointerCache(std::string filename, Context& ctx);
+
+  /// \brief Deleted copy constructor
+  PointerCache(const PointerCache&) = delete;
+
+  /// \brief Deleted move constructor
+  PointerCache(PointerCache&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  PointerCache& operator=(const PointerCache&) = delete;
+
+  /// \brief Deleted move assignment operator
+  PointerCache& operator=(PointerCache&&) = delete;
+
+  /// \brief Destructor
+  ~PointerCache();
+
+  /// \brief Load the results of the given analysis in `info`
+  ///
+  /// Return false, leaving `info` empty, if the cache holds no results for
+  /// the current program.
+  bool load(const std::string& analysis, PointerInfo& info);
+
+  /// \brief Save the results of the given analysis
+  void save(const std::string& analysis, const PointerInfo& info);
+
+}; // end class PointerCache
+
+} // end namespace analyzer
+} // end namespace ikos
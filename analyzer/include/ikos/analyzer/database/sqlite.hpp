@@ -45,8 +45,11 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <sqlite3.h>
 
@@ -58,6 +61,13 @@
 
 namespace ikos {
 namespace analyzer {
+
+namespace columnar {
+
+class TableWriter;
+
+} // end namespace columnar
+
 namespace sqlite {
 
 /// \brief Database error
@@ -126,6 +136,11 @@ using DbInt64 = sqlite3_int64;
 /// \brief Double type for SQLite
 using DbDouble = double;
 
+/// \brief Binary data for SQLite
+struct DbBlob {
+  StringRef data;
+};
+
 /// \brief Column type
 enum class DbColumnType { Text, Integer, Real, Blob };
 
@@ -146,14 +161,40 @@ enum class CommitPolicy {
   /// \brief Automatically start new transactions every MaxRowsPerTransaction
   /// inserted rows
   Auto = 1,
+
+  /// \brief Insert rows from a dedicated writer thread
+  ///
+  /// Rows are pushed in a bounded queue, and written by the writer thread in
+  /// transactions of MaxRowsPerTransaction rows.
+  Async = 2,
+};
+
+/// \brief A value of a row, queued for the asynchronous writer
+struct DbValue {
+  enum class Kind { Null, Integer, Real, Text, Blob };
+
+  Kind kind;
+  DbInt64 integer;
+  DbDouble real;
+  std::string text;
 };
 
+/// \brief Writer thread for CommitPolicy::Async
+class AsyncWriter;
+
+class DbOstream;
+
 /// \brief SQLite connection
 class DbConnection {
 public:
-  /// \brief Maximum number of rows per transaction, in CommitPolicy::Auto
+  /// \brief Maximum number of rows per transaction, in CommitPolicy::Auto and
+  /// CommitPolicy::Async
   static const int MaxRowsPerTransaction = 8192;
 
+  /// \brief Maximum number of rows waiting to be written, in
+  /// CommitPolicy::Async
+  static const std::size_t MaxQueuedRows = 65536;
+
 private:
   /// \brief Filename
   std::string _filename;
@@ -167,6 +208,30 @@ private:
   /// \brief Number of inserted rows, in CommitPolicy::Auto
   std::size_t _inserted_rows = 0;
 
+  /// \brief Writer thread, in CommitPolicy::Async
+  std::unique_ptr< AsyncWriter > _writer;
+
+  /// \brief Output streams buffering rows in batches
+  std::vector< DbOstream* > _batched_ostreams;
+
+  /// \brief Directory of the columnar files
+  std::string _columnar_directory;
+
+  /// \brief Tables written in columnar files instead of the database
+  std::vector< std::string > _columnar_tables;
+
+  /// \brief Minimum duration between two commits of publish(), or zero if
+  /// publish() is disabled
+  std::chrono::steady_clock::duration _publish_interval{0};
+
+  /// \brief Time of the last commit of publish()
+  std::chrono::steady_clock::time_point _last_publish;
+
+  /// \brief Mutex protecting the connection and the tables using it
+  ///
+  /// This is a recursive mutex because tables insert rows in other tables.
+  std::recursive_mutex _mutex;
+
 public:
   /// \brief Deleted default constructor
   DbConnection() = delete;
@@ -192,6 +257,12 @@ public:
   /// \brief Return the database filename
   const std::string& filename() const { return this->_filename; }
 
+  /// \brief Return the mutex protecting the connection
+  ///
+  /// Tables lock it on insertion, so that parallel analyses can share a
+  /// database connection.
+  std::recursive_mutex& mutex() { return this->_mutex; }
+
   /// \brief Execute a SQL command
   void exec_command(const char* cmd);
 
@@ -213,9 +284,44 @@ public:
   /// \brief Return the current commit policy
   CommitPolicy commit_policy() const { return this->_commit_policy; }
 
+  /// \brief Write the rows of the given tables in columnar files
+  ///
+  /// This only applies to output streams created afterwards. The tables are
+  /// still created in the database, but remain empty.
+  ///
+  /// \param directory The directory of the columnar files
+  /// \param tables The table names
+  /// \see columnar::TableWriter
+  void set_columnar_tables(std::string directory,
+                           std::vector< std::string > tables);
+
+  /// \brief Enable publish(), with the given minimum duration between two
+  /// commits
+  ///
+  /// This is meant for databases in JournalMode::WAL, read by another process
+  /// during the analysis.
+  void set_publish_interval(std::chrono::milliseconds interval);
+
+  /// \brief Write the buffered rows and commit the current transaction, so
+  /// that concurrent readers see them
+  ///
+  /// This does nothing if publish() is disabled, if the last commit of
+  /// publish() is more recent than the publish interval, or in
+  /// CommitPolicy::Manual.
+  void publish();
+
+  /// \brief Write the buffered rows and release the memory used by SQLite3
+  ///
+  /// This is used when the memory usage exceeds the spill limit, see
+  /// MemoryGovernor.
+  void release_memory();
+
 private:
-  /// \brief Called upon a row insertion
-  void row_inserted();
+  /// \brief Called upon the insertion of the given number of rows
+  void row_inserted(std::size_t rows = 1);
+
+  /// \brief Write the rows buffered by all output streams
+  void flush_batches();
 
 public:
   /// \brief Remove a table
@@ -252,6 +358,9 @@ private:
   /// \brief Database connection
   DbConnection& _db;
 
+  /// \brief Table name
+  std::string _table_name;
+
   /// \brief SQLite3 prepared statement
   sqlite3_stmt* _stmt = nullptr;
 
@@ -261,16 +370,52 @@ private:
   /// \brief Current number of column entered
   int _current_column = 1;
 
+  /// \brief Maximum number of rows inserted by a single statement
+  int _batch_rows;
+
+  /// \brief SQLite3 prepared statement inserting _batch_rows rows
+  ///
+  /// This is prepared lazily, on the first full batch.
+  sqlite3_stmt* _batch_stmt = nullptr;
+
+  /// \brief Number of complete rows in _values
+  int _pending_rows = 0;
+
+  /// \brief Values of the buffered rows, in CommitPolicy::Async or when
+  /// batching rows
+  std::vector< DbValue > _values;
+
+  /// \brief Columnar files writer, if the table is written in columnar files
+  std::unique_ptr< columnar::TableWriter > _columnar;
+
+public:
+  /// \brief Default number of rows per batch, for large tables
+  static const int DefaultBatchRows = 64;
+
+  /// \brief Maximum number of variables in a SQLite3 statement
+  ///
+  /// This is the default value of SQLITE_MAX_VARIABLE_NUMBER prior to 3.32.
+  static const int MaxVariables = 999;
+
 public:
   /// \brief Deleted default constructor
   DbOstream() = delete;
 
   /// \brief Constructor
   ///
+  /// If batch_rows is greater than 1, rows are buffered and inserted by groups
+  /// of batch_rows rows through a single multi-row INSERT statement. Buffered
+  /// rows are written on transaction boundaries, commit policy changes,
+  /// queries and destruction.
+  ///
   /// \param db The database connection
   /// \param table_name The table name
   /// \param columns Number of columns
-  DbOstream(DbConnection& db, StringRef table_name, int columns);
+  /// \param batch_rows Number of rows per batch
+  DbOstream(DbConnection& db,
+            StringRef table_name,
+            int columns,
+            int batch_rows = 1);
 
   /// \brief Deleted copy constructor
   DbOstream(const DbOstream&) = delete;
@@ -300,9 +445,28 @@ public:
   /// \brief Insert a double
   void add(DbDouble d);
 
+  /// \brief Insert binary data
+  void add(DbBlob b);
+
   /// \brief Flush the row
   void flush();
 
+  /// \brief Write all buffered rows
+  void flush_batch();
+
+private:
+  /// \brief Return true if values are buffered in _values
+  bool is_buffered() const {
+    return this->_batch_rows > 1 || this->_db._writer != nullptr;
+  }
+
+  /// \brief Prepare an INSERT statement for the given number of rows
+  sqlite3_stmt* prepare_insert(int rows) const;
+
+  /// \brief Write the given number of buffered rows, starting at the given
+  /// value index, with the given statement
+  void write_rows(sqlite3_stmt* stmt, std::size_t begin, int rows);
+
   // friends
   friend DbOstream& end_row(DbOstream&);
 
@@ -338,6 +502,12 @@ inline DbOstream& operator<<(DbOstream& o, DbDouble d) {
   return o;
 }
 
+/// \brief Insert binary data
+inline DbOstream& operator<<(DbOstream& o, DbBlob b) {
+  o.add(b);
+  return o;
+}
+
 /// \brief Insert sqlite::end_row or sqlite::null
 inline DbOstream& operator<<(DbOstream& o, DbOstream& (*m)(DbOstream&)) {
   if (m == &end_row) {
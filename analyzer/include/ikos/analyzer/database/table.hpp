@@ -44,6 +44,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <ikos/analyzer/database/sqlite.hpp>
 
@@ -59,12 +60,18 @@ protected:
   /// \brief Table name
   std::string _name;
 
+  /// \brief Indexed columns
+  std::vector< std::string > _indexes;
+
 public:
   /// \brief Deleted default constructor
   DatabaseTable() = delete;
 
   /// \brief Constructor
   ///
+  /// The indexes are not created until create_indexes() is called, since
+  /// inserting rows in an indexed table is slower.
+  ///
   /// \param db The database connection
   /// \param name The table name
   /// \param cols The table columns
@@ -93,6 +100,9 @@ public:
   /// \brief Name of the table
   const std::string& name() const { return this->_name; }
 
+  /// \brief Create the table indexes
+  void create_indexes();
+
 }; // end class DatabaseTable
 
 } // end namespace analyzer
@@ -43,6 +43,20 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/raw_ostream.h>
+
 #include <ikos/analyzer/analysis/result.hpp>
 #include <ikos/analyzer/checker/kind.hpp>
 #include <ikos/analyzer/checker/name.hpp>
@@ -51,10 +65,13 @@
 #include <ikos/analyzer/database/table/operands.hpp>
 #include <ikos/analyzer/database/table/statements.hpp>
 #include <ikos/analyzer/json/json.hpp>
+#include <ikos/analyzer/util/spill_store.hpp>
 
 namespace ikos {
 namespace analyzer {
 
+class MemoryGovernor;
+
 /// \brief Checks table
 class ChecksTable : public DatabaseTable {
 private:
@@ -73,6 +90,105 @@ private:
   /// \brief Last inserted id
   sqlite::DbInt64 _last_insert_id = 0;
 
+  /// \brief Checks merged across call contexts
+  struct AggregatedCheck {
+    CheckKind kind;
+    CheckerName checker;
+    Result status;
+    ar::Statement* stmt;
+    CallContext* call_context; // First call context with the worst status
+    std::vector< ar::Value* > operands;
+    std::string info;
+    std::vector< CallContext* > call_contexts; // Sample of call contexts
+    std::size_t num_call_contexts;
+  };
+
+  /// \brief Key of an aggregated check
+  using AggregatedCheckKey =
+      std::tuple< ar::Statement*, CheckerName, CheckKind >;
+
+  /// \brief Hash function for AggregatedCheckKey
+  struct AggregatedCheckKeyHash {
+    std::size_t operator()(const AggregatedCheckKey& k) const {
+      std::size_t hash = 0;
+      boost::hash_combine(hash, std::get< 0 >(k));
+      boost::hash_combine(hash, static_cast< int >(std::get< 1 >(k)));
+      boost::hash_combine(hash, static_cast< int >(std::get< 2 >(k)));
+      return hash;
+    }
+  };
+
+  /// \brief Maximum number of call contexts kept per aggregated check, or
+  /// boost::none if checks are not aggregated
+  boost::optional< unsigned > _max_aggregated_call_contexts;
+
+  /// \brief Stream receiving each check as a JSON line, or null
+  llvm::raw_ostream* _stream = nullptr;
+
+  /// \brief Aggregated checks, in insertion order
+  std::vector< AggregatedCheck > _aggregated;
+
+  /// \brief Map from keys to indexes in _aggregated
+  std::unordered_map< AggregatedCheckKey, std::size_t, AggregatedCheckKeyHash >
+      _aggregated_map;
+
+  /// \brief Memory governor, or null
+  const MemoryGovernor* _memory_governor = nullptr;
+
+  /// \brief Store of the spilled information of buffered checks, or null
+  std::unique_ptr< SpillStore > _spill_store;
+
+  /// \brief Mutex protecting the creation of _spill_store
+  std::mutex _spill_mutex;
+
+  /// \brief Last spill generation for which the database memory was released
+  std::atomic< unsigned > _released_generation{0};
+
+public:
+  /// \brief A check that is not yet written in the database
+  struct Check {
+    CheckKind kind;
+    CheckerName checker;
+    Result status;
+    ar::Statement* stmt;
+    CallContext* call_context;
+    llvm::SmallVector< ar::Value*, 2 > operands;
+    SpillableString info; // String representation of the information, or empty
+  };
+
+  /// \brief List of checks, used to write checks in a deterministic order
+  using Buffer = std::vector< Check >;
+
+  /// \brief Redirect the checks inserted by the current thread into a buffer
+  ///
+  /// This is used by parallel analyses: checks are collected by each thread,
+  /// and written later with flush(), in a deterministic order.
+  class BufferScope {
+  private:
+    /// \brief Previous buffer of the current thread
+    Buffer* _previous;
+
+  public:
+    /// \brief Constructor
+    explicit BufferScope(Buffer& buffer);
+
+    /// \brief Deleted copy constructor
+    BufferScope(const BufferScope&) = delete;
+
+    /// \brief Deleted move constructor
+    BufferScope(BufferScope&&) = delete;
+
+    /// \brief Deleted copy assignment operator
+    BufferScope& operator=(const BufferScope&) = delete;
+
+    /// \brief Deleted move assignment operator
+    BufferScope& operator=(BufferScope&&) = delete;
+
+    /// \brief Destructor
+    ~BufferScope();
+
+  }; // end class BufferScope
+
 public:
   /// \brief Constructor
   explicit ChecksTable(sqlite::DbConnection& db,
@@ -89,6 +205,87 @@ public:
               llvm::ArrayRef< ar::Value* > operands = {},
               const JsonDict& info = {});
 
+  /// \brief Write all the checks in the given buffer, and clear it
+  ///
+  /// If the checks of the current thread are redirected into another buffer,
+  /// see BufferScope, the checks are moved into that buffer instead.
+  void flush(Buffer& buffer);
+
+  /// \brief Return the number of warnings and errors inserted by the current
+  /// thread
+  static std::size_t num_unsafe_checks();
+
+  /// \brief Merge the checks on the same statement, from the same checker and
+  /// of the same kind, across call contexts
+  ///
+  /// Merged checks are kept in memory until write_aggregated() is called. The
+  /// status of a merged check is the worst status, from the most to the least
+  /// severe: error, warning, ok, unreachable.
+  ///
+  /// \param max_call_contexts Maximum number of call contexts listed in the
+  /// information of a merged check
+  void enable_aggregation(unsigned max_call_contexts);
+
+  /// \brief Write the merged checks in the database, one row per check
+  void write_aggregated();
+
+  /// \brief Write each check on the given stream, as a JSON line, as soon as
+  /// it is inserted
+  ///
+  /// Checks are streamed before they are buffered or merged, so a line is
+  /// written for each call context. The stream is flushed after each line.
+  void enable_stream(llvm::raw_ostream& stream);
+
+  /// \brief Spill the buffered checks to disk when the memory usage exceeds
+  /// the spill limit of the given memory governor
+  ///
+  /// While the memory usage is above the spill limit, the information of the
+  /// checks buffered by a thread is written in a temporary file, and the
+  /// database releases the memory of its buffered rows.
+  void set_memory_governor(const MemoryGovernor* memory_governor);
+
+private:
+  /// \brief Spill the information of the checks in the given buffer, and the
+  /// rows buffered by the database, if the memory usage exceeds the spill
+  /// limit
+  void spill(Buffer* buffer);
+
+  /// \brief Write a check on the stream, as a JSON line
+  void stream(CheckKind kind,
+              CheckerName checker,
+              Result status,
+              ar::Statement* stmt,
+              CallContext* call_context,
+              const JsonDict& info);
+
+  /// \brief Write a check in the database, or merge it if aggregation is
+  /// enabled
+  void write(CheckKind kind,
+             CheckerName checker,
+             Result status,
+             ar::Statement* stmt,
+             CallContext* call_context,
+             llvm::ArrayRef< ar::Value* > operands,
+             StringRef info);
+
+  /// \brief Merge a check with the previous checks of its group
+  void aggregate(CheckKind kind,
+                 CheckerName checker,
+                 Result status,
+                 ar::Statement* stmt,
+                 CallContext* call_context,
+                 llvm::ArrayRef< ar::Value* > operands,
+                 StringRef info);
+
+  /// \brief Write a row in the database
+  void write_row(CheckKind kind,
+                 CheckerName checker,
+                 Result status,
+                 ar::Statement* stmt,
+                 CallContext* call_context,
+                 llvm::ArrayRef< ar::Value* > operands,
+                 StringRef info);
+
 }; // end class ChecksTable
 
 } // end namespace analyzer
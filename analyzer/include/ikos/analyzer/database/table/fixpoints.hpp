@@ -0,0 +1,113 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Fixpoints database table
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <ikos/ar/semantic/statement.hpp>
+
+#include <ikos/analyzer/analysis/call_context.hpp>
+#include <ikos/analyzer/database/table.hpp>
+#include <ikos/analyzer/database/table/call_contexts.hpp>
+#include <ikos/analyzer/database/table/functions.hpp>
+#include <ikos/analyzer/database/table/statements.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Fixpoints table
+///
+/// Records statistics on the fixpoint iterations on each cycle.
+class FixpointsTable : public DatabaseTable {
+private:
+  /// \brief Functions table
+  FunctionsTable& _functions;
+
+  /// \brief Statements table
+  StatementsTable& _statements;
+
+  /// \brief Call contexts table
+  CallContextsTable& _call_contexts;
+
+  /// \brief Database output stream
+  sqlite::DbOstream _row;
+
+public:
+  /// \brief Constructor
+  FixpointsTable(sqlite::DbConnection& db,
+                 FunctionsTable& functions,
+                 StatementsTable& statements,
+                 CallContextsTable& call_contexts);
+
+  /// \brief Insert a row for the iterations on a cycle
+  ///
+  /// \param fun Analyzed function
+  /// \param head First statement of the cycle head, or null
+  /// \param call_context Call context of the analysis
+  /// \param increasing_iterations Number of increasing iterations
+  /// \param widenings Number of widenings
+  /// \param narrowings Number of narrowings
+  /// \param time Wall time, in seconds
+  /// \param peak_size Peak size of the invariant at the cycle head
+  /// \param copies Number of invariants copied by the fixpoint iterator
+  /// \param analyzed_nodes Number of basic blocks analyzed
+  /// \param reused_nodes Number of basic blocks whose post invariant was
+  /// reused because their pre invariant did not change
+  /// \param skipped_narrowings Number of decreasing iterations skipped
+  /// because the increasing iterations converged without widening
+  void insert(ar::Function* fun,
+              ar::Statement* head,
+              CallContext* call_context,
+              sqlite::DbInt64 increasing_iterations,
+              sqlite::DbInt64 widenings,
+              sqlite::DbInt64 narrowings,
+              sqlite::DbDouble time,
+              sqlite::DbInt64 peak_size,
+              sqlite::DbInt64 copies,
+              sqlite::DbInt64 analyzed_nodes,
+              sqlite::DbInt64 reused_nodes,
+              sqlite::DbInt64 skipped_narrowings);
+
+}; // end class FixpointsTable
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -44,10 +44,12 @@
 #pragma once
 
 #include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/StringMap.h>
 #include <llvm/IR/Constant.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
+#include <ikos/ar/semantic/function.hpp>
 #include <ikos/ar/semantic/value.hpp>
 
 #include <ikos/analyzer/database/table.hpp>
@@ -64,6 +66,12 @@ private:
   /// \brief Map from ar::Value* to id
   llvm::DenseMap< ar::Value*, sqlite::DbInt64 > _map;
 
+  /// \brief Map from operand kind and textual representation to id
+  ///
+  /// Operands with the same kind and representation, for instance the same
+  /// constant or local variable name in different functions, share a row.
+  llvm::StringMap< sqlite::DbInt64 > _repr_map;
+
   /// \brief Last inserted id
   sqlite::DbInt64 _last_insert_id = 0;
 
@@ -74,6 +82,14 @@ public:
   /// \brief Insert the given operand in the database and return the id
   sqlite::DbInt64 insert(ar::Value* value);
 
+  /// \brief Remove the ids of the internal variables, local variables and
+  /// parameters of the given function
+  ///
+  /// This must be called before the function body is destroyed, since the
+  /// addresses of these variables might be reused by new constants. Their
+  /// rows are kept, and shared with operands of the same representation.
+  void release(ar::Function* fun);
+
   /// \brief Return a textual representation of a llvm::Type
   static std::string repr(llvm::Type* type);
 
@@ -43,13 +43,17 @@
 
 #pragma once
 
+#include <memory>
+
 #include <llvm/ADT/DenseMap.h>
 
+#include <ikos/ar/semantic/code.hpp>
 #include <ikos/ar/semantic/statement.hpp>
 
 #include <ikos/analyzer/database/table.hpp>
 #include <ikos/analyzer/database/table/files.hpp>
 #include <ikos/analyzer/database/table/functions.hpp>
+#include <ikos/analyzer/util/source_location.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -72,6 +76,13 @@ private:
   /// \brief Last inserted id
   sqlite::DbInt64 _last_insert_id = 0;
 
+  /// \brief Source locations of the statements of a function body
+  using LocationIndex = llvm::DenseMap< ar::Statement*, SourceLocation >;
+
+  /// \brief Map from function bodies to the source locations of their
+  /// statements
+  llvm::DenseMap< ar::Code*, std::unique_ptr< LocationIndex > > _locations;
+
 public:
   /// \brief Constructor
   StatementsTable(sqlite::DbConnection& db,
@@ -81,6 +92,20 @@ public:
   /// \brief Insert the given statement in the database and return the id
   sqlite::DbInt64 insert(ar::Statement* stmt);
 
+  /// \brief Return the source location of the given statement
+  ///
+  /// The source locations of all the statements of a function body are
+  /// computed on the first call for one of them, then shared by all calling
+  /// contexts.
+  SourceLocation location(ar::Statement* stmt);
+
+  /// \brief Remove the ids and source locations of the statements of the
+  /// given code
+  ///
+  /// This must be called before the code is destroyed, and the statements
+  /// must not be inserted again.
+  void release(ar::Code* code);
+
 }; // end class StatementsTable
 
 } // end namespace analyzer
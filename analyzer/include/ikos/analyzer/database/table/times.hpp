@@ -43,7 +43,11 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include <ikos/analyzer/database/table.hpp>
+#include <ikos/analyzer/util/allocation_stats.hpp>
+#include <ikos/analyzer/util/perf_counters.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -58,7 +62,19 @@ public:
   explicit TimesTable(sqlite::DbConnection& db);
 
   /// \brief Insert a row
-  void insert(StringRef name, sqlite::DbDouble time);
+  ///
+  /// \param name Pass name
+  /// \param time Elapsed time, in seconds
+  /// \param peak_rss Peak resident set size at the end of the pass, in bytes
+  /// \param counters Hardware performance counters of the pass
+  /// \param allocations Allocations of the pass, and live bytes at the end
+  void insert(StringRef name,
+              sqlite::DbDouble time,
+              boost::optional< sqlite::DbInt64 > peak_rss = boost::none,
+              const boost::optional< PerfCounterValues >& counters =
+                  boost::none,
+              const boost::optional< AllocationValues >& allocations =
+                  boost::none);
 
 }; // end class TimesTable
 
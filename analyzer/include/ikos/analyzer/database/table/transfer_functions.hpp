@@ -0,0 +1,91 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Transfer functions database table
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <ikos/analyzer/analysis/call_context.hpp>
+#include <ikos/analyzer/database/table.hpp>
+#include <ikos/analyzer/database/table/call_contexts.hpp>
+#include <ikos/analyzer/database/table/functions.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Transfer functions table
+///
+/// Records the number of transfer functions executed and the time spent in
+/// them, per statement kind, for each analyzed function.
+class TransferFunctionsTable : public DatabaseTable {
+private:
+  /// \brief Functions table
+  FunctionsTable& _functions;
+
+  /// \brief Call contexts table
+  CallContextsTable& _call_contexts;
+
+  /// \brief Database output stream
+  sqlite::DbOstream _row;
+
+public:
+  /// \brief Constructor
+  TransferFunctionsTable(sqlite::DbConnection& db,
+                         FunctionsTable& functions,
+                         CallContextsTable& call_contexts);
+
+  /// \brief Insert a row for the transfer functions of a statement kind
+  ///
+  /// \param fun Analyzed function
+  /// \param call_context Call context of the analysis
+  /// \param kind Kind of statement
+  /// \param count Number of executed transfer functions
+  /// \param time Wall time, in seconds
+  void insert(ar::Function* fun,
+              CallContext* call_context,
+              StringRef kind,
+              sqlite::DbInt64 count,
+              sqlite::DbDouble time);
+
+}; // end class TransferFunctionsTable
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,135 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Statistics on the memory allocations
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2011-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <boost/optional.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Values of the allocation counters
+struct AllocationValues {
+  /// \brief Allocated bytes
+  std::uint64_t allocated_bytes = 0;
+
+  /// \brief Number of allocations
+  std::uint64_t allocations = 0;
+
+  /// \brief Allocated bytes that are not freed yet
+  ///
+  /// This is negative if more memory allocated before AllocationStats::enable()
+  /// is freed than memory is allocated after it.
+  std::int64_t live_bytes = 0;
+
+  /// \brief Return the difference with earlier values
+  ///
+  /// The live bytes are kept, since they are a level rather than a count.
+  AllocationValues operator-(const AllocationValues& other) const {
+    AllocationValues r;
+    r.allocated_bytes = this->allocated_bytes - other.allocated_bytes;
+    r.allocations = this->allocations - other.allocations;
+    r.live_bytes = this->live_bytes;
+    return r;
+  }
+};
+
+/// \brief Counters of the memory allocations of the process
+///
+/// The counters cover operator new and operator delete, which are replaced to
+/// record their calls, and the GMP memory functions, see gmp_allocator. The
+/// size of a block is its usable size, as returned by malloc_usable_size(3),
+/// or the size requested by GMP. Allocations with malloc, such as the ones of
+/// SQLite, are not counted. They are only supported on Linux.
+///
+/// Each thread updates its own counters, so recording an allocation needs no
+/// synchronization. When the counters are disabled, it costs a single test.
+class AllocationStats {
+private:
+  /// \brief True if the counters are enabled
+  static bool Enabled;
+
+public:
+  /// \brief Enable the counters
+  ///
+  /// This should be called before any thread is started. Return false, with
+  /// the reason in `error`, if the counters are not available.
+  static bool enable(std::string& error);
+
+  /// \brief Return true if the counters are enabled
+  static bool enabled() { return Enabled; }
+
+  /// \brief Return the counters of the process, or boost::none if they are
+  /// disabled
+  static boost::optional< AllocationValues > read();
+
+  /// \brief Record the allocation of a block of the given size
+  static void record_allocation(std::size_t size) {
+    if (Enabled) {
+      record_allocation_slow(size);
+    }
+  }
+
+  /// \brief Record the deallocation of a block of the given size
+  static void record_deallocation(std::size_t size) {
+    if (Enabled) {
+      record_deallocation_slow(size);
+    }
+  }
+
+private:
+  /// \brief Update the counters of the current thread on an allocation
+  static void record_allocation_slow(std::size_t size);
+
+  /// \brief Update the counters of the current thread on a deallocation
+  static void record_deallocation_slow(std::size_t size);
+
+}; // end class AllocationStats
+
+} // end namespace analyzer
+} // end namespace ikos
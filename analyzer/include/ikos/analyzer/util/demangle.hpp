@@ -56,6 +56,13 @@
 #include <ikos/analyzer/support/string_ref.hpp>
 
 namespace ikos {
+namespace ar {
+
+// forward declaration
+class Function;
+
+} // end namespace ar
+
 namespace analyzer {
 
 /// \brief Return true if the given symbol name is mangled
@@ -94,5 +101,10 @@ inline std::string demangle(StringRef name) {
   return demangle(name.to_string());
 }
 
+/// \brief Return the demangled name of the given function
+///
+/// Results are cached, this is thread-safe.
+const std::string& demangle(ar::Function* fun);
+
 } // end namespace analyzer
 } // end namespace ikos
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Local socket used by the analysis server
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <string>
+
+#include <ikos/analyzer/support/string_ref.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Connection of a client on a local socket
+///
+/// The protocol is line based. The connection is closed on destruction.
+class LocalSocketConnection {
+private:
+  /// \brief File descriptor, or -1
+  int _fd;
+
+  /// \brief Received bytes that are not consumed yet
+  std::string _buffer;
+
+public:
+  /// \brief Create a connection from an accepted file descriptor
+  explicit LocalSocketConnection(int fd);
+
+  /// \brief Deleted copy constructor
+  LocalSocketConnection(const LocalSocketConnection&) = delete;
+
+  /// \brief Move constructor
+  LocalSocketConnection(LocalSocketConnection&& other) noexcept;
+
+  /// \brief Deleted copy assignment operator
+  LocalSocketConnection& operator=(const LocalSocketConnection&) = delete;
+
+  /// \brief Deleted move assignment operator
+  LocalSocketConnection& operator=(LocalSocketConnection&&) = delete;
+
+  /// \brief Close the connection
+  ~LocalSocketConnection();
+
+  /// \brief Read a line, without the trailing newline
+  ///
+  /// Returns false if the client closed the connection.
+  bool read_line(std::string& line);
+
+  /// \brief Write a line, adding a trailing newline
+  ///
+  /// Errors are ignored, the client might have closed the connection.
+  void write_line(StringRef line);
+
+}; // end class LocalSocketConnection
+
+/// \brief Server listening on a local (unix domain) socket
+///
+/// The socket file is removed on destruction.
+class LocalSocketServer {
+private:
+  /// \brief Path of the socket file
+  std::string _path;
+
+  /// \brief File descriptor of the listening socket
+  int _fd;
+
+public:
+  /// \brief Listen on the given socket path
+  ///
+  /// \throws std::system_error If the socket cannot be created
+  explicit LocalSocketServer(std::string path);
+
+  /// \brief Deleted copy constructor
+  LocalSocketServer(const LocalSocketServer&) = delete;
+
+  /// \brief Deleted move constructor
+  LocalSocketServer(LocalSocketServer&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  LocalSocketServer& operator=(const LocalSocketServer&) = delete;
+
+  /// \brief Deleted move assignment operator
+  LocalSocketServer& operator=(LocalSocketServer&&) = delete;
+
+  /// \brief Stop listening and remove the socket file
+  ~LocalSocketServer();
+
+  /// \brief Return the path of the socket file
+  const std::string& path() const { return this->_path; }
+
+  /// \brief Wait for the next client
+  ///
+  /// \throws std::system_error If accept() fails
+  LocalSocketConnection accept();
+
+}; // end class LocalSocketServer
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -44,6 +44,7 @@
 #pragma once
 
 #include <iostream>
+#include <string>
 
 #include <ikos/core/support/compiler.hpp>
 
@@ -69,8 +70,34 @@ namespace log {
 /// \brief Global logging level
 extern LogLevel Level;
 
+/// \brief Start writing log messages from a dedicated thread
+///
+/// Messages are formatted by the calling thread, pushed in a lock-free ring
+/// buffer and written by a background thread. Messages are written
+/// synchronously until this is called.
+void start_async();
+
+/// \brief Write the pending log messages and stop the background thread
+void stop_async();
+
+/// \brief Wait until the pending log messages are written
+///
+/// This is a no-op if messages are written synchronously.
+void flush();
+
+/// \brief Set the prefix of the log messages of the current thread
+void set_thread_prefix(std::string prefix);
+
+/// \brief Write a log message of the given severity
+///
+/// This is thread-safe.
+void write(LogLevel level, StringRef message);
+
 /// \brief Logging output stream
+///
+/// The pending log messages are written first, to preserve the order.
 inline std::ostream& out() {
+  flush();
   return std::cout;
 }
 
@@ -87,7 +114,7 @@ inline std::ostream& critical_out() {
 /// \brief Log a critical message
 inline void critical(StringRef message) {
   if (is_enabled_for(LogLevel::Critical)) {
-    critical_out() << message << std::endl;
+    write(LogLevel::Critical, message);
   }
 }
 
@@ -99,7 +126,7 @@ inline std::ostream& error_out() {
 /// \brief Log an error message
 inline void error(StringRef message) {
   if (is_enabled_for(LogLevel::Error)) {
-    error_out() << message << std::endl;
+    write(LogLevel::Error, message);
   }
 }
 
@@ -111,7 +138,7 @@ inline std::ostream& warning_out() {
 /// \brief Log a warning message
 inline void warning(StringRef message) {
   if (is_enabled_for(LogLevel::Warning)) {
-    warning_out() << message << std::endl;
+    write(LogLevel::Warning, message);
   }
 }
 
@@ -123,7 +150,7 @@ inline std::ostream& info_out() {
 /// \brief Log an informative message
 inline void info(StringRef message) {
   if (ikos_unlikely(is_enabled_for(LogLevel::Info))) {
-    info_out() << message << std::endl;
+    write(LogLevel::Info, message);
   }
 }
 
@@ -135,7 +162,7 @@ inline std::ostream& debug_out() {
 /// \brief Log a debug message
 inline void debug(StringRef message) {
   if (ikos_unlikely(is_enabled_for(LogLevel::Debug))) {
-    debug_out() << message << std::endl;
+    write(LogLevel::Debug, message);
   }
 }
 
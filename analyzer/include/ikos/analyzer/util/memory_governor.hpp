@@ -0,0 +1,166 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Memory governor, degrading the analysis near the memory limit
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include <boost/optional.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Monitor the memory usage of the analyzer
+///
+/// A background thread periodically samples the memory usage of the process.
+/// Once it exceeds the soft limit, the value analyses degrade the precision of
+/// the functions that remain to be analyzed, producing partial results instead
+/// of being killed when reaching the hard memory limit (see `ikos --mem`).
+///
+/// Before that, once it exceeds the spill limit, cold data structures are
+/// spilled to disk, slowing down the analysis. Owners of these structures poll
+/// spill_generation() at points where they can safely release them, see
+/// ChecksTable.
+class MemoryGovernor {
+private:
+  /// \brief Soft limit, in bytes
+  std::uint64_t _soft_limit;
+
+  /// \brief Spill limit, in bytes
+  std::uint64_t _spill_limit;
+
+  /// \brief True if the memory usage exceeded the soft limit
+  std::atomic< bool > _exceeded;
+
+  /// \brief True if the memory usage is above the spill limit
+  std::atomic< bool > _spilling;
+
+  /// \brief Number of times the memory usage crossed the spill limit
+  std::atomic< unsigned > _spill_generation;
+
+  /// \brief Peak memory usage, in bytes
+  std::atomic< std::uint64_t > _peak;
+
+  /// \brief Mutex protecting _stop
+  std::mutex _mutex;
+
+  /// \brief Used to wake up the monitor thread
+  std::condition_variable _cv;
+
+  /// \brief True if the monitor thread should stop
+  bool _stop;
+
+  /// \brief Monitor thread
+  std::thread _thread;
+
+public:
+  /// \brief Start monitoring the memory usage
+  ///
+  /// \param soft_limit Soft limit, in megabytes, or 0 for no limit
+  /// \param spill_limit Spill limit, in megabytes, or 0 for no limit
+  explicit MemoryGovernor(std::uint64_t soft_limit,
+                          std::uint64_t spill_limit = 0);
+
+  /// \brief Deleted copy constructor
+  MemoryGovernor(const MemoryGovernor&) = delete;
+
+  /// \brief Deleted move constructor
+  MemoryGovernor(MemoryGovernor&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  MemoryGovernor& operator=(const MemoryGovernor&) = delete;
+
+  /// \brief Deleted move assignment operator
+  MemoryGovernor& operator=(MemoryGovernor&&) = delete;
+
+  /// \brief Stop monitoring the memory usage
+  ~MemoryGovernor();
+
+  /// \brief Return true if the memory usage exceeded the soft limit
+  ///
+  /// Once exceeded, it stays exceeded: memory is rarely given back to the
+  /// system, and the precision should not oscillate.
+  bool exceeded() const { return this->_exceeded.load(); }
+
+  /// \brief Return true if the memory usage is above the spill limit
+  ///
+  /// This is reset once the memory usage gets back below 90% of the limit.
+  bool spilling() const { return this->_spilling.load(); }
+
+  /// \brief Return the number of times the memory usage crossed the spill
+  /// limit
+  ///
+  /// Owners of cold data structures spill them when this changes.
+  unsigned spill_generation() const { return this->_spill_generation.load(); }
+
+  /// \brief Return the peak memory usage observed, in bytes
+  std::uint64_t peak_usage() const { return this->_peak.load(); }
+
+  /// \brief Return the current memory usage of the process, in bytes
+  ///
+  /// This is the size of the address space on Linux, since `ikos --mem` limits
+  /// it with RLIMIT_AS, or the resident set size otherwise.
+  static boost::optional< std::uint64_t > memory_usage();
+
+  /// \brief Return the peak resident set size of the process, in bytes
+  static boost::optional< std::uint64_t > peak_resident_size();
+
+  /// \brief Give the free memory of the heap back to the system, if possible
+  static void release_free_memory();
+
+private:
+  /// \brief Sample the memory usage until the governor is destroyed
+  void monitor();
+
+  /// \brief Sample the memory usage once, and return it
+  boost::optional< std::uint64_t > sample();
+
+}; // end class MemoryGovernor
+
+} // end namespace analyzer
+} // end namespace ikos
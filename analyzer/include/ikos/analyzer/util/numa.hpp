@@ -0,0 +1,128 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief NUMA topology of the machine
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief NUMA topology of the machine
+///
+/// The topology is read from /sys/devices/system/node on Linux. On other
+/// systems, or if it cannot be read, the machine has a single node.
+class NumaTopology {
+private:
+  /// \brief CPUs of each node
+  std::vector< std::vector< int > > _nodes;
+
+private:
+  /// \brief Detect the topology
+  NumaTopology();
+
+public:
+  /// \brief Deleted copy constructor
+  NumaTopology(const NumaTopology&) = delete;
+
+  /// \brief Deleted move constructor
+  NumaTopology(NumaTopology&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  NumaTopology& operator=(const NumaTopology&) = delete;
+
+  /// \brief Deleted move assignment operator
+  NumaTopology& operator=(NumaTopology&&) = delete;
+
+  /// \brief Destructor
+  ~NumaTopology() = default;
+
+  /// \brief Return the topology of the machine, detected on the first call
+  static const NumaTopology& get();
+
+  /// \brief Return the number of nodes with CPUs
+  std::size_t num_nodes() const { return this->_nodes.size(); }
+
+  /// \brief Restrict the calling thread to the CPUs of the given node
+  ///
+  /// Memory is allocated on the node of the thread that first touches it, so
+  /// the allocations of the thread (including its malloc arena and its GMP
+  /// free lists) become local to the node.
+  ///
+  /// Return false if the affinity cannot be set.
+  bool bind_current_thread(std::size_t node) const;
+
+}; // end class NumaTopology
+
+/// \brief Binding of the calling thread to a NUMA node on a scope
+///
+/// The previous affinity of the thread is restored at the end of the scope.
+class ScopeNumaBinding {
+private:
+  /// \brief Opaque saved affinity, empty if the thread was not bound
+  std::vector< unsigned char > _saved;
+
+public:
+  /// \brief Bind the calling thread to the given node
+  ScopeNumaBinding(const NumaTopology& topology, std::size_t node);
+
+  /// \brief Deleted copy constructor
+  ScopeNumaBinding(const ScopeNumaBinding&) = delete;
+
+  /// \brief Deleted move constructor
+  ScopeNumaBinding(ScopeNumaBinding&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  ScopeNumaBinding& operator=(const ScopeNumaBinding&) = delete;
+
+  /// \brief Deleted move assignment operator
+  ScopeNumaBinding& operator=(ScopeNumaBinding&&) = delete;
+
+  /// \brief Restore the previous affinity
+  ~ScopeNumaBinding();
+
+}; // end class ScopeNumaBinding
+
+} // end namespace analyzer
+} // end namespace ikos
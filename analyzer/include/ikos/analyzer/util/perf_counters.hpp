@@ -0,0 +1,117 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Hardware performance counters
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2011-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <boost/optional.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Values of the hardware performance counters
+struct PerfCounterValues {
+  /// \brief Retired instructions
+  std::uint64_t instructions = 0;
+
+  /// \brief CPU cycles
+  std::uint64_t cycles = 0;
+
+  /// \brief Last level cache misses
+  std::uint64_t llc_misses = 0;
+
+  /// \brief Mispredicted branches
+  std::uint64_t branch_misses = 0;
+
+  /// \brief Return the difference with earlier values
+  PerfCounterValues operator-(const PerfCounterValues& other) const {
+    PerfCounterValues r;
+    r.instructions = this->instructions - other.instructions;
+    r.cycles = this->cycles - other.cycles;
+    r.llc_misses = this->llc_misses - other.llc_misses;
+    r.branch_misses = this->branch_misses - other.branch_misses;
+    return r;
+  }
+};
+
+/// \brief Hardware performance counters, using perf_event_open(2)
+///
+/// Counters only measure user space, so that they are available with the
+/// default `perf_event_paranoid` setting. They are only supported on Linux.
+///
+/// The process counters are inherited by the threads created after enable(),
+/// but the counts of a thread are only added once it exits. They are used by
+/// ScopeTimerDatabase, whose phases join their threads. The thread counters
+/// are opened lazily by each thread, and used by TraceSpan.
+///
+/// When the counters are disabled, a read costs a single test.
+class PerfCounters {
+private:
+  /// \brief True if the counters are enabled
+  static bool Enabled;
+
+public:
+  /// \brief Enable the counters
+  ///
+  /// This should be called before any thread is started. Return false, with
+  /// the reason in `error`, if the counters are not available.
+  static bool enable(std::string& error);
+
+  /// \brief Return true if the counters are enabled
+  static bool enabled() { return Enabled; }
+
+  /// \brief Return the counters of the process, or boost::none if they are
+  /// disabled
+  static boost::optional< PerfCounterValues > read_process();
+
+  /// \brief Return the counters of the current thread, or boost::none if they
+  /// are disabled or not available
+  static boost::optional< PerfCounterValues > read_thread();
+
+}; // end class PerfCounters
+
+} // end namespace analyzer
+} // end namespace ikos
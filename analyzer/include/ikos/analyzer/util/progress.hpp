@@ -0,0 +1,167 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Progress of the analysis, reported as JSON events
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <ikos/analyzer/support/string_ref.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Report the progress of the analysis
+///
+/// When enabled, a background thread periodically writes the progress of the
+/// analysis as JSON lines in a file (or a named pipe). Each event holds the
+/// number of functions (or entry points) completed out of the total, the
+/// number of analyzed call contexts, the number of fixpoint iterations, the
+/// function currently analyzed and an estimate of the remaining time.
+///
+/// The remaining time is estimated from the cost of the completed functions,
+/// see FixpointProfileAnalysis::cost().
+///
+/// When progress reporting is disabled, each update costs a single test.
+class Progress {
+private:
+  /// \brief True if progress reporting is enabled
+  static bool Enabled;
+
+public:
+  /// \brief Enable progress reporting
+  ///
+  /// This should be called before any thread is started.
+  ///
+  /// \param path Path of the output file
+  /// \param interval Interval between two events
+  ///
+  /// \returns false if the file could not be opened
+  static bool enable(const std::string& path,
+                     std::chrono::milliseconds interval);
+
+  /// \brief Write the last event and stop the background thread
+  static void disable();
+
+  /// \brief Return true if progress reporting is enabled
+  static bool enabled() { return Enabled; }
+
+  /// \brief Set the number of functions to analyze and their total cost
+  static void set_total(std::size_t functions, std::uint64_t cost) {
+    if (Enabled) {
+      record_total(functions, cost);
+    }
+  }
+
+  /// \brief Start the analysis of the given function
+  static void start_function(StringRef name) {
+    if (Enabled) {
+      record_start(name);
+    }
+  }
+
+  /// \brief Finish the analysis of a function with the given cost
+  static void finish_function(std::uint64_t cost) {
+    if (Enabled) {
+      record_finish(cost);
+    }
+  }
+
+  /// \brief Count an analyzed call context
+  static void add_context() {
+    if (Enabled) {
+      record_context();
+    }
+  }
+
+  /// \brief Count a fixpoint iteration on a cycle
+  static void add_iteration() {
+    if (Enabled) {
+      record_iteration();
+    }
+  }
+
+private:
+  static void record_total(std::size_t functions, std::uint64_t cost);
+  static void record_start(StringRef name);
+  static void record_finish(std::uint64_t cost);
+  static void record_context();
+  static void record_iteration();
+
+}; // end class Progress
+
+/// \brief Report the analysis of a function on a scope
+class ProgressScope {
+private:
+  /// \brief Cost of the function
+  std::uint64_t _cost;
+
+public:
+  /// \brief Constructor
+  ///
+  /// \param name Name of the function
+  /// \param cost Cost of the function, see FixpointProfileAnalysis::cost()
+  ProgressScope(StringRef name, std::uint64_t cost) : _cost(cost) {
+    Progress::start_function(name);
+  }
+
+  /// \brief Deleted copy constructor
+  ProgressScope(const ProgressScope&) = delete;
+
+  /// \brief Deleted move constructor
+  ProgressScope(ProgressScope&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  ProgressScope& operator=(const ProgressScope&) = delete;
+
+  /// \brief Deleted move assignment operator
+  ProgressScope& operator=(ProgressScope&&) = delete;
+
+  /// \brief Destructor
+  ~ProgressScope() { Progress::finish_function(this->_cost); }
+
+}; // end class ProgressScope
+
+} // end namespace analyzer
+} // end namespace ikos
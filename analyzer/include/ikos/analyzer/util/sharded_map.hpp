@@ -0,0 +1,163 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Thread-safe sharded map
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <llvm/ADT/DenseMapInfo.h>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Hash function using llvm::DenseMapInfo
+template < typename Key >
+struct DenseMapInfoHash {
+  std::size_t operator()(const Key& key) const {
+    return llvm::DenseMapInfo< Key >::getHashValue(key);
+  }
+};
+
+/// \brief Thread-safe map, split in several shards
+///
+/// Each shard is a `Map` protected by its own mutex, so that threads looking
+/// up different keys rarely contend on the same lock.
+///
+/// Values are expected to be stable in memory (i.e, `std::unique_ptr< T >` or
+/// node-based maps), so that returned pointers stay valid after the lock is
+/// released.
+template < typename Map,
+           typename Hash,
+           std::size_t NumShards = 16 >
+class ShardedMap {
+private:
+  static_assert(NumShards > 0, "invalid number of shards");
+
+  /// \brief A shard
+  struct Shard {
+    std::mutex mutex;
+    Map map;
+  };
+
+private:
+  /// \brief Shards
+  std::array< Shard, NumShards > _shards;
+
+  /// \brief Hash function
+  Hash _hash;
+
+public:
+  /// \brief Constructor
+  ShardedMap() = default;
+
+  /// \brief Deleted copy constructor
+  ShardedMap(const ShardedMap&) = delete;
+
+  /// \brief Deleted move constructor
+  ShardedMap(ShardedMap&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  ShardedMap& operator=(const ShardedMap&) = delete;
+
+  /// \brief Deleted move assignment operator
+  ShardedMap& operator=(ShardedMap&&) = delete;
+
+  /// \brief Destructor
+  ~ShardedMap() = default;
+
+  /// \brief Return a pointer on the value associated with the given key
+  ///
+  /// If the key is not in the map, the value is created by calling `create()`.
+  /// Note that `create()` is called while holding the lock of the shard.
+  template < typename Key, typename Create >
+  auto get_or_create(const Key& key, Create create) {
+    Shard& shard = this->shard(key);
+    std::lock_guard< std::mutex > lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+      it = shard.map.insert(std::make_pair(key, create())).first;
+    }
+    return pointer(it->second);
+  }
+
+  /// \brief Remove the value associated with the given key, if any
+  ///
+  /// Pointers on the removed value are invalidated.
+  template < typename Key >
+  void erase(const Key& key) {
+    Shard& shard = this->shard(key);
+    std::lock_guard< std::mutex > lock(shard.mutex);
+    shard.map.erase(key);
+  }
+
+private:
+  /// \brief Return the shard for the given key
+  template < typename Key >
+  Shard& shard(const Key& key) {
+    // Use the high bits of a multiplicative hash, so that the shard index is
+    // independent of the bucket index within the shard
+    auto hash = static_cast< std::uint64_t >(this->_hash(key));
+    hash = (hash * 0x9E3779B97F4A7C15ULL) >> 32;
+    return this->_shards[hash % NumShards];
+  }
+
+  /// \brief Return the raw pointer of a std::unique_ptr
+  template < typename T >
+  static T* pointer(std::unique_ptr< T >& p) {
+    return p.get();
+  }
+
+  /// \brief Return a pointer on a value stored in a node-based map
+  template < typename T >
+  static T* pointer(T& v) {
+    return &v;
+  }
+
+}; // end class ShardedMap
+
+} // end namespace analyzer
+} // end namespace ikos
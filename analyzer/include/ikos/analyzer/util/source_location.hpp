@@ -59,7 +59,9 @@ using frontend::import::SourceLocation;
 using frontend::import::source_path;
 
 /// \brief Return the source location of the given statement
-using frontend::import::source_location;
+///
+/// Results are cached, this is thread-safe.
+SourceLocation source_location(ar::Statement* stmt);
 
 /// \brief Return the source location of the given statement as a string
 ///
@@ -0,0 +1,165 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief On-disk store for data spilled under memory pressure
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <ikos/analyzer/support/string_ref.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Append-only store of data spilled to disk
+///
+/// Data is written in an unlinked temporary file, removed by the system when
+/// the store is destroyed. Reads go through pread() rather than a memory
+/// mapping, since `ikos --mem` limits the address space (RLIMIT_AS), mappings
+/// included.
+///
+/// This is thread-safe.
+class SpillStore {
+public:
+  /// \brief Position of spilled data in the store
+  struct Ref {
+    std::uint64_t offset;
+    std::uint64_t size;
+  };
+
+private:
+  /// \brief File descriptor of the temporary file
+  int _fd;
+
+  /// \brief Size of the file, in bytes
+  std::uint64_t _size;
+
+  /// \brief Mutex protecting _size
+  std::mutex _mutex;
+
+public:
+  /// \brief Create a temporary file in $TMPDIR, or /tmp
+  ///
+  /// \throws std::runtime_error if the file cannot be created
+  SpillStore();
+
+  /// \brief Deleted copy constructor
+  SpillStore(const SpillStore&) = delete;
+
+  /// \brief Deleted move constructor
+  SpillStore(SpillStore&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  SpillStore& operator=(const SpillStore&) = delete;
+
+  /// \brief Deleted move assignment operator
+  SpillStore& operator=(SpillStore&&) = delete;
+
+  /// \brief Close and remove the temporary file
+  ~SpillStore();
+
+  /// \brief Write the given data at the end of the store
+  Ref write(StringRef data);
+
+  /// \brief Read previously written data
+  std::string read(Ref ref) const;
+
+  /// \brief Return the size of the store, in bytes
+  std::uint64_t size();
+
+}; // end class SpillStore
+
+/// \brief String that can be moved into a SpillStore
+class SpillableString {
+private:
+  /// \brief String, if not spilled
+  std::string _str;
+
+  /// \brief Store holding the string, or null
+  const SpillStore* _store = nullptr;
+
+  /// \brief Position of the string in _store
+  SpillStore::Ref _ref = {0, 0};
+
+public:
+  /// \brief Create an empty string
+  SpillableString() = default;
+
+  /// \brief Create a string in memory
+  SpillableString(std::string str) : _str(std::move(str)) {}
+
+  /// \brief Return true if the string is empty
+  bool empty() const {
+    return this->_store != nullptr ? this->_ref.size == 0 : this->_str.empty();
+  }
+
+  /// \brief Return true if the string was moved into a store
+  bool spilled() const { return this->_store != nullptr; }
+
+  /// \brief Return the string, read from the store if it was spilled
+  std::string str() const {
+    return this->_store != nullptr ? this->_store->read(this->_ref)
+                                   : this->_str;
+  }
+
+  /// \brief Move the string into the given store
+  ///
+  /// \returns The number of bytes released from memory
+  std::size_t spill(SpillStore& store) {
+    if (this->_store != nullptr || this->_str.empty()) {
+      return 0;
+    }
+    std::size_t released = this->_str.capacity();
+    this->_ref = store.write(this->_str);
+    this->_store = &store;
+    std::string().swap(this->_str);
+    return released;
+  }
+
+}; // end class SpillableString
+
+} // end namespace analyzer
+} // end namespace ikos
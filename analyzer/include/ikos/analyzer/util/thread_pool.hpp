@@ -0,0 +1,166 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Thread pool for parallel analyses
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Pool of worker threads executing independent tasks
+///
+/// Each worker owns a queue of tasks. Tasks are distributed in a round-robin
+/// fashion over the queues. A worker pops tasks from the back of its own queue
+/// and steals tasks from the front of the other queues when it runs out of
+/// work.
+///
+/// Tasks can be pushed before calling run(), or by a running task.
+///
+/// With the NUMA placement, see enable_numa_placement(), workers are spread
+/// over the NUMA nodes and bound to the CPUs of their node, so that the
+/// abstract states they allocate are local to their node. A worker steals
+/// from the workers of its own node first.
+class ThreadPool {
+public:
+  /// \brief Task
+  ///
+  /// The parameter is the index of the worker executing the task, in
+  /// [0, num_workers()).
+  using Task = std::function< void(std::size_t) >;
+
+private:
+  /// \brief Queue of tasks owned by a worker
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque< Task > tasks;
+  };
+
+private:
+  /// \brief True if workers are placed on the NUMA nodes
+  static bool NumaPlacement;
+
+private:
+  /// \brief Work queues, one per worker
+  std::vector< std::unique_ptr< WorkQueue > > _queues;
+
+  /// \brief NUMA node of each worker, empty without NUMA placement
+  std::vector< std::size_t > _nodes;
+
+  /// \brief Order in which each worker steals from the other workers
+  std::vector< std::vector< std::size_t > > _victims;
+
+  /// \brief Index of the queue receiving the next pushed task
+  std::atomic< std::size_t > _next_queue;
+
+  /// \brief Number of tasks pushed but not finished
+  std::atomic< std::size_t > _pending;
+
+  /// \brief True if a task threw an exception
+  std::atomic< bool > _failed;
+
+  /// \brief First exception thrown by a task
+  std::exception_ptr _exception;
+
+  /// \brief Mutex protecting _exception
+  std::mutex _exception_mutex;
+
+public:
+  /// \brief Create a thread pool with the given number of workers
+  explicit ThreadPool(std::size_t num_workers);
+
+  /// \brief Deleted copy constructor
+  ThreadPool(const ThreadPool&) = delete;
+
+  /// \brief Deleted move constructor
+  ThreadPool(ThreadPool&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// \brief Deleted move assignment operator
+  ThreadPool& operator=(ThreadPool&&) = delete;
+
+  /// \brief Destructor
+  ~ThreadPool();
+
+  /// \brief Place the workers of the thread pools created afterwards on the
+  /// NUMA nodes of the machine
+  ///
+  /// This has no effect on machines with a single node.
+  static void enable_numa_placement() { NumaPlacement = true; }
+
+  /// \brief Return the number of workers
+  std::size_t num_workers() const { return this->_queues.size(); }
+
+  /// \brief Add a task
+  void push(Task task);
+
+  /// \brief Execute all the tasks and wait for their completion
+  ///
+  /// The calling thread is used as the worker 0.
+  ///
+  /// If a task throws an exception, the remaining tasks are discarded and the
+  /// first exception is rethrown.
+  void run();
+
+private:
+  /// \brief Main loop of a worker
+  void work(std::size_t worker);
+
+  /// \brief Pop a task from the given worker's queue, or steal one
+  ///
+  /// Return false if no task was found.
+  bool pop(std::size_t worker, Task& task);
+
+}; // end class ThreadPool
+
+} // end namespace analyzer
+} // end namespace ikos
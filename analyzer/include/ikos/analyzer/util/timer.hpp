@@ -47,6 +47,11 @@
 #include <functional>
 #include <string>
 
+#include <boost/optional.hpp>
+
+#include <ikos/analyzer/util/allocation_stats.hpp>
+#include <ikos/analyzer/util/perf_counters.hpp>
+
 namespace ikos {
 namespace analyzer {
 
@@ -86,6 +91,12 @@ public:
   /// \brief Stop the timer
   void stop() { this->_end = Clock::now(); }
 
+  /// \brief Return the time point when the timer was started
+  TimePoint start_time() const { return this->_start; }
+
+  /// \brief Return the time point when the timer was stopped
+  TimePoint end_time() const { return this->_end; }
+
   /// \brief Return the elapsed time
   Duration elapsed() const {
     return std::chrono::duration_cast< Duration >(this->_end - this->_start);
@@ -136,11 +147,23 @@ class TimesTable;
 
 /// \brief Timer that saves the elapsed time at the end of the scope in a
 /// database
+///
+/// The peak resident set size of the process at the end of the scope is saved
+/// along with the elapsed time, the hardware performance counters of the scope
+/// if they are enabled, see PerfCounters, and its allocations if they are
+/// recorded, see AllocationStats. It is also recorded as a span if tracing is
+/// enabled, see Tracer.
 class ScopeTimerDatabase {
 private:
   /// \brief Actual timer
   Timer _timer;
 
+  /// \brief Performance counters at the beginning of the scope
+  boost::optional< PerfCounterValues > _counters;
+
+  /// \brief Allocation counters at the beginning of the scope
+  boost::optional< AllocationValues > _allocations;
+
   /// \brief Times table
   TimesTable& _table;
 
@@ -0,0 +1,164 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Nested time spans, exported in the Chrome trace event format
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2011-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <string>
+
+#include <boost/optional.hpp>
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <ikos/analyzer/support/string_ref.hpp>
+#include <ikos/analyzer/util/perf_counters.hpp>
+#include <ikos/analyzer/util/timer.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Collect nested time spans
+///
+/// Spans are recorded in a buffer per thread, without synchronization, and
+/// written at the end of the analysis in the Chrome trace event format. The
+/// file can be loaded in chrome://tracing or https://ui.perfetto.dev
+///
+/// When tracing is disabled, a span costs a single test.
+class Tracer {
+private:
+  /// \brief True if tracing is enabled
+  static bool Enabled;
+
+public:
+  /// \brief Enable tracing
+  ///
+  /// This should be called before any thread is started.
+  static void enable() { Enabled = true; }
+
+  /// \brief Return true if tracing is enabled
+  static bool enabled() { return Enabled; }
+
+  /// \brief Record a span
+  ///
+  /// \param category Category of the span, e.g, "fixpoint"
+  /// \param name Name of the span, e.g, a function name
+  /// \param start Start time
+  /// \param end End time
+  /// \param counters Hardware performance counters of the span, written as
+  /// the arguments of the event
+  static void record(
+      const char* category,
+      StringRef name,
+      Timer::TimePoint start,
+      Timer::TimePoint end,
+      const boost::optional< PerfCounterValues >& counters = boost::none);
+
+  /// \brief Write all the recorded spans on the given stream, as JSON
+  ///
+  /// This should be called once all threads are done.
+  static void write(llvm::raw_ostream& o);
+
+}; // end class Tracer
+
+/// \brief Span on a scope
+///
+/// The span records the hardware performance counters of the current thread
+/// if they are enabled, see PerfCounters.
+class TraceSpan {
+private:
+  /// \brief Category
+  const char* _category;
+
+  /// \brief Name, or empty if tracing is disabled
+  std::string _name;
+
+  /// \brief Start time
+  Timer::TimePoint _start;
+
+  /// \brief Performance counters at the start
+  boost::optional< PerfCounterValues > _counters;
+
+public:
+  /// \brief Constructor
+  ///
+  /// \param category Category of the span, e.g, "fixpoint"
+  /// \param name Name of the span, e.g, a function name
+  TraceSpan(const char* category, StringRef name) : _category(category) {
+    if (Tracer::enabled()) {
+      this->_name = name.to_string();
+      this->_counters = PerfCounters::read_thread();
+      this->_start = Timer::Clock::now();
+    }
+  }
+
+  /// \brief Deleted copy constructor
+  TraceSpan(const TraceSpan&) = delete;
+
+  /// \brief Deleted move constructor
+  TraceSpan(TraceSpan&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+  /// \brief Deleted move assignment operator
+  TraceSpan& operator=(TraceSpan&&) = delete;
+
+  /// \brief Destructor
+  ~TraceSpan() {
+    if (Tracer::enabled()) {
+      Timer::TimePoint end = Timer::Clock::now();
+      boost::optional< PerfCounterValues > counters;
+      if (this->_counters) {
+        counters = *PerfCounters::read_thread() - *this->_counters;
+      }
+      Tracer::record(this->_category,
+                     this->_name,
+                     this->_start,
+                     end,
+                     counters);
+    }
+  }
+
+}; // end class TraceSpan
+
+} // end namespace analyzer
+} // end namespace ikos
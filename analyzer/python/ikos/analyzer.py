@@ -43,6 +43,7 @@ import argparse
 import atexit
 import datetime
 import json
+import multiprocessing.pool
 import os
 import os.path
 import pipes
@@ -58,14 +59,28 @@ from ikos import args
 from ikos import colors
 from ikos import log
 from ikos import report
+from ikos import result_cache
 from ikos import settings
 from ikos import stats
+from ikos import tuning
 from ikos.log import printf
 from ikos.output_db import OutputDatabase
 
 
+def shard(value):
+    ''' Parse a shard "<i>/<n>" as a tuple (i, n) '''
+    try:
+        index, count = map(int, value.split('/'))
+    except ValueError:
+        index, count = -1, 0
+    if not 0 <= index < count:
+        raise argparse.ArgumentTypeError(
+            "invalid shard '%s', expected <i>/<n> with 0 <= i < n" % value)
+    return index, count
+
+
 def parse_arguments(argv):
-    usage = '%(prog)s [options] file[.c|.cpp|.bc|.ll]'
+    usage = '%(prog)s [options] file[.c|.cpp|.bc|.ll]...'
     description = 'ikos static analyzer'
     formatter_class = argparse.RawTextHelpFormatter
     parser = argparse.ArgumentParser(usage=usage,
@@ -73,9 +88,10 @@ def parse_arguments(argv):
                                      formatter_class=formatter_class)
 
     # Positional arguments
-    parser.add_argument('file',
+    parser.add_argument('files',
                         metavar='file[.c|.cpp|.bc|.ll]',
-                        help='File to analyze')
+                        nargs='+',
+                        help='Files to analyze, linked together')
 
     # Optional arguments
     parser.add_argument('-o', '--output-db',
@@ -83,6 +99,70 @@ def parse_arguments(argv):
                         metavar='<file>',
                         help='Output database file (default: output.db)',
                         default='output.db')
+    parser.add_argument('--db-format',
+                        dest='db_format',
+                        metavar='',
+                        help='Output format: sqlite (default) or columnar. '
+                             'With columnar, the checks, statements, operands '
+                             'and call contexts are written in <file>.col',
+                        choices=('sqlite', 'columnar'),
+                        default='sqlite')
+    parser.add_argument('--stream-checks',
+                        dest='stream_checks',
+                        metavar='<file>',
+                        help='Write each check as a JSON line in the given '
+                             'file as soon as it is found')
+    parser.add_argument('--trace',
+                        dest='trace',
+                        metavar='<file>',
+                        help='Write a trace of the analysis in the given '
+                             'file, in the Chrome trace event format')
+    parser.add_argument('--perf-counters',
+                        dest='perf_counters',
+                        help='Record the hardware performance counters of '
+                             'the analysis passes and the trace spans',
+                        action='store_true',
+                        default=False)
+    parser.add_argument('--allocation-stats',
+                        dest='allocation_stats',
+                        help='Record the allocations of the analysis passes',
+                        action='store_true',
+                        default=False)
+    parser.add_argument('--progress',
+                        dest='progress',
+                        help='Display a progress bar during the analysis',
+                        action='store_true',
+                        default=False)
+    parser.add_argument('--progress-events',
+                        dest='progress_events',
+                        metavar='<file>',
+                        help='Periodically write the progress of the analysis '
+                             'in the given file, as JSON lines')
+    parser.add_argument('--defer-db-indexes',
+                        dest='defer_db_indexes',
+                        help='Create the indexes of the output database at '
+                             'the end of the analysis',
+                        action='store_true',
+                        default=False)
+    parser.add_argument('--finalize-db',
+                        dest='finalize_db',
+                        help='Materialize the summary tables read by '
+                             'ikos-report and ikos-view, and compact the '
+                             'output database after the analysis',
+                        action='store_true',
+                        default=False)
+    parser.add_argument('--live-db',
+                        dest='live_db',
+                        help='Periodically commit the output database, so '
+                             'that ikos-view --live shows the results during '
+                             'the analysis',
+                        action='store_true',
+                        default=False)
+    parser.add_argument('--verify-cache',
+                        dest='verify_cache',
+                        metavar='<file>',
+                        help='Skip the verification of bitcode files already '
+                             'verified, as recorded in the given file')
     parser.add_argument('-v',
                         dest='verbosity',
                         help='Increase verbosity',
@@ -135,6 +215,25 @@ def parse_arguments(argv):
                           help='Do not initialize global variables for the '
                                'given entry points',
                           action='append')
+    analysis.add_argument('--function',
+                          dest='functions',
+                          metavar='<function>',
+                          help='Only check the given functions. The '
+                               'inter-procedural analysis only analyzes the '
+                               'entry points that might call them',
+                          action='append')
+    analysis.add_argument('--only-file',
+                          dest='only_files',
+                          metavar='<file>',
+                          help='Only check the functions defined in the given '
+                               'source file, see --function',
+                          action='append')
+    analysis.add_argument('--only-function',
+                          dest='only_functions',
+                          metavar='<regex>',
+                          help='Only check the functions with a name matching '
+                               'the given regular expression, see --function',
+                          action='append')
     analysis.add_argument('--no-liveness',
                           dest='no_liveness',
                           help='Disable the liveness analysis',
@@ -145,6 +244,12 @@ def parse_arguments(argv):
                           help='Disable the pointer analysis',
                           action='store_true',
                           default=False)
+    analysis.add_argument('--frame-projection',
+                          dest='frame_projection',
+                          help='Remove the variables of the caller from the '
+                               'entry state of inlined callees',
+                          action='store_true',
+                          default=False)
     analysis.add_argument('--no-fixpoint-profiles',
                           dest='no_fixpoint_profiles',
                           help='Disable the fixpoint profiles analysis',
@@ -182,6 +287,238 @@ def parse_arguments(argv):
                           metavar='',
                           help='Specify a value for argc',
                           type=int)
+    analysis.add_argument('--context-depth',
+                          dest='context_depth',
+                          metavar='',
+                          help='Maximum depth of calling contexts for the '
+                               'inter-procedural analysis, 0 for a '
+                               'context-insensitive analysis '
+                               '(default: unlimited)',
+                          type=int)
+    analysis.add_argument('--low-memory',
+                          dest='low_memory',
+                          help='Only keep the invariants at loop heads during '
+                               'the value analysis, and recompute the others '
+                               'when running checks',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--release-functions',
+                          dest='release_functions',
+                          help='Release the analysis state of each function '
+                               'once its results are written (requires '
+                               '--proc=intra)',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--release-ar',
+                          dest='release_ar',
+                          help='Also release the AR of each function that is '
+                               'not referenced by another function or global '
+                               'variable (implies --release-functions)',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--sparse',
+                          dest='sparse',
+                          help='Propagate intervals along the def-use chains '
+                               'of integer variables instead of abstract '
+                               'states along the control flow graph '
+                               '(requires --prec=reg and --proc=intra)',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--function-timeout',
+                          dest='function_timeout',
+                          metavar='',
+                          help='Time budget in seconds for the analysis of a '
+                               'function in a given calling context, after '
+                               'which loops are widened to top',
+                          type=int)
+    analysis.add_argument('--function-max-steps',
+                          dest='function_max_steps',
+                          metavar='',
+                          help='Maximum number of basic block analyses for a '
+                               'function in a given calling context, after '
+                               'which loops are widened to top',
+                          type=int)
+    analysis.add_argument('--deadline',
+                          dest='deadline',
+                          metavar='',
+                          help='Time in seconds after which the remaining '
+                               'entry points are skipped, analyzing first the '
+                               'entry points with the most checked statements '
+                               'per estimated cost',
+                          type=int)
+    analysis.add_argument('--estimate',
+                          dest='estimate',
+                          help='Print the estimated cost of the value '
+                               'analysis of each function and overall, '
+                               'without running it',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--refine-domain',
+                          dest='refine_domain',
+                          metavar='<domain>',
+                          help='Re-analyze the functions, or entry points for '
+                               'the inter-procedural analysis, with warnings '
+                               'or errors using the given, more precise, '
+                               'abstract domain, see --domain',
+                          choices=args.choices(args.domains))
+    analysis.add_argument('--function-domain',
+                          dest='function_domains',
+                          metavar='<function>:<domain>',
+                          action='append',
+                          help='Analyze the given function with the given '
+                               'abstract domain, see --domain (requires '
+                               '--proc=intra)')
+    analysis.add_argument('--kernel-domain',
+                          dest='kernel_domain',
+                          metavar='<domain>',
+                          help='Analyze the numeric kernels, i.e functions '
+                               'with nested loops or with loops indexing '
+                               'arrays with integer arithmetic, with the given '
+                               'abstract domain, see --domain (requires '
+                               '--proc=intra)',
+                          choices=args.choices(args.domains))
+    analysis.add_argument('--max-pack-size',
+                          dest='max_pack_size',
+                          metavar='<n>',
+                          help='Maximum number of variables in a pack of the '
+                               'variable packing domains (default: no limit)',
+                          type=int)
+    analysis.add_argument('--apron-max-size',
+                          dest='apron_max_size',
+                          metavar='<n>',
+                          help='Maximum size of the APRON polyhedra, in number '
+                               'of coefficients, before they are approximated '
+                               'with octagons or intervals (default: no '
+                               'limit)',
+                          type=int)
+    analysis.add_argument('--apron-timeout',
+                          dest='apron_timeout',
+                          metavar='<ms>',
+                          help='Maximum duration in milliseconds of an '
+                               'operation on APRON polyhedra, before the '
+                               'result is approximated with octagons or '
+                               'intervals (default: no limit)',
+                          type=int)
+    analysis.add_argument('--refine-timeout',
+                          dest='refine_timeout',
+                          metavar='',
+                          help='Time budget in seconds for the re-analysis of '
+                               'a function in a given calling context, see '
+                               '--refine-domain (default: same as '
+                               '--function-timeout)',
+                          type=int)
+    analysis.add_argument('--max-cells',
+                          dest='max_cells',
+                          metavar='',
+                          help='Maximum number of memory cells per memory '
+                               'location, after which the cells of the memory '
+                               'location are smashed',
+                          type=int)
+    analysis.add_argument('--aggregate-checks',
+                          dest='aggregate_checks',
+                          metavar='',
+                          help='Merge the checks of a statement across calling '
+                               'contexts, keeping the worst result and at most '
+                               'the given number of calling contexts per check',
+                          type=int)
+    analysis.add_argument('--skip-safe-contexts',
+                          dest='skip_safe_contexts',
+                          help='Skip the checks on a function in a calling '
+                               'context when its entry invariant is included '
+                               'in the one of a calling context without '
+                               'warnings and errors',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--group-contexts',
+                          dest='group_contexts',
+                          help='Analyze a callee once for all the calling '
+                               'contexts with the same entry invariant, and '
+                               'check it in each of them',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--trivial-checks',
+                          dest='trivial_checks',
+                          help='Decide the checks that are safe '
+                               'syntactically, such as divisions by non-zero '
+                               'constants, once per statement before the '
+                               'value analysis',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--tuning-profile',
+                          dest='tuning_profile',
+                          metavar='<file>',
+                          help='Tune the widening per loop and the precision '
+                               'per function from the telemetry of the '
+                               'previous runs, stored in the given file, and '
+                               'update it with the telemetry of this run')
+    analysis.add_argument('--fixpoint-stats',
+                          dest='fixpoint_stats',
+                          help='Record statistics on the fixpoint iterations '
+                               'on loops, see ikos-report --top-loops',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--transfer-stats',
+                          dest='transfer_stats',
+                          help='Record statistics on the transfer functions '
+                               'per statement kind, see ikos-report '
+                               '--top-transfer-functions',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--state-stats',
+                          dest='state_stats',
+                          help='Record the peak sizes of the abstract states '
+                               'per function, see ikos-report --format=stats',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--cache',
+                          dest='cache',
+                          help='Reuse the results of unchanged functions, or '
+                               'entry points for the inter-procedural '
+                               'analysis, from previous runs, using a cache '
+                               'file next to the output database',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--pointer-cache',
+                          dest='pointer_cache',
+                          help='Reuse the results of the pointer analyses '
+                               'from previous runs on the same program, '
+                               'using a cache file next to the output '
+                               'database',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--library-summary',
+                          dest='library_summaries',
+                          metavar='<file>',
+                          help='Use the summaries of a library, created with '
+                               '--emit-library-summary, instead of analyzing '
+                               'its functions again (can be repeated)',
+                          action='append',
+                          default=[])
+    analysis.add_argument('--emit-library-summary',
+                          dest='emit_library_summary',
+                          metavar='<file>',
+                          help='Save the summaries of the analyzed functions '
+                               'in a summary package, requires --proc=intra',
+                          default=None)
+    analysis.add_argument('--checkpoint',
+                          dest='checkpoint',
+                          help='Periodically save the analysis progress in a '
+                               'checkpoint file next to the output database, '
+                               'see --resume',
+                          action='store_true',
+                          default=False)
+    analysis.add_argument('--checkpoint-interval',
+                          dest='checkpoint_interval',
+                          metavar='',
+                          help='Interval between checkpoints, in seconds '
+                               '(default: 300)',
+                          type=int)
+    analysis.add_argument('--resume',
+                          dest='resume',
+                          help='Resume an interrupted analysis from its '
+                               'checkpoint file (implies --checkpoint)',
+                          action='store_true',
+                          default=False)
 
     # Compile options
     compiler = parser.add_argument_group('Compile Options')
@@ -206,6 +543,13 @@ def parse_arguments(argv):
                           metavar='',
                           help='Use the specified machine options',
                           action='append')
+    compiler.add_argument('--compile-jobs',
+                          dest='compile_jobs',
+                          metavar='<n>',
+                          type=int,
+                          help='Number of source files compiled in parallel '
+                               '(default: number of CPUs)',
+                          default=multiprocessing.cpu_count())
 
     # Preprocessing options
     preprocess = parser.add_argument_group('Preprocessing Options')
@@ -222,6 +566,20 @@ def parse_arguments(argv):
                             help='Front-end inline all functions',
                             action='store_true',
                             default=False)
+    preprocess.add_argument('--internalize',
+                            dest='internalize',
+                            help='Internalize everything but the entry points '
+                                 'and remove the dead code, with --opt=basic.\n'
+                                 'Functions unreachable from the entry points '
+                                 'are not analyzed, even with --proc=intra',
+                            action='store_true',
+                            default=False)
+    preprocess.add_argument('--in-process-pp',
+                            dest='in_process_pp',
+                            help='Run the preprocessing inside ikos-analyzer, '
+                                 'without writing the preprocessed bitcode',
+                            action='store_true',
+                            default=False)
     preprocess.add_argument('--disable-bc-verify',
                             dest='disable_bc_verify',
                             help='Do not run the LLVM bitcode verifier',
@@ -242,6 +600,12 @@ def parse_arguments(argv):
                               '(__cxa_throw, etc.)',
                          action='store_true',
                          default=False)
+    imports.add_argument('--lazy-import',
+                         dest='lazy_import',
+                         help='Only load and translate the functions '
+                              'reachable from the entry points',
+                         action='store_true',
+                         default=False)
     imports.add_argument('--no-libikos',
                          dest='no_libikos',
                          help='Do not use ikos intrinsics '
@@ -256,6 +620,17 @@ def parse_arguments(argv):
                         help='Do not run the AR type checker',
                         action='store_true',
                         default=False)
+    passes.add_argument('--remove-unreachable-functions',
+                        dest='remove_unreachable_functions',
+                        help='Remove the functions unreachable from the '
+                             'entry points',
+                        action='store_true',
+                        default=False)
+    passes.add_argument('--propagate-constants',
+                        dest='propagate_constants',
+                        help='Propagate constants and remove dead stores',
+                        action='store_true',
+                        default=False)
     passes.add_argument('--no-simplify-cfg',
                         dest='no_simplify_cfg',
                         help='Do not run the simplify-cfg pass',
@@ -266,6 +641,18 @@ def parse_arguments(argv):
                         help='Do not run the simplify-upcast-comparison pass',
                         action='store_true',
                         default=False)
+    passes.add_argument('--slice',
+                        dest='slice',
+                        help='Remove the statements irrelevant to the '
+                             'requested checks',
+                        action='store_true',
+                        default=False)
+    passes.add_argument('--all-loop-counters',
+                        dest='all_loop_counters',
+                        help='Add a loop counter in all loops, for the gauge '
+                             'domains',
+                        action='store_true',
+                        default=False)
 
     # Debug options
     debug = parser.add_argument_group('Debug Options')
@@ -330,6 +717,18 @@ def parse_arguments(argv):
                        metavar='<directory>',
                        help='Output directory for .dot files',
                        default=None)
+    debug.add_argument('--domain-trace',
+                       dest='domain_trace',
+                       metavar='<file>',
+                       help='Record the operations on the machine integer '
+                            'abstract domain\nduring the analysis of '
+                            '--domain-trace-function in the given file',
+                       default=None)
+    debug.add_argument('--domain-trace-function',
+                       dest='domain_trace_function',
+                       metavar='<function>',
+                       help='Function recorded by --domain-trace',
+                       default=None)
     debug.add_argument('--save-temps',
                        dest='save_temps',
                        help='Do not delete temporary files',
@@ -348,6 +747,20 @@ def parse_arguments(argv):
                       help='Remove the output database file after use',
                       action='store_true',
                       default=False)
+    misc.add_argument('--result-cache',
+                      dest='result_cache',
+                      metavar='<directory>',
+                      help='Reuse the output database of a previous analysis '
+                           'with the same\npreprocessed bitcode and options, '
+                           'stored in <directory>',
+                      default=None)
+    misc.add_argument('--shared-result-cache',
+                      dest='shared_result_cache',
+                      metavar='<directory>',
+                      help='Result cache shared between machines, looked up '
+                           'after\n--result-cache (e.g. on a network file '
+                           'system)',
+                      default=None)
     misc.add_argument('--color',
                       dest='color',
                       metavar='',
@@ -423,6 +836,51 @@ def parse_arguments(argv):
                           type=int,
                           help='MEM limit (MB)',
                           default=-1)
+    resource.add_argument('--soft-mem',
+                          dest='soft_mem',
+                          metavar='<MB>',
+                          type=int,
+                          help='Soft memory limit (MB), after which functions '
+                               'are analyzed with a lower precision, 0 to '
+                               'disable (default: 90%% of --mem)',
+                          default=None)
+    resource.add_argument('--spill-mem',
+                          dest='spill_mem',
+                          metavar='<MB>',
+                          type=int,
+                          help='Memory limit (MB), after which the buffered '
+                               'checks and database rows are spilled to disk, '
+                               '0 to disable (default: 75%% of --mem)',
+                          default=None)
+    resource.add_argument('-j', '--jobs',
+                          dest='jobs',
+                          metavar='<n>',
+                          type=int,
+                          help='Number of threads used by the analysis '
+                               '(default: 1)',
+                          default=1)
+    resource.add_argument('--numa',
+                          dest='numa',
+                          help='Spread the analysis threads over the NUMA '
+                               'nodes of the machine',
+                          action='store_true',
+                          default=False)
+    resource.add_argument('--processes',
+                          dest='processes',
+                          metavar='<n>',
+                          type=int,
+                          help='Number of worker processes forked for the '
+                               'value analysis, each analyzing a shard of '
+                               'the entry points or functions (default: 1)',
+                          default=1)
+    resource.add_argument('--shard',
+                          dest='shard',
+                          metavar='<i>/<n>',
+                          type=shard,
+                          help='Only analyze the i-th shard out of n of the '
+                               'entry points (interprocedural) or the '
+                               'functions (intraprocedural), see ikos-merge',
+                          default=None)
 
     opt = parser.parse_args(argv)
 
@@ -615,7 +1073,18 @@ def clang(
     subprocess.check_call(cmd)
 
 
-def ikos_pp(pp_path, bc_path, entry_points, opt_level, inline_all, verify):
+def llvm_link(output_path, input_paths):
+    cmd = [settings.llvm_link()]
+    cmd += input_paths
+    cmd += ['-o', output_path]
+
+    log.info('Linking llvm bitcode')
+    log.debug('Running %s' % command_string(cmd))
+    subprocess.check_call(cmd)
+
+
+def ikos_pp(pp_path, bc_path, entry_points, opt_level, inline_all,
+            internalize, verify):
     cmd = [settings.ikos_pp(),
            '-opt=%s' % opt_level,
            '-entry-points=%s' % ','.join(entry_points)]
@@ -623,6 +1092,9 @@ def ikos_pp(pp_path, bc_path, entry_points, opt_level, inline_all, verify):
     if inline_all:
         cmd.append('-inline-all')
 
+    if internalize:
+        cmd.append('-internalize')
+
     if not verify:
         cmd.append('-disable-verify')
 
@@ -646,12 +1118,11 @@ class AnalyzerError(Exception):
         self.returncode = returncode
 
 
-def ikos_analyzer(db_path, pp_path, opt):
-    # Fix huge slow down when ikos-analyzer uses DROP TABLE on an existing db
-    if os.path.isfile(db_path):
-        os.remove(db_path)
-
-    cmd = [settings.ikos_analyzer()]
+def ikos_analyzer_command(db_path, pp_path, opt):
+    ''' Return the ikos-analyzer command '''
+    # Binaries specialized for one domain do not support --refine-domain
+    domain = None if opt.refine_domain else opt.domain
+    cmd = [settings.ikos_analyzer(domain, opt.analyses)]
 
     # analysis options
     cmd += ['-a=%s' % ','.join(opt.analyses),
@@ -663,10 +1134,19 @@ def ikos_analyzer(db_path, pp_path, opt):
 
     if opt.no_init_globals:
         cmd.append('-no-init-globals=%s' % ','.join(opt.no_init_globals))
+    if opt.functions:
+        cmd.append('-functions=%s' % ','.join(opt.functions))
+    if opt.only_files:
+        cmd.append('-only-file=%s' % ','.join(
+            os.path.abspath(f) for f in opt.only_files))
+    for regex in opt.only_functions or ():
+        cmd.append('-only-function=%s' % regex)
     if opt.no_liveness:
         cmd.append('-no-liveness')
     if opt.no_pointer:
         cmd.append('-no-pointer')
+    if opt.frame_projection:
+        cmd.append('-frame-projection')
     if opt.no_fixpoint_profiles:
         cmd.append('-no-fixpoint-profiles')
     if opt.hardware_addresses:
@@ -675,6 +1155,109 @@ def ikos_analyzer(db_path, pp_path, opt):
         cmd.append('-hardware-addresses-file=%s' % opt.hardware_addresses_file)
     if opt.argc is not None:
         cmd.append('-argc=%d' % opt.argc)
+    if opt.context_depth is not None:
+        cmd.append('-context-depth=%d' % opt.context_depth)
+    if opt.low_memory:
+        cmd.append('-low-memory')
+    if opt.release_ar:
+        cmd.append('-release-ar')
+    elif opt.release_functions:
+        cmd.append('-release-functions')
+    if opt.sparse:
+        cmd.append('-sparse')
+    if opt.function_timeout is not None:
+        cmd.append('-function-timeout=%d' % opt.function_timeout)
+    if opt.refine_domain:
+        cmd.append('-refine-domain=%s' % opt.refine_domain)
+    if opt.function_domains:
+        cmd.append('-function-domain=%s' % ','.join(opt.function_domains))
+    if opt.kernel_domain:
+        cmd.append('-kernel-domain=%s' % opt.kernel_domain)
+    if opt.max_pack_size is not None:
+        cmd.append('-max-pack-size=%d' % opt.max_pack_size)
+    if opt.apron_max_size is not None:
+        cmd.append('-apron-max-size=%d' % opt.apron_max_size)
+    if opt.apron_timeout is not None:
+        cmd.append('-apron-timeout=%d' % opt.apron_timeout)
+    if opt.refine_timeout is not None:
+        cmd.append('-refine-timeout=%d' % opt.refine_timeout)
+    if opt.function_max_steps is not None:
+        cmd.append('-function-max-steps=%d' % opt.function_max_steps)
+    if opt.deadline is not None:
+        cmd.append('-deadline=%d' % opt.deadline)
+    if opt.estimate:
+        cmd.append('-estimate')
+    soft_mem = opt.soft_mem
+    if soft_mem is None and opt.mem > 0:
+        soft_mem = opt.mem * 9 // 10
+    if soft_mem:
+        cmd.append('-soft-mem-limit=%d' % soft_mem)
+    spill_mem = opt.spill_mem
+    if spill_mem is None and opt.mem > 0:
+        spill_mem = opt.mem * 3 // 4
+    if spill_mem:
+        cmd.append('-spill-mem-limit=%d' % spill_mem)
+    if opt.max_cells is not None:
+        cmd.append('-max-cells=%d' % opt.max_cells)
+    if opt.aggregate_checks is not None:
+        cmd.append('-aggregate-checks=%d' % opt.aggregate_checks)
+    if opt.skip_safe_contexts:
+        cmd.append('-skip-safe-contexts')
+    if opt.group_contexts:
+        cmd.append('-group-contexts')
+    if opt.trivial_checks:
+        cmd.append('-trivial-checks')
+    if opt.tuning_profile and os.path.exists(opt.tuning_profile):
+        cmd.append('-tuning=%s' % opt.tuning_profile)
+    if opt.fixpoint_stats or opt.tuning_profile:
+        cmd.append('-fixpoint-stats')
+    if opt.transfer_stats:
+        cmd.append('-transfer-stats')
+    if opt.state_stats:
+        cmd.append('-state-stats')
+    if opt.cache:
+        cmd.append('-cache=%s' % (db_path + '.cache'))
+    if opt.pointer_cache:
+        cmd.append('-pointer-cache=%s' % (db_path + '.pointer-cache'))
+    for path in opt.library_summaries:
+        cmd.append('-library-summary=%s' % path)
+    if opt.emit_library_summary:
+        cmd.append('-emit-library-summary=%s' % opt.emit_library_summary)
+    if opt.checkpoint or opt.resume:
+        cmd.append('-checkpoint=%s' % (db_path + '.checkpoint'))
+        if opt.checkpoint_interval is not None:
+            cmd.append('-checkpoint-interval=%d' % opt.checkpoint_interval)
+        if opt.resume:
+            cmd.append('-resume')
+    if opt.shard is not None:
+        cmd.append('-shard=%d/%d' % opt.shard)
+    if opt.jobs > 1:
+        cmd.append('-jobs=%d' % opt.jobs)
+    if opt.numa:
+        cmd.append('-numa')
+        if opt.processes <= 1:
+            cmd.append('-async-db')
+            cmd.append('-async-log')
+    if opt.processes > 1:
+        cmd.append('-processes=%d' % opt.processes)
+    if opt.defer_db_indexes:
+        cmd.append('-defer-db-indexes')
+    if opt.live_db:
+        cmd.append('-live-db')
+    if opt.verify_cache:
+        cmd.append('-verify-cache=%s' % opt.verify_cache)
+    if opt.stream_checks:
+        cmd.append('-stream-checks=%s' % opt.stream_checks)
+    if opt.trace:
+        cmd.append('-trace=%s' % opt.trace)
+    if opt.perf_counters:
+        cmd.append('-perf-counters')
+    if opt.allocation_stats:
+        cmd.append('-allocation-stats')
+    if opt.progress_events:
+        cmd.append('-progress=%s' % opt.progress_events)
+    if opt.db_format != 'sqlite':
+        cmd.append('-format=%s' % opt.db_format)
 
     # import options
     cmd.append('-allow-dbg-mismatch')
@@ -682,18 +1265,34 @@ def ikos_analyzer(db_path, pp_path, opt):
         cmd.append('-no-libc')
     if opt.no_libcpp:
         cmd.append('-no-libcpp')
+    if opt.lazy_import:
+        cmd.append('-lazy-import')
+    if opt.in_process_pp:
+        cmd.append('-pp-opt=%s' % opt.opt_level)
+        if opt.inline_all:
+            cmd.append('-pp-inline-all')
+        if opt.internalize:
+            cmd.append('-pp-internalize')
     if opt.no_libikos:
         cmd.append('-no-libikos')
 
     # AR passes options
     if opt.disable_type_check:
         cmd.append('-disable-type-check')
+    if opt.remove_unreachable_functions:
+        cmd.append('-remove-unreachable-functions')
+    if opt.propagate_constants:
+        cmd.append('-propagate-constants')
     if opt.no_simplify_cfg:
         cmd.append('-no-simplify-cfg')
     if opt.no_simplify_upcast_comparison:
         cmd.append('-no-simplify-upcast-comparison')
+    if opt.slice:
+        cmd.append('-slice')
     if 'gauge' in opt.domain:
         cmd.append('-add-loop-counters')
+        if opt.all_loop_counters:
+            cmd.append('-all-loop-counters')
 
     # debug options
     cmd += ['-display-checks=%s' % opt.display_checks,
@@ -711,6 +1310,10 @@ def ikos_analyzer(db_path, pp_path, opt):
         cmd.append('-display-fixpoint-profiles')
     if opt.generate_dot:
         cmd += ['-generate-dot', '-generate-dot-dir', opt.generate_dot_dir]
+    if opt.domain_trace:
+        cmd.append('-domain-trace=%s' % opt.domain_trace)
+    if opt.domain_trace_function:
+        cmd.append('-domain-trace-function=%s' % opt.domain_trace_function)
 
     # add -name-values if necessary
     if (opt.display_checks in ('all', 'fail') or
@@ -733,6 +1336,151 @@ def ikos_analyzer(db_path, pp_path, opt):
     # input/output
     cmd += [pp_path, '-o', db_path]
 
+    return cmd
+
+
+# ikos-analyzer options that do not change the output database
+RESULT_CACHE_IGNORED_OPTIONS = ('-color=', '-log=', '-jobs=', '-async-db',
+                                '-async-log', '-progress=', '-tuning=',
+                                '-numa', '-live-db')
+
+
+def result_cacheable(opt):
+    ''' Return True if ikos-analyzer only writes the output database '''
+    return not (opt.estimate or
+                opt.display_checks != 'no' or
+                opt.display_inv != 'no' or
+                opt.display_ar or
+                opt.display_liveness or
+                opt.display_function_pointer or
+                opt.display_pointer or
+                opt.display_fixpoint_profiles or
+                opt.generate_dot or
+                opt.trace or
+                opt.perf_counters or
+                opt.allocation_stats or
+                opt.domain_trace or
+                opt.stream_checks or
+                opt.verify_cache or
+                opt.cache or
+                opt.emit_library_summary or
+                opt.checkpoint or
+                opt.resume)
+
+
+def result_cache_key(pp_path, opt):
+    ''' Return the key of the analysis in the result cache '''
+    cmd = ikos_analyzer_command('output.db', 'input.bc', opt)
+    arguments = [arg for arg in cmd[1:-3]
+                 if not arg.startswith(RESULT_CACHE_IGNORED_OPTIONS)]
+    input_files = []
+    if opt.hardware_addresses_file:
+        input_files.append(opt.hardware_addresses_file)
+    if opt.tuning_profile and os.path.exists(opt.tuning_profile):
+        input_files.append(opt.tuning_profile)
+    input_files.extend(opt.library_summaries)
+
+    return result_cache.result_key(pp_path, cmd[0], arguments, input_files)
+
+
+class ProgressBar(threading.Thread):
+    ''' Display the progress events of ikos-analyzer on the standard error '''
+
+    WIDTH = 30
+
+    def __init__(self, path):
+        super(ProgressBar, self).__init__()
+        self.daemon = True
+        self.path = path
+        self.done = threading.Event()
+        self.line_length = 0
+
+    def run(self):
+        # Wait for ikos-analyzer to create the file
+        while not os.path.exists(self.path):
+            if self.done.wait(0.1):
+                return
+
+        with open(self.path) as f:
+            buf = ''
+            while True:
+                chunk = f.readline()
+                if not chunk:
+                    if self.done.wait(0.1):
+                        break
+                    continue
+                buf += chunk
+                if not buf.endswith('\n'):
+                    continue
+                try:
+                    self.display(json.loads(buf))
+                except ValueError:
+                    pass
+                buf = ''
+
+        self.clear()
+
+    def stop(self):
+        self.done.set()
+        self.join()
+
+    def display(self, event):
+        total = event.get('total', 0)
+        completed = event.get('completed', 0)
+        ratio = float(completed) / total if total > 0 else 0.0
+        filled = int(ratio * ProgressBar.WIDTH)
+        line = '[%s%s] %d/%d' % ('=' * filled,
+                                 ' ' * (ProgressBar.WIDTH - filled),
+                                 completed,
+                                 total)
+        if 'eta' in event:
+            line += ', ETA %s' % format_duration(event['eta'])
+        if event.get('current'):
+            line += ', %s' % event['current']
+        self.write(line)
+
+    def clear(self):
+        self.write('')
+
+    def write(self, line):
+        padding = ' ' * max(self.line_length - len(line), 0)
+        sys.stderr.write('\r' + line + padding)
+        if not line:
+            sys.stderr.write('\r')
+        sys.stderr.flush()
+        self.line_length = len(line)
+
+
+def format_duration(seconds):
+    ''' Return a short representation of the given duration '''
+    seconds = int(seconds)
+    if seconds >= 3600:
+        return '%dh%02dm' % (seconds // 3600, seconds % 3600 // 60)
+    if seconds >= 60:
+        return '%dm%02ds' % (seconds // 60, seconds % 60)
+    return '%ds' % seconds
+
+
+def ikos_analyzer(db_path, pp_path, opt):
+    # Fix huge slow down when ikos-analyzer uses DROP TABLE on an existing db
+    if os.path.isfile(db_path):
+        os.remove(db_path)
+
+    cmd = ikos_analyzer_command(db_path, pp_path, opt)
+
+    # display a progress bar, if requested
+    progress_bar = None
+    if opt.progress and sys.stderr.isatty() and opt.processes <= 1:
+        progress_path = opt.progress_events
+        if not progress_path:
+            progress_path = os.path.join(os.path.dirname(pp_path),
+                                         'progress.jsonl')
+            cmd.append('-progress=%s' % progress_path)
+        if os.path.isfile(progress_path):
+            os.remove(progress_path)
+        progress_bar = ProgressBar(progress_path)
+        progress_bar.start()
+
     # set resource limit, if requested
     if opt.mem > 0:
         import resource  # fails on Windows
@@ -769,6 +1517,9 @@ def ikos_analyzer(db_path, pp_path, opt):
         if timer.isAlive():
             timer.cancel()
 
+        if progress_bar is not None:
+            progress_bar.stop()
+
     # special case for Windows, since it does not define WIFEXITED & co.
     if sys.platform.startswith('win'):
         if return_status != 0:
@@ -793,6 +1544,21 @@ def ikos_analyzer(db_path, pp_path, opt):
                             cmd,
                             signum)
 
+    if opt.processes > 1:
+        merge_worker_databases(db_path, opt.processes)
+
+
+def merge_worker_databases(db_path, num_workers):
+    ''' Merge the output databases of the worker processes in db_path '''
+    from ikos.merge import merge
+
+    inputs = [db_path] + ['%s.%d' % (db_path, i) for i in range(num_workers)]
+    merged_path = db_path + '.merged'
+    merge(merged_path, inputs)
+    os.rename(merged_path, db_path)
+    for path in inputs[1:]:
+        os.remove(path)
+
 
 def ikos_view(opt, db):
     from ikos import view
@@ -804,6 +1570,66 @@ def ikos_view(opt, db):
 # main for ikos #
 #################
 
+def compile_sources(progname, opt, wd):
+    '''
+    Compile the c/c++ input files to llvm bitcode, in parallel
+
+    Return the paths of the llvm bitcode files, in the order of the input
+    files. Exit if a compilation fails.
+    '''
+    def bc_name(index, path):
+        if len(opt.files) == 1:
+            return namer(path, '.bc', wd)
+        # Input files might have the same name in different directories
+        return namer(path, '.%d.bc' % index, wd)
+
+    sources = [(bc_name(i, path), path)
+               for i, path in enumerate(opt.files)
+               if path_ext(path) in c_extensions + cpp_extensions]
+
+    def compile_source(source):
+        bc_path, path = source
+        try:
+            clang(bc_path, path,
+                  opt.compiler_include_flags,
+                  opt.compiler_define_flags,
+                  opt.compiler_warning_flags,
+                  opt.compiler_machine_flags,
+                  colors.ENABLE)
+            return 0
+        except subprocess.CalledProcessError as e:
+            printf('%s: error while compiling %s, abort.\n',
+                   progname, path, file=sys.stderr)
+            return e.returncode
+
+    if not sources:
+        return list(opt.files)
+
+    with stats.timer('clang'):
+        if len(sources) > 1 and opt.compile_jobs > 1:
+            # Each worker waits on a clang process
+            pool = multiprocessing.pool.ThreadPool(
+                min(opt.compile_jobs, len(sources)))
+            try:
+                returncodes = pool.map(compile_source, sources)
+            finally:
+                pool.close()
+                pool.join()
+        else:
+            returncodes = []
+            for source in sources:
+                returncodes.append(compile_source(source))
+                if returncodes[-1] != 0:
+                    break
+
+    for returncode in returncodes:
+        if returncode != 0:
+            sys.exit(returncode)
+
+    bc_paths = dict((path, bc_path) for bc_path, path in sources)
+    return [bc_paths.get(path, path) for path in opt.files]
+
+
 def main(argv):
     progname = os.path.basename(argv[0])
 
@@ -826,55 +1652,90 @@ def main(argv):
     # create working directory
     wd = create_working_directory(opt.temp_dir, opt.save_temps)
 
-    input_path = opt.file
+    for path in opt.files:
+        if path_ext(path) not in c_extensions + cpp_extensions + \
+                llvm_extensions:
+            printf('%s: error: unexpected file extension: %s\n',
+                   progname, path, file=sys.stderr)
+            sys.exit(1)
 
     # compile c/c++ code
-    if path_ext(input_path) in c_extensions + cpp_extensions:
-        bc_path = namer(opt.file, '.bc', wd)
+    input_paths = compile_sources(progname, opt, wd)
 
+    # link the llvm bitcode files
+    if len(input_paths) > 1:
+        input_path = namer(opt.files[0], '.linked.bc', wd)
         try:
-            with stats.timer('clang'):
-                clang(bc_path, input_path,
-                      opt.compiler_include_flags,
-                      opt.compiler_define_flags,
-                      opt.compiler_warning_flags,
-                      opt.compiler_machine_flags,
-                      colors.ENABLE)
+            with stats.timer('llvm-link'):
+                llvm_link(input_path, input_paths)
         except subprocess.CalledProcessError as e:
-            printf('%s: error while compiling %s, abort.\n',
-                   progname, input_path, file=sys.stderr)
+            printf('%s: error while linking llvm bitcode, abort.\n',
+                   progname, file=sys.stderr)
             sys.exit(e.returncode)
+    else:
+        input_path = input_paths[0]
 
-        input_path = bc_path
+    if opt.tuning_profile and opt.no_fixpoint_profiles:
+        printf('%s: error: --tuning-profile is not compatible with '
+               '--no-fixpoint-profiles\n',
+               progname, file=sys.stderr)
+        sys.exit(1)
 
-    if path_ext(input_path) not in llvm_extensions:
-        printf('%s: error: unexpected file extension.\n',
+    if opt.in_process_pp and (opt.lazy_import or opt.display_llvm):
+        printf('%s: error: --in-process-pp is not compatible with '
+               '--lazy-import and --display-llvm\n',
                progname, file=sys.stderr)
         sys.exit(1)
 
     # ikos-pp: preprocess llvm bitcode
-    pp_path = namer(opt.file, '.pp.bc', wd)
-    try:
-        with stats.timer('ikos-pp'):
-            ikos_pp(pp_path, input_path,
-                    opt.entry_points, opt.opt_level,
-                    opt.inline_all, not opt.disable_bc_verify)
-    except subprocess.CalledProcessError as e:
-        printf('%s: error while preprocessing llvm bitcode, abort.\n',
-               progname, file=sys.stderr)
-        sys.exit(e.returncode)
+    if opt.in_process_pp:
+        # ikos-analyzer runs the preprocessing on the loaded bitcode
+        pp_path = input_path
+    else:
+        pp_path = namer(opt.files[0], '.pp.bc', wd)
+        try:
+            with stats.timer('ikos-pp'):
+                ikos_pp(pp_path, input_path,
+                        opt.entry_points, opt.opt_level,
+                        opt.inline_all, opt.internalize,
+                        not opt.disable_bc_verify)
+        except subprocess.CalledProcessError as e:
+            printf('%s: error while preprocessing llvm bitcode, abort.\n',
+                   progname, file=sys.stderr)
+            sys.exit(e.returncode)
 
     # display the llvm bitcode, if requested
     if opt.display_llvm:
         display_llvm(pp_path)
 
+    # look for the results of an identical analysis
+    cache = None
+    cache_key = None
+    cache_hit = False
+    cache_directories = [d for d in (opt.result_cache,
+                                     opt.shared_result_cache) if d]
+    if cache_directories and result_cacheable(opt):
+        cache = result_cache.ResultCache(cache_directories)
+        with stats.timer('result-cache'):
+            cache_key = result_cache_key(pp_path, opt)
+            cache_hit = cache.lookup(cache_key, opt.output_db)
+
     # ikos-analyzer: analyze llvm bitcode
-    try:
-        with stats.timer('ikos-analyzer'):
-            ikos_analyzer(opt.output_db, pp_path, opt)
-    except AnalyzerError as e:
-        printf('%s: error: %s\n', progname, e, file=sys.stderr)
-        sys.exit(e.returncode)
+    if not cache_hit:
+        try:
+            with stats.timer('ikos-analyzer'):
+                ikos_analyzer(opt.output_db, pp_path, opt)
+        except AnalyzerError as e:
+            printf('%s: error: %s\n', progname, e, file=sys.stderr)
+            sys.exit(e.returncode)
+
+        # the estimates are printed by ikos-analyzer, there is no result
+        if opt.estimate:
+            return
+
+        if cache is not None:
+            with stats.timer('result-cache'):
+                cache.store(cache_key, opt.output_db)
 
     # open output database
     db = OutputDatabase(path=opt.output_db)
@@ -888,7 +1749,7 @@ def main(argv):
         ('start-date', start_date.isoformat(' ')),
         ('end-date', datetime.datetime.now().isoformat(' ')),
         ('working-directory', wd),
-        ('input', opt.file),
+        ('input', ' '.join(opt.files)),
         ('bc-file', input_path),
         ('pp-bc-file', pp_path),
         ('clang', settings.clang()),
@@ -906,8 +1767,21 @@ def main(argv):
         settings_rows.append(('cpu-limit', opt.cpu))
     if opt.mem > 0:
         settings_rows.append(('mem-limit', opt.mem))
+    if cache is not None:
+        settings_rows.append(('result-cache-key', cache_key))
+        settings_rows.append(('result-cache-hit', json.dumps(cache_hit)))
     db.insert_settings(settings_rows)
 
+    # update the tuning profile for the next run
+    if opt.tuning_profile:
+        with stats.timer('tuning'):
+            tuning.update(opt.tuning_profile, db)
+
+    # post-process the database for ikos-report and ikos-view
+    if opt.finalize_db:
+        with stats.timer('finalize'):
+            report.finalize(db)
+
     first = (log.LEVEL >= log.ERROR)
 
     # display timing results
@@ -172,20 +172,30 @@ default_analyses = (
 domains = (
     ('interval',
      'Interval domain'),
+    ('dense-interval',
+     'Interval domain, stored in dense arrays'),
     ('congruence',
      'Congruence domain'),
     ('interval-congruence',
      'Reduced product of Interval and Congruence'),
+    ('interval-equality',
+     'Reduced product of Interval and variable equalities'),
     ('dbm',
      'Difference-Bound Matrices domain'),
+    ('split-dbm',
+     'Sparse Difference-Bound Matrices domain'),
     ('var-pack-dbm',
      'Difference-Bound Matrices domain with variable packing'),
     ('var-pack-dbm-congruence',
      'Reduced product of DBM with variable packing and Congruence'),
+    ('static-pack-dbm',
+     'Difference-Bound Matrices domain with fixed variable packs'),
     ('gauge',
      'Gauge domain'),
     ('gauge-interval-congruence',
      'Reduced product of Gauge, Interval and Congruence'),
+    ('powerset-interval',
+     'Bounded disjunctions of Intervals'),
     ('apron-interval',
      'APRON Interval domain'),
     ('apron-octagon',
@@ -306,6 +316,7 @@ report_formats = (
     ('text', 'Generate a text report'),
     ('json', 'Generate a json report'),
     ('csv', 'Generate a csv report'),
+    ('stats', 'Generate a report on the time, memory and abstract state sizes'),
     ('web', 'Generate a web report (ikos-view)'),
     ('no', 'Do not generate a report'),
 )
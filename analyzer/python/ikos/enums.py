@@ -333,6 +333,7 @@ class FunctionsTable:
     DEFINITION = auto()
     FILE_ID = auto()
     LINE = auto()
+    HASH = auto()
 
 
 class StatementsTable:
@@ -372,3 +373,45 @@ class ChecksTable:
     OPERANDS = auto()
     CALL_CONTEXT_ID = auto()
     INFO = auto()
+
+
+class BudgetsTable:
+    FUNCTION_ID = auto(reset=0)
+    CALL_CONTEXT_ID = auto()
+    KIND = auto()
+    TIME = auto()
+    STEPS = auto()
+
+
+class FixpointsTable:
+    FUNCTION_ID = auto(reset=0)
+    STATEMENT_ID = auto()
+    CALL_CONTEXT_ID = auto()
+    INCREASING_ITERATIONS = auto()
+    WIDENINGS = auto()
+    NARROWINGS = auto()
+    TIME = auto()
+    PEAK_SIZE = auto()
+    COPIES = auto()
+    ANALYZED_NODES = auto()
+    REUSED_NODES = auto()
+    SKIPPED_NARROWINGS = auto()
+
+
+class TransferFunctionsTable:
+    FUNCTION_ID = auto(reset=0)
+    CALL_CONTEXT_ID = auto()
+    KIND = auto()
+    COUNT = auto()
+    TIME = auto()
+
+
+class StateSizesTable:
+    FUNCTION_ID = auto(reset=0)
+    CALL_CONTEXT_ID = auto()
+    SAMPLES = auto()
+    PEAK_CELLS = auto()
+    PEAK_POINTS_TO = auto()
+    PEAK_NODES = auto()
+    PEAK_PACK_SIZE = auto()
+    DROPPED_RELATIONS = auto()
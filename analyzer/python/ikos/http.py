@@ -50,3 +50,15 @@ except ImportError:
     from urlparse import parse_qs
     from urllib import urlencode
     from urllib2 import urlopen
+
+try:
+    # Python 3
+    from socketserver import ThreadingMixIn
+except ImportError:
+    # Python 2
+    from SocketServer import ThreadingMixIn
+
+
+class ThreadingHTTPServer(ThreadingMixIn, HTTPServer):
+    ''' HTTP server handling each request in a new thread '''
+    daemon_threads = True
@@ -0,0 +1,457 @@
+###############################################################################
+#
+# Merge the output databases of a distributed analysis
+#
+#
+# Contact: ikos@lists.nasa.gov
+#
+# Notices:
+#
+#
+# Copyright (c) 2011-2019 United States Government as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All Rights Reserved.
+#
+# Disclaimers:
+#
+# No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+# ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+# TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+# ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+# OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+# ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+# THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+# ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+# RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+# RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+# DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+# IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+#
+# Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+# THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+# AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+# IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+# USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+# RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+# HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+# AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+# RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+# UNILATERAL TERMINATION OF THIS AGREEMENT.
+import hashlib
+import argparse
+import collections
+import json
+import os.path
+import sqlite3
+import sys
+
+from ikos import log
+from ikos.enums import MemoryLocationKind
+from ikos.log import printf
+from ikos.output_db import OutputDatabase, decode_operands, encode_operands
+
+# Settings that must be equal in all the shards
+CONSISTENT_SETTINGS = ('analyses', 'procedural', 'machine-int-domain')
+
+
+def dumps(value):
+    ''' Serialize JSON the same way as ikos-analyzer '''
+    return json.dumps(value, separators=(',', ':'))
+
+
+def remap(ids, id):
+    ''' Return the merged id of a row, or None '''
+    return ids[id] if id is not None else None
+
+
+class Merger(object):
+    '''
+    Merge output databases into a new one
+
+    Every shard of an analysis (see `ikos --shard`) numbers the rows of its
+    output database independently. Rows describing the program (files,
+    functions, statements, operands, call contexts and memory locations) are
+    identified by their content, given a merged id, and inserted once. The
+    references to them, including in the JSON information of the checks, are
+    rewritten with the merged ids. Readers index these tables by id, hence the
+    merged ids start at 0 and are contiguous.
+    '''
+
+    def __init__(self, path, schema):
+        '''
+        Arguments:
+            path(str): path to the merged database, which must not exist
+            schema(list): statements creating the tables and indexes
+        '''
+        self.con = sqlite3.connect(path)
+        self.con.text_factory = str
+        self.indexes = []
+        for kind, sql in schema:
+            if kind == 'table':
+                self.con.execute(sql)
+            else:
+                self.indexes.append(sql)
+
+        # Merged ids, indexed by the content of the rows
+        self.files = {}
+        self.functions = {}
+        self.statements = {}
+        self.operands = {}
+        self.call_contexts = {}
+        self.memory_locations = {}
+        self.num_checks = 0
+
+        self.settings = None
+        self.entry_points = []
+        self.times = {}
+        self.counters = {}
+        self.allocations = {}
+        self.num_shards = 0
+
+    def _insert(self, ids, key, table, row):
+        ''' Return the merged id of a row, inserting it if it is new '''
+        id = ids.get(key)
+        if id is None:
+            id = len(ids)
+            ids[key] = id
+            self.con.execute('INSERT INTO %s VALUES (%s)'
+                             % (table, ','.join('?' * (len(row) + 1))),
+                             (id,) + row)
+        return id
+
+    def add(self, db):
+        ''' Merge the given OutputDatabase '''
+        c = db.con.cursor()
+        self.num_shards += 1
+        c.execute('SELECT name, value FROM settings')
+        self._add_settings(c.fetchall())
+        for name, time, peak_rss in db.load_phase_results(sort=False):
+            total_time, total_peak_rss = self.times.get(name, (0, None))
+            if total_peak_rss is None or (peak_rss is not None and
+                                          peak_rss > total_peak_rss):
+                total_peak_rss = peak_rss
+            self.times[name] = (total_time + time, total_peak_rss)
+        for row in db.load_phase_counters():
+            total = self.counters.get(row[0], (0, 0, 0, 0))
+            self.counters[row[0]] = tuple(a + b
+                                          for a, b in zip(total, row[1:]))
+        for row in db.load_phase_allocations():
+            total = self.allocations.get(row[0], (0, 0, 0))
+            self.allocations[row[0]] = tuple(a + b
+                                             for a, b in zip(total, row[1:]))
+
+        files = {}
+        c.execute('SELECT id, path FROM files')
+        for id, path in c:
+            files[id] = self._insert(self.files, path, 'files', (path,))
+
+        functions = {}
+        c.execute('SELECT id, name, demangled, definition, file_id, line, '
+                  'hash FROM functions')
+        for id, name, demangled, definition, file_id, line, hash in c:
+            functions[id] = self._insert(self.functions,
+                                         name,
+                                         'functions',
+                                         (name,
+                                          demangled,
+                                          definition,
+                                          remap(files, file_id),
+                                          line,
+                                          hash))
+
+        # Statements have no unique name: identify them by their location,
+        # and their rank among the statements at the same location
+        statements = {}
+        ranks = {}
+        c.execute('SELECT id, kind, function_id, file_id, line, column '
+                  'FROM statements ORDER BY id')
+        for id, kind, function_id, file_id, line, column in c:
+            row = (kind,
+                   remap(functions, function_id),
+                   remap(files, file_id),
+                   line,
+                   column)
+            rank = ranks.get(row, 0)
+            ranks[row] = rank + 1
+            statements[id] = self._insert(self.statements,
+                                          row + (rank,),
+                                          'statements',
+                                          row)
+
+        operands = {}
+        c.execute('SELECT id, kind, repr FROM operands')
+        for id, kind, repr in c:
+            operands[id] = self._insert(self.operands,
+                                        (kind, repr),
+                                        'operands',
+                                        (kind, repr))
+
+        # Parents are inserted before their children
+        call_contexts = {}
+        c.execute('SELECT id, call_id, function_id, parent_id '
+                  'FROM call_contexts ORDER BY id')
+        for id, call_id, function_id, parent_id in c:
+            row = (remap(statements, call_id),
+                   remap(functions, function_id),
+                   remap(call_contexts, parent_id))
+            call_contexts[id] = self._insert(self.call_contexts,
+                                             row,
+                                             'call_contexts',
+                                             row)
+
+        memory_locations = {}
+        c.execute('SELECT id, kind, info FROM memory_locations')
+        for id, kind, info in c:
+            if info is not None:
+                info = json.loads(info)
+                if kind == MemoryLocationKind.FUNCTION:
+                    info['id'] = functions[info['id']]
+                elif kind == MemoryLocationKind.DYN_ALLOC:
+                    info['call_id'] = statements[info['call_id']]
+                    info['context_id'] = call_contexts[info['context_id']]
+                info = dumps(info)
+            memory_locations[id] = self._insert(self.memory_locations,
+                                                (kind, info),
+                                                'memory_locations',
+                                                (kind, info))
+
+        def remap_info(info):
+            if info is None:
+                return None
+            info = json.loads(info)
+            if 'fun_id' in info:
+                info['fun_id'] = functions[info['fun_id']]
+            for block_info in info.get('points_to', ()):
+                block_info['id'] = memory_locations[block_info['id']]
+                if 'fun_id' in block_info:
+                    block_info['fun_id'] = functions[block_info['fun_id']]
+            for key in ('left_points_to', 'right_points_to'):
+                if key in info:
+                    info[key] = [memory_locations[id] for id in info[key]]
+            if 'call_contexts' in info:
+                info['call_contexts'] = [call_contexts[id]
+                                         for id in info['call_contexts']]
+            return dumps(info)
+
+        def remap_operands(value):
+            if value is None:
+                return None
+            return encode_operands([(num, operands[id])
+                                    for num, id in decode_operands(value)])
+
+        c.execute('SELECT kind, checker, status, statement_id, operands, '
+                  'call_context_id, info FROM checks')
+        rows = []
+        for kind, checker, status, stmt_id, ops, context_id, info in c:
+            rows.append((self.num_checks,
+                         kind,
+                         checker,
+                         status,
+                         statements[stmt_id],
+                         remap_operands(ops),
+                         call_contexts[context_id],
+                         remap_info(info)))
+            self.num_checks += 1
+            if len(rows) >= 10000:
+                self._insert_checks(rows)
+        self._insert_checks(rows)
+
+        for budget in db.load_budgets():
+            self.con.execute('INSERT INTO budgets VALUES (?, ?, ?, ?, ?)',
+                             (functions[budget.function_id],
+                              call_contexts[budget.call_context_id],
+                              budget.kind,
+                              budget.time,
+                              budget.steps))
+
+        for fixpoint in db.load_fixpoints():
+            self.con.execute('INSERT INTO fixpoints '
+                             'VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)',
+                             (functions[fixpoint.function_id],
+                              statements[fixpoint.statement_id],
+                              call_contexts[fixpoint.call_context_id],
+                              fixpoint.increasing_iterations,
+                              fixpoint.widenings,
+                              fixpoint.narrowings,
+                              fixpoint.time,
+                              fixpoint.peak_size,
+                              fixpoint.copies,
+                              fixpoint.analyzed_nodes,
+                              fixpoint.reused_nodes,
+                              fixpoint.skipped_narrowings))
+
+        for transfer in db.load_transfer_functions():
+            self.con.execute('INSERT INTO transfer_functions '
+                             'VALUES (?, ?, ?, ?, ?)',
+                             (functions[transfer.function_id],
+                              call_contexts[transfer.call_context_id],
+                              transfer.kind,
+                              transfer.count,
+                              transfer.time))
+
+        for size in db.load_state_sizes():
+            self.con.execute('INSERT INTO state_sizes '
+                             'VALUES (?, ?, ?, ?, ?, ?, ?, ?)',
+                             (functions[size.function_id],
+                              call_contexts[size.call_context_id],
+                              size.samples,
+                              size.peak_cells,
+                              size.peak_points_to,
+                              size.peak_nodes,
+                              size.peak_pack_size,
+                              size.dropped_relations))
+
+    def _insert_checks(self, rows):
+        self.con.executemany('INSERT INTO checks '
+                             'VALUES (?, ?, ?, ?, ?, ?, ?, ?)',
+                             rows)
+        del rows[:]
+
+    def _add_settings(self, rows):
+        settings = collections.OrderedDict(rows)
+        for name in CONSISTENT_SETTINGS:
+            if self.settings is not None and \
+                    settings.get(name) != self.settings.get(name):
+                raise ValueError("setting '%s' differs between the shards "
+                                 "(%r and %r)" % (name,
+                                                  self.settings.get(name),
+                                                  settings.get(name)))
+        for name in json.loads(settings.get('entry-points', '[]')):
+            if name not in self.entry_points:
+                self.entry_points.append(name)
+        if self.settings is None:
+            self.settings = settings
+
+    def finish(self):
+        ''' Write the settings, times and indexes, and commit '''
+        # The shards share the statements of global initializers and of the
+        # functions called from entry points of different shards, remove the
+        # identical checks
+        self.con.execute('DELETE FROM checks WHERE id NOT IN ('
+                         'SELECT MIN(id) FROM checks GROUP BY kind, checker, '
+                         'status, statement_id, operands, call_context_id, '
+                         'info)')
+
+        settings = self.settings
+        settings.pop('shard', None)
+        settings['format'] = 'sqlite'
+        settings['entry-points'] = dumps(self.entry_points)
+        settings['merged-shards'] = str(self.num_shards)
+        self.con.executemany('INSERT INTO settings VALUES (?, ?)',
+                             settings.items())
+
+        # Times of the shards are summed, peak memory usages are maximized
+        self.con.executemany('INSERT INTO times (pass, time, peak_rss) '
+                             'VALUES (?, ?, ?)',
+                             sorted((name, time, peak_rss)
+                                    for name, (time, peak_rss)
+                                    in self.times.items()))
+
+        # Performance counters of the shards are summed
+        self.con.executemany('UPDATE times SET instructions = ?, cycles = ?, '
+                             'llc_misses = ?, branch_misses = ? '
+                             'WHERE pass = ?',
+                             sorted(counters + (name,)
+                                    for name, counters
+                                    in self.counters.items()))
+
+        # Allocations of the shards are summed, since they are separate
+        # processes
+        self.con.executemany('UPDATE times SET allocated_bytes = ?, '
+                             'allocations = ?, live_bytes = ? '
+                             'WHERE pass = ?',
+                             sorted(allocations + (name,)
+                                    for name, allocations
+                                    in self.allocations.items()))
+
+        for sql in self.indexes:
+            self.con.execute(sql)
+        self.con.commit()
+        self.con.close()
+
+
+def schema(db):
+    ''' Return the statements creating the tables and indexes of a database '''
+    c = db.con.cursor()
+    c.execute("SELECT type, sql FROM main.sqlite_master "
+              "WHERE type IN ('table', 'index') AND sql IS NOT NULL "
+              "AND tbl_name NOT LIKE 'view\\_%' ESCAPE '\\' "
+              "ORDER BY type DESC")
+    return c.fetchall()
+
+
+def merge(output, inputs):
+    '''
+    Merge the output databases of the shards of an analysis
+
+    Arguments:
+        output(str): path to the merged database
+        inputs(list): paths to the output databases of the shards
+    '''
+    if os.path.exists(output):
+        os.remove(output)
+
+    merger = None
+    try:
+        for path in inputs:
+            log.info('Merging %s' % path)
+            db = OutputDatabase(path)
+            try:
+                if merger is None:
+                    merger = Merger(output, schema(db))
+                merger.add(db)
+            finally:
+                db.close()
+        merger.finish()
+    except BaseException:
+        # Do not leave a partial database
+        if merger is not None:
+            merger.con.close()
+        if os.path.exists(output):
+            os.remove(output)
+        raise
+
+
+def parse_arguments(argv):
+    usage = '%(prog)s [options] -o output.db shard.db...'
+    description = 'Merge the output databases of a distributed analysis ' \
+                  '(see ikos --shard)'
+    parser = argparse.ArgumentParser(usage=usage, description=description)
+    parser.add_argument('inputs',
+                        metavar='shard.db',
+                        nargs='+',
+                        help='Output databases of the shards')
+    parser.add_argument('-o', '--output',
+                        dest='output',
+                        metavar='<file>',
+                        help='Merged output database (default: output.db)',
+                        default='output.db')
+    parser.add_argument('-q', '--quiet',
+                        dest='log_level',
+                        help='Disable logging',
+                        action='store_const',
+                        const='none',
+                        default='info')
+    return parser.parse_args(argv)
+
+
+def main(argv):
+    progname = os.path.basename(argv[0])
+    opt = parse_arguments(argv[1:])
+    log.setup(opt.log_level)
+
+    for path in opt.inputs:
+        if not os.path.isfile(path):
+            printf('%s: error: no such file: \'%s\'\n',
+                   progname, path, file=sys.stderr)
+            sys.exit(1)
+        if os.path.abspath(path) == os.path.abspath(opt.output):
+            printf('%s: error: \'%s\' is both an input and the output\n',
+                   progname, path, file=sys.stderr)
+            sys.exit(1)
+
+    try:
+        merge(opt.output, opt.inputs)
+    except (ValueError, sqlite3.Error) as e:
+        printf('%s: error: %s\n', progname, e, file=sys.stderr)
+        sys.exit(1)
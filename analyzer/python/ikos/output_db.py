@@ -41,10 +41,14 @@
 ###############################################################################
 import collections
 import json
+import mmap
+import os.path
 import sqlite3
+import struct
 
 from ikos.enums import FilesTable, FunctionsTable, StatementsTable, \
-    CallContextsTable, OperandsTable, MemoryLocationsTable, ChecksTable
+    CallContextsTable, OperandsTable, MemoryLocationsTable, ChecksTable, \
+    BudgetsTable, FixpointsTable, TransferFunctionsTable, StateSizesTable
 
 
 class CachedProperty(object):
@@ -63,17 +67,65 @@ class CachedProperty(object):
 class OutputDatabase(object):
     ''' Represents an output database '''
 
-    def __init__(self, path):
+    def __init__(self, path, check_same_thread=True):
+        '''
+        Arguments:
+            path(str): path to the database
+            check_same_thread(bool): only allow the creating thread to use
+                the connection. Otherwise, the caller is responsible for
+                serializing the accesses to the database.
+        '''
         self.path = path
-        self.con = sqlite3.connect(path)
+        self.con = sqlite3.connect(path, check_same_thread=check_same_thread)
 
         # Use 'str' as text factory since it's the type of string literals
         # This is bytes in python 2 and unicode in python 3
         self.con.text_factory = str
 
+        if self._format() == 'columnar':
+            self._load_columnar_tables(path + '.col')
+
+    def _format(self):
+        ''' Return the output format of the analyzer '''
+        c = self.con.cursor()
+        try:
+            c.execute("SELECT value FROM settings WHERE name = 'format'")
+        except sqlite3.OperationalError:
+            return 'sqlite'
+        row = c.fetchone()
+        return row[0] if row is not None else 'sqlite'
+
+    def _load_columnar_tables(self, directory):
+        '''
+        Load the tables written in columnar files into temporary tables,
+        which hide the empty tables of the database
+        '''
+        for table in COLUMNAR_TABLES:
+            c = self.con.cursor()
+            c.execute('PRAGMA table_info(%s)' % table)
+            num_columns = len(c.fetchall())
+            columns = [read_column(os.path.join(directory,
+                                                '%s.%d' % (table, i)))
+                       for i in range(num_columns)]
+            c.execute('CREATE TEMP TABLE %s AS SELECT * FROM main.%s WHERE 0'
+                      % (table, table))
+            c.executemany('INSERT INTO temp.%s VALUES (%s)'
+                          % (table, ','.join('?' * num_columns)),
+                          zip(*columns))
+        self.con.commit()
+
     def close(self):
         self.con.close()
 
+    def reload(self):
+        '''
+        Drop the cached tables, so that the next accesses read the rows
+        written since, e.g by ikos-analyzer -live-db
+        '''
+        for name in ('files', 'functions', 'statements', 'operands',
+                     'call_contexts', 'memory_locations'):
+            self.__dict__.pop(name, None)
+
     def load_settings(self):
         ''' Load the analysis settings from the database '''
         c = self.con.cursor()
@@ -105,12 +157,125 @@ class OutputDatabase(object):
         c.execute('SELECT pass, time FROM times %s %s' % (where, order_by))
         return c.fetchall()
 
+    def load_phase_results(self, full=True, sort=True):
+        '''
+        Load the timing and memory results from the database,
+        as a list of tuples (pass, elapsed, peak_rss)
+
+        The peak resident set size is in bytes, or None if unknown.
+        '''
+        c = self.con.cursor()
+        where = "WHERE pass NOT LIKE '%ikos-analyzer.%'" if not full else ''
+        order_by = 'ORDER BY pass' if sort else ''
+        try:
+            c.execute('SELECT pass, time, peak_rss FROM times %s %s'
+                      % (where, order_by))
+        except sqlite3.OperationalError:
+            # Database generated by an older version
+            return [(name, elapsed, None)
+                    for name, elapsed in self.load_timing_results(full, sort)]
+        return c.fetchall()
+
+    def load_phase_counters(self):
+        '''
+        Load the hardware performance counters from the database,
+        as a list of tuples (pass, instructions, cycles, llc_misses,
+        branch_misses)
+
+        Passes without counters (see ikos-analyzer -perf-counters) are
+        omitted.
+        '''
+        c = self.con.cursor()
+        try:
+            c.execute('SELECT pass, instructions, cycles, llc_misses, '
+                      'branch_misses FROM times WHERE instructions NOT NULL')
+        except sqlite3.OperationalError:
+            # Database generated by an older version
+            return []
+        return c.fetchall()
+
+    def load_phase_allocations(self):
+        '''
+        Load the allocation statistics from the database,
+        as a list of tuples (pass, allocated_bytes, allocations, live_bytes)
+
+        Passes without statistics (see ikos-analyzer -allocation-stats) are
+        omitted.
+        '''
+        c = self.con.cursor()
+        try:
+            c.execute('SELECT pass, allocated_bytes, allocations, live_bytes '
+                      'FROM times WHERE allocations NOT NULL')
+        except sqlite3.OperationalError:
+            # Database generated by an older version
+            return []
+        return c.fetchall()
+
     def insert_timing_results(self, rows):
         ''' Insert the timing results into the database '''
         c = self.con.cursor()
-        c.executemany('INSERT INTO times VALUES (?, ?)', rows)
+        c.executemany('INSERT INTO times (pass, time) VALUES (?, ?)', rows)
         self.con.commit()
 
+    def load_budgets(self):
+        '''
+        Load the analyses that ran out of budget,
+        as a list of Budget objects
+        '''
+        c = self.con.cursor()
+        try:
+            c.execute('SELECT * FROM budgets')
+        except sqlite3.OperationalError:
+            # Database generated by an older version
+            return []
+        return [Budget(row, self) for row in c]
+
+    def load_fixpoints(self, limit=None):
+        '''
+        Load the statistics on the fixpoint iterations on loops,
+        as a list of Fixpoint objects, most expensive first
+        '''
+        c = self.con.cursor()
+        query = 'SELECT * FROM fixpoints ORDER BY time DESC'
+        if limit is not None:
+            query += ' LIMIT %d' % limit
+        try:
+            c.execute(query)
+        except sqlite3.OperationalError:
+            # Database generated by an older version
+            return []
+        return [Fixpoint(row, self) for row in c]
+
+    def load_transfer_functions(self):
+        '''
+        Load the statistics on the transfer functions,
+        as a list of TransferFunctions objects
+        '''
+        c = self.con.cursor()
+        try:
+            c.execute('SELECT * FROM transfer_functions')
+        except sqlite3.OperationalError:
+            # Database generated by an older version
+            return []
+        return [TransferFunctions(row, self) for row in c]
+
+    def load_state_sizes(self, limit=None):
+        '''
+        Load the statistics on the sizes of the abstract states,
+        as a list of StateSize objects, largest first
+        '''
+        c = self.con.cursor()
+        query = ('SELECT * FROM state_sizes '
+                 'ORDER BY peak_cells DESC, peak_points_to DESC')
+        if limit is not None:
+            query += ' LIMIT %d' % limit
+        try:
+            c.execute(query)
+        except sqlite3.OperationalError:
+            # Database generated by an older version
+            return []
+        return [StateSize(row, self) for row in c]
+
     @CachedProperty
     def files(self):
         return self._fetch_table('files', File)
@@ -141,6 +306,98 @@ class OutputDatabase(object):
         return [klass(row, self) for row in c]
 
 
+# Tables written in columnar files by ikos-analyzer -format=columnar
+COLUMNAR_TABLES = ('checks', 'statements', 'operands', 'call_contexts')
+
+# Tags of the values in columnar files
+TAG_NULL = 0
+TAG_INTEGER = 1
+TAG_REAL = 2
+TAG_TEXT = 3
+TAG_BLOB = 4
+
+
+def decode_operands(value):
+    '''
+    Return the list of (operand number, operand id) of a check
+
+    Operands are encoded as pairs of unsigned LEB128 integers (operand
+    number + 1, operand id), where the operand number is -1 if the operand is
+    not an operand of the statement. Databases written by older versions of
+    ikos-analyzer use a JSON list of pairs.
+    '''
+    if isinstance(value, type(u'')):
+        return [tuple(pair) for pair in json.loads(value)]
+
+    data = bytearray(value)
+    numbers = []
+    n = 0
+    shift = 0
+    for byte in data:
+        n |= (byte & 0x7f) << shift
+        shift += 7
+        if byte < 0x80:
+            numbers.append(n)
+            n = 0
+            shift = 0
+    return [(numbers[i] - 1, numbers[i + 1])
+            for i in range(0, len(numbers), 2)]
+
+
+def encode_operands(operands):
+    ''' Encode a list of (operand number, operand id), see decode_operands '''
+    data = bytearray()
+    for num, id in operands:
+        for n in (num + 1, id):
+            while n >= 0x80:
+                data.append((n & 0x7f) | 0x80)
+                n >>= 7
+            data.append(n)
+    return sqlite3.Binary(bytes(data))
+
+
+def map_file(path):
+    ''' Map a file in memory, read-only '''
+    with open(path, 'rb') as f:
+        if os.fstat(f.fileno()).st_size == 0:
+            return b''
+        return mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+
+def read_column(prefix):
+    '''
+    Read a column written in columnar files, as a list of values
+
+    See ikos/analyzer/database/columnar.hpp for the file format.
+    '''
+    tags = bytearray(map_file(prefix + '.tag'))
+    values = map_file(prefix + '.val')
+    texts = map_file(prefix + '.txt')
+
+    column = []
+    for i, tag in enumerate(tags):
+        if tag == TAG_NULL:
+            column.append(None)
+        elif tag == TAG_INTEGER:
+            column.append(struct.unpack_from('<q', values, 8 * i)[0])
+        elif tag == TAG_REAL:
+            column.append(struct.unpack_from('<d', values, 8 * i)[0])
+        elif tag == TAG_TEXT:
+            offset = struct.unpack_from('<Q', values, 8 * i)[0]
+            size = struct.unpack_from('<I', texts, offset)[0]
+            text = texts[offset + 4:offset + 4 + size]
+            if str is not bytes:
+                text = text.decode('utf-8')
+            column.append(text)
+        elif tag == TAG_BLOB:
+            offset = struct.unpack_from('<Q', values, 8 * i)[0]
+            size = struct.unpack_from('<I', texts, offset)[0]
+            column.append(sqlite3.Binary(texts[offset + 4:offset + 4 + size]))
+        else:
+            raise ValueError('%s: invalid tag %d' % (prefix, tag))
+    return column
+
+
 class File(object):
     ''' Represents a source file '''
 
@@ -161,6 +418,7 @@ class Function(object):
         'definition',
         'file_id',
         'line',
+        'hash',
         'db'
     )
 
@@ -171,6 +429,7 @@ class Function(object):
         self.definition = (row[FunctionsTable.DEFINITION] == 1)
         self.file_id = row[FunctionsTable.FILE_ID]  # or None
         self.line = row[FunctionsTable.LINE]  # or None
+        self.hash = row[FunctionsTable.HASH]  # structural hash
         self.db = db
 
     def pretty_name(self):
@@ -385,6 +644,159 @@ class Check(object):
         if not self.operands:
             return None
 
-        operands = json.loads(self.operands)
         return [NumOperandPair(num, self.db.operands[id])
-                for num, id in operands]
+                for num, id in decode_operands(self.operands)]
+
+
+class Budget(object):
+    ''' Represents an analysis that ran out of budget '''
+
+    __slots__ = (
+        'function_id',
+        'call_context_id',
+        'kind',
+        'time',
+        'steps',
+        'db'
+    )
+
+    def __init__(self, row, db):
+        self.function_id = row[BudgetsTable.FUNCTION_ID]
+        self.call_context_id = row[BudgetsTable.CALL_CONTEXT_ID]
+        self.kind = row[BudgetsTable.KIND]  # 'time', 'steps' or 'memory'
+        self.time = row[BudgetsTable.TIME]
+        self.steps = row[BudgetsTable.STEPS]
+        self.db = db
+
+    def function(self):
+        ''' Return the function '''
+        return self.db.functions[self.function_id]
+
+    def call_context(self):
+        ''' Return the call context '''
+        return self.db.call_contexts[self.call_context_id]
+
+
+class Fixpoint(object):
+    ''' Represents the fixpoint iterations on a loop '''
+
+    __slots__ = (
+        'function_id',
+        'statement_id',
+        'call_context_id',
+        'increasing_iterations',
+        'widenings',
+        'narrowings',
+        'time',
+        'peak_size',
+        'copies',
+        'analyzed_nodes',
+        'reused_nodes',
+        'skipped_narrowings',
+        'db'
+    )
+
+    def __init__(self, row, db):
+        self.function_id = row[FixpointsTable.FUNCTION_ID]
+        self.statement_id = row[FixpointsTable.STATEMENT_ID]  # or None
+        self.call_context_id = row[FixpointsTable.CALL_CONTEXT_ID]
+        self.increasing_iterations = row[FixpointsTable.INCREASING_ITERATIONS]
+        self.widenings = row[FixpointsTable.WIDENINGS]
+        self.narrowings = row[FixpointsTable.NARROWINGS]
+        self.time = row[FixpointsTable.TIME]
+        self.peak_size = row[FixpointsTable.PEAK_SIZE]
+        # Databases generated by an older version have no copies column
+        self.copies = (row[FixpointsTable.COPIES]
+                       if len(row) > FixpointsTable.COPIES else 0)
+        self.analyzed_nodes = (row[FixpointsTable.ANALYZED_NODES]
+                               if len(row) > FixpointsTable.ANALYZED_NODES
+                               else 0)
+        self.reused_nodes = (row[FixpointsTable.REUSED_NODES]
+                             if len(row) > FixpointsTable.REUSED_NODES else 0)
+        self.skipped_narrowings = (
+            row[FixpointsTable.SKIPPED_NARROWINGS]
+            if len(row) > FixpointsTable.SKIPPED_NARROWINGS else 0)
+        self.db = db
+
+    def function(self):
+        ''' Return the function '''
+        return self.db.functions[self.function_id]
+
+    def statement(self):
+        ''' Return the first statement of the loop head, or None '''
+        if self.statement_id is None:
+            return None
+        return self.db.statements[self.statement_id]
+
+    def call_context(self):
+        ''' Return the call context '''
+        return self.db.call_contexts[self.call_context_id]
+
+
+class TransferFunctions(object):
+    ''' Represents the transfer functions of a statement kind in a function '''
+
+    __slots__ = (
+        'function_id',
+        'call_context_id',
+        'kind',
+        'count',
+        'time',
+        'db'
+    )
+
+    def __init__(self, row, db):
+        self.function_id = row[TransferFunctionsTable.FUNCTION_ID]
+        self.call_context_id = row[TransferFunctionsTable.CALL_CONTEXT_ID]
+        self.kind = row[TransferFunctionsTable.KIND]
+        self.count = row[TransferFunctionsTable.COUNT]
+        self.time = row[TransferFunctionsTable.TIME]
+        self.db = db
+
+    def function(self):
+        ''' Return the function '''
+        return self.db.functions[self.function_id]
+
+    def call_context(self):
+        ''' Return the call context '''
+        return self.db.call_contexts[self.call_context_id]
+
+
+class StateSize(object):
+    ''' Represents the peak sizes of the abstract states of a function '''
+
+    __slots__ = (
+        'function_id',
+        'call_context_id',
+        'samples',
+        'peak_cells',
+        'peak_points_to',
+        'peak_nodes',
+        'peak_pack_size',
+        'dropped_relations',
+        'db'
+    )
+
+    def __init__(self, row, db):
+        self.function_id = row[StateSizesTable.FUNCTION_ID]
+        self.call_context_id = row[StateSizesTable.CALL_CONTEXT_ID]
+        self.samples = row[StateSizesTable.SAMPLES]
+        self.peak_cells = row[StateSizesTable.PEAK_CELLS]
+        self.peak_points_to = row[StateSizesTable.PEAK_POINTS_TO]
+        self.peak_nodes = row[StateSizesTable.PEAK_NODES]
+        if len(row) > StateSizesTable.DROPPED_RELATIONS:
+            self.peak_pack_size = row[StateSizesTable.PEAK_PACK_SIZE]
+            self.dropped_relations = row[StateSizesTable.DROPPED_RELATIONS]
+        else:
+            # Database generated by an older version
+            self.peak_pack_size = 0
+            self.dropped_relations = 0
+        self.db = db
+
+    def function(self):
+        ''' Return the function '''
+        return self.db.functions[self.function_id]
+
+    def call_context(self):
+        ''' Return the call context '''
+        return self.db.call_contexts[self.call_context_id]
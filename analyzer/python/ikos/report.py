@@ -46,7 +46,6 @@ import functools
 import io
 import itertools
 import json
-import operator
 import os
 import os.path
 import sqlite3
@@ -62,7 +61,8 @@ from ikos.enums import Result, CheckKind, CheckerName, ValueKind, \
     BufferOverflowCheckKind, ChecksTable
 from ikos.log import printf
 from ikos.output_db import OutputDatabase, File, Function, Statement, \
-    CallContext, Operand, NumOperandPair, MemoryLocation, Check
+    CallContext, Operand, NumOperandPair, MemoryLocation, Check, \
+    decode_operands
 
 
 ##################
@@ -96,6 +96,19 @@ def format_time(elapsed):
     return ' '.join(s)
 
 
+def format_memory(size):
+    ''' Format a memory size, in bytes.
+
+    >>> format_memory(3 * 1024 * 1024 + 512 * 1024)
+    '3.5 MB'
+    >>> format_memory(None)
+    '?'
+    '''
+    if size is None:
+        return '?'
+    return '%.1f MB' % (size / (1024.0 * 1024.0))
+
+
 def print_timing_results(db, full=True, sort=True):
     ''' Print the timing results from the database '''
     results = db.load_timing_results(full, sort)
@@ -106,58 +119,263 @@ def print_timing_results(db, full=True, sort=True):
         printf('%s: %s\n', name.ljust(name_width), format_time(elapsed))
 
 
-###########
-# summary #
-###########
-
-
-# Represents a check, as a hashable type
-CheckTuple = collections.namedtuple('CheckTuple', ('kind', 'operands', 'info'))
+def print_top_loops(db, n):
+    ''' Print the n most expensive loops from the database '''
+    fixpoints = db.load_fixpoints(limit=n)
 
+    printf(bold('# Top %d loops:') + '\n', n)
+    if not fixpoints:
+        printf('No loop statistics, use ikos --fixpoint-stats\n')
+        return
 
-def generate_statement_result(checks, keep_oks=True, keep_checkers=True):
+    for fixpoint in fixpoints:
+        statement = fixpoint.statement()
+        if statement is not None and statement.file_path() is not None:
+            location = '%s:%s' % (format_path(statement.file_path()),
+                                  statement.line_or('?'))
+        else:
+            location = '?'
+        call_context = fixpoint.call_context()
+        printf('%s: %s in %s%s\n',
+               format_time(fixpoint.time),
+               location,
+               fixpoint.function().pretty_name(),
+               ' (context: %s)' % call_context.str()
+               if not call_context.empty() else '')
+        printf('  %d increasing iterations, %d widenings, %d narrowings '
+               '(%d skipped), peak invariant size %d, %d invariant copies\n',
+               fixpoint.increasing_iterations,
+               fixpoint.widenings,
+               fixpoint.narrowings,
+               fixpoint.skipped_narrowings,
+               fixpoint.peak_size,
+               fixpoint.copies)
+        blocks = fixpoint.analyzed_nodes + fixpoint.reused_nodes
+        if blocks > 0:
+            printf('  %d basic blocks analyzed, %d reused (%.1f%% hit rate)\n',
+                   fixpoint.analyzed_nodes,
+                   fixpoint.reused_nodes,
+                   100.0 * fixpoint.reused_nodes / blocks)
+
+
+def print_top_transfer_functions(db, n):
     '''
-    Generate a result for a list of checks on a specific statement
-    and call context
+    Print the time spent in transfer functions per statement kind, and the n
+    functions spending the most time in transfer functions
     '''
-    result = Result.OK
-    errors = set()
-    warnings = set()
-    oks = set() if keep_oks else None
-    checkers = set() if keep_checkers else None
-
-    for check in checks:
-        if keep_checkers:
-            checkers.add(check[ChecksTable.CHECKER])
-
-        status = check[ChecksTable.STATUS]
+    transfers = db.load_transfer_functions()
+
+    printf(bold('# Transfer functions:') + '\n')
+    if not transfers:
+        printf('No transfer function statistics, use ikos --transfer-stats\n')
+        return
+
+    # Aggregate per statement kind and per function
+    kinds = collections.defaultdict(lambda: [0, 0.0])
+    functions = collections.defaultdict(
+        lambda: collections.defaultdict(lambda: [0, 0.0]))
+    for transfer in transfers:
+        for counters in (kinds[transfer.kind],
+                         functions[transfer.function_id][transfer.kind]):
+            counters[0] += transfer.count
+            counters[1] += transfer.time
+
+    total = sum(time for _, time in kinds.values()) or 1.0
+    name_width = max(len(kind) for kind in kinds)
+    for kind, (count, time) in sorted(kinds.items(),
+                                      key=lambda item: -item[1][1]):
+        printf('%s: %s (%.1f%%), %d executions\n',
+               kind.ljust(name_width),
+               format_time(time),
+               100.0 * time / total,
+               count)
+
+    printf('\n')
+    printf(bold('# Top %d functions:') + '\n', n)
+    ranking = sorted(functions.items(),
+                     key=lambda item: -sum(t for _, t in item[1].values()))
+    for function_id, function_kinds in ranking[:n]:
+        printf('%s: %s\n',
+               format_time(sum(t for _, t in function_kinds.values())),
+               db.functions[function_id].pretty_name())
+        printf('  %s\n',
+               ', '.join('%s %s (%d)' % (kind, format_time(time), count)
+                         for kind, (count, time)
+                         in sorted(function_kinds.items(),
+                                   key=lambda item: -item[1][1])))
+
+
+def print_top_offenders(db, n, settings):
+    '''
+    Print the n most expensive functions, call contexts, loops and checkers,
+    ranked by time and memory, with suggestions to speed up the analysis
+    '''
+    times = db.load_phase_results(full=True, sort=False)
+    transfers = db.load_transfer_functions()
+    sizes = db.load_state_sizes()
+    fixpoints = db.load_fixpoints(limit=n)
+    budgets = db.load_budgets()
+    suggestions = []
+
+    def function_location(function_id, call_context_id):
+        call_context = db.call_contexts[call_context_id]
+        return '%s%s' % (db.functions[function_id].pretty_name(),
+                         ' (context: %s)' % call_context.str()
+                         if not call_context.empty() else '')
+
+    # Time spent in transfer functions, per function and call context
+    contexts = collections.defaultdict(float)
+    for transfer in transfers:
+        contexts[(transfer.function_id, transfer.call_context_id)] += \
+            transfer.time
+    functions = collections.defaultdict(lambda: [0.0, 0])
+    for (function_id, _), time in contexts.items():
+        functions[function_id][0] += time
+        functions[function_id][1] += 1
+    total = sum(contexts.values()) or 1.0
+
+    printf(bold('# Top %d functions:') + '\n', n)
+    if not transfers:
+        printf('No function statistics, use ikos --transfer-stats\n')
+    ranking = sorted(functions.items(), key=lambda item: -item[1][0])
+    for function_id, (time, num_contexts) in ranking[:n]:
+        printf('%s (%.1f%%): %s, %d calling contexts\n',
+               format_time(time),
+               100.0 * time / total,
+               db.functions[function_id].pretty_name(),
+               num_contexts)
+
+    # Functions re-analyzed in many contexts are worth summarizing
+    for function_id, (time, num_contexts) in ranking:
+        if num_contexts >= 5 and time >= 0.1 * total:
+            suggestions.append(
+                '%s is analyzed in %d calling contexts (%s): it is a good '
+                'candidate for summarization, e.g. with a stub or a lower '
+                '--context-depth' % (db.functions[function_id].pretty_name(),
+                                     num_contexts,
+                                     format_time(time)))
+
+    printf('\n' + bold('# Top %d call contexts:') + '\n', n)
+    if not transfers:
+        printf('No call context statistics, use ikos --transfer-stats\n')
+    for (function_id, call_context_id), time in sorted(
+            contexts.items(), key=lambda item: -item[1])[:n]:
+        printf('%s: %s\n',
+               format_time(time),
+               function_location(function_id, call_context_id))
+
+    printf('\n' + bold('# Top %d loops:') + '\n', n)
+    if not fixpoints:
+        printf('No loop statistics, use ikos --fixpoint-stats\n')
+    for fixpoint in fixpoints:
+        statement = fixpoint.statement()
+        if statement is not None and statement.file_path() is not None:
+            location = '%s:%s' % (format_path(statement.file_path()),
+                                  statement.line_or('?'))
+        else:
+            location = '?'
+        printf('%s: %s in %s, %d widenings\n',
+               format_time(fixpoint.time),
+               location,
+               fixpoint.function().pretty_name(),
+               fixpoint.widenings)
+
+        # Loops widened many times converge faster with a threshold
+        if fixpoint.widenings >= 3:
+            suggestions.append(
+                'loop at %s in %s needs %d widenings: a constant loop bound '
+                'gives a widening hint to the fixpoint profiles (do not use '
+                '--no-fixpoint-profiles)' % (location,
+                                            fixpoint.function().pretty_name(),
+                                            fixpoint.widenings))
+
+    checker_prefix = 'ikos-analyzer.checker.'
+    checkers = sorted(((name[len(checker_prefix):], time)
+                       for name, time, _ in times
+                       if name.startswith(checker_prefix)),
+                      key=lambda item: -item[1])
+    printf('\n' + bold('# Top %d checkers:') + '\n', n)
+    for name, time in checkers[:n]:
+        printf('%s: %s\n', format_time(time), name)
+
+    printf('\n' + bold('# Top %d phases by memory:') + '\n', n)
+    phases = sorted((phase for phase in times if phase[2] is not None),
+                    key=lambda phase: -phase[2])
+    if not phases:
+        printf('No memory statistics\n')
+    for name, time, peak_rss in phases[:n]:
+        printf('%s: %s (%s)\n', format_memory(peak_rss), name,
+               format_time(time))
+
+    printf('\n' + bold('# Top %d abstract states:') + '\n', n)
+    if not sizes:
+        printf('No abstract state statistics, use ikos --state-stats\n')
+    for size in sizes[:n]:
+        printf('%d cells, %d points-to: %s\n',
+               size.peak_cells,
+               size.peak_points_to,
+               function_location(size.function_id, size.call_context_id))
+
+    # Entry points analyzed with initialized global variables
+    if settings.get('globals-init-policy', 'none') != 'none':
+        no_init_globals = settings.get('no-init-globals') or []
+        value_prefix = 'ikos-analyzer.value.'
+        for name in settings.get('entry-points') or []:
+            if name == 'main' or name in no_init_globals:
+                continue
+            time = sum(t for phase, t, _ in times
+                       if phase == value_prefix + name)
+            if time > 0:
+                suggestions.append(
+                    'entry point %s is analyzed with initialized global '
+                    'variables (%s): if it does not rely on their initial '
+                    'values, use --no-init-globals=%s' % (name,
+                                                          format_time(time),
+                                                          name))
+
+    for budget in budgets:
+        option = {'time': '--function-timeout',
+                  'steps': '--function-max-steps',
+                  'memory': '--soft-mem'}.get(budget.kind)
+        suggestions.append(
+            '%s ran out of its %s budget%s' % (
+                function_location(budget.function_id,
+                                   budget.call_context_id),
+                budget.kind,
+                ': increase %s' % option if option is not None else ''))
+
+    printf('\n' + bold('# Suggestions:') + '\n')
+    if not suggestions:
+        printf('None\n')
+    for suggestion in suggestions:
+        printf('* %s\n', suggestion)
 
-        if status == Result.UNREACHABLE:
-            result = Result.UNREACHABLE
 
-            if keep_checkers:
-                continue  # keep iterating
-            else:
-                break  # exit early
+###########
+# summary #
+###########
 
-        check = CheckTuple(check[ChecksTable.KIND],
-                           check[ChecksTable.OPERANDS],
-                           check[ChecksTable.INFO])
 
-        if status == Result.ERROR:
-            result = Result.ERROR
-            errors.add(check)
-        elif status == Result.WARNING:
-            if result == Result.OK:
-                result = Result.WARNING
-            warnings.add(check)
-        elif status == Result.OK:
-            if keep_oks:
-                oks.add(check)
-        else:
-            assert False, 'unexpected status'
+def contexts_query(where=''):
+    '''
+    Return a SQL query aggregating the checks per statement and calling
+    context.
 
-    return result, errors, warnings, oks, checkers
+    Each row contains the statement id, the call context id, and whether the
+    statement is unreachable, has an error or a warning in that calling
+    context, and whether a check comes from the dead code checker.
+    '''
+    return ('SELECT statement_id, call_context_id, '
+            'MAX(status=%d) AS unreachable, '
+            'MAX(status=%d) AS error, '
+            'MAX(status=%d) AS warning, '
+            'MAX(checker=%d) AS dead_code '
+            'FROM checks %s '
+            'GROUP BY statement_id, call_context_id') % (Result.UNREACHABLE,
+                                                         Result.ERROR,
+                                                         Result.WARNING,
+                                                         CheckerName.DEAD_CODE,
+                                                         where)
 
 
 class Summary:
@@ -178,53 +396,60 @@ def generate_summary(db):
     '''
     Return the analysis summary: number of errors, warnings, ok and
     unreachable per checked statements.
+
+    The summary is read from the summary tables if they are up-to-date (see
+    finalize()). Otherwise, the aggregation is done by the database, per
+    statement and calling context.
     '''
-    summary = Summary(ok=0, error=0, warning=0, unreachable=0)
+    if summary_up_to_date(db):
+        c = db.con.cursor()
+        c.execute('SELECT ok, error, warning, unreachable '
+                  'FROM summary_totals')
+        ok, error, warning, unreachable = c.fetchone()
+        c.close()
+        return Summary(ok=ok,
+                       error=error,
+                       warning=warning,
+                       unreachable=unreachable)
 
-    c = db.con.cursor()
-    order_by = 'statement_id, call_context_id'
-    c.execute('SELECT * FROM checks ORDER BY %s' % order_by)
+    return Summary(*summary_query(db))
 
-    stmt_id_key = operator.itemgetter(ChecksTable.STATEMENT_ID)
-    context_id_key = operator.itemgetter(ChecksTable.CALL_CONTEXT_ID)
-
-    for statement_id, statement_checks in itertools.groupby(c,
-                                                            key=stmt_id_key):
-        # Iterate over the checks for statement = statement_id
-        statement_results = set()
-        statement_checkers = set()
-        statement_errors = set()
-        statement_warnings = set()
-
-        for context_id, checks in itertools.groupby(statement_checks,
-                                                    key=context_id_key):
-            # Iterate over the checks for statement = statement_id
-            # and context = context_id
-            result, errors, warnings, _, checkers = \
-                generate_statement_result(checks,
-                                          keep_oks=False,
-                                          keep_checkers=True)
-            statement_results.add(result)
-            statement_checkers.update(checkers)
-            statement_errors.update(errors)
-            statement_warnings.update(warnings)
-
-        if statement_results == {Result.UNREACHABLE}:
-            # Statement is unreachable for all the calling contexts,
-            # check that it comes from dca
-            if CheckerName.DEAD_CODE in statement_checkers:
-                # Statement is never reachable
-                summary.unreachable += 1
-        else:
-            if Result.OK in statement_results:
-                # Some paths are safe
-                summary.ok += 1
 
-            summary.error += len(statement_errors)
-            summary.warning += len(statement_warnings)
+def summary_query(db):
+    '''
+    Compute the analysis summary from the checks
 
+    Return a tuple (ok, error, warning, unreachable).
+    '''
+    # Number of distinct checks with the given status on reachable contexts
+    distinct_checks = ('SELECT COUNT(*) FROM ('
+                       'SELECT DISTINCT c.statement_id, c.kind, '
+                       'c.operands, c.info '
+                       'FROM checks c JOIN contexts x '
+                       'ON c.statement_id = x.statement_id '
+                       'AND c.call_context_id = x.call_context_id '
+                       'WHERE x.unreachable = 0 AND c.status = %d)')
+
+    c = db.con.cursor()
+    c.execute(
+        'WITH contexts AS (%s), '
+        'statements_status AS ('
+        'SELECT MIN(unreachable) AS unreachable, '
+        'MAX(dead_code) AS dead_code, '
+        'MAX(unreachable = 0 AND error = 0 AND warning = 0) AS ok '
+        'FROM contexts GROUP BY statement_id) '
+        'SELECT '
+        '(SELECT COUNT(*) FROM statements_status '
+        'WHERE unreachable = 1 AND dead_code = 1), '
+        '(SELECT COUNT(*) FROM statements_status '
+        'WHERE unreachable = 0 AND ok = 1), '
+        '(%s), (%s)' % (contexts_query(),
+                        distinct_checks % Result.ERROR,
+                        distinct_checks % Result.WARNING))
+    unreachable, ok, error, warning = c.fetchone()
     c.close()
-    return summary
+
+    return ok, error, warning, unreachable
 
 
 def print_summary(db, full=True):
@@ -254,6 +479,19 @@ def print_summary(db, full=True):
                else '0')
         printf('\n')
 
+    budgets = db.load_budgets()
+    if budgets:
+        printf(bold_yellow('%d function analyses ran out of budget, '
+                           'their results are imprecise:') + '\n',
+               len(budgets))
+        for budget in budgets:
+            printf('  %s (%s budget, %d steps, %s)\n',
+                   budget.function().pretty_name(),
+                   budget.kind,
+                   budget.steps,
+                   format_time(budget.time))
+        printf('\n')
+
     if summary.error == 0 and summary.warning == 0:
         printf(bold_green('The program is SAFE') + '\n')
     else:
@@ -393,20 +631,125 @@ def print_raw_checks(db, interprocedural):
 
 
 class Report:
-    ''' Represents an analysis report '''
+    '''
+    Represents an analysis report
 
-    def __init__(self, db):
+    The statement reports are computed by the database and streamed: iterating
+    over the report executes a query yielding one StatementReport per row.
+    '''
+
+    def __init__(self,
+                 db,
+                 checks_where='',
+                 contexts_where='',
+                 display_unreachables=True):
+        '''
+        Arguments:
+            db(OutputDatabase): output database
+            checks_where(str): SQL condition on the reported checks
+            contexts_where(str): SQL condition on the checks used to compute
+                the reachability of each calling context
+            display_unreachables(bool): report unreachable statements
+        '''
         self.db = db
-        self.statement_reports = []
+        self.checks_where = checks_where
+        self.contexts_where = contexts_where
+        self.display_unreachables = display_unreachables
 
-    def append(self, statement_report):
-        self.statement_reports.append(statement_report)
+    def query(self):
+        '''
+        Return the SQL query computing the statement reports
+
+        Unfiltered reports are read from the summary tables if they are
+        up-to-date (see finalize()).
+        '''
+        if (not self.checks_where and not self.contexts_where and
+                self.display_unreachables and summary_up_to_date(self.db)):
+            return ('SELECT kind, status, statement_id, call_context_ids, '
+                    'operands, info FROM summary_reports')
+
+        return self.checks_query()
+
+    def checks_query(self):
+        ''' Return the SQL query computing the reports from the checks '''
+        checks_where = ''
+        if self.checks_where:
+            checks_where = 'AND (%s)' % self.checks_where
+
+        contexts_where = ''
+        if self.contexts_where:
+            contexts_where = 'WHERE %s' % self.contexts_where
+
+        # Checks on calling contexts where the statement is reachable
+        query = ('SELECT c.kind AS kind, '
+                 'c.status AS status, '
+                 'c.statement_id AS statement_id, '
+                 'GROUP_CONCAT(DISTINCT c.call_context_id) '
+                 'AS call_context_ids, '
+                 'c.operands AS operands, '
+                 'c.info AS info '
+                 'FROM checks c JOIN contexts x '
+                 'ON c.statement_id = x.statement_id '
+                 'AND c.call_context_id = x.call_context_id '
+                 'WHERE x.unreachable = 0 %s '
+                 'GROUP BY c.statement_id, c.status, c.kind, '
+                 'c.operands, c.info') % checks_where
+
+        if self.display_unreachables:
+            # Statements unreachable for all the calling contexts,
+            # according to the dead code checker
+            query += (' UNION ALL '
+                      'SELECT %d, %d, statement_id, '
+                      'GROUP_CONCAT(call_context_id), NULL, NULL '
+                      'FROM contexts GROUP BY statement_id '
+                      'HAVING MIN(unreachable) = 1 '
+                      'AND MAX(dead_code) = 1') % (CheckKind.UNREACHABLE,
+                                                   Result.UNREACHABLE)
+
+        return 'WITH contexts AS (%s) %s' % (contexts_query(contexts_where),
+                                             query)
+
+    def iterate(self, order_by='r.statement_id, r.status DESC, r.kind'):
+        '''
+        Yield the statement reports
+
+        Arguments:
+            order_by(str): SQL ordering clause, where `r` is the report row
+                and `s` is the statement
+        '''
+        c = self.db.con.cursor()
+        try:
+            c.execute('SELECT r.* FROM (%s) r '
+                      'LEFT JOIN statements s ON s.id = r.statement_id '
+                      'ORDER BY %s' % (self.query(), order_by))
+
+            for kind, status, statement_id, context_ids, operands, info in c:
+                yield StatementReport(
+                    db=self.db,
+                    kind=kind,
+                    status=status,
+                    statement_id=statement_id,
+                    call_context_ids=sorted(map(int, context_ids.split(','))),
+                    operands=operands,
+                    info=info)
+        finally:
+            c.close()
+
+    def __iter__(self):
+        return self.iterate()
+
+    def __len__(self):
+        c = self.db.con.cursor()
+        c.execute('SELECT COUNT(*) FROM (%s)' % self.query())
+        n, = c.fetchone()
+        c.close()
+        return n
 
     def __repr__(self):
-        if not self.statement_reports:
+        lines = ',\n'.join(map(repr, self))
+        if not lines:
             return 'Report([])'
 
-        lines = ',\n'.join(map(repr, self.statement_reports))
         return 'Report([\n%s\n])' % lines
 
 
@@ -440,9 +783,8 @@ class StatementReport:
         if not self.operands:
             return None
 
-        operands = json.loads(self.operands)
         return [NumOperandPair(no, self.db.operands[id])
-                for no, id in operands]
+                for no, id in decode_operands(self.operands)]
 
     def load_info(self):
         ''' Return the info, or None '''
@@ -471,12 +813,13 @@ def generate_report(db, status_filter=None, analyses_filter=None):
     '''
     Generate an analysis report.
 
+    The report is lazy: statement reports are computed by the database when
+    iterating over it.
+
     Arguments:
         status_filter(list): List of status, or None
         analyses_filter(list): List of checkers, or None
     '''
-    report = Report(db)
-
     # Parse filters
     if status_filter is not None:
         status_filter = tuple(map(Result.from_str, status_filter))
@@ -511,94 +854,117 @@ def generate_report(db, status_filter=None, analyses_filter=None):
                                      for checker in analyses_filter))
 
     where = ' AND '.join('(%s)' % clause for clause in where)
+    contexts_where = where
 
     if display_unreachables and not display_oks:
         # Only show unreachable statements if the statement is unreachable for
         # all calling contexts. To detect this, we need to make sure to get all
         # checks from the DeadCodeChecker, especially 'ok' checks.
-        where = '(%s) OR (checker=%d)' % (where, CheckerName.DEAD_CODE)
+        contexts_where = '(%s) OR (checker=%d)' % (where,
+                                                   CheckerName.DEAD_CODE)
 
-    if where:
-        where = 'WHERE %s' % where
+    return Report(db,
+                  checks_where=where,
+                  contexts_where=contexts_where,
+                  display_unreachables=display_unreachables)
 
-    order_by = 'ORDER BY statement_id, call_context_id'
 
-    # Execute query
+##################
+# summary tables #
+##################
+
+# Version of the layout of the summary tables, bump it when changing them
+SUMMARY_VERSION = 1
+
+
+def summary_key(db):
+    ''' Return a key identifying the analysis results '''
     c = db.con.cursor()
-    c.execute('SELECT * FROM checks %s %s' % (where, order_by))
-
-    stmt_id_key = operator.itemgetter(ChecksTable.STATEMENT_ID)
-    context_id_key = operator.itemgetter(ChecksTable.CALL_CONTEXT_ID)
-
-    for statement_id, statement_checks in itertools.groupby(c,
-                                                            key=stmt_id_key):
-        # Iterate over the checks for statement = statement_id
-        statement_results = set()
-        statement_context_ids = list()
-        statement_checkers = set()
-        statement_errors = collections.defaultdict(list)
-        statement_warnings = collections.defaultdict(list)
-        statement_oks = collections.defaultdict(list)
-
-        for context_id, checks in itertools.groupby(statement_checks,
-                                                    key=context_id_key):
-            # Iterate over the checks for statement = statement_id
-            # and context = context_id
-            result, errors, warnings, oks, checkers = \
-                generate_statement_result(checks,
-                                          keep_oks=display_oks,
-                                          keep_checkers=display_unreachables)
-            statement_results.add(result)
-            statement_context_ids.append(context_id)
-            if display_unreachables:
-                statement_checkers.union(checkers)
-            for error in errors:
-                statement_errors[error].append(context_id)
-            for warning in warnings:
-                statement_warnings[warning].append(context_id)
-            if display_oks:
-                for ok in oks:
-                    statement_oks[ok].append(context_id)
-
-        if statement_results == {Result.UNREACHABLE}:
-            # Statement is unreachable for all the calling contexts,
-            # check that we want unreachable checks and that it comes from dca
-            if display_unreachables and CheckerName.DEAD_CODE in checkers:
-                report.append(StatementReport(
-                    db=db,
-                    kind=CheckKind.UNREACHABLE,
-                    status=Result.UNREACHABLE,
-                    statement_id=statement_id,
-                    call_context_ids=statement_context_ids
-                ))
-        else:
-            for check, context_ids in statement_errors.items():
-                report.append(StatementReport(db=db,
-                                              kind=check.kind,
-                                              status=Result.ERROR,
-                                              statement_id=statement_id,
-                                              call_context_ids=context_ids,
-                                              operands=check.operands,
-                                              info=check.info))
-            for check, context_ids in statement_warnings.items():
-                report.append(StatementReport(db=db,
-                                              kind=check.kind,
-                                              status=Result.WARNING,
-                                              statement_id=statement_id,
-                                              call_context_ids=context_ids,
-                                              operands=check.operands,
-                                              info=check.info))
-            for check, context_ids in statement_oks.items():
-                report.append(StatementReport(db=db,
-                                              kind=check.kind,
-                                              status=Result.OK,
-                                              statement_id=statement_id,
-                                              call_context_ids=context_ids,
-                                              operands=check.operands,
-                                              info=check.info))
+    c.execute('SELECT (SELECT MAX(rowid) FROM checks), '
+              '(SELECT MAX(rowid) FROM statements)')
+    checks, statements = c.fetchone()
+    c.close()
+    return '%d:%s:%s' % (SUMMARY_VERSION, checks, statements)
+
 
+def summary_up_to_date(db):
+    ''' Return True if the summary tables match the analysis results '''
+    c = db.con.cursor()
+    try:
+        c.execute('SELECT key FROM summary_index')
+    except sqlite3.OperationalError:
+        return False  # No summary tables
+
+    row = c.fetchone()
+    c.close()
+    return row is not None and row[0] == summary_key(db)
+
+
+def create_summary_tables(db, schema, key):
+    '''
+    Create the summary tables in the given schema, for the results identified
+    by the given key (see summary_key())
+
+    The tables are:
+        summary_reports: the unfiltered statement reports, with the location
+            of the statement, sorted by file, line and status
+        summary_files: the number of checks per file, status and kind
+        summary_totals: the analysis summary, see generate_summary()
+        summary_index: the key of the results
+    '''
+    c = db.con.cursor()
+    for table in ('summary_reports', 'summary_files', 'summary_totals',
+                  'summary_index'):
+        c.execute('DROP TABLE IF EXISTS %s.%s' % (schema, table))
+
+    rep = Report(db)
+    c.execute('CREATE TABLE %s.summary_reports AS '
+              'SELECT s.file_id AS file_id, s.line AS line, '
+              's."column" AS "column", s.function_id AS function_id, '
+              'r.kind AS kind, r.status AS status, '
+              'r.statement_id AS statement_id, '
+              'r.call_context_ids AS call_context_ids, '
+              'r.operands AS operands, r.info AS info '
+              'FROM (%s) r LEFT JOIN statements s ON s.id = r.statement_id '
+              'ORDER BY s.file_id, s.line, r.status DESC'
+              % (schema, rep.checks_query()))
+    c.execute('CREATE INDEX %s.summary_reports_file_id '
+              'ON summary_reports (file_id)' % schema)
+
+    c.execute('CREATE TABLE %s.summary_files AS '
+              'SELECT file_id, status, kind, COUNT(*) AS count '
+              'FROM %s.summary_reports WHERE file_id IS NOT NULL '
+              'GROUP BY file_id, status, kind' % (schema, schema))
+
+    c.execute('CREATE TABLE %s.summary_totals '
+              '(ok INTEGER, error INTEGER, warning INTEGER, '
+              'unreachable INTEGER)' % schema)
+    c.execute('INSERT INTO %s.summary_totals VALUES (?, ?, ?, ?)' % schema,
+              summary_query(db))
+
+    c.execute('CREATE TABLE %s.summary_index (key TEXT)' % schema)
+    c.execute('INSERT INTO %s.summary_index VALUES (?)' % schema, (key,))
+    db.con.commit()
+    c.close()
+
+
+def finalize(db, vacuum=True):
+    '''
+    Post-process the output database after the analysis
+
+    This materializes the summary tables, used by ikos-report and ikos-view
+    instead of aggregating the checks, then updates the statistics of the
+    query planner and optionally compacts the database.
+    '''
+    if not summary_up_to_date(db):
+        create_summary_tables(db, 'main', summary_key(db))
+
+    c = db.con.cursor()
+    c.execute('ANALYZE')
+    db.con.commit()
+    if vacuum:
+        c.execute('VACUUM')
     c.close()
-    return report
 
 
 ##################
@@ -633,13 +999,16 @@ class TextFormatter(Formatter):
     RESULT_ORDER = [3, 1, 0, 2]
 
     @classmethod
-    def sorting_key(cls, report):
-        statement = report.statement()
-        return (cls.RESULT_ORDER[report.status],
-                statement.file_id_or(-1),
-                statement.line_or(-1),
-                statement.column_or(-1),
-                report.kind)
+    def order_by(cls):
+        ''' Return the SQL ordering clause of the reports '''
+        result_order = ' '.join('WHEN %d THEN %d' % (status, order)
+                                for status, order
+                                in enumerate(cls.RESULT_ORDER))
+        return ('CASE r.status %s END, '
+                'COALESCE(s.file_id, -1), '
+                'COALESCE(s.line, -1), '
+                'COALESCE(s."column", -1), '
+                'r.kind') % result_order
 
     def write_path(self, file):
         printf(bold('%s: '), format_path(file.path) if file else '?',
@@ -739,11 +1108,9 @@ class TextFormatter(Formatter):
             call_context = call_context.parent()
 
     def format(self, report):
-        statement_reports = report.statement_reports
-
-        # Sort reports
-        statement_reports.sort(key=self.sorting_key)
+        self.write_reports(report.iterate(self.order_by()))
 
+    def write_reports(self, statement_reports):
         for statement_report in statement_reports:
             statement = statement_report.statement()
             function = statement.function()
@@ -796,7 +1163,7 @@ class JSONEncoder(json.JSONEncoder):
             'operands': report.db.operands,
             'call_contexts': report.db.call_contexts,
             'memory_locations': report.db.memory_locations,
-            'reports': report.statement_reports,
+            'reports': list(report),
         }
 
     @staticmethod
@@ -873,8 +1240,24 @@ class JSONFormatter(Formatter):
     ''' JSON output formatter '''
 
     def format(self, report):
-        json.dump(report, self.output, cls=JSONEncoder)
-        self.output.write('\n')
+        encoder = JSONEncoder()
+
+        # Stream the statement reports, one at a time
+        self.output.write('{')
+        for key, value in (('files', report.db.files),
+                           ('functions', report.db.functions),
+                           ('statements', report.db.statements),
+                           ('operands', report.db.operands),
+                           ('call_contexts', report.db.call_contexts),
+                           ('memory_locations', report.db.memory_locations)):
+            self.output.write('"%s": %s, ' % (key, encoder.encode(value)))
+
+        self.output.write('"reports": [')
+        for i, statement_report in enumerate(report):
+            if i > 0:
+                self.output.write(', ')
+            self.output.write(encoder.encode(statement_report))
+        self.output.write(']}\n')
 
 
 class CSVFormatter(Formatter):
@@ -894,7 +1277,7 @@ class CSVFormatter(Formatter):
             'message'
         ])
 
-        for statement_report in report.statement_reports:
+        for statement_report in report:
             statement = statement_report.statement()
             function = statement.function()
 
@@ -924,9 +1307,14 @@ class AutoFormatter(TextFormatter):
     MAX_NUM_REPORT = 15
 
     def format(self, report):
-        if len(report.statement_reports) == 0:
+        # Only fetch the reports needed to decide
+        statement_reports = list(
+            itertools.islice(report.iterate(self.order_by()),
+                             AutoFormatter.MAX_NUM_REPORT + 1))
+
+        if len(statement_reports) == 0:
             printf('No entries.\n', file=self.output)
-        elif len(report.statement_reports) > AutoFormatter.MAX_NUM_REPORT:
+        elif len(statement_reports) > AutoFormatter.MAX_NUM_REPORT:
             printf('Report is too big (> %d entries)\n\n'
                    'Use `ikos-report %s` to examine the report'
                    ' in your terminal.\n'
@@ -937,7 +1325,62 @@ class AutoFormatter(TextFormatter):
                    report.db.path,
                    file=self.output)
         else:
-            super(AutoFormatter, self).format(report)
+            self.write_reports(statement_reports)
+
+
+class StatsFormatter(Formatter):
+    '''
+    Statistics output formatter
+
+    Prints the time and peak memory usage of each analysis phase, and the
+    functions with the largest abstract states (requires ikos --state-stats),
+    instead of the checks.
+    '''
+
+    MAX_NUM_FUNCTIONS = 20
+
+    def format(self, report):
+        db = report.db
+
+        phases = db.load_phase_results(full=True, sort=False)
+        printf(bold('# Phases:') + '\n', file=self.output)
+        if phases:
+            name_width = max(len(name) for name, _, _ in phases)
+            for name, elapsed, peak_rss in phases:
+                printf('%s: %s, peak RSS %s\n',
+                       name.ljust(name_width),
+                       format_time(elapsed),
+                       format_memory(peak_rss),
+                       file=self.output)
+
+        limit = None if self.verbosity > 1 else self.MAX_NUM_FUNCTIONS
+        sizes = db.load_state_sizes(limit=limit)
+        printf('\n' + bold('# Abstract states:') + '\n', file=self.output)
+        if not sizes:
+            printf('No abstract state statistics, use ikos --state-stats\n',
+                   file=self.output)
+            return
+
+        for size in sizes:
+            call_context = size.call_context()
+            printf('%s%s\n',
+                   size.function().pretty_name(),
+                   ' (context: %s)' % call_context.str()
+                   if not call_context.empty() else '',
+                   file=self.output)
+            printf('  %d cells, %d points-to, %d patricia tree nodes '
+                   '(peak over %d samples)\n',
+                   size.peak_cells,
+                   size.peak_points_to,
+                   size.peak_nodes,
+                   size.samples,
+                   file=self.output)
+            if size.peak_pack_size:
+                printf('  largest variable pack: %d variables, '
+                       '%d relations dropped\n',
+                       size.peak_pack_size,
+                       size.dropped_relations,
+                       file=self.output)
 
 
 # available formats
@@ -946,6 +1389,7 @@ formats = {
     'json': JSONFormatter,
     'csv': CSVFormatter,
     'auto': AutoFormatter,
+    'stats': StatsFormatter,
 }
 
 
@@ -1855,6 +2299,29 @@ def parse_arguments(argv):
                                        'no'),
                         choices=args.choices(args.display_summary_choices),
                         default='no')
+    parser.add_argument('--top-loops',
+                        dest='display_top_loops',
+                        metavar='N',
+                        help='Display the N most expensive loops '
+                             '(requires ikos --fixpoint-stats)',
+                        type=int,
+                        default=0)
+    parser.add_argument('--top-transfer-functions',
+                        dest='display_top_transfer_functions',
+                        metavar='N',
+                        help='Display the time spent in transfer functions '
+                             'per statement kind, and the N most expensive '
+                             'functions (requires ikos --transfer-stats)',
+                        type=int,
+                        default=0)
+    parser.add_argument('--top-offenders',
+                        dest='display_top_offenders',
+                        metavar='N',
+                        help='Display the N most expensive functions, call '
+                             'contexts, loops, checkers and abstract states, '
+                             'with suggestions to speed up the analysis',
+                        type=int,
+                        default=0)
     parser.add_argument('--display-raw-checks',
                         dest='display_raw_checks',
                         help='Display analysis raw checks',
@@ -1976,6 +2443,28 @@ def main(argv):
             print_summary(db, opt.display_summary == 'full')
             first = False
 
+        # display the most expensive loops
+        if opt.display_top_loops > 0:
+            if not first:
+                printf('\n')
+            print_top_loops(db, opt.display_top_loops)
+            first = False
+
+        # display the most expensive transfer functions
+        if opt.display_top_transfer_functions > 0:
+            if not first:
+                printf('\n')
+            print_top_transfer_functions(db,
+                                         opt.display_top_transfer_functions)
+            first = False
+
+        # display the most expensive functions, loops and checkers
+        if opt.display_top_offenders > 0:
+            if not first:
+                printf('\n')
+            print_top_offenders(db, opt.display_top_offenders, settings)
+            first = False
+
         # display raw checks
         if opt.display_raw_checks:
             if not first:
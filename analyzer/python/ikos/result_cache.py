@@ -0,0 +1,193 @@
+###############################################################################
+#
+# Content-addressed cache of analysis results
+#
+# Author: Maxime Arthaud
+#
+# Contact: ikos@lists.nasa.gov
+#
+# Notices:
+#
+#
+# Copyright (c) 2011-2019 United States Government as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All Rights Reserved.
+#
+# Disclaimers:
+#
+# No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+# ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+# TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+# ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+# OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+# ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+# THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+# ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+# RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+# RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+# DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+# IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+#
+# Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+# THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+# AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+# IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+# USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+# RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+# HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+# AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+# RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+# UNILATERAL TERMINATION OF THIS AGREEMENT.
+import hashlib
+import os
+import os.path
+import shutil
+import tempfile
+
+from ikos import log
+from ikos import settings
+
+
+def _update_file(h, path):
+    ''' Update the hash with the content of the given file '''
+    with open(path, 'rb') as f:
+        for chunk in iter(lambda: f.read(1 << 20), b''):
+            h.update(chunk)
+
+
+def _update_str(h, s):
+    ''' Update the hash with the given string '''
+    s = s.encode('utf-8')
+    h.update(str(len(s)).encode('utf-8'))
+    h.update(b':')
+    h.update(s)
+
+
+def result_key(bc_path, analyzer, arguments, input_files=()):
+    '''
+    Return the cache key of an analysis
+
+    Arguments:
+        bc_path(str): path to the preprocessed bitcode
+        analyzer(str): path to ikos-analyzer
+        arguments(list): options of ikos-analyzer impacting the results
+        input_files(list): additional files read by ikos-analyzer
+    '''
+    h = hashlib.sha256()
+    _update_str(h, settings.VERSION)
+    _update_str(h, os.path.basename(analyzer))
+
+    if settings.GIT_HEAD_DIRTY:
+        # The version does not identify the analyzer, use the binary
+        _update_file(h, analyzer)
+
+    _update_file(h, bc_path)
+
+    for argument in arguments:
+        _update_str(h, argument)
+
+    for path in input_files:
+        _update_file(h, path)
+
+    return h.hexdigest()
+
+
+# Files and directories of an output database, see ikos-analyzer -format
+OUTPUT_SUFFIXES = ('', '.col')
+
+
+class ResultCache(object):
+    '''
+    Cache of output databases, indexed by result_key()
+
+    Each entry is a directory containing the output database, and the
+    columnar files if any. Entries are written in a temporary directory
+    first, and then renamed, so that concurrent processes sharing the same
+    cache directory (e.g. on a network file system) never read partial
+    entries.
+    '''
+
+    def __init__(self, directories):
+        '''
+        Arguments:
+            directories(list): cache directories, in lookup order
+        '''
+        self.directories = directories
+
+    def _entry(self, directory, key):
+        return os.path.join(directory, key[:2], key)
+
+    def lookup(self, key, db_path):
+        '''
+        Copy the cached output database to db_path
+
+        Return True on a cache hit.
+        '''
+        for i, directory in enumerate(self.directories):
+            entry = self._entry(directory, key)
+            if not os.path.isdir(entry):
+                continue
+
+            try:
+                self._copy(entry, 'output.db',
+                           os.path.dirname(db_path) or '.',
+                           os.path.basename(db_path))
+            except (OSError, IOError) as e:
+                log.warning('Could not read the result cache %s: %s'
+                            % (directory, e))
+                continue
+
+            log.info('Using cached analysis results from %s' % entry)
+
+            # Populate the previous caches
+            for previous in self.directories[:i]:
+                self.store(key, db_path, directories=[previous])
+
+            return True
+
+        return False
+
+    def store(self, key, db_path, directories=None):
+        ''' Store the output database at db_path in the cache '''
+        for directory in (directories or self.directories):
+            entry = self._entry(directory, key)
+            if os.path.isdir(entry):
+                continue
+
+            parent = os.path.dirname(entry)
+            tmp = None
+            try:
+                if not os.path.isdir(parent):
+                    os.makedirs(parent)
+                tmp = tempfile.mkdtemp(prefix='.tmp-', dir=parent)
+                self._copy(os.path.dirname(db_path) or '.',
+                           os.path.basename(db_path), tmp, 'output.db')
+            except (OSError, IOError) as e:
+                log.warning('Could not write in the result cache %s: %s'
+                            % (directory, e))
+                if tmp is not None:
+                    shutil.rmtree(tmp, ignore_errors=True)
+                continue
+
+            try:
+                os.rename(tmp, entry)
+            except OSError:
+                # Stored concurrently by another process
+                shutil.rmtree(tmp, ignore_errors=True)
+
+    @staticmethod
+    def _copy(src_dir, src_name, dst_dir, dst_name):
+        ''' Copy an output database and its columnar files '''
+        for suffix in OUTPUT_SUFFIXES:
+            src = os.path.join(src_dir, src_name + suffix)
+            dst = os.path.join(dst_dir, dst_name + suffix)
+
+            if os.path.isdir(dst):
+                shutil.rmtree(dst)
+            elif os.path.exists(dst):
+                os.remove(dst)
+
+            if os.path.isdir(src):
+                shutil.copytree(src, dst)
+            elif os.path.isfile(src):
+                shutil.copyfile(src, dst)
@@ -43,6 +43,7 @@ import argparse
 import codecs
 import collections
 import itertools
+import multiprocessing
 import os
 import os.path
 import random
@@ -51,6 +52,14 @@ import subprocess
 import sys
 import tempfile
 import threading
+import time
+
+try:
+    # Python 3
+    import queue
+except ImportError:
+    # Python 2
+    import Queue as queue
 
 from ikos import analyzer
 from ikos import args
@@ -107,6 +116,20 @@ def parse_arguments(argv):
                                        args.default_log_level),
                         choices=args.choices(args.log_levels),
                         default=None)
+    parser.add_argument('-j', '--jobs',
+                        dest='jobs',
+                        metavar='<n>',
+                        type=int,
+                        help='Analyze the binaries during the build, with at '
+                             'most <n> analyses\nin parallel (bounded by the '
+                             'number of CPUs)',
+                        default=None)
+    parser.add_argument('--mem',
+                        dest='mem',
+                        metavar='<MB>',
+                        type=int,
+                        help='MEM limit shared by the parallel analyses (MB)',
+                        default=-1)
 
     opt = parser.parse_args(argv)
 
@@ -117,6 +140,9 @@ def parse_arguments(argv):
     if not opt.args:
         parser.error("too few arguments")
 
+    if opt.jobs is not None and opt.jobs < 1:
+        parser.error("argument -j/--jobs: must be positive")
+
     # verbosity changes the log level, if --log is not specified
     if opt.log_level is None:
         if opt.verbosity <= 0:
@@ -667,6 +693,9 @@ class ScanServerRequestHandler(http.BaseHTTPRequestHandler):
         self.server.binaries.append(binary)
         log.debug('Received %r' % binary)
 
+        if self.server.on_binary is not None:
+            self.server.on_binary(binary)
+
         # send response
         self.send_response(200)
         self.end_headers()
@@ -683,7 +712,11 @@ class ScanServer(threading.Thread):
     Note that the server is single threaded.
     '''
 
-    def __init__(self):
+    def __init__(self, on_binary=None):
+        '''
+        Arguments:
+            on_binary(function): called on each built binary, or None
+        '''
         super(ScanServer, self).__init__()
 
         self.port = None
@@ -698,6 +731,7 @@ class ScanServer(threading.Thread):
 
         self.httpd.timeout = 0.1
         self.httpd.binaries = []  # list of built binaries
+        self.httpd.on_binary = on_binary
         self.running = False
 
     def run(self):
@@ -713,6 +747,164 @@ class ScanServer(threading.Thread):
         return self.httpd.binaries
 
 
+def analysis_command(opt, bc_path, db_path, mem):
+    ''' Return the command to analyze the given bitcode file '''
+    cmd = [sys.executable,
+           settings.ikos(),
+           bc_path,
+           '-o',
+           db_path,
+           '--color=%s' % opt.color,
+           '--log=%s' % opt.log_level]
+    if mem > 0:
+        cmd.append('--mem=%d' % mem)
+    return cmd
+
+
+# Result of an analysis started by the AnalysisScheduler
+AnalysisResult = collections.namedtuple('AnalysisResult',
+                                        ('exe_path', 'db_path', 'status',
+                                         'time'))
+
+
+class AnalysisScheduler(object):
+    '''
+    Run the analyses of the built binaries in parallel, during the build
+
+    Binaries are queued as soon as they are reported to the scan server. The
+    number of parallel analyses is bounded by the number of CPUs, and the
+    memory limit is split between them.
+    '''
+
+    def __init__(self, opt):
+        self.opt = opt
+        self.jobs = max(1, min(opt.jobs, multiprocessing.cpu_count()))
+        self.mem = opt.mem // self.jobs if opt.mem > 0 else -1
+        self.queue = queue.Queue()
+        self.workers = [threading.Thread(target=self._work)
+                        for _ in range(self.jobs)]
+        self.lock = threading.Lock()  # protects the fields below and stdout
+        self.num_queued = 0
+        self.results = []
+        self.pending = set()  # queued binaries, not started yet
+        self.exe_locks = collections.defaultdict(threading.Lock)
+
+        for worker in self.workers:
+            worker.daemon = True
+
+    def start(self):
+        for worker in self.workers:
+            worker.start()
+
+    def add(self, binary):
+        ''' Queue the analysis of a built binary '''
+        with self.lock:
+            if binary['exe_path'] in self.pending:
+                return  # rebuilt before its analysis started
+
+            self.pending.add(binary['exe_path'])
+            self.num_queued += 1
+
+        self.queue.put(binary)
+
+    def join(self):
+        ''' Wait for the queued analyses to finish '''
+        for _ in self.workers:
+            self.queue.put(None)
+        for worker in self.workers:
+            worker.join()
+
+    def _work(self):
+        while True:
+            binary = self.queue.get()
+            if binary is None:
+                return
+
+            with self.lock:
+                self.pending.discard(binary['exe_path'])
+                exe_lock = self.exe_locks[binary['exe_path']]
+
+            # Never run two analyses writing the same database
+            with exe_lock:
+                self._analyze(binary)
+
+    def _analyze(self, binary):
+        exe_path = os.path.relpath(binary['exe_path'])
+        bc_path = os.path.relpath(binary['bc_path'])
+        db_path = '%s.db' % exe_path
+
+        if not os.path.exists(exe_path):
+            # e.g. temporary binaries built by configure scripts
+            self._done(AnalysisResult(exe_path, db_path, 'skipped', 0))
+            return
+
+        with self.lock:
+            log.info('Analyzing %s' % colors.bold(exe_path))
+
+        cmd = analysis_command(self.opt, bc_path, db_path, self.mem)
+        log.debug('Running %s' % command_string(cmd))
+
+        start = time.time()
+        try:
+            proc = subprocess.Popen(cmd,
+                                    stdout=subprocess.PIPE,
+                                    stderr=subprocess.STDOUT)
+            output, _ = proc.communicate()
+            rc = proc.returncode
+        except OSError as e:
+            output, rc = str(e).encode('utf-8'), e.errno
+        elapsed = time.time() - start
+
+        if rc == 0:
+            status = 'ok'
+        elif not os.path.exists(exe_path):
+            status = 'skipped'  # removed during the analysis
+        else:
+            status = 'failed'
+
+        self._done(AnalysisResult(exe_path, db_path, status, elapsed),
+                   output)
+
+    def _done(self, result, output=None):
+        with self.lock:
+            self.results.append(result)
+
+            if result.status != 'skipped':
+                printf(colors.bold('# %s') + ' [%d/%d, %.1fs]\n',
+                       result.exe_path,
+                       len(self.results),
+                       self.num_queued,
+                       result.time)
+                if output:
+                    printf('%s\n', output.decode('utf-8', errors='replace'))
+
+    STATUS_FORMATTER = {
+        'ok': colors.bold_green,
+        'failed': colors.bold_red,
+        'skipped': colors.bold_yellow,
+    }
+
+    def print_summary(self):
+        ''' Print a summary of the analyses '''
+        if not self.results:
+            printf('Nothing to analyze.\n')
+            return
+
+        printf(colors.bold('# Analyses') + '\n')
+        for result in sorted(self.results, key=lambda r: r.exe_path):
+            formatter = AnalysisScheduler.STATUS_FORMATTER[result.status]
+            printf('%s %s (%.1fs)\n',
+                   formatter(result.status.ljust(7)),
+                   result.exe_path,
+                   result.time)
+
+        counts = collections.Counter(r.status for r in self.results)
+        printf('\n%d analyzed, %d failed, %d skipped\n',
+               counts['ok'], counts['failed'], counts['skipped'])
+        if counts['ok']:
+            printf('Use `ikos-report <binary>.db` to examine a report.\n')
+
+
 ###########################################
 # main for ikos-scan-cc and ikos-scan-c++ #
 ###########################################
@@ -804,8 +996,14 @@ def main(argv):
     colors.setup(opt.color, file=log.out)
     log.setup(opt.log_level)
 
+    # analyses started during the build, if -j is specified
+    scheduler = None
+    if opt.jobs is not None:
+        scheduler = AnalysisScheduler(opt)
+        scheduler.start()
+
     # scan server
-    server = ScanServer()
+    server = ScanServer(on_binary=scheduler.add if scheduler else None)
     server.daemon = True
     server.start()
 
@@ -829,6 +1027,12 @@ def main(argv):
     server.cancel()
     server.join()
 
+    if scheduler is not None:
+        # wait for the remaining analyses
+        scheduler.join()
+        scheduler.print_summary()
+        return
+
     # skip binaries that have been removed
     binaries = [binary for binary in server.binaries
                 if os.path.exists(binary['exe_path'])]
@@ -848,11 +1052,5 @@ def main(argv):
             cmd = ['ikos', bc_path, '-o', '%s.db' % exe_path]
             log.info('Running %s' % colors.bold(command_string(cmd)))
 
-            cmd = [sys.executable,
-                   settings.ikos(),
-                   bc_path,
-                   '-o',
-                   '%s.db' % exe_path,
-                   '--color=%s' % opt.color,
-                   '--log=%s' % opt.log_level]
+            cmd = analysis_command(opt, bc_path, '%s.db' % exe_path, opt.mem)
             run(cmd)
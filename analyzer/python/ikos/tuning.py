@@ -0,0 +1,171 @@
+###############################################################################
+#
+# Feedback-directed tuning of the analysis
+#
+# Author: Maxime Arthaud
+#
+# Contact: ikos@lists.nasa.gov
+#
+# Notices:
+#
+#
+# Copyright (c) 2011-2019 United States Government as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All Rights Reserved.
+#
+# Disclaimers:
+#
+# No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+# ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+# TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+# ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+# OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+# ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+# THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+# ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+# RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+# RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+# DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+# IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+#
+# Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+# THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+# AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+# IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+# USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+# RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+# HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+# AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+# RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+# UNILATERAL TERMINATION OF THIS AGREEMENT.
+import hashlib
+import os
+import os.path
+
+from ikos import log
+
+# Loops cheaper than this, in seconds, are left untouched
+LOOP_MIN_TIME = 1.0
+
+# Expensive loops with at least this number of widenings are tuned
+LOOP_MIN_WIDENINGS = 2
+
+# Tuning of the expensive loops: widen right after the first iteration, with
+# the loop guard as the only widening threshold
+LOOP_WIDENING_DELAY = 0
+LOOP_THRESHOLDS = 1
+
+# Precision of the functions that ran out of budget
+FUNCTION_PRECISION = 'reg'
+
+# Precision levels, from the least precise
+PRECISIONS = ('reg', 'ptr', 'mem')
+
+
+class TuningProfile(object):
+    '''
+    Tuning profile of ikos-analyzer, see ikos-analyzer -tuning
+
+    The profile is stored in a sidecar file, one tab-separated entry per line:
+        function <name> <precision>
+        loop <function> <file> <line> <column> <widening delay> <thresholds>
+    '''
+
+    def __init__(self):
+        # function name -> precision
+        self.functions = {}
+        # (function name, file, line, column) -> (widening delay, thresholds)
+        self.loops = {}
+
+    def empty(self):
+        return not self.functions and not self.loops
+
+    def add_function(self, name, precision):
+        ''' Lower the precision of the given function '''
+        previous = self.functions.get(name)
+        if previous is None or (PRECISIONS.index(precision) <
+                                PRECISIONS.index(previous)):
+            self.functions[name] = precision
+
+    def add_loop(self, key, delay, thresholds):
+        ''' Tune the given loop, keeping the lowest settings '''
+        previous = self.loops.get(key)
+        if previous is not None:
+            delay = min(delay, previous[0])
+            thresholds = min(thresholds, previous[1])
+        self.loops[key] = (delay, thresholds)
+
+    def read(self, path):
+        ''' Read the entries of the given file '''
+        with open(path) as f:
+            for n, line in enumerate(f, 1):
+                line = line.rstrip('\n')
+                if not line or line.startswith('#'):
+                    continue
+                fields = line.split('\t')
+                try:
+                    if fields[0] == 'function' and len(fields) == 3:
+                        self.add_function(fields[1], fields[2])
+                    elif fields[0] == 'loop' and len(fields) == 7:
+                        self.add_loop((fields[1], fields[2],
+                                       int(fields[3]), int(fields[4])),
+                                      int(fields[5]), int(fields[6]))
+                    else:
+                        raise ValueError(line)
+                except ValueError:
+                    log.warning('%s:%d: invalid tuning profile entry, ignored'
+                                % (path, n))
+
+    def write(self, path):
+        ''' Write the profile in the given file '''
+        tmp_path = path + '.tmp'
+        with open(tmp_path, 'w') as f:
+            f.write('# ikos tuning profile, generated from the telemetry of '
+                    'the previous runs\n')
+            for name, precision in sorted(self.functions.items()):
+                f.write('function\t%s\t%s\n' % (name, precision))
+            for key, (delay, thresholds) in sorted(self.loops.items()):
+                f.write('loop\t%s\t%s\t%d\t%d\t%d\t%d\n'
+                        % (key + (delay, thresholds)))
+        os.rename(tmp_path, path)
+
+
+def update(path, db):
+    '''
+    Update the tuning profile with the telemetry of the given output database
+
+    The entries of the previous runs are kept: the functions and loops they
+    tuned are fast now, and would be untuned otherwise.
+
+    Arguments:
+        path(str): path to the tuning profile
+        db(OutputDatabase): output database of the run
+    '''
+    profile = TuningProfile()
+    if os.path.exists(path):
+        profile.read(path)
+
+    # Functions that ran out of their time or step budget
+    for budget in db.load_budgets():
+        if budget.kind in ('time', 'steps'):
+            profile.add_function(budget.function().name, FUNCTION_PRECISION)
+
+    # Loops, across calling contexts
+    loops = {}
+    for fixpoint in db.load_fixpoints():
+        statement = fixpoint.statement()
+        if statement is None or statement.file_id is None:
+            continue
+        key = (fixpoint.function().name,
+               statement.file().path,
+               statement.line,
+               statement.column)
+        time, widenings = loops.get(key, (0.0, 0))
+        loops[key] = (time + fixpoint.time, max(widenings, fixpoint.widenings))
+
+    for key, (time, widenings) in loops.items():
+        if time >= LOOP_MIN_TIME and widenings >= LOOP_MIN_WIDENINGS:
+            profile.add_loop(key, LOOP_WIDENING_DELAY, LOOP_THRESHOLDS)
+
+    if not profile.empty():
+        profile.write(path)
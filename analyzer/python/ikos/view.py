@@ -45,10 +45,12 @@ import argparse
 import collections
 import io
 import json
+import multiprocessing
 import operator
 import os
 import os.path
 import re
+import shutil
 import sqlite3
 import sys
 import threading
@@ -62,7 +64,7 @@ from ikos import report
 from ikos import settings
 from ikos.enums import Result, CheckKind
 from ikos.highlight import CppLexer, HtmlFormatter, highlight
-from ikos.http import HTTPServer, BaseHTTPRequestHandler
+from ikos.http import ThreadingHTTPServer, BaseHTTPRequestHandler
 from ikos.log import printf
 from ikos.output_db import OutputDatabase
 
@@ -122,72 +124,93 @@ class TemplateEngine:
         return data
 
 
-class RequestHandler(BaseHTTPRequestHandler):
-    ''' Handler for an HTTP request '''
-
-    _static_cache = {}
+# URLs of the pages served by the HTTP server
+SERVER_URLS = {
+    'static_url': '/static/',
+    'homepage_url': '/',
+    'settings_url': '/settings',
+    'report_url': '/report/%d',
+    'checks_url': '/report/%d/checks?after=%%d',
+    'live_url': '/live',
+}
+
+# URLs of the pages written by --export, relative to the export directory
+EXPORT_URLS = {
+    'static_url': 'static/',
+    'homepage_url': 'index.html',
+    'settings_url': 'settings.html',
+    'report_url': 'report-%d.html',
+    'checks_url': 'checks/%d-%%d.json',
+    'live_url': None,
+}
+
+
+class Pages:
+    '''
+    Render the pages of ikos-view
+
+    Pages are rendered for the HTTP server or for a static export, depending
+    on the given URLs (see SERVER_URLS and EXPORT_URLS).
+    '''
+
+    def __init__(self, db, view_report, urls):
+        self.db = db
+        self.report = view_report
+        self.urls = urls
 
-    def do_GET(self):
-        ''' Handle a GET request '''
-        urls = [
-            (r'^/$',
-             self._serve_homepage),
-            (r'^/static/(?P<path>[a-zA-Z_-]+/[a-zA-Z0-9_-]+\.[a-zA-Z_-]+)$',
-             self._serve_static),
-            (r'^/settings$',
-             self._serve_settings),
-            (r'^/report/(?P<id>[0-9]+)(\?k=(?P<kinds_filter>[A-Z0-9]+))?$',
-             self._serve_report)
-        ]
+        # Pages can be rendered in parallel, but share the database connection
+        self.lock = threading.Lock()
 
-        for pattern, f in urls:
-            m = re.match(pattern, self.path)
-            if m:
-                f(**m.groupdict())
-                return
+    def render(self, path, values={}):
+        ''' Format a template with the given values and the URLs '''
+        values = dict(values)
+        for key in ('static_url', 'homepage_url', 'settings_url'):
+            values[key] = self.urls[key]
+        values['live'] = json.dumps(self._live())
+        return TemplateEngine.get().process(path, values)
 
-        self._serve_not_found()
+    def _live(self):
+        ''' Generate the Javascript variable live, see live_key() '''
+        if not self.report.live or self.urls['live_url'] is None:
+            return None
 
-    # Static files
+        return {'url': self.urls['live_url'], 'key': self.report.key}
 
-    def _serve_static(self, path):
-        ''' Serve a static file '''
-        fullpath = os.path.join(SHARE_DIR, 'static', path)
+    def live_key(self):
+        '''
+        Return the key of the analysis results, as a JSON value
 
-        if os.path.isfile(fullpath):
-            self._send_static_headers(path)
-            self._write_file(fullpath)
-        else:
-            self._serve_not_found()
+        In live mode, pages poll it and reload when it changes.
+        '''
+        with self.lock:
+            return {'key': self.report.refresh()}
 
     # Homepage
 
-    def _serve_homepage(self):
-        ''' Serve the homepage '''
-        self._write_template('homepage.html', {
+    def homepage(self):
+        ''' Render the homepage '''
+        return self.render('homepage.html', {
             'check_kinds': json.dumps(self._check_kinds()),
             'check_kinds_filter': json.dumps(self._check_kinds_filter()),
             'files': json.dumps(self._files()),
+            'report_url': self.urls['report_url'],
         })
 
     def _check_kinds(self):
         ''' Generate the Javascript variable check_kinds '''
-        view_report = View.get().report
         return [{'id': kind, 'name': CheckKind.long_name(kind)}
-                for kind in view_report.kinds]
+                for kind in self.report.kinds]
 
     def _check_kinds_filter(self, param=None):
         ''' Generate the Javascript variable check_kinds_filter '''
-        view_report = View.get().report
-
-        filter = {kind: True for kind in view_report.kinds}
+        filter = {kind: True for kind in self.report.kinds}
 
         if not param:
             return filter
 
         param = [int(param[i:i + 2], 16) for i in range(0, len(param), 2)]
 
-        for kind in view_report.kinds:
+        for kind in self.report.kinds:
             try:
                 filter[kind] = (param[kind // 8] & (1 << (kind % 8))) != 0
             except IndexError:
@@ -197,14 +220,13 @@ class RequestHandler(BaseHTTPRequestHandler):
 
     def _files(self):
         ''' Generate the Javascript variable files '''
-        view_report = View.get().report
         files = []
 
-        for file in view_report.files:
+        for file in self.report.files:
             files.append({
                 'id': file.id,
                 'path': report.format_path(file.path),
-                'status_kinds': view_report.files_status_kinds[file.id]
+                'status_kinds': self.report.files_status_kinds[file.id]
             })
 
         # Sort by path
@@ -214,10 +236,9 @@ class RequestHandler(BaseHTTPRequestHandler):
 
     # Settings
 
-    def _serve_settings(self):
-        ''' Serve the settings page '''
-        db = View.get().db
-        settings = db.load_settings()
+    def settings(self):
+        ''' Render the settings page '''
+        settings = self.db.load_settings()
         s = []
 
         for name, value in settings.items():
@@ -230,44 +251,148 @@ class RequestHandler(BaseHTTPRequestHandler):
                          % (html.escape(name),
                             html.escape(str(value))))
 
-        self._write_template('settings.html', {'settings': '\n\t'.join(s)})
+        return self.render('settings.html', {'settings': '\n\t'.join(s)})
 
     # File report
 
+    def file_report(self, file, kinds_filter=None):
+        '''
+        Render the report of a file
+
+        Raise IOError if the source file cannot be read.
+        '''
+        with io.open(file.path, 'r',
+                     encoding='utf-8',
+                     errors='ignore') as f:
+            code = f.read()
+
+        with self.lock:
+            lines_status = self.report.lines_status(file.id)
+
+        # Checks are loaded by the page, see checks()
+        fmt = Formatter(lines_status)
+        lexer = CppLexer(stripnl=False)
+        code = highlight(code, lexer, fmt)
+        check_kinds_filter = self._check_kinds_filter(param=kinds_filter)
+        return self.render('report.html', {
+            'file_id': file.id,
+            'filepath': html.escape(report.format_path(file.path)),
+            'check_kinds': json.dumps(self._check_kinds()),
+            'check_kinds_filter': json.dumps(check_kinds_filter),
+            'checks_url': self.urls['checks_url'] % file.id,
+            'static_export': json.dumps(self.urls is EXPORT_URLS),
+            'code': code,
+            'pygments_css': fmt.get_style_defs('.highlight')
+        })
+
+    def checks(self, file_id, after):
+        ''' Return a page of checks for a file, as a JSON value '''
+        with self.lock:
+            return self.report.checks_page(file_id, after)
+
+    # Errors
+
+    def not_found(self, path):
+        ''' Render a 404 Not Found page '''
+        return self.render('not_found.html', {'path': html.escape(path)})
+
+    def error(self, message):
+        ''' Render a 500 Internal Error page '''
+        return self.render('error.html', {'message': html.escape(message)})
+
+
+class RequestHandler(BaseHTTPRequestHandler):
+    ''' Handler for an HTTP request '''
+
+    _static_cache = {}
+
+    def do_GET(self):
+        ''' Handle a GET request '''
+        urls = [
+            (r'^/$',
+             self._serve_homepage),
+            (r'^/static/(?P<path>[a-zA-Z_-]+/[a-zA-Z0-9_-]+\.[a-zA-Z_-]+)$',
+             self._serve_static),
+            (r'^/settings$',
+             self._serve_settings),
+            (r'^/report/(?P<id>[0-9]+)(\?k=(?P<kinds_filter>[A-Z0-9]+))?$',
+             self._serve_report),
+            (r'^/report/(?P<id>[0-9]+)/checks(\?after=(?P<after>[0-9]+))?$',
+             self._serve_checks),
+            (r'^/live$',
+             self._serve_live),
+        ]
+
+        for pattern, f in urls:
+            m = re.match(pattern, self.path)
+            if m:
+                f(**m.groupdict())
+                return
+
+        self._serve_not_found()
+
+    # Static files
+
+    def _serve_static(self, path):
+        ''' Serve a static file '''
+        fullpath = os.path.join(SHARE_DIR, 'static', path)
+
+        if os.path.isfile(fullpath):
+            self._send_static_headers(path)
+            self._write_file(fullpath)
+        else:
+            self._serve_not_found()
+
+    # Pages
+
+    def _serve_homepage(self):
+        ''' Serve the homepage '''
+        self._write_html(View.get().pages.homepage())
+
+    def _serve_settings(self):
+        ''' Serve the settings page '''
+        self._write_html(View.get().pages.settings())
+
     def _serve_report(self, id, kinds_filter):
         ''' Serve a specific report for a file '''
         id = int(id)
-        view_report = View.get().report
+        view = View.get()
 
         try:
-            file = view_report.files[id]
+            file = view.report.files[id]
         except IndexError:
             self._serve_not_found()
             return
 
         try:
-            with io.open(file.path, 'r',
-                         encoding='utf-8',
-                         errors='ignore') as f:
-                code = f.read()
+            page = view.pages.file_report(file, kinds_filter)
         except (OSError, IOError):
             self._serve_error("No such file: %s" % file.path)
             return
 
-        fmt = Formatter(file)
-        lexer = CppLexer(stripnl=False)
-        code = highlight(code, lexer, fmt)
-        check_kinds_filter = self._check_kinds_filter(param=kinds_filter)
-        self._write_template('report.html', {
-            'filepath': html.escape(report.format_path(file.path)),
-            'check_kinds': json.dumps(self._check_kinds()),
-            'check_kinds_filter': json.dumps(check_kinds_filter),
-            'code': code,
-            'functions': json.dumps(fmt.functions),
-            'call_contexts': json.dumps(fmt.call_contexts),
-            'checks': json.dumps(fmt.checks),
-            'pygments_css': fmt.get_style_defs('.highlight')
-        })
+        self._write_html(page)
+
+    def _serve_checks(self, id, after):
+        ''' Serve a page of checks for a file, as JSON '''
+        id = int(id)
+        after = int(after or 0)
+        view = View.get()
+
+        if id >= len(view.report.files):
+            self._serve_not_found()
+            return
+
+        self._write_json(view.pages.checks(id, after))
+
+    def _serve_live(self):
+        ''' Serve the key of the analysis results, as JSON '''
+        view = View.get()
+
+        if not view.report.live:
+            self._serve_not_found()
+            return
+
+        self._write_json(view.pages.live_key())
 
     # Helpers
 
@@ -298,25 +423,27 @@ class RequestHandler(BaseHTTPRequestHandler):
             self.wfile.write(data)
             RequestHandler._static_cache[fullpath] = data
 
-    def _write_template(self, path, values={}, status=200):
-        ''' Write a template to the response stream '''
-        engine = TemplateEngine.get()
+    def _write_html(self, data, status=200):
+        ''' Write an HTML page to the response stream '''
         self.send_response(status)
         self.send_header('Content-Type', 'text/html; charset=UTF-8')
         self.end_headers()
-        self.wfile.write(engine.process(path, values).encode('utf8'))
+        self.wfile.write(data.encode('utf8'))
+
+    def _write_json(self, value):
+        ''' Write a JSON value to the response stream '''
+        self.send_response(200)
+        self.send_header('Content-Type', 'application/json; charset=UTF-8')
+        self.end_headers()
+        self.wfile.write(json.dumps(value).encode('utf8'))
 
     def _serve_not_found(self):
         ''' Server a 404 Not Found page '''
-        self._write_template('not_found.html',
-                             {'path': html.escape(self.path)},
-                             status=404)
+        self._write_html(View.get().pages.not_found(self.path), status=404)
 
     def _serve_error(self, message):
         ''' Server a 500 Internal Error page '''
-        self._write_template('error.html',
-                             {'message': html.escape(message)},
-                             status=500)
+        self._write_html(View.get().pages.error(message), status=500)
 
 
 class View:
@@ -330,14 +457,17 @@ class View:
         assert cls._singleton is not None
         return cls._singleton
 
-    def __init__(self, db, port=8080):
+    def __init__(self, db, port=8080, live=False):
         View._singleton = self
         self.db = db
         self.port = port
-        self.report = ViewReport(self.db)
+        self.report = ViewReport(self.db, live)
+
+        # Requests are served in parallel, see Pages.lock
+        self.pages = Pages(self.db, self.report, SERVER_URLS)
 
         try:
-            self.httpd = HTTPServer(('', self.port), RequestHandler)
+            self.httpd = ThreadingHTTPServer(('', self.port), RequestHandler)
         except (OSError, IOError) as e:
             log.error("Could not start the HTTP server: %s" % e)
             sys.exit(1)
@@ -350,159 +480,326 @@ class View:
         self.httpd.serve_forever()
 
 
+# Pages and directory of the export worker process, see export_init()
+_export_pages = None
+_export_directory = None
+
+
+def export_init(db_path, directory):
+    ''' Initialize an export worker process '''
+    db = OutputDatabase(db_path)
+    view_report = ViewReport(db)
+    view_report.pre_process()
+    export_setup(Pages(db, view_report, EXPORT_URLS), directory)
+
+
+def export_setup(pages, directory):
+    ''' Set the pages and the directory used by export_file() '''
+    global _export_pages, _export_directory
+    _export_pages = pages
+    _export_directory = directory
+
+
+def export_file(file_id):
+    '''
+    Export the report and the checks of a file, in an export worker process
+
+    Return an error message, or None.
+    '''
+    pages = _export_pages
+    file = pages.report.files[file_id]
+    error = None
+
+    try:
+        page = pages.file_report(file)
+    except (OSError, IOError):
+        error = "No such file: %s" % file.path
+        page = pages.error(error)
+    write_text(os.path.join(_export_directory,
+                            EXPORT_URLS['report_url'] % file_id),
+               page)
+
+    after = 0
+    while True:
+        checks = pages.checks(file_id, after)
+        write_text(os.path.join(_export_directory,
+                                EXPORT_URLS['checks_url'] % file_id % after),
+                   json.dumps(checks))
+        if checks['next'] is None:
+            break
+        after = checks['next']
+
+    return error
+
+
+def write_text(path, data):
+    ''' Write a text file, in utf-8 '''
+    with io.open(path, 'w', encoding='utf-8') as f:
+        f.write(data)
+
+
+class Export:
+    '''
+    Static export of ikos-view (ikos-view --export)
+
+    Every page is rendered in the export directory, so that it can be served
+    by any web server. The reports of the source files are rendered in
+    parallel, by worker processes with their own database connection.
+    '''
+
+    def __init__(self, db, db_path, directory, jobs):
+        self.db = db
+        self.db_path = db_path
+        self.directory = directory
+        self.jobs = jobs
+        self.report = ViewReport(db)
+        self.pages = Pages(db, self.report, EXPORT_URLS)
+
+    def run(self):
+        log.info("Pre-processing...")
+        # The index is built once here, and reused by the workers (unless the
+        # database is read-only)
+        self.report.pre_process()
+
+        for subdirectory in ('', 'checks', 'static'):
+            path = os.path.join(self.directory, subdirectory)
+            if not os.path.isdir(path):
+                os.makedirs(path)
+        self._copy_static()
+
+        write_text(os.path.join(self.directory, EXPORT_URLS['homepage_url']),
+                   self.pages.homepage())
+        write_text(os.path.join(self.directory, EXPORT_URLS['settings_url']),
+                   self.pages.settings())
+
+        file_ids = [file.id for file in self.report.files]
+        log.info("Exporting %d files in '%s'..."
+                 % (len(file_ids), self.directory))
+        if self.jobs > 1 and len(file_ids) > 1:
+            pool = multiprocessing.Pool(min(self.jobs, len(file_ids)),
+                                        export_init,
+                                        (self.db_path, self.directory))
+            try:
+                errors = pool.map(export_file, file_ids, chunksize=1)
+            finally:
+                pool.close()
+                pool.join()
+        else:
+            export_setup(self.pages, self.directory)
+            errors = [export_file(file_id) for file_id in file_ids]
+
+        for error in errors:
+            if error is not None:
+                log.warning(error)
+
+    def _copy_static(self):
+        ''' Copy the static files (CSS, Javascript) '''
+        source = os.path.join(SHARE_DIR, 'static')
+        for root, _, files in os.walk(source):
+            target = os.path.join(self.directory,
+                                  'static',
+                                  os.path.relpath(root, source))
+            if not os.path.isdir(target):
+                os.makedirs(target)
+            for name in files:
+                shutil.copyfile(os.path.join(root, name),
+                                os.path.join(target, name))
+
+
 StatusKinds = collections.namedtuple('StatusKinds',
                                      ['ok', 'warning', 'error', 'unreachable'])
 
 
 class ViewReport:
-    ''' IKOS view report '''
+    '''
+    IKOS view report
 
-    def __init__(self, db):
+    The statement reports are read from the summary tables of the database
+    (see report.finalize()), built once and reused by the following runs of
+    ikos-view. Checks are then loaded per file, one page at a time.
+
+    In live mode, the database is written by ikos-analyzer -live-db during
+    the analysis. The summary tables are then kept in temporary tables, and
+    rebuilt by refresh() when new results are committed.
+    '''
+
+    # Number of checks per page
+    PAGE_SIZE = 500
+
+    def __init__(self, db, live=False):
         self.db = db
-        self._report = None
+        self.live = live
+
+        # Key of the indexed results, see report.summary_key()
+        self.key = None
+
         self.kinds = None
         self.files = None
 
         # Map[file.id, Map[check.status, Map[check.kind, count]]]
         self.files_status_kinds = None
 
-        # Map[file.id, Map[check.line, List[Check]]]
-        self.files_lines_reports = None
-
     def pre_process(self):
         ''' Pre processing some values '''
-        # List of CheckKind
-        c = self.db.con.cursor()
-        rows = c.execute("SELECT DISTINCT kind FROM checks ORDER BY kind")
-        self.kinds = [row[0] for row in rows]
+        if self.live:
+            # Never write the database while ikos-analyzer is running
+            self.key = report.summary_key(self.db)
+            report.create_summary_tables(self.db, 'temp', self.key)
+        elif not report.summary_up_to_date(self.db):
+            log.info("Indexing the report...")
+            self._build_index()
 
-        # Generate report
-        self._report = report.generate_report(self.db)
+        self._load_files()
 
-        self.files = self.db.files
-        self.files_status_kinds = {}
-        self.files_lines_reports = {}
-        for file in self.files:
-            self.files_status_kinds[file.id] = StatusKinds(ok={},
-                                                           warning={},
-                                                           error={},
-                                                           unreachable={})
-            self.files_lines_reports[file.id] = {}
-
-        for statement_report in self._report.statement_reports:
-            stmt = statement_report.statement()
-            file = stmt.file()
+    def refresh(self):
+        '''
+        Rebuild the index if new results were committed in the database
 
-            if file is None:
-                continue  # Ignore checks without a file
+        Return the key of the indexed results.
+        '''
+        key = report.summary_key(self.db)
+        if key != self.key:
+            log.debug("Refreshing the report...")
+            self.key = key
+            report.create_summary_tables(self.db, 'temp', key)
+            self.db.reload()
+            self._load_files()
+        return self.key
+
+    def _load_files(self):
+        ''' Load the check kinds and the number of checks per file '''
+        c = self.db.con.cursor()
 
-            kind = statement_report.kind
-            status = statement_report.status
+        # List of CheckKind
+        c.execute('SELECT DISTINCT kind FROM summary_files ORDER BY kind')
+        self.kinds = [row[0] for row in c]
+
+        files = self.db.files
+        files_status_kinds = {}
+        for file in files:
+            files_status_kinds[file.id] = StatusKinds(ok={},
+                                                      warning={},
+                                                      error={},
+                                                      unreachable={})
+
+        c.execute('SELECT file_id, status, kind, count FROM summary_files')
+        for file_id, status, kind, count in c:
+            files_status_kinds[file_id][status][kind] = count
+
+        c.close()
+        self.files = files
+        self.files_status_kinds = files_status_kinds
+
+    def _build_index(self):
+        '''
+        Build the index
 
-            # Update self.files_status_kinds
-            kinds = self.files_status_kinds[file.id][status]
-            if kind not in kinds:
-                kinds[kind] = 0
-            kinds[kind] += 1
+        The index is stored in temporary tables if the database is read-only.
+        '''
+        key = report.summary_key(self.db)
+        try:
+            report.create_summary_tables(self.db, 'main', key)
+        except sqlite3.OperationalError as e:
+            log.warning("Could not store the index in the database: %s" % e)
+            self.db.con.rollback()
+            report.create_summary_tables(self.db, 'temp', key)
+
+    def lines_status(self, file_id):
+        ''' Return the status of each source line of the given file '''
+        c = self.db.con.cursor()
+        c.execute('SELECT line, MAX(status=%d), MAX(status=%d), '
+                  'MAX(status=%d) FROM summary_reports WHERE file_id = ? '
+                  'GROUP BY line' % (Result.ERROR,
+                                     Result.WARNING,
+                                     Result.UNREACHABLE),
+                  (file_id,))
+
+        lines_status = {}
+        for line, error, warning, unreachable in c:
+            if error:
+                lines_status[line] = Result.ERROR
+            elif warning:
+                lines_status[line] = Result.WARNING
+            elif unreachable:
+                lines_status[line] = Result.UNREACHABLE
+            else:
+                lines_status[line] = Result.OK
 
-            # Update self.files_lines_reports
-            lines_reports = self.files_lines_reports[file.id]
-            if stmt.line not in lines_reports:
-                lines_reports[stmt.line] = []
-            lines_reports[stmt.line].append(statement_report)
+        c.close()
+        return lines_status
 
+    def checks_page(self, file_id, after):
+        '''
+        Return a page of checks for the given file
 
-class Formatter(HtmlFormatter):
-    ''' Source code HTML formatter '''
+        Arguments:
+            file_id(int): file id
+            after(int): position of the last check of the previous page
+        '''
+        c = self.db.con.cursor()
+        c.execute('SELECT rowid, line, "column", function_id, kind, status, '
+                  'statement_id, call_context_ids, operands, info '
+                  'FROM summary_reports WHERE file_id = ? AND rowid > ? '
+                  'ORDER BY rowid LIMIT ?',
+                  (file_id, after, ViewReport.PAGE_SIZE + 1))
+        rows = c.fetchall()
+        c.close()
 
-    def __init__(self, file):
-        super(Formatter, self).__init__()
-        self.file = file
-        self.functions = {}
-        self.call_contexts = {}
-        self.checks = {}
+        builder = ChecksBuilder(self.db)
+        for row in rows[:ViewReport.PAGE_SIZE]:
+            builder.add(row)
 
-    def wrap(self, source, outfile):
-        return self._wrap_code(source)
+        next = None
+        if len(rows) > ViewReport.PAGE_SIZE:
+            next = rows[ViewReport.PAGE_SIZE - 1][0]
 
-    def _wrap_code(self, source):
-        view_report = View.get().report
-        lines_reports = view_report.files_lines_reports[self.file.id]
+        return {
+            'checks': builder.checks,
+            'functions': builder.functions,
+            'call_contexts': builder.call_contexts,
+            'next': next,
+        }
 
-        yield 0, '<div class="highlight">\n'
-        line_num = 1
 
-        for i, line in source:
-            statement_reports = lines_reports.get(line_num)
+class ChecksBuilder:
+    ''' Build the checks of a page, with their functions and call contexts '''
 
-            t = '''<div id="L%d" class="line_wrap status_%d">
-                     <span class="line_number">
-                      <a href="#L%d">%d</a>
-                     </span>
-                     <span class="line_content">
-                       <span class="line_code_wrap">
-                         <span class="line_code">
-                           <pre>%s</pre>
-                         </span>
-                         <span class="checks_toggle hidden">
-                           <a href="javascript:" class="toggle">&#128065;</a>
-                         </span>
-                       </span>
-                       <span class="checks hidden"></span>
-                     </span>
-                   </div>\n''' % (line_num,
-                                  self._line_status(statement_reports),
-                                  line_num,
-                                  line_num,
-                                  line.replace('\n', ''))
-
-            if statement_reports:
-                self.checks[line_num] = self._build_checks(statement_reports)
-
-            yield i, t
-            line_num += 1
-
-        yield 0, '</div>'
+    def __init__(self, db):
+        self.db = db
+        self.functions = {}
+        self.call_contexts = {}
 
-    def _line_status(self, statement_reports):
-        ''' Return the status of a source line '''
-        if not statement_reports:
-            return -1
-
-        status = [0, 0, 0, 0]
-        for statement_report in statement_reports:
-            status[statement_report.status] += 1
-
-        if status[Result.ERROR] > 0:
-            return Result.ERROR
-        elif status[Result.WARNING] > 0:
-            return Result.WARNING
-        elif status[Result.UNREACHABLE] > 0:
-            return Result.UNREACHABLE
-        else:
-            return Result.OK
-
-    def _build_checks(self, statement_reports):
-        ''' Return the list of check for a source line '''
-        checks = []
-
-        for statement_report in statement_reports:
-            statement = statement_report.statement()
-            checks.append({
-                'kind': statement_report.kind,
-                'status': statement_report.status,
-                'column': statement.column_or('?'),
-                'message': report.generate_message(statement_report, 4),
-                'function_id': statement.function_id,
-                'call_context_ids': statement_report.call_context_ids,
-            })
-            self._build_function(statement.function())
-            self._build_call_contexts(statement_report.call_contexts())
+        # Map[line, List[check]]
+        self.checks = {}
 
-        # Sort by status (error > warning > ok)
-        checks.sort(key=operator.itemgetter('status'), reverse=True)
+    def add(self, row):
+        ''' Add a row of the summary_reports table '''
+        (_, line, column, function_id, kind, status, statement_id,
+         call_context_ids, operands, info) = row
+
+        call_context_ids = sorted(map(int, call_context_ids.split(',')))
+        statement_report = report.StatementReport(
+            db=self.db,
+            kind=kind,
+            status=status,
+            statement_id=statement_id,
+            call_context_ids=call_context_ids,
+            operands=operands,
+            info=info)
+
+        if line not in self.checks:
+            self.checks[line] = []
+        self.checks[line].append({
+            'kind': kind,
+            'status': status,
+            'column': column if column is not None else '?',
+            'message': report.generate_message(statement_report, 4),
+            'function_id': function_id,
+            'call_context_ids': call_context_ids,
+        })
 
-        return checks
+        self._build_function(self.db.functions[function_id])
+        self._build_call_contexts(statement_report.call_contexts())
 
     def _build_function(self, function):
         if function.id in self.functions:
@@ -536,6 +833,48 @@ class Formatter(HtmlFormatter):
         self.call_contexts[call_context_id] = '\n'.join(lines)
 
 
+class Formatter(HtmlFormatter):
+    ''' Source code HTML formatter '''
+
+    def __init__(self, lines_status):
+        super(Formatter, self).__init__()
+        self.lines_status = lines_status
+
+    def wrap(self, source, outfile=None):
+        return self._wrap_code(source)
+
+    def _wrap_code(self, source):
+        yield 0, '<div class="highlight">\n'
+        line_num = 1
+
+        for i, line in source:
+            t = '''<div id="L%d" class="line_wrap status_%d">
+                     <span class="line_number">
+                      <a href="#L%d">%d</a>
+                     </span>
+                     <span class="line_content">
+                       <span class="line_code_wrap">
+                         <span class="line_code">
+                           <pre>%s</pre>
+                         </span>
+                         <span class="checks_toggle hidden">
+                           <a href="javascript:" class="toggle">&#128065;</a>
+                         </span>
+                       </span>
+                       <span class="checks hidden"></span>
+                     </span>
+                   </div>\n''' % (line_num,
+                                  self.lines_status.get(line_num, -1),
+                                  line_num,
+                                  line_num,
+                                  line.replace('\n', ''))
+
+            yield i, t
+            line_num += 1
+
+        yield 0, '</div>'
+
+
 ##########################
 # command line interface #
 ##########################
@@ -581,6 +920,26 @@ def parse_arguments(argv):
                         help='Listening port',
                         default=8080,
                         type=int)
+    parser.add_argument('--export',
+                        dest='export',
+                        metavar='<directory>',
+                        help='Write every page in the given directory, to be '
+                             'served by a web server,\ninstead of starting '
+                             'the HTTP server',
+                        default=None)
+    parser.add_argument('-j', '--jobs',
+                        dest='jobs',
+                        metavar='<n>',
+                        type=int,
+                        help='Number of processes rendering the pages of '
+                             '--export\n(default: number of CPUs)',
+                        default=multiprocessing.cpu_count())
+    parser.add_argument('--live',
+                        dest='live',
+                        help='Refresh the pages while ikos-analyzer '
+                             'writes the database\n(see ikos --live-db)',
+                        action='store_true',
+                        default=False)
 
     return parser.parse_args(argv)
 
@@ -609,16 +968,25 @@ def main(argv):
                progname, opt.file, file=sys.stderr)
         sys.exit(1)
 
+    if opt.live and opt.export:
+        printf("%s: error: --live and --export are incompatible\n",
+               progname, file=sys.stderr)
+        sys.exit(1)
+
     try:
         # open result database
-        db = OutputDatabase(opt.file)
-
-        v = View(db, port=opt.port)
-        browser_timer = threading.Timer(0.1,
-                                        open_browser,
-                                        ['http://localhost:%d/' % opt.port])
-        browser_timer.start()
-        v.serve()
+        db = OutputDatabase(opt.file, check_same_thread=False)
+
+        if opt.export:
+            Export(db, opt.file, opt.export, max(opt.jobs, 1)).run()
+        else:
+            v = View(db, port=opt.port, live=opt.live)
+            browser_timer = threading.Timer(0.1,
+                                            open_browser,
+                                            ['http://localhost:%d/'
+                                             % opt.port])
+            browser_timer.start()
+            v.serve()
 
         # close database
         db.close()
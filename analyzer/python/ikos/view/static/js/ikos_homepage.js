@@ -69,7 +69,8 @@ function init_files_list(e) {
 
     var a = document.createElement('a');
     a.className = 'file_link';
-    a.href = '/report/' + file.id + '?k=' + check_kinds_filter_param;
+    a.href = window.report_url.replace('%d', file.id)
+           + '?k=' + check_kinds_filter_param;
     a.appendChild(document.createTextNode(file.path));
 
     var td_name = document.createElement('td');
@@ -114,6 +115,29 @@ function count_checks(kinds) {
   return value;
 }
 
+/** Poll the key of the analysis results, and reload the page when it changes
+ *
+ * param e - event
+ */
+function init_live(e) {
+  if (window.live === null) {
+    return;
+  }
+
+  window.setInterval(function() {
+    var request = new XMLHttpRequest();
+    request.open('GET', window.live.url);
+    request.responseType = 'json';
+    request.addEventListener('load', function(e) {
+      if (request.status === 200 && request.response.key !== window.live.key) {
+        window.location.reload();
+      }
+    });
+    request.send();
+  }, 5000);
+}
+
 /** load event */
 window.addEventListener('load', init_check_kinds_list);
 window.addEventListener('load', init_files_list);
+window.addEventListener('load', init_live);
@@ -1,25 +1,92 @@
-/** Init the list of checks
+/** Load the checks, one page at a time
  *
  * param e - event
  */
 function init_checks(e) {
-  for (var line_num in window.checks) {
-    var checks = window.checks[line_num];
+  load_checks_page(0);
+}
+
+/** Load a page of checks from the server
+ *
+ * param after - position of the last check of the previous page
+ */
+function load_checks_page(after) {
+  var request = new XMLHttpRequest();
+  request.open('GET', window.checks_url.replace('%d', after));
+  request.responseType = 'json';
+  request.addEventListener('load', function(e) {
+    if (request.status !== 200) {
+      return;
+    }
+
+    var page = request.response;
+    Object.assign(window.functions, page.functions);
+    Object.assign(window.call_contexts, page.call_contexts);
+    add_checks(page.checks);
+
+    if (page.next !== null) {
+      load_checks_page(page.next);
+    }
+  });
+  request.send();
+}
+
+/** Add checks to the source lines, applying the current filters
+ *
+ * param checks - map from line numbers to lists of checks
+ */
+function add_checks(checks) {
+  var updated_lines = [];
+
+  for (var line_num in checks) {
+    var line_checks = checks[line_num];
     var line_wrap = document.getElementById('L' + line_num);
+    if (line_wrap === null) {
+      continue; // Source file has changed since the analysis
+    }
 
-    // Init checks box
+    // Fill checks box
     var checks_box = line_wrap.getElementsByClassName('checks')[0];
-    for (var i = 0; i < checks.length; i++) {
-      var check_line = create_check_line(line_num, checks[i]);
+    for (var i = 0; i < line_checks.length; i++) {
+      var check = line_checks[i];
+      var check_line = create_check_line(line_num, check);
+
+      if (!window.check_kinds_filter[check.kind]) {
+        check_line.classList.add('kind_hidden');
+      }
+      if (!is_status_checked(check.status)) {
+        check_line.classList.add('status_hidden');
+      }
+
       checks_box.appendChild(check_line);
     }
-    checks_box.classList.remove('hidden')
 
     // Init toggle button
     var toggle = line_wrap.getElementsByClassName('toggle')[0];
-    toggle.addEventListener('click', toggle_checks);
-    toggle.parentNode.classList.remove('hidden');
+    if (toggle.parentNode.classList.contains('hidden')) {
+      toggle.addEventListener('click', toggle_checks);
+      toggle.parentNode.classList.remove('hidden');
+    }
+
+    updated_lines.push(line_num);
   }
+
+  // Show/Hide checks boxes
+  update_checks_boxes(updated_lines);
+}
+
+/** Return true if the status checkbox for the given status is checked
+ *
+ * param status - the status
+ */
+function is_status_checked(status) {
+  var checkboxs = document.getElementsByClassName('checkbox_status');
+  for (var i = 0; i < checkboxs.length; i++) {
+    if (checkboxs[i].value == status) {
+      return checkboxs[i].checked;
+    }
+  }
+  return true;
 }
 
 /** Create a check line
@@ -62,6 +129,30 @@ function create_check_line(line_num, check) {
   return check_line;
 }
 
+/** Read the check kinds filter from the URL parameter
+ *
+ * The server applies the parameter itself, this is only needed for the pages
+ * exported with ikos-view --export.
+ *
+ * param e - event
+ */
+function read_check_kinds_filter(e) {
+  var match = /[?&]k=([0-9A-Fa-f]*)/.exec(window.location.search);
+  if (!window.static_export || match === null) {
+    return;
+  }
+
+  var param = match[1];
+  for (var i = 0; i < window.check_kinds.length; i++) {
+    var kind = window.check_kinds[i].id;
+    var byte_index = Math.floor(kind / 8);
+    if (2 * byte_index + 2 <= param.length) {
+      var byte = parseInt(param.substr(2 * byte_index, 2), 16);
+      window.check_kinds_filter[kind] = (byte & (1 << (kind % 8))) !== 0;
+    }
+  }
+}
+
 /** Initialize the list of check kinds
  *
  * param e - event
@@ -405,9 +496,33 @@ function close_modal(e) {
   modal.classList.add('hidden');
 }
 
+/** Poll the key of the analysis results, and reload the page when it changes
+ *
+ * param e - event
+ */
+function init_live(e) {
+  if (window.live === null) {
+    return;
+  }
+
+  window.setInterval(function() {
+    var request = new XMLHttpRequest();
+    request.open('GET', window.live.url);
+    request.responseType = 'json';
+    request.addEventListener('load', function(e) {
+      if (request.status === 200 && request.response.key !== window.live.key) {
+        window.location.reload();
+      }
+    });
+    request.send();
+  }, 5000);
+}
+
 //** load events */
+window.addEventListener('load', read_check_kinds_filter);
 window.addEventListener('load', init_checks);
 window.addEventListener('load', init_check_kinds_list);
 window.addEventListener('load', init_status_checkbox);
 window.addEventListener('load', init_navigators);
 window.addEventListener('load', init_call_contexts_modals);
+window.addEventListener('load', init_live);
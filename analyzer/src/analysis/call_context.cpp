@@ -41,28 +41,50 @@
  *
  ******************************************************************************/
 
+#include <llvm/ADT/SmallVector.h>
+
 #include <ikos/analyzer/analysis/call_context.hpp>
 
 namespace ikos {
 namespace analyzer {
 
-CallContextFactory::CallContextFactory()
-    : _empty_call_context(new CallContext()) {}
+CallContextFactory::CallContextFactory(boost::optional< unsigned > max_depth)
+    : _empty_call_context(new CallContext()), _max_depth(max_depth) {}
 
 CallContextFactory::~CallContextFactory() = default;
 
 CallContext* CallContextFactory::get_context(CallContext* parent,
                                              ar::CallBase* call) {
   ikos_assert(parent != nullptr && call != nullptr);
-  auto it = this->_map.find({parent, call});
-  if (it == this->_map.end()) {
-    auto call_context = new CallContext(parent, call);
-    this->_map.try_emplace({parent, call},
-                           std::unique_ptr< CallContext >(call_context));
-    return call_context;
-  } else {
-    return it->second.get();
+
+  if (!this->is_truncated(parent)) {
+    return this->get_or_create(parent, call);
+  }
+
+  unsigned max_depth = *this->_max_depth;
+  if (max_depth == 0) {
+    return this->get_empty();
+  }
+
+  // Keep the last `max_depth - 1` calls of the parent
+  llvm::SmallVector< ar::CallBase*, 8 > calls;
+  for (CallContext* c = parent; calls.size() + 1 < max_depth && !c->empty();
+       c = c->parent()) {
+    calls.push_back(c->call());
+  }
+
+  CallContext* context = this->get_empty();
+  for (auto it = calls.rbegin(), et = calls.rend(); it != et; ++it) {
+    context = this->get_or_create(context, *it);
   }
+  return this->get_or_create(context, call);
+}
+
+CallContext* CallContextFactory::get_or_create(CallContext* parent,
+                                               ar::CallBase* call) {
+  return this->_map.get_or_create(std::make_pair(parent, call), [=] {
+    return std::unique_ptr< CallContext >(new CallContext(parent, call));
+  });
 }
 
 } // end namespace analyzer
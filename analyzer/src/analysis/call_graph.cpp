@@ -0,0 +1,221 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the call graph analysis
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <ostream>
+
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/function.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+#include <ikos/ar/semantic/value.hpp>
+
+#include <ikos/analyzer/analysis/call_graph.hpp>
+#include <ikos/analyzer/support/cast.hpp>
+#include <ikos/analyzer/util/demangle.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+/// \brief Return the functions with a definition directly called by `fun`
+std::vector< ar::Function* > direct_callees(ar::Function* fun) {
+  std::vector< ar::Function* > callees;
+  for (ar::BasicBlock* bb : *fun->body()) {
+    for (ar::Statement* stmt : *bb) {
+      auto call = dyn_cast< ar::CallBase >(stmt);
+      if (call == nullptr) {
+        continue;
+      }
+      auto cst = dyn_cast< ar::FunctionPointerConstant >(call->called());
+      if (cst != nullptr && cst->function()->is_definition()) {
+        callees.push_back(cst->function());
+      }
+    }
+  }
+  std::sort(callees.begin(), callees.end());
+  callees.erase(std::unique(callees.begin(), callees.end()), callees.end());
+  return callees;
+}
+
+/// \brief Tarjan's algorithm on the call graph, without recursion
+class CallGraphSccBuilder {
+private:
+  /// \brief State of a function during the visit
+  struct Node {
+    std::size_t index;
+    std::size_t lowlink;
+    bool on_stack;
+    std::vector< ar::Function* > callees;
+  };
+
+  /// \brief Frame of the depth-first search
+  struct Frame {
+    ar::Function* fun;
+    std::size_t next;
+  };
+
+private:
+  llvm::DenseMap< ar::Function*, Node > _nodes;
+  std::vector< ar::Function* > _stack;
+  std::size_t _next_index = 0;
+
+public:
+  /// \brief Visit the given function, calling `f` on each component found
+  template < typename Function >
+  void visit(ar::Function* root, Function f) {
+    if (this->_nodes.find(root) != this->_nodes.end()) {
+      return;
+    }
+
+    std::vector< Frame > frames;
+    this->enter(root);
+    frames.push_back(Frame{root, 0});
+
+    while (!frames.empty()) {
+      Frame& frame = frames.back();
+      Node& node = this->_nodes[frame.fun];
+
+      if (frame.next < node.callees.size()) {
+        ar::Function* callee = node.callees[frame.next++];
+        auto it = this->_nodes.find(callee);
+        if (it == this->_nodes.end()) {
+          this->enter(callee);
+          frames.push_back(Frame{callee, 0});
+        } else if (it->second.on_stack) {
+          node.lowlink = std::min(node.lowlink, it->second.index);
+        }
+        continue;
+      }
+
+      ar::Function* fun = frame.fun;
+      frames.pop_back();
+
+      if (node.lowlink == node.index) {
+        std::vector< ar::Function* > component;
+        ar::Function* member = nullptr;
+        do {
+          member = this->_stack.back();
+          this->_stack.pop_back();
+          this->_nodes[member].on_stack = false;
+          component.push_back(member);
+        } while (member != fun);
+        f(std::move(component), node.callees);
+      }
+
+      if (!frames.empty()) {
+        Node& parent = this->_nodes[frames.back().fun];
+        parent.lowlink = std::min(parent.lowlink, this->_nodes[fun].lowlink);
+      }
+    }
+  }
+
+private:
+  /// \brief Push a new function on the stack
+  void enter(ar::Function* fun) {
+    std::size_t index = this->_next_index++;
+    this->_nodes[fun] = Node{index, index, true, direct_callees(fun)};
+    this->_stack.push_back(fun);
+  }
+
+}; // end class CallGraphSccBuilder
+
+} // end anonymous namespace
+
+CallGraphAnalysis::CallGraphAnalysis(Context& ctx) : _ctx(ctx) {}
+
+CallGraphAnalysis::~CallGraphAnalysis() = default;
+
+void CallGraphAnalysis::run() {
+  ar::Bundle* bundle = _ctx.bundle;
+
+  CallGraphSccBuilder builder;
+  for (auto it = bundle->function_begin(), et = bundle->function_end();
+       it != et;
+       ++it) {
+    ar::Function* fun = *it;
+    if (!fun->is_definition()) {
+      continue;
+    }
+
+    builder.visit(fun,
+                  [this](std::vector< ar::Function* > component,
+                         const std::vector< ar::Function* >& callees) {
+                    if (component.size() == 1 &&
+                        !std::binary_search(callees.begin(),
+                                            callees.end(),
+                                            component.front())) {
+                      // Not recursive
+                      return;
+                    }
+
+                    std::size_t index = this->_components.size();
+                    for (ar::Function* member : component) {
+                      this->_map.try_emplace(member, index);
+                    }
+                    this->_components.push_back(std::move(component));
+                  });
+  }
+}
+
+bool CallGraphAnalysis::same_component(ar::Function* f,
+                                       ar::Function* g) const {
+  auto f_it = this->_map.find(f);
+  if (f_it == this->_map.end()) {
+    return false;
+  }
+  auto g_it = this->_map.find(g);
+  return g_it != this->_map.end() && f_it->second == g_it->second;
+}
+
+void CallGraphAnalysis::dump(std::ostream& o) const {
+  for (const auto& component : this->_components) {
+    o << "recursive component:" << std::endl;
+    for (ar::Function* fun : component) {
+      o << " • " << demangle(fun) << std::endl;
+    }
+  }
+}
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,353 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the cost estimate analysis
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <limits>
+#include <ostream>
+
+#include <llvm/ADT/DenseSet.h>
+
+#include <ikos/core/fixpoint/wto.hpp>
+
+#include <ikos/ar/semantic/bundle.hpp>
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+#include <ikos/ar/semantic/value.hpp>
+
+#include <ikos/analyzer/analysis/call_graph.hpp>
+#include <ikos/analyzer/analysis/cost_estimate.hpp>
+#include <ikos/analyzer/analysis/fixpoint_profile.hpp>
+#include <ikos/analyzer/support/cast.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+/// \brief Maximum number of calling contexts, to avoid overflows
+constexpr std::uint64_t MaxContexts = std::uint64_t(1) << 40;
+
+/// \brief Compute the maximum nesting depth of the cycles of a wto
+class WtoDepthVisitor : public core::WtoComponentVisitor< ar::Code* > {
+private:
+  using WtoVertexT = core::WtoVertex< ar::Code* >;
+  using WtoCycleT = core::WtoCycle< ar::Code* >;
+
+private:
+  /// \brief Depth of the current component
+  unsigned _depth = 0;
+
+  /// \brief Maximum depth
+  unsigned _max_depth = 0;
+
+public:
+  /// \brief Constructor
+  WtoDepthVisitor() = default;
+
+  /// \brief Deleted copy constructor
+  WtoDepthVisitor(const WtoDepthVisitor&) = delete;
+
+  /// \brief Deleted move constructor
+  WtoDepthVisitor(WtoDepthVisitor&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  WtoDepthVisitor& operator=(const WtoDepthVisitor&) = delete;
+
+  /// \brief Deleted move assignment operator
+  WtoDepthVisitor& operator=(WtoDepthVisitor&&) = delete;
+
+  /// \brief Destructor
+  ~WtoDepthVisitor() override = default;
+
+  void visit(const WtoVertexT&) override {}
+
+  void visit(const WtoCycleT& cycle) override {
+    this->_depth++;
+    this->_max_depth = std::max(this->_max_depth, this->_depth);
+    for (auto it = cycle.begin(), et = cycle.end(); it != et; ++it) {
+      it->accept(*this);
+    }
+    this->_depth--;
+  }
+
+  /// \brief Return the maximum depth
+  unsigned max_depth() const { return this->_max_depth; }
+
+}; // end class WtoDepthVisitor
+
+/// \brief Return the number of direct calls to each function with a
+/// definition, in the given function
+llvm::DenseMap< ar::Function*, std::uint64_t > direct_calls(
+    ar::Function* fun) {
+  llvm::DenseMap< ar::Function*, std::uint64_t > calls;
+  for (ar::BasicBlock* bb : *fun->body()) {
+    for (ar::Statement* stmt : *bb) {
+      auto call = dyn_cast< ar::CallBase >(stmt);
+      if (call == nullptr) {
+        continue;
+      }
+      auto cst = dyn_cast< ar::FunctionPointerConstant >(call->called());
+      if (cst != nullptr && cst->function()->is_definition()) {
+        calls[cst->function()]++;
+      }
+    }
+  }
+  return calls;
+}
+
+/// \brief Return the number of statements of the given function
+std::uint64_t num_statements(ar::Function* fun) {
+  std::uint64_t n = 0;
+  for (ar::BasicBlock* bb : *fun->body()) {
+    n += bb->num_statements();
+  }
+  return n;
+}
+
+/// \brief Return the number of internal and local variables of the given
+/// function
+std::uint64_t num_variables(ar::Function* fun) {
+  return static_cast< std::uint64_t >(
+      std::distance(fun->body()->internal_variable_begin(),
+                    fun->body()->internal_variable_end()) +
+      std::distance(fun->local_variable_begin(), fun->local_variable_end()));
+}
+
+} // end anonymous namespace
+
+CostEstimateAnalysis::CostEstimateAnalysis(Context& ctx) : _ctx(ctx) {}
+
+CostEstimateAnalysis::~CostEstimateAnalysis() = default;
+
+void CostEstimateAnalysis::run() {
+  ar::Bundle* bundle = this->_ctx.bundle;
+  bool interprocedural =
+      this->_ctx.opts.procedural == Procedural::Interprocedural;
+
+  llvm::DenseMap< ar::Function*, std::uint64_t > contexts;
+  if (interprocedural) {
+    contexts = this->calling_contexts();
+  }
+
+  for (auto it = bundle->function_begin(), et = bundle->function_end();
+       it != et;
+       ++it) {
+    ar::Function* fun = *it;
+    if (!fun->is_definition()) {
+      continue;
+    }
+
+    FunctionCostEstimate estimate{};
+    estimate.function = fun;
+    if (interprocedural) {
+      auto ctx_it = contexts.find(fun);
+      if (ctx_it == contexts.end()) {
+        // Not reachable from the entry points
+        continue;
+      }
+      estimate.contexts = ctx_it->second;
+    } else {
+      estimate.contexts = 1;
+    }
+
+    estimate.statements = num_statements(fun);
+    WtoDepthVisitor visitor;
+    this->_ctx.wto_cache->get(fun->body()).accept(visitor);
+    estimate.wto_depth = visitor.max_depth();
+    estimate.fan_out = direct_calls(fun).size();
+    estimate.variables = num_variables(fun);
+    estimate.cost = static_cast< double >(fixpoint_cost(this->_ctx, fun)) *
+                    static_cast< double >(estimate.contexts) *
+                    this->domain_factor(estimate.variables);
+    this->_estimates.push_back(estimate);
+  }
+
+  std::stable_sort(this->_estimates.begin(),
+                   this->_estimates.end(),
+                   [](const FunctionCostEstimate& a,
+                      const FunctionCostEstimate& b) {
+                     return a.cost > b.cost;
+                   });
+}
+
+llvm::DenseMap< ar::Function*, std::uint64_t > CostEstimateAnalysis::
+    calling_contexts() const {
+  // Functions reachable from the entry points, through direct calls
+  llvm::DenseMap< ar::Function*,
+                  llvm::DenseMap< ar::Function*, std::uint64_t > >
+      callees;
+  llvm::DenseSet< ar::Function* > entry_points;
+  std::vector< ar::Function* > worklist;
+  for (ar::Function* fun : this->_ctx.opts.entry_points) {
+    if (fun->is_definition() && entry_points.insert(fun).second) {
+      worklist.push_back(fun);
+    }
+  }
+  while (!worklist.empty()) {
+    ar::Function* fun = worklist.back();
+    worklist.pop_back();
+    if (callees.find(fun) != callees.end()) {
+      continue;
+    }
+    auto calls = direct_calls(fun);
+    for (const auto& call : calls) {
+      if (callees.find(call.first) == callees.end()) {
+        worklist.push_back(call.first);
+      }
+    }
+    callees.try_emplace(fun, std::move(calls));
+  }
+
+  // Number of call strings of at most `depth` calls ending in a function,
+  // computed for increasing depths until it stabilizes
+  //
+  // Each function has at least one calling context, including the functions
+  // only called from their own recursive component.
+  const CallGraphAnalysis* call_graph = this->_ctx.call_graph;
+  llvm::DenseMap< ar::Function*, std::uint64_t > contexts;
+  for (const auto& item : callees) {
+    contexts[item.first] = 1;
+  }
+
+  unsigned max_depth = this->_ctx.opts.context_depth
+                           ? *this->_ctx.opts.context_depth
+                           : std::numeric_limits< unsigned >::max();
+  for (unsigned depth = 1; depth <= max_depth; depth++) {
+    llvm::DenseMap< ar::Function*, std::uint64_t > next;
+    for (const auto& item : callees) {
+      next[item.first] = entry_points.count(item.first) != 0 ? 1 : 0;
+    }
+    for (const auto& item : callees) {
+      ar::Function* caller = item.first;
+      for (const auto& call : item.second) {
+        ar::Function* callee = call.first;
+        if (call_graph != nullptr &&
+            call_graph->same_component(caller, callee)) {
+          continue;
+        }
+        std::uint64_t& n = next[callee];
+        n = std::min(n + std::min(call.second * contexts[caller], MaxContexts),
+                     MaxContexts);
+      }
+    }
+
+    bool stable = true;
+    for (auto& item : next) {
+      item.second = std::max(item.second, std::uint64_t(1));
+      if (item.second != contexts[item.first]) {
+        stable = false;
+      }
+    }
+    contexts = std::move(next);
+    if (stable) {
+      break;
+    }
+  }
+  return contexts;
+}
+
+double CostEstimateAnalysis::domain_factor(std::uint64_t variables) const {
+  // Width of the relations: all the variables, or the size of a pack
+  double width = static_cast< double >(std::max(variables, std::uint64_t(1)));
+  double pack =
+      std::min(width, static_cast< double >(this->_ctx.opts.max_pack_size));
+
+  // Weakly relational domains are linear in the width, thanks to the
+  // incremental closure. Polyhedra and linear equalities are quadratic.
+  switch (this->_ctx.opts.machine_int_domain) {
+    case MachineIntDomainOption::Interval:
+    case MachineIntDomainOption::DenseInterval:
+    case MachineIntDomainOption::Congruence:
+    case MachineIntDomainOption::IntervalCongruence:
+    case MachineIntDomainOption::IntervalEquality:
+    case MachineIntDomainOption::Gauge:
+    case MachineIntDomainOption::GaugeIntervalCongruence:
+    case MachineIntDomainOption::PowersetInterval:
+    case MachineIntDomainOption::ApronInterval:
+      return 1.0;
+    case MachineIntDomainOption::DBM:
+    case MachineIntDomainOption::SplitDBM:
+    case MachineIntDomainOption::ApronOctagon:
+      return width;
+    case MachineIntDomainOption::VarPackDBM:
+    case MachineIntDomainOption::VarPackDBMCongruence:
+    case MachineIntDomainOption::StaticPackDBM:
+    case MachineIntDomainOption::VarPackApronOctagon:
+      return pack;
+    case MachineIntDomainOption::ApronPolkaPolyhedra:
+    case MachineIntDomainOption::ApronPolkaLinearEqualities:
+    case MachineIntDomainOption::ApronPplPolyhedra:
+    case MachineIntDomainOption::ApronPplLinearCongruences:
+    case MachineIntDomainOption::ApronPkgridPolyhedraLinearCongruences:
+      return width * width;
+    case MachineIntDomainOption::VarPackApronPolkaPolyhedra:
+    case MachineIntDomainOption::VarPackApronPolkaLinearEqualities:
+    case MachineIntDomainOption::VarPackApronPplPolyhedra:
+    case MachineIntDomainOption::VarPackApronPplLinearCongruences:
+    case MachineIntDomainOption::VarPackApronPkgridPolyhedraLinearCongruences:
+      return pack * pack;
+  }
+  return 1.0;
+}
+
+double CostEstimateAnalysis::total_cost() const {
+  double total = 0;
+  for (const FunctionCostEstimate& estimate : this->_estimates) {
+    total += estimate.cost;
+  }
+  return total;
+}
+
+void CostEstimateAnalysis::dump(std::ostream& o) const {
+  o << "# function statements wto-depth fan-out contexts variables cost\n";
+  for (const FunctionCostEstimate& estimate : this->_estimates) {
+    o << estimate.function->name() << ' ' << estimate.statements << ' '
+      << estimate.wto_depth << ' ' << estimate.fan_out << ' '
+      << estimate.contexts << ' ' << estimate.variables << ' '
+      << estimate.cost << '\n';
+  }
+  o << "# total " << this->total_cost() << std::endl;
+}
+
+} // end namespace analyzer
+} // end namespace ikos
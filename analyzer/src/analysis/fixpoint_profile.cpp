@@ -41,18 +41,114 @@
  *
  ******************************************************************************/
 
+#include <algorithm>
+
 #include <ikos/core/fixpoint/wto.hpp>
 
 #include <ikos/ar/semantic/statement.hpp>
 
 #include <ikos/analyzer/analysis/fixpoint_profile.hpp>
 #include <ikos/analyzer/support/cast.hpp>
+#include <ikos/analyzer/util/thread_pool.hpp>
 
 namespace ikos {
 namespace analyzer {
 
+const std::size_t FixpointProfileAnalysis::MaxWideningThresholds = 8;
+
+const unsigned FixpointProfileAnalysis::MaxJoinIterations = 3;
+
 namespace {
 
+/// \brief Return the constant of the given comparison, adjusted so that it can
+/// be used as a widening threshold, or boost::none
+boost::optional< ar::MachineInt > extract_constant(ar::Comparison* cmp) {
+  ar::IntegerConstant* constant = nullptr;
+  bool cst_left;
+
+  if (cmp->left()->is_integer_constant()) {
+    constant = cast< ar::IntegerConstant >(cmp->left());
+    cst_left = true;
+  } else if (cmp->right()->is_integer_constant()) {
+    constant = cast< ar::IntegerConstant >(cmp->right());
+    cst_left = false;
+  } else {
+    return boost::none;
+  }
+
+  ar::MachineInt value = constant->value();
+  ar::MachineInt one(1, value.bit_width(), value.sign());
+  bool overflow = false;
+
+  // check if the comparison is <= or >=
+  if (cmp->predicate() == ar::Comparison::UIGE ||
+      cmp->predicate() == ar::Comparison::SIGE) {
+    if (cst_left) {
+      // case `cst >= var` <=> `cst + 1 > var`
+      value = add(value, one, overflow);
+    } else {
+      // case `var >= cst` <=> `var > cst - 1`
+      value = sub(value, one, overflow);
+    }
+  } else if (cmp->predicate() == ar::Comparison::UILE ||
+             cmp->predicate() == ar::Comparison::SILE) {
+    if (cst_left) {
+      // case `cst <= var` <=> `cst - 1 < var`
+      value = sub(value, one, overflow);
+    } else {
+      // case `var <= cst` <=> `var < cst + 1`
+      value = add(value, one, overflow);
+    }
+  }
+  if (overflow) {
+    return boost::none;
+  }
+  return value;
+}
+
+/// \brief Return the constant of the loop guard starting the given basic
+/// block, or boost::none
+boost::optional< ar::MachineInt > extract_guard_constant(ar::BasicBlock* bb) {
+  if (bb->empty()) {
+    return boost::none;
+  }
+
+  // we have a comparison, check if there is a constant
+  if (auto cmp = dyn_cast< ar::Comparison >(bb->front())) {
+    return extract_constant(cmp);
+  } else {
+    return boost::none;
+  }
+}
+
+/// \brief Collect the sizes of the local arrays of the given function
+std::vector< ar::MachineInt > collect_array_sizes(ar::Function* fun) {
+  std::vector< ar::MachineInt > sizes;
+  ar::IntegerType* size_type = ar::IntegerType::size_type(fun->bundle());
+
+  for (ar::BasicBlock* bb : *fun->body()) {
+    for (ar::Statement* stmt : *bb) {
+      auto alloc = dyn_cast< ar::Allocate >(stmt);
+      if (alloc == nullptr) {
+        continue;
+      }
+      ar::Type* type = alloc->allocated_type();
+      if (auto array_type = dyn_cast< ar::ArrayType >(type)) {
+        sizes.emplace_back(array_type->num_elements(),
+                           size_type->bit_width(),
+                           size_type->sign());
+      }
+      if (auto cst = dyn_cast< ar::IntegerConstant >(alloc->array_size())) {
+        if (cst->value().to_z_number() > 1) {
+          sizes.push_back(cst->value());
+        }
+      }
+    }
+  }
+
+  return sizes;
+}
+
 class FixpointProfileWtoVisitor
     : public core::WtoComponentVisitor< ar::Code* > {
 private:
@@ -60,16 +156,40 @@ private:
   using WtoCycleT = core::WtoCycle< ar::Code* >;
 
 private:
-  llvm::DenseMap< ar::BasicBlock*, std::unique_ptr< core::MachineInt > >*
+  llvm::DenseMap< ar::BasicBlock*, std::vector< core::MachineInt > >*
       _collector;
 
+  /// \brief Cycle heads that are not widening points
+  llvm::DenseSet< ar::BasicBlock* >* _join_heads;
+
+  /// \brief Sizes of the local arrays of the function
+  std::vector< ar::MachineInt > _array_sizes;
+
+  /// \brief Candidate thresholds of the cycles currently visited
+  std::vector< std::vector< ar::MachineInt > > _candidates;
+
+  /// \brief Basic blocks of the cycles currently visited
+  std::vector< llvm::DenseSet< ar::BasicBlock* > > _components;
+
+  /// \brief Widening points selected so far
+  llvm::DenseSet< ar::BasicBlock* > _widening_points;
+
+  /// \brief Cycle heads visited so far
+  std::vector< ar::BasicBlock* > _heads;
+
 public:
   /// \brief Default constructor
-  explicit FixpointProfileWtoVisitor(
-      llvm::DenseMap< ar::BasicBlock*, std::unique_ptr< core::MachineInt > >*
-          collector) {
-    this->_collector = collector;
-  }
+  FixpointProfileWtoVisitor(
+      llvm::DenseMap< ar::BasicBlock*, std::vector< core::MachineInt > >*
+          collector,
+      llvm::DenseSet< ar::BasicBlock* >* join_heads,
+      std::vector< ar::MachineInt > array_sizes)
+      : _collector(collector),
+        _join_heads(join_heads),
+        _array_sizes(std::move(array_sizes)) {}
+
+  /// \brief Return the cycle heads, innermost first
+  const std::vector< ar::BasicBlock* >& heads() const { return this->_heads; }
 
   /// \brief Default copy constructor
   FixpointProfileWtoVisitor(const FixpointProfileWtoVisitor&) = delete;
@@ -87,89 +207,225 @@ public:
   /// \brief Destructor
   ~FixpointProfileWtoVisitor() override = default;
 
-  void visit(const WtoVertexT&) override {}
+  void visit(const WtoVertexT& vertex) override {
+    this->collect_constants(vertex.node());
+    this->add_to_components(vertex.node());
+  }
 
   void visit(const WtoCycleT& cycle) override {
     auto head = cycle.head();
 
-    if (head->num_successors() > 1) {
-      auto successor = *(head->successor_begin());
-      if (auto constant = this->extract_constant(successor)) {
-        this->_collector->try_emplace(head,
-                                      std::make_unique< ar::MachineInt >(
-                                          *constant));
-      }
-    }
+    this->_candidates.emplace_back(this->_array_sizes);
+    this->collect_constants(head);
+    this->add_to_components(head);
+    this->_components.emplace_back();
 
     for (auto it = cycle.begin(), et = cycle.end(); it != et; ++it) {
       it->accept(*this);
     }
-  }
 
-  boost::optional< ar::MachineInt > extract_constant(ar::BasicBlock* bb) const {
-    if (bb->empty()) {
-      return boost::none;
+    std::vector< ar::MachineInt > candidates =
+        std::move(this->_candidates.back());
+    this->_candidates.pop_back();
+
+    llvm::DenseSet< ar::BasicBlock* > component =
+        std::move(this->_components.back());
+    this->_components.pop_back();
+
+    // Nested cycles are visited first, so their widening points are known
+    this->_heads.push_back(head);
+    if (this->has_cycle(head, component)) {
+      this->_widening_points.insert(head);
+    } else {
+      this->_join_heads->insert(head);
     }
 
-    // we have a comparison, check if there is a constant
-    if (auto cmp = dyn_cast< ar::Comparison >(bb->front())) {
-      ar::IntegerConstant* constant = nullptr;
-      bool cst_left;
+    // The constant of the loop guard comes first
+    std::vector< ar::MachineInt > thresholds;
+    if (head->num_successors() > 1) {
+      auto successor = *(head->successor_begin());
+      if (auto constant = extract_guard_constant(successor)) {
+        thresholds.push_back(*constant);
+      }
+    }
 
-      if (cmp->left()->is_integer_constant()) {
-        constant = cast< ar::IntegerConstant >(cmp->left());
-        cst_left = true;
-      } else if (cmp->right()->is_integer_constant()) {
-        constant = cast< ar::IntegerConstant >(cmp->right());
-        cst_left = false;
-      } else {
-        return boost::none;
+    // Then the other candidates, in increasing order
+    auto lt = [](const ar::MachineInt& a, const ar::MachineInt& b) {
+      return a.to_z_number() < b.to_z_number();
+    };
+    auto eq = [](const ar::MachineInt& a, const ar::MachineInt& b) {
+      return a.to_z_number() == b.to_z_number();
+    };
+    std::sort(candidates.begin(), candidates.end(), lt);
+    candidates.erase(std::unique(candidates.begin(), candidates.end(), eq),
+                     candidates.end());
+    for (const ar::MachineInt& candidate : candidates) {
+      if (thresholds.size() >= FixpointProfileAnalysis::MaxWideningThresholds) {
+        break;
+      }
+      if (thresholds.empty() || !eq(thresholds.front(), candidate)) {
+        thresholds.push_back(candidate);
       }
+    }
 
-      ar::MachineInt value = constant->value();
-      ar::MachineInt one(1, value.bit_width(), value.sign());
-      bool overflow = false;
-
-      // check if the comparison is <= or >=
-      if (cmp->predicate() == ar::Comparison::UIGE ||
-          cmp->predicate() == ar::Comparison::SIGE) {
-        if (cst_left) {
-          // case `cst >= var` <=> `cst + 1 > var`
-          value = add(value, one, overflow);
-        } else {
-          // case `var >= cst` <=> `var > cst - 1`
-          value = sub(value, one, overflow);
+    if (!thresholds.empty()) {
+      this->_collector->try_emplace(head, std::move(thresholds));
+    }
+  }
+
+private:
+  /// \brief Add the given basic block to the enclosing cycles
+  void add_to_components(ar::BasicBlock* bb) {
+    for (auto& component : this->_components) {
+      component.insert(bb);
+    }
+  }
+
+  /// \brief Return true if there is a cycle through the given head, within
+  /// the given component, that avoids the widening points
+  bool has_cycle(ar::BasicBlock* head,
+                 const llvm::DenseSet< ar::BasicBlock* >& component) const {
+    llvm::DenseSet< ar::BasicBlock* > visited;
+    std::vector< ar::BasicBlock* > worklist{head};
+    while (!worklist.empty()) {
+      ar::BasicBlock* bb = worklist.back();
+      worklist.pop_back();
+      for (auto it = bb->successor_begin(), et = bb->successor_end(); it != et;
+           ++it) {
+        ar::BasicBlock* succ = *it;
+        if (succ == head) {
+          return true;
         }
-      } else if (cmp->predicate() == ar::Comparison::UILE ||
-                 cmp->predicate() == ar::Comparison::SILE) {
-        if (cst_left) {
-          // case `cst <= var` <=> `cst - 1 < var`
-          value = sub(value, one, overflow);
-        } else {
-          // case `var <= cst` <=> `var < cst + 1`
-          value = add(value, one, overflow);
+        if (component.count(succ) > 0 &&
+            this->_widening_points.count(succ) == 0 &&
+            visited.insert(succ).second) {
+          worklist.push_back(succ);
         }
       }
-      if (overflow) {
-        return boost::none;
+    }
+    return false;
+  }
+
+  /// \brief Add the constants of the comparisons in the given basic block to
+  /// the candidates of the enclosing cycles
+  void collect_constants(ar::BasicBlock* bb) {
+    if (this->_candidates.empty()) {
+      return;
+    }
+
+    for (ar::Statement* stmt : *bb) {
+      if (auto cmp = dyn_cast< ar::Comparison >(stmt)) {
+        if (auto constant = extract_constant(cmp)) {
+          for (auto& candidates : this->_candidates) {
+            candidates.push_back(*constant);
+          }
+        }
       }
-      return value;
-    } else {
-      return boost::none;
     }
   }
 
 }; // end class FixpointProfileWtoVisitor
 
+/// \brief Estimate the cost of a fixpoint, see FixpointProfileAnalysis::cost()
+class FixpointCostWtoVisitor : public core::WtoComponentVisitor< ar::Code* > {
+private:
+  using WtoVertexT = core::WtoVertex< ar::Code* >;
+  using WtoCycleT = core::WtoCycle< ar::Code* >;
+
+private:
+  /// \brief Fixpoint profile of the function, or null
+  const FixpointProfile* _profile;
+
+  /// \brief Expected number of iterations of the current component
+  std::uint64_t _iterations = 1;
+
+  /// \brief Estimated cost
+  std::uint64_t _cost = 0;
+
+public:
+  /// \brief Constructor
+  explicit FixpointCostWtoVisitor(const FixpointProfile* profile)
+      : _profile(profile) {}
+
+  /// \brief Default copy constructor
+  FixpointCostWtoVisitor(const FixpointCostWtoVisitor&) = delete;
+
+  /// \brief Default move constructor
+  FixpointCostWtoVisitor(FixpointCostWtoVisitor&&) = delete;
+
+  /// \brief Delete copy assignment operator
+  FixpointCostWtoVisitor& operator=(const FixpointCostWtoVisitor&) = delete;
+
+  /// \brief Delete move assignment operator
+  FixpointCostWtoVisitor& operator=(FixpointCostWtoVisitor&&) = delete;
+
+  /// \brief Destructor
+  ~FixpointCostWtoVisitor() override = default;
+
+  void visit(const WtoVertexT& vertex) override {
+    this->add_block(vertex.node());
+  }
+
+  void visit(const WtoCycleT& cycle) override {
+    std::uint64_t iterations = this->_iterations;
+
+    std::uint64_t factor = 2;
+    if (this->_profile != nullptr) {
+      factor += this->_profile->widening_thresholds(cycle.head()).size() +
+                this->_profile->widening_delay(cycle.head());
+    }
+    this->_iterations = std::min(iterations * factor, MaxIterations);
+
+    this->add_block(cycle.head());
+    for (auto it = cycle.begin(), et = cycle.end(); it != et; ++it) {
+      it->accept(*this);
+    }
+
+    this->_iterations = iterations;
+  }
+
+  /// \brief Return the estimated cost
+  std::uint64_t cost() const { return std::max(this->_cost, std::uint64_t(1)); }
+
+private:
+  /// \brief Maximum number of expected iterations, to avoid overflows
+  static constexpr std::uint64_t MaxIterations = 1 << 20;
+
+  /// \brief Add the cost of the given basic block
+  void add_block(ar::BasicBlock* bb) {
+    this->_cost += this->_iterations * (1 + bb->num_statements());
+  }
+
+}; // end class FixpointCostWtoVisitor
+
 } // end anonymous namespace
 
 void FixpointProfileAnalysis::run() {
+  if (this->_ctx.opts.tuning_file) {
+    this->_tuning.load(*this->_ctx.opts.tuning_file);
+  }
+
   auto bundle = this->_ctx.bundle;
-  for (auto it = bundle->function_begin(), et = bundle->function_end();
-       it != et;
-       it++) {
-    if (auto profile = this->analyze_function(*it)) {
-      this->_map.try_emplace(*it, std::move(profile));
+  std::vector< ar::Function* > functions(bundle->function_begin(),
+                                         bundle->function_end());
+
+  // Analyze every function in parallel, each task writing in its own slot
+  std::vector< std::unique_ptr< FixpointProfile > > profiles(functions.size());
+  std::vector< std::uint64_t > costs(functions.size(), 1);
+  ThreadPool pool(std::max(this->_ctx.opts.jobs, 1U));
+  for (std::size_t i = 0; i < functions.size(); i++) {
+    pool.push([this, i, &functions, &profiles, &costs](std::size_t) {
+      profiles[i] = this->analyze_function(functions[i]);
+      costs[i] = this->estimate_cost(functions[i], profiles[i].get());
+    });
+  }
+  pool.run();
+
+  this->_costs.reserve(functions.size());
+  for (std::size_t i = 0; i < functions.size(); i++) {
+    this->_costs.try_emplace(functions[i], costs[i]);
+    if (profiles[i]) {
+      this->_map.try_emplace(functions[i], std::move(profiles[i]));
     }
   }
 }
@@ -183,15 +439,20 @@ void FixpointProfileAnalysis::dump(std::ostream& o) const {
 }
 
 std::unique_ptr< FixpointProfile > FixpointProfileAnalysis::analyze_function(
-    ar::Function* fun) {
+    ar::Function* fun) const {
   if (!fun->is_definition()) {
     return nullptr;
   }
 
   std::unique_ptr< FixpointProfile > profile(new FixpointProfile(fun));
-  FixpointProfileWtoVisitor visitor(&profile->_widening_hints);
-  core::Wto< ar::Code* > wto(fun->body());
+  FixpointProfileWtoVisitor visitor(&profile->_widening_hints,
+                                    &profile->_join_heads,
+                                    collect_array_sizes(fun));
+  core::Wto< ar::Code* > wto = this->_ctx.wto_cache->get(fun->body());
   wto.accept(visitor);
+  if (!this->_tuning.empty()) {
+    this->tune(*profile, visitor.heads());
+  }
   if (!profile->empty()) {
     return profile;
   } else {
@@ -199,6 +460,50 @@ std::unique_ptr< FixpointProfile > FixpointProfileAnalysis::analyze_function(
   }
 }
 
+void FixpointProfileAnalysis::tune(
+    FixpointProfile& profile, const std::vector< ar::BasicBlock* >& heads) const {
+  ar::Function* fun = profile.function();
+  profile._precision = this->_tuning.precision(fun);
+  for (ar::BasicBlock* head : heads) {
+    auto tuning = this->_tuning.loop(fun, head);
+    if (!tuning) {
+      continue;
+    }
+    profile._widening_delays[head] = tuning->widening_delay;
+    auto it = profile._widening_hints.find(head);
+    if (it == profile._widening_hints.end()) {
+      continue;
+    }
+    if (tuning->max_thresholds == 0) {
+      profile._widening_hints.erase(it);
+    } else if (it->second.size() > tuning->max_thresholds) {
+      it->second.erase(it->second.begin() + tuning->max_thresholds,
+                       it->second.end());
+    }
+  }
+}
+
+std::uint64_t FixpointProfileAnalysis::estimate_cost(
+    ar::Function* fun, const FixpointProfile* profile) const {
+  if (!fun->is_definition()) {
+    return 1;
+  }
+
+  FixpointCostWtoVisitor visitor(profile);
+  core::Wto< ar::Code* > wto = this->_ctx.wto_cache->get(fun->body());
+  wto.accept(visitor);
+  return visitor.cost();
+}
+
+std::uint64_t FixpointProfileAnalysis::cost(ar::Function* fun) const {
+  auto it = this->_costs.find(fun);
+  if (it != this->_costs.end()) {
+    return it->second;
+  } else {
+    return 1;
+  }
+}
+
 boost::optional< const FixpointProfile& > FixpointProfileAnalysis::profile(
     ar::Function* fun) const {
   auto it = this->_map.find(fun);
@@ -209,25 +514,81 @@ boost::optional< const FixpointProfile& > FixpointProfileAnalysis::profile(
   }
 }
 
-boost::optional< const core::MachineInt& > FixpointProfile::widening_hint(
+void FixpointProfileAnalysis::release(ar::Function* fun) {
+  this->_map.erase(fun);
+}
+
+llvm::ArrayRef< core::MachineInt > FixpointProfile::widening_thresholds(
     ar::BasicBlock* bb) const {
   auto it = this->_widening_hints.find(bb);
   if (it == this->_widening_hints.end()) {
+    return {};
+  } else {
+    return it->second;
+  }
+}
+
+bool FixpointProfile::is_widening_point(ar::BasicBlock* bb) const {
+  return this->_join_heads.count(bb) == 0;
+}
+
+unsigned FixpointProfile::widening_delay(ar::BasicBlock* bb) const {
+  auto it = this->_widening_delays.find(bb);
+  if (it != this->_widening_delays.end()) {
+    return it->second;
+  }
+  return this->is_widening_point(bb)
+             ? 0
+             : FixpointProfileAnalysis::MaxJoinIterations;
+}
+
+bool FixpointProfile::join_iteration(ar::BasicBlock* bb,
+                                     unsigned iteration) const {
+  return iteration <= 1 + this->widening_delay(bb);
+}
+
+boost::optional< const core::MachineInt& > FixpointProfile::widening_hint(
+    ar::BasicBlock* bb, unsigned iteration) const {
+  llvm::ArrayRef< core::MachineInt > thresholds = this->widening_thresholds(bb);
+  unsigned delay = this->widening_delay(bb);
+  if (iteration < 2 + delay || iteration - 2 - delay >= thresholds.size()) {
     return boost::none;
   } else {
-    return *it->second;
+    return thresholds[iteration - 2 - delay];
   }
 }
 
 bool FixpointProfile::empty() const {
-  return this->_widening_hints.empty();
+  return this->_widening_hints.empty() && this->_join_heads.empty() &&
+         this->_widening_delays.empty() && !this->_precision;
 }
 
 void FixpointProfile::dump(std::ostream& o) const {
   for (const auto& item : this->_widening_hints) {
     o << " • ";
     item.first->dump(o);
-    o << ": " << *item.second << std::endl;
+    o << ": ";
+    for (auto it = item.second.begin(), et = item.second.end(); it != et;) {
+      o << *it;
+      ++it;
+      if (it != et) {
+        o << ", ";
+      }
+    }
+    o << std::endl;
+  }
+  for (ar::BasicBlock* bb : this->_join_heads) {
+    o << " • ";
+    bb->dump(o);
+    o << ": not a widening point" << std::endl;
+  }
+  for (const auto& item : this->_widening_delays) {
+    o << " • ";
+    item.first->dump(o);
+    o << ": widening delay " << item.second << std::endl;
+  }
+  if (this->_precision) {
+    o << " • precision " << precision_str(*this->_precision) << std::endl;
   }
 }
 
@@ -41,6 +41,7 @@
  *
  ******************************************************************************/
 
+#include <algorithm>
 #include <fstream>
 #include <regex>
 #include <sstream>
@@ -102,6 +103,15 @@ static Interval parse_range(StringRef buffer,
                   core::MachineInt(ubound, ptr_bit_width, core::Unsigned));
 }
 
+/// \brief Return true if `a` ends before `b` starts, and is not adjacent
+static bool is_before(const Interval& a, const Interval& b) {
+  if (!(a.ub() < b.lb())) {
+    return false;
+  }
+  core::MachineInt one(1, a.ub().bit_width(), core::Unsigned);
+  return a.ub() + one != b.lb();
+}
+
 } // end anonymous namespace
 
 HardwareAddresses::HardwareAddresses(
@@ -158,25 +168,55 @@ void HardwareAddresses::add_range_from_file(const std::string& filepath) {
 }
 
 void HardwareAddresses::add_range(Interval range) {
-  this->_address_ranges.push_back(std::move(range));
+  auto& ranges = this->_address_ranges;
+
+  // Ranges overlapping or adjacent to `range` are in [first, last)
+  auto first = std::lower_bound(ranges.begin(),
+                                ranges.end(),
+                                range,
+                                [](const Interval& r, const Interval& x) {
+                                  return is_before(r, x);
+                                });
+  auto last = std::upper_bound(first,
+                               ranges.end(),
+                               range,
+                               [](const Interval& x, const Interval& r) {
+                                 return is_before(x, r);
+                               });
+  for (auto it = first; it != last; ++it) {
+    range.join_with(*it);
+  }
+  auto pos = ranges.erase(first, last);
+  ranges.insert(pos, std::move(range));
+}
+
+std::vector< core::machine_int::Interval >::const_iterator HardwareAddresses::
+    lower_bound(const core::MachineInt& addr) const {
+  return std::lower_bound(this->_address_ranges.begin(),
+                          this->_address_ranges.end(),
+                          addr,
+                          [](const Interval& r, const core::MachineInt& x) {
+                            return r.ub() < x;
+                          });
 }
 
 bool HardwareAddresses::geq(const Interval& other) const {
-  for (const auto& it : this->ranges()) {
-    if (other.leq(it)) {
-      return true;
-    }
+  if (other.is_bottom()) {
+    return !this->_address_ranges.empty();
   }
-  return false;
+
+  // Ranges are merged, so `other` is included in at most one of them
+  auto it = this->lower_bound(other.lb());
+  return it != this->_address_ranges.end() && other.leq(*it);
 }
 
 bool HardwareAddresses::is_meet_bottom(const Interval& other) const {
-  for (const auto& it : this->ranges()) {
-    if (!it.meet(other).is_bottom()) {
-      return false;
-    }
+  if (other.is_bottom()) {
+    return true;
   }
-  return true;
+
+  auto it = this->lower_bound(other.lb());
+  return it == this->_address_ranges.end() || other.ub() < it->lb();
 }
 
 void HardwareAddresses::dump(std::ostream& o) const {
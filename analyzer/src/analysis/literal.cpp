@@ -77,16 +77,123 @@ const AggregateLit& LiteralFactory::get_aggregate(ar::Value* value) {
 }
 
 const Literal& LiteralFactory::get(ar::Value* value) {
-  auto it = this->_map.find(value);
-  if (it == this->_map.end()) {
-    std::pair< Map::iterator, bool > res =
-        this->_map.emplace(value, this->create_literal(value));
-    return (res.first)->second;
+  return *this->_map.get_or_create(value,
+                                   [=] { return this->create_literal(value); });
+}
+
+const CodeLiterals& LiteralFactory::get(ar::Code* code) {
+  return *this->_code_map.get_or_create(code, [=] {
+    return std::make_unique< CodeLiterals >(*this, code);
+  });
+}
+
+void LiteralFactory::release(ar::Function* fun) {
+  ar::Code* body = fun->body();
+  this->_code_map.erase(body);
+  for (auto it = body->internal_variable_begin(),
+            et = body->internal_variable_end();
+       it != et;
+       ++it) {
+    this->_map.erase(static_cast< ar::Value* >(*it));
+  }
+  for (auto it = fun->local_variable_begin(), et = fun->local_variable_end();
+       it != et;
+       ++it) {
+    this->_map.erase(static_cast< ar::Value* >(*it));
+  }
+  for (auto it = fun->param_begin(), et = fun->param_end(); it != et; ++it) {
+    this->_map.erase(static_cast< ar::Value* >(*it));
+  }
+}
+
+const Literal& StatementLiterals::result() const {
+  if (this->_row[0] == nullptr) {
+    // Throw the same error as the literal factory
+    return this->_lfac->get(this->_stmt->result());
+  }
+  return *this->_row[0];
+}
+
+const Literal& StatementLiterals::operand(std::size_t i) const {
+  if (this->_row[i + 1] == nullptr) {
+    // Throw the same error as the literal factory
+    return this->_lfac->get(this->_stmt->operand(i));
+  }
+  return *this->_row[i + 1];
+}
+
+const ScalarLit& StatementLiterals::scalar_result() const {
+  const Literal& lit = this->result();
+
+  if (lit.is_scalar()) {
+    return lit.scalar();
+  } else {
+    throw AggregateLiteralError(lit.aggregate());
+  }
+}
+
+const ScalarLit& StatementLiterals::scalar_operand(std::size_t i) const {
+  const Literal& lit = this->operand(i);
+
+  if (lit.is_scalar()) {
+    return lit.scalar();
+  } else {
+    throw AggregateLiteralError(lit.aggregate());
+  }
+}
+
+const AggregateLit& StatementLiterals::aggregate_result() const {
+  const Literal& lit = this->result();
+
+  if (lit.is_aggregate()) {
+    return lit.aggregate();
+  } else {
+    throw ScalarLiteralError(lit.scalar());
+  }
+}
+
+const AggregateLit& StatementLiterals::aggregate_operand(std::size_t i) const {
+  const Literal& lit = this->operand(i);
+
+  if (lit.is_aggregate()) {
+    return lit.aggregate();
   } else {
-    return it->second;
+    throw ScalarLiteralError(lit.scalar());
+  }
+}
+
+CodeLiterals::CodeLiterals(LiteralFactory& lfac, ar::Code* code)
+    : _lfac(lfac), _code(code) {
+  // Return the literal of the given value, or null if it cannot be created
+  auto literal = [&lfac](ar::Value* value) -> const Literal* {
+    try {
+      return &lfac.get(value);
+    } catch (const LogicError&) {
+      return nullptr;
+    }
+  };
+
+  for (ar::BasicBlock* bb : *code) {
+    for (ar::Statement* stmt : *bb) {
+      this->_rows.try_emplace(stmt,
+                              static_cast< unsigned >(this->_literals.size()));
+      this->_literals.push_back(
+          stmt->has_result() ? literal(stmt->result()) : nullptr);
+      for (auto it = stmt->op_begin(), et = stmt->op_end(); it != et; ++it) {
+        this->_literals.push_back(literal(*it));
+      }
+    }
   }
 }
 
+CodeLiterals::~CodeLiterals() = default;
+
+StatementLiterals CodeLiterals::get(ar::Statement* stmt) const {
+  auto it = this->_rows.find(stmt);
+  ikos_assert_msg(it != this->_rows.end(), "statement not in the code");
+  return StatementLiterals(this->_lfac, stmt, &this->_literals[it->second]);
+}
+
 namespace {
 
 /// \brief Convert a std::size_t representing a size or an offset to a
@@ -121,25 +228,44 @@ public:
 
 public:
   void operator()(const ScalarLit& scalar) {
-    this->_fields.push_back(
-        AggregateLit::Field{this->_offset, scalar, this->_size});
+    AggregateLit::append(this->_fields,
+                         AggregateLit::Field{this->_offset,
+                                             scalar,
+                                             this->_size});
   }
 
   void operator()(const AggregateLit& aggregate) {
     if (aggregate.is_cst()) {
       for (const auto& field : aggregate.fields()) {
-        this->_fields.push_back(
-            AggregateLit::Field{this->_offset + field.offset,
-                                field.value,
-                                field.size});
+        AggregateLit::append(this->_fields,
+                             AggregateLit::Field{this->_offset + field.offset,
+                                                 field.value,
+                                                 field.size,
+                                                 field.repeat,
+                                                 field.stride});
+      }
+    } else if (aggregate.is_data()) {
+      ar::DataArrayConstant* cst = aggregate.data_cst();
+      const MachineInt& element_size = aggregate.data_element_size();
+      MachineInt offset = this->_offset;
+      for (std::size_t i = 0, n = cst->num_elements(); i < n; i++) {
+        AggregateLit::append(this->_fields,
+                             AggregateLit::Field{offset,
+                                                 ScalarLit::machine_int(
+                                                     cst->element(i)),
+                                                 element_size});
+        offset += element_size;
       }
     } else if (aggregate.is_zero()) {
-      this->_fields.push_back(
-          AggregateLit::Field{this->_offset, ScalarLit::null(), this->_size});
+      AggregateLit::append(this->_fields,
+                           AggregateLit::Field{this->_offset,
+                                               ScalarLit::null(),
+                                               this->_size});
     } else if (aggregate.is_undefined()) {
-      this->_fields.push_back(AggregateLit::Field{this->_offset,
-                                                  ScalarLit::undefined(),
-                                                  this->_size});
+      AggregateLit::append(this->_fields,
+                           AggregateLit::Field{this->_offset,
+                                               ScalarLit::undefined(),
+                                               this->_size});
     } else if (aggregate.is_var()) {
       throw LogicError(
           "literal factory: unexpected variable aggregate within a constant "
@@ -267,6 +393,16 @@ public:
                                          _dl)));
   }
 
+  Literal operator()(ar::DataArrayConstant* c) {
+    return Literal(AggregateLit::
+                       data(c,
+                            to_machine_int(_dl.alloc_size_in_bytes(
+                                               c->element_type()),
+                                           _dl),
+                            to_machine_int(_dl.store_size_in_bytes(c->type()),
+                                           _dl)));
+  }
+
   Literal operator()(ar::AggregateZeroConstant* c) {
     return Literal(AggregateLit::zero(
         to_machine_int(_dl.store_size_in_bytes(c->type()), _dl)));
@@ -43,322 +43,337 @@
  *
  ******************************************************************************/
 
-#include <ikos/core/domain/discrete_domain.hpp>
-#include <ikos/core/fixpoint/fwd_fixpoint_iterator.hpp>
+#include <algorithm>
+
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
 
 #include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/statement.hpp>
 
 #include <ikos/analyzer/analysis/liveness.hpp>
 #include <ikos/analyzer/analysis/variable.hpp>
 #include <ikos/analyzer/util/log.hpp>
+#include <ikos/analyzer/util/thread_pool.hpp>
 
 namespace ikos {
 namespace analyzer {
 namespace {
 
-/// \brief Lattice of liveness
+/// \brief Liveness solver on a code, using dense bitsets
 ///
-/// This is a small wrapper around core::DiscreteDomain, with a few changes:
-///   * The default constructor returns bottom
-///   * Has convenient operator+ and operator-
-template < typename VariableRef >
-class LivenessDomain final
-    : public core::AbstractDomain< LivenessDomain< VariableRef > > {
-private:
-  using DiscreteDomain = core::DiscreteDomain< VariableRef >;
-
-public:
-  using Iterator = typename DiscreteDomain::Iterator;
-
-private:
-  DiscreteDomain _inv;
-
+/// Variables are numbered in order of appearance in the code, and sets of
+/// variables are bitsets indexed by these numbers. The live variables are
+/// computed with a backward worklist algorithm on the basic blocks, then a
+/// last backward pass on each basic block computes the variables that die
+/// after each statement.
+///
+/// Local variables whose address is only used as the pointer operand of loads
+/// and stores are stack slots: their memory cells cannot be reached otherwise.
+/// A stack slot is live where a load on it may follow, and it gets the bits
+/// after the variables.
+class LivenessSolver {
 private:
-  /// \brief Private constructor
-  explicit LivenessDomain(DiscreteDomain inv) : _inv(std::move(inv)) {}
-
-public:
-  /// \brief Create the empty liveness domain
-  LivenessDomain() : _inv(DiscreteDomain::bottom()) {}
-
-  /// \brief Create the liveness domain with the given elements
-  LivenessDomain(std::initializer_list< VariableRef > elements)
-      : _inv(elements) {}
-
-  /// \brief Copy constructor
-  LivenessDomain(const LivenessDomain&) = default;
-
-  /// \brief Move constructor
-  LivenessDomain(LivenessDomain&&) = default;
-
-  /// \brief Copy assignment operator
-  LivenessDomain& operator=(const LivenessDomain&) = default;
-
-  /// \brief Move assignment operator
-  LivenessDomain& operator=(LivenessDomain&&) = default;
-
-  /// \brief Destructor
-  ~LivenessDomain() override = default;
-
-  /// \brief Create the top liveness domain
-  static LivenessDomain top() { return LivenessDomain(DiscreteDomain::top()); }
-
-  /// \brief Create the bottom liveness domain
-  static LivenessDomain bottom() {
-    return LivenessDomain(DiscreteDomain::bottom());
-  }
-
-  /// \brief Return the number of elements in the liveness domain
-  std::size_t size() const { return this->_inv.size(); }
-
-  /// \brief Begin iterator over the elements
-  Iterator begin() const { return this->_inv.begin(); }
-
-  /// \brief End iterator over the elements
-  Iterator end() const { return this->_inv.end(); }
-
-  bool is_bottom() const override { return this->_inv.is_bottom(); }
-
-  bool is_top() const override { return this->_inv.is_top(); }
-
-  void set_to_bottom() override { this->_inv.set_to_bottom(); }
-
-  void set_to_top() override { this->_inv.set_to_top(); }
-
-  bool leq(const LivenessDomain& other) const override {
-    return this->_inv.leq(other._inv);
-  }
-
-  bool equals(const LivenessDomain& other) const override {
-    return this->_inv.equals(other._inv);
-  }
-
-  void join_with(const LivenessDomain& other) override {
-    this->_inv.join_with(other._inv);
-  }
-
-  void widen_with(const LivenessDomain& other) override {
-    this->_inv.widen_with(other._inv);
-  }
-
-  void meet_with(const LivenessDomain& other) override {
-    this->_inv.meet_with(other._inv);
-  }
+  /// \brief Variables used and defined by a statement
+  struct StatementVars {
+    /// \brief Statement
+    ar::Statement* stmt;
 
-  void narrow_with(const LivenessDomain& other) override {
-    this->_inv.narrow_with(other._inv);
-  }
-
-  void operator-=(const LivenessDomain& other) {
-    this->_inv.difference_with(other._inv);
-  }
+    /// \brief Index of the defined variable, or -1
+    int def;
 
-  void operator-=(VariableRef v) { this->_inv.remove(v); }
-
-  void operator+=(const LivenessDomain& other) {
-    this->_inv.join_with(other._inv);
-  }
+    /// \brief Indexes of the used variables
+    std::vector< unsigned > uses;
 
-  void operator+=(VariableRef v) { this->_inv.add(v); }
+    /// \brief Index of the stack slot loaded or stored, or -1
+    int slot;
 
-  void dump(std::ostream& o) const override { this->_inv.dump(o); }
-
-  static std::string name() { return "liveness domain"; }
-
-}; // end class LivenessDomain
-
-/// \brief Inverse an ar::Code* graph
-///
-/// The entry node is the exit node, and successors and predecessors are swapped
-struct ReverseCodeGraphTrait {
-  using NodeRef = ar::BasicBlock*;
-  using SuccessorNodeIterator = ar::BasicBlock::BasicBlockIterator;
-  using PredecessorNodeIterator = ar::BasicBlock::BasicBlockIterator;
-
-  static ar::BasicBlock* entry(ar::Code* code) {
-    ikos_assert_msg(code->has_exit_block(), "code graph cannot be inversed");
-    return code->exit_block();
-  }
+    /// \brief True if the statement loads the stack slot
+    bool slot_load;
+  };
 
-  static SuccessorNodeIterator successor_begin(ar::BasicBlock* bb) {
-    return bb->predecessor_begin();
-  }
+  /// \brief Basic block information
+  struct BlockInfo {
+    /// \brief Basic block
+    ar::BasicBlock* bb;
 
-  static SuccessorNodeIterator successor_end(ar::BasicBlock* bb) {
-    return bb->predecessor_end();
-  }
+    /// \brief Variables of each statement of the basic block
+    std::vector< StatementVars > stmts;
 
-  static PredecessorNodeIterator predecessor_begin(ar::BasicBlock* bb) {
-    return bb->successor_begin();
-  }
+    /// \brief Variables used before being defined in the basic block
+    llvm::BitVector gen;
 
-  static PredecessorNodeIterator predecessor_end(ar::BasicBlock* bb) {
-    return bb->successor_end();
-  }
+    /// \brief Variables defined in the basic block
+    llvm::BitVector kill;
 
-}; // end struct ReverseCodeGraphTrait
+    /// \brief Variables live at the entry of the basic block
+    llvm::BitVector live_in;
 
-/// \brief Liveness fixpoint iterator
-class LivenessFixpointIterator final
-    : public core::InterleavedFwdFixpointIterator< ar::Code*,
-                                                   LivenessDomain< Variable* >,
-                                                   ReverseCodeGraphTrait > {
-private:
-  /// \brief Parent class
-  using FwdFixpointIterator =
-      core::InterleavedFwdFixpointIterator< ar::Code*,
-                                            LivenessDomain< Variable* >,
-                                            ReverseCodeGraphTrait >;
-
-  /// \brief Liveness abstract domain
-  using LivenessDomainT = LivenessDomain< Variable* >;
-
-  /// \brief A pair (kill, gen)
-  struct KillGen {
-    LivenessDomainT kill;
-    LivenessDomainT gen;
+    /// \brief Variables live at the end of the basic block
+    llvm::BitVector live_out;
   };
 
-  /// \brief Map from basic block to a (kill, gen) pair
-  using KillGenMap = llvm::DenseMap< ar::BasicBlock*, KillGen >;
-
-  /// \brief Map from basic block to liveness domain
-  using LivenessMap = llvm::DenseMap< ar::BasicBlock*, LivenessDomainT >;
-
-public:
-  /// \brief Iterator on a map from basic block to liveness domain
-  using LivenessMapIterator = LivenessMap::const_iterator;
-
 private:
   /// \brief Variable factory
   VariableFactory& _vfac;
 
-  /// \brief Store (kill, gen) sets for each basic block
-  KillGenMap _kg_map;
+  /// \brief Variables, indexed by number
+  std::vector< Variable* > _vars;
+
+  /// \brief Map from variable to number
+  llvm::DenseMap< Variable*, unsigned > _var_index;
 
-  /// \brief Set of all variables (defined and used) for each basic blocks
-  LivenessMap _all_vars_map;
+  /// \brief Stack slots, indexed by number
+  std::vector< ar::LocalVariable* > _slots;
 
-  /// \brief Set of live variables at the **entry** of a basic block
-  LivenessMap _live_at_entry_map;
+  /// \brief Map from stack slot to number
+  llvm::DenseMap< ar::LocalVariable*, unsigned > _slot_index;
 
-  /// \brief Set of dead variables at the **end** of a basic block
-  LivenessMap _dead_at_end_map;
+  /// \brief Basic blocks, in the order of the code
+  std::vector< BlockInfo > _blocks;
+
+  /// \brief Map from basic block to index in _blocks
+  llvm::DenseMap< ar::BasicBlock*, unsigned > _block_index;
 
 public:
-  LivenessFixpointIterator(ar::Code* code, VariableFactory& vfac)
-      : FwdFixpointIterator(code), _vfac(vfac) {
-    this->init();
+  /// \brief Constructor
+  LivenessSolver(ar::Code* code, VariableFactory& vfac) : _vfac(vfac) {
+    this->init(code);
   }
 
-  LivenessMapIterator live_at_entry_begin() const {
-    return this->_live_at_entry_map.begin();
-  }
+  /// \brief Compute the live variables at the entry and end of each block
+  void run() {
+    std::size_t num_blocks = this->_blocks.size();
 
-  LivenessMapIterator live_at_entry_end() const {
-    return this->_live_at_entry_map.end();
-  }
+    // Start with the last blocks, closer to the exit
+    std::vector< unsigned > worklist;
+    worklist.reserve(num_blocks);
+    for (std::size_t i = 0; i < num_blocks; i++) {
+      worklist.push_back(static_cast< unsigned >(i));
+    }
+    llvm::BitVector in_worklist(static_cast< unsigned >(num_blocks), true);
+
+    llvm::BitVector live(static_cast< unsigned >(this->_vars.size()));
+    while (!worklist.empty()) {
+      unsigned i = worklist.back();
+      worklist.pop_back();
+      in_worklist.reset(i);
+      BlockInfo& info = this->_blocks[i];
+
+      // OUT(B) = U IN(S) for all successors S of B
+      info.live_out.reset();
+      for (auto it = info.bb->successor_begin(),
+                et = info.bb->successor_end();
+           it != et;
+           ++it) {
+        info.live_out |= this->_blocks[this->_block_index[*it]].live_in;
+      }
 
-  LivenessMapIterator dead_at_end_begin() const {
-    return this->_dead_at_end_map.begin();
+      // IN(B) = (OUT(B) \ kill(B)) U gen(B)
+      live = info.live_out;
+      live.reset(info.kill);
+      live |= info.gen;
+      if (live == info.live_in) {
+        continue;
+      }
+      info.live_in = live;
+
+      for (auto it = info.bb->predecessor_begin(),
+                et = info.bb->predecessor_end();
+           it != et;
+           ++it) {
+        unsigned pred = this->_block_index[*it];
+        if (!in_worklist.test(pred)) {
+          in_worklist.set(pred);
+          worklist.push_back(pred);
+        }
+      }
+    }
   }
 
-  LivenessMapIterator dead_at_end_end() const {
-    return this->_dead_at_end_map.end();
-  }
+  /// \brief Store the results in the given CodeResults
+  void results(LivenessAnalysis::CodeResults& results) const {
+    results.live_at_entry.reserve(this->_blocks.size());
+    for (const BlockInfo& info : this->_blocks) {
+      results.live_at_entry.emplace_back(info.bb,
+                                         this->variable_list(info.live_in));
+
+      // Walk backward to find the variables that die after each statement
+      llvm::BitVector live = info.live_out;
+      for (auto it = info.stmts.rbegin(), et = info.stmts.rend(); it != et;
+           ++it) {
+        LivenessAnalysis::VariableRefList dead;
+        if (it->def >= 0 && !live.test(static_cast< unsigned >(it->def))) {
+          dead.push_back(this->_vars[static_cast< unsigned >(it->def)]);
+        }
+        for (unsigned use : it->uses) {
+          if (!live.test(use) && static_cast< int >(use) != it->def) {
+            dead.push_back(this->_vars[use]);
+          }
+        }
 
-  /// \brief Compute the set of dead and live variables
-  void run() { FwdFixpointIterator::run(LivenessDomainT::bottom()); }
+        // Live variables before the statement
+        if (it->def >= 0) {
+          live.reset(static_cast< unsigned >(it->def));
+        }
+        for (unsigned use : it->uses) {
+          live.set(use);
+        }
+        if (!dead.empty()) {
+          results.dead_after.emplace_back(it->stmt, std::move(dead));
+        }
 
-  /// \brief Apply the kill-gen equation
-  ///
-  /// IN(B) = (OUT(B) \ kill (B)) U gen (B)
-  LivenessDomainT analyze_node(ar::BasicBlock* bb,
-                               LivenessDomainT post) override {
-    auto it = this->_kg_map.find(bb);
-    ikos_assert(it != this->_kg_map.end());
-
-    LivenessDomainT pre(post);
-    pre -= it->second.kill; // delete kill set
-    pre += it->second.gen;  // add gen set
-    return pre;
+        // Stack slot not loaded afterwards
+        if (it->slot >= 0) {
+          auto slot = static_cast< unsigned >(it->slot);
+          unsigned bit = this->slot_bit(slot);
+          if (!live.test(bit)) {
+            results.dead_slot_after.emplace_back(it->stmt, this->_slots[slot]);
+          }
+          if (it->slot_load) {
+            live.set(bit);
+          }
+        }
+      }
+    }
   }
 
-  LivenessDomainT analyze_edge(ar::BasicBlock*,
-                               ar::BasicBlock*,
-                               LivenessDomainT pre) override {
-    return pre;
-  }
+private:
+  /// \brief Number the variables and compute kill/gen sets
+  void init(ar::Code* code) {
+    llvm::DenseSet< ar::LocalVariable* > escaped = escaped_locals(code);
+
+    this->_blocks.reserve(code->num_basic_blocks());
+    for (ar::BasicBlock* bb : *code) {
+      this->_block_index.try_emplace(
+          bb, static_cast< unsigned >(this->_blocks.size()));
+      this->_blocks.push_back(BlockInfo{bb, {}, {}, {}, {}, {}});
+      BlockInfo& info = this->_blocks.back();
+
+      info.stmts.reserve(bb->num_statements());
+      for (ar::Statement* stmt : *bb) {
+        StatementVars vars{stmt, -1, {}, -1, false};
+
+        if (stmt->has_result()) {
+          Variable* var = this->variable_ref(stmt->result());
+          ikos_assert_msg(var != nullptr, "result is not a variable");
+          vars.def = static_cast< int >(this->index(var));
+        }
 
-  /// \brief Store the set of dead variables at the exit of `bb`
-  ///
-  /// Note: this is the post invariant, because we reversed the graph
-  void process_pre(ar::BasicBlock* bb,
-                   const LivenessDomainT& post_live) override {
-    ikos_assert(!post_live.is_top());
+        for (auto it = stmt->op_begin(), et = stmt->op_end(); it != et; ++it) {
+          Variable* var = this->variable_ref(*it);
+          if (var != nullptr) {
+            unsigned idx = this->index(var);
+            if (std::find(vars.uses.begin(), vars.uses.end(), idx) ==
+                vars.uses.end()) {
+              vars.uses.push_back(idx);
+            }
+          }
+        }
 
-    auto it = this->_all_vars_map.find(bb);
-    ikos_assert(it != this->_all_vars_map.end());
-    LivenessDomainT all = it->second;
+        ar::LocalVariable* lv = slot_access(stmt);
+        if (lv != nullptr && escaped.count(lv) == 0) {
+          vars.slot = static_cast< int >(this->slot_index(lv));
+          vars.slot_load = ar::isa< ar::Load >(stmt);
+        }
 
-    // dead = all - live
-    LivenessDomainT dead(all);
-    dead -= post_live;
+        info.stmts.push_back(std::move(vars));
+      }
+    }
 
-    this->_dead_at_end_map.try_emplace(bb, dead);
+    auto num_bits =
+        static_cast< unsigned >(this->_vars.size() + this->_slots.size());
+    for (BlockInfo& info : this->_blocks) {
+      info.gen.resize(num_bits);
+      info.kill.resize(num_bits);
+      info.live_in.resize(num_bits);
+      info.live_out.resize(num_bits);
+
+      for (auto it = info.stmts.rbegin(), et = info.stmts.rend(); it != et;
+           ++it) {
+        if (it->def >= 0) {
+          info.kill.set(static_cast< unsigned >(it->def));
+          info.gen.reset(static_cast< unsigned >(it->def));
+        }
+        for (unsigned use : it->uses) {
+          info.gen.set(use);
+        }
+        if (it->slot >= 0 && it->slot_load) {
+          info.gen.set(this->slot_bit(static_cast< unsigned >(it->slot)));
+        }
+      }
+    }
   }
 
-  /// \brief Store the set of live variables at the entry of `bb`
-  ///
-  /// Note: this is the pre invariant, because we reversed the graph
-  void process_post(ar::BasicBlock* bb,
-                    const LivenessDomainT& pre_live) override {
-    ikos_assert(!pre_live.is_top());
-
-    this->_live_at_entry_map.try_emplace(bb, pre_live);
+  /// \brief Return the local variable whose memory is loaded or stored by the
+  /// given statement, or null
+  static ar::LocalVariable* slot_access(ar::Statement* stmt) {
+    if (auto load = ar::dyn_cast< ar::Load >(stmt)) {
+      return ar::dyn_cast< ar::LocalVariable >(load->operand());
+    } else if (auto store = ar::dyn_cast< ar::Store >(stmt)) {
+      return ar::dyn_cast< ar::LocalVariable >(store->pointer());
+    } else {
+      return nullptr;
+    }
   }
 
-private:
-  /// \brief Compute kill/gen sets for each basic blocks
-  void init() {
-    ar::Code* code = this->cfg();
-
-    for (auto it = code->begin(), et = code->end(); it != et; ++it) {
-      this->init(*it);
+  /// \brief Return the local variables whose address escapes, i.e. is used
+  /// other than as the pointer operand of a load or store
+  static llvm::DenseSet< ar::LocalVariable* > escaped_locals(ar::Code* code) {
+    llvm::DenseSet< ar::LocalVariable* > escaped;
+    for (ar::BasicBlock* bb : *code) {
+      for (ar::Statement* stmt : *bb) {
+        bool access = ar::isa< ar::Load >(stmt) || ar::isa< ar::Store >(stmt);
+        for (std::size_t i = 0; i < stmt->num_operands(); i++) {
+          if (auto lv = ar::dyn_cast< ar::LocalVariable >(stmt->operand(i))) {
+            if (!access || i != 0) {
+              escaped.insert(lv);
+            }
+          }
+        }
+      }
     }
+    return escaped;
   }
 
-  /// \brief Compute kill/gen sets for the given basic block
-  void init(ar::BasicBlock* bb) {
-    LivenessDomainT kill, gen, all;
-
-    for (auto it = bb->rbegin(), et = bb->rend(); it != et; ++it) {
-      ar::Statement* stmt = *it;
+  /// \brief Return the number of the given variable
+  unsigned index(Variable* var) {
+    auto res = this->_var_index.try_emplace(
+        var, static_cast< unsigned >(this->_vars.size()));
+    if (res.second) {
+      this->_vars.push_back(var);
+    }
+    return res.first->second;
+  }
 
-      // Process defs
-      if (stmt->has_result()) {
-        Variable* var = this->variable_ref(stmt->result());
-        ikos_assert_msg(var != nullptr, "result is not a variable");
+  /// \brief Return the number of the given stack slot
+  unsigned slot_index(ar::LocalVariable* lv) {
+    auto res = this->_slot_index.try_emplace(
+        lv, static_cast< unsigned >(this->_slots.size()));
+    if (res.second) {
+      this->_slots.push_back(lv);
+    }
+    return res.first->second;
+  }
 
-        kill += var;
-        gen -= var;
-        all += var;
-      }
+  /// \brief Return the bit of the given stack slot, after the variables
+  unsigned slot_bit(unsigned slot) const {
+    return static_cast< unsigned >(this->_vars.size()) + slot;
+  }
 
-      // Process uses
-      for (auto op_it = stmt->op_begin(), op_et = stmt->op_end();
-           op_it != op_et;
-           ++op_it) {
-        Variable* var = this->variable_ref(*op_it);
-        if (var != nullptr) {
-          gen += var;
-          all += var;
-        }
+  /// \brief Convert a bitset into a VariableRefList
+  LivenessAnalysis::VariableRefList variable_list(
+      const llvm::BitVector& set) const {
+    LivenessAnalysis::VariableRefList list;
+    list.reserve(set.count());
+    for (unsigned idx : set.set_bits()) {
+      if (idx >= this->_vars.size()) {
+        break; // Stack slots
       }
+      list.push_back(this->_vars[idx]);
     }
-
-    this->_kg_map.try_emplace(bb, KillGen{kill, gen});
-    this->_all_vars_map.try_emplace(bb, all);
+    return list;
   }
 
   /// \brief Get the Variable* of an ar::Value
@@ -378,7 +393,7 @@ private:
     }
   }
 
-}; // end class LivenessFixpointIterator
+}; // end class LivenessSolver
 
 } // end anonymous namespace
 
@@ -397,77 +412,107 @@ boost::optional< const LivenessAnalysis::VariableRefList& > LivenessAnalysis::
 }
 
 boost::optional< const LivenessAnalysis::VariableRefList& > LivenessAnalysis::
-    dead_at_end(ar::BasicBlock* bb) const {
-  auto it = this->_dead_at_end_map.find(bb);
-  if (it != this->_dead_at_end_map.end()) {
+    dead_after(ar::Statement* stmt) const {
+  auto it = this->_dead_after_map.find(stmt);
+  if (it != this->_dead_after_map.end()) {
     return it->second;
   } else {
     return boost::none;
   }
 }
 
+ar::LocalVariable* LivenessAnalysis::dead_slot_after(
+    ar::Statement* stmt) const {
+  auto it = this->_dead_slot_after_map.find(stmt);
+  if (it != this->_dead_slot_after_map.end()) {
+    return it->second;
+  } else {
+    return nullptr;
+  }
+}
+
+void LivenessAnalysis::release(ar::Code* code) {
+  for (ar::BasicBlock* bb : *code) {
+    this->_live_at_entry_map.erase(bb);
+    for (ar::Statement* stmt : *bb) {
+      this->_dead_after_map.erase(stmt);
+      this->_dead_slot_after_map.erase(stmt);
+    }
+  }
+}
+
 void LivenessAnalysis::run() {
   ar::Bundle* bundle = _ctx.bundle;
 
+  // Collect the global variable initializers and function bodies
+  std::vector< ar::Code* > codes;
   for (auto it = bundle->global_begin(), et = bundle->global_end(); it != et;
        ++it) {
     ar::GlobalVariable* gv = *it;
     if (gv->is_definition()) {
-      log::debug(
-          "Running liveness analysis on initializer of global variable '" +
-          gv->name() + "'");
-      this->run(gv->initializer());
+      codes.push_back(gv->initializer());
     }
   }
-
   for (auto it = bundle->function_begin(), et = bundle->function_end();
        it != et;
        ++it) {
     ar::Function* fun = *it;
     if (fun->is_definition()) {
-      log::debug("Running liveness analysis on function '" + fun->name() + "'");
-      this->run(fun->body());
+      codes.push_back(fun->body());
     }
   }
-}
-
-/// \brief Convert a LivenessDomain into a VariableRefList
-static LivenessAnalysis::VariableRefList to_variable_ref_list(
-    const LivenessDomain< Variable* >& value) {
-  LivenessAnalysis::VariableRefList list;
 
-  if (!value.is_bottom()) {
-    list.reserve(value.size());
-    std::copy(value.begin(), value.end(), std::back_inserter(list));
+  // Analyze every code in parallel, each task writing in its own slot
+  std::vector< CodeResults > results(codes.size());
+  ThreadPool pool(std::max(_ctx.opts.jobs, 1U));
+  for (std::size_t i = 0; i < codes.size(); i++) {
+    pool.push([this, i, &codes, &results](std::size_t) {
+      ar::Code* code = codes[i];
+      if (code->is_global_var_initializer()) {
+        log::debug(
+            "Running liveness analysis on initializer of global variable '" +
+            code->global_var()->name() + "'");
+      } else {
+        log::debug("Running liveness analysis on function '" +
+                   code->function()->name() + "'");
+      }
+      results[i] = this->run(code);
+    });
   }
+  pool.run();
 
-  return list;
-}
-
-void LivenessAnalysis::run(ar::Code* code) {
-  // If the code has no exit block, do nothing
-  if (!code->has_exit_block()) {
-    return;
+  // Store the results
+  std::size_t num_blocks = 0;
+  std::size_t num_stmts = 0;
+  std::size_t num_slot_stmts = 0;
+  for (const CodeResults& result : results) {
+    num_blocks += result.live_at_entry.size();
+    num_stmts += result.dead_after.size();
+    num_slot_stmts += result.dead_slot_after.size();
+  }
+  this->_live_at_entry_map.reserve(num_blocks);
+  this->_dead_after_map.reserve(num_stmts);
+  this->_dead_slot_after_map.reserve(num_slot_stmts);
+  for (CodeResults& result : results) {
+    for (auto& item : result.live_at_entry) {
+      this->_live_at_entry_map.try_emplace(item.first, std::move(item.second));
+    }
+    for (auto& item : result.dead_after) {
+      this->_dead_after_map.try_emplace(item.first, std::move(item.second));
+    }
+    for (const auto& item : result.dead_slot_after) {
+      this->_dead_slot_after_map.try_emplace(item.first, item.second);
+    }
   }
+}
 
-  // Run the liveness fixpoint iterator
-  LivenessFixpointIterator fixpoint(code, *_ctx.var_factory);
-  fixpoint.run();
+LivenessAnalysis::CodeResults LivenessAnalysis::run(ar::Code* code) const {
+  LivenessSolver solver(code, *_ctx.var_factory);
+  solver.run();
 
-  // Store the results
-  for (auto it = fixpoint.live_at_entry_begin(),
-            et = fixpoint.live_at_entry_end();
-       it != et;
-       ++it) {
-    this->_live_at_entry_map.try_emplace(it->first,
-                                         to_variable_ref_list(it->second));
-  }
-  for (auto it = fixpoint.dead_at_end_begin(), et = fixpoint.dead_at_end_end();
-       it != et;
-       ++it) {
-    this->_dead_at_end_map.try_emplace(it->first,
-                                       to_variable_ref_list(it->second));
-  }
+  CodeResults results;
+  solver.results(results);
+  return results;
 }
 
 void LivenessAnalysis::dump(std::ostream& o) const {
@@ -508,17 +553,25 @@ void LivenessAnalysis::dump(std::ostream& o, ar::Code* code) const {
     }
     o << "\n";
 
-    // Dead at end
-    o << "dead_at_end(";
-    bb->dump(o);
-    o << ") = ";
-    it = this->_dead_at_end_map.find(bb);
-    if (it != this->_dead_at_end_map.end()) {
-      dump(o, it->second);
-    } else {
-      o << "none";
+    // Dead after each statement
+    for (ar::Statement* stmt : *bb) {
+      auto stmt_it = this->_dead_after_map.find(stmt);
+      if (stmt_it != this->_dead_after_map.end()) {
+        o << "dead_after(";
+        stmt->dump(o);
+        o << ") = ";
+        dump(o, stmt_it->second);
+        o << "\n";
+      }
+      auto slot_it = this->_dead_slot_after_map.find(stmt);
+      if (slot_it != this->_dead_slot_after_map.end()) {
+        o << "dead_slot_after(";
+        stmt->dump(o);
+        o << ") = ";
+        slot_it->second->dump(o);
+        o << "\n";
+      }
     }
-    o << "\n";
   }
 }
 
@@ -156,46 +156,30 @@ void DynAllocMemoryLocation::dump(std::ostream& o) const {
 // MemoryFactory
 
 MemoryFactory::MemoryFactory()
-    : _absolute_zero_memory(std::make_unique< AbsoluteZeroMemoryLocation >()),
-      _argv_memory(std::make_unique< ArgvMemoryLocation >()) {}
+    : _absolute_zero_memory(nullptr), _argv_memory(nullptr), _next_id(0) {
+  this->_absolute_zero_memory =
+      this->with_id(new AbsoluteZeroMemoryLocation());
+  this->_argv_memory = this->with_id(new ArgvMemoryLocation());
+}
 
 MemoryFactory::~MemoryFactory() = default;
 
 LocalMemoryLocation* MemoryFactory::get_local(ar::LocalVariable* var) {
-  auto it = this->_local_memory_map.find(var);
-  if (it == this->_local_memory_map.end()) {
-    auto ml = new LocalMemoryLocation(var);
-    this->_local_memory_map.try_emplace(var,
-                                        std::unique_ptr< LocalMemoryLocation >(
-                                            ml));
-    return ml;
-  } else {
-    return it->second.get();
-  }
+  return this->_local_memory_map.get_or_create(var, [=] {
+    return this->with_id(new LocalMemoryLocation(var), var->function());
+  });
 }
 
 GlobalMemoryLocation* MemoryFactory::get_global(ar::GlobalVariable* var) {
-  auto it = this->_global_memory_map.find(var);
-  if (it == this->_global_memory_map.end()) {
-    auto ml = new GlobalMemoryLocation(var);
-    this->_global_memory_map
-        .try_emplace(var, std::unique_ptr< GlobalMemoryLocation >(ml));
-    return ml;
-  } else {
-    return it->second.get();
-  }
+  return this->_global_memory_map.get_or_create(var, [=] {
+    return this->with_id(new GlobalMemoryLocation(var));
+  });
 }
 
 FunctionMemoryLocation* MemoryFactory::get_function(ar::Function* fun) {
-  auto it = this->_function_memory_map.find(fun);
-  if (it == this->_function_memory_map.end()) {
-    auto ml = new FunctionMemoryLocation(fun);
-    this->_function_memory_map
-        .try_emplace(fun, std::unique_ptr< FunctionMemoryLocation >(ml));
-    return ml;
-  } else {
-    return it->second.get();
-  }
+  return this->_function_memory_map.get_or_create(fun, [=] {
+    return this->with_id(new FunctionMemoryLocation(fun));
+  });
 }
 
 FunctionMemoryLocation* MemoryFactory::get_function(
@@ -205,27 +189,18 @@ FunctionMemoryLocation* MemoryFactory::get_function(
 
 AggregateMemoryLocation* MemoryFactory::get_aggregate(
     ar::InternalVariable* var) {
-  auto it = this->_aggregate_memory_map.find(var);
-  if (it == this->_aggregate_memory_map.end()) {
-    auto ml = new AggregateMemoryLocation(var);
-    this->_aggregate_memory_map
-        .try_emplace(var, std::unique_ptr< AggregateMemoryLocation >(ml));
-    return ml;
-  } else {
-    return it->second.get();
-  }
+  return this->_aggregate_memory_map.get_or_create(var, [=] {
+    ar::Code* code = var->code();
+    return this->with_id(new AggregateMemoryLocation(var),
+                         code->is_function_body() ? code->function()
+                                                  : nullptr);
+  });
 }
 
 VaArgMemoryLocation* MemoryFactory::get_va_arg(llvm::StringRef sv) {
-  auto it = this->_va_arg_map.find(sv);
-  if (it == this->_va_arg_map.end()) {
-    auto ml = new VaArgMemoryLocation(sv);
-    this->_va_arg_map.try_emplace(sv,
-                                  std::unique_ptr< VaArgMemoryLocation >(ml));
-    return ml;
-  } else {
-    return it->second.get();
-  }
+  return this->_va_arg_map.get_or_create(sv, [=] {
+    return this->with_id(new VaArgMemoryLocation(sv));
+  });
 }
 
 AbsoluteZeroMemoryLocation* MemoryFactory::get_absolute_zero() {
@@ -238,16 +213,9 @@ ArgvMemoryLocation* MemoryFactory::get_argv() {
 
 DynAllocMemoryLocation* MemoryFactory::get_dyn_alloc(ar::CallBase* call,
                                                      CallContext* context) {
-  auto it = this->_dyn_alloc_map.find({call, context});
-  if (it == this->_dyn_alloc_map.end()) {
-    auto ml = new DynAllocMemoryLocation(call, context);
-    this->_dyn_alloc_map.try_emplace({call, context},
-                                     std::unique_ptr< DynAllocMemoryLocation >(
-                                         ml));
-    return ml;
-  } else {
-    return it->second.get();
-  }
+  return this->_dyn_alloc_map.get_or_create(std::make_pair(call, context), [=] {
+    return this->with_id(new DynAllocMemoryLocation(call, context));
+  });
 }
 
 } // end namespace analyzer
@@ -41,15 +41,94 @@
  *
  ******************************************************************************/
 
+#include <algorithm>
+#include <iterator>
+#include <unordered_set>
+
 #include <boost/iterator/transform_iterator.hpp>
 
 #include <ikos/analyzer/analysis/option.hpp>
 #include <ikos/analyzer/analysis/value/machine_int_domain.hpp>
 #include <ikos/analyzer/database/output.hpp>
+#include <ikos/analyzer/support/assert.hpp>
 
 namespace ikos {
 namespace analyzer {
 
+std::vector< ar::Function* > ShardOption::select(
+    const std::vector< ar::Function* >& functions) const {
+  std::vector< ar::Function* > sorted(functions);
+  std::sort(sorted.begin(),
+            sorted.end(),
+            [](ar::Function* a, ar::Function* b) {
+              return a->name() < b->name();
+            });
+
+  std::unordered_set< ar::Function* > selected;
+  for (std::size_t i = this->index; i < sorted.size(); i += this->count) {
+    selected.insert(sorted[i]);
+  }
+
+  std::vector< ar::Function* > result;
+  std::copy_if(functions.begin(),
+               functions.end(),
+               std::back_inserter(result),
+               [&selected](ar::Function* fun) {
+                 return selected.count(fun) > 0;
+               });
+  return result;
+}
+
+std::string shard_str(const ShardOption& shard) {
+  return std::to_string(shard.index) + "/" + std::to_string(shard.count);
+}
+
+std::string function_domains_str(
+    const std::unordered_map< ar::Function*, MachineIntDomainOption >&
+        function_domains) {
+  std::vector< std::pair< std::string, MachineIntDomainOption > > items;
+  items.reserve(function_domains.size());
+  for (const auto& item : function_domains) {
+    items.emplace_back(item.first->name(), item.second);
+  }
+  std::sort(items.begin(), items.end());
+
+  std::string r;
+  for (const auto& item : items) {
+    if (!r.empty()) {
+      r += ',';
+    }
+    r += item.first;
+    r += ':';
+    r += machine_int_domain_option_str(item.second);
+  }
+  return r;
+}
+
+AnalysisOptions AnalysisOptions::refined() const {
+  ikos_assert_msg(this->refine_domain, "no refine domain");
+  AnalysisOptions opts = *this;
+  opts.machine_int_domain = *this->refine_domain;
+  if (this->refine_timeout) {
+    opts.function_timeout = this->refine_timeout;
+  }
+  opts.sparse = false;
+  opts.refine_domain = boost::none;
+  opts.refine_timeout = boost::none;
+  opts.function_domains.clear();
+  opts.kernel_domain = boost::none;
+  return opts;
+}
+
+AnalysisOptions AnalysisOptions::with_domain(
+    MachineIntDomainOption domain) const {
+  AnalysisOptions opts = *this;
+  opts.machine_int_domain = domain;
+  opts.function_domains.clear();
+  opts.kernel_domain = boost::none;
+  return opts;
+}
+
 void AnalysisOptions::save(SettingsTable& table) {
   auto function_name = [](ar::Function* fun) { return fun->name(); };
 
@@ -73,12 +152,20 @@ void AnalysisOptions::save(SettingsTable& table) {
                                                           .end(),
                                                       function_name)));
 
+  table.insert("functions",
+               to_json(boost::make_transform_iterator(this->functions.begin(),
+                                                      function_name),
+                       boost::make_transform_iterator(this->functions.end(),
+                                                      function_name)));
+
   table.insert("procedural", procedural_str(this->procedural));
 
   table.insert("use-liveness", this->use_liveness);
 
   table.insert("use-pointer-analysis", this->use_pointer);
 
+  table.insert("use-frame-projection", this->use_frame_projection);
+
   table.insert("precision-level", precision_str(this->precision));
 
   table.insert("globals-init-policy",
@@ -87,12 +174,89 @@ void AnalysisOptions::save(SettingsTable& table) {
   table.insert("machine-int-domain",
                machine_int_domain_option_str(this->machine_int_domain));
 
+  if (!this->function_domains.empty()) {
+    table.insert("function-domains",
+                 function_domains_str(this->function_domains));
+  }
+
+  if (this->kernel_domain) {
+    table.insert("kernel-domain",
+                 machine_int_domain_option_str(*this->kernel_domain));
+  }
+
+  if (this->max_pack_size != 0) {
+    table.insert("max-pack-size", std::to_string(this->max_pack_size));
+  }
+
+  if (this->apron_max_size != 0) {
+    table.insert("apron-max-size", std::to_string(this->apron_max_size));
+  }
+
+  if (this->apron_timeout != 0) {
+    table.insert("apron-timeout", std::to_string(this->apron_timeout));
+  }
+
   table.insert("hardware-addresses",
                hardware_addresses_str(this->hardware_addresses));
 
   if (this->argc) {
     table.insert("argc", std::to_string(*this->argc));
   }
+
+  if (this->context_depth) {
+    table.insert("context-depth", std::to_string(*this->context_depth));
+  }
+
+  table.insert("low-memory", this->low_memory);
+  table.insert("release-functions", this->release_functions);
+  table.insert("release-ar", this->release_bodies);
+  table.insert("sparse", this->sparse);
+
+  if (this->function_timeout) {
+    table.insert("function-timeout", std::to_string(*this->function_timeout));
+  }
+
+  if (this->function_max_steps) {
+    table.insert("function-max-steps",
+                 std::to_string(*this->function_max_steps));
+  }
+
+  if (this->deadline) {
+    table.insert("deadline", std::to_string(*this->deadline));
+  }
+
+  if (this->refine_domain) {
+    table.insert("refine-domain",
+                 machine_int_domain_option_str(*this->refine_domain));
+  }
+
+  if (this->refine_timeout) {
+    table.insert("refine-timeout", std::to_string(*this->refine_timeout));
+  }
+
+  if (this->tuning_file) {
+    table.insert("tuning", *this->tuning_file);
+  }
+
+  table.insert("fixpoint-stats", this->fixpoint_stats);
+  table.insert("transfer-stats", this->transfer_stats);
+  table.insert("state-stats", this->state_stats);
+
+  if (this->max_cells) {
+    table.insert("max-cells", std::to_string(*this->max_cells));
+  }
+
+  if (this->aggregate_checks) {
+    table.insert("aggregate-checks", std::to_string(*this->aggregate_checks));
+  }
+
+  table.insert("skip-safe-contexts", this->skip_safe_contexts);
+  table.insert("group-contexts", this->group_contexts);
+  table.insert("trivial-checks", this->trivial_checks);
+
+  if (this->shard) {
+    table.insert("shard", shard_str(*this->shard));
+  }
 }
 
 } // end namespace analyzer
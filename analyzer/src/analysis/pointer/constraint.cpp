@@ -44,7 +44,12 @@
  *
  ******************************************************************************/
 
+#include <string>
+#include <vector>
+
 #include <ikos/analyzer/analysis/pointer/constraint.hpp>
+#include <ikos/analyzer/util/log.hpp>
+#include <ikos/analyzer/util/thread_pool.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -58,8 +63,35 @@ void PointerConstraints::add(std::unique_ptr< PointerConstraint > cst) {
   this->_system.add(std::move(cst));
 }
 
-void PointerConstraints::solve() {
-  this->_system.solve();
+void PointerConstraints::solve(unsigned jobs) {
+  if (jobs <= 1) {
+    this->_system.solve();
+    return;
+  }
+
+  using ConstraintSystem =
+      core::pointer::ConstraintSystem< Variable*, MemoryLocation* >;
+
+  std::vector< ConstraintSystem > systems = this->_system.split(jobs);
+  if (systems.size() <= 1) {
+    for (ConstraintSystem& system : systems) {
+      this->_system.merge(std::move(system));
+    }
+    this->_system.solve();
+    return;
+  }
+
+  log::debug("Solving pointer constraints using " +
+             std::to_string(systems.size()) + " threads");
+  ThreadPool pool(systems.size());
+  for (ConstraintSystem& system : systems) {
+    pool.push([&system](std::size_t) { system.solve(); });
+  }
+  pool.run();
+
+  for (ConstraintSystem& system : systems) {
+    this->_system.merge(std::move(system));
+  }
 }
 
 void PointerConstraints::results(PointerInfo& info) const {
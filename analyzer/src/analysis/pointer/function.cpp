@@ -52,6 +52,8 @@
 #include <ikos/core/domain/pointer/dummy.hpp>
 #include <ikos/core/domain/uninitialized/dummy.hpp>
 
+#include <ikos/ar/verify/type.hpp>
+
 #include <ikos/analyzer/analysis/pointer/constraint.hpp>
 #include <ikos/analyzer/analysis/pointer/function.hpp>
 #include <ikos/analyzer/analysis/pointer/value.hpp>
@@ -151,12 +153,38 @@ void FunctionPointerAnalysis::run() {
   }
 
   log::debug("Solving pointer constraints");
-  constraints.solve();
+  constraints.solve(_ctx.opts.jobs);
 
   // Save information
   constraints.results(this->_info);
 }
 
+const PointsToSet& FunctionPointerAnalysis::callees(ar::CallBase* call) {
+  return *this->_callees.get_or_create(call, [&] {
+    auto ptr = dyn_cast< ar::InternalVariable >(call->called());
+    if (ptr == nullptr) {
+      return PointsToSet::top();
+    }
+
+    PointsToSet points_to =
+        this->_info.get(_ctx.var_factory->get_internal(ptr)).points_to();
+    if (points_to.is_top() || points_to.is_bottom()) {
+      return PointsToSet::top();
+    }
+
+    PointsToSet callees = PointsToSet::empty();
+    for (MemoryLocation* mem : points_to) {
+      if (auto fun_mem = dyn_cast< FunctionMemoryLocation >(mem)) {
+        if (ar::TypeVerifier::is_valid_call(call,
+                                            fun_mem->function()->type())) {
+          callees.add(mem);
+        }
+      }
+    }
+    return callees;
+  });
+}
+
 void FunctionPointerAnalysis::dump(std::ostream& o) const {
   o << "Function pointer analysis results:\n";
   this->_info.dump(o);
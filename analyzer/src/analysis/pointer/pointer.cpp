@@ -129,7 +129,7 @@ public:
   NumericalCodeInvariants(Context& ctx,
                           const FunctionPointerAnalysis& function_pointer,
                           ar::Code* code)
-      : FwdFixpointIterator(code),
+      : FwdFixpointIterator(code, *ctx.wto_cache),
         _ctx(ctx),
         _empty_call_context(ctx.call_context_factory->get_empty()),
         _function_pointer(function_pointer),
@@ -145,12 +145,13 @@ public:
                               unsigned iteration,
                               AbstractDomainT before,
                               AbstractDomainT after) override {
-    if (iteration <= 1) {
+    if (iteration <= 1 ||
+        (this->_profile && this->_profile->join_iteration(head, iteration))) {
       before.join_iter_with(after);
       return before;
     }
-    if (iteration == 2 && this->_profile) {
-      if (auto threshold = this->_profile->widening_hint(head)) {
+    if (this->_profile) {
+      if (auto threshold = this->_profile->widening_hint(head, iteration)) {
         before.widen_threshold_with(after, *threshold);
         return before;
       }
@@ -286,7 +287,7 @@ void PointerAnalysis::run() {
   }
 
   log::debug("Solving pointer constraints");
-  constraints.solve();
+  constraints.solve(_ctx.opts.jobs);
 
   // Save information
   constraints.results(this->_info);
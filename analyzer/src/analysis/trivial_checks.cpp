@@ -0,0 +1,174 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Syntactic pre-pass deciding the trivially safe checks
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <algorithm>
+#include <array>
+#include <unordered_set>
+
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/function.hpp>
+#include <ikos/ar/semantic/value.hpp>
+
+#include <ikos/analyzer/analysis/call_context.hpp>
+#include <ikos/analyzer/analysis/trivial_checks.hpp>
+#include <ikos/analyzer/checker/kind.hpp>
+#include <ikos/analyzer/database/output.hpp>
+#include <ikos/analyzer/support/cast.hpp>
+#include <ikos/analyzer/support/number.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+TrivialChecksAnalysis::TrivialChecksAnalysis(Context& ctx) : _ctx(ctx) {}
+
+TrivialChecksAnalysis::~TrivialChecksAnalysis() = default;
+
+void TrivialChecksAnalysis::run() {
+  const auto& analyses = this->_ctx.opts.analyses;
+  bool division_by_zero = std::find(analyses.begin(),
+                                    analyses.end(),
+                                    CheckerName::DivisionByZero) !=
+                          analyses.end();
+  bool shift_count = std::find(analyses.begin(),
+                               analyses.end(),
+                               CheckerName::ShiftCount) != analyses.end();
+  if (!division_by_zero && !shift_count) {
+    return;
+  }
+
+  std::unordered_set< ar::Function* >
+      selected(this->_ctx.opts.functions.begin(),
+               this->_ctx.opts.functions.end());
+  CallContext* empty = this->_ctx.call_context_factory->get_empty();
+  ChecksTable& checks = this->_ctx.output_db->checks;
+
+  for (auto it = this->_ctx.bundle->function_begin(),
+            et = this->_ctx.bundle->function_end();
+       it != et;
+       ++it) {
+    ar::Function* fun = *it;
+    if (!fun->is_definition() ||
+        (!selected.empty() && selected.count(fun) == 0)) {
+      continue;
+    }
+
+    for (ar::BasicBlock* bb : *fun->body()) {
+      for (ar::Statement* stmt : *bb) {
+        auto bin = dyn_cast< ar::BinaryOperation >(stmt);
+        if (bin == nullptr) {
+          continue;
+        }
+
+        if (division_by_zero && is_safe_division(bin)) {
+          this->_division_by_zero.insert(stmt);
+          checks.insert(CheckKind::DivisionByZero,
+                        CheckerName::DivisionByZero,
+                        Result::Ok,
+                        stmt,
+                        empty,
+                        std::array< ar::Value*, 1 >{{bin->right()}});
+        }
+        if (shift_count && is_safe_shift(bin)) {
+          this->_shift_count.insert(stmt);
+          checks.insert(CheckKind::ShiftCount,
+                        CheckerName::ShiftCount,
+                        Result::Ok,
+                        stmt,
+                        empty,
+                        std::array< ar::Value*, 1 >{{bin->right()}});
+        }
+      }
+    }
+  }
+}
+
+bool TrivialChecksAnalysis::is_safe(CheckerName checker,
+                                    ar::Statement* stmt) const {
+  switch (checker) {
+    case CheckerName::DivisionByZero:
+      return this->_division_by_zero.count(stmt) != 0;
+    case CheckerName::ShiftCount:
+      return this->_shift_count.count(stmt) != 0;
+    default:
+      return false;
+  }
+}
+
+bool TrivialChecksAnalysis::is_safe_division(ar::BinaryOperation* stmt) {
+  if (stmt->op() != ar::BinaryOperation::UDiv &&
+      stmt->op() != ar::BinaryOperation::SDiv &&
+      stmt->op() != ar::BinaryOperation::URem &&
+      stmt->op() != ar::BinaryOperation::SRem) {
+    return false;
+  }
+
+  auto divisor = dyn_cast< ar::IntegerConstant >(stmt->right());
+  return divisor != nullptr && !divisor->value().is_zero();
+}
+
+bool TrivialChecksAnalysis::is_safe_shift(ar::BinaryOperation* stmt) {
+  if (stmt->op() != ar::BinaryOperation::UShl &&
+      stmt->op() != ar::BinaryOperation::SShl &&
+      stmt->op() != ar::BinaryOperation::ULShr &&
+      stmt->op() != ar::BinaryOperation::SLShr &&
+      stmt->op() != ar::BinaryOperation::UAShr &&
+      stmt->op() != ar::BinaryOperation::SAShr) {
+    return false;
+  }
+
+  auto count = dyn_cast< ar::IntegerConstant >(stmt->right());
+  auto type = dyn_cast< ar::IntegerType >(stmt->result()->type());
+  if (count == nullptr || type == nullptr) {
+    return false;
+  }
+
+  // Same bounds as the ShiftCountChecker
+  MachineInt zero = MachineInt::zero(type->bit_width(), type->sign());
+  MachineInt limit =
+      MachineInt(type->bit_width() - 1, type->bit_width(), type->sign());
+  return count->value() >= zero && count->value() <= limit;
+}
+
+} // end namespace analyzer
+} // end namespace ikos
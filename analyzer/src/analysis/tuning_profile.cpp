@@ -0,0 +1,178 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the tuning profile
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <fstream>
+#include <sstream>
+
+#include <boost/functional/hash.hpp>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+
+#include <ikos/ar/semantic/statement.hpp>
+
+#include <ikos/analyzer/analysis/tuning_profile.hpp>
+#include <ikos/analyzer/exception.hpp>
+#include <ikos/analyzer/util/source_location.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+/// \brief Parse a precision level
+boost::optional< Precision > parse_precision(llvm::StringRef str) {
+  if (str == "reg") {
+    return Precision::Register;
+  } else if (str == "ptr") {
+    return Precision::Pointer;
+  } else if (str == "mem") {
+    return Precision::Memory;
+  } else {
+    return boost::none;
+  }
+}
+
+/// \brief Parse an unsigned integer
+boost::optional< unsigned > parse_unsigned(llvm::StringRef str) {
+  unsigned n;
+  if (str.getAsInteger(10, n)) {
+    return boost::none;
+  }
+  return n;
+}
+
+} // end anonymous namespace
+
+std::size_t TuningProfile::LoopKeyHash::operator()(const LoopKey& key) const {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, std::get< 0 >(key));
+  boost::hash_combine(seed, std::get< 1 >(key));
+  boost::hash_combine(seed, std::get< 2 >(key));
+  return seed;
+}
+
+void TuningProfile::load(const std::string& filepath) {
+  std::ifstream stream(filepath);
+  if (!stream.is_open()) {
+    throw ArgumentError("cannot open tuning profile '" + filepath + "'");
+  }
+
+  std::string line;
+  unsigned n_line = 0;
+  while (std::getline(stream, line)) {
+    n_line++;
+    llvm::StringRef buffer = llvm::StringRef(line).rtrim();
+    if (buffer.empty() || buffer.startswith("#")) {
+      continue;
+    }
+
+    auto error = [&filepath, n_line]() {
+      std::ostringstream buf;
+      buf << filepath << ":" << n_line << ": invalid tuning profile entry";
+      return ArgumentError(buf.str());
+    };
+
+    llvm::SmallVector< llvm::StringRef, 7 > fields;
+    buffer.split(fields, '\t');
+
+    if (fields[0] == "function" && fields.size() == 3) {
+      boost::optional< Precision > precision = parse_precision(fields[2]);
+      if (!precision) {
+        throw error();
+      }
+      this->_functions[fields[1].str()].precision = precision;
+    } else if (fields[0] == "loop" && fields.size() == 7) {
+      boost::optional< unsigned > n = parse_unsigned(fields[3]);
+      boost::optional< unsigned > column = parse_unsigned(fields[4]);
+      boost::optional< unsigned > delay = parse_unsigned(fields[5]);
+      boost::optional< unsigned > thresholds = parse_unsigned(fields[6]);
+      if (!n || !column || !delay || !thresholds) {
+        throw error();
+      }
+      this->_functions[fields[1].str()].loops[LoopKey(fields[2].str(),
+                                                       *n,
+                                                       *column)] =
+          LoopTuning{*delay, *thresholds};
+    } else {
+      throw error();
+    }
+  }
+}
+
+boost::optional< Precision > TuningProfile::precision(
+    ar::Function* fun) const {
+  auto it = this->_functions.find(fun->name());
+  if (it == this->_functions.end()) {
+    return boost::none;
+  }
+  return it->second.precision;
+}
+
+boost::optional< const LoopTuning& > TuningProfile::loop(
+    ar::Function* fun, ar::BasicBlock* head) const {
+  auto it = this->_functions.find(fun->name());
+  if (it == this->_functions.end() || it->second.loops.empty()) {
+    return boost::none;
+  }
+
+  for (ar::Statement* stmt : *head) {
+    if (!stmt->has_frontend()) {
+      continue;
+    }
+    SourceLocation loc = source_location(stmt);
+    if (!loc) {
+      return boost::none;
+    }
+    auto loop = it->second.loops.find(
+        LoopKey(loc.path().string(), loc.line(), loc.column()));
+    if (loop == it->second.loops.end()) {
+      return boost::none;
+    }
+    return loop->second;
+  }
+  return boost::none;
+}
+
+} // end namespace analyzer
+} // end namespace ikos
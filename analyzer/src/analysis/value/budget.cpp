@@ -0,0 +1,128 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the analysis budget
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <ikos/analyzer/analysis/value/budget.hpp>
+#include <ikos/analyzer/database/output.hpp>
+#include <ikos/analyzer/support/assert.hpp>
+#include <ikos/analyzer/util/demangle.hpp>
+#include <ikos/analyzer/util/log.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+const char* budget_kind_str(BudgetKind kind) {
+  switch (kind) {
+    case BudgetKind::Time:
+      return "time";
+    case BudgetKind::Steps:
+      return "steps";
+    case BudgetKind::Memory:
+      return "memory";
+    default:
+      ikos_unreachable("unreachable");
+  }
+}
+
+AnalysisBudget::AnalysisBudget(const AnalysisOptions& opts,
+                               const MemoryGovernor* memory_governor)
+    : _start(Timer::Clock::now()),
+      _steps(0),
+      _memory_governor(memory_governor) {
+  if (opts.function_timeout) {
+    this->_timeout = Timer::Duration(*opts.function_timeout);
+  }
+  if (opts.function_max_steps) {
+    this->_max_steps = *opts.function_max_steps;
+  }
+}
+
+void AnalysisBudget::start() {
+  this->_start = Timer::Clock::now();
+  this->_steps = 0;
+  this->_exhausted = boost::none;
+}
+
+void AnalysisBudget::step() {
+  this->_steps++;
+
+  if (this->_exhausted) {
+    return;
+  }
+  if (this->_max_steps && this->_steps > *this->_max_steps) {
+    this->_exhausted = BudgetKind::Steps;
+  } else if (this->_timeout && this->elapsed() > *this->_timeout) {
+    this->_exhausted = BudgetKind::Time;
+  } else if (this->_memory_governor != nullptr &&
+             this->_memory_governor->exceeded()) {
+    this->_exhausted = BudgetKind::Memory;
+  }
+}
+
+BudgetKind AnalysisBudget::exhausted_kind() const {
+  ikos_assert_msg(this->_exhausted, "budget is not exhausted");
+  return *this->_exhausted;
+}
+
+Timer::Duration AnalysisBudget::elapsed() const {
+  return std::chrono::duration_cast< Timer::Duration >(Timer::Clock::now() -
+                                                       this->_start);
+}
+
+void report_exhausted_budget(Context& ctx,
+                             ar::Function* fun,
+                             CallContext* call_context,
+                             const AnalysisBudget& budget) {
+  log::warning("analysis of function '" + demangle(fun) +
+               "' ran out of its " + budget_kind_str(budget.exhausted_kind()) +
+               " budget, loops were widened to top");
+  ctx.output_db->budgets.insert(fun,
+                                call_context,
+                                budget_kind_str(budget.exhausted_kind()),
+                                budget.elapsed().count(),
+                                static_cast< sqlite::DbInt64 >(budget.steps()));
+}
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
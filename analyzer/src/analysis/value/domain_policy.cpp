@@ -0,0 +1,170 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the selection of the machine integer abstract domain
+ * of each function
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+
+#include <ikos/core/fixpoint/wto.hpp>
+
+#include <ikos/ar/semantic/statement.hpp>
+
+#include <ikos/analyzer/analysis/value/domain_policy.hpp>
+#include <ikos/analyzer/support/cast.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+namespace {
+
+/// \brief Collect the depth of the cycles of a function, and the operations
+/// in its cycles
+class KernelWtoVisitor : public core::WtoComponentVisitor< ar::Code* > {
+private:
+  using WtoVertexT = core::WtoVertex< ar::Code* >;
+  using WtoCycleT = core::WtoCycle< ar::Code* >;
+
+private:
+  /// \brief Depth of the current component
+  unsigned _depth = 0;
+
+  /// \brief Maximum depth of the cycles
+  unsigned _max_depth = 0;
+
+  /// \brief Number of integer binary operations in cycles
+  std::size_t _arithmetic = 0;
+
+  /// \brief Number of pointer shifts by a variable offset in cycles
+  std::size_t _indexing = 0;
+
+public:
+  /// \brief Constructor
+  KernelWtoVisitor() = default;
+
+  /// \brief Deleted copy constructor
+  KernelWtoVisitor(const KernelWtoVisitor&) = delete;
+
+  /// \brief Deleted move constructor
+  KernelWtoVisitor(KernelWtoVisitor&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  KernelWtoVisitor& operator=(const KernelWtoVisitor&) = delete;
+
+  /// \brief Deleted move assignment operator
+  KernelWtoVisitor& operator=(KernelWtoVisitor&&) = delete;
+
+  /// \brief Destructor
+  ~KernelWtoVisitor() override = default;
+
+  void visit(const WtoVertexT& vertex) override {
+    if (this->_depth > 0) {
+      this->scan(vertex.node());
+    }
+  }
+
+  void visit(const WtoCycleT& cycle) override {
+    this->_depth++;
+    this->_max_depth = std::max(this->_max_depth, this->_depth);
+    this->scan(cycle.head());
+    for (auto it = cycle.begin(), et = cycle.end(); it != et; ++it) {
+      it->accept(*this);
+    }
+    this->_depth--;
+  }
+
+  /// \brief Return true if the function is a numeric kernel
+  bool is_kernel() const {
+    return this->_max_depth >= 2 ||
+           (this->_arithmetic > 0 && this->_indexing > 0);
+  }
+
+private:
+  /// \brief Count the operations of a basic block in a cycle
+  void scan(ar::BasicBlock* bb) {
+    for (ar::Statement* stmt : *bb) {
+      if (auto binop = dyn_cast< ar::BinaryOperation >(stmt)) {
+        if (binop->result()->type()->is_integer()) {
+          this->_arithmetic++;
+        }
+      } else if (auto shift = dyn_cast< ar::PointerShift >(stmt)) {
+        if (std::any_of(shift->term_begin(),
+                        shift->term_end(),
+                        [](const ar::PointerShift::Term& term) {
+                          return !term.second->is_integer_constant();
+                        })) {
+          this->_indexing++;
+        }
+      }
+    }
+  }
+
+}; // end class KernelWtoVisitor
+
+} // end anonymous namespace
+
+bool is_numeric_kernel(Context& ctx, ar::Function* fun) {
+  if (!fun->is_definition()) {
+    return false;
+  }
+
+  KernelWtoVisitor visitor;
+  core::Wto< ar::Code* > wto = ctx.wto_cache->get(fun->body());
+  wto.accept(visitor);
+  return visitor.is_kernel();
+}
+
+MachineIntDomainOption function_machine_int_domain(Context& ctx,
+                                                   ar::Function* fun) {
+  auto it = ctx.opts.function_domains.find(fun);
+  if (it != ctx.opts.function_domains.end()) {
+    return it->second;
+  }
+  if (ctx.opts.kernel_domain && is_numeric_kernel(ctx, fun)) {
+    return *ctx.opts.kernel_domain;
+  }
+  return ctx.opts.machine_int_domain;
+}
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
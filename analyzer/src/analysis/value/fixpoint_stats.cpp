@@ -0,0 +1,128 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Statistics on the fixpoint iterations of the value analysis
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <sstream>
+
+#include <ikos/analyzer/analysis/value/fixpoint_stats.hpp>
+#include <ikos/analyzer/database/output.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+FixpointStats::FixpointStats(const AnalysisOptions& opts)
+    : _enabled(opts.fixpoint_stats) {}
+
+std::size_t FixpointStats::size(const AbstractDomain& inv) const {
+  if (!this->_enabled) {
+    return 0;
+  }
+  std::ostringstream buf;
+  inv.dump(buf);
+  return buf.str().size();
+}
+
+void FixpointStats::add(ar::BasicBlock* head,
+                        const core::FixpointCycleStats& stats) {
+  if (!this->_enabled) {
+    return;
+  }
+  core::FixpointCycleStats& total = this->_map[head];
+  total.increasing_iterations += stats.increasing_iterations;
+  total.widenings += stats.widenings;
+  total.narrowings += stats.narrowings;
+  total.skipped_narrowings += stats.skipped_narrowings;
+  total.time += stats.time;
+  total.peak_size = std::max(total.peak_size, stats.peak_size);
+  total.copies += stats.copies;
+  total.analyzed_nodes += stats.analyzed_nodes;
+  total.reused_nodes += stats.reused_nodes;
+}
+
+/// \brief Return the first statement of the basic block with a source
+/// location, or null
+static ar::Statement* first_frontend_statement(ar::BasicBlock* bb) {
+  for (ar::Statement* stmt : *bb) {
+    if (stmt->has_frontend()) {
+      return stmt;
+    }
+  }
+  return nullptr;
+}
+
+void FixpointStats::report(Context& ctx,
+                           ar::Function* fun,
+                           CallContext* call_context) {
+  if (this->_map.empty()) {
+    return;
+  }
+
+  // Iterate on the basic blocks for a deterministic order
+  for (ar::BasicBlock* bb : *fun->body()) {
+    auto it = this->_map.find(bb);
+    if (it == this->_map.end()) {
+      continue;
+    }
+    const core::FixpointCycleStats& stats = it->second;
+    ctx.output_db->fixpoints
+        .insert(fun,
+                first_frontend_statement(bb),
+                call_context,
+                static_cast< sqlite::DbInt64 >(stats.increasing_iterations),
+                static_cast< sqlite::DbInt64 >(stats.widenings),
+                static_cast< sqlite::DbInt64 >(stats.narrowings),
+                stats.time.count(),
+                static_cast< sqlite::DbInt64 >(stats.peak_size),
+                static_cast< sqlite::DbInt64 >(stats.copies),
+                static_cast< sqlite::DbInt64 >(stats.analyzed_nodes),
+                static_cast< sqlite::DbInt64 >(stats.reused_nodes),
+                static_cast< sqlite::DbInt64 >(stats.skipped_narrowings));
+  }
+
+  this->_map.clear();
+}
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
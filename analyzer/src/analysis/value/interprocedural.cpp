@@ -41,9 +41,19 @@
  *
  ******************************************************************************/
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include <llvm/ADT/StringExtras.h>
+
 #include <ikos/core/fixpoint/fwd_fixpoint_iterator.hpp>
 #include <ikos/core/support/compiler.hpp>
 
@@ -51,20 +61,31 @@
 #include <ikos/ar/semantic/type.hpp>
 #include <ikos/ar/semantic/value.hpp>
 
+#include <ikos/analyzer/analysis/call_graph.hpp>
 #include <ikos/analyzer/analysis/execution_engine/engine.hpp>
 #include <ikos/analyzer/analysis/execution_engine/inliner.hpp>
 #include <ikos/analyzer/analysis/execution_engine/numerical.hpp>
 #include <ikos/analyzer/analysis/fixpoint_profile.hpp>
 #include <ikos/analyzer/analysis/pointer/pointer.hpp>
 #include <ikos/analyzer/analysis/value/abstract_domain.hpp>
+#include <ikos/analyzer/analysis/value/budget.hpp>
+#include <ikos/analyzer/analysis/value/fixpoint_stats.hpp>
+#include <ikos/analyzer/analysis/value/state_stats.hpp>
+#include <ikos/analyzer/analysis/value/transfer_stats.hpp>
 #include <ikos/analyzer/analysis/value/interprocedural.hpp>
 #include <ikos/analyzer/analysis/value/machine_int_domain.hpp>
 #include <ikos/analyzer/analysis/variable.hpp>
+#include <ikos/analyzer/analysis/variable_packing.hpp>
 #include <ikos/analyzer/checker/checker.hpp>
+#include <ikos/analyzer/database/cache.hpp>
 #include <ikos/analyzer/support/cast.hpp>
 #include <ikos/analyzer/util/demangle.hpp>
 #include <ikos/analyzer/util/log.hpp>
+#include <ikos/analyzer/util/memory_governor.hpp>
+#include <ikos/analyzer/util/progress.hpp>
+#include <ikos/analyzer/util/thread_pool.hpp>
 #include <ikos/analyzer/util/timer.hpp>
+#include <ikos/analyzer/util/trace.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -200,6 +221,145 @@ std::vector< std::pair< ar::Function*, MachineInt > > global_dtors(
   return entries;
 }
 
+/// \brief Collect the global variables that can be referenced by the analysis
+///
+/// A global variable can only be read if its address appears in code that
+/// might be executed: the entry points, the global constructors and
+/// destructors, any function they might call, directly or through a function
+/// pointer, and the initializers of referenced global variables.
+///
+/// Global variables outside of this set are left uninitialized, which avoids
+/// writing large unused constant tables into the initial invariant.
+class ReferencedGlobals {
+private:
+  /// \brief Functions to visit
+  std::vector< ar::Function* > _worklist;
+
+  /// \brief Global variables to visit
+  std::vector< ar::GlobalVariable* > _gv_worklist;
+
+  /// \brief Visited functions
+  std::unordered_set< ar::Function* > _functions;
+
+  /// \brief Referenced global variables
+  std::unordered_set< ar::GlobalVariable* > _globals;
+
+public:
+  /// \brief Constructor
+  ReferencedGlobals() = default;
+
+  /// \brief Add a root function
+  void add_root(ar::Function* fun) { this->add_function(fun); }
+
+  /// \brief Compute the referenced global variables
+  void run() {
+    while (!this->_worklist.empty() || !this->_gv_worklist.empty()) {
+      if (!this->_worklist.empty()) {
+        ar::Function* fun = this->_worklist.back();
+        this->_worklist.pop_back();
+        if (fun->is_definition()) {
+          this->visit_code(fun->body());
+        }
+      } else {
+        ar::GlobalVariable* gv = this->_gv_worklist.back();
+        this->_gv_worklist.pop_back();
+        if (gv->is_definition()) {
+          this->visit_code(gv->initializer());
+        }
+      }
+    }
+  }
+
+  /// \brief Return true if the given global variable can be referenced
+  bool contains(ar::GlobalVariable* gv) const {
+    return this->_globals.find(gv) != this->_globals.end();
+  }
+
+  /// \brief Return the number of referenced global variables
+  std::size_t size() const { return this->_globals.size(); }
+
+  /// \brief Return true if the given function might be executed
+  bool contains(ar::Function* fun) const {
+    return this->_functions.find(fun) != this->_functions.end();
+  }
+
+  /// \brief Call `f` on each function that might be executed
+  template < typename Function >
+  void for_each_function(Function f) const {
+    for (ar::Function* fun : this->_functions) {
+      f(fun);
+    }
+  }
+
+  /// \brief Return the structural hash of the visited functions and global
+  /// variables
+  ar::HashValue hash() const {
+    // Use a commutative combination, see ar::Bundle::hash()
+    ar::HashValue h = 0;
+    for (ar::Function* fun : this->_functions) {
+      h += ar::hash_combine(ar::hash_string(fun->name()), fun->hash());
+    }
+    for (ar::GlobalVariable* gv : this->_globals) {
+      h += ar::hash_combine(ar::hash_string(gv->name()), gv->hash());
+    }
+    return h;
+  }
+
+private:
+  /// \brief Add a function to visit
+  void add_function(ar::Function* fun) {
+    if (this->_functions.insert(fun).second) {
+      this->_worklist.push_back(fun);
+    }
+  }
+
+  /// \brief Add a global variable to visit
+  void add_global(ar::GlobalVariable* gv) {
+    if (this->_globals.insert(gv).second) {
+      this->_gv_worklist.push_back(gv);
+    }
+  }
+
+  /// \brief Visit the statements of the given code
+  void visit_code(ar::Code* code) {
+    for (ar::BasicBlock* bb : *code) {
+      for (ar::Statement* stmt : *bb) {
+        for (auto it = stmt->op_begin(), et = stmt->op_end(); it != et; ++it) {
+          this->visit_value(*it);
+        }
+      }
+    }
+  }
+
+  /// \brief Visit an operand, including the elements of aggregate constants
+  void visit_value(ar::Value* value) {
+    if (auto gv = dyn_cast< ar::GlobalVariable >(value)) {
+      this->add_global(gv);
+    } else if (auto cst = dyn_cast< ar::FunctionPointerConstant >(value)) {
+      this->add_function(cst->function());
+    } else if (auto cst = dyn_cast< ar::StructConstant >(value)) {
+      for (auto it = cst->field_begin(), et = cst->field_end(); it != et;
+           ++it) {
+        this->visit_value(it->value);
+      }
+    } else if (auto cst = dyn_cast< ar::SequentialConstant >(value)) {
+      for (ar::Value* element : cst->values()) {
+        this->visit_value(element);
+      }
+    }
+  }
+
+}; // end class ReferencedGlobals
+
+/// \brief Return true if the given function is part of a recursive component
+///
+/// The calls within a recursive component use shared fix-points that grow
+/// between iterations, so the transfer function of a basic block is not a
+/// function of its pre invariant only.
+bool is_recursive(Context& ctx, ar::Function* fun) {
+  return ctx.call_graph != nullptr && ctx.call_graph->is_recursive(fun);
+}
+
 /// \brief Fixpoint on a global variable initializer
 class GlobalVarInitializerFixpoint final
     : public core::InterleavedFwdFixpointIterator< ar::Code*, AbstractDomain > {
@@ -224,10 +384,16 @@ private:
 public:
   /// \brief Constructor
   GlobalVarInitializerFixpoint(Context& ctx, ar::GlobalVariable* gv)
-      : FwdFixpointIterator(gv->initializer()),
+      : FwdFixpointIterator(gv->initializer(), *ctx.wto_cache),
         _gv(gv),
         _ctx(ctx),
-        _empty_call_context(ctx.call_context_factory->get_empty()) {}
+        _empty_call_context(ctx.call_context_factory->get_empty()) {
+    this->set_low_memory(ctx.opts.low_memory ||
+                         (ctx.memory_governor != nullptr &&
+                          ctx.memory_governor->exceeded()));
+    this->set_reuse_unchanged(true);
+    this->set_in_place(true);
+  }
 
   /// \brief Propagate the invariant through the basic block
   AbstractDomain analyze_node(ar::BasicBlock* bb, AbstractDomain pre) override {
@@ -307,6 +473,92 @@ public:
 
 }; // end class GlobalVarInitializerFixpoint
 
+/// \brief Entry invariants of the function bodies whose checks are all safe
+///
+/// If the checks on a function body produced no warning and no error for an
+/// entry invariant, they cannot produce any for a smaller entry invariant,
+/// since the first fixpoint covers all the executions of the second one.
+class SafeContexts {
+private:
+  /// \brief Maximum number of entry invariants kept per function
+  static constexpr std::size_t MaxInvariantsPerFunction = 8;
+
+private:
+  /// \brief Mutex protecting _map
+  std::mutex _mutex;
+
+  /// \brief Map from functions to their safe entry invariants
+  std::unordered_map< ar::Function*, std::vector< AbstractDomain > > _map;
+
+public:
+  /// \brief Constructor
+  SafeContexts() = default;
+
+  /// \brief Deleted copy constructor
+  SafeContexts(const SafeContexts&) = delete;
+
+  /// \brief Deleted move constructor
+  SafeContexts(SafeContexts&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  SafeContexts& operator=(const SafeContexts&) = delete;
+
+  /// \brief Deleted move assignment operator
+  SafeContexts& operator=(SafeContexts&&) = delete;
+
+  /// \brief Destructor
+  ~SafeContexts() = default;
+
+  /// \brief Return true if the given entry invariant is included in a safe
+  /// entry invariant of the function
+  bool is_subsumed(ar::Function* fun, const AbstractDomain& entry_inv) {
+    std::vector< AbstractDomain > invariants;
+    {
+      std::lock_guard< std::mutex > lock(this->_mutex);
+      auto it = this->_map.find(fun);
+      if (it == this->_map.end()) {
+        return false;
+      }
+      invariants = it->second;
+    }
+    return std::any_of(invariants.begin(),
+                       invariants.end(),
+                       [&entry_inv](const AbstractDomain& inv) {
+                         return entry_inv.leq(inv);
+                       });
+  }
+
+  /// \brief Add a safe entry invariant for the given function
+  void add(ar::Function* fun, const AbstractDomain& entry_inv) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    std::vector< AbstractDomain >& invariants = this->_map[fun];
+    if (invariants.size() < MaxInvariantsPerFunction) {
+      invariants.push_back(entry_inv);
+    }
+  }
+
+}; // end class SafeContexts
+
+/// \brief Checks of a function body in a call context, and of its callees
+///
+/// This is used to write the checks of a parallel run in the order of a
+/// sequential run.
+struct ParallelChecksNode {
+  /// \brief Checks on the function body
+  ChecksTable::Buffer checks;
+
+  /// \brief Checks on the callees
+  std::vector< std::unique_ptr< ParallelChecksNode > > callees;
+
+  /// \brief Write all the checks in the database, in depth-first order
+  void flush(ChecksTable& table) {
+    table.flush(this->checks);
+    for (const auto& callee : this->callees) {
+      callee->flush(table);
+    }
+  }
+};
+
 /// \brief Fixpoint on a function body
 class FunctionFixpoint final
     : public core::InterleavedFwdFixpointIterator< ar::Code*, AbstractDomain > {
@@ -322,7 +574,16 @@ private:
   using InlineCallExecutionEngineT =
       InlineCallExecutionEngine< FunctionFixpoint, AbstractDomain >;
 
+  /// \brief Fix-points on callees with a truncated call context
+  using SharedCalleeMap = InlineCallExecutionEngineT::SharedCalleeMap;
+
+  /// \brief Fix-points on callees shared between calling contexts
+  using GroupedCalleeMap = InlineCallExecutionEngineT::GroupedCalleeMap;
+
 private:
+  /// \brief Analysis context
+  Context& _ctx;
+
   /// \brief Analyzed function
   ar::Function* _function;
 
@@ -332,6 +593,21 @@ private:
   /// \brief Machine integer abstract domain
   MachineIntDomainOption _machine_int_domain;
 
+  /// \brief Time and step budget of the current run
+  AnalysisBudget _budget;
+
+  /// \brief Budget of the last run, if it was exhausted
+  boost::optional< AnalysisBudget > _exhausted_budget;
+
+  /// \brief Statistics on the fixpoint iterations
+  FixpointStats _fixpoint_stats;
+
+  /// \brief Statistics on the transfer functions
+  TransferStats _transfer_stats;
+
+  /// \brief Statistics on the sizes of the abstract states
+  StateStats _state_stats;
+
   /// \brief Fixpoint profile
   boost::optional< const FixpointProfile& > _profile;
 
@@ -341,7 +617,30 @@ private:
   std::vector< ar::Function* > _analyzed_functions;
 
   /// \brief List of property checks to run
-  const std::vector< std::unique_ptr< Checker > >& _checkers;
+  CheckerList& _checkers;
+
+  /// \brief Safe entry invariants, or null
+  SafeContexts* _safe_contexts;
+
+  /// \brief Entry invariant of the last run, if _safe_contexts is not null
+  boost::optional< AbstractDomain > _entry_inv;
+
+  /// \brief Fix-points on callees with a truncated call context
+  ///
+  /// This is only owned by the fixpoint on the entry point and on the targets
+  /// of an indirect call with several potential callees, and null otherwise.
+  std::unique_ptr< SharedCalleeMap > _shared_callees;
+
+  /// \brief Fix-points on callees shared between calling contexts
+  ///
+  /// This is owned like _shared_callees.
+  std::unique_ptr< GroupedCalleeMap > _grouped_callees;
+
+  /// \brief True if the fix-point is shared with other calling contexts, see
+  /// AnalysisOptions::group_contexts
+  ///
+  /// The invariants are then kept after the checks, for the other contexts.
+  bool _grouped = false;
 
   /// \brief Numerical execution engine
   NumericalExecutionEngineT _exec_engine;
@@ -354,19 +653,33 @@ public:
   ///
   /// \param ctx Analysis context
   /// \param checkers List of checkers to run
+  /// \param safe_contexts Safe entry invariants, or null
+  /// \param cache_stats Statistics of the callee summary cache
   /// \param entry_point Function to analyze
+  /// \param jobs Number of threads analyzing the targets of indirect calls
   FunctionFixpoint(Context& ctx,
-                   const std::vector< std::unique_ptr< Checker > >& checkers,
-                   ar::Function* entry_point)
-      : FwdFixpointIterator(entry_point->body()),
+                   CheckerList& checkers,
+                   SafeContexts* safe_contexts,
+                   InlineCallCacheStats& cache_stats,
+                   ar::Function* entry_point,
+                   unsigned jobs)
+      : FwdFixpointIterator(entry_point->body(), *ctx.wto_cache),
+        _ctx(ctx),
         _function(entry_point),
         _call_context(ctx.call_context_factory->get_empty()),
         _machine_int_domain(ctx.opts.machine_int_domain),
+        _budget(ctx.opts, ctx.memory_governor),
+        _fixpoint_stats(ctx.opts),
+        _transfer_stats(ctx.opts),
+        _state_stats(ctx.opts),
         _profile(ctx.fixpoint_profiler == nullptr
                      ? boost::none
                      : ctx.fixpoint_profiler->profile(entry_point)),
         _analyzed_functions{entry_point},
         _checkers(checkers),
+        _safe_contexts(safe_contexts),
+        _shared_callees(std::make_unique< SharedCalleeMap >()),
+        _grouped_callees(std::make_unique< GroupedCalleeMap >()),
         _exec_engine(AbstractDomain::bottom(),
                      ctx,
                      this->_call_context,
@@ -378,8 +691,18 @@ public:
         _call_exec_engine(ctx,
                           _exec_engine,
                           *this,
+                          cache_stats,
+                          *this->_shared_callees,
+                          *this->_grouped_callees,
                           /* context_stable = */ true,
-                          /* convergence_achieved = */ false) {}
+                          /* convergence_achieved = */ false,
+                          jobs) {
+    this->set_low_memory(ctx.opts.low_memory ||
+                         (ctx.memory_governor != nullptr &&
+                          ctx.memory_governor->exceeded()));
+    this->set_reuse_unchanged(!is_recursive(ctx, entry_point));
+    this->set_in_place(true);
+  }
 
   /// \brief Constructor for a callee
   ///
@@ -388,21 +711,35 @@ public:
   /// \param call Call statement
   /// \param callee Called function
   /// \param context_stable Is the calling context stable (fixpoint reached)?
+  /// \param isolated Is the callee one of several targets of an indirect call?
+  /// If so, it owns the fix-points on its callees with a truncated call
+  /// context, and might be analyzed in parallel with the other targets.
   FunctionFixpoint(Context& ctx,
                    const FunctionFixpoint& caller,
                    ar::CallBase* call,
                    ar::Function* callee,
-                   bool context_stable)
-      : FwdFixpointIterator(callee->body()),
+                   bool context_stable,
+                   bool isolated)
+      : FwdFixpointIterator(callee->body(), *ctx.wto_cache),
+        _ctx(ctx),
         _function(callee),
         _call_context(
             ctx.call_context_factory->get_context(caller._call_context, call)),
         _machine_int_domain(ctx.opts.machine_int_domain),
+        _budget(ctx.opts, ctx.memory_governor),
+        _fixpoint_stats(ctx.opts),
+        _transfer_stats(ctx.opts),
+        _state_stats(ctx.opts),
         _profile(ctx.fixpoint_profiler == nullptr
                      ? boost::none
                      : ctx.fixpoint_profiler->profile(callee)),
         _analyzed_functions(caller._analyzed_functions),
         _checkers(caller._checkers),
+        _safe_contexts(caller._safe_contexts),
+        _shared_callees(isolated ? std::make_unique< SharedCalleeMap >()
+                                 : nullptr),
+        _grouped_callees(isolated ? std::make_unique< GroupedCalleeMap >()
+                                  : nullptr),
         _exec_engine(AbstractDomain::bottom(),
                      ctx,
                      this->_call_context,
@@ -414,15 +751,51 @@ public:
         _call_exec_engine(ctx,
                           _exec_engine,
                           *this,
+                          caller._call_exec_engine.cache_stats(),
+                          isolated ? *this->_shared_callees
+                                   : caller._call_exec_engine.shared_callees(),
+                          isolated
+                              ? *this->_grouped_callees
+                              : caller._call_exec_engine.grouped_callees(),
                           /* context_stable = */ context_stable,
-                          /* convergence_achieved = */ false) {
+                          /* convergence_achieved = */ false,
+                          /* jobs = */ isolated
+                              ? 1
+                              : caller._call_exec_engine.jobs()) {
     this->_analyzed_functions.push_back(callee);
+    this->set_low_memory(ctx.opts.low_memory ||
+                         (ctx.memory_governor != nullptr &&
+                          ctx.memory_governor->exceeded()));
+    this->set_reuse_unchanged(!is_recursive(ctx, callee));
+    this->set_in_place(true);
   }
 
   /// \brief Compute the fixpoint
   void run(AbstractDomain inv) {
+    // Callees are analyzed within the fixpoint of their caller
+    TraceSpan span(this->_call_context->empty() ? "fixpoint" : "inline",
+                   this->_function->name());
+    if (this->_safe_contexts != nullptr) {
+      this->_entry_inv = inv;
+    }
+    Progress::add_context();
+    this->_budget.start();
+    this->_state_stats.sample(inv);
     FwdFixpointIterator::run(std::move(inv));
     this->_call_exec_engine.mark_convergence_achieved();
+    if (this->_budget.exhausted()) {
+      this->_exhausted_budget = this->_budget;
+    } else {
+      this->_exhausted_budget = boost::none;
+    }
+
+    // A callee is only checked after the fixpoint of its caller, drop the
+    // invariants that can be recomputed until then
+    if (!this->_call_context->empty() && !this->low_memory() &&
+        this->_ctx.memory_governor != nullptr &&
+        this->_ctx.memory_governor->exceeded()) {
+      this->compact();
+    }
   }
 
   /// \brief Extrapolate the new state after an increasing iteration
@@ -430,12 +803,18 @@ public:
                              unsigned iteration,
                              AbstractDomain before,
                              AbstractDomain after) override {
-    if (iteration <= 1) {
+    if (this->_budget.exhausted()) {
+      // Out of budget, converge as fast as possible
+      return AbstractDomain::top();
+    }
+    Progress::add_iteration();
+    if (iteration <= 1 ||
+        (this->_profile && this->_profile->join_iteration(head, iteration))) {
       before.join_iter_with(after);
       return before;
     }
-    if (iteration == 2 && this->_profile) {
-      if (auto threshold = this->_profile->widening_hint(head)) {
+    if (this->_profile) {
+      if (auto threshold = this->_profile->widening_hint(head, iteration)) {
         before.widen_threshold_with(after, *threshold);
         return before;
       }
@@ -447,6 +826,9 @@ public:
   /// \brief Check if the decreasing iterations fixpoint is reached
   bool is_decreasing_iterations_fixpoint(const AbstractDomain& before,
                                          const AbstractDomain& after) override {
+    if (this->_budget.exhausted()) {
+      return true;
+    }
     if (machine_int_domain_option_has_narrowing(this->_machine_int_domain)) {
       return before.leq(after);
     } else {
@@ -454,12 +836,27 @@ public:
     }
   }
 
+  /// \brief Return the size of an invariant, for statistics
+  std::size_t abstract_value_size(const AbstractDomain& inv) override {
+    this->_state_stats.sample(inv);
+    return this->_fixpoint_stats.size(inv);
+  }
+
+  /// \brief Process the statistics on the iterations on a cycle
+  void process_cycle_stats(ar::BasicBlock* head,
+                           const core::FixpointCycleStats& stats) override {
+    this->_fixpoint_stats.add(head, stats);
+  }
+
   /// \brief Propagate the invariant through the basic block
   AbstractDomain analyze_node(ar::BasicBlock* bb, AbstractDomain pre) override {
+    this->_budget.step();
     this->_exec_engine.set_inv(std::move(pre));
     this->_exec_engine.exec_enter(bb);
     for (ar::Statement* stmt : *bb) {
-      transfer_function(this->_exec_engine, this->_call_exec_engine, stmt);
+      this->_transfer_stats.transfer_function(this->_exec_engine,
+                                              this->_call_exec_engine,
+                                              stmt);
     }
     this->_exec_engine.exec_leave(bb);
     return std::move(this->_exec_engine.inv());
@@ -487,62 +884,252 @@ public:
   }
 
   /// \brief Run the checks with the previously computed fix-point
-  void run_checks() {
-    for (const auto& checker : this->_checkers) {
-      checker->enter(this->_function, this->_call_context);
+  void run_checks() { this->run_checks(this->_call_context); }
+
+  /// \brief Run the checks with the previously computed fix-point, in the
+  /// given call context
+  ///
+  /// This is not the call context of the fix-point if it is shared with other
+  /// calling contexts.
+  void run_checks(CallContext* context) {
+    this->check_function(this->_checkers, context);
+    this->run_callee_checks(context);
+  }
+
+  /// \brief Run the checks with the previously computed fix-point, on a pool
+  /// of threads
+  ///
+  /// The checks on each callee are run by a separate task of the pool. On an
+  /// entry point, this does not run the checks on callees with a truncated
+  /// call context, see run_shared_checks().
+  ///
+  /// \param pool Pool of threads
+  /// \param checkers List of checkers for each worker of the pool
+  /// \param worker Index of the current worker
+  /// \param node Buffer for the checks, flushed later in a deterministic order
+  void run_parallel_checks(ThreadPool& pool,
+                           std::vector< CheckerList >& checkers,
+                           std::size_t worker,
+                           ParallelChecksNode& node) {
+    {
+      ChecksTable::BufferScope scope(node.checks);
+      this->check_function(checkers[worker], this->_call_context);
     }
 
-    // Check the function body
-    for (ar::BasicBlock* bb : *this->cfg()) {
-      this->_exec_engine.set_inv(this->pre(bb));
-      this->_exec_engine.exec_enter(bb);
-      for (const auto& checker : this->_checkers) {
-        checker->enter(bb, this->_exec_engine.inv(), this->_call_context);
-      }
+    // Callees are checked by other tasks, they cannot be cleared here
+    auto push_checks = [&pool, &checkers, &node](FunctionFixpoint* callee) {
+      node.callees.push_back(std::make_unique< ParallelChecksNode >());
+      ParallelChecksNode* callee_node = node.callees.back().get();
+      pool.push([callee, &pool, &checkers, callee_node](std::size_t w) {
+        callee->run_parallel_checks(pool, checkers, w, *callee_node);
+      });
+    };
+    this->_call_exec_engine.for_each_callee(push_checks);
+
+    if (this->_shared_callees != nullptr && !this->_call_context->empty()) {
+      // Target of an indirect call, see run_callee_checks()
+      this->_call_exec_engine.for_each_shared_callee(push_checks);
+    }
+  }
 
-      for (ar::Statement* stmt : *bb) {
-        // Check the statement if it's related to an llvm instruction
-        if (stmt->has_frontend()) {
-          for (const auto& checker : this->_checkers) {
-            checker->check(stmt, this->_exec_engine.inv(), this->_call_context);
-          }
-        }
+  /// \brief Run the checks on the callees with a truncated call context
+  ///
+  /// This should only be called on an entry point, after
+  /// run_parallel_checks().
+  void run_shared_checks() {
+    ikos_assert(this->_shared_callees != nullptr &&
+                this->_call_context->empty());
+    this->_call_exec_engine.clear();
+    this->_call_exec_engine.run_shared_checks();
+    this->_shared_callees->clear();
+    this->_grouped_callees->clear();
+  }
 
-        // Propagate
-        transfer_function(this->_exec_engine, this->_call_exec_engine, stmt);
+private:
+  /// \brief Run the checks on the function body, in the given call context
+  void check_function(CheckerList& checkers, CallContext* context) {
+    TraceSpan span("checks", this->_function->name());
+    if (context == this->_call_context) {
+      // Only the calling context of the fix-point reports its statistics
+      if (this->_exhausted_budget) {
+        report_exhausted_budget(this->_ctx,
+                                this->_function,
+                                this->_call_context,
+                                *this->_exhausted_budget);
       }
+      this->_fixpoint_stats.report(this->_ctx,
+                                   this->_function,
+                                   this->_call_context);
+      this->_transfer_stats.report(this->_ctx,
+                                   this->_function,
+                                   this->_call_context);
+      this->_state_stats.report(this->_ctx,
+                                this->_function,
+                                this->_call_context);
+    }
 
-      for (const auto& checker : this->_checkers) {
-        checker->leave(bb, this->_exec_engine.inv(), this->_call_context);
+    if (this->_entry_inv &&
+        this->_safe_contexts->is_subsumed(this->_function, *this->_entry_inv)) {
+      // Checks on the function body cannot fail
+      log::debug("Skipping checks for function '" +
+                 demangle(this->_function) + "'");
+      this->_entry_inv = boost::none;
+      if (!this->_grouped) {
+        this->clear();
       }
-      this->_exec_engine.exec_leave(bb);
+      return;
     }
 
-    for (const auto& checker : this->_checkers) {
-      checker->leave(this->_function, this->_call_context);
+    std::size_t num_unsafe_checks = ChecksTable::num_unsafe_checks();
+
+    for (const auto& checker : checkers) {
+      checker->enter(this->_function, context);
     }
 
-    // Clear the invariants
-    this->clear();
+    // Check the function body
+    if (this->low_memory()) {
+      // Recompute the invariants from the cycle heads
+      std::vector< bool > checked(this->cfg()->num_basic_blocks(), false);
+      this->replay(
+          [this, &checkers, &checked, context](ar::BasicBlock* bb,
+                                               const AbstractDomain& pre,
+                                               const AbstractDomain& /*post*/) {
+            checked[bb->index()] = true;
+            this->check_block(checkers, bb, pre, context);
+          });
+
+      // Basic blocks unreachable from the entry block
+      for (ar::BasicBlock* bb : *this->cfg()) {
+        if (!checked[bb->index()]) {
+          this->check_block(checkers, bb, AbstractDomain::bottom(), context);
+        }
+      }
+    } else {
+      for (ar::BasicBlock* bb : *this->cfg()) {
+        this->check_block(checkers, bb, this->pre(bb), context);
+      }
+    }
 
+    for (const auto& checker : checkers) {
+      checker->leave(this->_function, context);
+    }
+
+    if (this->_entry_inv &&
+        ChecksTable::num_unsafe_checks() == num_unsafe_checks) {
+      this->_safe_contexts->add(this->_function, *this->_entry_inv);
+    }
+    this->_entry_inv = boost::none;
+
+    // Clear the invariants, unless other calling contexts need them
+    if (!this->_grouped) {
+      this->clear();
+    }
+  }
+
+  /// \brief Run the checks on the callees, in the given call context of the
+  /// function
+  void run_callee_checks(CallContext* context) {
     // Run the checks on the callees
-    this->_call_exec_engine.run_checks();
+    this->_call_exec_engine.run_checks(context);
 
-    // Clear the list of callees
-    this->_call_exec_engine.clear();
+    // Clear the list of callees, unless other calling contexts need them
+    if (!this->_grouped) {
+      this->_call_exec_engine.clear();
+    }
+
+    if (this->_shared_callees != nullptr) {
+      // Run the checks on the callees with a truncated call context
+      this->_call_exec_engine.run_shared_checks();
+      this->_shared_callees->clear();
+      this->_grouped_callees->clear();
+    }
+  }
+
+  /// \brief Run the checks on the given basic block
+  void check_block(CheckerList& checkers,
+                   ar::BasicBlock* bb,
+                   const AbstractDomain& pre,
+                   CallContext* context) {
+    if (pre.is_normal_flow_bottom()) {
+      this->check_unreachable_block(checkers, bb, pre, context);
+      return;
+    }
+
+    this->_exec_engine.set_inv(pre);
+    this->_exec_engine.exec_enter(bb);
+    for (const auto& checker : checkers) {
+      checker->enter(bb, this->_exec_engine.inv(), context);
+    }
+
+    for (ar::Statement* stmt : *bb) {
+      // Check the statement if it's related to an llvm instruction
+      if (stmt->has_frontend()) {
+        checkers.check(stmt, this->_exec_engine.inv(), context);
+      }
+
+      // Propagate
+      transfer_function(this->_exec_engine, this->_call_exec_engine, stmt);
+    }
+
+    for (const auto& checker : checkers) {
+      checker->leave(bb, this->_exec_engine.inv(), context);
+    }
+    this->_exec_engine.exec_leave(bb);
+  }
+
+  /// \brief Run the checks on a basic block with a bottom pre invariant
+  ///
+  /// The block is unreachable: the invariant stays bottom on all statements,
+  /// so the checkers are called directly, without any transfer function.
+  void check_unreachable_block(CheckerList& checkers,
+                               ar::BasicBlock* bb,
+                               const AbstractDomain& pre,
+                               CallContext* context) {
+    for (const auto& checker : checkers) {
+      checker->enter(bb, pre, context);
+    }
+
+    for (ar::Statement* stmt : *bb) {
+      if (stmt->has_frontend()) {
+        checkers.check(stmt, pre, context);
+      }
+    }
+
+    for (const auto& checker : checkers) {
+      checker->leave(bb, pre, context);
+    }
   }
 
+public:
   /// \name Helpers for InlineCallExecutionEngine
   /// @{
 
   /// \brief Mark that the calling context is stable
   void mark_context_stable() { this->_call_exec_engine.mark_context_stable(); }
 
+  /// \brief Mark that the fix-point is shared with other calling contexts
+  ///
+  /// The fix-points on its callees are checked in each calling context too.
+  void mark_grouped() {
+    if (this->_grouped) {
+      return;
+    }
+    this->_grouped = true;
+    this->_call_exec_engine.for_each_callee(
+        [](FunctionFixpoint* callee) { callee->mark_grouped(); });
+  }
+
   /// \brief Return the inline call execution engine
   const InlineCallExecutionEngineT& inliner() const {
     return this->_call_exec_engine;
   }
 
+  /// \brief Return the analyzed function
+  ar::Function* function() const { return this->_function; }
+
+  /// \brief Return the current call context
+  CallContext* call_context() const { return this->_call_context; }
+
   /// \brief Return true if the given function is currently analyzed
   bool is_currently_analyzed(ar::Function* fun) const {
     return std::find(this->_analyzed_functions.begin(),
@@ -560,14 +1147,20 @@ public:
 }; // end class FunctionFixpoint
 
 /// \brief Return the initial invariant
-AbstractDomain init_invariant(MachineIntDomainOption machine_int_domain) {
+AbstractDomain init_invariant(const Context& ctx) {
+  VariablePackingPtr packing = nullptr;
+  if (ctx.variable_packing != nullptr) {
+    packing = ctx.variable_packing->packing();
+  }
+
   return AbstractDomain(
       /*normal=*/
-      MemoryAbstractDomain(PointerAbstractDomain(make_top_machine_int_domain(
-                                                     machine_int_domain),
-                                                 NullityAbstractDomain::top()),
-                           UninitializedAbstractDomain::top(),
-                           LifetimeAbstractDomain::top()),
+      MemoryAbstractDomain(
+          PointerAbstractDomain(
+              make_top_machine_int_domain(ctx.opts.machine_int_domain, packing),
+              NullityAbstractDomain::top()),
+          UninitializedAbstractDomain::top(),
+          LifetimeAbstractDomain::top()),
       /*caught_exceptions=*/MemoryAbstractDomain::bottom(),
       /*propagated_exceptions=*/MemoryAbstractDomain::bottom());
 }
@@ -630,6 +1223,441 @@ AbstractDomain init_main_invariant(Context& ctx,
   return inv;
 }
 
+/// \brief Return the initial invariant of an entry point
+///
+/// \param init_inv Invariant after the initialization of global variables
+AbstractDomain entry_point_invariant(Context& ctx,
+                                     ar::Function* entry_point,
+                                     const AbstractDomain& init_inv) {
+  AbstractDomain entry_inv = AbstractDomain::bottom();
+
+  if (std::find(ctx.opts.no_init_globals.begin(),
+                ctx.opts.no_init_globals.end(),
+                entry_point) == ctx.opts.no_init_globals.end()) {
+    // Use invariant with initialized global variables
+    entry_inv = init_inv;
+  } else {
+    // Default invariant
+    entry_inv = init_invariant(ctx);
+  }
+
+  if (entry_point->name() == "main" && entry_point->num_parameters() >= 2) {
+    entry_inv = init_main_invariant(ctx, entry_point, entry_inv);
+  }
+
+  return entry_inv;
+}
+
+/// \brief Initial invariants of the entry points
+///
+/// The invariant after the initialization of global variables is computed
+/// once, then frozen and shared by all entry points. The invariant of an entry
+/// point is only created when it is analyzed, as a copy sharing most of its
+/// structure with the frozen invariant.
+class EntryPointInvariants {
+private:
+  /// \brief Analysis context
+  Context& _ctx;
+
+  /// \brief Invariant after the initialization of global variables
+  const AbstractDomain _init_inv;
+
+public:
+  /// \brief Constructor
+  EntryPointInvariants(Context& ctx, AbstractDomain init_inv)
+      : _ctx(ctx), _init_inv(std::move(init_inv)) {}
+
+  /// \brief Return the initial invariant of the given entry point
+  ///
+  /// This is thread-safe.
+  AbstractDomain get(ar::Function* entry_point) const {
+    return entry_point_invariant(this->_ctx, entry_point, this->_init_inv);
+  }
+
+}; // end class EntryPointInvariants
+
+/// \brief Return the invariant after the static initialization of the
+/// referenced global variables
+AbstractDomain static_init_invariant(Context& ctx,
+                                     const ReferencedGlobals& referenced) {
+  AbstractDomain inv = init_invariant(ctx);
+  ar::Bundle* bundle = ctx.bundle;
+  for (auto it = bundle->global_begin(), et = bundle->global_end(); it != et;
+       ++it) {
+    ar::GlobalVariable* gv = *it;
+    if (gv->is_definition() && referenced.contains(gv) &&
+        is_initialized(gv, ctx.opts.globals_init_policy)) {
+      log::debug("Initializing global variable '" + gv->name() + "'");
+      GlobalVarInitializerFixpoint fixpoint(ctx, gv);
+      fixpoint.run(inv);
+      inv = fixpoint.exit_invariant();
+    }
+  }
+  return inv;
+}
+
+/// \brief Analyze the given entry point and check properties
+///
+/// \param parallel_checkers List of checkers for each thread checking the
+/// results in parallel, or null to check them on the current thread. This is
+/// also the number of threads analyzing the targets of indirect calls.
+/// \param refine True for the re-analysis of the entry point, see Refinement
+void analyze_entry_point(
+    Context& ctx,
+    CheckerList& checkers,
+    std::vector< CheckerList >* parallel_checkers,
+    SafeContexts* safe_contexts,
+    InlineCallCacheStats& cache_stats,
+    ar::Function* entry_point,
+    const value::AbstractDomain& entry_inv,
+    bool refine = false) {
+  FunctionFixpoint fixpoint(ctx,
+                            checkers,
+                            safe_contexts,
+                            cache_stats,
+                            entry_point,
+                            /* jobs = */ parallel_checkers != nullptr
+                                ? static_cast< unsigned >(
+                                      parallel_checkers->size())
+                                : 1);
+
+  {
+    if (refine) {
+      log::info("Re-analyzing entry point '" + demangle(entry_point) +
+                "' with domain " +
+                machine_int_domain_option_str(ctx.opts.machine_int_domain));
+    } else {
+      log::info("Analyzing entry point '" + demangle(entry_point) +
+                "'");
+    }
+    ScopeTimerDatabase t(ctx.output_db->times,
+                         std::string(refine ? "ikos-analyzer.refine."
+                                            : "ikos-analyzer.value.") +
+                             entry_point->name());
+    fixpoint.run(entry_inv);
+  }
+
+  {
+    log::info("Checking properties for entry point '" +
+              demangle(entry_point) + "'");
+    ScopeTimerDatabase t(ctx.output_db->times,
+                         std::string(refine ? "ikos-analyzer.refine-check."
+                                            : "ikos-analyzer.check.") +
+                             entry_point->name());
+    if (parallel_checkers != nullptr && !ctx.opts.group_contexts) {
+      // Fix-points shared between calling contexts are checked sequentially
+      ParallelChecksNode checks;
+      ThreadPool pool(parallel_checkers->size());
+      pool.push([&fixpoint, &pool, parallel_checkers, &checks](
+                    std::size_t worker) {
+        fixpoint.run_parallel_checks(pool, *parallel_checkers, worker, checks);
+      });
+      pool.run();
+      checks.flush(ctx.output_db->checks);
+      fixpoint.run_shared_checks();
+    } else {
+      fixpoint.run_checks();
+    }
+  }
+}
+
+/// \brief Return true if the given entry point might call one of the
+/// functions selected by the user, see AnalysisOptions::functions
+bool reaches_selected_functions(const Context& ctx, ar::Function* entry_point) {
+  ReferencedGlobals reachable;
+  reachable.add_root(entry_point);
+  reachable.run();
+  return std::any_of(ctx.opts.functions.begin(),
+                     ctx.opts.functions.end(),
+                     [&reachable](ar::Function* fun) {
+                       return reachable.contains(fun);
+                     });
+}
+
+/// \brief Return the estimated cost of an entry point, the sum of the costs
+/// of the functions it might call
+std::uint64_t entry_point_cost(const Context& ctx, ar::Function* entry_point) {
+  ReferencedGlobals reachable;
+  reachable.add_root(entry_point);
+  reachable.run();
+  std::uint64_t cost = 0;
+  reachable.for_each_function(
+      [&](ar::Function* fun) { cost += fixpoint_cost(ctx, fun); });
+  return cost;
+}
+
+/// \brief Return the number of statements checked when analyzing an entry
+/// point, an estimate of its number of checks
+///
+/// Only the statements of the functions selected by the user are checked.
+std::uint64_t entry_point_statements(const Context& ctx,
+                                     ar::Function* entry_point) {
+  ReferencedGlobals reachable;
+  reachable.add_root(entry_point);
+  reachable.run();
+  std::uint64_t statements = 0;
+  reachable.for_each_function([&](ar::Function* fun) {
+    if (!fun->is_definition() ||
+        (!ctx.opts.functions.empty() &&
+         std::find(ctx.opts.functions.begin(),
+                   ctx.opts.functions.end(),
+                   fun) == ctx.opts.functions.end())) {
+      return;
+    }
+    for (ar::BasicBlock* bb : *fun->body()) {
+      statements += bb->num_statements();
+    }
+  });
+  return statements;
+}
+
+/// \brief Sort the entry points, with their hashes and costs, in decreasing
+/// order of checked statements per unit of estimated cost
+///
+/// This maximizes the number of checks completed before a deadline.
+void sort_entry_points_by_density(const Context& ctx,
+                                  std::vector< ar::Function* >& entries,
+                                  std::vector< std::string >& hashes,
+                                  std::vector< std::uint64_t >& costs) {
+  std::vector< double > density;
+  density.reserve(entries.size());
+  for (std::size_t i = 0; i < entries.size(); i++) {
+    density.push_back(
+        static_cast< double >(entry_point_statements(ctx, entries[i])) /
+        static_cast< double >(std::max(costs[i], std::uint64_t(1))));
+  }
+
+  std::vector< std::size_t > order(entries.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(),
+                   order.end(),
+                   [&density](std::size_t a, std::size_t b) {
+                     return density[a] > density[b];
+                   });
+
+  std::vector< ar::Function* > sorted_entries;
+  std::vector< std::string > sorted_hashes;
+  std::vector< std::uint64_t > sorted_costs;
+  sorted_entries.reserve(entries.size());
+  sorted_hashes.reserve(entries.size());
+  sorted_costs.reserve(entries.size());
+  for (std::size_t i : order) {
+    sorted_entries.push_back(entries[i]);
+    sorted_hashes.push_back(std::move(hashes[i]));
+    sorted_costs.push_back(costs[i]);
+  }
+  entries = std::move(sorted_entries);
+  hashes = std::move(sorted_hashes);
+  costs = std::move(sorted_costs);
+}
+
+/// \brief Return true if the deadline of the analysis has passed, see
+/// AnalysisOptions::deadline
+bool deadline_passed(const Context& ctx, Timer::TimePoint start) {
+  return ctx.opts.deadline &&
+         Timer::Clock::now() - start >=
+             std::chrono::seconds(*ctx.opts.deadline);
+}
+
+/// \brief Return the hash of the code reachable from an entry point
+///
+/// This is the key of the entry point in the cache of previous results: any
+/// change in a function that might be called from the entry point, directly
+/// or transitively, invalidates its results. The functions selected by the
+/// user are also part of the key, since only their statements are checked.
+std::string entry_point_hash(const Context& ctx,
+                             ar::Function* entry_point,
+                             ar::GlobalVariable* gv_ctors,
+                             bool init_globals) {
+  ReferencedGlobals reachable;
+  reachable.add_root(entry_point);
+  if (init_globals) {
+    for (const auto& entry : global_cdtors(gv_ctors)) {
+      reachable.add_root(entry.first);
+    }
+  }
+  reachable.run();
+
+  ar::HashValue selected = 0;
+  for (ar::Function* fun : ctx.opts.functions) {
+    selected += ar::hash_string(fun->name());
+  }
+
+  return llvm::utohexstr(
+      ar::hash_combine(ar::hash_combine(reachable.hash(), selected),
+                       init_globals ? 1 : 0));
+}
+
+/// \brief Re-analysis of the entry points with warnings or errors, using a
+/// more precise abstract domain
+class Refinement {
+public:
+  /// \brief Context with the analysis options of the re-analysis
+  Context ctx;
+
+  /// \brief Checkers of each worker
+  std::vector< CheckerList > checkers;
+
+private:
+  /// \brief Referenced global variables
+  const ReferencedGlobals& _referenced;
+
+  /// \brief Global constructors, or null
+  ar::GlobalVariable* _gv_ctors;
+
+  /// \brief Statistics of the callee summary cache
+  InlineCallCacheStats& _cache_stats;
+
+  /// \brief Invariant after the initialization of global variables, in the
+  /// abstract domain of the re-analysis, computed on demand
+  boost::optional< AbstractDomain > _init_inv;
+
+  /// \brief Mutex protecting _init_inv
+  std::mutex _mutex;
+
+public:
+  /// \brief Constructor
+  Refinement(const Context& parent,
+             unsigned jobs,
+             const ReferencedGlobals& referenced,
+             ar::GlobalVariable* gv_ctors,
+             InlineCallCacheStats& cache_stats)
+      : ctx(parent, parent.opts.refined()),
+        _referenced(referenced),
+        _gv_ctors(gv_ctors),
+        _cache_stats(cache_stats) {
+    ctx.function_cache = nullptr;
+    checkers.reserve(jobs);
+    for (unsigned i = 0; i < jobs; i++) {
+      checkers.emplace_back(ctx);
+    }
+  }
+
+  /// \brief Return the initial invariant of the given entry point
+  AbstractDomain entry_invariant(ar::Function* entry_point) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    if (!this->_init_inv) {
+      // Only the invariants are needed, the checks were already reported
+      AbstractDomain inv = static_init_invariant(this->ctx, this->_referenced);
+      for (const auto& entry : global_ctors(this->_gv_ctors)) {
+        ar::Function* ctor = entry.first;
+        if (ctor->is_definition()) {
+          FunctionFixpoint fixpoint(this->ctx,
+                                    this->checkers[0],
+                                    /*safe_contexts=*/nullptr,
+                                    this->_cache_stats,
+                                    ctor,
+                                    /* jobs = */ 1);
+          fixpoint.run(inv);
+          inv = fixpoint.exit_invariant();
+        }
+      }
+      this->_init_inv = std::move(inv);
+    }
+    return entry_point_invariant(this->ctx, entry_point, *this->_init_inv);
+  }
+
+}; // end class Refinement
+
+/// \brief Return the number of warnings and errors in the given checks
+std::size_t num_unsafe_checks(const ChecksTable::Buffer& checks) {
+  return static_cast< std::size_t >(
+      std::count_if(checks.begin(),
+                    checks.end(),
+                    [](const ChecksTable::Check& check) {
+                      return check.status == Result::Warning ||
+                             check.status == Result::Error;
+                    }));
+}
+
+/// \brief Analyze an entry point, or reuse its checks from the cache if the
+/// code reachable from it is unchanged
+///
+/// \param hash Hash of the code reachable from the entry point, or empty to
+/// bypass the cache
+/// \param cost Estimated cost of the entry point, for the progress report
+/// \param refinement Re-analysis of the entry point if it has warnings or
+/// errors, or null
+/// \param worker Index of the current worker
+void analyze_cached_entry_point(
+    Context& ctx,
+    CheckerList& checkers,
+    std::vector< CheckerList >* parallel_checkers,
+    SafeContexts* safe_contexts,
+    InlineCallCacheStats& cache_stats,
+    ar::Function* entry_point,
+    const value::AbstractDomain& entry_inv,
+    const std::string& hash,
+    std::uint64_t cost,
+    Refinement* refinement,
+    std::size_t worker) {
+  ProgressScope progress(entry_point->name(), cost);
+
+  if (hash.empty() && refinement == nullptr) {
+    analyze_entry_point(ctx,
+                        checkers,
+                        parallel_checkers,
+                        safe_contexts,
+                        cache_stats,
+                        entry_point,
+                        entry_inv);
+    return;
+  }
+
+  ChecksTable::Buffer checks;
+  if (!hash.empty() &&
+      ctx.function_cache->lookup_entry_point(entry_point,
+                                             hash,
+                                             *ctx.call_context_factory,
+                                             checks)) {
+    log::info("Using cached results for entry point '" +
+              demangle(entry_point) + "'");
+    ctx.output_db->checks.flush(checks);
+    return;
+  }
+
+  {
+    ChecksTable::BufferScope scope(checks);
+    analyze_entry_point(ctx,
+                        checkers,
+                        parallel_checkers,
+                        safe_contexts,
+                        cache_stats,
+                        entry_point,
+                        entry_inv);
+  }
+
+  if (refinement != nullptr) {
+    std::size_t num_unsafe = num_unsafe_checks(checks);
+    if (num_unsafe > 0) {
+      ChecksTable::Buffer refined_checks;
+      {
+        ChecksTable::BufferScope scope(refined_checks);
+        analyze_entry_point(refinement->ctx,
+                            refinement->checkers[worker],
+                            /*parallel_checkers=*/nullptr,
+                            /*safe_contexts=*/nullptr,
+                            cache_stats,
+                            entry_point,
+                            refinement->entry_invariant(entry_point),
+                            /*refine=*/true);
+      }
+
+      // The re-analysis might be less precise, e.g. if it ran out of budget
+      if (num_unsafe_checks(refined_checks) <= num_unsafe) {
+        checks = std::move(refined_checks);
+      }
+    }
+  }
+
+  // Degraded results depend on the memory usage, do not reuse them
+  if (!hash.empty() &&
+      (ctx.memory_governor == nullptr || !ctx.memory_governor->exceeded())) {
+    ctx.function_cache->record_entry_point(entry_point, hash, checks);
+  }
+  ctx.output_db->checks.flush(checks);
+}
+
 } // end anonymous namespace
 
 void InterproceduralValueAnalysis::run() {
@@ -637,27 +1665,39 @@ void InterproceduralValueAnalysis::run() {
   ar::Bundle* bundle = _ctx.bundle;
 
   // Create checkers
-  std::vector< std::unique_ptr< Checker > > checkers;
-  for (CheckerName name : _ctx.opts.analyses) {
-    checkers.emplace_back(make_checker(_ctx, name));
+  CheckerList checkers(_ctx);
+
+  // Safe entry invariants, to skip checks on subsumed call contexts
+  std::unique_ptr< SafeContexts > safe_contexts;
+  if (_ctx.opts.skip_safe_contexts) {
+    safe_contexts = std::make_unique< SafeContexts >();
   }
 
-  // Initial invariant
-  value::AbstractDomain init_inv = init_invariant(_ctx.opts.machine_int_domain);
+  // Statistics of the callee summary cache
+  InlineCallCacheStats cache_stats;
+
+  // Global constructors and destructors
+  ar::GlobalVariable* gv_ctors = bundle->global_or_null("ar.global_ctors");
+  ar::GlobalVariable* gv_dtors = bundle->global_or_null("ar.global_dtors");
+
+  // Compute the global variables that can be referenced
+  ReferencedGlobals referenced;
+  for (ar::Function* entry_point : _ctx.opts.entry_points) {
+    referenced.add_root(entry_point);
+  }
+  for (const auto& entry : global_cdtors(gv_ctors)) {
+    referenced.add_root(entry.first);
+  }
+  for (const auto& entry : global_cdtors(gv_dtors)) {
+    referenced.add_root(entry.first);
+  }
+  referenced.run();
+  log::debug("Found " + std::to_string(referenced.size()) +
+             " referenced global variables");
 
   // Initialize global variables
   log::debug("Computing global variable static initialization");
-  for (auto it = bundle->global_begin(), et = bundle->global_end(); it != et;
-       ++it) {
-    ar::GlobalVariable* gv = *it;
-    if (gv->is_definition() &&
-        is_initialized(gv, _ctx.opts.globals_init_policy)) {
-      log::debug("Initializing global variable '" + gv->name() + "'");
-      GlobalVarInitializerFixpoint fixpoint(_ctx, gv);
-      fixpoint.run(init_inv);
-      init_inv = fixpoint.exit_invariant();
-    }
-  }
+  value::AbstractDomain init_inv = static_init_invariant(_ctx, referenced);
 
   if (_ctx.opts.display_invariants == DisplayOption::All) {
     log::out() << "Invariant after global variable static initialization:\n";
@@ -666,7 +1706,6 @@ void InterproceduralValueAnalysis::run() {
   }
 
   // Call constructors
-  ar::GlobalVariable* gv_ctors = bundle->global_or_null("ar.global_ctors");
   if (gv_ctors != nullptr) {
     log::info("Computing global variable dynamic initialization");
 
@@ -680,10 +1719,15 @@ void InterproceduralValueAnalysis::run() {
         continue;
       }
 
-      FunctionFixpoint fixpoint(_ctx, checkers, ctor);
+      FunctionFixpoint fixpoint(_ctx,
+                                checkers,
+                                safe_contexts.get(),
+                                cache_stats,
+                                ctor,
+                                /* jobs = */ 1);
 
       {
-        log::info("Analyzing global constructor '" + demangle(ctor->name()) +
+        log::info("Analyzing global constructor '" + demangle(ctor) +
                   "'");
         ScopeTimerDatabase t(_ctx.output_db->times,
                              "ikos-analyzer.value." + ctor->name());
@@ -692,7 +1736,7 @@ void InterproceduralValueAnalysis::run() {
 
       {
         log::info("Checking properties for global constructor '" +
-                  demangle(ctor->name()) + "'");
+                  demangle(ctor) + "'");
         ScopeTimerDatabase t(_ctx.output_db->times,
                              "ikos-analyzer.check." + ctor->name());
         fixpoint.run_checks();
@@ -708,7 +1752,42 @@ void InterproceduralValueAnalysis::run() {
     }
   }
 
-  // Analyze each entry point
+  // Number of threads
+  unsigned jobs = _ctx.opts.jobs;
+  if (jobs > 1 &&
+      (machine_int_domain_option_is_apron(_ctx.opts.machine_int_domain) ||
+       (_ctx.opts.refine_domain &&
+        machine_int_domain_option_is_apron(*_ctx.opts.refine_domain)))) {
+    log::warning("APRON domains do not support parallel analyses, "
+                 "analyzing entry points on a single thread");
+    jobs = 1;
+  }
+
+  // Re-analysis of the entry points with warnings or errors
+  std::unique_ptr< Refinement > refinement;
+  if (_ctx.opts.refine_domain) {
+    refinement = std::make_unique< Refinement >(_ctx,
+                                                std::max(jobs, 1U),
+                                                referenced,
+                                                gv_ctors,
+                                                cache_stats);
+  }
+
+  // Reuse the checks of unchanged entry points from previous runs
+  bool use_cache = _ctx.function_cache != nullptr;
+  if (use_cache && safe_contexts) {
+    log::warning("skipping safe call contexts makes the results of an entry "
+                 "point depend on the other entry points, ignoring the cache");
+    use_cache = false;
+  }
+
+  // Initial invariants, shared by all entry points
+  const EntryPointInvariants entry_invs(_ctx, init_inv);
+
+  // Entry points, their hashes for the cache and their estimated costs
+  std::vector< ar::Function* > entries;
+  std::vector< std::string > hashes;
+  std::vector< std::uint64_t > costs;
   for (ar::Function* entry_point : _ctx.opts.entry_points) {
     if (!entry_point->is_definition()) {
       log::error("missing implementation of function '" + entry_point->name() +
@@ -716,44 +1795,138 @@ void InterproceduralValueAnalysis::run() {
       continue;
     }
 
-    // Entry point initial invariant
-    value::AbstractDomain entry_inv = value::AbstractDomain::bottom();
+    if (!_ctx.opts.functions.empty() &&
+        !reaches_selected_functions(_ctx, entry_point)) {
+      log::info("Skipping entry point '" + demangle(entry_point) +
+                "', it cannot call the selected functions");
+      continue;
+    }
+
+    bool init_globals = std::find(_ctx.opts.no_init_globals.begin(),
+                                  _ctx.opts.no_init_globals.end(),
+                                  entry_point) ==
+                        _ctx.opts.no_init_globals.end();
+    entries.push_back(entry_point);
+    hashes.push_back(use_cache
+                         ? entry_point_hash(_ctx,
+                                            entry_point,
+                                            gv_ctors,
+                                            init_globals)
+                         : std::string());
+    costs.push_back((Progress::enabled() || _ctx.opts.deadline)
+                        ? entry_point_cost(_ctx, entry_point)
+                        : 1);
+  }
 
-    if (std::find(_ctx.opts.no_init_globals.begin(),
-                  _ctx.opts.no_init_globals.end(),
-                  entry_point) == _ctx.opts.no_init_globals.end()) {
-      // Use invariant with initialized global variables
-      entry_inv = init_inv;
-    } else {
-      // Default invariant
-      entry_inv = init_invariant(_ctx.opts.machine_int_domain);
+  // Complete as many checks as possible before the deadline
+  Timer::TimePoint start = Timer::Clock::now();
+  if (_ctx.opts.deadline) {
+    sort_entry_points_by_density(_ctx, entries, hashes, costs);
+  }
+
+  if (Progress::enabled()) {
+    Progress::set_total(entries.size(),
+                        std::accumulate(costs.begin(),
+                                        costs.end(),
+                                        std::uint64_t(0)));
+  }
+
+  if (jobs <= 1 || entries.size() <= 1) {
+    // Only the checks can run in parallel, create checkers for each worker
+    std::vector< CheckerList > parallel_checkers;
+    if (jobs > 1) {
+      log::debug("Checking properties using " + std::to_string(jobs) +
+                 " threads");
+      parallel_checkers.reserve(jobs);
+      for (unsigned i = 0; i < jobs; i++) {
+        parallel_checkers.emplace_back(_ctx);
+      }
     }
 
-    if (entry_point->name() == "main" && entry_point->num_parameters() >= 2) {
-      entry_inv = init_main_invariant(_ctx, entry_point, entry_inv);
+    // Analyze each entry point
+    for (std::size_t i = 0; i < entries.size(); i++) {
+      if (deadline_passed(_ctx, start)) {
+        log::warning("deadline reached, skipping " +
+                     std::to_string(entries.size() - i) +
+                     " remaining entry point(s)");
+        break;
+      }
+      analyze_cached_entry_point(_ctx,
+                                 checkers,
+                                 jobs > 1 ? &parallel_checkers : nullptr,
+                                 safe_contexts.get(),
+                                 cache_stats,
+                                 entries[i],
+                                 entry_invs.get(entries[i]),
+                                 hashes[i],
+                                 costs[i],
+                                 refinement.get(),
+                                 /*worker=*/0);
+      _ctx.output_db->db.publish();
     }
 
-    FunctionFixpoint fixpoint(_ctx, checkers, entry_point);
+    for (const CheckerList& worker : parallel_checkers) {
+      checkers.merge_times(worker);
+    }
+  } else {
+    // Checkers hold a state, create checkers for each worker
+    std::vector< CheckerList > worker_checkers;
+    worker_checkers.reserve(jobs);
+    for (unsigned i = 0; i < jobs; i++) {
+      worker_checkers.emplace_back(_ctx);
+    }
 
-    {
-      log::info("Analyzing entry point '" + demangle(entry_point->name()) +
-                "'");
-      ScopeTimerDatabase t(_ctx.output_db->times,
-                           "ikos-analyzer.value." + entry_point->name());
-      fixpoint.run(entry_inv);
+    // Checks of each entry point, written in the order of the entry points
+    std::vector< ChecksTable::Buffer > buffers(entries.size());
+
+    // Analyze each entry point in parallel
+    log::debug("Analyzing entry points using " + std::to_string(jobs) +
+               " threads");
+    ThreadPool pool(jobs);
+    for (std::size_t i = 0; i < entries.size(); i++) {
+      pool.push([this,
+                 i,
+                 &entries,
+                 &entry_invs,
+                 &worker_checkers,
+                 &safe_contexts,
+                 &cache_stats,
+                 &hashes,
+                 &costs,
+                 &refinement,
+                 &buffers,
+                 start](std::size_t worker) {
+        if (deadline_passed(this->_ctx, start)) {
+          log::warning("deadline reached, skipping entry point '" +
+                       demangle(entries[i]) + "'");
+          return;
+        }
+        ChecksTable::BufferScope scope(buffers[i]);
+        analyze_cached_entry_point(this->_ctx,
+                                   worker_checkers[worker],
+                                   /* parallel_checkers = */ nullptr,
+                                   safe_contexts.get(),
+                                   cache_stats,
+                                   entries[i],
+                                   entry_invs.get(entries[i]),
+                                   hashes[i],
+                                   costs[i],
+                                   refinement.get(),
+                                   worker);
+      });
     }
+    pool.run();
 
-    {
-      log::info("Checking properties for entry point '" +
-                demangle(entry_point->name()) + "'");
-      ScopeTimerDatabase t(_ctx.output_db->times,
-                           "ikos-analyzer.check." + entry_point->name());
-      fixpoint.run_checks();
+    for (ChecksTable::Buffer& buffer : buffers) {
+      _ctx.output_db->checks.flush(buffer);
+    }
+
+    for (const CheckerList& worker : worker_checkers) {
+      checkers.merge_times(worker);
     }
   }
 
   // Call destructors
-  ar::GlobalVariable* gv_dtors = bundle->global_or_null("ar.global_dtors");
   if (gv_dtors != nullptr) {
     log::info("Analyzing global destructors");
 
@@ -767,10 +1940,15 @@ void InterproceduralValueAnalysis::run() {
         continue;
       }
 
-      FunctionFixpoint fixpoint(_ctx, checkers, dtor);
+      FunctionFixpoint fixpoint(_ctx,
+                                checkers,
+                                safe_contexts.get(),
+                                cache_stats,
+                                dtor,
+                                /* jobs = */ 1);
 
       {
-        log::info("Analyzing global destructor '" + demangle(dtor->name()) +
+        log::info("Analyzing global destructor '" + demangle(dtor) +
                   "'");
         ScopeTimerDatabase t(_ctx.output_db->times,
                              "ikos-analyzer.value." + dtor->name());
@@ -780,7 +1958,7 @@ void InterproceduralValueAnalysis::run() {
 
       {
         log::info("Checking properties for global destructor: '" +
-                  demangle(dtor->name()) + "'");
+                  demangle(dtor) + "'");
         ScopeTimerDatabase t(_ctx.output_db->times,
                              "ikos-analyzer.check." + dtor->name());
         fixpoint.run_checks();
@@ -796,6 +1974,28 @@ void InterproceduralValueAnalysis::run() {
        ++it) {
     _ctx.output_db->functions.insert(*it);
   }
+
+  // Insert the time spent in each checker in the database
+  checkers.report_times();
+  if (refinement) {
+    for (std::size_t i = 1; i < refinement->checkers.size(); i++) {
+      refinement->checkers[0].merge_times(refinement->checkers[i]);
+    }
+    refinement->checkers[0].report_times();
+  }
+
+  // Insert the statistics of the callee summary cache in the database
+  _ctx.output_db->times.insert("ikos-analyzer.value.summary-cache.hits",
+                               static_cast< sqlite::DbDouble >(
+                                   cache_stats.hits.load()));
+  _ctx.output_db->times.insert("ikos-analyzer.value.summary-cache.misses",
+                               static_cast< sqlite::DbDouble >(
+                                   cache_stats.misses.load()));
+  if (_ctx.opts.group_contexts) {
+    _ctx.output_db->times.insert("ikos-analyzer.value.summary-cache.grouped",
+                                 static_cast< sqlite::DbDouble >(
+                                     cache_stats.grouped.load()));
+  }
 }
 
 } // end namespace analyzer
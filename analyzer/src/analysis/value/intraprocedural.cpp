@@ -41,23 +41,45 @@
  *
  ******************************************************************************/
 
+#include <algorithm>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include <ikos/core/domain/machine_int/trace.hpp>
 #include <ikos/core/fixpoint/fwd_fixpoint_iterator.hpp>
 
 #include <ikos/analyzer/analysis/execution_engine/context_insensitive.hpp>
 #include <ikos/analyzer/analysis/execution_engine/engine.hpp>
 #include <ikos/analyzer/analysis/execution_engine/numerical.hpp>
 #include <ikos/analyzer/analysis/fixpoint_profile.hpp>
+#include <ikos/analyzer/analysis/literal.hpp>
+#include <ikos/analyzer/analysis/liveness.hpp>
 #include <ikos/analyzer/analysis/pointer/pointer.hpp>
 #include <ikos/analyzer/analysis/value/abstract_domain.hpp>
+#include <ikos/analyzer/analysis/value/budget.hpp>
+#include <ikos/analyzer/analysis/value/domain_policy.hpp>
+#include <ikos/analyzer/analysis/value/fixpoint_stats.hpp>
+#include <ikos/analyzer/analysis/value/state_stats.hpp>
+#include <ikos/analyzer/analysis/value/transfer_stats.hpp>
 #include <ikos/analyzer/analysis/value/intraprocedural.hpp>
 #include <ikos/analyzer/analysis/value/machine_int_domain.hpp>
+#include <ikos/analyzer/analysis/value/sparse.hpp>
 #include <ikos/analyzer/analysis/variable.hpp>
+#include <ikos/analyzer/analysis/variable_packing.hpp>
 #include <ikos/analyzer/checker/checker.hpp>
+#include <ikos/analyzer/database/cache.hpp>
+#include <ikos/analyzer/database/library_summary.hpp>
+#include <ikos/analyzer/database/output.hpp>
 #include <ikos/analyzer/util/demangle.hpp>
 #include <ikos/analyzer/util/log.hpp>
+#include <ikos/analyzer/util/memory_governor.hpp>
+#include <ikos/analyzer/util/progress.hpp>
+#include <ikos/analyzer/util/thread_pool.hpp>
 #include <ikos/analyzer/util/timer.hpp>
 
 namespace ikos {
@@ -72,6 +94,11 @@ namespace {
 
 using namespace value;
 
+/// \brief Return true if the soft memory limit is exceeded
+bool memory_exceeded(const Context& ctx) {
+  return ctx.memory_governor != nullptr && ctx.memory_governor->exceeded();
+}
+
 /// \brief Fixpoint on a function body
 class FunctionFixpoint
     : public core::InterleavedFwdFixpointIterator< ar::Code*, AbstractDomain > {
@@ -93,32 +120,105 @@ private:
   /// \brief Machine integer abstract domain
   MachineIntDomainOption _machine_int_domain;
 
+  /// \brief True if the function is analyzed with a lower precision, because
+  /// the soft memory limit was exceeded before the analysis started
+  bool _degraded;
+
+  /// \brief Precision of the analysis
+  Precision _precision;
+
   /// \brief Fixpoint profile
   boost::optional< const FixpointProfile& > _profile;
 
+  /// \brief Time and step budget
+  AnalysisBudget _budget;
+
+  /// \brief Statistics on the fixpoint iterations
+  FixpointStats _fixpoint_stats;
+
+  /// \brief Statistics on the transfer functions
+  TransferStats _transfer_stats;
+
+  /// \brief Statistics on the sizes of the abstract states
+  StateStats _state_stats;
+
+  /// \brief True if the exit block is reachable, for the library summary
+  bool _returns;
+
+  /// \brief Interval of the returned integer, for the library summary
+  boost::optional< core::machine_int::Interval > _return_interval;
+
 public:
   /// \brief Create a function fixpoint iterator
   FunctionFixpoint(Context& ctx, ar::Function* function)
-      : FwdFixpointIterator(function->body()),
+      : FwdFixpointIterator(function->body(), *ctx.wto_cache),
         _ctx(ctx),
         _function(function),
         _empty_call_context(ctx.call_context_factory->get_empty()),
         _machine_int_domain(ctx.opts.machine_int_domain),
+        _degraded(memory_exceeded(ctx)),
+        _precision(_degraded ? Precision::Register : ctx.opts.precision),
         _profile(ctx.fixpoint_profiler == nullptr
                      ? boost::none
-                     : ctx.fixpoint_profiler->profile(function)) {}
+                     : ctx.fixpoint_profiler->profile(function)),
+        _budget(ctx.opts, ctx.memory_governor),
+        _fixpoint_stats(ctx.opts),
+        _transfer_stats(ctx.opts),
+        _state_stats(ctx.opts),
+        _returns(false) {
+    this->set_low_memory(ctx.opts.low_memory || _degraded);
+    this->set_reuse_unchanged(true);
+    this->set_in_place(true);
+
+    // The tuning profile lowers the precision of functions that ran out of
+    // budget in a previous run
+    if (this->_profile && this->_profile->precision() &&
+        *this->_profile->precision() < this->_precision) {
+      this->_precision = *this->_profile->precision();
+    }
+  }
+
+  /// \brief Return true if the function is analyzed with a lower precision
+  /// because of the soft memory limit
+  bool degraded() const { return this->_degraded; }
+
+  /// \brief Compute the fixpoint
+  void run(AbstractDomain inv) {
+    Progress::add_context();
+    this->_budget.start();
+    this->_state_stats.sample(inv);
+    FwdFixpointIterator::run(std::move(inv));
+
+    if (this->_ctx.library_summary_output != nullptr) {
+      boost::optional< core::ZNumber > lb, ub;
+      if (this->_return_interval && !this->_return_interval->is_bottom()) {
+        lb = this->_return_interval->lb().to_z_number();
+        ub = this->_return_interval->ub().to_z_number();
+      }
+      this->_ctx.library_summary_output->record(this->_function,
+                                                this->_returns,
+                                                lb,
+                                                ub);
+    }
+  }
 
   /// \brief Extrapolate the new state after an increasing iteration
   AbstractDomain extrapolate(ar::BasicBlock* head,
                              unsigned iteration,
                              AbstractDomain before,
                              AbstractDomain after) override {
-    if (iteration <= 1) {
+    if (this->_budget.exhausted()) {
+      // Out of budget, converge as fast as possible
+      return AbstractDomain::top();
+    }
+    Progress::add_iteration();
+    if (iteration <= 1 ||
+        (this->_profile && this->_profile->join_iteration(head, iteration))) {
       before.join_iter_with(after);
       return before;
     }
-    if (iteration == 2 && this->_profile) {
-      if (auto threshold = this->_profile->widening_hint(head)) {
+    if (this->_profile) {
+      if (auto threshold = this->_profile->widening_hint(head, iteration)) {
         before.widen_threshold_with(after, *threshold);
         return before;
       }
@@ -130,6 +230,9 @@ public:
   /// \brief Check if the decreasing iterations fixpoint is reached
   bool is_decreasing_iterations_fixpoint(const AbstractDomain& before,
                                          const AbstractDomain& after) override {
+    if (this->_budget.exhausted()) {
+      return true;
+    }
     if (machine_int_domain_option_has_narrowing(this->_machine_int_domain)) {
       return before.leq(after);
     } else {
@@ -137,13 +240,26 @@ public:
     }
   }
 
+  /// \brief Return the size of an invariant, for statistics
+  std::size_t abstract_value_size(const AbstractDomain& inv) override {
+    this->_state_stats.sample(inv);
+    return this->_fixpoint_stats.size(inv);
+  }
+
+  /// \brief Process the statistics on the iterations on a cycle
+  void process_cycle_stats(ar::BasicBlock* head,
+                           const core::FixpointCycleStats& stats) override {
+    this->_fixpoint_stats.add(head, stats);
+  }
+
   /// \brief Propagate the invariant through the basic block
   AbstractDomain analyze_node(ar::BasicBlock* bb, AbstractDomain pre) override {
+    this->_budget.step();
     NumericalExecutionEngine< AbstractDomain >
         exec_engine(std::move(pre),
                     _ctx,
                     this->_empty_call_context,
-                    /* precision = */ _ctx.opts.precision,
+                    /* precision = */ this->_precision,
                     /* liveness = */ _ctx.liveness,
                     /* pointer_info = */ _ctx.pointer == nullptr
                         ? nullptr
@@ -152,12 +268,44 @@ public:
         exec_engine);
     exec_engine.exec_enter(bb);
     for (ar::Statement* stmt : *bb) {
-      transfer_function(exec_engine, call_exec_engine, stmt);
+      this->_transfer_stats.transfer_function(exec_engine,
+                                              call_exec_engine,
+                                              stmt);
+    }
+    if (this->_ctx.library_summary_output != nullptr &&
+        bb == this->_function->body()->exit_block_or_null()) {
+      this->record_exit(bb, exec_engine.inv());
     }
     exec_engine.exec_leave(bb);
     return std::move(exec_engine.inv());
   }
 
+  /// \brief Record the returned value, for the library summary
+  ///
+  /// This is called before the variables are forgotten by exec_leave(). The
+  /// last call, on the final invariant of the exit block, wins.
+  void record_exit(ar::BasicBlock* bb, const AbstractDomain& inv) {
+    this->_returns = !inv.is_normal_flow_bottom();
+    this->_return_interval = boost::none;
+    if (!this->_returns) {
+      return;
+    }
+    for (ar::Statement* stmt : *bb) {
+      auto ret = dyn_cast< ar::ReturnValue >(stmt);
+      if (ret == nullptr || !ret->has_operand() ||
+          !isa< ar::IntegerType >(ret->operand()->type())) {
+        continue;
+      }
+      const ScalarLit& val = this->_ctx.lit_factory->get_scalar(ret->operand());
+      if (val.is_machine_int()) {
+        this->_return_interval = core::machine_int::Interval(val.machine_int());
+      } else if (val.is_machine_int_var()) {
+        this->_return_interval =
+            inv.normal().integers().to_interval(val.var());
+      }
+    }
+  }
+
   /// \brief Propagate the invariant through an edge
   AbstractDomain analyze_edge(ar::BasicBlock* src,
                               ar::BasicBlock* dest,
@@ -166,7 +314,7 @@ public:
         exec_engine(std::move(pre),
                     _ctx,
                     this->_empty_call_context,
-                    /* precision = */ _ctx.opts.precision,
+                    /* precision = */ this->_precision,
                     /* liveness = */ _ctx.liveness,
                     /* pointer_info = */ _ctx.pointer == nullptr
                         ? nullptr
@@ -184,45 +332,49 @@ public:
                     const AbstractDomain& /*post*/) override {}
 
   /// \brief Run the checks with the previously computed fix-point
-  void run_checks(const std::vector< std::unique_ptr< Checker > >& checkers) {
+  void run_checks(CheckerList& checkers) {
+    if (this->_budget.exhausted()) {
+      report_exhausted_budget(this->_ctx,
+                              this->_function,
+                              this->_empty_call_context,
+                              this->_budget);
+    }
+    this->_fixpoint_stats.report(this->_ctx,
+                                 this->_function,
+                                 this->_empty_call_context);
+    this->_transfer_stats.report(this->_ctx,
+                                 this->_function,
+                                 this->_empty_call_context);
+    this->_state_stats.report(this->_ctx,
+                              this->_function,
+                              this->_empty_call_context);
+
     for (const auto& checker : checkers) {
       checker->enter(this->_function, this->_empty_call_context);
     }
 
     // Check the function body
-    for (ar::BasicBlock* bb : *this->cfg()) {
-      NumericalExecutionEngine< AbstractDomain >
-          exec_engine(this->pre(bb),
-                      _ctx,
-                      this->_empty_call_context,
-                      /* precision = */ _ctx.opts.precision,
-                      /* liveness = */ _ctx.liveness,
-                      /* pointer_info = */ _ctx.pointer == nullptr
-                          ? nullptr
-                          : &_ctx.pointer->results());
-      ContextInsensitiveCallExecutionEngine< AbstractDomain > call_exec_engine(
-          exec_engine);
-
-      exec_engine.exec_enter(bb);
-      for (const auto& checker : checkers) {
-        checker->enter(bb, exec_engine.inv(), this->_empty_call_context);
-      }
+    if (this->low_memory()) {
+      // Recompute the invariants from the cycle heads
+      std::vector< bool > checked(this->cfg()->num_basic_blocks(), false);
+      auto check = [this, &checkers, &checked](ar::BasicBlock* bb,
+                                               const AbstractDomain& pre,
+                                               const AbstractDomain&) {
+        checked[bb->index()] = true;
+        this->check_block(checkers, bb, pre);
+      };
+      this->replay(check);
 
-      for (ar::Statement* stmt : *bb) {
-        // Check the statement if it's related to an llvm instruction
-        if (stmt->has_frontend()) {
-          for (const auto& checker : checkers) {
-            checker->check(stmt, exec_engine.inv(), this->_empty_call_context);
-          }
+      // Basic blocks unreachable from the entry block
+      for (ar::BasicBlock* bb : *this->cfg()) {
+        if (!checked[bb->index()]) {
+          this->check_block(checkers, bb, AbstractDomain::bottom());
         }
-        // Propagate
-        transfer_function(exec_engine, call_exec_engine, stmt);
       }
-
-      for (const auto& checker : checkers) {
-        checker->leave(bb, exec_engine.inv(), this->_empty_call_context);
+    } else {
+      for (ar::BasicBlock* bb : *this->cfg()) {
+        this->check_block(checkers, bb, this->pre(bb));
       }
-      exec_engine.exec_leave(bb);
     }
 
     for (const auto& checker : checkers) {
@@ -230,60 +382,642 @@ public:
     }
   }
 
-}; // end class FunctionFixpoint
+private:
+  /// \brief Run the checks on the given basic block
+  void check_block(CheckerList& checkers,
+                   ar::BasicBlock* bb,
+                   const AbstractDomain& pre) {
+    if (pre.is_normal_flow_bottom()) {
+      this->check_unreachable_block(checkers, bb, pre);
+      return;
+    }
 
-} // end anonymous namespace
+    NumericalExecutionEngine< AbstractDomain >
+        exec_engine(pre,
+                    _ctx,
+                    this->_empty_call_context,
+                    /* precision = */ this->_precision,
+                    /* liveness = */ _ctx.liveness,
+                    /* pointer_info = */ _ctx.pointer == nullptr
+                        ? nullptr
+                        : &_ctx.pointer->results());
+    ContextInsensitiveCallExecutionEngine< AbstractDomain > call_exec_engine(
+        exec_engine);
 
-void IntraproceduralValueAnalysis::run() {
-  // Bundle
-  ar::Bundle* bundle = _ctx.bundle;
+    exec_engine.exec_enter(bb);
+    for (const auto& checker : checkers) {
+      checker->enter(bb, exec_engine.inv(), this->_empty_call_context);
+    }
+
+    for (ar::Statement* stmt : *bb) {
+      // Check the statement if it's related to an llvm instruction
+      if (stmt->has_frontend()) {
+        checkers.check(stmt, exec_engine.inv(), this->_empty_call_context);
+      }
+      // Propagate
+      transfer_function(exec_engine, call_exec_engine, stmt);
+    }
 
-  // Create checkers
-  std::vector< std::unique_ptr< Checker > > checkers;
-  for (CheckerName name : _ctx.opts.analyses) {
-    checkers.emplace_back(make_checker(_ctx, name));
+    for (const auto& checker : checkers) {
+      checker->leave(bb, exec_engine.inv(), this->_empty_call_context);
+    }
+    exec_engine.exec_leave(bb);
   }
 
-  // Initial invariant
-  value::AbstractDomain init_inv(
+  /// \brief Run the checks on a basic block with a bottom pre invariant
+  ///
+  /// The block is unreachable: the invariant stays bottom on all statements,
+  /// so the checkers are called directly, without any transfer function.
+  void check_unreachable_block(CheckerList& checkers,
+                               ar::BasicBlock* bb,
+                               const AbstractDomain& pre) {
+    for (const auto& checker : checkers) {
+      checker->enter(bb, pre, this->_empty_call_context);
+    }
+
+    for (ar::Statement* stmt : *bb) {
+      if (stmt->has_frontend()) {
+        checkers.check(stmt, pre, this->_empty_call_context);
+      }
+    }
+
+    for (const auto& checker : checkers) {
+      checker->leave(bb, pre, this->_empty_call_context);
+    }
+  }
+
+}; // end class FunctionFixpoint
+
+/// \brief Return the initial machine integer abstract value of the functions
+value::MachineIntAbstractDomain init_machine_int_invariant(Context& ctx) {
+  // Fixed packs of variables
+  value::VariablePackingPtr packing = nullptr;
+  if (ctx.variable_packing != nullptr) {
+    packing = ctx.variable_packing->packing();
+  }
+
+  return value::make_top_machine_int_domain(ctx.opts.machine_int_domain,
+                                            packing);
+}
+
+/// \brief Return the initial invariant of the functions, with the given
+/// machine integer abstract value
+AbstractDomain init_invariant(value::MachineIntAbstractDomain integers) {
+  return AbstractDomain(
       /*normal=*/value::MemoryAbstractDomain(
-          value::PointerAbstractDomain(value::make_top_machine_int_domain(
-                                           _ctx.opts.machine_int_domain),
+          value::PointerAbstractDomain(std::move(integers),
                                        value::NullityAbstractDomain::top()),
           value::UninitializedAbstractDomain::top(),
           value::LifetimeAbstractDomain::top()),
       /*caught_exceptions=*/value::MemoryAbstractDomain::bottom(),
       /*propagated_exceptions=*/value::MemoryAbstractDomain::bottom());
+}
+
+/// \brief Return the initial invariant of the functions
+AbstractDomain init_invariant(Context& ctx) {
+  return init_invariant(init_machine_int_invariant(ctx));
+}
+
+/// \brief Analysis of some functions with other options
+///
+/// This is used for the re-analysis of the functions with warnings or errors
+/// using a more precise abstract domain, and for the functions analyzed with
+/// their own abstract domain, see value::function_machine_int_domain().
+class AnalysisVariant {
+public:
+  /// \brief Context with the analysis options of the variant
+  Context ctx;
+
+  /// \brief Initial invariant, in the abstract domain of the variant
+  AbstractDomain init_inv;
+
+  /// \brief Checkers of each worker
+  std::vector< CheckerList > checkers;
+
+public:
+  /// \brief Constructor
+  AnalysisVariant(const Context& parent, AnalysisOptions opts, unsigned jobs)
+      : ctx(parent, std::move(opts)), init_inv(init_invariant(ctx)) {
+    ctx.function_cache = nullptr;
+    checkers.reserve(jobs);
+    for (unsigned i = 0; i < jobs; i++) {
+      checkers.emplace_back(ctx);
+    }
+  }
+
+  /// \brief Merge the times of the checkers and insert them in the database
+  void report_times() {
+    for (std::size_t i = 1; i < this->checkers.size(); i++) {
+      this->checkers[0].merge_times(this->checkers[i]);
+    }
+    this->checkers[0].report_times();
+  }
+
+}; // end class AnalysisVariant
+
+/// \brief Variants of the analysis for the functions analyzed with their own
+/// abstract domain
+using DomainVariants =
+    std::map< MachineIntDomainOption, std::unique_ptr< AnalysisVariant > >;
+
+/// \brief Compute the given fixpoint on a function and check properties
+///
+/// \param checks Buffer for the checks, or null to write them directly
+/// \param refine True for the re-analysis of the function, see
+/// AnalysisVariant
+///
+/// Return true if the results are degraded by the soft memory limit.
+template < typename Fixpoint >
+bool run_fixpoint(Context& ctx,
+                  ar::Function* function,
+                  Fixpoint& fixpoint,
+                  const AbstractDomain& init_inv,
+                  CheckerList& checkers,
+                  ChecksTable::Buffer* checks,
+                  bool refine) {
+  std::string phase = refine ? "refine" : "value";
+
+  {
+    if (refine) {
+      log::info("Re-analyzing function '" + demangle(function) +
+                "' with domain " +
+                machine_int_domain_option_str(ctx.opts.machine_int_domain));
+    } else {
+      log::info("Analyzing function '" + demangle(function) + "'");
+    }
+    ScopeTimerDatabase t(ctx.output_db->times,
+                         "ikos-analyzer." + phase + "." + function->name());
+    fixpoint.run(init_inv);
+  }
+
+  {
+    log::info("Checking properties for function '" +
+              demangle(function) + "'");
+    ScopeTimerDatabase t(ctx.output_db->times,
+                         "ikos-analyzer." + phase + "-check." +
+                             function->name());
+    if (checks != nullptr) {
+      ChecksTable::BufferScope scope(*checks);
+      fixpoint.run_checks(checkers);
+    } else {
+      fixpoint.run_checks(checkers);
+    }
+  }
+
+  return fixpoint.degraded();
+}
+
+/// \brief Compute the fixpoint on the given function and check properties,
+/// with the given initial invariant
+///
+/// See run_fixpoint()
+bool run_function_fixpoint(Context& ctx,
+                           ar::Function* function,
+                           const AbstractDomain& init_inv,
+                           CheckerList& checkers,
+                           ChecksTable::Buffer* checks,
+                           bool refine) {
+  if (ctx.opts.sparse) {
+    SparseFunctionFixpoint fixpoint(ctx, function);
+    return run_fixpoint(ctx,
+                        function,
+                        fixpoint,
+                        init_inv,
+                        checkers,
+                        checks,
+                        refine);
+  } else {
+    FunctionFixpoint fixpoint(ctx, function);
+    return run_fixpoint(ctx,
+                        function,
+                        fixpoint,
+                        init_inv,
+                        checkers,
+                        checks,
+                        refine);
+  }
+}
+
+/// \brief Compute the fixpoint on the given function and check properties
+///
+/// See run_fixpoint()
+bool run_function(Context& ctx,
+                  ar::Function* function,
+                  const AbstractDomain& init_inv,
+                  CheckerList& checkers,
+                  ChecksTable::Buffer* checks,
+                  bool refine) {
+#ifndef IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN
+  // Record the operations on the machine integer abstract domain, see
+  // Context::domain_trace
+  if (ctx.domain_trace != nullptr && function == ctx.domain_trace_function &&
+      !refine) {
+    log::info("Recording the machine integer domain operations of function '" +
+              demangle(function) + "'");
+    AbstractDomain traced_inv = init_invariant(value::MachineIntAbstractDomain(
+        core::machine_int::TraceDomain< Variable*,
+                                        value::MachineIntAbstractDomain >(
+            init_machine_int_invariant(ctx), *ctx.domain_trace)));
+    return run_function_fixpoint(ctx,
+                                 function,
+                                 traced_inv,
+                                 checkers,
+                                 checks,
+                                 refine);
+  }
+#endif
+
+  return run_function_fixpoint(ctx,
+                               function,
+                               init_inv,
+                               checkers,
+                               checks,
+                               refine);
+}
+
+/// \brief Return the number of warnings and errors in the given checks
+std::size_t num_unsafe_checks(const ChecksTable::Buffer& checks) {
+  return static_cast< std::size_t >(
+      std::count_if(checks.begin(),
+                    checks.end(),
+                    [](const ChecksTable::Check& check) {
+                      return check.status == Result::Warning ||
+                             check.status == Result::Error;
+                    }));
+}
+
+/// \brief Analyze the given function and check properties
+///
+/// \param variant Analysis of the function with its own abstract domain, or
+/// null
+/// \param refinement Re-analysis of the function if it has warnings or
+/// errors, or null
+/// \param worker Index of the current worker
+void analyze_function(Context& ctx,
+                      ar::Function* function,
+                      const AbstractDomain& init_inv,
+                      CheckerList& checkers,
+                      AnalysisVariant* variant,
+                      AnalysisVariant* refinement,
+                      std::size_t worker) {
+  ProgressScope progress(function->name(), fixpoint_cost(ctx, function));
+
+  // Reuse the results of a previous run, if the function is unchanged. The
+  // library summary needs a fixpoint, see LibrarySummaries.
+  ChecksTable::Buffer checks;
+  if (ctx.function_cache != nullptr && ctx.library_summary_output == nullptr &&
+      ctx.function_cache->lookup(function,
+                                 ctx.call_context_factory->get_empty(),
+                                 checks)) {
+    log::info("Using cached results for function '" +
+              demangle(function) + "'");
+    ctx.output_db->checks.flush(checks);
+    return;
+  }
+
+  bool buffered = ctx.function_cache != nullptr || refinement != nullptr;
+  bool degraded;
+  if (variant != nullptr) {
+    log::debug("Using domain " +
+               std::string(machine_int_domain_option_str(
+                   variant->ctx.opts.machine_int_domain)) +
+               " for function '" + demangle(function) + "'");
+    degraded = run_function(variant->ctx,
+                            function,
+                            variant->init_inv,
+                            variant->checkers[worker],
+                            buffered ? &checks : nullptr,
+                            /*refine=*/false);
+  } else {
+    degraded = run_function(ctx,
+                            function,
+                            init_inv,
+                            checkers,
+                            buffered ? &checks : nullptr,
+                            /*refine=*/false);
+  }
+
+  if (refinement != nullptr) {
+    std::size_t num_unsafe = num_unsafe_checks(checks);
+    if (num_unsafe > 0) {
+      ChecksTable::Buffer refined_checks;
+      bool refined_degraded = run_function(refinement->ctx,
+                                           function,
+                                           refinement->init_inv,
+                                           refinement->checkers[worker],
+                                           &refined_checks,
+                                           /*refine=*/true);
+
+      // The re-analysis might be less precise, e.g. if it ran out of budget
+      if (num_unsafe_checks(refined_checks) <= num_unsafe) {
+        checks = std::move(refined_checks);
+        degraded = refined_degraded;
+      }
+    }
+  }
+
+  if (ctx.function_cache != nullptr) {
+    // Degraded results depend on the memory usage, do not reuse them
+    if (!degraded) {
+      ctx.function_cache->record(function, checks);
+    }
+  }
+  if (buffered) {
+    ctx.output_db->checks.flush(checks);
+  }
+}
+
+/// \brief Collect the functions referenced by a value
+void collect_functions(ar::Value* value,
+                       std::unordered_set< ar::Function* >& functions) {
+  if (auto cst = dyn_cast< ar::FunctionPointerConstant >(value)) {
+    functions.insert(cst->function());
+  } else if (auto cst = dyn_cast< ar::StructConstant >(value)) {
+    for (auto it = cst->field_begin(), et = cst->field_end(); it != et; ++it) {
+      collect_functions(it->value, functions);
+    }
+  } else if (auto cst = dyn_cast< ar::SequentialConstant >(value)) {
+    for (auto it = cst->element_begin(), et = cst->element_end(); it != et;
+         ++it) {
+      collect_functions(*it, functions);
+    }
+  }
+}
 
-  // Analyze every function in the bundle
+/// \brief Collect the functions referenced by a code
+void collect_functions(ar::Code* code,
+                       std::unordered_set< ar::Function* >& functions) {
+  for (ar::BasicBlock* bb : *code) {
+    for (ar::Statement* stmt : *bb) {
+      for (auto it = stmt->op_begin(), et = stmt->op_end(); it != et; ++it) {
+        collect_functions(*it, functions);
+      }
+    }
+  }
+}
+
+/// \brief Return the functions referenced by a function body or a global
+/// variable initializer
+///
+/// The analysis of the other functions might look at their AR, e.g. to check
+/// an indirect call or to apply a library summary, so their body is kept.
+std::unordered_set< ar::Function* > referenced_functions(ar::Bundle* bundle) {
+  std::unordered_set< ar::Function* > functions;
+  for (auto it = bundle->global_begin(), et = bundle->global_end(); it != et;
+       ++it) {
+    if ((*it)->is_definition()) {
+      collect_functions((*it)->initializer(), functions);
+    }
+  }
   for (auto it = bundle->function_begin(), et = bundle->function_end();
        it != et;
        ++it) {
-    ar::Function* function = *it;
+    if ((*it)->is_definition()) {
+      collect_functions((*it)->body(), functions);
+    }
+  }
+  return functions;
+}
 
-    // Insert the function in the database
-    _ctx.output_db->functions.insert(function);
+/// \brief Release the analysis state of a function once its results are
+/// written, see AnalysisOptions::release_functions
+///
+/// If `release_body` is true, the AR body of the function is also destroyed.
+/// The ids of its statements and variables are removed from the caches first,
+/// since their addresses might be reused by new AR constants.
+void release_function(Context& ctx,
+                      ar::Function* function,
+                      bool release_body) {
+  ar::Code* body = function->body();
+  if (ctx.liveness != nullptr) {
+    ctx.liveness->release(body);
+  }
+  if (ctx.fixpoint_profiler != nullptr) {
+    ctx.fixpoint_profiler->release(function);
+  }
+  ctx.wto_cache->invalidate(body);
+  ctx.lit_factory->release(function);
+
+  if (release_body) {
+    ctx.output_db->statements.release(body);
+    ctx.output_db->operands.release(function);
+    function->erase_body();
+  }
+}
+
+} // end anonymous namespace
+
+void IntraproceduralValueAnalysis::run() {
+  // Bundle
+  ar::Bundle* bundle = _ctx.bundle;
+
+  // Initial invariant
+  value::AbstractDomain init_inv = init_invariant(_ctx);
 
-    if (!function->is_definition()) {
-      continue;
+  // Functions of the shard, for a distributed analysis
+  std::unordered_set< ar::Function* > shard;
+  if (_ctx.opts.shard) {
+    std::vector< ar::Function* > definitions;
+    std::copy_if(bundle->function_begin(),
+                 bundle->function_end(),
+                 std::back_inserter(definitions),
+                 [](ar::Function* fun) { return fun->is_definition(); });
+    for (ar::Function* function : _ctx.opts.shard->select(definitions)) {
+      shard.insert(function);
     }
+    log::debug("Analyzing " + std::to_string(shard.size()) + " out of " +
+               std::to_string(definitions.size()) + " functions (shard " +
+               shard_str(*_ctx.opts.shard) + ")");
+  }
+
+  // Functions requested by the user
+  std::unordered_set< ar::Function* > requested(_ctx.opts.functions.begin(),
+                                                _ctx.opts.functions.end());
 
-    FunctionFixpoint fixpoint(_ctx, function);
+  auto is_selected = [this, &shard, &requested](ar::Function* function) {
+    return (!this->_ctx.opts.shard || shard.count(function) > 0) &&
+           (requested.empty() || requested.count(function) > 0);
+  };
 
-    {
-      log::info("Analyzing function '" + demangle(function->name()) + "'");
-      ScopeTimerDatabase t(_ctx.output_db->times,
-                           "ikos-analyzer.value." + function->name());
-      fixpoint.run(init_inv);
+  // Functions analyzed with their own abstract domain
+  std::unordered_map< ar::Function*, MachineIntDomainOption > domains;
+  if (!_ctx.opts.function_domains.empty() || _ctx.opts.kernel_domain) {
+    for (auto it = bundle->function_begin(), et = bundle->function_end();
+         it != et;
+         ++it) {
+      if (!(*it)->is_definition() || !is_selected(*it)) {
+        continue;
+      }
+      MachineIntDomainOption domain =
+          function_machine_int_domain(_ctx, *it);
+      if (domain != _ctx.opts.machine_int_domain) {
+        domains.emplace(*it, domain);
+      }
     }
+    log::debug(std::to_string(domains.size()) +
+               " functions analyzed with their own abstract domain");
+  }
 
-    {
-      log::info("Checking properties for function '" +
-                demangle(function->name()) + "'");
-      ScopeTimerDatabase t(_ctx.output_db->times,
-                           "ikos-analyzer.check." + function->name());
-      fixpoint.run_checks(checkers);
+  // Number of threads
+  unsigned jobs = _ctx.opts.jobs;
+  if (jobs > 1 &&
+      (machine_int_domain_option_is_apron(_ctx.opts.machine_int_domain) ||
+       (_ctx.opts.refine_domain &&
+        machine_int_domain_option_is_apron(*_ctx.opts.refine_domain)) ||
+       std::any_of(domains.begin(),
+                   domains.end(),
+                   [](const auto& item) {
+                     return machine_int_domain_option_is_apron(item.second);
+                   }))) {
+    log::warning("APRON domains do not support parallel analyses, "
+                 "analyzing functions on a single thread");
+    jobs = 1;
+  }
+  if (jobs > 1 && _ctx.opts.release_functions) {
+    log::warning("releasing the analysis state of functions is not supported "
+                 "by parallel analyses, analyzing functions on a single "
+                 "thread");
+    jobs = 1;
+  }
+
+  // Functions whose AR body is needed by the analysis of other functions
+  std::unordered_set< ar::Function* > referenced;
+  if (_ctx.opts.release_bodies) {
+    referenced = referenced_functions(bundle);
+  }
+
+  // Variants of the analysis, for each abstract domain
+  DomainVariants variants;
+  for (const auto& item : domains) {
+    std::unique_ptr< AnalysisVariant >& variant = variants[item.second];
+    if (variant == nullptr) {
+      variant = std::make_unique< AnalysisVariant >(_ctx,
+                                                    _ctx.opts.with_domain(
+                                                        item.second),
+                                                    jobs);
+    }
+  }
+  auto variant_of = [&domains, &variants](ar::Function* function) {
+    auto it = domains.find(function);
+    return it != domains.end() ? variants.at(it->second).get() : nullptr;
+  };
+
+  // Re-analysis of the functions with warnings or errors
+  std::unique_ptr< AnalysisVariant > refinement;
+  if (_ctx.opts.refine_domain) {
+    refinement =
+        std::make_unique< AnalysisVariant >(_ctx, _ctx.opts.refined(), jobs);
+  }
+
+  if (Progress::enabled()) {
+    std::size_t num_functions = 0;
+    std::uint64_t cost = 0;
+    for (auto it = bundle->function_begin(), et = bundle->function_end();
+         it != et;
+         ++it) {
+      if ((*it)->is_definition() && is_selected(*it)) {
+        num_functions++;
+        cost += fixpoint_cost(_ctx, *it);
+      }
+    }
+    Progress::set_total(num_functions, cost);
+  }
+
+  if (jobs <= 1) {
+    // Create checkers
+    CheckerList checkers(_ctx);
+
+    // Analyze every function in the bundle
+    for (auto it = bundle->function_begin(), et = bundle->function_end();
+         it != et;
+         ++it) {
+      ar::Function* function = *it;
+
+      // Insert the function in the database
+      _ctx.output_db->functions.insert(function);
+
+      if (!function->is_definition() || !is_selected(function)) {
+        continue;
+      }
+
+      analyze_function(_ctx,
+                       function,
+                       init_inv,
+                       checkers,
+                       variant_of(function),
+                       refinement.get(),
+                       /*worker=*/0);
+      _ctx.output_db->db.publish();
+
+      if (_ctx.opts.release_functions) {
+        release_function(_ctx,
+                         function,
+                         _ctx.opts.release_bodies &&
+                             referenced.count(function) == 0);
+      }
     }
+
+    // Insert the time spent in each checker in the database
+    checkers.report_times();
+    for (const auto& item : variants) {
+      item.second->report_times();
+    }
+    if (refinement) {
+      refinement->report_times();
+    }
+    return;
+  }
+
+  // Insert all functions in the database
+  std::vector< ar::Function* > functions;
+  for (auto it = bundle->function_begin(), et = bundle->function_end();
+       it != et;
+       ++it) {
+    ar::Function* function = *it;
+    _ctx.output_db->functions.insert(function);
+
+    if (function->is_definition() && is_selected(function)) {
+      functions.push_back(function);
+    }
+  }
+
+  // Checkers hold a state, create checkers for each worker
+  std::vector< CheckerList > checkers;
+  checkers.reserve(jobs);
+  for (unsigned i = 0; i < jobs; i++) {
+    checkers.emplace_back(_ctx);
+  }
+
+  // Analyze every function in parallel
+  log::debug("Analyzing functions using " + std::to_string(jobs) +
+             " threads");
+  ThreadPool pool(jobs);
+  for (ar::Function* function : functions) {
+    AnalysisVariant* variant = variant_of(function);
+    pool.push([this, function, &init_inv, &checkers, variant, &refinement](
+                  std::size_t worker) {
+      analyze_function(this->_ctx,
+                       function,
+                       init_inv,
+                       checkers[worker],
+                       variant,
+                       refinement.get(),
+                       worker);
+      this->_ctx.output_db->db.publish();
+    });
+  }
+  pool.run();
+
+  // Insert the time spent in each checker in the database
+  for (std::size_t i = 1; i < checkers.size(); i++) {
+    checkers[0].merge_times(checkers[i]);
+  }
+  checkers[0].report_times();
+  for (const auto& item : variants) {
+    item.second->report_times();
+  }
+  if (refinement) {
+    refinement->report_times();
   }
 }
 
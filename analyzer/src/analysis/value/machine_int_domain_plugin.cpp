@@ -0,0 +1,201 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Load the machine integer abstract domains from modules
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/DynamicLibrary.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+
+#include <ikos/analyzer/analysis/value/machine_int_domain.hpp>
+#include <ikos/analyzer/exception.hpp>
+#include <ikos/analyzer/support/assert.hpp>
+#include <ikos/analyzer/util/log.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+namespace {
+
+/// \brief Number of machine integer abstract domains
+constexpr std::size_t NumMachineIntDomains =
+    static_cast< std::size_t >(
+        MachineIntDomainOption::VarPackApronPkgridPolyhedraLinearCongruences) +
+    1;
+
+/// \brief Constructor of each loaded domain, or null
+std::array< std::atomic< MakeTopMachineIntDomainFn >, NumMachineIntDomains >
+    LoadedDomains{};
+
+/// \brief Mutex for the loading of modules
+std::mutex LoadMutex;
+
+/// \brief Entry point of a module, see ikos_analyzer_machine_int_domain_plugin
+using PluginEntryFn = MakeTopMachineIntDomainFn (*)(MachineIntDomainOption);
+
+/// \brief Return the paths of the module of the given family
+///
+/// Modules are next to ikos-analyzer in the build directory, and in
+/// `<prefix>/lib/ikos` once installed.
+std::array< std::string, 2 > module_paths(const char* family) {
+  std::string exe = llvm::sys::fs::getMainExecutable(
+      "ikos-analyzer", reinterpret_cast< void* >(&load_machine_int_domain));
+  llvm::StringRef bin_dir = llvm::sys::path::parent_path(exe);
+  std::string filename =
+      std::string("ikos-analyzer-domain-") + family + ".so";
+
+  llvm::SmallString< 256 > build_path(bin_dir);
+  llvm::sys::path::append(build_path, filename);
+
+  llvm::SmallString< 256 > install_path(bin_dir);
+  llvm::sys::path::append(install_path, "..", "lib", "ikos", filename);
+
+  return {build_path.str().str(), install_path.str().str()};
+}
+
+} // end anonymous namespace
+
+const char* machine_int_domain_family(MachineIntDomainOption d) {
+  switch (d) {
+    case MachineIntDomainOption::Interval:
+    case MachineIntDomainOption::DenseInterval:
+    case MachineIntDomainOption::Congruence:
+    case MachineIntDomainOption::IntervalCongruence:
+    case MachineIntDomainOption::IntervalEquality:
+    case MachineIntDomainOption::PowersetInterval:
+      return "numeric";
+    case MachineIntDomainOption::DBM:
+    case MachineIntDomainOption::SplitDBM:
+    case MachineIntDomainOption::VarPackDBM:
+    case MachineIntDomainOption::VarPackDBMCongruence:
+    case MachineIntDomainOption::StaticPackDBM:
+      return "dbm";
+    case MachineIntDomainOption::Gauge:
+    case MachineIntDomainOption::GaugeIntervalCongruence:
+      return "gauge";
+    case MachineIntDomainOption::ApronInterval:
+    case MachineIntDomainOption::ApronOctagon:
+    case MachineIntDomainOption::ApronPolkaPolyhedra:
+    case MachineIntDomainOption::ApronPolkaLinearEqualities:
+    case MachineIntDomainOption::ApronPplPolyhedra:
+    case MachineIntDomainOption::ApronPplLinearCongruences:
+    case MachineIntDomainOption::ApronPkgridPolyhedraLinearCongruences:
+      return "apron";
+    case MachineIntDomainOption::VarPackApronOctagon:
+    case MachineIntDomainOption::VarPackApronPolkaPolyhedra:
+    case MachineIntDomainOption::VarPackApronPolkaLinearEqualities:
+    case MachineIntDomainOption::VarPackApronPplPolyhedra:
+    case MachineIntDomainOption::VarPackApronPplLinearCongruences:
+    case MachineIntDomainOption::VarPackApronPkgridPolyhedraLinearCongruences:
+      return "var-pack-apron";
+    default: {
+      ikos_unreachable("unreachable");
+    }
+  }
+}
+
+MakeTopMachineIntDomainFn load_machine_int_domain(MachineIntDomainOption d) {
+  auto index = static_cast< std::size_t >(d);
+  ikos_assert(index < NumMachineIntDomains);
+
+  MakeTopMachineIntDomainFn make_top =
+      LoadedDomains[index].load(std::memory_order_acquire);
+  if (make_top != nullptr) {
+    return make_top;
+  }
+
+  std::lock_guard< std::mutex > lock(LoadMutex);
+  make_top = LoadedDomains[index].load(std::memory_order_relaxed);
+  if (make_top != nullptr) {
+    return make_top;
+  }
+
+  const char* family = machine_int_domain_family(d);
+  for (const std::string& path : module_paths(family)) {
+    if (!llvm::sys::fs::exists(path)) {
+      continue;
+    }
+
+    // Modules are never unloaded
+    std::string error;
+    auto module =
+        llvm::sys::DynamicLibrary::getPermanentLibrary(path.c_str(), &error);
+    if (!module.isValid()) {
+      throw LogicError("unable to load " + path + ": " + error);
+    }
+    void* entry =
+        module.getAddressOfSymbol("ikos_analyzer_machine_int_domain_plugin");
+    if (entry == nullptr) {
+      throw LogicError(path + " is not an abstract domain module");
+    }
+    make_top = reinterpret_cast< PluginEntryFn >(entry)(d);
+    if (make_top == nullptr) {
+      throw LogicError(path + " does not contain the abstract domain '" +
+                       machine_int_domain_option_str(d) + "'");
+    }
+
+    log::debug("Loaded " + path);
+    LoadedDomains[index].store(make_top, std::memory_order_release);
+    return make_top;
+  }
+
+  throw LogicError("could not find the module ikos-analyzer-domain-" +
+                   std::string(family) + " of the abstract domain '" +
+                   machine_int_domain_option_str(d) + "'");
+}
+
+MachineIntAbstractDomain make_top_machine_int_domain(
+    MachineIntDomainOption d, const VariablePackingPtr& packing) {
+  return load_machine_int_domain(d)(packing);
+}
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,719 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implement the sparse value analysis of a function
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <ikos/core/fixpoint/sparse_fixpoint_iterator.hpp>
+
+#include <ikos/ar/semantic/statement.hpp>
+#include <ikos/ar/semantic/type.hpp>
+
+#include <ikos/analyzer/analysis/execution_engine/context_insensitive.hpp>
+#include <ikos/analyzer/analysis/execution_engine/engine.hpp>
+#include <ikos/analyzer/analysis/execution_engine/numerical.hpp>
+#include <ikos/analyzer/analysis/value/sparse.hpp>
+#include <ikos/analyzer/analysis/variable.hpp>
+#include <ikos/analyzer/database/library_summary.hpp>
+#include <ikos/analyzer/support/cast.hpp>
+#include <ikos/analyzer/util/progress.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+namespace {
+
+/// \brief Return the integer internal variable defined by the given
+/// statement, or null
+ar::InternalVariable* integer_result(ar::Statement* stmt) {
+  auto var = dyn_cast_or_null< ar::InternalVariable >(stmt->result_or_null());
+  if (var != nullptr && var->type()->is_integer()) {
+    return var;
+  }
+  return nullptr;
+}
+
+/// \brief Return true if the given statement defining an integer internal
+/// variable is modelled by the sparse analysis
+///
+/// Other definitions, e.g. loads and calls, define an unknown value.
+bool is_modelled(ar::Statement* stmt) {
+  if (isa< ar::Assignment >(stmt) || isa< ar::BinaryOperation >(stmt)) {
+    return true;
+  } else if (auto un = dyn_cast< ar::UnaryOperation >(stmt)) {
+    switch (un->op()) {
+      case ar::UnaryOperation::UTrunc:
+      case ar::UnaryOperation::STrunc:
+      case ar::UnaryOperation::ZExt:
+      case ar::UnaryOperation::SExt:
+        return true;
+      case ar::UnaryOperation::Bitcast:
+        return un->operand()->type()->is_integer();
+      default:
+        return false;
+    }
+  } else {
+    return false;
+  }
+}
+
+/// \brief Return true if the given comparison refines integer variables
+bool is_guard(ar::Comparison* cmp) {
+  return cmp->is_integer_predicate() &&
+         (isa< ar::InternalVariable >(cmp->left()) ||
+          isa< ar::InternalVariable >(cmp->right()));
+}
+
+/// \brief Return true if the given comparison uses the given variable
+bool uses(ar::Comparison* cmp, ar::InternalVariable* var) {
+  return cmp->left() == var || cmp->right() == var;
+}
+
+/// \brief Return true if the given statement uses the given variable
+bool uses(ar::Statement* stmt, ar::Value* var) {
+  return std::find(stmt->op_begin(), stmt->op_end(), var) != stmt->op_end();
+}
+
+/// \brief Call `f` on each integer internal variable operand of `stmt`
+template < typename Function >
+void for_each_integer_operand(ar::Statement* stmt, Function f) {
+  for (auto it = stmt->op_begin(), et = stmt->op_end(); it != et; ++it) {
+    auto var = dyn_cast< ar::InternalVariable >(*it);
+    if (var != nullptr && var->type()->is_integer()) {
+      f(var);
+    }
+  }
+}
+
+} // end anonymous namespace
+
+/// \brief Def-use graph of the integer internal variables of a function
+///
+/// Nodes are the modelled definitions, see is_modelled(), plus an entry node
+/// preceding the definitions without modelled operands.
+class DefUseGraph {
+public:
+  /// \brief Definition of an integer internal variable
+  struct Definition {
+    /// \brief Defining statement, or null for the entry node
+    ar::Statement* stmt = nullptr;
+
+    /// \brief Comparisons refining the operands of the statement
+    std::vector< ar::Comparison* > guards;
+
+    /// \brief Definitions of the operands of the statement and the guards
+    std::vector< Definition* > predecessors;
+
+    /// \brief Definitions using the defined variable
+    std::vector< Definition* > successors;
+  };
+
+private:
+  /// \brief Maximum number of unique predecessors visited for guards
+  static constexpr unsigned MaxGuardBlocks = 4;
+
+private:
+  /// \brief Definitions, starting with the entry node
+  std::vector< std::unique_ptr< Definition > > _definitions;
+
+  /// \brief Modelled definitions of each variable
+  std::unordered_map< ar::InternalVariable*, std::vector< Definition* > >
+      _var_definitions;
+
+  /// \brief Variables with a definition that is not modelled
+  std::unordered_set< ar::InternalVariable* > _unknown;
+
+public:
+  /// \brief Build the def-use graph of the given function body
+  explicit DefUseGraph(ar::Code* body) {
+    this->_definitions.push_back(std::make_unique< Definition >());
+
+    // Definitions
+    std::unordered_map< ar::Statement*, Definition* > stmt_definitions;
+    for (ar::BasicBlock* bb : *body) {
+      for (ar::Statement* stmt : *bb) {
+        ar::InternalVariable* var = integer_result(stmt);
+        if (var == nullptr) {
+          continue;
+        }
+        if (!is_modelled(stmt)) {
+          this->_unknown.insert(var);
+          continue;
+        }
+        this->_definitions.push_back(std::make_unique< Definition >());
+        Definition* def = this->_definitions.back().get();
+        def->stmt = stmt;
+        this->_var_definitions[var].push_back(def);
+        stmt_definitions.emplace(stmt, def);
+      }
+    }
+
+    // Guards
+    for (ar::BasicBlock* bb : *body) {
+      std::vector< ar::Comparison* > active = entry_guards(bb);
+      for (ar::Statement* stmt : *bb) {
+        if (auto cmp = dyn_cast< ar::Comparison >(stmt)) {
+          if (is_guard(cmp)) {
+            active.push_back(cmp);
+          }
+          continue;
+        }
+
+        auto it = stmt_definitions.find(stmt);
+        if (it != stmt_definitions.end()) {
+          std::copy_if(active.begin(),
+                       active.end(),
+                       std::back_inserter(it->second->guards),
+                       [stmt](ar::Comparison* cmp) {
+                         return uses(stmt, cmp->left()) ||
+                                uses(stmt, cmp->right());
+                       });
+        }
+
+        if (ar::InternalVariable* var = integer_result(stmt)) {
+          active.erase(std::remove_if(active.begin(),
+                                      active.end(),
+                                      [var](ar::Comparison* cmp) {
+                                        return uses(cmp, var);
+                                      }),
+                       active.end());
+        }
+      }
+    }
+
+    // Def-use chains
+    for (auto it = std::next(this->_definitions.begin()),
+              et = this->_definitions.end();
+         it != et;
+         ++it) {
+      Definition* def = it->get();
+      std::unordered_set< Definition* > preds;
+      auto add_operand = [this, &preds](ar::InternalVariable* var) {
+        if (const std::vector< Definition* >* defs = this->definitions(var)) {
+          preds.insert(defs->begin(), defs->end());
+        }
+      };
+      for_each_integer_operand(def->stmt, add_operand);
+      for (ar::Comparison* guard : def->guards) {
+        for_each_integer_operand(guard, add_operand);
+      }
+      if (preds.empty()) {
+        preds.insert(this->entry());
+      }
+      for (Definition* pred : preds) {
+        pred->successors.push_back(def);
+        def->predecessors.push_back(pred);
+      }
+    }
+  }
+
+  /// \brief Deleted copy constructor
+  DefUseGraph(const DefUseGraph&) = delete;
+
+  /// \brief Deleted move constructor
+  DefUseGraph(DefUseGraph&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  DefUseGraph& operator=(const DefUseGraph&) = delete;
+
+  /// \brief Deleted move assignment operator
+  DefUseGraph& operator=(DefUseGraph&&) = delete;
+
+  /// \brief Destructor
+  ~DefUseGraph() = default;
+
+  /// \brief Return the entry node
+  Definition* entry() const { return this->_definitions.front().get(); }
+
+  /// \brief Return the number of definitions, excluding the entry node
+  std::size_t num_definitions() const { return this->_definitions.size() - 1; }
+
+  /// \brief Return the definitions of the given variable, or null if its
+  /// value is unknown
+  const std::vector< Definition* >* definitions(
+      ar::InternalVariable* var) const {
+    if (this->_unknown.count(var) > 0) {
+      return nullptr;
+    }
+    auto it = this->_var_definitions.find(var);
+    if (it == this->_var_definitions.end()) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  /// \brief Return the variables with modelled definitions
+  std::vector< ar::InternalVariable* > variables() const {
+    std::vector< ar::InternalVariable* > vars;
+    for (const auto& entry : this->_var_definitions) {
+      if (this->_unknown.count(entry.first) == 0) {
+        vars.push_back(entry.first);
+      }
+    }
+    return vars;
+  }
+
+  /// \brief Return the comparisons holding at the entry of the given block
+  ///
+  /// A block with a unique predecessor is only entered after its predecessor,
+  /// so the comparisons of the predecessor hold, unless one of their operands
+  /// is defined again afterwards.
+  static std::vector< ar::Comparison* > entry_guards(ar::BasicBlock* bb) {
+    std::vector< ar::Comparison* > guards;
+    std::unordered_set< ar::InternalVariable* > defined;
+    std::unordered_set< ar::BasicBlock* > visited{bb};
+
+    for (unsigned depth = 0;
+         depth < MaxGuardBlocks && bb->num_predecessors() == 1;
+         ++depth) {
+      bb = *bb->predecessor_begin();
+      if (!visited.insert(bb).second) {
+        break;
+      }
+      for (auto it = bb->rbegin(), et = bb->rend(); it != et; ++it) {
+        ar::Statement* stmt = *it;
+        if (auto cmp = dyn_cast< ar::Comparison >(stmt)) {
+          if (is_guard(cmp) &&
+              std::none_of(defined.begin(),
+                           defined.end(),
+                           [cmp](ar::InternalVariable* var) {
+                             return uses(cmp, var);
+                           })) {
+            guards.push_back(cmp);
+          }
+        } else if (ar::InternalVariable* var = integer_result(stmt)) {
+          defined.insert(var);
+        }
+      }
+    }
+
+    return guards;
+  }
+
+}; // end class DefUseGraph
+
+} // end namespace value
+} // end namespace analyzer
+
+namespace core {
+
+/// \brief Implement GraphTraits for DefUseGraph
+template <>
+struct GraphTraits< analyzer::value::DefUseGraph* > {
+  using NodeRef = analyzer::value::DefUseGraph::Definition*;
+  using SuccessorNodeIterator = std::vector< NodeRef >::const_iterator;
+  using PredecessorNodeIterator = std::vector< NodeRef >::const_iterator;
+
+  static NodeRef entry(analyzer::value::DefUseGraph* graph) {
+    return graph->entry();
+  }
+
+  static SuccessorNodeIterator successor_begin(NodeRef def) {
+    return def->successors.cbegin();
+  }
+
+  static SuccessorNodeIterator successor_end(NodeRef def) {
+    return def->successors.cend();
+  }
+
+  static PredecessorNodeIterator predecessor_begin(NodeRef def) {
+    return def->predecessors.cbegin();
+  }
+
+  static PredecessorNodeIterator predecessor_end(NodeRef def) {
+    return def->predecessors.cend();
+  }
+};
+
+} // end namespace core
+
+namespace analyzer {
+namespace value {
+
+namespace {
+
+/// \brief Interval fixpoint on the def-use graph of a function
+class IntervalFixpoint final
+    : public core::SparseFixpointIterator< DefUseGraph*,
+                                           core::machine_int::Interval > {
+private:
+  /// \brief Parent class
+  using SparseFixpointIterator =
+      core::SparseFixpointIterator< DefUseGraph*, core::machine_int::Interval >;
+
+  /// \brief Machine integer interval
+  using Interval = core::machine_int::Interval;
+
+  /// \brief Definition
+  using Definition = DefUseGraph::Definition;
+
+private:
+  /// \brief Analysis context
+  Context& _ctx;
+
+  /// \brief Empty call context
+  CallContext* _empty_call_context;
+
+  /// \brief Initial invariant
+  const AbstractDomain& _init_inv;
+
+  /// \brief Time and step budget
+  AnalysisBudget& _budget;
+
+  /// \brief Statistics on the fixpoint iterations
+  FixpointStats& _fixpoint_stats;
+
+public:
+  /// \brief Constructor
+  IntervalFixpoint(Context& ctx,
+                   DefUseGraph* graph,
+                   const AbstractDomain& init_inv,
+                   AnalysisBudget& budget,
+                   FixpointStats& fixpoint_stats)
+      : SparseFixpointIterator(graph),
+        _ctx(ctx),
+        _empty_call_context(ctx.call_context_factory->get_empty()),
+        _init_inv(init_inv),
+        _budget(budget),
+        _fixpoint_stats(fixpoint_stats) {}
+
+  /// \brief Return the interval of the given variable
+  ///
+  /// This is the join of the values of its definitions, or top if the
+  /// variable has no modelled definition, e.g. a parameter.
+  Interval variable_value(ar::InternalVariable* var) const {
+    auto type = cast< ar::IntegerType >(var->type());
+    const std::vector< Definition* >* defs = this->graph()->definitions(var);
+    if (defs == nullptr) {
+      return Interval::top(type->bit_width(), type->sign());
+    }
+    Interval value = Interval::bottom(type->bit_width(), type->sign());
+    for (Definition* def : *defs) {
+      const Interval& def_value = this->value(def);
+      if (!def_value.is_bottom()) {
+        value.join_with(def_value);
+      }
+    }
+    return value;
+  }
+
+  /// \brief Compute the interval of a definition
+  Interval analyze_node(Definition* def) override {
+    if (def->stmt == nullptr) {
+      return Interval::top();
+    }
+
+    this->_budget.step();
+    auto var = cast< ar::InternalVariable >(def->stmt->result());
+    auto type = cast< ar::IntegerType >(var->type());
+    Interval bottom = Interval::bottom(type->bit_width(), type->sign());
+
+    // Operands not computed yet are bottom
+    AbstractDomain inv = this->_init_inv;
+    bool computed = true;
+    auto assign_operand = [this, &inv, &computed](ar::InternalVariable* v) {
+      Interval value = this->variable_value(v);
+      if (value.is_bottom()) {
+        computed = false;
+      } else if (!value.is_top()) {
+        inv.normal().integers().set(this->_ctx.var_factory->get_internal(v),
+                                    value);
+      }
+    };
+    for_each_integer_operand(def->stmt, assign_operand);
+    for (ar::Comparison* guard : def->guards) {
+      for_each_integer_operand(guard, assign_operand);
+    }
+    if (!computed) {
+      return bottom;
+    }
+
+    NumericalExecutionEngine< AbstractDomain >
+        exec_engine(std::move(inv),
+                    _ctx,
+                    this->_empty_call_context,
+                    /* precision = */ Precision::Register);
+    ContextInsensitiveCallExecutionEngine< AbstractDomain > call_exec_engine(
+        exec_engine);
+    for (ar::Comparison* guard : def->guards) {
+      exec_engine.exec(guard);
+    }
+    transfer_function(exec_engine, call_exec_engine, def->stmt);
+
+    if (exec_engine.inv().is_normal_flow_bottom()) {
+      return bottom;
+    }
+    return exec_engine.inv().normal().integers().to_interval(
+        this->_ctx.var_factory->get_internal(var));
+  }
+
+  /// \brief Extrapolate the new value after an increasing iteration
+  Interval extrapolate(Definition* head,
+                       unsigned iteration,
+                       Interval before,
+                       Interval after) override {
+    if (this->_budget.exhausted()) {
+      // Out of budget, converge as fast as possible
+      return Interval::top(after.bit_width(), after.sign());
+    }
+    Progress::add_iteration();
+    return SparseFixpointIterator::extrapolate(head,
+                                               iteration,
+                                               std::move(before),
+                                               std::move(after));
+  }
+
+  /// \brief Check if the decreasing iterations fixpoint is reached
+  bool is_decreasing_iterations_fixpoint(const Interval& before,
+                                         const Interval& after) override {
+    if (this->_budget.exhausted()) {
+      return true;
+    }
+    return before.leq(after);
+  }
+
+  /// \brief Process the statistics on the iterations on a cycle
+  void process_cycle_stats(Definition* head,
+                           const core::FixpointCycleStats& stats) override {
+    this->_fixpoint_stats.add(head->stmt->parent(), stats);
+  }
+
+}; // end class IntervalFixpoint
+
+} // end anonymous namespace
+
+SparseFunctionFixpoint::SparseFunctionFixpoint(Context& ctx,
+                                               ar::Function* function)
+    : _ctx(ctx),
+      _function(function),
+      _empty_call_context(ctx.call_context_factory->get_empty()),
+      _init_inv(AbstractDomain::top()),
+      _budget(ctx.opts, ctx.memory_governor),
+      _fixpoint_stats(ctx.opts) {}
+
+SparseFunctionFixpoint::~SparseFunctionFixpoint() = default;
+
+void SparseFunctionFixpoint::run(AbstractDomain inv) {
+  Progress::add_context();
+  this->_budget.start();
+  this->_init_inv = std::move(inv);
+  this->_graph = std::make_unique< DefUseGraph >(this->_function->body());
+
+  IntervalFixpoint fixpoint(this->_ctx,
+                            this->_graph.get(),
+                            this->_init_inv,
+                            this->_budget,
+                            this->_fixpoint_stats);
+  fixpoint.run();
+
+  this->_values.clear();
+  for (ar::InternalVariable* var : this->_graph->variables()) {
+    this->_values.emplace(var, fixpoint.variable_value(var));
+  }
+
+  if (this->_ctx.library_summary_output != nullptr) {
+    this->record_summary();
+  }
+}
+
+void SparseFunctionFixpoint::record_summary() const {
+  // Without flow information, assume that the function returns
+  boost::optional< core::ZNumber > lb, ub;
+  ar::Code* body = this->_function->body();
+  if (body->has_exit_block()) {
+    for (ar::Statement* stmt : *body->exit_block()) {
+      auto ret = dyn_cast< ar::ReturnValue >(stmt);
+      if (ret == nullptr || !ret->has_operand() ||
+          !isa< ar::InternalVariable >(ret->operand())) {
+        continue;
+      }
+      auto it =
+          this->_values.find(cast< ar::InternalVariable >(ret->operand()));
+      if (it != this->_values.end() && !it->second.is_bottom() &&
+          !it->second.is_top()) {
+        lb = it->second.lb().to_z_number();
+        ub = it->second.ub().to_z_number();
+      }
+    }
+  }
+  this->_ctx.library_summary_output->record(this->_function,
+                                            /* returns = */ true,
+                                            lb,
+                                            ub);
+}
+
+AbstractDomain SparseFunctionFixpoint::block_invariant(
+    ar::BasicBlock* bb) const {
+  AbstractDomain inv = this->_init_inv;
+  std::vector< ar::Comparison* > guards = DefUseGraph::entry_guards(bb);
+
+  auto assign_variable = [this, &inv](ar::InternalVariable* var) {
+    auto it = this->_values.find(var);
+    if (it != this->_values.end() && !it->second.is_bottom() &&
+        !it->second.is_top()) {
+      inv.normal().integers().set(this->_ctx.var_factory->get_internal(var),
+                                  it->second);
+    }
+  };
+  for (ar::Statement* stmt : *bb) {
+    for_each_integer_operand(stmt, assign_variable);
+  }
+  for (ar::Comparison* guard : guards) {
+    for_each_integer_operand(guard, assign_variable);
+  }
+
+  NumericalExecutionEngine< AbstractDomain >
+      exec_engine(std::move(inv),
+                  _ctx,
+                  this->_empty_call_context,
+                  /* precision = */ Precision::Register);
+  for (ar::Comparison* guard : guards) {
+    exec_engine.exec(guard);
+  }
+  return std::move(exec_engine.inv());
+}
+
+void SparseFunctionFixpoint::run_checks(CheckerList& checkers) {
+  if (this->_budget.exhausted()) {
+    report_exhausted_budget(this->_ctx,
+                            this->_function,
+                            this->_empty_call_context,
+                            this->_budget);
+  }
+  this->_fixpoint_stats.report(this->_ctx,
+                               this->_function,
+                               this->_empty_call_context);
+
+  for (const auto& checker : checkers) {
+    checker->enter(this->_function, this->_empty_call_context);
+  }
+
+  // Basic blocks reachable from the entry block
+  ar::Code* body = this->_function->body();
+  std::unordered_set< ar::BasicBlock* > reachable{body->entry_block()};
+  std::vector< ar::BasicBlock* > worklist{body->entry_block()};
+  while (!worklist.empty()) {
+    ar::BasicBlock* bb = worklist.back();
+    worklist.pop_back();
+    for (auto it = bb->successor_begin(), et = bb->successor_end(); it != et;
+         ++it) {
+      if (reachable.insert(*it).second) {
+        worklist.push_back(*it);
+      }
+    }
+  }
+
+  for (ar::BasicBlock* bb : *body) {
+    if (reachable.count(bb) > 0) {
+      this->check_block(checkers, bb, this->block_invariant(bb));
+    } else {
+      this->check_unreachable_block(checkers, bb, AbstractDomain::bottom());
+    }
+  }
+
+  for (const auto& checker : checkers) {
+    checker->leave(this->_function, this->_empty_call_context);
+  }
+}
+
+void SparseFunctionFixpoint::check_block(CheckerList& checkers,
+                                         ar::BasicBlock* bb,
+                                         const AbstractDomain& pre) {
+  if (pre.is_normal_flow_bottom()) {
+    this->check_unreachable_block(checkers, bb, pre);
+    return;
+  }
+
+  NumericalExecutionEngine< AbstractDomain >
+      exec_engine(pre,
+                  _ctx,
+                  this->_empty_call_context,
+                  /* precision = */ Precision::Register,
+                  /* liveness = */ _ctx.liveness);
+  ContextInsensitiveCallExecutionEngine< AbstractDomain > call_exec_engine(
+      exec_engine);
+
+  exec_engine.exec_enter(bb);
+  for (const auto& checker : checkers) {
+    checker->enter(bb, exec_engine.inv(), this->_empty_call_context);
+  }
+
+  for (ar::Statement* stmt : *bb) {
+    // Check the statement if it's related to an llvm instruction
+    if (stmt->has_frontend()) {
+      checkers.check(stmt, exec_engine.inv(), this->_empty_call_context);
+    }
+    // Propagate
+    transfer_function(exec_engine, call_exec_engine, stmt);
+  }
+
+  for (const auto& checker : checkers) {
+    checker->leave(bb, exec_engine.inv(), this->_empty_call_context);
+  }
+  exec_engine.exec_leave(bb);
+}
+
+void SparseFunctionFixpoint::check_unreachable_block(
+    CheckerList& checkers, ar::BasicBlock* bb, const AbstractDomain& pre) {
+  for (const auto& checker : checkers) {
+    checker->enter(bb, pre, this->_empty_call_context);
+  }
+
+  for (ar::Statement* stmt : *bb) {
+    if (stmt->has_frontend()) {
+      checkers.check(stmt, pre, this->_empty_call_context);
+    }
+  }
+
+  for (const auto& checker : checkers) {
+    checker->leave(bb, pre, this->_empty_call_context);
+  }
+}
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Statistics on the sizes of the abstract states
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+
+#include <ikos/core/adt/patricia_tree/node.hpp>
+
+#include <ikos/analyzer/analysis/value/state_stats.hpp>
+#include <ikos/analyzer/database/output.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+StateStats::StateStats(const AnalysisOptions& opts)
+    : _enabled(opts.state_stats) {
+  if (this->_enabled) {
+    core::numeric::VarPackingStats& packs =
+        core::numeric::VarPackingSettings::stats();
+    this->_enclosing_packs = packs;
+    packs = {0, 0};
+  }
+}
+
+void StateStats::sample(const AbstractDomain& inv) {
+  if (!this->_enabled) {
+    return;
+  }
+  this->_samples++;
+
+  const MemoryAbstractDomain& normal = inv.normal();
+  this->_peak_cells = std::max(this->_peak_cells, normal.num_cells());
+  this->_peak_points_to =
+      std::max(this->_peak_points_to,
+               normal.num_points_to() + normal.pointers().num_points_to());
+
+  // Nodes allocated by this thread can be freed by another one
+  const core::patricia_tree_utils::NodeAllocationStats& nodes =
+      core::patricia_tree_utils::NodePool::stats();
+  if (nodes.allocations > nodes.deallocations) {
+    this->_peak_nodes =
+        std::max(this->_peak_nodes, nodes.allocations - nodes.deallocations);
+  }
+}
+
+void StateStats::report(Context& ctx,
+                        ar::Function* fun,
+                        CallContext* call_context) {
+  if (!this->_enabled) {
+    return;
+  }
+
+  // Restore the statistics of the enclosing analysis
+  core::numeric::VarPackingStats& packs =
+      core::numeric::VarPackingSettings::stats();
+  core::numeric::VarPackingStats own_packs = packs;
+  packs.max_pack_size =
+      std::max(packs.max_pack_size, this->_enclosing_packs.max_pack_size);
+  packs.dropped_relations += this->_enclosing_packs.dropped_relations;
+  this->_enclosing_packs = {0, 0};
+
+  if (this->_samples == 0) {
+    return;
+  }
+
+  ctx.output_db->state_sizes
+      .insert(fun,
+              call_context,
+              static_cast< sqlite::DbInt64 >(this->_samples),
+              static_cast< sqlite::DbInt64 >(this->_peak_cells),
+              static_cast< sqlite::DbInt64 >(this->_peak_points_to),
+              static_cast< sqlite::DbInt64 >(this->_peak_nodes),
+              static_cast< sqlite::DbInt64 >(own_packs.max_pack_size),
+              static_cast< sqlite::DbInt64 >(own_packs.dropped_relations));
+
+  this->_samples = 0;
+  this->_peak_cells = 0;
+  this->_peak_points_to = 0;
+  this->_peak_nodes = 0;
+}
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,171 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Statistics on the transfer functions of the value analysis
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <ikos/analyzer/analysis/value/transfer_stats.hpp>
+#include <ikos/analyzer/database/output.hpp>
+#include <ikos/analyzer/support/assert.hpp>
+#include <ikos/analyzer/support/cast.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace value {
+
+TransferStats::TransferStats(const AnalysisOptions& opts)
+    : _enabled(opts.transfer_stats) {}
+
+void TransferStats::report(Context& ctx,
+                           ar::Function* fun,
+                           CallContext* call_context) {
+  if (!this->_enabled) {
+    return;
+  }
+
+  for (std::size_t i = 0; i < NumKinds; i++) {
+    Counters& counters = this->_counters[i];
+    if (counters.count == 0) {
+      continue;
+    }
+    ctx.output_db->transfer_functions
+        .insert(fun,
+                call_context,
+                kind_str(static_cast< Kind >(i)),
+                static_cast< sqlite::DbInt64 >(counters.count),
+                std::chrono::duration< double >(counters.time).count());
+    counters = Counters();
+  }
+}
+
+TransferStats::Kind TransferStats::kind(ar::Statement* stmt) {
+  switch (stmt->kind()) {
+    case ar::Statement::AssignmentKind:
+      return Assignment;
+    case ar::Statement::UnaryOperationKind:
+      return UnaryOperation;
+    case ar::Statement::BinaryOperationKind:
+      return BinaryOperation;
+    case ar::Statement::ComparisonKind:
+      return Comparison;
+    case ar::Statement::ReturnValueKind:
+      return ReturnValue;
+    case ar::Statement::UnreachableKind:
+      return Unreachable;
+    case ar::Statement::AllocateKind:
+      return Allocate;
+    case ar::Statement::PointerShiftKind:
+      return PointerShift;
+    case ar::Statement::LoadKind:
+      return Load;
+    case ar::Statement::StoreKind:
+      return Store;
+    case ar::Statement::ExtractElementKind:
+      return ExtractElement;
+    case ar::Statement::InsertElementKind:
+      return InsertElement;
+    case ar::Statement::ShuffleVectorKind:
+      return ShuffleVector;
+    case ar::Statement::CallKind: {
+      auto call = cast< ar::Call >(stmt);
+      if (auto cst = dyn_cast< ar::FunctionPointerConstant >(call->called())) {
+        if (cst->function()->is_intrinsic()) {
+          return IntrinsicCall;
+        }
+      }
+      return Call;
+    }
+    case ar::Statement::InvokeKind:
+      return Invoke;
+    case ar::Statement::LandingPadKind:
+      return LandingPad;
+    case ar::Statement::ResumeKind:
+      return Resume;
+    default:
+      ikos_unreachable("unexpected statement kind");
+  }
+}
+
+const char* TransferStats::kind_str(Kind kind) {
+  switch (kind) {
+    case Assignment:
+      return "assignment";
+    case UnaryOperation:
+      return "unary-operation";
+    case BinaryOperation:
+      return "binary-operation";
+    case Comparison:
+      return "comparison";
+    case ReturnValue:
+      return "return-value";
+    case Unreachable:
+      return "unreachable";
+    case Allocate:
+      return "allocate";
+    case PointerShift:
+      return "pointer-shift";
+    case Load:
+      return "load";
+    case Store:
+      return "store";
+    case ExtractElement:
+      return "extract-element";
+    case InsertElement:
+      return "insert-element";
+    case ShuffleVector:
+      return "shuffle-vector";
+    case Call:
+      return "call";
+    case IntrinsicCall:
+      return "intrinsic-call";
+    case Invoke:
+      return "invoke";
+    case LandingPad:
+      return "landing-pad";
+    case Resume:
+      return "resume";
+    default:
+      ikos_unreachable("unexpected kind");
+  }
+}
+
+} // end namespace value
+} // end namespace analyzer
+} // end namespace ikos
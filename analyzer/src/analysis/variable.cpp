@@ -195,82 +195,61 @@ void UnnamedShadowVariable::dump(std::ostream& o) const {
 
 VariableFactory::VariableFactory(ar::Bundle* bundle)
     : _ar_context(bundle->context()),
-      _size_type(ar::IntegerType::size_type(bundle)) {}
+      _size_type(ar::IntegerType::size_type(bundle)),
+      _next_id(0) {}
 
 VariableFactory::~VariableFactory() = default;
 
 LocalVariable* VariableFactory::get_local(ar::LocalVariable* var) {
-  auto it = this->_local_variable_map.find(var);
-  if (it == this->_local_variable_map.end()) {
-    auto vn = new LocalVariable(var);
+  return this->_local_variable_map.get_or_create(var, [=] {
+    ar::Function* scope = var->function();
+    auto vn = this->with_id(new LocalVariable(var), scope);
     vn->set_offset_var(
-        std::make_unique< OffsetVariable >(this->_size_type, vn));
-    this->_local_variable_map.try_emplace(var,
-                                          std::unique_ptr< LocalVariable >(vn));
+        this->with_id(new OffsetVariable(this->_size_type, vn.get()), scope));
     return vn;
-  } else {
-    return it->second.get();
-  }
+  });
 }
 
 GlobalVariable* VariableFactory::get_global(ar::GlobalVariable* var) {
-  auto it = this->_global_variable_map.find(var);
-  if (it == this->_global_variable_map.end()) {
-    auto vn = new GlobalVariable(var);
+  return this->_global_variable_map.get_or_create(var, [=] {
+    auto vn = this->with_id(new GlobalVariable(var));
     vn->set_offset_var(
-        std::make_unique< OffsetVariable >(this->_size_type, vn));
-    this->_global_variable_map.try_emplace(var,
-                                           std::unique_ptr< GlobalVariable >(
-                                               vn));
+        this->with_id(new OffsetVariable(this->_size_type, vn.get())));
     return vn;
-  } else {
-    return it->second.get();
-  }
+  });
 }
 
 InternalVariable* VariableFactory::get_internal(ar::InternalVariable* var) {
-  auto it = this->_internal_variable_map.find(var);
-  if (it == this->_internal_variable_map.end()) {
-    auto vn = new InternalVariable(var);
+  return this->_internal_variable_map.get_or_create(var, [=] {
+    ar::Function* scope =
+        var->code()->is_function_body() ? var->code()->function() : nullptr;
+    auto vn = this->with_id(new InternalVariable(var), scope);
     if (vn->type()->is_pointer() || vn->type()->is_aggregate()) {
       vn->set_offset_var(
-          std::make_unique< OffsetVariable >(this->_size_type, vn));
+          this->with_id(new OffsetVariable(this->_size_type, vn.get()),
+                        scope));
     }
-    this->_internal_variable_map
-        .try_emplace(var, std::unique_ptr< InternalVariable >(vn));
     return vn;
-  } else {
-    return it->second.get();
-  }
+  });
 }
 
 InlineAssemblyPointerVariable* VariableFactory::get_asm_ptr(
     ar::InlineAssemblyConstant* cst) {
-  auto it = this->_inline_asm_pointer_map.find(cst);
-  if (it == this->_inline_asm_pointer_map.end()) {
-    auto vn = new InlineAssemblyPointerVariable(cst);
+  return this->_inline_asm_pointer_map.get_or_create(cst, [=] {
+    auto vn = this->with_id(new InlineAssemblyPointerVariable(cst));
     vn->set_offset_var(
-        std::make_unique< OffsetVariable >(this->_size_type, vn));
-    this->_inline_asm_pointer_map
-        .try_emplace(cst, std::unique_ptr< InlineAssemblyPointerVariable >(vn));
+        this->with_id(new OffsetVariable(this->_size_type, vn.get())));
     return vn;
-  } else {
-    return it->second.get();
-  }
+  });
 }
 
 FunctionPointerVariable* VariableFactory::get_function_ptr(ar::Function* fun) {
-  auto it = this->_function_pointer_map.find(fun);
-  if (it == this->_function_pointer_map.end()) {
-    auto vn = new FunctionPointerVariable(fun);
+  return this->_function_pointer_map.get_or_create(fun, [=] {
+    auto vn = this->with_id(new FunctionPointerVariable(fun));
     vn->set_offset_var(
-        std::make_unique< OffsetVariable >(this->_size_type, vn));
-    this->_function_pointer_map
-        .try_emplace(fun, std::unique_ptr< FunctionPointerVariable >(vn));
+        this->with_id(new OffsetVariable(this->_size_type, vn.get())));
     return vn;
-  } else {
-    return it->second.get();
-  }
+  });
 }
 
 FunctionPointerVariable* VariableFactory::get_function_ptr(
@@ -282,8 +261,7 @@ CellVariable* VariableFactory::get_cell(MemoryLocation* address,
                                         const MachineInt& offset,
                                         const MachineInt& size) {
   auto key = std::make_tuple(address, offset, size);
-  auto it = this->_cell_map.find(key);
-  if (it == this->_cell_map.end()) {
+  return this->_cell_map.get_or_create(key, [&] {
     // Create a memory cell variable
     // A cell can be either an integer, a float or a pointer
     // The integer type should have the right bit-width and be signed
@@ -297,72 +275,53 @@ CellVariable* VariableFactory::get_cell(MemoryLocation* address,
     ar::Type* type = ar::IntegerType::get(this->_ar_context,
                                           bit_width.to< unsigned >(),
                                           Signed);
-    auto vn = new CellVariable(type, address, offset, size);
+    auto vn = this->with_id(new CellVariable(type, address, offset, size));
     vn->set_offset_var(
-        std::make_unique< OffsetVariable >(this->_size_type, vn));
-    this->_cell_map.emplace(key, std::unique_ptr< CellVariable >(vn));
+        this->with_id(new OffsetVariable(this->_size_type, vn.get())));
     return vn;
-  } else {
-    return it->second.get();
-  }
+  });
 }
 
 AllocSizeVariable* VariableFactory::get_alloc_size(MemoryLocation* address) {
-  auto it = this->_alloc_size_map.find(address);
-  if (it == this->_alloc_size_map.end()) {
-    auto vn = new AllocSizeVariable(this->_size_type, address);
-    this->_alloc_size_map.try_emplace(address,
-                                      std::unique_ptr< AllocSizeVariable >(vn));
-    return vn;
-  } else {
-    return it->second.get();
-  }
+  return this->_alloc_size_map.get_or_create(address, [=] {
+    return this->with_id(new AllocSizeVariable(this->_size_type, address));
+  });
 }
 
 ReturnVariable* VariableFactory::get_return(ar::Function* fun) {
-  auto it = this->_return_variable_map.find(fun);
-  if (it == this->_return_variable_map.end()) {
-    auto vn = new ReturnVariable(fun);
+  return this->_return_variable_map.get_or_create(fun, [=] {
+    auto vn = this->with_id(new ReturnVariable(fun));
     if (vn->type()->is_pointer() || vn->type()->is_aggregate()) {
       vn->set_offset_var(
-          std::make_unique< OffsetVariable >(this->_size_type, vn));
+          this->with_id(new OffsetVariable(this->_size_type, vn.get())));
     }
-    this->_return_variable_map.try_emplace(fun,
-                                           std::unique_ptr< ReturnVariable >(
-                                               vn));
     return vn;
-  } else {
-    return it->second.get();
-  }
+  });
 }
 
 NamedShadowVariable* VariableFactory::get_named_shadow(ar::Type* type,
                                                        llvm::StringRef name) {
-  auto it = this->_named_shadow_variable_map.find(name);
-  if (it == this->_named_shadow_variable_map.end()) {
-    auto vn = new NamedShadowVariable(type, name);
+  return this->_named_shadow_variable_map.get_or_create(name, [=] {
+    auto vn = this->with_id(new NamedShadowVariable(type, name));
     if (vn->type()->is_pointer() || vn->type()->is_aggregate()) {
       vn->set_offset_var(
-          std::make_unique< OffsetVariable >(this->_size_type, vn));
+          this->with_id(new OffsetVariable(this->_size_type, vn.get())));
     }
-    this->_named_shadow_variable_map
-        .try_emplace(name, std::unique_ptr< NamedShadowVariable >(vn));
     return vn;
-  } else {
-    return it->second.get();
-  }
+  });
 }
 
 UnnamedShadowVariable* VariableFactory::create_unnamed_shadow(ar::Type* type) {
+  std::lock_guard< std::mutex > lock(this->_unnamed_shadow_mutex);
   std::size_t id = this->_unnamed_shadow_variable_vec.size();
-  auto vn = new UnnamedShadowVariable(type, id);
+  auto vn = this->with_id(new UnnamedShadowVariable(type, id));
   if (vn->type()->is_pointer() || vn->type()->is_aggregate()) {
     vn->set_offset_var(
-        std::make_unique< OffsetVariable >(this->_size_type, vn));
+        this->with_id(new OffsetVariable(this->_size_type, vn.get())));
   }
-  this->_unnamed_shadow_variable_vec.emplace_back(
-      std::unique_ptr< UnnamedShadowVariable >(vn));
-  return vn;
+  UnnamedShadowVariable* ptr = vn.get();
+  this->_unnamed_shadow_variable_vec.emplace_back(std::move(vn));
+  return ptr;
 }
 
 } // end namespace analyzer
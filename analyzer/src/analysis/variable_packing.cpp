@@ -0,0 +1,157 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the variable packing pre-analysis
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+#include <ikos/ar/semantic/type.hpp>
+
+#include <ikos/analyzer/analysis/variable_packing.hpp>
+#include <ikos/analyzer/util/log.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+const std::size_t VariablePackingAnalysis::MaxPackSize;
+
+VariablePackingAnalysis::VariablePackingAnalysis(Context& ctx)
+    : _ctx(ctx), _packing(std::make_shared< VariablePackingT >(MaxPackSize)) {}
+
+VariablePackingAnalysis::~VariablePackingAnalysis() = default;
+
+void VariablePackingAnalysis::run() {
+  ar::Bundle* bundle = _ctx.bundle;
+
+  for (auto it = bundle->function_begin(), et = bundle->function_end();
+       it != et;
+       ++it) {
+    ar::Function* fun = *it;
+    if (fun->is_definition()) {
+      log::debug("Computing variable packs of function '" + fun->name() +
+                 "'");
+      this->run(fun->body());
+    }
+  }
+}
+
+void VariablePackingAnalysis::run(ar::Code* code) {
+  for (ar::BasicBlock* bb : *code) {
+    for (ar::Statement* stmt : *bb) {
+      if (auto assign = ar::dyn_cast< ar::Assignment >(stmt)) {
+        this->pack(assign->result(), assign->operand());
+      } else if (auto unary = ar::dyn_cast< ar::UnaryOperation >(stmt)) {
+        switch (unary->op()) {
+          case ar::UnaryOperation::UTrunc:
+          case ar::UnaryOperation::STrunc:
+          case ar::UnaryOperation::ZExt:
+          case ar::UnaryOperation::SExt:
+          case ar::UnaryOperation::Bitcast: {
+            this->pack(unary->result(), unary->operand());
+          } break;
+          default: {
+            break;
+          }
+        }
+      } else if (auto binary = ar::dyn_cast< ar::BinaryOperation >(stmt)) {
+        switch (binary->op()) {
+          case ar::BinaryOperation::UAdd:
+          case ar::BinaryOperation::USub:
+          case ar::BinaryOperation::SAdd:
+          case ar::BinaryOperation::SSub: {
+            this->pack(binary->result(), binary->left());
+            this->pack(binary->result(), binary->right());
+          } break;
+          default: {
+            break;
+          }
+        }
+      } else if (auto cmp = ar::dyn_cast< ar::Comparison >(stmt)) {
+        if (cmp->is_integer_predicate() || cmp->is_pointer_predicate()) {
+          this->pack(cmp->left(), cmp->right());
+        }
+      } else if (auto shift = ar::dyn_cast< ar::PointerShift >(stmt)) {
+        this->pack(shift->result(), shift->pointer());
+        for (auto it = shift->term_begin(), et = shift->term_end(); it != et;
+             ++it) {
+          this->pack(shift->result(), (*it).second);
+        }
+      }
+    }
+  }
+}
+
+void VariablePackingAnalysis::pack(ar::Value* x, ar::Value* y) {
+  Variable* x_var = this->numerical_variable(x);
+  Variable* y_var = this->numerical_variable(y);
+
+  if (x_var != nullptr && y_var != nullptr) {
+    this->_packing->pack(x_var, y_var);
+  }
+}
+
+Variable* VariablePackingAnalysis::numerical_variable(ar::Value* value) const {
+  Variable* var = nullptr;
+
+  // Global variables and function pointers are shared by all functions, and
+  // are thus left in singleton packs
+  if (auto lv = ar::dyn_cast< ar::LocalVariable >(value)) {
+    var = _ctx.var_factory->get_local(lv);
+  } else if (auto iv = ar::dyn_cast< ar::InternalVariable >(value)) {
+    var = _ctx.var_factory->get_internal(iv);
+  } else {
+    return nullptr;
+  }
+
+  if (ar::isa< ar::IntegerType >(var->type())) {
+    return var;
+  } else {
+    return var->offset_var();
+  }
+}
+
+void VariablePackingAnalysis::dump(std::ostream& o) const {
+  this->_packing->dump(o);
+  o << "\n";
+}
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -59,6 +59,10 @@ const char* AssertProverChecker::description() const {
   return "Assertion prover checker";
 }
 
+bool AssertProverChecker::handles(ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::CallKind;
+}
+
 void AssertProverChecker::check(ar::Statement* stmt,
                                 const value::AbstractDomain& inv,
                                 CallContext* call_context) {
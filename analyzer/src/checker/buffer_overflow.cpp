@@ -65,6 +65,12 @@ const char* BufferOverflowChecker::description() const {
   return "Buffer overflow checker";
 }
 
+bool BufferOverflowChecker::handles(ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::LoadKind ||
+         kind == ar::Statement::StoreKind ||
+         kind == ar::Statement::CallKind;
+}
+
 /// \brief Return true if `lit >= n`
 static bool is_greater_equal(const ScalarLit& lit,
                              const MachineInt& n,
@@ -229,20 +235,23 @@ void BufferOverflowChecker::check_mem_access(ar::Statement* stmt,
                                              CallContext* call_context) {
   CheckResult check = this->check_mem_access(stmt, pointer, access_size, inv);
   this->display_invariant(check.result, stmt, inv);
-  this->_checks.insert(check.kind,
-                       CheckerName::BufferOverflow,
-                       check.result,
-                       stmt,
-                       call_context,
-                       check.operands,
-                       check.info);
+  this->insert_check(check.kind,
+                     check.result,
+                     stmt,
+                     call_context,
+                     check.operands,
+                     [this, &check](JsonDict& info) {
+                       if (check.kind == CheckKind::BufferOverflow) {
+                         this->mem_access_info(info);
+                       }
+                     });
 }
 
 BufferOverflowChecker::CheckResult BufferOverflowChecker::check_mem_access(
     ar::Statement* stmt,
     ar::Value* pointer,
     ar::Value* access_size,
-    value::AbstractDomain inv) {
+    const value::AbstractDomain& inv) {
   if (inv.is_normal_flow_bottom()) {
     // Statement unreachable
     if (this->display_mem_access_check(Result::Unreachable,
@@ -251,7 +260,7 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_mem_access(
                                        access_size)) {
       out() << std::endl;
     }
-    return {CheckKind::Unreachable, Result::Unreachable, {}, {}};
+    return {CheckKind::Unreachable, Result::Unreachable, {}};
   }
 
   const ScalarLit& ptr = this->_lit_factory.get_scalar(pointer);
@@ -261,7 +270,7 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_mem_access(
 
   if (ptr.is_undefined() ||
       (ptr.is_pointer_var() &&
-       inv.normal().uninitialized().is_uninitialized(ptr.var()))) {
+       this->pointer_facts(stmt, ptr.var(), inv).is_uninitialized())) {
     // Undefined pointer operand
     if (this->display_mem_access_check(Result::Error,
                                        stmt,
@@ -269,7 +278,7 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_mem_access(
                                        access_size)) {
       out() << ": undefined pointer operand" << std::endl;
     }
-    return {CheckKind::UninitializedVariable, Result::Error, {pointer}, {}};
+    return {CheckKind::UninitializedVariable, Result::Error, {pointer}};
   }
 
   if (size.is_undefined() ||
@@ -282,13 +291,14 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_mem_access(
                                        access_size)) {
       out() << ": undefined size operand" << std::endl;
     }
-    return {CheckKind::UninitializedVariable, Result::Error, {access_size}, {}};
+    return {CheckKind::UninitializedVariable, Result::Error, {access_size}};
   }
 
   // Check null pointer dereference
 
   if (ptr.is_null() ||
-      (ptr.is_pointer_var() && inv.normal().nullity().is_null(ptr.var()))) {
+      (ptr.is_pointer_var() &&
+       this->pointer_facts(stmt, ptr.var(), inv).is_null())) {
     // Null pointer operand
     if (this->display_mem_access_check(Result::Error,
                                        stmt,
@@ -296,29 +306,28 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_mem_access(
                                        access_size)) {
       out() << ": null pointer dereference" << std::endl;
     }
-    return {CheckKind::NullPointerDereference, Result::Error, {pointer}, {}};
+    return {CheckKind::NullPointerDereference, Result::Error, {pointer}};
   }
 
   // Check unexpected operand
   if (!ptr.is_pointer_var()) {
     log::error("unexpected pointer operand");
-    return {CheckKind::UnexpectedOperand, Result::Error, {pointer}, {}};
+    return {CheckKind::UnexpectedOperand, Result::Error, {pointer}};
   }
   if (!size.is_machine_int() && !size.is_machine_int_var()) {
     log::error("unexpected size operand");
-    return {CheckKind::UnexpectedOperand, Result::Error, {access_size}, {}};
+    return {CheckKind::UnexpectedOperand, Result::Error, {access_size}};
   }
 
-  // Initialize global variable pointer and function pointer
-  this->init_global_ptr(pointer, inv);
+  // Facts about the pointer, shared with the other checkers
+  PointerFacts& facts = this->pointer_facts(stmt, ptr.var(), inv);
 
-  // Variable representing the pointer offset
-  Variable* offset_var = inv.normal().pointers().offset_var(ptr.var());
+  // Global variable pointers and function pointers are only initialized in
+  // the copy of the invariant below
+  bool is_global_ptr = isa< ar::GlobalVariable >(pointer) ||
+                       isa< ar::FunctionPointerConstant >(pointer);
 
-  // Points-to set of the pointer
-  PointsToSet addrs = inv.normal().pointers().points_to(ptr.var());
-
-  if (addrs.is_empty()) {
+  if (!is_global_ptr && facts.points_to().is_empty()) {
     // Pointer is invalid
     if (this->display_mem_access_check(Result::Error,
                                        stmt,
@@ -326,8 +335,8 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_mem_access(
                                        access_size)) {
       out() << ": empty points-to set for pointer" << std::endl;
     }
-    return {CheckKind::InvalidPointerDereference, Result::Error, {pointer}, {}};
-  } else if (addrs.is_top()) {
+    return {CheckKind::InvalidPointerDereference, Result::Error, {pointer}};
+  } else if (!is_global_ptr && facts.points_to().is_top()) {
     // Unknown points-to set
     if (this->display_mem_access_check(Result::Warning,
                                        stmt,
@@ -335,14 +344,31 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_mem_access(
                                        access_size)) {
       out() << ": no points-to information for pointer" << std::endl;
     }
-    return {CheckKind::UnknownMemoryAccess, Result::Warning, {pointer}, {}};
+    return {CheckKind::UnknownMemoryAccess, Result::Warning, {pointer}};
   }
 
-  JsonDict info;
-  JsonList points_to_info;
+  // Copy of the invariant, with shadow variables for the checks
+  value::AbstractDomain access_inv(inv);
+
+  // Initialize global variable pointer and function pointer
+  this->init_global_ptr(pointer, access_inv);
+
+  // Variable representing the pointer offset
+  Variable* offset_var = access_inv.normal().pointers().offset_var(ptr.var());
+
+  // Points-to set of the pointer
+  PointsToSet addrs =
+      is_global_ptr ? access_inv.normal().pointers().points_to(ptr.var())
+                    : facts.points_to();
+
+  // Information on the access, only turned into json for warnings and errors
+  MemoryAccessInfo& access_info = this->_access_info;
+  access_info.points_to.clear();
 
-  IntInterval offset_intv = inv.normal().integers().to_interval(offset_var);
-  info.put("offset", to_json(offset_intv));
+  IntInterval offset_intv =
+      is_global_ptr ? access_inv.normal().integers().to_interval(offset_var)
+                    : facts.offset_interval();
+  access_info.offset = offset_intv;
 
   // Add a shadow variable `offset_plus_size = offset + access_size`
   Variable* offset_plus_size =
@@ -351,26 +377,23 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_mem_access(
 
   IntInterval size_intv;
   if (size.is_machine_int_var()) {
-    size_intv = inv.normal().integers().to_interval(size.var());
-    inv.normal().integers().apply(IntBinaryOperator::Add,
-                                  offset_plus_size,
-                                  offset_var,
-                                  size.var());
+    size_intv = access_inv.normal().integers().to_interval(size.var());
+    access_inv.normal().integers().apply(IntBinaryOperator::Add,
+                                         offset_plus_size,
+                                         offset_var,
+                                         size.var());
   } else if (size.is_machine_int()) {
     size_intv = IntInterval(size.machine_int());
-    inv.normal().integers().apply(IntBinaryOperator::Add,
-                                  offset_plus_size,
-                                  offset_var,
-                                  size.machine_int());
+    access_inv.normal().integers().apply(IntBinaryOperator::Add,
+                                         offset_plus_size,
+                                         offset_var,
+                                         size.machine_int());
   } else {
     ikos_unreachable("unexpected access size");
   }
-  info.put("access_size", to_json(size_intv));
-
-  if (auto element_size =
-          this->is_array_access(stmt, inv, offset_intv, addrs)) {
-    info.put("array_element_size", *element_size);
-  }
+  access_info.access_size = size_intv;
+  access_info.array_element_size =
+      this->is_array_access(stmt, access_inv, offset_intv, addrs);
 
   // Are all the points-to in/valid
   bool all_valid = true;
@@ -378,26 +401,26 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_mem_access(
 
   for (auto addr : addrs) {
     AllocSizeVariable* size_var = _ctx.var_factory->get_alloc_size(addr);
-    this->init_global_alloc_size(addr, size_var, inv);
+    this->init_global_alloc_size(addr, size_var, access_inv);
 
-    // add block info
-    JsonDict block_info = {
-        {"id", _ctx.output_db->memory_locations.insert(addr)}};
+    access_info.points_to.emplace_back();
+    MemoryLocationCheck& location_check = access_info.points_to.back();
+    location_check.addr = addr;
 
     // perform analysis
     auto result_pair = this->check_memory_location_access(stmt,
                                                           pointer,
                                                           access_size,
-                                                          inv,
+                                                          access_inv,
                                                           addr,
                                                           size_var,
                                                           offset_var,
                                                           offset_plus_size,
                                                           offset_intv,
-                                                          block_info);
+                                                          location_check);
 
-    block_info.put("status", static_cast< int >(result_pair.first));
-    block_info.put("kind", static_cast< int >(result_pair.second));
+    location_check.result = result_pair.first;
+    location_check.kind = result_pair.second;
 
     if (result_pair.first == Result::Error) {
       all_valid = false;
@@ -407,27 +430,48 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_mem_access(
     } else {
       all_invalid = false;
     }
-
-    points_to_info.add(block_info);
   }
 
-  info.put("points_to", points_to_info);
-
   if (all_invalid) {
-    return {CheckKind::BufferOverflow,
-            Result::Error,
-            {pointer, access_size},
-            info};
+    return {CheckKind::BufferOverflow, Result::Error, {pointer, access_size}};
   } else if (!all_valid) {
-    return {CheckKind::BufferOverflow,
-            Result::Warning,
-            {pointer, access_size},
-            info};
+    return {CheckKind::BufferOverflow, Result::Warning, {pointer, access_size}};
   } else {
-    return {CheckKind::BufferOverflow, Result::Ok, {pointer, access_size}, {}};
+    return {CheckKind::BufferOverflow, Result::Ok, {pointer, access_size}};
   }
 }
 
+void BufferOverflowChecker::mem_access_info(JsonDict& info) {
+  const MemoryAccessInfo& access_info = this->_access_info;
+  info.put("offset", to_json(access_info.offset));
+  info.put("access_size", to_json(access_info.access_size));
+  if (access_info.array_element_size) {
+    info.put("array_element_size", *access_info.array_element_size);
+  }
+
+  JsonList points_to_info;
+  for (const MemoryLocationCheck& location_check : access_info.points_to) {
+    JsonDict block_info = {
+        {"id", _ctx.output_db->memory_locations.insert(location_check.addr)}};
+    if (location_check.size) {
+      block_info.put("size", to_json(*location_check.size));
+    }
+    if (location_check.diff) {
+      block_info.put("diff", to_json(*location_check.diff));
+    }
+    block_info.put("status", static_cast< int >(location_check.result));
+    block_info.put("kind", static_cast< int >(location_check.kind));
+    points_to_info.add(block_info);
+  }
+  info.put("points_to", points_to_info);
+}
+
+void BufferOverflowChecker::leave(ar::Function* fun,
+                                  CallContext* call_context) {
+  std::vector< MemoryLocationCheck >().swap(this->_access_info.points_to);
+  Checker::leave(fun, call_context);
+}
+
 std::pair< Result, BufferOverflowChecker::BufferOverflowCheckKind >
 BufferOverflowChecker::check_memory_location_access(
     ar::Statement* stmt,
@@ -439,7 +483,7 @@ BufferOverflowChecker::check_memory_location_access(
     Variable* offset_var,
     Variable* offset_plus_size,
     const IntInterval& offset_intv,
-    JsonDict& block_info) {
+    MemoryLocationCheck& location_check) {
   if (isa< FunctionMemoryLocation >(addr)) {
     // Try to dereference a function pointer, this is an error
     if (this->display_mem_access_check(Result::Error,
@@ -575,18 +619,16 @@ BufferOverflowChecker::check_memory_location_access(
     }
   }
 
-  // add `size` (min, max) to block_info
-  IntInterval size_intv = inv.normal().integers().to_interval(size_var);
-  block_info.put("size", to_json(size_intv));
+  // record `size` (min, max)
+  location_check.size = inv.normal().integers().to_interval(size_var);
 
-  // add `offset + access_size - size` (min, max) to block_info
+  // record `offset + access_size - size` (min, max)
   MachineInt zero(0, this->_data_layout.pointers.bit_width, Unsigned);
   MachineInt one(1, this->_data_layout.pointers.bit_width, Unsigned);
   IntLinearExpression expr(zero);
   expr.add(one, offset_plus_size);
   expr.add(-one, size_var);
-  IntInterval diff_intv = inv.normal().integers().to_interval(expr);
-  block_info.put("diff", to_json(diff_intv));
+  location_check.diff = inv.normal().integers().to_interval(expr);
 
   // Checks: `offset > mem_size || offset + access_size > mem_size`
   value::AbstractDomain tmp1(inv);
@@ -661,8 +703,7 @@ void BufferOverflowChecker::check_strcpy(ar::Statement* stmt,
                        check.result,
                        stmt,
                        call_context,
-                       check.operands,
-                       check.info);
+                       check.operands);
 }
 
 BufferOverflowChecker::CheckResult BufferOverflowChecker::check_strcpy(
@@ -678,7 +719,7 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_strcpy(
                                    src_op)) {
       out() << std::endl;
     }
-    return {CheckKind::Unreachable, Result::Unreachable, {}, {}};
+    return {CheckKind::Unreachable, Result::Unreachable, {}};
   }
 
   const ScalarLit& dest = this->_lit_factory.get_scalar(dest_op);
@@ -693,7 +734,7 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_strcpy(
     if (this->display_strcpy_check(Result::Error, stmt, dest_op, src_op)) {
       out() << ": undefined source pointer" << std::endl;
     }
-    return {CheckKind::UninitializedVariable, Result::Error, {src_op}, {}};
+    return {CheckKind::UninitializedVariable, Result::Error, {src_op}};
   }
 
   if (dest.is_undefined() ||
@@ -703,7 +744,7 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_strcpy(
     if (this->display_strcpy_check(Result::Error, stmt, dest_op, src_op)) {
       out() << ": undefined destination pointer" << std::endl;
     }
-    return {CheckKind::UninitializedVariable, Result::Error, {dest_op}, {}};
+    return {CheckKind::UninitializedVariable, Result::Error, {dest_op}};
   }
 
   // Check null pointer dereference
@@ -714,7 +755,7 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_strcpy(
     if (this->display_mem_access_check(Result::Error, stmt, dest_op, src_op)) {
       out() << ": null source pointer" << std::endl;
     }
-    return {CheckKind::NullPointerDereference, Result::Error, {src_op}, {}};
+    return {CheckKind::NullPointerDereference, Result::Error, {src_op}};
   }
 
   if (dest.is_null() ||
@@ -723,17 +764,17 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_strcpy(
     if (this->display_mem_access_check(Result::Error, stmt, dest_op, src_op)) {
       out() << ": null destination pointer" << std::endl;
     }
-    return {CheckKind::NullPointerDereference, Result::Error, {dest_op}, {}};
+    return {CheckKind::NullPointerDereference, Result::Error, {dest_op}};
   }
 
   // Check unexpected operand
   if (!src.is_pointer_var()) {
     log::error("unexpected source pointer operand");
-    return {CheckKind::UnexpectedOperand, Result::Error, {src_op}, {}};
+    return {CheckKind::UnexpectedOperand, Result::Error, {src_op}};
   }
   if (!dest.is_pointer_var()) {
     log::error("unexpected destination pointer operand");
-    return {CheckKind::UnexpectedOperand, Result::Error, {dest_op}, {}};
+    return {CheckKind::UnexpectedOperand, Result::Error, {dest_op}};
   }
 
   // Initialize global variable pointers and function pointers
@@ -748,21 +789,21 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_strcpy(
     if (this->display_strcpy_check(Result::Error, stmt, dest_op, src_op)) {
       out() << ": empty points-to set for source pointer" << std::endl;
     }
-    return {CheckKind::InvalidPointerDereference, Result::Error, {src_op}, {}};
+    return {CheckKind::InvalidPointerDereference, Result::Error, {src_op}};
   }
   if (dest_addrs.is_empty()) {
     // Destination pointer is invalid
     if (this->display_strcpy_check(Result::Error, stmt, dest_op, src_op)) {
       out() << ": empty points-to set for destination pointer" << std::endl;
     }
-    return {CheckKind::InvalidPointerDereference, Result::Error, {dest_op}, {}};
+    return {CheckKind::InvalidPointerDereference, Result::Error, {dest_op}};
   }
   if (src_addrs.is_top()) {
     // Unknown source points-to set
     if (this->display_strcpy_check(Result::Error, stmt, dest_op, src_op)) {
       out() << ": no points-to information for source pointer" << std::endl;
     }
-    return {CheckKind::UnknownMemoryAccess, Result::Warning, {src_op}, {}};
+    return {CheckKind::UnknownMemoryAccess, Result::Warning, {src_op}};
   }
   if (dest_addrs.is_top()) {
     // Unknown source points-to set
@@ -770,7 +811,7 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_strcpy(
       out() << ": no points-to information for destination pointer"
             << std::endl;
     }
-    return {CheckKind::UnknownMemoryAccess, Result::Warning, {dest_op}, {}};
+    return {CheckKind::UnknownMemoryAccess, Result::Warning, {dest_op}};
   }
 
   bool all_valid = true;
@@ -829,8 +870,7 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_strcpy(
 
   return {CheckKind::StrcpyBufferOverflow,
           all_valid ? Result::Ok : Result::Warning,
-          {dest_op, src_op},
-          {}};
+          {dest_op, src_op}};
 }
 
 ar::IntegerConstant* BufferOverflowChecker::store_size(ar::Type* type) {
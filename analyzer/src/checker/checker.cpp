@@ -130,5 +130,64 @@ std::unique_ptr< Checker > make_checker(Context& ctx, CheckerName name) {
   }
 }
 
+// CheckerList
+
+CheckerList::CheckerList(Context& ctx)
+    : _ctx(ctx),
+      _selected(ctx.opts.functions.begin(), ctx.opts.functions.end()),
+      _pointer_facts(std::make_shared< PointerFactsCache >()),
+      _int_facts(std::make_shared< IntFactsCache >()) {
+  for (CheckerName name : ctx.opts.analyses) {
+    this->_checkers.emplace_back(make_checker(ctx, name));
+    this->_checkers.back()->set_pointer_facts(this->_pointer_facts);
+    this->_checkers.back()->set_int_facts(this->_int_facts);
+  }
+  for (std::size_t kind = 0; kind < NumStatementKinds; kind++) {
+    for (CheckerIndex i = 0; i < this->_checkers.size(); i++) {
+      if (this->_checkers[i]->handles(
+              static_cast< ar::Statement::StatementKind >(kind))) {
+        this->_dispatch[kind].push_back(i);
+      }
+    }
+  }
+  this->_times.resize(this->_checkers.size(), Timer::Duration::zero());
+}
+
+void CheckerList::check(ar::Statement* stmt,
+                        const value::AbstractDomain& inv,
+                        CallContext* call_context) {
+  if (!this->_selected.empty() &&
+      this->_selected.count(stmt->code()->function()) == 0) {
+    return;
+  }
+
+  // The invariant changes between calls, even for the same statement
+  this->_pointer_facts->clear();
+  this->_int_facts->clear();
+
+  for (CheckerIndex i : this->_dispatch[stmt->kind()]) {
+    Timer timer;
+    timer.start();
+    this->_checkers[i]->check(stmt, inv, call_context);
+    timer.stop();
+    this->_times[i] += timer.elapsed();
+  }
+}
+
+void CheckerList::merge_times(const CheckerList& other) {
+  ikos_assert(this->_times.size() == other._times.size());
+  for (CheckerIndex i = 0; i < this->_times.size(); i++) {
+    this->_times[i] += other._times[i];
+  }
+}
+
+void CheckerList::report_times() const {
+  for (CheckerIndex i = 0; i < this->_checkers.size(); i++) {
+    this->_ctx.output_db->times.insert(std::string("ikos-analyzer.checker.") +
+                                           this->_checkers[i]->short_name(),
+                                       this->_times[i].count());
+  }
+}
+
 } // end namespace analyzer
 } // end namespace ikos
@@ -42,6 +42,7 @@
  ******************************************************************************/
 
 #include <ikos/analyzer/analysis/literal.hpp>
+#include <ikos/analyzer/analysis/trivial_checks.hpp>
 #include <ikos/analyzer/checker/division_by_zero.hpp>
 #include <ikos/analyzer/json/helper.hpp>
 #include <ikos/analyzer/support/cast.hpp>
@@ -60,9 +61,19 @@ const char* DivisionByZeroChecker::description() const {
   return "Division by zero checker";
 }
 
+bool DivisionByZeroChecker::handles(ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::BinaryOperationKind;
+}
+
 void DivisionByZeroChecker::check(ar::Statement* stmt,
                                   const value::AbstractDomain& inv,
                                   CallContext* call_context) {
+  if (this->_ctx.trivial_checks != nullptr &&
+      this->_ctx.trivial_checks->is_safe(CheckerName::DivisionByZero, stmt)) {
+    // Already written as safe, see TrivialChecksAnalysis
+    return;
+  }
+
   if (auto bin = dyn_cast< ar::BinaryOperation >(stmt)) {
     if (bin->op() == ar::BinaryOperation::UDiv ||
         bin->op() == ar::BinaryOperation::SDiv ||
@@ -91,11 +102,11 @@ DivisionByZeroChecker::CheckResult DivisionByZeroChecker::check_division(
     return {CheckKind::Unreachable, Result::Unreachable, {}};
   }
 
-  const ScalarLit& lit = this->_lit_factory.get_scalar(stmt->right());
+  const ScalarLit& lit = this->literals(stmt).scalar_operand(1);
 
   if (lit.is_undefined() ||
       (lit.is_machine_int_var() &&
-       inv.normal().uninitialized().is_uninitialized(lit.var()))) {
+       this->int_facts(stmt, lit.var(), inv).is_uninitialized())) {
     // Undefined operand
     if (this->display_division_check(Result::Error, stmt)) {
       out() << ": undefined operand" << std::endl;
@@ -107,7 +118,7 @@ DivisionByZeroChecker::CheckResult DivisionByZeroChecker::check_division(
   if (lit.is_machine_int()) {
     divisor = IntInterval(lit.machine_int());
   } else if (lit.is_machine_int_var()) {
-    divisor = inv.normal().integers().to_interval(lit.var());
+    divisor = this->int_facts(stmt, lit.var(), inv).interval();
   } else {
     log::error("unexpected operand to binary operation");
     return {CheckKind::UnexpectedOperand, Result::Error, {}};
@@ -57,6 +57,10 @@ const char* DoubleFreeChecker::description() const {
   return "Double free checker";
 }
 
+bool DoubleFreeChecker::handles(ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::CallKind;
+}
+
 void DoubleFreeChecker::check(ar::Statement* stmt,
                               const value::AbstractDomain& inv,
                               CallContext* call_context) {
@@ -60,6 +60,11 @@ const char* FunctionCallChecker::description() const {
   return "Function call checker";
 }
 
+bool FunctionCallChecker::handles(ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::CallKind ||
+         kind == ar::Statement::InvokeKind;
+}
+
 void FunctionCallChecker::check(ar::Statement* stmt,
                                 const value::AbstractDomain& inv,
                                 CallContext* call_context) {
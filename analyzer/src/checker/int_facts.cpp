@@ -0,0 +1,99 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of IntFacts and IntFactsCache
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2011-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <ikos/analyzer/checker/int_facts.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+bool IntFacts::is_uninitialized() {
+  if (!this->_uninitialized) {
+    this->_uninitialized =
+        this->_inv.normal().uninitialized().is_uninitialized(this->_var);
+  }
+  return *this->_uninitialized;
+}
+
+const IntFacts::IntInterval& IntFacts::interval() {
+  if (!this->_interval) {
+    this->_interval = this->_inv.normal().integers().to_interval(this->_var);
+  }
+  return *this->_interval;
+}
+
+const IntFacts::Congruence& IntFacts::congruence() {
+  if (!this->_congruence) {
+    this->_congruence =
+        this->_inv.normal().integers().to_congruence(this->_var);
+  }
+  return *this->_congruence;
+}
+
+IntFacts& IntFactsCache::get(ar::Statement* stmt,
+                             Variable* var,
+                             const value::AbstractDomain& inv) {
+  if (stmt != this->_stmt || &inv != this->_inv) {
+    this->clear();
+    this->_stmt = stmt;
+    this->_inv = &inv;
+  }
+
+  for (IntFacts& facts : this->_facts) {
+    if (facts.variable() == var) {
+      return facts;
+    }
+  }
+
+  this->_facts.emplace_back(var, inv);
+  return this->_facts.back();
+}
+
+void IntFactsCache::clear() {
+  this->_stmt = nullptr;
+  this->_inv = nullptr;
+  this->_facts.clear();
+}
+
+} // end namespace analyzer
+} // end namespace ikos
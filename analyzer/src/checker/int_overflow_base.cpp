@@ -107,15 +107,16 @@ IntOverflowCheckerBase::check_integer_overflow(
     return {}; // TODO: Support checks on vector operations
   }
 
-  const ScalarLit& left_lit = this->_lit_factory.get_scalar(stmt->left());
-  const ScalarLit& right_lit = this->_lit_factory.get_scalar(stmt->right());
+  StatementLiterals lits = this->literals(stmt);
+  const ScalarLit& left_lit = lits.scalar_operand(0);
+  const ScalarLit& right_lit = lits.scalar_operand(1);
 
   IntInterval left_interval;
   IntInterval right_interval;
 
   if (left_lit.is_undefined() ||
       (left_lit.is_machine_int_var() &&
-       inv.normal().uninitialized().is_uninitialized(left_lit.var()))) {
+       this->int_facts(stmt, left_lit.var(), inv).is_uninitialized())) {
     // Undefined operand
     if (this->display_int_overflow_check(Result::Error, stmt)) {
       out() << ": undefined left operand" << std::endl;
@@ -125,7 +126,7 @@ IntOverflowCheckerBase::check_integer_overflow(
   } else if (left_lit.is_machine_int()) {
     left_interval = IntInterval(left_lit.machine_int());
   } else if (left_lit.is_machine_int_var()) {
-    left_interval = inv.normal().integers().to_interval(left_lit.var());
+    left_interval = this->int_facts(stmt, left_lit.var(), inv).interval();
   } else {
     log::error("unexpected operand to binary operation");
     return {{CheckKind::UnexpectedOperand, Result::Error, {stmt->left()}, {}}};
@@ -133,7 +134,7 @@ IntOverflowCheckerBase::check_integer_overflow(
 
   if (right_lit.is_undefined() ||
       (right_lit.is_machine_int_var() &&
-       inv.normal().uninitialized().is_uninitialized(right_lit.var()))) {
+       this->int_facts(stmt, right_lit.var(), inv).is_uninitialized())) {
     // Undefined operand
     if (this->display_int_overflow_check(Result::Error, stmt)) {
       out() << ": undefined right operand" << std::endl;
@@ -143,7 +144,7 @@ IntOverflowCheckerBase::check_integer_overflow(
   } else if (right_lit.is_machine_int()) {
     right_interval = IntInterval(right_lit.machine_int());
   } else if (right_lit.is_machine_int_var()) {
-    right_interval = inv.normal().integers().to_interval(right_lit.var());
+    right_interval = this->int_facts(stmt, right_lit.var(), inv).interval();
   } else {
     log::error("unexpected operand to binary operation");
     return {{CheckKind::UnexpectedOperand, Result::Error, {stmt->right()}, {}}};
@@ -59,6 +59,13 @@ const char* NullDereferenceChecker::description() const {
   return "Null dereference checker";
 }
 
+bool NullDereferenceChecker::handles(ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::LoadKind ||
+         kind == ar::Statement::StoreKind ||
+         kind == ar::Statement::CallKind ||
+         kind == ar::Statement::InvokeKind;
+}
+
 void NullDereferenceChecker::check(ar::Statement* stmt,
                                    const value::AbstractDomain& inv,
                                    CallContext* call_context) {
@@ -132,7 +139,7 @@ NullDereferenceChecker::CheckResult NullDereferenceChecker::check_null(
 
   if (ptr.is_undefined() ||
       (ptr.is_pointer_var() &&
-       inv.normal().uninitialized().is_uninitialized(ptr.var()))) {
+       this->pointer_facts(stmt, ptr.var(), inv).is_uninitialized())) {
     // Undefined operand
     if (this->display_null_check(Result::Error, stmt, operand)) {
       out() << ": undefined operand" << std::endl;
@@ -179,7 +186,7 @@ NullDereferenceChecker::CheckResult NullDereferenceChecker::check_null(
     return {CheckKind::NullPointerDereference, Result::Ok};
   }
 
-  core::Nullity null_val = inv.normal().nullity().get(ptr.var());
+  core::Nullity null_val = this->pointer_facts(stmt, ptr.var(), inv).nullity();
   if (null_val.is_null()) {
     // Pointer is definitely null
     if (this->display_null_check(Result::Error, stmt, operand)) {
@@ -61,6 +61,12 @@ const char* PointerAlignmentChecker::description() const {
   return "pointer alignment checker";
 }
 
+bool PointerAlignmentChecker::handles(ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::LoadKind ||
+         kind == ar::Statement::StoreKind ||
+         kind == ar::Statement::CallKind;
+}
+
 void PointerAlignmentChecker::check(ar::Statement* stmt,
                                     const value::AbstractDomain& inv,
                                     CallContext* call_context) {
@@ -140,7 +146,7 @@ PointerAlignmentChecker::CheckResult PointerAlignmentChecker::check_alignment(
 
   if (ptr.is_undefined() ||
       (ptr.is_pointer_var() &&
-       inv.normal().uninitialized().is_uninitialized(ptr.var()))) {
+       this->pointer_facts(stmt, ptr.var(), inv).is_uninitialized())) {
     // Undefined operand
     if (this->display_alignment_check(Result::Error, stmt, operand)) {
       out() << ": undefined operand" << std::endl;
@@ -149,7 +155,8 @@ PointerAlignmentChecker::CheckResult PointerAlignmentChecker::check_alignment(
   }
 
   if (ptr.is_null() ||
-      (ptr.is_pointer_var() && inv.normal().nullity().is_null(ptr.var()))) {
+      (ptr.is_pointer_var() &&
+       this->pointer_facts(stmt, ptr.var(), inv).is_null())) {
     // Null operand
     if (this->display_alignment_check(Result::Error, stmt, operand)) {
       out() << ": null operand" << std::endl;
@@ -170,17 +177,15 @@ PointerAlignmentChecker::CheckResult PointerAlignmentChecker::check_alignment(
     return {CheckKind::UnalignedPointer, Result::Ok, {}};
   }
 
-  // Pointer variable
-  Variable* ptr_var = ptr.var();
-
-  // Variable representing the pointer offset
-  Variable* offset_var = inv.normal().pointers().offset_var(ptr_var);
+  // Facts about the pointer
+  PointerFacts& facts = this->pointer_facts(stmt, ptr.var(), inv);
 
   // Points-to set of the pointer
-  PointsToSet addrs = inv.normal().pointers().points_to(ptr_var);
-
+  PointsToSet addrs;
   if (auto gv = dyn_cast< ar::GlobalVariable >(operand)) {
     addrs = PointsToSet{_ctx.mem_factory->get_global(gv)};
+  } else {
+    addrs = facts.points_to();
   }
 
   if (addrs.is_empty()) {
@@ -200,11 +205,9 @@ PointerAlignmentChecker::CheckResult PointerAlignmentChecker::check_alignment(
   }
 
   Congruence alignment_req_c = to_congruence(alignment_req, 0);
-  Congruence offset_c = inv.normal().integers().to_congruence(offset_var);
-
-  if (isa< ar::GlobalVariable >(operand)) {
-    offset_c = to_congruence(0, 0);
-  }
+  Congruence offset_c = isa< ar::GlobalVariable >(operand)
+                            ? to_congruence(0, 0)
+                            : facts.offset_congruence();
 
   JsonDict info;
   JsonList points_to_info;
@@ -59,6 +59,10 @@ const char* PointerCompareChecker::description() const {
   return "Pointer compare checker";
 }
 
+bool PointerCompareChecker::handles(ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::ComparisonKind;
+}
+
 void PointerCompareChecker::check(ar::Statement* stmt,
                                   const value::AbstractDomain& inv,
                                   CallContext* call_context) {
@@ -89,8 +93,9 @@ PointerCompareChecker::CheckResult PointerCompareChecker::check_pointer_compare(
     return {CheckKind::Unreachable, Result::Unreachable, {}, {}};
   }
 
-  const ScalarLit& left_ptr = this->_lit_factory.get_scalar(stmt->left());
-  const ScalarLit& right_ptr = this->_lit_factory.get_scalar(stmt->right());
+  StatementLiterals lits = this->literals(stmt);
+  const ScalarLit& left_ptr = lits.scalar_operand(0);
+  const ScalarLit& right_ptr = lits.scalar_operand(1);
 
   // Check uninitialized operands
 
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of PointerFacts and PointerFactsCache
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2011-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <ikos/analyzer/checker/pointer_facts.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+bool PointerFacts::is_uninitialized() {
+  if (!this->_uninitialized) {
+    this->_uninitialized =
+        this->_inv.normal().uninitialized().is_uninitialized(this->_ptr);
+  }
+  return *this->_uninitialized;
+}
+
+core::Nullity PointerFacts::nullity() {
+  if (!this->_nullity) {
+    this->_nullity = this->_inv.normal().nullity().get(this->_ptr);
+  }
+  return *this->_nullity;
+}
+
+const PointerFacts::PointsToSet& PointerFacts::points_to() {
+  if (!this->_points_to) {
+    this->_points_to = this->_inv.normal().pointers().points_to(this->_ptr);
+  }
+  return *this->_points_to;
+}
+
+const PointerFacts::IntInterval& PointerFacts::offset_interval() {
+  if (!this->_offset_interval) {
+    this->_offset_interval =
+        this->_inv.normal().integers().to_interval(this->offset_var());
+  }
+  return *this->_offset_interval;
+}
+
+const PointerFacts::Congruence& PointerFacts::offset_congruence() {
+  if (!this->_offset_congruence) {
+    this->_offset_congruence =
+        this->_inv.normal().integers().to_congruence(this->offset_var());
+  }
+  return *this->_offset_congruence;
+}
+
+PointerFacts& PointerFactsCache::get(ar::Statement* stmt,
+                                     Variable* ptr,
+                                     const value::AbstractDomain& inv) {
+  if (stmt != this->_stmt || &inv != this->_inv) {
+    this->clear();
+    this->_stmt = stmt;
+    this->_inv = &inv;
+  }
+
+  for (PointerFacts& facts : this->_facts) {
+    if (facts.pointer() == ptr) {
+      return facts;
+    }
+  }
+
+  this->_facts.emplace_back(ptr, inv);
+  return this->_facts.back();
+}
+
+void PointerFactsCache::clear() {
+  this->_stmt = nullptr;
+  this->_inv = nullptr;
+  this->_facts.clear();
+}
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -60,6 +60,10 @@ const char* PointerOverflowChecker::description() const {
   return "Pointer overflow checker";
 }
 
+bool PointerOverflowChecker::handles(ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::PointerShiftKind;
+}
+
 void PointerOverflowChecker::check(ar::Statement* stmt,
                                    const value::AbstractDomain& inv,
                                    CallContext* call_context) {
@@ -86,11 +90,12 @@ PointerOverflowChecker::CheckResult PointerOverflowChecker::
     return {CheckKind::Unreachable, Result::Unreachable, {}};
   }
 
-  const ScalarLit& base = this->_lit_factory.get_scalar(stmt->pointer());
+  StatementLiterals lits = this->literals(stmt);
+  const ScalarLit& base = lits.scalar_operand(0);
 
   if (base.is_undefined() ||
       (base.is_pointer_var() &&
-       inv.normal().uninitialized().is_uninitialized(base.var()))) {
+       this->pointer_facts(stmt, base.var(), inv).is_uninitialized())) {
     if (this->display_pointer_overflow_check(Result::Error, stmt)) {
       out() << ": undefined base operand" << std::endl;
     }
@@ -104,9 +109,9 @@ PointerOverflowChecker::CheckResult PointerOverflowChecker::
       isa< ar::FunctionPointerConstant >(stmt->pointer())) {
     base_interval = ZInterval(0);
   } else if (isa< ar::InternalVariable >(stmt->pointer())) {
-    Variable* offset_var = inv.normal().pointers().offset_var(base.var());
-    base_interval =
-        inv.normal().integers().to_interval(offset_var).to_z_interval();
+    base_interval = this->pointer_facts(stmt, base.var(), inv)
+                        .offset_interval()
+                        .to_z_interval();
   } else {
     log::error("unexpected operand to ptrshift");
     return {CheckKind::UnexpectedOperand, Result::Error, {stmt->pointer()}};
@@ -119,12 +124,13 @@ PointerOverflowChecker::CheckResult PointerOverflowChecker::
   ZBound max(MachineInt::max(this->_data_layout.pointers.bit_width, Unsigned)
                  .to_z_number());
 
+  std::size_t i = 1;
   for (auto it = stmt->term_begin(), et = stmt->term_end();
        it != et && result != Result::Error;
-       it++) {
+       it++, i++) {
     auto term = *it;
     auto factor_interval = ZInterval(term.first.to_z_number());
-    const ScalarLit& offset = this->_lit_factory.get_scalar(term.second);
+    const ScalarLit& offset = lits.scalar_operand(i);
     ZInterval offset_interval;
 
     if (offset.is_undefined() ||
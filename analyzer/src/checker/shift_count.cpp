@@ -42,6 +42,7 @@
  ******************************************************************************/
 
 #include <ikos/analyzer/analysis/literal.hpp>
+#include <ikos/analyzer/analysis/trivial_checks.hpp>
 #include <ikos/analyzer/checker/shift_count.hpp>
 #include <ikos/analyzer/json/helper.hpp>
 #include <ikos/analyzer/support/cast.hpp>
@@ -60,9 +61,19 @@ const char* ShiftCountChecker::description() const {
   return "Shift count checker";
 }
 
+bool ShiftCountChecker::handles(ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::BinaryOperationKind;
+}
+
 void ShiftCountChecker::check(ar::Statement* stmt,
                               const value::AbstractDomain& inv,
                               CallContext* call_context) {
+  if (this->_ctx.trivial_checks != nullptr &&
+      this->_ctx.trivial_checks->is_safe(CheckerName::ShiftCount, stmt)) {
+    // Already written as safe, see TrivialChecksAnalysis
+    return;
+  }
+
   if (auto bin = dyn_cast< ar::BinaryOperation >(stmt)) {
     if (bin->op() == ar::BinaryOperation::SShl ||
         bin->op() == ar::BinaryOperation::UShl ||
@@ -93,7 +104,7 @@ ShiftCountChecker::CheckResult ShiftCountChecker::check_shift_count(
     return {CheckKind::Unreachable, Result::Unreachable, {}};
   }
 
-  const ScalarLit& shift_count = this->_lit_factory.get_scalar(stmt->right());
+  const ScalarLit& shift_count = this->literals(stmt).scalar_operand(1);
 
   IntInterval shift_count_interval;
   if (shift_count.is_undefined() ||
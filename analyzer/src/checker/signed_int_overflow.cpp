@@ -57,6 +57,11 @@ const char* SignedIntOverflowChecker::description() const {
   return "Signed integer overflow checker";
 }
 
+bool SignedIntOverflowChecker::handles(
+    ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::BinaryOperationKind;
+}
+
 void SignedIntOverflowChecker::check(ar::Statement* stmt,
                                      const value::AbstractDomain& inv,
                                      CallContext* call_context) {
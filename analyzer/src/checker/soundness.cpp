@@ -59,6 +59,12 @@ const char* SoundnessChecker::description() const {
   return "Soundness checker";
 }
 
+bool SoundnessChecker::handles(ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::StoreKind ||
+         kind == ar::Statement::CallKind ||
+         kind == ar::Statement::InvokeKind;
+}
+
 void SoundnessChecker::check(ar::Statement* stmt,
                              const value::AbstractDomain& inv,
                              CallContext* call_context) {
@@ -272,6 +278,7 @@ std::vector< SoundnessChecker::CheckResult > SoundnessChecker::
     case ar::Intrinsic::IkosNonDetUi32:
     case ar::Intrinsic::IkosCounterInit:
     case ar::Intrinsic::IkosCounterIncr:
+    case ar::Intrinsic::IkosCounterForget:
     case ar::Intrinsic::IkosPrintInvariant:
     case ar::Intrinsic::IkosPrintValues: {
       return {};
@@ -106,6 +106,8 @@ boost::optional< Result > UninitializedVariableChecker::check_initialized(
     return boost::none;
   } else if (isa< ar::VectorConstant >(operand)) {
     return boost::none;
+  } else if (isa< ar::DataArrayConstant >(operand)) {
+    return boost::none;
   } else if (isa< ar::AggregateZeroConstant >(operand)) {
     return boost::none;
   } else if (isa< ar::FunctionPointerConstant >(operand)) {
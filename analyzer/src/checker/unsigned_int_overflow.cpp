@@ -57,6 +57,11 @@ const char* UnsignedIntOverflowChecker::description() const {
   return "Unsigned integer overflow checker";
 }
 
+bool UnsignedIntOverflowChecker::handles(
+    ar::Statement::StatementKind kind) const {
+  return kind == ar::Statement::BinaryOperationKind;
+}
+
 void UnsignedIntOverflowChecker::check(ar::Statement* stmt,
                                        const value::AbstractDomain& inv,
                                        CallContext* call_context) {
@@ -0,0 +1,743 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Persistent cache of function results, for incremental analyses
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringExtras.h>
+
+#include <ikos/ar/semantic/bundle.hpp>
+#include <ikos/ar/semantic/function.hpp>
+
+#include <ikos/analyzer/checker/name.hpp>
+#include <ikos/analyzer/database/cache.hpp>
+#include <ikos/analyzer/support/cast.hpp>
+#include <ikos/analyzer/util/log.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+/// \brief Return a string representing the analysis options that have an
+/// impact on the results of a function
+std::string config_str(const AnalysisOptions& opts) {
+  std::string r;
+  for (CheckerName checker : opts.analyses) {
+    r += checker_short_name(checker);
+    r += ',';
+  }
+  r += ';';
+  r += machine_int_domain_option_str(opts.machine_int_domain);
+  r += ';';
+  if (!opts.function_domains.empty()) {
+    r += function_domains_str(opts.function_domains);
+    r += ';';
+  }
+  if (opts.kernel_domain) {
+    r += "kernel=";
+    r += machine_int_domain_option_str(*opts.kernel_domain);
+    r += ';';
+  }
+  if (opts.max_pack_size != 0) {
+    r += "pack=";
+    r += std::to_string(opts.max_pack_size);
+    r += ';';
+  }
+  if (opts.apron_max_size != 0 || opts.apron_timeout != 0) {
+    r += "apron=";
+    r += std::to_string(opts.apron_max_size);
+    r += ',';
+    r += std::to_string(opts.apron_timeout);
+    r += ';';
+  }
+  r += procedural_str(opts.procedural);
+  r += ';';
+  r += opts.use_liveness ? "liveness" : "no-liveness";
+  r += ';';
+  r += opts.use_pointer ? "pointer" : "no-pointer";
+  r += ';';
+  r += precision_str(opts.precision);
+  r += ';';
+  r += hardware_addresses_str(opts.hardware_addresses);
+  if (opts.procedural == Procedural::Interprocedural) {
+    r += ';';
+    r += globals_init_policy_str(opts.globals_init_policy);
+    r += ';';
+    r += opts.argc ? std::to_string(*opts.argc) : "-";
+    r += ';';
+    r += opts.context_depth ? std::to_string(*opts.context_depth) : "-";
+    if (opts.use_frame_projection) {
+      r += ";frame-projection";
+    }
+    if (opts.group_contexts) {
+      r += ";group-contexts";
+    }
+  }
+  if (opts.refine_domain) {
+    r += ";refine=";
+    r += machine_int_domain_option_str(*opts.refine_domain);
+    r += ';';
+    r += opts.refine_timeout ? std::to_string(*opts.refine_timeout) : "-";
+  }
+  if (opts.trivial_checks) {
+    r += ";trivial-checks";
+  }
+  return r;
+}
+
+/// \brief Split a comma separated list of integers
+std::vector< sqlite::DbInt64 > parse_operands(llvm::StringRef s) {
+  std::vector< sqlite::DbInt64 > operands;
+  llvm::SmallVector< llvm::StringRef, 4 > parts;
+  s.split(parts, ',', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (llvm::StringRef part : parts) {
+    long long n = 0;
+    if (!part.getAsInteger(10, n)) {
+      operands.push_back(n);
+    }
+  }
+  return operands;
+}
+
+/// \brief Join a list of integers with commas
+std::string join_operands(const std::vector< sqlite::DbInt64 >& operands) {
+  std::string s;
+  for (sqlite::DbInt64 operand_no : operands) {
+    if (!s.empty()) {
+      s += ',';
+    }
+    s += std::to_string(operand_no);
+  }
+  return s;
+}
+
+/// \brief Index of the statements of codes by position, built on demand
+class StatementIndex {
+public:
+  /// \brief Basic block number and statement number in the block
+  using Position = std::pair< sqlite::DbInt64, sqlite::DbInt64 >;
+
+private:
+  /// \brief Statements of each basic block, per code
+  llvm::DenseMap< ar::Code*, std::vector< std::vector< ar::Statement* > > >
+      _statements;
+
+  /// \brief Positions of the statements
+  llvm::DenseMap< ar::Statement*, Position > _positions;
+
+public:
+  /// \brief Return the statement at the given position, or null
+  ar::Statement* statement(ar::Code* code,
+                           sqlite::DbInt64 block,
+                           sqlite::DbInt64 statement) {
+    const auto& blocks = this->index(code);
+    if (block < 0 || static_cast< std::size_t >(block) >= blocks.size()) {
+      return nullptr;
+    }
+    const auto& stmts = blocks[static_cast< std::size_t >(block)];
+    if (statement < 0 ||
+        static_cast< std::size_t >(statement) >= stmts.size()) {
+      return nullptr;
+    }
+    return stmts[static_cast< std::size_t >(statement)];
+  }
+
+  /// \brief Return the position of the given statement
+  Position position(ar::Statement* stmt) {
+    this->index(stmt->code());
+    return this->_positions[stmt];
+  }
+
+private:
+  /// \brief Index the statements of the given code
+  const std::vector< std::vector< ar::Statement* > >& index(ar::Code* code) {
+    auto it = this->_statements.find(code);
+    if (it != this->_statements.end()) {
+      return it->second;
+    }
+
+    std::vector< std::vector< ar::Statement* > > blocks;
+    sqlite::DbInt64 block_no = 0;
+    for (ar::BasicBlock* bb : *code) {
+      blocks.emplace_back(bb->begin(), bb->end());
+      sqlite::DbInt64 stmt_no = 0;
+      for (ar::Statement* stmt : *bb) {
+        this->_positions[stmt] = {block_no, stmt_no++};
+      }
+      block_no++;
+    }
+    return this->_statements[code] = std::move(blocks);
+  }
+
+}; // end class StatementIndex
+
+/// \brief Serialize a call context
+///
+/// The result is the list of calls `function:block:statement`, from the
+/// outermost call, separated by slashes.
+///
+/// Return false if the call context cannot be serialized.
+bool serialize_call_context(CallContext* call_context,
+                            StatementIndex& index,
+                            std::string& out) {
+  if (call_context->empty()) {
+    return true;
+  }
+  if (!serialize_call_context(call_context->parent(), index, out)) {
+    return false;
+  }
+
+  ar::CallBase* call = call_context->call();
+  ar::Function* fun = call->code()->function();
+  if (fun == nullptr) {
+    return false;
+  }
+
+  StatementIndex::Position pos = index.position(call);
+  if (!out.empty()) {
+    out += '/';
+  }
+  out += fun->name();
+  out += ':';
+  out += std::to_string(pos.first);
+  out += ':';
+  out += std::to_string(pos.second);
+  return true;
+}
+
+/// \brief Rebuild a call context serialized by serialize_call_context()
+///
+/// Return null if a call cannot be found.
+CallContext* parse_call_context(llvm::StringRef s,
+                                ar::Bundle* bundle,
+                                StatementIndex& index,
+                                CallContextFactory& factory) {
+  CallContext* call_context = factory.get_empty();
+  llvm::SmallVector< llvm::StringRef, 4 > calls;
+  s.split(calls, '/', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (llvm::StringRef call : calls) {
+    auto stmt_split = call.rsplit(':');
+    auto block_split = stmt_split.first.rsplit(':');
+    long long block_no = 0;
+    long long stmt_no = 0;
+    if (block_split.second.getAsInteger(10, block_no) ||
+        stmt_split.second.getAsInteger(10, stmt_no)) {
+      return nullptr;
+    }
+
+    ar::Function* fun = bundle->function_or_null(block_split.first.str());
+    if (fun == nullptr || !fun->is_definition()) {
+      return nullptr;
+    }
+
+    ar::Statement* stmt = index.statement(fun->body(), block_no, stmt_no);
+    if (stmt == nullptr || !isa< ar::CallBase >(stmt)) {
+      return nullptr;
+    }
+
+    call_context =
+        factory.get_context(call_context, cast< ar::CallBase >(stmt));
+  }
+  return call_context;
+}
+
+} // end anonymous namespace
+
+FunctionCache::FunctionCache(std::string filename, const AnalysisOptions& opts)
+    : _db(std::move(filename)), _config(config_str(opts)) {
+  this->_db.set_journal_mode(sqlite::JournalMode::Off);
+  this->_db.set_synchronous_flag(sqlite::SynchronousFlag::Off);
+  this->_db.create_table("config", {{"value", sqlite::DbColumnType::Text}});
+  this->_db.create_table("functions",
+                         {{"id", sqlite::DbColumnType::Integer},
+                          {"name", sqlite::DbColumnType::Text},
+                          {"hash", sqlite::DbColumnType::Text}});
+  this->_db.create_table("checks",
+                         {{"function_id", sqlite::DbColumnType::Integer},
+                          {"kind", sqlite::DbColumnType::Integer},
+                          {"checker", sqlite::DbColumnType::Integer},
+                          {"status", sqlite::DbColumnType::Integer},
+                          {"block", sqlite::DbColumnType::Integer},
+                          {"statement", sqlite::DbColumnType::Integer},
+                          {"operands", sqlite::DbColumnType::Text},
+                          {"info", sqlite::DbColumnType::Text}});
+  this->_db.create_table("entry_points",
+                         {{"id", sqlite::DbColumnType::Integer},
+                          {"name", sqlite::DbColumnType::Text},
+                          {"hash", sqlite::DbColumnType::Text}});
+  this->_db.create_table("entry_point_checks",
+                         {{"entry_point_id", sqlite::DbColumnType::Integer},
+                          {"function", sqlite::DbColumnType::Text},
+                          {"call_context", sqlite::DbColumnType::Text},
+                          {"kind", sqlite::DbColumnType::Integer},
+                          {"checker", sqlite::DbColumnType::Integer},
+                          {"status", sqlite::DbColumnType::Integer},
+                          {"block", sqlite::DbColumnType::Integer},
+                          {"statement", sqlite::DbColumnType::Integer},
+                          {"operands", sqlite::DbColumnType::Text},
+                          {"info", sqlite::DbColumnType::Text}});
+
+  // Check the analysis options
+  {
+    sqlite::DbIstream in(this->_db, "SELECT value FROM config");
+    if (in.empty()) {
+      return;
+    }
+    std::string config;
+    in >> config;
+    if (config != this->_config) {
+      return;
+    }
+  }
+
+  // Load functions
+  llvm::DenseMap< sqlite::DbInt64, Entry* > functions;
+  {
+    sqlite::DbIstream in(this->_db, "SELECT id, name, hash FROM functions");
+    while (!in.empty()) {
+      sqlite::DbInt64 id;
+      std::string name;
+      std::string hash;
+      in >> id >> name >> hash;
+      Entry& entry = this->_old_entries[name];
+      entry.hash = std::move(hash);
+      functions[id] = &entry;
+    }
+  }
+
+  // Load checks
+  {
+    sqlite::DbIstream in(this->_db,
+                         "SELECT function_id, kind, checker, status, block, "
+                         "statement, operands, info FROM checks");
+    while (!in.empty()) {
+      sqlite::DbInt64 function_id;
+      Check check;
+      std::string operands;
+      in >> function_id >> check.kind >> check.checker >> check.status >>
+          check.block >> check.statement >> operands >> check.info;
+      check.operands = parse_operands(operands);
+
+      auto it = functions.find(function_id);
+      if (it != functions.end()) {
+        it->second->checks.push_back(std::move(check));
+      }
+    }
+  }
+
+  // Load entry points
+  llvm::DenseMap< sqlite::DbInt64, Entry* > entry_points;
+  {
+    sqlite::DbIstream in(this->_db, "SELECT id, name, hash FROM entry_points");
+    while (!in.empty()) {
+      sqlite::DbInt64 id;
+      std::string name;
+      std::string hash;
+      in >> id >> name >> hash;
+      Entry& entry = this->_old_entry_points[name];
+      entry.hash = std::move(hash);
+      entry_points[id] = &entry;
+    }
+  }
+
+  // Load checks of entry points
+  {
+    sqlite::DbIstream in(this->_db,
+                         "SELECT entry_point_id, function, call_context, "
+                         "kind, checker, status, block, statement, operands, "
+                         "info FROM entry_point_checks");
+    while (!in.empty()) {
+      sqlite::DbInt64 entry_point_id;
+      Check check;
+      std::string operands;
+      in >> entry_point_id >> check.function >> check.call_context >>
+          check.kind >> check.checker >> check.status >> check.block >>
+          check.statement >> operands >> check.info;
+      check.operands = parse_operands(operands);
+
+      auto it = entry_points.find(entry_point_id);
+      if (it != entry_points.end()) {
+        it->second->checks.push_back(std::move(check));
+      }
+    }
+  }
+}
+
+FunctionCache::~FunctionCache() = default;
+
+std::string FunctionCache::hash(ar::Function* fun) {
+  return llvm::utohexstr(fun->hash());
+}
+
+bool FunctionCache::lookup(ar::Function* fun,
+                           CallContext* call_context,
+                           ChecksTable::Buffer& buffer) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
+  auto it = this->_old_entries.find(fun->name());
+  if (it == this->_old_entries.end() || !fun->is_definition()) {
+    return false;
+  }
+
+  const Entry& entry = it->second;
+  if (entry.hash != hash(fun)) {
+    return false;
+  }
+
+  // Index basic blocks
+  std::vector< ar::BasicBlock* > blocks(fun->body()->begin(),
+                                        fun->body()->end());
+
+  ChecksTable::Buffer checks;
+  for (const Check& check : entry.checks) {
+    if (check.block < 0 ||
+        static_cast< std::size_t >(check.block) >= blocks.size()) {
+      return false;
+    }
+    ar::BasicBlock* bb = blocks[static_cast< std::size_t >(check.block)];
+    if (check.statement < 0 ||
+        static_cast< std::size_t >(check.statement) >= bb->num_statements()) {
+      return false;
+    }
+    ar::Statement* stmt =
+        *std::next(bb->begin(), static_cast< std::ptrdiff_t >(check.statement));
+
+    llvm::SmallVector< ar::Value*, 2 > operands;
+    for (sqlite::DbInt64 operand_no : check.operands) {
+      if (operand_no < 0 ||
+          static_cast< std::size_t >(operand_no) >= stmt->num_operands()) {
+        return false;
+      }
+      operands.push_back(
+          stmt->operand(static_cast< std::size_t >(operand_no)));
+    }
+
+    checks.push_back(
+        ChecksTable::Check{static_cast< CheckKind >(check.kind),
+                           static_cast< CheckerName >(check.checker),
+                           static_cast< Result >(check.status),
+                           stmt,
+                           call_context,
+                           std::move(operands),
+                           check.info});
+  }
+
+  buffer.insert(buffer.end(),
+                std::make_move_iterator(checks.begin()),
+                std::make_move_iterator(checks.end()));
+  this->_new_entries[fun->name()] = entry;
+  return true;
+}
+
+void FunctionCache::record(ar::Function* fun,
+                           const ChecksTable::Buffer& buffer) {
+  Entry entry;
+  entry.hash = hash(fun);
+
+  // Index statements
+  llvm::DenseMap< ar::Statement*,
+                  std::pair< sqlite::DbInt64, sqlite::DbInt64 > >
+      positions;
+  sqlite::DbInt64 block_no = 0;
+  for (ar::BasicBlock* bb : *fun->body()) {
+    sqlite::DbInt64 stmt_no = 0;
+    for (ar::Statement* stmt : *bb) {
+      positions[stmt] = {block_no, stmt_no++};
+    }
+    block_no++;
+  }
+
+  for (const ChecksTable::Check& check : buffer) {
+    auto it = positions.find(check.stmt);
+    if (it == positions.end()) {
+      // Check on a statement of another function, cannot be cached
+      return;
+    }
+
+    Check c{static_cast< sqlite::DbInt64 >(check.kind),
+            static_cast< sqlite::DbInt64 >(check.checker),
+            static_cast< sqlite::DbInt64 >(check.status),
+            it->second.first,
+            it->second.second,
+            {},
+            check.info.str()};
+
+    for (ar::Value* operand : check.operands) {
+      auto op =
+          std::find(check.stmt->op_begin(), check.stmt->op_end(), operand);
+      if (op == check.stmt->op_end()) {
+        // Operand is not an operand of the statement, cannot be cached
+        return;
+      }
+      c.operands.push_back(
+          static_cast< sqlite::DbInt64 >(op - check.stmt->op_begin()));
+    }
+
+    entry.checks.push_back(std::move(c));
+  }
+
+  std::lock_guard< std::mutex > lock(this->_mutex);
+  this->_new_entries[fun->name()] = std::move(entry);
+  this->checkpoint_if_due();
+}
+
+bool FunctionCache::lookup_entry_point(ar::Function* entry_point,
+                                       const std::string& hash,
+                                       CallContextFactory& factory,
+                                       ChecksTable::Buffer& buffer) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
+  auto it = this->_old_entry_points.find(entry_point->name());
+  if (it == this->_old_entry_points.end()) {
+    return false;
+  }
+
+  const Entry& entry = it->second;
+  if (entry.hash != hash) {
+    return false;
+  }
+
+  ar::Bundle* bundle = entry_point->bundle();
+  StatementIndex index;
+  ChecksTable::Buffer checks;
+  for (const Check& check : entry.checks) {
+    ar::Function* fun = bundle->function_or_null(check.function);
+    if (fun == nullptr || !fun->is_definition()) {
+      return false;
+    }
+
+    ar::Statement* stmt =
+        index.statement(fun->body(), check.block, check.statement);
+    if (stmt == nullptr) {
+      return false;
+    }
+
+    llvm::SmallVector< ar::Value*, 2 > operands;
+    for (sqlite::DbInt64 operand_no : check.operands) {
+      if (operand_no < 0 ||
+          static_cast< std::size_t >(operand_no) >= stmt->num_operands()) {
+        return false;
+      }
+      operands.push_back(
+          stmt->operand(static_cast< std::size_t >(operand_no)));
+    }
+
+    CallContext* call_context =
+        parse_call_context(check.call_context, bundle, index, factory);
+    if (call_context == nullptr) {
+      return false;
+    }
+
+    checks.push_back(
+        ChecksTable::Check{static_cast< CheckKind >(check.kind),
+                           static_cast< CheckerName >(check.checker),
+                           static_cast< Result >(check.status),
+                           stmt,
+                           call_context,
+                           std::move(operands),
+                           check.info});
+  }
+
+  buffer.insert(buffer.end(),
+                std::make_move_iterator(checks.begin()),
+                std::make_move_iterator(checks.end()));
+  this->_new_entry_points[entry_point->name()] = entry;
+  return true;
+}
+
+void FunctionCache::record_entry_point(ar::Function* entry_point,
+                                       const std::string& hash,
+                                       const ChecksTable::Buffer& buffer) {
+  Entry entry;
+  entry.hash = hash;
+
+  StatementIndex index;
+  for (const ChecksTable::Check& check : buffer) {
+    ar::Function* fun = check.stmt->code()->function();
+    if (fun == nullptr) {
+      // Check on a global variable initializer, cannot be cached
+      return;
+    }
+
+    StatementIndex::Position pos = index.position(check.stmt);
+    Check c{static_cast< sqlite::DbInt64 >(check.kind),
+            static_cast< sqlite::DbInt64 >(check.checker),
+            static_cast< sqlite::DbInt64 >(check.status),
+            pos.first,
+            pos.second,
+            {},
+            check.info.str(),
+            fun->name(),
+            {}};
+
+    for (ar::Value* operand : check.operands) {
+      auto op =
+          std::find(check.stmt->op_begin(), check.stmt->op_end(), operand);
+      if (op == check.stmt->op_end()) {
+        // Operand is not an operand of the statement, cannot be cached
+        return;
+      }
+      c.operands.push_back(
+          static_cast< sqlite::DbInt64 >(op - check.stmt->op_begin()));
+    }
+
+    if (!serialize_call_context(check.call_context, index, c.call_context)) {
+      return;
+    }
+
+    entry.checks.push_back(std::move(c));
+  }
+
+  std::lock_guard< std::mutex > lock(this->_mutex);
+  this->_new_entry_points[entry_point->name()] = std::move(entry);
+  this->checkpoint_if_due();
+}
+
+void FunctionCache::enable_checkpoints(std::chrono::seconds interval) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
+  this->_checkpoint_interval = interval;
+  this->_last_checkpoint = std::chrono::steady_clock::now();
+}
+
+void FunctionCache::save() {
+  std::lock_guard< std::mutex > lock(this->_mutex);
+  this->write(/*keep_old_entries=*/false);
+}
+
+void FunctionCache::checkpoint_if_due() {
+  if (this->_checkpoint_interval.count() == 0) {
+    return;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  if (now - this->_last_checkpoint < this->_checkpoint_interval) {
+    return;
+  }
+
+  log::debug("Writing checkpoint");
+  this->write(/*keep_old_entries=*/true);
+  this->_last_checkpoint = std::chrono::steady_clock::now();
+}
+
+void FunctionCache::write(bool keep_old_entries) {
+  this->_db.exec_command("DELETE FROM config");
+  this->_db.exec_command("DELETE FROM functions");
+  this->_db.exec_command("DELETE FROM checks");
+  this->_db.exec_command("DELETE FROM entry_points");
+  this->_db.exec_command("DELETE FROM entry_point_checks");
+
+  this->_db.set_commit_policy(sqlite::CommitPolicy::Auto);
+
+  {
+    sqlite::DbOstream row(this->_db, "config", 1);
+    row << this->_config << sqlite::end_row;
+  }
+
+  {
+    sqlite::DbOstream function_row(this->_db, "functions", 3);
+    sqlite::DbOstream check_row(this->_db, "checks", 8);
+    sqlite::DbInt64 id = 0;
+    auto write_function = [&](llvm::StringRef name, const Entry& entry) {
+      function_row << id << to_string_ref(name) << entry.hash
+                   << sqlite::end_row;
+
+      for (const Check& check : entry.checks) {
+        check_row << id << check.kind << check.checker << check.status
+                  << check.block << check.statement
+                  << join_operands(check.operands) << check.info
+                  << sqlite::end_row;
+      }
+
+      id++;
+    };
+
+    for (const auto& entry : this->_new_entries) {
+      write_function(entry.first(), entry.second);
+    }
+    if (keep_old_entries) {
+      for (const auto& entry : this->_old_entries) {
+        if (this->_new_entries.count(entry.first()) == 0) {
+          write_function(entry.first(), entry.second);
+        }
+      }
+    }
+  }
+
+  {
+    sqlite::DbOstream entry_point_row(this->_db, "entry_points", 3);
+    sqlite::DbOstream entry_point_check_row(this->_db,
+                                            "entry_point_checks",
+                                            10);
+    sqlite::DbInt64 id = 0;
+    auto write_entry_point = [&](llvm::StringRef name, const Entry& entry) {
+      entry_point_row << id << to_string_ref(name) << entry.hash
+                      << sqlite::end_row;
+
+      for (const Check& check : entry.checks) {
+        entry_point_check_row << id << check.function << check.call_context
+                              << check.kind << check.checker << check.status
+                              << check.block << check.statement
+                              << join_operands(check.operands) << check.info
+                              << sqlite::end_row;
+      }
+
+      id++;
+    };
+
+    for (const auto& entry : this->_new_entry_points) {
+      write_entry_point(entry.first(), entry.second);
+    }
+    if (keep_old_entries) {
+      for (const auto& entry : this->_old_entry_points) {
+        if (this->_new_entry_points.count(entry.first()) == 0) {
+          write_entry_point(entry.first(), entry.second);
+        }
+      }
+    }
+  }
+
+  this->_db.set_commit_policy(sqlite::CommitPolicy::Manual);
+}
+
+} // end namespace analyzer
+} // end namespace ikos
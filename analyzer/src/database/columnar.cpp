@@ -0,0 +1,151 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implement columnar output files
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2011-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <cstring>
+#include <limits>
+
+#include <sqlite3.h>
+
+#include <ikos/analyzer/database/columnar.hpp>
+#include <ikos/analyzer/database/sqlite.hpp>
+#include <ikos/analyzer/support/assert.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace columnar {
+
+/// \brief Write an unsigned integer in little endian
+template < typename T >
+static void write_le(std::ofstream& o, T n) {
+  char bytes[sizeof(T)];
+  for (std::size_t i = 0; i < sizeof(T); i++) {
+    bytes[i] = static_cast< char >((n >> (8 * i)) & 0xff);
+  }
+  o.write(bytes, sizeof(T));
+}
+
+TableWriter::TableWriter(const std::string& directory,
+                         StringRef table_name,
+                         int columns)
+    : _table_name(table_name.to_string()) {
+  ikos_assert_msg(columns > 0, "invalid number of columns");
+
+  for (int i = 0; i < columns; i++) {
+    std::string prefix =
+        directory + "/" + this->_table_name + "." + std::to_string(i);
+    auto column = std::make_unique< Column >();
+    column->tags.open(prefix + ".tag", std::ios::binary | std::ios::trunc);
+    column->values.open(prefix + ".val", std::ios::binary | std::ios::trunc);
+    column->texts.open(prefix + ".txt", std::ios::binary | std::ios::trunc);
+    if (!column->tags || !column->values || !column->texts) {
+      throw sqlite::DbError(SQLITE_CANTOPEN,
+                            "TableWriter: cannot open columnar files " +
+                                prefix);
+    }
+    this->_columns.push_back(std::move(column));
+  }
+}
+
+TableWriter::~TableWriter() = default;
+
+TableWriter::Column& TableWriter::next_column() {
+  ikos_assert_msg(this->_current_column < this->_columns.size(),
+                  "too many columns");
+  return *this->_columns[this->_current_column++];
+}
+
+void TableWriter::write(Column& column, Tag tag, std::uint64_t value) {
+  column.tags.put(static_cast< char >(tag));
+  write_le(column.values, value);
+}
+
+void TableWriter::add(StringRef s) {
+  this->add_text(Tag::Text, s);
+}
+
+void TableWriter::add_blob(StringRef b) {
+  this->add_text(Tag::Blob, b);
+}
+
+void TableWriter::add_text(Tag tag, StringRef s) {
+  ikos_assert(s.size() <= std::numeric_limits< std::uint32_t >::max());
+
+  Column& column = this->next_column();
+  write(column, tag, column.texts_size);
+  write_le(column.texts, static_cast< std::uint32_t >(s.size()));
+  column.texts.write(s.data(), static_cast< std::streamsize >(s.size()));
+  column.texts_size += sizeof(std::uint32_t) + s.size();
+}
+
+void TableWriter::add_null() {
+  write(this->next_column(), Tag::Null, 0);
+}
+
+void TableWriter::add(std::int64_t n) {
+  write(this->next_column(), Tag::Integer, static_cast< std::uint64_t >(n));
+}
+
+void TableWriter::add(double d) {
+  std::uint64_t n;
+  static_assert(sizeof(n) == sizeof(d), "unexpected size of double");
+  std::memcpy(&n, &d, sizeof(n));
+  write(this->next_column(), Tag::Real, n);
+}
+
+void TableWriter::end_row() {
+  ikos_assert_msg(this->_current_column == this->_columns.size(),
+                  "incomplete row");
+  this->_current_column = 0;
+
+  for (const auto& column : this->_columns) {
+    if (!column->tags || !column->values || !column->texts) {
+      throw sqlite::DbError(SQLITE_IOERR,
+                            "TableWriter: cannot write columnar files of " +
+                                this->_table_name);
+    }
+  }
+}
+
+} // end namespace columnar
+} // end namespace analyzer
+} // end namespace ikos
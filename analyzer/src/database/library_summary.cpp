@@ -0,0 +1,218 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Summaries of library functions, reused across analyses
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/FileSystem.h>
+
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+
+#include <ikos/analyzer/database/library_summary.hpp>
+#include <ikos/analyzer/database/sqlite.hpp>
+#include <ikos/analyzer/exception.hpp>
+#include <ikos/analyzer/support/cast.hpp>
+#include <ikos/analyzer/support/string_ref.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+/// \brief Create the tables of a summary package
+void create_tables(sqlite::DbConnection& db) {
+  db.create_table("info",
+                  {{"key", sqlite::DbColumnType::Text},
+                   {"value", sqlite::DbColumnType::Text}});
+  db.create_table("summaries",
+                  {{"name", sqlite::DbColumnType::Text},
+                   {"hash", sqlite::DbColumnType::Text},
+                   {"returns", sqlite::DbColumnType::Integer},
+                   {"writes_memory", sqlite::DbColumnType::Integer},
+                   {"may_throw", sqlite::DbColumnType::Integer},
+                   {"return_lb", sqlite::DbColumnType::Text},
+                   {"return_ub", sqlite::DbColumnType::Text}});
+}
+
+/// \brief Serialize an optional bound, as an empty string if unknown
+std::string bound_str(const boost::optional< core::ZNumber >& n) {
+  return n ? n->str() : std::string();
+}
+
+/// \brief Parse an optional bound serialized by bound_str()
+boost::optional< core::ZNumber > parse_bound(const std::string& s) {
+  if (s.empty()) {
+    return boost::none;
+  }
+  return core::ZNumber::from_string(s);
+}
+
+} // end anonymous namespace
+
+LibrarySummaries::LibrarySummaries() = default;
+
+LibrarySummaries::~LibrarySummaries() = default;
+
+void LibrarySummaries::load(const std::string& filename) {
+  if (!llvm::sys::fs::exists(filename)) {
+    throw ArgumentError("summary package '" + filename + "' does not exist");
+  }
+
+  sqlite::DbConnection db(filename);
+  create_tables(db);
+
+  // Check the format version
+  {
+    sqlite::DbIstream in(db, "SELECT value FROM info WHERE key = 'format'");
+    std::string format;
+    if (!in.empty()) {
+      in >> format;
+    }
+    if (format != std::to_string(FormatVersion)) {
+      throw ArgumentError("'" + filename +
+                          "' is not a summary package of format version " +
+                          std::to_string(FormatVersion));
+    }
+  }
+
+  sqlite::DbIstream in(db,
+                       "SELECT name, hash, returns, writes_memory, may_throw, "
+                       "return_lb, return_ub FROM summaries");
+  std::lock_guard< std::mutex > lock(this->_mutex);
+  while (!in.empty()) {
+    std::string name;
+    Entry entry;
+    sqlite::DbInt64 returns;
+    sqlite::DbInt64 writes_memory;
+    sqlite::DbInt64 may_throw;
+    std::string return_lb;
+    std::string return_ub;
+    in >> name >> entry.hash >> returns >> writes_memory >> may_throw >>
+        return_lb >> return_ub;
+    entry.summary.returns = returns != 0;
+    entry.summary.writes_memory = writes_memory != 0;
+    entry.summary.may_throw = may_throw != 0;
+    entry.summary.return_lb = parse_bound(return_lb);
+    entry.summary.return_ub = parse_bound(return_ub);
+    this->_entries[name] = std::move(entry);
+  }
+}
+
+void LibrarySummaries::save(const std::string& filename) const {
+  sqlite::DbConnection db(filename);
+  db.set_journal_mode(sqlite::JournalMode::Off);
+  db.set_synchronous_flag(sqlite::SynchronousFlag::Off);
+  db.drop_table("info");
+  db.drop_table("summaries");
+  create_tables(db);
+  db.set_commit_policy(sqlite::CommitPolicy::Auto);
+
+  {
+    sqlite::DbOstream row(db, "info", 2);
+    row << "format" << std::to_string(FormatVersion) << sqlite::end_row;
+  }
+
+  {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    sqlite::DbOstream row(db, "summaries", 7);
+    for (const auto& entry : this->_entries) {
+      const LibrarySummary& summary = entry.second.summary;
+      row << to_string_ref(entry.first()) << entry.second.hash
+          << static_cast< sqlite::DbInt64 >(summary.returns)
+          << static_cast< sqlite::DbInt64 >(summary.writes_memory)
+          << static_cast< sqlite::DbInt64 >(summary.may_throw)
+          << bound_str(summary.return_lb) << bound_str(summary.return_ub)
+          << sqlite::end_row;
+    }
+  }
+
+  db.set_commit_policy(sqlite::CommitPolicy::Manual);
+}
+
+std::size_t LibrarySummaries::size() const {
+  std::lock_guard< std::mutex > lock(this->_mutex);
+  return this->_entries.size();
+}
+
+const LibrarySummary* LibrarySummaries::lookup(ar::Function* fun) const {
+  if (!fun->is_definition()) {
+    return nullptr;
+  }
+
+  std::lock_guard< std::mutex > lock(this->_mutex);
+  auto it = this->_entries.find(fun->name());
+  if (it == this->_entries.end() ||
+      it->second.hash != llvm::utohexstr(fun->hash())) {
+    return nullptr;
+  }
+  return &it->second.summary;
+}
+
+void LibrarySummaries::record(ar::Function* fun,
+                              bool returns,
+                              boost::optional< core::ZNumber > return_lb,
+                              boost::optional< core::ZNumber > return_ub) {
+  Entry entry;
+  entry.hash = llvm::utohexstr(fun->hash());
+  entry.summary.returns = returns;
+  entry.summary.writes_memory = false;
+  entry.summary.may_throw = false;
+  entry.summary.return_lb = std::move(return_lb);
+  entry.summary.return_ub = std::move(return_ub);
+
+  for (ar::BasicBlock* bb : *fun->body()) {
+    for (ar::Statement* stmt : *bb) {
+      if (isa< ar::Store >(stmt) || isa< ar::CallBase >(stmt)) {
+        entry.summary.writes_memory = true;
+      }
+      if (isa< ar::CallBase >(stmt) || isa< ar::Resume >(stmt)) {
+        entry.summary.may_throw = true;
+      }
+    }
+  }
+
+  std::lock_guard< std::mutex > lock(this->_mutex);
+  this->_entries[fun->name()] = std::move(entry);
+}
+
+} // end namespace analyzer
+} // end namespace ikos
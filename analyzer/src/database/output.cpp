@@ -46,7 +46,7 @@
 namespace ikos {
 namespace analyzer {
 
-OutputDatabase::OutputDatabase(sqlite::DbConnection& db_)
+OutputDatabase::OutputDatabase(sqlite::DbConnection& db_, bool defer_indexes)
     : db(db_),
       settings(db_),
       times(db_),
@@ -56,9 +56,32 @@ OutputDatabase::OutputDatabase(sqlite::DbConnection& db_)
       operands(db_),
       call_contexts(db_, functions, statements),
       memory_locations(db_, functions, statements, call_contexts),
-      checks(db_, statements, operands, call_contexts) {
+      checks(db_, statements, operands, call_contexts),
+      budgets(db_, functions, call_contexts),
+      fixpoints(db_, functions, statements, call_contexts),
+      transfer_functions(db_, functions, call_contexts),
+      state_sizes(db_, functions, call_contexts) {
+  if (!defer_indexes) {
+    this->create_indexes();
+  }
   this->db.set_commit_policy(sqlite::CommitPolicy::Auto);
 }
 
+void OutputDatabase::create_indexes() {
+  this->settings.create_indexes();
+  this->times.create_indexes();
+  this->files.create_indexes();
+  this->functions.create_indexes();
+  this->statements.create_indexes();
+  this->operands.create_indexes();
+  this->call_contexts.create_indexes();
+  this->memory_locations.create_indexes();
+  this->checks.create_indexes();
+  this->budgets.create_indexes();
+  this->fixpoints.create_indexes();
+  this->transfer_functions.create_indexes();
+  this->state_sizes.create_indexes();
+}
+
 } // end namespace analyzer
 } // end namespace ikos
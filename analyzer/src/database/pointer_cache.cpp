@@ -0,0 +1,597 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Persistent cache of the pointer analyses results
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <array>
+#include <vector>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/StringExtras.h>
+
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/function.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+
+#include <ikos/analyzer/database/pointer_cache.hpp>
+#include <ikos/analyzer/support/cast.hpp>
+#include <ikos/analyzer/support/string_ref.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+/// \brief Positions of the variables and statements, built on demand
+class PositionIndex {
+public:
+  /// \brief Basic block number and statement number in the block
+  using StatementPosition = std::pair< std::size_t, std::size_t >;
+
+private:
+  /// \brief Internal variables of each code
+  llvm::DenseMap< ar::Code*, std::vector< ar::InternalVariable* > >
+      _internal_vars;
+
+  /// \brief Local variables of each function
+  llvm::DenseMap< ar::Function*, std::vector< ar::LocalVariable* > >
+      _local_vars;
+
+  /// \brief Statements of each basic block, per code
+  llvm::DenseMap< ar::Code*, std::vector< std::vector< ar::Statement* > > >
+      _statements;
+
+  /// \brief Positions of the internal and local variables
+  llvm::DenseMap< ar::Value*, std::size_t > _var_positions;
+
+  /// \brief Positions of the statements
+  llvm::DenseMap< ar::Statement*, StatementPosition > _stmt_positions;
+
+public:
+  /// \brief Return the position of an internal variable in its code
+  std::size_t position(ar::InternalVariable* var) {
+    this->internal_vars(var->code());
+    return this->_var_positions[var];
+  }
+
+  /// \brief Return the position of a local variable in its function
+  std::size_t position(ar::LocalVariable* var) {
+    this->local_vars(var->function());
+    return this->_var_positions[var];
+  }
+
+  /// \brief Return the position of a statement in its code
+  StatementPosition position(ar::Statement* stmt) {
+    this->statements(stmt->code());
+    return this->_stmt_positions[stmt];
+  }
+
+  /// \brief Return the internal variable at the given position, or null
+  ar::InternalVariable* internal_var(ar::Code* code, std::size_t pos) {
+    const auto& vars = this->internal_vars(code);
+    return pos < vars.size() ? vars[pos] : nullptr;
+  }
+
+  /// \brief Return the local variable at the given position, or null
+  ar::LocalVariable* local_var(ar::Function* fun, std::size_t pos) {
+    const auto& vars = this->local_vars(fun);
+    return pos < vars.size() ? vars[pos] : nullptr;
+  }
+
+  /// \brief Return the statement at the given position, or null
+  ar::Statement* statement(ar::Code* code, StatementPosition pos) {
+    const auto& blocks = this->statements(code);
+    if (pos.first >= blocks.size()) {
+      return nullptr;
+    }
+    const auto& stmts = blocks[pos.first];
+    return pos.second < stmts.size() ? stmts[pos.second] : nullptr;
+  }
+
+private:
+  /// \brief Index the internal variables of the given code
+  const std::vector< ar::InternalVariable* >& internal_vars(ar::Code* code) {
+    auto it = this->_internal_vars.find(code);
+    if (it != this->_internal_vars.end()) {
+      return it->second;
+    }
+
+    std::vector< ar::InternalVariable* > vars(code->internal_variable_begin(),
+                                              code->internal_variable_end());
+    for (std::size_t i = 0; i < vars.size(); i++) {
+      this->_var_positions[vars[i]] = i;
+    }
+    return this->_internal_vars[code] = std::move(vars);
+  }
+
+  /// \brief Index the local variables of the given function
+  const std::vector< ar::LocalVariable* >& local_vars(ar::Function* fun) {
+    auto it = this->_local_vars.find(fun);
+    if (it != this->_local_vars.end()) {
+      return it->second;
+    }
+
+    std::vector< ar::LocalVariable* > vars;
+    if (fun->is_definition()) {
+      vars.assign(fun->local_variable_begin(), fun->local_variable_end());
+    }
+    for (std::size_t i = 0; i < vars.size(); i++) {
+      this->_var_positions[vars[i]] = i;
+    }
+    return this->_local_vars[fun] = std::move(vars);
+  }
+
+  /// \brief Index the statements of the given code
+  const std::vector< std::vector< ar::Statement* > >& statements(
+      ar::Code* code) {
+    auto it = this->_statements.find(code);
+    if (it != this->_statements.end()) {
+      return it->second;
+    }
+
+    std::vector< std::vector< ar::Statement* > > blocks;
+    std::size_t block_no = 0;
+    for (ar::BasicBlock* bb : *code) {
+      blocks.emplace_back(bb->begin(), bb->end());
+      std::size_t stmt_no = 0;
+      for (ar::Statement* stmt : *bb) {
+        this->_stmt_positions[stmt] = {block_no, stmt_no++};
+      }
+      block_no++;
+    }
+    return this->_statements[code] = std::move(blocks);
+  }
+
+}; // end class PositionIndex
+
+/// \brief Serialize the owner of a code, `f<function>` or `g<global>`
+std::string code_str(ar::Code* code) {
+  if (code->is_function_body()) {
+    return "f" + code->function()->name();
+  } else {
+    return "g" + code->global_var()->name();
+  }
+}
+
+/// \brief Parse a code serialized by code_str(), or return null
+ar::Code* parse_code(llvm::StringRef s, ar::Bundle* bundle) {
+  if (s.startswith("f")) {
+    ar::Function* fun = bundle->function_or_null(s.drop_front().str());
+    if (fun != nullptr && fun->is_definition()) {
+      return fun->body();
+    }
+  } else if (s.startswith("g")) {
+    ar::GlobalVariable* gv = bundle->global_or_null(s.drop_front().str());
+    if (gv != nullptr && gv->is_definition()) {
+      return gv->initializer();
+    }
+  }
+  return nullptr;
+}
+
+/// \brief Parse a position, return false on error
+bool parse_position(llvm::StringRef s, std::size_t& pos) {
+  unsigned long long n = 0;
+  if (s.getAsInteger(10, n)) {
+    return false;
+  }
+  pos = static_cast< std::size_t >(n);
+  return true;
+}
+
+/// \brief Serialize a variable as `<kind><position>:<owner>`
+///
+/// Return false if the variable cannot be serialized.
+bool serialize_variable(Variable* v, PositionIndex& index, std::string& out) {
+  if (auto iv = dyn_cast< InternalVariable >(v)) {
+    ar::InternalVariable* var = iv->internal_var();
+    out = "i" + std::to_string(index.position(var)) + ":" +
+          code_str(var->code());
+  } else if (auto lv = dyn_cast< LocalVariable >(v)) {
+    ar::LocalVariable* var = lv->local_var();
+    out = "l" + std::to_string(index.position(var)) + ":" +
+          var->function()->name();
+  } else if (auto gv = dyn_cast< GlobalVariable >(v)) {
+    out = "g:" + gv->global_var()->name();
+  } else if (auto fv = dyn_cast< FunctionPointerVariable >(v)) {
+    out = "f:" + fv->function()->name();
+  } else if (auto rv = dyn_cast< ReturnVariable >(v)) {
+    out = "r:" + rv->function()->name();
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/// \brief Parse a variable serialized by serialize_variable(), or return null
+Variable* parse_variable(llvm::StringRef s,
+                         Context& ctx,
+                         PositionIndex& index) {
+  auto split = s.split(':');
+  llvm::StringRef kind = split.first.take_front();
+  std::string name = split.second.str();
+  std::size_t pos = 0;
+
+  if (kind == "i") {
+    ar::Code* code = parse_code(split.second, ctx.bundle);
+    if (code == nullptr || !parse_position(split.first.drop_front(), pos)) {
+      return nullptr;
+    }
+    ar::InternalVariable* var = index.internal_var(code, pos);
+    return var != nullptr ? ctx.var_factory->get_internal(var) : nullptr;
+  } else if (kind == "l") {
+    ar::Function* fun = ctx.bundle->function_or_null(name);
+    if (fun == nullptr || !parse_position(split.first.drop_front(), pos)) {
+      return nullptr;
+    }
+    ar::LocalVariable* var = index.local_var(fun, pos);
+    return var != nullptr ? ctx.var_factory->get_local(var) : nullptr;
+  } else if (kind == "g") {
+    ar::GlobalVariable* gv = ctx.bundle->global_or_null(name);
+    return gv != nullptr ? ctx.var_factory->get_global(gv) : nullptr;
+  } else if (kind == "f") {
+    ar::Function* fun = ctx.bundle->function_or_null(name);
+    return fun != nullptr ? ctx.var_factory->get_function_ptr(fun) : nullptr;
+  } else if (kind == "r") {
+    ar::Function* fun = ctx.bundle->function_or_null(name);
+    return fun != nullptr ? ctx.var_factory->get_return(fun) : nullptr;
+  }
+  return nullptr;
+}
+
+/// \brief Serialize a memory location as `<kind><position>:<owner>`
+///
+/// Return false if the memory location cannot be serialized.
+bool serialize_memory_location(MemoryLocation* m,
+                               PositionIndex& index,
+                               std::string& out) {
+  if (auto lm = dyn_cast< LocalMemoryLocation >(m)) {
+    ar::LocalVariable* var = lm->local_var();
+    out = "l" + std::to_string(index.position(var)) + ":" +
+          var->function()->name();
+  } else if (auto gm = dyn_cast< GlobalMemoryLocation >(m)) {
+    out = "g:" + gm->global_var()->name();
+  } else if (auto fm = dyn_cast< FunctionMemoryLocation >(m)) {
+    out = "f:" + fm->function()->name();
+  } else if (auto am = dyn_cast< AggregateMemoryLocation >(m)) {
+    ar::InternalVariable* var = am->internal_var();
+    out = "a" + std::to_string(index.position(var)) + ":" +
+          code_str(var->code());
+  } else if (auto vm = dyn_cast< VaArgMemoryLocation >(m)) {
+    out = "v:" + vm->shadow_var();
+  } else if (isa< AbsoluteZeroMemoryLocation >(m)) {
+    out = "z:";
+  } else if (isa< ArgvMemoryLocation >(m)) {
+    out = "A:";
+  } else if (auto dm = dyn_cast< DynAllocMemoryLocation >(m)) {
+    if (!dm->context()->empty()) {
+      return false;
+    }
+    PositionIndex::StatementPosition pos = index.position(dm->call());
+    out = "d" + std::to_string(pos.first) + "." + std::to_string(pos.second) +
+          ":" + code_str(dm->call()->code());
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/// \brief Parse a memory location serialized by serialize_memory_location(),
+/// or return null
+MemoryLocation* parse_memory_location(llvm::StringRef s,
+                                      Context& ctx,
+                                      PositionIndex& index) {
+  auto split = s.split(':');
+  llvm::StringRef kind = split.first.take_front();
+  std::string name = split.second.str();
+  std::size_t pos = 0;
+
+  if (kind == "l") {
+    ar::Function* fun = ctx.bundle->function_or_null(name);
+    if (fun == nullptr || !parse_position(split.first.drop_front(), pos)) {
+      return nullptr;
+    }
+    ar::LocalVariable* var = index.local_var(fun, pos);
+    return var != nullptr ? ctx.mem_factory->get_local(var) : nullptr;
+  } else if (kind == "g") {
+    ar::GlobalVariable* gv = ctx.bundle->global_or_null(name);
+    return gv != nullptr ? ctx.mem_factory->get_global(gv) : nullptr;
+  } else if (kind == "f") {
+    ar::Function* fun = ctx.bundle->function_or_null(name);
+    return fun != nullptr ? ctx.mem_factory->get_function(fun) : nullptr;
+  } else if (kind == "a") {
+    ar::Code* code = parse_code(split.second, ctx.bundle);
+    if (code == nullptr || !parse_position(split.first.drop_front(), pos)) {
+      return nullptr;
+    }
+    ar::InternalVariable* var = index.internal_var(code, pos);
+    return var != nullptr ? ctx.mem_factory->get_aggregate(var) : nullptr;
+  } else if (kind == "v") {
+    return ctx.mem_factory->get_va_arg(split.second);
+  } else if (kind == "z") {
+    return ctx.mem_factory->get_absolute_zero();
+  } else if (kind == "A") {
+    return ctx.mem_factory->get_argv();
+  } else if (kind == "d") {
+    ar::Code* code = parse_code(split.second, ctx.bundle);
+    auto stmt_split = split.first.drop_front().split('.');
+    PositionIndex::StatementPosition stmt_pos;
+    if (code == nullptr || !parse_position(stmt_split.first, stmt_pos.first) ||
+        !parse_position(stmt_split.second, stmt_pos.second)) {
+      return nullptr;
+    }
+    auto call = dyn_cast_or_null< ar::CallBase >(
+        index.statement(code, stmt_pos));
+    if (call == nullptr) {
+      return nullptr;
+    }
+    return ctx.mem_factory->get_dyn_alloc(call,
+                                          ctx.call_context_factory
+                                              ->get_empty());
+  }
+  return nullptr;
+}
+
+/// \brief Serialize a nullity value
+sqlite::DbInt64 nullity_int(const core::Nullity& n) {
+  return n.is_bottom() ? 0 : (n.is_null() ? 1 : (n.is_non_null() ? 2 : 3));
+}
+
+/// \brief Parse a nullity value serialized by nullity_int()
+core::Nullity parse_nullity(sqlite::DbInt64 n) {
+  switch (n) {
+    case 0:
+      return core::Nullity::bottom();
+    case 1:
+      return core::Nullity::null();
+    case 2:
+      return core::Nullity::non_null();
+    default:
+      return core::Nullity::top();
+  }
+}
+
+/// \brief Serialize an uninitialized value
+sqlite::DbInt64 uninitialized_int(const core::Uninitialized& u) {
+  return u.is_bottom() ? 0
+                       : (u.is_initialized()
+                              ? 1
+                              : (u.is_uninitialized() ? 2 : 3));
+}
+
+/// \brief Parse an uninitialized value serialized by uninitialized_int()
+core::Uninitialized parse_uninitialized(sqlite::DbInt64 n) {
+  switch (n) {
+    case 0:
+      return core::Uninitialized::bottom();
+    case 1:
+      return core::Uninitialized::initialized();
+    case 2:
+      return core::Uninitialized::uninitialized();
+    default:
+      return core::Uninitialized::top();
+  }
+}
+
+/// \brief Serialize an offset interval as `bit-width:sign:lb:ub`
+std::string interval_str(const MachineIntInterval& i) {
+  return std::to_string(i.bit_width()) + ":" +
+         (i.sign() == Signed ? "s" : "u") + ":" + i.lb().str() + ":" +
+         i.ub().str();
+}
+
+/// \brief Parse an offset interval serialized by interval_str()
+///
+/// Return false on error.
+bool parse_interval(llvm::StringRef s, MachineIntInterval& i) {
+  llvm::SmallVector< llvm::StringRef, 4 > parts;
+  s.split(parts, ':');
+  unsigned bit_width = 0;
+  if (parts.size() != 4 || parts[0].getAsInteger(10, bit_width) ||
+      bit_width == 0 || (parts[1] != "s" && parts[1] != "u")) {
+    return false;
+  }
+  Signedness sign = parts[1] == "s" ? Signed : Unsigned;
+  try {
+    i = MachineIntInterval(MachineInt(ZNumber::from_string(parts[2].str()),
+                                      bit_width,
+                                      sign),
+                           MachineInt(ZNumber::from_string(parts[3].str()),
+                                      bit_width,
+                                      sign));
+  } catch (const core::NumberError&) {
+    return false;
+  }
+  return true;
+}
+
+} // end anonymous namespace
+
+PointerCache::PointerCache(std::string filename, Context& ctx)
+    : _db(std::move(filename)), _ctx(ctx) {
+  this->_db.set_journal_mode(sqlite::JournalMode::Off);
+  this->_db.set_synchronous_flag(sqlite::SynchronousFlag::Off);
+  this->_db.create_table("config", {{"value", sqlite::DbColumnType::Text}});
+  this->_db.create_table("results",
+                         {{"analysis", sqlite::DbColumnType::Text},
+                          {"variable", sqlite::DbColumnType::Text},
+                          {"nullity", sqlite::DbColumnType::Integer},
+                          {"uninitialized", sqlite::DbColumnType::Integer},
+                          {"offset", sqlite::DbColumnType::Text},
+                          {"points_to", sqlite::DbColumnType::Text}});
+
+  this->_config = llvm::utohexstr(ctx.bundle->hash()) +
+                  (ctx.opts.use_liveness ? ";liveness" : ";no-liveness");
+
+  sqlite::DbIstream in(this->_db, "SELECT value FROM config");
+  if (!in.empty()) {
+    std::string config;
+    in >> config;
+    this->_valid = (config == this->_config);
+  }
+}
+
+PointerCache::~PointerCache() = default;
+
+bool PointerCache::load(const std::string& analysis, PointerInfo& info) {
+  if (!this->_valid) {
+    return false;
+  }
+
+  PositionIndex index;
+  bool found = false;
+  sqlite::DbIstream in(this->_db,
+                       "SELECT variable, nullity, uninitialized, offset, "
+                       "points_to FROM results WHERE analysis = '" +
+                           analysis + "'");
+  while (!in.empty()) {
+    std::string variable;
+    sqlite::DbInt64 nullity = 0;
+    sqlite::DbInt64 uninitialized = 0;
+    std::string offset;
+    std::string points_to;
+    in >> variable >> nullity >> uninitialized >> offset >> points_to;
+    found = true;
+
+    Variable* v = parse_variable(variable, this->_ctx, index);
+    MachineIntInterval interval = MachineIntInterval::top();
+    if (v == nullptr || !parse_interval(offset, interval)) {
+      info.clear();
+      return false;
+    }
+
+    PointsToSet set = PointsToSet::empty();
+    if (points_to == "top") {
+      set = PointsToSet::top();
+    } else if (points_to == "bottom") {
+      set = PointsToSet::bottom();
+    } else {
+      llvm::SmallVector< llvm::StringRef, 4 > keys;
+      llvm::StringRef(points_to).split(keys,
+                                       '\n',
+                                       /*MaxSplit=*/-1,
+                                       /*KeepEmpty=*/false);
+      for (llvm::StringRef key : keys) {
+        MemoryLocation* m = parse_memory_location(key, this->_ctx, index);
+        if (m == nullptr) {
+          info.clear();
+          return false;
+        }
+        set.add(m);
+      }
+    }
+
+    info.insert(v,
+                PointerAbsValue(std::move(set),
+                                std::move(interval),
+                                parse_nullity(nullity),
+                                parse_uninitialized(uninitialized)));
+  }
+  return found;
+}
+
+void PointerCache::save(const std::string& analysis, const PointerInfo& info) {
+  PositionIndex index;
+
+  // Serialize everything first, so that nothing is written on failure
+  std::vector< std::array< std::string, 3 > > rows;
+  std::vector< std::pair< sqlite::DbInt64, sqlite::DbInt64 > > lattices;
+  for (const auto& entry : info) {
+    std::string variable;
+    if (!serialize_variable(entry.first, index, variable)) {
+      return;
+    }
+
+    const PointerAbsValue& value = entry.second;
+    std::string points_to;
+    if (value.points_to().is_top()) {
+      points_to = "top";
+    } else if (value.points_to().is_bottom()) {
+      points_to = "bottom";
+    } else {
+      for (MemoryLocation* m : value.points_to()) {
+        std::string key;
+        if (!serialize_memory_location(m, index, key)) {
+          return;
+        }
+        if (!points_to.empty()) {
+          points_to += '\n';
+        }
+        points_to += key;
+      }
+    }
+
+    rows.push_back({std::move(variable),
+                    interval_str(value.offset()),
+                    std::move(points_to)});
+    lattices.emplace_back(nullity_int(value.nullity()),
+                          uninitialized_int(value.uninitialized()));
+  }
+
+  if (!this->_valid) {
+    this->_db.exec_command("DELETE FROM config");
+    this->_db.exec_command("DELETE FROM results");
+  }
+  this->_db.exec_command("DELETE FROM results WHERE analysis = '" + analysis +
+                         "'");
+
+  this->_db.set_commit_policy(sqlite::CommitPolicy::Auto);
+
+  if (!this->_valid) {
+    sqlite::DbOstream row(this->_db, "config", 1);
+    row << this->_config << sqlite::end_row;
+    this->_valid = true;
+  }
+
+  {
+    sqlite::DbOstream row(this->_db, "results", 6);
+    for (std::size_t i = 0; i < rows.size(); i++) {
+      row << analysis << rows[i][0] << lattices[i].first
+          << lattices[i].second << rows[i][1] << rows[i][2] << sqlite::end_row;
+    }
+  }
+
+  this->_db.set_commit_policy(sqlite::CommitPolicy::Manual);
+}
+
+} // end namespace analyzer
+} // end namespace ikos
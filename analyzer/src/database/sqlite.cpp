@@ -43,11 +43,19 @@
  *
  ******************************************************************************/
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iterator>
 #include <sstream>
+#include <thread>
 
 #include <ikos/core/support/compiler.hpp>
 
+#include <ikos/analyzer/database/columnar.hpp>
 #include <ikos/analyzer/database/sqlite.hpp>
+#include <ikos/analyzer/util/trace.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -161,6 +169,286 @@ const char* column_type_str(DbColumnType t) {
   }
 }
 
+// Helpers
+
+/// \brief Bind the given values to the given statement, then execute it
+///
+/// \param stmt The prepared statement
+/// \param begin Pointer on the first value
+/// \param end Pointer past the last value
+/// \param caller Name of the caller, for error messages
+static void write_values(sqlite3_stmt* stmt,
+                         const DbValue* begin,
+                         const DbValue* end,
+                         const char* caller) {
+  int column = 1;
+  for (const DbValue* value = begin; value != end; ++value) {
+    int status = SQLITE_OK;
+    switch (value->kind) {
+      case DbValue::Kind::Null: {
+        status = sqlite3_bind_null(stmt, column);
+      } break;
+      case DbValue::Kind::Integer: {
+        status = sqlite3_bind_int64(stmt, column, value->integer);
+      } break;
+      case DbValue::Kind::Real: {
+        status = sqlite3_bind_double(stmt, column, value->real);
+      } break;
+      case DbValue::Kind::Text: {
+        status = sqlite3_bind_text(stmt,
+                                   column,
+                                   value->text.data(),
+                                   static_cast< int >(value->text.size()),
+                                   SQLITE_STATIC);
+      } break;
+      case DbValue::Kind::Blob: {
+        status = sqlite3_bind_blob(stmt,
+                                   column,
+                                   value->text.data(),
+                                   static_cast< int >(value->text.size()),
+                                   SQLITE_STATIC);
+      } break;
+    }
+    if (status != SQLITE_OK) {
+      throw DbError(status, std::string(caller) + ": bind failed");
+    }
+    column++;
+  }
+
+  int status = sqlite3_step(stmt);
+  if (status != SQLITE_DONE) {
+    throw DbError(status, std::string(caller) + ": step failed");
+  }
+
+  status = sqlite3_clear_bindings(stmt);
+  if (status != SQLITE_OK) {
+    throw DbError(status, std::string(caller) + ": clear bindings failed");
+  }
+
+  status = sqlite3_reset(stmt);
+  if (status != SQLITE_OK) {
+    throw DbError(status, std::string(caller) + ": reset failed");
+  }
+}
+
+// AsyncWriter
+
+/// \brief Writer thread, draining a queue of rows into the database
+class AsyncWriter {
+private:
+  /// \brief Rows waiting to be written by a single statement
+  struct Row {
+    sqlite3_stmt* stmt;
+    std::vector< DbValue > values;
+    std::size_t rows;
+  };
+
+private:
+  /// \brief SQLite3 handle
+  sqlite3* _handle;
+
+  /// \brief Mutex protecting the queue and the SQLite3 handle
+  std::mutex _mutex;
+
+  /// \brief Notified when rows are pushed, or on stop
+  std::condition_variable _not_empty;
+
+  /// \brief Notified when the queue is drained by the writer thread
+  std::condition_variable _not_full;
+
+  /// \brief Notified when the writer thread becomes idle
+  std::condition_variable _idle;
+
+  /// \brief Rows waiting to be written
+  std::deque< Row > _queue;
+
+  /// \brief True if the writer thread is writing rows
+  bool _busy = false;
+
+  /// \brief True if the writer thread should stop
+  bool _stop = false;
+
+  /// \brief First error raised by the writer thread
+  std::exception_ptr _error;
+
+  /// \brief Number of rows in the current transaction
+  std::size_t _inserted_rows = 0;
+
+  /// \brief Writer thread
+  std::thread _thread;
+
+public:
+  /// \brief Constructor
+  explicit AsyncWriter(sqlite3* handle) : _handle(handle) {
+    this->exec("BEGIN");
+    this->_thread = std::thread([this] { this->run(); });
+  }
+
+  /// \brief Deleted copy constructor
+  AsyncWriter(const AsyncWriter&) = delete;
+
+  /// \brief Deleted move constructor
+  AsyncWriter(AsyncWriter&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+  /// \brief Deleted move assignment operator
+  AsyncWriter& operator=(AsyncWriter&&) = delete;
+
+  /// \brief Destructor
+  ///
+  /// The destructor shall not throw an exception. Call stop() to check errors.
+  ~AsyncWriter() {
+    try {
+      this->stop();
+    } catch (...) {
+    }
+  }
+
+  /// \brief Push rows in the queue
+  ///
+  /// \param stmt The INSERT statement
+  /// \param values The values of all rows
+  /// \param rows The number of rows
+  void push(sqlite3_stmt* stmt,
+            std::vector< DbValue > values,
+            std::size_t rows = 1) {
+    std::unique_lock< std::mutex > lock(this->_mutex);
+    this->_not_full.wait(lock, [this] {
+      return this->_queue.size() < DbConnection::MaxQueuedRows ||
+             this->_error != nullptr;
+    });
+    this->check_error();
+    this->_queue.push_back(Row{stmt, std::move(values), rows});
+    this->_not_empty.notify_one();
+  }
+
+  /// \brief Wait until all queued rows are written
+  void wait() {
+    std::unique_lock< std::mutex > lock(this->_mutex);
+    this->wait_idle(lock);
+    this->check_error();
+  }
+
+  /// \brief Release the memory used by SQLite3, once all queued rows are
+  /// written
+  void release_memory() {
+    std::unique_lock< std::mutex > lock(this->_mutex);
+    this->wait_idle(lock);
+    this->check_error();
+    sqlite3_db_release_memory(this->_handle);
+  }
+
+  /// \brief Execute a SQL command, once all queued rows are written
+  void exec(const char* cmd) {
+    std::unique_lock< std::mutex > lock(this->_mutex);
+    this->wait_idle(lock);
+    int status = sqlite3_exec(this->_handle, cmd, nullptr, nullptr, nullptr);
+    if (status != SQLITE_OK) {
+      throw DbError(status,
+                    "DbConnection::exec_command(): " + std::string(cmd));
+    }
+  }
+
+  /// \brief Write all queued rows, commit and stop the writer thread
+  void stop() {
+    if (!this->_thread.joinable()) {
+      return;
+    }
+
+    {
+      std::lock_guard< std::mutex > lock(this->_mutex);
+      this->_stop = true;
+      this->_not_empty.notify_one();
+    }
+    this->_thread.join();
+
+    this->check_error();
+    this->exec("COMMIT");
+  }
+
+private:
+  /// \brief Wait until the queue is empty and the writer thread is idle
+  void wait_idle(std::unique_lock< std::mutex >& lock) {
+    this->_idle.wait(lock, [this] {
+      return (this->_queue.empty() && !this->_busy) || this->_error != nullptr;
+    });
+  }
+
+  /// \brief Rethrow the error raised by the writer thread, if any
+  void check_error() {
+    if (this->_error != nullptr) {
+      std::rethrow_exception(this->_error);
+    }
+  }
+
+  /// \brief Main loop of the writer thread
+  void run() {
+    std::unique_lock< std::mutex > lock(this->_mutex);
+    while (true) {
+      this->_not_empty.wait(lock, [this] {
+        return !this->_queue.empty() || this->_stop;
+      });
+      if (this->_queue.empty()) {
+        return;
+      }
+
+      // Take all queued rows, and write them without holding the lock
+      std::deque< Row > rows;
+      rows.swap(this->_queue);
+      this->_busy = true;
+      this->_not_full.notify_all();
+      lock.unlock();
+
+      std::exception_ptr error;
+      try {
+        for (Row& row : rows) {
+          this->write(row);
+        }
+      } catch (...) {
+        error = std::current_exception();
+      }
+
+      lock.lock();
+      this->_busy = false;
+      if (error != nullptr) {
+        this->_error = error;
+        this->_queue.clear();
+        this->_not_full.notify_all();
+        this->_idle.notify_all();
+        return;
+      }
+      this->_idle.notify_all();
+    }
+  }
+
+  /// \brief Write a row
+  void write(Row& row) {
+    write_values(row.stmt,
+                 row.values.data(),
+                 row.values.data() + row.values.size(),
+                 "AsyncWriter::write()");
+
+    this->_inserted_rows += row.rows;
+    if (this->_inserted_rows >= DbConnection::MaxRowsPerTransaction) {
+      this->commit();
+    }
+  }
+
+  /// \brief Commit the current transaction and start a new one
+  void commit() {
+    TraceSpan span("db", "commit");
+    int status =
+        sqlite3_exec(this->_handle, "COMMIT; BEGIN", nullptr, nullptr, nullptr);
+    if (status != SQLITE_OK) {
+      throw DbError(status, "AsyncWriter::commit()");
+    }
+    this->_inserted_rows = 0;
+  }
+
+}; // end class AsyncWriter
+
 // DbConnection
 
 DbConnection::DbConnection(std::string filename)
@@ -177,6 +465,12 @@ DbConnection::DbConnection(std::string filename)
 
 DbConnection::~DbConnection() {
   // The destructor shall not throw an exception. No error check.
+  try {
+    this->flush_batches();
+  } catch (...) {
+  }
+  this->_writer.reset();
+
   if (this->_commit_policy == CommitPolicy::Auto) {
     sqlite3_exec(this->_handle, "COMMIT", nullptr, nullptr, nullptr);
   }
@@ -187,6 +481,11 @@ DbConnection::~DbConnection() {
 void DbConnection::exec_command(const char* cmd) {
   ikos_assert_msg(cmd != nullptr, "cmd is null");
 
+  if (this->_writer != nullptr) {
+    this->_writer->exec(cmd);
+    return;
+  }
+
   int status = sqlite3_exec(this->_handle, cmd, nullptr, nullptr, nullptr);
   if (status != SQLITE_OK) {
     throw DbError(status, "DbConnection::exec_command(): " + std::string(cmd));
@@ -199,23 +498,31 @@ void DbConnection::exec_command(const std::string& cmd) {
 
 void DbConnection::begin_transaction() {
   ikos_assert(this->_commit_policy == CommitPolicy::Manual);
+  this->flush_batches();
   this->exec_command("BEGIN");
 }
 
 void DbConnection::commit_transaction() {
   ikos_assert(this->_commit_policy == CommitPolicy::Manual);
+  this->flush_batches();
   this->exec_command("COMMIT");
 }
 
 void DbConnection::rollback_transaction() {
   ikos_assert(this->_commit_policy == CommitPolicy::Manual);
+  this->flush_batches();
   this->exec_command("ROLLBACK");
 }
 
 void DbConnection::set_commit_policy(CommitPolicy policy) {
+  this->flush_batches();
+
   if (this->_commit_policy == CommitPolicy::Auto) {
     this->exec_command("COMMIT");
     this->_inserted_rows = 0;
+  } else if (this->_commit_policy == CommitPolicy::Async) {
+    std::unique_ptr< AsyncWriter > writer = std::move(this->_writer);
+    writer->stop();
   }
 
   this->_commit_policy = policy;
@@ -223,14 +530,66 @@ void DbConnection::set_commit_policy(CommitPolicy policy) {
   if (this->_commit_policy == CommitPolicy::Auto) {
     this->exec_command("BEGIN");
     this->_inserted_rows = 0;
+  } else if (this->_commit_policy == CommitPolicy::Async) {
+    this->_writer = std::make_unique< AsyncWriter >(this->_handle);
+  }
+}
+
+void DbConnection::set_columnar_tables(std::string directory,
+                                       std::vector< std::string > tables) {
+  this->_columnar_directory = std::move(directory);
+  this->_columnar_tables = std::move(tables);
+}
+
+void DbConnection::set_publish_interval(std::chrono::milliseconds interval) {
+  std::lock_guard< std::recursive_mutex > lock(this->_mutex);
+  this->_publish_interval = interval;
+  this->_last_publish = std::chrono::steady_clock::now();
+}
+
+void DbConnection::publish() {
+  if (this->_publish_interval.count() == 0) {
+    return;
+  }
+
+  std::lock_guard< std::recursive_mutex > lock(this->_mutex);
+  auto now = std::chrono::steady_clock::now();
+  if (now - this->_last_publish < this->_publish_interval) {
+    return;
+  }
+  this->_last_publish = now;
+
+  if (this->_commit_policy == CommitPolicy::Auto) {
+    this->flush_batches();
+    TraceSpan span("db", "publish");
+    this->exec_command("COMMIT");
+    this->_inserted_rows = 0;
+    this->exec_command("BEGIN");
+  } else if (this->_commit_policy == CommitPolicy::Async) {
+    // The writer thread commits once the queued rows are written
+    this->flush_batches();
+    TraceSpan span("db", "publish");
+    this->exec_command("COMMIT; BEGIN");
+  }
+}
+
+void DbConnection::release_memory() {
+  std::lock_guard< std::recursive_mutex > lock(this->_mutex);
+  this->flush_batches();
+  TraceSpan span("db", "release-memory");
+  if (this->_writer != nullptr) {
+    this->_writer->release_memory();
+  } else {
+    sqlite3_db_release_memory(this->_handle);
   }
 }
 
-void DbConnection::row_inserted() {
+void DbConnection::row_inserted(std::size_t rows) {
   if (this->_commit_policy == CommitPolicy::Auto) {
-    this->_inserted_rows++;
+    this->_inserted_rows += rows;
 
     if (this->_inserted_rows >= MaxRowsPerTransaction) {
+      TraceSpan span("db", "commit");
       this->exec_command("COMMIT");
       this->_inserted_rows = 0;
       this->exec_command("BEGIN");
@@ -238,6 +597,14 @@ void DbConnection::row_inserted() {
   }
 }
 
+void DbConnection::flush_batches() {
+  std::lock_guard< std::recursive_mutex > lock(this->_mutex);
+  TraceSpan span("db", "flush-batches");
+  for (DbOstream* o : this->_batched_ostreams) {
+    o->flush_batch();
+  }
+}
+
 void DbConnection::drop_table(StringRef name) {
   std::string cmd("DROP TABLE IF EXISTS ");
   cmd += name;
@@ -327,39 +694,106 @@ void DbConnection::set_synchronous_flag(SynchronousFlag flag) {
 
 // DbOstream
 
-DbOstream::DbOstream(DbConnection& db, StringRef table_name, int columns)
-    : _db(db), _columns(columns) {
+DbOstream::DbOstream(DbConnection& db,
+                     StringRef table_name,
+                     int columns,
+                     int batch_rows)
+    : _db(db),
+      _table_name(table_name.to_string()),
+      _columns(columns),
+      _batch_rows(std::max(
+          1, std::min(batch_rows, MaxVariables / std::max(columns, 1)))) {
   ikos_assert_msg(columns > 0, "invalid number of columns");
+  ikos_assert_msg(batch_rows > 0, "invalid number of rows per batch");
+
+  this->_stmt = this->prepare_insert(1);
 
+  const auto& columnar_tables = this->_db._columnar_tables;
+  if (std::find(columnar_tables.begin(),
+                columnar_tables.end(),
+                this->_table_name) != columnar_tables.end()) {
+    this->_columnar =
+        std::make_unique< columnar::TableWriter >(this->_db._columnar_directory,
+                                                  table_name,
+                                                  columns);
+    this->_batch_rows = 1;
+  }
+
+  if (this->_batch_rows > 1) {
+    std::lock_guard< std::recursive_mutex > lock(this->_db._mutex);
+    this->_db._batched_ostreams.push_back(this);
+  }
+}
+
+DbOstream::~DbOstream() {
+  // The destructor shall not throw an exception. No error check is performed.
+  if (this->_batch_rows > 1) {
+    std::lock_guard< std::recursive_mutex > lock(this->_db._mutex);
+    try {
+      this->flush_batch();
+    } catch (...) {
+    }
+    auto& ostreams = this->_db._batched_ostreams;
+    ostreams.erase(std::remove(ostreams.begin(), ostreams.end(), this),
+                   ostreams.end());
+  }
+  if (this->_db._writer != nullptr) {
+    // Queued rows might use the prepared statements
+    try {
+      this->_db._writer->wait();
+    } catch (...) {
+    }
+  }
+  sqlite3_finalize(this->_batch_stmt);
+  sqlite3_finalize(this->_stmt);
+}
+
+sqlite3_stmt* DbOstream::prepare_insert(int rows) const {
   // Create SQL command
   std::string insert("INSERT INTO ");
-  insert += table_name;
-  insert += " VALUES (";
-  for (int i = 0; i < columns; i++) {
-    insert += '?';
-    insert += (i + 1 < columns) ? ',' : ')';
+  insert += this->_table_name;
+  insert += " VALUES ";
+  for (int r = 0; r < rows; r++) {
+    if (r > 0) {
+      insert += ',';
+    }
+    insert += '(';
+    for (int i = 0; i < this->_columns; i++) {
+      insert += '?';
+      insert += (i + 1 < this->_columns) ? ',' : ')';
+    }
   }
 
+  sqlite3_stmt* stmt = nullptr;
   int status = sqlite3_prepare_v2(this->_db._handle,
                                   insert.c_str(),
                                   -1,
-                                  &this->_stmt,
+                                  &stmt,
                                   nullptr);
   if (status != SQLITE_OK) {
     throw DbError(status,
-                  "DbOstream: cannot populate " + table_name.to_string() +
+                  "DbOstream: cannot populate " + this->_table_name +
                       " in database " + this->_db.filename());
   }
-}
-
-DbOstream::~DbOstream() {
-  // The destructor shall not throw an exception. No error check is performed.
-  sqlite3_finalize(_stmt);
+  return stmt;
 }
 
 void DbOstream::add(StringRef s) {
   ikos_assert(s.size() <= std::numeric_limits< int >::max());
 
+  if (this->_columnar != nullptr) {
+    this->_columnar->add(s);
+    this->_current_column++;
+    return;
+  }
+
+  if (this->is_buffered()) {
+    this->_values.push_back(
+        DbValue{DbValue::Kind::Text, 0, 0.0, std::string(s.data(), s.size())});
+    this->_current_column++;
+    return;
+  }
+
   int status = sqlite3_bind_text(this->_stmt,
                                  this->_current_column++,
                                  s.data(),
@@ -371,6 +805,18 @@ void DbOstream::add(StringRef s) {
 }
 
 void DbOstream::add_null() {
+
+  if (this->_columnar != nullptr) {
+    this->_columnar->add_null();
+    this->_current_column++;
+    return;
+  }
+  if (this->is_buffered()) {
+    this->_values.push_back(DbValue{DbValue::Kind::Null, 0, 0.0, {}});
+    this->_current_column++;
+    return;
+  }
+
   int status = sqlite3_bind_null(this->_stmt, this->_current_column++);
   if (status != SQLITE_OK) {
     throw DbError(status, "DbOstream::add_null()");
@@ -378,6 +824,18 @@ void DbOstream::add_null() {
 }
 
 void DbOstream::add(DbInt64 n) {
+
+  if (this->_columnar != nullptr) {
+    this->_columnar->add(static_cast< std::int64_t >(n));
+    this->_current_column++;
+    return;
+  }
+  if (this->is_buffered()) {
+    this->_values.push_back(DbValue{DbValue::Kind::Integer, n, 0.0, {}});
+    this->_current_column++;
+    return;
+  }
+
   int status = sqlite3_bind_int64(this->_stmt, this->_current_column++, n);
   if (status != SQLITE_OK) {
     throw DbError(status, "DbOstream::add(DbInt64)");
@@ -385,16 +843,81 @@ void DbOstream::add(DbInt64 n) {
 }
 
 void DbOstream::add(DbDouble d) {
+
+  if (this->_columnar != nullptr) {
+    this->_columnar->add(d);
+    this->_current_column++;
+    return;
+  }
+  if (this->is_buffered()) {
+    this->_values.push_back(DbValue{DbValue::Kind::Real, 0, d, {}});
+    this->_current_column++;
+    return;
+  }
+
   int status = sqlite3_bind_double(this->_stmt, this->_current_column++, d);
   if (status != SQLITE_OK) {
     throw DbError(status, "DbOstream::add(DbDouble)");
   }
 }
 
+void DbOstream::add(DbBlob b) {
+  ikos_assert(b.data.size() <= std::numeric_limits< int >::max());
+
+  if (this->_columnar != nullptr) {
+    this->_columnar->add_blob(b.data);
+    this->_current_column++;
+    return;
+  }
+
+  if (this->is_buffered()) {
+    this->_values.push_back(DbValue{DbValue::Kind::Blob,
+                                    0,
+                                    0.0,
+                                    std::string(b.data.data(),
+                                                b.data.size())});
+    this->_current_column++;
+    return;
+  }
+
+  int status = sqlite3_bind_blob(this->_stmt,
+                                 this->_current_column++,
+                                 b.data.data(),
+                                 static_cast< int >(b.data.size()),
+                                 SQLITE_TRANSIENT);
+  if (status != SQLITE_OK) {
+    throw DbError(status, "DbOstream::add(DbBlob)");
+  }
+}
+
 void DbOstream::flush() {
   ikos_assert_msg(this->_current_column == this->_columns + 1,
                   "incomplete row");
-  ikos_ignore(this->_columns);
+  this->_current_column = 1;
+
+  if (this->_columnar != nullptr) {
+    this->_columnar->end_row();
+    return;
+  }
+
+  if (this->_batch_rows > 1) {
+    this->_pending_rows++;
+    if (this->_pending_rows == this->_batch_rows) {
+      if (this->_batch_stmt == nullptr) {
+        this->_batch_stmt = this->prepare_insert(this->_batch_rows);
+      }
+      this->write_rows(this->_batch_stmt, 0, this->_batch_rows);
+      this->_values.clear();
+      this->_pending_rows = 0;
+    }
+    return;
+  }
+
+  if (this->_db._writer != nullptr) {
+    this->_db._writer->push(this->_stmt, std::move(this->_values));
+    this->_values.clear();
+    return;
+  }
 
   int status = sqlite3_step(this->_stmt);
   if (status != SQLITE_DONE) {
@@ -411,14 +934,58 @@ void DbOstream::flush() {
     throw DbError(status, "DbOstream::flush(): reset failed");
   }
 
-  this->_current_column = 1;
   this->_db.row_inserted();
 }
 
+void DbOstream::flush_batch() {
+  if (this->_pending_rows == 0) {
+    return;
+  }
+
+  // Not enough rows for the batch statement, insert them one by one
+  auto columns = static_cast< std::size_t >(this->_columns);
+  for (int r = 0; r < this->_pending_rows; r++) {
+    this->write_rows(this->_stmt, static_cast< std::size_t >(r) * columns, 1);
+  }
+
+  // Keep the values of an incomplete row
+  this->_values.erase(this->_values.begin(),
+                      this->_values.begin() +
+                          static_cast< std::ptrdiff_t >(
+                              static_cast< std::size_t >(this->_pending_rows) *
+                              columns));
+  this->_pending_rows = 0;
+}
+
+void DbOstream::write_rows(sqlite3_stmt* stmt, std::size_t begin, int rows) {
+  std::size_t end = begin + static_cast< std::size_t >(rows) *
+                                static_cast< std::size_t >(this->_columns);
+
+  if (this->_db._writer != nullptr) {
+    std::vector< DbValue > values(
+        std::make_move_iterator(this->_values.begin() +
+                                static_cast< std::ptrdiff_t >(begin)),
+        std::make_move_iterator(this->_values.begin() +
+                                static_cast< std::ptrdiff_t >(end)));
+    this->_db._writer->push(stmt,
+                            std::move(values),
+                            static_cast< std::size_t >(rows));
+    return;
+  }
+
+  write_values(stmt,
+               this->_values.data() + begin,
+               this->_values.data() + end,
+               "DbOstream::write_rows()");
+  this->_db.row_inserted(static_cast< std::size_t >(rows));
+}
+
 // DbIstream
 
 DbIstream::DbIstream(DbConnection& db, std::string query)
     : _db(db), _query(std::move(query)) {
+  this->_db.flush_batches();
+
   int status = sqlite3_prepare_v2(this->_db._handle,
                                   this->_query.c_str(),
                                   -1,
@@ -55,6 +55,12 @@ DatabaseTable::DatabaseTable(
   this->_db.drop_table(this->_name);
   this->_db.create_table(this->_name, cols);
   for (const auto& col : indexes) {
+    this->_indexes.push_back(col.to_string());
+  }
+}
+
+void DatabaseTable::create_indexes() {
+  for (const auto& col : this->_indexes) {
     std::string index_name("index_");
     index_name += this->_name;
     index_name += '_';
@@ -61,6 +61,7 @@ CallContextsTable::CallContextsTable(sqlite::DbConnection& db,
       _row(db, "call_contexts", 4) {}
 
 sqlite::DbInt64 CallContextsTable::insert(CallContext* call_context) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
   ikos_assert(call_context != nullptr);
 
   auto it = this->_map.find(call_context);
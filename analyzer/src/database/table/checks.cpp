@@ -41,11 +41,67 @@
  *
  ******************************************************************************/
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+
 #include <ikos/analyzer/database/table/checks.hpp>
+#include <ikos/analyzer/support/assert.hpp>
+#include <ikos/analyzer/util/memory_governor.hpp>
+#include <ikos/analyzer/util/trace.hpp>
 
 namespace ikos {
 namespace analyzer {
 
+namespace {
+
+/// \brief Buffer of the current thread, or null
+thread_local ChecksTable::Buffer* CurrentBuffer = nullptr;
+
+/// \brief Number of warnings and errors inserted by the current thread
+thread_local std::size_t NumUnsafeChecks = 0;
+
+/// \brief Last spill generation for which the current thread spilled its
+/// buffer
+thread_local unsigned SpilledGeneration = 0;
+
+/// \brief Return the severity of a result, used to merge checks
+int severity(Result result) {
+  switch (result) {
+    case Result::Unreachable:
+      return 0;
+    case Result::Ok:
+      return 1;
+    case Result::Warning:
+      return 2;
+    case Result::Error:
+      return 3;
+    default:
+      ikos_unreachable("unreachable");
+  }
+}
+
+/// \brief Append an unsigned integer, encoded in LEB128
+void write_varint(std::string& out, std::uint64_t n) {
+  while (n >= 0x80) {
+    out.push_back(static_cast< char >((n & 0x7f) | 0x80));
+    n >>= 7;
+  }
+  out.push_back(static_cast< char >(n));
+}
+
+} // end anonymous namespace
+
+ChecksTable::BufferScope::BufferScope(Buffer& buffer)
+    : _previous(CurrentBuffer) {
+  CurrentBuffer = &buffer;
+}
+
+ChecksTable::BufferScope::~BufferScope() {
+  CurrentBuffer = this->_previous;
+}
+
 ChecksTable::ChecksTable(sqlite::DbConnection& db,
                          StatementsTable& statements,
                          OperandsTable& operands,
@@ -57,14 +113,14 @@ ChecksTable::ChecksTable(sqlite::DbConnection& db,
                      {"checker", sqlite::DbColumnType::Integer},
                      {"status", sqlite::DbColumnType::Integer},
                      {"statement_id", sqlite::DbColumnType::Integer},
-                     {"operands", sqlite::DbColumnType::Text},
+                     {"operands", sqlite::DbColumnType::Blob},
                      {"call_context_id", sqlite::DbColumnType::Integer},
                      {"info", sqlite::DbColumnType::Text}},
                     {"statement_id", "call_context_id"}),
       _statements(statements),
       _operands(operands),
       _call_contexts(call_contexts),
-      _row(db, "checks", 8) {}
+      _row(db, "checks", 8, sqlite::DbOstream::DefaultBatchRows) {}
 
 void ChecksTable::insert(CheckKind kind,
                          CheckerName checker,
@@ -73,6 +129,257 @@ void ChecksTable::insert(CheckKind kind,
                          CallContext* call_context,
                          llvm::ArrayRef< ar::Value* > operands,
                          const JsonDict& info) {
+  if (status == Result::Warning || status == Result::Error) {
+    NumUnsafeChecks++;
+  }
+
+  if (this->_stream != nullptr) {
+    this->stream(kind, checker, status, stmt, call_context, info);
+  }
+
+  if (CurrentBuffer != nullptr) {
+    CurrentBuffer->push_back(Check{kind,
+                                   checker,
+                                   status,
+                                   stmt,
+                                   call_context,
+                                   {operands.begin(), operands.end()},
+                                   info.empty() ? std::string()
+                                                : info.str()});
+    this->spill(CurrentBuffer);
+    return;
+  }
+
+  {
+    std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+    this->write(kind,
+                checker,
+                status,
+                stmt,
+                call_context,
+                operands,
+                info.empty() ? std::string() : info.str());
+  }
+  this->spill(nullptr);
+}
+
+void ChecksTable::flush(Buffer& buffer) {
+  if (CurrentBuffer != nullptr && CurrentBuffer != &buffer) {
+    // Checks of the current thread are redirected into another buffer
+    CurrentBuffer->insert(CurrentBuffer->end(),
+                          std::make_move_iterator(buffer.begin()),
+                          std::make_move_iterator(buffer.end()));
+    buffer.clear();
+    return;
+  }
+
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+  TraceSpan span("db", "flush-checks");
+  for (const Check& check : buffer) {
+    this->write(check.kind,
+                check.checker,
+                check.status,
+                check.stmt,
+                check.call_context,
+                check.operands,
+                check.info.str());
+  }
+  buffer.clear();
+}
+
+std::size_t ChecksTable::num_unsafe_checks() {
+  return NumUnsafeChecks;
+}
+
+void ChecksTable::set_memory_governor(const MemoryGovernor* memory_governor) {
+  this->_memory_governor = memory_governor;
+}
+
+void ChecksTable::spill(Buffer* buffer) {
+  if (this->_memory_governor == nullptr ||
+      !this->_memory_governor->spilling()) {
+    return;
+  }
+
+  unsigned generation = this->_memory_governor->spill_generation();
+
+  // Release the memory of the database once per generation
+  unsigned released = this->_released_generation.load();
+  if (released != generation &&
+      this->_released_generation.compare_exchange_strong(released,
+                                                         generation)) {
+    this->_db.release_memory();
+  }
+
+  if (buffer == nullptr || buffer->empty()) {
+    return;
+  }
+
+  SpillStore* store;
+  {
+    std::lock_guard< std::mutex > lock(this->_spill_mutex);
+    if (this->_spill_store == nullptr) {
+      this->_spill_store = std::make_unique< SpillStore >();
+    }
+    store = this->_spill_store.get();
+  }
+
+  if (SpilledGeneration == generation) {
+    // Previous checks of the buffer are already spilled
+    buffer->back().info.spill(*store);
+    return;
+  }
+
+  SpilledGeneration = generation;
+  TraceSpan span("db", "spill-checks");
+  std::size_t bytes = 0;
+  for (Check& check : *buffer) {
+    bytes += check.info.spill(*store);
+  }
+  if (bytes > 0) {
+    MemoryGovernor::release_free_memory();
+  }
+}
+
+void ChecksTable::enable_aggregation(unsigned max_call_contexts) {
+  this->_max_aggregated_call_contexts = max_call_contexts;
+}
+
+void ChecksTable::write_aggregated() {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+  TraceSpan span("db", "write-aggregated-checks");
+  for (const AggregatedCheck& check : this->_aggregated) {
+    if (check.num_call_contexts <= 1) {
+      this->write_row(check.kind,
+                      check.checker,
+                      check.status,
+                      check.stmt,
+                      check.call_context,
+                      check.operands,
+                      check.info);
+      continue;
+    }
+
+    // Add the sample of call contexts to the information
+    JsonList call_contexts;
+    for (CallContext* call_context : check.call_contexts) {
+      call_contexts.add(this->_call_contexts.insert(call_context));
+    }
+    std::string info =
+        JsonDict{{"call_contexts", call_contexts},
+                 {"num_call_contexts",
+                  static_cast< sqlite::DbInt64 >(check.num_call_contexts)}}
+            .str();
+    if (!check.info.empty()) {
+      // Both are JSON dictionaries, merge them
+      info = check.info.substr(0, check.info.size() - 1) + "," + info.substr(1);
+    }
+
+    this->write_row(check.kind,
+                    check.checker,
+                    check.status,
+                    check.stmt,
+                    check.call_context,
+                    check.operands,
+                    info);
+  }
+  this->_aggregated.clear();
+  this->_aggregated_map.clear();
+}
+
+void ChecksTable::enable_stream(llvm::raw_ostream& stream) {
+  this->_stream = &stream;
+}
+
+void ChecksTable::stream(CheckKind kind,
+                         CheckerName checker,
+                         Result status,
+                         ar::Statement* stmt,
+                         CallContext* call_context,
+                         const JsonDict& info) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+
+  JsonDict line{{"kind", static_cast< sqlite::DbInt64 >(kind)},
+                {"checker", checker_short_name(checker)},
+                {"status", result_str(status)},
+                {"statement_id", this->_statements.insert(stmt)},
+                {"call_context_id", this->_call_contexts.insert(call_context)}};
+  SourceLocation loc = this->_statements.location(stmt);
+  if (loc) {
+    line.put("file", source_path(loc.file()).string());
+    line.put("line", static_cast< sqlite::DbInt64 >(loc.line()));
+    line.put("column", static_cast< sqlite::DbInt64 >(loc.column()));
+  }
+  if (!info.empty()) {
+    line.put("info", info);
+  }
+
+  *this->_stream << line.str() << '\n';
+  this->_stream->flush();
+}
+
+void ChecksTable::write(CheckKind kind,
+                        CheckerName checker,
+                        Result status,
+                        ar::Statement* stmt,
+                        CallContext* call_context,
+                        llvm::ArrayRef< ar::Value* > operands,
+                        StringRef info) {
+  if (this->_max_aggregated_call_contexts) {
+    this->aggregate(kind, checker, status, stmt, call_context, operands, info);
+  } else {
+    this->write_row(kind, checker, status, stmt, call_context, operands, info);
+  }
+}
+
+void ChecksTable::aggregate(CheckKind kind,
+                            CheckerName checker,
+                            Result status,
+                            ar::Statement* stmt,
+                            CallContext* call_context,
+                            llvm::ArrayRef< ar::Value* > operands,
+                            StringRef info) {
+  auto res = this->_aggregated_map.emplace(std::make_tuple(stmt, checker, kind),
+                                           this->_aggregated.size());
+  if (res.second) {
+    // First check of the group
+    this->_aggregated.push_back(
+        AggregatedCheck{kind,
+                        checker,
+                        status,
+                        stmt,
+                        call_context,
+                        {operands.begin(), operands.end()},
+                        info.to_string(),
+                        {call_context},
+                        1});
+    return;
+  }
+
+  AggregatedCheck& check = this->_aggregated[res.first->second];
+  check.num_call_contexts++;
+  if (check.call_contexts.size() < *this->_max_aggregated_call_contexts &&
+      std::find(check.call_contexts.begin(),
+                check.call_contexts.end(),
+                call_context) == check.call_contexts.end()) {
+    check.call_contexts.push_back(call_context);
+  }
+  if (severity(status) > severity(check.status)) {
+    // Keep the operands and information of the worst check
+    check.status = status;
+    check.call_context = call_context;
+    check.operands.assign(operands.begin(), operands.end());
+    check.info = info.to_string();
+  }
+}
+
+void ChecksTable::write_row(CheckKind kind,
+                            CheckerName checker,
+                            Result status,
+                            ar::Statement* stmt,
+                            CallContext* call_context,
+                            llvm::ArrayRef< ar::Value* > operands,
+                            StringRef info) {
   sqlite::DbInt64 id = this->_last_insert_id++;
 
   this->_row << id;
@@ -82,23 +389,26 @@ void ChecksTable::insert(CheckKind kind,
   this->_row << this->_statements.insert(stmt);
   if (!operands.empty() &&
       (status == Result::Warning || status == Result::Error)) {
-    JsonList json_operands;
+    // Pairs of (operand number + 1, operand id), as unsigned LEB128 varints
+    std::string encoded_operands;
     for (auto operand : operands) {
-      // Find operand number
+      // Find operand number, 0 if not found
       auto it = std::find(stmt->op_begin(), stmt->op_end(), operand);
-      sqlite::DbInt64 operand_no = -1;
+      std::uint64_t operand_no = 0;
       if (it != stmt->op_end()) {
-        operand_no = static_cast< sqlite::DbInt64 >(it - stmt->op_begin());
+        operand_no = static_cast< std::uint64_t >(it - stmt->op_begin()) + 1;
       }
-      json_operands.add(JsonList{operand_no, this->_operands.insert(operand)});
+      sqlite::DbInt64 operand_id = this->_operands.insert(operand);
+      write_varint(encoded_operands, operand_no);
+      write_varint(encoded_operands, static_cast< std::uint64_t >(operand_id));
     }
-    this->_row << json_operands.str();
+    this->_row << sqlite::DbBlob{encoded_operands};
   } else {
     this->_row << sqlite::null;
   }
   this->_row << this->_call_contexts.insert(call_context);
   if (!info.empty()) {
-    this->_row << info.str();
+    this->_row << info;
   } else {
     this->_row << sqlite::null;
   }
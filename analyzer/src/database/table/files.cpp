@@ -56,6 +56,7 @@ FilesTable::FilesTable(sqlite::DbConnection& db)
       _row(db, "files", 2) {}
 
 sqlite::DbInt64 FilesTable::insert(llvm::DIFile* file) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
   ikos_assert(file != nullptr);
 
   // Check in _di_file_map
@@ -0,0 +1,99 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Fixpoints database table
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <ikos/analyzer/database/table/fixpoints.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+FixpointsTable::FixpointsTable(sqlite::DbConnection& db,
+                               FunctionsTable& functions,
+                               StatementsTable& statements,
+                               CallContextsTable& call_contexts)
+    : DatabaseTable(db,
+                    "fixpoints",
+                    {{"function_id", sqlite::DbColumnType::Integer},
+                     {"statement_id", sqlite::DbColumnType::Integer},
+                     {"call_context_id", sqlite::DbColumnType::Integer},
+                     {"increasing_iterations", sqlite::DbColumnType::Integer},
+                     {"widenings", sqlite::DbColumnType::Integer},
+                     {"narrowings", sqlite::DbColumnType::Integer},
+                     {"time", sqlite::DbColumnType::Real},
+                     {"peak_size", sqlite::DbColumnType::Integer},
+                     {"copies", sqlite::DbColumnType::Integer},
+                     {"analyzed_nodes", sqlite::DbColumnType::Integer},
+                     {"reused_nodes", sqlite::DbColumnType::Integer},
+                     {"skipped_narrowings", sqlite::DbColumnType::Integer}},
+                    {"function_id", "call_context_id"}),
+      _functions(functions),
+      _statements(statements),
+      _call_contexts(call_contexts),
+      _row(db, "fixpoints", 12) {}
+
+void FixpointsTable::insert(ar::Function* fun,
+                            ar::Statement* head,
+                            CallContext* call_context,
+                            sqlite::DbInt64 increasing_iterations,
+                            sqlite::DbInt64 widenings,
+                            sqlite::DbInt64 narrowings,
+                            sqlite::DbDouble time,
+                            sqlite::DbInt64 peak_size,
+                            sqlite::DbInt64 copies,
+                            sqlite::DbInt64 analyzed_nodes,
+                            sqlite::DbInt64 reused_nodes,
+                            sqlite::DbInt64 skipped_narrowings) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+  this->_row << this->_functions.insert(fun);
+  if (head != nullptr) {
+    this->_row << this->_statements.insert(head);
+  } else {
+    this->_row << sqlite::null;
+  }
+  this->_row << this->_call_contexts.insert(call_context);
+  this->_row << increasing_iterations << widenings << narrowings << time
+             << peak_size << copies << analyzed_nodes << reused_nodes
+             << skipped_narrowings << sqlite::end_row;
+}
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -41,6 +41,7 @@
  *
  ******************************************************************************/
 
+#include <llvm/ADT/StringExtras.h>
 #include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/Function.h>
 
@@ -58,12 +59,14 @@ FunctionsTable::FunctionsTable(sqlite::DbConnection& db, FilesTable& files)
                      {"demangled", sqlite::DbColumnType::Text},
                      {"definition", sqlite::DbColumnType::Integer},
                      {"file_id", sqlite::DbColumnType::Integer},
-                     {"line", sqlite::DbColumnType::Integer}},
+                     {"line", sqlite::DbColumnType::Integer},
+                     {"hash", sqlite::DbColumnType::Text}},
                     {"file_id"}),
       _files(files),
-      _row(db, "functions", 6) {}
+      _row(db, "functions", 7) {}
 
 sqlite::DbInt64 FunctionsTable::insert(ar::Function* fun) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
   ikos_assert(fun != nullptr);
 
   auto it = this->_map.find(fun);
@@ -98,6 +101,7 @@ sqlite::DbInt64 FunctionsTable::insert(ar::Function* fun) {
     this->_row << sqlite::null;
     this->_row << sqlite::null;
   }
+  this->_row << llvm::utohexstr(fun->hash());
   this->_row << sqlite::end_row;
 
   this->_map.try_emplace(fun, id);
@@ -70,6 +70,7 @@ MemoryLocationsTable::MemoryLocationsTable(sqlite::DbConnection& db,
       _row(db, "memory_locations", 3) {}
 
 sqlite::DbInt64 MemoryLocationsTable::insert(MemoryLocation* mem_loc) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
   ikos_assert(mem_loc != nullptr);
 
   auto it = this->_map.find(mem_loc);
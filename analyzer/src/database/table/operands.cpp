@@ -52,6 +52,7 @@
 #include <llvm/IR/IntrinsicInst.h>
 #include <llvm/Transforms/Utils/Local.h>
 
+#include <ikos/ar/semantic/code.hpp>
 #include <ikos/ar/semantic/function.hpp>
 #include <ikos/ar/semantic/value.hpp>
 #include <ikos/ar/semantic/value_visitor.hpp>
@@ -71,9 +72,10 @@ OperandsTable::OperandsTable(sqlite::DbConnection& db)
                      {"kind", sqlite::DbColumnType::Integer},
                      {"repr", sqlite::DbColumnType::Text}},
                     {}),
-      _row(db, "operands", 3) {}
+      _row(db, "operands", 3, sqlite::DbOstream::DefaultBatchRows) {}
 
 sqlite::DbInt64 OperandsTable::insert(ar::Value* value) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
   ikos_assert(value != nullptr);
 
   auto it = this->_map.find(value);
@@ -81,16 +83,47 @@ sqlite::DbInt64 OperandsTable::insert(ar::Value* value) {
     return it->second;
   }
 
-  sqlite::DbInt64 id = this->_last_insert_id++;
-  this->_row << id;
-  this->_row << static_cast< sqlite::DbInt64 >(value->kind());
-  this->_row << repr(value);
-  this->_row << sqlite::end_row;
+  auto kind = static_cast< sqlite::DbInt64 >(value->kind());
+  std::string value_repr = repr(value);
+
+  std::string key = std::to_string(kind);
+  key += ':';
+  key += value_repr;
+  auto res = this->_repr_map.try_emplace(key, this->_last_insert_id);
+  sqlite::DbInt64 id = res.first->second;
+
+  if (res.second) {
+    this->_last_insert_id++;
+    this->_row << id;
+    this->_row << kind;
+    this->_row << value_repr;
+    this->_row << sqlite::end_row;
+  }
 
   this->_map.try_emplace(value, id);
   return id;
 }
 
+void OperandsTable::release(ar::Function* fun) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+
+  ar::Code* body = fun->body();
+  for (auto it = body->internal_variable_begin(),
+            et = body->internal_variable_end();
+       it != et;
+       ++it) {
+    this->_map.erase(*it);
+  }
+  for (auto it = fun->local_variable_begin(), et = fun->local_variable_end();
+       it != et;
+       ++it) {
+    this->_map.erase(*it);
+  }
+  for (auto it = fun->param_begin(), et = fun->param_end(); it != et; ++it) {
+    this->_map.erase(*it);
+  }
+}
+
 namespace detail {
 namespace {
 
@@ -993,6 +1026,19 @@ struct OperandReprVisitor {
     return r;
   }
 
+  std::string operator()(ar::DataArrayConstant* c) const {
+    std::string r = "[";
+    for (std::size_t i = 0, n = c->num_elements(); i < n;) {
+      r += c->element(i).str();
+      ++i;
+      if (i != n) {
+        r += ", ";
+      }
+    }
+    r += "]";
+    return r;
+  }
+
   std::string operator()(ar::AggregateZeroConstant*) const { return "{0}"; }
 
   std::string operator()(ar::FunctionPointerConstant* c) const {
@@ -0,0 +1,83 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Abstract state sizes database table
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <ikos/analyzer/database/table/state_sizes.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+StateSizesTable::StateSizesTable(sqlite::DbConnection& db,
+                                 FunctionsTable& functions,
+                                 CallContextsTable& call_contexts)
+    : DatabaseTable(db,
+                    "state_sizes",
+                    {{"function_id", sqlite::DbColumnType::Integer},
+                     {"call_context_id", sqlite::DbColumnType::Integer},
+                     {"samples", sqlite::DbColumnType::Integer},
+                     {"peak_cells", sqlite::DbColumnType::Integer},
+                     {"peak_points_to", sqlite::DbColumnType::Integer},
+                     {"peak_nodes", sqlite::DbColumnType::Integer},
+                     {"peak_pack_size", sqlite::DbColumnType::Integer},
+                     {"dropped_relations", sqlite::DbColumnType::Integer}},
+                    {"function_id", "call_context_id"}),
+      _functions(functions),
+      _call_contexts(call_contexts),
+      _row(db, "state_sizes", 8) {}
+
+void StateSizesTable::insert(ar::Function* fun,
+                             CallContext* call_context,
+                             sqlite::DbInt64 samples,
+                             sqlite::DbInt64 peak_cells,
+                             sqlite::DbInt64 peak_points_to,
+                             sqlite::DbInt64 peak_nodes,
+                             sqlite::DbInt64 peak_pack_size,
+                             sqlite::DbInt64 dropped_relations) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+  this->_row << this->_functions.insert(fun);
+  this->_row << this->_call_contexts.insert(call_context);
+  this->_row << samples << peak_cells << peak_points_to << peak_nodes
+             << peak_pack_size << dropped_relations << sqlite::end_row;
+}
+
+} // end namespace analyzer
+} // end namespace ikos
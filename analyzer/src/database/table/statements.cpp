@@ -61,9 +61,10 @@ StatementsTable::StatementsTable(sqlite::DbConnection& db,
                     {"function_id", "file_id"}),
       _files(files),
       _functions(functions),
-      _row(db, "statements", 6) {}
+      _row(db, "statements", 6, sqlite::DbOstream::DefaultBatchRows) {}
 
 sqlite::DbInt64 StatementsTable::insert(ar::Statement* stmt) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
   ikos_assert(stmt != nullptr);
 
   auto it = this->_map.find(stmt);
@@ -81,7 +82,7 @@ sqlite::DbInt64 StatementsTable::insert(ar::Statement* stmt) {
   this->_row << this->_functions.insert(code->function());
 
   ikos_assert(stmt->has_frontend());
-  SourceLocation loc = source_location(stmt);
+  SourceLocation loc = this->location(stmt);
   if (loc) {
     this->_row << this->_files.insert(loc.file());
     this->_row << static_cast< sqlite::DbInt64 >(loc.line());
@@ -98,5 +99,36 @@ sqlite::DbInt64 StatementsTable::insert(ar::Statement* stmt) {
   return id;
 }
 
+SourceLocation StatementsTable::location(ar::Statement* stmt) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+  ikos_assert(stmt != nullptr);
+
+  ar::Code* code = stmt->parent()->code();
+  std::unique_ptr< LocationIndex >& index = this->_locations[code];
+  if (index == nullptr) {
+    index = std::make_unique< LocationIndex >();
+    for (ar::BasicBlock* bb : *code) {
+      for (ar::Statement* s : *bb) {
+        index->try_emplace(s, source_location(s));
+      }
+    }
+  }
+
+  auto it = index->find(stmt);
+  ikos_assert(it != index->end());
+  return it->second;
+}
+
+void StatementsTable::release(ar::Code* code) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+
+  this->_locations.erase(code);
+  for (ar::BasicBlock* bb : *code) {
+    for (ar::Statement* stmt : *bb) {
+      this->_map.erase(stmt);
+    }
+  }
+}
+
 } // end namespace analyzer
 } // end namespace ikos
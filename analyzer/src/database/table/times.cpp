@@ -50,12 +50,48 @@ TimesTable::TimesTable(sqlite::DbConnection& db)
     : DatabaseTable(db,
                     "times",
                     {{"pass", sqlite::DbColumnType::Text},
-                     {"time", sqlite::DbColumnType::Real}},
+                     {"time", sqlite::DbColumnType::Real},
+                     {"peak_rss", sqlite::DbColumnType::Integer},
+                     {"instructions", sqlite::DbColumnType::Integer},
+                     {"cycles", sqlite::DbColumnType::Integer},
+                     {"llc_misses", sqlite::DbColumnType::Integer},
+                     {"branch_misses", sqlite::DbColumnType::Integer},
+                     {"allocated_bytes", sqlite::DbColumnType::Integer},
+                     {"allocations", sqlite::DbColumnType::Integer},
+                     {"live_bytes", sqlite::DbColumnType::Integer}},
                     {"pass"}),
-      _row(db, "times", 2) {}
+      _row(db, "times", 10) {}
 
-void TimesTable::insert(StringRef name, sqlite::DbDouble time) {
-  this->_row << name << time << sqlite::end_row;
+void TimesTable::insert(
+    StringRef name,
+    sqlite::DbDouble time,
+    boost::optional< sqlite::DbInt64 > peak_rss,
+    const boost::optional< PerfCounterValues >& counters,
+    const boost::optional< AllocationValues >& allocations) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+  this->_row << name << time;
+  if (peak_rss) {
+    this->_row << *peak_rss;
+  } else {
+    this->_row << sqlite::null;
+  }
+  if (counters) {
+    this->_row << static_cast< sqlite::DbInt64 >(counters->instructions)
+               << static_cast< sqlite::DbInt64 >(counters->cycles)
+               << static_cast< sqlite::DbInt64 >(counters->llc_misses)
+               << static_cast< sqlite::DbInt64 >(counters->branch_misses);
+  } else {
+    this->_row << sqlite::null << sqlite::null << sqlite::null
+               << sqlite::null;
+  }
+  if (allocations) {
+    this->_row << static_cast< sqlite::DbInt64 >(allocations->allocated_bytes)
+               << static_cast< sqlite::DbInt64 >(allocations->allocations)
+               << static_cast< sqlite::DbInt64 >(allocations->live_bytes);
+  } else {
+    this->_row << sqlite::null << sqlite::null << sqlite::null;
+  }
+  this->_row << sqlite::end_row;
 }
 
 } // end namespace analyzer
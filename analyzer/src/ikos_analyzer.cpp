@@ -42,33 +42,64 @@
  *
  ******************************************************************************/
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 
+#include <llvm/IR/DebugInfoMetadata.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Support/Debug.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/InitLLVM.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Regex.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/WithColor.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <ikos/core/domain/machine_int/trace.hpp>
+#ifdef HAS_APRON
+#include <ikos/core/domain/numeric/apron.hpp>
+#endif
+#include <ikos/core/domain/numeric/var_packing_domain.hpp>
+
 #include <ikos/ar/format/dot.hpp>
 #include <ikos/ar/format/formatter.hpp>
 #include <ikos/ar/format/text.hpp>
 #include <ikos/ar/pass/add_loop_counters.hpp>
 #include <ikos/ar/pass/name_values.hpp>
+#include <ikos/ar/pass/pass_manager.hpp>
+#include <ikos/ar/pass/propagate_constants.hpp>
+#include <ikos/ar/pass/remove_unreachable_functions.hpp>
 #include <ikos/ar/pass/simplify_cfg.hpp>
 #include <ikos/ar/pass/simplify_upcast_comparison.hpp>
+#include <ikos/ar/pass/slice.hpp>
 #include <ikos/ar/verify/frontend.hpp>
 #include <ikos/ar/verify/type.hpp>
 
 #include <ikos/frontend/llvm/import.hpp>
+#include <ikos/frontend/llvm/pass.hpp>
 
 #include <ikos/analyzer/analysis/call_context.hpp>
+#include <ikos/analyzer/analysis/call_graph.hpp>
+#include <ikos/analyzer/analysis/cost_estimate.hpp>
 #include <ikos/analyzer/analysis/context.hpp>
 #include <ikos/analyzer/analysis/fixpoint_profile.hpp>
 #include <ikos/analyzer/analysis/hardware_addresses.hpp>
@@ -79,17 +110,35 @@
 #include <ikos/analyzer/analysis/pointer/function.hpp>
 #include <ikos/analyzer/analysis/pointer/pointer.hpp>
 #include <ikos/analyzer/analysis/result.hpp>
+#include <ikos/analyzer/analysis/trivial_checks.hpp>
+#include <ikos/analyzer/analysis/value/abstract_domain.hpp>
 #include <ikos/analyzer/analysis/value/interprocedural.hpp>
 #include <ikos/analyzer/analysis/value/intraprocedural.hpp>
+#include <ikos/analyzer/analysis/value/machine_int_domain.hpp>
 #include <ikos/analyzer/analysis/variable.hpp>
+#include <ikos/analyzer/analysis/variable_packing.hpp>
+#include <ikos/analyzer/checker/checker.hpp>
 #include <ikos/analyzer/checker/name.hpp>
+#include <ikos/analyzer/database/cache.hpp>
+#include <ikos/analyzer/database/library_summary.hpp>
 #include <ikos/analyzer/database/output.hpp>
+#include <ikos/analyzer/database/pointer_cache.hpp>
+#include <ikos/analyzer/util/allocation_stats.hpp>
 #include <ikos/analyzer/util/color.hpp>
+#include <ikos/analyzer/util/demangle.hpp>
+#include <ikos/analyzer/util/gmp_allocator.hpp>
+#include <ikos/analyzer/util/local_socket.hpp>
 #include <ikos/analyzer/util/log.hpp>
+#include <ikos/analyzer/util/memory_governor.hpp>
+#include <ikos/analyzer/util/source_location.hpp>
+#include <ikos/analyzer/util/thread_pool.hpp>
 #include <ikos/analyzer/util/timer.hpp>
+#include <ikos/analyzer/util/progress.hpp>
+#include <ikos/analyzer/util/trace.hpp>
 
 namespace ar = ikos::ar;
 namespace llvm_to_ar = ikos::frontend::import;
+namespace ikos_pp = ikos::frontend::pass;
 namespace analyzer = ikos::analyzer;
 
 /// \name Main options
@@ -110,6 +159,150 @@ static llvm::cl::opt< std::string > OutputFilename(
     llvm::cl::init("output.db"),
     llvm::cl::cat(MainCategory));
 
+static llvm::cl::opt< std::string > CacheFilename(
+    "cache",
+    llvm::cl::desc("Cache file used to reuse the results of unchanged "
+                   "functions, or entry points for the interprocedural "
+                   "analysis, from previous runs"),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< std::string > PointerCacheFilename(
+    "pointer-cache",
+    llvm::cl::desc("Cache file used to reuse the results of the pointer "
+                   "analyses from previous runs on the same program"),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::list< std::string > LibrarySummaryFilenames(
+    "library-summary",
+    llvm::cl::desc("Summary packages of libraries, used instead of analyzing "
+                   "the library functions again"),
+    llvm::cl::CommaSeparated,
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< std::string > EmitLibrarySummaryFilename(
+    "emit-library-summary",
+    llvm::cl::desc("Save the summaries of the analyzed functions in a summary "
+                   "package, for the analyses of programs linking them "
+                   "(requires -proc=intra)"),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< std::string > CheckpointFilename(
+    "checkpoint",
+    llvm::cl::desc("Periodically save the results of the analyzed functions, "
+                   "or entry points for the interprocedural analysis, in the "
+                   "given file, see -resume"),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< unsigned > CheckpointInterval(
+    "checkpoint-interval",
+    llvm::cl::desc("Interval between checkpoints, in seconds (default: 300)"),
+    llvm::cl::value_desc("seconds"),
+    llvm::cl::init(300),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< bool > Resume(
+    "resume",
+    llvm::cl::desc("Resume an interrupted analysis from its checkpoint file"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< bool > AsyncOutput(
+    "async-db",
+    llvm::cl::desc("Write the output database from a dedicated thread"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< bool > LiveOutput(
+    "live-db",
+    llvm::cl::desc("Write the output database in WAL mode and commit the "
+                   "results periodically, so that they can be read during "
+                   "the analysis (e.g, by ikos-view --live)"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< bool > AsyncLog(
+    "async-log",
+    llvm::cl::desc("Write the log messages from a dedicated thread"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< analyzer::OutputFormat > OutputFormat(
+    "format",
+    llvm::cl::desc("Output format:"),
+    llvm::cl::values(clEnumValN(analyzer::OutputFormat::SQLite,
+                                "sqlite",
+                                "SQLite database (default)"),
+                     clEnumValN(analyzer::OutputFormat::Columnar,
+                                "columnar",
+                                "Large tables in columnar files, in the "
+                                "directory <output>.col")),
+    llvm::cl::init(analyzer::OutputFormat::SQLite),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< std::string > StreamChecksFilename(
+    "stream-checks",
+    llvm::cl::desc("Write each check as a JSON line in the given file as soon "
+                   "as it is found (use - for the standard output)"),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< std::string > TraceFilename(
+    "trace",
+    llvm::cl::desc("Write a trace of the analysis in the given file, in the "
+                   "Chrome trace event format"),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< bool > EnablePerfCounters(
+    "perf-counters",
+    llvm::cl::desc("Record the hardware performance counters (instructions, "
+                   "cycles, cache misses, branch misses) of the timed passes "
+                   "and the trace spans"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< bool > EnableAllocationStats(
+    "allocation-stats",
+    llvm::cl::desc("Record the allocations (bytes, count, live bytes) of the "
+                   "timed passes"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< std::string > ProgressFilename(
+    "progress",
+    llvm::cl::desc("Periodically write the progress of the analysis in the "
+                   "given file, as JSON lines"),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< unsigned > ProgressInterval(
+    "progress-interval",
+    llvm::cl::desc("Interval between two progress events, in milliseconds "
+                   "(default: 1000)"),
+    llvm::cl::init(1000),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< std::string > VerifyCacheFilename(
+    "verify-cache",
+    llvm::cl::desc("Skip the verification of the LLVM bitcode and the AR when "
+                   "the bitcode was already verified, as recorded in the "
+                   "given file"),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< std::string > ServerSocket(
+    "server",
+    llvm::cl::desc("After the pre-analyses, serve value analysis requests on "
+                   "the given local socket, reusing the AR and the "
+                   "pre-analyses"),
+    llvm::cl::value_desc("socket"),
+    llvm::cl::cat(MainCategory));
+
+static llvm::cl::opt< bool > DeferDbIndexes(
+    "defer-db-indexes",
+    llvm::cl::desc("Create the indexes of the output database at the end of "
+                   "the analysis"),
+    llvm::cl::cat(MainCategory));
+
 static llvm::cl::opt< analyzer::LogLevel > LogLevel(
     "log",
     llvm::cl::desc("Log level:"),
@@ -196,6 +389,10 @@ static llvm::cl::opt< analyzer::MachineIntDomainOption > Domain(
                    machine_int_domain_option_str(
                        analyzer::MachineIntDomainOption::Interval),
                    "Interval domain"),
+        clEnumValN(analyzer::MachineIntDomainOption::DenseInterval,
+                   machine_int_domain_option_str(
+                       analyzer::MachineIntDomainOption::DenseInterval),
+                   "Interval domain, stored in dense arrays"),
         clEnumValN(analyzer::MachineIntDomainOption::Congruence,
                    machine_int_domain_option_str(
                        analyzer::MachineIntDomainOption::Congruence),
@@ -204,10 +401,18 @@ static llvm::cl::opt< analyzer::MachineIntDomainOption > Domain(
                    machine_int_domain_option_str(
                        analyzer::MachineIntDomainOption::IntervalCongruence),
                    "Reduced product of Interval and Congruence"),
+        clEnumValN(analyzer::MachineIntDomainOption::IntervalEquality,
+                   machine_int_domain_option_str(
+                       analyzer::MachineIntDomainOption::IntervalEquality),
+                   "Reduced product of Interval and variable equalities"),
         clEnumValN(analyzer::MachineIntDomainOption::DBM,
                    machine_int_domain_option_str(
                        analyzer::MachineIntDomainOption::DBM),
                    "Difference-Bound Matrices domain"),
+        clEnumValN(analyzer::MachineIntDomainOption::SplitDBM,
+                   machine_int_domain_option_str(
+                       analyzer::MachineIntDomainOption::SplitDBM),
+                   "Sparse Difference-Bound Matrices domain"),
         clEnumValN(analyzer::MachineIntDomainOption::VarPackDBM,
                    machine_int_domain_option_str(
                        analyzer::MachineIntDomainOption::VarPackDBM),
@@ -217,6 +422,11 @@ static llvm::cl::opt< analyzer::MachineIntDomainOption > Domain(
             machine_int_domain_option_str(
                 analyzer::MachineIntDomainOption::VarPackDBMCongruence),
             "Reduced product of DBM with variable packing and Congruence"),
+        clEnumValN(analyzer::MachineIntDomainOption::StaticPackDBM,
+                   machine_int_domain_option_str(
+                       analyzer::MachineIntDomainOption::StaticPackDBM),
+                   "Difference-Bound Matrices domain with fixed variable "
+                   "packs"),
         clEnumValN(analyzer::MachineIntDomainOption::Gauge,
                    machine_int_domain_option_str(
                        analyzer::MachineIntDomainOption::Gauge),
@@ -226,6 +436,10 @@ static llvm::cl::opt< analyzer::MachineIntDomainOption > Domain(
             machine_int_domain_option_str(
                 analyzer::MachineIntDomainOption::GaugeIntervalCongruence),
             "Reduced product of Gauge, Interval and Congruence"),
+        clEnumValN(analyzer::MachineIntDomainOption::PowersetInterval,
+                   machine_int_domain_option_str(
+                       analyzer::MachineIntDomainOption::PowersetInterval),
+                   "Bounded disjunctions of Intervals"),
         clEnumValN(analyzer::MachineIntDomainOption::ApronInterval,
                    machine_int_domain_option_str(
                        analyzer::MachineIntDomainOption::ApronInterval),
@@ -290,7 +504,11 @@ static llvm::cl::opt< analyzer::MachineIntDomainOption > Domain(
                            VarPackApronPkgridPolyhedraLinearCongruences),
                    "APRON Pkgrid Polyhedra and Linear Congruences domain with "
                    "variable packing")),
+#ifdef IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN
+    llvm::cl::init(analyzer::value::StaticMachineIntDomainOption),
+#else
     llvm::cl::init(analyzer::MachineIntDomainOption::Interval),
+#endif
     llvm::cl::cat(AnalysisCategory));
 
 static llvm::cl::list< std::string > EntryPoints(
@@ -301,6 +519,29 @@ static llvm::cl::list< std::string > EntryPoints(
     llvm::cl::value_desc("function"),
     llvm::cl::cat(AnalysisCategory));
 
+static llvm::cl::list< std::string > Functions(
+    "functions",
+    llvm::cl::desc("Only check these functions. The interprocedural analysis "
+                   "only analyzes the entry points that might call them"),
+    llvm::cl::CommaSeparated,
+    llvm::cl::value_desc("function"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::list< std::string > OnlyFiles(
+    "only-file",
+    llvm::cl::desc("Only check the functions defined in these source files, "
+                   "see -functions"),
+    llvm::cl::CommaSeparated,
+    llvm::cl::value_desc("file"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::list< std::string > OnlyFunctions(
+    "only-function",
+    llvm::cl::desc("Only check the functions with a name, or demangled name, "
+                   "matching the given regular expression, see -functions"),
+    llvm::cl::value_desc("regex"),
+    llvm::cl::cat(AnalysisCategory));
+
 static llvm::cl::list< std::string > NoInitGlobals(
     "no-init-globals",
     llvm::cl::desc(
@@ -331,6 +572,12 @@ static llvm::cl::opt< bool > NoPointer(
     llvm::cl::desc("Disable the pointer analysis"),
     llvm::cl::cat(AnalysisCategory));
 
+static llvm::cl::opt< bool > FrameProjection(
+    "frame-projection",
+    llvm::cl::desc("Remove the variables of the caller from the entry state of "
+                   "inlined callees"),
+    llvm::cl::cat(AnalysisCategory));
+
 static llvm::cl::opt< bool > NoFixpointProfiles(
     "no-fixpoint-profiles",
     llvm::cl::desc("Disable the fixpoint profiles analysis"),
@@ -392,6 +639,248 @@ static llvm::cl::opt< int > Argc("argc",
                                  llvm::cl::init(-1),
                                  llvm::cl::cat(AnalysisCategory));
 
+static llvm::cl::opt< int > ContextDepth(
+    "context-depth",
+    llvm::cl::desc("Maximum depth of calling contexts for the interprocedural "
+                   "analysis, 0 for a context-insensitive analysis "
+                   "(default: unlimited)"),
+    llvm::cl::value_desc("k"),
+    llvm::cl::init(-1),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< bool > LowMemory(
+    "low-memory",
+    llvm::cl::desc("Only keep the invariants at loop heads during the value "
+                   "analysis, and recompute the others when running checks"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< bool > ReleaseFunctions(
+    "release-functions",
+    llvm::cl::desc("Release the analysis state of each function once its "
+                   "results are written (requires -proc=intra)"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< bool > ReleaseAR(
+    "release-ar",
+    llvm::cl::desc("Also release the AR of each function that is not "
+                   "referenced by another function or global variable, once "
+                   "its results are written (implies -release-functions)"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< bool > Sparse(
+    "sparse",
+    llvm::cl::desc("Propagate intervals along the def-use chains of integer "
+                   "variables instead of abstract states along the control "
+                   "flow graph (requires -prec=reg and -proc=intra)"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > FunctionTimeout(
+    "function-timeout",
+    llvm::cl::desc("Time budget in seconds for the analysis of a function in "
+                   "a given calling context, after which loops are widened to "
+                   "top (default: unlimited)"),
+    llvm::cl::value_desc("seconds"),
+    llvm::cl::init(0),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > FunctionMaxSteps(
+    "function-max-steps",
+    llvm::cl::desc("Maximum number of basic block analyses for a function in "
+                   "a given calling context, after which loops are widened to "
+                   "top (default: unlimited)"),
+    llvm::cl::value_desc("n"),
+    llvm::cl::init(0),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > Deadline(
+    "deadline",
+    llvm::cl::desc("Time in seconds after which the remaining entry points "
+                   "are skipped, analyzing first the entry points with the "
+                   "most checked statements per estimated cost (default: "
+                   "unlimited)"),
+    llvm::cl::value_desc("seconds"),
+    llvm::cl::init(0),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< bool > Estimate(
+    "estimate",
+    llvm::cl::desc("Print the estimated cost of the value analysis of each "
+                   "function and overall, without running it"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< std::string > RefineDomain(
+    "refine-domain",
+    llvm::cl::desc("Re-analyze the functions, or entry points for the "
+                   "interprocedural analysis, with warnings or errors using "
+                   "the given abstract domain (see -d), and keep the most "
+                   "precise results"),
+    llvm::cl::value_desc("domain"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::list< std::string > FunctionDomains(
+    "function-domain",
+    llvm::cl::desc("Abstract domain (see -d) of the given function, for the "
+                   "intraprocedural analysis"),
+    llvm::cl::CommaSeparated,
+    llvm::cl::value_desc("function:domain"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< std::string > KernelDomain(
+    "kernel-domain",
+    llvm::cl::desc("Abstract domain (see -d) of the numeric kernels: functions "
+                   "with nested loops, or with loops indexing arrays with "
+                   "integer arithmetic, for the intraprocedural analysis"),
+    llvm::cl::value_desc("domain"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > MaxPackSize(
+    "max-pack-size",
+    llvm::cl::desc("Maximum number of variables in a pack of the variable "
+                   "packing domains, relations growing a pack past it are "
+                   "tracked with intervals (default: no limit)"),
+    llvm::cl::value_desc("n"),
+    llvm::cl::init(0),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > ApronMaxSize(
+    "apron-max-size",
+    llvm::cl::desc("Maximum size of the APRON polyhedra, in number of "
+                   "coefficients, before they are approximated with octagons "
+                   "or intervals (default: no limit)"),
+    llvm::cl::value_desc("n"),
+    llvm::cl::init(0),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > ApronTimeout(
+    "apron-timeout",
+    llvm::cl::desc("Maximum duration in milliseconds of an operation on APRON "
+                   "polyhedra, before the result is approximated with "
+                   "octagons or intervals (default: no limit)"),
+    llvm::cl::value_desc("ms"),
+    llvm::cl::init(0),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > RefineTimeout(
+    "refine-timeout",
+    llvm::cl::desc("Time budget in seconds for the re-analysis of a function "
+                   "in a given calling context, see -refine-domain (default: "
+                   "same as -function-timeout)"),
+    llvm::cl::value_desc("seconds"),
+    llvm::cl::init(0),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< std::string > TuningFilename(
+    "tuning",
+    llvm::cl::desc("Tuning profile generated from the telemetry of a previous "
+                   "run: widening delays and thresholds per loop, precision "
+                   "per function"),
+    llvm::cl::value_desc("file"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > SoftMemLimit(
+    "soft-mem-limit",
+    llvm::cl::desc("Soft memory limit in megabytes, after which functions are "
+                   "analyzed with a lower precision (default: unlimited)"),
+    llvm::cl::value_desc("MB"),
+    llvm::cl::init(0),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > SpillMemLimit(
+    "spill-mem-limit",
+    llvm::cl::desc("Memory limit in megabytes, after which the buffered checks "
+                   "and database rows are spilled to disk (default: "
+                   "unlimited)"),
+    llvm::cl::value_desc("MB"),
+    llvm::cl::init(0),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > MaxCells(
+    "max-cells",
+    llvm::cl::desc("Maximum number of memory cells per memory location, after "
+                   "which the cells of the memory location are smashed "
+                   "(default: unlimited)"),
+    llvm::cl::value_desc("n"),
+    llvm::cl::init(0),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > AggregateChecks(
+    "aggregate-checks",
+    llvm::cl::desc("Merge the checks of a statement across call contexts, "
+                   "keeping the worst result and at most n call contexts per "
+                   "check (default: disabled)"),
+    llvm::cl::value_desc("n"),
+    llvm::cl::init(0),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< bool > SkipSafeContexts(
+    "skip-safe-contexts",
+    llvm::cl::desc("Skip the checks on a function in a calling context when "
+                   "its entry invariant is included in the one of a calling "
+                   "context without warnings and errors"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< bool > GroupContexts(
+    "group-contexts",
+    llvm::cl::desc("Analyze a callee once for all the calling contexts with "
+                   "the same entry invariant, and check it in each of them"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< bool > TrivialChecks(
+    "trivial-checks",
+    llvm::cl::desc("Decide the checks that are safe syntactically, such as "
+                   "divisions by non-zero constants, once per statement "
+                   "before the value analysis"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< bool > FixpointStats(
+    "fixpoint-stats",
+    llvm::cl::desc("Record statistics on the fixpoint iterations on loops in "
+                   "the output database"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< bool > TransferStats(
+    "transfer-stats",
+    llvm::cl::desc("Record the number of transfer functions and the time "
+                   "spent in them, per statement kind, in the output database"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< bool > StateStats(
+    "state-stats",
+    llvm::cl::desc("Record the peak sizes of the abstract states (memory "
+                   "cells, points-to sets, patricia tree nodes) per function "
+                   "in the output database"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > Jobs(
+    "jobs",
+    llvm::cl::desc("Number of threads used by the analysis (default: 1)"),
+    llvm::cl::value_desc("n"),
+    llvm::cl::init(1),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< bool > Numa(
+    "numa",
+    llvm::cl::desc("Spread the analysis threads over the NUMA nodes, bind "
+                   "them to their node and steal work from the same node "
+                   "first"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > Processes(
+    "processes",
+    llvm::cl::desc("Number of worker processes forked for the value analysis. "
+                   "Worker i analyzes the i-th shard and writes its results "
+                   "in <output>.<i>, see ikos-merge (default: 1)"),
+    llvm::cl::value_desc("n"),
+    llvm::cl::init(1),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< std::string > Shard(
+    "shard",
+    llvm::cl::desc("Only analyze the i-th shard out of n of the entry points "
+                   "(interprocedural) or the functions (intraprocedural)"),
+    llvm::cl::value_desc("i/n"),
+    llvm::cl::cat(AnalysisCategory));
+
 /// @}
 /// \name Import options
 /// @{
@@ -419,6 +908,41 @@ static llvm::cl::opt< bool > AllowDebugInfoMismatch(
     llvm::cl::desc("Allow incorrect debug information in the module"),
     llvm::cl::cat(ImportCategory));
 
+static llvm::cl::opt< bool > LazyImport(
+    "lazy-import",
+    llvm::cl::desc("Only load and translate the functions reachable from the "
+                   "entry points"),
+    llvm::cl::cat(ImportCategory));
+
+static llvm::cl::opt< ikos_pp::OptLevel > Preprocess(
+    "pp-opt",
+    llvm::cl::desc("Run the ikos-pp preprocessing on the input bitcode, with "
+                   "the given optimization level:"),
+    llvm::cl::values(
+        clEnumValN(ikos_pp::OptLevel::None,
+                   "none",
+                   "Only passes required for the translation to AR"),
+        clEnumValN(ikos_pp::OptLevel::Basic,
+                   "basic",
+                   "Basic set of optimizations"),
+        clEnumValN(ikos_pp::OptLevel::Aggressive,
+                   "aggressive",
+                   "Aggressive optimizations")),
+    llvm::cl::cat(ImportCategory));
+
+static llvm::cl::opt< bool > PreprocessInlineAll(
+    "pp-inline-all",
+    llvm::cl::desc("Inline all functions during the preprocessing (if "
+                   "-pp-opt=aggressive)"),
+    llvm::cl::cat(ImportCategory));
+
+static llvm::cl::opt< bool > PreprocessInternalize(
+    "pp-internalize",
+    llvm::cl::desc("Internalize everything but the entry points during the "
+                   "preprocessing, and remove the dead functions and global "
+                   "variables (if -pp-opt=basic)"),
+    llvm::cl::cat(ImportCategory));
+
 /// @}
 /// \name Passes options
 /// @{
@@ -430,6 +954,16 @@ static llvm::cl::opt< bool > NoTypeCheck(
     llvm::cl::desc("Do not run the type checker"),
     llvm::cl::cat(PassCategory));
 
+static llvm::cl::opt< bool > RemoveUnreachableFunctions(
+    "remove-unreachable-functions",
+    llvm::cl::desc("Remove the functions unreachable from the entry points"),
+    llvm::cl::cat(PassCategory));
+
+static llvm::cl::opt< bool > PropagateConstants(
+    "propagate-constants",
+    llvm::cl::desc("Propagate constants and remove dead stores"),
+    llvm::cl::cat(PassCategory));
+
 static llvm::cl::opt< bool > NoSimplifyCFG(
     "no-simplify-cfg",
     llvm::cl::desc("Do not run the simplify-cfg pass"),
@@ -437,7 +971,13 @@ static llvm::cl::opt< bool > NoSimplifyCFG(
 
 static llvm::cl::opt< bool > AddLoopCounters(
     "add-loop-counters",
-    llvm::cl::desc("Add a loop counter in each cycle"),
+    llvm::cl::desc("Add a loop counter in the cycles with affine updates used "
+                   "in pointer shifts"),
+    llvm::cl::cat(PassCategory));
+
+static llvm::cl::opt< bool > AllLoopCounters(
+    "all-loop-counters",
+    llvm::cl::desc("With -add-loop-counters, add a loop counter in each cycle"),
     llvm::cl::cat(PassCategory));
 
 static llvm::cl::opt< bool > NameValues(
@@ -455,6 +995,11 @@ static llvm::cl::opt< bool > NoSimplifyUpcastComparison(
     llvm::cl::desc("Do not simplify the implicit upcast before a comparison"),
     llvm::cl::cat(PassCategory));
 
+static llvm::cl::opt< bool > Slice(
+    "slice",
+    llvm::cl::desc("Remove the statements irrelevant to the requested checks"),
+    llvm::cl::cat(PassCategory));
+
 /// @}
 /// \name Debug options
 /// @{
@@ -477,6 +1022,11 @@ static llvm::cl::opt< bool > DisplayPointer(
     llvm::cl::desc("Display pointer analysis results"),
     llvm::cl::cat(DebugCategory));
 
+static llvm::cl::opt< bool > DisplayCallGraph(
+    "display-call-graph",
+    llvm::cl::desc("Display the recursive components of the call graph"),
+    llvm::cl::cat(DebugCategory));
+
 static llvm::cl::opt< bool > DisplayFixpointProfiles(
     "display-fixpoint-profiles",
     llvm::cl::desc("Display fixpoint profiles analysis results"),
@@ -528,6 +1078,21 @@ static llvm::cl::opt< analyzer::DisplayOption > DisplayChecks(
     llvm::cl::init(analyzer::DisplayOption::None),
     llvm::cl::cat(DebugCategory));
 
+static llvm::cl::opt< std::string > DomainTraceFilename(
+    "domain-trace",
+    llvm::cl::desc("Record the operations on the machine integer abstract "
+                   "domain during the analysis of the function given by "
+                   "-domain-trace-function in the given binary file, to be "
+                   "replayed by the core benchmarks"),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(DebugCategory));
+
+static llvm::cl::opt< std::string > DomainTraceFunction(
+    "domain-trace-function",
+    llvm::cl::desc("Function recorded by -domain-trace"),
+    llvm::cl::value_desc("function"),
+    llvm::cl::cat(DebugCategory));
+
 /// @}
 /// \name Formatting options
 /// @{
@@ -580,6 +1145,50 @@ static llvm_to_ar::Importer::ImportOptions make_import_options() {
   return opts;
 }
 
+/// \brief Return a key identifying the given bitcode and the import options,
+/// for the verification cache
+static std::string verify_cache_key(llvm::StringRef bitcode) {
+  llvm::MD5 md5;
+  md5.update(bitcode);
+  md5.update(llvm::StringRef(NoLibIkos ? "1" : "0"));
+  md5.update(llvm::StringRef(NoLibc ? "1" : "0"));
+  md5.update(llvm::StringRef(NoLibcpp ? "1" : "0"));
+  md5.update(llvm::StringRef(AllowDebugInfoMismatch ? "1" : "0"));
+  md5.update(llvm::StringRef(LazyImport ? "1" : "0"));
+  if (Preprocess.getNumOccurrences() > 0) {
+    md5.update(std::to_string(static_cast< int >(Preprocess.getValue())));
+    md5.update(llvm::StringRef(PreprocessInlineAll ? "1" : "0"));
+    md5.update(llvm::StringRef(PreprocessInternalize ? "1" : "0"));
+  }
+  llvm::MD5::MD5Result result;
+  md5.final(result);
+  llvm::SmallString< 32 > str;
+  llvm::MD5::stringifyResult(result, str);
+  return std::string(str.data(), str.size());
+}
+
+/// \brief Return true if the given key is in the verification cache
+static bool verify_cache_contains(const std::string& key) {
+  std::ifstream in(VerifyCacheFilename);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line == key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// \brief Add the given key in the verification cache
+static void verify_cache_insert(const std::string& key) {
+  std::ofstream out(VerifyCacheFilename, std::ios::app);
+  out << key << '\n';
+  if (!out) {
+    analyzer::log::warning("could not write verification cache '" +
+                           VerifyCacheFilename + "'");
+  }
+}
+
 /// \brief Build format options from command line arguments
 static ar::Formatter::FormatOptions make_format_options() {
   ar::Formatter::FormatOptions opts;
@@ -590,8 +1199,9 @@ static ar::Formatter::FormatOptions make_format_options() {
 }
 
 /// \brief Parse a list of function names and return a list of functions
-static std::vector< ar::Function* > parse_function_names(
-    const llvm::cl::list< std::string >& opt, ar::Bundle* bundle) {
+template < typename Names >
+static std::vector< ar::Function* > parse_function_names(const Names& opt,
+                                                         ar::Bundle* bundle) {
   std::vector< ar::Function* > functions;
 
   if (std::find(opt.begin(), opt.end(), "*") != opt.end()) {
@@ -624,22 +1234,285 @@ static std::vector< ar::Function* > parse_function_names(
   return functions;
 }
 
+/// \brief Return the number of threads used by the analysis
+static unsigned analysis_jobs() {
+#ifdef IKOS_SINGLE_THREADED
+  // Patricia trees use non-atomic reference counters
+  return 1;
+#else
+  return std::max(Jobs.getValue(), 1U);
+#endif
+}
+
+/// \brief Run the given passes and record the time spent in each pass
+///
+/// The time of a code pass is summed over all threads.
+static void run_passes(ar::PassManager& passes,
+                       ar::Bundle* bundle,
+                       analyzer::OutputDatabase& output_db) {
+  for (std::size_t i = 0; i < passes.num_passes(); i++) {
+    analyzer::log::debug("Running " + std::string(passes.pass(i).name()) +
+                         " pass on AR");
+  }
+
+  passes.run(bundle);
+
+  for (std::size_t i = 0; i < passes.num_passes(); i++) {
+    const ar::Pass& pass = passes.pass(i);
+    const ar::PassManager::Statistics& stats = passes.statistics(i);
+    output_db.times.insert("ikos-analyzer." + std::string(pass.name()),
+                           stats.time.count());
+    analyzer::log::debug("Pass " + std::string(pass.name()) + ": " +
+                         std::to_string(stats.statements) +
+                         " statements added");
+  }
+}
+
+/// \brief Mark the codes of the given bundle as verified
+///
+/// Only the codes modified by the passes afterward are verified again.
+static void mark_clean(ar::Bundle* bundle) {
+  for (auto it = bundle->global_begin(), et = bundle->global_end(); it != et;
+       ++it) {
+    if ((*it)->is_definition()) {
+      (*it)->initializer()->mark_clean();
+    }
+  }
+  for (auto it = bundle->function_begin(), et = bundle->function_end();
+       it != et;
+       ++it) {
+    if ((*it)->is_definition()) {
+      (*it)->body()->mark_clean();
+    }
+  }
+}
+
+/// \brief Parse the shard option, i.e "<index>/<count>"
+static boost::optional< analyzer::ShardOption > parse_shard() {
+  if (Shard.empty()) {
+    return boost::none;
+  }
+
+  llvm::StringRef index;
+  llvm::StringRef count;
+  std::tie(index, count) = llvm::StringRef(Shard).split('/');
+  analyzer::ShardOption shard{0, 0};
+  if (index.getAsInteger(10, shard.index) ||
+      count.getAsInteger(10, shard.count) || shard.count == 0 ||
+      shard.index >= shard.count) {
+    throw analyzer::ArgumentError("invalid shard '" + Shard +
+                                  "', expected <i>/<n> with 0 <= i < n");
+  }
+  return shard;
+}
+
+/// \brief Return true if the given function is defined in one of the files
+/// given by -only-file
+static bool is_in_only_files(ar::Function* fun) {
+  if (!fun->has_frontend()) {
+    return false;
+  }
+  llvm::DISubprogram* dbg = fun->frontend< llvm::Function >()->getSubprogram();
+  if (dbg == nullptr || dbg->getFile() == nullptr) {
+    return false;
+  }
+
+  std::string path = analyzer::source_path(dbg->getFile()).string();
+  for (const std::string& file : OnlyFiles) {
+    // Either the same absolute path, or a path relative to the build
+    // directory of the file
+    if (path == boost::filesystem::absolute(file).string() ||
+        llvm::StringRef(path).endswith("/" + file)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// \brief Return the functions selected by -functions, -only-file and
+/// -only-function, or an empty list to select all functions
+static std::vector< ar::Function* > select_functions(ar::Bundle* bundle) {
+  std::vector< ar::Function* > functions =
+      parse_function_names(Functions, bundle);
+  if (OnlyFiles.empty() && OnlyFunctions.empty()) {
+    return functions;
+  }
+
+  std::vector< llvm::Regex > regexes;
+  for (const std::string& pattern : OnlyFunctions) {
+    llvm::Regex regex(pattern);
+    std::string error;
+    if (!regex.isValid(error)) {
+      throw analyzer::ArgumentError("invalid regular expression '" + pattern +
+                                    "': " + error);
+    }
+    regexes.push_back(std::move(regex));
+  }
+
+  for (auto it = bundle->function_begin(), et = bundle->function_end();
+       it != et;
+       ++it) {
+    ar::Function* fun = *it;
+    if (!fun->is_definition() ||
+        std::find(functions.begin(), functions.end(), fun) !=
+            functions.end()) {
+      continue;
+    }
+
+    bool selected = is_in_only_files(fun);
+    for (const llvm::Regex& regex : regexes) {
+      selected = selected || regex.match(fun->name()) ||
+                 regex.match(analyzer::demangle(fun));
+    }
+    if (selected) {
+      functions.push_back(fun);
+    }
+  }
+
+  if (functions.empty()) {
+    throw analyzer::ArgumentError(
+        "no function matches -only-file or -only-function");
+  }
+  analyzer::log::debug("Selected " + std::to_string(functions.size()) +
+                       " functions");
+  return functions;
+}
+
+/// \brief Parse the name of an abstract domain, for the given option
+static analyzer::MachineIntDomainOption parse_domain(const std::string& name,
+                                                     const char* option) {
+#ifdef IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN
+  throw analyzer::ArgumentError("this binary only supports the '" +
+                                std::string(
+                                    analyzer::machine_int_domain_option_str(
+                                        analyzer::value::
+                                            StaticMachineIntDomainOption)) +
+                                "' abstract domain, -" + option +
+                                " is not available");
+#else
+  analyzer::MachineIntDomainOption domain;
+  if (Domain.getParser().parse(Domain, Domain.ArgStr, name, domain)) {
+    throw analyzer::ArgumentError("unknown abstract domain '" + name +
+                                  "' for -" + option);
+  }
+  return domain;
+#endif
+}
+
+/// \brief Parse the abstract domain of the re-analysis, see -refine-domain
+static boost::optional< analyzer::MachineIntDomainOption >
+parse_refine_domain() {
+  if (RefineDomain.empty()) {
+    return boost::none;
+  }
+  return parse_domain(RefineDomain, "refine-domain");
+}
+
+/// \brief Parse the abstract domains of specific functions, see
+/// -function-domain
+static std::unordered_map< ar::Function*, analyzer::MachineIntDomainOption >
+parse_function_domains(ar::Bundle* bundle) {
+  std::unordered_map< ar::Function*, analyzer::MachineIntDomainOption >
+      domains;
+  for (const auto& item : FunctionDomains) {
+    llvm::StringRef name;
+    llvm::StringRef domain;
+    std::tie(name, domain) = llvm::StringRef(item).rsplit(':');
+    if (domain.empty()) {
+      throw analyzer::ArgumentError("invalid -function-domain '" + item +
+                                    "', expected <function>:<domain>");
+    }
+    ar::Function* fun = bundle->function_or_null(name.str());
+    if (fun == nullptr || !fun->is_definition()) {
+      throw analyzer::ArgumentError("could not find function '" + name.str() +
+                                    "' for -function-domain");
+    }
+    domains[fun] = parse_domain(domain.str(), "function-domain");
+  }
+  return domains;
+}
+
+/// \brief Parse the abstract domain of the numeric kernels, see
+/// -kernel-domain
+static boost::optional< analyzer::MachineIntDomainOption >
+parse_kernel_domain() {
+  if (KernelDomain.empty()) {
+    return boost::none;
+  }
+  return parse_domain(KernelDomain, "kernel-domain");
+}
+
+/// \brief Parse the entry points, keeping the ones of the shard for an
+/// interprocedural analysis
+static std::vector< ar::Function* > parse_entry_points(
+    ar::Bundle* bundle, const boost::optional< analyzer::ShardOption >& shard) {
+  std::vector< ar::Function* > entry_points =
+      parse_function_names(EntryPoints, bundle);
+  if (shard && Procedural == analyzer::Procedural::Interprocedural) {
+    entry_points = shard->select(entry_points);
+  }
+  return entry_points;
+}
+
 /// \brief Build analysis options from command line arguments
 static analyzer::AnalysisOptions make_analysis_options(ar::Bundle* bundle) {
+  boost::optional< analyzer::ShardOption > shard = parse_shard();
   return analyzer::AnalysisOptions{
       .analyses = {Analyses.begin(), Analyses.end()},
-      .entry_points = parse_function_names(EntryPoints, bundle),
+      .entry_points = parse_entry_points(bundle, shard),
       .no_init_globals = parse_function_names(NoInitGlobals, bundle),
+      .functions = select_functions(bundle),
       .machine_int_domain = Domain,
+      .function_domains = parse_function_domains(bundle),
+      .kernel_domain = parse_kernel_domain(),
+      .max_pack_size = MaxPackSize,
+      .apron_max_size = ApronMaxSize,
+      .apron_timeout = ApronTimeout,
       .procedural = Procedural,
       .use_liveness = !NoLiveness,
       .use_pointer = !NoPointer,
+      .use_frame_projection = FrameProjection,
       .precision = Precision,
       .globals_init_policy = GlobalsInitPolicy,
       .display_invariants = DisplayInvariants,
       .display_checks = DisplayChecks,
       .hardware_addresses = {bundle, HardwareAddresses, HardwareAddressesFile},
       .argc = ((Argc >= 0) ? boost::optional< int >(Argc) : boost::none),
+      .context_depth = ((ContextDepth >= 0)
+                            ? boost::optional< unsigned >(ContextDepth)
+                            : boost::none),
+      .low_memory = LowMemory,
+      .release_functions = ReleaseFunctions || ReleaseAR,
+      .release_bodies = ReleaseAR,
+      .sparse = Sparse,
+      .function_timeout = ((FunctionTimeout > 0)
+                               ? boost::optional< unsigned >(FunctionTimeout)
+                               : boost::none),
+      .function_max_steps = ((FunctionMaxSteps > 0)
+                                 ? boost::optional< unsigned >(FunctionMaxSteps)
+                                 : boost::none),
+      .deadline = ((Deadline > 0) ? boost::optional< unsigned >(Deadline)
+                                  : boost::none),
+      .refine_domain = parse_refine_domain(),
+      .refine_timeout = ((RefineTimeout > 0)
+                             ? boost::optional< unsigned >(RefineTimeout)
+                             : boost::none),
+      .tuning_file = (!TuningFilename.empty()
+                          ? boost::optional< std::string >(TuningFilename)
+                          : boost::none),
+      .fixpoint_stats = FixpointStats,
+      .transfer_stats = TransferStats,
+      .state_stats = StateStats,
+      .max_cells = ((MaxCells > 0) ? boost::optional< unsigned >(MaxCells)
+                                   : boost::none),
+      .aggregate_checks = ((AggregateChecks > 0)
+                               ? boost::optional< unsigned >(AggregateChecks)
+                               : boost::none),
+      .skip_safe_contexts = SkipSafeContexts,
+      .group_contexts = GroupContexts,
+      .trivial_checks = TrivialChecks,
+      .jobs = analysis_jobs(),
+      .shard = shard,
   };
 }
 
@@ -684,10 +1557,303 @@ static void generate_dot(ar::Bundle* bundle,
   }
 }
 
+/// \brief Run the value analysis and check properties
+static void run_value_analysis(analyzer::Context& ctx) {
+  if (ctx.opts.max_cells) {
+    analyzer::value::MemoryAbstractDomain::set_max_cells_per_location(
+        *ctx.opts.max_cells);
+  }
+  if (ctx.opts.procedural == analyzer::Procedural::Interprocedural) {
+    analyzer::InterproceduralValueAnalysis analysis(ctx);
+    analyzer::log::info("Running interprocedural value analysis");
+    analyzer::ScopeTimerDatabase t(ctx.output_db->times,
+                                   "ikos-analyzer.value-analysis");
+    analysis.run();
+  } else if (ctx.opts.procedural == analyzer::Procedural::Intraprocedural) {
+    analyzer::IntraproceduralValueAnalysis analysis(ctx);
+    analyzer::log::info("Running intraprocedural value analysis");
+    analyzer::ScopeTimerDatabase t(ctx.output_db->times,
+                                   "ikos-analyzer.value-analysis");
+    analysis.run();
+  } else {
+    ikos_unreachable("unreachable");
+  }
+
+  if (ctx.opts.aggregate_checks) {
+    analyzer::log::debug("Writing aggregated checks");
+    ctx.output_db->checks.write_aggregated();
+  }
+}
+
+/// \brief Return the output database of the given worker process
+static std::string worker_output_filename(unsigned index) {
+  return OutputFilename + "." + std::to_string(index);
+}
+
+/// \brief Run the value analysis of a shard, in a worker process
+static void run_worker(const analyzer::Context& ctx,
+                       analyzer::ShardOption shard) {
+  analyzer::log::set_thread_prefix("[process " + std::to_string(shard.index) +
+                                   "] ");
+
+  analyzer::AnalysisOptions opts = ctx.opts;
+  opts.shard = shard;
+  if (opts.procedural == analyzer::Procedural::Interprocedural) {
+    opts.entry_points = shard.select(opts.entry_points);
+  }
+
+  std::string filename = worker_output_filename(shard.index);
+  analyzer::log::debug("Creating output database '" + filename + "'");
+  llvm::sys::fs::remove(filename);
+  analyzer::sqlite::DbConnection db(filename);
+  db.set_journal_mode(analyzer::sqlite::JournalMode::Off);
+  db.set_synchronous_flag(analyzer::sqlite::SynchronousFlag::Off);
+  analyzer::OutputDatabase output_db(db, DeferDbIndexes);
+
+  opts.save(output_db.settings);
+  if (opts.aggregate_checks) {
+    output_db.checks.enable_aggregation(*opts.aggregate_checks);
+  }
+
+  analyzer::Context worker_ctx(ctx, opts);
+  worker_ctx.output_db = &output_db;
+
+  // The monitor thread of the parent does not exist in the worker
+  std::unique_ptr< analyzer::MemoryGovernor > memory_governor;
+  if (ctx.memory_governor != nullptr) {
+    memory_governor =
+        std::make_unique< analyzer::MemoryGovernor >(SoftMemLimit,
+                                                     SpillMemLimit);
+    worker_ctx.memory_governor = memory_governor.get();
+    output_db.checks.set_memory_governor(memory_governor.get());
+  }
+
+  run_value_analysis(worker_ctx);
+
+  if (DeferDbIndexes) {
+    output_db.create_indexes();
+  }
+}
+
+/// \brief Run the value analysis on forked worker processes
+///
+/// Each worker analyzes a shard of the functions, or of the entry points for
+/// the interprocedural analysis, and writes its results in its own output
+/// database, see worker_output_filename(). The AR and the results of the
+/// pre-analyses are shared with the workers through copy-on-write pages, and
+/// no state is shared between the abstract domains of different workers.
+///
+/// Only the calling thread exists in the workers, hence the options starting
+/// threads before the value analysis are rejected, and the memory governor is
+/// replaced in each worker.
+static void run_value_analysis_processes(const analyzer::Context& ctx,
+                                         unsigned num_workers) {
+  // Do not duplicate buffered outputs in the workers
+  llvm::outs().flush();
+  llvm::errs().flush();
+  std::fflush(nullptr);
+
+  std::vector< pid_t > workers;
+  int fork_error = 0;
+  for (unsigned i = 0; i < num_workers; i++) {
+    pid_t pid = ::fork();
+    if (pid < 0) {
+      fork_error = errno;
+      break;
+    }
+    if (pid == 0) {
+      int status = 0;
+      try {
+        run_worker(ctx, analyzer::ShardOption{i, num_workers});
+      } catch (std::exception& err) {
+        analyzer::log::error(err.what());
+        status = 1;
+      } catch (...) {
+        analyzer::log::error("unexpected exception in worker process");
+        status = 1;
+      }
+      llvm::outs().flush();
+      llvm::errs().flush();
+      // Skip the destructors and exit handlers of the parent
+      ::_exit(status);
+    }
+    workers.push_back(pid);
+  }
+
+  unsigned failed = 0;
+  for (pid_t pid : workers) {
+    int status = 0;
+    while (::waitpid(pid, &status, 0) < 0) {
+      if (errno != EINTR) {
+        status = -1;
+        break;
+      }
+    }
+    if (status == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      failed++;
+    }
+  }
+
+  if (fork_error != 0) {
+    throw std::system_error(fork_error,
+                            std::generic_category(),
+                            "could not fork worker process");
+  }
+  if (failed > 0) {
+    throw std::runtime_error(std::to_string(failed) + " out of " +
+                             std::to_string(num_workers) +
+                             " worker processes failed");
+  }
+}
+
+/// \brief Split a comma separated list
+static std::vector< std::string > split_list(const std::string& list) {
+  std::vector< std::string > items;
+  std::size_t begin = 0;
+  while (begin <= list.size()) {
+    std::size_t end = list.find(',', begin);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    if (end > begin) {
+      items.push_back(list.substr(begin, end - begin));
+    }
+    begin = end + 1;
+  }
+  return items;
+}
+
+/// \brief Answer a value analysis request of the server
+///
+/// A request is a list of `key=value` lines:
+///   * `output`: path of the output database (required)
+///   * `entry-points`: comma separated list of entry points
+///   * `analyses`: comma separated list of analyses, see -a
+///   * `functions`: comma separated list of functions to check, see -functions
+///
+/// Other settings are the ones given on the command line of the server.
+static void answer_request(const analyzer::Context& warm,
+                           const std::map< std::string, std::string >& req) {
+  auto output = req.find("output");
+  if (output == req.end() || output->second.empty()) {
+    throw analyzer::ArgumentError("missing output database");
+  }
+
+  analyzer::AnalysisOptions opts = warm.opts;
+  auto it = req.find("entry-points");
+  if (it != req.end()) {
+    opts.entry_points = parse_function_names(split_list(it->second),
+                                             warm.bundle);
+  }
+  it = req.find("analyses");
+  if (it != req.end()) {
+    opts.analyses.clear();
+    for (const std::string& name : split_list(it->second)) {
+      analyzer::CheckerName checker;
+      if (Analyses.getParser().parse(Analyses, Analyses.ArgStr, name, checker)) {
+        throw analyzer::ArgumentError("unknown analysis '" + name + "'");
+      }
+#ifdef IKOS_ANALYZER_PRUNED_DOMAINS
+      if (analyzer::checker_needs_uninitialized(checker) ||
+          analyzer::checker_needs_lifetime(checker)) {
+        throw analyzer::ArgumentError("this binary does not support the '" +
+                                      name + "' analysis");
+      }
+#endif
+      opts.analyses.push_back(checker);
+    }
+  }
+  it = req.find("functions");
+  if (it != req.end()) {
+    opts.functions = parse_function_names(split_list(it->second),
+                                          warm.bundle);
+  }
+
+  analyzer::log::debug("Creating output database '" + output->second + "'");
+  analyzer::sqlite::DbConnection db(output->second);
+  db.set_journal_mode(analyzer::sqlite::JournalMode::Off);
+  db.set_synchronous_flag(analyzer::sqlite::SynchronousFlag::Off);
+  analyzer::OutputDatabase output_db(db, DeferDbIndexes);
+
+  opts.save(output_db.settings);
+  if (opts.aggregate_checks) {
+    output_db.checks.enable_aggregation(*opts.aggregate_checks);
+  }
+
+  // Reuse the factories and the results of the pre-analyses
+  analyzer::Context ctx(warm, opts);
+  ctx.output_db = &output_db;
+  ctx.function_cache = nullptr;
+
+  // The cache depends on the analysis options of the request
+  std::unique_ptr< analyzer::FunctionCache > function_cache;
+  if (!CacheFilename.empty()) {
+    function_cache =
+        std::make_unique< analyzer::FunctionCache >(CacheFilename, opts);
+    ctx.function_cache = function_cache.get();
+  }
+
+  run_value_analysis(ctx);
+
+  if (function_cache != nullptr) {
+    function_cache->save();
+  }
+
+  if (DeferDbIndexes) {
+    output_db.create_indexes();
+  }
+}
+
+/// \brief Serve value analysis requests on a local socket
+///
+/// Each connection sends one request, see answer_request(), terminated by an
+/// empty line or the end of the stream. The server answers with a single line,
+/// `ok <seconds>` or `error <message>`, and closes the connection. A request
+/// with a `quit` line stops the server.
+static void serve(const analyzer::Context& warm) {
+  analyzer::LocalSocketServer server(ServerSocket);
+  analyzer::log::info("Listening on '" + server.path() + "'");
+
+  while (true) {
+    analyzer::LocalSocketConnection connection = server.accept();
+
+    std::map< std::string, std::string > request;
+    std::string line;
+    while (connection.read_line(line) && !line.empty()) {
+      std::size_t eq = line.find('=');
+      if (eq == std::string::npos) {
+        request[line] = "";
+      } else {
+        request[line.substr(0, eq)] = line.substr(eq + 1);
+      }
+    }
+
+    if (request.count("quit") > 0) {
+      connection.write_line("ok");
+      return;
+    }
+
+    try {
+      analyzer::Timer timer;
+      timer.start();
+      answer_request(warm, request);
+      timer.stop();
+      connection.write_line("ok " + std::to_string(timer.elapsed().count()));
+    } catch (std::exception& err) {
+      // catch any std::exception, core::Exception or analyzer::Exception
+      analyzer::log::error(err.what());
+      connection.write_line(std::string("error ") + err.what());
+    }
+  }
+}
+
 /// \brief Main for ikos-analyzer
 int main(int argc, char** argv) {
   llvm::InitLLVM X(argc, argv);
 
+  // Serve small GMP numbers from thread-local pools
+  analyzer::gmp_allocator::install();
+
   // Program name
   std::string progname = boost::filesystem::path(argv[0]).filename().string();
 
@@ -697,6 +1863,10 @@ int main(int argc, char** argv) {
   // LLVM context
   llvm::LLVMContext llvm_context;
 
+  // Merge the debug info types sharing the same ODR identifier, so that the
+  // C++ types defined in several translation units are only imported once
+  llvm_context.enableDebugTypeODRUniquing();
+
   /*
    * Parse parameters
    */
@@ -706,39 +1876,321 @@ int main(int argc, char** argv) {
 
   // Set log level
   analyzer::log::Level = LogLevel;
+  if (AsyncLog) {
+    analyzer::log::start_async();
+  }
 
   // Enable colors, if asked
   analyzer::color::Enable = colors_enabled();
 
+#ifdef IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN
+  // This binary is compiled for a single machine integer abstract domain
+  if (Domain != analyzer::value::StaticMachineIntDomainOption) {
+    llvm::errs() << progname << ": error: this binary only supports the '"
+                 << analyzer::machine_int_domain_option_str(
+                        analyzer::value::StaticMachineIntDomainOption)
+                 << "' abstract domain, use ikos-analyzer instead\n";
+    return 1;
+  }
+#endif
+
+#ifdef IKOS_ANALYZER_DOMAIN_PLUGINS
+  // Load the module of the abstract domain before the pre-processing
+  try {
+    analyzer::value::load_machine_int_domain(Domain);
+  } catch (analyzer::LogicError& err) {
+    llvm::errs() << progname << ": error: " << err.what() << "\n";
+    return 1;
+  }
+#endif
+
+#ifdef IKOS_ANALYZER_PRUNED_DOMAINS
+  // This binary does not track uninitialized variables and lifetimes
+  for (analyzer::CheckerName checker : Analyses) {
+    if (analyzer::checker_needs_uninitialized(checker) ||
+        analyzer::checker_needs_lifetime(checker)) {
+      llvm::errs() << progname << ": error: this binary does not support the '"
+                   << analyzer::checker_short_name(checker)
+                   << "' analysis, use ikos-analyzer instead\n";
+      return 1;
+    }
+  }
+#endif
+
+  if (!CheckpointFilename.empty() && !CacheFilename.empty()) {
+    llvm::errs() << progname << ": error: -checkpoint is not compatible with "
+                 << "-cache\n";
+    return 1;
+  }
+  if (Processes > 1 &&
+      (!Shard.empty() || !ServerSocket.empty() || !CacheFilename.empty() ||
+       !CheckpointFilename.empty() || !EmitLibrarySummaryFilename.empty() ||
+       !StreamChecksFilename.empty() || !ProgressFilename.empty() ||
+       !TraceFilename.empty() || AsyncOutput || AsyncLog ||
+       OutputFormat == analyzer::OutputFormat::Columnar)) {
+    llvm::errs() << progname << ": error: -processes is not compatible with "
+                 << "-shard, -server, -cache, -checkpoint, "
+                 << "-emit-library-summary, -stream-checks, -progress, "
+                 << "-trace, -async-db, -async-log and -format=columnar\n";
+    return 1;
+  }
+  if (LiveOutput && (Processes > 1 || !ServerSocket.empty() ||
+                     OutputFormat == analyzer::OutputFormat::Columnar)) {
+    llvm::errs() << progname << ": error: -live-db is not compatible with "
+                 << "-processes, -server and -format=columnar\n";
+    return 1;
+  }
+  if (TrivialChecks && (!Shard.empty() || Processes > 1 ||
+                        !ServerSocket.empty() || !CheckpointFilename.empty())) {
+    llvm::errs() << progname << ": error: -trivial-checks is not compatible "
+                 << "with -shard, -processes, -server and -checkpoint\n";
+    return 1;
+  }
+  if (!LibrarySummaryFilenames.empty() &&
+      (!CacheFilename.empty() || !CheckpointFilename.empty())) {
+    llvm::errs() << progname << ": error: -library-summary is not compatible "
+                 << "with -cache and -checkpoint\n";
+    return 1;
+  }
+  if (!EmitLibrarySummaryFilename.empty() &&
+      Procedural != analyzer::Procedural::Intraprocedural) {
+    llvm::errs() << progname
+                 << ": error: -emit-library-summary requires -proc=intra\n";
+    return 1;
+  }
+  if (!EmitLibrarySummaryFilename.empty() && !ServerSocket.empty()) {
+    llvm::errs() << progname << ": error: -emit-library-summary is not "
+                 << "compatible with -server\n";
+    return 1;
+  }
+  if (Sparse && Precision != analyzer::Precision::Register) {
+    llvm::errs() << progname << ": error: -sparse requires -prec=reg\n";
+    return 1;
+  }
+  if (Sparse && Procedural != analyzer::Procedural::Intraprocedural) {
+    llvm::errs() << progname << ": error: -sparse requires -proc=intra\n";
+    return 1;
+  }
+  if ((ReleaseFunctions || ReleaseAR) &&
+      Procedural != analyzer::Procedural::Intraprocedural) {
+    llvm::errs() << progname << ": error: -release-functions and -release-ar "
+                 << "require -proc=intra\n";
+    return 1;
+  }
+  if ((ReleaseFunctions || ReleaseAR) && !ServerSocket.empty()) {
+    llvm::errs() << progname << ": error: -release-functions and -release-ar "
+                 << "are not compatible with -server\n";
+    return 1;
+  }
+  if (ReleaseAR && (!CacheFilename.empty() || !CheckpointFilename.empty() ||
+                    AggregateChecks > 0)) {
+    llvm::errs() << progname << ": error: -release-ar is not compatible with "
+                 << "-cache, -checkpoint and -aggregate-checks\n";
+    return 1;
+  }
+  if ((!FunctionDomains.empty() || !KernelDomain.empty()) &&
+      Procedural != analyzer::Procedural::Intraprocedural) {
+    llvm::errs() << progname
+                 << ": error: -function-domain and -kernel-domain require "
+                    "-proc=intra\n";
+    return 1;
+  }
+  if (!TuningFilename.empty() && NoFixpointProfiles) {
+    llvm::errs() << progname
+                 << ": error: -tuning requires the fixpoint profiles "
+                    "analysis\n";
+    return 1;
+  }
+  if (Resume && CheckpointFilename.empty()) {
+    llvm::errs() << progname << ": error: -resume requires -checkpoint\n";
+    return 1;
+  }
+  if (DomainTraceFilename.empty() != DomainTraceFunction.empty()) {
+    llvm::errs() << progname << ": error: -domain-trace and "
+                 << "-domain-trace-function must be used together\n";
+    return 1;
+  }
+  if (!DomainTraceFilename.empty() &&
+      Procedural != analyzer::Procedural::Intraprocedural) {
+    llvm::errs() << progname << ": error: -domain-trace requires -proc=intra\n";
+    return 1;
+  }
+#ifdef IKOS_ANALYZER_STATIC_MACHINE_INT_DOMAIN
+  if (!DomainTraceFilename.empty()) {
+    llvm::errs() << progname << ": error: this binary does not support "
+                 << "-domain-trace, use ikos-analyzer instead\n";
+    return 1;
+  }
+#endif
+
   try {
 #ifndef NDEBUG
     analyzer::log::warning(
         "ikos was compiled in debug mode, the analysis might be slow");
 #endif
+#ifdef IKOS_SINGLE_THREADED
+    if (Jobs > 1) {
+      analyzer::log::warning(
+          "ikos was compiled without thread support, ignoring -jobs");
+    }
+#endif
+
+    if (Numa) {
+      analyzer::ThreadPool::enable_numa_placement();
+    }
+
+    if (EnablePerfCounters) {
+      std::string error;
+      if (!analyzer::PerfCounters::enable(error)) {
+        analyzer::log::warning("could not enable the performance counters: " +
+                               error);
+      }
+    }
+
+    if (EnableAllocationStats) {
+      std::string error;
+      if (!analyzer::AllocationStats::enable(error)) {
+        analyzer::log::warning("could not record the allocations: " + error);
+      }
+    }
+
+    if (!TraceFilename.empty()) {
+      analyzer::Tracer::enable();
+    }
+
+    if (!ProgressFilename.empty() &&
+        !analyzer::Progress::enable(ProgressFilename,
+                                    std::chrono::milliseconds(
+                                        std::max(ProgressInterval.getValue(),
+                                                 1U)))) {
+      llvm::errs() << progname << ": " << ProgressFilename
+                   << ": error: could not open file\n";
+      return 1;
+    }
 
     // Initialize output database
     // This might throw DbError, see catch()
     analyzer::log::debug("Creating output database '" + OutputFilename + "'");
     analyzer::sqlite::DbConnection db(OutputFilename);
-    db.set_journal_mode(analyzer::sqlite::JournalMode::Off);
+    if (LiveOutput) {
+      db.set_journal_mode(analyzer::sqlite::JournalMode::WAL);
+      db.set_publish_interval(std::chrono::seconds(2));
+    } else {
+      db.set_journal_mode(analyzer::sqlite::JournalMode::Off);
+    }
     db.set_synchronous_flag(analyzer::sqlite::SynchronousFlag::Off);
-    analyzer::OutputDatabase output_db(db);
+    if (OutputFormat == analyzer::OutputFormat::Columnar) {
+      std::string directory = OutputFilename + ".col";
+      std::error_code err = llvm::sys::fs::create_directories(directory);
+      if (err) {
+        llvm::errs() << progname << ": " << directory
+                     << ": error: " << err.message() << "\n";
+        return 1;
+      }
+      db.set_columnar_tables(directory,
+                             {"checks", "statements", "operands",
+                              "call_contexts"});
+    }
+    analyzer::OutputDatabase output_db(db, DeferDbIndexes);
+
+    // Initialize the stream of checks
+    std::unique_ptr< llvm::raw_fd_ostream > checks_stream;
+    if (!StreamChecksFilename.empty()) {
+      std::error_code ec;
+      checks_stream =
+          std::make_unique< llvm::raw_fd_ostream >(StreamChecksFilename,
+                                                   ec,
+                                                   llvm::sys::fs::F_None);
+      if (ec) {
+        llvm::errs() << progname << ": " << StreamChecksFilename
+                     << ": error: " << ec.message() << "\n";
+        return 1;
+      }
+      output_db.checks.enable_stream(*checks_stream);
+    }
+    if (AsyncOutput) {
+      db.set_commit_policy(analyzer::sqlite::CommitPolicy::Async);
+    }
 
     // Load the input module
     std::unique_ptr< llvm::Module > module = nullptr;
+    bool verified = false;
+    std::string verify_key;
     {
       analyzer::log::debug("Loading LLVM bitcode");
       analyzer::ScopeTimerDatabase t(output_db.times, "ikos-analyzer.load-bc");
+      llvm::ErrorOr< std::unique_ptr< llvm::MemoryBuffer > > buffer =
+          llvm::MemoryBuffer::getFileOrSTDIN(InputFilename);
+      if (!buffer) {
+        llvm::errs() << progname << ": " << InputFilename
+                     << ": error: " << buffer.getError().message() << "\n";
+        return 2;
+      }
+      if (!VerifyCacheFilename.empty()) {
+        verify_key = verify_cache_key((*buffer)->getBuffer());
+        verified = verify_cache_contains(verify_key);
+      }
       llvm::SMDiagnostic err; // Error diagnostic
-      module = llvm::parseIRFile(InputFilename, err, llvm_context);
+      if (LazyImport) {
+        module = llvm::getLazyIRModule(std::move(*buffer), err, llvm_context);
+      } else {
+        module =
+            llvm::parseIR((*buffer)->getMemBufferRef(), err, llvm_context);
+      }
       if (!module) {
         err.print(progname.c_str(), llvm::errs());
         return 2;
       }
     }
 
+    // Run the ikos-pp preprocessing on the loaded module, instead of writing
+    // and parsing the preprocessed bitcode again
+    if (Preprocess.getNumOccurrences() > 0) {
+      if (LazyImport) {
+        llvm::errs() << progname << ": error: -pp-opt is not compatible with "
+                     << "-lazy-import\n";
+        return 1;
+      }
+
+      analyzer::log::debug("Preprocessing LLVM bitcode");
+      analyzer::ScopeTimerDatabase t(output_db.times,
+                                     "ikos-analyzer.preprocess-bc");
+
+      // The preprocessing passes expect a valid module
+      if (!verified && verifyModule(*module, &llvm::errs())) {
+        llvm::errs() << progname << ": " << InputFilename
+                     << ": error: input module is broken!\n";
+        return 3;
+      }
+
+      llvm::legacy::PassManager pass_manager;
+      std::vector< std::string > entry_points(EntryPoints.begin(),
+                                              EntryPoints.end());
+      ikos_pp::addPreprocessingPasses(pass_manager,
+                                      Preprocess,
+                                      entry_points,
+                                      PreprocessInlineAll,
+                                      PreprocessInternalize);
+      pass_manager.run(*module);
+    }
+
+    // Load the functions reachable from the entry points
+    // This might throw ImportError, see catch()
+    if (LazyImport) {
+      analyzer::log::debug("Loading functions reachable from entry points");
+      analyzer::ScopeTimerDatabase t(output_db.times,
+                                     "ikos-analyzer.materialize-bc");
+      std::vector< std::string > entry_points(EntryPoints.begin(),
+                                              EntryPoints.end());
+      llvm_to_ar::materialize_reachable_functions(*module, entry_points);
+    }
+
+    if (verified) {
+      analyzer::log::debug("Skipping verification of unchanged bitcode");
+    }
+
     // Immediately run the verifier to catch any problems
-    {
+    if (!verified) {
       analyzer::log::debug("Verifying integrity of LLVM bitcode");
       analyzer::ScopeTimerDatabase t(output_db.times,
                                      "ikos-analyzer.verify-bc");
@@ -769,16 +2221,17 @@ int main(int argc, char** argv) {
       analyzer::log::info("Translating LLVM bitcode to AR");
       analyzer::ScopeTimerDatabase t(output_db.times,
                                      "ikos-analyzer.llvm-to-ar");
-      llvm_to_ar::Importer importer(ar_context);
+      llvm_to_ar::Importer importer(ar_context, analysis_jobs());
       bundle = importer.import(*module, make_import_options());
     }
 
     // Run type checker
-    if (!NoTypeCheck) {
+    if (!NoTypeCheck && !verified) {
       analyzer::log::debug("Running type verifier on AR");
       analyzer::ScopeTimerDatabase t(output_db.times,
                                      "ikos-analyzer.type-checker");
-      if (!ar::TypeVerifier(/*all = */ true).verify(bundle, std::cerr)) {
+      if (!ar::TypeVerifier(/*all = */ true)
+               .verify(bundle, std::cerr, analysis_jobs())) {
         llvm::errs() << progname << ": " << InputFilename
                      << ": error: type checker\n";
         return 7;
@@ -786,40 +2239,73 @@ int main(int argc, char** argv) {
     }
 
     // Check for debug information in AR
-    if (!ar::FrontendVerifier(/*all = */ true).verify(bundle, std::cerr)) {
+    if (!verified && !ar::FrontendVerifier(/*all = */ true)
+                          .verify(bundle, std::cerr, analysis_jobs())) {
       return 8;
     }
 
-    // Simplify the control flow graph
-    if (!NoSimplifyCFG) {
-      analyzer::log::debug("Running simplify-cfg pass on AR");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.simplify-cfg");
-      ar::SimplifyCFGPass().run(bundle);
+    if (!VerifyCacheFilename.empty() && !verified && !NoTypeCheck) {
+      verify_cache_insert(verify_key);
     }
 
-    // Add a loop counter in each cycle, for the Gauge domain
-    if (AddLoopCounters) {
-      analyzer::log::debug("Running add-loop-counters pass on AR");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.add-loop-counters");
-      ar::AddLoopCountersPass().run(bundle);
-    }
+    mark_clean(bundle);
+
+    // Run the AR passes
+    {
+      ar::PassManager passes(analysis_jobs());
+
+      // Remove the functions unreachable from the entry points
+      if (RemoveUnreachableFunctions &&
+          std::find(EntryPoints.begin(), EntryPoints.end(), "*") ==
+              EntryPoints.end()) {
+        passes.add(std::make_unique< ar::RemoveUnreachableFunctionsPass >(
+            parse_function_names(EntryPoints, bundle)));
+      }
+
+      // Propagate constants and remove dead stores
+      if (PropagateConstants) {
+        passes.add(std::make_unique< ar::PropagateConstantsPass >());
+      }
+
+      // Simplify the control flow graph
+      if (!NoSimplifyCFG) {
+        passes.add(std::make_unique< ar::SimplifyCFGPass >());
+      }
+
+      // Add loop counters, for the Gauge domain
+      if (AddLoopCounters) {
+        passes.add(std::make_unique< ar::AddLoopCountersPass >(
+            /* all_loops = */ AllLoopCounters));
+      }
+
+      // Simplify upcast comparison loop
+      if (!NoSimplifyUpcastComparison) {
+        passes.add(std::make_unique< ar::SimplifyUpcastComparisonPass >());
+      }
+
+      // Name variables and basic block, for debugging purpose only
+      if (NameValues) {
+        passes.add(std::make_unique< ar::NameValuesPass >(!NoNamePrefix));
+      }
 
-    // Simplify upcast comparison loop
-    if (!NoSimplifyUpcastComparison) {
-      analyzer::log::debug("Running simplify-upcast-comparison pass on AR");
-      analyzer::ScopeTimerDatabase
-          t(output_db.times, "ikos-analyzer.simplify-upcast-comparison");
-      ar::SimplifyUpcastComparisonPass().run(bundle);
+      run_passes(passes, bundle, output_db);
     }
 
-    // Name variables and basic block, for debugging purpose only
-    if (NameValues) {
-      analyzer::log::debug("Running name-values pass on AR");
+    // Run type checker on the codes modified by the passes
+    if (!NoTypeCheck) {
+      analyzer::log::debug("Running type verifier on the modified AR");
       analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.name-values");
-      ar::NameValuesPass(!NoNamePrefix).run(bundle);
+                                     "ikos-analyzer.type-checker-passes");
+      if (!ar::TypeVerifier(/*all = */ true)
+               .verify(bundle,
+                       std::cerr,
+                       analysis_jobs(),
+                       /*dirty_only = */ true)) {
+        llvm::errs() << progname << ": " << InputFilename
+                     << ": error: type checker after the AR passes\n";
+        return 7;
+      }
+      mark_clean(bundle);
     }
 
     // Display the abstract representation
@@ -828,7 +2314,7 @@ int main(int argc, char** argv) {
       analyzer::ScopeTimerDatabase t(output_db.times,
                                      "ikos-analyzer.display-ar");
       ar::TextFormatter formatter(make_format_options());
-      formatter.format(analyzer::log::out(), bundle);
+      formatter.format(analyzer::log::out(), bundle, analysis_jobs());
     }
 
     // Generate .dot files
@@ -842,12 +2328,33 @@ int main(int argc, char** argv) {
     // Save analysis options in the database
     analyzer::AnalysisOptions opts = make_analysis_options(bundle);
     opts.save(output_db.settings);
+    ikos::core::numeric::VarPackingSettings::set_max_pack_size(
+        opts.max_pack_size);
+#ifdef HAS_APRON
+    ikos::core::numeric::apron::limits() = {opts.apron_max_size,
+                                            opts.apron_timeout};
+#endif
+    if (OutputFormat == analyzer::OutputFormat::Columnar) {
+      output_db.settings.insert("format", "columnar");
+    }
+    if (opts.aggregate_checks) {
+      output_db.checks.enable_aggregation(*opts.aggregate_checks);
+    }
 
     // Initialize factories
     analyzer::MemoryFactory mem_factory;
     analyzer::VariableFactory var_factory(bundle);
     analyzer::LiteralFactory lit_factory(var_factory, bundle->data_layout());
-    analyzer::CallContextFactory call_context_factory;
+    analyzer::CallContextFactory call_context_factory(opts.context_depth);
+    ikos::core::WtoCache< ar::Code* > wto_cache;
+
+    // Monitor the memory usage
+    std::unique_ptr< analyzer::MemoryGovernor > memory_governor;
+    if (SoftMemLimit > 0 || SpillMemLimit > 0) {
+      memory_governor =
+          std::make_unique< analyzer::MemoryGovernor >(SoftMemLimit,
+                                                       SpillMemLimit);
+    }
 
     // Analysis context
     analyzer::Context ctx(bundle,
@@ -857,7 +2364,21 @@ int main(int argc, char** argv) {
                           mem_factory,
                           var_factory,
                           lit_factory,
-                          call_context_factory);
+                          call_context_factory,
+                          wto_cache);
+    ctx.memory_governor = memory_governor.get();
+    output_db.checks.set_memory_governor(memory_governor.get());
+
+    // Remove the statements that do not contribute to the requested checks
+    if (Slice) {
+      analyzer::CheckerList checkers(ctx);
+      ar::PassManager passes(analysis_jobs());
+      passes.add(std::make_unique< ar::SlicePass >(
+          [&checkers](ar::Statement* stmt) {
+            return checkers.handles(stmt->kind());
+          }));
+      run_passes(passes, bundle, output_db);
+    }
 
     // First, run a liveness analysis
     //
@@ -875,6 +2396,18 @@ int main(int argc, char** argv) {
       liveness.dump(analyzer::log::out());
     }
 
+    // Compute the fixed packs of variables, for the static variable packing
+    // domains
+    analyzer::VariablePackingAnalysis variable_packing(ctx);
+    if (opts.machine_int_domain ==
+        analyzer::MachineIntDomainOption::StaticPackDBM) {
+      analyzer::log::info("Running variable packing analysis");
+      analyzer::ScopeTimerDatabase t(output_db.times,
+                                     "ikos-analyzer.variable-packing-analysis");
+      variable_packing.run();
+      ctx.variable_packing = &variable_packing;
+    }
+
     // Run the fixpoint profile analysis
     //
     // This is used to detect widening hints, useful for other analyses
@@ -890,16 +2423,132 @@ int main(int argc, char** argv) {
       profiler.dump(analyzer::log::out());
     }
 
+    // Estimate the cost of the value analysis, and stop there
+    if (Estimate) {
+      analyzer::CallGraphAnalysis call_graph(ctx);
+      if (Procedural == analyzer::Procedural::Interprocedural) {
+        analyzer::log::info("Running call graph analysis");
+        analyzer::ScopeTimerDatabase t(output_db.times,
+                                       "ikos-analyzer.call-graph-analysis");
+        call_graph.run();
+        ctx.call_graph = &call_graph;
+      }
+      analyzer::log::info("Running cost estimate analysis");
+      analyzer::CostEstimateAnalysis estimate(ctx);
+      {
+        analyzer::ScopeTimerDatabase t(output_db.times,
+                                       "ikos-analyzer.cost-estimate-analysis");
+        estimate.run();
+      }
+      estimate.dump(analyzer::log::out());
+      if (AsyncOutput) {
+        db.set_commit_policy(analyzer::sqlite::CommitPolicy::Auto);
+      }
+      return 0;
+    }
+
+    // Load the cache of function results
+    std::unique_ptr< analyzer::FunctionCache > function_cache;
+    if (!CacheFilename.empty() && ServerSocket.empty()) {
+      analyzer::log::debug("Loading cache file '" + CacheFilename + "'");
+      function_cache =
+          std::make_unique< analyzer::FunctionCache >(CacheFilename, opts);
+      ctx.function_cache = function_cache.get();
+    } else if (!CheckpointFilename.empty() && ServerSocket.empty()) {
+      if (Resume) {
+        analyzer::log::info("Resuming from checkpoint '" +
+                            CheckpointFilename + "'");
+      } else {
+        // Start from scratch
+        llvm::sys::fs::remove(CheckpointFilename);
+      }
+      function_cache =
+          std::make_unique< analyzer::FunctionCache >(CheckpointFilename,
+                                                      opts);
+      function_cache->enable_checkpoints(
+          std::chrono::seconds(CheckpointInterval));
+      ctx.function_cache = function_cache.get();
+    }
+
+    // Load the summaries of library functions
+    analyzer::LibrarySummaries library_summaries;
+    for (const std::string& filename : LibrarySummaryFilenames) {
+      analyzer::log::debug("Loading summary package '" + filename + "'");
+      library_summaries.load(filename);
+    }
+    if (!LibrarySummaryFilenames.empty()) {
+      ctx.library_summaries = &library_summaries;
+    }
+    analyzer::LibrarySummaries library_summary_output;
+    if (!EmitLibrarySummaryFilename.empty()) {
+      ctx.library_summary_output = &library_summary_output;
+    }
+
+    // Record the operations on the machine integer abstract domain
+    std::ofstream domain_trace_file;
+    std::unique_ptr< ikos::core::machine_int::TraceWriter > domain_trace;
+    if (!DomainTraceFilename.empty()) {
+      domain_trace_file.open(DomainTraceFilename, std::ios::binary);
+      if (!domain_trace_file) {
+        llvm::errs() << progname << ": " << DomainTraceFilename
+                     << ": error: " << strerror(errno) << "\n";
+        return 1;
+      }
+      domain_trace =
+          std::make_unique< ikos::core::machine_int::TraceWriter >(
+              domain_trace_file);
+      ctx.domain_trace = domain_trace.get();
+      ctx.domain_trace_function =
+          parse_function_names(std::vector< std::string >{DomainTraceFunction},
+                               bundle)
+              .front();
+    }
+
+    // Compute the recursive components of the call graph
+    //
+    // Calls entering a recursive component share their fix-point
+    analyzer::CallGraphAnalysis call_graph(ctx);
+    if (Procedural == analyzer::Procedural::Interprocedural) {
+      analyzer::log::info("Running call graph analysis");
+      analyzer::ScopeTimerDatabase t(output_db.times,
+                                     "ikos-analyzer.call-graph-analysis");
+      call_graph.run();
+      ctx.call_graph = &call_graph;
+    }
+    if (DisplayCallGraph) {
+      call_graph.dump(analyzer::log::out());
+    }
+
     // Run a fast intraprocedural function pointer analysis
     //
     // The goal here is to get all function pointers so that we can analyse
-    // precisely indirect calls in the following analyses
+    // precisely indirect calls in the following analyses. The
+    // interprocedural analysis uses it to narrow the potential callees of
+    // indirect calls.
+    std::unique_ptr< analyzer::PointerCache > pointer_cache;
+    if (!PointerCacheFilename.empty() && !NoPointer) {
+      analyzer::log::debug("Loading pointer cache file '" +
+                           PointerCacheFilename + "'");
+      pointer_cache =
+          std::make_unique< analyzer::PointerCache >(PointerCacheFilename,
+                                                     ctx);
+    }
+
     analyzer::FunctionPointerAnalysis function_pointer(ctx);
-    if (Procedural == analyzer::Procedural::Intraprocedural && !NoPointer) {
-      analyzer::log::info("Running function pointer analysis");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.function-pointer-analysis");
-      function_pointer.run();
+    if (!NoPointer) {
+      if (pointer_cache != nullptr &&
+          pointer_cache->load("function-pointer", function_pointer.results())) {
+        analyzer::log::info("Using cached function pointer analysis results");
+      } else {
+        analyzer::log::info("Running function pointer analysis");
+        analyzer::ScopeTimerDatabase t(output_db.times,
+                                       "ikos-analyzer.function-pointer-"
+                                       "analysis");
+        function_pointer.run();
+        if (pointer_cache != nullptr) {
+          pointer_cache->save("function-pointer", function_pointer.results());
+        }
+      }
       ctx.function_pointer = &function_pointer;
     }
     if (DisplayFunctionPointer) {
@@ -911,31 +2560,85 @@ int main(int argc, char** argv) {
     // That step uses the result of the previous function pointer analysis.
     analyzer::PointerAnalysis pointer(ctx, function_pointer);
     if (Procedural == analyzer::Procedural::Intraprocedural && !NoPointer) {
-      analyzer::log::info("Running pointer analysis");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.pointer-analysis");
-      pointer.run();
+      if (pointer_cache != nullptr &&
+          pointer_cache->load("pointer", pointer.results())) {
+        analyzer::log::info("Using cached pointer analysis results");
+      } else {
+        analyzer::log::info("Running pointer analysis");
+        analyzer::ScopeTimerDatabase t(output_db.times,
+                                       "ikos-analyzer.pointer-analysis");
+        pointer.run();
+        if (pointer_cache != nullptr) {
+          pointer_cache->save("pointer", pointer.results());
+        }
+      }
       ctx.pointer = &pointer;
     }
+    pointer_cache.reset();
     if (DisplayPointer) {
       pointer.dump(analyzer::log::out());
     }
 
-    // Final step, run a value analysis, and check properties on the results
-    if (Procedural == analyzer::Procedural::Interprocedural) {
-      analyzer::InterproceduralValueAnalysis analysis(ctx);
-      analyzer::log::info("Running interprocedural value analysis");
+    // Write the checks that are safe syntactically, once per statement
+    analyzer::TrivialChecksAnalysis trivial_checks(ctx);
+    if (TrivialChecks) {
+      analyzer::log::info("Running trivial checks analysis");
       analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.value-analysis");
-      analysis.run();
-    } else if (Procedural == analyzer::Procedural::Intraprocedural) {
-      analyzer::IntraproceduralValueAnalysis analysis(ctx);
-      analyzer::log::info("Running intraprocedural value analysis");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.value-analysis");
-      analysis.run();
+                                     "ikos-analyzer.trivial-checks-analysis");
+      trivial_checks.run();
+      ctx.trivial_checks = &trivial_checks;
+    }
+
+    // Final step, run a value analysis, and check properties on the results
+    if (!ServerSocket.empty()) {
+      // Keep the AR and the pre-analyses in memory, and run the value
+      // analysis for each request
+      serve(ctx);
+    } else if (Processes > 1) {
+      run_value_analysis_processes(ctx, Processes);
     } else {
-      ikos_unreachable("unreachable");
+      run_value_analysis(ctx);
+    }
+    analyzer::Progress::disable();
+
+    if (function_cache != nullptr) {
+      analyzer::log::debug("Saving cache file '" +
+                           (CacheFilename.empty() ? CheckpointFilename
+                                                  : CacheFilename) +
+                           "'");
+      function_cache->save();
+    }
+
+    if (ctx.library_summary_output != nullptr) {
+      analyzer::log::info("Saving " +
+                          std::to_string(library_summary_output.size()) +
+                          " function summaries in '" +
+                          EmitLibrarySummaryFilename + "'");
+      library_summary_output.save(EmitLibrarySummaryFilename);
+    }
+
+    if (AsyncOutput) {
+      // Wait for the writer thread, and report errors
+      db.set_commit_policy(analyzer::sqlite::CommitPolicy::Auto);
+    }
+
+    if (DeferDbIndexes) {
+      analyzer::log::debug("Creating output database indexes");
+      analyzer::ScopeTimerDatabase t(output_db.times,
+                                     "ikos-analyzer.create-db-indexes");
+      output_db.create_indexes();
+    }
+
+    if (!TraceFilename.empty()) {
+      analyzer::log::debug("Writing trace file '" + TraceFilename + "'");
+      std::error_code ec;
+      llvm::raw_fd_ostream trace(TraceFilename, ec, llvm::sys::fs::F_None);
+      if (ec) {
+        llvm::errs() << progname << ": " << TraceFilename
+                     << ": error: " << ec.message() << "\n";
+        return 1;
+      }
+      analyzer::Tracer::write(trace);
     }
   } catch (analyzer::sqlite::DbError& err) {
     llvm::errs() << progname << ": " << OutputFilename
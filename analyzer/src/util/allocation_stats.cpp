@@ -0,0 +1,292 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the allocation counters
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#ifdef __linux__
+#include <malloc.h>
+#endif
+
+#include <ikos/analyzer/util/allocation_stats.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+#ifdef __linux__
+
+/// \brief Counters of a thread
+///
+/// Counters are only written by their thread, and read by
+/// AllocationStats::read(). This is trivially destructible, so that it
+/// remains usable when memory is freed after the thread-local destructors ran.
+struct ThreadCounters {
+  std::atomic< std::uint64_t > allocated_bytes;
+  std::atomic< std::uint64_t > freed_bytes;
+  std::atomic< std::uint64_t > allocations;
+
+  /// \brief Next counters in the registry
+  ThreadCounters* next;
+
+  /// \brief True if the counters are in the registry
+  bool registered;
+};
+
+/// \brief Add to a counter written by a single thread
+void add(std::atomic< std::uint64_t >& counter, std::uint64_t n) {
+  counter.store(counter.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+}
+
+/// \brief Registry of the counters of the running threads
+///
+/// This is an intrusive list, since it is updated from operator new.
+class Registry {
+private:
+  /// \brief Mutex protecting the registry
+  std::mutex _mutex;
+
+  /// \brief Counters of the running threads
+  ThreadCounters* _head = nullptr;
+
+  /// \brief Counters of the exited threads
+  AllocationValues _exited;
+
+  /// \brief Freed bytes of the exited threads
+  std::uint64_t _exited_freed_bytes = 0;
+
+public:
+  /// \brief Add the counters of a thread
+  void add(ThreadCounters* counters) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    counters->next = this->_head;
+    this->_head = counters;
+  }
+
+  /// \brief Remove the counters of an exiting thread
+  void remove(ThreadCounters* counters) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    for (ThreadCounters** it = &this->_head; *it != nullptr;
+         it = &(*it)->next) {
+      if (*it == counters) {
+        *it = counters->next;
+        break;
+      }
+    }
+    this->_exited.allocated_bytes +=
+        counters->allocated_bytes.load(std::memory_order_relaxed);
+    this->_exited.allocations +=
+        counters->allocations.load(std::memory_order_relaxed);
+    this->_exited_freed_bytes +=
+        counters->freed_bytes.load(std::memory_order_relaxed);
+  }
+
+  /// \brief Return the counters of the process
+  AllocationValues read() {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    AllocationValues r = this->_exited;
+    std::uint64_t freed_bytes = this->_exited_freed_bytes;
+    for (ThreadCounters* it = this->_head; it != nullptr; it = it->next) {
+      r.allocated_bytes += it->allocated_bytes.load(std::memory_order_relaxed);
+      r.allocations += it->allocations.load(std::memory_order_relaxed);
+      freed_bytes += it->freed_bytes.load(std::memory_order_relaxed);
+    }
+    r.live_bytes = static_cast< std::int64_t >(r.allocated_bytes) -
+                   static_cast< std::int64_t >(freed_bytes);
+    return r;
+  }
+};
+
+/// \brief Return the registry
+///
+/// It is never destroyed, since memory can be freed during the destruction of
+/// static objects. It is constructed in static storage rather than with
+/// operator new, which records its allocations in the registry.
+Registry& registry() {
+  alignas(Registry) static char storage[sizeof(Registry)];
+  static auto* registry = new (storage) Registry();
+  return *registry;
+}
+
+thread_local ThreadCounters Counters;
+
+/// \brief Removes the counters from the registry when a thread exits
+struct ThreadExit {
+  ~ThreadExit() {
+    if (Counters.registered) {
+      registry().remove(&Counters);
+    }
+  }
+};
+
+thread_local ThreadExit Exit;
+
+/// \brief Return the counters of the current thread
+ThreadCounters& thread_counters() {
+  if (!Counters.registered) {
+    // Register the removal of the counters on thread exit
+    (void)&Exit;
+    Counters.registered = true;
+    registry().add(&Counters);
+  }
+  return Counters;
+}
+
+/// \brief Allocate a block with malloc and record it
+///
+/// The usable size is only queried when the counters are enabled, so that
+/// operator new costs a single test otherwise.
+///
+/// On failure, call the new handler until it succeeds, like operator new.
+void* allocate(std::size_t size) {
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  while (ptr == nullptr) {
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+    ptr = std::malloc(size == 0 ? 1 : size);
+  }
+  if (AllocationStats::enabled()) {
+    AllocationStats::record_allocation(::malloc_usable_size(ptr));
+  }
+  return ptr;
+}
+
+/// \brief Record the deallocation of a block and free it
+void deallocate(void* ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (AllocationStats::enabled()) {
+    AllocationStats::record_deallocation(::malloc_usable_size(ptr));
+  }
+  std::free(ptr);
+}
+
+#endif // __linux__
+
+} // end anonymous namespace
+
+bool AllocationStats::Enabled = false;
+
+#ifdef __linux__
+
+bool AllocationStats::enable(std::string& /*error*/) {
+  Enabled = true;
+  return true;
+}
+
+boost::optional< AllocationValues > AllocationStats::read() {
+  if (!Enabled) {
+    return boost::none;
+  }
+  return registry().read();
+}
+
+void AllocationStats::record_allocation_slow(std::size_t size) {
+  ThreadCounters& counters = thread_counters();
+  add(counters.allocated_bytes, size);
+  add(counters.allocations, 1);
+}
+
+void AllocationStats::record_deallocation_slow(std::size_t size) {
+  add(thread_counters().freed_bytes, size);
+}
+
+#else // __linux__
+
+bool AllocationStats::enable(std::string& error) {
+  error = "allocation statistics are only supported on Linux";
+  return false;
+}
+
+boost::optional< AllocationValues > AllocationStats::read() {
+  return boost::none;
+}
+
+void AllocationStats::record_allocation_slow(std::size_t /*size*/) {}
+
+void AllocationStats::record_deallocation_slow(std::size_t /*size*/) {}
+
+#endif // __linux__
+
+} // end namespace analyzer
+} // end namespace ikos
+
+#ifdef __linux__
+
+// Replace the global operator new and operator delete to record allocations.
+// The other forms (nothrow, sized) call these.
+
+void* operator new(std::size_t size) {
+  return ikos::analyzer::allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+  return ikos::analyzer::allocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  ikos::analyzer::deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  ikos::analyzer::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  ikos::analyzer::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept {
+  ikos::analyzer::deallocate(ptr);
+}
+
+#endif // __linux__
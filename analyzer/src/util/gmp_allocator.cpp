@@ -0,0 +1,252 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the pool allocator for GMP numbers
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include <gmp.h>
+
+#include <ikos/analyzer/util/allocation_stats.hpp>
+#include <ikos/analyzer/util/gmp_allocator.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace gmp_allocator {
+
+namespace {
+
+/// \brief Size of a limb, in bytes
+constexpr std::size_t LimbSize = sizeof(mp_limb_t);
+
+/// \brief Number of size classes, for blocks of 1 to NumClasses limbs
+constexpr std::size_t NumClasses = 4;
+
+/// \brief Marker for sizes that are not pooled
+constexpr std::size_t NoClass = NumClasses;
+
+/// \brief Number of blocks carved from a chunk
+constexpr std::size_t BlocksPerChunk = 2048;
+
+/// \brief Free block, linked to the next free block
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+/// \brief Free list of blocks of the same size class
+struct FreeList {
+  FreeBlock* head;
+};
+
+/// \brief Free lists handed over by exited threads
+class Depot {
+private:
+  /// \brief Mutex protecting _lists
+  std::mutex _mutex;
+
+  /// \brief Free lists, per size class
+  std::array< std::vector< FreeList >, NumClasses > _lists;
+
+public:
+  /// \brief Add a non-empty free list
+  void push(std::size_t cls, FreeList list) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    this->_lists[cls].push_back(list);
+  }
+
+  /// \brief Take a free list, return false if there is none
+  bool pop(std::size_t cls, FreeList& list) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    if (this->_lists[cls].empty()) {
+      return false;
+    }
+    list = this->_lists[cls].back();
+    this->_lists[cls].pop_back();
+    return true;
+  }
+};
+
+/// \brief Return the depot
+///
+/// It is never destroyed, since GMP numbers can be freed during the
+/// destruction of static objects.
+Depot& depot() {
+  static auto* depot = new Depot();
+  return *depot;
+}
+
+/// \brief Free lists of the current thread
+///
+/// This is trivially destructible, so that it remains usable when GMP numbers
+/// are freed after the thread-local destructors ran.
+thread_local std::array< FreeList, NumClasses > Lists;
+
+/// \brief Hands the free lists over to the depot when a thread exits
+struct ThreadExit {
+  ~ThreadExit() {
+    for (std::size_t cls = 0; cls < NumClasses; cls++) {
+      if (Lists[cls].head != nullptr) {
+        depot().push(cls, Lists[cls]);
+        Lists[cls].head = nullptr;
+      }
+    }
+  }
+};
+
+thread_local ThreadExit Exit;
+
+/// \brief Report an allocation failure and abort, like GMP does
+[[noreturn]] void out_of_memory(std::size_t size) {
+  std::fprintf(stderr,
+               "GNU MP: Cannot allocate memory (size=%lu)\n",
+               static_cast< unsigned long >(size));
+  std::abort();
+}
+
+/// \brief Return the size class of a block, or NoClass
+std::size_t size_class(std::size_t size) {
+  if (size == 0 || size > NumClasses * LimbSize || size % LimbSize != 0) {
+    return NoClass;
+  }
+  return size / LimbSize - 1;
+}
+
+/// \brief Fill the empty free list of the given size class
+void refill(std::size_t cls) {
+  // Register the hand over of the free lists on thread exit
+  (void)&Exit;
+
+  FreeList& list = Lists[cls];
+  if (depot().pop(cls, list)) {
+    return;
+  }
+
+  std::size_t block_size = (cls + 1) * LimbSize;
+  auto* chunk =
+      static_cast< char* >(std::malloc(BlocksPerChunk * block_size));
+  if (chunk == nullptr) {
+    out_of_memory(BlocksPerChunk * block_size);
+  }
+  FreeBlock* head = nullptr;
+  for (std::size_t i = BlocksPerChunk; i > 0; i--) {
+    auto* block = reinterpret_cast< FreeBlock* >(chunk + (i - 1) * block_size);
+    block->next = head;
+    head = block;
+  }
+  list.head = head;
+}
+
+void* allocate(std::size_t size) {
+  AllocationStats::record_allocation(size);
+  std::size_t cls = size_class(size);
+  if (cls == NoClass) {
+    void* ptr = std::malloc(size);
+    if (ptr == nullptr) {
+      out_of_memory(size);
+    }
+    return ptr;
+  }
+
+  FreeList& list = Lists[cls];
+  if (list.head == nullptr) {
+    refill(cls);
+  }
+  FreeBlock* block = list.head;
+  list.head = block->next;
+  return block;
+}
+
+void deallocate(void* ptr, std::size_t size) {
+  AllocationStats::record_deallocation(size);
+  std::size_t cls = size_class(size);
+  if (cls == NoClass) {
+    std::free(ptr);
+    return;
+  }
+
+  // Blocks allocated with malloc before install() are valid blocks of their
+  // size class, they can be pooled as well.
+  FreeList& list = Lists[cls];
+  auto* block = static_cast< FreeBlock* >(ptr);
+  block->next = list.head;
+  list.head = block;
+}
+
+void* reallocate(void* ptr, std::size_t old_size, std::size_t new_size) {
+  std::size_t old_cls = size_class(old_size);
+  std::size_t new_cls = size_class(new_size);
+  if (old_cls == NoClass && new_cls == NoClass) {
+    AllocationStats::record_deallocation(old_size);
+    AllocationStats::record_allocation(new_size);
+    void* new_ptr = std::realloc(ptr, new_size);
+    if (new_ptr == nullptr) {
+      out_of_memory(new_size);
+    }
+    return new_ptr;
+  }
+  if (old_cls == new_cls) {
+    AllocationStats::record_deallocation(old_size);
+    AllocationStats::record_allocation(new_size);
+    return ptr;
+  }
+
+  void* new_ptr = allocate(new_size);
+  std::memcpy(new_ptr, ptr, std::min(old_size, new_size));
+  deallocate(ptr, old_size);
+  return new_ptr;
+}
+
+} // end anonymous namespace
+
+void install() {
+  mp_set_memory_functions(allocate, reallocate, deallocate);
+}
+
+} // end namespace gmp_allocator
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,164 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the local socket used by the analysis server
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <ikos/analyzer/util/local_socket.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+LocalSocketConnection::LocalSocketConnection(int fd) : _fd(fd) {}
+
+LocalSocketConnection::LocalSocketConnection(
+    LocalSocketConnection&& other) noexcept
+    : _fd(other._fd), _buffer(std::move(other._buffer)) {
+  other._fd = -1;
+}
+
+LocalSocketConnection::~LocalSocketConnection() {
+  if (this->_fd >= 0) {
+    ::close(this->_fd);
+  }
+}
+
+bool LocalSocketConnection::read_line(std::string& line) {
+  while (true) {
+    std::size_t pos = this->_buffer.find('\n');
+    if (pos != std::string::npos) {
+      line = this->_buffer.substr(0, pos);
+      this->_buffer.erase(0, pos + 1);
+      return true;
+    }
+
+    char chunk[4096];
+    ssize_t n = ::read(this->_fd, chunk, sizeof(chunk));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      // End of stream, return the last unterminated line, if any
+      if (this->_buffer.empty()) {
+        return false;
+      }
+      line = std::move(this->_buffer);
+      this->_buffer.clear();
+      return true;
+    }
+    this->_buffer.append(chunk, static_cast< std::size_t >(n));
+  }
+}
+
+void LocalSocketConnection::write_line(StringRef line) {
+  std::string data = line.to_string();
+  data += '\n';
+  const char* p = data.data();
+  std::size_t size = data.size();
+  while (size > 0) {
+    ssize_t n = ::write(this->_fd, p, size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return;
+    }
+    p += n;
+    size -= static_cast< std::size_t >(n);
+  }
+}
+
+LocalSocketServer::LocalSocketServer(std::string path)
+    : _path(std::move(path)), _fd(-1) {
+  struct sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (this->_path.size() >= sizeof(addr.sun_path)) {
+    throw std::system_error(ENAMETOOLONG,
+                            std::generic_category(),
+                            this->_path);
+  }
+  std::strncpy(addr.sun_path, this->_path.c_str(), sizeof(addr.sun_path) - 1);
+
+  this->_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (this->_fd < 0) {
+    throw std::system_error(errno, std::generic_category(), "socket");
+  }
+
+  // Remove a stale socket file of a previous server
+  ::unlink(this->_path.c_str());
+
+  if (::bind(this->_fd,
+             reinterpret_cast< struct sockaddr* >(&addr),
+             sizeof(addr)) < 0 ||
+      ::listen(this->_fd, SOMAXCONN) < 0) {
+    int err = errno;
+    ::close(this->_fd);
+    throw std::system_error(err, std::generic_category(), this->_path);
+  }
+}
+
+LocalSocketServer::~LocalSocketServer() {
+  ::close(this->_fd);
+  ::unlink(this->_path.c_str());
+}
+
+LocalSocketConnection LocalSocketServer::accept() {
+  while (true) {
+    int fd = ::accept(this->_fd, nullptr, nullptr);
+    if (fd >= 0) {
+      return LocalSocketConnection(fd);
+    }
+    if (errno != EINTR) {
+      throw std::system_error(errno, std::generic_category(), "accept");
+    }
+  }
+}
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -43,6 +43,14 @@
 
 #include <unistd.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include <ikos/analyzer/util/log.hpp>
 
 namespace ikos {
@@ -52,6 +60,272 @@ namespace log {
 // Default global logging level
 LogLevel Level = LogLevel::All;
 
+namespace {
+
+/// \brief Bounded lock-free queue of messages
+///
+/// Multiple producers, single consumer. Each slot holds a sequence number
+/// telling whether it is ready to be written or to be read (see Dmitry
+/// Vyukov's bounded queue).
+class MessageRing {
+private:
+  /// \brief Slot of the ring
+  struct Slot {
+    std::atomic< std::size_t > seq;
+    std::string message;
+  };
+
+private:
+  /// \brief Slots, the size is a power of 2
+  std::unique_ptr< Slot[] > _slots;
+
+  /// \brief Mask to compute the index of a position
+  std::size_t _mask;
+
+  /// \brief Next position to write
+  std::atomic< std::size_t > _head;
+
+  /// \brief Next position to read, only accessed by the consumer
+  std::size_t _tail;
+
+public:
+  /// \brief Create a ring with the given capacity, a power of 2
+  explicit MessageRing(std::size_t capacity)
+      : _slots(new Slot[capacity]), _mask(capacity - 1), _head(0), _tail(0) {
+    for (std::size_t i = 0; i < capacity; i++) {
+      this->_slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /// \brief Push a message, return false if the ring is full
+  bool try_push(std::string& message) {
+    std::size_t pos = this->_head.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot = this->_slots[pos & this->_mask];
+      std::size_t seq = slot.seq.load(std::memory_order_acquire);
+      if (seq == pos) {
+        if (this->_head.compare_exchange_weak(pos,
+                                              pos + 1,
+                                              std::memory_order_relaxed)) {
+          slot.message = std::move(message);
+          slot.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (seq < pos) {
+        return false;
+      } else {
+        pos = this->_head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// \brief Pop a message, return false if the next one is not ready
+  bool try_pop(std::string& message) {
+    Slot& slot = this->_slots[this->_tail & this->_mask];
+    if (slot.seq.load(std::memory_order_acquire) != this->_tail + 1) {
+      return false;
+    }
+    message = std::move(slot.message);
+    slot.message.clear();
+    slot.seq.store(this->_tail + this->_mask + 1, std::memory_order_release);
+    this->_tail++;
+    return true;
+  }
+
+  /// \brief Return the number of positions claimed by producers
+  std::size_t head() const { return this->_head.load(); }
+
+  /// \brief Return the number of messages read
+  std::size_t tail() const { return this->_tail; }
+
+}; // end class MessageRing
+
+/// \brief Writer of log messages on a background thread
+class AsyncWriter {
+private:
+  /// \brief Number of messages in the ring
+  static constexpr std::size_t Capacity = 4096;
+
+  /// \brief Maximum time between two checks of the ring, when idle
+  static constexpr std::chrono::milliseconds IdleTimeout{10};
+
+private:
+  MessageRing _ring;
+
+  /// \brief Number of messages written and flushed
+  std::atomic< std::size_t > _written;
+
+  /// \brief True if the background thread is waiting for messages
+  std::atomic< bool > _sleeping;
+
+  /// \brief True if the background thread should stop
+  bool _stop;
+
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  std::condition_variable _drained;
+  std::thread _thread;
+
+public:
+  AsyncWriter()
+      : _ring(Capacity),
+        _written(0),
+        _sleeping(false),
+        _stop(false),
+        _thread([this] { this->run(); }) {}
+
+  AsyncWriter(const AsyncWriter&) = delete;
+  AsyncWriter(AsyncWriter&&) = delete;
+  AsyncWriter& operator=(const AsyncWriter&) = delete;
+  AsyncWriter& operator=(AsyncWriter&&) = delete;
+
+  /// \brief Write the pending messages and stop the background thread
+  ~AsyncWriter() {
+    {
+      std::lock_guard< std::mutex > lock(this->_mutex);
+      this->_stop = true;
+    }
+    this->_wake.notify_one();
+    this->_thread.join();
+  }
+
+  /// \brief Push a message
+  void push(std::string message) {
+    while (!this->_ring.try_push(message)) {
+      // The ring is full, wait for the background thread
+      this->wake();
+      std::this_thread::yield();
+    }
+    if (this->_sleeping.load()) {
+      this->wake();
+    }
+  }
+
+  /// \brief Wait until the messages pushed so far are written
+  void flush() {
+    std::size_t target = this->_ring.head();
+    if (this->_written.load(std::memory_order_acquire) >= target) {
+      return;
+    }
+    std::unique_lock< std::mutex > lock(this->_mutex);
+    this->_wake.notify_one();
+    this->_drained.wait(lock, [this, target] {
+      return this->_written.load(std::memory_order_acquire) >= target;
+    });
+  }
+
+private:
+  /// \brief Wake up the background thread
+  void wake() {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    this->_wake.notify_one();
+  }
+
+  /// \brief Main loop of the background thread
+  void run() {
+    std::string message;
+    while (true) {
+      bool written = false;
+      while (this->_ring.try_pop(message)) {
+        std::cout << message;
+        written = true;
+      }
+      if (written) {
+        std::cout.flush();
+      }
+
+      std::unique_lock< std::mutex > lock(this->_mutex);
+      this->_written.store(this->_ring.tail(), std::memory_order_release);
+      this->_drained.notify_all();
+      if (this->_stop && this->_ring.tail() == this->_ring.head()) {
+        return;
+      }
+
+      // A push might miss the flag, the timeout bounds the delay
+      this->_sleeping.store(true);
+      if (this->_ring.tail() == this->_ring.head()) {
+        this->_wake.wait_for(lock, IdleTimeout);
+      }
+      this->_sleeping.store(false);
+    }
+  }
+
+}; // end class AsyncWriter
+
+/// \brief Background writer, or null if messages are written synchronously
+std::unique_ptr< AsyncWriter > Writer;
+
+/// \brief Prefix of the messages of the current thread
+thread_local std::string ThreadPrefix;
+
+/// \brief Return the formatted log message
+std::string format(LogLevel level, StringRef message) {
+  std::string line;
+  line.reserve(message.size() + ThreadPrefix.size() + 32);
+  line += '[';
+  switch (level) {
+    case LogLevel::Critical: {
+      line += color::on_red();
+      line += "CRITICAL";
+    } break;
+    case LogLevel::Error: {
+      line += color::on_red();
+      line += "ERROR";
+    } break;
+    case LogLevel::Warning: {
+      line += color::bold_yellow();
+      line += '!';
+    } break;
+    case LogLevel::Info: {
+      line += color::bold_blue();
+      line += '*';
+    } break;
+    default: {
+      line += color::magenta();
+      line += '.';
+    } break;
+  }
+  line += color::off();
+  line += "] ";
+  line += ThreadPrefix;
+  line += message;
+  line += '\n';
+  return line;
+}
+
+} // end anonymous namespace
+
+void start_async() {
+  if (!Writer) {
+    Writer = std::make_unique< AsyncWriter >();
+  }
+}
+
+void stop_async() {
+  Writer.reset();
+}
+
+void flush() {
+  if (Writer) {
+    Writer->flush();
+  }
+}
+
+void set_thread_prefix(std::string prefix) {
+  ThreadPrefix = std::move(prefix);
+}
+
+void write(LogLevel level, StringRef message) {
+  std::string line = format(level, message);
+  if (Writer && level < LogLevel::Critical) {
+    Writer->push(std::move(line));
+  } else {
+    // Critical messages usually precede a crash, write them immediately
+    flush();
+    std::cout << line << std::flush;
+  }
+}
+
 } // end namespace log
 } // end namespace analyzer
 } // end namespace ikos
@@ -0,0 +1,191 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the memory governor
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <string>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <ikos/analyzer/util/log.hpp>
+#include <ikos/analyzer/util/memory_governor.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Interval between two samples of the memory usage
+static constexpr std::chrono::milliseconds SampleInterval(100);
+
+/// \brief Number of samples between two reports in the log
+static constexpr unsigned ReportInterval = 100;
+
+/// \brief Return a human readable size in megabytes
+static std::string to_megabytes(std::uint64_t size) {
+  return std::to_string(size / (1024 * 1024)) + " MB";
+}
+
+/// \brief Convert a limit in megabytes to bytes, where 0 means no limit
+static std::uint64_t to_bytes(std::uint64_t limit) {
+  return limit > 0 ? limit * 1024 * 1024
+                   : std::numeric_limits< std::uint64_t >::max();
+}
+
+MemoryGovernor::MemoryGovernor(std::uint64_t soft_limit,
+                               std::uint64_t spill_limit)
+    : _soft_limit(to_bytes(soft_limit)),
+      _spill_limit(to_bytes(spill_limit)),
+      _exceeded(false),
+      _spilling(false),
+      _spill_generation(0),
+      _peak(0),
+      _stop(false) {
+  this->sample();
+  this->_thread = std::thread([this] { this->monitor(); });
+}
+
+MemoryGovernor::~MemoryGovernor() {
+  {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    this->_stop = true;
+  }
+  this->_cv.notify_one();
+  this->_thread.join();
+  log::debug("Peak memory usage: " + to_megabytes(this->_peak.load()));
+}
+
+boost::optional< std::uint64_t > MemoryGovernor::memory_usage() {
+#if defined(__linux__)
+  std::ifstream statm("/proc/self/statm");
+  std::uint64_t size = 0;
+  if (statm >> size) {
+    return size * static_cast< std::uint64_t >(sysconf(_SC_PAGESIZE));
+  }
+#elif defined(__APPLE__)
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(),
+                MACH_TASK_BASIC_INFO,
+                reinterpret_cast< task_info_t >(&info),
+                &count) == KERN_SUCCESS) {
+    return static_cast< std::uint64_t >(info.resident_size);
+  }
+#endif
+
+  // Fall back on the peak resident set size
+  return peak_resident_size();
+}
+
+boost::optional< std::uint64_t > MemoryGovernor::peak_resident_size() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+    return static_cast< std::uint64_t >(usage.ru_maxrss);
+#else
+    return static_cast< std::uint64_t >(usage.ru_maxrss) * 1024;
+#endif
+  }
+  return boost::none;
+}
+
+void MemoryGovernor::release_free_memory() {
+#ifdef __GLIBC__
+  malloc_trim(0);
+#endif
+}
+
+void MemoryGovernor::monitor() {
+  std::unique_lock< std::mutex > lock(this->_mutex);
+  for (unsigned n = 1;; n++) {
+    if (this->_cv.wait_for(lock, SampleInterval, [this] {
+          return this->_stop;
+        })) {
+      return;
+    }
+    boost::optional< std::uint64_t > usage = this->sample();
+    if (usage && n % ReportInterval == 0) {
+      log::debug("Memory usage: " + to_megabytes(*usage));
+    }
+  }
+}
+
+boost::optional< std::uint64_t > MemoryGovernor::sample() {
+  boost::optional< std::uint64_t > usage = memory_usage();
+  if (!usage) {
+    return boost::none;
+  }
+  if (*usage > this->_peak.load()) {
+    this->_peak.store(*usage);
+  }
+  if (*usage >= this->_spill_limit) {
+    if (!this->_spilling.exchange(true)) {
+      this->_spill_generation++;
+      log::debug("Memory usage (" + to_megabytes(*usage) +
+                 ") exceeded the spill limit (" +
+                 to_megabytes(this->_spill_limit) + ")");
+    }
+  } else if (*usage < this->_spill_limit / 10 * 9) {
+    this->_spilling.store(false);
+  }
+  if (*usage >= this->_soft_limit && !this->_exceeded.exchange(true)) {
+    log::warning("memory usage (" + to_megabytes(*usage) +
+                 ") exceeded the soft limit (" +
+                 to_megabytes(this->_soft_limit) +
+                 "), the remaining functions are analyzed with a lower "
+                 "precision");
+  }
+  return usage;
+}
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,168 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the NUMA topology
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <ikos/analyzer/util/numa.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+#ifdef __linux__
+
+/// \brief Parse a list of ranges, e.g `0-3,8,10-11`
+std::vector< int > parse_list(const std::string& str) {
+  std::vector< int > r;
+  std::istringstream in(str);
+  std::string range;
+  while (std::getline(in, range, ',')) {
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+    try {
+      std::size_t dash = range.find('-');
+      int first = std::stoi(range.substr(0, dash));
+      int last = first;
+      if (dash != std::string::npos) {
+        last = std::stoi(range.substr(dash + 1));
+      }
+      for (int i = first; i <= last; i++) {
+        r.push_back(i);
+      }
+    } catch (const std::exception&) {
+      return {};
+    }
+  }
+  return r;
+}
+
+/// \brief Read the first line of a file, or return an empty string
+std::string read_line(const std::string& path) {
+  std::ifstream in(path);
+  std::string line;
+  std::getline(in, line);
+  return line;
+}
+
+#endif // __linux__
+
+} // end anonymous namespace
+
+NumaTopology::NumaTopology() {
+#ifdef __linux__
+  for (int node : parse_list(read_line("/sys/devices/system/node/online"))) {
+    std::vector< int > cpus = parse_list(read_line(
+        "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+    if (!cpus.empty()) {
+      this->_nodes.push_back(std::move(cpus));
+    }
+  }
+#endif
+  if (this->_nodes.empty()) {
+    // Unknown topology, a single node with all CPUs
+    this->_nodes.emplace_back();
+  }
+}
+
+const NumaTopology& NumaTopology::get() {
+  static NumaTopology topology;
+  return topology;
+}
+
+bool NumaTopology::bind_current_thread(std::size_t node) const {
+#ifdef __linux__
+  const std::vector< int >& cpus = this->_nodes.at(node);
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+#else
+  static_cast< void >(node);
+  return false;
+#endif
+}
+
+ScopeNumaBinding::ScopeNumaBinding(const NumaTopology& topology,
+                                   std::size_t node) {
+#ifdef __linux__
+  cpu_set_t set;
+  if (::pthread_getaffinity_np(::pthread_self(), sizeof(set), &set) == 0 &&
+      topology.bind_current_thread(node)) {
+    this->_saved.resize(sizeof(set));
+    std::memcpy(this->_saved.data(), &set, sizeof(set));
+  }
+#else
+  static_cast< void >(topology);
+  static_cast< void >(node);
+#endif
+}
+
+ScopeNumaBinding::~ScopeNumaBinding() {
+#ifdef __linux__
+  if (!this->_saved.empty()) {
+    cpu_set_t set;
+    std::memcpy(&set, this->_saved.data(), sizeof(set));
+    ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+  }
+#endif
+}
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,197 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implement the hardware performance counters
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <ikos/analyzer/util/perf_counters.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+#ifdef __linux__
+
+/// \brief Events of the counters, in the order of PerfCounterValues
+const std::array< std::uint64_t, 4 > Events = {
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+/// \brief Set of open counters, one per event
+class CounterSet {
+private:
+  std::array< int, 4 > _fds;
+
+public:
+  CounterSet() { this->_fds.fill(-1); }
+
+  CounterSet(const CounterSet&) = delete;
+  CounterSet(CounterSet&&) = delete;
+  CounterSet& operator=(const CounterSet&) = delete;
+  CounterSet& operator=(CounterSet&&) = delete;
+
+  ~CounterSet() {
+    for (int fd : this->_fds) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+  }
+
+  /// \brief Open the counters of the calling thread, return false and set
+  /// errno on failure
+  bool open(bool inherit) {
+    for (std::size_t i = 0; i < Events.size(); i++) {
+      struct perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = Events[i];
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.inherit = inherit ? 1 : 0;
+      long fd = ::syscall(SYS_perf_event_open,
+                          &attr,
+                          /*pid=*/0,
+                          /*cpu=*/-1,
+                          /*group_fd=*/-1,
+                          /*flags=*/0UL);
+      if (fd < 0) {
+        return false;
+      }
+      this->_fds[i] = static_cast< int >(fd);
+    }
+    return true;
+  }
+
+  /// \brief Read the counters
+  PerfCounterValues read() const {
+    std::array< std::uint64_t, 4 > values = {0, 0, 0, 0};
+    for (std::size_t i = 0; i < Events.size(); i++) {
+      if (::read(this->_fds[i], &values[i], sizeof(values[i])) !=
+          sizeof(values[i])) {
+        values[i] = 0;
+      }
+    }
+    PerfCounterValues r;
+    r.instructions = values[0];
+    r.cycles = values[1];
+    r.llc_misses = values[2];
+    r.branch_misses = values[3];
+    return r;
+  }
+};
+
+/// \brief Counters of the process, inherited by the threads
+std::unique_ptr< CounterSet > ProcessCounters;
+
+/// \brief Counters of the current thread, or null if they could not be opened
+thread_local std::unique_ptr< CounterSet > ThreadCounters;
+
+/// \brief True if the counters of the current thread were opened
+thread_local bool ThreadCountersOpened = false;
+
+#endif // __linux__
+
+} // end anonymous namespace
+
+bool PerfCounters::Enabled = false;
+
+bool PerfCounters::enable(std::string& error) {
+#ifdef __linux__
+  auto counters = std::make_unique< CounterSet >();
+  if (!counters->open(/*inherit=*/true)) {
+    error = std::strerror(errno);
+    return false;
+  }
+  ProcessCounters = std::move(counters);
+  Enabled = true;
+  return true;
+#else
+  error = "only supported on Linux";
+  return false;
+#endif
+}
+
+boost::optional< PerfCounterValues > PerfCounters::read_process() {
+#ifdef __linux__
+  if (Enabled) {
+    return ProcessCounters->read();
+  }
+#endif
+  return boost::none;
+}
+
+boost::optional< PerfCounterValues > PerfCounters::read_thread() {
+#ifdef __linux__
+  if (Enabled) {
+    if (!ThreadCountersOpened) {
+      ThreadCountersOpened = true;
+      auto counters = std::make_unique< CounterSet >();
+      if (counters->open(/*inherit=*/false)) {
+        ThreadCounters = std::move(counters);
+      }
+    }
+    if (ThreadCounters != nullptr) {
+      return ThreadCounters->read();
+    }
+  }
+#endif
+  return boost::none;
+}
+
+} // end namespace analyzer
+} // end namespace ikos
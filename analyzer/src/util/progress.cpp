@@ -0,0 +1,199 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the progress reporting
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <ikos/analyzer/json/json.hpp>
+#include <ikos/analyzer/util/progress.hpp>
+#include <ikos/analyzer/util/timer.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+/// \brief State of the progress, shared by the analysis threads
+struct ProgressState {
+  /// \brief Output file
+  std::ofstream out;
+
+  /// \brief Interval between two events
+  std::chrono::milliseconds interval;
+
+  /// \brief Start time
+  Timer::TimePoint start;
+
+  std::atomic< std::size_t > total_functions{0};
+  std::atomic< std::uint64_t > total_cost{0};
+  std::atomic< std::size_t > completed_functions{0};
+  std::atomic< std::uint64_t > completed_cost{0};
+  std::atomic< std::uint64_t > contexts{0};
+  std::atomic< std::uint64_t > iterations{0};
+
+  /// \brief Protects `current`, `stop` and `out`
+  std::mutex mutex;
+
+  /// \brief Name of the function currently analyzed
+  std::string current;
+
+  /// \brief True if the background thread should stop
+  bool stop = false;
+
+  /// \brief Wakes up the background thread
+  std::condition_variable wake;
+
+  /// \brief Background thread
+  std::thread thread;
+
+  /// \brief Destructor, stop the background thread if it is still running
+  ~ProgressState() {
+    if (this->thread.joinable()) {
+      {
+        std::lock_guard< std::mutex > lock(this->mutex);
+        this->stop = true;
+      }
+      this->wake.notify_one();
+      this->thread.join();
+    }
+  }
+};
+
+/// \brief Progress state, or null if progress reporting is disabled
+std::unique_ptr< ProgressState > State;
+
+/// \brief Write an event, `state.mutex` must be held
+void write_event(ProgressState& state, const char* event) {
+  double elapsed =
+      std::chrono::duration< double >(Timer::Clock::now() - state.start)
+          .count();
+  std::uint64_t total_cost = state.total_cost;
+  std::uint64_t completed_cost = state.completed_cost;
+
+  JsonDict dict{{"event", event},
+                {"elapsed", elapsed},
+                {"completed", state.completed_functions.load()},
+                {"total", state.total_functions.load()},
+                {"contexts", state.contexts.load()},
+                {"iterations", state.iterations.load()},
+                {"current", state.current}};
+
+  // Assume the remaining cost is analyzed at the same speed
+  if (completed_cost > 0 && total_cost >= completed_cost) {
+    dict.put("eta",
+             elapsed * static_cast< double >(total_cost - completed_cost) /
+                 static_cast< double >(completed_cost));
+  }
+
+  state.out << dict.str() << '\n';
+  state.out.flush();
+}
+
+/// \brief Main loop of the background thread
+void run(ProgressState& state) {
+  std::unique_lock< std::mutex > lock(state.mutex);
+  write_event(state, "start");
+  while (!state.wake.wait_for(lock, state.interval, [&state] {
+    return state.stop;
+  })) {
+    write_event(state, "progress");
+  }
+  write_event(state, "end");
+}
+
+} // end anonymous namespace
+
+bool Progress::Enabled = false;
+
+bool Progress::enable(const std::string& path,
+                      std::chrono::milliseconds interval) {
+  auto state = std::make_unique< ProgressState >();
+  state->out.open(path);
+  if (!state->out) {
+    return false;
+  }
+  state->interval = interval;
+  state->start = Timer::Clock::now();
+  State = std::move(state);
+  State->thread = std::thread([] { run(*State); });
+  Enabled = true;
+  return true;
+}
+
+void Progress::disable() {
+  if (!State) {
+    return;
+  }
+  Enabled = false;
+  State.reset();
+}
+
+void Progress::record_total(std::size_t functions, std::uint64_t cost) {
+  State->total_functions = functions;
+  State->total_cost = cost;
+}
+
+void Progress::record_start(StringRef name) {
+  std::lock_guard< std::mutex > lock(State->mutex);
+  State->current = name.to_string();
+}
+
+void Progress::record_finish(std::uint64_t cost) {
+  State->completed_cost += cost;
+  State->completed_functions++;
+}
+
+void Progress::record_context() {
+  State->contexts.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Progress::record_iteration() {
+  State->iterations.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // end namespace analyzer
+} // end namespace ikos
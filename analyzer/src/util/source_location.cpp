@@ -41,6 +41,10 @@
  *
  ******************************************************************************/
 
+#include <mutex>
+
+#include <llvm/ADT/DenseMap.h>
+
 #include <ikos/analyzer/util/source_location.hpp>
 
 namespace ikos {
@@ -72,6 +76,21 @@ static boost::filesystem::path relative_to(const boost::filesystem::path& from,
   return final_path;
 }
 
+SourceLocation source_location(ar::Statement* stmt) {
+  static std::mutex mutex;
+  static llvm::DenseMap< ar::Statement*, SourceLocation > cache;
+
+  std::lock_guard< std::mutex > lock(mutex);
+  auto it = cache.find(stmt);
+  if (it != cache.end()) {
+    return it->second;
+  }
+
+  SourceLocation loc = frontend::import::source_location(stmt);
+  cache.try_emplace(stmt, loc);
+  return loc;
+}
+
 std::string source_location_string(ar::Statement* stmt,
                                    const boost::filesystem::path& wd) {
   SourceLocation loc = source_location(stmt);
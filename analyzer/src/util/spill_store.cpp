@@ -0,0 +1,132 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the spill store
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <ikos/analyzer/util/spill_store.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+SpillStore::SpillStore() : _fd(-1), _size(0) {
+  const char* tmpdir = std::getenv("TMPDIR");
+  std::string path = (tmpdir != nullptr && *tmpdir != '\0') ? tmpdir : "/tmp";
+  path += "/ikos-spill-XXXXXX";
+
+  this->_fd = mkstemp(&path[0]);
+  if (this->_fd == -1) {
+    throw std::runtime_error("SpillStore: cannot create " + path + ": " +
+                             std::strerror(errno));
+  }
+
+  // The file is removed once closed
+  ::unlink(path.c_str());
+}
+
+SpillStore::~SpillStore() {
+  ::close(this->_fd);
+}
+
+SpillStore::Ref SpillStore::write(StringRef data) {
+  std::uint64_t offset;
+  {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    offset = this->_size;
+    this->_size += data.size();
+  }
+
+  const char* buf = data.data();
+  std::size_t remaining = data.size();
+  auto pos = static_cast< off_t >(offset);
+  while (remaining > 0) {
+    ssize_t n = ::pwrite(this->_fd, buf, remaining, pos);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(std::string("SpillStore: cannot write: ") +
+                               std::strerror(errno));
+    }
+    buf += n;
+    remaining -= static_cast< std::size_t >(n);
+    pos += n;
+  }
+
+  return {offset, data.size()};
+}
+
+std::string SpillStore::read(Ref ref) const {
+  std::string data(ref.size, '\0');
+  char* buf = &data[0];
+  std::size_t remaining = data.size();
+  auto pos = static_cast< off_t >(ref.offset);
+  while (remaining > 0) {
+    ssize_t n = ::pread(this->_fd, buf, remaining, pos);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      throw std::runtime_error(std::string("SpillStore: cannot read: ") +
+                               (n < 0 ? std::strerror(errno) : "end of file"));
+    }
+    buf += n;
+    remaining -= static_cast< std::size_t >(n);
+    pos += n;
+  }
+  return data;
+}
+
+std::uint64_t SpillStore::size() {
+  std::lock_guard< std::mutex > lock(this->_mutex);
+  return this->_size;
+}
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,231 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the execution on stack segments
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <system_error>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+#include <ikos/analyzer/util/stack.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+#if defined(__linux__)
+
+namespace {
+
+/// \brief Stack space required to run a function on the current stack
+///
+/// This should be larger than the stack used between two nested calls to
+/// run_on_large_stack(), e.g, the analysis of one function.
+constexpr std::size_t StackReserve = std::size_t(4) << 20; // 4MB
+
+/// \brief Size of a stack segment
+///
+/// Pages are only committed when used.
+constexpr std::size_t SegmentSize = std::size_t(256) << 20; // 256MB
+
+/// \brief Lowest address usable before switching to a new segment, or 0 if
+/// the bounds of the current stack are unknown
+thread_local std::uintptr_t StackLimit = 0;
+
+/// \brief Return the stack limit of the current thread, or 0
+std::uintptr_t thread_stack_limit() {
+  pthread_attr_t attr;
+  if (::pthread_getattr_np(::pthread_self(), &attr) != 0) {
+    return 0;
+  }
+  void* addr = nullptr;
+  std::size_t size = 0;
+  int r = ::pthread_attr_getstack(&attr, &addr, &size);
+  ::pthread_attr_destroy(&attr);
+  if (r != 0 || size <= StackReserve) {
+    return 0;
+  }
+  return reinterpret_cast< std::uintptr_t >(addr) + StackReserve;
+}
+
+/// \brief Stack segment allocated with mmap, with a guard page
+class StackSegment {
+private:
+  /// \brief Base address
+  void* _base;
+
+  /// \brief Size of the guard page
+  std::size_t _guard_size;
+
+public:
+  /// \brief Allocate a stack segment
+  StackSegment() : _guard_size(static_cast< std::size_t >(::getpagesize())) {
+    this->_base = ::mmap(nullptr,
+                         SegmentSize,
+                         PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE |
+                             MAP_STACK,
+                         -1,
+                         0);
+    if (this->_base == MAP_FAILED) {
+      throw std::system_error(errno,
+                              std::generic_category(),
+                              "cannot allocate stack segment");
+    }
+    ::mprotect(this->_base, this->_guard_size, PROT_NONE);
+  }
+
+  /// \brief Deleted copy constructor
+  StackSegment(const StackSegment&) = delete;
+
+  /// \brief Deleted move constructor
+  StackSegment(StackSegment&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  StackSegment& operator=(const StackSegment&) = delete;
+
+  /// \brief Deleted move assignment operator
+  StackSegment& operator=(StackSegment&&) = delete;
+
+  /// \brief Destructor
+  ~StackSegment() { ::munmap(this->_base, SegmentSize); }
+
+  /// \brief Return the lowest address of the segment
+  void* base() const { return this->_base; }
+
+  /// \brief Return the lowest usable address before switching to a new
+  /// segment
+  std::uintptr_t limit() const {
+    return reinterpret_cast< std::uintptr_t >(this->_base) +
+           this->_guard_size + StackReserve;
+  }
+
+}; // end class StackSegment
+
+/// \brief Function call on a stack segment
+struct SegmentCall {
+  /// \brief Function to call
+  const std::function< void() >* function;
+
+  /// \brief Exception thrown by the function, if any
+  std::exception_ptr error;
+
+  /// \brief Context of the caller
+  ucontext_t caller;
+
+  /// \brief Context of the callee
+  ucontext_t callee;
+};
+
+/// \brief Call being started on the current thread
+thread_local SegmentCall* PendingCall = nullptr;
+
+/// \brief Entry point of a stack segment
+///
+/// Exceptions cannot unwind past the segment, they are caught and rethrown
+/// by the caller. Returning resumes the caller, see `uc_link`.
+void segment_entry() {
+  SegmentCall* call = PendingCall;
+  try {
+    (*call->function)();
+  } catch (...) {
+    call->error = std::current_exception();
+  }
+}
+
+} // end anonymous namespace
+
+void run_on_large_stack(const std::function< void() >& f) {
+  if (StackLimit == 0) {
+    StackLimit = thread_stack_limit();
+  }
+
+  char marker;
+  if (StackLimit == 0 ||
+      reinterpret_cast< std::uintptr_t >(&marker) > StackLimit) {
+    f();
+    return;
+  }
+
+  StackSegment segment;
+  SegmentCall call;
+  call.function = &f;
+  if (::getcontext(&call.callee) != 0) {
+    throw std::system_error(errno, std::generic_category(), "getcontext");
+  }
+  call.callee.uc_stack.ss_sp = segment.base();
+  call.callee.uc_stack.ss_size = SegmentSize;
+  call.callee.uc_link = &call.caller;
+  ::makecontext(&call.callee, segment_entry, 0);
+
+  std::uintptr_t prev_limit = StackLimit;
+  StackLimit = segment.limit();
+  PendingCall = &call;
+  int r = ::swapcontext(&call.caller, &call.callee);
+  StackLimit = prev_limit;
+
+  if (r != 0) {
+    throw std::system_error(errno, std::generic_category(), "swapcontext");
+  }
+  if (call.error) {
+    std::rethrow_exception(call.error);
+  }
+}
+
+#else
+
+void run_on_large_stack(const std::function< void() >& f) {
+  f();
+}
+
+#endif
+
+} // end namespace analyzer
+} // end namespace ikos
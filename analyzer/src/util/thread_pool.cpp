@@ -0,0 +1,190 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Thread pool for parallel analyses
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+#include <ikos/analyzer/support/assert.hpp>
+#include <ikos/analyzer/util/log.hpp>
+#include <ikos/analyzer/util/numa.hpp>
+#include <ikos/analyzer/util/thread_pool.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+bool ThreadPool::NumaPlacement = false;
+
+ThreadPool::ThreadPool(std::size_t num_workers)
+    : _next_queue(0), _pending(0), _failed(false) {
+  ikos_assert_msg(num_workers > 0, "invalid number of workers");
+  this->_queues.reserve(num_workers);
+  for (std::size_t i = 0; i < num_workers; i++) {
+    this->_queues.emplace_back(std::make_unique< WorkQueue >());
+  }
+
+  // Consecutive workers share a node
+  std::size_t num_nodes = NumaTopology::get().num_nodes();
+  if (NumaPlacement && num_nodes > 1 && num_workers > 1) {
+    this->_nodes.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; i++) {
+      this->_nodes.push_back(i * num_nodes / num_workers);
+    }
+  }
+
+  // Steal from the workers of the same node first, then in a round-robin
+  // fashion from the next workers
+  this->_victims.resize(num_workers);
+  for (std::size_t worker = 0; worker < num_workers; worker++) {
+    std::vector< std::size_t >& victims = this->_victims[worker];
+    victims.reserve(num_workers - 1);
+    for (std::size_t i = 1; i < num_workers; i++) {
+      victims.push_back((worker + i) % num_workers);
+    }
+    if (!this->_nodes.empty()) {
+      std::stable_partition(victims.begin(),
+                            victims.end(),
+                            [this, worker](std::size_t victim) {
+                              return this->_nodes[victim] ==
+                                     this->_nodes[worker];
+                            });
+    }
+  }
+}
+
+ThreadPool::~ThreadPool() = default;
+
+void ThreadPool::push(Task task) {
+  std::size_t i = this->_next_queue++ % this->_queues.size();
+  WorkQueue& queue = *this->_queues[i];
+  this->_pending++;
+  std::lock_guard< std::mutex > lock(queue.mutex);
+  queue.tasks.push_back(std::move(task));
+}
+
+void ThreadPool::run() {
+  std::vector< std::thread > threads;
+  threads.reserve(this->_queues.size() - 1);
+  for (std::size_t i = 1; i < this->_queues.size(); i++) {
+    threads.emplace_back([this, i] {
+      log::set_thread_prefix("[worker " + std::to_string(i) + "] ");
+      if (!this->_nodes.empty()) {
+        NumaTopology::get().bind_current_thread(this->_nodes[i]);
+      }
+      this->work(i);
+    });
+  }
+
+  if (!this->_nodes.empty()) {
+    ScopeNumaBinding binding(NumaTopology::get(), this->_nodes[0]);
+    this->work(0);
+  } else {
+    this->work(0);
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  if (this->_exception) {
+    std::exception_ptr exception = this->_exception;
+    this->_exception = nullptr;
+    this->_failed = false;
+    std::rethrow_exception(exception);
+  }
+}
+
+void ThreadPool::work(std::size_t worker) {
+  Task task;
+  while (this->_pending > 0) {
+    if (!this->pop(worker, task)) {
+      // Other workers are still running tasks that might push new ones
+      std::this_thread::yield();
+      continue;
+    }
+
+    if (!this->_failed) {
+      try {
+        task(worker);
+      } catch (...) {
+        std::lock_guard< std::mutex > lock(this->_exception_mutex);
+        if (!this->_exception) {
+          this->_exception = std::current_exception();
+        }
+        this->_failed = true;
+      }
+    }
+
+    task = nullptr;
+    this->_pending--;
+  }
+}
+
+bool ThreadPool::pop(std::size_t worker, Task& task) {
+  // Look in the worker's own queue first
+  {
+    WorkQueue& queue = *this->_queues[worker];
+    std::lock_guard< std::mutex > lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      return true;
+    }
+  }
+
+  // Steal from the other queues
+  for (std::size_t victim : this->_victims[worker]) {
+    WorkQueue& queue = *this->_queues[victim];
+    std::lock_guard< std::mutex > lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+} // end namespace analyzer
+} // end namespace ikos
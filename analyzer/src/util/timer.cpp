@@ -42,19 +42,47 @@
  ******************************************************************************/
 
 #include <ikos/analyzer/database/output.hpp>
+#include <ikos/analyzer/util/memory_governor.hpp>
 #include <ikos/analyzer/util/timer.hpp>
+#include <ikos/analyzer/util/trace.hpp>
 
 namespace ikos {
 namespace analyzer {
 
 ScopeTimerDatabase::ScopeTimerDatabase(TimesTable& table, std::string name)
-    : _table(table), _name(std::move(name)) {
+    : _counters(PerfCounters::read_process()),
+      _allocations(AllocationStats::read()),
+      _table(table),
+      _name(std::move(name)) {
   this->_timer.start();
 }
 
 ScopeTimerDatabase::~ScopeTimerDatabase() {
   this->_timer.stop();
-  this->_table.insert(this->_name, this->_timer.elapsed().count());
+  boost::optional< std::uint64_t > peak_rss =
+      MemoryGovernor::peak_resident_size();
+  boost::optional< PerfCounterValues > counters;
+  if (this->_counters) {
+    counters = *PerfCounters::read_process() - *this->_counters;
+  }
+  boost::optional< AllocationValues > allocations;
+  if (this->_allocations) {
+    allocations = *AllocationStats::read() - *this->_allocations;
+  }
+  this->_table.insert(this->_name,
+                      this->_timer.elapsed().count(),
+                      peak_rss ? boost::make_optional(
+                                     static_cast< sqlite::DbInt64 >(*peak_rss))
+                               : boost::none,
+                      counters,
+                      allocations);
+  if (Tracer::enabled()) {
+    Tracer::record("phase",
+                   this->_name,
+                   this->_timer.start_time(),
+                   this->_timer.end_time(),
+                   counters);
+  }
 }
 
 } // end namespace analyzer
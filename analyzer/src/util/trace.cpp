@@ -0,0 +1,141 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implement nested time spans
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <ikos/analyzer/json/json.hpp>
+#include <ikos/analyzer/util/trace.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+/// \brief A recorded span
+struct Span {
+  const char* category;
+  std::string name;
+  Timer::TimePoint start;
+  Timer::TimePoint end;
+  boost::optional< PerfCounterValues > counters;
+};
+
+/// \brief Spans recorded by a thread
+struct ThreadSpans {
+  std::size_t tid;
+  std::vector< Span > spans;
+};
+
+/// \brief Mutex protecting AllThreadSpans
+std::mutex AllThreadSpansMutex;
+
+/// \brief Spans of all threads, kept after the threads exit
+std::vector< std::unique_ptr< ThreadSpans > > AllThreadSpans;
+
+/// \brief Spans of the current thread, or null
+thread_local ThreadSpans* CurrentThreadSpans = nullptr;
+
+/// \brief Start time of the trace
+const Timer::TimePoint TraceStart = Timer::Clock::now();
+
+/// \brief Return the number of microseconds between the start of the trace
+/// and the given time point
+double microseconds(Timer::TimePoint t) {
+  return std::chrono::duration< double, std::micro >(t - TraceStart).count();
+}
+
+} // end anonymous namespace
+
+bool Tracer::Enabled = false;
+
+void Tracer::record(const char* category,
+                    StringRef name,
+                    Timer::TimePoint start,
+                    Timer::TimePoint end,
+                    const boost::optional< PerfCounterValues >& counters) {
+  if (CurrentThreadSpans == nullptr) {
+    std::lock_guard< std::mutex > lock(AllThreadSpansMutex);
+    AllThreadSpans.push_back(std::make_unique< ThreadSpans >());
+    CurrentThreadSpans = AllThreadSpans.back().get();
+    CurrentThreadSpans->tid = AllThreadSpans.size();
+  }
+  CurrentThreadSpans->spans.push_back(
+      Span{category, name.to_string(), start, end, counters});
+}
+
+void Tracer::write(llvm::raw_ostream& o) {
+  std::lock_guard< std::mutex > lock(AllThreadSpansMutex);
+
+  // Complete events, see the Trace Event Format specification
+  o << "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& thread_spans : AllThreadSpans) {
+    for (const Span& span : thread_spans->spans) {
+      if (!first) {
+        o << ",\n";
+      }
+      first = false;
+      JsonDict event{{"name", span.name},
+                     {"cat", span.category},
+                     {"ph", "X"},
+                     {"ts", microseconds(span.start)},
+                     {"dur", microseconds(span.end) - microseconds(span.start)},
+                     {"pid", 1},
+                     {"tid", thread_spans->tid}};
+      if (span.counters) {
+        event.put("args",
+                  JsonDict{{"instructions", span.counters->instructions},
+                           {"cycles", span.counters->cycles},
+                           {"llc_misses", span.counters->llc_misses},
+                           {"branch_misses", span.counters->branch_misses}});
+      }
+      o << event.str();
+    }
+  }
+  o << "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -0,0 +1,12 @@
+// UNSAFE
+
+// The parameter is never used, so the liveness analysis never removes it
+int f(int unused) {
+  return 1;
+}
+
+int main() {
+  int x = f(1);
+  x += f(2);
+  return 10 / (x - 2);
+}
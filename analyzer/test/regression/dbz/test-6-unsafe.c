@@ -0,0 +1,14 @@
+// UNSAFE
+
+// Arithmetic on constant variables, evaluated concretely on non-relational
+// domains and through linear expressions on relational domains
+int main() {
+  int a = 6;
+  int b = 7;
+  unsigned c = 4294967295U;
+  int x = a * b - 42;
+  unsigned y = (c + 2U) * 3U;
+  int r = 100 / (a + b);
+  r += 100 / (int)y;
+  return r + 1 / x;
+}
@@ -58,6 +58,9 @@ namespace ikos {
 namespace ar {
 
 /// \brief Text formatter
+///
+/// The text is written into a large buffer, flushed to the output stream by
+/// blocks, and the text of the types is cached.
 class TextFormatter : public Formatter {
 public:
   /// \brief Public constructor
@@ -82,6 +85,13 @@ public:
   /// \brief Format a bundle into text format
   void format(std::ostream&, Bundle*) const;
 
+  /// \brief Format a bundle into text format, with the given number of
+  /// threads
+  ///
+  /// Functions are formatted in parallel into separate buffers, which are
+  /// then written in order. The output is the same as with one thread.
+  void format(std::ostream&, Bundle*, unsigned jobs) const;
+
   /// \brief Format a global variable into text format
   void format(std::ostream&, GlobalVariable*) const;
 
@@ -52,11 +52,25 @@ namespace ar {
 ///
 /// This pass adds an initialization statement that sets the counter to zero in
 /// all basic blocks before a loop, and then adds a statement that increments
-/// the counter by one within that loop.
+/// the counter by one within that loop. The counter is forgotten in the exit
+/// blocks of the loop that are only reachable from the loop.
+///
+/// Each counter is a dimension of the gauges of the Gauge domain. By default,
+/// counters are only added in loops that might benefit from them: loops with
+/// an affine update (`x = y + c` or `x = y - c`, for a constant `c`) and a
+/// pointer shift with a non-constant term.
 class AddLoopCountersPass final : public CodePass {
+private:
+  /// \brief Add a counter in all loops
+  bool _all_loops;
+
 public:
-  /// \brief Default constructor
-  AddLoopCountersPass() = default;
+  /// \brief Constructor
+  ///
+  /// \param all_loops Add a counter in all loops, instead of the loops with
+  /// affine updates used in pointer shifts
+  explicit AddLoopCountersPass(bool all_loops = false)
+      : _all_loops(all_loops) {}
 
   /// \brief Get the pass name
   const char* name() const override;
@@ -91,7 +91,8 @@ public:
 
   /// \brief Run the pass on the given Bundle
   ///
-  /// Returns true if the bundle has been updated
+  /// Returns true if the bundle has been updated. The cached structural hash
+  /// of the updated codes is invalidated.
   bool run(Bundle*) override;
 
 private:
@@ -100,6 +101,9 @@ private:
   /// Returns true if the code has been updated
   virtual bool run_on_code(Code*) = 0;
 
+  // friends
+  friend class PassManager;
+
 }; // end class CodePass
 
 } // end namespace ar
@@ -0,0 +1,133 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Run a sequence of passes
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <ikos/ar/pass/pass.hpp>
+
+namespace ikos {
+namespace ar {
+
+/// \brief Run a sequence of passes on a bundle
+///
+/// Consecutive code passes are pipelined: each code (function body or global
+/// variable initializer) goes through all of them, and codes are processed in
+/// parallel on `jobs` threads. Other passes run alone, on the whole bundle.
+///
+/// Code passes are run concurrently on different codes, so they must not
+/// share mutable state between codes.
+class PassManager {
+public:
+  /// \brief Statistics about a pass
+  struct Statistics {
+    /// \brief Time spent in the pass, summed over all threads
+    std::chrono::duration< double > time = std::chrono::duration< double >(0);
+
+    /// \brief Number of statements after the pass, minus before the pass
+    std::int64_t statements = 0;
+  };
+
+private:
+  // Passes to run
+  std::vector< std::unique_ptr< Pass > > _passes;
+
+  // Statistics, for each pass
+  std::vector< Statistics > _statistics;
+
+  // Number of threads
+  unsigned _jobs;
+
+public:
+  /// \brief Constructor
+  ///
+  /// \param jobs Number of threads used to run code passes
+  explicit PassManager(unsigned jobs = 1) : _jobs(jobs) {}
+
+  /// \brief Deleted copy constructor
+  PassManager(const PassManager&) = delete;
+
+  /// \brief Default move constructor
+  PassManager(PassManager&&) noexcept = default;
+
+  /// \brief Deleted copy assignment operator
+  PassManager& operator=(const PassManager&) = delete;
+
+  /// \brief Default move assignment operator
+  PassManager& operator=(PassManager&&) noexcept = default;
+
+  /// \brief Destructor
+  ~PassManager() = default;
+
+  /// \brief Add a pass at the end of the sequence
+  void add(std::unique_ptr< Pass > pass);
+
+  /// \brief Return the number of passes
+  std::size_t num_passes() const { return this->_passes.size(); }
+
+  /// \brief Return the i-th pass
+  const Pass& pass(std::size_t i) const { return *this->_passes[i]; }
+
+  /// \brief Return the statistics of the i-th pass
+  const Statistics& statistics(std::size_t i) const {
+    return this->_statistics[i];
+  }
+
+  /// \brief Run all the passes on the given bundle
+  ///
+  /// Returns true if the bundle has been updated. Statistics are accumulated
+  /// over successive runs.
+  bool run(Bundle*);
+
+private:
+  /// \brief Run the code passes in [begin, end) on the given bundle
+  bool run_code_passes(Bundle*, std::size_t begin, std::size_t end);
+
+}; // end class PassManager
+
+} // end namespace ar
+} // end namespace ikos
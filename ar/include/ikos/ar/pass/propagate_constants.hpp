@@ -0,0 +1,99 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Propagate constants and remove dead stores
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <ikos/ar/pass/pass.hpp>
+#include <ikos/ar/semantic/code.hpp>
+
+namespace ikos {
+namespace ar {
+
+/// \brief Pass to propagate constants and remove dead stores
+///
+/// The pass iterates the following steps until nothing changes:
+///   * Basic blocks with a comparison on constants that is always false are
+///     infeasible. The basic blocks that are not reachable through
+///     feasible basic blocks are ignored.
+///   * Comparisons on constants that are always true are removed.
+///   * An internal variable with a single reachable definition that is a
+///     constant, or that folds into a constant, is replaced by that constant.
+///     Its definition is removed.
+///
+/// Operations that could raise an error (division by zero, invalid shift
+/// count, integer overflow) are never folded.
+///
+/// Finally, a store is removed when it is followed, in the same basic block,
+/// by a store of the same type on the same pointer, without any statement
+/// reading memory in-between.
+class PropagateConstantsPass final : public CodePass {
+public:
+  /// \brief Default constructor
+  PropagateConstantsPass() = default;
+
+  /// \brief Get the pass name
+  const char* name() const override;
+
+  /// \brief Get the pass description
+  const char* description() const override;
+
+private:
+  /// \brief Run the pass on the given Code
+  ///
+  /// Return true if the code has been updated
+  bool run_on_code(Code*) override;
+
+  /// \brief Propagate the constants of one iteration
+  ///
+  /// Return true if the code has been updated
+  bool propagate_constants(Code*);
+
+  /// \brief Remove the stores overwritten in the same basic block
+  ///
+  /// Return true if the code has been updated
+  bool remove_dead_stores(Code*);
+
+}; // end class PropagateConstantsPass
+
+} // end namespace ar
+} // end namespace ikos
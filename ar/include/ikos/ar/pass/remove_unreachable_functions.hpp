@@ -0,0 +1,89 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Remove the functions unreachable from the entry points
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <ikos/ar/pass/pass.hpp>
+#include <ikos/ar/semantic/function.hpp>
+
+namespace ikos {
+namespace ar {
+
+/// \brief Pass to remove the functions unreachable from the entry points
+///
+/// A function is reachable if it is an entry point, or if it is referenced
+/// (called or address taken) by a reachable function or by the initializer of
+/// a reachable global variable. A global variable is reachable if it is
+/// referenced by a reachable function or initializer, or if it is
+/// ar.global_ctors or ar.global_dtors.
+///
+/// The bodies of unreachable functions and the initializers of unreachable
+/// global variables are removed, turning them into declarations.
+class RemoveUnreachableFunctionsPass final : public Pass {
+private:
+  // Entry points
+  std::vector< Function* > _entry_points;
+
+public:
+  /// \brief Constructor
+  explicit RemoveUnreachableFunctionsPass(std::vector< Function* > entry_points)
+      : _entry_points(std::move(entry_points)) {}
+
+  /// \brief Run the pass on the given Bundle
+  ///
+  /// Returns true if the bundle has been updated
+  bool run(Bundle*) override;
+
+  /// \brief Get the pass name
+  const char* name() const override;
+
+  /// \brief Get the pass description
+  const char* description() const override;
+
+}; // end class RemoveUnreachableFunctionsPass
+
+} // end namespace ar
+} // end namespace ikos
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Slice the code with respect to a set of statements
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <utility>
+
+#include <ikos/ar/pass/pass.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+
+namespace ikos {
+namespace ar {
+
+/// \brief Pass to slice the code with respect to a criterion
+///
+/// The criterion selects the statements of interest (e.g, the statements
+/// checked by an analysis). The pass removes the statements that do not
+/// contribute to the value of an operand of the statements of interest.
+///
+/// The slice is conservative:
+///   * Only side-effect free statements defining an internal variable can be
+///     removed (assignments, arithmetic, pointer shifts, non-volatile loads and
+///     vector operations).
+///   * Statements with memory or control side effects (stores, comparisons,
+///     calls, allocations, returns, etc.) are always kept, along with the
+///     backward data slice of their operands.
+///   * The control flow graph is left unchanged, hence the control
+///     dependencies of the statements of interest are preserved.
+class SlicePass final : public CodePass {
+public:
+  /// \brief Criterion, returns true for the statements of interest
+  using Criterion = std::function< bool(Statement*) >;
+
+private:
+  Criterion _criterion;
+
+public:
+  /// \brief Constructor
+  explicit SlicePass(Criterion criterion) : _criterion(std::move(criterion)) {}
+
+  /// \brief Get the pass name
+  const char* name() const override;
+
+  /// \brief Get the pass description
+  const char* description() const override;
+
+private:
+  /// \brief Run the pass on the given Code
+  ///
+  /// Return true if the code has been updated
+  bool run_on_code(Code*) override;
+
+  /// \brief Return true if the given statement can be removed
+  bool is_removable(Statement*) const;
+
+}; // end class SlicePass
+
+} // end namespace ar
+} // end namespace ikos
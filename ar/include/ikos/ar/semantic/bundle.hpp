@@ -44,10 +44,12 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <ikos/ar/semantic/context.hpp>
 #include <ikos/ar/semantic/data_layout.hpp>
+#include <ikos/ar/semantic/hash.hpp>
 #include <ikos/ar/semantic/intrinsic.hpp>
 #include <ikos/ar/semantic/symbol_table.hpp>
 #include <ikos/ar/support/string_ref.hpp>
@@ -82,6 +84,9 @@ private:
   // List of functions
   SymbolTable< Function > _functions;
 
+  // Mutex for intrinsic_function()
+  std::mutex _intrinsics_mutex;
+
 public:
   /// \brief Iterator over a list of global variables
   using GlobalVariableIterator = SymbolTable< GlobalVariable >::Iterator;
@@ -152,6 +157,9 @@ public:
   std::size_t num_functions() const { return this->_functions.size(); }
 
   /// \brief Get the intrinsic function of the given ID
+  ///
+  /// This is thread-safe, so that passes running on different codes in
+  /// parallel can declare intrinsics.
   Function* intrinsic_function(Intrinsic::ID id);
 
   /// \brief Get the function with the given name, or nullptr
@@ -165,6 +173,13 @@ public:
   /// \brief Find an available name with the given prefix
   std::string find_available_name(StringRef prefix) const;
 
+  /// \brief Get the structural hash of the bundle
+  ///
+  /// The hash covers the target triple, global variables and functions. It is
+  /// computed from the cached hashes of the codes, so it is cheap to recompute
+  /// after a pass changed a few functions.
+  HashValue hash() const;
+
 private:
   /// \brief Add a global variable in the bundle
   void add_global_variable(std::unique_ptr< GlobalVariable >);
@@ -43,6 +43,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -55,7 +57,9 @@
 #include <ikos/ar/semantic/bundle.hpp>
 #include <ikos/ar/semantic/context.hpp>
 #include <ikos/ar/semantic/function.hpp>
+#include <ikos/ar/semantic/hash.hpp>
 #include <ikos/ar/semantic/value.hpp>
+#include <ikos/ar/support/arena.hpp>
 #include <ikos/ar/support/assert.hpp>
 #include <ikos/ar/support/iterator.hpp>
 #include <ikos/ar/support/traceable.hpp>
@@ -84,6 +88,9 @@ private:
   // Parent code
   Code* _parent;
 
+  // Index in the parent code, in [0, num_basic_blocks())
+  std::size_t _index;
+
   // Name (optional)
   std::string _name;
 
@@ -133,6 +140,12 @@ public:
   /// \brief Get the parent code
   Code* code() const { return this->_parent; }
 
+  /// \brief Get the index in the parent code
+  ///
+  /// Indices are dense, in [0, code()->num_basic_blocks()). They are
+  /// renumbered when a basic block is erased.
+  std::size_t index() const { return this->_index; }
+
   /// \brief Get the first statement
   Statement* front() const {
     ikos_assert_msg(!this->_statements.empty(), "basic block is empty");
@@ -188,7 +201,9 @@ public:
   void insert_after(StatementIterator it, std::unique_ptr< Statement > stmt);
 
   /// \brief Remove the statement at it
-  void remove(StatementIterator it);
+  ///
+  /// Returns an iterator to the statement following the removed one.
+  StatementIterator remove(StatementIterator it);
 
   /// \brief Remove the last statement and return it
   std::unique_ptr< Statement > pop_back();
@@ -267,6 +282,9 @@ public:
   /// \brief Dump the basic block and its content, for debugging purpose
   void full_dump(std::ostream&) const;
 
+  // friends
+  friend class Code;
+
 }; // end class BasicBlock
 
 /// \brief Code
@@ -275,6 +293,11 @@ public:
 /// initializer
 class Code : public Traceable {
 private:
+  // Arena for the statements, or null
+  //
+  // This is declared first, so that it is destroyed after the statements.
+  std::unique_ptr< Arena > _arena;
+
   // List of basic blocks
   std::vector< std::unique_ptr< BasicBlock > > _blocks;
 
@@ -296,6 +319,12 @@ private:
   // Parent bundle (non-null)
   Bundle* _bundle;
 
+  // Cached structural hash, or 0 if not computed yet
+  mutable std::atomic< HashValue > _hash;
+
+  // True if the code was created or modified since it was last verified
+  std::atomic< bool > _dirty;
+
 public:
   /// \brief Iterator over a list of basic block
   using BasicBlockIterator = boost::transform_iterator<
@@ -342,6 +371,9 @@ public:
                                           SeqExposeRawPtr< BasicBlock >());
   }
 
+  /// \brief Get the number of basic blocks
+  std::size_t num_basic_blocks() const { return this->_blocks.size(); }
+
   /// \brief Begin iterator over the list of internal variables
   InternalVariableIterator internal_variable_begin() const {
     return boost::make_transform_iterator(this->_internal_vars.cbegin(),
@@ -412,6 +444,58 @@ public:
   /// \brief Get the parent bundle
   Bundle* bundle() const { return this->_bundle; }
 
+  /// \brief Get the structural hash of the code
+  ///
+  /// The hash is computed on the first call and cached. Code transformations
+  /// must call invalidate_hash(), see CodePass::run().
+  HashValue hash() const;
+
+  /// \brief Invalidate the cached structural hash
+  void invalidate_hash() { this->_hash.store(0); }
+
+  /// \brief Return true if the code was created or modified since it was
+  /// last verified
+  ///
+  /// Code transformations must call mark_dirty(), see CodePass::run(), so that
+  /// only the modified codes are verified again.
+  bool is_dirty() const { return this->_dirty.load(); }
+
+  /// \brief Mark the code as modified since it was last verified
+  void mark_dirty() { this->_dirty.store(true); }
+
+  /// \brief Mark the code as verified
+  void mark_clean() { this->_dirty.store(false); }
+
+  /// \brief Allocate the statements created by the current thread in the
+  /// arena of the given code, for the lifetime of the scope
+  ///
+  /// Statements created in a scope are contiguous in memory, in creation
+  /// order, and are released all at once with the code. They must not be moved
+  /// into another code. Statements created outside of a scope, for instance by
+  /// passes, are allocated on the heap.
+  class ArenaScope {
+  private:
+    // Previous arena of the current thread
+    Arena* _prev;
+
+  public:
+    /// \brief Enter the scope
+    explicit ArenaScope(Code* code);
+
+    /// \brief Deleted copy constructor
+    ArenaScope(const ArenaScope&) = delete;
+
+    /// \brief Deleted copy assignment operator
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    /// \brief Leave the scope
+    ~ArenaScope();
+
+  }; // end class ArenaScope
+
+  /// \brief Return the arena used by the current thread, or null
+  static Arena* current_arena();
+
 private:
   /// \brief Add a basic block in the code
   void add_basic_block(std::unique_ptr< BasicBlock >);
@@ -450,6 +534,12 @@ struct GraphTraits< ar::Code* > {
 
   static ar::BasicBlock* entry(ar::Code* code) { return code->entry_block(); }
 
+  static std::size_t index(ar::BasicBlock* bb) { return bb->index(); }
+
+  static std::size_t num_nodes(ar::Code* code) {
+    return code->num_basic_blocks();
+  }
+
   static SuccessorNodeIterator successor_begin(ar::BasicBlock* bb) {
     return bb->successor_begin();
   }
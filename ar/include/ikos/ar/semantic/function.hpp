@@ -51,6 +51,7 @@
 
 #include <ikos/ar/semantic/bundle.hpp>
 #include <ikos/ar/semantic/context.hpp>
+#include <ikos/ar/semantic/hash.hpp>
 #include <ikos/ar/semantic/intrinsic.hpp>
 #include <ikos/ar/semantic/type.hpp>
 #include <ikos/ar/semantic/value.hpp>
@@ -187,6 +188,17 @@ public:
   /// \brief Get the function body code, or null if it's a declaration
   Code* body_or_null() const { return this->_body.get(); }
 
+  /// \brief Remove the body, turning the function into a declaration
+  ///
+  /// This also removes the local variables and parameters. Using them after
+  /// calling erase_body() is an undefined behavior.
+  void erase_body();
+
+  /// \brief Get the structural hash of the function
+  ///
+  /// The hash covers the function type and body, but not its name.
+  HashValue hash() const;
+
   /// \brief Begin iterator over the list of local variables
   LocalVariableIterator local_variable_begin() const {
     ikos_assert_msg(this->_body, "function is a declaration");
@@ -79,6 +79,7 @@ public:
     IkosNonDetUi32,
     IkosCounterInit,
     IkosCounterIncr,
+    IkosCounterForget,
     IkosPrintInvariant,
     IkosPrintValues,
     _EndIkosIntrinsic,
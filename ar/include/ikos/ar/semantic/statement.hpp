@@ -134,6 +134,16 @@ public:
   /// \brief Destructor
   virtual ~Statement();
 
+  /// \brief Allocate a statement, in the current arena if any
+  ///
+  /// See Code::ArenaScope
+  static void* operator new(std::size_t size);
+
+  /// \brief Deallocate a statement
+  ///
+  /// Memory from an arena is released with the arena.
+  static void operator delete(void* ptr);
+
   /// \brief Get the kind of statement
   StatementKind kind() const { return this->_kind; }
 
@@ -191,6 +201,16 @@ public:
     return this->_operands[i];
   }
 
+  /// \brief Set the n-th operand
+  ///
+  /// The new operand must have the same type as the previous one.
+  void set_operand(std::size_t i, Value* value) {
+    ikos_assert_msg(i < this->_operands.size(), "invalid index");
+    ikos_assert_msg(value->type() == this->_operands[i]->type(),
+                    "invalid operand type");
+    this->_operands[i] = value;
+  }
+
   /// \brief Dump the statement for debugging purpose
   virtual void dump(std::ostream&) const = 0;
 
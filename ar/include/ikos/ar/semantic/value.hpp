@@ -50,6 +50,7 @@
 
 #include <ikos/ar/semantic/bundle.hpp>
 #include <ikos/ar/semantic/context.hpp>
+#include <ikos/ar/semantic/hash.hpp>
 #include <ikos/ar/semantic/type.hpp>
 #include <ikos/ar/support/assert.hpp>
 #include <ikos/ar/support/cast.hpp>
@@ -82,6 +83,7 @@ public:
     ArrayConstantKind,
     VectorConstantKind,
     _EndSequentialConstantKind,
+    DataArrayConstantKind,
     AggregateZeroConstantKind,
     FunctionPointerConstantKind,
     InlineAssemblyConstantKind,
@@ -166,6 +168,11 @@ public:
   /// \brief Is it a constant vector?
   bool is_vector_constant() const { return this->_kind == VectorConstantKind; }
 
+  /// \brief Is it a data array constant
+  bool is_data_array_constant() const {
+    return this->_kind == DataArrayConstantKind;
+  }
+
   /// \brief Is it a constant aggregate zero?
   bool is_aggregate_zero_constant() const {
     return this->_kind == AggregateZeroConstantKind;
@@ -519,6 +526,67 @@ public:
 
 }; // end class VectorConstant
 
+/// \brief Constant array of integers, stored as raw data
+///
+/// This is a compact alternative to ArrayConstant for large arrays of integers
+/// (e.g, strings, lookup tables, embedded binary blobs). Elements are stored
+/// contiguously in little-endian order, using `element_size()` bytes each,
+/// instead of one IntegerConstant per element.
+class DataArrayConstant final : public Constant {
+private:
+  // Raw data
+  std::string _data;
+
+private:
+  /// \brief Private constructor
+  DataArrayConstant(ArrayType* type, std::string data);
+
+public:
+  /// \brief Static constructor
+  ///
+  /// \param data Elements in little-endian order, using `element_size()`
+  /// bytes each
+  static DataArrayConstant* get(Context& ctx,
+                                ArrayType* type,
+                                const std::string& data);
+
+  /// \brief Get the type
+  ArrayType* type() const { return cast< ArrayType >(this->_type); }
+
+  /// \brief Get the element type
+  IntegerType* element_type() const {
+    return cast< IntegerType >(this->type()->element_type());
+  }
+
+  /// \brief Get the raw data
+  const std::string& data() const { return this->_data; }
+
+  /// \brief Get the size of an element in the raw data, in bytes
+  std::size_t element_size() const {
+    return (this->element_type()->bit_width() + 7) / 8;
+  }
+
+  /// \brief Get the number of elements
+  std::size_t num_elements() const {
+    return this->_data.size() / this->element_size();
+  }
+
+  /// \brief Get the element at the given index
+  MachineInt element(std::size_t i) const;
+
+  /// \brief Dump the value for debugging purpose
+  void dump(std::ostream&) const override;
+
+  /// \brief Method for type support (isa, cast, dyn_cast)
+  static bool classof(const Value* v) {
+    return v->kind() == DataArrayConstantKind;
+  }
+
+  // friends
+  friend class ContextImpl;
+
+}; // end class DataArrayConstant
+
 /// \brief Constant aggregate full of zeros
 class AggregateZeroConstant final : public Constant {
 private:
@@ -709,6 +777,10 @@ public:
   /// \brief Get the global variable initializer code, or null
   Code* initializer_or_null() const { return this->_initializer.get(); }
 
+  /// \brief Remove the initializer, turning the global variable into a
+  /// declaration
+  void erase_initializer();
+
   /// \brief Get the alignment of the global variable in memory, in bytes
   ///
   /// Returns 0 if the alignment is unspecified.
@@ -717,6 +789,11 @@ public:
   /// \brief Return true if the global variable has a specified alignment
   bool has_alignment() const { return this->alignment() > 0; }
 
+  /// \brief Get the structural hash of the global variable
+  ///
+  /// The hash covers the type, alignment and initializer, but not the name.
+  HashValue hash() const;
+
   /// \brief Dump the value for debugging purpose
   void dump(std::ostream&) const override;
 
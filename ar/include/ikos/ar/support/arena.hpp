@@ -0,0 +1,115 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Bump allocator for AR objects
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ikos {
+namespace ar {
+
+/// \brief Bump allocator
+///
+/// Memory is allocated by chunks, and objects allocated one after the other
+/// are contiguous in memory. Memory is only released when the arena is
+/// destroyed: deallocating an object is a no-op.
+///
+/// The arena does not call destructors, and is not thread-safe.
+class Arena {
+public:
+  /// \brief Alignment of the allocated blocks
+  static constexpr std::size_t Alignment = alignof(std::max_align_t);
+
+  /// \brief Default size of a chunk, in bytes
+  static constexpr std::size_t ChunkSize = 16 * 1024;
+
+private:
+  // Allocated chunks
+  std::vector< std::unique_ptr< char[] > > _chunks;
+
+  // Next free byte in the current chunk
+  char* _ptr = nullptr;
+
+  // End of the current chunk
+  char* _end = nullptr;
+
+public:
+  /// \brief Create an empty arena
+  Arena() = default;
+
+  /// \brief Deleted copy constructor
+  Arena(const Arena&) = delete;
+
+  /// \brief Deleted move constructor
+  Arena(Arena&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  Arena& operator=(const Arena&) = delete;
+
+  /// \brief Deleted move assignment operator
+  Arena& operator=(Arena&&) = delete;
+
+  /// \brief Destructor, releasing all the chunks
+  ~Arena() = default;
+
+  /// \brief Allocate a memory block of the given size
+  void* allocate(std::size_t size) {
+    size = (size + Alignment - 1) & ~(Alignment - 1);
+    if (static_cast< std::size_t >(this->_end - this->_ptr) < size) {
+      std::size_t chunk_size = (size > ChunkSize) ? size : ChunkSize;
+      // operator new[] returns memory suitably aligned for any object
+      this->_chunks.emplace_back(new char[chunk_size]);
+      this->_ptr = this->_chunks.back().get();
+      this->_end = this->_ptr + chunk_size;
+    }
+    void* block = this->_ptr;
+    this->_ptr += size;
+    return block;
+  }
+
+}; // end class Arena
+
+} // end namespace ar
+} // end namespace ikos
@@ -83,8 +83,17 @@ public:
 
   /// \brief Check the given bundle
   ///
+  /// Global variables and functions are checked in parallel, and errors are
+  /// written in order.
+  ///
   /// \param err The output stream for errors
-  bool verify(Bundle* bundle, std::ostream& err) const;
+  /// \param jobs Number of threads
+  /// \param dirty_only Only check the global variables and functions with a
+  /// dirty code, see Code::is_dirty()
+  bool verify(Bundle* bundle,
+              std::ostream& err,
+              unsigned jobs = 1,
+              bool dirty_only = false) const;
 
   /// \brief Check the given global variable
   ///
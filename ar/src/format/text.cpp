@@ -41,6 +41,15 @@
  *
  ******************************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include <boost/container/flat_set.hpp>
 
 #include <ikos/ar/format/text.hpp>
@@ -52,7 +61,244 @@
 namespace ikos {
 namespace ar {
 
-void TextFormatter::format(std::ostream& o, Bundle* bundle) const {
+namespace {
+
+/// \brief Number of functions per thread formatted in parallel before the
+/// texts are written, see TextFormatter::format(std::ostream&, Bundle*,
+/// unsigned)
+constexpr std::size_t ParallelChunkSize = 64;
+
+/// \brief Output buffer of the text formatter
+///
+/// Text is appended to a large string, reused for the whole output, instead
+/// of going through the std::ostream for each token. If an output stream is
+/// given, the buffer is written to it when it exceeds FlushSize.
+class TextBuffer {
+private:
+  /// \brief Size of the buffer before it is written to the output stream
+  static constexpr std::size_t FlushSize = 1 << 20;
+
+  /// \brief Buffered text
+  std::string _data;
+
+  /// \brief Output stream, or null
+  std::ostream* _out;
+
+  /// \brief Stream used to format the other values, created on demand
+  std::unique_ptr< std::ostringstream > _fallback;
+
+public:
+  /// \brief Create a buffer writing into the given output stream, or an
+  /// in-memory buffer if it is null
+  explicit TextBuffer(std::ostream* out = nullptr) : _out(out) {
+    if (out != nullptr) {
+      this->_data.reserve(FlushSize + FlushSize / 4);
+    }
+  }
+
+  /// \brief Deleted copy constructor
+  TextBuffer(const TextBuffer&) = delete;
+
+  /// \brief Deleted move constructor
+  TextBuffer(TextBuffer&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  TextBuffer& operator=(const TextBuffer&) = delete;
+
+  /// \brief Deleted move assignment operator
+  TextBuffer& operator=(TextBuffer&&) = delete;
+
+  /// \brief Destructor
+  ~TextBuffer() { this->flush(); }
+
+  /// \brief Write the buffered text to the output stream
+  void flush() {
+    if (this->_out != nullptr && !this->_data.empty()) {
+      this->_out->write(this->_data.data(),
+                        static_cast< std::streamsize >(this->_data.size()));
+      this->_data.clear();
+    }
+  }
+
+  /// \brief Move the buffered text into the given string, keeping the
+  /// capacity of both
+  void move_to(std::string& text) {
+    text.assign(this->_data);
+    this->_data.clear();
+  }
+
+  TextBuffer& operator<<(char c) {
+    this->_data.push_back(c);
+    return *this;
+  }
+
+  template < std::size_t N >
+  TextBuffer& operator<<(const char (&s)[N]) {
+    this->_data.append(s, N - 1);
+    this->flush_if_full();
+    return *this;
+  }
+
+  TextBuffer& operator<<(const std::string& s) {
+    this->_data.append(s);
+    this->flush_if_full();
+    return *this;
+  }
+
+  TextBuffer& operator<<(int n) { return *this << static_cast< long long >(n); }
+
+  TextBuffer& operator<<(long n) {
+    return *this << static_cast< long long >(n);
+  }
+
+  TextBuffer& operator<<(long long n) {
+    if (n < 0) {
+      this->append_integer(0ULL - static_cast< unsigned long long >(n), true);
+    } else {
+      this->append_integer(static_cast< unsigned long long >(n), false);
+    }
+    return *this;
+  }
+
+  TextBuffer& operator<<(unsigned n) {
+    return *this << static_cast< unsigned long long >(n);
+  }
+
+  TextBuffer& operator<<(unsigned long n) {
+    return *this << static_cast< unsigned long long >(n);
+  }
+
+  TextBuffer& operator<<(unsigned long long n) {
+    this->append_integer(n, false);
+    return *this;
+  }
+
+  TextBuffer& operator<<(const ZNumber& n) {
+    if (n.fits< long long >()) {
+      return *this << n.to< long long >();
+    } else {
+      return *this << n.str();
+    }
+  }
+
+  TextBuffer& operator<<(const MachineInt& n) {
+    return *this << n.to_z_number();
+  }
+
+  /// \brief Format any other value with its std::ostream operator
+  template < typename T >
+  TextBuffer& operator<<(const T& value) {
+    if (!this->_fallback) {
+      this->_fallback = std::make_unique< std::ostringstream >();
+    }
+    this->_fallback->str(std::string());
+    *this->_fallback << value;
+    return *this << this->_fallback->str();
+  }
+
+private:
+  /// \brief Append an integer in base 10
+  void append_integer(unsigned long long n, bool negative) {
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* p = end;
+    do {
+      *--p = static_cast< char >('0' + n % 10);
+      n /= 10;
+    } while (n != 0);
+    if (negative) {
+      *--p = '-';
+    }
+    this->_data.append(p, end);
+    this->flush_if_full();
+  }
+
+  /// \brief Write the buffer to the output stream if it exceeds FlushSize
+  void flush_if_full() {
+    if (this->_data.size() >= FlushSize) {
+      this->flush();
+    }
+  }
+
+}; // end class TextBuffer
+
+/// \brief Write the text format of the AR into a TextBuffer
+///
+/// This implements TextFormatter. The text of the types is cached, since the
+/// types of the operands are formatted on each statement.
+class TextWriter {
+private:
+  /// \brief Formatter options
+  const TextFormatter& _formatter;
+
+  /// \brief Text of the types
+  std::unordered_map< Type*, std::string > _types;
+
+public:
+  /// \brief Create a writer with the options of the given formatter
+  explicit TextWriter(const TextFormatter& formatter) : _formatter(formatter) {}
+
+  /// \brief Deleted copy constructor
+  TextWriter(const TextWriter&) = delete;
+
+  /// \brief Default move constructor
+  TextWriter(TextWriter&&) = default;
+
+  /// \brief Deleted copy assignment operator
+  TextWriter& operator=(const TextWriter&) = delete;
+
+  /// \brief Deleted move assignment operator
+  TextWriter& operator=(TextWriter&&) = delete;
+
+  /// \brief Destructor
+  ~TextWriter() = default;
+
+  /// \brief Show the result type of the statements
+  bool show_result_type() const { return this->_formatter.show_result_type(); }
+
+  /// \brief Show the operand types of the statements
+  bool show_operand_types() const {
+    return this->_formatter.show_operand_types();
+  }
+
+  /// \brief Format the data layout and target of a bundle
+  void format_header(TextBuffer&, Bundle*);
+
+  /// \brief Format a global variable
+  void format(TextBuffer&, GlobalVariable*);
+
+  /// \brief Format a function
+  void format(TextBuffer&, Function*);
+
+  /// \brief Format a code
+  void format(TextBuffer&, Code*);
+
+  /// \brief Format a code
+  void format(TextBuffer&, Code*, const Namer&);
+
+  /// \brief Format a basic block
+  void format(TextBuffer&, BasicBlock*);
+
+  /// \brief Format a basic block
+  void format(TextBuffer&, BasicBlock*, const Namer&);
+
+  /// \brief Format a statement
+  void format(TextBuffer&, Statement*);
+
+  /// \brief Format a statement
+  void format(TextBuffer&, Statement*, const Namer&);
+
+  /// \brief Format a type
+  void format(TextBuffer&, Type*);
+
+  /// \brief Format a value
+  void format(TextBuffer&, Value*, const Namer&, bool show_type);
+
+}; // end class TextWriter
+
+} // end anonymous namespace
+
+void TextWriter::format_header(TextBuffer& o, Bundle* bundle) {
   o << "// Bundle\n";
 
   // data layout
@@ -71,51 +317,9 @@ void TextFormatter::format(std::ostream& o, Bundle* bundle) const {
 
   // target triple
   o << "target-triple = " << bundle->target_triple() << "\n";
-
-  if (!this->order_globals()) {
-    // global variables
-    for (auto it = bundle->global_begin(), et = bundle->global_end(); it != et;
-         ++it) {
-      o << "\n";
-      this->format(o, *it);
-    }
-
-    // functions
-    for (auto it = bundle->function_begin(), et = bundle->function_end();
-         it != et;
-         ++it) {
-      o << "\n";
-      this->format(o, *it);
-    }
-  } else {
-    // sort global variables and functions by name, before formatting
-    std::vector< GlobalVariable* > globals(bundle->global_begin(),
-                                           bundle->global_end());
-    std::vector< Function* > functions(bundle->function_begin(),
-                                       bundle->function_end());
-
-    std::sort(globals.begin(),
-              globals.end(),
-              [](GlobalVariable* a, GlobalVariable* b) {
-                return a->name() < b->name();
-              });
-    std::sort(functions.begin(), functions.end(), [](Function* a, Function* b) {
-      return a->name() < b->name();
-    });
-
-    // format globals and functions
-    for (GlobalVariable* gv : globals) {
-      o << "\n";
-      this->format(o, gv);
-    }
-    for (Function* fun : functions) {
-      o << "\n";
-      this->format(o, fun);
-    }
-  }
 }
 
-void TextFormatter::format(std::ostream& o, GlobalVariable* gv) const {
+void TextWriter::format(TextBuffer& o, GlobalVariable* gv) {
   // declare/define
   if (gv->is_declaration()) {
     o << "declare ";
@@ -142,7 +346,7 @@ void TextFormatter::format(std::ostream& o, GlobalVariable* gv) const {
   }
 }
 
-void TextFormatter::format(std::ostream& o, Function* f) const {
+void TextWriter::format(TextBuffer& o, Function* f) {
   FunctionType* type = f->type();
   Namer namer;
 
@@ -195,25 +399,25 @@ void TextFormatter::format(std::ostream& o, Function* f) const {
   }
 }
 
-void TextFormatter::format(std::ostream& o, Code* code) const {
+void TextWriter::format(TextBuffer& o, Code* code) {
   this->format(o, code, Namer(code));
 }
 
-void TextFormatter::format(std::ostream& o,
-                           Code* code,
-                           const Namer& namer) const {
+void TextWriter::format(TextBuffer& o,
+                        Code* code,
+                           const Namer& namer) {
   for (auto it = code->begin(), et = code->end(); it != et; ++it) {
     this->format(o, *it, namer);
   }
 }
 
-void TextFormatter::format(std::ostream& o, BasicBlock* bb) const {
+void TextWriter::format(TextBuffer& o, BasicBlock* bb) {
   this->format(o, bb, Namer(bb->code()));
 }
 
-void TextFormatter::format(std::ostream& o,
-                           BasicBlock* bb,
-                           const Namer& namer) const {
+void TextWriter::format(TextBuffer& o,
+                        BasicBlock* bb,
+                           const Namer& namer) {
   Code* code = bb->code();
 
   // name
@@ -264,7 +468,7 @@ void TextFormatter::format(std::ostream& o,
   o << "}\n";
 }
 
-void TextFormatter::format(std::ostream& o, Statement* stmt) const {
+void TextWriter::format(TextBuffer& o, Statement* stmt) {
   Namer namer(stmt->code());
   this->format(o, stmt, namer);
 }
@@ -277,13 +481,13 @@ public:
   using ResultType = void;
 
 public:
-  const TextFormatter& formatter;
-  std::ostream& o;
+  TextWriter& formatter;
+  TextBuffer& o;
   const Namer& namer;
 
 public:
-  FormatTextStatement(const TextFormatter& formatter_,
-                      std::ostream& o_,
+  FormatTextStatement(TextWriter& formatter_,
+                      TextBuffer& o_,
                       const Namer& namer_)
       : formatter(formatter_), o(o_), namer(namer_) {}
 
@@ -477,9 +681,9 @@ public:
 
 } // end anonymous namespace
 
-void TextFormatter::format(std::ostream& o,
-                           Statement* stmt,
-                           const Namer& namer) const {
+void TextWriter::format(TextBuffer& o,
+                        Statement* stmt,
+                           const Namer& namer) {
   FormatTextStatement vis(*this, o, namer);
   apply_visitor(vis, stmt);
 }
@@ -495,13 +699,13 @@ public:
   using ResultType = void;
 
 public:
-  std::ostream& o;
+  TextBuffer& o;
   TypeSet seen;
 
 public:
-  explicit FormatTextType(std::ostream& o_) : o(o_) {}
+  explicit FormatTextType(TextBuffer& o_) : o(o_) {}
 
-  FormatTextType(std::ostream& o_, TypeSet seen_)
+  FormatTextType(TextBuffer& o_, TypeSet seen_)
       : o(o_), seen(std::move(seen_)) {}
 
   void operator()(VoidType* /*t*/) { o << "void"; }
@@ -607,9 +811,16 @@ public:
 
 } // end anonymous namespace
 
-void TextFormatter::format(std::ostream& o, Type* type) const {
-  FormatTextType vis(o);
-  apply_visitor(vis, type);
+void TextWriter::format(TextBuffer& o, Type* type) {
+  auto it = this->_types.find(type);
+  if (it == this->_types.end()) {
+    TextBuffer text;
+    FormatTextType vis(text);
+    apply_visitor(vis, type);
+    it = this->_types.emplace(type, std::string()).first;
+    text.move_to(it->second);
+  }
+  o << it->second;
 }
 
 namespace {
@@ -620,11 +831,11 @@ public:
   using ResultType = void;
 
 public:
-  std::ostream& o;
+  TextBuffer& o;
   const Namer& namer;
 
 public:
-  FormatTextValue(std::ostream& o_, const Namer& namer_)
+  FormatTextValue(TextBuffer& o_, const Namer& namer_)
       : o(o_), namer(namer_) {}
 
   void operator()(UndefinedConstant* /*c*/) { o << "undef"; }
@@ -672,6 +883,18 @@ public:
     o << ">";
   }
 
+  void operator()(DataArrayConstant* c) {
+    o << "[";
+    for (std::size_t i = 0, n = c->num_elements(); i < n;) {
+      o << c->element(i);
+      ++i;
+      if (i != n) {
+        o << ", ";
+      }
+    }
+    o << "]";
+  }
+
   void operator()(AggregateZeroConstant* /*c*/) { o << "aggregate_zero"; }
 
   void operator()(FunctionPointerConstant* c) {
@@ -692,10 +915,10 @@ public:
 
 } // end anonymous namespace
 
-void TextFormatter::format(std::ostream& o,
-                           Value* value,
+void TextWriter::format(TextBuffer& o,
+                        Value* value,
                            const Namer& namer,
-                           bool show_type) const {
+                           bool show_type) {
   if (show_type) {
     this->format(o, value->type());
     o << " ";
@@ -704,5 +927,147 @@ void TextFormatter::format(std::ostream& o,
   apply_visitor(vis, value);
 }
 
+void TextFormatter::format(std::ostream& o, Bundle* bundle) const {
+  this->format(o, bundle, 1);
+}
+
+void TextFormatter::format(std::ostream& o,
+                           Bundle* bundle,
+                           unsigned jobs) const {
+  TextBuffer buffer(&o);
+  TextWriter writer(*this);
+  writer.format_header(buffer, bundle);
+
+  std::vector< GlobalVariable* > globals(bundle->global_begin(),
+                                         bundle->global_end());
+  std::vector< Function* > functions(bundle->function_begin(),
+                                     bundle->function_end());
+
+  if (this->order_globals()) {
+    // sort global variables and functions by name, before formatting
+    std::sort(globals.begin(),
+              globals.end(),
+              [](GlobalVariable* a, GlobalVariable* b) {
+                return a->name() < b->name();
+              });
+    std::sort(functions.begin(), functions.end(), [](Function* a, Function* b) {
+      return a->name() < b->name();
+    });
+  }
+
+  // global variables
+  for (GlobalVariable* gv : globals) {
+    buffer << "\n";
+    writer.format(buffer, gv);
+  }
+
+  // functions
+  if (jobs <= 1 || functions.size() <= 1) {
+    for (Function* fun : functions) {
+      buffer << "\n";
+      writer.format(buffer, fun);
+    }
+    return;
+  }
+
+  // Format the functions in parallel, into a text per function. The texts
+  // are written in order, by chunks, to bound the memory usage.
+  std::vector< TextWriter > writers;
+  writers.reserve(jobs);
+  for (unsigned i = 0; i < jobs; i++) {
+    writers.emplace_back(*this);
+  }
+  std::vector< std::string > texts;
+  const std::size_t chunk_size = jobs * ParallelChunkSize;
+
+  for (std::size_t begin = 0; begin < functions.size(); begin += chunk_size) {
+    std::size_t end = std::min(functions.size(), begin + chunk_size);
+    texts.resize(end - begin);
+    std::atomic< std::size_t > next(begin);
+
+    auto work = [&](TextWriter& worker) {
+      TextBuffer text;
+      for (std::size_t i = next++; i < end; i = next++) {
+        text << "\n";
+        worker.format(text, functions[i]);
+        text.move_to(texts[i - begin]);
+      }
+    };
+
+    std::vector< std::thread > threads;
+    threads.reserve(jobs - 1);
+    for (unsigned i = 1; i < jobs; i++) {
+      threads.emplace_back(work, std::ref(writers[i]));
+    }
+    work(writers[0]);
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    for (std::size_t i = 0; i < end - begin; i++) {
+      buffer << texts[i];
+    }
+  }
+}
+
+void TextFormatter::format(std::ostream& o, GlobalVariable* gv) const {
+  TextBuffer buffer(&o);
+  TextWriter(*this).format(buffer, gv);
+}
+
+void TextFormatter::format(std::ostream& o, Function* f) const {
+  TextBuffer buffer(&o);
+  TextWriter(*this).format(buffer, f);
+}
+
+void TextFormatter::format(std::ostream& o, Code* code) const {
+  TextBuffer buffer(&o);
+  TextWriter(*this).format(buffer, code);
+}
+
+void TextFormatter::format(std::ostream& o,
+                           Code* code,
+                           const Namer& namer) const {
+  TextBuffer buffer(&o);
+  TextWriter(*this).format(buffer, code, namer);
+}
+
+void TextFormatter::format(std::ostream& o, BasicBlock* bb) const {
+  TextBuffer buffer(&o);
+  TextWriter(*this).format(buffer, bb);
+}
+
+void TextFormatter::format(std::ostream& o,
+                           BasicBlock* bb,
+                           const Namer& namer) const {
+  TextBuffer buffer(&o);
+  TextWriter(*this).format(buffer, bb, namer);
+}
+
+void TextFormatter::format(std::ostream& o, Statement* stmt) const {
+  TextBuffer buffer(&o);
+  TextWriter(*this).format(buffer, stmt);
+}
+
+void TextFormatter::format(std::ostream& o,
+                           Statement* stmt,
+                           const Namer& namer) const {
+  TextBuffer buffer(&o);
+  TextWriter(*this).format(buffer, stmt, namer);
+}
+
+void TextFormatter::format(std::ostream& o, Type* type) const {
+  TextBuffer buffer(&o);
+  TextWriter(*this).format(buffer, type);
+}
+
+void TextFormatter::format(std::ostream& o,
+                           Value* value,
+                           const Namer& namer,
+                           bool show_type) const {
+  TextBuffer buffer(&o);
+  TextWriter(*this).format(buffer, value, namer, show_type);
+}
+
 } // end namespace ar
 } // end namespace ikos
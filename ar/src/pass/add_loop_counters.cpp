@@ -47,6 +47,9 @@
  *
  ******************************************************************************/
 
+#include <algorithm>
+#include <vector>
+
 #include <ikos/core/fixpoint/wto.hpp>
 
 #include <ikos/ar/pass/add_loop_counters.hpp>
@@ -77,11 +80,21 @@ private:
   // Code
   Code* _code;
 
+  // Add a counter in all loops
+  bool _all_loops;
+
   // List of basic blocks in the current cycle
   std::vector< BasicBlock* > _blocks;
 
+  // True if a loop counter has been added
+  bool _changed = false;
+
 public:
-  explicit LoopIterator(Code* code) : _code(code) {}
+  LoopIterator(Code* code, bool all_loops)
+      : _code(code), _all_loops(all_loops) {}
+
+  /// \brief Return true if a loop counter has been added
+  bool changed() const { return this->_changed; }
 
   void visit(const WtoVertexT& vertex) override {
     this->_blocks.push_back(vertex.node());
@@ -98,7 +111,9 @@ public:
       it->accept(*this);
     }
 
-    this->add_loop_counter(cycle, this->_blocks);
+    if (this->_all_loops || this->benefits_from_counter(this->_blocks)) {
+      this->add_loop_counter(cycle, this->_blocks);
+    }
 
     // Update _blocks
     this->_blocks.insert(this->_blocks.end(),
@@ -106,11 +121,55 @@ public:
                          current_blocks.end());
   }
 
+  /// \brief Return true if the given cycle has an affine update and a pointer
+  /// shift with a non-constant term
+  ///
+  /// This is a syntactic approximation of the loops where a counter relates
+  /// the induction variables to the offsets of the accessed pointers.
+  static bool benefits_from_counter(const std::vector< BasicBlock* >& blocks) {
+    bool affine_update = false;
+    bool variable_shift = false;
+
+    for (BasicBlock* bb : blocks) {
+      for (Statement* stmt : *bb) {
+        if (auto bin = dyn_cast< BinaryOperation >(stmt)) {
+          affine_update = affine_update || is_affine_update(bin);
+        } else if (auto shift = dyn_cast< PointerShift >(stmt)) {
+          for (auto it = shift->term_begin(), et = shift->term_end(); it != et;
+               ++it) {
+            variable_shift = variable_shift || !isa< Constant >((*it).second);
+          }
+        }
+        if (affine_update && variable_shift) {
+          return true;
+        }
+      }
+    }
+
+    return false;
+  }
+
+  /// \brief Return true if the given statement is `x = y + c` or `x = y - c`,
+  /// for a constant `c`
+  static bool is_affine_update(BinaryOperation* stmt) {
+    switch (stmt->op()) {
+      case BinaryOperation::UAdd:
+      case BinaryOperation::SAdd:
+      case BinaryOperation::USub:
+      case BinaryOperation::SSub:
+        return isa< IntegerConstant >(stmt->left()) !=
+               isa< IntegerConstant >(stmt->right());
+      default:
+        return false;
+    }
+  }
+
   /// \brief Add a loop counter in the given cycle
   void add_loop_counter(const WtoCycleT& cycle,
                         const std::vector< BasicBlock* >& blocks) {
     Bundle* bundle = this->_code->bundle();
     Context& ctx = bundle->context();
+    this->_changed = true;
 
     // Get the intrinsics for loop counters
     Function* counter_init =
@@ -167,6 +226,38 @@ public:
         pred->push_back(Call::create(var, counter_incr, {var, one}));
       }
     }
+
+    // Forget the counter in the exit blocks only reachable from the cycle
+    Function* counter_forget =
+        bundle->intrinsic_function(Intrinsic::IkosCounterForget);
+
+    std::vector< BasicBlock* > exits;
+    for (BasicBlock* bb : blocks) {
+      for (auto it = bb->successor_begin(), et = bb->successor_end(); it != et;
+           ++it) {
+        BasicBlock* succ = *it;
+
+        if (std::find(blocks.begin(), blocks.end(), succ) == blocks.end() &&
+            std::find(exits.begin(), exits.end(), succ) == exits.end()) {
+          exits.push_back(succ);
+        }
+      }
+    }
+
+    for (BasicBlock* exit : exits) {
+      bool only_from_cycle =
+          std::all_of(exit->predecessor_begin(),
+                      exit->predecessor_end(),
+                      [&blocks](BasicBlock* pred) {
+                        return std::find(blocks.begin(), blocks.end(), pred) !=
+                               blocks.end();
+                      });
+
+      if (only_from_cycle &&
+          (exit->empty() || !isa< LandingPad >(exit->front()))) {
+        exit->push_front(Call::create(nullptr, counter_forget, {var}));
+      }
+    }
   }
 
 }; // end class LoopIterator
@@ -178,10 +269,10 @@ bool AddLoopCountersPass::run_on_code(Code* code) {
   core::Wto< Code* > wto(code);
 
   // Add a loop counter in each cycle
-  LoopIterator it(code);
+  LoopIterator it(code, this->_all_loops);
   wto.accept(it);
 
-  return true;
+  return it.changed();
 }
 
 } // end namespace ar
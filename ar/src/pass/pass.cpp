@@ -55,7 +55,11 @@ bool CodePass::run(Bundle* bundle) {
        ++it) {
     GlobalVariable* gv = *it;
     if (gv->is_definition()) {
-      change = this->run_on_code(gv->initializer()) || change;
+      if (this->run_on_code(gv->initializer())) {
+        gv->initializer()->invalidate_hash();
+        gv->initializer()->mark_dirty();
+        change = true;
+      }
     }
   }
 
@@ -64,7 +68,11 @@ bool CodePass::run(Bundle* bundle) {
        ++it) {
     Function* fun = *it;
     if (fun->is_definition()) {
-      change = this->run_on_code(fun->body()) || change;
+      if (this->run_on_code(fun->body())) {
+        fun->body()->invalidate_hash();
+        fun->body()->mark_dirty();
+        change = true;
+      }
     }
   }
 
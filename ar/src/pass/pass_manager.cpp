@@ -0,0 +1,187 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of PassManager
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <atomic>
+
+#include <ikos/ar/pass/pass_manager.hpp>
+#include <ikos/ar/semantic/function.hpp>
+#include <ikos/ar/semantic/value.hpp>
+#include <ikos/ar/support/parallel.hpp>
+
+namespace ikos {
+namespace ar {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// \brief Return the number of statements in the given code
+std::int64_t num_statements(Code* code) {
+  std::int64_t n = 0;
+  for (BasicBlock* bb : *code) {
+    n += static_cast< std::int64_t >(bb->num_statements());
+  }
+  return n;
+}
+
+/// \brief Return the codes of the given bundle
+std::vector< Code* > codes(Bundle* bundle) {
+  std::vector< Code* > result;
+
+  for (auto it = bundle->global_begin(), et = bundle->global_end(); it != et;
+       ++it) {
+    GlobalVariable* gv = *it;
+    if (gv->is_definition()) {
+      result.push_back(gv->initializer());
+    }
+  }
+
+  for (auto it = bundle->function_begin(), et = bundle->function_end();
+       it != et;
+       ++it) {
+    Function* fun = *it;
+    if (fun->is_definition()) {
+      result.push_back(fun->body());
+    }
+  }
+
+  return result;
+}
+
+/// \brief Return the number of statements in the given bundle
+std::int64_t num_statements(Bundle* bundle) {
+  std::int64_t n = 0;
+  for (Code* code : codes(bundle)) {
+    n += num_statements(code);
+  }
+  return n;
+}
+
+} // end anonymous namespace
+
+void PassManager::add(std::unique_ptr< Pass > pass) {
+  this->_passes.push_back(std::move(pass));
+  this->_statistics.emplace_back();
+}
+
+bool PassManager::run(Bundle* bundle) {
+  bool change = false;
+  std::size_t i = 0;
+
+  while (i < this->_passes.size()) {
+    if (dynamic_cast< CodePass* >(this->_passes[i].get()) != nullptr) {
+      // Pipeline the consecutive code passes
+      std::size_t end = i + 1;
+      while (end < this->_passes.size() &&
+             dynamic_cast< CodePass* >(this->_passes[end].get()) != nullptr) {
+        end++;
+      }
+      change = this->run_code_passes(bundle, i, end) || change;
+      i = end;
+    } else {
+      Statistics& stats = this->_statistics[i];
+      std::int64_t before = num_statements(bundle);
+      Clock::time_point start = Clock::now();
+      change = this->_passes[i]->run(bundle) || change;
+      stats.time += Clock::now() - start;
+      stats.statements += num_statements(bundle) - before;
+      i++;
+    }
+  }
+
+  return change;
+}
+
+bool PassManager::run_code_passes(Bundle* bundle,
+                                  std::size_t begin,
+                                  std::size_t end) {
+  std::vector< Code* > work = codes(bundle);
+  std::atomic< bool > change(false);
+
+  // Time in nanoseconds and statement delta, for each pass
+  std::vector< std::atomic< std::int64_t > > times(end - begin);
+  std::vector< std::atomic< std::int64_t > > statements(end - begin);
+  for (std::size_t i = 0; i < end - begin; i++) {
+    times[i] = 0;
+    statements[i] = 0;
+  }
+
+  parallel_for(work.size(), this->_jobs, [&](std::size_t n) {
+    Code* code = work[n];
+    bool code_change = false;
+    std::int64_t count = num_statements(code);
+
+    for (std::size_t i = begin; i < end; i++) {
+      auto pass = static_cast< CodePass* >(this->_passes[i].get());
+      Clock::time_point start = Clock::now();
+      bool pass_change = pass->run_on_code(code);
+      auto elapsed = std::chrono::duration_cast< std::chrono::nanoseconds >(
+          Clock::now() - start);
+      times[i - begin] += elapsed.count();
+
+      if (pass_change) {
+        code_change = true;
+        std::int64_t new_count = num_statements(code);
+        statements[i - begin] += new_count - count;
+        count = new_count;
+      }
+    }
+
+    if (code_change) {
+      code->invalidate_hash();
+      code->mark_dirty();
+      change = true;
+    }
+  });
+
+  for (std::size_t i = begin; i < end; i++) {
+    Statistics& stats = this->_statistics[i];
+    stats.time += std::chrono::nanoseconds(times[i - begin].load());
+    stats.statements += statements[i - begin].load();
+  }
+
+  return change;
+}
+
+} // end namespace ar
+} // end namespace ikos
@@ -0,0 +1,458 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of PropagateConstantsPass
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <ikos/ar/pass/propagate_constants.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+
+namespace ikos {
+namespace ar {
+
+namespace {
+
+/// \brief Return the truth value of an integer comparison on constants, or
+/// boost::none if the comparison is not on integer constants
+boost::optional< bool > evaluate(Comparison* cmp) {
+  if (!cmp->is_integer_predicate() || !cmp->left()->is_integer_constant() ||
+      !cmp->right()->is_integer_constant()) {
+    return boost::none;
+  }
+
+  const MachineInt& l = cast< IntegerConstant >(cmp->left())->value();
+  const MachineInt& r = cast< IntegerConstant >(cmp->right())->value();
+
+  switch (cmp->predicate()) {
+    case Comparison::UIEQ:
+    case Comparison::SIEQ:
+      return l == r;
+    case Comparison::UINE:
+    case Comparison::SINE:
+      return l != r;
+    case Comparison::UIGT:
+    case Comparison::SIGT:
+      return l > r;
+    case Comparison::UIGE:
+    case Comparison::SIGE:
+      return l >= r;
+    case Comparison::UILT:
+    case Comparison::SILT:
+      return l < r;
+    case Comparison::UILE:
+    case Comparison::SILE:
+      return l <= r;
+    default:
+      return boost::none;
+  }
+}
+
+/// \brief Return true if the basic block contains a comparison that is always
+/// false
+bool is_infeasible(BasicBlock* bb) {
+  for (Statement* stmt : *bb) {
+    if (auto cmp = dyn_cast< Comparison >(stmt)) {
+      boost::optional< bool > value = evaluate(cmp);
+      if (value && !*value) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/// \brief Return true if `n` is a valid shift count for `bit_width`
+bool is_valid_shift_count(const MachineInt& n, unsigned bit_width) {
+  ZNumber count = n.to_z_number();
+  return count >= 0 && count < bit_width;
+}
+
+/// \brief Fold a unary operation on an integer constant
+boost::optional< MachineInt > fold(UnaryOperation* s) {
+  auto cst = dyn_cast< IntegerConstant >(s->operand());
+  if (cst == nullptr || !s->result()->type()->is_integer()) {
+    return boost::none;
+  }
+
+  const MachineInt& n = cst->value();
+  auto type = cast< IntegerType >(s->result()->type());
+
+  switch (s->op()) {
+    case UnaryOperation::UTrunc:
+    case UnaryOperation::STrunc: {
+      if (n.sign() != type->sign() || n.bit_width() <= type->bit_width()) {
+        return boost::none;
+      }
+      return n.trunc(type->bit_width());
+    }
+    case UnaryOperation::ZExt:
+    case UnaryOperation::SExt: {
+      if (n.sign() != type->sign() || n.bit_width() >= type->bit_width()) {
+        return boost::none;
+      }
+      return n.ext(type->bit_width());
+    }
+    case UnaryOperation::Bitcast: {
+      if (n.bit_width() != type->bit_width()) {
+        return boost::none;
+      }
+      return n.sign() == type->sign() ? n : n.sign_cast(type->sign());
+    }
+    default:
+      return boost::none;
+  }
+}
+
+/// \brief Fold a binary operation on integer constants
+///
+/// Operations that could raise an error are not folded.
+boost::optional< MachineInt > fold(BinaryOperation* s) {
+  auto left = dyn_cast< IntegerConstant >(s->left());
+  auto right = dyn_cast< IntegerConstant >(s->right());
+  if (left == nullptr || right == nullptr) {
+    return boost::none;
+  }
+
+  const MachineInt& l = left->value();
+  const MachineInt& r = right->value();
+  bool overflow = false;
+  bool exact = false;
+  boost::optional< MachineInt > result;
+
+  switch (s->op()) {
+    case BinaryOperation::UAdd:
+    case BinaryOperation::SAdd: {
+      result = add(l, r, overflow);
+    } break;
+    case BinaryOperation::USub:
+    case BinaryOperation::SSub: {
+      result = sub(l, r, overflow);
+    } break;
+    case BinaryOperation::UMul:
+    case BinaryOperation::SMul: {
+      result = mul(l, r, overflow);
+    } break;
+    case BinaryOperation::UDiv:
+    case BinaryOperation::SDiv: {
+      if (r.is_zero()) {
+        return boost::none;
+      }
+      result = div(l, r, overflow, exact);
+    } break;
+    case BinaryOperation::URem:
+    case BinaryOperation::SRem: {
+      if (r.is_zero() || (l.is_signed() && l.is_min() && r.all_ones())) {
+        return boost::none;
+      }
+      result = rem(l, r);
+    } break;
+    case BinaryOperation::UShl:
+    case BinaryOperation::SShl: {
+      if (!is_valid_shift_count(r, l.bit_width())) {
+        return boost::none;
+      }
+      result = shl(l, r, overflow);
+    } break;
+    case BinaryOperation::ULShr:
+    case BinaryOperation::SLShr: {
+      if (!is_valid_shift_count(r, l.bit_width())) {
+        return boost::none;
+      }
+      result = lshr(l, r, exact);
+    } break;
+    case BinaryOperation::UAShr:
+    case BinaryOperation::SAShr: {
+      if (!is_valid_shift_count(r, l.bit_width())) {
+        return boost::none;
+      }
+      result = ashr(l, r, exact);
+    } break;
+    case BinaryOperation::UAnd:
+    case BinaryOperation::SAnd: {
+      result = and_(l, r);
+    } break;
+    case BinaryOperation::UOr:
+    case BinaryOperation::SOr: {
+      result = or_(l, r);
+    } break;
+    case BinaryOperation::UXor:
+    case BinaryOperation::SXor: {
+      result = xor_(l, r);
+    } break;
+    default: {
+      return boost::none;
+    }
+  }
+
+  if (overflow) {
+    return boost::none;
+  }
+  return result;
+}
+
+/// \brief Return the constant value of the given statement, or nullptr
+Value* constant_value(Context& ctx, Statement* stmt) {
+  if (auto assign = dyn_cast< Assignment >(stmt)) {
+    Value* operand = assign->operand();
+    if (operand->is_integer_constant() || operand->is_float_constant() ||
+        operand->is_null_constant()) {
+      return operand;
+    }
+    return nullptr;
+  }
+
+  boost::optional< MachineInt > value;
+  if (auto unary = dyn_cast< UnaryOperation >(stmt)) {
+    value = fold(unary);
+  } else if (auto binary = dyn_cast< BinaryOperation >(stmt)) {
+    value = fold(binary);
+  }
+
+  if (!value) {
+    return nullptr;
+  }
+  auto type = cast< IntegerType >(stmt->result()->type());
+  return IntegerConstant::get(ctx, type, *value);
+}
+
+/// \brief Return true if the statement could read memory
+bool may_read_memory(Statement* stmt) {
+  switch (stmt->kind()) {
+    case Statement::AssignmentKind:
+    case Statement::UnaryOperationKind:
+    case Statement::BinaryOperationKind:
+    case Statement::ComparisonKind:
+    case Statement::AllocateKind:
+    case Statement::PointerShiftKind:
+    case Statement::StoreKind:
+    case Statement::ExtractElementKind:
+    case Statement::InsertElementKind:
+    case Statement::ShuffleVectorKind:
+      return false;
+    default:
+      return true;
+  }
+}
+
+} // end anonymous namespace
+
+const char* PropagateConstantsPass::name() const {
+  return "propagate-constants";
+}
+
+const char* PropagateConstantsPass::description() const {
+  return "Propagate constants and remove dead stores";
+}
+
+bool PropagateConstantsPass::run_on_code(Code* code) {
+  bool change = false;
+
+  while (this->propagate_constants(code)) {
+    change = true;
+  }
+
+  change = this->remove_dead_stores(code) || change;
+  return change;
+}
+
+bool PropagateConstantsPass::propagate_constants(Code* code) {
+  bool change = false;
+
+  // Compute the basic blocks reachable through feasible basic blocks
+  std::unordered_set< BasicBlock* > reachable;
+  std::vector< BasicBlock* > worklist = {code->entry_block()};
+  reachable.insert(code->entry_block());
+
+  while (!worklist.empty()) {
+    BasicBlock* bb = worklist.back();
+    worklist.pop_back();
+
+    if (is_infeasible(bb)) {
+      continue;
+    }
+
+    for (auto it = bb->successor_begin(), et = bb->successor_end(); it != et;
+         ++it) {
+      if (reachable.insert(*it).second) {
+        worklist.push_back(*it);
+      }
+    }
+  }
+
+  // Remove the comparisons that are always true, and count the reachable
+  // definitions of internal variables
+  //
+  // The statements after a comparison that is always false are unreachable.
+  std::unordered_map< Variable*, unsigned > num_defs;
+
+  for (BasicBlock* bb : reachable) {
+    for (auto it = bb->begin(); it != bb->end();) {
+      Statement* stmt = *it;
+
+      if (auto cmp = dyn_cast< Comparison >(stmt)) {
+        boost::optional< bool > value = evaluate(cmp);
+        if (value && *value) {
+          it = bb->remove(it);
+          change = true;
+          continue;
+        } else if (value && !*value) {
+          // The following statements are never executed
+          break;
+        }
+      }
+
+      if (stmt->has_result() && stmt->result()->is_internal_variable()) {
+        num_defs[stmt->result()]++;
+      }
+      ++it;
+    }
+  }
+
+  // Find the internal variables with a single constant definition
+  std::unordered_map< Variable*, Value* > constants;
+  std::unordered_set< Statement* > dead;
+
+  for (BasicBlock* bb : reachable) {
+    for (Statement* stmt : *bb) {
+      if (auto cmp = dyn_cast< Comparison >(stmt)) {
+        boost::optional< bool > value = evaluate(cmp);
+        if (value && !*value) {
+          break;
+        }
+      }
+      if (!stmt->has_result() || num_defs[stmt->result()] != 1) {
+        continue;
+      }
+
+      Value* value = constant_value(code->context(), stmt);
+      if (value != nullptr) {
+        constants.emplace(stmt->result(), value);
+        dead.insert(stmt);
+      }
+    }
+  }
+
+  if (constants.empty()) {
+    return change;
+  }
+
+  // Replace the internal variables by their constant, and remove the
+  // definitions
+  for (BasicBlock* bb : *code) {
+    for (auto it = bb->begin(); it != bb->end();) {
+      Statement* stmt = *it;
+
+      if (dead.count(stmt) != 0) {
+        it = bb->remove(it);
+        continue;
+      }
+
+      for (std::size_t i = 0; i < stmt->num_operands(); i++) {
+        auto var = dyn_cast< InternalVariable >(stmt->operand(i));
+        if (var == nullptr) {
+          continue;
+        }
+
+        auto cst = constants.find(var);
+        if (cst != constants.end()) {
+          stmt->set_operand(i, cst->second);
+        }
+      }
+      ++it;
+    }
+  }
+
+  return true;
+}
+
+bool PropagateConstantsPass::remove_dead_stores(Code* code) {
+  bool change = false;
+
+  for (BasicBlock* bb : *code) {
+    // Last store on each pointer, not followed by a memory read
+    std::unordered_map< Value*, Store* > last_store;
+    std::unordered_set< Statement* > dead;
+
+    for (Statement* stmt : *bb) {
+      if (auto store = dyn_cast< Store >(stmt)) {
+        if (store->is_volatile()) {
+          last_store.erase(store->pointer());
+          continue;
+        }
+
+        auto it = last_store.find(store->pointer());
+        if (it != last_store.end() &&
+            it->second->value()->type() == store->value()->type()) {
+          dead.insert(it->second);
+        }
+        last_store[store->pointer()] = store;
+      } else if (may_read_memory(stmt)) {
+        last_store.clear();
+      } else if (stmt->has_result()) {
+        // The pointer variable is redefined
+        last_store.erase(stmt->result());
+      }
+    }
+
+    if (dead.empty()) {
+      continue;
+    }
+
+    for (auto it = bb->begin(); it != bb->end();) {
+      if (dead.count(*it) != 0) {
+        it = bb->remove(it);
+      } else {
+        ++it;
+      }
+    }
+    change = true;
+  }
+
+  return change;
+}
+
+} // end namespace ar
+} // end namespace ikos
@@ -0,0 +1,168 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of RemoveUnreachableFunctionsPass
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <unordered_set>
+
+#include <ikos/ar/pass/remove_unreachable_functions.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+
+namespace ikos {
+namespace ar {
+
+namespace {
+
+/// \brief Helper to compute the reachable functions and global variables
+class Reachability {
+public:
+  // Reachable functions
+  std::unordered_set< Function* > functions;
+
+  // Reachable global variables
+  std::unordered_set< GlobalVariable* > globals;
+
+private:
+  // Codes to visit
+  std::vector< Code* > _worklist;
+
+public:
+  /// \brief Mark the given function as reachable
+  void add(Function* fun) {
+    if (this->functions.insert(fun).second && fun->is_definition()) {
+      this->_worklist.push_back(fun->body());
+    }
+  }
+
+  /// \brief Mark the given global variable as reachable
+  void add(GlobalVariable* gv) {
+    if (this->globals.insert(gv).second && gv->is_definition()) {
+      this->_worklist.push_back(gv->initializer());
+    }
+  }
+
+  /// \brief Mark the functions and global variables used by a value
+  void visit(Value* value) {
+    if (auto cst = dyn_cast< FunctionPointerConstant >(value)) {
+      this->add(cst->function());
+    } else if (auto gv = dyn_cast< GlobalVariable >(value)) {
+      this->add(gv);
+    } else if (auto cst = dyn_cast< StructConstant >(value)) {
+      for (auto it = cst->field_begin(), et = cst->field_end(); it != et;
+           ++it) {
+        this->visit(it->value);
+      }
+    } else if (auto cst = dyn_cast< SequentialConstant >(value)) {
+      for (auto it = cst->element_begin(), et = cst->element_end(); it != et;
+           ++it) {
+        this->visit(*it);
+      }
+    }
+  }
+
+  /// \brief Visit the reachable codes
+  void run() {
+    while (!this->_worklist.empty()) {
+      Code* code = this->_worklist.back();
+      this->_worklist.pop_back();
+
+      for (BasicBlock* bb : *code) {
+        for (Statement* stmt : *bb) {
+          for (auto it = stmt->op_begin(), et = stmt->op_end(); it != et;
+               ++it) {
+            this->visit(*it);
+          }
+        }
+      }
+    }
+  }
+
+}; // end class Reachability
+
+} // end anonymous namespace
+
+bool RemoveUnreachableFunctionsPass::run(Bundle* bundle) {
+  Reachability reachability;
+
+  for (Function* fun : this->_entry_points) {
+    reachability.add(fun);
+  }
+  for (const char* name : {"ar.global_ctors", "ar.global_dtors"}) {
+    if (GlobalVariable* gv = bundle->global_or_null(name)) {
+      reachability.add(gv);
+    }
+  }
+  reachability.run();
+
+  bool change = false;
+
+  for (auto it = bundle->function_begin(), et = bundle->function_end();
+       it != et;
+       ++it) {
+    Function* fun = *it;
+    if (fun->is_definition() && reachability.functions.count(fun) == 0) {
+      fun->erase_body();
+      change = true;
+    }
+  }
+
+  for (auto it = bundle->global_begin(), et = bundle->global_end(); it != et;
+       ++it) {
+    GlobalVariable* gv = *it;
+    if (gv->is_definition() && reachability.globals.count(gv) == 0) {
+      gv->erase_initializer();
+      change = true;
+    }
+  }
+
+  return change;
+}
+
+const char* RemoveUnreachableFunctionsPass::name() const {
+  return "remove-unreachable-functions";
+}
+
+const char* RemoveUnreachableFunctionsPass::description() const {
+  return "Remove the functions unreachable from the entry points";
+}
+
+} // end namespace ar
+} // end namespace ikos
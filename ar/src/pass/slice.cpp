@@ -0,0 +1,157 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of SlicePass
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2017-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <ikos/ar/pass/slice.hpp>
+#include <ikos/ar/semantic/code.hpp>
+
+namespace ikos {
+namespace ar {
+
+const char* SlicePass::name() const {
+  return "slice";
+}
+
+const char* SlicePass::description() const {
+  return "Slice the code with respect to the statements of interest";
+}
+
+bool SlicePass::is_removable(Statement* stmt) const {
+  if (!stmt->has_result() || !stmt->result()->is_internal_variable()) {
+    return false;
+  }
+
+  switch (stmt->kind()) {
+    case Statement::AssignmentKind:
+    case Statement::UnaryOperationKind:
+    case Statement::BinaryOperationKind:
+    case Statement::PointerShiftKind:
+    case Statement::ExtractElementKind:
+    case Statement::InsertElementKind:
+    case Statement::ShuffleVectorKind:
+      return !this->_criterion(stmt);
+    case Statement::LoadKind:
+      return !cast< Load >(stmt)->is_volatile() && !this->_criterion(stmt);
+    default:
+      return false;
+  }
+}
+
+bool SlicePass::run_on_code(Code* code) {
+  // Removable statements, indexed by result variable
+  std::unordered_map< Variable*, std::vector< Statement* > > defs;
+
+  // Statements to keep, whose operands are not processed yet
+  std::vector< Statement* > worklist;
+
+  for (BasicBlock* bb : *code) {
+    for (Statement* stmt : *bb) {
+      if (this->is_removable(stmt)) {
+        defs[stmt->result()].push_back(stmt);
+      } else {
+        worklist.push_back(stmt);
+      }
+    }
+  }
+
+  if (defs.empty()) {
+    return false;
+  }
+
+  // Internal variables needed by a kept statement
+  std::unordered_set< Variable* > needed;
+
+  while (!worklist.empty()) {
+    Statement* stmt = worklist.back();
+    worklist.pop_back();
+
+    for (auto it = stmt->op_begin(), et = stmt->op_end(); it != et; ++it) {
+      if (!(*it)->is_internal_variable()) {
+        continue;
+      }
+
+      auto var = cast< Variable >(*it);
+      if (!needed.insert(var).second) {
+        continue;
+      }
+
+      auto def = defs.find(var);
+      if (def != defs.end()) {
+        worklist.insert(worklist.end(),
+                        def->second.begin(),
+                        def->second.end());
+      }
+    }
+  }
+
+  // Removable statements whose result is not needed
+  std::unordered_set< Statement* > dead;
+
+  for (const auto& def : defs) {
+    if (needed.count(def.first) == 0) {
+      dead.insert(def.second.begin(), def.second.end());
+    }
+  }
+
+  if (dead.empty()) {
+    return false;
+  }
+
+  for (BasicBlock* bb : *code) {
+    for (auto it = bb->begin(); it != bb->end();) {
+      if (dead.count(*it) != 0) {
+        it = bb->remove(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  return true;
+}
+
+} // end namespace ar
+} // end namespace ikos
@@ -74,6 +74,7 @@ Bundle* Bundle::create(Context& ctx,
 }
 
 Function* Bundle::intrinsic_function(Intrinsic::ID id) {
+  std::lock_guard< std::mutex > lock(this->_intrinsics_mutex);
   std::string name = Intrinsic::long_name(id);
 
   Function* fun = this->_functions.find(name);
@@ -105,6 +106,26 @@ std::string Bundle::find_available_name(StringRef prefix) const {
   return name;
 }
 
+HashValue Bundle::hash() const {
+  // Symbols are stored in hash tables: use a commutative combination, so that
+  // the result does not depend on the iteration order
+  HashValue h = 0;
+
+  for (auto it = this->global_begin(), et = this->global_end(); it != et;
+       ++it) {
+    GlobalVariable* gv = *it;
+    h += hash_combine(hash_string(gv->name()), gv->hash());
+  }
+
+  for (auto it = this->function_begin(), et = this->function_end(); it != et;
+       ++it) {
+    Function* fun = *it;
+    h += hash_combine(hash_string(fun->name()), fun->hash());
+  }
+
+  return hash_combine(hash_string(this->_target_triple), h);
+}
+
 void Bundle::add_global_variable(std::unique_ptr< GlobalVariable > gv) {
   this->_globals.add(std::move(gv));
 }
@@ -52,7 +52,7 @@ namespace ar {
 
 // BasicBlock
 
-BasicBlock::BasicBlock(Code* code) : _parent(code) {
+BasicBlock::BasicBlock(Code* code) : _parent(code), _index(0) {
   ikos_assert_msg(code, "code is null");
 }
 
@@ -95,9 +95,10 @@ void BasicBlock::insert_after(StatementIterator it,
   this->_statements.insert(it.base(), std::move(stmt));
 }
 
-void BasicBlock::remove(StatementIterator it) {
+BasicBlock::StatementIterator BasicBlock::remove(StatementIterator it) {
   (*it.base())->set_parent(nullptr);
-  this->_statements.erase(it.base());
+  return StatementIterator(this->_statements.erase(it.base()),
+                           SeqExposeRawPtr< Statement >());
 }
 
 std::unique_ptr< Statement > BasicBlock::pop_back() {
@@ -248,7 +249,9 @@ Code::Code(Function* function)
       _exit_block(nullptr),
       _function(function),
       _global_var(nullptr),
-      _bundle(function->bundle()) {
+      _bundle(function->bundle()),
+      _hash(0),
+      _dirty(true) {
   ikos_assert_msg(function, "function is null");
 }
 
@@ -257,12 +260,52 @@ Code::Code(GlobalVariable* gv)
       _exit_block(nullptr),
       _function(nullptr),
       _global_var(gv),
-      _bundle(gv->bundle()) {
+      _bundle(gv->bundle()),
+      _hash(0),
+      _dirty(true) {
   ikos_assert_msg(gv, "gv is null");
 }
 
 Code::~Code() = default;
 
+namespace {
+
+/// \brief Arena used by the current thread, see Code::ArenaScope
+thread_local Arena* CurrentArena = nullptr;
+
+} // end anonymous namespace
+
+Code::ArenaScope::ArenaScope(Code* code) : _prev(CurrentArena) {
+#ifdef IKOS_DISABLE_STATEMENT_ARENA
+  static_cast< void >(code);
+#else
+  if (code->_arena == nullptr) {
+    code->_arena = std::make_unique< Arena >();
+  }
+  CurrentArena = code->_arena.get();
+#endif
+}
+
+Code::ArenaScope::~ArenaScope() {
+  CurrentArena = this->_prev;
+}
+
+Arena* Code::current_arena() {
+  return CurrentArena;
+}
+
+HashValue Code::hash() const {
+  HashValue h = this->_hash.load();
+  if (h == 0) {
+    h = structural_hash(this);
+    if (h == 0) {
+      h = 1; // 0 means "not computed yet"
+    }
+    this->_hash.store(h);
+  }
+  return h;
+}
+
 void Code::set_entry_block(BasicBlock* bb) {
   this->_entry_block = bb;
 }
@@ -272,6 +315,7 @@ void Code::set_exit_block(BasicBlock* bb) {
 }
 
 void Code::add_basic_block(std::unique_ptr< BasicBlock > bb) {
+  bb->_index = this->_blocks.size();
   this->_blocks.emplace_back(std::move(bb));
 }
 
@@ -289,6 +333,11 @@ void Code::erase_basic_block(BasicBlock* bb) {
                                        return bb_ptr.get() == bb;
                                      }),
                       this->_blocks.end());
+
+  // Keep the indices dense
+  for (std::size_t i = 0; i < this->_blocks.size(); i++) {
+    this->_blocks[i]->_index = i;
+  }
 }
 
 void Code::add_internal_variable(std::unique_ptr< InternalVariable > iv) {
@@ -72,206 +72,132 @@ ContextImpl::ContextImpl()
 ContextImpl::~ContextImpl() = default;
 
 void ContextImpl::add_bundle(std::unique_ptr< Bundle > bundle) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   this->_bundles.emplace_back(std::move(bundle));
 }
 
 IntegerType* ContextImpl::integer_type(unsigned bit_width, Signedness sign) {
-  auto it = this->_integer_types.find(std::make_tuple(bit_width, sign));
-  if (it == this->_integer_types.end()) {
-    auto type = new IntegerType(bit_width, sign);
-    this->_integer_types.emplace(std::make_tuple(bit_width, sign),
-                                 std::unique_ptr< IntegerType >(type));
-    return type;
-  } else {
-    return it->second.get();
-  }
+  const auto key = std::make_tuple(bit_width, sign);
+  return this->_integer_types.get_or_create(key, [&] {
+    return new IntegerType(bit_width, sign);
+  });
 }
 
 PointerType* ContextImpl::pointer_type(Type* pointee) {
-  auto it = this->_pointer_types.find(pointee);
-  if (it == this->_pointer_types.end()) {
-    auto type = new PointerType(pointee);
-    this->_pointer_types.emplace(pointee, std::unique_ptr< PointerType >(type));
-    return type;
-  } else {
-    return it->second.get();
-  }
+  return this->_pointer_types.get_or_create(pointee, [&] {
+    return new PointerType(pointee);
+  });
 }
 
 ArrayType* ContextImpl::array_type(Type* element_type, ZNumber num_element) {
-  auto it = this->_array_types.find(std::make_tuple(element_type, num_element));
-  if (it == this->_array_types.end()) {
-    auto type = new ArrayType(element_type, num_element);
-    this->_array_types.emplace(std::make_tuple(element_type, num_element),
-                               std::unique_ptr< ArrayType >(type));
-    return type;
-  } else {
-    return it->second.get();
-  }
+  const auto key = std::make_tuple(element_type, num_element);
+  return this->_array_types.get_or_create(key, [&] {
+    return new ArrayType(element_type, num_element);
+  });
 }
 
 VectorType* ContextImpl::vector_type(ScalarType* element_type,
                                      ZNumber num_element) {
-  auto it =
-      this->_vector_types.find(std::make_tuple(element_type, num_element));
-  if (it == this->_vector_types.end()) {
-    auto type = new VectorType(element_type, num_element);
-    this->_vector_types.emplace(std::make_tuple(element_type, num_element),
-                                std::unique_ptr< VectorType >(type));
-    return type;
-  } else {
-    return it->second.get();
-  }
+  const auto key = std::make_tuple(element_type, num_element);
+  return this->_vector_types.get_or_create(key, [&] {
+    return new VectorType(element_type, num_element);
+  });
 }
 
 FunctionType* ContextImpl::function_type(
     Type* return_type,
     const FunctionType::ParamTypes& param_types,
     bool is_var_arg) {
-  auto it = this->_function_types.find(
-      std::make_tuple(return_type, param_types, is_var_arg));
-  if (it == this->_function_types.end()) {
-    auto type = new FunctionType(return_type, param_types, is_var_arg);
-    this->_function_types.emplace(std::make_tuple(return_type,
-                                                  param_types,
-                                                  is_var_arg),
-                                  std::unique_ptr< FunctionType >(type));
-    return type;
-  } else {
-    return it->second.get();
-  }
+  const auto key = std::make_tuple(return_type, param_types, is_var_arg);
+  return this->_function_types.get_or_create(key, [&] {
+    return new FunctionType(return_type, param_types, is_var_arg);
+  });
 }
 
 void ContextImpl::add_type(std::unique_ptr< Type > type) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   this->_types.emplace_back(std::move(type));
 }
 
 UndefinedConstant* ContextImpl::undefined_cst(Type* type) {
-  auto it = this->_undefined_constants.find(type);
-  if (it == this->_undefined_constants.end()) {
-    auto cst = new UndefinedConstant(type);
-    this->_undefined_constants.emplace(type,
-                                       std::unique_ptr< UndefinedConstant >(
-                                           cst));
-    return cst;
-  } else {
-    return it->second.get();
-  }
+  return this->_undefined_constants.get_or_create(type, [&] {
+    return new UndefinedConstant(type);
+  });
 }
 
 IntegerConstant* ContextImpl::integer_cst(IntegerType* type, MachineInt value) {
-  auto it = this->_integer_constants.find(std::make_tuple(type, value));
-  if (it == this->_integer_constants.end()) {
-    auto cst = new IntegerConstant(type, value);
-    this->_integer_constants.emplace(std::make_tuple(type, value),
-                                     std::unique_ptr< IntegerConstant >(cst));
-    return cst;
-  } else {
-    return it->second.get();
-  }
+  const auto key = std::make_tuple(type, value);
+  return this->_integer_constants.get_or_create(key, [&] {
+    return new IntegerConstant(type, value);
+  });
 }
 
 FloatConstant* ContextImpl::float_cst(FloatType* type,
                                       const std::string& value) {
-  auto it = this->_float_constants.find(std::make_tuple(type, value));
-  if (it == this->_float_constants.end()) {
-    auto cst = new FloatConstant(type, value);
-    this->_float_constants.emplace(std::make_tuple(type, value),
-                                   std::unique_ptr< FloatConstant >(cst));
-    return cst;
-  } else {
-    return it->second.get();
-  }
+  const auto key = std::make_tuple(type, value);
+  return this->_float_constants.get_or_create(key, [&] {
+    return new FloatConstant(type, value);
+  });
 }
 
 NullConstant* ContextImpl::null_cst(PointerType* type) {
-  auto it = this->_null_constants.find(type);
-  if (it == this->_null_constants.end()) {
-    auto cst = new NullConstant(type);
-    this->_null_constants.emplace(type, std::unique_ptr< NullConstant >(cst));
-    return cst;
-  } else {
-    return it->second.get();
-  }
+  return this->_null_constants.get_or_create(type, [&] {
+    return new NullConstant(type);
+  });
 }
 
 StructConstant* ContextImpl::struct_cst(StructType* type,
                                         const StructConstant::Values& values) {
-  auto it = this->_struct_constants.find(std::make_tuple(type, values));
-  if (it == this->_struct_constants.end()) {
-    auto cst = new StructConstant(type, values);
-    this->_struct_constants.emplace(std::make_tuple(type, values),
-                                    std::unique_ptr< StructConstant >(cst));
-    return cst;
-  } else {
-    return it->second.get();
-  }
+  const auto key = std::make_tuple(type, values);
+  return this->_struct_constants.get_or_create(key, [&] {
+    return new StructConstant(type, values);
+  });
 }
 
 ArrayConstant* ContextImpl::array_cst(ArrayType* type,
                                       const ArrayConstant::Values& values) {
-  auto it = this->_array_constants.find(std::make_tuple(type, values));
-  if (it == this->_array_constants.end()) {
-    auto cst = new ArrayConstant(type, values);
-    this->_array_constants.emplace(std::make_tuple(type, values),
-                                   std::unique_ptr< ArrayConstant >(cst));
-    return cst;
-  } else {
-    return it->second.get();
-  }
+  const auto key = std::make_tuple(type, values);
+  return this->_array_constants.get_or_create(key, [&] {
+    return new ArrayConstant(type, values);
+  });
 }
 
 VectorConstant* ContextImpl::vector_cst(VectorType* type,
                                         const VectorConstant::Values& values) {
-  auto it = this->_vector_constants.find(std::make_tuple(type, values));
-  if (it == this->_vector_constants.end()) {
-    auto cst = new VectorConstant(type, values);
-    this->_vector_constants.emplace(std::make_tuple(type, values),
-                                    std::unique_ptr< VectorConstant >(cst));
-    return cst;
-  } else {
-    return it->second.get();
-  }
+  const auto key = std::make_tuple(type, values);
+  return this->_vector_constants.get_or_create(key, [&] {
+    return new VectorConstant(type, values);
+  });
+}
+
+DataArrayConstant* ContextImpl::data_array_cst(ArrayType* type,
+                                              const std::string& data) {
+  const auto key = std::make_tuple(type, data);
+  return this->_data_array_constants.get_or_create(key, [&] {
+    return new DataArrayConstant(type, data);
+  });
 }
 
 AggregateZeroConstant* ContextImpl::aggregate_zero_cst(AggregateType* type) {
-  auto it = this->_aggregate_zero_constants.find(type);
-  if (it == this->_aggregate_zero_constants.end()) {
-    auto cst = new AggregateZeroConstant(type);
-    this->_aggregate_zero_constants
-        .emplace(type, std::unique_ptr< AggregateZeroConstant >(cst));
-    return cst;
-  } else {
-    return it->second.get();
-  }
+  return this->_aggregate_zero_constants.get_or_create(type, [&] {
+    return new AggregateZeroConstant(type);
+  });
 }
 
 FunctionPointerConstant* ContextImpl::function_pointer_cst(Function* function) {
-  auto it = this->_function_pointer_constants.find(function);
-  if (it == this->_function_pointer_constants.end()) {
-    ikos_assert_msg(function, "function is null");
-    PointerType* fun_ptr_type = this->pointer_type(function->type());
-    auto cst = new FunctionPointerConstant(fun_ptr_type, function);
-    this->_function_pointer_constants
-        .emplace(function, std::unique_ptr< FunctionPointerConstant >(cst));
-    return cst;
-  } else {
-    return it->second.get();
-  }
+  ikos_assert_msg(function, "function is null");
+  PointerType* fun_ptr_type = this->pointer_type(function->type());
+  return this->_function_pointer_constants.get_or_create(function, [&] {
+    return new FunctionPointerConstant(fun_ptr_type, function);
+  });
 }
 
 InlineAssemblyConstant* ContextImpl::inline_assembly_cst(
     PointerType* type, const std::string& code) {
-  auto it = this->_inline_assembly_constants.find(std::make_tuple(type, code));
-  if (it == this->_inline_assembly_constants.end()) {
-    auto cst = new InlineAssemblyConstant(type, code);
-    this->_inline_assembly_constants
-        .emplace(std::make_tuple(type, code),
-                 std::unique_ptr< InlineAssemblyConstant >(cst));
-    return cst;
-  } else {
-    return it->second.get();
-  }
+  const auto key = std::make_tuple(type, code);
+  return this->_inline_assembly_constants.get_or_create(key, [&] {
+    return new InlineAssemblyConstant(type, code);
+  });
 }
 
 } // end namespace ar
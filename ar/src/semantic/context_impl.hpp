@@ -43,20 +43,122 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <boost/container/flat_map.hpp>
 
 #include <ikos/ar/semantic/bundle.hpp>
+#include <ikos/ar/semantic/hash.hpp>
 #include <ikos/ar/semantic/type.hpp>
 #include <ikos/ar/semantic/value.hpp>
 
 namespace ikos {
 namespace ar {
 
+/// \name Hash functions for the keys of interned types and constants
+/// @{
+
+inline std::size_t intern_hash(const void* p) {
+  return std::hash< const void* >()(p);
+}
+
+template < typename T,
+           class = std::enable_if_t< std::is_integral< T >::value ||
+                                     std::is_enum< T >::value > >
+inline std::size_t intern_hash(T n) {
+  return std::hash< std::size_t >()(static_cast< std::size_t >(n));
+}
+
+inline std::size_t intern_hash(const ZNumber& n) {
+  return hash_value(n);
+}
+
+inline std::size_t intern_hash(const MachineInt& n) {
+  return hash_value(n);
+}
+
+inline std::size_t intern_hash(const std::string& s) {
+  return std::hash< std::string >()(s);
+}
+
+inline std::size_t intern_hash(const StructConstant::Field& field) {
+  return static_cast< std::size_t >(
+      hash_combine(intern_hash(field.offset), intern_hash(field.value)));
+}
+
+template < typename T >
+inline std::size_t intern_hash(const std::vector< T >& v) {
+  HashValue seed = v.size();
+  for (const auto& e : v) {
+    seed = hash_combine(seed, intern_hash(e));
+  }
+  return static_cast< std::size_t >(seed);
+}
+
+template < typename Tuple, std::size_t... I >
+inline std::size_t intern_hash_tuple(const Tuple& t,
+                                     std::index_sequence< I... >) {
+  HashValue seed = 0;
+  // Expand the tuple elements in order
+  int expand[] = {0, (seed = hash_combine(seed, intern_hash(std::get< I >(t))),
+                      0)...};
+  static_cast< void >(expand);
+  return static_cast< std::size_t >(seed);
+}
+
+template < typename... Args >
+inline std::size_t intern_hash(const std::tuple< Args... >& t) {
+  return intern_hash_tuple(t, std::index_sequence_for< Args... >());
+}
+
+/// @}
+
+/// \brief Map interning types or constants, safe to use from several threads
+///
+/// The map is split into shards, selected by the hash of the key, each with its
+/// own mutex. Threads creating different types or constants rarely wait on
+/// each other. Objects are never removed, so returned pointers remain valid and
+/// can be compared for equality.
+template < typename Key, typename T >
+class InternMap {
+private:
+  static constexpr std::size_t NumShards = 16;
+
+  struct Shard {
+    std::mutex mutex;
+    boost::container::flat_map< Key, std::unique_ptr< T > > map;
+  };
+
+  std::array< Shard, NumShards > _shards;
+
+public:
+  /// \brief Return the object for the given key, or create it
+  ///
+  /// `create` is called with the shard locked, and must not use this map.
+  template < typename Create >
+  T* get_or_create(const Key& key, Create create) {
+    Shard& shard = this->_shards[intern_hash(key) % NumShards];
+    std::lock_guard< std::mutex > lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it != shard.map.end()) {
+      return it->second.get();
+    }
+    T* obj = create();
+    shard.map.emplace(key, std::unique_ptr< T >(obj));
+    return obj;
+  }
+
+}; // end class InternMap
+
 class ContextImpl {
 private:
   // List of owned bundles
@@ -96,81 +198,69 @@ private:
   // see https://github.com/boostorg/container/issues/97
 
   // Integer types
-  boost::container::flat_map< std::tuple< unsigned, Signedness >,
-                              std::unique_ptr< IntegerType > >
-      _integer_types;
+  InternMap< std::tuple< unsigned, Signedness >, IntegerType > _integer_types;
 
   // Pointer types
-  boost::container::flat_map< Type*, std::unique_ptr< PointerType > >
-      _pointer_types;
+  InternMap< Type*, PointerType > _pointer_types;
 
   // Array types
-  boost::container::flat_map< std::tuple< Type*, ZNumber >,
-                              std::unique_ptr< ArrayType > >
-      _array_types;
+  InternMap< std::tuple< Type*, ZNumber >, ArrayType > _array_types;
 
   // Vector types
-  boost::container::flat_map< std::tuple< ScalarType*, ZNumber >,
-                              std::unique_ptr< VectorType > >
-      _vector_types;
+  InternMap< std::tuple< ScalarType*, ZNumber >, VectorType > _vector_types;
 
   // Function types
-  boost::container::flat_map<
-      std::tuple< Type*, FunctionType::ParamTypes, bool >,
-      std::unique_ptr< FunctionType > >
+  InternMap< std::tuple< Type*, FunctionType::ParamTypes, bool >, FunctionType >
       _function_types;
 
   // Other types (struct and opaque)
   std::vector< std::unique_ptr< Type > > _types;
 
   // Undefined constants
-  boost::container::flat_map< Type*, std::unique_ptr< UndefinedConstant > >
-      _undefined_constants;
+  InternMap< Type*, UndefinedConstant > _undefined_constants;
 
   // Integer constants
-  boost::container::flat_map< std::tuple< IntegerType*, MachineInt >,
-                              std::unique_ptr< IntegerConstant > >
+  InternMap< std::tuple< IntegerType*, MachineInt >, IntegerConstant >
       _integer_constants;
 
   // Float constants
-  boost::container::flat_map< std::tuple< FloatType*, std::string >,
-                              std::unique_ptr< FloatConstant > >
+  InternMap< std::tuple< FloatType*, std::string >, FloatConstant >
       _float_constants;
 
   // Null constants
-  boost::container::flat_map< PointerType*, std::unique_ptr< NullConstant > >
-      _null_constants;
+  InternMap< PointerType*, NullConstant > _null_constants;
 
   // Structure constants
-  boost::container::flat_map< std::tuple< StructType*, StructConstant::Values >,
-                              std::unique_ptr< StructConstant > >
+  InternMap< std::tuple< StructType*, StructConstant::Values >, StructConstant >
       _struct_constants;
 
   // Array constants
-  boost::container::flat_map< std::tuple< ArrayType*, ArrayConstant::Values >,
-                              std::unique_ptr< ArrayConstant > >
+  InternMap< std::tuple< ArrayType*, ArrayConstant::Values >, ArrayConstant >
       _array_constants;
 
   // Vector constants
-  boost::container::flat_map< std::tuple< VectorType*, VectorConstant::Values >,
-                              std::unique_ptr< VectorConstant > >
+  InternMap< std::tuple< VectorType*, VectorConstant::Values >, VectorConstant >
       _vector_constants;
 
+  // Data array constants
+  InternMap< std::tuple< ArrayType*, std::string >, DataArrayConstant >
+      _data_array_constants;
+
   // Aggregate zero constants
-  boost::container::flat_map< AggregateType*,
-                              std::unique_ptr< AggregateZeroConstant > >
-      _aggregate_zero_constants;
+  InternMap< AggregateType*, AggregateZeroConstant > _aggregate_zero_constants;
 
   // Function pointer constants
-  boost::container::flat_map< Function*,
-                              std::unique_ptr< FunctionPointerConstant > >
-      _function_pointer_constants;
+  InternMap< Function*, FunctionPointerConstant > _function_pointer_constants;
 
   // Inline assembly constants
-  boost::container::flat_map< std::tuple< PointerType*, std::string >,
-                              std::unique_ptr< InlineAssemblyConstant > >
+  InternMap< std::tuple< PointerType*, std::string >, InlineAssemblyConstant >
       _inline_assembly_constants;
 
+  // Mutex protecting the list of bundles and other types
+  //
+  // Interned types and constants are protected by their InternMap.
+  std::mutex _mutex;
+
 public:
   /// \brief Default constructor
   ContextImpl();
@@ -265,6 +355,9 @@ public:
   VectorConstant* vector_cst(VectorType* type,
                              const VectorConstant::Values& values);
 
+  /// \brief Get or create a data array constant
+  DataArrayConstant* data_array_cst(ArrayType* type, const std::string& data);
+
   /// \brief Get or create an aggregate zero constant
   AggregateZeroConstant* aggregate_zero_cst(AggregateType* type);
 
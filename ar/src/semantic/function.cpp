@@ -89,6 +89,12 @@ Function::Function(Bundle* bundle,
 
 Function::~Function() = default;
 
+void Function::erase_body() {
+  this->_body.reset();
+  this->_parameters.clear();
+  this->_local_vars.clear();
+}
+
 Function* Function::create(Bundle* bundle,
                            FunctionType* type,
                            std::string name,
@@ -115,6 +121,14 @@ void Function::set_name(std::string new_name) {
   this->_parent->rename_function(this, prev_name, this->_name);
 }
 
+HashValue Function::hash() const {
+  HashValue h = structural_hash(this->_type);
+  if (this->is_definition()) {
+    h = hash_combine(h, this->_body->hash());
+  }
+  return h;
+}
+
 void Function::add_local_variable(std::unique_ptr< LocalVariable > lv) {
   this->_local_vars.emplace_back(std::move(lv));
 }
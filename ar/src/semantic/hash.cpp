@@ -0,0 +1,345 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the structural hashing
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <unordered_map>
+
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/function.hpp>
+#include <ikos/ar/semantic/hash.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+#include <ikos/ar/semantic/type.hpp>
+#include <ikos/ar/semantic/value.hpp>
+
+namespace ikos {
+namespace ar {
+
+HashValue hash_string(const std::string& s) {
+  // FNV-1a
+  HashValue h = 0xcbf29ce484222325ULL;
+  for (char c : s) {
+    h ^= static_cast< unsigned char >(c);
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+namespace {
+
+/// \brief Compute structural hashes
+///
+/// Hashes of types are memoized. Variables and basic blocks are numbered in
+/// their order of appearance.
+class StructuralHasher {
+private:
+  // Hashes of types
+  std::unordered_map< Type*, HashValue > _types;
+
+  // Numbering of local and internal variables
+  std::unordered_map< Variable*, HashValue > _variables;
+
+  // Numbering of basic blocks
+  std::unordered_map< BasicBlock*, HashValue > _blocks;
+
+public:
+  /// \brief Constructor
+  StructuralHasher() = default;
+
+  /// \brief Hash a type
+  HashValue hash(Type* type) {
+    auto it = this->_types.find(type);
+    if (it != this->_types.end()) {
+      return it->second;
+    }
+
+    HashValue h = static_cast< HashValue >(type->kind());
+
+    // Insert a temporary hash, to stop on recursive types
+    this->_types.emplace(type, h);
+
+    switch (type->kind()) {
+      case Type::VoidKind:
+      case Type::OpaqueKind: {
+      } break;
+      case Type::IntegerKind: {
+        auto int_type = cast< IntegerType >(type);
+        h = hash_combine(h, int_type->bit_width());
+        h = hash_combine(h, static_cast< HashValue >(int_type->sign()));
+      } break;
+      case Type::FloatKind: {
+        auto float_type = cast< FloatType >(type);
+        h = hash_combine(h, float_type->bit_width());
+        h = hash_combine(h,
+                         static_cast< HashValue >(
+                             float_type->float_semantic()));
+      } break;
+      case Type::PointerKind: {
+        h = hash_combine(h, this->hash(cast< PointerType >(type)->pointee()));
+      } break;
+      case Type::StructKind: {
+        auto struct_type = cast< StructType >(type);
+        h = hash_combine(h, struct_type->packed() ? 1 : 0);
+        for (auto it = struct_type->field_begin(),
+                  et = struct_type->field_end();
+             it != et;
+             ++it) {
+          h = hash_combine(h, hash_string(it->offset.str()));
+          h = hash_combine(h, this->hash(it->type));
+        }
+      } break;
+      case Type::ArrayKind:
+      case Type::VectorKind: {
+        auto seq_type = cast< SequentialType >(type);
+        h = hash_combine(h, this->hash(seq_type->element_type()));
+        h = hash_combine(h, hash_string(seq_type->num_elements().str()));
+      } break;
+      case Type::FunctionKind: {
+        auto fun_type = cast< FunctionType >(type);
+        h = hash_combine(h, this->hash(fun_type->return_type()));
+        for (auto it = fun_type->param_begin(), et = fun_type->param_end();
+             it != et;
+             ++it) {
+          h = hash_combine(h, this->hash(*it));
+        }
+        h = hash_combine(h, fun_type->is_var_arg() ? 1 : 0);
+      } break;
+      default: {
+        ikos_unreachable("unexpected type");
+      }
+    }
+
+    this->_types[type] = h;
+    return h;
+  }
+
+  /// \brief Hash a value
+  HashValue hash(Value* value) {
+    HashValue h = static_cast< HashValue >(value->kind());
+    h = hash_combine(h, this->hash(value->type()));
+
+    switch (value->kind()) {
+      case Value::UndefinedConstantKind:
+      case Value::NullConstantKind:
+      case Value::AggregateZeroConstantKind: {
+      } break;
+      case Value::IntegerConstantKind: {
+        h = hash_combine(h,
+                         hash_string(
+                             cast< IntegerConstant >(value)->value().str()));
+      } break;
+      case Value::FloatConstantKind: {
+        h = hash_combine(h, hash_string(cast< FloatConstant >(value)->value()));
+      } break;
+      case Value::StructConstantKind: {
+        auto cst = cast< StructConstant >(value);
+        for (auto it = cst->field_begin(), et = cst->field_end(); it != et;
+             ++it) {
+          h = hash_combine(h, hash_string(it->offset.str()));
+          h = hash_combine(h, this->hash(it->value));
+        }
+      } break;
+      case Value::ArrayConstantKind:
+      case Value::VectorConstantKind: {
+        auto cst = cast< SequentialConstant >(value);
+        for (auto it = cst->element_begin(), et = cst->element_end(); it != et;
+             ++it) {
+          h = hash_combine(h, this->hash(*it));
+        }
+      } break;
+      case Value::DataArrayConstantKind: {
+        h = hash_combine(h,
+                         hash_string(cast< DataArrayConstant >(value)->data()));
+      } break;
+      case Value::FunctionPointerConstantKind: {
+        h = hash_combine(h,
+                         hash_string(cast< FunctionPointerConstant >(value)
+                                         ->function()
+                                         ->name()));
+      } break;
+      case Value::InlineAssemblyConstantKind: {
+        h = hash_combine(h,
+                         hash_string(
+                             cast< InlineAssemblyConstant >(value)->code()));
+      } break;
+      case Value::GlobalVariableKind: {
+        h = hash_combine(h, hash_string(cast< GlobalVariable >(value)->name()));
+      } break;
+      case Value::LocalVariableKind: {
+        auto lv = cast< LocalVariable >(value);
+        h = hash_combine(h, this->number(lv));
+        h = hash_combine(h, lv->alignment());
+      } break;
+      case Value::InternalVariableKind: {
+        h = hash_combine(h, this->number(cast< InternalVariable >(value)));
+      } break;
+      default: {
+        ikos_unreachable("unexpected value");
+      }
+    }
+
+    return h;
+  }
+
+  /// \brief Hash a statement
+  HashValue hash(Statement* stmt) {
+    HashValue h = static_cast< HashValue >(stmt->kind());
+
+    if (stmt->has_result()) {
+      h = hash_combine(h, this->hash(stmt->result()));
+    }
+    for (auto it = stmt->op_begin(), et = stmt->op_end(); it != et; ++it) {
+      h = hash_combine(h, this->hash(*it));
+    }
+
+    switch (stmt->kind()) {
+      case Statement::UnaryOperationKind: {
+        auto s = cast< UnaryOperation >(stmt);
+        h = hash_combine(h, static_cast< HashValue >(s->op()));
+      } break;
+      case Statement::BinaryOperationKind: {
+        auto s = cast< BinaryOperation >(stmt);
+        h = hash_combine(h, static_cast< HashValue >(s->op()));
+        h = hash_combine(h, s->has_no_wrap() ? 1 : 0);
+        h = hash_combine(h, s->is_exact() ? 1 : 0);
+      } break;
+      case Statement::ComparisonKind: {
+        auto s = cast< Comparison >(stmt);
+        h = hash_combine(h, static_cast< HashValue >(s->predicate()));
+      } break;
+      case Statement::AllocateKind: {
+        h = hash_combine(h,
+                         this->hash(cast< Allocate >(stmt)->allocated_type()));
+      } break;
+      case Statement::PointerShiftKind: {
+        auto s = cast< PointerShift >(stmt);
+        for (auto it = s->term_begin(), et = s->term_end(); it != et; ++it) {
+          h = hash_combine(h, hash_string((*it).first.str()));
+        }
+      } break;
+      case Statement::LoadKind: {
+        auto s = cast< Load >(stmt);
+        h = hash_combine(h, s->alignment());
+        h = hash_combine(h, s->is_volatile() ? 1 : 0);
+      } break;
+      case Statement::StoreKind: {
+        auto s = cast< Store >(stmt);
+        h = hash_combine(h, s->alignment());
+        h = hash_combine(h, s->is_volatile() ? 1 : 0);
+      } break;
+      case Statement::InvokeKind: {
+        auto s = cast< Invoke >(stmt);
+        h = hash_combine(h, this->number(s->normal_dest()));
+        h = hash_combine(h, this->number(s->exception_dest()));
+      } break;
+      default: {
+      } break;
+    }
+
+    return h;
+  }
+
+  /// \brief Hash a code
+  HashValue hash(const Code* code) {
+    // Parameters are numbered first
+    if (code->is_function_body()) {
+      Function* fun = code->function();
+      for (auto it = fun->param_begin(), et = fun->param_end(); it != et;
+           ++it) {
+        this->number(*it);
+      }
+    }
+
+    // Number basic blocks by position
+    for (BasicBlock* bb : *code) {
+      this->number(bb);
+    }
+
+    HashValue h = this->_blocks.size();
+    for (BasicBlock* bb : *code) {
+      HashValue bb_hash = this->number(bb);
+      for (Statement* stmt : *bb) {
+        bb_hash = hash_combine(bb_hash, this->hash(stmt));
+      }
+      for (auto it = bb->successor_begin(), et = bb->successor_end(); it != et;
+           ++it) {
+        bb_hash = hash_combine(bb_hash, this->number(*it));
+      }
+      h = hash_combine(h, bb_hash);
+    }
+
+    h = hash_combine(h, this->number(code->entry_block()));
+    if (code->has_exit_block()) {
+      h = hash_combine(h, this->number(code->exit_block()) + 1);
+    } else {
+      h = hash_combine(h, 0);
+    }
+    return h;
+  }
+
+private:
+  /// \brief Return the number of the given variable
+  HashValue number(Variable* var) {
+    return this->_variables.emplace(var, this->_variables.size())
+        .first->second;
+  }
+
+  /// \brief Return the number of the given basic block
+  HashValue number(BasicBlock* bb) {
+    return this->_blocks.emplace(bb, this->_blocks.size()).first->second;
+  }
+
+}; // end class StructuralHasher
+
+} // end anonymous namespace
+
+HashValue structural_hash(Type* type) {
+  StructuralHasher hasher;
+  return hasher.hash(type);
+}
+
+HashValue structural_hash(const Code* code) {
+  StructuralHasher hasher;
+  return hasher.hash(code);
+}
+
+} // end namespace ar
+} // end namespace ikos
@@ -163,6 +163,10 @@ FunctionType* Intrinsic::type(Bundle* bundle, ID id) {
       params.push_back(size_ty); // counter
       params.push_back(size_ty); // increment
     } break;
+    case IkosCounterForget: {
+      ret_ty = void_ty;          // ret
+      params.push_back(size_ty); // counter
+    } break;
     case IkosPrintInvariant: {
       ret_ty = void_ty; // ret
     } break;
@@ -518,6 +522,8 @@ const char* Intrinsic::short_name(ID id) {
       return "ikos.counter.init";
     case IkosCounterIncr:
       return "ikos.counter.incr";
+    case IkosCounterForget:
+      return "ikos.counter.forget";
     case IkosPrintInvariant:
       return "ikos.print_invariant";
     case IkosPrintValues:
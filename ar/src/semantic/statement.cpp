@@ -41,6 +41,9 @@
  *
  ******************************************************************************/
 
+#include <cstddef>
+#include <new>
+
 #include <ikos/ar/semantic/bundle.hpp>
 #include <ikos/ar/semantic/statement.hpp>
 
@@ -62,6 +65,35 @@ Statement::Statement(StatementKind kind,
 
 Statement::~Statement() = default;
 
+namespace {
+
+/// \brief Header before each statement, recording where it was allocated
+struct alignas(std::max_align_t) AllocationHeader {
+  // Arena, or null if allocated on the heap
+  Arena* arena;
+};
+
+} // end anonymous namespace
+
+void* Statement::operator new(std::size_t size) {
+  Arena* arena = Code::current_arena();
+  std::size_t total = sizeof(AllocationHeader) + size;
+  void* block =
+      (arena != nullptr) ? arena->allocate(total) : ::operator new(total);
+  auto header = new (block) AllocationHeader{arena};
+  return header + 1;
+}
+
+void Statement::operator delete(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  auto header = static_cast< AllocationHeader* >(ptr) - 1;
+  if (header->arena == nullptr) {
+    ::operator delete(header);
+  }
+}
+
 BasicBlock::StatementIterator Statement::iterator() const {
   return std::find(this->parent()->begin(), this->parent()->end(), this);
 }
@@ -235,6 +235,48 @@ void VectorConstant::dump(std::ostream& o) const {
   o << ">";
 }
 
+// DataArrayConstant
+
+DataArrayConstant::DataArrayConstant(ArrayType* type, std::string data)
+    : Constant(DataArrayConstantKind, type), _data(std::move(data)) {
+  ikos_assert_msg(type->element_type()->is_integer(), "unexpected type");
+  ikos_assert_msg(cast< IntegerType >(type->element_type())->bit_width() <= 64,
+                  "unexpected bit-width");
+  ikos_assert_msg(type->num_elements() == this->num_elements(),
+                  "incompatible size");
+}
+
+DataArrayConstant* DataArrayConstant::get(Context& ctx,
+                                          ArrayType* type,
+                                          const std::string& data) {
+  return ctx_impl(ctx).data_array_cst(type, data);
+}
+
+MachineInt DataArrayConstant::element(std::size_t i) const {
+  ikos_assert(i < this->num_elements());
+  IntegerType* type = this->element_type();
+  std::size_t size = this->element_size();
+  const char* p = this->_data.data() + i * size;
+
+  uint64_t n = 0;
+  for (std::size_t j = 0; j < size; j++) {
+    n |= static_cast< uint64_t >(static_cast< unsigned char >(p[j])) << (8 * j);
+  }
+  return MachineInt(n, type->bit_width(), type->sign());
+}
+
+void DataArrayConstant::dump(std::ostream& o) const {
+  o << "[";
+  for (std::size_t i = 0, n = this->num_elements(); i < n;) {
+    o << this->element(i);
+    ++i;
+    if (i != n) {
+      o << ", ";
+    }
+  }
+  o << "]";
+}
+
 // AggregateZeroConstant
 
 AggregateZeroConstant::AggregateZeroConstant(AggregateType* type)
@@ -345,6 +387,19 @@ void GlobalVariable::set_name(std::string new_name) {
   this->_parent->rename_global_variable(this, prev_name, this->name());
 }
 
+void GlobalVariable::erase_initializer() {
+  this->_initializer.reset();
+}
+
+HashValue GlobalVariable::hash() const {
+  HashValue h = structural_hash(this->_type);
+  h = hash_combine(h, this->_alignment);
+  if (this->is_definition()) {
+    h = hash_combine(h, this->_initializer->hash());
+  }
+  return h;
+}
+
 void GlobalVariable::dump(std::ostream& o) const {
   o << "@" << this->name();
 }
@@ -41,8 +41,14 @@
  *
  ******************************************************************************/
 
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include <ikos/ar/format/text.hpp>
 #include <ikos/ar/semantic/statement.hpp>
+#include <ikos/ar/support/parallel.hpp>
 #include <ikos/ar/verify/frontend.hpp>
 
 namespace ikos {
@@ -57,19 +63,58 @@ namespace ar {
 // and with the second pattern, the compiler will remove the call to f() if
 // valid is false because of short-circuiting.
 
-bool FrontendVerifier::verify(Bundle* bundle, std::ostream& err) const {
-  bool valid = true;
-  for (auto it = bundle->global_begin(), et = bundle->global_end();
-       it != et && (this->_all || valid);
+bool FrontendVerifier::verify(Bundle* bundle,
+                              std::ostream& err,
+                              unsigned jobs,
+                              bool dirty_only) const {
+  std::vector< GlobalVariable* > globals;
+  std::vector< Function* > functions;
+  for (auto it = bundle->global_begin(), et = bundle->global_end(); it != et;
        ++it) {
-    valid = this->verify(*it, err) && valid;
+    GlobalVariable* gv = *it;
+    if (!dirty_only || (gv->is_definition() && gv->initializer()->is_dirty())) {
+      globals.push_back(gv);
+    }
   }
   for (auto it = bundle->function_begin(), et = bundle->function_end();
-       it != et && (this->_all || valid);
+       it != et;
        ++it) {
-    valid = this->verify(*it, err) && valid;
+    Function* fun = *it;
+    if (!dirty_only || (fun->is_definition() && fun->body()->is_dirty())) {
+      functions.push_back(fun);
+    }
   }
-  return valid;
+  std::size_t n = globals.size() + functions.size();
+
+  // Errors and validity of each global variable and function
+  std::vector< std::string > errors(n);
+  std::vector< char > valid(n, 1);
+  std::atomic< bool > failed(false);
+
+  parallel_for(n, jobs, [&](std::size_t i) {
+    if (!this->_all && failed) {
+      return;
+    }
+
+    std::ostringstream out;
+    if (i < globals.size()) {
+      valid[i] = this->verify(globals[i], out);
+    } else {
+      valid[i] = this->verify(functions[i - globals.size()], out);
+    }
+    errors[i] = out.str();
+
+    if (!valid[i]) {
+      failed = true;
+    }
+  });
+
+  bool result = true;
+  for (std::size_t i = 0; i < n && (this->_all || result); i++) {
+    err << errors[i];
+    result = valid[i] && result;
+  }
+  return result;
 }
 
 bool FrontendVerifier::verify(GlobalVariable* /*gv*/,
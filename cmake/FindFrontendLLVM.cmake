@@ -93,6 +93,12 @@ if (NOT FRONTEND_LLVM_FOUND)
     DOC "Path to ikos llvm-to-ar library"
   )
 
+  find_library(FRONTEND_LLVM_PP_LIB
+    NAMES ikos-pp
+    HINTS ${FRONTEND_LLVM_LIB_SEARCH_DIRS}
+    DOC "Path to ikos-pp library"
+  )
+
   find_program(FRONTEND_LLVM_IKOS_PP_EXECUTABLE
     NAMES ikos-pp
     HINTS ${FRONTEND_LLVM_BIN_SEARCH_DIRS}
@@ -104,6 +110,7 @@ if (NOT FRONTEND_LLVM_FOUND)
     REQUIRED_VARS
       FRONTEND_LLVM_INCLUDE_DIR
       FRONTEND_LLVM_TO_AR_LIB
+      FRONTEND_LLVM_PP_LIB
       FRONTEND_LLVM_IKOS_PP_EXECUTABLE
     FAIL_MESSAGE
       "Could NOT find ikos llvm frontend. Please provide -DFRONTEND_LLVM_ROOT=/path/to/frontend")
@@ -0,0 +1,618 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Map stored in a sorted array while small, in a patricia tree above
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <ikos/core/adt/patricia_tree/map.hpp>
+#include <ikos/core/semantic/dumpable.hpp>
+#include <ikos/core/semantic/indexable.hpp>
+
+namespace ikos {
+namespace core {
+
+// forward declaration
+template < typename Key, typename Value, bool HashConsed >
+class AdaptiveMapIterator;
+
+/// \brief Map stored in a sorted array while small, in a patricia tree above
+///
+/// Small maps are stored in an array of pairs, sorted by key index in the
+/// order of iteration of a patricia tree. The array is shared between copies
+/// and copied on write. Lookups,
+/// comparisons and binary operations on small maps are scans over a contiguous
+/// array, which is faster than walking a patricia tree.
+///
+/// Once the map holds more than FlatLimit elements, it switches to a
+/// PatriciaTreeMap. It switches back to the array when an intersection of
+/// trees holds at most FlatLimit / 2 elements.
+///
+/// If HashConsed is true, the patricia tree is hash-consed, see
+/// PatriciaTreeMap.
+///
+/// Both representations are iterated in the same order.
+template < typename Key, typename Value, bool HashConsed = false >
+class AdaptiveMap final {
+public:
+  static_assert(IsIndexable< Key >::value,
+                "Key must implement IndexableTraits");
+
+  /// \brief Maximum number of elements stored in the sorted array
+  static constexpr std::size_t FlatLimit = 32;
+
+private:
+  using Pair = std::pair< Key, Value >;
+  using Vector = std::vector< Pair >;
+  using VectorPtr = std::shared_ptr< Vector >;
+  using PatriciaTreeMapT = PatriciaTreeMap< Key, Value, HashConsed >;
+
+public:
+  using Iterator = AdaptiveMapIterator< Key, Value, HashConsed >;
+
+private:
+  // Sorted array, or null if the map is empty or stored in the tree
+  VectorPtr _flat;
+
+  // Patricia tree, if _is_tree is true
+  PatriciaTreeMapT _tree;
+
+  // True if the elements are stored in the patricia tree
+  bool _is_tree = false;
+
+private:
+  /// \brief Return the index of the given key
+  static Index index(const Key& key) {
+    return IndexableTraits< Key >::index(key);
+  }
+
+  /// \brief Compare two indexes in the order of iteration of a patricia tree
+  ///
+  /// The patricia tree puts keys with a zero at their lowest differing bit on
+  /// the left, hence keys are ordered by their bit-reversed index.
+  static bool less(Index a, Index b) {
+    Index diff = a ^ b;
+    return diff != 0 && (a & (diff & (~diff + 1))) == 0;
+  }
+
+  /// \brief Compare a pair with an index
+  static bool less_pair(const Pair& p, Index idx) {
+    return less(index(p.first), idx);
+  }
+
+  /// \brief Return the empty array
+  static const Vector& empty_vector() {
+    static const Vector empty;
+    return empty;
+  }
+
+  /// \brief Return the sorted array
+  const Vector& flat() const {
+    return this->_flat ? *this->_flat : empty_vector();
+  }
+
+  /// \brief Return the sorted array, copying it if it is shared
+  Vector& mutable_flat() {
+    if (!this->_flat) {
+      this->_flat = std::make_shared< Vector >();
+    } else if (this->_flat.use_count() > 1) {
+      this->_flat = std::make_shared< Vector >(*this->_flat);
+    }
+    return *this->_flat;
+  }
+
+  /// \brief Return the position of the given key in the sorted array
+  ///
+  /// Return the position where it should be inserted if it is not found.
+  static std::size_t position(const Vector& v, const Key& key) {
+    return static_cast< std::size_t >(
+        std::lower_bound(v.begin(), v.end(), index(key), less_pair) -
+        v.begin());
+  }
+
+  /// \brief Return true if the given position holds the given key
+  static bool found(const Vector& v, std::size_t pos, const Key& key) {
+    return pos < v.size() && index(v[pos].first) == index(key);
+  }
+
+  /// \brief Build a patricia tree from the given sorted array
+  static PatriciaTreeMapT make_tree(const Vector& v) {
+    PatriciaTreeMapT tree;
+    for (const Pair& p : v) {
+      tree.insert_or_assign(p.first, p.second);
+    }
+    return tree;
+  }
+
+  /// \brief Return the elements as a patricia tree
+  PatriciaTreeMapT tree() const {
+    return this->_is_tree ? this->_tree : make_tree(this->flat());
+  }
+
+  /// \brief Store the elements in the given patricia tree
+  void set_tree(PatriciaTreeMapT tree) {
+    this->_flat.reset();
+    this->_tree = std::move(tree);
+    this->_is_tree = true;
+  }
+
+  /// \brief Store the elements in the given sorted array
+  ///
+  /// Switch to a patricia tree if the array is too large.
+  void set_flat(Vector&& elements) {
+    if (elements.size() > FlatLimit) {
+      this->set_tree(make_tree(elements));
+      return;
+    }
+    this->_tree.clear();
+    this->_is_tree = false;
+    if (elements.empty()) {
+      this->_flat.reset();
+    } else {
+      this->_flat = std::make_shared< Vector >(std::move(elements));
+    }
+  }
+
+  /// \brief Switch to a patricia tree if the sorted array is too large
+  void grow() {
+    if (this->flat().size() > FlatLimit) {
+      this->set_tree(make_tree(this->flat()));
+    }
+  }
+
+  /// \brief Switch back to a sorted array if the patricia tree is small
+  void shrink() {
+    std::size_t size = 0;
+    for (auto it = this->_tree.begin(), et = this->_tree.end(); it != et;
+         ++it) {
+      if (++size > FlatLimit / 2) {
+        return;
+      }
+    }
+    this->set_flat(Vector(this->_tree.begin(), this->_tree.end()));
+  }
+
+public:
+  /// \brief Create an empty map
+  AdaptiveMap() = default;
+
+  /// \brief Copy constructor
+  AdaptiveMap(const AdaptiveMap&) noexcept = default;
+
+  /// \brief Move constructor
+  AdaptiveMap(AdaptiveMap&&) noexcept = default;
+
+  /// \brief Copy assignment operator
+  AdaptiveMap& operator=(const AdaptiveMap&) noexcept = default;
+
+  /// \brief Move assignment operator
+  AdaptiveMap& operator=(AdaptiveMap&&) noexcept = default;
+
+  /// \brief Destructor
+  ~AdaptiveMap() = default;
+
+  /// \brief Return true if the elements are stored in a patricia tree
+  bool is_tree() const { return this->_is_tree; }
+
+  /// \brief Return true if the map is empty
+  bool empty() const {
+    return this->_is_tree ? this->_tree.empty() : this->_flat == nullptr;
+  }
+
+  /// \brief Return the number of elements in the map
+  std::size_t size() const {
+    return this->_is_tree ? this->_tree.size() : this->flat().size();
+  }
+
+  /// \brief Clear the content of the map
+  void clear() {
+    this->_flat.reset();
+    this->_tree.clear();
+    this->_is_tree = false;
+  }
+
+  /// \brief Find the value associated with the given key
+  boost::optional< const Value& > at(const Key& key) const {
+    if (this->_is_tree) {
+      return this->_tree.at(key);
+    }
+    const Vector& v = this->flat();
+    std::size_t pos = position(v, key);
+    if (found(v, pos, key)) {
+      return v[pos].second;
+    }
+    return boost::none;
+  }
+
+  /// \brief Return the begin iterator over the elements of the map
+  Iterator begin() const {
+    if (this->_is_tree) {
+      return Iterator(this->_tree.begin());
+    }
+    return Iterator(this->flat().data());
+  }
+
+  /// \brief Return the end iterator over the elements of the map
+  Iterator end() const {
+    if (this->_is_tree) {
+      return Iterator(this->_tree.end());
+    }
+    return Iterator(this->flat().data() + this->flat().size());
+  }
+
+  /// \brief Lower or equal comparison
+  ///
+  /// The comparison function needs to be a callable of type:
+  ///   bool(const Value& left, const Value& right)
+  template < typename Compare >
+  bool leq(const AdaptiveMap& other, const Compare& cmp) const {
+    if (other._is_tree) {
+      return this->tree().leq(other._tree, cmp);
+    } else if (this->_is_tree) {
+      for (const Pair& p : other.flat()) {
+        boost::optional< const Value& > v = this->_tree.at(p.first);
+        if (!v || !cmp(*v, p.second)) {
+          return false;
+        }
+      }
+      return true;
+    } else if (this->_flat == other._flat) {
+      return true;
+    }
+    const Vector& a = this->flat();
+    const Vector& b = other.flat();
+    if (a.size() < b.size()) {
+      return false;
+    }
+    auto it = a.begin();
+    for (const Pair& p : b) {
+      Index idx = index(p.first);
+      while (it != a.end() && less(index(it->first), idx)) {
+        ++it;
+      }
+      if (it == a.end() || index(it->first) != idx ||
+          !cmp(it->second, p.second)) {
+        return false;
+      }
+      ++it;
+    }
+    return true;
+  }
+
+  /// \brief Equality comparison
+  ///
+  /// The comparison function should be a callable of type:
+  ///   bool(const Value& left, const Value& right)
+  template < typename Compare >
+  bool equals(const AdaptiveMap& other, const Compare& cmp) const {
+    if (this->_is_tree || other._is_tree) {
+      return this->tree().equals(other.tree(), cmp);
+    } else if (this->_flat == other._flat) {
+      return true;
+    }
+    const Vector& a = this->flat();
+    const Vector& b = other.flat();
+    return a.size() == b.size() &&
+           std::equal(a.begin(),
+                      a.end(),
+                      b.begin(),
+                      [&cmp](const Pair& x, const Pair& y) {
+                        return index(x.first) == index(y.first) &&
+                               cmp(x.second, y.second);
+                      });
+  }
+
+  /// \brief Insert an element or assign a new value for the given `key`
+  void insert_or_assign(const Key& key, const Value& value) {
+    if (this->_is_tree) {
+      this->_tree.insert_or_assign(key, value);
+      return;
+    }
+    Vector& v = this->mutable_flat();
+    std::size_t pos = position(v, key);
+    if (found(v, pos, key)) {
+      v[pos].second = value;
+    } else {
+      v.emplace(v.begin() + static_cast< std::ptrdiff_t >(pos), key, value);
+      this->grow();
+    }
+  }
+
+  /// \brief Find the value corresponding to `key` and replace its bound value
+  /// with `combine(old_value, value)`.
+  ///
+  /// If the key is not found, insert (`key`, `value`).
+  ///
+  /// The combining function should be a callable of type:
+  ///   boost::optional< Value >(const Value& old, const Value& new)
+  template < typename CombiningFunction >
+  void update_or_insert(const CombiningFunction& combine,
+                        const Key& key,
+                        const Value& value) {
+    if (this->_is_tree) {
+      this->_tree.update_or_insert(combine, key, value);
+      return;
+    }
+    std::size_t pos = position(this->flat(), key);
+    if (found(this->flat(), pos, key)) {
+      boost::optional< Value > new_value =
+          combine(this->flat()[pos].second, value);
+      Vector& v = this->mutable_flat();
+      if (new_value) {
+        v[pos].second = std::move(*new_value);
+      } else {
+        v.erase(v.begin() + static_cast< std::ptrdiff_t >(pos));
+        if (v.empty()) {
+          this->_flat.reset();
+        }
+      }
+    } else {
+      Vector& v = this->mutable_flat();
+      v.emplace(v.begin() + static_cast< std::ptrdiff_t >(pos), key, value);
+      this->grow();
+    }
+  }
+
+  /// \brief Remove an element from the map, if present
+  void erase(const Key& key) {
+    if (this->_is_tree) {
+      this->_tree.erase(key);
+      return;
+    }
+    std::size_t pos = position(this->flat(), key);
+    if (!found(this->flat(), pos, key)) {
+      return;
+    }
+    Vector& v = this->mutable_flat();
+    v.erase(v.begin() + static_cast< std::ptrdiff_t >(pos));
+    if (v.empty()) {
+      this->_flat.reset();
+    }
+  }
+
+  /// \brief Perform the union of two maps
+  ///
+  /// The combining function should be a callable of type:
+  ///   boost::optional< Value >(const Value& left, const Value& right)
+  template < typename CombiningFunction >
+  void join_with(const AdaptiveMap& other, const CombiningFunction& combine) {
+    if (this->_is_tree || other._is_tree) {
+      if (!this->_is_tree) {
+        this->set_tree(this->tree());
+      }
+      this->_tree.join_with(other.tree(), combine);
+      return;
+    } else if (this->_flat == other._flat || other._flat == nullptr) {
+      return;
+    } else if (this->_flat == nullptr) {
+      this->_flat = other._flat;
+      return;
+    }
+    const Vector& a = this->flat();
+    const Vector& b = other.flat();
+    Vector elements;
+    elements.reserve(a.size() + b.size());
+    auto it = a.begin();
+    auto jt = b.begin();
+    while (it != a.end() && jt != b.end()) {
+      Index i = index(it->first);
+      Index j = index(jt->first);
+      if (less(i, j)) {
+        elements.push_back(*it++);
+      } else if (less(j, i)) {
+        elements.push_back(*jt++);
+      } else {
+        boost::optional< Value > new_value = combine(it->second, jt->second);
+        if (new_value) {
+          elements.emplace_back(it->first, std::move(*new_value));
+        }
+        ++it;
+        ++jt;
+      }
+    }
+    elements.insert(elements.end(), it, a.end());
+    elements.insert(elements.end(), jt, b.end());
+    this->set_flat(std::move(elements));
+  }
+
+  /// \brief Perform the intersection of two maps
+  ///
+  /// The combining function should be a callable of type:
+  ///   boost::optional< Value >(const Value& left, const Value& right)
+  template < typename CombiningFunction >
+  void intersect_with(const AdaptiveMap& other,
+                      const CombiningFunction& combine) {
+    if (this->_is_tree && other._is_tree) {
+      this->_tree.intersect_with(other._tree, combine);
+      this->shrink();
+      return;
+    }
+    Vector elements;
+    if (this->_is_tree) {
+      for (const Pair& p : other.flat()) {
+        boost::optional< const Value& > v = this->_tree.at(p.first);
+        if (v) {
+          boost::optional< Value > new_value = combine(*v, p.second);
+          if (new_value) {
+            elements.emplace_back(p.first, std::move(*new_value));
+          }
+        }
+      }
+    } else if (other._is_tree) {
+      for (const Pair& p : this->flat()) {
+        boost::optional< const Value& > v = other._tree.at(p.first);
+        if (v) {
+          boost::optional< Value > new_value = combine(p.second, *v);
+          if (new_value) {
+            elements.emplace_back(p.first, std::move(*new_value));
+          }
+        }
+      }
+    } else if (this->_flat == other._flat) {
+      return;
+    } else {
+      const Vector& a = this->flat();
+      const Vector& b = other.flat();
+      auto it = a.begin();
+      auto jt = b.begin();
+      while (it != a.end() && jt != b.end()) {
+        Index i = index(it->first);
+        Index j = index(jt->first);
+        if (less(i, j)) {
+          ++it;
+        } else if (less(j, i)) {
+          ++jt;
+        } else {
+          boost::optional< Value > new_value =
+              combine(it->second, jt->second);
+          if (new_value) {
+            elements.emplace_back(it->first, std::move(*new_value));
+          }
+          ++it;
+          ++jt;
+        }
+      }
+    }
+    this->set_flat(std::move(elements));
+  }
+
+  /// \brief Dump the map, for debugging purpose
+  void dump(std::ostream& o) const {
+    static_assert(IsDumpable< Key >::value,
+                  "Key must implement DumpableTraits");
+    static_assert(IsDumpable< Value >::value,
+                  "Value must implement DumpableTraits");
+    o << "{";
+    for (auto it = this->begin(), et = this->end(); it != et;) {
+      DumpableTraits< Key >::dump(o, it->first);
+      o << " -> ";
+      DumpableTraits< Value >::dump(o, it->second);
+      ++it;
+      if (it != et) {
+        o << "; ";
+      }
+    }
+    o << "}";
+  }
+
+}; // end class AdaptiveMap
+
+/// \brief Iterator over the elements of an AdaptiveMap
+template < typename Key, typename Value, bool HashConsed >
+class AdaptiveMapIterator final {
+public:
+  // Required types for iterators
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = const std::pair< Key, Value >;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const std::pair< Key, Value >*;
+  using reference = const std::pair< Key, Value >&;
+
+private:
+  using TreeIterator =
+      typename PatriciaTreeMap< Key, Value, HashConsed >::Iterator;
+
+private:
+  // Position in the sorted array, if the map is not a tree
+  pointer _ptr = nullptr;
+
+  // Position in the patricia tree, if the map is a tree
+  boost::optional< TreeIterator > _it;
+
+public:
+  /// \brief Create an end iterator on an empty map
+  AdaptiveMapIterator() = default;
+
+  /// \brief Create an iterator on a sorted array
+  explicit AdaptiveMapIterator(pointer ptr) : _ptr(ptr) {}
+
+  /// \brief Create an iterator on a patricia tree
+  explicit AdaptiveMapIterator(TreeIterator it) : _it(std::move(it)) {}
+
+  /// \brief Pre-increment the iterator
+  AdaptiveMapIterator& operator++() {
+    if (this->_it) {
+      ++(*this->_it);
+    } else {
+      ++this->_ptr;
+    }
+    return *this;
+  }
+
+  /// \brief Post-increment the iterator
+  const AdaptiveMapIterator operator++(int) {
+    AdaptiveMapIterator r = *this;
+    ++(*this);
+    return r;
+  }
+
+  /// \brief Compare two iterators
+  bool operator==(const AdaptiveMapIterator& other) const {
+    if (this->_it && other._it) {
+      return *this->_it == *other._it;
+    }
+    return !this->_it && !other._it && this->_ptr == other._ptr;
+  }
+
+  /// \brief Compare two iterators
+  bool operator!=(const AdaptiveMapIterator& other) const {
+    return !this->operator==(other);
+  }
+
+  /// \brief Dereference the iterator
+  reference operator*() const { return this->_it ? **this->_it : *this->_ptr; }
+
+  /// \brief Dereference the iterator
+  pointer operator->() const { return &this->operator*(); }
+
+}; // end class AdaptiveMapIterator
+
+} // end namespace core
+} // end namespace ikos
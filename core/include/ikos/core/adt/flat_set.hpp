@@ -0,0 +1,339 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Set stored in a sorted array shared between copies
+ *
+ * Elements are sorted by index. Copies share the same array until one of them
+ * is modified. Union, intersection and inclusion are linear merges over
+ * contiguous memory, which is faster than walking patricia trees for large
+ * sets without shared subtrees, especially when indexes are dense.
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include <ikos/core/semantic/dumpable.hpp>
+#include <ikos/core/semantic/indexable.hpp>
+
+namespace ikos {
+namespace core {
+
+/// \brief Set of elements stored in a sorted array
+///
+/// Elements are ordered by their index (see IndexableTraits). The array is
+/// shared between copies and copied on write.
+template < typename Key >
+class FlatSet final {
+public:
+  static_assert(IsIndexable< Key >::value,
+                "Key must implement IndexableTraits");
+
+private:
+  using Vector = std::vector< Key >;
+  using VectorPtr = std::shared_ptr< const Vector >;
+
+public:
+  using Iterator = typename Vector::const_iterator;
+
+private:
+  // Sorted array, or null for the empty set
+  VectorPtr _elements;
+
+private:
+  /// \brief Return the index of the given element
+  static Index index(const Key& key) {
+    return IndexableTraits< Key >::index(key);
+  }
+
+  /// \brief Compare two elements by index
+  static bool less(const Key& a, const Key& b) { return index(a) < index(b); }
+
+  /// \brief Return the empty array
+  static const Vector& empty_vector() {
+    static const Vector empty;
+    return empty;
+  }
+
+  /// \brief Return the array
+  const Vector& elements() const {
+    return this->_elements ? *this->_elements : empty_vector();
+  }
+
+  /// \brief Set the array
+  void set(Vector&& elements) {
+    if (elements.empty()) {
+      this->_elements.reset();
+    } else {
+      this->_elements = std::make_shared< const Vector >(std::move(elements));
+    }
+  }
+
+public:
+  /// \brief Create an empty set
+  FlatSet() = default;
+
+  /// \brief Create a set with the given elements
+  FlatSet(std::initializer_list< Key > elements)
+      : FlatSet(elements.begin(), elements.end()) {}
+
+  /// \brief Create a set with the given elements
+  template < typename InputIterator >
+  FlatSet(InputIterator first, InputIterator last) {
+    Vector elements(first, last);
+    std::sort(elements.begin(), elements.end(), less);
+    elements.erase(std::unique(elements.begin(),
+                               elements.end(),
+                               [](const Key& a, const Key& b) {
+                                 return index(a) == index(b);
+                               }),
+                   elements.end());
+    this->set(std::move(elements));
+  }
+
+  /// \brief Copy constructor
+  FlatSet(const FlatSet&) noexcept = default;
+
+  /// \brief Move constructor
+  FlatSet(FlatSet&&) noexcept = default;
+
+  /// \brief Copy assignment operator
+  FlatSet& operator=(const FlatSet&) noexcept = default;
+
+  /// \brief Move assignment operator
+  FlatSet& operator=(FlatSet&&) noexcept = default;
+
+  /// \brief Destructor
+  ~FlatSet() = default;
+
+  /// \brief Return true if the set is empty
+  bool empty() const { return this->_elements == nullptr; }
+
+  /// \brief Return the number of elements in the set
+  std::size_t size() const { return this->elements().size(); }
+
+  /// \brief Remove all the elements
+  void clear() { this->_elements.reset(); }
+
+  /// \brief Return true if the set contains the given element
+  bool contains(const Key& key) const {
+    const Vector& v = this->elements();
+    auto it = std::lower_bound(v.begin(), v.end(), key, less);
+    return it != v.end() && index(*it) == index(key);
+  }
+
+  /// \brief Return true if this set is a subset of the other
+  bool is_subset_of(const FlatSet& other) const {
+    if (this->_elements == other._elements) {
+      return true;
+    }
+    const Vector& a = this->elements();
+    const Vector& b = other.elements();
+    return a.size() <= b.size() &&
+           std::includes(b.begin(), b.end(), a.begin(), a.end(), less);
+  }
+
+  /// \brief Return true if the two sets are equal
+  bool equals(const FlatSet& other) const {
+    if (this->_elements == other._elements) {
+      return true;
+    }
+    const Vector& a = this->elements();
+    const Vector& b = other.elements();
+    return a.size() == b.size() &&
+           std::equal(a.begin(),
+                      a.end(),
+                      b.begin(),
+                      [](const Key& x, const Key& y) {
+                        return index(x) == index(y);
+                      });
+  }
+
+  /// \brief Return true if the two sets are equal
+  bool operator==(const FlatSet& other) const { return this->equals(other); }
+
+  /// \brief Begin iterator over the elements, in index order
+  Iterator begin() const { return this->elements().begin(); }
+
+  /// \brief End iterator over the elements
+  Iterator end() const { return this->elements().end(); }
+
+  /// \brief Insert an element
+  void insert(const Key& key) {
+    const Vector& v = this->elements();
+    auto it = std::lower_bound(v.begin(), v.end(), key, less);
+    if (it != v.end() && index(*it) == index(key)) {
+      return;
+    }
+    Vector elements;
+    elements.reserve(v.size() + 1);
+    elements.insert(elements.end(), v.begin(), it);
+    elements.push_back(key);
+    elements.insert(elements.end(), it, v.end());
+    this->set(std::move(elements));
+  }
+
+  /// \brief Remove an element
+  void erase(const Key& key) {
+    const Vector& v = this->elements();
+    auto it = std::lower_bound(v.begin(), v.end(), key, less);
+    if (it == v.end() || index(*it) != index(key)) {
+      return;
+    }
+    Vector elements;
+    elements.reserve(v.size() - 1);
+    elements.insert(elements.end(), v.begin(), it);
+    elements.insert(elements.end(), std::next(it), v.end());
+    this->set(std::move(elements));
+  }
+
+  /// \brief Perform the union of two sets
+  void join_with(const FlatSet& other) {
+    if (this->_elements == other._elements || other.empty()) {
+      return;
+    } else if (this->empty() || this->is_subset_of(other)) {
+      this->_elements = other._elements;
+      return;
+    }
+    const Vector& a = this->elements();
+    const Vector& b = other.elements();
+    Vector elements;
+    elements.reserve(a.size() + b.size());
+    std::set_union(a.begin(),
+                   a.end(),
+                   b.begin(),
+                   b.end(),
+                   std::back_inserter(elements),
+                   less);
+    if (elements.size() != a.size()) {
+      this->set(std::move(elements));
+    }
+  }
+
+  /// \brief Perform the union of two sets
+  FlatSet join(const FlatSet& other) const {
+    FlatSet tmp(*this);
+    tmp.join_with(other);
+    return tmp;
+  }
+
+  /// \brief Perform the intersection of two sets
+  void intersect_with(const FlatSet& other) {
+    if (this->_elements == other._elements || this->empty()) {
+      return;
+    } else if (other.empty()) {
+      this->clear();
+      return;
+    }
+    const Vector& a = this->elements();
+    const Vector& b = other.elements();
+    Vector elements;
+    elements.reserve(std::min(a.size(), b.size()));
+    std::set_intersection(a.begin(),
+                          a.end(),
+                          b.begin(),
+                          b.end(),
+                          std::back_inserter(elements),
+                          less);
+    if (elements.size() != a.size()) {
+      this->set(std::move(elements));
+    }
+  }
+
+  /// \brief Perform the intersection of two sets
+  FlatSet intersect(const FlatSet& other) const {
+    FlatSet tmp(*this);
+    tmp.intersect_with(other);
+    return tmp;
+  }
+
+  /// \brief Perform the difference of two sets
+  void difference_with(const FlatSet& other) {
+    if (this->_elements == other._elements) {
+      this->clear();
+      return;
+    } else if (this->empty() || other.empty()) {
+      return;
+    }
+    const Vector& a = this->elements();
+    const Vector& b = other.elements();
+    Vector elements;
+    elements.reserve(a.size());
+    std::set_difference(a.begin(),
+                        a.end(),
+                        b.begin(),
+                        b.end(),
+                        std::back_inserter(elements),
+                        less);
+    if (elements.size() != a.size()) {
+      this->set(std::move(elements));
+    }
+  }
+
+  /// \brief Perform the difference of two sets
+  FlatSet difference(const FlatSet& other) const {
+    FlatSet tmp(*this);
+    tmp.difference_with(other);
+    return tmp;
+  }
+
+  /// \brief Dump the set, for debugging purpose
+  void dump(std::ostream& o) const {
+    static_assert(IsDumpable< Key >::value,
+                  "Key must implement DumpableTraits");
+    o << "{";
+    for (auto it = this->begin(), et = this->end(); it != et;) {
+      DumpableTraits< Key >::dump(o, *it);
+      ++it;
+      if (it != et) {
+        o << "; ";
+      }
+    }
+    o << "}";
+  }
+
+}; // end class FlatSet
+
+} // end namespace core
+} // end namespace ikos
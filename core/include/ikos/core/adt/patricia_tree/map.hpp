@@ -51,11 +51,12 @@
 
 #include <iostream>
 #include <iterator>
-#include <memory>
 #include <stack>
 
+#include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 
+#include <ikos/core/adt/patricia_tree/node.hpp>
 #include <ikos/core/adt/patricia_tree/utils.hpp>
 #include <ikos/core/semantic/dumpable.hpp>
 #include <ikos/core/semantic/indexable.hpp>
@@ -69,81 +70,121 @@ namespace patricia_tree_map_impl {
 
 using namespace patricia_tree_utils;
 
-template < typename Key, typename Value >
+template < typename Key, typename Value, bool HashConsed >
 class PatriciaTree;
 
-template < typename Key, typename Value >
+template < typename Key, typename Value, bool HashConsed >
+class PatriciaTreeNode;
+
+template < typename Key, typename Value, bool HashConsed >
+class PatriciaTreeLeaf;
+
+template < typename Key, typename Value, bool HashConsed >
 class PatriciaTreeIterator;
 
-template < typename Key, typename Value >
-inline bool empty(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree);
+template < typename Key, typename Value, bool HashConsed >
+struct TreeFactory;
 
-template < typename Key, typename Value >
-inline std::size_t size(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree);
+template < typename Key, typename Value, bool HashConsed >
+using TreePtr = NodePtr< const PatriciaTree< Key, Value, HashConsed > >;
 
-template < typename Key, typename Value >
+template < typename Key, typename Value, bool HashConsed >
+using BranchPtr = NodePtr< const PatriciaTreeNode< Key, Value, HashConsed > >;
+
+template < typename Key, typename Value, bool HashConsed >
+using LeafPtr = NodePtr< const PatriciaTreeLeaf< Key, Value, HashConsed > >;
+
+template < typename Key, typename Value, bool HashConsed >
+inline bool empty(const TreePtr< Key, Value, HashConsed >& tree);
+
+template < typename Key, typename Value, bool HashConsed >
+inline std::size_t size(const TreePtr< Key, Value, HashConsed >& tree);
+
+template < typename Key, typename Value, bool HashConsed >
 inline boost::optional< const Value& > find_value(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+    const TreePtr< Key, Value, HashConsed >& tree,
     const Key& key);
 
-template < typename Key, typename Value, typename Compare >
-inline bool leq(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-                const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename Compare >
+inline bool leq(const TreePtr< Key, Value, HashConsed >& s,
+                const TreePtr< Key, Value, HashConsed >& t,
                 const Compare& cmp);
 
-template < typename Key, typename Value, typename Compare >
-inline bool equals(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-                   const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename Compare >
+inline bool equals(const TreePtr< Key, Value, HashConsed >& s,
+                   const TreePtr< Key, Value, HashConsed >& t,
                    const Compare& cmp);
 
-template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > insert_or_assign(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+template < typename Key, typename Value, bool HashConsed >
+inline TreePtr< Key, Value, HashConsed > insert_or_assign(
+    const TreePtr< Key, Value, HashConsed >& tree,
     const Key& key,
     const Value& value);
 
-template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_insert(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename CombiningFunction >
+inline TreePtr< Key, Value, HashConsed > update_or_insert(
+    const TreePtr< Key, Value, HashConsed >& tree,
     const CombiningFunction& combine,
     const Key& key,
     const Value& value);
 
-template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_ignore(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename CombiningFunction >
+inline TreePtr< Key, Value, HashConsed > update_or_ignore(
+    const TreePtr< Key, Value, HashConsed >& tree,
     const CombiningFunction& combine,
     const Key& key,
     const Value& value);
 
-template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > erase(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+template < typename Key, typename Value, bool HashConsed >
+inline TreePtr< Key, Value, HashConsed > erase(
+    const TreePtr< Key, Value, HashConsed >& tree,
     const Key& key);
 
-template < typename Key, typename Value, typename UnaryOp >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > transform(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename UnaryOp >
+inline TreePtr< Key, Value, HashConsed > transform(
+    const TreePtr< Key, Value, HashConsed >& tree,
     const UnaryOp& op);
 
-template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > join(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename CombiningFunction >
+inline TreePtr< Key, Value, HashConsed > join(
+    const TreePtr< Key, Value, HashConsed >& s,
+    const TreePtr< Key, Value, HashConsed >& t,
     const CombiningFunction& combine);
 
-template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > intersect(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename CombiningFunction >
+inline TreePtr< Key, Value, HashConsed > intersect(
+    const TreePtr< Key, Value, HashConsed >& s,
+    const TreePtr< Key, Value, HashConsed >& t,
     const CombiningFunction& combine);
 
-template < typename Key, typename Value, typename BinaryOp >
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename BinaryOp >
 inline typename BinaryOp::ResultType binary_operation(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+    const TreePtr< Key, Value, HashConsed >& s,
+    const TreePtr< Key, Value, HashConsed >& t,
     const BinaryOp& op);
 
 } // end namespace patricia_tree_map_impl
@@ -155,25 +196,32 @@ inline typename BinaryOp::ResultType binary_operation(
 /// Key must implement IndexableTraits
 /// Key must implement bool Key::operator==(const Key&) const
 /// Value must implement bool Value::operator==(const Value&) const
-template < typename Key, typename Value >
+///
+/// If HashConsed is true, the nodes of the trees are hash-consed: equal maps
+/// share the same tree, and identical subtrees are shared across all maps.
+/// Comparisons become pointer comparisons, at the cost of a lookup in a global
+/// table on each node creation. In that case, Value must also implement
+/// `std::size_t hash_value(const Value&)`, and Value::operator== must agree
+/// with the comparison functions given to leq() and equals().
+template < typename Key, typename Value, bool HashConsed = false >
 class PatriciaTreeMap final {
 public:
   static_assert(IsIndexable< Key >::value,
                 "Key must implement IndexableTraits");
 
 private:
-  using PatriciaTree = patricia_tree_map_impl::PatriciaTree< Key, Value >;
+  using TreePtr = patricia_tree_map_impl::TreePtr< Key, Value, HashConsed >;
 
 public:
-  using Iterator = patricia_tree_map_impl::PatriciaTreeIterator< Key, Value >;
+  using Iterator =
+      patricia_tree_map_impl::PatriciaTreeIterator< Key, Value, HashConsed >;
 
 private:
-  std::shared_ptr< const PatriciaTree > _tree;
+  TreePtr _tree;
 
 private:
   /// \brief Private constructor
-  explicit PatriciaTreeMap(std::shared_ptr< const PatriciaTree > tree)
-      : _tree(std::move(tree)) {}
+  explicit PatriciaTreeMap(TreePtr tree) : _tree(std::move(tree)) {}
 
 public:
   /// \brief Create an empty patricia tree map
@@ -400,20 +448,18 @@ public:
   }
 
   // Allow binary_operation to call the private constructor
-  template < typename K, typename V, typename BinaryOp >
+  template < typename K, typename V, bool HC, typename BinaryOp >
   friend typename BinaryOp::ResultType patricia_tree_map_impl::binary_operation(
-      const std::shared_ptr<
-          const patricia_tree_map_impl::PatriciaTree< K, V > >& s,
-      const std::shared_ptr<
-          const patricia_tree_map_impl::PatriciaTree< K, V > >& t,
+      const patricia_tree_map_impl::TreePtr< K, V, HC >& s,
+      const patricia_tree_map_impl::TreePtr< K, V, HC >& t,
       const BinaryOp& op);
 
 }; // end class PatriciaTreeMap
 
 namespace patricia_tree_map_impl {
 
-template < typename Key, typename Value >
-class PatriciaTree {
+template < typename Key, typename Value, bool HashConsed >
+class PatriciaTree : public RefCountedNode {
 private:
   std::size_t _size;
 
@@ -436,49 +482,57 @@ public:
 
 }; // end class PatriciaTree
 
-template < typename Key, typename Value >
-class PatriciaTreeNode final : public PatriciaTree< Key, Value > {
+template < typename Key, typename Value, bool HashConsed >
+class PatriciaTreeNode final : public PatriciaTree< Key, Value, HashConsed > {
 private:
   Index _prefix;
   Index _branching_bit;
-  std::shared_ptr< const PatriciaTree< Key, Value > > _left_tree;
-  std::shared_ptr< const PatriciaTree< Key, Value > > _right_tree;
+  TreePtr< Key, Value, HashConsed > _left_tree;
+  TreePtr< Key, Value, HashConsed > _right_tree;
 
 public:
   PatriciaTreeNode(
       Index prefix,
       Index branching_bit,
-      std::shared_ptr< const PatriciaTree< Key, Value > > left_tree,
-      std::shared_ptr< const PatriciaTree< Key, Value > > right_tree)
-      : PatriciaTree< Key, Value >(left_tree->size() + right_tree->size()),
+      TreePtr< Key, Value, HashConsed > left_tree,
+      TreePtr< Key, Value, HashConsed > right_tree)
+      : PatriciaTree< Key, Value, HashConsed >(left_tree->size() +
+                                               right_tree->size()),
         _prefix(prefix),
         _branching_bit(branching_bit),
         _left_tree(std::move(left_tree)),
         _right_tree(std::move(right_tree)) {}
 
+  ~PatriciaTreeNode() override {
+    TreeFactory< Key, Value, HashConsed >::release(this);
+  }
+
   Index prefix() const { return this->_prefix; }
 
   Index branching_bit() const { return this->_branching_bit; }
 
-  const std::shared_ptr< const PatriciaTree< Key, Value > >& left_tree() const {
+  const TreePtr< Key, Value, HashConsed >& left_tree() const {
     return this->_left_tree;
   }
 
-  const std::shared_ptr< const PatriciaTree< Key, Value > >& right_tree()
-      const {
+  const TreePtr< Key, Value, HashConsed >& right_tree() const {
     return this->_right_tree;
   }
 
 }; // end class PatriciaTreeNode
 
-template < typename Key, typename Value >
-class PatriciaTreeLeaf final : public PatriciaTree< Key, Value > {
+template < typename Key, typename Value, bool HashConsed >
+class PatriciaTreeLeaf final : public PatriciaTree< Key, Value, HashConsed > {
 private:
   std::pair< Key, Value > _pair;
 
 public:
   PatriciaTreeLeaf(const Key& key, const Value& value)
-      : PatriciaTree< Key, Value >(1), _pair(key, value) {}
+      : PatriciaTree< Key, Value, HashConsed >(1), _pair(key, value) {}
+
+  ~PatriciaTreeLeaf() override {
+    TreeFactory< Key, Value, HashConsed >::release(this);
+  }
 
   const Key& key() const { return this->_pair.first; }
 
@@ -488,15 +542,122 @@ public:
 
 }; // end class PatriciaTreeLeaf
 
+/// \brief Creation of leaves and nodes
+template < typename Key, typename Value, bool HashConsed >
+struct TreeFactory {
+  static LeafPtr< Key, Value, HashConsed > leaf(const Key& key,
+                                                const Value& value) {
+    return make_node_ptr< const PatriciaTreeLeaf< Key, Value, HashConsed > >(
+        key, value);
+  }
+
+  static BranchPtr< Key, Value, HashConsed > node(
+      Index prefix,
+      Index branching_bit,
+      const TreePtr< Key, Value, HashConsed >& left_tree,
+      const TreePtr< Key, Value, HashConsed >& right_tree) {
+    return make_node_ptr< const PatriciaTreeNode< Key, Value, HashConsed > >(
+        prefix, branching_bit, left_tree, right_tree);
+  }
+
+  static void release(const PatriciaTreeLeaf< Key, Value, HashConsed >*) {}
+
+  static void release(const PatriciaTreeNode< Key, Value, HashConsed >*) {}
+
+}; // end struct TreeFactory
+
+/// \brief Creation of hash-consed leaves and nodes
 template < typename Key, typename Value >
-inline bool empty(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree) {
+struct TreeFactory< Key, Value, true > {
+  using Leaf = PatriciaTreeLeaf< Key, Value, true >;
+  using Node = PatriciaTreeNode< Key, Value, true >;
+
+  static std::size_t hash(Index index, const Value& value) {
+    std::size_t result = 0;
+    boost::hash_combine(result, index);
+    boost::hash_combine(result, value);
+    return result;
+  }
+
+  static std::size_t hash(Index prefix,
+                          Index branching_bit,
+                          const PatriciaTree< Key, Value, true >* left_tree,
+                          const PatriciaTree< Key, Value, true >* right_tree) {
+    std::size_t result = 0;
+    boost::hash_combine(result, prefix);
+    boost::hash_combine(result, branching_bit);
+    boost::hash_combine(result, left_tree);
+    boost::hash_combine(result, right_tree);
+    return result;
+  }
+
+  static LeafPtr< Key, Value, true > leaf(const Key& key, const Value& value) {
+    Index index = IndexableTraits< Key >::index(key);
+    return HashConsingTable< Leaf >::get().find_or_create(
+        hash(index, value),
+        [&](const Leaf& other) {
+          return IndexableTraits< Key >::index(other.key()) == index &&
+                 other.value() == value;
+        },
+        [&]() { return new const Leaf(key, value); });
+  }
+
+  static BranchPtr< Key, Value, true > node(
+      Index prefix,
+      Index branching_bit,
+      const TreePtr< Key, Value, true >& left_tree,
+      const TreePtr< Key, Value, true >& right_tree) {
+    return HashConsingTable< Node >::get().find_or_create(
+        hash(prefix, branching_bit, left_tree.get(), right_tree.get()),
+        [&](const Node& other) {
+          return other.prefix() == prefix &&
+                 other.branching_bit() == branching_bit &&
+                 other.left_tree() == left_tree &&
+                 other.right_tree() == right_tree;
+        },
+        [&]() {
+          return new const Node(prefix, branching_bit, left_tree, right_tree);
+        });
+  }
+
+  static void release(const Leaf* leaf) {
+    HashConsingTable< Leaf >::get().erase(hash(IndexableTraits< Key >::index(
+                                                   leaf->key()),
+                                               leaf->value()),
+                                          leaf);
+  }
+
+  static void release(const Node* node) {
+    HashConsingTable< Node >::get().erase(hash(node->prefix(),
+                                               node->branching_bit(),
+                                               node->left_tree().get(),
+                                               node->right_tree().get()),
+                                          node);
+  }
+
+}; // end struct TreeFactory
+
+template < typename Key, typename Value, bool HashConsed >
+inline LeafPtr< Key, Value, HashConsed > as_leaf(
+    const TreePtr< Key, Value, HashConsed >& tree) {
+  return static_node_ptr_cast<
+      const PatriciaTreeLeaf< Key, Value, HashConsed > >(tree);
+}
+
+template < typename Key, typename Value, bool HashConsed >
+inline BranchPtr< Key, Value, HashConsed > as_branch(
+    const TreePtr< Key, Value, HashConsed >& tree) {
+  return static_node_ptr_cast<
+      const PatriciaTreeNode< Key, Value, HashConsed > >(tree);
+}
+
+template < typename Key, typename Value, bool HashConsed >
+inline bool empty(const TreePtr< Key, Value, HashConsed >& tree) {
   return tree == nullptr;
 }
 
-template < typename Key, typename Value >
-inline std::size_t size(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree) {
+template < typename Key, typename Value, bool HashConsed >
+inline std::size_t size(const TreePtr< Key, Value, HashConsed >& tree) {
   if (tree != nullptr) {
     return tree->size();
   } else {
@@ -505,23 +666,21 @@ inline std::size_t size(
 }
 
 /// \brief Return the leaf associated with the given key, or nullptr
-template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTreeLeaf< Key, Value > > find_leaf(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+template < typename Key, typename Value, bool HashConsed >
+inline LeafPtr< Key, Value, HashConsed > find_leaf(
+    const TreePtr< Key, Value, HashConsed >& tree,
     const Key& key) {
   if (tree == nullptr) {
     return nullptr;
   }
   if (tree->is_leaf()) {
-    auto leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
+    auto leaf = as_leaf(tree);
     if (leaf->key() != key) {
       return nullptr;
     }
     return leaf;
   }
-  auto node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(tree);
+  auto node = as_branch(tree);
   if (is_zero_bit(IndexableTraits< Key >::index(key), node->branching_bit())) {
     return find_leaf(node->left_tree(), key);
   } else {
@@ -529,9 +688,9 @@ inline std::shared_ptr< const PatriciaTreeLeaf< Key, Value > > find_leaf(
   }
 }
 
-template < typename Key, typename Value >
+template < typename Key, typename Value, bool HashConsed >
 inline boost::optional< const Value& > find_value(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+    const TreePtr< Key, Value, HashConsed >& tree,
     const Key& key) {
   auto leaf = find_leaf(tree, key);
   if (leaf == nullptr) {
@@ -541,9 +700,12 @@ inline boost::optional< const Value& > find_value(
   }
 }
 
-template < typename Key, typename Value, typename Compare >
-inline bool leq(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-                const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename Compare >
+inline bool leq(const TreePtr< Key, Value, HashConsed >& s,
+                const TreePtr< Key, Value, HashConsed >& t,
                 const Compare& cmp) {
   if (s == t) {
     return true;
@@ -558,16 +720,13 @@ inline bool leq(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
     if (t->is_node()) {
       return false;
     }
-    auto s_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(s);
-    auto t_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    auto s_leaf = as_leaf(s);
+    auto t_leaf = as_leaf(t);
     return s_leaf->key() == t_leaf->key() &&
            cmp(s_leaf->value(), t_leaf->value());
   }
   if (t->is_leaf()) {
-    auto t_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    auto t_leaf = as_leaf(t);
     auto s_value = find_value(s, t_leaf->key());
     if (s_value) {
       return cmp(*s_value, t_leaf->value());
@@ -575,10 +734,8 @@ inline bool leq(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
       return false;
     }
   }
-  auto s_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(s);
-  auto t_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(t);
+  auto s_node = as_branch(s);
+  auto t_node = as_branch(t);
   if (s_node->size() < t_node->size()) {
     return false;
   }
@@ -600,13 +757,20 @@ inline bool leq(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
   return false; // t contains bindings that are not in s
 }
 
-template < typename Key, typename Value, typename Compare >
-inline bool equals(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-                   const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename Compare >
+inline bool equals(const TreePtr< Key, Value, HashConsed >& s,
+                   const TreePtr< Key, Value, HashConsed >& t,
                    const Compare& cmp) {
   if (s == t) {
     return true;
   }
+  if (HashConsed) {
+    // Equal hash-consed trees are physically equal
+    return false;
+  }
   if (s == nullptr || t == nullptr) {
     return false;
   }
@@ -614,20 +778,16 @@ inline bool equals(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
     if (t->is_node()) {
       return false;
     }
-    auto s_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(s);
-    auto t_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    auto s_leaf = as_leaf(s);
+    auto t_leaf = as_leaf(t);
     return s_leaf->key() == t_leaf->key() &&
            cmp(s_leaf->value(), t_leaf->value());
   }
   if (t->is_leaf()) {
     return false;
   }
-  auto s_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(s);
-  auto t_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(t);
+  auto s_node = as_branch(s);
+  auto t_node = as_branch(t);
   return s_node->size() == t_node->size() &&
          s_node->prefix() == t_node->prefix() &&
          s_node->branching_bit() == t_node->branching_bit() &&
@@ -638,72 +798,69 @@ inline bool equals(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
 /// \brief Create a node
 ///
 /// Prevent the creation of a node with only one child.
-template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > make_node(
+template < typename Key, typename Value, bool HashConsed >
+inline TreePtr< Key, Value, HashConsed > make_node(
     Index prefix,
     Index branching_bit,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& left_tree,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& right_tree) {
+    const TreePtr< Key, Value, HashConsed >& left_tree,
+    const TreePtr< Key, Value, HashConsed >& right_tree) {
   if (left_tree == nullptr) {
     return right_tree;
   }
   if (right_tree == nullptr) {
     return left_tree;
   }
-  return std::make_shared< const PatriciaTreeNode< Key, Value > >(prefix,
-                                                                  branching_bit,
-                                                                  left_tree,
-                                                                  right_tree);
+  return TreeFactory< Key, Value, HashConsed >::node(prefix,
+                                                     branching_bit,
+                                                     left_tree,
+                                                     right_tree);
 }
 
 /// \brief Join non-null patricia trees
-template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTreeNode< Key, Value > > join_trees(
+template < typename Key, typename Value, bool HashConsed >
+inline BranchPtr< Key, Value, HashConsed > join_trees(
     Index prefix_s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
+    const TreePtr< Key, Value, HashConsed >& s,
     Index prefix_t,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t) {
+    const TreePtr< Key, Value, HashConsed >& t) {
   ikos_assert(s != nullptr && t != nullptr);
 
   Index m = branching_bit(prefix_s, prefix_t);
 
   if (is_zero_bit(prefix_s, m)) {
-    return std::make_shared<
-        const PatriciaTreeNode< Key, Value > >(mask(prefix_s, m), m, s, t);
+    return TreeFactory< Key, Value, HashConsed >::node(
+        mask(prefix_s, m), m, s, t);
   } else {
-    return std::make_shared<
-        const PatriciaTreeNode< Key, Value > >(mask(prefix_s, m), m, t, s);
+    return TreeFactory< Key, Value, HashConsed >::node(
+        mask(prefix_s, m), m, t, s);
   }
 }
 
-template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > insert_or_assign(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+template < typename Key, typename Value, bool HashConsed >
+inline TreePtr< Key, Value, HashConsed > insert_or_assign(
+    const TreePtr< Key, Value, HashConsed >& tree,
     const Key& key,
     const Value& value) {
   if (tree == nullptr) {
-    return std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key, value);
+    return TreeFactory< Key, Value, HashConsed >::leaf(key, value);
   }
   if (tree->is_leaf()) {
-    auto leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
+    auto leaf = as_leaf(tree);
     if (leaf->key() == key) {
       if (leaf->value() == value) {
         return tree;
       } else {
-        return std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key,
-                                                                        value);
+        return TreeFactory< Key, Value, HashConsed >::leaf(key, value);
       }
     }
-    auto new_leaf =
-        std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key, value);
-    return join_trees< Key, Value >(IndexableTraits< Key >::index(key),
-                                    new_leaf,
-                                    IndexableTraits< Key >::index(leaf->key()),
-                                    leaf);
-  }
-  auto node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(tree);
+    auto new_leaf = TreeFactory< Key, Value, HashConsed >::leaf(key, value);
+    return join_trees< Key, Value, HashConsed >(
+        IndexableTraits< Key >::index(key),
+        new_leaf,
+        IndexableTraits< Key >::index(leaf->key()),
+        leaf);
+  }
+  auto node = as_branch(tree);
   if (match_prefix(IndexableTraits< Key >::index(key),
                    node->prefix(),
                    node->branching_bit())) {
@@ -728,47 +885,47 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > insert_or_assign(
                        new_right_tree);
     }
   }
-  auto new_leaf =
-      std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key, value);
-  return join_trees< Key, Value >(IndexableTraits< Key >::index(key),
-                                  new_leaf,
-                                  node->prefix(),
-                                  node);
+  auto new_leaf = TreeFactory< Key, Value, HashConsed >::leaf(key, value);
+  return join_trees< Key, Value, HashConsed >(
+      IndexableTraits< Key >::index(key),
+      new_leaf,
+      node->prefix(),
+      node);
 }
 
-template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_insert(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename CombiningFunction >
+inline TreePtr< Key, Value, HashConsed > update_or_insert(
+    const TreePtr< Key, Value, HashConsed >& tree,
     const CombiningFunction& combine,
     const Key& key,
     const Value& value) {
   if (tree == nullptr) {
-    return std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key, value);
+    return TreeFactory< Key, Value, HashConsed >::leaf(key, value);
   }
   if (tree->is_leaf()) {
-    auto leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
+    auto leaf = as_leaf(tree);
     if (leaf->key() == key) {
       boost::optional< Value > new_value = combine(leaf->value(), value);
       if (new_value) {
         if (leaf->value() == *new_value) {
           return tree;
         } else {
-          return std::make_shared<
-              const PatriciaTreeLeaf< Key, Value > >(key, *new_value);
+          return TreeFactory< Key, Value, HashConsed >::leaf(key, *new_value);
         }
       }
       return nullptr;
     }
-    auto new_leaf =
-        std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key, value);
-    return join_trees< Key, Value >(IndexableTraits< Key >::index(key),
-                                    new_leaf,
-                                    IndexableTraits< Key >::index(leaf->key()),
-                                    leaf);
-  }
-  auto node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(tree);
+    auto new_leaf = TreeFactory< Key, Value, HashConsed >::leaf(key, value);
+    return join_trees< Key, Value, HashConsed >(
+        IndexableTraits< Key >::index(key),
+        new_leaf,
+        IndexableTraits< Key >::index(leaf->key()),
+        leaf);
+  }
+  auto node = as_branch(tree);
   if (match_prefix(IndexableTraits< Key >::index(key),
                    node->prefix(),
                    node->branching_bit())) {
@@ -795,17 +952,20 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_insert(
                        new_right_tree);
     }
   }
-  auto new_leaf =
-      std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key, value);
-  return join_trees< Key, Value >(IndexableTraits< Key >::index(key),
-                                  new_leaf,
-                                  node->prefix(),
-                                  node);
+  auto new_leaf = TreeFactory< Key, Value, HashConsed >::leaf(key, value);
+  return join_trees< Key, Value, HashConsed >(
+      IndexableTraits< Key >::index(key),
+      new_leaf,
+      node->prefix(),
+      node);
 }
 
-template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_ignore(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename CombiningFunction >
+inline TreePtr< Key, Value, HashConsed > update_or_ignore(
+    const TreePtr< Key, Value, HashConsed >& tree,
     const CombiningFunction& combine,
     const Key& key,
     const Value& value) {
@@ -813,24 +973,21 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_ignore(
     return nullptr;
   }
   if (tree->is_leaf()) {
-    auto leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
+    auto leaf = as_leaf(tree);
     if (leaf->key() == key) {
       boost::optional< Value > new_value = combine(leaf->value(), value);
       if (new_value) {
         if (leaf->value() == *new_value) {
           return tree;
         } else {
-          return std::make_shared<
-              const PatriciaTreeLeaf< Key, Value > >(key, *new_value);
+          return TreeFactory< Key, Value, HashConsed >::leaf(key, *new_value);
         }
       }
       return nullptr;
     }
     return tree;
   }
-  auto node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(tree);
+  auto node = as_branch(tree);
   if (match_prefix(IndexableTraits< Key >::index(key),
                    node->prefix(),
                    node->branching_bit())) {
@@ -861,11 +1018,14 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_ignore(
 }
 
 /// \brief Update or insert an existing leaf `t_leaf` in a tree `s`
-template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > >
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename CombiningFunction >
+inline TreePtr< Key, Value, HashConsed >
 update_or_insert_leaf(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTreeLeaf< Key, Value > >& t_leaf,
+    const TreePtr< Key, Value, HashConsed >& s,
+    const LeafPtr< Key, Value, HashConsed >& t_leaf,
     const CombiningFunction& combine) {
   if (s == t_leaf) {
     return s;
@@ -874,8 +1034,7 @@ update_or_insert_leaf(
     return t_leaf;
   }
   if (s->is_leaf()) {
-    auto s_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(s);
+    auto s_leaf = as_leaf(s);
     if (s_leaf->key() == t_leaf->key()) {
       boost::optional< Value > new_value =
           combine(s_leaf->value(), t_leaf->value());
@@ -885,21 +1044,19 @@ update_or_insert_leaf(
         } else if (t_leaf->value() == *new_value) {
           return t_leaf;
         } else {
-          return std::make_shared<
-              const PatriciaTreeLeaf< Key, Value > >(s_leaf->key(), *new_value);
+          return TreeFactory< Key, Value, HashConsed >::leaf(
+              s_leaf->key(), *new_value);
         }
       }
       return nullptr;
     }
-    return join_trees< Key, Value >(IndexableTraits< Key >::index(
-                                        s_leaf->key()),
-                                    s_leaf,
-                                    IndexableTraits< Key >::index(
-                                        t_leaf->key()),
-                                    t_leaf);
-  }
-  auto s_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(s);
+    return join_trees< Key, Value, HashConsed >(
+        IndexableTraits< Key >::index( s_leaf->key()),
+        s_leaf,
+        IndexableTraits< Key >::index( t_leaf->key()),
+        t_leaf);
+  }
+  auto s_node = as_branch(s);
   if (match_prefix(IndexableTraits< Key >::index(t_leaf->key()),
                    s_node->prefix(),
                    s_node->branching_bit())) {
@@ -926,30 +1083,29 @@ update_or_insert_leaf(
                        new_right_tree);
     }
   }
-  return join_trees< Key, Value >(s_node->prefix(),
-                                  s_node,
-                                  IndexableTraits< Key >::index(t_leaf->key()),
-                                  t_leaf);
+  return join_trees< Key, Value, HashConsed >(
+      s_node->prefix(),
+      s_node,
+      IndexableTraits< Key >::index(t_leaf->key()),
+      t_leaf);
 }
 
-template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > erase(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+template < typename Key, typename Value, bool HashConsed >
+inline TreePtr< Key, Value, HashConsed > erase(
+    const TreePtr< Key, Value, HashConsed >& tree,
     const Key& key) {
   if (tree == nullptr) {
     return nullptr;
   }
   if (tree->is_leaf()) {
-    auto leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
+    auto leaf = as_leaf(tree);
     if (leaf->key() == key) {
       return nullptr;
     } else {
       return tree;
     }
   }
-  auto node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(tree);
+  auto node = as_branch(tree);
   if (match_prefix(IndexableTraits< Key >::index(key),
                    node->prefix(),
                    node->branching_bit())) {
@@ -977,29 +1133,30 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > erase(
   return tree;
 }
 
-template < typename Key, typename Value, typename UnaryOp >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > transform(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename UnaryOp >
+inline TreePtr< Key, Value, HashConsed > transform(
+    const TreePtr< Key, Value, HashConsed >& tree,
     const UnaryOp& op) {
   if (tree == nullptr) {
     return nullptr;
   }
   if (tree->is_leaf()) {
-    auto leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
+    auto leaf = as_leaf(tree);
     boost::optional< Value > new_value = op(leaf->key(), leaf->value());
     if (new_value) {
       if (leaf->value() == *new_value) {
         return tree;
       } else {
-        return std::make_shared<
-            const PatriciaTreeLeaf< Key, Value > >(leaf->key(), *new_value);
+        return TreeFactory< Key, Value, HashConsed >::leaf(
+            leaf->key(), *new_value);
       }
     }
     return nullptr;
   }
-  auto node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(tree);
+  auto node = as_branch(tree);
   auto new_left_tree = transform(node->left_tree(), op);
   auto new_right_tree = transform(node->right_tree(), op);
   if (node->left_tree() == new_left_tree &&
@@ -1013,10 +1170,13 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > transform(
   }
 }
 
-template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > join(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename CombiningFunction >
+inline TreePtr< Key, Value, HashConsed > join(
+    const TreePtr< Key, Value, HashConsed >& s,
+    const TreePtr< Key, Value, HashConsed >& t,
     const CombiningFunction& combine) {
   if (s == t) {
     return s;
@@ -1028,8 +1188,7 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > join(
     return s;
   }
   if (s->is_leaf()) {
-    auto s_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(s);
+    auto s_leaf = as_leaf(s);
     return update_or_insert_leaf(t,
                                  s_leaf,
                                  [=](const Value& t_value,
@@ -1039,14 +1198,11 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > join(
                                  });
   }
   if (t->is_leaf()) {
-    auto t_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    auto t_leaf = as_leaf(t);
     return update_or_insert_leaf(s, t_leaf, combine);
   }
-  auto s_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(s);
-  auto t_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(t);
+  auto s_node = as_branch(s);
+  auto t_node = as_branch(t);
   Index m = s_node->branching_bit();
   Index n = t_node->branching_bit();
   Index p = s_node->prefix();
@@ -1099,10 +1255,13 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > join(
   return join_trees(p, s, q, t);
 }
 
-template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > intersect(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename CombiningFunction >
+inline TreePtr< Key, Value, HashConsed > intersect(
+    const TreePtr< Key, Value, HashConsed >& s,
+    const TreePtr< Key, Value, HashConsed >& t,
     const CombiningFunction& combine) {
   if (s == t) {
     return s;
@@ -1111,8 +1270,7 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > intersect(
     return nullptr;
   }
   if (s->is_leaf()) {
-    auto s_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(s);
+    auto s_leaf = as_leaf(s);
     auto t_leaf = find_leaf(t, s_leaf->key());
     if (t_leaf) {
       boost::optional< Value > new_value =
@@ -1123,16 +1281,15 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > intersect(
         } else if (t_leaf->value() == *new_value) {
           return std::move(t_leaf);
         } else {
-          return std::make_shared<
-              const PatriciaTreeLeaf< Key, Value > >(s_leaf->key(), *new_value);
+          return TreeFactory< Key, Value, HashConsed >::leaf(
+              s_leaf->key(), *new_value);
         }
       }
     }
     return nullptr;
   }
   if (t->is_leaf()) {
-    auto t_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    auto t_leaf = as_leaf(t);
     auto s_leaf = find_leaf(s, t_leaf->key());
     if (s_leaf) {
       boost::optional< Value > new_value =
@@ -1143,17 +1300,15 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > intersect(
         } else if (t_leaf->value() == *new_value) {
           return std::move(t_leaf);
         } else {
-          return std::make_shared<
-              const PatriciaTreeLeaf< Key, Value > >(t_leaf->key(), *new_value);
+          return TreeFactory< Key, Value, HashConsed >::leaf(
+              t_leaf->key(), *new_value);
         }
       }
     }
     return nullptr;
   }
-  auto s_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(s);
-  auto t_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(t);
+  auto s_node = as_branch(s);
+  auto t_node = as_branch(t);
   Index m = s_node->branching_bit();
   Index n = t_node->branching_bit();
   Index p = s_node->prefix();
@@ -1192,38 +1347,39 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > intersect(
   return nullptr;
 }
 
-template < typename Key, typename Value, typename BinaryOp >
+template < typename Key,
+           typename Value,
+           bool HashConsed,
+           typename BinaryOp >
 inline typename BinaryOp::ResultType binary_operation(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+    const TreePtr< Key, Value, HashConsed >& s,
+    const TreePtr< Key, Value, HashConsed >& t,
     const BinaryOp& op) {
+  using PatriciaTreeMapT = PatriciaTreeMap< Key, Value, HashConsed >;
+
   if (op.has_equals() && s == t) {
-    return op.equals(PatriciaTreeMap< Key, Value >(s));
+    return op.equals(PatriciaTreeMapT(s));
   }
   if (s == nullptr) {
-    return op.right(PatriciaTreeMap< Key, Value >(t));
+    return op.right(PatriciaTreeMapT(t));
   }
   if (t == nullptr) {
-    return op.left(PatriciaTreeMap< Key, Value >(s));
+    return op.left(PatriciaTreeMapT(s));
   }
   if (s->is_leaf()) {
-    auto s_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(s);
-    return op.right_with_left_leaf(PatriciaTreeMap< Key, Value >(t),
+    auto s_leaf = as_leaf(s);
+    return op.right_with_left_leaf(PatriciaTreeMapT(t),
                                    s_leaf->key(),
                                    s_leaf->value());
   }
   if (t->is_leaf()) {
-    auto t_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
-    return op.left_with_right_leaf(PatriciaTreeMap< Key, Value >(s),
+    auto t_leaf = as_leaf(t);
+    return op.left_with_right_leaf(PatriciaTreeMapT(s),
                                    t_leaf->key(),
                                    t_leaf->value());
   }
-  auto s_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(s);
-  auto t_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(t);
+  auto s_node = as_branch(s);
+  auto t_node = as_branch(t);
   Index m = s_node->branching_bit();
   Index n = t_node->branching_bit();
   Index p = s_node->prefix();
@@ -1240,32 +1396,27 @@ inline typename BinaryOp::ResultType binary_operation(
   if (m < n && match_prefix(q, p, m)) {
     // q contains p, join t with a subtree of s
     if (is_zero_bit(q, m)) {
-      return op.merge(op.left(
-                          PatriciaTreeMap< Key, Value >(s_node->right_tree())),
+      return op.merge(op.left(PatriciaTreeMapT(s_node->right_tree())),
                       binary_operation(s_node->left_tree(), t, op));
     } else {
-      return op.merge(op.left(
-                          PatriciaTreeMap< Key, Value >(s_node->left_tree())),
+      return op.merge(op.left(PatriciaTreeMapT(s_node->left_tree())),
                       binary_operation(s_node->right_tree(), t, op));
     }
   }
   if (m > n && match_prefix(p, q, n)) {
     // p contains q. Merge s with a subtree of t.
     if (is_zero_bit(p, n)) {
-      return op.merge(op.right(
-                          PatriciaTreeMap< Key, Value >(t_node->right_tree())),
+      return op.merge(op.right(PatriciaTreeMapT(t_node->right_tree())),
                       binary_operation(s, t_node->left_tree(), op));
     } else {
-      return op.merge(op.right(
-                          PatriciaTreeMap< Key, Value >(t_node->left_tree())),
+      return op.merge(op.right(PatriciaTreeMapT(t_node->left_tree())),
                       binary_operation(s, t_node->right_tree(), op));
     }
   }
-  return op.merge(op.left(PatriciaTreeMap< Key, Value >(s)),
-                  op.right(PatriciaTreeMap< Key, Value >(t)));
+  return op.merge(op.left(PatriciaTreeMapT(s)), op.right(PatriciaTreeMapT(t)));
 }
 
-template < typename Key, typename Value >
+template < typename Key, typename Value, bool HashConsed >
 class PatriciaTreeIterator final {
 public:
   // Required types for iterators
@@ -1276,16 +1427,15 @@ public:
   using reference = const std::pair< Key, Value >&;
 
 private:
-  std::shared_ptr< const PatriciaTreeLeaf< Key, Value > > _leaf;
-  std::stack< std::shared_ptr< const PatriciaTreeNode< Key, Value > > > _stack;
+  LeafPtr< Key, Value, HashConsed > _leaf;
+  std::stack< BranchPtr< Key, Value, HashConsed > > _stack;
 
 public:
   /// \brief Create an end iterator
   PatriciaTreeIterator() = default;
 
   /// \brief Create an iterator on the given patricia tree
-  explicit PatriciaTreeIterator(
-      const std::shared_ptr< const PatriciaTree< Key, Value > >& tree) {
+  explicit PatriciaTreeIterator(const TreePtr< Key, Value, HashConsed >& tree) {
     if (tree != nullptr) {
       this->look_for_next_leaf(tree);
     }
@@ -1336,19 +1486,16 @@ public:
 
 private:
   /// \brief Find the leftmost leaf, store all intermediate nodes
-  void look_for_next_leaf(
-      const std::shared_ptr< const PatriciaTree< Key, Value > >& tree) {
+  void look_for_next_leaf(const TreePtr< Key, Value, HashConsed >& tree) {
     auto t = tree;
     ikos_assert(t != nullptr);
     while (t->is_node()) {
-      auto node =
-          std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(t);
+      auto node = as_branch(t);
       this->_stack.push(node);
       t = node->left_tree();
       ikos_assert(t != nullptr); // a node always has two children
     }
-    this->_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    this->_leaf = as_leaf(t);
   }
 
 }; // end class PatriciaTreeIterator
@@ -0,0 +1,753 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Reference counted nodes for patricia trees
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace ikos {
+namespace core {
+namespace patricia_tree_utils {
+
+/// \brief Counters of node allocations
+struct NodeAllocationStats {
+  /// \brief Number of allocated nodes
+  std::size_t allocations;
+
+  /// \brief Number of allocations served by the free lists of the pool
+  std::size_t reused;
+
+  /// \brief Number of deallocated nodes
+  std::size_t deallocations;
+
+  /// \brief Number of allocated bytes
+  std::size_t bytes;
+
+  /// \brief Add the given counters
+  NodeAllocationStats& operator+=(const NodeAllocationStats& other) {
+    this->allocations += other.allocations;
+    this->reused += other.reused;
+    this->deallocations += other.deallocations;
+    this->bytes += other.bytes;
+    return *this;
+  }
+
+  /// \brief Return the difference with the given counters
+  NodeAllocationStats operator-(const NodeAllocationStats& other) const {
+    return NodeAllocationStats{this->allocations - other.allocations,
+                               this->reused - other.reused,
+                               this->deallocations - other.deallocations,
+                               this->bytes - other.bytes};
+  }
+
+  /// \brief Dump the counters, for debugging purpose
+  void dump(std::ostream& o) const {
+    o << "allocations=" << this->allocations << ", reused=" << this->reused
+      << ", deallocations=" << this->deallocations
+      << ", bytes=" << this->bytes;
+  }
+
+}; // end struct NodeAllocationStats
+
+class NodeAllocationScope;
+
+/// \brief Pool of memory blocks for the nodes of patricia trees
+///
+/// Freed blocks are kept in a per-thread free list for each size class, and
+/// reused by the next allocations of the same size class. Blocks freed by a
+/// thread that already exited, or exceeding the cache size, are directly
+/// returned to the system allocator.
+///
+/// If the macro IKOS_DISABLE_NODE_POOL is defined, all allocations go through
+/// the system allocator. This is useful with memory sanitizers.
+///
+/// Allocations are counted per thread, see stats() and NodeAllocationScope.
+class NodePool {
+private:
+  /// \brief Size of a size class, in bytes
+  static const std::size_t Granularity = 16;
+
+  /// \brief Number of size classes
+  ///
+  /// Blocks larger than `Granularity * NumSizeClasses` are not pooled.
+  static const std::size_t NumSizeClasses = 16;
+
+  /// \brief Maximum number of cached blocks per size class, per thread
+  static const std::size_t MaxCachedBlocks = 4096;
+
+  /// \brief Free memory block
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  /// \brief Free list of a size class
+  struct FreeList {
+    FreeBlock* head;
+    std::size_t size;
+  };
+
+  /// \brief Per-thread state of the pool
+  ///
+  /// This is trivially destructible, so that it remains usable while other
+  /// thread local objects are destroyed.
+  struct State {
+    FreeList lists[NumSizeClasses];
+    bool released;
+    NodeAllocationStats stats;
+    NodeAllocationStats* scope;
+  };
+
+  /// \brief Releases the cached blocks on thread exit
+  struct Releaser {
+    /// \brief Constructor
+    Releaser() = default;
+
+    /// \brief No copy constructor
+    Releaser(const Releaser&) = delete;
+
+    /// \brief No move constructor
+    Releaser(Releaser&&) = delete;
+
+    /// \brief No copy assignment operator
+    Releaser& operator=(const Releaser&) = delete;
+
+    /// \brief No move assignment operator
+    Releaser& operator=(Releaser&&) = delete;
+
+    /// \brief Destructor
+    ~Releaser() {
+      State& state = NodePool::state();
+      for (FreeList& list : state.lists) {
+        while (list.head != nullptr) {
+          FreeBlock* block = list.head;
+          list.head = block->next;
+          ::operator delete(block);
+        }
+        list.size = 0;
+      }
+      state.released = true;
+    }
+  };
+
+private:
+  /// \brief Return the state of the pool for the current thread
+  static State& state() {
+    static thread_local State state; // zero-initialized
+    return state;
+  }
+
+  /// \brief Register the release of the cached blocks on thread exit
+  static void register_releaser() {
+    static thread_local Releaser releaser;
+    static_cast< void >(releaser);
+  }
+
+  /// \brief Return the size class of a block of the given size
+  static std::size_t size_class(std::size_t size) {
+    return (size + Granularity - 1) / Granularity - 1;
+  }
+
+  /// \brief Count an allocation in the current thread and scope
+  static void count_allocation(State& state, std::size_t size, bool reused) {
+    NodeAllocationStats stats{1, reused ? 1U : 0U, 0, size};
+    state.stats += stats;
+    if (state.scope != nullptr) {
+      *state.scope += stats;
+    }
+  }
+
+  /// \brief Count a deallocation in the current thread and scope
+  static void count_deallocation(State& state) {
+    state.stats.deallocations++;
+    if (state.scope != nullptr) {
+      state.scope->deallocations++;
+    }
+  }
+
+public:
+  /// \brief Allocate a memory block of the given size
+  static void* allocate(std::size_t size) {
+    State& state = NodePool::state();
+#ifdef IKOS_DISABLE_NODE_POOL
+    count_allocation(state, size, false);
+    return ::operator new(size);
+#else
+    std::size_t c = size_class(size);
+    if (c >= NumSizeClasses) {
+      count_allocation(state, size, false);
+      return ::operator new(size);
+    }
+    FreeList& list = state.lists[c];
+    if (list.head != nullptr) {
+      count_allocation(state, size, true);
+      FreeBlock* block = list.head;
+      list.head = block->next;
+      list.size--;
+      return block;
+    }
+    count_allocation(state, size, false);
+    return ::operator new((c + 1) * Granularity);
+#endif
+  }
+
+  /// \brief Deallocate a memory block of the given size
+  static void deallocate(void* ptr, std::size_t size) {
+    State& state = NodePool::state();
+    count_deallocation(state);
+#ifdef IKOS_DISABLE_NODE_POOL
+    static_cast< void >(size);
+    ::operator delete(ptr);
+#else
+    std::size_t c = size_class(size);
+    if (c >= NumSizeClasses) {
+      ::operator delete(ptr);
+      return;
+    }
+    FreeList& list = state.lists[c];
+    if (state.released || list.size >= MaxCachedBlocks) {
+      ::operator delete(ptr);
+      return;
+    }
+    register_releaser();
+    auto block = static_cast< FreeBlock* >(ptr);
+    block->next = list.head;
+    list.head = block;
+    list.size++;
+#endif
+  }
+
+  /// \brief Return the node allocation counters of the current thread
+  static const NodeAllocationStats& stats() { return state().stats; }
+
+  friend class NodeAllocationScope;
+
+}; // end class NodePool
+
+/// \brief Node allocation counters, per owner
+///
+/// Owners are arbitrary names, e.g, the names of the abstract domains. The
+/// profile is filled by NodeAllocationScope and is never destroyed, so that
+/// scopes can be closed during the destruction of static objects.
+class NodeAllocationProfile {
+private:
+  std::mutex _mutex;
+  std::map< std::string, NodeAllocationStats > _owners;
+
+private:
+  /// \brief Constructor
+  NodeAllocationProfile() = default;
+
+public:
+  /// \brief No copy constructor
+  NodeAllocationProfile(const NodeAllocationProfile&) = delete;
+
+  /// \brief No move constructor
+  NodeAllocationProfile(NodeAllocationProfile&&) = delete;
+
+  /// \brief No copy assignment operator
+  NodeAllocationProfile& operator=(const NodeAllocationProfile&) = delete;
+
+  /// \brief No move assignment operator
+  NodeAllocationProfile& operator=(NodeAllocationProfile&&) = delete;
+
+  /// \brief Destructor
+  ~NodeAllocationProfile() = delete;
+
+  /// \brief Return the global profile
+  static NodeAllocationProfile& get() {
+    static auto profile = new NodeAllocationProfile();
+    return *profile;
+  }
+
+  /// \brief Add counters to the given owner
+  void add(const std::string& owner, const NodeAllocationStats& stats) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    this->_owners[owner] += stats;
+  }
+
+  /// \brief Return the counters of all owners
+  std::map< std::string, NodeAllocationStats > owners() {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    return this->_owners;
+  }
+
+  /// \brief Reset all counters
+  void clear() {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    this->_owners.clear();
+  }
+
+  /// \brief Dump the profile, one owner per line
+  void dump(std::ostream& o) {
+    for (const auto& owner : this->owners()) {
+      o << owner.first << ": ";
+      owner.second.dump(o);
+      o << "\n";
+    }
+  }
+
+}; // end class NodeAllocationProfile
+
+/// \brief Attribute the node allocations of the current thread to an owner
+/// until the end of the scope
+///
+/// Scopes can be nested: the allocations of an inner scope are also
+/// attributed to the outer scopes. When closed, the counters are added to the
+/// NodeAllocationProfile.
+class NodeAllocationScope {
+private:
+  std::string _owner;
+  NodeAllocationStats _stats;
+  NodeAllocationStats* _parent;
+
+public:
+  /// \brief Constructor
+  explicit NodeAllocationScope(std::string owner)
+      : _owner(std::move(owner)),
+        _stats{0, 0, 0, 0},
+        _parent(NodePool::state().scope) {
+    NodePool::state().scope = &this->_stats;
+  }
+
+  /// \brief No copy constructor
+  NodeAllocationScope(const NodeAllocationScope&) = delete;
+
+  /// \brief No move constructor
+  NodeAllocationScope(NodeAllocationScope&&) = delete;
+
+  /// \brief No copy assignment operator
+  NodeAllocationScope& operator=(const NodeAllocationScope&) = delete;
+
+  /// \brief No move assignment operator
+  NodeAllocationScope& operator=(NodeAllocationScope&&) = delete;
+
+  /// \brief Destructor
+  ~NodeAllocationScope() {
+    NodePool::state().scope = this->_parent;
+    if (this->_parent != nullptr) {
+      *this->_parent += this->_stats;
+    }
+    NodeAllocationProfile::get().add(this->_owner, this->_stats);
+  }
+
+  /// \brief Return the counters of the scope so far
+  const NodeAllocationStats& stats() const { return this->_stats; }
+
+}; // end class NodeAllocationScope
+
+/// \brief Non-atomic reference counter
+///
+/// Nodes must not be shared between threads.
+struct NonAtomicRefCount {
+  /// \brief Counter type
+  using Counter = std::size_t;
+
+  /// \brief Whether nodes can be shared between threads
+  static constexpr bool ThreadSafe = false;
+
+  /// \brief Increment the counter
+  static void acquire(Counter& count) { ++count; }
+
+  /// \brief Decrement the counter, return true if it reached 0
+  static bool release(Counter& count) { return --count == 0; }
+
+  /// \brief Increment the counter, unless it is 0
+  static bool try_acquire(Counter& count) {
+    if (count == 0) {
+      return false;
+    }
+    ++count;
+    return true;
+  }
+};
+
+/// \brief Atomic reference counter
+///
+/// Nodes are immutable, so a tree can be shared between threads once it is
+/// published, e.g through a mutex or a task queue, without a deep copy.
+struct AtomicRefCount {
+  /// \brief Counter type
+  using Counter = std::atomic< std::size_t >;
+
+  /// \brief Whether nodes can be shared between threads
+  static constexpr bool ThreadSafe = true;
+
+  /// \brief Increment the counter
+  static void acquire(Counter& count) {
+    count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// \brief Decrement the counter, return true if it reached 0
+  ///
+  /// The release ordering makes the writes on the node visible to the thread
+  /// destroying it.
+  static bool release(Counter& count) {
+    return count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+  }
+
+  /// \brief Increment the counter, unless it is 0
+  static bool try_acquire(Counter& count) {
+    std::size_t n = count.load(std::memory_order_relaxed);
+    while (n != 0) {
+      if (count.compare_exchange_weak(n, n + 1, std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+/// \brief Reference counter of the nodes of patricia trees
+///
+/// The reference counter is atomic, unless the macro IKOS_SINGLE_THREADED is
+/// defined.
+#ifdef IKOS_SINGLE_THREADED
+using DefaultRefCount = NonAtomicRefCount;
+#else
+using DefaultRefCount = AtomicRefCount;
+#endif
+
+/// \brief Base class for reference counted nodes
+///
+/// Nodes hold an intrusive reference counter and are allocated in the
+/// NodePool. RefCount is either NonAtomicRefCount or AtomicRefCount.
+template < typename RefCount >
+class BasicRefCountedNode {
+public:
+  /// \brief Reference counter policy
+  using RefCountPolicy = RefCount;
+
+private:
+  mutable typename RefCount::Counter _ref_count;
+
+protected:
+  /// \brief Constructor
+  BasicRefCountedNode() : _ref_count(0) {}
+
+public:
+  /// \brief No copy constructor
+  BasicRefCountedNode(const BasicRefCountedNode&) = delete;
+
+  /// \brief No move constructor
+  BasicRefCountedNode(BasicRefCountedNode&&) = delete;
+
+  /// \brief No copy assignment operator
+  BasicRefCountedNode& operator=(const BasicRefCountedNode&) = delete;
+
+  /// \brief No move assignment operator
+  BasicRefCountedNode& operator=(BasicRefCountedNode&&) = delete;
+
+  /// \brief Destructor
+  virtual ~BasicRefCountedNode() = default;
+
+  /// \brief Allocate a node in the pool
+  static void* operator new(std::size_t size) {
+    return NodePool::allocate(size);
+  }
+
+  /// \brief Deallocate a node from the pool
+  static void operator delete(void* ptr, std::size_t size) {
+    NodePool::deallocate(ptr, size);
+  }
+
+private:
+  /// \brief Increment the reference counter
+  void acquire() const { RefCount::acquire(this->_ref_count); }
+
+  /// \brief Decrement the reference counter, return true if it reached 0
+  bool release() const { return RefCount::release(this->_ref_count); }
+
+  /// \brief Increment the reference counter, unless it is 0
+  bool try_acquire() const { return RefCount::try_acquire(this->_ref_count); }
+
+  template < typename T >
+  friend class NodePtr;
+
+  template < typename T >
+  friend class HashConsingTable;
+
+}; // end class BasicRefCountedNode
+
+/// \brief Base class for the nodes of patricia trees
+using RefCountedNode = BasicRefCountedNode< DefaultRefCount >;
+
+/// \brief Intrusive smart pointer on a node of a patricia tree
+///
+/// This provides the subset of the std::shared_ptr interface used by patricia
+/// trees, without the separate control block.
+template < typename T >
+class NodePtr {
+private:
+  T* _ptr;
+
+private:
+  struct AdoptTag {};
+
+  /// \brief Adopt a reference already taken on the given node
+  NodePtr(T* ptr, AdoptTag) noexcept : _ptr(ptr) {}
+
+public:
+  /// \brief Create a null pointer
+  NodePtr() noexcept : _ptr(nullptr) {}
+
+  /// \brief Create a null pointer
+  NodePtr(std::nullptr_t) noexcept : _ptr(nullptr) {}
+
+  /// \brief Take a new reference on the given node
+  explicit NodePtr(T* ptr) noexcept : _ptr(ptr) { this->acquire(); }
+
+  /// \brief Copy constructor
+  NodePtr(const NodePtr& other) noexcept : _ptr(other._ptr) {
+    this->acquire();
+  }
+
+  /// \brief Move constructor
+  NodePtr(NodePtr&& other) noexcept : _ptr(other._ptr) {
+    other._ptr = nullptr;
+  }
+
+  /// \brief Copy constructor from a pointer on a derived node
+  template <
+      typename U,
+      typename = std::enable_if_t< std::is_convertible< U*, T* >::value > >
+  NodePtr(const NodePtr< U >& other) noexcept : _ptr(other._ptr) {
+    this->acquire();
+  }
+
+  /// \brief Move constructor from a pointer on a derived node
+  template <
+      typename U,
+      typename = std::enable_if_t< std::is_convertible< U*, T* >::value > >
+  NodePtr(NodePtr< U >&& other) noexcept : _ptr(other._ptr) {
+    other._ptr = nullptr;
+  }
+
+  /// \brief Copy assignment operator
+  NodePtr& operator=(const NodePtr& other) noexcept {
+    NodePtr(other).swap(*this);
+    return *this;
+  }
+
+  /// \brief Move assignment operator
+  NodePtr& operator=(NodePtr&& other) noexcept {
+    NodePtr(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /// \brief Destructor
+  ~NodePtr() { this->release(); }
+
+  /// \brief Return the raw pointer
+  T* get() const noexcept { return this->_ptr; }
+
+  /// \brief Dereference the pointer
+  T& operator*() const noexcept { return *this->_ptr; }
+
+  /// \brief Dereference the pointer
+  T* operator->() const noexcept { return this->_ptr; }
+
+  /// \brief Return true if the pointer is not null
+  explicit operator bool() const noexcept { return this->_ptr != nullptr; }
+
+  /// \brief Release the reference on the node, if any
+  void reset() noexcept { NodePtr().swap(*this); }
+
+  /// \brief Swap with the given pointer
+  void swap(NodePtr& other) noexcept { std::swap(this->_ptr, other._ptr); }
+
+private:
+  /// \brief Take a reference on the node, if any
+  void acquire() const noexcept {
+    if (this->_ptr != nullptr) {
+      this->_ptr->acquire();
+    }
+  }
+
+  /// \brief Release the reference on the node, if any
+  void release() const noexcept {
+    if (this->_ptr != nullptr && this->_ptr->release()) {
+      delete this->_ptr;
+    }
+  }
+
+  template < typename U >
+  friend class NodePtr;
+
+  template < typename U >
+  friend class HashConsingTable;
+
+}; // end class NodePtr
+
+/// \brief Allocate a node and return a pointer on it
+template < typename T, typename... Args >
+inline NodePtr< T > make_node_ptr(Args&&... args) {
+  return NodePtr< T >(new T(std::forward< Args >(args)...));
+}
+
+/// \brief Cast a pointer on a node into a pointer on a derived node
+template < typename T, typename U >
+inline NodePtr< T > static_node_ptr_cast(const NodePtr< U >& ptr) {
+  return NodePtr< T >(static_cast< T* >(ptr.get()));
+}
+
+template < typename T, typename U >
+inline bool operator==(const NodePtr< T >& a, const NodePtr< U >& b) {
+  return a.get() == b.get();
+}
+
+template < typename T, typename U >
+inline bool operator!=(const NodePtr< T >& a, const NodePtr< U >& b) {
+  return a.get() != b.get();
+}
+
+template < typename T >
+inline bool operator==(const NodePtr< T >& a, std::nullptr_t) {
+  return a.get() == nullptr;
+}
+
+template < typename T >
+inline bool operator==(std::nullptr_t, const NodePtr< T >& a) {
+  return a.get() == nullptr;
+}
+
+template < typename T >
+inline bool operator!=(const NodePtr< T >& a, std::nullptr_t) {
+  return a.get() != nullptr;
+}
+
+template < typename T >
+inline bool operator!=(std::nullptr_t, const NodePtr< T >& a) {
+  return a.get() != nullptr;
+}
+
+/// \brief Table of the hash-consed nodes of type T
+///
+/// Nodes are registered by their hash and must call erase() in their
+/// destructor. The table is never destroyed, so that nodes can still be
+/// released during the destruction of static objects.
+template < typename T >
+class HashConsingTable {
+private:
+#ifndef IKOS_SINGLE_THREADED
+  std::mutex _mutex;
+#endif
+  std::unordered_multimap< std::size_t, const T* > _nodes;
+
+private:
+  using Ptr = NodePtr< const T >;
+
+  /// \brief Constructor
+  HashConsingTable() = default;
+
+public:
+  /// \brief No copy constructor
+  HashConsingTable(const HashConsingTable&) = delete;
+
+  /// \brief No move constructor
+  HashConsingTable(HashConsingTable&&) = delete;
+
+  /// \brief No copy assignment operator
+  HashConsingTable& operator=(const HashConsingTable&) = delete;
+
+  /// \brief No move assignment operator
+  HashConsingTable& operator=(HashConsingTable&&) = delete;
+
+  /// \brief Destructor
+  ~HashConsingTable() = delete;
+
+  /// \brief Return the table of the nodes of type T
+  static HashConsingTable& get() {
+    static auto table = new HashConsingTable();
+    return *table;
+  }
+
+  /// \brief Return the registered node with the given hash such that
+  /// `equal(node)` is true, or register and return the node `create()`
+  template < typename Equal, typename Create >
+  Ptr find_or_create(std::size_t hash,
+                     const Equal& equal,
+                     const Create& create) {
+#ifndef IKOS_SINGLE_THREADED
+    std::lock_guard< std::mutex > lock(this->_mutex);
+#endif
+    auto range = this->_nodes.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      const T* node = it->second;
+      // A node with no reference is being destroyed by another thread
+      if (equal(*node) && node->try_acquire()) {
+        return Ptr(node, typename Ptr::AdoptTag{});
+      }
+    }
+    const T* node = create();
+    this->_nodes.emplace(hash, node);
+    return Ptr(node);
+  }
+
+  /// \brief Unregister the given node
+  void erase(std::size_t hash, const T* node) {
+#ifndef IKOS_SINGLE_THREADED
+    std::lock_guard< std::mutex > lock(this->_mutex);
+#endif
+    auto range = this->_nodes.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == node) {
+        this->_nodes.erase(it);
+        return;
+      }
+    }
+  }
+
+}; // end class HashConsingTable
+
+} // end namespace patricia_tree_utils
+} // end namespace core
+} // end namespace ikos
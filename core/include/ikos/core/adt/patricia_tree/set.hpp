@@ -49,11 +49,14 @@
 
 #pragma once
 
+#include <functional>
 #include <iostream>
 #include <iterator>
-#include <memory>
 #include <stack>
 
+#include <boost/functional/hash.hpp>
+
+#include <ikos/core/adt/patricia_tree/node.hpp>
 #include <ikos/core/adt/patricia_tree/utils.hpp>
 #include <ikos/core/semantic/dumpable.hpp>
 #include <ikos/core/semantic/indexable.hpp>
@@ -67,58 +70,74 @@ namespace patricia_tree_set_impl {
 
 using namespace patricia_tree_utils;
 
-template < typename Key >
+template < typename Key, bool HashConsed >
 class PatriciaTree;
 
-template < typename Key >
+template < typename Key, bool HashConsed >
+class PatriciaTreeNode;
+
+template < typename Key, bool HashConsed >
+class PatriciaTreeLeaf;
+
+template < typename Key, bool HashConsed >
 class PatriciaTreeIterator;
 
-template < typename Key >
-inline bool empty(const std::shared_ptr< const PatriciaTree< Key > >& tree);
+template < typename Key, bool HashConsed >
+struct TreeFactory;
 
-template < typename Key >
-inline std::size_t size(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree);
+template < typename Key, bool HashConsed >
+using TreePtr = NodePtr< const PatriciaTree< Key, HashConsed > >;
 
-template < typename Key >
-inline bool contains(const std::shared_ptr< const PatriciaTree< Key > >& tree,
-                     const Key& key);
+template < typename Key, bool HashConsed >
+using BranchPtr = NodePtr< const PatriciaTreeNode< Key, HashConsed > >;
 
-template < typename Key >
-inline bool is_subset_of(const std::shared_ptr< const PatriciaTree< Key > >& s,
-                         const std::shared_ptr< const PatriciaTree< Key > >& t);
+template < typename Key, bool HashConsed >
+using LeafPtr = NodePtr< const PatriciaTreeLeaf< Key, HashConsed > >;
 
-template < typename Key >
-inline bool equals(const std::shared_ptr< const PatriciaTree< Key > >& s,
-                   const std::shared_ptr< const PatriciaTree< Key > >& t);
+template < typename Key, bool HashConsed >
+inline bool empty(const TreePtr< Key, HashConsed >& tree);
 
-template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > insert(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree, const Key& key);
+template < typename Key, bool HashConsed >
+inline std::size_t size(const TreePtr< Key, HashConsed >& tree);
 
-template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > erase(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree, const Key& key);
+template < typename Key, bool HashConsed >
+inline bool contains(const TreePtr< Key, HashConsed >& tree, const Key& key);
+
+template < typename Key, bool HashConsed >
+inline bool is_subset_of(const TreePtr< Key, HashConsed >& s,
+                         const TreePtr< Key, HashConsed >& t);
+
+template < typename Key, bool HashConsed >
+inline bool equals(const TreePtr< Key, HashConsed >& s,
+                   const TreePtr< Key, HashConsed >& t);
+
+template < typename Key, bool HashConsed >
+inline TreePtr< Key, HashConsed > insert(
+    const TreePtr< Key, HashConsed >& tree, const Key& key);
+
+template < typename Key, bool HashConsed >
+inline TreePtr< Key, HashConsed > erase(
+    const TreePtr< Key, HashConsed >& tree, const Key& key);
 
-template < typename Key, typename Predicate >
-inline std::shared_ptr< const PatriciaTree< Key > > filter(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree,
+template < typename Key, bool HashConsed, typename Predicate >
+inline TreePtr< Key, HashConsed > filter(
+    const TreePtr< Key, HashConsed >& tree,
     const Predicate& pred);
 
-template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > join(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t);
+template < typename Key, bool HashConsed >
+inline TreePtr< Key, HashConsed > join(
+    const TreePtr< Key, HashConsed >& s,
+    const TreePtr< Key, HashConsed >& t);
 
-template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > intersect(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t);
+template < typename Key, bool HashConsed >
+inline TreePtr< Key, HashConsed > intersect(
+    const TreePtr< Key, HashConsed >& s,
+    const TreePtr< Key, HashConsed >& t);
 
-template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > difference(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t);
+template < typename Key, bool HashConsed >
+inline TreePtr< Key, HashConsed > difference(
+    const TreePtr< Key, HashConsed >& s,
+    const TreePtr< Key, HashConsed >& t);
 
 } // end namespace patricia_tree_set_impl
 
@@ -128,25 +147,30 @@ inline std::shared_ptr< const PatriciaTree< Key > > difference(
 ///
 /// Key must implement IndexableTraits
 /// Key must implement bool Key::operator==(const Key&) const
-template < typename Key >
+///
+/// If HashConsed is true, the nodes of the trees are hash-consed: equal sets
+/// share the same tree, and identical subtrees are shared across all sets.
+/// Comparisons become pointer comparisons, at the cost of a lookup in a global
+/// table on each node creation.
+template < typename Key, bool HashConsed = false >
 class PatriciaTreeSet final {
 public:
   static_assert(IsIndexable< Key >::value,
                 "Key must implement IndexableTraits");
 
 private:
-  using PatriciaTree = patricia_tree_set_impl::PatriciaTree< Key >;
+  using TreePtr = patricia_tree_set_impl::TreePtr< Key, HashConsed >;
 
 public:
-  using Iterator = patricia_tree_set_impl::PatriciaTreeIterator< Key >;
+  using Iterator =
+      patricia_tree_set_impl::PatriciaTreeIterator< Key, HashConsed >;
 
 private:
-  std::shared_ptr< const PatriciaTree > _tree;
+  TreePtr _tree;
 
 private:
   /// \brief Private constructor
-  explicit PatriciaTreeSet(std::shared_ptr< const PatriciaTree > tree)
-      : _tree(std::move(tree)) {}
+  explicit PatriciaTreeSet(TreePtr tree) : _tree(std::move(tree)) {}
 
 public:
   /// \brief Create an empty patricia tree set
@@ -212,6 +236,19 @@ public:
     return patricia_tree_set_impl::equals(this->_tree, other._tree);
   }
 
+  /// \brief Return the hash of the set
+  std::size_t hash() const {
+    if (HashConsed) {
+      return std::hash< const void* >()(this->_tree.get());
+    } else {
+      std::size_t result = 0;
+      for (const Key& key : *this) {
+        boost::hash_combine(result, IndexableTraits< Key >::index(key));
+      }
+      return result;
+    }
+  }
+
   /// \brief Return the begin iterator over the elements of the set
   Iterator begin() const { return Iterator(this->_tree); }
 
@@ -285,17 +322,23 @@ public:
 }; // end class PatriciaTreeSet
 
 /// \brief Write a patricia tree set on a stream
-template < typename Key >
-inline std::ostream& operator<<(std::ostream& o,
-                                const PatriciaTreeSet< Key >& tree) {
+template < typename Key, bool HashConsed >
+inline std::ostream& operator<<(
+    std::ostream& o, const PatriciaTreeSet< Key, HashConsed >& tree) {
   tree.dump(o);
   return o;
 }
 
+/// \brief Return the hash of a patricia tree set
+template < typename Key, bool HashConsed >
+inline std::size_t hash_value(const PatriciaTreeSet< Key, HashConsed >& set) {
+  return set.hash();
+}
+
 namespace patricia_tree_set_impl {
 
-template < typename Key >
-class PatriciaTree {
+template < typename Key, bool HashConsed >
+class PatriciaTree : public RefCountedNode {
 private:
   std::size_t _size;
 
@@ -318,60 +361,168 @@ public:
 
 }; // end class PatriciaTree
 
-template < typename Key >
-class PatriciaTreeNode final : public PatriciaTree< Key > {
+template < typename Key, bool HashConsed >
+class PatriciaTreeNode final : public PatriciaTree< Key, HashConsed > {
 private:
   Index _prefix;
   Index _branching_bit;
-  std::shared_ptr< const PatriciaTree< Key > > _left_tree;
-  std::shared_ptr< const PatriciaTree< Key > > _right_tree;
+  TreePtr< Key, HashConsed > _left_tree;
+  TreePtr< Key, HashConsed > _right_tree;
 
 public:
   PatriciaTreeNode(Index prefix,
                    Index branching_bit,
-                   std::shared_ptr< const PatriciaTree< Key > > left_tree,
-                   std::shared_ptr< const PatriciaTree< Key > > right_tree)
-      : PatriciaTree< Key >(left_tree->size() + right_tree->size()),
+                   TreePtr< Key, HashConsed > left_tree,
+                   TreePtr< Key, HashConsed > right_tree)
+      : PatriciaTree< Key, HashConsed >(left_tree->size() +
+                                        right_tree->size()),
         _prefix(prefix),
         _branching_bit(branching_bit),
         _left_tree(std::move(left_tree)),
         _right_tree(std::move(right_tree)) {}
 
+  ~PatriciaTreeNode() override {
+    TreeFactory< Key, HashConsed >::release(this);
+  }
+
   Index prefix() const { return this->_prefix; }
 
   Index branching_bit() const { return this->_branching_bit; }
 
-  const std::shared_ptr< const PatriciaTree< Key > >& left_tree() const {
+  const TreePtr< Key, HashConsed >& left_tree() const {
     return this->_left_tree;
   }
 
-  const std::shared_ptr< const PatriciaTree< Key > >& right_tree() const {
+  const TreePtr< Key, HashConsed >& right_tree() const {
     return this->_right_tree;
   }
 
 }; // end class PatriciaTreeNode
 
-template < typename Key >
-class PatriciaTreeLeaf final : public PatriciaTree< Key > {
+template < typename Key, bool HashConsed >
+class PatriciaTreeLeaf final : public PatriciaTree< Key, HashConsed > {
 private:
   Key _key;
 
 public:
   explicit PatriciaTreeLeaf(Key key)
-      : PatriciaTree< Key >(1), _key(std::move(key)) {}
+      : PatriciaTree< Key, HashConsed >(1), _key(std::move(key)) {}
+
+  ~PatriciaTreeLeaf() override {
+    TreeFactory< Key, HashConsed >::release(this);
+  }
 
   const Key& key() const { return this->_key; }
 
 }; // end class PatriciaTreeLeaf
 
+/// \brief Creation of leaves and nodes
+template < typename Key, bool HashConsed >
+struct TreeFactory {
+  static LeafPtr< Key, HashConsed > leaf(const Key& key) {
+    return make_node_ptr< const PatriciaTreeLeaf< Key, HashConsed > >(key);
+  }
+
+  static BranchPtr< Key, HashConsed > node(
+      Index prefix,
+      Index branching_bit,
+      const TreePtr< Key, HashConsed >& left_tree,
+      const TreePtr< Key, HashConsed >& right_tree) {
+    return make_node_ptr< const PatriciaTreeNode< Key, HashConsed > >(
+        prefix, branching_bit, left_tree, right_tree);
+  }
+
+  static void release(const PatriciaTreeLeaf< Key, HashConsed >*) {}
+
+  static void release(const PatriciaTreeNode< Key, HashConsed >*) {}
+
+}; // end struct TreeFactory
+
+/// \brief Creation of hash-consed leaves and nodes
 template < typename Key >
-inline bool empty(const std::shared_ptr< const PatriciaTree< Key > >& tree) {
+struct TreeFactory< Key, true > {
+  using Leaf = PatriciaTreeLeaf< Key, true >;
+  using Node = PatriciaTreeNode< Key, true >;
+
+  static std::size_t hash(Index index) { return boost::hash_value(index); }
+
+  static std::size_t hash(Index prefix,
+                          Index branching_bit,
+                          const PatriciaTree< Key, true >* left_tree,
+                          const PatriciaTree< Key, true >* right_tree) {
+    std::size_t result = 0;
+    boost::hash_combine(result, prefix);
+    boost::hash_combine(result, branching_bit);
+    boost::hash_combine(result, left_tree);
+    boost::hash_combine(result, right_tree);
+    return result;
+  }
+
+  static LeafPtr< Key, true > leaf(const Key& key) {
+    Index index = IndexableTraits< Key >::index(key);
+    return HashConsingTable< Leaf >::get().find_or_create(
+        hash(index),
+        [&](const Leaf& other) {
+          return IndexableTraits< Key >::index(other.key()) == index;
+        },
+        [&]() { return new const Leaf(key); });
+  }
+
+  static BranchPtr< Key, true > node(
+      Index prefix,
+      Index branching_bit,
+      const TreePtr< Key, true >& left_tree,
+      const TreePtr< Key, true >& right_tree) {
+    return HashConsingTable< Node >::get().find_or_create(
+        hash(prefix, branching_bit, left_tree.get(), right_tree.get()),
+        [&](const Node& other) {
+          return other.prefix() == prefix &&
+                 other.branching_bit() == branching_bit &&
+                 other.left_tree() == left_tree &&
+                 other.right_tree() == right_tree;
+        },
+        [&]() {
+          return new const Node(prefix, branching_bit, left_tree, right_tree);
+        });
+  }
+
+  static void release(const Leaf* leaf) {
+    HashConsingTable< Leaf >::get().erase(hash(IndexableTraits< Key >::index(
+                                              leaf->key())),
+                                          leaf);
+  }
+
+  static void release(const Node* node) {
+    HashConsingTable< Node >::get().erase(hash(node->prefix(),
+                                               node->branching_bit(),
+                                               node->left_tree().get(),
+                                               node->right_tree().get()),
+                                          node);
+  }
+
+}; // end struct TreeFactory
+
+template < typename Key, bool HashConsed >
+inline LeafPtr< Key, HashConsed > as_leaf(
+    const TreePtr< Key, HashConsed >& tree) {
+  return static_node_ptr_cast< const PatriciaTreeLeaf< Key, HashConsed > >(
+      tree);
+}
+
+template < typename Key, bool HashConsed >
+inline BranchPtr< Key, HashConsed > as_branch(
+    const TreePtr< Key, HashConsed >& tree) {
+  return static_node_ptr_cast< const PatriciaTreeNode< Key, HashConsed > >(
+      tree);
+}
+
+template < typename Key, bool HashConsed >
+inline bool empty(const TreePtr< Key, HashConsed >& tree) {
   return tree == nullptr;
 }
 
-template < typename Key >
-inline std::size_t size(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree) {
+template < typename Key, bool HashConsed >
+inline std::size_t size(const TreePtr< Key, HashConsed >& tree) {
   if (tree != nullptr) {
     return tree->size();
   } else {
@@ -379,17 +530,16 @@ inline std::size_t size(
   }
 }
 
-template < typename Key >
-inline bool contains(const std::shared_ptr< const PatriciaTree< Key > >& tree,
-                     const Key& key) {
+template < typename Key, bool HashConsed >
+inline bool contains(const TreePtr< Key, HashConsed >& tree, const Key& key) {
   if (tree == nullptr) {
     return false;
   }
   if (tree->is_leaf()) {
-    auto leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(tree);
+    auto leaf = as_leaf(tree);
     return leaf->key() == key;
   }
-  auto node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(tree);
+  auto node = as_branch(tree);
   if (is_zero_bit(IndexableTraits< Key >::index(key), node->branching_bit())) {
     return contains(node->left_tree(), key);
   } else {
@@ -397,10 +547,10 @@ inline bool contains(const std::shared_ptr< const PatriciaTree< Key > >& tree,
   }
 }
 
-template < typename Key >
+template < typename Key, bool HashConsed >
 inline bool is_subset_of(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t) {
+    const TreePtr< Key, HashConsed >& s,
+    const TreePtr< Key, HashConsed >& t) {
   if (s == t) {
     return true;
   }
@@ -411,14 +561,14 @@ inline bool is_subset_of(
     return false;
   }
   if (s->is_leaf()) {
-    auto s_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(s);
+    auto s_leaf = as_leaf(s);
     return contains(t, s_leaf->key());
   }
   if (t->is_leaf()) {
     return false;
   }
-  auto s_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(s);
-  auto t_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(t);
+  auto s_node = as_branch(s);
+  auto t_node = as_branch(t);
   if (s_node->size() > t_node->size()) {
     return false;
   }
@@ -442,12 +592,16 @@ inline bool is_subset_of(
   return false; // s contains bindings that are not in t
 }
 
-template < typename Key >
-inline bool equals(const std::shared_ptr< const PatriciaTree< Key > >& s,
-                   const std::shared_ptr< const PatriciaTree< Key > >& t) {
+template < typename Key, bool HashConsed >
+inline bool equals(const TreePtr< Key, HashConsed >& s,
+                   const TreePtr< Key, HashConsed >& t) {
   if (s == t) {
     return true;
   }
+  if (HashConsed) {
+    // Equal hash-consed trees are physically equal
+    return false;
+  }
   if (s == nullptr || t == nullptr) {
     return false;
   }
@@ -455,15 +609,15 @@ inline bool equals(const std::shared_ptr< const PatriciaTree< Key > >& s,
     if (t->is_node()) {
       return false;
     }
-    auto s_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(s);
-    auto t_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(t);
+    auto s_leaf = as_leaf(s);
+    auto t_leaf = as_leaf(t);
     return s_leaf->key() == t_leaf->key();
   }
   if (t->is_leaf()) {
     return false;
   }
-  auto s_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(s);
-  auto t_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(t);
+  auto s_node = as_branch(s);
+  auto t_node = as_branch(t);
   return s_node->size() == t_node->size() &&
          s_node->prefix() == t_node->prefix() &&
          s_node->branching_bit() == t_node->branching_bit() &&
@@ -474,66 +628,61 @@ inline bool equals(const std::shared_ptr< const PatriciaTree< Key > >& s,
 /// \brief Create a node
 ///
 /// Prevent the creation of a node with only one child.
-template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > make_node(
+template < typename Key, bool HashConsed >
+inline TreePtr< Key, HashConsed > make_node(
     Index prefix,
     Index branching_bit,
-    const std::shared_ptr< const PatriciaTree< Key > >& left_tree,
-    const std::shared_ptr< const PatriciaTree< Key > >& right_tree) {
+    const TreePtr< Key, HashConsed >& left_tree,
+    const TreePtr< Key, HashConsed >& right_tree) {
   if (left_tree == nullptr) {
     return right_tree;
   }
   if (right_tree == nullptr) {
     return left_tree;
   }
-  return std::make_shared< const PatriciaTreeNode< Key > >(prefix,
-                                                           branching_bit,
-                                                           left_tree,
-                                                           right_tree);
+  return TreeFactory< Key, HashConsed >::node(prefix,
+                                              branching_bit,
+                                              left_tree,
+                                              right_tree);
 }
 
 /// \brief Join non-null patricia trees
-template < typename Key >
-inline std::shared_ptr< const PatriciaTreeNode< Key > > join_trees(
+template < typename Key, bool HashConsed >
+inline BranchPtr< Key, HashConsed > join_trees(
     Index prefix_s,
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
+    const TreePtr< Key, HashConsed >& s,
     Index prefix_t,
-    const std::shared_ptr< const PatriciaTree< Key > >& t) {
+    const TreePtr< Key, HashConsed >& t) {
   ikos_assert(s != nullptr && t != nullptr);
 
   Index m = branching_bit(prefix_s, prefix_t);
 
   if (is_zero_bit(prefix_s, m)) {
-    return std::make_shared< const PatriciaTreeNode< Key > >(mask(prefix_s, m),
-                                                             m,
-                                                             s,
-                                                             t);
+    return TreeFactory< Key, HashConsed >::node(mask(prefix_s, m), m, s, t);
   } else {
-    return std::make_shared< const PatriciaTreeNode< Key > >(mask(prefix_s, m),
-                                                             m,
-                                                             t,
-                                                             s);
+    return TreeFactory< Key, HashConsed >::node(mask(prefix_s, m), m, t, s);
   }
 }
 
-template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > insert(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree, const Key& key) {
+template < typename Key, bool HashConsed >
+inline TreePtr< Key, HashConsed > insert(
+    const TreePtr< Key, HashConsed >& tree, const Key& key) {
   if (tree == nullptr) {
-    return std::make_shared< const PatriciaTreeLeaf< Key > >(key);
+    return TreeFactory< Key, HashConsed >::leaf(key);
   }
   if (tree->is_leaf()) {
-    auto leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(tree);
+    auto leaf = as_leaf(tree);
     if (leaf->key() == key) {
       return tree;
     }
-    auto new_leaf = std::make_shared< const PatriciaTreeLeaf< Key > >(key);
-    return join_trees< Key >(IndexableTraits< Key >::index(key),
-                             new_leaf,
-                             IndexableTraits< Key >::index(leaf->key()),
-                             leaf);
-  }
-  auto node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(tree);
+    auto new_leaf = TreeFactory< Key, HashConsed >::leaf(key);
+    return join_trees< Key, HashConsed >(IndexableTraits< Key >::index(key),
+                                         new_leaf,
+                                         IndexableTraits< Key >::index(
+                                             leaf->key()),
+                                         leaf);
+  }
+  auto node = as_branch(tree);
   if (match_prefix(IndexableTraits< Key >::index(key),
                    node->prefix(),
                    node->branching_bit())) {
@@ -558,18 +707,18 @@ inline std::shared_ptr< const PatriciaTree< Key > > insert(
                        new_right_tree);
     }
   }
-  auto new_leaf = std::make_shared< const PatriciaTreeLeaf< Key > >(key);
-  return join_trees< Key >(IndexableTraits< Key >::index(key),
-                           new_leaf,
-                           node->prefix(),
-                           node);
+  auto new_leaf = TreeFactory< Key, HashConsed >::leaf(key);
+  return join_trees< Key, HashConsed >(IndexableTraits< Key >::index(key),
+                                       new_leaf,
+                                       node->prefix(),
+                                       node);
 }
 
 /// \brief Insert the leaf `t_leaf` into the patricia tree `s`
-template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > insert_leaf(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTreeLeaf< Key > >& t_leaf) {
+template < typename Key, bool HashConsed >
+inline TreePtr< Key, HashConsed > insert_leaf(
+    const TreePtr< Key, HashConsed >& s,
+    const LeafPtr< Key, HashConsed >& t_leaf) {
   if (s == t_leaf) {
     return s;
   }
@@ -577,16 +726,18 @@ inline std::shared_ptr< const PatriciaTree< Key > > insert_leaf(
     return t_leaf;
   }
   if (s->is_leaf()) {
-    auto s_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(s);
+    auto s_leaf = as_leaf(s);
     if (s_leaf->key() == t_leaf->key()) {
       return std::move(s_leaf);
     }
-    return join_trees< Key >(IndexableTraits< Key >::index(s_leaf->key()),
-                             s_leaf,
-                             IndexableTraits< Key >::index(t_leaf->key()),
-                             t_leaf);
-  }
-  auto s_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(s);
+    return join_trees< Key, HashConsed >(IndexableTraits< Key >::index(
+                                             s_leaf->key()),
+                                         s_leaf,
+                                         IndexableTraits< Key >::index(
+                                             t_leaf->key()),
+                                         t_leaf);
+  }
+  auto s_node = as_branch(s);
   if (match_prefix(IndexableTraits< Key >::index(t_leaf->key()),
                    s_node->prefix(),
                    s_node->branching_bit())) {
@@ -611,27 +762,28 @@ inline std::shared_ptr< const PatriciaTree< Key > > insert_leaf(
                        new_right_tree);
     }
   }
-  return join_trees< Key >(s_node->prefix(),
-                           s_node,
-                           IndexableTraits< Key >::index(t_leaf->key()),
-                           t_leaf);
+  return join_trees< Key, HashConsed >(s_node->prefix(),
+                                       s_node,
+                                       IndexableTraits< Key >::index(
+                                           t_leaf->key()),
+                                       t_leaf);
 }
 
-template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > erase(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree, const Key& key) {
+template < typename Key, bool HashConsed >
+inline TreePtr< Key, HashConsed > erase(
+    const TreePtr< Key, HashConsed >& tree, const Key& key) {
   if (tree == nullptr) {
     return nullptr;
   }
   if (tree->is_leaf()) {
-    auto leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(tree);
+    auto leaf = as_leaf(tree);
     if (leaf->key() == key) {
       return nullptr;
     } else {
       return tree;
     }
   }
-  auto node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(tree);
+  auto node = as_branch(tree);
   if (match_prefix(IndexableTraits< Key >::index(key),
                    node->prefix(),
                    node->branching_bit())) {
@@ -659,22 +811,22 @@ inline std::shared_ptr< const PatriciaTree< Key > > erase(
   return tree;
 }
 
-template < typename Key, typename Predicate >
-inline std::shared_ptr< const PatriciaTree< Key > > filter(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree,
+template < typename Key, bool HashConsed, typename Predicate >
+inline TreePtr< Key, HashConsed > filter(
+    const TreePtr< Key, HashConsed >& tree,
     const Predicate& pred) {
   if (tree == nullptr) {
     return nullptr;
   }
   if (tree->is_leaf()) {
-    auto leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(tree);
+    auto leaf = as_leaf(tree);
     if (pred(leaf->key())) {
       return tree;
     } else {
       return nullptr;
     }
   }
-  auto node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(tree);
+  auto node = as_branch(tree);
   auto new_left_tree = filter(node->left_tree(), pred);
   auto new_right_tree = filter(node->right_tree(), pred);
   if (new_left_tree == node->left_tree() &&
@@ -688,10 +840,10 @@ inline std::shared_ptr< const PatriciaTree< Key > > filter(
   }
 }
 
-template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > join(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t) {
+template < typename Key, bool HashConsed >
+inline TreePtr< Key, HashConsed > join(
+    const TreePtr< Key, HashConsed >& s,
+    const TreePtr< Key, HashConsed >& t) {
   if (s == t) {
     return s;
   }
@@ -702,15 +854,15 @@ inline std::shared_ptr< const PatriciaTree< Key > > join(
     return s;
   }
   if (s->is_leaf()) {
-    auto s_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(s);
+    auto s_leaf = as_leaf(s);
     return insert_leaf(t, s_leaf);
   }
   if (t->is_leaf()) {
-    auto t_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(t);
+    auto t_leaf = as_leaf(t);
     return insert_leaf(s, t_leaf);
   }
-  auto s_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(s);
-  auto t_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(t);
+  auto s_node = as_branch(s);
+  auto t_node = as_branch(t);
   Index m = s_node->branching_bit();
   Index n = t_node->branching_bit();
   Index p = s_node->prefix();
@@ -763,10 +915,10 @@ inline std::shared_ptr< const PatriciaTree< Key > > join(
   return join_trees(p, s, q, t);
 }
 
-template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > intersect(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t) {
+template < typename Key, bool HashConsed >
+inline TreePtr< Key, HashConsed > intersect(
+    const TreePtr< Key, HashConsed >& s,
+    const TreePtr< Key, HashConsed >& t) {
   if (s == t) {
     return s;
   }
@@ -774,7 +926,7 @@ inline std::shared_ptr< const PatriciaTree< Key > > intersect(
     return nullptr;
   }
   if (s->is_leaf()) {
-    auto s_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(s);
+    auto s_leaf = as_leaf(s);
     if (contains(t, s_leaf->key())) {
       return s;
     } else {
@@ -782,15 +934,15 @@ inline std::shared_ptr< const PatriciaTree< Key > > intersect(
     }
   }
   if (t->is_leaf()) {
-    auto t_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(t);
+    auto t_leaf = as_leaf(t);
     if (contains(s, t_leaf->key())) {
       return t;
     } else {
       return nullptr;
     }
   }
-  auto s_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(s);
-  auto t_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(t);
+  auto s_node = as_branch(s);
+  auto t_node = as_branch(t);
   Index m = s_node->branching_bit();
   Index n = t_node->branching_bit();
   Index p = s_node->prefix();
@@ -827,10 +979,10 @@ inline std::shared_ptr< const PatriciaTree< Key > > intersect(
   return nullptr;
 }
 
-template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > difference(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t) {
+template < typename Key, bool HashConsed >
+inline TreePtr< Key, HashConsed > difference(
+    const TreePtr< Key, HashConsed >& s,
+    const TreePtr< Key, HashConsed >& t) {
   if (s == t) {
     return nullptr;
   }
@@ -841,7 +993,7 @@ inline std::shared_ptr< const PatriciaTree< Key > > difference(
     return s;
   }
   if (s->is_leaf()) {
-    auto s_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(s);
+    auto s_leaf = as_leaf(s);
     if (contains(t, s_leaf->key())) {
       return nullptr;
     } else {
@@ -849,11 +1001,11 @@ inline std::shared_ptr< const PatriciaTree< Key > > difference(
     }
   }
   if (t->is_leaf()) {
-    auto t_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(t);
+    auto t_leaf = as_leaf(t);
     return erase(s, t_leaf->key());
   }
-  auto s_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(s);
-  auto t_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(t);
+  auto s_node = as_branch(s);
+  auto t_node = as_branch(t);
   Index m = s_node->branching_bit();
   Index n = t_node->branching_bit();
   Index p = s_node->prefix();
@@ -898,7 +1050,7 @@ inline std::shared_ptr< const PatriciaTree< Key > > difference(
   return s;
 }
 
-template < typename Key >
+template < typename Key, bool HashConsed >
 class PatriciaTreeIterator final {
 public:
   // Required types for iterators
@@ -909,16 +1061,15 @@ public:
   using reference = const Key&;
 
 private:
-  std::shared_ptr< const PatriciaTreeLeaf< Key > > _leaf;
-  std::stack< std::shared_ptr< const PatriciaTreeNode< Key > > > _stack;
+  LeafPtr< Key, HashConsed > _leaf;
+  std::stack< BranchPtr< Key, HashConsed > > _stack;
 
 public:
   /// \brief Create an end iterator
   PatriciaTreeIterator() = default;
 
   /// \brief Create an iterator on the given patricia tree
-  explicit PatriciaTreeIterator(
-      const std::shared_ptr< const PatriciaTree< Key > >& tree) {
+  explicit PatriciaTreeIterator(const TreePtr< Key, HashConsed >& tree) {
     if (tree != nullptr) {
       this->look_for_next_leaf(tree);
     }
@@ -969,17 +1120,16 @@ public:
 
 private:
   /// \brief Find the leftmost leaf, store all intermediate nodes
-  void look_for_next_leaf(
-      const std::shared_ptr< const PatriciaTree< Key > >& tree) {
+  void look_for_next_leaf(const TreePtr< Key, HashConsed >& tree) {
     auto t = tree;
     ikos_assert(t != nullptr);
     while (t->is_node()) {
-      auto node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(t);
+      auto node = as_branch(t);
       this->_stack.push(node);
       t = node->left_tree();
       ikos_assert(t != nullptr); // a node always has two children
     }
-    this->_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(t);
+    this->_leaf = as_leaf(t);
   }
 
 }; // end class PatriciaTreeIterator
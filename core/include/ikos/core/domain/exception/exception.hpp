@@ -45,6 +45,8 @@
 
 #include <sstream>
 
+#include <boost/optional.hpp>
+
 #include <ikos/core/domain/exception/abstract_domain.hpp>
 
 namespace ikos {
@@ -59,20 +61,30 @@ namespace exception {
 ///   * **caught_exceptions** represents the state of uncaught exceptions;
 ///   * **propagated_exceptions** represents the state of caught exceptions
 ///     that are propagated through the control flow graph.
+///
+/// The exceptional states are bottom in code that never throws, such as C
+/// code. They are represented by boost::none when bottom, and only
+/// materialized when an exception is thrown or when they are accessed through
+/// a non-const accessor. Operations on bottom exceptional states are then
+/// almost free.
 template < typename UnderlyingDomain >
 class ExceptionDomain final
     : public exception::AbstractDomain< UnderlyingDomain,
                                         ExceptionDomain< UnderlyingDomain > > {
+private:
+  /// \brief Underlying domain, or boost::none for bottom
+  using OptionalDomain = boost::optional< UnderlyingDomain >;
+
 private:
   /// \brief Represents the normal execution flow state
   UnderlyingDomain _normal;
 
   /// \brief Represents the state of uncaught exceptions
-  UnderlyingDomain _caught_exceptions;
+  OptionalDomain _caught_exceptions;
 
   /// \brief Represents the state of caught exceptions that are propagated
   /// through the control flow graph
-  UnderlyingDomain _propagated_exceptions;
+  OptionalDomain _propagated_exceptions;
 
 private:
   struct TopTag {};
@@ -87,15 +99,10 @@ private:
 
   /// \brief Create the top abstract value with no pending exceptions
   explicit ExceptionDomain(TopNoExceptionsTag)
-      : _normal(UnderlyingDomain::top()),
-        _caught_exceptions(UnderlyingDomain::bottom()),
-        _propagated_exceptions(UnderlyingDomain::bottom()) {}
+      : _normal(UnderlyingDomain::top()) {}
 
   /// \brief Create the bottom abstract value
-  explicit ExceptionDomain(BottomTag)
-      : _normal(UnderlyingDomain::bottom()),
-        _caught_exceptions(UnderlyingDomain::bottom()),
-        _propagated_exceptions(UnderlyingDomain::bottom()) {}
+  explicit ExceptionDomain(BottomTag) : _normal(UnderlyingDomain::bottom()) {}
 
 public:
   /// \brief Create the top abstract value
@@ -111,8 +118,8 @@ public:
                   UnderlyingDomain caught_exceptions,
                   UnderlyingDomain propagated_exceptions)
       : _normal(std::move(normal)),
-        _caught_exceptions(std::move(caught_exceptions)),
-        _propagated_exceptions(std::move(propagated_exceptions)) {}
+        _caught_exceptions(lift(std::move(caught_exceptions))),
+        _propagated_exceptions(lift(std::move(propagated_exceptions))) {}
 
   /// \brief Copy constructor
   ExceptionDomain(const ExceptionDomain&) = default;
@@ -140,85 +147,222 @@ public:
   /// \brief Create the bottom abstract value
   static ExceptionDomain bottom() { return ExceptionDomain(BottomTag{}); }
 
+private:
+  /// \brief Return boost::none if the given domain is bottom
+  static OptionalDomain lift(UnderlyingDomain inv) {
+    if (inv.is_bottom()) {
+      return boost::none;
+    } else {
+      return OptionalDomain(std::move(inv));
+    }
+  }
+
+  /// \brief Return the bottom underlying domain
+  static const UnderlyingDomain& bottom_domain() {
+    static const UnderlyingDomain Bottom = UnderlyingDomain::bottom();
+    return Bottom;
+  }
+
+  /// \brief Return the given exceptional state
+  static const UnderlyingDomain& get(const OptionalDomain& inv) {
+    return inv ? *inv : bottom_domain();
+  }
+
+  /// \brief Materialize the given exceptional state
+  static UnderlyingDomain& materialize(OptionalDomain& inv) {
+    if (!inv) {
+      inv = UnderlyingDomain::bottom();
+    }
+    return *inv;
+  }
+
+  /// \brief Return true if the given exceptional state is bottom
+  static bool is_bottom(const OptionalDomain& inv) {
+    return !inv || inv->is_bottom();
+  }
+
+  /// \brief Return true if the given exceptional state is top
+  static bool is_top(const OptionalDomain& inv) { return inv && inv->is_top(); }
+
+  /// \brief Partial order on exceptional states
+  static bool leq(const OptionalDomain& left, const OptionalDomain& right) {
+    if (!left) {
+      return true;
+    } else if (!right) {
+      return left->is_bottom();
+    } else {
+      return left->leq(*right);
+    }
+  }
+
+  /// \brief Equality on exceptional states
+  static bool equals(const OptionalDomain& left, const OptionalDomain& right) {
+    if (!left) {
+      return is_bottom(right);
+    } else if (!right) {
+      return left->is_bottom();
+    } else {
+      return left->equals(*right);
+    }
+  }
+
+  /// \brief Apply an upper bound operator on exceptional states
+  ///
+  /// Bottom is the identity of the operator.
+  template < typename Operator >
+  static void apply_upper_bound(OptionalDomain& left,
+                                const OptionalDomain& right,
+                                Operator op) {
+    if (!right) {
+      return;
+    } else if (!left) {
+      left = right;
+    } else {
+      op(*left, *right);
+    }
+  }
+
+  /// \brief Apply a lower bound operator on exceptional states
+  ///
+  /// Bottom is the absorbing element of the operator.
+  template < typename Operator >
+  static void apply_lower_bound(OptionalDomain& left,
+                                const OptionalDomain& right,
+                                Operator op) {
+    if (!left) {
+      return;
+    } else if (!right) {
+      left = boost::none;
+    } else {
+      op(*left, *right);
+    }
+  }
+
+  /// \brief Join the exceptional state `from` into `to`, and set `from` to
+  /// bottom
+  static void merge(OptionalDomain& to, OptionalDomain& from) {
+    if (!to) {
+      to = std::move(from);
+    } else if (from) {
+      to->join_with(*from);
+    }
+    from = boost::none;
+  }
+
+public:
   bool is_bottom() const override {
-    return this->_normal.is_bottom() && this->_caught_exceptions.is_bottom() &&
-           this->_propagated_exceptions.is_bottom();
+    return this->_normal.is_bottom() && is_bottom(this->_caught_exceptions) &&
+           is_bottom(this->_propagated_exceptions);
   }
 
   bool is_top() const override {
-    return this->_normal.is_top() && this->_caught_exceptions.is_top() &&
-           this->_propagated_exceptions.is_top();
+    return this->_normal.is_top() && is_top(this->_caught_exceptions) &&
+           is_top(this->_propagated_exceptions);
   }
 
   void set_to_bottom() override {
     this->_normal.set_to_bottom();
-    this->_caught_exceptions.set_to_bottom();
-    this->_propagated_exceptions.set_to_bottom();
+    this->_caught_exceptions = boost::none;
+    this->_propagated_exceptions = boost::none;
   }
 
   void set_to_top() override {
     this->_normal.set_to_top();
-    this->_caught_exceptions.set_to_top();
-    this->_propagated_exceptions.set_to_top();
+    this->_caught_exceptions = UnderlyingDomain::top();
+    this->_propagated_exceptions = UnderlyingDomain::top();
   }
 
   bool leq(const ExceptionDomain& other) const override {
     return this->_normal.leq(other._normal) &&
-           this->_caught_exceptions.leq(other._caught_exceptions) &&
-           this->_propagated_exceptions.leq(other._propagated_exceptions);
+           leq(this->_caught_exceptions, other._caught_exceptions) &&
+           leq(this->_propagated_exceptions, other._propagated_exceptions);
   }
 
   bool equals(const ExceptionDomain& other) const override {
     return this->_normal.equals(other._normal) &&
-           this->_caught_exceptions.equals(other._caught_exceptions) &&
-           this->_propagated_exceptions.equals(other._propagated_exceptions);
+           equals(this->_caught_exceptions, other._caught_exceptions) &&
+           equals(this->_propagated_exceptions, other._propagated_exceptions);
   }
 
   void join_with(const ExceptionDomain& other) override {
+    auto op = [](UnderlyingDomain& left, const UnderlyingDomain& right) {
+      left.join_with(right);
+    };
     this->_normal.join_with(other._normal);
-    this->_caught_exceptions.join_with(other._caught_exceptions);
-    this->_propagated_exceptions.join_with(other._propagated_exceptions);
+    apply_upper_bound(this->_caught_exceptions, other._caught_exceptions, op);
+    apply_upper_bound(this->_propagated_exceptions,
+                      other._propagated_exceptions,
+                      op);
   }
 
   void join_loop_with(const ExceptionDomain& other) override {
+    auto op = [](UnderlyingDomain& left, const UnderlyingDomain& right) {
+      left.join_loop_with(right);
+    };
     this->_normal.join_loop_with(other._normal);
-    this->_caught_exceptions.join_loop_with(other._caught_exceptions);
-    this->_propagated_exceptions.join_loop_with(other._propagated_exceptions);
+    apply_upper_bound(this->_caught_exceptions, other._caught_exceptions, op);
+    apply_upper_bound(this->_propagated_exceptions,
+                      other._propagated_exceptions,
+                      op);
   }
 
   void join_iter_with(const ExceptionDomain& other) override {
+    auto op = [](UnderlyingDomain& left, const UnderlyingDomain& right) {
+      left.join_iter_with(right);
+    };
     this->_normal.join_iter_with(other._normal);
-    this->_caught_exceptions.join_iter_with(other._caught_exceptions);
-    this->_propagated_exceptions.join_iter_with(other._propagated_exceptions);
+    apply_upper_bound(this->_caught_exceptions, other._caught_exceptions, op);
+    apply_upper_bound(this->_propagated_exceptions,
+                      other._propagated_exceptions,
+                      op);
   }
 
   void widen_with(const ExceptionDomain& other) override {
+    auto op = [](UnderlyingDomain& left, const UnderlyingDomain& right) {
+      left.widen_with(right);
+    };
     this->_normal.widen_with(other._normal);
-    this->_caught_exceptions.widen_with(other._caught_exceptions);
-    this->_propagated_exceptions.widen_with(other._propagated_exceptions);
+    apply_upper_bound(this->_caught_exceptions, other._caught_exceptions, op);
+    apply_upper_bound(this->_propagated_exceptions,
+                      other._propagated_exceptions,
+                      op);
   }
 
   /// \brief Perform the widening of two abstract values with a threshold
   template < typename Threshold >
   void widen_threshold_with(const ExceptionDomain& other,
                             const Threshold& threshold) {
+    auto op = [&threshold](UnderlyingDomain& left,
+                           const UnderlyingDomain& right) {
+      left.widen_threshold_with(right, threshold);
+    };
     this->_normal.widen_threshold_with(other._normal, threshold);
-    this->_caught_exceptions.widen_threshold_with(other._caught_exceptions,
-                                                  threshold);
-    this->_propagated_exceptions
-        .widen_threshold_with(other._propagated_exceptions, threshold);
+    apply_upper_bound(this->_caught_exceptions, other._caught_exceptions, op);
+    apply_upper_bound(this->_propagated_exceptions,
+                      other._propagated_exceptions,
+                      op);
   }
 
   void meet_with(const ExceptionDomain& other) override {
+    auto op = [](UnderlyingDomain& left, const UnderlyingDomain& right) {
+      left.meet_with(right);
+    };
     this->_normal.meet_with(other._normal);
-    this->_caught_exceptions.meet_with(other._caught_exceptions);
-    this->_propagated_exceptions.meet_with(other._propagated_exceptions);
+    apply_lower_bound(this->_caught_exceptions, other._caught_exceptions, op);
+    apply_lower_bound(this->_propagated_exceptions,
+                      other._propagated_exceptions,
+                      op);
   }
 
   void narrow_with(const ExceptionDomain& other) override {
+    auto op = [](UnderlyingDomain& left, const UnderlyingDomain& right) {
+      left.narrow_with(right);
+    };
     this->_normal.narrow_with(other._normal);
-    this->_caught_exceptions.narrow_with(other._caught_exceptions);
-    this->_propagated_exceptions.narrow_with(other._propagated_exceptions);
+    apply_lower_bound(this->_caught_exceptions, other._caught_exceptions, op);
+    apply_lower_bound(this->_propagated_exceptions,
+                      other._propagated_exceptions,
+                      op);
   }
 
   /*
@@ -230,19 +374,19 @@ public:
   const UnderlyingDomain& normal() const override { return this->_normal; }
 
   UnderlyingDomain& caught_exceptions() override {
-    return this->_caught_exceptions;
+    return materialize(this->_caught_exceptions);
   }
 
   const UnderlyingDomain& caught_exceptions() const override {
-    return this->_caught_exceptions;
+    return get(this->_caught_exceptions);
   }
 
-  UnderlyingDomain propagated_exceptions() override {
-    return this->_propagated_exceptions;
+  UnderlyingDomain& propagated_exceptions() override {
+    return materialize(this->_propagated_exceptions);
   }
 
   const UnderlyingDomain& propagated_exceptions() const override {
-    return this->_propagated_exceptions;
+    return get(this->_propagated_exceptions);
   }
 
   bool is_normal_flow_bottom() const override {
@@ -256,67 +400,77 @@ public:
   void set_normal_flow_to_top() override { this->_normal.set_to_top(); }
 
   bool is_caught_exceptions_bottom() const override {
-    return this->_caught_exceptions.is_bottom();
+    return is_bottom(this->_caught_exceptions);
   }
 
   bool is_caught_exceptions_top() const override {
-    return this->_caught_exceptions.is_top();
+    return is_top(this->_caught_exceptions);
   }
 
   void set_caught_exceptions_to_bottom() override {
-    this->_caught_exceptions.set_to_bottom();
+    this->_caught_exceptions = boost::none;
   }
 
   void set_caught_exceptions_to_top() override {
-    this->_caught_exceptions.set_to_top();
+    this->_caught_exceptions = UnderlyingDomain::top();
   }
 
   bool is_propagated_exceptions_bottom() const override {
-    return this->_propagated_exceptions.is_bottom();
+    return is_bottom(this->_propagated_exceptions);
   }
 
   bool is_propagated_exceptions_top() const override {
-    return this->_propagated_exceptions.is_top();
+    return is_top(this->_propagated_exceptions);
   }
 
   void set_propagated_exceptions_to_bottom() override {
-    this->_propagated_exceptions.set_to_bottom();
+    this->_propagated_exceptions = boost::none;
   }
 
   void set_propagated_exceptions_to_top() override {
-    this->_propagated_exceptions.set_to_top();
+    this->_propagated_exceptions = UnderlyingDomain::top();
   }
 
   void merge_propagated_in_caught_exceptions() override {
-    this->_caught_exceptions.join_with(this->_propagated_exceptions);
-    this->_propagated_exceptions.set_to_bottom();
+    merge(this->_caught_exceptions, this->_propagated_exceptions);
   }
 
   void merge_caught_in_propagated_exceptions() override {
-    this->_propagated_exceptions.join_with(this->_caught_exceptions);
-    this->_caught_exceptions.set_to_bottom();
+    merge(this->_propagated_exceptions, this->_caught_exceptions);
   }
 
-  void enter_normal() override { this->_caught_exceptions.set_to_bottom(); }
+  void enter_normal() override { this->_caught_exceptions = boost::none; }
 
   void enter_catch() override {
-    std::swap(this->_normal, this->_caught_exceptions);
-    this->_caught_exceptions.set_to_bottom();
-    this->_propagated_exceptions.set_to_bottom();
+    if (this->_caught_exceptions) {
+      this->_normal = std::move(*this->_caught_exceptions);
+    } else {
+      this->_normal.set_to_bottom();
+    }
+    this->_caught_exceptions = boost::none;
+    this->_propagated_exceptions = boost::none;
   }
 
   void ignore_exceptions() override {
-    this->_caught_exceptions.set_to_bottom();
-    this->_propagated_exceptions.set_to_bottom();
+    this->_caught_exceptions = boost::none;
+    this->_propagated_exceptions = boost::none;
   }
 
   void throw_exception() override {
-    this->_caught_exceptions.join_with(this->_normal);
+    if (this->_caught_exceptions) {
+      this->_caught_exceptions->join_with(this->_normal);
+    } else {
+      this->_caught_exceptions = this->_normal;
+    }
     this->_normal.set_to_bottom();
   }
 
   void resume_exception() override {
-    this->_caught_exceptions.join_with(this->_normal);
+    if (this->_caught_exceptions) {
+      this->_caught_exceptions->join_with(this->_normal);
+    } else {
+      this->_caught_exceptions = this->_normal;
+    }
     this->_normal.set_to_bottom();
   }
 
@@ -324,9 +478,9 @@ public:
     o << "(normal=";
     this->_normal.dump(o);
     o << ", caught_exceptions=";
-    this->_caught_exceptions.dump(o);
+    get(this->_caught_exceptions).dump(o);
     o << ", propagated_exceptions=";
-    this->_propagated_exceptions.dump(o);
+    get(this->_propagated_exceptions).dump(o);
     o << ")";
   }
 
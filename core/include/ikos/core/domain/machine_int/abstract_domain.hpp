@@ -43,6 +43,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <ikos/core/domain/abstract_domain.hpp>
 #include <ikos/core/domain/machine_int/operator.hpp>
 #include <ikos/core/linear_expression.hpp>
@@ -167,6 +169,16 @@ public:
   /// \brief Forget a variable
   virtual void forget(VariableRef x) = 0;
 
+  /// \brief Forget a set of variables
+  virtual void forget_vars(const std::vector< VariableRef >& vars) {
+    for (VariableRef x : vars) {
+      this->forget(x);
+    }
+  }
+
+  /// \brief Forget all variables except the given ones
+  virtual void project(const std::vector< VariableRef >& keep) = 0;
+
   /// \brief Normalize the abstract value
   virtual void normalize() const = 0;
 
@@ -305,6 +305,10 @@ public:
 
   void forget(VariableRef x) override { this->_inv.forget(x); }
 
+  void project(const std::vector< VariableRef >& keep) override {
+    this->_inv.project(keep);
+  }
+
   void normalize() const override {}
 
   Interval to_interval(VariableRef x) const override {
@@ -0,0 +1,837 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Separate domain of intervals stored in dense arrays
+ *
+ * Every machine integer variable whose bounds fit in an int64_t is given a
+ * slot, and an abstract value stores the lower and upper bounds of all slots
+ * in two contiguous arrays. Lattice operations are then straight loops over
+ * these arrays, that the compiler can vectorize.
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <ikos/core/domain/machine_int/interval.hpp>
+#include <ikos/core/domain/machine_int/separate_domain.hpp>
+#include <ikos/core/value/machine_int/interval.hpp>
+
+namespace ikos {
+namespace core {
+namespace machine_int {
+
+/// \brief Table of dense slots for machine integer variables
+///
+/// Slots are allocated once, in a table shared by all threads, and never
+/// freed. Each thread keeps a copy of the table, so that looking up a slot
+/// only takes the lock for variables it has not seen yet.
+///
+/// If the index of a destroyed variable is reused by a variable of another
+/// type, the new variable is given a new slot.
+template < typename VariableRef >
+class DenseIntervalSlots {
+private:
+  using VariableTrait = machine_int::VariableTraits< VariableRef >;
+
+public:
+  /// \brief Slots and per-slot type metadata
+  struct Table {
+    /// \brief Map from variable index to slot
+    std::unordered_map< Index, std::size_t > slots;
+
+    /// \brief Variable of each slot
+    std::vector< VariableRef > variables;
+
+    /// \brief Bit-width of each slot
+    std::vector< unsigned > bit_widths;
+
+    /// \brief Signedness of each slot
+    std::vector< Signedness > signs;
+
+    /// \brief Smallest value of the type of each slot
+    std::vector< int64_t > min;
+
+    /// \brief Largest value of the type of each slot
+    std::vector< int64_t > max;
+  };
+
+public:
+  /// \brief Return true if the bounds of the given type fit in an int64_t
+  static bool is_dense(unsigned bit_width, Signedness sign) {
+    return bit_width < 64 || (bit_width == 64 && sign == Signed);
+  }
+
+  /// \brief Return true if the bounds of the given variable fit in an int64_t
+  static bool is_dense(VariableRef x) {
+    return is_dense(VariableTrait::bit_width(x), VariableTrait::sign(x));
+  }
+
+  /// \brief Return the slot of the given variable, allocating it if needed
+  static std::size_t slot(VariableRef x) {
+    ikos_assert(is_dense(x));
+    Index index = IndexableTraits< VariableRef >::index(x);
+    unsigned bit_width = VariableTrait::bit_width(x);
+    Signedness sign = VariableTrait::sign(x);
+    Table& local = local_table();
+    auto it = local.slots.find(index);
+    if (it != local.slots.end() &&
+        has_type(local, it->second, bit_width, sign)) {
+      return it->second;
+    }
+
+    std::lock_guard< std::mutex > lock(mutex());
+    Table& global = global_table();
+    it = global.slots.find(index);
+    if (it == global.slots.end() ||
+        !has_type(global, it->second, bit_width, sign)) {
+      // New variable, or the index of a destroyed variable was reused
+      global.slots[index] = global.variables.size();
+      global.variables.push_back(x);
+      global.bit_widths.push_back(bit_width);
+      global.signs.push_back(sign);
+      global.min.push_back(MachineInt::min(bit_width, sign).to< int64_t >());
+      global.max.push_back(MachineInt::max(bit_width, sign).to< int64_t >());
+    }
+    synchronize(local, global);
+    return local.slots.at(index);
+  }
+
+  /// \brief Return a table with at least the first `n` slots
+  static const Table& table(std::size_t n) {
+    Table& local = local_table();
+    if (local.variables.size() < n) {
+      std::lock_guard< std::mutex > lock(mutex());
+      synchronize(local, global_table());
+    }
+    ikos_assert(local.variables.size() >= n);
+    return local;
+  }
+
+private:
+  /// \brief Return true if the given slot has the given type
+  static bool has_type(const Table& table,
+                       std::size_t slot,
+                       unsigned bit_width,
+                       Signedness sign) {
+    return table.bit_widths[slot] == bit_width && table.signs[slot] == sign;
+  }
+
+  /// \brief Copy the slots of `global` missing in `local`
+  static void synchronize(Table& local, const Table& global) {
+    for (std::size_t i = local.variables.size(); i < global.variables.size();
+         i++) {
+      local.slots[IndexableTraits< VariableRef >::index(global.variables[i])] =
+          i;
+      local.variables.push_back(global.variables[i]);
+      local.bit_widths.push_back(global.bit_widths[i]);
+      local.signs.push_back(global.signs[i]);
+      local.min.push_back(global.min[i]);
+      local.max.push_back(global.max[i]);
+    }
+  }
+
+  /// \brief Return the table shared by all threads
+  static Table& global_table() {
+    static Table table;
+    return table;
+  }
+
+  /// \brief Return the lock of the shared table
+  static std::mutex& mutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  /// \brief Return the copy of the table for the current thread
+  static Table& local_table() {
+    static thread_local Table table;
+    return table;
+  }
+
+}; // end class DenseIntervalSlots
+
+/// \brief Separate domain of intervals stored in dense arrays
+///
+/// This has the same interface as SeparateDomain< VariableRef, Interval >.
+///
+/// The bounds of the variables with a dense slot are stored in two arrays,
+/// indexed by slot. A slot past the end of the arrays is top. The other
+/// variables (e.g, 64-bit unsigned or 128-bit integers) fall back to a
+/// SeparateDomain.
+template < typename VariableRef >
+class DenseSeparateIntervalDomain final
+    : public core::AbstractDomain<
+          DenseSeparateIntervalDomain< VariableRef > > {
+public:
+  static_assert(
+      core::IsVariable< VariableRef >::value,
+      "VariableRef does not meet the requirements for variable types");
+  static_assert(machine_int::IsVariable< VariableRef >::value,
+                "VariableRef must implement machine_int::VariableTraits");
+
+private:
+  using VariableTrait = machine_int::VariableTraits< VariableRef >;
+  using Slots = DenseIntervalSlots< VariableRef >;
+  using SlotTable = typename Slots::Table;
+  using WideDomainT = SeparateDomain< VariableRef, Interval >;
+
+public:
+  using LinearExpressionT = LinearExpression< MachineInt, VariableRef >;
+
+private:
+  /// \brief Lower bounds, indexed by slot
+  std::vector< int64_t > _lb;
+
+  /// \brief Upper bounds, indexed by slot
+  std::vector< int64_t > _ub;
+
+  /// \brief Intervals of the variables without a dense slot
+  WideDomainT _wide;
+
+  bool _is_bottom;
+
+private:
+  struct TopTag {};
+  struct BottomTag {};
+
+  /// \brief Create the top abstract value
+  explicit DenseSeparateIntervalDomain(TopTag)
+      : _wide(WideDomainT::top()), _is_bottom(false) {}
+
+  /// \brief Create the bottom abstract value
+  explicit DenseSeparateIntervalDomain(BottomTag)
+      : _wide(WideDomainT::top()), _is_bottom(true) {}
+
+public:
+  /// \brief Iterator over the pairs (variable, interval)
+  ///
+  /// Top intervals are skipped.
+  class Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = const std::pair< VariableRef, Interval >;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::pair< VariableRef, Interval >*;
+    using reference = const std::pair< VariableRef, Interval >&;
+
+  private:
+    using WideIterator = typename WideDomainT::Iterator;
+
+  private:
+    const DenseSeparateIntervalDomain* _inv;
+    std::size_t _slot;
+    WideIterator _wide_it;
+    WideIterator _wide_end;
+    boost::optional< std::pair< VariableRef, Interval > > _current;
+
+  public:
+    /// \brief Create an iterator starting at the given slot
+    Iterator(const DenseSeparateIntervalDomain* inv,
+             std::size_t slot,
+             WideIterator wide_it,
+             WideIterator wide_end)
+        : _inv(inv),
+          _slot(slot),
+          _wide_it(std::move(wide_it)),
+          _wide_end(std::move(wide_end)) {
+      this->settle();
+    }
+
+    Iterator& operator++() {
+      if (this->_slot < this->_inv->_lb.size()) {
+        ++this->_slot;
+      } else {
+        ++this->_wide_it;
+      }
+      this->settle();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator r = *this;
+      ++(*this);
+      return r;
+    }
+
+    reference operator*() const { return *this->_current; }
+
+    pointer operator->() const { return &*this->_current; }
+
+    bool operator==(const Iterator& other) const {
+      return this->_slot == other._slot && this->_wide_it == other._wide_it;
+    }
+
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+  private:
+    /// \brief Move to the next non-top interval and load it
+    void settle() {
+      std::size_t n = this->_inv->_lb.size();
+      const SlotTable& table = Slots::table(n);
+      for (; this->_slot < n; ++this->_slot) {
+        if (!this->_inv->is_top_slot(table, this->_slot)) {
+          this->_current.emplace(table.variables[this->_slot],
+                                 this->_inv->get_slot(table, this->_slot));
+          return;
+        }
+      }
+      if (this->_wide_it != this->_wide_end) {
+        this->_current.emplace(*this->_wide_it);
+      } else {
+        this->_current = boost::none;
+      }
+    }
+
+  }; // end class Iterator
+
+public:
+  /// \brief Create the top abstract value
+  DenseSeparateIntervalDomain() : DenseSeparateIntervalDomain(TopTag{}) {}
+
+  /// \brief Copy constructor
+  DenseSeparateIntervalDomain(const DenseSeparateIntervalDomain&) = default;
+
+  /// \brief Move constructor
+  DenseSeparateIntervalDomain(DenseSeparateIntervalDomain&&) = default;
+
+  /// \brief Copy assignment operator
+  DenseSeparateIntervalDomain& operator=(const DenseSeparateIntervalDomain&) =
+      default;
+
+  /// \brief Move assignment operator
+  DenseSeparateIntervalDomain& operator=(DenseSeparateIntervalDomain&&) =
+      default;
+
+  /// \brief Destructor
+  ~DenseSeparateIntervalDomain() override = default;
+
+  /// \brief Create the top abstract value
+  static DenseSeparateIntervalDomain top() {
+    return DenseSeparateIntervalDomain(TopTag{});
+  }
+
+  /// \brief Create the bottom abstract value
+  static DenseSeparateIntervalDomain bottom() {
+    return DenseSeparateIntervalDomain(BottomTag{});
+  }
+
+  /// \brief Begin iterator over the pairs (variable, interval)
+  Iterator begin() const {
+    ikos_assert(!this->is_bottom());
+    return Iterator(this, 0, this->_wide.begin(), this->_wide.end());
+  }
+
+  /// \brief End iterator over the pairs (variable, interval)
+  Iterator end() const {
+    ikos_assert(!this->is_bottom());
+    return Iterator(this,
+                    this->_lb.size(),
+                    this->_wide.end(),
+                    this->_wide.end());
+  }
+
+  bool is_bottom() const override { return this->_is_bottom; }
+
+  bool is_top() const override {
+    if (this->is_bottom() || !this->_wide.is_top()) {
+      return false;
+    }
+    std::size_t n = this->_lb.size();
+    const SlotTable& table = Slots::table(n);
+    const int64_t* lb = this->_lb.data();
+    const int64_t* ub = this->_ub.data();
+    const int64_t* min = table.min.data();
+    const int64_t* max = table.max.data();
+    bool top = true;
+    for (std::size_t i = 0; i < n; i++) {
+      top &= (lb[i] == min[i]) & (ub[i] == max[i]);
+    }
+    return top;
+  }
+
+  void set_to_bottom() override {
+    this->_is_bottom = true;
+    this->_lb.clear();
+    this->_ub.clear();
+    this->_wide.set_to_top();
+  }
+
+  void set_to_top() override {
+    this->_is_bottom = false;
+    this->_lb.clear();
+    this->_ub.clear();
+    this->_wide.set_to_top();
+  }
+
+  bool leq(const DenseSeparateIntervalDomain& other) const override {
+    if (this->is_bottom()) {
+      return true;
+    } else if (other.is_bottom()) {
+      return false;
+    }
+
+    std::size_t n = std::min(this->_lb.size(), other._lb.size());
+    const int64_t* lb = this->_lb.data();
+    const int64_t* ub = this->_ub.data();
+    const int64_t* other_lb = other._lb.data();
+    const int64_t* other_ub = other._ub.data();
+    bool result = true;
+    for (std::size_t i = 0; i < n; i++) {
+      result &= (other_lb[i] <= lb[i]) & (ub[i] <= other_ub[i]);
+    }
+
+    // Past the end of this->_lb, this is top so `other` has to be top
+    result = result && other.is_top_from(this->_lb.size());
+
+    return result && this->_wide.leq(other._wide);
+  }
+
+  bool equals(const DenseSeparateIntervalDomain& other) const override {
+    if (this->is_bottom()) {
+      return other.is_bottom();
+    } else if (other.is_bottom()) {
+      return false;
+    }
+
+    std::size_t n = std::min(this->_lb.size(), other._lb.size());
+    const int64_t* lb = this->_lb.data();
+    const int64_t* ub = this->_ub.data();
+    const int64_t* other_lb = other._lb.data();
+    const int64_t* other_ub = other._ub.data();
+    bool result = true;
+    for (std::size_t i = 0; i < n; i++) {
+      result &= (lb[i] == other_lb[i]) & (ub[i] == other_ub[i]);
+    }
+
+    result = result && this->is_top_from(other._lb.size()) &&
+             other.is_top_from(this->_lb.size());
+
+    return result && this->_wide.equals(other._wide);
+  }
+
+  void join_with(const DenseSeparateIntervalDomain& other) override {
+    if (other.is_bottom()) {
+      return;
+    } else if (this->is_bottom()) {
+      this->operator=(other);
+      return;
+    }
+
+    // Slots past the end of either value are top
+    std::size_t n = std::min(this->_lb.size(), other._lb.size());
+    this->_lb.resize(n);
+    this->_ub.resize(n);
+    int64_t* lb = this->_lb.data();
+    int64_t* ub = this->_ub.data();
+    const int64_t* other_lb = other._lb.data();
+    const int64_t* other_ub = other._ub.data();
+    for (std::size_t i = 0; i < n; i++) {
+      lb[i] = std::min(lb[i], other_lb[i]);
+      ub[i] = std::max(ub[i], other_ub[i]);
+    }
+
+    this->_wide.join_with(other._wide);
+  }
+
+  void widen_with(const DenseSeparateIntervalDomain& other) override {
+    if (other.is_bottom()) {
+      return;
+    } else if (this->is_bottom()) {
+      this->operator=(other);
+      return;
+    }
+
+    std::size_t n = std::min(this->_lb.size(), other._lb.size());
+    this->_lb.resize(n);
+    this->_ub.resize(n);
+    const SlotTable& table = Slots::table(n);
+    int64_t* lb = this->_lb.data();
+    int64_t* ub = this->_ub.data();
+    const int64_t* other_lb = other._lb.data();
+    const int64_t* other_ub = other._ub.data();
+    const int64_t* min = table.min.data();
+    const int64_t* max = table.max.data();
+    for (std::size_t i = 0; i < n; i++) {
+      lb[i] = other_lb[i] < lb[i] ? min[i] : lb[i];
+      ub[i] = ub[i] < other_ub[i] ? max[i] : ub[i];
+    }
+
+    this->_wide.widen_with(other._wide);
+  }
+
+  void widen_threshold_with(const DenseSeparateIntervalDomain& other,
+                            const MachineInt& threshold) {
+    if (other.is_bottom()) {
+      return;
+    } else if (this->is_bottom()) {
+      this->operator=(other);
+      return;
+    }
+
+    std::size_t n = std::min(this->_lb.size(), other._lb.size());
+    this->_lb.resize(n);
+    this->_ub.resize(n);
+    const SlotTable& table = Slots::table(n);
+    for (std::size_t i = 0; i < n; i++) {
+      if (other._lb[i] < this->_lb[i] || this->_ub[i] < other._ub[i]) {
+        this->set_slot(i,
+                       this->get_slot(table, i)
+                           .widening_threshold(other.get_slot(table, i),
+                                               threshold));
+      }
+    }
+
+    this->_wide.widen_threshold_with(other._wide, threshold);
+  }
+
+  void meet_with(const DenseSeparateIntervalDomain& other) override {
+    if (this->is_bottom()) {
+      return;
+    } else if (other.is_bottom()) {
+      this->set_to_bottom();
+      return;
+    }
+
+    // Slots past the end of `other` are top
+    std::size_t n = other._lb.size();
+    this->extend(n);
+    int64_t* lb = this->_lb.data();
+    int64_t* ub = this->_ub.data();
+    const int64_t* other_lb = other._lb.data();
+    const int64_t* other_ub = other._ub.data();
+    bool empty = false;
+    for (std::size_t i = 0; i < n; i++) {
+      lb[i] = std::max(lb[i], other_lb[i]);
+      ub[i] = std::min(ub[i], other_ub[i]);
+      empty |= lb[i] > ub[i];
+    }
+
+    this->_wide.meet_with(other._wide);
+
+    if (empty || this->_wide.is_bottom()) {
+      this->set_to_bottom();
+    }
+  }
+
+  void narrow_with(const DenseSeparateIntervalDomain& other) override {
+    if (this->is_bottom()) {
+      return;
+    } else if (other.is_bottom()) {
+      this->set_to_bottom();
+      return;
+    }
+
+    std::size_t n = other._lb.size();
+    this->extend(n);
+    const SlotTable& table = Slots::table(n);
+    int64_t* lb = this->_lb.data();
+    int64_t* ub = this->_ub.data();
+    const int64_t* other_lb = other._lb.data();
+    const int64_t* other_ub = other._ub.data();
+    const int64_t* min = table.min.data();
+    const int64_t* max = table.max.data();
+    bool empty = false;
+    for (std::size_t i = 0; i < n; i++) {
+      lb[i] = lb[i] == min[i] ? other_lb[i] : lb[i];
+      ub[i] = ub[i] == max[i] ? other_ub[i] : ub[i];
+      empty |= lb[i] > ub[i];
+    }
+
+    this->_wide.narrow_with(other._wide);
+
+    if (empty || this->_wide.is_bottom()) {
+      this->set_to_bottom();
+    }
+  }
+
+  /// \brief Get the interval of the given variable
+  Interval get(VariableRef x) const {
+    if (this->is_bottom()) {
+      return Interval::bottom(VariableTrait::bit_width(x),
+                              VariableTrait::sign(x));
+    } else if (!Slots::is_dense(x)) {
+      return this->_wide.get(x);
+    }
+
+    std::size_t slot = Slots::slot(x);
+    if (slot >= this->_lb.size()) {
+      return Interval::top(VariableTrait::bit_width(x),
+                           VariableTrait::sign(x));
+    }
+    return this->get_slot(Slots::table(slot + 1), slot);
+  }
+
+  /// \brief Set the interval of the given variable
+  void set(VariableRef x, const Interval& value) {
+    if (this->is_bottom()) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else if (!Slots::is_dense(x)) {
+      this->_wide.set(x, value);
+    } else {
+      std::size_t slot = Slots::slot(x);
+      if (slot >= this->_lb.size() && value.is_top()) {
+        return;
+      }
+      this->extend(slot + 1);
+      this->set_slot(slot, value);
+    }
+  }
+
+  /// \brief Refine the interval of the given variable
+  void refine(VariableRef x, const Interval& value) {
+    if (this->is_bottom()) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else if (value.is_top()) {
+      return;
+    } else {
+      Interval i = this->get(x).meet(value);
+      if (i.is_bottom()) {
+        this->set_to_bottom();
+      } else {
+        this->set(x, i);
+      }
+    }
+  }
+
+  /// \brief Projection
+  ///
+  /// Return an overapproximation of the linear expression e as an interval
+  ///
+  /// Note that it wraps on integer overflow.
+  /// Note that it will automatically cast variables to the type of
+  /// `e.constant()`.
+  Interval project(const LinearExpressionT& e) const {
+    // Result type
+    unsigned bit_width = e.constant().bit_width();
+    Signedness sign = e.constant().sign();
+
+    if (this->is_bottom()) {
+      return Interval::bottom(bit_width, sign);
+    }
+
+    Interval r(e.constant());
+    for (const auto& term : e) {
+      r = add(r,
+              mul(Interval(term.second),
+                  this->get(term.first).cast(bit_width, sign)));
+    }
+    return r;
+  }
+
+  /// \brief Forget the interval of the given variable
+  void forget(VariableRef x) {
+    if (this->is_bottom()) {
+      return;
+    } else if (!Slots::is_dense(x)) {
+      this->_wide.forget(x);
+    } else {
+      std::size_t slot = Slots::slot(x);
+      if (slot < this->_lb.size()) {
+        const SlotTable& table = Slots::table(slot + 1);
+        this->_lb[slot] = table.min[slot];
+        this->_ub[slot] = table.max[slot];
+      }
+    }
+  }
+
+  /// \brief Forget the interval of all variables except the given ones
+  void project(std::vector< VariableRef > keep) {
+    if (this->is_bottom()) {
+      return;
+    }
+
+    std::sort(keep.begin(), keep.end());
+    std::size_t n = this->_lb.size();
+    const SlotTable& table = Slots::table(n);
+    for (std::size_t slot = 0; slot < n; slot++) {
+      if (!std::binary_search(keep.begin(),
+                              keep.end(),
+                              table.variables[slot])) {
+        this->_lb[slot] = table.min[slot];
+        this->_ub[slot] = table.max[slot];
+      }
+    }
+    this->_wide.project(std::move(keep));
+  }
+
+  /// \brief Assign `x = n`
+  void assign(VariableRef x, const MachineInt& n) {
+    this->set(x, Interval(n));
+  }
+
+  /// \brief Assign `x = n`
+  void assign(VariableRef x, VariableRef y) { this->set(x, this->get(y)); }
+
+  /// \brief Assign `x = e`
+  ///
+  /// Note that it wraps on integer overflow.
+  /// Note that it will automatically cast variables to the type of `x`.
+  void assign(VariableRef x, const LinearExpressionT& e) {
+    this->set(x, this->project(e));
+  }
+
+  /// \brief Apply `x = op y`
+  void apply(UnaryOperator op, VariableRef x, VariableRef y) {
+    this->set(x,
+              apply_unary_operator(op,
+                                   this->get(y),
+                                   VariableTrait::bit_width(x),
+                                   VariableTrait::sign(x)));
+  }
+
+  /// \brief Apply `x = y op z`
+  void apply(BinaryOperator op, VariableRef x, VariableRef y, VariableRef z) {
+    this->set(x, apply_bin_operator(op, this->get(y), this->get(z)));
+  }
+
+  /// \brief Apply `x = y op z`
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             const MachineInt& z) {
+    this->set(x, apply_bin_operator(op, this->get(y), Interval(z)));
+  }
+
+  /// \brief Apply `x = y op z`
+  void apply(BinaryOperator op,
+             VariableRef x,
+             const MachineInt& y,
+             VariableRef z) {
+    this->set(x, apply_bin_operator(op, Interval(y), this->get(z)));
+  }
+
+  void dump(std::ostream& o) const override {
+    if (this->is_bottom()) {
+      o << "⊥";
+      return;
+    }
+    o << "{";
+    for (auto it = this->begin(), et = this->end(); it != et;) {
+      DumpableTraits< VariableRef >::dump(o, it->first);
+      o << " -> ";
+      it->second.dump(o);
+      ++it;
+      if (it != et) {
+        o << "; ";
+      }
+    }
+    o << "}";
+  }
+
+  static std::string name() { return "dense separate domain of intervals"; }
+
+private:
+  /// \brief Extend the arrays up to `n` slots, with top intervals
+  void extend(std::size_t n) {
+    std::size_t size = this->_lb.size();
+    if (size >= n) {
+      return;
+    }
+    const SlotTable& table = Slots::table(n);
+    this->_lb.insert(this->_lb.end(),
+                     table.min.begin() + size,
+                     table.min.begin() + n);
+    this->_ub.insert(this->_ub.end(),
+                     table.max.begin() + size,
+                     table.max.begin() + n);
+  }
+
+  /// \brief Return true if all the slots from `slot` are top
+  bool is_top_from(std::size_t slot) const {
+    std::size_t n = this->_lb.size();
+    if (slot >= n) {
+      return true;
+    }
+    const SlotTable& table = Slots::table(n);
+    bool top = true;
+    for (std::size_t i = slot; i < n; i++) {
+      top &= (this->_lb[i] == table.min[i]) & (this->_ub[i] == table.max[i]);
+    }
+    return top;
+  }
+
+  /// \brief Return true if the given slot is top
+  bool is_top_slot(const SlotTable& table, std::size_t slot) const {
+    return this->_lb[slot] == table.min[slot] &&
+           this->_ub[slot] == table.max[slot];
+  }
+
+  /// \brief Return the interval of the given slot
+  Interval get_slot(const SlotTable& table, std::size_t slot) const {
+    unsigned bit_width = table.bit_widths[slot];
+    Signedness sign = table.signs[slot];
+    return Interval(MachineInt(this->_lb[slot], bit_width, sign),
+                    MachineInt(this->_ub[slot], bit_width, sign));
+  }
+
+  /// \brief Set the interval of the given slot
+  ///
+  /// The interval must not be bottom.
+  void set_slot(std::size_t slot, const Interval& value) {
+    ikos_assert(!value.is_bottom());
+    this->_lb[slot] = value.lb().template to< int64_t >();
+    this->_ub[slot] = value.ub().template to< int64_t >();
+  }
+
+}; // end class DenseSeparateIntervalDomain
+
+/// \brief Machine integer interval abstract domain, using dense arrays
+template < typename VariableRef >
+using DenseIntervalDomain =
+    IntervalDomain< VariableRef, DenseSeparateIntervalDomain< VariableRef > >;
+
+} // end namespace machine_int
+} // end namespace core
+} // end namespace ikos
@@ -192,6 +192,8 @@ public:
 
   void forget(VariableRef) override {}
 
+  void project(const std::vector< VariableRef >&) override {}
+
   void normalize() const override {}
 
   Interval to_interval(VariableRef x) const override {
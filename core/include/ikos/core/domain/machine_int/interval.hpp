@@ -71,14 +71,20 @@ inline Interval trim_bound(const Interval& i, const MachineInt& b) {
 }
 
 /// \brief Machine integer interval abstract domain
-template < typename VariableRef >
+///
+/// The intervals are stored in SeparateDomainT, which defaults to a patricia
+/// tree of intervals. See DenseSeparateIntervalDomain for an alternative.
+template < typename VariableRef,
+           typename SeparateDomainT =
+               machine_int::SeparateDomain< VariableRef, Interval > >
 class IntervalDomain final
-    : public machine_int::AbstractDomain< VariableRef,
-                                          IntervalDomain< VariableRef > > {
+    : public machine_int::AbstractDomain<
+          VariableRef,
+          IntervalDomain< VariableRef, SeparateDomainT > > {
 private:
-  using Parent =
-      machine_int::AbstractDomain< VariableRef, IntervalDomain< VariableRef > >;
-  using SeparateDomainT = machine_int::SeparateDomain< VariableRef, Interval >;
+  using Parent = machine_int::AbstractDomain<
+      VariableRef,
+      IntervalDomain< VariableRef, SeparateDomainT > >;
   using VariableTrait = machine_int::VariableTraits< VariableRef >;
 
 public:
@@ -351,6 +357,10 @@ public:
 
   void forget(VariableRef x) override { this->_inv.forget(x); }
 
+  void project(const std::vector< VariableRef >& keep) override {
+    this->_inv.project(keep);
+  }
+
   void normalize() const override {}
 
   Interval to_interval(VariableRef x) const override {
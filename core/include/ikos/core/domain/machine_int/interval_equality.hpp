@@ -0,0 +1,641 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Reduced product of intervals and variable equalities for machine
+ * integers
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <ikos/core/adt/patricia_tree/map.hpp>
+#include <ikos/core/adt/patricia_tree/set.hpp>
+#include <ikos/core/domain/machine_int/abstract_domain.hpp>
+#include <ikos/core/domain/machine_int/interval.hpp>
+#include <ikos/core/semantic/dumpable.hpp>
+#include <ikos/core/semantic/indexable.hpp>
+
+namespace ikos {
+namespace core {
+namespace machine_int {
+
+/// \brief Reduced product of intervals and equalities between variables on
+/// machine integers
+///
+/// Variables known to be equal are grouped in classes, stored as a flattened
+/// union-find: each variable of a class with several members is mapped to the
+/// representative of its class, and each representative to the members of its
+/// class. Variables alone in their class are not stored.
+///
+/// All the members of a class have the same interval. Projections of linear
+/// expressions replace each variable by its representative, so that `x - y`
+/// is zero when `x = y`, at the cost of the interval domain.
+template < typename VariableRef >
+class IntervalEqualityDomain final
+    : public machine_int::AbstractDomain<
+          VariableRef,
+          IntervalEqualityDomain< VariableRef > > {
+private:
+  using Parent =
+      machine_int::AbstractDomain< VariableRef,
+                                   IntervalEqualityDomain< VariableRef > >;
+  using IntervalDomainT = IntervalDomain< VariableRef >;
+  using VariableSet = PatriciaTreeSet< VariableRef >;
+  using RepresentativeMap = PatriciaTreeMap< VariableRef, VariableRef >;
+  using ClassMap = PatriciaTreeMap< VariableRef, VariableSet >;
+
+public:
+  using LinearExpressionT = LinearExpression< MachineInt, VariableRef >;
+
+private:
+  /// \brief Intervals
+  IntervalDomainT _intervals;
+
+  /// \brief Map from a variable to the representative of its class
+  RepresentativeMap _reps;
+
+  /// \brief Map from a representative to the members of its class
+  ClassMap _classes;
+
+private:
+  /// \brief Private constructor
+  explicit IntervalEqualityDomain(IntervalDomainT intervals)
+      : _intervals(std::move(intervals)) {}
+
+public:
+  /// \brief Create the top abstract value
+  IntervalEqualityDomain() : _intervals(IntervalDomainT::top()) {}
+
+  /// \brief Copy constructor
+  IntervalEqualityDomain(const IntervalEqualityDomain&) = default;
+
+  /// \brief Move constructor
+  IntervalEqualityDomain(IntervalEqualityDomain&&) = default;
+
+  /// \brief Copy assignment operator
+  IntervalEqualityDomain& operator=(const IntervalEqualityDomain&) = default;
+
+  /// \brief Move assignment operator
+  IntervalEqualityDomain& operator=(IntervalEqualityDomain&&) = default;
+
+  /// \brief Destructor
+  ~IntervalEqualityDomain() override = default;
+
+  /// \brief Create the top abstract value
+  static IntervalEqualityDomain top() {
+    return IntervalEqualityDomain(IntervalDomainT::top());
+  }
+
+  /// \brief Create the bottom abstract value
+  static IntervalEqualityDomain bottom() {
+    return IntervalEqualityDomain(IntervalDomainT::bottom());
+  }
+
+  bool is_bottom() const override { return this->_intervals.is_bottom(); }
+
+  bool is_top() const override {
+    return this->_intervals.is_top() && this->_reps.empty();
+  }
+
+  void set_to_bottom() override {
+    this->_intervals.set_to_bottom();
+    this->_reps.clear();
+    this->_classes.clear();
+  }
+
+  void set_to_top() override {
+    this->_intervals.set_to_top();
+    this->_reps.clear();
+    this->_classes.clear();
+  }
+
+  bool leq(const IntervalEqualityDomain& other) const override {
+    if (this->is_bottom()) {
+      return true;
+    } else if (other.is_bottom()) {
+      return false;
+    }
+    if (!this->_intervals.leq(other._intervals)) {
+      return false;
+    }
+    for (const auto& entry : other._reps) {
+      if (this->find(entry.first) != this->find(entry.second)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool equals(const IntervalEqualityDomain& other) const override {
+    return this->leq(other) && other.leq(*this);
+  }
+
+  void join_with(const IntervalEqualityDomain& other) override {
+    if (other.is_bottom()) {
+      return;
+    } else if (this->is_bottom()) {
+      this->operator=(other);
+    } else {
+      this->_intervals.join_with(other._intervals);
+      this->join_classes(other);
+    }
+  }
+
+  void widen_with(const IntervalEqualityDomain& other) override {
+    if (other.is_bottom()) {
+      return;
+    } else if (this->is_bottom()) {
+      this->operator=(other);
+    } else {
+      this->_intervals.widen_with(other._intervals);
+      this->join_classes(other);
+    }
+  }
+
+  void widen_threshold_with(const IntervalEqualityDomain& other,
+                            const MachineInt& threshold) override {
+    if (other.is_bottom()) {
+      return;
+    } else if (this->is_bottom()) {
+      this->operator=(other);
+    } else {
+      this->_intervals.widen_threshold_with(other._intervals, threshold);
+      this->join_classes(other);
+    }
+  }
+
+  void meet_with(const IntervalEqualityDomain& other) override {
+    if (this->is_bottom()) {
+      return;
+    } else if (other.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      this->_intervals.meet_with(other._intervals);
+      this->reduce();
+      for (const auto& entry : other._reps) {
+        this->add_equality(entry.first, entry.second);
+      }
+    }
+  }
+
+  void narrow_with(const IntervalEqualityDomain& other) override {
+    if (this->is_bottom()) {
+      return;
+    } else if (other.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      this->_intervals.narrow_with(other._intervals);
+      this->reduce();
+    }
+  }
+
+  void assign(VariableRef x, const MachineInt& n) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->detach(x);
+    this->_intervals.assign(x, n);
+  }
+
+  void assign(VariableRef x, VariableRef y) override {
+    if (this->is_bottom() || x == y) {
+      return;
+    }
+    this->detach(x);
+    this->_intervals.assign(x, y);
+    this->merge(x, y);
+  }
+
+  void assign(VariableRef x, const LinearExpressionT& e) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    if (boost::optional< VariableRef > y = e.variable()) {
+      this->assign(x, *y);
+      return;
+    }
+    Interval value = this->to_interval(e);
+    this->detach(x);
+    this->_intervals.set(x, value);
+  }
+
+  void apply(UnaryOperator op, VariableRef x, VariableRef y) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->detach(x);
+    this->_intervals.apply(op, x, y);
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             VariableRef z) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    if ((op == BinaryOperator::Sub || op == BinaryOperator::SubNoWrap ||
+         op == BinaryOperator::Xor) &&
+        this->find(y) == this->find(z)) {
+      // x = y - y
+      Interval value = this->to_interval(y);
+      this->assign(x, MachineInt::zero(value.bit_width(), value.sign()));
+      return;
+    }
+    this->detach(x);
+    this->_intervals.apply(op, x, y, z);
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             const MachineInt& z) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->detach(x);
+    this->_intervals.apply(op, x, y, z);
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             const MachineInt& y,
+             VariableRef z) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->detach(x);
+    this->_intervals.apply(op, x, y, z);
+  }
+
+  void add(Predicate pred, VariableRef x, VariableRef y) override {
+    if (this->is_bottom()) {
+      return;
+    }
+
+    if (this->find(x) == this->find(y)) {
+      switch (pred) {
+        case Predicate::EQ:
+        case Predicate::GE:
+        case Predicate::LE: {
+          // Always true
+        } break;
+        case Predicate::NE:
+        case Predicate::GT:
+        case Predicate::LT: {
+          this->set_to_bottom();
+        } break;
+      }
+      return;
+    }
+
+    if (pred == Predicate::EQ) {
+      this->add_equality(x, y);
+    } else {
+      this->_intervals.add(pred, x, y);
+      this->propagate(x);
+      this->propagate(y);
+    }
+  }
+
+  void add(Predicate pred, VariableRef x, const MachineInt& y) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->_intervals.add(pred, x, y);
+    this->propagate(x);
+  }
+
+  void add(Predicate pred, const MachineInt& x, VariableRef y) override {
+    Parent::add(pred, x, y);
+  }
+
+  void set(VariableRef x, const Interval& value) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->detach(x);
+    this->_intervals.set(x, value);
+  }
+
+  void set(VariableRef x, const Congruence& value) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->detach(x);
+    this->_intervals.set(x, value);
+  }
+
+  void set(VariableRef x, const IntervalCongruence& value) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->detach(x);
+    this->_intervals.set(x, value);
+  }
+
+  void refine(VariableRef x, const Interval& value) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->_intervals.refine(x, value);
+    this->propagate(x);
+  }
+
+  void refine(VariableRef x, const Congruence& value) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->_intervals.refine(x, value);
+    this->propagate(x);
+  }
+
+  void refine(VariableRef x, const IntervalCongruence& value) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->_intervals.refine(x, value);
+    this->propagate(x);
+  }
+
+  void forget(VariableRef x) override {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->detach(x);
+    this->_intervals.forget(x);
+  }
+
+  void project(const std::vector< VariableRef >& keep) override {
+    if (this->is_bottom()) {
+      return;
+    }
+
+    this->_intervals.project(keep);
+
+    VariableSet keep_set(keep.begin(), keep.end());
+    ClassMap classes = this->_classes;
+    this->_reps.clear();
+    this->_classes.clear();
+    for (const auto& entry : classes) {
+      VariableSet members = entry.second.intersect(keep_set);
+      if (members.size() >= 2) {
+        this->insert_class(members);
+      }
+    }
+  }
+
+  void normalize() const override {}
+
+  Interval to_interval(VariableRef x) const override {
+    return this->_intervals.to_interval(x);
+  }
+
+  Interval to_interval(const LinearExpressionT& e) const override {
+    return this->_intervals.to_interval(this->substitute(e));
+  }
+
+  Congruence to_congruence(VariableRef x) const override {
+    return this->_intervals.to_congruence(x);
+  }
+
+  Congruence to_congruence(const LinearExpressionT& e) const override {
+    return this->_intervals.to_congruence(this->substitute(e));
+  }
+
+  IntervalCongruence to_interval_congruence(VariableRef x) const override {
+    return this->_intervals.to_interval_congruence(x);
+  }
+
+  IntervalCongruence to_interval_congruence(
+      const LinearExpressionT& e) const override {
+    return this->_intervals.to_interval_congruence(this->substitute(e));
+  }
+
+  void dump(std::ostream& o) const override {
+    this->_intervals.dump(o);
+    if (this->is_bottom() || this->_classes.empty()) {
+      return;
+    }
+    o << " ∧ {";
+    for (auto it = this->_classes.begin(), et = this->_classes.end();
+         it != et;) {
+      for (auto m_it = it->second.begin(), m_et = it->second.end();
+           m_it != m_et;) {
+        DumpableTraits< VariableRef >::dump(o, *m_it);
+        ++m_it;
+        if (m_it != m_et) {
+          o << " = ";
+        }
+      }
+      ++it;
+      if (it != et) {
+        o << ", ";
+      }
+    }
+    o << "}";
+  }
+
+  static std::string name() { return "interval and equality domain"; }
+
+private:
+  /// \brief Return the representative of the class of `x`
+  VariableRef find(VariableRef x) const {
+    boost::optional< const VariableRef& > rep = this->_reps.at(x);
+    return rep ? *rep : x;
+  }
+
+  /// \brief Return the members of the class of `x`
+  VariableSet members(VariableRef x) const {
+    boost::optional< const VariableRef& > rep = this->_reps.at(x);
+    if (!rep) {
+      return VariableSet{x};
+    }
+    return *this->_classes.at(*rep);
+  }
+
+  /// \brief Insert a new class with the given members
+  ///
+  /// The representative is the first member.
+  void insert_class(const VariableSet& members) {
+    ikos_assert(members.size() >= 2);
+    VariableRef rep = *members.begin();
+    for (VariableRef v : members) {
+      this->_reps.insert_or_assign(v, rep);
+    }
+    this->_classes.insert_or_assign(rep, members);
+  }
+
+  /// \brief Remove `x` from its class
+  void detach(VariableRef x) {
+    boost::optional< const VariableRef& > rep_ref = this->_reps.at(x);
+    if (!rep_ref) {
+      return;
+    }
+    VariableRef rep = *rep_ref;
+    VariableSet members = *this->_classes.at(rep);
+    members.erase(x);
+    this->_reps.erase(x);
+    this->_classes.erase(rep);
+    if (members.size() == 1) {
+      this->_reps.erase(*members.begin());
+    } else if (x == rep) {
+      this->insert_class(members);
+    } else {
+      this->_classes.insert_or_assign(rep, members);
+    }
+  }
+
+  /// \brief Merge the classes of `x` and `y`
+  ///
+  /// Precondition: `x` and `y` have the same interval.
+  void merge(VariableRef x, VariableRef y) {
+    VariableRef rep_x = this->find(x);
+    VariableRef rep_y = this->find(y);
+    if (rep_x == rep_y) {
+      return;
+    }
+    VariableSet members_x = this->members(x);
+    VariableSet members_y = this->members(y);
+
+    // Keep the representative of the largest class
+    if (members_x.size() > members_y.size()) {
+      std::swap(rep_x, rep_y);
+      std::swap(members_x, members_y);
+    }
+    for (VariableRef v : members_x) {
+      this->_reps.insert_or_assign(v, rep_y);
+    }
+    this->_reps.insert_or_assign(rep_y, rep_y);
+    this->_classes.erase(rep_x);
+    members_y.join_with(members_x);
+    this->_classes.insert_or_assign(rep_y, members_y);
+  }
+
+  /// \brief Add the equality `x = y`
+  void add_equality(VariableRef x, VariableRef y) {
+    if (this->is_bottom()) {
+      return;
+    }
+    Interval value = this->to_interval(x).meet(this->to_interval(y));
+    if (value.is_bottom()) {
+      this->set_to_bottom();
+      return;
+    }
+    this->merge(x, y);
+    for (VariableRef v : this->members(x)) {
+      this->_intervals.set(v, value);
+    }
+  }
+
+  /// \brief Copy the interval of `x` to the other members of its class
+  void propagate(VariableRef x) {
+    if (this->is_bottom()) {
+      return;
+    }
+    boost::optional< const VariableRef& > rep = this->_reps.at(x);
+    if (!rep) {
+      return;
+    }
+    Interval value = this->to_interval(x);
+    for (VariableRef v : *this->_classes.at(*rep)) {
+      if (v != x) {
+        this->_intervals.set(v, value);
+      }
+    }
+  }
+
+  /// \brief Give the same interval to all the members of each class
+  void reduce() {
+    for (const auto& entry : this->_classes) {
+      if (this->is_bottom()) {
+        return;
+      }
+      Interval value = this->to_interval(entry.first);
+      for (VariableRef v : entry.second) {
+        value.meet_with(this->to_interval(v));
+      }
+      for (VariableRef v : entry.second) {
+        this->_intervals.set(v, value);
+      }
+    }
+  }
+
+  /// \brief Keep the equalities that hold in both `this` and `other`
+  void join_classes(const IntervalEqualityDomain& other) {
+    // Members of a class of `this` are grouped by their class in `other`
+    using Key = std::pair< Index, Index >;
+    std::map< Key, VariableSet > groups;
+    for (const auto& entry : this->_reps) {
+      Key key(IndexableTraits< VariableRef >::index(entry.second),
+              IndexableTraits< VariableRef >::index(other.find(entry.first)));
+      groups[key].insert(entry.first);
+    }
+
+    this->_reps.clear();
+    this->_classes.clear();
+    for (const auto& group : groups) {
+      if (group.second.size() >= 2) {
+        this->insert_class(group.second);
+      }
+    }
+  }
+
+  /// \brief Replace each variable of `e` by the representative of its class
+  LinearExpressionT substitute(const LinearExpressionT& e) const {
+    if (this->_reps.empty()) {
+      return e;
+    }
+    LinearExpressionT r(e.constant());
+    for (const auto& term : e) {
+      r.add(term.second, this->find(term.first));
+    }
+    return r;
+  }
+
+}; // end class IntervalEqualityDomain
+
+} // end namespace machine_int
+} // end namespace core
+} // end namespace ikos
@@ -43,6 +43,8 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include <ikos/core/domain/machine_int/abstract_domain.hpp>
 #include <ikos/core/domain/numeric/abstract_domain.hpp>
 #include <ikos/core/number/machine_int.hpp>
@@ -95,14 +97,13 @@ public:
 private:
   NumDomain _inv;
 
-private:
-  /// \brief Private constructor
-  explicit NumericDomainAdapter(NumDomain inv) : _inv(std::move(inv)) {}
-
 public:
   /// \brief Create the top abstract value
   NumericDomainAdapter() : _inv(NumDomain::top()) {}
 
+  /// \brief Create an abstract value from the given numerical abstract value
+  explicit NumericDomainAdapter(NumDomain inv) : _inv(std::move(inv)) {}
+
   /// \brief Copy constructor
   NumericDomainAdapter(const NumericDomainAdapter&) = default;
 
@@ -174,11 +175,44 @@ public:
   }
 
 private:
-  /// \brief Return 2**n
-  static ZNumber power_of_2(unsigned n) { return ZNumber(1) << n; }
+  /// \brief Integer constants for a given bit-width
+  struct BitWidthConstants {
+    /// \brief 2**bit_width
+    ZNumber modulus;
+
+    /// \brief 2**(bit_width - 1)
+    ZNumber half_modulus;
+
+    /// \brief Range of signed integers
+    ZInterval signed_range;
+
+    /// \brief Range of unsigned integers
+    ZInterval unsigned_range;
 
-  /// \brief Return 2**n
-  static ZNumber power_of_2(const ZNumber& n) { return ZNumber(1) << n; }
+    /// \brief Range of valid shift amounts, i.e [0, bit_width - 1]
+    ZInterval shift_range;
+
+    explicit BitWidthConstants(unsigned bit_width)
+        : modulus(ZNumber(1) << bit_width),
+          half_modulus(ZNumber(1) << (bit_width - 1)),
+          signed_range(ZBound(-half_modulus), ZBound(half_modulus - 1)),
+          unsigned_range(ZBound(0), ZBound(modulus - 1)),
+          shift_range(ZBound(0), ZBound(ZNumber(bit_width - 1))) {}
+  };
+
+  /// \brief Return the constants for the given bit-width
+  ///
+  /// Constants are computed once per thread, so that large bit-widths do not
+  /// allocate a new GMP integer on every statement.
+  static const BitWidthConstants& constants(unsigned bit_width) {
+    static thread_local std::unordered_map< unsigned, BitWidthConstants > cache;
+
+    auto it = cache.find(bit_width);
+    if (it == cache.end()) {
+      it = cache.emplace(bit_width, BitWidthConstants(bit_width)).first;
+    }
+    return it->second;
+  }
 
   /// \brief Convert a linear expression on machine integers to a linear
   /// expression on integers
@@ -201,17 +235,15 @@ private:
   /// Apply the wrap-around semantic for machine integers of the given bit-width
   /// and sign.
   void wrap(VariableRef x, VariableRef y, unsigned bit_width, Signedness sign) {
+    const BitWidthConstants& c = constants(bit_width);
     if (sign == Signed) {
-      ZNumber n = power_of_2(bit_width);
-      ZNumber m = power_of_2(bit_width - 1);
       // x = ((y + m) mod n) - m
-      this->_inv.apply(ZBinaryOperator::Add, x, y, m);
-      this->_inv.apply(ZBinaryOperator::Mod, x, x, n);
-      this->_inv.apply(ZBinaryOperator::Sub, x, x, m);
+      this->_inv.apply(ZBinaryOperator::Add, x, y, c.half_modulus);
+      this->_inv.apply(ZBinaryOperator::Mod, x, x, c.modulus);
+      this->_inv.apply(ZBinaryOperator::Sub, x, x, c.half_modulus);
     } else if (sign == Unsigned) {
       // x = y mod n
-      ZNumber n = power_of_2(bit_width);
-      this->_inv.apply(ZBinaryOperator::Mod, x, y, n);
+      this->_inv.apply(ZBinaryOperator::Mod, x, y, c.modulus);
     } else {
       ikos_unreachable("unreachable");
     }
@@ -226,7 +258,9 @@ private:
   ///
   /// This truncate the value of `x`, basically ignoring overflows.
   void trunc(VariableRef x, unsigned bit_width, Signedness sign) {
-    this->_inv.refine(x, MachIntInterval::top(bit_width, sign).to_z_interval());
+    const BitWidthConstants& c = constants(bit_width);
+    this->_inv.refine(x,
+                      sign == Signed ? c.signed_range : c.unsigned_range);
   }
 
 public:
@@ -308,8 +342,7 @@ public:
       case MachIntBinaryOperator::Shl: {
         // z has to be between [0, bit_width - 1]
         unsigned bit_width = VariableTrait::bit_width(x);
-        this->_inv.refine(z,
-                          ZInterval(ZBound(0), ZBound(ZNumber(bit_width - 1))));
+        this->_inv.refine(z, constants(bit_width).shift_range);
 
         this->_inv.apply(ZBinaryOperator::Shl, x, y, z);
         this->wrap(x);
@@ -317,8 +350,7 @@ public:
       case MachIntBinaryOperator::ShlNoWrap: {
         // z has to be between [0, bit_width - 1]
         unsigned bit_width = VariableTrait::bit_width(x);
-        this->_inv.refine(z,
-                          ZInterval(ZBound(0), ZBound(ZNumber(bit_width - 1))));
+        this->_inv.refine(z, constants(bit_width).shift_range);
 
         this->_inv.apply(ZBinaryOperator::Shl, x, y, z);
         this->trunc(x);
@@ -326,8 +358,7 @@ public:
       case MachIntBinaryOperator::LShr: {
         // z has to be between [0, bit_width - 1]
         unsigned bit_width = VariableTrait::bit_width(x);
-        this->_inv.refine(z,
-                          ZInterval(ZBound(0), ZBound(ZNumber(bit_width - 1))));
+        this->_inv.refine(z, constants(bit_width).shift_range);
 
         if (VariableTrait::sign(x) == Signed) {
           if (x == z) {
@@ -347,8 +378,7 @@ public:
       case MachIntBinaryOperator::AShr: {
         // z has to be between [0, bit_width - 1]
         unsigned bit_width = VariableTrait::bit_width(x);
-        this->_inv.refine(z,
-                          ZInterval(ZBound(0), ZBound(ZNumber(bit_width - 1))));
+        this->_inv.refine(z, constants(bit_width).shift_range);
 
         if (VariableTrait::sign(x) == Signed) {
           this->_inv.apply(ZBinaryOperator::Shr, x, y, z);
@@ -548,8 +578,7 @@ public:
       case MachIntBinaryOperator::Shl: {
         // z has to be between [0, bit_width - 1]
         unsigned bit_width = VariableTrait::bit_width(x);
-        this->_inv.refine(z,
-                          ZInterval(ZBound(0), ZBound(ZNumber(bit_width - 1))));
+        this->_inv.refine(z, constants(bit_width).shift_range);
 
         this->_inv.apply(ZBinaryOperator::Shl, x, y.to_z_number(), z);
         this->wrap(x);
@@ -557,8 +586,7 @@ public:
       case MachIntBinaryOperator::ShlNoWrap: {
         // z has to be between [0, bit_width - 1]
         unsigned bit_width = VariableTrait::bit_width(x);
-        this->_inv.refine(z,
-                          ZInterval(ZBound(0), ZBound(ZNumber(bit_width - 1))));
+        this->_inv.refine(z, constants(bit_width).shift_range);
 
         this->_inv.apply(ZBinaryOperator::Shl, x, y.to_z_number(), z);
         this->trunc(x);
@@ -566,8 +594,7 @@ public:
       case MachIntBinaryOperator::LShr: {
         // z has to be between [0, bit_width - 1]
         unsigned bit_width = VariableTrait::bit_width(x);
-        this->_inv.refine(z,
-                          ZInterval(ZBound(0), ZBound(ZNumber(bit_width - 1))));
+        this->_inv.refine(z, constants(bit_width).shift_range);
 
         if (VariableTrait::sign(x) == Signed) {
           this->_inv.apply(ZBinaryOperator::Shr,
@@ -585,8 +612,7 @@ public:
       case MachIntBinaryOperator::AShr: {
         // z has to be between [0, bit_width - 1]
         unsigned bit_width = VariableTrait::bit_width(x);
-        this->_inv.refine(z,
-                          ZInterval(ZBound(0), ZBound(ZNumber(bit_width - 1))));
+        this->_inv.refine(z, constants(bit_width).shift_range);
 
         if (VariableTrait::sign(x) == Signed) {
           this->_inv.apply(ZBinaryOperator::Shr, x, y.to_z_number(), z);
@@ -701,6 +727,14 @@ public:
 
   void forget(VariableRef x) override { this->_inv.forget(x); }
 
+  void forget_vars(const std::vector< VariableRef >& vars) override {
+    this->_inv.forget_vars(vars);
+  }
+
+  void project(const std::vector< VariableRef >& keep) override {
+    this->_inv.project(keep);
+  }
+
   void normalize() const override { this->_inv.normalize(); }
 
   MachIntInterval to_interval(VariableRef x) const override {
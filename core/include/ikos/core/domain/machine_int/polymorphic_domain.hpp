@@ -48,6 +48,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <ikos/core/domain/machine_int/abstract_domain.hpp>
 #include <ikos/core/support/assert.hpp>
@@ -200,6 +201,12 @@ private:
     /// \brief Forget a variable
     virtual void forget(VariableRef x) = 0;
 
+    /// \brief Forget a set of variables
+    virtual void forget_vars(const std::vector< VariableRef >& vars) = 0;
+
+    /// \brief Forget all variables except the given ones
+    virtual void project(const std::vector< VariableRef >& keep) = 0;
+
     /// \brief Normalize the abstract value
     virtual void normalize() const = 0;
 
@@ -452,6 +459,16 @@ private:
     /// \brief Forget a variable
     void forget(VariableRef x) override { this->_inv.forget(x); }
 
+    /// \brief Forget a set of variables
+    void forget_vars(const std::vector< VariableRef >& vars) override {
+      this->_inv.forget_vars(vars);
+    }
+
+    /// \brief Forget all variables except the given ones
+    void project(const std::vector< VariableRef >& keep) override {
+      this->_inv.project(keep);
+    }
+
     /// \brief Normalize the abstract value
     void normalize() const override { this->_inv.normalize(); }
 
@@ -806,6 +823,18 @@ public:
     }
   }
 
+  void forget_vars(const std::vector< VariableRef >& vars) override {
+    if (this->_ptr != nullptr) {
+      this->_ptr->forget_vars(vars);
+    }
+  }
+
+  void project(const std::vector< VariableRef >& keep) override {
+    if (this->_ptr != nullptr) {
+      this->_ptr->project(keep);
+    }
+  }
+
   void normalize() const override {
     if (this->_ptr != nullptr) {
       this->_ptr->normalize();
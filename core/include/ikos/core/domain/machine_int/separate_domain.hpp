@@ -43,7 +43,10 @@
 
 #pragma once
 
-#include <ikos/core/adt/patricia_tree/map.hpp>
+#include <algorithm>
+#include <vector>
+
+#include <ikos/core/adt/adaptive_map.hpp>
 #include <ikos/core/domain/abstract_domain.hpp>
 #include <ikos/core/domain/machine_int/operator.hpp>
 #include <ikos/core/linear_expression.hpp>
@@ -70,14 +73,14 @@ public:
 
 private:
   using VariableTrait = machine_int::VariableTraits< VariableRef >;
-  using PatriciaTreeMapT = PatriciaTreeMap< VariableRef, Value >;
+  using MapT = AdaptiveMap< VariableRef, Value >;
 
 public:
   using LinearExpressionT = LinearExpression< MachineInt, VariableRef >;
-  using Iterator = typename PatriciaTreeMapT::Iterator;
+  using Iterator = typename MapT::Iterator;
 
 private:
-  PatriciaTreeMapT _tree;
+  MapT _map;
   bool _is_bottom;
 
 private:
@@ -119,29 +122,29 @@ public:
   /// \brief Begin iterator over the pairs (variable, value)
   Iterator begin() const {
     ikos_assert(!this->is_bottom());
-    return this->_tree.begin();
+    return this->_map.begin();
   }
 
   /// \brief End iterator over the pairs (variable, value)
   Iterator end() const {
     ikos_assert(!this->is_bottom());
-    return this->_tree.end();
+    return this->_map.end();
   }
 
   bool is_bottom() const override { return this->_is_bottom; }
 
   bool is_top() const override {
-    return !this->is_bottom() && this->_tree.empty();
+    return !this->is_bottom() && this->_map.empty();
   }
 
   void set_to_bottom() override {
     this->_is_bottom = true;
-    this->_tree.clear();
+    this->_map.clear();
   }
 
   void set_to_top() override {
     this->_is_bottom = false;
-    this->_tree.clear();
+    this->_map.clear();
   }
 
   bool leq(const SeparateDomain& other) const override {
@@ -150,7 +153,7 @@ public:
     } else if (other.is_bottom()) {
       return false;
     } else {
-      return this->_tree.leq(other._tree, [](const Value& x, const Value& y) {
+      return this->_map.leq(other._map, [](const Value& x, const Value& y) {
         return x.leq(y);
       });
     }
@@ -162,10 +165,10 @@ public:
     } else if (other.is_bottom()) {
       return false;
     } else {
-      return this->_tree.equals(other._tree,
-                                [](const Value& x, const Value& y) {
-                                  return x.equals(y);
-                                });
+      return this->_map.equals(other._map,
+                               [](const Value& x, const Value& y) {
+                                 return x.equals(y);
+                               });
     }
   }
 
@@ -175,15 +178,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [](const Value& x, const Value& y) {
-                                   Value z = x.join(y);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [](const Value& x, const Value& y) {
+                                  Value z = x.join(y);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -193,15 +196,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [](const Value& x, const Value& y) {
-                                   Value z = x.join_loop(y);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [](const Value& x, const Value& y) {
+                                  Value z = x.join_loop(y);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -211,15 +214,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [](const Value& x, const Value& y) {
-                                   Value z = x.join_loop(y);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [](const Value& x, const Value& y) {
+                                  Value z = x.join_loop(y);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -229,15 +232,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [](const Value& x, const Value& y) {
-                                   Value z = x.widening(y);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [](const Value& x, const Value& y) {
+                                  Value z = x.widening(y);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -248,15 +251,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [threshold](const Value& x, const Value& y) {
-                                   Value z = x.widening_threshold(y, threshold);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [threshold](const Value& x, const Value& y) {
+                                  Value z = x.widening_threshold(y, threshold);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -267,7 +270,7 @@ public:
       this->set_to_bottom();
     } else {
       try {
-        this->_tree.join_with(other._tree, [](const Value& x, const Value& y) {
+        this->_map.join_with(other._map, [](const Value& x, const Value& y) {
           Value z = x.meet(y);
           if (z.is_bottom()) {
             throw BottomFound();
@@ -287,7 +290,7 @@ public:
       this->set_to_bottom();
     } else {
       try {
-        this->_tree.join_with(other._tree, [](const Value& x, const Value& y) {
+        this->_map.join_with(other._map, [](const Value& x, const Value& y) {
           Value z = x.narrowing(y);
           if (z.is_bottom()) {
             throw BottomFound();
@@ -305,7 +308,7 @@ public:
     if (this->is_bottom()) {
       return Value::bottom(VariableTrait::bit_width(x), VariableTrait::sign(x));
     } else {
-      boost::optional< const Value& > v = this->_tree.at(x);
+      boost::optional< const Value& > v = this->_map.at(x);
       if (v) {
         return *v;
       } else {
@@ -321,9 +324,9 @@ public:
     } else if (value.is_bottom()) {
       this->set_to_bottom();
     } else if (value.is_top()) {
-      this->_tree.erase(x);
+      this->_map.erase(x);
     } else {
-      this->_tree.insert_or_assign(x, value);
+      this->_map.insert_or_assign(x, value);
     }
   }
 
@@ -337,7 +340,7 @@ public:
       return;
     } else {
       try {
-        this->_tree.update_or_insert(
+        this->_map.update_or_insert(
             [](const Value& x, const Value& y) {
               Value z = x.meet(y);
               if (z.is_bottom()) {
@@ -384,7 +387,25 @@ public:
     if (this->is_bottom()) {
       return;
     }
-    this->_tree.erase(x);
+    this->_map.erase(x);
+  }
+
+  /// \brief Forget the abstract value of all variables except the given ones
+  void project(std::vector< VariableRef > keep) {
+    if (this->is_bottom()) {
+      return;
+    }
+
+    std::sort(keep.begin(), keep.end());
+    std::vector< VariableRef > dropped;
+    for (const auto& binding : this->_map) {
+      if (!std::binary_search(keep.begin(), keep.end(), binding.first)) {
+        dropped.push_back(binding.first);
+      }
+    }
+    for (VariableRef x : dropped) {
+      this->_map.erase(x);
+    }
   }
 
   /// \brief Assign `x = n`
@@ -435,7 +456,7 @@ public:
     if (this->is_bottom()) {
       o << "⊥";
     } else {
-      this->_tree.dump(o);
+      this->_map.dump(o);
     }
   }
 
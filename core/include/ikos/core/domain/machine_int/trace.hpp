@@ -0,0 +1,1152 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Recording and replay of the operations on a machine integer domain
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ikos/core/domain/machine_int/abstract_domain.hpp>
+#include <ikos/core/exception.hpp>
+#include <ikos/core/semantic/indexable.hpp>
+#include <ikos/core/support/assert.hpp>
+
+namespace ikos {
+namespace core {
+namespace machine_int {
+
+/// \brief Operation recorded in a trace, see TraceWriter
+///
+/// The operands of each operation are listed in comments. States and
+/// variables are identified by integers, see TraceWriter.
+enum class TraceOpcode : std::uint8_t {
+  Variable = 0,        // id, bit-width, sign
+  Top,                 // s
+  Bottom,              // s
+  Copy,                // s, other
+  Move,                // s, other
+  Destroy,             // s
+  IsBottom,            // s
+  IsTop,               // s
+  SetToBottom,         // s
+  SetToTop,            // s
+  Leq,                 // s, other
+  Equals,              // s, other
+  Join,                // s, other
+  JoinLoop,            // s, other
+  JoinIter,            // s, other
+  Widen,               // s, other
+  WidenThreshold,      // s, other, n
+  Meet,                // s, other
+  Narrow,              // s, other
+  AssignNum,           // s, x, n
+  AssignVar,           // s, x, y
+  AssignExpr,          // s, x, e
+  ApplyUnary,          // s, op, x, y
+  ApplyVarVar,         // s, op, x, y, z
+  ApplyVarNum,         // s, op, x, y, z
+  ApplyNumVar,         // s, op, x, y, z
+  AddVarVar,           // s, pred, x, y
+  AddVarNum,           // s, pred, x, y
+  AddNumVar,           // s, pred, x, y
+  SetInterval,         // s, x, i
+  SetCongruence,       // s, x, c
+  SetIntervalCongr,    // s, x, i, c
+  RefineInterval,      // s, x, i
+  RefineCongruence,    // s, x, c
+  RefineIntervalCongr, // s, x, i, c
+  Forget,              // s, x
+  ForgetVars,          // s, xs
+  Project,             // s, xs
+  Normalize,           // s
+  ToInterval,          // s, x
+  ToIntervalExpr,      // s, e
+  ToCongruence,        // s, x
+  ToCongruenceExpr,    // s, e
+  ToIntervalCongr,     // s, x
+  ToIntervalCongrExpr, // s, e
+  MarkCounter,         // s, x
+  UnmarkCounter,       // s, x
+  InitCounter,         // s, x, n
+  IncrCounter,         // s, x, n
+  ForgetCounter,       // s, x
+  _Last = ForgetCounter,
+};
+
+/// \brief Magic number at the beginning of a trace
+constexpr char TraceMagic[] = {'I', 'K', 'O', 'S', 'T', 'R', 'C', '1'};
+
+/// \brief Linear expression of a trace, on variable identifiers
+struct TraceExpression {
+  /// \brief Terms, as pairs of coefficient and variable identifier
+  std::vector< std::pair< MachineInt, std::uint64_t > > terms;
+
+  /// \brief Constant
+  MachineInt constant;
+};
+
+/// \brief Writer of a binary trace of the operations on a machine integer
+/// domain
+///
+/// A trace is a sequence of operations, see TraceOpcode. Each abstract value
+/// is a state with a unique identifier, and variables are declared with a
+/// `Variable` operation before their first use. Integers are encoded in
+/// LEB128, and numbers in zig-zag LEB128 when they fit in 64 bits.
+///
+/// This is not thread-safe: all the recorded abstract values must be used by
+/// the same thread.
+class TraceWriter {
+private:
+  /// \brief Output stream
+  std::ostream& _out;
+
+  /// \brief Identifier of the next state
+  std::uint64_t _next_state;
+
+  /// \brief Identifier of each variable, by index
+  std::unordered_map< Index, std::uint64_t > _variables;
+
+public:
+  /// \brief Create a trace writer on the given binary output stream
+  explicit TraceWriter(std::ostream& out) : _out(out), _next_state(0) {
+    this->_out.write(TraceMagic, sizeof(TraceMagic));
+  }
+
+  /// \brief Deleted copy constructor
+  TraceWriter(const TraceWriter&) = delete;
+
+  /// \brief Deleted move constructor
+  TraceWriter(TraceWriter&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  TraceWriter& operator=(const TraceWriter&) = delete;
+
+  /// \brief Deleted move assignment operator
+  TraceWriter& operator=(TraceWriter&&) = delete;
+
+  /// \brief Destructor
+  ~TraceWriter() { this->_out.flush(); }
+
+  /// \brief Return the identifier of a new state
+  std::uint64_t new_state() { return this->_next_state++; }
+
+  /// \brief Return the identifier of the given variable
+  ///
+  /// The variable is declared on its first use.
+  template < typename VariableRef >
+  std::uint64_t variable(const VariableRef& x) {
+    auto it = this->_variables.find(IndexableTraits< VariableRef >::index(x));
+    if (it != this->_variables.end()) {
+      return it->second;
+    }
+
+    auto id = static_cast< std::uint64_t >(this->_variables.size());
+    this->_variables.emplace(IndexableTraits< VariableRef >::index(x), id);
+    this->record(TraceOpcode::Variable,
+                 id,
+                 static_cast< std::uint64_t >(
+                     VariableTraits< VariableRef >::bit_width(x)),
+                 VariableTraits< VariableRef >::sign(x));
+    return id;
+  }
+
+  /// \brief Record an operation with the given operands
+  template < typename... Args >
+  void record(TraceOpcode opcode, const Args&... args) {
+    this->_out.put(static_cast< char >(opcode));
+    int unused[] = {0, (this->write(args), 0)...};
+    static_cast< void >(unused);
+  }
+
+private:
+  void write(std::uint64_t n) {
+    while (n >= 0x80) {
+      this->_out.put(static_cast< char >((n & 0x7f) | 0x80));
+      n >>= 7;
+    }
+    this->_out.put(static_cast< char >(n));
+  }
+
+  void write(Signedness sign) {
+    this->_out.put(static_cast< char >(sign == Signed ? 0 : 1));
+  }
+
+  void write(UnaryOperator op) {
+    this->write(static_cast< std::uint64_t >(op));
+  }
+
+  void write(BinaryOperator op) {
+    this->write(static_cast< std::uint64_t >(op));
+  }
+
+  void write(Predicate pred) {
+    this->write(static_cast< std::uint64_t >(pred));
+  }
+
+  void write(const ZNumber& n) {
+    if (n.fits< std::int64_t >()) {
+      auto v = n.to< std::int64_t >();
+      this->_out.put(0);
+      this->write((static_cast< std::uint64_t >(v) << 1) ^
+                  static_cast< std::uint64_t >(v >> 63));
+    } else {
+      std::string s = n.str();
+      this->_out.put(1);
+      this->write(static_cast< std::uint64_t >(s.size()));
+      this->_out.write(s.data(), static_cast< std::streamsize >(s.size()));
+    }
+  }
+
+  void write(const MachineInt& n) {
+    this->write(static_cast< std::uint64_t >(n.bit_width()));
+    this->write(n.sign());
+    this->write(n.to_z_number());
+  }
+
+  void write(const Interval& i) {
+    this->write(static_cast< std::uint64_t >(i.bit_width()));
+    this->write(i.sign());
+    this->write(i.lb().to_z_number());
+    this->write(i.ub().to_z_number());
+  }
+
+  void write(const Congruence& c) {
+    this->write(static_cast< std::uint64_t >(c.bit_width()));
+    this->write(c.sign());
+    if (c.is_bottom()) {
+      this->_out.put(1);
+    } else {
+      this->_out.put(0);
+      this->write(c.to_z_congruence().modulus());
+      this->write(c.to_z_congruence().residue());
+    }
+  }
+
+  void write(const IntervalCongruence& ic) {
+    this->write(ic.interval());
+    this->write(ic.congruence());
+  }
+
+  void write(const std::vector< std::uint64_t >& ids) {
+    this->write(static_cast< std::uint64_t >(ids.size()));
+    for (std::uint64_t id : ids) {
+      this->write(id);
+    }
+  }
+
+  void write(const TraceExpression& e) {
+    this->write(static_cast< std::uint64_t >(e.terms.size()));
+    for (const auto& term : e.terms) {
+      this->write(term.first);
+      this->write(term.second);
+    }
+    this->write(e.constant);
+  }
+
+}; // end class TraceWriter
+
+/// \brief Reader of a binary trace, see TraceWriter
+///
+/// Throws a LogicError on a malformed trace.
+class TraceReader {
+private:
+  /// \brief Input stream
+  std::istream& _in;
+
+public:
+  /// \brief Create a trace reader on the given binary input stream
+  explicit TraceReader(std::istream& in) : _in(in) {
+    char magic[sizeof(TraceMagic)];
+    if (!this->_in.read(magic, sizeof(magic)) ||
+        !std::equal(magic, magic + sizeof(magic), TraceMagic)) {
+      throw LogicError("invalid domain trace: bad magic number");
+    }
+  }
+
+  /// \brief Deleted copy constructor
+  TraceReader(const TraceReader&) = delete;
+
+  /// \brief Deleted move constructor
+  TraceReader(TraceReader&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  TraceReader& operator=(const TraceReader&) = delete;
+
+  /// \brief Deleted move assignment operator
+  TraceReader& operator=(TraceReader&&) = delete;
+
+  /// \brief Destructor
+  ~TraceReader() = default;
+
+  /// \brief Read the next operation
+  ///
+  /// Returns false at the end of the trace.
+  bool read_opcode(TraceOpcode& opcode) {
+    int c = this->_in.get();
+    if (c == std::char_traits< char >::eof()) {
+      return false;
+    }
+    if (c > static_cast< int >(TraceOpcode::_Last)) {
+      throw LogicError("invalid domain trace: unknown operation");
+    }
+    opcode = static_cast< TraceOpcode >(c);
+    return true;
+  }
+
+  /// \brief Read an unsigned integer
+  std::uint64_t read_uint() {
+    std::uint64_t n = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      int c = this->read_byte();
+      n |= static_cast< std::uint64_t >(c & 0x7f) << shift;
+      if ((c & 0x80) == 0) {
+        return n;
+      }
+    }
+    throw LogicError("invalid domain trace: integer overflow");
+  }
+
+  /// \brief Read a signedness
+  Signedness read_sign() { return this->read_byte() == 0 ? Signed : Unsigned; }
+
+  /// \brief Read a number
+  ZNumber read_z_number() {
+    if (this->read_byte() == 0) {
+      std::uint64_t v = this->read_uint();
+      return ZNumber(static_cast< std::int64_t >(v >> 1) ^
+                     -static_cast< std::int64_t >(v & 1));
+    } else {
+      std::string s(static_cast< std::size_t >(this->read_uint()), '\0');
+      if (!this->_in.read(&s[0], static_cast< std::streamsize >(s.size()))) {
+        throw LogicError("invalid domain trace: unexpected end of trace");
+      }
+      return ZNumber::from_string(s);
+    }
+  }
+
+  /// \brief Read a machine integer
+  MachineInt read_machine_int() {
+    auto bit_width = static_cast< unsigned >(this->read_uint());
+    Signedness sign = this->read_sign();
+    return MachineInt(this->read_z_number(), bit_width, sign);
+  }
+
+  /// \brief Read a machine integer interval
+  Interval read_interval() {
+    auto bit_width = static_cast< unsigned >(this->read_uint());
+    Signedness sign = this->read_sign();
+    MachineInt lb(this->read_z_number(), bit_width, sign);
+    MachineInt ub(this->read_z_number(), bit_width, sign);
+    return Interval(std::move(lb), std::move(ub));
+  }
+
+  /// \brief Read a machine integer congruence
+  Congruence read_congruence() {
+    auto bit_width = static_cast< unsigned >(this->read_uint());
+    Signedness sign = this->read_sign();
+    if (this->read_byte() != 0) {
+      return Congruence::bottom(bit_width, sign);
+    }
+    ZNumber a = this->read_z_number();
+    ZNumber b = this->read_z_number();
+    return Congruence(std::move(a), std::move(b), bit_width, sign);
+  }
+
+  /// \brief Read a machine integer interval-congruence
+  IntervalCongruence read_interval_congruence() {
+    Interval i = this->read_interval();
+    Congruence c = this->read_congruence();
+    return IntervalCongruence(i, c);
+  }
+
+  /// \brief Read a list of identifiers
+  std::vector< std::uint64_t > read_uints() {
+    std::vector< std::uint64_t > ids(
+        static_cast< std::size_t >(this->read_uint()));
+    for (std::uint64_t& id : ids) {
+      id = this->read_uint();
+    }
+    return ids;
+  }
+
+  /// \brief Read a linear expression
+  TraceExpression read_expression() {
+    std::size_t n = static_cast< std::size_t >(this->read_uint());
+    std::vector< std::pair< MachineInt, std::uint64_t > > terms;
+    terms.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+      MachineInt coeff = this->read_machine_int();
+      terms.emplace_back(std::move(coeff), this->read_uint());
+    }
+    return TraceExpression{std::move(terms), this->read_machine_int()};
+  }
+
+private:
+  int read_byte() {
+    int c = this->_in.get();
+    if (c == std::char_traits< char >::eof()) {
+      throw LogicError("invalid domain trace: unexpected end of trace");
+    }
+    return c;
+  }
+
+}; // end class TraceReader
+
+/// \brief Machine integer abstract domain recording its operations in a
+/// trace
+///
+/// This is a wrapper around a machine integer abstract domain, that forwards
+/// all operations and records them with a TraceWriter. Each abstract value is
+/// a state of the trace, from its construction to its destruction.
+///
+/// The initial abstract value is recorded as top, unless it is bottom.
+template < typename VariableRef, typename Domain >
+class TraceDomain final
+    : public machine_int::AbstractDomain< VariableRef,
+                                          TraceDomain< VariableRef, Domain > > {
+public:
+  static_assert(machine_int::IsAbstractDomain< Domain, VariableRef >::value,
+                "Domain must implement machine_int::AbstractDomain");
+
+public:
+  using LinearExpressionT = LinearExpression< MachineInt, VariableRef >;
+
+private:
+  /// \brief Underlying abstract value
+  Domain _inv;
+
+  /// \brief Trace writer
+  TraceWriter* _trace;
+
+  /// \brief State identifier
+  std::uint64_t _id;
+
+public:
+  /// \brief Create the top abstract value
+  TraceDomain() {
+    ikos_unreachable("cannot create a TraceDomain without a trace");
+  }
+
+  /// \brief Record the given abstract value in the given trace
+  TraceDomain(Domain inv, TraceWriter& trace)
+      : _inv(std::move(inv)), _trace(&trace), _id(trace.new_state()) {
+    this->_trace->record(this->_inv.is_bottom() ? TraceOpcode::Bottom
+                                                : TraceOpcode::Top,
+                         this->_id);
+  }
+
+  /// \brief Copy constructor
+  TraceDomain(const TraceDomain& other)
+      : _inv(other._inv),
+        _trace(other._trace),
+        _id(other._trace->new_state()) {
+    this->_trace->record(TraceOpcode::Copy, this->_id, other._id);
+  }
+
+  /// \brief Move constructor
+  TraceDomain(TraceDomain&& other) noexcept
+      : _inv(std::move(other._inv)),
+        _trace(other._trace),
+        _id(other._trace->new_state()) {
+    this->_trace->record(TraceOpcode::Move, this->_id, other._id);
+  }
+
+  /// \brief Copy assignment operator
+  TraceDomain& operator=(const TraceDomain& other) {
+    this->_inv = other._inv;
+    this->_trace->record(TraceOpcode::Copy, this->_id, other._id);
+    return *this;
+  }
+
+  /// \brief Move assignment operator
+  TraceDomain& operator=(TraceDomain&& other) noexcept {
+    this->_inv = std::move(other._inv);
+    this->_trace->record(TraceOpcode::Move, this->_id, other._id);
+    return *this;
+  }
+
+  /// \brief Destructor
+  ~TraceDomain() override {
+    this->_trace->record(TraceOpcode::Destroy, this->_id);
+  }
+
+  /// \brief Create the top abstract value
+  static TraceDomain top() {
+    ikos_unreachable("cannot create a TraceDomain without a trace");
+  }
+
+  /// \brief Create the bottom abstract value
+  static TraceDomain bottom() {
+    ikos_unreachable("cannot create a TraceDomain without a trace");
+  }
+
+  /// \brief Return the state identifier
+  std::uint64_t id() const { return this->_id; }
+
+  bool is_bottom() const override {
+    this->record(TraceOpcode::IsBottom);
+    return this->_inv.is_bottom();
+  }
+
+  bool is_top() const override {
+    this->record(TraceOpcode::IsTop);
+    return this->_inv.is_top();
+  }
+
+  void set_to_bottom() override {
+    this->record(TraceOpcode::SetToBottom);
+    this->_inv.set_to_bottom();
+  }
+
+  void set_to_top() override {
+    this->record(TraceOpcode::SetToTop);
+    this->_inv.set_to_top();
+  }
+
+  bool leq(const TraceDomain& other) const override {
+    this->record(TraceOpcode::Leq, other._id);
+    return this->_inv.leq(other._inv);
+  }
+
+  bool equals(const TraceDomain& other) const override {
+    this->record(TraceOpcode::Equals, other._id);
+    return this->_inv.equals(other._inv);
+  }
+
+  void join_with(const TraceDomain& other) override {
+    this->record(TraceOpcode::Join, other._id);
+    this->_inv.join_with(other._inv);
+  }
+
+  void join_loop_with(const TraceDomain& other) override {
+    this->record(TraceOpcode::JoinLoop, other._id);
+    this->_inv.join_loop_with(other._inv);
+  }
+
+  void join_iter_with(const TraceDomain& other) override {
+    this->record(TraceOpcode::JoinIter, other._id);
+    this->_inv.join_iter_with(other._inv);
+  }
+
+  void widen_with(const TraceDomain& other) override {
+    this->record(TraceOpcode::Widen, other._id);
+    this->_inv.widen_with(other._inv);
+  }
+
+  void widen_threshold_with(const TraceDomain& other,
+                            const MachineInt& threshold) override {
+    this->record(TraceOpcode::WidenThreshold, other._id, threshold);
+    this->_inv.widen_threshold_with(other._inv, threshold);
+  }
+
+  void meet_with(const TraceDomain& other) override {
+    this->record(TraceOpcode::Meet, other._id);
+    this->_inv.meet_with(other._inv);
+  }
+
+  void narrow_with(const TraceDomain& other) override {
+    this->record(TraceOpcode::Narrow, other._id);
+    this->_inv.narrow_with(other._inv);
+  }
+
+  void assign(VariableRef x, const MachineInt& n) override {
+    this->record(TraceOpcode::AssignNum, this->var(x), n);
+    this->_inv.assign(x, n);
+  }
+
+  void assign(VariableRef x, VariableRef y) override {
+    std::uint64_t x_id = this->var(x);
+    this->record(TraceOpcode::AssignVar, x_id, this->var(y));
+    this->_inv.assign(x, y);
+  }
+
+  void assign(VariableRef x, const LinearExpressionT& e) override {
+    std::uint64_t x_id = this->var(x);
+    this->record(TraceOpcode::AssignExpr, x_id, this->expr(e));
+    this->_inv.assign(x, e);
+  }
+
+  void apply(UnaryOperator op, VariableRef x, VariableRef y) override {
+    std::uint64_t x_id = this->var(x);
+    std::uint64_t y_id = this->var(y);
+    this->record(TraceOpcode::ApplyUnary, op, x_id, y_id);
+    this->_inv.apply(op, x, y);
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             VariableRef z) override {
+    std::uint64_t x_id = this->var(x);
+    std::uint64_t y_id = this->var(y);
+    std::uint64_t z_id = this->var(z);
+    this->record(TraceOpcode::ApplyVarVar, op, x_id, y_id, z_id);
+    this->_inv.apply(op, x, y, z);
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             const MachineInt& z) override {
+    std::uint64_t x_id = this->var(x);
+    std::uint64_t y_id = this->var(y);
+    this->record(TraceOpcode::ApplyVarNum, op, x_id, y_id, z);
+    this->_inv.apply(op, x, y, z);
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             const MachineInt& y,
+             VariableRef z) override {
+    std::uint64_t x_id = this->var(x);
+    std::uint64_t z_id = this->var(z);
+    this->record(TraceOpcode::ApplyNumVar, op, x_id, y, z_id);
+    this->_inv.apply(op, x, y, z);
+  }
+
+  void add(Predicate pred, VariableRef x, VariableRef y) override {
+    std::uint64_t x_id = this->var(x);
+    std::uint64_t y_id = this->var(y);
+    this->record(TraceOpcode::AddVarVar, pred, x_id, y_id);
+    this->_inv.add(pred, x, y);
+  }
+
+  void add(Predicate pred, VariableRef x, const MachineInt& y) override {
+    this->record(TraceOpcode::AddVarNum, pred, this->var(x), y);
+    this->_inv.add(pred, x, y);
+  }
+
+  void add(Predicate pred, const MachineInt& x, VariableRef y) override {
+    this->record(TraceOpcode::AddNumVar, pred, x, this->var(y));
+    this->_inv.add(pred, x, y);
+  }
+
+  void set(VariableRef x, const Interval& value) override {
+    this->record(TraceOpcode::SetInterval, this->var(x), value);
+    this->_inv.set(x, value);
+  }
+
+  void set(VariableRef x, const Congruence& value) override {
+    this->record(TraceOpcode::SetCongruence, this->var(x), value);
+    this->_inv.set(x, value);
+  }
+
+  void set(VariableRef x, const IntervalCongruence& value) override {
+    this->record(TraceOpcode::SetIntervalCongr, this->var(x), value);
+    this->_inv.set(x, value);
+  }
+
+  void refine(VariableRef x, const Interval& value) override {
+    this->record(TraceOpcode::RefineInterval, this->var(x), value);
+    this->_inv.refine(x, value);
+  }
+
+  void refine(VariableRef x, const Congruence& value) override {
+    this->record(TraceOpcode::RefineCongruence, this->var(x), value);
+    this->_inv.refine(x, value);
+  }
+
+  void refine(VariableRef x, const IntervalCongruence& value) override {
+    this->record(TraceOpcode::RefineIntervalCongr, this->var(x), value);
+    this->_inv.refine(x, value);
+  }
+
+  void forget(VariableRef x) override {
+    this->record(TraceOpcode::Forget, this->var(x));
+    this->_inv.forget(x);
+  }
+
+  void forget_vars(const std::vector< VariableRef >& vars) override {
+    this->record(TraceOpcode::ForgetVars, this->vars(vars));
+    this->_inv.forget_vars(vars);
+  }
+
+  void project(const std::vector< VariableRef >& keep) override {
+    this->record(TraceOpcode::Project, this->vars(keep));
+    this->_inv.project(keep);
+  }
+
+  void normalize() const override {
+    this->record(TraceOpcode::Normalize);
+    this->_inv.normalize();
+  }
+
+  Interval to_interval(VariableRef x) const override {
+    this->record(TraceOpcode::ToInterval, this->var(x));
+    return this->_inv.to_interval(x);
+  }
+
+  Interval to_interval(const LinearExpressionT& e) const override {
+    this->record(TraceOpcode::ToIntervalExpr, this->expr(e));
+    return this->_inv.to_interval(e);
+  }
+
+  Congruence to_congruence(VariableRef x) const override {
+    this->record(TraceOpcode::ToCongruence, this->var(x));
+    return this->_inv.to_congruence(x);
+  }
+
+  Congruence to_congruence(const LinearExpressionT& e) const override {
+    this->record(TraceOpcode::ToCongruenceExpr, this->expr(e));
+    return this->_inv.to_congruence(e);
+  }
+
+  IntervalCongruence to_interval_congruence(VariableRef x) const override {
+    this->record(TraceOpcode::ToIntervalCongr, this->var(x));
+    return this->_inv.to_interval_congruence(x);
+  }
+
+  IntervalCongruence to_interval_congruence(
+      const LinearExpressionT& e) const override {
+    this->record(TraceOpcode::ToIntervalCongrExpr, this->expr(e));
+    return this->_inv.to_interval_congruence(e);
+  }
+
+  void mark_counter(VariableRef x) override {
+    this->record(TraceOpcode::MarkCounter, this->var(x));
+    this->_inv.mark_counter(x);
+  }
+
+  void unmark_counter(VariableRef x) override {
+    this->record(TraceOpcode::UnmarkCounter, this->var(x));
+    this->_inv.unmark_counter(x);
+  }
+
+  void init_counter(VariableRef x, const MachineInt& c) override {
+    this->record(TraceOpcode::InitCounter, this->var(x), c);
+    this->_inv.init_counter(x, c);
+  }
+
+  void incr_counter(VariableRef x, const MachineInt& k) override {
+    this->record(TraceOpcode::IncrCounter, this->var(x), k);
+    this->_inv.incr_counter(x, k);
+  }
+
+  void forget_counter(VariableRef x) override {
+    this->record(TraceOpcode::ForgetCounter, this->var(x));
+    this->_inv.forget_counter(x);
+  }
+
+  void dump(std::ostream& o) const override { this->_inv.dump(o); }
+
+  static std::string name() { return "trace of " + Domain::name(); }
+
+private:
+  /// \brief Record an operation on this state
+  template < typename... Args >
+  void record(TraceOpcode opcode, const Args&... args) const {
+    this->_trace->record(opcode, this->_id, args...);
+  }
+
+  /// \brief Return the identifier of a variable
+  std::uint64_t var(const VariableRef& x) const {
+    return this->_trace->variable(x);
+  }
+
+  /// \brief Return the identifiers of a list of variables
+  std::vector< std::uint64_t > vars(
+      const std::vector< VariableRef >& xs) const {
+    std::vector< std::uint64_t > ids;
+    ids.reserve(xs.size());
+    for (const VariableRef& x : xs) {
+      ids.push_back(this->var(x));
+    }
+    return ids;
+  }
+
+  /// \brief Return a linear expression on variable identifiers
+  TraceExpression expr(const LinearExpressionT& e) const {
+    TraceExpression r{{}, e.constant()};
+    r.terms.reserve(e.num_terms());
+    for (const auto& term : e) {
+      r.terms.emplace_back(term.second, this->var(term.first));
+    }
+    return r;
+  }
+
+}; // end class TraceDomain
+
+/// \brief Replay of a trace on a machine integer abstract domain
+///
+/// The variables of the trace are created with the given function, and its
+/// states are abstract values of the given domain. A state used before its
+/// creation, for instance because the trace was recorded from the middle of
+/// an analysis, starts at top.
+template < typename VariableRef, typename Domain >
+class TraceReplayer {
+public:
+  static_assert(machine_int::IsAbstractDomain< Domain, VariableRef >::value,
+                "Domain must implement machine_int::AbstractDomain");
+
+public:
+  using LinearExpressionT = LinearExpression< MachineInt, VariableRef >;
+
+  /// \brief Function creating a variable from its identifier, bit-width and
+  /// signedness
+  using MakeVariable =
+      std::function< VariableRef(std::uint64_t, unsigned, Signedness) >;
+
+private:
+  /// \brief Function creating the variables
+  MakeVariable _make_variable;
+
+  /// \brief Variables, by identifier
+  std::vector< VariableRef > _variables;
+
+  /// \brief Live states, by identifier
+  std::unordered_map< std::uint64_t, Domain > _states;
+
+  /// \brief Number of queries that returned true, to keep them alive
+  std::size_t _true_queries = 0;
+
+public:
+  /// \brief Constructor
+  explicit TraceReplayer(MakeVariable make_variable)
+      : _make_variable(std::move(make_variable)) {}
+
+  /// \brief Replay all the operations of the given trace
+  ///
+  /// Returns the number of replayed operations.
+  std::size_t replay(TraceReader& trace) {
+    std::size_t n = 0;
+    TraceOpcode opcode;
+    while (trace.read_opcode(opcode)) {
+      this->replay(trace, opcode);
+      n++;
+    }
+    return n;
+  }
+
+  /// \brief Return the state with the given identifier
+  Domain& state(std::uint64_t id) {
+    auto it = this->_states.find(id);
+    if (it == this->_states.end()) {
+      it = this->_states.emplace(id, Domain::top()).first;
+    }
+    return it->second;
+  }
+
+  /// \brief Return the number of live states
+  std::size_t num_states() const { return this->_states.size(); }
+
+  /// \brief Return the number of queries that returned true
+  std::size_t num_true_queries() const { return this->_true_queries; }
+
+private:
+  /// \brief Return the variable with the given identifier
+  const VariableRef& var(std::uint64_t id) const {
+    if (id >= this->_variables.size()) {
+      throw LogicError("invalid domain trace: undeclared variable");
+    }
+    return this->_variables[static_cast< std::size_t >(id)];
+  }
+
+  /// \brief Read a variable
+  const VariableRef& read_var(TraceReader& trace) const {
+    return this->var(trace.read_uint());
+  }
+
+  /// \brief Read a list of variables
+  std::vector< VariableRef > read_vars(TraceReader& trace) const {
+    std::vector< VariableRef > xs;
+    for (std::uint64_t id : trace.read_uints()) {
+      xs.push_back(this->var(id));
+    }
+    return xs;
+  }
+
+  /// \brief Read a linear expression
+  LinearExpressionT read_expr(TraceReader& trace) const {
+    TraceExpression e = trace.read_expression();
+    LinearExpressionT r(e.constant);
+    for (const auto& term : e.terms) {
+      r.add(term.first, this->var(term.second));
+    }
+    return r;
+  }
+
+  /// \brief Record the result of a query
+  void query(bool result) {
+    if (result) {
+      this->_true_queries++;
+    }
+  }
+
+  /// \brief Replay one operation
+  void replay(TraceReader& trace, TraceOpcode opcode) {
+    if (opcode == TraceOpcode::Variable) {
+      std::uint64_t id = trace.read_uint();
+      auto bit_width = static_cast< unsigned >(trace.read_uint());
+      Signedness sign = trace.read_sign();
+      if (id != this->_variables.size()) {
+        throw LogicError("invalid domain trace: unexpected variable");
+      }
+      this->_variables.push_back(this->_make_variable(id, bit_width, sign));
+      return;
+    }
+
+    std::uint64_t id = trace.read_uint();
+    switch (opcode) {
+      case TraceOpcode::Top: {
+        this->_states.erase(id);
+        this->_states.emplace(id, Domain::top());
+      } break;
+      case TraceOpcode::Bottom: {
+        this->_states.erase(id);
+        this->_states.emplace(id, Domain::bottom());
+      } break;
+      case TraceOpcode::Copy: {
+        std::uint64_t other = trace.read_uint();
+        if (other != id) {
+          Domain value = this->state(other);
+          this->state(id) = std::move(value);
+        }
+      } break;
+      case TraceOpcode::Move: {
+        std::uint64_t other = trace.read_uint();
+        if (other != id) {
+          Domain value = std::move(this->state(other));
+          this->state(id) = std::move(value);
+        }
+      } break;
+      case TraceOpcode::Destroy: {
+        this->_states.erase(id);
+      } break;
+      case TraceOpcode::IsBottom: {
+        this->query(this->state(id).is_bottom());
+      } break;
+      case TraceOpcode::IsTop: {
+        this->query(this->state(id).is_top());
+      } break;
+      case TraceOpcode::SetToBottom: {
+        this->state(id).set_to_bottom();
+      } break;
+      case TraceOpcode::SetToTop: {
+        this->state(id).set_to_top();
+      } break;
+      case TraceOpcode::Leq: {
+        const Domain& other = this->state(trace.read_uint());
+        this->query(this->state(id).leq(other));
+      } break;
+      case TraceOpcode::Equals: {
+        const Domain& other = this->state(trace.read_uint());
+        this->query(this->state(id).equals(other));
+      } break;
+      case TraceOpcode::Join: {
+        Domain other = this->state(trace.read_uint());
+        this->state(id).join_with(other);
+      } break;
+      case TraceOpcode::JoinLoop: {
+        Domain other = this->state(trace.read_uint());
+        this->state(id).join_loop_with(other);
+      } break;
+      case TraceOpcode::JoinIter: {
+        Domain other = this->state(trace.read_uint());
+        this->state(id).join_iter_with(other);
+      } break;
+      case TraceOpcode::Widen: {
+        Domain other = this->state(trace.read_uint());
+        this->state(id).widen_with(other);
+      } break;
+      case TraceOpcode::WidenThreshold: {
+        Domain other = this->state(trace.read_uint());
+        MachineInt threshold = trace.read_machine_int();
+        this->state(id).widen_threshold_with(other, threshold);
+      } break;
+      case TraceOpcode::Meet: {
+        Domain other = this->state(trace.read_uint());
+        this->state(id).meet_with(other);
+      } break;
+      case TraceOpcode::Narrow: {
+        Domain other = this->state(trace.read_uint());
+        this->state(id).narrow_with(other);
+      } break;
+      case TraceOpcode::AssignNum: {
+        VariableRef x = this->read_var(trace);
+        this->state(id).assign(x, trace.read_machine_int());
+      } break;
+      case TraceOpcode::AssignVar: {
+        VariableRef x = this->read_var(trace);
+        VariableRef y = this->read_var(trace);
+        this->state(id).assign(x, y);
+      } break;
+      case TraceOpcode::AssignExpr: {
+        VariableRef x = this->read_var(trace);
+        this->state(id).assign(x, this->read_expr(trace));
+      } break;
+      case TraceOpcode::ApplyUnary: {
+        auto op = static_cast< UnaryOperator >(trace.read_uint());
+        VariableRef x = this->read_var(trace);
+        VariableRef y = this->read_var(trace);
+        this->state(id).apply(op, x, y);
+      } break;
+      case TraceOpcode::ApplyVarVar: {
+        auto op = static_cast< BinaryOperator >(trace.read_uint());
+        VariableRef x = this->read_var(trace);
+        VariableRef y = this->read_var(trace);
+        VariableRef z = this->read_var(trace);
+        this->state(id).apply(op, x, y, z);
+      } break;
+      case TraceOpcode::ApplyVarNum: {
+        auto op = static_cast< BinaryOperator >(trace.read_uint());
+        VariableRef x = this->read_var(trace);
+        VariableRef y = this->read_var(trace);
+        this->state(id).apply(op, x, y, trace.read_machine_int());
+      } break;
+      case TraceOpcode::ApplyNumVar: {
+        auto op = static_cast< BinaryOperator >(trace.read_uint());
+        VariableRef x = this->read_var(trace);
+        MachineInt y = trace.read_machine_int();
+        VariableRef z = this->read_var(trace);
+        this->state(id).apply(op, x, y, z);
+      } break;
+      case TraceOpcode::AddVarVar: {
+        auto pred = static_cast< Predicate >(trace.read_uint());
+        VariableRef x = this->read_var(trace);
+        VariableRef y = this->read_var(trace);
+        this->state(id).add(pred, x, y);
+      } break;
+      case TraceOpcode::AddVarNum: {
+        auto pred = static_cast< Predicate >(trace.read_uint());
+        VariableRef x = this->read_var(trace);
+        this->state(id).add(pred, x, trace.read_machine_int());
+      } break;
+      case TraceOpcode::AddNumVar: {
+        auto pred = static_cast< Predicate >(trace.read_uint());
+        MachineInt x = trace.read_machine_int();
+        this->state(id).add(pred, x, this->read_var(trace));
+      } break;
+      case TraceOpcode::SetInterval: {
+        VariableRef x = this->read_var(trace);
+        this->state(id).set(x, trace.read_interval());
+      } break;
+      case TraceOpcode::SetCongruence: {
+        VariableRef x = this->read_var(trace);
+        this->state(id).set(x, trace.read_congruence());
+      } break;
+      case TraceOpcode::SetIntervalCongr: {
+        VariableRef x = this->read_var(trace);
+        this->state(id).set(x, trace.read_interval_congruence());
+      } break;
+      case TraceOpcode::RefineInterval: {
+        VariableRef x = this->read_var(trace);
+        this->state(id).refine(x, trace.read_interval());
+      } break;
+      case TraceOpcode::RefineCongruence: {
+        VariableRef x = this->read_var(trace);
+        this->state(id).refine(x, trace.read_congruence());
+      } break;
+      case TraceOpcode::RefineIntervalCongr: {
+        VariableRef x = this->read_var(trace);
+        this->state(id).refine(x, trace.read_interval_congruence());
+      } break;
+      case TraceOpcode::Forget: {
+        this->state(id).forget(this->read_var(trace));
+      } break;
+      case TraceOpcode::ForgetVars: {
+        this->state(id).forget_vars(this->read_vars(trace));
+      } break;
+      case TraceOpcode::Project: {
+        this->state(id).project(this->read_vars(trace));
+      } break;
+      case TraceOpcode::Normalize: {
+        this->state(id).normalize();
+      } break;
+      case TraceOpcode::ToInterval: {
+        VariableRef x = this->read_var(trace);
+        this->query(this->state(id).to_interval(x).is_top());
+      } break;
+      case TraceOpcode::ToIntervalExpr: {
+        LinearExpressionT e = this->read_expr(trace);
+        this->query(this->state(id).to_interval(e).is_top());
+      } break;
+      case TraceOpcode::ToCongruence: {
+        VariableRef x = this->read_var(trace);
+        this->query(this->state(id).to_congruence(x).is_top());
+      } break;
+      case TraceOpcode::ToCongruenceExpr: {
+        LinearExpressionT e = this->read_expr(trace);
+        this->query(this->state(id).to_congruence(e).is_top());
+      } break;
+      case TraceOpcode::ToIntervalCongr: {
+        VariableRef x = this->read_var(trace);
+        this->query(this->state(id).to_interval_congruence(x).is_top());
+      } break;
+      case TraceOpcode::ToIntervalCongrExpr: {
+        LinearExpressionT e = this->read_expr(trace);
+        this->query(this->state(id).to_interval_congruence(e).is_top());
+      } break;
+      case TraceOpcode::MarkCounter: {
+        this->state(id).mark_counter(this->read_var(trace));
+      } break;
+      case TraceOpcode::UnmarkCounter: {
+        this->state(id).unmark_counter(this->read_var(trace));
+      } break;
+      case TraceOpcode::InitCounter: {
+        VariableRef x = this->read_var(trace);
+        this->state(id).init_counter(x, trace.read_machine_int());
+      } break;
+      case TraceOpcode::IncrCounter: {
+        VariableRef x = this->read_var(trace);
+        this->state(id).incr_counter(x, trace.read_machine_int());
+      } break;
+      case TraceOpcode::ForgetCounter: {
+        this->state(id).forget_counter(this->read_var(trace));
+      } break;
+      default: {
+        throw LogicError("invalid domain trace: unknown operation");
+      }
+    }
+  }
+
+}; // end class TraceReplayer
+
+} // end namespace machine_int
+} // end namespace core
+} // end namespace ikos
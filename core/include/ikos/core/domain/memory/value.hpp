@@ -51,10 +51,18 @@
 
 #pragma once
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <ikos/core/adt/patricia_tree/map.hpp>
 #include <ikos/core/domain/memory/abstract_domain.hpp>
+#include <ikos/core/domain/memory/value/cell_offset_index.hpp>
 #include <ikos/core/domain/memory/value/cell_set.hpp>
 #include <ikos/core/domain/memory/value/mem_loc_to_cell_set.hpp>
 #include <ikos/core/domain/memory/value/mem_loc_to_pointer_set.hpp>
+#include <ikos/core/domain/memory/value/zero_segments.hpp>
+#include <ikos/core/domain/separate_domain.hpp>
 #include <ikos/core/semantic/memory/cell.hpp>
 
 namespace ikos {
@@ -96,6 +104,16 @@ struct CellFactoryTraits {};
 /// `memory::CellVariableTraits`. The variable doesn't have a fixed type. It is
 /// either a signed machine integer of 8*size bits, a floating points of 8*size
 /// bits or a pointer.
+///
+/// Byte ranges set to zero by a memset or a memory copy are also kept as
+/// summarized segments, see ZeroSegments. A read fully within a segment
+/// returns zero, without a cell per element.
+///
+/// A memory location with too many cells is smashed, see
+/// set_max_cells_per_location(). Its cells are then summary cells: a summary
+/// cell `(base, offset, size)` models all the elements of `size` bytes at
+/// offsets congruent to `offset` modulo `size`, within the byte ranges it
+/// covers. Summary cells are only updated with weak updates.
 template < typename VariableRef,
            typename MemoryLocationRef,
            typename VariableFactory,
@@ -147,11 +165,11 @@ private:
   using CellSetT = CellSet< VariableRef >;
 
   /// \brief Map from base addresses to set of synthetic cells
-  ///
-  /// TODO(jnavas): it should be a map from pointer offsets to set of
-  /// overlapping cells to make operations faster.
   using MemLocToCellSetT = MemLocToCellSet< MemoryLocationRef, VariableRef >;
 
+  /// \brief Index of cell sets by offset, to find overlapping cells
+  using CellOffsetIndexT = CellOffsetIndex< VariableRef, MemoryLocationRef >;
+
   /// \brief Points-to set
   using PointsToSetT = PointsToSet< MemoryLocationRef >;
 
@@ -164,6 +182,12 @@ private:
   /// \brief Map from base addresses to set of pointers
   using MemLocToPointerSetT = MemLocToPointerSet< MemoryLocationRef >;
 
+  /// \brief Map from base addresses to zero segments
+  using MemLocToZeroSegmentsT = MemLocToZeroSegments< MemoryLocationRef >;
+
+  /// \brief Map from summary cells to the byte ranges they cover
+  using CellToCoverageT = SeparateDomain< VariableRef, ZeroSegments >;
+
   /// \brief Literal
   using LiteralT = Literal< VariableRef, MemoryLocationRef >;
 
@@ -176,6 +200,8 @@ private:
 private:
   MemLocToCellSetT _cells;
   MemLocToPointerSetT _pointer_sets;
+  MemLocToZeroSegmentsT _zeros;
+  CellToCoverageT _summaries;
   PointerDomain _pointer;
   UninitializedDomain _uninitialized;
   LifetimeDomain _lifetime;
@@ -188,6 +214,8 @@ private:
   explicit ValueDomain(TopTag)
       : _cells(MemLocToCellSetT::top()),
         _pointer_sets(MemLocToPointerSetT::top()),
+        _zeros(MemLocToZeroSegmentsT::top()),
+        _summaries(CellToCoverageT::top()),
         _pointer(PointerDomain::top()),
         _uninitialized(UninitializedDomain::top()),
         _lifetime(LifetimeDomain::top()) {}
@@ -196,6 +224,8 @@ private:
   explicit ValueDomain(BottomTag)
       : _cells(MemLocToCellSetT::bottom()),
         _pointer_sets(MemLocToPointerSetT::bottom()),
+        _zeros(MemLocToZeroSegmentsT::bottom()),
+        _summaries(CellToCoverageT::bottom()),
         _pointer(PointerDomain::bottom()),
         _uninitialized(UninitializedDomain::bottom()),
         _lifetime(LifetimeDomain::bottom()) {}
@@ -213,6 +243,8 @@ public:
                        LifetimeDomain lifetime)
       : _cells(MemLocToCellSetT::top()),
         _pointer_sets(MemLocToPointerSetT::top()),
+        _zeros(MemLocToZeroSegmentsT::top()),
+        _summaries(CellToCoverageT::top()),
         _pointer(std::move(pointer)),
         _uninitialized(std::move(uninitialized)),
         _lifetime(lifetime) {
@@ -240,6 +272,26 @@ public:
   /// \brief Create the bottom abstract value
   static ValueDomain bottom() { return ValueDomain(BottomTag{}); }
 
+  /// \brief Set the maximum number of cells per memory location
+  ///
+  /// When a memory location holds that many cells and a write needs a new
+  /// cell, the memory location is smashed: its cells with the same size and
+  /// the same offset modulo their size are folded into one summary cell,
+  /// holding the join of their values. Later writes perform weak updates on
+  /// the summary cells, and reads return their value. A read needing a new
+  /// cell returns an unknown value instead.
+  ///
+  /// This bounds the size of abstract values on code filling large buffers.
+  /// Zero means no limit, which is the default.
+  ///
+  /// This must be called before the analysis starts.
+  static void set_max_cells_per_location(std::size_t max_cells) {
+    max_cells_storage() = max_cells;
+  }
+
+  /// \brief Return the maximum number of cells per memory location
+  static std::size_t max_cells_per_location() { return max_cells_storage(); }
+
   /*
    * Implement core::AbstractDomain
    */
@@ -251,13 +303,16 @@ public:
 
   bool is_top() const override {
     return this->_cells.is_top() && this->_pointer_sets.is_top() &&
-           this->_pointer.is_top() && this->_uninitialized.is_top() &&
-           this->_lifetime.is_top();
+           this->_zeros.is_top() && this->_summaries.is_top() &&
+           this->_pointer.is_top() &&
+           this->_uninitialized.is_top() && this->_lifetime.is_top();
   }
 
   void set_to_bottom() override {
     this->_cells.set_to_bottom();
     this->_pointer_sets.set_to_bottom();
+    this->_zeros.set_to_bottom();
+    this->_summaries.set_to_bottom();
     this->_pointer.set_to_bottom();
     this->_uninitialized.set_to_bottom();
     this->_lifetime.set_to_bottom();
@@ -266,6 +321,8 @@ public:
   void set_to_top() override {
     this->_cells.set_to_top();
     this->_pointer_sets.set_to_top();
+    this->_zeros.set_to_top();
+    this->_summaries.set_to_top();
     this->_pointer.set_to_top();
     this->_uninitialized.set_to_top();
     this->_lifetime.set_to_top();
@@ -276,12 +333,22 @@ public:
       return true;
     } else if (other.is_bottom()) {
       return false;
+    } else if (this->_summaries.is_top() && other._summaries.is_top()) {
+      return this->leq_cells(other);
     } else {
-      return this->_cells.leq(other._cells) &&
-             this->_pointer_sets.leq(other._pointer_sets) &&
-             this->_pointer.leq(other._pointer) &&
-             this->_uninitialized.leq(other._uninitialized) &&
-             this->_lifetime.leq(other._lifetime);
+      // Smash the memory locations smashed in `other` only
+      PointsToSetT smashed = this->smashed_locations();
+      PointsToSetT other_smashed = other.smashed_locations();
+      if (!smashed.leq(other_smashed)) {
+        return false;
+      }
+      ValueDomain inv(*this);
+      for (MemoryLocationRef addr : other_smashed) {
+        if (!smashed.contains(addr)) {
+          inv.smash_cells_as(addr, other);
+        }
+      }
+      return inv.leq_cells(other);
     }
   }
 
@@ -293,6 +360,8 @@ public:
     } else {
       return this->_cells.equals(other._cells) &&
              this->_pointer_sets.equals(other._pointer_sets) &&
+             this->_zeros.equals(other._zeros) &&
+             this->_summaries.equals(other._summaries) &&
              this->_pointer.equals(other._pointer) &&
              this->_uninitialized.equals(other._uninitialized) &&
              this->_lifetime.equals(other._lifetime);
@@ -305,11 +374,15 @@ public:
     } else if (other.is_bottom()) {
       return;
     } else {
-      this->_cells.join_with(other._cells);
-      this->_pointer_sets.join_with(other._pointer_sets);
-      this->_pointer.join_with(other._pointer);
-      this->_uninitialized.join_with(other._uninitialized);
-      this->_lifetime.join_with(other._lifetime);
+      this->apply_with_summaries(other, [this](const ValueDomain& inv) {
+        this->_cells.join_with(inv._cells);
+        this->_pointer_sets.join_with(inv._pointer_sets);
+        this->_zeros.join_with(inv._zeros);
+        this->_summaries.join_with(inv._summaries);
+        this->_pointer.join_with(inv._pointer);
+        this->_uninitialized.join_with(inv._uninitialized);
+        this->_lifetime.join_with(inv._lifetime);
+      });
     }
   }
 
@@ -319,11 +392,15 @@ public:
     } else if (other.is_bottom()) {
       return;
     } else {
-      this->_cells.join_loop_with(other._cells);
-      this->_pointer_sets.join_loop_with(other._pointer_sets);
-      this->_pointer.join_loop_with(other._pointer);
-      this->_uninitialized.join_loop_with(other._uninitialized);
-      this->_lifetime.join_loop_with(other._lifetime);
+      this->apply_with_summaries(other, [this](const ValueDomain& inv) {
+        this->_cells.join_loop_with(inv._cells);
+        this->_pointer_sets.join_loop_with(inv._pointer_sets);
+        this->_zeros.join_loop_with(inv._zeros);
+        this->_summaries.join_loop_with(inv._summaries);
+        this->_pointer.join_loop_with(inv._pointer);
+        this->_uninitialized.join_loop_with(inv._uninitialized);
+        this->_lifetime.join_loop_with(inv._lifetime);
+      });
     }
   }
 
@@ -333,11 +410,15 @@ public:
     } else if (other.is_bottom()) {
       return;
     } else {
-      this->_cells.join_iter_with(other._cells);
-      this->_pointer_sets.join_iter_with(other._pointer_sets);
-      this->_pointer.join_iter_with(other._pointer);
-      this->_uninitialized.join_iter_with(other._uninitialized);
-      this->_lifetime.join_iter_with(other._lifetime);
+      this->apply_with_summaries(other, [this](const ValueDomain& inv) {
+        this->_cells.join_iter_with(inv._cells);
+        this->_pointer_sets.join_iter_with(inv._pointer_sets);
+        this->_zeros.join_iter_with(inv._zeros);
+        this->_summaries.join_iter_with(inv._summaries);
+        this->_pointer.join_iter_with(inv._pointer);
+        this->_uninitialized.join_iter_with(inv._uninitialized);
+        this->_lifetime.join_iter_with(inv._lifetime);
+      });
     }
   }
 
@@ -347,11 +428,15 @@ public:
     } else if (other.is_bottom()) {
       return;
     } else {
-      this->_cells.widen_with(other._cells);
-      this->_pointer_sets.widen_with(other._pointer_sets);
-      this->_pointer.widen_with(other._pointer);
-      this->_uninitialized.widen_with(other._uninitialized);
-      this->_lifetime.widen_with(other._lifetime);
+      this->apply_with_summaries(other, [this](const ValueDomain& inv) {
+        this->_cells.widen_with(inv._cells);
+        this->_pointer_sets.widen_with(inv._pointer_sets);
+        this->_zeros.widen_with(inv._zeros);
+        this->_summaries.widen_with(inv._summaries);
+        this->_pointer.widen_with(inv._pointer);
+        this->_uninitialized.widen_with(inv._uninitialized);
+        this->_lifetime.widen_with(inv._lifetime);
+      });
     }
   }
 
@@ -362,11 +447,15 @@ public:
     } else if (other.is_bottom()) {
       return;
     } else {
-      this->_cells.widen_with(other._cells);
-      this->_pointer_sets.join_with(other._pointer_sets);
-      this->_pointer.widen_threshold_with(other._pointer, threshold);
-      this->_uninitialized.widen_with(other._uninitialized);
-      this->_lifetime.widen_with(other._lifetime);
+      this->apply_with_summaries(other, [&](const ValueDomain& inv) {
+        this->_cells.widen_with(inv._cells);
+        this->_pointer_sets.join_with(inv._pointer_sets);
+        this->_zeros.widen_with(inv._zeros);
+        this->_summaries.widen_with(inv._summaries);
+        this->_pointer.widen_threshold_with(inv._pointer, threshold);
+        this->_uninitialized.widen_with(inv._uninitialized);
+        this->_lifetime.widen_with(inv._lifetime);
+      });
     }
   }
 
@@ -376,11 +465,15 @@ public:
     } else if (other.is_bottom()) {
       this->set_to_bottom();
     } else {
-      this->_cells.meet_with(other._cells);
-      this->_pointer_sets.meet_with(other._pointer_sets);
-      this->_pointer.meet_with(other._pointer);
-      this->_uninitialized.meet_with(other._uninitialized);
-      this->_lifetime.meet_with(other._lifetime);
+      this->apply_with_summaries(other, [this](const ValueDomain& inv) {
+        this->_cells.meet_with(inv._cells);
+        this->_pointer_sets.meet_with(inv._pointer_sets);
+        this->_zeros.meet_with(inv._zeros);
+        this->_summaries.meet_with(inv._summaries);
+        this->_pointer.meet_with(inv._pointer);
+        this->_uninitialized.meet_with(inv._uninitialized);
+        this->_lifetime.meet_with(inv._lifetime);
+      });
     }
   }
 
@@ -390,11 +483,15 @@ public:
     } else if (other.is_bottom()) {
       this->set_to_bottom();
     } else {
-      this->_cells.narrow_with(other._cells);
-      this->_pointer_sets.narrow_with(other._pointer_sets);
-      this->_pointer.narrow_with(other._pointer);
-      this->_uninitialized.narrow_with(other._uninitialized);
-      this->_lifetime.narrow_with(other._lifetime);
+      this->apply_with_summaries(other, [this](const ValueDomain& inv) {
+        this->_cells.narrow_with(inv._cells);
+        this->_pointer_sets.narrow_with(inv._pointer_sets);
+        this->_zeros.narrow_with(inv._zeros);
+        this->_summaries.narrow_with(inv._summaries);
+        this->_pointer.narrow_with(inv._pointer);
+        this->_uninitialized.narrow_with(inv._uninitialized);
+        this->_lifetime.narrow_with(inv._lifetime);
+      });
     }
   }
 
@@ -428,12 +525,290 @@ public:
 
   const LifetimeDomain& lifetime() const override { return this->_lifetime; }
 
+  /// \brief Return the number of synthetic cells
+  std::size_t num_cells() const {
+    if (this->is_bottom()) {
+      return 0;
+    }
+    std::size_t n = 0;
+    for (auto it = this->_cells.begin(), et = this->_cells.end(); it != et;
+         ++it) {
+      n += it->second.size();
+    }
+    return n;
+  }
+
+  /// \brief Return the total size of the points-to sets of the pointers stored
+  /// in memory
+  ///
+  /// Unknown points-to sets are not counted.
+  std::size_t num_points_to() const {
+    if (this->is_bottom()) {
+      return 0;
+    }
+    std::size_t n = 0;
+    for (auto it = this->_pointer_sets.begin(), et = this->_pointer_sets.end();
+         it != et;
+         ++it) {
+      const PointsToSetT& addrs = it->second.points_to();
+      if (addrs.is_set()) {
+        n += addrs.size();
+      }
+    }
+    return n;
+  }
+
 private:
   /// \brief Return the offset variable associated to `p`
   VariableRef offset_var(VariableRef p) const {
     return this->_pointer.offset_var(p);
   }
 
+  /// \brief Storage for the maximum number of cells per memory location
+  static std::size_t& max_cells_storage() {
+    static std::size_t max_cells = 0;
+    return max_cells;
+  }
+
+  /// \brief Return true if adding a cell in the given set would exceed the
+  /// maximum number of cells per memory location
+  static bool exceeds_max_cells(const CellSetT& cells) {
+    std::size_t max_cells = max_cells_storage();
+    return max_cells != 0 && cells.size() >= max_cells;
+  }
+
+  /// \brief Compare the underlying domains, see leq()
+  bool leq_cells(const ValueDomain& other) const {
+    return this->_cells.leq(other._cells) &&
+           this->_pointer_sets.leq(other._pointer_sets) &&
+           this->_zeros.leq(other._zeros) &&
+           this->_summaries.leq(other._summaries) &&
+           this->_pointer.leq(other._pointer) &&
+           this->_uninitialized.leq(other._uninitialized) &&
+           this->_lifetime.leq(other._lifetime);
+  }
+
+  /// \brief Apply the binary operator `op` on the underlying domains
+  ///
+  /// The memory locations smashed on one side only are smashed on the other
+  /// side first, so that `op` combines summary cells with summary cells.
+  template < typename Op >
+  void apply_with_summaries(const ValueDomain& other, Op op) {
+    if (this->_summaries.is_top() && other._summaries.is_top()) {
+      op(other);
+      return;
+    }
+
+    PointsToSetT smashed = this->smashed_locations();
+    PointsToSetT other_smashed = other.smashed_locations();
+    for (MemoryLocationRef addr : other_smashed) {
+      if (!smashed.contains(addr)) {
+        this->smash_cells_as(addr, other);
+      }
+    }
+    if (smashed.leq(other_smashed)) {
+      op(other);
+    } else {
+      ValueDomain inv(other);
+      for (MemoryLocationRef addr : smashed) {
+        if (!other_smashed.contains(addr)) {
+          inv.smash_cells_as(addr, *this);
+        }
+      }
+      op(inv);
+    }
+
+    smashed.join_with(other_smashed);
+    this->clean_summaries(smashed);
+  }
+
+  /// \brief Return the memory locations with summary cells
+  PointsToSetT smashed_locations() const {
+    PointsToSetT addrs = PointsToSetT::empty();
+    for (auto it = this->_summaries.begin(), et = this->_summaries.end();
+         it != et;
+         ++it) {
+      addrs.add(CellVariableTrait::base(it->first));
+    }
+    return addrs;
+  }
+
+  /// \brief Return true if the given cell is a summary cell
+  bool is_summary(VariableRef cell) const {
+    return !this->_summaries.get(cell).is_empty();
+  }
+
+  /// \brief Return true if the cells of the given memory location are
+  /// summary cells
+  bool is_smashed(MemoryLocationRef addr) const {
+    if (this->_summaries.is_top()) {
+      return false;
+    }
+    const CellSetT& cells = this->_cells.get(addr);
+    return !cells.is_empty() && this->is_summary(*cells.begin());
+  }
+
+  /// \brief Return the offset of the given cell modulo its size
+  static MachineInt phase(VariableRef cell) {
+    return mod(CellVariableTrait::offset(cell), CellVariableTrait::size(cell));
+  }
+
+  /// \brief Return true if the cells `x` and `y` have the same size and the
+  /// same phase
+  static bool same_phase(VariableRef x, VariableRef y) {
+    return CellVariableTrait::size(x) == CellVariableTrait::size(y) &&
+           phase(x) == phase(y);
+  }
+
+  /// \brief Return true if all the given offsets are congruent to the offset
+  /// of `cell` modulo its size
+  static bool same_phase(const IntervalCongruence& offset, VariableRef cell) {
+    if (offset.is_bottom()) {
+      return false;
+    }
+    const auto& c = offset.to_z_congruence();
+    ZNumber size = CellVariableTrait::size(cell).to_z_number();
+    ZNumber cell_offset = CellVariableTrait::offset(cell).to_z_number();
+    return mod(c.modulus(), size) == 0 &&
+           mod(c.residue() - cell_offset, size) == 0;
+  }
+
+  /// \brief Smash the cells of the given memory location
+  ///
+  /// The cells with the same size and phase are folded into the summary cell
+  /// `summary(cell)`, where `cell` is the first of them. The summary cell
+  /// holds the join of their values and covers their bytes.
+  template < typename Summary >
+  void smash_cells(MemoryLocationRef addr, Summary summary) {
+    const CellSetT& cells = this->_cells.get(addr);
+    if (cells.is_empty()) {
+      return;
+    }
+
+    std::vector< std::pair< VariableRef, std::vector< VariableRef > > > groups;
+    for (VariableRef cell : cells) {
+      auto it = std::find_if(groups.begin(), groups.end(), [=](const auto& g) {
+        return same_phase(g.second.front(), cell);
+      });
+      if (it == groups.end()) {
+        groups.emplace_back(summary(cell), std::vector< VariableRef >{cell});
+      } else {
+        it->second.push_back(cell);
+      }
+    }
+
+    CellSetT summaries;
+    for (const auto& group : groups) {
+      VariableRef summary_cell = group.first;
+      const std::vector< VariableRef >& folded = group.second;
+      bool init = std::find(folded.begin(), folded.end(), summary_cell) !=
+                  folded.end();
+      ZeroSegments coverage;
+      for (VariableRef cell : folded) {
+        coverage.add(this->cell_range(cell));
+        if (cell == summary_cell) {
+          continue;
+        }
+        if (init) {
+          this->fold_cell(summary_cell, cell);
+        } else {
+          this->integers().assign(summary_cell, cell);
+          this->pointers().assign(summary_cell, cell);
+          this->uninitialized().assign(summary_cell, cell);
+          init = true;
+        }
+      }
+      for (VariableRef cell : folded) {
+        if (cell != summary_cell) {
+          this->forget_surface_cell(cell);
+        }
+      }
+      summaries.add(summary_cell);
+      this->_summaries.set(summary_cell, coverage);
+    }
+    this->_cells.set(addr, summaries);
+  }
+
+  /// \brief Smash the cells of the given memory location, using the summary
+  /// cells of `other` when possible
+  void smash_cells_as(MemoryLocationRef addr, const ValueDomain& other) {
+    const CellSetT& other_cells = other._cells.get(addr);
+    this->smash_cells(addr, [&other_cells](VariableRef cell) {
+      for (VariableRef summary : other_cells) {
+        if (same_phase(summary, cell)) {
+          return summary;
+        }
+      }
+      return cell;
+    });
+  }
+
+  /// \brief Smash the cells of the given memory location, using canonical
+  /// summary cells
+  void smash_cells(VariableFactory& vfac, MemoryLocationRef addr) {
+    this->smash_cells(addr, [this, &vfac, addr](VariableRef cell) {
+      return this->cell(vfac, addr, phase(cell), CellVariableTrait::size(cell));
+    });
+  }
+
+  /// \brief Perform a weak update `summary = cell`
+  void fold_cell(VariableRef summary, VariableRef cell) {
+    PointerDomain pointer_inv(this->_pointer);
+    UninitializedDomain uninitialized_inv(this->_uninitialized);
+
+    pointer_inv.integers().assign(summary, cell);
+    pointer_inv.assign(summary, cell);
+    uninitialized_inv.assign(summary, cell);
+
+    this->_pointer.join_with(pointer_inv);
+    this->_uninitialized.join_with(uninitialized_inv);
+  }
+
+  /// \brief Forget the cells of the given smashed memory locations that are
+  /// not summary cells anymore, after a binary operation
+  void clean_summaries(const PointsToSetT& addrs) {
+    if (this->_cells.is_bottom()) {
+      return;
+    }
+    for (MemoryLocationRef addr : addrs) {
+      const CellSetT& cells = this->_cells.get(addr);
+      CellSetT new_cells = cells;
+      for (VariableRef cell : cells) {
+        if (!this->is_summary(cell)) {
+          this->forget_surface_cell(cell);
+          new_cells.remove(cell);
+        }
+      }
+      this->_cells.set(addr, new_cells);
+    }
+  }
+
+  /// \brief Remove the given byte range from the summary cells of `addr`,
+  /// except `keep`
+  ///
+  /// Summary cells covering no byte are forgotten.
+  void forget_summary_cells(MemoryLocationRef addr,
+                            const Interval& range,
+                            const std::vector< VariableRef >& keep = {}) {
+    const CellSetT& cells = this->_cells.get(addr);
+    CellSetT new_cells = cells;
+    for (VariableRef cell : cells) {
+      if (std::find(keep.begin(), keep.end(), cell) != keep.end()) {
+        continue;
+      }
+      ZeroSegments coverage = this->_summaries.get(cell);
+      coverage.remove(range);
+      if (coverage.is_empty()) {
+        this->forget_surface_cell(cell);
+        this->_summaries.forget(cell);
+        new_cells.remove(cell);
+      } else {
+        this->_summaries.set(cell, coverage);
+      }
+    }
+    this->_cells.set(addr, new_cells);
+  }
+
   /// \brief Return the byte range for a given cell
   Interval cell_range(VariableRef cell) const {
     const MachineInt& offset = CellVariableTrait::offset(cell);
@@ -442,17 +817,6 @@ private:
     return Interval(offset, offset + size - one);
   }
 
-  /// \brief Return true if the given cell overlaps with the given byte range
-  bool cell_overlap(VariableRef cell, const Interval& range) {
-    Interval meet = this->cell_range(cell).meet(range);
-    return !meet.is_bottom();
-  }
-
-  /// \brief Return true if the given cells overlap
-  bool cell_overlap(VariableRef a, VariableRef b) {
-    return this->cell_overlap(a, this->cell_range(b));
-  }
-
   /// \brief Return true if the memory write at `offset` of size `size`
   /// can update the given cell. Return false if the number of overlaps between
   /// the cell and the memory write is not exactly 1.
@@ -513,10 +877,14 @@ private:
   }
 
   /// \brief Create a new cell for a write, performing reduction if possible
+  ///
+  /// Sets `strong` to false if the returned cell is a summary cell that needs
+  /// a weak update.
   VariableRef write_realize_single_cell(VariableFactory& vfac,
                                         MemoryLocationRef base,
                                         const MachineInt& offset,
-                                        const MachineInt& size) {
+                                        const MachineInt& size,
+                                        bool& strong) {
     VariableRef new_cell = this->cell(vfac, base, offset, size);
     const CellSetT& cells = this->_cells.get(base);
 
@@ -526,26 +894,65 @@ private:
       return new_cell;
     }
 
+    if (this->is_smashed(base)) {
+      return this->write_realize_summary_cell(vfac, new_cell, strong);
+    }
+
     CellSetT new_cells = cells;
     bool found = false;
 
     // remove overlapping cells
-    for (VariableRef cell : cells) {
+    for (VariableRef cell :
+         CellOffsetIndexT::overlapping(cells, this->cell_range(new_cell))) {
       if (cell == new_cell) {
         found = true;
-      } else if (this->cell_overlap(cell, new_cell)) {
+      } else {
         this->forget_surface_cell(cell);
         new_cells.remove(cell);
       }
     }
 
-    if (!found) {
-      new_cells.add(new_cell);
+    if (!found && exceeds_max_cells(new_cells)) {
+      this->_cells.set(base, new_cells);
+      this->smash_cells(vfac, base);
+      return this->write_realize_summary_cell(vfac, new_cell, strong);
     }
+
+    new_cells.add(new_cell);
     this->_cells.set(base, new_cells);
     return new_cell;
   }
 
+  /// \brief Return the summary cell for a write on `cell`, in a smashed
+  /// memory location
+  ///
+  /// Sets `strong` to false if the summary cell covers other bytes.
+  VariableRef write_realize_summary_cell(VariableFactory& vfac,
+                                         VariableRef cell,
+                                         bool& strong) {
+    MemoryLocationRef base = CellVariableTrait::base(cell);
+    VariableRef summary =
+        this->cell(vfac, base, phase(cell), CellVariableTrait::size(cell));
+    Interval range = this->cell_range(cell);
+
+    // Summary cells covering only the written bytes are forgotten, thus
+    // `summary` can be updated strongly if it is not a summary cell anymore
+    this->forget_summary_cells(base, range);
+
+    ZeroSegments coverage = this->_summaries.get(summary);
+    if (coverage.is_empty()) {
+      CellSetT cells = this->_cells.get(base);
+      cells.add(summary);
+      this->_cells.set(base, cells);
+      coverage = ZeroSegments(range);
+    } else {
+      strong = false;
+      coverage.add(range);
+    }
+    this->_summaries.set(summary, coverage);
+    return summary;
+  }
+
   /// \brief Perform a write with an approximated offset.
   ///
   /// Returns a list of cells on which we should perform a weak update.
@@ -565,18 +972,32 @@ private:
       return {};
     }
 
+    if (this->is_smashed(base)) {
+      // Summary cells with the same size and phase as the write are updated,
+      // the others do not cover the written bytes anymore
+      IntervalCongruence offset_ic =
+          this->integers().to_interval_congruence(offset);
+      std::vector< VariableRef > updated_cells;
+      for (VariableRef cell : cells) {
+        if (CellVariableTrait::size(cell) == size &&
+            same_phase(offset_ic, cell)) {
+          updated_cells.push_back(cell);
+        }
+      }
+      this->forget_summary_cells(base, range, updated_cells);
+      return updated_cells;
+    }
+
     CellSetT new_cells = cells;
     std::vector< VariableRef > updated_cells;
 
-    for (VariableRef cell : cells) {
-      if (this->cell_overlap(cell, range)) {
-        if (this->cell_realizes_once(cell, offset, size)) {
-          // that cell has only one way to be affected by the write statement
-          updated_cells.push_back(cell);
-        } else {
-          this->forget_surface_cell(cell);
-          new_cells.remove(cell);
-        }
+    for (VariableRef cell : CellOffsetIndexT::overlapping(cells, range)) {
+      if (this->cell_realizes_once(cell, offset, size)) {
+        // that cell has only one way to be affected by the write statement
+        updated_cells.push_back(cell);
+      } else {
+        this->forget_surface_cell(cell);
+        new_cells.remove(cell);
       }
     }
 
@@ -585,19 +1006,112 @@ private:
   }
 
   /// \brief Create a new cell for a read
-  VariableRef read_realize_single_cell(VariableFactory& vfac,
-                                       MemoryLocationRef base,
-                                       const MachineInt& offset,
-                                       const MachineInt& size) {
+  ///
+  /// Returns boost::none if the memory location is smashed or has too many
+  /// cells, see read_summary_cell().
+  boost::optional< VariableRef > read_realize_single_cell(
+      VariableFactory& vfac,
+      MemoryLocationRef base,
+      const MachineInt& offset,
+      const MachineInt& size) {
+    if (this->is_smashed(base)) {
+      return boost::none;
+    }
     VariableRef new_cell = this->cell(vfac, base, offset, size);
     CellSetT cells = this->_cells.get(base);
+    if (!cells.is_empty() && cells.contains(new_cell)) {
+      return new_cell;
+    }
+    if (exceeds_max_cells(cells)) {
+      return boost::none;
+    }
     cells.add(new_cell);
     this->_cells.set(base, cells);
 
+    // A new cell within a zero segment is zero
+    if (this->_zeros.get(base).contains(this->cell_range(new_cell))) {
+      this->strong_update(new_cell,
+                          LiteralT::machine_int(
+                              MachineInt::zero(MachIntVariableTrait::bit_width(
+                                                   new_cell),
+                                               Signed)));
+    }
+
     // TODO(marthaud): perform further reduction in case of partial overlaps
     return new_cell;
   }
 
+  /// \brief Perform a read `lhs = *(base + offset)` without creating a cell
+  ///
+  /// The result is the value of the summary cell with the same size and phase
+  /// covering the read bytes, zero within zero segments, or unknown.
+  void read_summary_cell(const LiteralT& lhs,
+                         MemoryLocationRef base,
+                         const IntervalCongruence& offset,
+                         const MachineInt& size,
+                         bool first) {
+    Interval range =
+        add(offset.interval(),
+            Interval(MachineInt::zero(size.bit_width(), Unsigned),
+                     size - MachineInt(1, size.bit_width(), Unsigned)));
+
+    for (VariableRef cell : this->_cells.get(base)) {
+      if (CellVariableTrait::size(cell) == size &&
+          same_phase(offset, cell) &&
+          this->_summaries.get(cell).contains(range)) {
+        if (first) {
+          this->strong_update(lhs, cell);
+        } else {
+          this->weak_update(lhs, cell);
+        }
+        return;
+      }
+    }
+
+    if (first && this->_zeros.get(base).contains(range)) {
+      this->assign_zero(lhs);
+    } else {
+      this->forget_surface(lhs.var());
+    }
+  }
+
+  /// \brief Remove the given byte range from the zero segments of `addr`
+  void forget_zeros(MemoryLocationRef addr, const Interval& range) {
+    ZeroSegments zeros = this->_zeros.get(addr);
+    if (zeros.is_empty()) {
+      return;
+    }
+    zeros.remove(range);
+    this->_zeros.set(addr, zeros);
+  }
+
+  /// \brief Return true if all the bytes in the given range of every memory
+  /// location in `addrs` are zero
+  bool is_zero(const PointsToSetT& addrs, const Interval& range) const {
+    for (MemoryLocationRef addr : addrs) {
+      if (!this->_zeros.get(addr).contains(range)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// \brief Assign zero to the result of a read
+  void assign_zero(const LiteralT& lhs) {
+    VariableRef x = lhs.var();
+    if (lhs.is_machine_int_var()) {
+      this->integers().assign(x,
+                              MachineInt::zero(MachIntVariableTrait::bit_width(
+                                                   x),
+                                               MachIntVariableTrait::sign(x)));
+    } else if (lhs.is_pointer_var()) {
+      this->_pointer.assign_null(x);
+    } else {
+      this->forget_surface(x);
+    }
+    this->uninitialized().assign_initialized(x);
+  }
+
   /// \brief Assignment `var = literal`
   class LiteralWriter : public LiteralT::template Visitor<> {
   private:
@@ -834,6 +1348,17 @@ public:
     Interval offset_intv = this->integers().to_interval(this->offset_var(ptr));
     ikos_assert(offset_intv.sign() == Unsigned);
 
+    // Writing zero keeps the zero segments
+    if (!rhs.is_machine_int() || !rhs.machine_int().is_zero()) {
+      Interval range =
+          add(offset_intv,
+              Interval(MachineInt::zero(size.bit_width(), Unsigned),
+                       size - MachineInt(1, size.bit_width(), Unsigned)));
+      for (MemoryLocationRef addr : addrs) {
+        this->forget_zeros(addr, range);
+      }
+    }
+
     if (offset_intv.singleton()) {
       // The offset has one possible value.
       //
@@ -841,10 +1366,11 @@ public:
       MachineInt offset = *offset_intv.singleton();
 
       for (MemoryLocationRef addr : addrs) {
+        bool strong = addrs.size() == 1;
         VariableRef cell =
-            this->write_realize_single_cell(vfac, addr, offset, size);
+            this->write_realize_single_cell(vfac, addr, offset, size, strong);
 
-        if (addrs.size() == 1) {
+        if (strong) {
           this->strong_update(cell, rhs);
         } else {
           this->weak_update(cell, rhs);
@@ -948,15 +1474,21 @@ public:
       bool first = true;
 
       for (MemoryLocationRef addr : addrs) {
-        VariableRef cell =
+        boost::optional< VariableRef > cell =
             this->read_realize_single_cell(vfac, addr, offset, size);
 
-        if (first) {
-          this->strong_update(lhs, cell);
-          first = false;
+        if (!cell) {
+          this->read_summary_cell(lhs,
+                                  addr,
+                                  IntervalCongruence(offset),
+                                  size,
+                                  first);
+        } else if (first) {
+          this->strong_update(lhs, *cell);
         } else {
-          this->weak_update(lhs, cell);
+          this->weak_update(lhs, *cell);
         }
+        first = false;
       }
     } else {
       // The offset is a range.
@@ -975,7 +1507,30 @@ public:
       // summarization array-based domain (e.g.,some array domain
       // such as a trivial array smashing or something more
       // expressive like Cousot&Logozzo's POPL'11).
-      this->forget_surface(lhs.var());
+      //
+      // A read within zero segments still returns zero, and a read of smashed
+      // memory locations returns the value of their summary cells.
+      Interval range =
+          add(offset_intv,
+              Interval(MachineInt::zero(size.bit_width(), Unsigned),
+                       size - MachineInt(1, size.bit_width(), Unsigned)));
+      if (this->is_zero(addrs, range)) {
+        this->assign_zero(lhs);
+      } else if (std::all_of(addrs.begin(),
+                             addrs.end(),
+                             [this](MemoryLocationRef addr) {
+                               return this->is_smashed(addr);
+                             })) {
+        IntervalCongruence offset_ic =
+            this->integers().to_interval_congruence(this->offset_var(ptr));
+        bool first = true;
+        for (MemoryLocationRef addr : addrs) {
+          this->read_summary_cell(lhs, addr, offset_ic, size, first);
+          first = false;
+        }
+      } else {
+        this->forget_surface(lhs.var());
+      }
     }
 
     // Handle pointer sets
@@ -1069,11 +1624,15 @@ public:
         ValueDomain inv(prev);
         const CellSetT& src_cells = inv._cells.get(src_addr);
 
-        if (!src_cells.is_empty()) {
+        // Summary cells are not copied, their bytes are unknown
+        if (!src_cells.is_empty() && !inv.is_smashed(src_addr) &&
+            !inv.is_smashed(dest_addr)) {
           CellSetT dest_cells = inv._cells.get(dest_addr);
 
           for (VariableRef cell : src_cells) {
-            if (this->cell_range(cell).leq(src_range)) {
+            // Cells past the limit are not copied, their value is unknown
+            if (this->cell_range(cell).leq(src_range) &&
+                !exceeds_max_cells(dest_cells)) {
               VariableRef new_cell =
                   this->cell(vfac,
                              dest_addr,
@@ -1090,6 +1649,28 @@ public:
           inv._cells.set(dest_addr, dest_cells);
         }
 
+        // Copy the zero segments of the source range as a whole
+        ZeroSegments src_zeros = inv._zeros.get(src_addr);
+        if (!src_zeros.is_empty()) {
+          ZeroSegments dest_zeros = inv._zeros.get(dest_addr);
+          for (const Interval& segment : src_zeros) {
+            Interval part = segment.meet(src_range);
+            if (part.is_bottom()) {
+              continue;
+            }
+            bool overflow_lb = false;
+            bool overflow_ub = false;
+            MachineInt lb =
+                add(dest_offset, part.lb() - src_offset, overflow_lb);
+            MachineInt ub =
+                add(dest_offset, part.ub() - src_offset, overflow_ub);
+            if (!overflow_lb && !overflow_ub) {
+              dest_zeros.add(Interval(lb, ub));
+            }
+          }
+          inv._zeros.set(dest_addr, dest_zeros);
+        }
+
         if (first) {
           this->operator=(std::move(inv));
           first = false;
@@ -1197,10 +1778,15 @@ public:
       for (MemoryLocationRef addr : addrs) {
         const CellSetT& cells = this->_cells.get(addr);
 
-        if (!cells.is_empty()) {
+        if (this->is_smashed(addr)) {
+          // The zero bytes are summarized by the zero segments below
+          this->forget_summary_cells(addr, unsafe_range);
+        } else if (!cells.is_empty()) {
           CellSetT new_cells = cells;
 
-          for (VariableRef cell : cells) {
+          // Cells included in the safe or unsafe range overlap it
+          for (VariableRef cell :
+               CellOffsetIndexT::overlapping(cells, unsafe_range)) {
             Interval range = this->cell_range(cell);
 
             if (range.leq(safe_range)) {
@@ -1220,6 +1806,13 @@ public:
           this->_cells.set(addr, new_cells);
         }
       }
+
+      // Summarize the bytes surely set to zero as one segment
+      if (addrs.singleton() && !size_lb.is_zero() && !safe_range.is_bottom()) {
+        ZeroSegments zeros = this->_zeros.get(*addrs.singleton());
+        zeros.add(safe_range);
+        this->_zeros.set(*addrs.singleton(), zeros);
+      }
     } else {
       // to be sound, remove all reachable cells
       for (MemoryLocationRef addr : addrs) {
@@ -1275,10 +1868,14 @@ private:
     }
 
     this->_cells.set_to_top();
+    this->_zeros.set_to_top();
+    this->_summaries.set_to_top();
   }
 
   /// \brief Forget the synthetic cells for the given memory location
   void forget_cells(MemoryLocationRef addr) {
+    this->_zeros.forget(addr);
+
     const CellSetT& cells = this->_cells.get(addr);
 
     if (cells.is_bottom()) {
@@ -1287,6 +1884,7 @@ private:
 
     for (VariableRef cell : cells) {
       this->forget_surface_cell(cell);
+      this->_summaries.forget(cell);
     }
 
     this->_cells.forget(addr);
@@ -1320,6 +1918,13 @@ private:
   void forget_cells(MemoryLocationRef addr, const Interval& range) {
     ikos_assert(!range.is_bottom());
 
+    this->forget_zeros(addr, range);
+
+    if (this->is_smashed(addr)) {
+      this->forget_summary_cells(addr, range);
+      return;
+    }
+
     const CellSetT& cells = this->_cells.get(addr);
     CellSetT new_cells = cells;
 
@@ -1327,11 +1932,9 @@ private:
       return;
     }
 
-    for (VariableRef cell : cells) {
-      if (cell_overlap(cell, range)) {
-        this->forget_surface_cell(cell);
-        new_cells.remove(cell);
-      }
+    for (VariableRef cell : CellOffsetIndexT::overlapping(cells, range)) {
+      this->forget_surface_cell(cell);
+      new_cells.remove(cell);
     }
 
     this->_cells.set(addr, new_cells);
@@ -1474,6 +2077,18 @@ public:
 
   void zero_reachable_mem(VariableRef p) override {
     this->uninitialize_reachable_mem(p);
+
+    if (this->is_bottom() || this->nullity().is_null(p)) {
+      return;
+    }
+
+    // The whole memory location is one zero segment
+    PointsToSetT addrs = this->_pointer.points_to(p);
+    if (auto addr = addrs.singleton()) {
+      unsigned bit_width = MachIntVariableTrait::bit_width(this->offset_var(p));
+      this->_zeros.set(*addr,
+                       ZeroSegments(Interval::top(bit_width, Unsigned)));
+    }
   }
 
   void uninitialize_reachable_mem(VariableRef p) override {
@@ -1503,11 +2118,148 @@ public:
     }
   }
 
+  /// \brief Forget the memory locations that are unreachable
+  ///
+  /// A memory location is reachable if `is_root(addr)` returns true, or if it
+  /// is pointed by a pointer variable that is not a cell, or by a cell or the
+  /// pointer set of a reachable memory location.
+  ///
+  /// The cells, pointer set and lifetime of unreachable memory locations are
+  /// forgotten. Nothing is forgotten if a pointer might point anywhere.
+  ///
+  /// Returns the list of forgotten memory locations.
+  template < typename IsRoot >
+  std::vector< MemoryLocationRef > forget_unreachable_mem(IsRoot is_root) {
+    if (this->is_bottom()) {
+      return {};
+    }
+
+    // Reachable memory locations
+    PointsToSetT reachable = PointsToSetT::empty();
+    std::vector< MemoryLocationRef > worklist;
+    auto visit = [&reachable, &worklist](MemoryLocationRef addr) {
+      if (!reachable.contains(addr)) {
+        reachable.add(addr);
+        worklist.push_back(addr);
+      }
+    };
+
+    // Only memory locations with cells, a pointer set or zero segments can be
+    // forgotten. Check them first, to avoid a walk over all the pointers when
+    // they are all roots.
+    bool collectible = false;
+    auto visit_root = [&](MemoryLocationRef addr) {
+      if (is_root(addr)) {
+        visit(addr);
+      } else {
+        collectible = true;
+      }
+    };
+    for (auto it = this->_cells.begin(), et = this->_cells.end(); it != et;
+         ++it) {
+      visit_root(it->first);
+    }
+    for (auto it = this->_pointer_sets.begin(), et = this->_pointer_sets.end();
+         it != et;
+         ++it) {
+      visit_root(it->first);
+    }
+    for (auto it = this->_zeros.begin(), et = this->_zeros.end(); it != et;
+         ++it) {
+      visit_root(it->first);
+    }
+
+    if (!collectible) {
+      return {};
+    }
+
+    // Memory locations pointed by the cells of a memory location
+    //
+    // The memory locations pointed by the pointer set of a memory location are
+    // looked up in _pointer_sets directly.
+    PatriciaTreeMap< MemoryLocationRef, PointsToSetT > successors;
+    auto add_successors = [&successors](MemoryLocationRef addr,
+                                        const PointsToSetT& addrs) {
+      boost::optional< const PointsToSetT& > prev = successors.at(addr);
+      PointsToSetT succ = prev ? *prev : PointsToSetT::empty();
+      succ.join_with(addrs);
+      successors.insert_or_assign(addr, succ);
+    };
+
+    bool unknown = false;
+    this->_pointer.for_each_points_to(
+        [&](VariableRef p, const PointsToSetT& addrs) {
+          if (MemVariableTrait::is_cell(p)) {
+            add_successors(CellVariableTrait::base(p), addrs);
+          } else if (addrs.is_top()) {
+            unknown = true;
+          } else {
+            for (MemoryLocationRef addr : addrs) {
+              visit(addr);
+            }
+          }
+        });
+
+    if (unknown) {
+      return {};
+    }
+
+    while (!worklist.empty()) {
+      MemoryLocationRef addr = worklist.back();
+      worklist.pop_back();
+
+      for (const auto& succ :
+           {successors.at(addr), this->_pointer_sets.points_to(addr)}) {
+        if (!succ) {
+          continue;
+        }
+        if (succ->is_top()) {
+          return {};
+        }
+        for (MemoryLocationRef dest : *succ) {
+          visit(dest);
+        }
+      }
+    }
+
+    // Collect the unreachable memory locations
+    std::vector< MemoryLocationRef > unreachable;
+    auto collect = [&reachable, &unreachable](MemoryLocationRef addr) {
+      if (!reachable.contains(addr)) {
+        // Mark it, to avoid duplicates
+        reachable.add(addr);
+        unreachable.push_back(addr);
+      }
+    };
+
+    for (auto it = this->_cells.begin(), et = this->_cells.end(); it != et;
+         ++it) {
+      collect(it->first);
+    }
+    for (auto it = this->_pointer_sets.begin(), et = this->_pointer_sets.end();
+         it != et;
+         ++it) {
+      collect(it->first);
+    }
+    for (auto it = this->_zeros.begin(), et = this->_zeros.end(); it != et;
+         ++it) {
+      collect(it->first);
+    }
+
+    for (MemoryLocationRef addr : unreachable) {
+      this->forget_mem(addr);
+      this->_lifetime.forget(addr);
+    }
+
+    return unreachable;
+  }
+
   void normalize() const override {
     // is_bottom() will normalize
     if (this->_cells.is_bottom() || this->_pointer_sets.is_bottom() ||
-        this->_pointer.is_bottom() || this->_uninitialized.is_bottom() ||
-        this->_lifetime.is_bottom()) {
+        this->_zeros.is_bottom() || this->_summaries.is_bottom() ||
+        this->_pointer.is_bottom() ||
+        this->_uninitialized.is_bottom() || this->_lifetime.is_bottom()) {
       const_cast< ValueDomain* >(this)->set_to_bottom();
     }
   }
@@ -1523,6 +2275,10 @@ public:
       o << ", ";
       this->_pointer_sets.dump(o);
       o << ", ";
+      this->_zeros.dump(o);
+      o << ", ";
+      this->_summaries.dump(o);
+      o << ", ";
       this->_pointer.dump(o);
       o << ", ";
       this->_uninitialized.dump(o);
@@ -0,0 +1,225 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Index of the cells of a cell set, sorted by offset
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+#include <ikos/core/domain/memory/value/cell_set.hpp>
+#include <ikos/core/number/machine_int.hpp>
+#include <ikos/core/semantic/memory/cell.hpp>
+#include <ikos/core/value/machine_int/interval.hpp>
+
+namespace ikos {
+namespace core {
+namespace memory {
+
+/// \brief Index of the cells of a cell set, sorted by offset
+///
+/// It returns the cells overlapping a byte range with two binary searches,
+/// instead of a scan of the whole cell set.
+///
+/// Cell sets are hash-consed and shared between abstract values, so indexes
+/// are cached per cell set and built only once.
+template < typename VariableRef, typename MemoryLocationRef >
+class CellOffsetIndex {
+private:
+  /// \brief Trait for cell variables
+  using CellVariableTrait =
+      CellVariableTraits< VariableRef, MemoryLocationRef >;
+
+  /// \brief Set of cells
+  using CellSetT = CellSet< VariableRef >;
+
+  /// \brief Machine integer interval
+  using Interval = machine_int::Interval;
+
+  /// \brief Cell with its byte range
+  struct Entry {
+    MachineInt lb;
+    MachineInt ub;
+    VariableRef cell;
+  };
+
+  /// \brief Cache of indexes
+  using Cache = std::unordered_map< CellSetT,
+                                    std::shared_ptr< const CellOffsetIndex >,
+                                    boost::hash< CellSetT > >;
+
+private:
+  /// \brief Cell sets smaller than this are scanned without an index
+  static constexpr std::size_t MinIndexedSize = 16;
+
+  /// \brief Maximum number of cached indexes, per thread
+  static constexpr std::size_t MaxCacheSize = 1024;
+
+private:
+  /// \brief Cells sorted by lower bound of their byte range
+  std::vector< Entry > _entries;
+
+  /// \brief Largest cell size minus one
+  MachineInt _max_extent;
+
+private:
+  /// \brief Build the index of the given cell set
+  explicit CellOffsetIndex(const CellSetT& cells)
+      : _entries(sorted_entries(cells)),
+        _max_extent(max_extent(this->_entries)) {}
+
+  /// \brief Return the cells with their byte range, sorted by lower bound
+  static std::vector< Entry > sorted_entries(const CellSetT& cells) {
+    ikos_assert(!cells.is_empty());
+    std::vector< Entry > entries;
+    entries.reserve(cells.size());
+    for (VariableRef cell : cells) {
+      Interval range = cell_range(cell);
+      entries.push_back(Entry{range.lb(), range.ub(), cell});
+    }
+    std::sort(entries.begin(),
+              entries.end(),
+              [](const Entry& a, const Entry& b) { return a.lb < b.lb; });
+    return entries;
+  }
+
+  /// \brief Return the largest cell size minus one
+  static MachineInt max_extent(const std::vector< Entry >& entries) {
+    MachineInt extent = entries.front().ub - entries.front().lb;
+    for (const Entry& entry : entries) {
+      MachineInt entry_extent = entry.ub - entry.lb;
+      if (entry_extent > extent) {
+        extent = std::move(entry_extent);
+      }
+    }
+    return extent;
+  }
+
+  /// \brief Return the byte range of the given cell
+  static Interval cell_range(VariableRef cell) {
+    const MachineInt& offset = CellVariableTrait::offset(cell);
+    const MachineInt& size = CellVariableTrait::size(cell);
+    MachineInt one(1, offset.bit_width(), Unsigned);
+    return Interval(offset, offset + size - one);
+  }
+
+  /// \brief Return the index of the given cell set, from the cache
+  static std::shared_ptr< const CellOffsetIndex > get(const CellSetT& cells) {
+    static thread_local Cache cache;
+
+    auto it = cache.find(cells);
+    if (it != cache.end()) {
+      return it->second;
+    }
+
+    if (cache.size() >= MaxCacheSize) {
+      cache.clear();
+    }
+    std::shared_ptr< const CellOffsetIndex > index(new CellOffsetIndex(cells));
+    cache.emplace(cells, index);
+    return index;
+  }
+
+  /// \brief Append the cells overlapping [lb, ub] to `result`
+  void overlapping(const MachineInt& lb,
+                   const MachineInt& ub,
+                   std::vector< VariableRef >& result) const {
+    // A cell starting before lb - max_extent cannot reach lb
+    bool overflow = false;
+    MachineInt start = sub(lb, this->_max_extent, overflow);
+    if (overflow) {
+      start.set_min();
+    }
+
+    auto first =
+        std::lower_bound(this->_entries.begin(),
+                         this->_entries.end(),
+                         start,
+                         [](const Entry& e, const MachineInt& x) {
+                           return e.lb < x;
+                         });
+    auto last =
+        std::upper_bound(first,
+                         this->_entries.end(),
+                         ub,
+                         [](const MachineInt& x, const Entry& e) {
+                           return x < e.lb;
+                         });
+    for (auto it = first; it != last; ++it) {
+      if (it->ub >= lb) {
+        result.push_back(it->cell);
+      }
+    }
+  }
+
+public:
+  /// \brief Return the cells of `cells` overlapping the given byte range
+  static std::vector< VariableRef > overlapping(const CellSetT& cells,
+                                                const Interval& range) {
+    std::vector< VariableRef > result;
+    if (cells.is_empty() || range.is_bottom()) {
+      return result;
+    }
+
+    if (cells.size() < MinIndexedSize) {
+      for (VariableRef cell : cells) {
+        if (!cell_range(cell).meet(range).is_bottom()) {
+          result.push_back(cell);
+        }
+      }
+      return result;
+    }
+
+    get(cells)->overlapping(range.lb(), range.ub(), result);
+    return result;
+  }
+
+}; // end class CellOffsetIndex
+
+} // end namespace memory
+} // end namespace core
+} // end namespace ikos
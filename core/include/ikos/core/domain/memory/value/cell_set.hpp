@@ -60,10 +60,12 @@ namespace memory {
 /// The bottom value is represented as top.
 ///
 /// Note that this is not a lattice.
+///
+/// Cell sets are hash-consed, so that equal cell sets share their tree.
 template < typename VariableRef >
 class CellSet final : public core::AbstractDomain< CellSet< VariableRef > > {
 private:
-  using PatriciaTreeSetT = PatriciaTreeSet< VariableRef >;
+  using PatriciaTreeSetT = PatriciaTreeSet< VariableRef, true >;
 
 public:
   using Iterator = typename PatriciaTreeSetT::Iterator;
@@ -108,6 +110,9 @@ public:
   /// \brief Return the number of cells
   std::size_t size() const { return this->_set.size(); }
 
+  /// \brief Return the hash of the cell set
+  std::size_t hash() const { return this->_set.hash(); }
+
   /// \brief Begin iterator over the cells
   Iterator begin() const { return this->_set.begin(); }
 
@@ -204,6 +209,12 @@ public:
 
 }; // end class CellSet
 
+/// \brief Return the hash of a cell set
+template < typename VariableRef >
+inline std::size_t hash_value(const CellSet< VariableRef >& cells) {
+  return cells.hash();
+}
+
 } // end namespace memory
 } // end namespace core
 } // end namespace ikos
@@ -51,9 +51,13 @@ namespace core {
 namespace memory {
 
 /// \brief Map from memory locations to set of synthetic cells
+///
+/// The underlying patricia trees are hash-consed: abstract values mostly
+/// differ in a few memory locations, and comparisons become pointer
+/// comparisons.
 template < typename MemoryLocationRef, typename VariableRef >
 using MemLocToCellSet =
-    SeparateDomain< MemoryLocationRef, CellSet< VariableRef > >;
+    SeparateDomain< MemoryLocationRef, CellSet< VariableRef >, true >;
 
 } // end namespace memory
 } // end namespace core
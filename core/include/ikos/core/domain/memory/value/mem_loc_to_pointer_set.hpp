@@ -63,6 +63,7 @@ public:
 
 private:
   using PointerSetT = PointerSet< MemoryLocationRef >;
+  using PointsToSetT = PointsToSet< MemoryLocationRef >;
   using PatriciaTreeMapT = PatriciaTreeMap< MemoryLocationRef, PointerSetT >;
 
 public:
@@ -317,6 +318,19 @@ public:
     }
   }
 
+  /// \brief Return the points-to set of the pointer set of the given memory
+  /// location, or boost::none if it is unknown
+  boost::optional< const PointsToSetT& > points_to(
+      MemoryLocationRef addr) const {
+    ikos_assert(!this->is_bottom());
+    boost::optional< const PointerSetT& > v = this->_tree.at(addr);
+    if (v) {
+      return v->points_to();
+    } else {
+      return boost::none;
+    }
+  }
+
   /// \brief Set the pointer set of the given memory location
   void set(MemoryLocationRef addr, const PointerSetT& pointer_set) {
     if (this->is_bottom()) {
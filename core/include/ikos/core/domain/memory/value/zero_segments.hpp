@@ -0,0 +1,281 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Byte ranges of a memory location known to be zero
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <vector>
+
+#include <ikos/core/domain/abstract_domain.hpp>
+#include <ikos/core/domain/separate_domain.hpp>
+#include <ikos/core/value/machine_int/interval.hpp>
+
+namespace ikos {
+namespace core {
+namespace memory {
+
+/// \brief Set of byte ranges of a memory location known to be zero
+///
+/// A memory set to zero, or a memory copy from zeroed bytes, is summarized
+/// as one segment of bytes instead of one cell per element.
+///
+/// Segments are sorted by offset, disjoint and not adjacent.
+///
+/// As for CellSet, the empty set represents top, and the bottom value is
+/// represented as top. Note that this is not a lattice.
+class ZeroSegments final : public core::AbstractDomain< ZeroSegments > {
+public:
+  /// \brief Machine integer interval
+  using Interval = machine_int::Interval;
+
+  using Iterator = std::vector< Interval >::const_iterator;
+
+private:
+  std::vector< Interval > _segments;
+
+private:
+  struct EmptyTag {};
+
+  /// \brief Create the empty set
+  explicit ZeroSegments(EmptyTag) {}
+
+public:
+  /// \brief Create the empty set
+  ZeroSegments() : ZeroSegments(EmptyTag{}) {}
+
+  /// \brief Create the set with the given segment
+  explicit ZeroSegments(const Interval& range) : _segments{range} {
+    ikos_assert(!range.is_bottom());
+  }
+
+  /// \brief Copy constructor
+  ZeroSegments(const ZeroSegments&) = default;
+
+  /// \brief Move constructor
+  ZeroSegments(ZeroSegments&&) = default;
+
+  /// \brief Copy assignment operator
+  ZeroSegments& operator=(const ZeroSegments&) = default;
+
+  /// \brief Move assignment operator
+  ZeroSegments& operator=(ZeroSegments&&) = default;
+
+  /// \brief Destructor
+  ~ZeroSegments() override = default;
+
+  /// \brief Create the top value (empty set)
+  static ZeroSegments top() { return ZeroSegments(EmptyTag{}); }
+
+  /// \brief Create the bottom value (empty set)
+  static ZeroSegments bottom() { return ZeroSegments(EmptyTag{}); }
+
+  /// \brief Begin iterator over the segments
+  Iterator begin() const { return this->_segments.cbegin(); }
+
+  /// \brief End iterator over the segments
+  Iterator end() const { return this->_segments.cend(); }
+
+  bool is_bottom() const override { return false; }
+
+  bool is_top() const override { return this->_segments.empty(); }
+
+  /// \brief Return true if the set is empty
+  bool is_empty() const { return this->_segments.empty(); }
+
+  void set_to_bottom() override { this->_segments.clear(); }
+
+  void set_to_top() override { this->_segments.clear(); }
+
+  /// \brief Return true if all the bytes in the given range are zero
+  bool contains(const Interval& range) const {
+    for (const Interval& segment : this->_segments) {
+      if (range.leq(segment)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool leq(const ZeroSegments& other) const override {
+    for (const Interval& segment : other._segments) {
+      if (!this->contains(segment)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool equals(const ZeroSegments& other) const override {
+    if (this->_segments.size() != other._segments.size()) {
+      return false;
+    }
+    for (std::size_t i = 0; i < this->_segments.size(); i++) {
+      if (!this->_segments[i].equals(other._segments[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void join_with(const ZeroSegments& other) override {
+    // Only keep the bytes zero on both sides
+    std::vector< Interval > segments;
+    auto it = this->_segments.begin(), et = this->_segments.end();
+    auto other_it = other._segments.begin(), other_et = other._segments.end();
+    while (it != et && other_it != other_et) {
+      Interval inter = it->meet(*other_it);
+      if (!inter.is_bottom()) {
+        segments.push_back(inter);
+      }
+      if (it->ub() < other_it->ub()) {
+        ++it;
+      } else {
+        ++other_it;
+      }
+    }
+    this->_segments = std::move(segments);
+  }
+
+  void widen_with(const ZeroSegments& other) override {
+    // Drop the segments that shrink, so that segments are only removed
+    std::vector< Interval > segments;
+    for (const Interval& segment : this->_segments) {
+      if (other.contains(segment)) {
+        segments.push_back(segment);
+      }
+    }
+    this->_segments = std::move(segments);
+  }
+
+  void meet_with(const ZeroSegments& other) override {
+    for (const Interval& segment : other._segments) {
+      this->add(segment);
+    }
+  }
+
+  void narrow_with(const ZeroSegments& /*other*/) override {
+    // Keep the current segments, to ensure termination
+  }
+
+  /// \brief Add the given byte range
+  void add(const Interval& range) {
+    ikos_assert(!range.is_bottom());
+    std::vector< Interval > segments;
+    segments.reserve(this->_segments.size() + 1);
+    Interval merged = range;
+    bool inserted = false;
+    for (const Interval& segment : this->_segments) {
+      if (precedes(segment, merged)) {
+        segments.push_back(segment);
+      } else if (precedes(merged, segment)) {
+        if (!inserted) {
+          segments.push_back(merged);
+          inserted = true;
+        }
+        segments.push_back(segment);
+      } else {
+        merged.join_with(segment);
+      }
+    }
+    if (!inserted) {
+      segments.push_back(merged);
+    }
+    this->_segments = std::move(segments);
+  }
+
+  /// \brief Remove the given byte range
+  void remove(const Interval& range) {
+    ikos_assert(!range.is_bottom());
+    std::vector< Interval > segments;
+    segments.reserve(this->_segments.size() + 1);
+    for (const Interval& segment : this->_segments) {
+      if (segment.meet(range).is_bottom()) {
+        segments.push_back(segment);
+        continue;
+      }
+      MachineInt one(1, range.bit_width(), Unsigned);
+      if (segment.lb() < range.lb()) {
+        segments.emplace_back(segment.lb(), range.lb() - one);
+      }
+      if (range.ub() < segment.ub()) {
+        segments.emplace_back(range.ub() + one, segment.ub());
+      }
+    }
+    this->_segments = std::move(segments);
+  }
+
+  void dump(std::ostream& o) const override {
+    if (this->is_top()) {
+      o << "⊤";
+    } else {
+      o << "{";
+      for (auto it = this->_segments.begin(), et = this->_segments.end();
+           it != et;) {
+        it->dump(o);
+        ++it;
+        if (it != et) {
+          o << ", ";
+        }
+      }
+      o << "}";
+    }
+  }
+
+  static std::string name() { return "zero segments domain"; }
+
+private:
+  /// \brief Return true if `lhs` ends before `rhs` starts, with a gap
+  static bool precedes(const Interval& lhs, const Interval& rhs) {
+    return !lhs.ub().is_max() &&
+           lhs.ub() + MachineInt(1, lhs.bit_width(), Unsigned) < rhs.lb();
+  }
+
+}; // end class ZeroSegments
+
+/// \brief Map from memory locations to zero segments
+template < typename MemoryLocationRef >
+using MemLocToZeroSegments = SeparateDomain< MemoryLocationRef, ZeroSegments >;
+
+} // end namespace memory
+} // end namespace core
+} // end namespace ikos
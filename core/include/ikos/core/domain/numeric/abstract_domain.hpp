@@ -43,6 +43,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <vector>
+
 #include <ikos/core/domain/abstract_domain.hpp>
 #include <ikos/core/domain/numeric/operator.hpp>
 #include <ikos/core/linear_constraint.hpp>
@@ -142,6 +145,36 @@ public:
   /// \brief Forget a numerical variable
   virtual void forget(VariableRef x) = 0;
 
+  /// \brief Forget a set of numerical variables
+  virtual void forget_vars(const std::vector< VariableRef >& vars) {
+    for (VariableRef x : vars) {
+      this->forget(x);
+    }
+  }
+
+  /// \brief Forget all numerical variables except the given ones
+  ///
+  /// The default implementation keeps the linear constraints on these
+  /// variables only.
+  virtual void project(const std::vector< VariableRef >& keep) {
+    this->normalize();
+    if (this->is_bottom()) {
+      return;
+    }
+
+    LinearConstraintSystemT csts = this->to_linear_constraint_system();
+    this->set_to_top();
+    for (const LinearConstraintT& cst : csts) {
+      bool kept = true;
+      for (auto it = cst.begin(), et = cst.end(); it != et && kept; ++it) {
+        kept = std::find(keep.begin(), keep.end(), it->first) != keep.end();
+      }
+      if (kept) {
+        this->add(cst);
+      }
+    }
+  }
+
   /// \brief Normalize the abstract value
   virtual void normalize() const = 0;
 
@@ -44,7 +44,12 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <ap_global0.h>
@@ -61,6 +66,7 @@
 #include <ikos/core/linear_expression.hpp>
 #include <ikos/core/number.hpp>
 #include <ikos/core/support/assert.hpp>
+#include <ikos/core/support/compiler.hpp>
 #include <ikos/core/value/numeric/congruence.hpp>
 #include <ikos/core/value/numeric/interval.hpp>
 
@@ -70,65 +76,6 @@ namespace numeric {
 
 namespace apron {
 
-/// \brief Wrapper for ap_abstract0_t*
-using InvPtr = std::shared_ptr< ap_abstract0_t >;
-
-/// \brief Deleter for InvPtr
-struct InvDeleter {
-  void operator()(ap_abstract0_t* inv) {
-    ap_abstract0_free(ap_abstract0_manager(inv), inv);
-  }
-};
-
-/// \brief Create a InvPtr from a ap_abstract0_t*
-inline InvPtr inv_ptr(ap_abstract0_t* inv) {
-  return std::shared_ptr< ap_abstract0_t >(inv, InvDeleter());
-}
-
-/// \returns the size of a ap_abstract0_t
-inline std::size_t dims(ap_abstract0_t* inv) {
-  return ap_abstract0_dimension(ap_abstract0_manager(inv), inv).intdim;
-}
-
-/// \brief Add some dimensions to a ap_abstract0_t
-inline InvPtr add_dimensions(ap_abstract0_t* inv, std::size_t dims) {
-  ikos_assert(dims > 0);
-
-  ap_dimchange_t* dimchange = ap_dimchange_alloc(dims, 0);
-  for (std::size_t i = 0; i < dims; i++) {
-    // add dimension at the end
-    dimchange->dim[i] = static_cast< ap_dim_t >(apron::dims(inv));
-  }
-
-  ap_manager_t* manager = ap_abstract0_manager(inv);
-  InvPtr r = inv_ptr(
-      ap_abstract0_add_dimensions(manager, false, inv, dimchange, false));
-  ap_dimchange_free(dimchange);
-  return r;
-}
-
-/// \brief Remove some dimensions of a ap_abstract0_t
-inline InvPtr remove_dimensions(ap_abstract0_t* inv,
-                                const std::vector< ap_dim_t >& dims) {
-  ikos_assert(!dims.empty());
-  ikos_assert(std::is_sorted(dims.begin(), dims.end()));
-
-  // make sure that the removing dimensions are in ascending order
-
-  ap_dimchange_t* dimchange = ap_dimchange_alloc(dims.size(), 0);
-  for (std::size_t i = 0; i < dims.size(); i++) {
-    // remove dimension dims[i] and shift to the left all the dimensions greater
-    // than dims[i]
-    dimchange->dim[i] = dims[i];
-  }
-
-  ap_manager_t* manager = ap_abstract0_manager(inv);
-  InvPtr r =
-      inv_ptr(ap_abstract0_remove_dimensions(manager, false, inv, dimchange));
-  ap_dimchange_free(dimchange);
-  return r;
-}
-
 /// \brief Create a binary expression
 template < typename Number >
 inline ap_texpr0_t* binop_expr(ap_texpr_op_t, ap_texpr0_t*, ap_texpr0_t*);
@@ -159,6 +106,24 @@ inline ap_scalar_t* to_ap_scalar(const QNumber& n) {
   return ap_scalar_alloc_set_mpq(e.get_mpq_t());
 }
 
+/// \brief Set an ap_coeff_t* to the given ikos::ZNumber
+///
+/// Small numbers are converted without creating a temporary GMP number.
+inline void set_ap_coeff(ap_coeff_t* coeff, const ZNumber& n) {
+  if (n.fits< long >()) {
+    ap_coeff_set_scalar_int(coeff, n.to< long >());
+  } else {
+    mpq_class e(n.mpz());
+    ap_coeff_set_scalar_mpq(coeff, e.get_mpq_t());
+  }
+}
+
+/// \brief Set an ap_coeff_t* to the given ikos::QNumber
+inline void set_ap_coeff(ap_coeff_t* coeff, const QNumber& q) {
+  mpq_class e(q.mpq());
+  ap_coeff_set_scalar_mpq(coeff, e.get_mpq_t());
+}
+
 /// \brief Conversion from ikos::ZNumber to ap_texpr0_t*
 inline ap_texpr0_t* to_ap_expr(const ZNumber& n) {
   mpq_class e(n.mpz());
@@ -302,6 +267,399 @@ inline ap_abstract0_t* domain_narrowing(Domain d,
   }
 }
 
+/// \brief Number of available abstract domains
+constexpr std::size_t NumDomains = PkgridPolyhedraLinCongruences + 1;
+
+/// \brief Managers of a thread
+///
+/// Apron managers are not thread-safe, so each thread allocates its own
+/// managers, on first use.
+///
+/// Apron reference counts managers: each abstract value holds a reference on
+/// the manager that created it, and the counter is not atomic. Thus, an
+/// abstract value freed by another thread is handed back to the thread that
+/// created it, which frees it on its next call to thread_manager(). Once that
+/// thread exited, its abstract values are freed under `mutex`.
+struct ThreadManagers : public std::enable_shared_from_this< ThreadManagers > {
+  /// \brief Managers of the thread, or null if not allocated yet
+  ap_manager_t* managers[NumDomains] = {};
+
+  /// \brief Protects `alive` and `pending`
+  std::mutex mutex;
+
+  /// \brief False once the thread released its managers
+  bool alive = true;
+
+  /// \brief Abstract values freed by other threads
+  std::vector< ap_abstract0_t* > pending;
+
+  /// \brief True if `pending` might not be empty
+  std::atomic< bool > has_pending{false};
+
+  /// \brief Free the abstract values handed back by other threads
+  ///
+  /// This must be called by the thread owning the managers.
+  void free_pending() {
+    std::vector< ap_abstract0_t* > invs;
+    {
+      std::lock_guard< std::mutex > lock(this->mutex);
+      invs.swap(this->pending);
+      this->has_pending.store(false, std::memory_order_relaxed);
+    }
+    for (ap_abstract0_t* inv : invs) {
+      ap_abstract0_free(inv->man, inv);
+    }
+  }
+
+  /// \brief Release the references of the thread on its managers
+  ///
+  /// This must be called by the thread owning the managers. The managers
+  /// are freed with their last abstract value.
+  void release();
+};
+
+/// \brief Map from managers to the threads that allocated them
+class ManagerRegistry {
+private:
+  std::mutex _mutex;
+  std::unordered_map< ap_manager_t*, std::shared_ptr< ThreadManagers > >
+      _owners;
+
+  /// \brief Managers allocated by threads that already released theirs
+  std::vector< std::shared_ptr< ThreadManagers > > _late;
+
+public:
+  /// \brief Constructor
+  ManagerRegistry() = default;
+
+  /// \brief No copy constructor
+  ManagerRegistry(const ManagerRegistry&) = delete;
+
+  /// \brief No move constructor
+  ManagerRegistry(ManagerRegistry&&) = delete;
+
+  /// \brief No copy assignment operator
+  ManagerRegistry& operator=(const ManagerRegistry&) = delete;
+
+  /// \brief No move assignment operator
+  ManagerRegistry& operator=(ManagerRegistry&&) = delete;
+
+  /// \brief Destructor
+  ///
+  /// Releases the managers allocated after their thread released its
+  /// managers, i.e, by the destructor of another thread local variable.
+  ~ManagerRegistry() {
+    for (const auto& managers : this->_late) {
+      for (ap_abstract0_t* inv : managers->pending) {
+        ap_abstract0_free(inv->man, inv);
+      }
+      for (ap_manager_t* man : managers->managers) {
+        if (man != nullptr) {
+          ap_manager_free(man);
+        }
+      }
+    }
+  }
+
+  /// \brief Return the registry
+  static ManagerRegistry& get() {
+    static ManagerRegistry registry;
+    return registry;
+  }
+
+  /// \brief Register a manager allocated by `owner`
+  void add(ap_manager_t* man, const std::shared_ptr< ThreadManagers >& owner) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    this->_owners[man] = owner;
+  }
+
+  /// \brief Unregister a manager that is about to be freed
+  void remove(ap_manager_t* man) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    this->_owners.erase(man);
+  }
+
+  /// \brief Return the thread that allocated the given manager
+  std::shared_ptr< ThreadManagers > owner(ap_manager_t* man) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    auto it = this->_owners.find(man);
+    ikos_assert_msg(it != this->_owners.end(), "unknown apron manager");
+    return it->second;
+  }
+
+  /// \brief Keep the given managers until exit
+  void add_late(const std::shared_ptr< ThreadManagers >& managers) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    this->_late.push_back(managers);
+  }
+};
+
+inline void ThreadManagers::release() {
+  std::lock_guard< std::mutex > lock(this->mutex);
+  for (ap_abstract0_t* inv : this->pending) {
+    ap_abstract0_free(inv->man, inv);
+  }
+  this->pending.clear();
+  this->has_pending.store(false, std::memory_order_relaxed);
+  for (ap_manager_t*& man : this->managers) {
+    if (man != nullptr) {
+      if (man->count == 1) {
+        ManagerRegistry::get().remove(man);
+      }
+      ap_manager_free(man);
+      man = nullptr;
+    }
+  }
+  this->alive = false;
+}
+
+/// \brief State of the current thread
+struct ThreadState {
+  /// \brief Managers of the current thread, or null
+  ThreadManagers* managers;
+
+  /// \brief True once the thread released its managers
+  bool released;
+
+  /// \brief Releases the managers on thread exit
+  class Releaser {
+  private:
+    std::shared_ptr< ThreadManagers > _managers;
+
+  public:
+    /// \brief Constructor
+    explicit Releaser(std::shared_ptr< ThreadManagers > managers)
+        : _managers(std::move(managers)) {}
+
+    /// \brief No copy constructor
+    Releaser(const Releaser&) = delete;
+
+    /// \brief No move constructor
+    Releaser(Releaser&&) = delete;
+
+    /// \brief No copy assignment operator
+    Releaser& operator=(const Releaser&) = delete;
+
+    /// \brief No move assignment operator
+    Releaser& operator=(Releaser&&) = delete;
+
+    /// \brief Destructor
+    ~Releaser() {
+      this->_managers->release();
+      ThreadState::get().managers = nullptr;
+      ThreadState::get().released = true;
+    }
+  };
+
+  /// \brief Return the state of the current thread
+  static ThreadState& get() {
+    static thread_local ThreadState state; // zero-initialized
+    return state;
+  }
+
+  /// \brief Return the managers of the current thread, allocated on first use
+  static ThreadManagers& current() {
+    ThreadState& state = get();
+    if (ikos_unlikely(state.managers == nullptr)) {
+      auto managers = std::make_shared< ThreadManagers >();
+      if (!state.released) {
+        static thread_local Releaser releaser(managers);
+        static_cast< void >(releaser);
+      } else {
+        ManagerRegistry::get().add_late(managers);
+      }
+      state.managers = managers.get();
+    }
+    return *state.managers;
+  }
+};
+
+/// \brief Return the manager of the current thread for the given domain
+inline ap_manager_t* thread_manager(Domain d) {
+  ThreadManagers& managers = ThreadState::current();
+  if (ikos_unlikely(managers.has_pending.load(std::memory_order_acquire))) {
+    managers.free_pending();
+  }
+  ap_manager_t*& man = managers.managers[d];
+  if (ikos_unlikely(man == nullptr)) {
+    man = alloc_domain_manager(d);
+    ManagerRegistry::get().add(man, managers.shared_from_this());
+  }
+  return man;
+}
+
+/// \brief Wrapper for ap_abstract0_t*
+using InvPtr = std::shared_ptr< ap_abstract0_t >;
+
+/// \brief Deleter for InvPtr
+struct InvDeleter {
+  Domain domain;
+
+  void operator()(ap_abstract0_t* inv) const {
+    ThreadManagers* managers = ThreadState::get().managers;
+    if (managers != nullptr && inv->man == managers->managers[this->domain]) {
+      ap_abstract0_free(inv->man, inv);
+      return;
+    }
+
+    // The abstract value was created by another thread
+    std::shared_ptr< ThreadManagers > owner =
+        ManagerRegistry::get().owner(inv->man);
+    std::lock_guard< std::mutex > lock(owner->mutex);
+    if (owner->alive) {
+      owner->pending.push_back(inv);
+      owner->has_pending.store(true, std::memory_order_release);
+    } else {
+      ap_manager_t* man = inv->man;
+      if (man->count == 1) {
+        ManagerRegistry::get().remove(man);
+      }
+      ap_abstract0_free(man, inv);
+    }
+  }
+};
+
+/// \brief Create a InvPtr from a ap_abstract0_t*
+inline InvPtr inv_ptr(Domain d, ap_abstract0_t* inv) {
+  return std::shared_ptr< ap_abstract0_t >(inv, InvDeleter{d});
+}
+
+/// \returns the size of a ap_abstract0_t
+inline std::size_t dims(ap_manager_t* manager, ap_abstract0_t* inv) {
+  return ap_abstract0_dimension(manager, inv).intdim;
+}
+
+/// \brief Add some dimensions to a ap_abstract0_t
+inline InvPtr add_dimensions(Domain d,
+                             ap_abstract0_t* inv,
+                             std::size_t dims) {
+  ikos_assert(dims > 0);
+
+  ap_manager_t* manager = thread_manager(d);
+  ap_dimchange_t* dimchange = ap_dimchange_alloc(dims, 0);
+  for (std::size_t i = 0; i < dims; i++) {
+    // add dimension at the end
+    dimchange->dim[i] = static_cast< ap_dim_t >(apron::dims(manager, inv));
+  }
+
+  InvPtr r = inv_ptr(
+      d, ap_abstract0_add_dimensions(manager, false, inv, dimchange, false));
+  ap_dimchange_free(dimchange);
+  return r;
+}
+
+/// \brief Remove some dimensions of a ap_abstract0_t
+inline InvPtr remove_dimensions(Domain d,
+                                ap_abstract0_t* inv,
+                                const std::vector< ap_dim_t >& dims) {
+  ikos_assert(!dims.empty());
+  ikos_assert(std::is_sorted(dims.begin(), dims.end()));
+
+  // make sure that the removing dimensions are in ascending order
+
+  ap_dimchange_t* dimchange = ap_dimchange_alloc(dims.size(), 0);
+  for (std::size_t i = 0; i < dims.size(); i++) {
+    // remove dimension dims[i] and shift to the left all the dimensions greater
+    // than dims[i]
+    dimchange->dim[i] = dims[i];
+  }
+
+  ap_manager_t* manager = thread_manager(d);
+  InvPtr r = inv_ptr(
+      d, ap_abstract0_remove_dimensions(manager, false, inv, dimchange));
+  ap_dimchange_free(dimchange);
+  return r;
+}
+
+/// \brief Limits on the operations of the polyhedra domains
+///
+/// Polyhedra can grow to thousands of constraints and generators, and a
+/// single operation can then take minutes. When an operation exceeds a limit,
+/// the abstract value is approximated with an octagon, and then with
+/// intervals if the octagon is still too large.
+///
+/// This only applies to PolkaPolyhedra, PplPolyhedra and
+/// PkgridPolyhedraLinCongruences.
+struct Limits {
+  /// \brief Maximum size of an abstract value, or 0 for no limit
+  ///
+  /// This is the number of coefficients of the constraint and generator
+  /// systems, see ap_abstract0_size(). Apron aborts an operation whose result
+  /// would exceed it.
+  std::size_t max_size;
+
+  /// \brief Maximum duration of an operation in milliseconds, or 0 for no
+  /// limit
+  ///
+  /// Operations are not interrupted, but the result of a slow operation is
+  /// approximated, so that the next operations are fast.
+  unsigned timeout;
+};
+
+/// \brief Return the limits of the polyhedra domains
+///
+/// This is shared by all threads, and should be set before the analysis
+/// starts.
+inline Limits& limits() {
+  static Limits limits = {0, 0};
+  return limits;
+}
+
+/// \brief Return true if the given domain is subject to limits()
+constexpr bool has_limits(Domain d) {
+  return d == PolkaPolyhedra || d == PplPolyhedra ||
+         d == PkgridPolyhedraLinCongruences;
+}
+
+/// \brief Approximate an abstract value with an octagon
+///
+/// The result is an abstract value of the same domain.
+inline InvPtr octagon_approximation(Domain d, const InvPtr& inv) {
+  ap_manager_t* manager = thread_manager(d);
+  ap_manager_t* oct_manager = thread_manager(Octagon);
+  std::size_t n = dims(manager, inv.get());
+
+  ap_lincons0_array_t csts = ap_abstract0_to_lincons_array(manager, inv.get());
+  ap_abstract0_t* oct =
+      ap_abstract0_meet_lincons_array(oct_manager,
+                                      true,
+                                      ap_abstract0_top(oct_manager, n, 0),
+                                      &csts);
+  ap_lincons0_array_clear(&csts);
+
+  ap_lincons0_array_t oct_csts =
+      ap_abstract0_to_lincons_array(oct_manager, oct);
+  ap_abstract0_free(oct_manager, oct);
+  InvPtr r = inv_ptr(d,
+                     ap_abstract0_meet_lincons_array(manager,
+                                                     true,
+                                                     ap_abstract0_top(manager,
+                                                                      n,
+                                                                      0),
+                                                     &oct_csts));
+  ap_lincons0_array_clear(&oct_csts);
+  return r;
+}
+
+/// \brief Approximate an abstract value with intervals
+///
+/// The result is an abstract value of the same domain.
+inline InvPtr interval_approximation(Domain d, const InvPtr& inv) {
+  ap_manager_t* manager = thread_manager(d);
+  std::size_t n = dims(manager, inv.get());
+
+  if (n == 0) {
+    return inv;
+  } else if (ap_abstract0_is_bottom(manager, inv.get())) {
+    return inv_ptr(d, ap_abstract0_bottom(manager, n, 0));
+  }
+
+  ap_interval_t** box = ap_abstract0_to_box(manager, inv.get());
+  InvPtr r = inv_ptr(d, ap_abstract0_of_box(manager, n, 0, box));
+  ap_interval_array_free(box, n);
+  return r;
+}
+
 } // end namespace apron
 
 /// \brief Wrapper for APRON abstract domains
@@ -329,11 +687,92 @@ private:
   VariableMap _var_map;
 
 private:
-  /// \brief Get the manager for the given apron domain
-  static ap_manager_t* manager() {
-    // Initialized at first call
-    static ap_manager_t* man = apron::alloc_domain_manager(Domain);
-    return man;
+  /// \brief Get the manager of the current thread for the apron domain
+  static ap_manager_t* manager() { return apron::thread_manager(Domain); }
+
+  /// \brief Create a InvPtr from a ap_abstract0_t*
+  static apron::InvPtr inv_ptr(ap_abstract0_t* inv) {
+    return apron::inv_ptr(Domain, inv);
+  }
+
+  /// \brief Apply an Apron operation within the limits of apron::limits()
+  ///
+  /// `op` computes the result from the operands `x` and `y` (possibly null),
+  /// using manager(). If the operation runs out of space, it is applied again
+  /// on octagon approximations of the operands, and then on interval
+  /// approximations. If the result is too large or took too long to compute,
+  /// it is approximated.
+  template < typename Operation >
+  static apron::InvPtr apply_within_limits(ap_funid_t funid,
+                                           const Operation& op,
+                                           apron::InvPtr x,
+                                           apron::InvPtr y) {
+    const apron::Limits& limits = apron::limits();
+
+    if (!apron::has_limits(Domain) ||
+        (limits.max_size == 0 && limits.timeout == 0)) {
+      return inv_ptr(op(x.get(), y.get()));
+    }
+
+    ap_manager_t* man = manager();
+    ap_funopt_t funopt = ap_manager_get_funopt(man, funid);
+    funopt.max_object_size = limits.max_size;
+    ap_manager_set_funopt(man, funid, &funopt);
+
+    for (int approximation = 0;; approximation++) {
+      auto start = std::chrono::steady_clock::now();
+      man->result.exn = AP_EXC_NONE;
+      apron::InvPtr r = inv_ptr(op(x.get(), y.get()));
+
+      if (man->result.exn != AP_EXC_OUT_OF_SPACE &&
+          man->result.exn != AP_EXC_TIMEOUT) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return approximate_within_limits(r, elapsed);
+      } else if (approximation == 2) {
+        // The result of an aborted operation is sound, but imprecise
+        return r;
+      }
+
+      if (approximation == 0) {
+        x = apron::octagon_approximation(Domain, x);
+        y = y ? apron::octagon_approximation(Domain, y) : y;
+      } else {
+        x = apron::interval_approximation(Domain, x);
+        y = y ? apron::interval_approximation(Domain, y) : y;
+      }
+
+      if (funid == AP_FUNID_WIDENING) {
+        // The widening requires x <= y
+        y = inv_ptr(ap_abstract0_join(man, false, x.get(), y.get()));
+      }
+    }
+  }
+
+  /// \brief Approximate the result of an operation exceeding the limits
+  static apron::InvPtr approximate_within_limits(
+      const apron::InvPtr& inv, std::chrono::steady_clock::duration elapsed) {
+    const apron::Limits& limits = apron::limits();
+    bool too_slow = limits.timeout != 0 &&
+                    elapsed > std::chrono::milliseconds(limits.timeout);
+    bool too_large = limits.max_size != 0 &&
+                     ap_abstract0_size(manager(), inv.get()) > limits.max_size;
+
+    if (!too_slow && !too_large) {
+      return inv;
+    }
+
+    apron::InvPtr oct = apron::octagon_approximation(Domain, inv);
+    if (limits.max_size == 0 ||
+        ap_abstract0_size(manager(), oct.get()) <= limits.max_size) {
+      return oct;
+    }
+
+    return apron::interval_approximation(Domain, oct);
+  }
+
+  /// \returns the size of a ap_abstract0_t
+  static std::size_t dims(ap_abstract0_t* inv) {
+    return apron::dims(manager(), inv);
   }
 
   /// \brief Get the dimension associated to a variable
@@ -349,9 +788,9 @@ private:
       return *dim;
     } else {
       auto new_dim = static_cast< ap_dim_t >(this->_var_map.size());
-      this->_inv = apron::add_dimensions(this->_inv.get(), 1);
+      this->_inv = apron::add_dimensions(Domain, this->_inv.get(), 1);
       this->_var_map.insert_or_assign(v, new_dim);
-      ikos_assert(this->_var_map.size() == apron::dims(this->_inv.get()));
+      ikos_assert(this->_var_map.size() == dims(this->_inv.get()));
       return new_dim;
     }
   }
@@ -361,8 +800,8 @@ private:
                                     apron::InvPtr& inv_x,
                                     const VariableMap& var_map_y,
                                     apron::InvPtr& inv_y) {
-    ikos_assert(var_map_x.size() == apron::dims(inv_x.get()));
-    ikos_assert(var_map_y.size() == apron::dims(inv_y.get()));
+    ikos_assert(var_map_x.size() == dims(inv_x.get()));
+    ikos_assert(var_map_y.size() == dims(inv_y.get()));
 
     // build a result variable map, based on var_map_x
     VariableMap result_var_map(var_map_x);
@@ -389,25 +828,27 @@ private:
 
     // add the necessary dimensions to inv_x and inv_y
     if (result_var_map.size() > var_map_x.size()) {
-      inv_x = apron::add_dimensions(inv_x.get(),
+      inv_x = apron::add_dimensions(Domain,
+                                    inv_x.get(),
                                     result_var_map.size() - var_map_x.size());
     }
     if (result_var_map.size() > var_map_y.size()) {
-      inv_y = apron::add_dimensions(inv_y.get(),
+      inv_y = apron::add_dimensions(Domain,
+                                    inv_y.get(),
                                     result_var_map.size() - var_map_y.size());
     }
 
-    ikos_assert(result_var_map.size() == apron::dims(inv_x.get()));
-    ikos_assert(result_var_map.size() == apron::dims(inv_y.get()));
+    ikos_assert(result_var_map.size() == dims(inv_x.get()));
+    ikos_assert(result_var_map.size() == dims(inv_y.get()));
 
     // build and apply the permutation map for inv_y
     ap_dimperm_t* perm_y = build_perm_map(var_map_y, result_var_map);
-    inv_y = apron::inv_ptr(
+    inv_y = inv_ptr(
         ap_abstract0_permute_dimensions(manager(), false, inv_y.get(), perm_y));
     ap_dimperm_free(perm_y);
 
-    ikos_assert(result_var_map.size() == apron::dims(inv_x.get()));
-    ikos_assert(result_var_map.size() == apron::dims(inv_y.get()));
+    ikos_assert(result_var_map.size() == dims(inv_x.get()));
+    ikos_assert(result_var_map.size() == dims(inv_y.get()));
 
     return result_var_map;
   }
@@ -450,34 +891,86 @@ private:
     return ap_texpr0_dim(var_dim_insert(v));
   }
 
-  /// \brief Conversion from LinearExpression to ap_texpr0_t*
-  ap_texpr0_t* to_ap_expr(const LinearExpressionT& e) {
-    ap_texpr0_t* r = apron::to_ap_expr(e.constant());
+  /// \brief Conversion from LinearExpression to ap_linexpr0_t*
+  ///
+  /// This is cheaper than building an ap_texpr0_t* tree, since the result is
+  /// a single sparse array.
+  ap_linexpr0_t* to_ap_linexpr(const LinearExpressionT& e) {
+    ap_linexpr0_t* r = ap_linexpr0_alloc(AP_LINEXPR_SPARSE, e.num_terms());
+    apron::set_ap_coeff(ap_linexpr0_cstref(r), e.constant());
 
     for (auto it = e.begin(), et = e.end(); it != et; ++it) {
-      ap_texpr0_t* term =
-          apron::binop_expr< Number >(AP_TEXPR_MUL,
-                                      apron::to_ap_expr(it->second),
-                                      to_ap_expr(it->first));
-      r = apron::binop_expr< Number >(AP_TEXPR_ADD, r, term);
+      ap_dim_t dim = var_dim_insert(it->first);
+      apron::set_ap_coeff(ap_linexpr0_coeffref(r, dim), it->second);
     }
 
     return r;
   }
 
-  /// \brief Conversion from LinearConstraint to ap_tcons0_t
-  ap_tcons0_t to_ap_constraint(const LinearConstraintT& cst) {
+  /// \brief Conversion from LinearConstraint to ap_lincons0_t
+  ap_lincons0_t to_ap_constraint(const LinearConstraintT& cst) {
     const LinearExpressionT& exp = cst.expression();
 
     if (cst.is_equality()) {
-      return ap_tcons0_make(AP_CONS_EQ, to_ap_expr(exp), nullptr);
+      return ap_lincons0_make(AP_CONS_EQ, to_ap_linexpr(exp), nullptr);
     } else if (cst.is_inequality()) {
-      return ap_tcons0_make(AP_CONS_SUPEQ, to_ap_expr(-exp), nullptr);
+      return ap_lincons0_make(AP_CONS_SUPEQ, to_ap_linexpr(-exp), nullptr);
     } else {
-      return ap_tcons0_make(AP_CONS_DISEQ, to_ap_expr(exp), nullptr);
+      return ap_lincons0_make(AP_CONS_DISEQ, to_ap_linexpr(exp), nullptr);
     }
   }
 
+  /// \brief Conversion from a congruence on x to ap_lincons0_t
+  ap_lincons0_t to_ap_constraint(VariableRef x, const CongruenceT& value) {
+    ikos_assert(!value.is_bottom() && !value.is_top());
+
+    if (value.singleton()) {
+      return to_ap_constraint(VariableExprT(x) == *value.singleton());
+    } else {
+      return ap_lincons0_make(AP_CONS_EQMOD,
+                              to_ap_linexpr(VariableExprT(x) -
+                                            value.residue()),
+                              apron::to_ap_scalar(value.modulus()));
+    }
+  }
+
+  /// \brief Meet with the given array of constraints, in one Apron call
+  ///
+  /// The array is freed.
+  void add(ap_lincons0_array_t& csts) {
+    this->_inv = apply_within_limits(
+        AP_FUNID_MEET_LINCONS_ARRAY,
+        [&csts](ap_abstract0_t* x, ap_abstract0_t*) {
+          return ap_abstract0_meet_lincons_array(manager(), false, x, &csts);
+        },
+        this->_inv,
+        nullptr);
+
+    // this step allows to improve the precision
+    for (std::size_t i = 0; i < csts.size && !this->is_bottom(); i++) {
+      ap_lincons0_t& cst = csts.p[i];
+      if (cst.constyp == AP_CONS_EQMOD) {
+        continue;
+      }
+
+      // check satisfiability of csts.p[i]
+      ap_interval_t* ap_intv =
+          ap_abstract0_bound_linexpr(manager(), this->_inv.get(), cst.linexpr0);
+      IntervalT intv = apron::to_ikos_interval< Number >(ap_intv);
+      ap_interval_free(ap_intv);
+
+      if (intv.is_bottom() ||
+          (cst.constyp == AP_CONS_EQ && !intv.contains(0)) ||
+          (cst.constyp == AP_CONS_SUPEQ && intv.ub() < BoundT(0)) ||
+          (cst.constyp == AP_CONS_DISEQ && intv == IntervalT(0))) {
+        // cst is not satisfiable
+        this->set_to_bottom();
+      }
+    }
+
+    ap_lincons0_array_clear(&csts);
+  }
+
   /// \brief Conversion from ap_linexpr0_t* to LinearExpression
   LinearExpressionT to_ikos_linear_expression(ap_linexpr0_t* expr) const {
     ikos_assert(ap_linexpr0_is_linear(expr));
@@ -530,11 +1023,11 @@ private:
 
   /// \brief Create the top abstract value
   explicit ApronDomain(TopTag)
-      : _inv(apron::inv_ptr(ap_abstract0_top(manager(), 0, 0))) {}
+      : _inv(inv_ptr(ap_abstract0_top(manager(), 0, 0))) {}
 
   /// \brief Create the bottom abstract value
   explicit ApronDomain(BottomTag)
-      : _inv(apron::inv_ptr(ap_abstract0_bottom(manager(), 0, 0))) {}
+      : _inv(inv_ptr(ap_abstract0_bottom(manager(), 0, 0))) {}
 
 public:
   /// \brief Create the top abstract value
@@ -617,8 +1110,13 @@ public:
       apron::InvPtr inv_y(other._inv);
       VariableMap var_map =
           merge_var_maps(this->_var_map, inv_x, other._var_map, inv_y);
-      apron::InvPtr inv = apron::inv_ptr(
-          ap_abstract0_join(manager(), false, inv_x.get(), inv_y.get()));
+      apron::InvPtr inv = apply_within_limits(
+          AP_FUNID_JOIN,
+          [](ap_abstract0_t* x, ap_abstract0_t* y) {
+            return ap_abstract0_join(manager(), false, x, y);
+          },
+          inv_x,
+          inv_y);
       return ApronDomain(inv, var_map);
     }
   }
@@ -637,8 +1135,13 @@ public:
       apron::InvPtr inv_y(other._inv);
       VariableMap var_map =
           merge_var_maps(this->_var_map, inv_x, other._var_map, inv_y);
-      apron::InvPtr inv = apron::inv_ptr(
-          ap_abstract0_widening(manager(), inv_x.get(), inv_y.get()));
+      apron::InvPtr inv = apply_within_limits(
+          AP_FUNID_WIDENING,
+          [](ap_abstract0_t* x, ap_abstract0_t* y) {
+            return ap_abstract0_widening(manager(), x, y);
+          },
+          inv_x,
+          inv_y);
       return ApronDomain(inv, var_map);
     }
   }
@@ -669,8 +1172,13 @@ public:
       apron::InvPtr inv_y(other._inv);
       VariableMap var_map =
           merge_var_maps(this->_var_map, inv_x, other._var_map, inv_y);
-      apron::InvPtr inv = apron::inv_ptr(
-          ap_abstract0_meet(manager(), false, inv_x.get(), inv_y.get()));
+      apron::InvPtr inv = apply_within_limits(
+          AP_FUNID_MEET,
+          [](ap_abstract0_t* x, ap_abstract0_t* y) {
+            return ap_abstract0_meet(manager(), false, x, y);
+          },
+          inv_x,
+          inv_y);
       return ApronDomain(inv, var_map);
     }
   }
@@ -691,7 +1199,7 @@ public:
       apron::InvPtr inv_y(other._inv);
       VariableMap var_map =
           merge_var_maps(this->_var_map, inv_x, other._var_map, inv_y);
-      apron::InvPtr inv = apron::inv_ptr(
+      apron::InvPtr inv = inv_ptr(
           apron::domain_narrowing(Domain, manager(), inv_x.get(), inv_y.get()));
       return ApronDomain(inv, var_map);
     }
@@ -718,15 +1226,63 @@ public:
       return;
     }
 
-    ap_texpr0_t* t = to_ap_expr(e);
+    ap_linexpr0_t* t = to_ap_linexpr(e);
     ap_dim_t v_dim = var_dim_insert(x);
-    this->_inv = apron::inv_ptr(ap_abstract0_assign_texpr(manager(),
-                                                          false,
-                                                          this->_inv.get(),
-                                                          v_dim,
-                                                          t,
-                                                          nullptr));
-    ap_texpr0_free(t);
+    this->_inv = apply_within_limits(
+        AP_FUNID_ASSIGN_LINEXPR_ARRAY,
+        [&v_dim, &t](ap_abstract0_t* x, ap_abstract0_t*) {
+          return ap_abstract0_assign_linexpr_array(manager(),
+                                                   false,
+                                                   x,
+                                                   &v_dim,
+                                                   &t,
+                                                   1,
+                                                   nullptr);
+        },
+        this->_inv,
+        nullptr);
+    ap_linexpr0_free(t);
+  }
+
+  /// \brief Perform the parallel assignment x_i = e_i, for all i
+  ///
+  /// All the expressions are evaluated in the current abstract value, and the
+  /// assignment is performed in one Apron call.
+  ///
+  /// The variables x_i must be distinct.
+  void assign(
+      const std::vector< std::pair< VariableRef, LinearExpressionT > >& xs) {
+    if (this->is_bottom() || xs.empty()) {
+      return;
+    }
+
+    std::vector< ap_dim_t > dims;
+    std::vector< ap_linexpr0_t* > exprs;
+    dims.reserve(xs.size());
+    exprs.reserve(xs.size());
+    for (const auto& assignment : xs) {
+      exprs.push_back(to_ap_linexpr(assignment.second));
+    }
+    for (const auto& assignment : xs) {
+      dims.push_back(var_dim_insert(assignment.first));
+    }
+
+    this->_inv = apply_within_limits(
+        AP_FUNID_ASSIGN_LINEXPR_ARRAY,
+        [&dims, &exprs](ap_abstract0_t* x, ap_abstract0_t*) {
+          return ap_abstract0_assign_linexpr_array(manager(),
+                                                   false,
+                                                   x,
+                                                   dims.data(),
+                                                   exprs.data(),
+                                                   exprs.size(),
+                                                   nullptr);
+        },
+        this->_inv,
+        nullptr);
+    for (ap_linexpr0_t* e : exprs) {
+      ap_linexpr0_free(e);
+    }
   }
 
 private:
@@ -772,12 +1328,18 @@ private:
     }
 
     ap_dim_t x_dim = var_dim_insert(x);
-    this->_inv = apron::inv_ptr(ap_abstract0_assign_texpr(manager(),
-                                                          false,
-                                                          this->_inv.get(),
-                                                          x_dim,
-                                                          t,
-                                                          nullptr));
+    this->_inv = apply_within_limits(
+        AP_FUNID_ASSIGN_TEXPR_ARRAY,
+        [x_dim, t](ap_abstract0_t* x, ap_abstract0_t*) {
+          return ap_abstract0_assign_texpr(manager(),
+                                           false,
+                                           x,
+                                           x_dim,
+                                           t,
+                                           nullptr);
+        },
+        this->_inv,
+        nullptr);
     ap_texpr0_free(t);
   }
 
@@ -859,39 +1421,14 @@ public:
       return;
     }
 
-    ap_tcons0_array_t ap_csts = ap_tcons0_array_make(csts.size());
+    ap_lincons0_array_t ap_csts = ap_lincons0_array_make(csts.size());
 
     std::size_t i = 0;
     for (const LinearConstraintT& cst : csts) {
       ap_csts.p[i++] = to_ap_constraint(cst);
     }
 
-    this->_inv = apron::inv_ptr(ap_abstract0_meet_tcons_array(manager(),
-                                                              false,
-                                                              this->_inv.get(),
-                                                              &ap_csts));
-
-    // this step allows to improve the precision
-    for (i = 0; i < csts.size() && !this->is_bottom(); i++) {
-      // check satisfiability of ap_csts.p[i]
-      ap_tcons0_t& cst = ap_csts.p[i];
-      ap_interval_t* ap_intv =
-          ap_abstract0_bound_texpr(manager(), this->_inv.get(), cst.texpr0);
-      IntervalT intv = apron::to_ikos_interval< Number >(ap_intv);
-
-      if (intv.is_bottom() ||
-          (cst.constyp == AP_CONS_EQ && !intv.contains(0)) ||
-          (cst.constyp == AP_CONS_SUPEQ && intv.ub() < BoundT(0)) ||
-          (cst.constyp == AP_CONS_DISEQ && intv == IntervalT(0))) {
-        // cst is not satisfiable
-        this->set_to_bottom();
-        return;
-      }
-
-      ap_interval_free(ap_intv);
-    }
-
-    ap_tcons0_array_clear(&ap_csts);
+    this->add(ap_csts);
   }
 
   void set(VariableRef x, const IntervalT& value) override {
@@ -923,8 +1460,7 @@ public:
       this->set_to_bottom();
     } else {
       this->forget(x);
-      this->refine(x, value.interval());
-      this->refine(x, value.congruence());
+      this->refine(x, value);
     }
   }
 
@@ -947,19 +1483,10 @@ public:
       this->set_to_bottom();
     } else if (value.is_top()) {
       return;
-    } else if (value.singleton()) {
-      this->add(VariableExprT(x) == *value.singleton());
     } else {
-      ap_tcons0_array_t csts = ap_tcons0_array_make(1);
-      csts.p[0] = ap_tcons0_make(AP_CONS_EQMOD,
-                                 to_ap_expr(VariableExprT(x) - value.residue()),
-                                 apron::to_ap_scalar(value.modulus()));
-      this->_inv =
-          apron::inv_ptr(ap_abstract0_meet_tcons_array(manager(),
-                                                       false,
-                                                       this->_inv.get(),
-                                                       &csts));
-      ap_tcons0_array_clear(&csts);
+      ap_lincons0_array_t csts = ap_lincons0_array_make(1);
+      csts.p[0] = to_ap_constraint(x, value);
+      this->add(csts);
     }
   }
 
@@ -969,8 +1496,24 @@ public:
     } else if (value.is_bottom()) {
       this->set_to_bottom();
     } else {
-      this->refine(x, value.interval());
-      this->refine(x, value.congruence());
+      // Meet with all the constraints at once
+      LinearConstraintSystemT itv_csts = within_interval(x, value.interval());
+      bool has_cong = !value.congruence().is_top();
+      std::size_t n = itv_csts.size() + (has_cong ? 1 : 0);
+
+      if (n == 0) {
+        return;
+      }
+
+      ap_lincons0_array_t csts = ap_lincons0_array_make(n);
+      std::size_t i = 0;
+      for (const LinearConstraintT& cst : itv_csts) {
+        csts.p[i++] = to_ap_constraint(cst);
+      }
+      if (has_cong) {
+        csts.p[i++] = to_ap_constraint(x, value.congruence());
+      }
+      this->add(csts);
     }
   }
 
@@ -983,13 +1526,14 @@ public:
 
     ap_dim_t dim = *has_dim;
     std::vector< ap_dim_t > vector_dims{dim};
-    this->_inv = apron::inv_ptr(ap_abstract0_forget_array(manager(),
+    this->_inv = inv_ptr(ap_abstract0_forget_array(manager(),
                                                           false,
                                                           this->_inv.get(),
                                                           &vector_dims[0],
                                                           vector_dims.size(),
                                                           false));
-    this->_inv = apron::remove_dimensions(this->_inv.get(), vector_dims);
+    this->_inv =
+        apron::remove_dimensions(Domain, this->_inv.get(), vector_dims);
     this->_var_map.transform([dim](VariableRef, ap_dim_t d) {
       if (d < dim) {
         return boost::optional< ap_dim_t >(d);
@@ -999,9 +1543,64 @@ public:
         return boost::optional< ap_dim_t >(d - 1);
       }
     });
-    ikos_assert(this->_var_map.size() == apron::dims(this->_inv.get()));
+    ikos_assert(this->_var_map.size() == dims(this->_inv.get()));
   }
 
+  void forget_vars(const std::vector< VariableRef >& vars) override {
+    std::vector< ap_dim_t > vector_dims;
+    for (VariableRef x : vars) {
+      boost::optional< const ap_dim_t& > dim = var_dim(x);
+      if (dim) {
+        vector_dims.push_back(*dim);
+      }
+    }
+    this->remove_dims(std::move(vector_dims));
+  }
+
+  void project(const std::vector< VariableRef >& keep) override {
+    std::vector< VariableRef > kept(keep);
+    std::sort(kept.begin(), kept.end());
+    std::vector< ap_dim_t > vector_dims;
+    for (auto it = this->_var_map.begin(), et = this->_var_map.end(); it != et;
+         ++it) {
+      if (!std::binary_search(kept.begin(), kept.end(), it->first)) {
+        vector_dims.push_back(it->second);
+      }
+    }
+    this->remove_dims(std::move(vector_dims));
+  }
+
+private:
+  /// \brief Forget and remove the given dimensions at once
+  void remove_dims(std::vector< ap_dim_t > vector_dims) {
+    if (vector_dims.empty()) {
+      return;
+    }
+
+    std::sort(vector_dims.begin(), vector_dims.end());
+    vector_dims.erase(std::unique(vector_dims.begin(), vector_dims.end()),
+                      vector_dims.end());
+    this->_inv = inv_ptr(ap_abstract0_forget_array(manager(),
+                                                          false,
+                                                          this->_inv.get(),
+                                                          &vector_dims[0],
+                                                          vector_dims.size(),
+                                                          false));
+    this->_inv =
+        apron::remove_dimensions(Domain, this->_inv.get(), vector_dims);
+    this->_var_map.transform([&vector_dims](VariableRef, ap_dim_t d) {
+      auto it = std::lower_bound(vector_dims.begin(), vector_dims.end(), d);
+      if (it != vector_dims.end() && *it == d) {
+        return boost::optional< ap_dim_t >(boost::none);
+      } else {
+        return boost::optional< ap_dim_t >(
+            d - static_cast< ap_dim_t >(it - vector_dims.begin()));
+      }
+    });
+    ikos_assert(this->_var_map.size() == dims(this->_inv.get()));
+  }
+
+public:
   void normalize() const override {
     ap_abstract0_canonicalize(manager(), this->_inv.get());
   }
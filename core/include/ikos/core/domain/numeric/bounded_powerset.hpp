@@ -0,0 +1,570 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Bounded powerset numerical abstract domain
+ *
+ * Finite disjunctions of abstract values, with at most MaxDisjuncts
+ * disjuncts. When a join produces more disjuncts, the two closest disjuncts
+ * are merged, where the distance between two disjuncts is the number of
+ * constraints of one that the other does not entail.
+ *
+ * See Roberto Bagnara, Patricia M. Hill and Enea Zaffanella's paper:
+ * Widening operators for powerset domains, in STTT, 8(4-5):449-466, 2006.
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <ikos/core/domain/numeric/abstract_domain.hpp>
+#include <ikos/core/support/assert.hpp>
+#include <ikos/core/value/numeric/congruence.hpp>
+#include <ikos/core/value/numeric/interval.hpp>
+
+namespace ikos {
+namespace core {
+namespace numeric {
+
+/// \brief Bounded powerset abstract domain
+///
+/// An abstract value is a disjunction of at most MaxDisjuncts non-bottom
+/// values of NumericDomain. The empty disjunction is bottom.
+///
+/// The number of disjuncts bounds the memory, and every operation costs at
+/// most MaxDisjuncts^2 operations on NumericDomain. Widening and narrowing
+/// merge all disjuncts, hence the fixpoint iterations terminate.
+template < typename Number,
+           typename VariableRef,
+           typename NumericDomain,
+           std::size_t MaxDisjuncts >
+class BoundedPowersetDomain final
+    : public numeric::AbstractDomain<
+          Number,
+          VariableRef,
+          BoundedPowersetDomain< Number,
+                                 VariableRef,
+                                 NumericDomain,
+                                 MaxDisjuncts > > {
+public:
+  static_assert(MaxDisjuncts >= 1, "MaxDisjuncts must be at least 1");
+
+public:
+  using BoundT = Bound< Number >;
+  using IntervalT = Interval< Number >;
+  using CongruenceT = Congruence< Number >;
+  using IntervalCongruenceT = IntervalCongruence< Number >;
+  using LinearExpressionT = LinearExpression< Number, VariableRef >;
+  using LinearConstraintT = LinearConstraint< Number, VariableRef >;
+  using LinearConstraintSystemT = LinearConstraintSystem< Number, VariableRef >;
+
+private:
+  /// \brief Disjuncts, none of them is bottom
+  std::vector< NumericDomain > _disjuncts;
+
+private:
+  struct TopTag {};
+  struct BottomTag {};
+
+  /// \brief Create the top abstract value
+  explicit BoundedPowersetDomain(TopTag) : _disjuncts{NumericDomain::top()} {}
+
+  /// \brief Create the bottom abstract value
+  explicit BoundedPowersetDomain(BottomTag) {}
+
+  /// \brief Create an abstract value with a single disjunct
+  explicit BoundedPowersetDomain(NumericDomain inv) {
+    if (!inv.is_bottom()) {
+      this->_disjuncts.push_back(std::move(inv));
+    }
+  }
+
+public:
+  /// \brief Create the top abstract value
+  BoundedPowersetDomain() : BoundedPowersetDomain(TopTag{}) {}
+
+  /// \brief Copy constructor
+  BoundedPowersetDomain(const BoundedPowersetDomain&) = default;
+
+  /// \brief Move constructor
+  BoundedPowersetDomain(BoundedPowersetDomain&&) = default;
+
+  /// \brief Copy assignment operator
+  BoundedPowersetDomain& operator=(const BoundedPowersetDomain&) = default;
+
+  /// \brief Move assignment operator
+  BoundedPowersetDomain& operator=(BoundedPowersetDomain&&) = default;
+
+  /// \brief Destructor
+  ~BoundedPowersetDomain() override = default;
+
+  /// \brief Create the top abstract value
+  static BoundedPowersetDomain top() {
+    return BoundedPowersetDomain(TopTag{});
+  }
+
+  /// \brief Create the bottom abstract value
+  static BoundedPowersetDomain bottom() {
+    return BoundedPowersetDomain(BottomTag{});
+  }
+
+  /// \brief Return the number of disjuncts
+  std::size_t num_disjuncts() const { return this->_disjuncts.size(); }
+
+  /// \brief Return the disjuncts
+  const std::vector< NumericDomain >& disjuncts() const {
+    return this->_disjuncts;
+  }
+
+  bool is_bottom() const override { return this->_disjuncts.empty(); }
+
+  bool is_top() const override {
+    return std::any_of(this->_disjuncts.begin(),
+                       this->_disjuncts.end(),
+                       [](const NumericDomain& inv) { return inv.is_top(); });
+  }
+
+  void set_to_bottom() override { this->_disjuncts.clear(); }
+
+  void set_to_top() override {
+    this->_disjuncts.clear();
+    this->_disjuncts.push_back(NumericDomain::top());
+  }
+
+  /// \brief Return true if every disjunct is included in a disjunct of `other`
+  ///
+  /// This is a sufficient condition for the inclusion.
+  bool leq(const BoundedPowersetDomain& other) const override {
+    return std::all_of(this->_disjuncts.begin(),
+                       this->_disjuncts.end(),
+                       [&other](const NumericDomain& inv) {
+                         return other.subsumes(inv);
+                       });
+  }
+
+  bool equals(const BoundedPowersetDomain& other) const override {
+    return this->leq(other) && other.leq(*this);
+  }
+
+  void join_with(const BoundedPowersetDomain& other) override {
+    for (const NumericDomain& inv : other._disjuncts) {
+      this->add_disjunct(inv);
+    }
+    this->reduce();
+  }
+
+  void widen_with(const BoundedPowersetDomain& other) override {
+    if (this->is_bottom()) {
+      this->operator=(other);
+    } else if (other.is_bottom()) {
+      return;
+    } else {
+      this->operator=(BoundedPowersetDomain(
+          this->merge().widening(other.merge())));
+    }
+  }
+
+  void widen_threshold_with(const BoundedPowersetDomain& other,
+                            const Number& threshold) override {
+    if (this->is_bottom()) {
+      this->operator=(other);
+    } else if (other.is_bottom()) {
+      return;
+    } else {
+      this->operator=(BoundedPowersetDomain(
+          this->merge().widening_threshold(other.merge(), threshold)));
+    }
+  }
+
+  void meet_with(const BoundedPowersetDomain& other) override {
+    std::vector< NumericDomain > disjuncts;
+    disjuncts.swap(this->_disjuncts);
+    for (const NumericDomain& x : disjuncts) {
+      for (const NumericDomain& y : other._disjuncts) {
+        this->add_disjunct(x.meet(y));
+      }
+    }
+    this->reduce();
+  }
+
+  void narrow_with(const BoundedPowersetDomain& other) override {
+    if (this->is_bottom()) {
+      return;
+    } else if (other.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      this->operator=(BoundedPowersetDomain(
+          this->merge().narrowing(other.merge())));
+    }
+  }
+
+  void assign(VariableRef x, int n) override {
+    this->transform([&](NumericDomain& inv) { inv.assign(x, n); });
+  }
+
+  void assign(VariableRef x, const Number& n) override {
+    this->transform([&](NumericDomain& inv) { inv.assign(x, n); });
+  }
+
+  void assign(VariableRef x, VariableRef y) override {
+    this->transform([&](NumericDomain& inv) { inv.assign(x, y); });
+  }
+
+  void assign(VariableRef x, const LinearExpressionT& e) override {
+    this->transform([&](NumericDomain& inv) { inv.assign(x, e); });
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             VariableRef z) override {
+    this->transform([&](NumericDomain& inv) { inv.apply(op, x, y, z); });
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             const Number& z) override {
+    this->transform([&](NumericDomain& inv) { inv.apply(op, x, y, z); });
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             const Number& y,
+             VariableRef z) override {
+    this->transform([&](NumericDomain& inv) { inv.apply(op, x, y, z); });
+  }
+
+  void add(const LinearConstraintT& cst) override {
+    this->transform([&](NumericDomain& inv) { inv.add(cst); });
+  }
+
+  void add(const LinearConstraintSystemT& csts) override {
+    this->transform([&](NumericDomain& inv) { inv.add(csts); });
+  }
+
+  void set(VariableRef x, const IntervalT& value) override {
+    if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      this->transform([&](NumericDomain& inv) { inv.set(x, value); });
+    }
+  }
+
+  void set(VariableRef x, const CongruenceT& value) override {
+    if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      this->transform([&](NumericDomain& inv) { inv.set(x, value); });
+    }
+  }
+
+  void set(VariableRef x, const IntervalCongruenceT& value) override {
+    if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      this->transform([&](NumericDomain& inv) { inv.set(x, value); });
+    }
+  }
+
+  void refine(VariableRef x, const IntervalT& value) override {
+    if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      this->transform([&](NumericDomain& inv) { inv.refine(x, value); });
+    }
+  }
+
+  void refine(VariableRef x, const CongruenceT& value) override {
+    if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      this->transform([&](NumericDomain& inv) { inv.refine(x, value); });
+    }
+  }
+
+  void refine(VariableRef x, const IntervalCongruenceT& value) override {
+    if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      this->transform([&](NumericDomain& inv) { inv.refine(x, value); });
+    }
+  }
+
+  void forget(VariableRef x) override {
+    this->transform([&](NumericDomain& inv) { inv.forget(x); });
+  }
+
+  void normalize() const override {
+    for (const NumericDomain& inv : this->_disjuncts) {
+      inv.normalize();
+    }
+  }
+
+  IntervalT to_interval(VariableRef x) const override {
+    IntervalT r = IntervalT::bottom();
+    for (const NumericDomain& inv : this->_disjuncts) {
+      r.join_with(inv.to_interval(x));
+    }
+    return r;
+  }
+
+  IntervalT to_interval(const LinearExpressionT& e) const override {
+    IntervalT r = IntervalT::bottom();
+    for (const NumericDomain& inv : this->_disjuncts) {
+      r.join_with(inv.to_interval(e));
+    }
+    return r;
+  }
+
+  CongruenceT to_congruence(VariableRef x) const override {
+    CongruenceT r = CongruenceT::bottom();
+    for (const NumericDomain& inv : this->_disjuncts) {
+      r.join_with(inv.to_congruence(x));
+    }
+    return r;
+  }
+
+  CongruenceT to_congruence(const LinearExpressionT& e) const override {
+    CongruenceT r = CongruenceT::bottom();
+    for (const NumericDomain& inv : this->_disjuncts) {
+      r.join_with(inv.to_congruence(e));
+    }
+    return r;
+  }
+
+  IntervalCongruenceT to_interval_congruence(VariableRef x) const override {
+    IntervalCongruenceT r = IntervalCongruenceT::bottom();
+    for (const NumericDomain& inv : this->_disjuncts) {
+      r.join_with(inv.to_interval_congruence(x));
+    }
+    return r;
+  }
+
+  IntervalCongruenceT to_interval_congruence(
+      const LinearExpressionT& e) const override {
+    IntervalCongruenceT r = IntervalCongruenceT::bottom();
+    for (const NumericDomain& inv : this->_disjuncts) {
+      r.join_with(inv.to_interval_congruence(e));
+    }
+    return r;
+  }
+
+  LinearConstraintSystemT to_linear_constraint_system() const override {
+    if (this->is_bottom()) {
+      return LinearConstraintSystemT(LinearConstraintT::contradiction());
+    }
+
+    return this->merge().to_linear_constraint_system();
+  }
+
+  /// \name Non-negative loop counter abstract domain methods
+  /// @{
+
+  void mark_counter(VariableRef x) override {
+    this->transform([&](NumericDomain& inv) { inv.mark_counter(x); });
+  }
+
+  void unmark_counter(VariableRef x) override {
+    this->transform([&](NumericDomain& inv) { inv.unmark_counter(x); });
+  }
+
+  void init_counter(VariableRef x, const Number& c) override {
+    this->transform([&](NumericDomain& inv) { inv.init_counter(x, c); });
+  }
+
+  void incr_counter(VariableRef x, const Number& k) override {
+    this->transform([&](NumericDomain& inv) { inv.incr_counter(x, k); });
+  }
+
+  void forget_counter(VariableRef x) override {
+    this->transform([&](NumericDomain& inv) { inv.forget_counter(x); });
+  }
+
+  /// @}
+
+  void dump(std::ostream& o) const override {
+    if (this->is_bottom()) {
+      o << "⊥";
+      return;
+    }
+    for (auto it = this->_disjuncts.begin(), et = this->_disjuncts.end();
+         it != et;) {
+      it->dump(o);
+      ++it;
+      if (it != et) {
+        o << " ∨ ";
+      }
+    }
+  }
+
+  static std::string name() {
+    return "bounded powerset of " + NumericDomain::name();
+  }
+
+private:
+  /// \brief Apply `op` on each disjunct and remove the bottom ones
+  template < typename UnaryOp >
+  void transform(const UnaryOp& op) {
+    for (NumericDomain& inv : this->_disjuncts) {
+      op(inv);
+    }
+    this->_disjuncts.erase(std::remove_if(this->_disjuncts.begin(),
+                                          this->_disjuncts.end(),
+                                          [](const NumericDomain& inv) {
+                                            return inv.is_bottom();
+                                          }),
+                           this->_disjuncts.end());
+  }
+
+  /// \brief Return the join of all the disjuncts
+  NumericDomain merge() const {
+    ikos_assert(!this->is_bottom());
+    NumericDomain r = this->_disjuncts.front();
+    for (auto it = std::next(this->_disjuncts.begin());
+         it != this->_disjuncts.end();
+         ++it) {
+      r.join_with(*it);
+    }
+    return r;
+  }
+
+  /// \brief Return true if `inv` is included in one of the disjuncts
+  bool subsumes(const NumericDomain& inv) const {
+    return std::any_of(this->_disjuncts.begin(),
+                       this->_disjuncts.end(),
+                       [&inv](const NumericDomain& x) { return inv.leq(x); });
+  }
+
+  /// \brief Add a disjunct, without bounding the number of disjuncts
+  ///
+  /// Disjuncts included in another one are removed.
+  void add_disjunct(NumericDomain inv) {
+    if (inv.is_bottom() || this->subsumes(inv)) {
+      return;
+    }
+    this->_disjuncts.erase(std::remove_if(this->_disjuncts.begin(),
+                                          this->_disjuncts.end(),
+                                          [&inv](const NumericDomain& x) {
+                                            return x.leq(inv);
+                                          }),
+                           this->_disjuncts.end());
+    this->_disjuncts.push_back(std::move(inv));
+  }
+
+  /// \brief Return true if `inv` entails the constraint `cst`
+  static bool entails(const NumericDomain& inv, const LinearConstraintT& cst) {
+    IntervalT i = inv.to_interval(cst.expression());
+    if (cst.is_equality()) {
+      return i.singleton() == boost::optional< Number >(Number(0));
+    } else if (cst.is_inequality()) {
+      return i.ub() <= BoundT(0);
+    } else {
+      return !i.contains(0);
+    }
+  }
+
+  /// \brief Return the number of constraints of `csts` not entailed by `inv`
+  static std::size_t lost_constraints(const LinearConstraintSystemT& csts,
+                                      const NumericDomain& inv) {
+    return static_cast< std::size_t >(
+        std::count_if(csts.begin(),
+                      csts.end(),
+                      [&inv](const LinearConstraintT& cst) {
+                        return !entails(inv, cst);
+                      }));
+  }
+
+  /// \brief Merge the closest disjuncts until there are at most MaxDisjuncts
+  void reduce() {
+    if (this->_disjuncts.size() <= MaxDisjuncts) {
+      return;
+    }
+
+    std::vector< LinearConstraintSystemT > csts;
+    csts.reserve(this->_disjuncts.size());
+    for (const NumericDomain& inv : this->_disjuncts) {
+      csts.push_back(inv.to_linear_constraint_system());
+    }
+
+    while (this->_disjuncts.size() > MaxDisjuncts) {
+      // Find the pair of disjuncts sharing the most constraints
+      std::size_t best_i = 0;
+      std::size_t best_j = 1;
+      std::size_t best_distance = std::numeric_limits< std::size_t >::max();
+      for (std::size_t i = 0; i < this->_disjuncts.size(); i++) {
+        for (std::size_t j = i + 1; j < this->_disjuncts.size(); j++) {
+          std::size_t distance =
+              lost_constraints(csts[i], this->_disjuncts[j]) +
+              lost_constraints(csts[j], this->_disjuncts[i]);
+          if (distance < best_distance) {
+            best_i = i;
+            best_j = j;
+            best_distance = distance;
+          }
+        }
+      }
+
+      this->_disjuncts[best_i].join_with(this->_disjuncts[best_j]);
+      this->_disjuncts.erase(this->_disjuncts.begin() + best_j);
+      csts.erase(csts.begin() + best_j);
+
+      // Remove the disjuncts included in the merged disjunct
+      for (std::size_t k = 0; k < this->_disjuncts.size();) {
+        if (k != best_i && this->_disjuncts[k].leq(this->_disjuncts[best_i])) {
+          this->_disjuncts.erase(this->_disjuncts.begin() + k);
+          csts.erase(csts.begin() + k);
+          if (k < best_i) {
+            best_i--;
+          }
+        } else {
+          k++;
+        }
+      }
+      csts[best_i] = this->_disjuncts[best_i].to_linear_constraint_system();
+    }
+  }
+
+}; // end class BoundedPowersetDomain
+
+} // end namespace numeric
+} // end namespace core
+} // end namespace ikos
@@ -46,9 +46,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include <boost/iterator/transform_iterator.hpp>
 
 #include <ikos/core/domain/numeric/abstract_domain.hpp>
+#include <ikos/core/domain/numeric/int64_closure.hpp>
 #include <ikos/core/domain/numeric/linear_interval_solver.hpp>
 #include <ikos/core/number/bound.hpp>
 #include <ikos/core/support/assert.hpp>
@@ -94,9 +100,14 @@ private:
   /// \brief Parent
   using Parent = numeric::AbstractDomain< Number, VariableRef, DBM >;
 
+  /// \brief Difference bound matrix
+  ///
+  /// The elements are shared between copies of the matrix until one of them
+  /// is modified (copy-on-write). This allows cheap copies of invariants, and
+  /// constant time comparisons of unchanged matrices.
   class Matrix {
   private:
-    std::vector< BoundT > _matrix;
+    std::shared_ptr< std::vector< BoundT > > _matrix;
     MatrixIndex _num_vars = 0; // size of the matrix
 
   public:
@@ -121,31 +132,43 @@ private:
     /// \brief Return the number of variables in the matrix
     MatrixIndex num_vars() const { return this->_num_vars; }
 
+    /// \brief Return true if both matrices share the same elements
+    ///
+    /// This is a sufficient condition for equality.
+    bool is_identical(const Matrix& other) const {
+      return this->_num_vars == other._num_vars &&
+             this->_matrix == other._matrix;
+    }
+
     /// \brief Return the element (i, j)
     const BoundT& operator()(MatrixIndex i, MatrixIndex j) const {
       ikos_assert_msg(i < this->_num_vars && j < this->_num_vars,
                       "ouf of bounds matrix access");
-      return this->_matrix[this->_num_vars * i + j];
+      return (*this->_matrix)[this->_num_vars * i + j];
     }
 
     /// \brief Return the element (i, j)
     BoundT& operator()(MatrixIndex i, MatrixIndex j) {
       ikos_assert_msg(i < this->_num_vars && j < this->_num_vars,
                       "ouf of bounds matrix access");
-      return this->_matrix[this->_num_vars * i + j];
+      return this->elements()[this->_num_vars * i + j];
     }
 
     /// \brief Clear the matrix
     void clear() {
       this->_num_vars = 0;
-      this->_matrix.clear();
+      this->_matrix.reset();
     }
 
     /// \brief Clear and resize the matrix
     void clear_resize(MatrixIndex num_vars) {
       this->_num_vars = num_vars;
-      this->_matrix.clear();
-      this->_matrix.resize(num_vars * num_vars, BoundT::plus_infinity());
+      this->_matrix =
+          std::make_shared< std::vector< BoundT > >(num_vars * num_vars,
+                                                    BoundT::plus_infinity());
+      for (MatrixIndex i = 0; i < num_vars; i++) {
+        (*this->_matrix)[num_vars * i + i] = BoundT(0);
+      }
     }
 
     /// \brief Resize the matrix to handle a new variable
@@ -153,47 +176,141 @@ private:
     /// \returns the index of the new variable
     MatrixIndex add_variable() {
       if (this->_num_vars == 0) {
-        this->_num_vars = 2;
-        this->_matrix.resize(this->_num_vars * this->_num_vars,
-                             BoundT::plus_infinity());
+        this->clear_resize(2);
       } else {
-        std::vector< BoundT > new_matrix((this->_num_vars + 1) *
-                                             (this->_num_vars + 1),
-                                         BoundT::plus_infinity());
+        auto new_matrix = std::make_shared< std::vector< BoundT > >(
+            (this->_num_vars + 1) * (this->_num_vars + 1),
+            BoundT::plus_infinity());
+
+        // Elements can only be moved if they are not shared
+        bool unique = this->_matrix.use_count() == 1;
+        std::vector< BoundT >& matrix = *this->_matrix;
 
         for (MatrixIndex i = 0; i < this->_num_vars; i++) {
           for (MatrixIndex j = 0; j < this->_num_vars; j++) {
-            new_matrix[(this->_num_vars + 1) * i + j] =
-                std::move(this->_matrix[this->_num_vars * i + j]);
+            BoundT& elem = matrix[this->_num_vars * i + j];
+            if (unique) {
+              (*new_matrix)[(this->_num_vars + 1) * i + j] = std::move(elem);
+            } else {
+              (*new_matrix)[(this->_num_vars + 1) * i + j] = elem;
+            }
           }
         }
 
-        std::swap(this->_matrix, new_matrix);
+        (*new_matrix)[(this->_num_vars + 1) * this->_num_vars +
+                      this->_num_vars] = BoundT(0);
+
+        this->_matrix = std::move(new_matrix);
         this->_num_vars++;
       }
 
       return this->_num_vars - 1;
     }
 
+    /// \brief Shrink the matrix to the given indexes
+    ///
+    /// The index `indexes[i]` becomes the index `i`.
+    void shrink(const std::vector< MatrixIndex >& indexes) {
+      const auto n = static_cast< MatrixIndex >(indexes.size());
+      auto new_matrix = std::make_shared< std::vector< BoundT > >();
+      new_matrix->reserve(n * n);
+
+      bool unique = this->_matrix.use_count() == 1;
+      std::vector< BoundT >& matrix = *this->_matrix;
+
+      for (MatrixIndex i : indexes) {
+        for (MatrixIndex j : indexes) {
+          BoundT& elem = matrix[this->_num_vars * i + j];
+          if (unique) {
+            new_matrix->push_back(std::move(elem));
+          } else {
+            new_matrix->push_back(elem);
+          }
+        }
+      }
+
+      this->_matrix = std::move(new_matrix);
+      this->_num_vars = n;
+    }
+
     /// \brief Apply Floyd-Warshall algorithm to normalize the matrix
     void normalize() {
       const MatrixIndex n = this->_num_vars;
 
+      if (n == 0) {
+        return;
+      }
+
+      std::vector< BoundT >& matrix = this->elements();
+
       for (MatrixIndex i = 0; i < n; i++) {
-        this->_matrix[n * i + i] = BoundT(0);
+        matrix[n * i + i] = BoundT(0);
+      }
+
+      // Try first with fixed-width weights
+      if (int64_closure::dbm_closure(matrix, n)) {
+        return;
       }
 
       for (MatrixIndex k = 0; k < n; k++) {
         for (MatrixIndex i = 0; i < n; i++) {
           for (MatrixIndex j = 0; j < n; j++) {
-            this->_matrix[n * i + j] =
-                min(this->_matrix[n * i + j],
-                    this->_matrix[n * i + k] + this->_matrix[n * k + j]);
+            matrix[n * i + j] =
+                min(matrix[n * i + j], matrix[n * i + k] + matrix[n * k + j]);
           }
         }
       }
     }
 
+    /// \brief Restore the closure after the weight of the edge (u, v) decreased
+    ///
+    /// The matrix must be closed, except for the element (u, v). This runs in
+    /// O(n^2).
+    ///
+    /// Return false if the new edge creates a negative cycle.
+    bool close_edge(MatrixIndex u, MatrixIndex v) {
+      const MatrixIndex n = this->_num_vars;
+      std::vector< BoundT >& matrix = this->elements();
+
+      const BoundT c = matrix[n * u + v];
+      if (c.is_plus_infinity()) {
+        return true;
+      }
+      if (c + matrix[n * v + u] < BoundT(0)) {
+        return false;
+      }
+
+      // Since c + M[v, u] >= 0, column `u` and row `v` are left unchanged,
+      // hence the matrix can be updated in place.
+      for (MatrixIndex a = 0; a < n; a++) {
+        if (matrix[n * a + u].is_plus_infinity()) {
+          continue;
+        }
+        const BoundT w_a_v = matrix[n * a + u] + c;
+        for (MatrixIndex b = 0; b < n; b++) {
+          matrix[n * a + b] = min(matrix[n * a + b], w_a_v + matrix[n * v + b]);
+        }
+      }
+
+      return true;
+    }
+
+    /// \brief Normalize the matrix incrementally
+    ///
+    /// The matrix must be closed, except for the given edges.
+    ///
+    /// Return false if one of the edges creates a negative cycle.
+    bool normalize(
+        const std::vector< std::pair< MatrixIndex, MatrixIndex > >& edges) {
+      for (const auto& edge : edges) {
+        if (!this->close_edge(edge.first, edge.second)) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
     /// \brief Return true if the matrix has a negative cycle
     bool has_negative_cycle() const {
       for (MatrixIndex i = 0; i < this->_num_vars; i++) {
@@ -243,14 +360,38 @@ private:
       }
     }
 
+  private:
+    /// \brief Return the elements for modification
+    ///
+    /// This copies the elements if they are shared with another matrix.
+    std::vector< BoundT >& elements() {
+      ikos_assert(this->_matrix != nullptr);
+      if (this->_matrix.use_count() > 1) {
+        this->_matrix =
+            std::make_shared< std::vector< BoundT > >(*this->_matrix);
+      }
+      return *this->_matrix;
+    }
+
   }; // end class Matrix
 
+private:
+  /// \brief Maximum number of modified edges normalized incrementally
+  static constexpr std::size_t MaxDirtyEdges = 8;
+
 private:
   bool _is_bottom;
   bool _is_normalized;
   Matrix _matrix;
   VarIndexMap _var_index_map;
 
+  /// \brief Edges (j, i) of the matrix decreased since the last normalization
+  ///
+  /// If the matrix is not normalized and this is not empty, the matrix is
+  /// closed except for these edges, and it can be normalized incrementally.
+  /// Otherwise, it requires a full closure.
+  std::vector< std::pair< MatrixIndex, MatrixIndex > > _dirty_edges;
+
 private:
   struct TopTag {};
   struct BottomTag {};
@@ -261,6 +402,16 @@ private:
   /// \brief Create the bottom abstract value
   explicit DBM(BottomTag) : _is_bottom(true), _is_normalized(true) {}
 
+  /// \brief Return true if both DBMs share the same representation
+  ///
+  /// Copies of a DBM share their matrix until one of them is modified, so
+  /// this is a constant time sufficient condition for equality.
+  bool is_identical(const DBM& other) const {
+    return this->_is_bottom == other._is_bottom &&
+           this->_matrix.is_identical(other._matrix) &&
+           this->_var_index_map == other._var_index_map;
+  }
+
 public:
   /// \brief Create the top abstract value
   DBM() : DBM(TopTag{}) {}
@@ -299,8 +450,22 @@ public:
       return;
     }
 
+    if (!this->_dirty_edges.empty() &&
+        this->_dirty_edges.size() < this->_matrix.num_vars()) {
+      // Incremental closure, in O(n^2) per edge
+      bool ok = self->_matrix.normalize(this->_dirty_edges);
+      self->_dirty_edges.clear();
+
+      if (!ok || this->_matrix.has_negative_cycle()) {
+        self->_is_bottom = true;
+      }
+      self->_is_normalized = true;
+      return;
+    }
+
     // Floyd-Warshall algorithm
     self->_matrix.normalize();
+    self->_dirty_edges.clear();
 
     // Check for negative cycle
     if (this->_matrix.has_negative_cycle()) {
@@ -330,6 +495,7 @@ public:
   void set_to_bottom() override {
     this->_is_bottom = true;
     this->_is_normalized = true;
+    this->_dirty_edges.clear();
     this->_matrix.clear();
     this->_var_index_map.clear();
   }
@@ -337,11 +503,16 @@ public:
   void set_to_top() override {
     this->_is_bottom = false;
     this->_is_normalized = true;
+    this->_dirty_edges.clear();
     this->_matrix.clear();
     this->_var_index_map.clear();
   }
 
   bool leq(const DBM& other) const override {
+    if (this->is_identical(other)) {
+      return true;
+    }
+
     // Requires normalization
     this->normalize();
     other.normalize();
@@ -398,6 +569,10 @@ public:
   }
 
   bool equals(const DBM& other) const override {
+    if (this->is_identical(other)) {
+      return true;
+    }
+
     return this->leq(other) && other.leq(*this);
   }
 
@@ -576,6 +751,10 @@ private:
 
 public:
   DBM join(const DBM& other) const override {
+    if (this->is_identical(other)) {
+      return *this;
+    }
+
     // Requires normalization
     this->normalize();
     other.normalize();
@@ -592,10 +771,18 @@ public:
   }
 
   void join_with(const DBM& other) override {
+    if (this->is_identical(other)) {
+      return;
+    }
+
     this->operator=(this->join(other));
   }
 
   DBM widening(const DBM& other) const override {
+    if (this->is_identical(other)) {
+      return *this;
+    }
+
     // Requires the normalization of the right operand.
     // The left operand (this) should not be normalized.
     other.normalize();
@@ -610,11 +797,19 @@ public:
   }
 
   void widen_with(const DBM& other) override {
+    if (this->is_identical(other)) {
+      return;
+    }
+
     this->operator=(this->widening(other));
   }
 
   DBM widening_threshold(const DBM& other,
                          const Number& threshold) const override {
+    if (this->is_identical(other)) {
+      return *this;
+    }
+
     // Requires the normalization of the right operand.
     // The left operand (this) should not be normalized.
     other.normalize();
@@ -631,10 +826,18 @@ public:
 
   void widen_threshold_with(const DBM& other,
                             const Number& threshold) override {
+    if (this->is_identical(other)) {
+      return;
+    }
+
     this->operator=(this->widening_threshold(other, threshold));
   }
 
   DBM meet(const DBM& other) const override {
+    if (this->is_identical(other)) {
+      return *this;
+    }
+
     // Requires normalization
     this->normalize();
     other.normalize();
@@ -647,10 +850,18 @@ public:
   }
 
   void meet_with(const DBM& other) override {
+    if (this->is_identical(other)) {
+      return;
+    }
+
     this->operator=(this->meet(other));
   }
 
   DBM narrowing(const DBM& other) const override {
+    if (this->is_identical(other)) {
+      return *this;
+    }
+
     // Requires normalization
     this->normalize();
     other.normalize();
@@ -663,6 +874,10 @@ public:
   }
 
   void narrow_with(const DBM& other) override {
+    if (this->is_identical(other)) {
+      return;
+    }
+
     this->operator=(this->narrowing(other));
   }
 
@@ -704,12 +919,33 @@ private:
     }
   }
 
+  /// \brief Record that the edge (j, i) of the matrix decreased
+  void mark_dirty_edge(MatrixIndex j, MatrixIndex i) {
+    if (this->_is_normalized) {
+      this->_is_normalized = false;
+      this->_dirty_edges.assign(1, {j, i});
+    } else if (!this->_dirty_edges.empty()) {
+      if (std::find(this->_dirty_edges.begin(),
+                    this->_dirty_edges.end(),
+                    std::make_pair(j, i)) != this->_dirty_edges.end()) {
+        return;
+      }
+
+      if (this->_dirty_edges.size() < MaxDirtyEdges) {
+        this->_dirty_edges.emplace_back(j, i);
+      } else {
+        // Too many edges, use a full closure
+        this->_dirty_edges.clear();
+      }
+    }
+  }
+
   /// \brief Add constraint v_i - v_j <= c
   void add_constraint(MatrixIndex i, MatrixIndex j, const BoundT& c) {
     const BoundT& w = this->_matrix(j, i);
     if (c < w) {
       this->_matrix(j, i) = c;
-      this->_is_normalized = false;
+      this->mark_dirty_edge(j, i);
     }
   }
 
@@ -736,7 +972,8 @@ private:
       }
     }
 
-    this->_is_normalized = false;
+    // Paths through v_i are shifted by opposite amounts, hence the closure
+    // (and the set of dirty edges) is preserved.
   }
 
   /// \brief Apply v_i = v_i + c
@@ -1248,6 +1485,15 @@ public:
 private:
   /// \brief Forget all informations about variable k
   void forget(MatrixIndex k) {
+    if (!this->_is_normalized && !this->_dirty_edges.empty()) {
+      // Cheaper than the propagation below, and keeps the matrix normalized
+      this->normalize();
+
+      if (this->_is_bottom) {
+        return;
+      }
+    }
+
     // Use informations about k to improve all constraints
     // Not necessary if already normalized
     if (!this->_is_normalized) {
@@ -1274,7 +1520,7 @@ private:
     }
     this->_matrix(k, k) = BoundT(0);
 
-    this->_is_normalized = false;
+    // Removing a variable from a closed matrix leaves it closed
   }
 
 public:
@@ -1290,7 +1536,91 @@ public:
     }
   }
 
+  void forget_vars(const std::vector< VariableRef >& vars) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    std::vector< VariableRef > dropped(vars);
+    std::sort(dropped.begin(), dropped.end());
+    this->remove_variables([&dropped](VariableRef x) {
+      return std::binary_search(dropped.begin(), dropped.end(), x);
+    });
+  }
+
+  void project(const std::vector< VariableRef >& keep) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    std::vector< VariableRef > kept(keep);
+    std::sort(kept.begin(), kept.end());
+    this->remove_variables([&kept](VariableRef x) {
+      return !std::binary_search(kept.begin(), kept.end(), x);
+    });
+  }
+
 private:
+  /// \brief Forget all the variables satisfying the given predicate
+  ///
+  /// The rows and columns of these variables are removed from the matrix,
+  /// which is rebuilt once.
+  template < typename Predicate >
+  void remove_variables(const Predicate& is_removed) {
+    std::vector< MatrixIndex > removed;
+    for (const auto& p : this->_var_index_map) {
+      if (is_removed(p.first)) {
+        removed.push_back(p.second);
+      }
+    }
+
+    if (removed.empty()) {
+      return;
+    } else if (removed.size() == 1) {
+      auto it = std::find_if(this->_var_index_map.begin(),
+                             this->_var_index_map.end(),
+                             [&removed](const auto& p) {
+                               return p.second == removed[0];
+                             });
+      this->forget(removed[0]);
+      this->_var_index_map.erase(it);
+      return;
+    }
+
+    // After the first call, the matrix is either normalized or has no dirty
+    // edges, hence the other calls do not need a closure
+    for (MatrixIndex k : removed) {
+      this->forget(k);
+
+      if (this->_is_bottom) {
+        return;
+      }
+    }
+    ikos_assert(this->_dirty_edges.empty());
+
+    // Shrink the matrix to the remaining variables, including the zero at 0
+    VarIndexMap var_index_map;
+    var_index_map.reserve(this->_var_index_map.size() - removed.size());
+    std::vector< MatrixIndex > indexes;
+    indexes.reserve(this->_var_index_map.size() - removed.size() + 1);
+    indexes.push_back(0);
+    for (const auto& p : this->_var_index_map) {
+      if (!is_removed(p.first)) {
+        var_index_map.emplace_hint(var_index_map.end(),
+                                   p.first,
+                                   static_cast< MatrixIndex >(indexes.size()));
+        indexes.push_back(p.second);
+      }
+    }
+
+    if (indexes.size() == 1) {
+      this->_matrix.clear();
+    } else {
+      this->_matrix.shrink(indexes);
+    }
+    this->_var_index_map = std::move(var_index_map);
+  }
+
   struct GetVar {
     const VariableRef& operator()(
         const std::pair< VariableRef, MatrixIndex >& p) const {
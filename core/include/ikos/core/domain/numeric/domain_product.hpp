@@ -288,6 +288,16 @@ public:
     this->_product.second().forget(x);
   }
 
+  void forget_vars(const std::vector< VariableRef >& vars) override {
+    this->_product.first().forget_vars(vars);
+    this->_product.second().forget_vars(vars);
+  }
+
+  void project(const std::vector< VariableRef >& keep) override {
+    this->_product.first().project(keep);
+    this->_product.second().project(keep);
+  }
+
   IntervalT to_interval(VariableRef x) const override {
     IntervalT a = this->_product.first().to_interval(x);
     IntervalT b = this->_product.second().to_interval(x);
@@ -592,6 +602,14 @@ public:
 
   void forget(VariableRef x) override { this->_product.forget(x); }
 
+  void forget_vars(const std::vector< VariableRef >& vars) override {
+    this->_product.forget_vars(vars);
+  }
+
+  void project(const std::vector< VariableRef >& keep) override {
+    this->_product.project(keep);
+  }
+
   IntervalT to_interval(VariableRef x) const override {
     return this->_product.to_interval(x);
   }
@@ -3,6 +3,10 @@
  * \file
  * \brief Reduced product of gauges, intervals and congruences
  *
+ * The reduction is lazy: transfer functions only mark the written variable,
+ * and the reduction is performed when a later operation reads it, or before
+ * a lattice operation.
+ *
  * Author: Maxime Arthaud
  *
  * Contact: ikos@lists.nasa.gov
@@ -43,6 +47,9 @@
 
 #pragma once
 
+#include <atomic>
+
+#include <ikos/core/adt/patricia_tree/set.hpp>
 #include <ikos/core/domain/numeric/abstract_domain.hpp>
 #include <ikos/core/domain/numeric/congruence.hpp>
 #include <ikos/core/domain/numeric/domain_product.hpp>
@@ -74,6 +81,16 @@ public:
   using LinearConstraintT = LinearConstraint< Number, VariableRef >;
   using LinearConstraintSystemT = LinearConstraintSystem< Number, VariableRef >;
 
+  /// \brief Statistics on the lazy reduction
+  struct ReductionStatistics {
+    /// \brief Number of variable reductions performed
+    std::atomic< std::size_t > performed{0};
+
+    /// \brief Number of variable reductions avoided, because the variable was
+    /// overwritten or marked twice before being read
+    std::atomic< std::size_t > avoided{0};
+  };
+
 private:
   using GaugeDomainT = GaugeDomain< Number, VariableRef >;
   using IntervalDomainT =
@@ -86,9 +103,14 @@ private:
                                                  IntervalDomainT,
                                                  CongruenceDomainT >;
 
+  using VariableSetT = PatriciaTreeSet< VariableRef >;
+
 private:
   DomainProduct _product;
 
+  /// \brief Variables that need a reduction
+  VariableSetT _dirty;
+
 private:
   /// \brief Private constructor
   explicit GaugeIntervalCongruenceDomain(DomainProduct product)
@@ -100,6 +122,8 @@ private:
       return;
     }
 
+    reduction_statistics().performed++;
+
     IntervalT i = this->_product.first().to_interval(v);
     i.meet_with(this->_product.second().to_interval(v));
     CongruenceT c = this->_product.third().to_congruence(v);
@@ -117,6 +141,60 @@ private:
     }
   }
 
+  /// \brief Mark variable `v` as needing a reduction
+  void mark_dirty(VariableRef v) {
+    if (this->_product.is_bottom()) {
+      return;
+    }
+
+    if (this->_dirty.contains(v)) {
+      // The previous value of `v` was never read
+      reduction_statistics().avoided++;
+    } else {
+      this->_dirty.insert(v);
+    }
+  }
+
+  /// \brief Drop the pending reduction of `v`, when `v` is overwritten
+  void drop_dirty(VariableRef v) {
+    if (this->_dirty.contains(v)) {
+      this->_dirty.erase(v);
+      reduction_statistics().avoided++;
+    }
+  }
+
+  /// \brief Perform the pending reduction of `v`, before `v` is read
+  void reduce_dirty(VariableRef v) {
+    if (this->_dirty.contains(v)) {
+      this->_dirty.erase(v);
+      this->reduce_variable(v);
+    }
+  }
+
+  /// \brief Perform the pending reductions of the variables in `e`
+  void reduce_dirty(const LinearExpressionT& e) {
+    if (this->_dirty.empty()) {
+      return;
+    }
+    for (const auto& term : e) {
+      this->reduce_dirty(term.first);
+    }
+  }
+
+  /// \brief Perform all the pending reductions
+  void reduce() const {
+    if (this->_dirty.empty()) {
+      return;
+    }
+
+    auto self = const_cast< GaugeIntervalCongruenceDomain* >(this);
+    VariableSetT dirty = std::move(self->_dirty);
+    self->_dirty.clear();
+    for (VariableRef v : dirty) {
+      self->reduce_variable(v);
+    }
+  }
+
 public:
   /// \brief Create the top abstract value
   GaugeIntervalCongruenceDomain() = default;
@@ -148,122 +226,189 @@ public:
     return GaugeIntervalCongruenceDomain(DomainProduct::bottom());
   }
 
+  /// \brief Return the statistics on the lazy reduction of this domain
+  static ReductionStatistics& reduction_statistics() {
+    static ReductionStatistics stats;
+    return stats;
+  }
+
   /// \brief Return the first abstract value
   ///
   /// Note: does not normalize.
-  const GaugeDomainT& first() const { return this->_product.first(); }
+  const GaugeDomainT& first() const {
+    this->reduce();
+    return this->_product.first();
+  }
 
   /// \brief Return the first abstract value
   ///
   /// Note: does not normalize.
-  GaugeDomainT& first() { return this->_product.first(); }
+  GaugeDomainT& first() {
+    this->reduce();
+    return this->_product.first();
+  }
 
   /// \brief Return the second abstract value
   ///
   /// Note: does not normalize.
-  const IntervalDomainT& second() const { return this->_product.second(); }
+  const IntervalDomainT& second() const {
+    this->reduce();
+    return this->_product.second();
+  }
 
   /// \brief Return the second abstract value
   ///
   /// Note: does not normalize.
-  IntervalDomainT& second() { return this->_product.second(); }
+  IntervalDomainT& second() {
+    this->reduce();
+    return this->_product.second();
+  }
 
   /// \brief Return the third abstract value
   ///
   /// Note: does not normalize.
-  const CongruenceDomainT& third() const { return this->_product.third(); }
+  const CongruenceDomainT& third() const {
+    this->reduce();
+    return this->_product.third();
+  }
 
   /// \brief Return the third abstract value
   ///
   /// Note: does not normalize.
-  CongruenceDomainT& third() { return this->_product.third(); }
+  CongruenceDomainT& third() {
+    this->reduce();
+    return this->_product.third();
+  }
 
+  /// \brief Return true if the abstract value is bottom
+  ///
+  /// Note: pending reductions are not performed. They can only find bottom if
+  /// the components describe an empty set, which is detected at the next
+  /// lattice operation.
   bool is_bottom() const override { return this->_product.is_bottom(); }
 
   bool is_top() const override { return this->_product.is_top(); }
 
-  void set_to_bottom() override { this->_product.set_to_bottom(); }
+  void set_to_bottom() override {
+    this->_product.set_to_bottom();
+    this->_dirty.clear();
+  }
 
-  void set_to_top() override { this->_product.set_to_top(); }
+  void set_to_top() override {
+    this->_product.set_to_top();
+    this->_dirty.clear();
+  }
 
   bool leq(const GaugeIntervalCongruenceDomain& other) const override {
+    this->reduce();
+    other.reduce();
     return this->_product.leq(other._product);
   }
 
   bool equals(const GaugeIntervalCongruenceDomain& other) const override {
+    this->reduce();
+    other.reduce();
     return this->_product.equals(other._product);
   }
 
   void join_with(const GaugeIntervalCongruenceDomain& other) override {
+    this->reduce();
+    other.reduce();
     this->_product.join_with(other._product);
   }
 
   void join_loop_with(const GaugeIntervalCongruenceDomain& other) override {
+    this->reduce();
+    other.reduce();
     this->_product.join_loop_with(other._product);
   }
 
   void join_iter_with(const GaugeIntervalCongruenceDomain& other) override {
+    this->reduce();
+    other.reduce();
     this->_product.join_iter_with(other._product);
   }
 
   void widen_with(const GaugeIntervalCongruenceDomain& other) override {
+    this->reduce();
+    other.reduce();
     this->_product.widen_with(other._product);
   }
 
   void widen_threshold_with(const GaugeIntervalCongruenceDomain& other,
                             const Number& threshold) override {
+    this->reduce();
+    other.reduce();
     this->_product.widen_threshold_with(other._product, threshold);
   }
 
   void meet_with(const GaugeIntervalCongruenceDomain& other) override {
+    this->reduce();
+    other.reduce();
     this->_product.meet_with(other._product);
   }
 
   void narrow_with(const GaugeIntervalCongruenceDomain& other) override {
+    this->reduce();
+    other.reduce();
     this->_product.narrow_with(other._product);
   }
 
-  void assign(VariableRef x, int n) override { this->_product.assign(x, n); }
+  void assign(VariableRef x, int n) override {
+    this->_product.assign(x, n);
+    this->drop_dirty(x);
+  }
 
   void assign(VariableRef x, const Number& n) override {
     this->_product.assign(x, n);
+    this->drop_dirty(x);
   }
 
   void assign(VariableRef x, VariableRef y) override {
+    this->reduce_dirty(y);
     this->_product.assign(x, y);
-    this->reduce_variable(x);
+    this->mark_dirty(x);
   }
 
   void assign(VariableRef x, const LinearExpressionT& e) override {
+    this->reduce_dirty(e);
     this->_product.assign(x, e);
-    this->reduce_variable(x);
+    this->mark_dirty(x);
   }
 
   void apply(BinaryOperator op,
              VariableRef x,
              VariableRef y,
              VariableRef z) override {
+    this->reduce_dirty(y);
+    this->reduce_dirty(z);
     this->_product.apply(op, x, y, z);
-    this->reduce_variable(x);
+    this->mark_dirty(x);
   }
 
   void apply(BinaryOperator op,
              VariableRef x,
              VariableRef y,
              const Number& z) override {
+    this->reduce_dirty(y);
     this->_product.apply(op, x, y, z);
-    this->reduce_variable(x);
+    this->mark_dirty(x);
   }
 
   void apply(BinaryOperator op,
              VariableRef x,
              const Number& y,
              VariableRef z) override {
+    this->reduce_dirty(z);
     this->_product.apply(op, x, y, z);
-    this->reduce_variable(x);
+    this->mark_dirty(x);
   }
 
+  // Constraints can refine the abstract value to bottom, and thus are reduced
+  // eagerly.
+
   void add(const LinearConstraintT& cst) override {
+    this->reduce_dirty(cst.expression());
     this->_product.add(cst);
 
     for (const auto& term : cst) {
@@ -272,6 +417,10 @@ public:
   }
 
   void add(const LinearConstraintSystemT& csts) override {
+    for (const LinearConstraintT& cst : csts) {
+      this->reduce_dirty(cst.expression());
+    }
+
     this->_product.add(csts);
 
     for (const LinearConstraintT& cst : csts) {
@@ -298,6 +447,7 @@ public:
       this->_product.first().set(x, value.interval());
       this->_product.second().set(x, value.interval());
       this->_product.third().set(x, value.congruence());
+      this->drop_dirty(x);
     }
   }
 
@@ -315,15 +465,22 @@ public:
     } else if (value.is_bottom()) {
       this->set_to_bottom();
     } else {
+      this->_dirty.erase(x);
       this->_product.second().refine(x, value.interval());
       this->_product.third().refine(x, value.congruence());
       this->reduce_variable(x);
     }
   }
 
-  void forget(VariableRef x) override { this->_product.forget(x); }
+  void forget(VariableRef x) override {
+    this->_product.forget(x);
+    this->drop_dirty(x);
+  }
 
-  void normalize() const override { this->_product.normalize(); }
+  void normalize() const override {
+    this->reduce();
+    this->_product.normalize();
+  }
 
   GaugeT to_gauge(VariableRef x) const {
     return this->_product.first().to_gauge(x);
@@ -362,6 +519,8 @@ public:
 
   IntervalCongruenceT to_interval_congruence(
       const LinearExpressionT& e) const override {
+    const_cast< GaugeIntervalCongruenceDomain* >(this)->reduce_dirty(e);
+
     if (this->is_bottom()) {
       return IntervalCongruenceT::bottom();
     } else {
@@ -373,6 +532,7 @@ public:
   }
 
   LinearConstraintSystemT to_linear_constraint_system() const override {
+    this->reduce();
     return this->_product.to_linear_constraint_system();
   }
 
@@ -387,19 +547,25 @@ public:
 
   void init_counter(VariableRef x, const Number& c) override {
     this->_product.init_counter(x, c);
+    this->drop_dirty(x);
   }
 
   void incr_counter(VariableRef x, const Number& k) override {
+    this->reduce_dirty(x);
     this->_product.incr_counter(x, k);
   }
 
   void forget_counter(VariableRef x) override {
     this->_product.forget_counter(x);
+    this->drop_dirty(x);
   }
 
   /// @}
 
-  void dump(std::ostream& o) const override { this->_product.dump(o); }
+  void dump(std::ostream& o) const override {
+    this->reduce();
+    this->_product.dump(o);
+  }
 
   static std::string name() { return "gauge + interval + congruence domain"; }
 
@@ -0,0 +1,348 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Closure of difference bound matrices using fixed-width weights
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <ikos/core/number/bound.hpp>
+#include <ikos/core/number/z_number.hpp>
+#include <ikos/core/support/compiler.hpp>
+
+namespace ikos {
+namespace core {
+namespace numeric {
+namespace int64_closure {
+
+/// \brief Weight of a difference bound matrix, as a fixed-width integer
+///
+/// +oo is represented by the sentinel `PlusInfinity`. Finite weights are
+/// kept within [-MaxWeight, MaxWeight] so that the sum of three weights never
+/// overflows. A closure that leaves this range is abandoned, and the caller
+/// falls back to the unlimited precision implementation.
+using Weight = int64_t;
+
+/// \brief Weight representing +oo
+constexpr Weight PlusInfinity = std::numeric_limits< Weight >::max();
+
+/// \brief Largest absolute value of a finite weight
+constexpr Weight MaxWeight = Weight(1) << 60;
+
+/// \brief Return true if the weight is +oo or within the finite range
+inline bool is_valid(Weight w) {
+  return w == PlusInfinity || (w >= -MaxWeight && w <= MaxWeight);
+}
+
+/// \brief Add two weights
+inline Weight add(Weight a, Weight b) {
+  return (a == PlusInfinity || b == PlusInfinity) ? PlusInfinity : a + b;
+}
+
+/// \brief Add three weights
+inline Weight add(Weight a, Weight b, Weight c) {
+  return (a == PlusInfinity || b == PlusInfinity || c == PlusInfinity)
+             ? PlusInfinity
+             : a + b + c;
+}
+
+/// \brief Divide a weight by 2, with rounding towards zero
+inline Weight half(Weight a) {
+  return (a == PlusInfinity) ? PlusInfinity : a / 2;
+}
+
+/// \brief Convert the given bounds into weights
+///
+/// Return false if a bound does not fit in a weight.
+inline bool load(const std::vector< Bound< ZNumber > >& bounds,
+                 std::vector< Weight >& weights) {
+  weights.resize(bounds.size());
+
+  for (std::size_t i = 0; i < bounds.size(); i++) {
+    const Bound< ZNumber >& b = bounds[i];
+
+    if (b.is_plus_infinity()) {
+      weights[i] = PlusInfinity;
+    } else if (b.is_minus_infinity()) {
+      return false;
+    } else {
+      ZNumber n = *b.number();
+      if (!n.fits< Weight >()) {
+        return false;
+      }
+      weights[i] = n.to< Weight >();
+      if (!is_valid(weights[i])) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/// \brief Convert the given weights back into bounds
+inline void store(const std::vector< Weight >& weights,
+                  std::vector< Bound< ZNumber > >& bounds) {
+  ikos_assert(weights.size() == bounds.size());
+
+  for (std::size_t i = 0; i < weights.size(); i++) {
+    if (weights[i] == PlusInfinity) {
+      bounds[i] = Bound< ZNumber >::plus_infinity();
+    } else {
+      bounds[i] = ZNumber(weights[i]);
+    }
+  }
+}
+
+/// \brief Return the scratch buffer used to compute closures
+inline std::vector< Weight >& scratch() {
+  static thread_local std::vector< Weight > weights;
+  return weights;
+}
+
+/// \brief Relax a row of a difference bound matrix through another row
+///
+/// Compute `row_i[j] = min(row_i[j], w_ik + row_k[j])` for `j` in `[0, n)`,
+/// where `w_ik` is a finite weight and `row_i` and `row_k` do not overlap.
+///
+/// The loop is branch-free so that it can be vectorized, and it is compiled
+/// for several instruction sets when possible (see
+/// ikos_attribute_target_clones).
+///
+/// Return false if a weight leaves the finite range.
+ikos_attribute_target_clones inline bool relax_row(Weight* row_i,
+                                                   const Weight* row_k,
+                                                   Weight w_ik,
+                                                   std::size_t n) {
+  Weight invalid = 0;
+  for (std::size_t j = 0; j < n; j++) {
+    Weight w = (row_k[j] == PlusInfinity) ? PlusInfinity : w_ik + row_k[j];
+    Weight r = std::min(row_i[j], w);
+    row_i[j] = r;
+    invalid |= static_cast< Weight >(r != PlusInfinity) &
+               static_cast< Weight >((r > MaxWeight) | (r < -MaxWeight));
+  }
+  return invalid == 0;
+}
+
+/// \brief Apply the Floyd-Warshall algorithm on a `n * n` row-major matrix
+///
+/// Return false if a weight leaves the finite range, in which case the
+/// content of `m` is unspecified.
+inline bool floyd_warshall(std::vector< Weight >& m, std::size_t n) {
+  for (std::size_t k = 0; k < n; k++) {
+    if (m[n * k + k] >= 0) {
+      // Fast path: row `k` and column `k` are left unchanged by the pivot,
+      // hence rows can be relaxed independently
+      for (std::size_t i = 0; i < n; i++) {
+        if (i == k || m[n * i + k] == PlusInfinity) {
+          continue;
+        }
+        if (!relax_row(&m[n * i], &m[n * k], m[n * i + k], n)) {
+          return false;
+        }
+      }
+      continue;
+    }
+
+    // Negative cycle: keep the exact in-place semantics
+    for (std::size_t i = 0; i < n; i++) {
+      if (m[n * i + k] == PlusInfinity) {
+        // Row `i` cannot be improved through `k`
+        continue;
+      }
+
+      // The only updated operand used within the row is `m[i, k]`, so
+      // weights stay within 3 * MaxWeight until the end of the row.
+      bool valid = true;
+      for (std::size_t j = 0; j < n; j++) {
+        Weight w = add(m[n * i + k], m[n * k + j]);
+        if (w < m[n * i + j]) {
+          m[n * i + j] = w;
+          valid &= is_valid(w);
+        }
+      }
+
+      if (!valid) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/// \brief Apply the Floyd-Warshall algorithm on a difference bound matrix
+///
+/// `matrix` is a `n * n` row-major matrix.
+///
+/// Return false, leaving the matrix unchanged, if the weights do not fit in
+/// fixed-width integers.
+inline bool dbm_closure(std::vector< Bound< ZNumber > >& matrix,
+                        std::size_t n) {
+  std::vector< Weight >& m = scratch();
+
+  if (!load(matrix, m) || !floyd_warshall(m, n)) {
+    return false;
+  }
+
+  store(m, matrix);
+  return true;
+}
+
+/// \brief Fallback for numbers that are not integers
+template < typename Number >
+inline bool dbm_closure(std::vector< Bound< Number > >&, std::size_t) {
+  return false;
+}
+
+/// \brief Return the position of the element `(i, j)` of an octagon matrix
+///
+/// Octagon matrices are coherent: the element `(i, j)` is equal to the element
+/// `(j ^ 1, i ^ 1)`. Only the elements such that `j <= (i | 1)` are stored,
+/// row by row, hence a matrix on `n` variables has `2n * (n + 1)` elements.
+/// The diagonal elements `(i, i)` and `(i ^ 1, i ^ 1)` are stored separately.
+/// Indexes are zero-based.
+inline std::size_t octagon_index(std::size_t i, std::size_t j) {
+  if (j > (i | 1)) {
+    std::size_t t = i;
+    i = j ^ 1;
+    j = t ^ 1;
+  }
+  return j + ((i + 1) * (i + 1)) / 2;
+}
+
+/// \brief Return the number of elements of an octagon matrix on `n` variables
+inline std::size_t octagon_size(std::size_t n) {
+  return 2 * n * (n + 1);
+}
+
+/// \brief Apply the strong closure algorithm on an octagon matrix
+///
+/// `m` is a packed `2n * 2n` matrix (see octagon_index), where `n` is the
+/// number of variables. Variables `k` such that `normalized[k]` is true are
+/// skipped.
+///
+/// Return false if a weight leaves the finite range, in which case the
+/// content of `m` is unspecified.
+inline bool strong_closure(std::vector< Weight >& m,
+                           std::size_t n,
+                           const std::vector< unsigned char >& normalized) {
+  const std::size_t dim = 2 * n;
+
+  auto at = [&m](std::size_t i, std::size_t j) -> Weight& {
+    return m[octagon_index(i, j)];
+  };
+
+  for (std::size_t k = 0; k < n; k++) {
+    if (normalized[k]) {
+      continue;
+    }
+
+    const std::size_t pos = 2 * k;
+    const std::size_t neg = 2 * k + 1;
+
+    for (std::size_t i = 0; i < dim; i++) {
+      for (std::size_t j = 0; j <= (i | 1); j++) {
+        // to ensure the "closed" property
+        Weight w = at(i, j);
+        w = std::min(w, add(at(i, pos), at(pos, j)));
+        w = std::min(w, add(at(i, neg), at(neg, j)));
+        w = std::min(w, add(at(i, pos), at(pos, neg), at(neg, j)));
+        w = std::min(w, add(at(i, neg), at(neg, pos), at(pos, j)));
+
+        // Several operands can be updated within a row, so check every
+        // weight to guarantee that the sums never overflow.
+        if (!is_valid(w)) {
+          return false;
+        }
+        at(i, j) = w;
+      }
+    }
+
+    // to ensure for all i,j: m_ij <= (m_i+i- + m_j-j+)/2
+    for (std::size_t i = 0; i < dim; i++) {
+      for (std::size_t j = 0; j <= (i | 1); j++) {
+        at(i, j) = std::min(at(i, j), half(add(at(i, i ^ 1), at(j ^ 1, j))));
+      }
+    }
+  }
+
+  return true;
+}
+
+/// \brief Apply the strong closure algorithm on an octagon matrix
+///
+/// `matrix` is a packed `2n * 2n` matrix (see octagon_index), where `n` is the
+/// number of variables. Variables `k` such that `normalized[k]` is true are
+/// skipped.
+///
+/// Return false, leaving the matrix unchanged, if the weights do not fit in
+/// fixed-width integers.
+inline bool octagon_closure(std::vector< Bound< ZNumber > >& matrix,
+                            std::size_t n,
+                            const std::vector< unsigned char >& normalized) {
+  std::vector< Weight >& m = scratch();
+
+  if (!load(matrix, m) || !strong_closure(m, n, normalized)) {
+    return false;
+  }
+
+  store(m, matrix);
+  return true;
+}
+
+/// \brief Fallback for numbers that are not integers
+template < typename Number >
+inline bool octagon_closure(std::vector< Bound< Number > >&,
+                            std::size_t,
+                            const std::vector< unsigned char >&) {
+  return false;
+}
+
+} // end namespace int64_closure
+} // end namespace numeric
+} // end namespace core
+} // end namespace ikos
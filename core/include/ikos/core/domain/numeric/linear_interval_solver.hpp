@@ -52,11 +52,11 @@
 
 #pragma once
 
+#include <deque>
 #include <functional>
 #include <vector>
 
 #include <boost/container/flat_map.hpp>
-#include <boost/container/flat_set.hpp>
 
 #include <ikos/core/linear_constraint.hpp>
 #include <ikos/core/linear_expression.hpp>
@@ -86,15 +86,16 @@ inline QInterval trim_bound(const QInterval& i, const QBound&) {
 
 /// \brief Linear interval solver
 ///
+/// The solver uses a worklist of constraints. When the interval of a variable
+/// is refined, only the constraints mentioning that variable are propagated
+/// again.
+///
+/// The number of operations is bounded by `max_cycles` times the cost of one
+/// propagation of all the constraints.
+///
 /// Note that the solver does not own the linear constraints.
 template < typename Number, typename VariableRef, typename NumAbstractDomain >
 class LinearIntervalSolver {
-private:
-  static const std::size_t _large_system_cst_threshold = 3;
-
-  /// \brief Cost of one propagation cycle for a dense 3x3 system of constraints
-  static const std::size_t _large_system_op_threshold = 27;
-
 private:
   using BoundT = Bound< Number >;
   using IntervalT = Interval< Number >;
@@ -107,8 +108,9 @@ private:
 
 private:
   using ConstraintSet = std::vector< LinearConstraintRef >;
-  using TriggerTable = boost::container::flat_map< VariableRef, ConstraintSet >;
-  using VariableSet = boost::container::flat_set< VariableRef >;
+  using ConstraintIndexes = std::vector< std::size_t >;
+  using TriggerTable =
+      boost::container::flat_map< VariableRef, ConstraintIndexes >;
 
 private:
   std::size_t _max_cycles;
@@ -116,14 +118,37 @@ private:
   std::size_t _max_op = 0;
   std::size_t _op_count = 0;
   bool _is_contradiction = false;
-  bool _is_large_system = false;
   ConstraintSet _csts;
   TriggerTable _trigger_table;
-  VariableSet _refined_variables;
+  std::deque< std::size_t > _worklist;
+  std::vector< bool > _in_worklist;
 
 private:
   struct BottomFound {};
 
+  /// \brief Add the constraint at the given index in the worklist
+  void schedule(std::size_t i) {
+    if (!this->_in_worklist[i]) {
+      this->_in_worklist[i] = true;
+      this->_worklist.push_back(i);
+    }
+  }
+
+  /// \brief Add the constraints mentioning variable v in the worklist
+  void trigger(VariableRef v) {
+    if (this->_csts.size() == 1) {
+      this->schedule(0);
+      return;
+    }
+
+    auto it = this->_trigger_table.find(v);
+    if (it != this->_trigger_table.end()) {
+      for (std::size_t i : it->second) {
+        this->schedule(i);
+      }
+    }
+  }
+
   /// \brief Refine the abstract value for the given variable v
   void refine(VariableRef v, const IntervalT& i, NumAbstractDomain& inv) {
     IntervalT old_i = inv.to_interval(v);
@@ -133,7 +158,7 @@ private:
     }
     if (old_i != new_i) {
       inv.refine(v, new_i);
-      this->_refined_variables.insert(v);
+      this->trigger(v);
       ++this->_op_count;
     }
   }
@@ -177,7 +202,7 @@ private:
           }
           if (old_i != new_i) {
             inv.refine(pivot, new_i);
-            this->_refined_variables.insert(pivot);
+            this->trigger(pivot);
           }
           ++this->_op_count;
         }
@@ -186,47 +211,35 @@ private:
   }
 
   void build_trigger_table() {
-    // Build the trigger table
-    for (LinearConstraintRef cst : this->_csts) {
-      for (const auto& term : cst.get()) {
-        this->_trigger_table[term.first].push_back(cst);
+    for (std::size_t i = 0; i < this->_csts.size(); i++) {
+      for (const auto& term : this->_csts[i].get()) {
+        this->_trigger_table[term.first].push_back(i);
       }
     }
   }
 
-  /// \brief Slove a large linear constraint system
-  void solve_large_system(NumAbstractDomain& inv) {
+  /// \brief Solve the linear constraint system
+  void solve(NumAbstractDomain& inv) {
     this->_op_count = 0;
-    this->_refined_variables.clear();
-    for (const LinearConstraintT& cst : this->_csts) {
-      this->propagate(cst, inv);
+    this->_worklist.clear();
+    this->_in_worklist.assign(this->_csts.size(), false);
+    for (std::size_t i = 0; i < this->_csts.size(); i++) {
+      this->schedule(i);
     }
-    do {
-      VariableSet vars_to_process(this->_refined_variables);
-      this->_refined_variables.clear();
-      for (VariableRef var : vars_to_process) {
-        for (const LinearConstraintT& cst : this->_trigger_table[var]) {
-          this->propagate(cst, inv);
-        }
-      }
-    } while (!this->_refined_variables.empty() &&
-             this->_op_count <= this->_max_op);
-  }
 
-  /// \brief Slove a small linear constraint system
-  void solve_small_system(NumAbstractDomain& inv) {
-    std::size_t cycle = 0;
-    do {
-      ++cycle;
-      this->_refined_variables.clear();
-      for (const LinearConstraintT& cst : this->_csts) {
-        this->propagate(cst, inv);
-      }
-    } while (!this->_refined_variables.empty() && cycle <= this->_max_cycles);
+    while (!this->_worklist.empty() && this->_op_count <= this->_max_op) {
+      std::size_t i = this->_worklist.front();
+      this->_worklist.pop_front();
+      this->_in_worklist[i] = false;
+      this->propagate(this->_csts[i], inv);
+    }
   }
 
 public:
   /// \brief Constructor
+  ///
+  /// \param max_cycles Refinement budget, in number of propagations of the
+  /// whole system
   explicit LinearIntervalSolver(std::size_t max_cycles)
       : _max_cycles(max_cycles) {}
 
@@ -286,19 +299,12 @@ public:
 
     this->_max_op = this->_op_per_cycle * this->_max_cycles;
 
-    this->_is_large_system = this->_csts.size() > _large_system_cst_threshold ||
-                             this->_op_per_cycle > _large_system_op_threshold;
-
-    if (this->_is_large_system) {
+    if (this->_csts.size() > 1) {
       this->build_trigger_table();
     }
 
     try {
-      if (this->_is_large_system) {
-        this->solve_large_system(inv);
-      } else {
-        this->solve_small_system(inv);
-      }
+      this->solve(inv);
     } catch (BottomFound&) {
       inv.set_to_bottom();
     }
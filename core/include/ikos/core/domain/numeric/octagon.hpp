@@ -48,12 +48,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 #include <boost/container/flat_map.hpp>
 #include <boost/optional.hpp>
 
 #include <ikos/core/domain/numeric/abstract_domain.hpp>
+#include <ikos/core/domain/numeric/int64_closure.hpp>
 #include <ikos/core/domain/numeric/interval.hpp>
 #include <ikos/core/number/bound.hpp>
 #include <ikos/core/support/assert.hpp>
@@ -104,6 +106,11 @@ private:
     // Matrix represented as single vector for performance.
     // Using a standard vector< vector<> > results in significant
     // degradation of performance.
+    //
+    // The matrix is coherent: the element (i, j) is equal to the element
+    // (j', i'), where i' is the other index of the variable of i. Only the
+    // lower half is stored, see int64_closure::octagon_index. Rows of a new
+    // variable are appended at the end, hence resizing never moves elements.
 
   private:
     std::vector< BoundT > _matrix;
@@ -140,15 +147,8 @@ private:
         return;
       }
 
-      this->_matrix.resize(4 * new_size * new_size, BoundT::plus_infinity());
-
-      for (MatrixIndex j = 2 * this->_num_var; j > 0; --j) {
-        for (MatrixIndex i = 2 * this->_num_var; i > 0; --i) {
-          std::swap(this->_matrix[2 * new_size * (j - 1) + (i - 1)],
-                    this->_matrix[2 * _num_var * (j - 1) + (i - 1)]);
-        }
-      }
-
+      this->_matrix.resize(int64_closure::octagon_size(new_size),
+                           BoundT::plus_infinity());
       this->_num_var = new_size;
     }
 
@@ -161,37 +161,38 @@ private:
         return;
       }
 
+      // Elements only move towards the beginning of the vector
       MatrixIndex new_size = this->_num_var - 1;
-      std::vector< BoundT > new_matrix;
-      new_matrix.resize(4 * new_size * new_size, BoundT::plus_infinity());
-
-      for (MatrixIndex j = 2 * this->_num_var; j > 0; --j) {
-        if (j == 2 * k || j == 2 * k - 1) {
-          continue;
+      for (MatrixIndex i = 1; i <= 2 * new_size; i++) {
+        MatrixIndex old_i = (i < 2 * k - 1) ? i : i + 2;
+        for (MatrixIndex j = 1; j <= ((i + 1) & ~MatrixIndex(1)); j++) {
+          MatrixIndex old_j = (j < 2 * k - 1) ? j : j + 2;
+          std::swap(this->_matrix[index(i, j)],
+                    this->_matrix[index(old_i, old_j)]);
         }
+      }
 
-        for (MatrixIndex i = 2 * this->_num_var; i > 0; --i) {
-          if (i == 2 * k || i == 2 * k - 1) {
-            continue;
-          }
+      this->_matrix.erase(this->_matrix.begin() +
+                              int64_closure::octagon_size(new_size),
+                          this->_matrix.end());
+      this->_num_var = new_size;
+    }
 
-          if (i > 2 * k) {
-            if (j > 2 * k) {
-              std::swap(new_matrix[2 * new_size * (j - 3) + (i - 3)],
-                        this->_matrix[2 * _num_var * (j - 1) + (i - 1)]);
-            } else { // j < 2*k-1
-              std::swap(new_matrix[2 * new_size * (j - 1) + (i - 3)],
-                        this->_matrix[2 * _num_var * (j - 1) + (i - 1)]);
-            }
-          } else { // i < 2*k-1
-            if (j > 2 * k) {
-              std::swap(new_matrix[2 * new_size * (j - 3) + (i - 1)],
-                        this->_matrix[2 * _num_var * (j - 1) + (i - 1)]);
-            } else { // j < 2*k-1
-              std::swap(new_matrix[2 * new_size * (j - 1) + (i - 1)],
-                        this->_matrix[2 * _num_var * (j - 1) + (i - 1)]);
-            }
-          }
+    /// \brief Downsize the matrix to the given variables
+    ///
+    /// The variable `kept[k - 1]` becomes the variable `k`.
+    void shrink(const std::vector< MatrixIndex >& kept) {
+      MatrixIndex new_size = kept.size();
+      std::vector< BoundT > new_matrix;
+      new_matrix.resize(int64_closure::octagon_size(new_size),
+                        BoundT::plus_infinity());
+
+      for (MatrixIndex i = 1; i <= 2 * new_size; i++) {
+        MatrixIndex old_i = 2 * kept[(i - 1) / 2] - (i % 2);
+        for (MatrixIndex j = 1; j <= ((i + 1) & ~MatrixIndex(1)); j++) {
+          MatrixIndex old_j = 2 * kept[(j - 1) / 2] - (j % 2);
+          std::swap(new_matrix[index(i, j)],
+                    this->_matrix[index(old_i, old_j)]);
         }
       }
 
@@ -206,23 +207,24 @@ private:
     }
 
     BoundT& operator()(MatrixIndex i, MatrixIndex j) {
-      // Accesses the matrix as one-based and in column-major order
-      // so as to match DBM representations.
+      // Accesses the matrix as one-based so as to match DBM representations.
       ikos_assert_msg(i >= 1 && j >= 1 && i <= 2 * this->_num_var &&
                           j <= 2 * this->_num_var,
                       "out of bounds matrix access");
-      return this->_matrix[2 * this->_num_var * (j - 1) + (i - 1)];
+      return this->_matrix[index(i, j)];
     }
 
     const BoundT& operator()(MatrixIndex i, MatrixIndex j) const {
-      // Accesses the matrix as one-based and in column-major order
-      // so as to match DBM representations.
+      // Accesses the matrix as one-based so as to match DBM representations.
       ikos_assert_msg(i >= 1 && j >= 1 && i <= 2 * this->_num_var &&
                           j <= 2 * this->_num_var,
                       "out of bounds matrix access");
-      return this->_matrix[2 * this->_num_var * (j - 1) + (i - 1)];
+      return this->_matrix[index(i, j)];
     }
 
+    /// \brief Return the elements of the lower half, row by row
+    std::vector< BoundT >& elements() { return this->_matrix; }
+
     /// \brief Print the matrix, for debugging purpose
     void dump(std::ostream& o) const {
       for (MatrixIndex i = 1; i <= 2 * this->_num_var; i++) {
@@ -234,6 +236,12 @@ private:
       }
     }
 
+  private:
+    /// \brief Return the position of the one-based element (i, j)
+    static MatrixIndex index(MatrixIndex i, MatrixIndex j) {
+      return int64_closure::octagon_index(i - 1, j - 1);
+    }
+
   }; // end class Matrix
 
 private:
@@ -299,37 +307,69 @@ private:
     }
   }
 
+  /// \brief Mark the constraints on the given variable as updated
+  ///
+  /// If they are the only updated constraints since the last normalization,
+  /// the next one is an incremental closure, in O(n^2).
+  void set_unnormalized(MatrixIndex k) {
+    this->_is_normalized = false;
+    this->_norm_vector[k - 1] = 0;
+  }
+
   /// \brief Resize the octagon
   void resize() {
+    // New variables are unconstrained, thus do not need a closure
     this->_matrix.resize(this->_var_index_map.size());
-    this->_norm_vector.resize(this->_var_index_map.size(), 0);
+    this->_norm_vector.resize(this->_var_index_map.size(), 1);
   }
 
-public:
-  /// \brief Compute the strong closure algorithm
-  void normalize() const override {
-    if (this->_is_normalized) {
-      return;
+  /// \brief Close the matrix with the variable `k` as pivot
+  void close_pivot(MatrixIndex k) {
+    const MatrixIndex size = 2 * this->_matrix.size();
+
+    // Only the lower half is stored, see Matrix
+    for (MatrixIndex i = 1; i <= size; ++i) {
+      for (MatrixIndex j = 1; j <= ((i + 1) & ~MatrixIndex(1)); ++j) {
+        // to ensure the "closed" property
+        this->_matrix(i, j) =
+            C(this->_matrix(i, j),
+              this->_matrix(i, 2 * k - 1) + this->_matrix(2 * k - 1, j),
+              this->_matrix(i, 2 * k) + this->_matrix(2 * k, j),
+              this->_matrix(i, 2 * k - 1) + this->_matrix(2 * k - 1, 2 * k) +
+                  this->_matrix(2 * k, j),
+              this->_matrix(i, 2 * k) + this->_matrix(2 * k, 2 * k - 1) +
+                  this->_matrix(2 * k - 1, j));
+      }
     }
 
-    auto self = const_cast< Octagon* >(this);
-
-    if (this->_is_bottom) {
-      self->_is_normalized = true;
-      return;
+    // to ensure for all i,j: m_ij <= (m_i+i- + m_j-j+)/2
+    for (MatrixIndex i = 1; i <= size; ++i) {
+      for (MatrixIndex j = 1; j <= ((i + 1) & ~MatrixIndex(1)); ++j) {
+        this->_matrix(i, j) = min(this->_matrix(i, j),
+                                  (this->_matrix(i, i + 2 * (i % 2) - 1) +
+                                   this->_matrix(j + 2 * (j % 2) - 1, j)) /
+                                      BoundT(2));
+      }
     }
+  }
 
+  /// \brief Incremental strong closure
+  ///
+  /// The matrix must be closed, except for the constraints on the variable
+  /// `v`. The rows of `v` are first closed with every other pivot, then the
+  /// whole matrix is closed with `v` as pivot.
+  void close_incremental(MatrixIndex v) {
     const MatrixIndex num_var = this->_matrix.size();
 
     for (MatrixIndex k = 1; k <= num_var; ++k) {
-      if (this->_norm_vector[k - 1]) {
+      if (k == v) {
         continue;
       }
 
-      for (MatrixIndex i = 1; i <= 2 * num_var; ++i) {
+      // By coherence, the rows of `v` hold its columns as well
+      for (MatrixIndex i = 2 * v - 1; i <= 2 * v; ++i) {
         for (MatrixIndex j = 1; j <= 2 * num_var; ++j) {
-          // to ensure the "closed" property
-          self->_matrix(i, j) =
+          this->_matrix(i, j) =
               C(this->_matrix(i, j),
                 this->_matrix(i, 2 * k - 1) + this->_matrix(2 * k - 1, j),
                 this->_matrix(i, 2 * k) + this->_matrix(2 * k, j),
@@ -339,18 +379,54 @@ public:
                     this->_matrix(2 * k - 1, j));
         }
       }
+    }
 
-      // to ensure for all i,j: m_ij <= (m_i+i- + m_j-j+)/2
-      for (MatrixIndex i = 1; i <= 2 * num_var; ++i) {
-        for (MatrixIndex j = 1; j <= 2 * num_var; ++j) {
-          self->_matrix(i, j) = min(this->_matrix(i, j),
-                                    (this->_matrix(i, i + 2 * (i % 2) - 1) +
-                                     this->_matrix(j + 2 * (j % 2) - 1, j)) /
-                                        BoundT(2));
-        }
+    this->close_pivot(v);
+  }
+
+public:
+  /// \brief Compute the strong closure algorithm
+  void normalize() const override {
+    if (this->_is_normalized) {
+      return;
+    }
+
+    auto self = const_cast< Octagon* >(this);
+
+    if (this->_is_bottom) {
+      self->_is_normalized = true;
+      return;
+    }
+
+    const MatrixIndex num_var = this->_matrix.size();
+    const auto updated =
+        std::count(this->_norm_vector.begin(), this->_norm_vector.end(), 0);
+
+    if (updated == 1) {
+      auto it =
+          std::find(self->_norm_vector.begin(), self->_norm_vector.end(), 0);
+      self->close_incremental(
+          static_cast< MatrixIndex >(it - self->_norm_vector.begin()) + 1);
+      *it = 1;
+    } else if (updated > 1) {
+      // The other variables can be related through the updated ones
+      std::fill(self->_norm_vector.begin(), self->_norm_vector.end(), 0);
+
+      // Try first with fixed-width weights
+      if (int64_closure::octagon_closure(self->_matrix.elements(),
+                                         num_var,
+                                         this->_norm_vector)) {
+        std::fill(self->_norm_vector.begin(), self->_norm_vector.end(), 1);
       }
 
-      self->_norm_vector[k - 1] = 1;
+      for (MatrixIndex k = 1; k <= num_var; ++k) {
+        if (this->_norm_vector[k - 1]) {
+          continue;
+        }
+
+        self->close_pivot(k);
+        self->_norm_vector[k - 1] = 1;
+      }
     }
 
     // Check for negative cycle
@@ -991,6 +1067,7 @@ private:
       this->_matrix(2 * var - 1, 2 * var) =
           min(this->_matrix(2 * var - 1, 2 * var), constraint);
     }
+    this->set_unnormalized(var);
 
     if (this->_matrix(2 * var, 2 * var - 1) <
         -this->_matrix(2 * var - 1, 2 * var)) {
@@ -1025,6 +1102,9 @@ private:
       this->_matrix(2 * i - 1, 2 * j) =
           min(this->_matrix(2 * i - 1, 2 * j), constraint);
     }
+    // Updated elements are all in the rows of `i`, by coherence
+    this->set_unnormalized(i);
+
     if (this->_matrix(2 * j, 2 * i - 1) < -this->_matrix(2 * j - 1, 2 * i) ||
         this->_matrix(2 * j - 1, 2 * i - 1) <
             -this->_matrix(2 * i - 1, 2 * j - 1)) {
@@ -1092,8 +1172,6 @@ public:
 
       this->set(x, this->to_interval(e));
     }
-
-    this->set_normalized(false);
   }
 
 private:
@@ -1109,6 +1187,7 @@ private:
     }
 
     if (op_eq) {
+      // By coherence, the rows of `j` hold its columns as well
       for (MatrixIndex j_idx = 1; j_idx <= 2 * this->_matrix.size(); ++j_idx) {
         if (j_idx != 2 * j && j_idx != 2 * j - 1) {
           this->_matrix(2 * j - 1, j_idx) -= lb;
@@ -1116,13 +1195,6 @@ private:
         }
       }
 
-      for (MatrixIndex i_idx = 1; i_idx <= 2 * _matrix.size(); ++i_idx) {
-        if (i_idx != 2 * j && i_idx != 2 * j - 1) {
-          this->_matrix(i_idx, 2 * j) -= lb;
-          this->_matrix(i_idx, 2 * j - 1) += ub;
-        }
-      }
-
       this->_matrix(2 * j - 1, 2 * j) -= BoundT(2) * lb;
       this->_matrix(2 * j, 2 * j - 1) += BoundT(2) * ub;
     } else {
@@ -1269,7 +1341,9 @@ private:
       }
     }
 
-    this->_norm_vector[i - 1] = 0;
+    if (!this->_is_bottom) {
+      this->set_unnormalized(i);
+    }
     // Result is not normalized.
   }
 
@@ -1431,7 +1505,6 @@ public:
         return;
       }
     }
-    this->_is_normalized = false;
   }
 
   void add(const LinearConstraintSystemT& csts) override {
@@ -1510,11 +1583,59 @@ public:
           this->_var_index_map[itz->first]--;
         }
       }
-      this->_norm_vector.resize(this->_var_index_map.size(), 0);
-      this->_is_normalized = false;
+      // Removing a variable from a closed octagon leaves it closed
+      this->_norm_vector.resize(this->_var_index_map.size(), 1);
+    }
+  }
+
+  void forget_vars(const std::vector< VariableRef >& vars) override {
+    std::vector< VariableRef > dropped(vars);
+    std::sort(dropped.begin(), dropped.end());
+    this->remove_variables([&dropped](VariableRef x) {
+      return std::binary_search(dropped.begin(), dropped.end(), x);
+    });
+  }
+
+  void project(const std::vector< VariableRef >& keep) override {
+    std::vector< VariableRef > kept(keep);
+    std::sort(kept.begin(), kept.end());
+    this->remove_variables([&kept](VariableRef x) {
+      return !std::binary_search(kept.begin(), kept.end(), x);
+    });
+  }
+
+private:
+  /// \brief Forget all the variables satisfying the given predicate
+  ///
+  /// The matrix is normalized and downsized once.
+  template < typename Predicate >
+  void remove_variables(const Predicate& is_removed) {
+    VarIndexMap var_index_map;
+    std::vector< MatrixIndex > kept;
+    for (const auto& p : this->_var_index_map) {
+      if (!is_removed(p.first)) {
+        kept.push_back(p.second);
+        var_index_map.emplace_hint(var_index_map.end(), p.first, kept.size());
+      }
     }
+
+    if (kept.size() == this->_var_index_map.size()) {
+      return;
+    }
+
+    this->normalize();
+    if (this->_is_bottom) {
+      return;
+    }
+
+    // Removing variables from a closed octagon leaves it closed
+    this->_matrix.shrink(kept);
+    this->_var_index_map = std::move(var_index_map);
+    this->_norm_vector.assign(kept.size(), 1);
   }
 
+public:
+
   IntervalT to_interval(VariableRef x) const override {
     // projection requires normalization.
     auto it = this->_var_index_map.find(x);
@@ -43,7 +43,7 @@
 
 #pragma once
 
-#include <ikos/core/adt/patricia_tree/map.hpp>
+#include <ikos/core/adt/adaptive_map.hpp>
 #include <ikos/core/domain/abstract_domain.hpp>
 #include <ikos/core/domain/numeric/operator.hpp>
 #include <ikos/core/linear_expression.hpp>
@@ -67,13 +67,13 @@ public:
 
 private:
   using LinearExpressionT = LinearExpression< Number, VariableRef >;
-  using PatriciaTreeMapT = PatriciaTreeMap< VariableRef, Value >;
+  using MapT = AdaptiveMap< VariableRef, Value >;
 
 public:
-  using Iterator = typename PatriciaTreeMapT::Iterator;
+  using Iterator = typename MapT::Iterator;
 
 private:
-  PatriciaTreeMapT _tree;
+  MapT _map;
   bool _is_bottom;
 
 private:
@@ -115,29 +115,29 @@ public:
   /// \brief Begin iterator over the pairs (variable, value)
   Iterator begin() const {
     ikos_assert(!this->is_bottom());
-    return this->_tree.begin();
+    return this->_map.begin();
   }
 
   /// \brief End iterator over the pairs (variable, value)
   Iterator end() const {
     ikos_assert(!this->is_bottom());
-    return this->_tree.end();
+    return this->_map.end();
   }
 
   bool is_bottom() const override { return this->_is_bottom; }
 
   bool is_top() const override {
-    return !this->is_bottom() && this->_tree.empty();
+    return !this->is_bottom() && this->_map.empty();
   }
 
   void set_to_bottom() override {
     this->_is_bottom = true;
-    this->_tree.clear();
+    this->_map.clear();
   }
 
   void set_to_top() override {
     this->_is_bottom = false;
-    this->_tree.clear();
+    this->_map.clear();
   }
 
   bool leq(const SeparateDomain& other) const override {
@@ -146,7 +146,7 @@ public:
     } else if (other.is_bottom()) {
       return false;
     } else {
-      return this->_tree.leq(other._tree, [](const Value& x, const Value& y) {
+      return this->_map.leq(other._map, [](const Value& x, const Value& y) {
         return x.leq(y);
       });
     }
@@ -158,10 +158,10 @@ public:
     } else if (other.is_bottom()) {
       return false;
     } else {
-      return this->_tree.equals(other._tree,
-                                [](const Value& x, const Value& y) {
-                                  return x.equals(y);
-                                });
+      return this->_map.equals(other._map,
+                               [](const Value& x, const Value& y) {
+                                 return x.equals(y);
+                               });
     }
   }
 
@@ -171,15 +171,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [](const Value& x, const Value& y) {
-                                   Value z = x.join(y);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [](const Value& x, const Value& y) {
+                                  Value z = x.join(y);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -189,15 +189,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [](const Value& x, const Value& y) {
-                                   Value z = x.join_loop(y);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [](const Value& x, const Value& y) {
+                                  Value z = x.join_loop(y);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -207,15 +207,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [](const Value& x, const Value& y) {
-                                   Value z = x.join_loop(y);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [](const Value& x, const Value& y) {
+                                  Value z = x.join_loop(y);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -225,15 +225,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [](const Value& x, const Value& y) {
-                                   Value z = x.widening(y);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [](const Value& x, const Value& y) {
+                                  Value z = x.widening(y);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -244,15 +244,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [threshold](const Value& x, const Value& y) {
-                                   Value z = x.widening_threshold(y, threshold);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [threshold](const Value& x, const Value& y) {
+                                  Value z = x.widening_threshold(y, threshold);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -263,7 +263,7 @@ public:
       this->set_to_bottom();
     } else {
       try {
-        this->_tree.join_with(other._tree, [](const Value& x, const Value& y) {
+        this->_map.join_with(other._map, [](const Value& x, const Value& y) {
           Value z = x.meet(y);
           if (z.is_bottom()) {
             throw BottomFound();
@@ -283,7 +283,7 @@ public:
       this->set_to_bottom();
     } else {
       try {
-        this->_tree.join_with(other._tree, [](const Value& x, const Value& y) {
+        this->_map.join_with(other._map, [](const Value& x, const Value& y) {
           Value z = x.narrowing(y);
           if (z.is_bottom()) {
             throw BottomFound();
@@ -301,7 +301,7 @@ public:
     if (this->is_bottom()) {
       return Value::bottom();
     } else {
-      boost::optional< const Value& > v = this->_tree.at(x);
+      boost::optional< const Value& > v = this->_map.at(x);
       if (v) {
         return *v;
       } else {
@@ -317,9 +317,9 @@ public:
     } else if (value.is_bottom()) {
       this->set_to_bottom();
     } else if (value.is_top()) {
-      this->_tree.erase(x);
+      this->_map.erase(x);
     } else {
-      this->_tree.insert_or_assign(x, value);
+      this->_map.insert_or_assign(x, value);
     }
   }
 
@@ -333,7 +333,7 @@ public:
       return;
     } else {
       try {
-        this->_tree.update_or_insert(
+        this->_map.update_or_insert(
             [](const Value& x, const Value& y) {
               Value z = x.meet(y);
               if (z.is_bottom()) {
@@ -370,7 +370,7 @@ public:
     if (this->is_bottom()) {
       return;
     }
-    this->_tree.erase(x);
+    this->_map.erase(x);
   }
 
   /// \brief Assign `x = n`
@@ -406,7 +406,7 @@ public:
     if (this->is_bottom()) {
       o << "⊥";
     } else {
-      this->_tree.dump(o);
+      this->_map.dump(o);
     }
   }
 
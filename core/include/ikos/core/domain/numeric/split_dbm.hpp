@@ -0,0 +1,1415 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Sparse domain of Difference-Bound Matrices in split normal form
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Based on Graeme Gange, Jorge A. Navas, Peter Schachte, Harald Sondergaard
+ * and Peter J. Stuckey's paper: Exploiting Sparsity in Difference-Bound
+ * Matrices, in SAS, 185-204, 2016.
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <boost/container/flat_map.hpp>
+#include <boost/container/flat_set.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+
+#include <ikos/core/domain/numeric/abstract_domain.hpp>
+#include <ikos/core/domain/numeric/linear_interval_solver.hpp>
+#include <ikos/core/number/bound.hpp>
+#include <ikos/core/support/assert.hpp>
+#include <ikos/core/value/numeric/congruence.hpp>
+#include <ikos/core/value/numeric/interval.hpp>
+#include <ikos/core/value/numeric/interval_congruence.hpp>
+
+namespace ikos {
+namespace core {
+namespace numeric {
+
+/// \brief Sparse Difference-Bound Matrices abstract domain
+///
+/// The constraints are stored in split normal form: the bounds of each
+/// variable are kept separately, and the differences `v_j - v_i <= w` are
+/// kept as a sparse weighted graph, using adjacency lists.
+///
+/// The graph is closed lazily, on the first operation that requires it.
+/// Edges implied by the bounds of the variables are removed during the
+/// closure, which keeps the graph sparse.
+///
+/// This provides the precision of DBM at a cost close to the interval domain
+/// when variables are related to only a few other variables.
+///
+/// Note that this abstract domain is not thread-safe.
+template < typename Number,
+           typename VariableRef,
+           std::size_t MaxReductionCycles = 10 >
+class SplitDBM final
+    : public numeric::AbstractDomain<
+          Number,
+          VariableRef,
+          SplitDBM< Number, VariableRef, MaxReductionCycles > > {
+public:
+  using BoundT = Bound< Number >;
+  using IntervalT = Interval< Number >;
+  using CongruenceT = Congruence< Number >;
+  using IntervalCongruenceT = IntervalCongruence< Number >;
+  using VariableExprT = VariableExpression< Number, VariableRef >;
+  using LinearExpressionT = LinearExpression< Number, VariableRef >;
+  using LinearConstraintT = LinearConstraint< Number, VariableRef >;
+  using LinearConstraintSystemT = LinearConstraintSystem< Number, VariableRef >;
+
+private:
+  /// \brief Index of a variable in the graph
+  using VertexIndex = unsigned;
+
+  /// \brief Map from variable to vertex
+  using VarIndexMap = boost::container::flat_map< VariableRef, VertexIndex >;
+
+  /// \brief Map from successor to weight
+  using EdgeMap = boost::container::flat_map< VertexIndex, Number >;
+
+  /// \brief Set of predecessors
+  using VertexSet = boost::container::flat_set< VertexIndex >;
+
+  /// \brief Solver
+  using LinearIntervalSolverT =
+      LinearIntervalSolver< Number, VariableRef, SplitDBM >;
+
+  /// \brief Parent
+  using Parent = numeric::AbstractDomain< Number, VariableRef, SplitDBM >;
+
+  /// \brief Marker for an invalid vertex
+  static constexpr VertexIndex None = std::numeric_limits< VertexIndex >::max();
+
+  /// \brief Marker for the special variable zero, in add_constraint()
+  static constexpr VertexIndex Zero = None - 1;
+
+private:
+  bool _is_bottom;
+  bool _is_normalized;
+  VarIndexMap _var_index_map;
+
+  /// \brief Lower bound of each vertex
+  std::vector< BoundT > _lb;
+
+  /// \brief Upper bound of each vertex
+  std::vector< BoundT > _ub;
+
+  /// \brief Edges i -> j with weight w, representing v_j - v_i <= w
+  std::vector< EdgeMap > _succ;
+
+  /// \brief Predecessors of each vertex
+  std::vector< VertexSet > _pred;
+
+  /// \brief Vertices that are not bound to a variable
+  std::vector< VertexIndex > _free_vertices;
+
+private:
+  struct TopTag {};
+  struct BottomTag {};
+
+  /// \brief Create the top abstract value
+  explicit SplitDBM(TopTag) : _is_bottom(false), _is_normalized(true) {}
+
+  /// \brief Create the bottom abstract value
+  explicit SplitDBM(BottomTag) : _is_bottom(true), _is_normalized(true) {}
+
+public:
+  /// \brief Create the top abstract value
+  SplitDBM() : SplitDBM(TopTag{}) {}
+
+  /// \brief Copy constructor
+  SplitDBM(const SplitDBM&) = default;
+
+  /// \brief Move constructor
+  SplitDBM(SplitDBM&&) = default;
+
+  /// \brief Copy assignment operator
+  SplitDBM& operator=(const SplitDBM&) = default;
+
+  /// \brief Move assignment operator
+  SplitDBM& operator=(SplitDBM&&) = default;
+
+  /// \brief Destructor
+  ~SplitDBM() override = default;
+
+  /// \brief Create the top abstract value
+  static SplitDBM top() { return SplitDBM(TopTag{}); }
+
+  /// \brief Create the bottom abstract value
+  static SplitDBM bottom() { return SplitDBM(BottomTag{}); }
+
+private:
+  /// \brief Return the number of vertices, including free vertices
+  VertexIndex num_vertices() const {
+    return static_cast< VertexIndex >(this->_lb.size());
+  }
+
+  /// \brief Return the weight of the edge i -> j, or nullptr
+  const Number* edge(VertexIndex i, VertexIndex j) const {
+    auto it = this->_succ[i].find(j);
+    if (it == this->_succ[i].end()) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  /// \brief Set the weight of the edge i -> j
+  void set_edge(VertexIndex i, VertexIndex j, const Number& w) {
+    ikos_assert(i != j);
+    this->_succ[i][j] = w;
+    this->_pred[j].insert(i);
+  }
+
+  /// \brief Return the tightest bound on v_j - v_i, in a normalized graph
+  BoundT weight(VertexIndex i, VertexIndex j) const {
+    BoundT w = this->_ub[j] - this->_lb[i];
+    if (const Number* e = this->edge(i, j)) {
+      w = min(w, BoundT(*e));
+    }
+    return w;
+  }
+
+  /// \brief Create a new vertex, without any constraint
+  VertexIndex add_vertex() {
+    if (!this->_free_vertices.empty()) {
+      VertexIndex i = this->_free_vertices.back();
+      this->_free_vertices.pop_back();
+      return i;
+    }
+
+    this->_lb.push_back(BoundT::minus_infinity());
+    this->_ub.push_back(BoundT::plus_infinity());
+    this->_succ.emplace_back();
+    this->_pred.emplace_back();
+    return this->num_vertices() - 1;
+  }
+
+  /// \brief Get the vertex of variable x
+  ///
+  /// Create a new one if not found
+  VertexIndex var_index(VariableRef x) {
+    auto it = this->_var_index_map.find(x);
+    if (it != this->_var_index_map.end()) {
+      return it->second;
+    }
+
+    VertexIndex i = this->add_vertex();
+    this->_var_index_map.emplace(x, i);
+    return i;
+  }
+
+  /// \brief Remove all constraints on vertex k
+  void clear_vertex(VertexIndex k) {
+    for (const auto& e : this->_succ[k]) {
+      this->_pred[e.first].erase(k);
+    }
+    for (VertexIndex p : this->_pred[k]) {
+      this->_succ[p].erase(k);
+    }
+    this->_succ[k].clear();
+    this->_pred[k].clear();
+    this->_lb[k] = BoundT::minus_infinity();
+    this->_ub[k] = BoundT::plus_infinity();
+  }
+
+  /// \brief Add constraint v_i - v_j <= c
+  ///
+  /// Either i or j can be `Zero`, to represent a bound on a variable.
+  void add_constraint(VertexIndex i, VertexIndex j, const BoundT& c) {
+    if (c.is_plus_infinity()) {
+      return;
+    }
+
+    if (j == Zero) { // v_i <= c
+      if (c < this->_ub[i]) {
+        this->_ub[i] = c;
+        this->_is_normalized = false;
+      }
+    } else if (i == Zero) { // v_j >= -c
+      if (-c > this->_lb[j]) {
+        this->_lb[j] = -c;
+        this->_is_normalized = false;
+      }
+    } else if (i == j) {
+      if (c < BoundT(0)) {
+        this->set_to_bottom();
+      }
+    } else {
+      ikos_assert(c.is_finite());
+      Number w = *c.number();
+      const Number* e = this->edge(j, i);
+      if (e == nullptr || w < *e) {
+        this->set_edge(j, i, w);
+        this->_is_normalized = false;
+      }
+    }
+  }
+
+  /// \brief Add constraint v_i - v_j <= c
+  void add_constraint(VertexIndex i, VertexIndex j, const Number& c) {
+    this->add_constraint(i, j, BoundT(c));
+  }
+
+  /// \brief Add constraint v_i - v_j <= c
+  void add_constraint(VertexIndex i, VertexIndex j, int c) {
+    this->add_constraint(i, j, BoundT(c));
+  }
+
+  /// \brief Apply v_i = v_i + c
+  void increment(VertexIndex i, const Number& c) {
+    if (c == 0) {
+      return;
+    }
+
+    this->_lb[i] += BoundT(c);
+    this->_ub[i] += BoundT(c);
+    for (auto& e : this->_succ[i]) {
+      e.second -= c;
+    }
+    for (VertexIndex p : this->_pred[i]) {
+      this->_succ[p][i] += c;
+    }
+
+    // Paths through v_i are shifted by opposite amounts, hence the closure
+    // is preserved.
+  }
+
+  /// \brief Forget all informations about vertex k
+  void forget(VertexIndex k) {
+    // Use informations about k to improve all constraints
+    // Not necessary if already normalized
+    if (!this->_is_normalized) {
+      if (this->_lb[k] > this->_ub[k]) {
+        this->set_to_bottom();
+        return;
+      }
+
+      for (VertexIndex i : this->_pred[k]) {
+        const Number w_i_k = *this->edge(i, k);
+
+        // v_i >= v_k - w_i_k
+        this->_lb[i] = max(this->_lb[i], this->_lb[k] - BoundT(w_i_k));
+
+        for (const auto& e : this->_succ[k]) {
+          Number w = w_i_k + e.second;
+          if (e.first == i) {
+            if (w < 0) {
+              this->set_to_bottom();
+              return;
+            }
+          } else {
+            this->add_constraint(e.first, i, w);
+          }
+        }
+      }
+
+      for (const auto& e : this->_succ[k]) {
+        // v_j <= v_k + w_k_j
+        this->_ub[e.first] =
+            min(this->_ub[e.first], this->_ub[k] + BoundT(e.second));
+      }
+    }
+
+    this->clear_vertex(k);
+  }
+
+  /// \brief Close the graph and propagate the bounds
+  ///
+  /// Return false if the constraints are unsatisfiable.
+  bool close() {
+    const VertexIndex n = this->num_vertices();
+
+    // Floyd-Warshall algorithm, only iterating on existing edges
+    for (VertexIndex k = 0; k < n; k++) {
+      if (this->_pred[k].empty() || this->_succ[k].empty()) {
+        continue;
+      }
+
+      // Edges to and from k are left unchanged
+      for (VertexIndex i : this->_pred[k]) {
+        const Number w_i_k = *this->edge(i, k);
+
+        for (const auto& e : this->_succ[k]) {
+          VertexIndex j = e.first;
+          Number w = w_i_k + e.second;
+
+          if (i == j) {
+            if (w < 0) {
+              return false;
+            }
+            continue;
+          }
+
+          auto it = this->_succ[i].find(j);
+          if (it == this->_succ[i].end()) {
+            this->set_edge(i, j, w);
+          } else if (w < it->second) {
+            it->second = std::move(w);
+          }
+        }
+      }
+    }
+
+    // The graph is closed, so one pass is enough to propagate the bounds
+    for (VertexIndex i = 0; i < n; i++) {
+      for (const auto& e : this->_succ[i]) {
+        VertexIndex j = e.first;
+        this->_ub[j] = min(this->_ub[j], this->_ub[i] + BoundT(e.second));
+        this->_lb[i] = max(this->_lb[i], this->_lb[j] - BoundT(e.second));
+      }
+    }
+
+    for (VertexIndex i = 0; i < n; i++) {
+      if (this->_lb[i] > this->_ub[i]) {
+        return false;
+      }
+    }
+
+    // Remove edges implied by the bounds
+    std::vector< VertexIndex > implied;
+    for (VertexIndex i = 0; i < n; i++) {
+      implied.clear();
+      for (const auto& e : this->_succ[i]) {
+        if (BoundT(e.second) >= this->_ub[e.first] - this->_lb[i]) {
+          implied.push_back(e.first);
+        }
+      }
+      for (VertexIndex j : implied) {
+        this->_succ[i].erase(j);
+        this->_pred[j].erase(i);
+      }
+    }
+
+    return true;
+  }
+
+public:
+  /// \brief Normalize the graph
+  void normalize() const override {
+    if (this->_is_normalized) {
+      return;
+    }
+
+    auto self = const_cast< SplitDBM* >(this);
+
+    if (this->_is_bottom) {
+      self->_is_normalized = true;
+      return;
+    }
+
+    if (!self->close()) {
+      self->set_to_bottom();
+      return;
+    }
+
+    self->_is_normalized = true;
+  }
+
+  bool is_bottom() const override {
+    this->normalize();
+    return this->_is_bottom;
+  }
+
+  bool is_top() const override {
+    // Does not require normalization
+
+    if (this->_is_bottom) {
+      return false;
+    }
+
+    for (const auto& p : this->_var_index_map) {
+      VertexIndex i = p.second;
+      if (!this->_lb[i].is_infinite() || !this->_ub[i].is_infinite() ||
+          !this->_succ[i].empty() || !this->_pred[i].empty()) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  void set_to_bottom() override {
+    this->_is_bottom = true;
+    this->_is_normalized = true;
+    this->_var_index_map.clear();
+    this->_lb.clear();
+    this->_ub.clear();
+    this->_succ.clear();
+    this->_pred.clear();
+    this->_free_vertices.clear();
+  }
+
+  void set_to_top() override {
+    this->set_to_bottom();
+    this->_is_bottom = false;
+  }
+
+  bool leq(const SplitDBM& other) const override {
+    // Requires normalization
+    this->normalize();
+    other.normalize();
+
+    if (this->_is_bottom) {
+      return true;
+    } else if (other._is_bottom) {
+      return false;
+    }
+
+    // Vertex in `this` of each vertex in `other`
+    std::vector< VertexIndex > vertex(other.num_vertices(), None);
+
+    for (const auto& p : other._var_index_map) {
+      VertexIndex j = p.second;
+      auto it = this->_var_index_map.find(p.first);
+      if (it == this->_var_index_map.end()) {
+        // Variable in `other` but not in `this`
+        if (!other._lb[j].is_infinite() || !other._ub[j].is_infinite() ||
+            !other._succ[j].empty() || !other._pred[j].empty()) {
+          return false;
+        }
+        continue;
+      }
+
+      VertexIndex i = it->second;
+      if (!(this->_lb[i] >= other._lb[j]) || !(this->_ub[i] <= other._ub[j])) {
+        return false;
+      }
+      vertex[j] = i;
+    }
+
+    for (VertexIndex j = 0; j < other.num_vertices(); j++) {
+      for (const auto& e : other._succ[j]) {
+        VertexIndex i = vertex[j];
+        VertexIndex i2 = vertex[e.first];
+        if (i == None || i2 == None) {
+          return false;
+        }
+        if (!(this->weight(i, i2) <= BoundT(e.second))) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  bool equals(const SplitDBM& other) const override {
+    return this->leq(other) && other.leq(*this);
+  }
+
+private:
+  /// \brief Prepare the result of a binary operation between `this` and
+  /// `other`
+  ///
+  /// The vertices of `result` are the variables of both operands if `union_`
+  /// is true, otherwise the variables common to both operands. `vars[r]` is
+  /// the pair of vertices in `this` and `other` of the vertex `r` of
+  /// `result`, where `None` marks a missing variable. `this_res` and
+  /// `other_res` map the vertices of the operands to the vertices of
+  /// `result`.
+  void merge_variables(const SplitDBM& other,
+                       bool union_,
+                       SplitDBM& result,
+                       std::vector< std::pair< VertexIndex, VertexIndex > >& vars,
+                       std::vector< VertexIndex >& this_res,
+                       std::vector< VertexIndex >& other_res) const {
+    this_res.assign(this->num_vertices(), None);
+    other_res.assign(other.num_vertices(), None);
+
+    auto emplace = [&](VariableRef x, VertexIndex i, VertexIndex j) {
+      auto r = static_cast< VertexIndex >(vars.size());
+      result._var_index_map.emplace_hint(result._var_index_map.end(), x, r);
+      vars.emplace_back(i, j);
+      if (i != None) {
+        this_res[i] = r;
+      }
+      if (j != None) {
+        other_res[j] = r;
+      }
+    };
+
+    for (auto l = this->_var_index_map.begin(),
+              r = other._var_index_map.begin();
+         l != this->_var_index_map.end() || r != other._var_index_map.end();) {
+      if (l == this->_var_index_map.end() ||
+          (r != other._var_index_map.end() && r->first < l->first)) {
+        // Variable in `other` but not in `this`
+        if (union_) {
+          emplace(r->first, None, r->second);
+        }
+        ++r;
+      } else if (r == other._var_index_map.end() ||
+                 (l != this->_var_index_map.end() && l->first < r->first)) {
+        // Variable in `this` but not in `other`
+        if (union_) {
+          emplace(l->first, l->second, None);
+        }
+        ++l;
+      } else {
+        emplace(l->first, l->second, r->second);
+        ++l;
+        ++r;
+      }
+    }
+
+    result._lb.assign(vars.size(), BoundT::minus_infinity());
+    result._ub.assign(vars.size(), BoundT::plus_infinity());
+    result._succ.resize(vars.size());
+    result._pred.resize(vars.size());
+  }
+
+  /// \brief Apply a pointwise binary operator on the bounds and the edges
+  ///
+  /// This behaves as if the operator was applied on the matrices of both
+  /// operands, where `this` is left as is and `other` is closed. Edges
+  /// implied by the bounds of the result are not stored.
+  template < typename BinaryOperator >
+  SplitDBM pointwise_binary_op(const SplitDBM& other,
+                               const BinaryOperator& op) const {
+    SplitDBM result;
+    std::vector< std::pair< VertexIndex, VertexIndex > > vars;
+    std::vector< VertexIndex > this_res, other_res;
+    this->merge_variables(other, false, result, vars, this_res, other_res);
+
+    for (VertexIndex r = 0; r < vars.size(); r++) {
+      VertexIndex i = vars[r].first;
+      VertexIndex j = vars[r].second;
+      result._lb[r] = -op(-this->_lb[i], -other._lb[j]);
+      result._ub[r] = op(this->_ub[i], other._ub[j]);
+    }
+
+    // Add the edge r -> s, unless it is implied by the bounds of the result
+    auto apply_edge = [&](VertexIndex r, VertexIndex s) {
+      BoundT w = op(this->weight(vars[r].first, vars[s].first),
+                    other.weight(vars[r].second, vars[s].second));
+      if (w.is_finite() && w < result._ub[s] - result._lb[r]) {
+        result._succ[r][s] = *w.number();
+        result._pred[s].insert(r);
+      }
+    };
+
+    // Explicit edges
+    for (VertexIndex r = 0; r < vars.size(); r++) {
+      for (const auto& e : this->_succ[vars[r].first]) {
+        VertexIndex s = this_res[e.first];
+        if (s != None) {
+          apply_edge(r, s);
+        }
+      }
+      for (const auto& e : other._succ[vars[r].second]) {
+        VertexIndex s = other_res[e.first];
+        if (s != None) {
+          apply_edge(r, s);
+        }
+      }
+    }
+
+    // Edges implied by the bounds in both operands, but not necessarily by
+    // the bounds of the result, e.g `x = y = 0` and `x = y = 1` gives `x = y`.
+    std::vector< VertexIndex > lower, upper;
+    for (VertexIndex r = 0; r < vars.size(); r++) {
+      if (this->_lb[vars[r].first].is_finite() &&
+          other._lb[vars[r].second].is_finite()) {
+        lower.push_back(r);
+      }
+      if (this->_ub[vars[r].first].is_finite() &&
+          other._ub[vars[r].second].is_finite()) {
+        upper.push_back(r);
+      }
+    }
+    for (VertexIndex r : lower) {
+      for (VertexIndex s : upper) {
+        if (r != s) {
+          apply_edge(r, s);
+        }
+      }
+    }
+
+    return result;
+  }
+
+  struct JoinOperator {
+    BoundT operator()(const BoundT& x, const BoundT& y) const {
+      return max(x, y);
+    }
+  };
+
+  struct WideningOperator {
+    BoundT operator()(const BoundT& x, const BoundT& y) const {
+      if (y <= x) {
+        return x;
+      } else {
+        return BoundT::plus_infinity();
+      }
+    }
+  };
+
+  struct WideningThresholdOperator {
+    BoundT threshold;
+
+    explicit WideningThresholdOperator(const Number& threshold_)
+        : threshold(threshold_) {}
+
+    BoundT operator()(const BoundT& x, const BoundT& y) const {
+      if (y <= x) {
+        return x;
+      } else if (threshold >= y) {
+        return threshold;
+      } else {
+        return BoundT::plus_infinity();
+      }
+    }
+  };
+
+public:
+  SplitDBM join(const SplitDBM& other) const override {
+    // Requires normalization
+    this->normalize();
+    other.normalize();
+
+    if (this->_is_bottom) {
+      return other;
+    } else if (other._is_bottom) {
+      return *this;
+    }
+
+    SplitDBM result = this->pointwise_binary_op(other, JoinOperator{});
+    result._is_normalized = true; // The join is normalized by construction
+    return result;
+  }
+
+  void join_with(const SplitDBM& other) override {
+    this->operator=(this->join(other));
+  }
+
+  SplitDBM widening(const SplitDBM& other) const override {
+    // Requires the normalization of the right operand.
+    // The left operand (this) should not be normalized.
+    other.normalize();
+
+    if (this->_is_bottom) {
+      return other;
+    } else if (other._is_bottom) {
+      return *this;
+    } else {
+      return this->pointwise_binary_op(other, WideningOperator{});
+    }
+  }
+
+  void widen_with(const SplitDBM& other) override {
+    this->operator=(this->widening(other));
+  }
+
+  SplitDBM widening_threshold(const SplitDBM& other,
+                              const Number& threshold) const override {
+    // Requires the normalization of the right operand.
+    // The left operand (this) should not be normalized.
+    other.normalize();
+
+    if (this->_is_bottom) {
+      return other;
+    } else if (other._is_bottom) {
+      return *this;
+    } else {
+      return this->pointwise_binary_op(other,
+                                       WideningThresholdOperator{threshold});
+    }
+  }
+
+  void widen_threshold_with(const SplitDBM& other,
+                            const Number& threshold) override {
+    this->operator=(this->widening_threshold(other, threshold));
+  }
+
+  SplitDBM meet(const SplitDBM& other) const override {
+    // Requires normalization
+    this->normalize();
+    other.normalize();
+
+    if (this->_is_bottom || other._is_bottom) {
+      return bottom();
+    }
+
+    SplitDBM result;
+    std::vector< std::pair< VertexIndex, VertexIndex > > vars;
+    std::vector< VertexIndex > this_res, other_res;
+    this->merge_variables(other, true, result, vars, this_res, other_res);
+
+    for (VertexIndex r = 0; r < vars.size(); r++) {
+      VertexIndex i = vars[r].first;
+      VertexIndex j = vars[r].second;
+
+      if (i != None) {
+        result._lb[r] = this->_lb[i];
+        result._ub[r] = this->_ub[i];
+        for (const auto& e : this->_succ[i]) {
+          result.set_edge(r, this_res[e.first], e.second);
+        }
+      }
+      if (j != None) {
+        result._lb[r] = max(result._lb[r], other._lb[j]);
+        result._ub[r] = min(result._ub[r], other._ub[j]);
+        for (const auto& e : other._succ[j]) {
+          result.add_constraint(other_res[e.first], r, e.second);
+        }
+      }
+    }
+
+    result._is_normalized = false;
+    return result;
+  }
+
+  void meet_with(const SplitDBM& other) override {
+    this->operator=(this->meet(other));
+  }
+
+  SplitDBM narrowing(const SplitDBM& other) const override {
+    // Requires normalization
+    this->normalize();
+    other.normalize();
+
+    if (this->_is_bottom || other._is_bottom) {
+      return bottom();
+    }
+
+    SplitDBM result;
+    std::vector< std::pair< VertexIndex, VertexIndex > > vars;
+    std::vector< VertexIndex > this_res, other_res;
+    this->merge_variables(other, true, result, vars, this_res, other_res);
+
+    for (VertexIndex r = 0; r < vars.size(); r++) {
+      VertexIndex i = vars[r].first;
+      VertexIndex j = vars[r].second;
+
+      if (i != None) {
+        result._lb[r] = this->_lb[i];
+        result._ub[r] = this->_ub[i];
+        for (const auto& e : this->_succ[i]) {
+          result.set_edge(r, this_res[e.first], e.second);
+        }
+      }
+      if (j != None) {
+        // Only refine infinite bounds and missing edges
+        if (result._lb[r].is_minus_infinity()) {
+          result._lb[r] = other._lb[j];
+        }
+        if (result._ub[r].is_plus_infinity()) {
+          result._ub[r] = other._ub[j];
+        }
+        for (const auto& e : other._succ[j]) {
+          VertexIndex s = other_res[e.first];
+          if (result.edge(r, s) == nullptr) {
+            result.set_edge(r, s, e.second);
+          }
+        }
+      }
+    }
+
+    result._is_normalized = false;
+    return result;
+  }
+
+  void narrow_with(const SplitDBM& other) override {
+    this->operator=(this->narrowing(other));
+  }
+
+private:
+  /// \brief Apply x = y + c
+  void assign_add(VariableRef x, VariableRef y, const Number& c) {
+    VertexIndex i = this->var_index(x);
+
+    if (x == y) { // x = x + c
+      this->increment(i, c);
+      return;
+    }
+
+    VertexIndex j = this->var_index(y);
+    this->forget(i);
+    if (this->_is_bottom) {
+      return;
+    }
+    this->add_constraint(i, j, c);
+    this->add_constraint(j, i, -c);
+  }
+
+public:
+  void assign(VariableRef x, int n) override { this->assign(x, Number(n)); }
+
+  void assign(VariableRef x, const Number& n) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    VertexIndex i = this->var_index(x);
+    this->forget(i);
+    if (this->_is_bottom) {
+      return;
+    }
+    this->add_constraint(i, Zero, n);
+    this->add_constraint(Zero, i, -n);
+  }
+
+  void assign(VariableRef x, VariableRef y) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    this->assign_add(x, y, Number(0));
+  }
+
+  void assign(VariableRef x, const LinearExpressionT& e) override {
+    // Does not require normalization
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (e.is_constant()) { // x = c
+      this->assign(x, e.constant());
+      return;
+    }
+
+    if (e.num_terms() == 1 && e.begin()->second == 1) { // x = y + c
+      this->assign_add(x, e.begin()->first, e.constant());
+      return;
+    }
+
+    // Projection using intervals, requires normalization
+    this->normalize();
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    this->set(x, this->to_interval(e));
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             VariableRef z) override {
+    // Requires normalization
+    this->normalize();
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    IntervalT v_y = this->to_interval(y);
+    IntervalT v_z = this->to_interval(z);
+
+    if (v_z.singleton()) {
+      this->apply(op, x, y, *v_z.singleton());
+    } else if (v_y.singleton()) {
+      this->apply(op, x, *v_y.singleton(), z);
+    } else {
+      this->set(x, apply_bin_operator(op, v_y, v_z));
+    }
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             const Number& z) override {
+    // Does not require normalization
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    switch (op) {
+      case BinaryOperator::Add: { // x = y + z
+        this->assign_add(x, y, z);
+      } break;
+      case BinaryOperator::Sub: { // x = y - z
+        this->assign_add(x, y, -z);
+      } break;
+      case BinaryOperator::Mul: {
+        if (z == 1) { // x = y
+          this->assign(x, y);
+        } else {
+          // Requires normalization
+          this->normalize();
+
+          if (this->_is_bottom) {
+            return;
+          }
+
+          this->set(x, this->to_interval(y) * IntervalT(z));
+        }
+      } break;
+      case BinaryOperator::Div: {
+        if (z == 1) { // x = y
+          this->assign(x, y);
+        } else {
+          // Requires normalization
+          this->normalize();
+
+          if (this->_is_bottom) {
+            return;
+          }
+
+          this->set(x, this->to_interval(y) / IntervalT(z));
+        }
+      } break;
+      case BinaryOperator::Mod: {
+        if (z == 0) {
+          this->set_to_bottom();
+          return;
+        }
+
+        // Requires normalization
+        this->normalize();
+
+        if (this->_is_bottom) {
+          return;
+        }
+
+        IntervalT v_y = this->to_interval(y);
+        boost::optional< Number > n = v_y.mod_to_sub(z);
+
+        if (n) {
+          // Equivalent to x = y - n
+          this->assign_add(x, y, -(*n));
+        } else {
+          this->set(x, IntervalT(BoundT(0), BoundT(abs(z) - 1)));
+
+          // If y < abs(z) then x >= y
+          if (v_y.ub() < BoundT(abs(z))) {
+            VertexIndex i = this->var_index(x);
+            VertexIndex j = this->var_index(y);
+            this->add_constraint(j, i, BoundT(0));
+          }
+
+          // If y >= -abs(z) then x <= y + abs(z)
+          if (v_y.lb() >= BoundT(-abs(z))) {
+            VertexIndex i = this->var_index(x);
+            VertexIndex j = this->var_index(y);
+            this->add_constraint(i, j, BoundT(abs(z)));
+          }
+        }
+      } break;
+      case BinaryOperator::Rem:
+      case BinaryOperator::Shl:
+      case BinaryOperator::Shr:
+      case BinaryOperator::And:
+      case BinaryOperator::Or:
+      case BinaryOperator::Xor: {
+        // Requires normalization
+        this->normalize();
+
+        if (this->_is_bottom) {
+          return;
+        }
+
+        this->set(x,
+                  apply_bin_operator(op, this->to_interval(y), IntervalT(z)));
+      } break;
+    }
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             const Number& y,
+             VariableRef z) override {
+    // Does not require normalization
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    switch (op) {
+      case BinaryOperator::Add: { // x = y + z
+        this->assign_add(x, z, y);
+      } break;
+      case BinaryOperator::Mul: {
+        if (y == 1) { // x = z
+          this->assign(x, z);
+        } else {
+          // Requires normalization
+          this->normalize();
+
+          if (this->_is_bottom) {
+            return;
+          }
+
+          this->set(x, IntervalT(y) * this->to_interval(z));
+        }
+      } break;
+      case BinaryOperator::Sub:
+      case BinaryOperator::Div:
+      case BinaryOperator::Rem:
+      case BinaryOperator::Mod:
+      case BinaryOperator::Shl:
+      case BinaryOperator::Shr:
+      case BinaryOperator::And:
+      case BinaryOperator::Or:
+      case BinaryOperator::Xor: {
+        // Requires normalization
+        this->normalize();
+
+        if (this->_is_bottom) {
+          return;
+        }
+
+        this->set(x,
+                  apply_bin_operator(op, IntervalT(y), this->to_interval(z)));
+      } break;
+    }
+  }
+
+private:
+  /// \brief Add a constraint of the form `+/-x <= c`, `x - y <= c` or the
+  /// equivalent equalities
+  ///
+  /// Return false if the constraint is not of this form.
+  bool add_difference_constraint(const LinearConstraintT& cst) {
+    if (!cst.is_inequality() && !cst.is_equality()) {
+      return false;
+    }
+
+    auto it = cst.begin();
+    auto it2 = ++cst.begin();
+    VertexIndex i, j;
+    const Number& c = cst.constant();
+
+    if (cst.num_terms() == 1 && it->second == 1) {
+      i = this->var_index(it->first);
+      j = Zero;
+    } else if (cst.num_terms() == 1 && it->second == -1) {
+      i = Zero;
+      j = this->var_index(it->first);
+    } else if (cst.num_terms() == 2 && it->second == 1 && it2->second == -1) {
+      i = this->var_index(it->first);
+      j = this->var_index(it2->first);
+    } else if (cst.num_terms() == 2 && it->second == -1 && it2->second == 1) {
+      i = this->var_index(it2->first);
+      j = this->var_index(it->first);
+    } else {
+      return false;
+    }
+
+    this->add_constraint(i, j, c);
+    if (cst.is_equality()) {
+      this->add_constraint(j, i, -c);
+    }
+    return true;
+  }
+
+public:
+  void add(const LinearConstraintT& cst) override {
+    // Does not require normalization
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (cst.num_terms() == 0) {
+      if (cst.is_contradiction()) {
+        this->set_to_bottom();
+      }
+      return;
+    }
+
+    if (this->add_difference_constraint(cst)) {
+      return;
+    }
+
+    // use the linear interval solver
+    this->normalize();
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    LinearIntervalSolverT solver(MaxReductionCycles);
+    solver.add(cst);
+    solver.run(*this);
+  }
+
+  void add(const LinearConstraintSystemT& csts) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    LinearIntervalSolverT solver(MaxReductionCycles);
+
+    for (const LinearConstraintT& cst : csts) {
+      if (cst.num_terms() == 0) {
+        if (cst.is_contradiction()) {
+          this->set_to_bottom();
+          return;
+        }
+      } else if (!this->add_difference_constraint(cst)) {
+        solver.add(cst);
+      }
+
+      if (this->_is_bottom) {
+        return;
+      }
+    }
+
+    if (!solver.empty()) {
+      // use the linear interval solver
+      this->normalize();
+
+      if (this->_is_bottom) {
+        return;
+      }
+
+      solver.run(*this);
+    }
+  }
+
+  void set(VariableRef x, const IntervalT& value) override {
+    if (this->_is_bottom) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      VertexIndex i = this->var_index(x);
+      this->forget(i);
+      if (this->_is_bottom) {
+        return;
+      }
+      this->add_constraint(i, Zero, value.ub());
+      this->add_constraint(Zero, i, -value.lb());
+    }
+  }
+
+  void set(VariableRef x, const CongruenceT& value) override {
+    if (this->_is_bottom) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      boost::optional< Number > n = value.singleton();
+      if (n) {
+        this->assign(x, *n);
+      } else {
+        this->forget(x);
+      }
+    }
+  }
+
+  void set(VariableRef x, const IntervalCongruenceT& value) override {
+    this->set(x, value.interval());
+  }
+
+  void refine(VariableRef x, const IntervalT& value) override {
+    if (this->_is_bottom) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      VertexIndex i = this->var_index(x);
+      this->add_constraint(i, Zero, value.ub());
+      this->add_constraint(Zero, i, -value.lb());
+    }
+  }
+
+  void refine(VariableRef x, const CongruenceT& value) override {
+    if (this->is_bottom()) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      IntervalCongruenceT iv(this->to_interval(x), value);
+      this->refine(x, iv.interval());
+    }
+  }
+
+  void refine(VariableRef x, const IntervalCongruenceT& value) override {
+    if (this->is_bottom()) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      IntervalCongruenceT iv(this->to_interval(x));
+      iv.meet_with(value);
+      this->refine(x, iv.interval());
+    }
+  }
+
+  void forget(VariableRef x) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    auto it = this->_var_index_map.find(x);
+    if (it != this->_var_index_map.end()) {
+      VertexIndex i = it->second;
+      this->forget(i);
+      if (this->_is_bottom) {
+        return;
+      }
+      this->_var_index_map.erase(it);
+      this->_free_vertices.push_back(i);
+    }
+  }
+
+private:
+  struct GetVar {
+    const VariableRef& operator()(
+        const std::pair< VariableRef, VertexIndex >& p) const {
+      return p.first;
+    }
+  };
+
+public:
+  /// \brief Iterator over a list of variables
+  using VariableIterator =
+      boost::transform_iterator< GetVar, typename VarIndexMap::const_iterator >;
+
+  /// \brief Begin iterator over the list of variables
+  VariableIterator var_begin() const {
+    return boost::make_transform_iterator(this->_var_index_map.cbegin(),
+                                          GetVar());
+  }
+
+  /// \brief End iterator over the list of variables
+  VariableIterator var_end() const {
+    return boost::make_transform_iterator(this->_var_index_map.cend(),
+                                          GetVar());
+  }
+
+  IntervalT to_interval(VariableRef x) const override {
+    // Requires normalization
+    this->normalize();
+
+    if (this->_is_bottom) {
+      return IntervalT::bottom();
+    } else {
+      auto it = this->_var_index_map.find(x);
+
+      if (it == this->_var_index_map.cend()) {
+        return IntervalT::top();
+      } else {
+        return IntervalT(this->_lb[it->second], this->_ub[it->second]);
+      }
+    }
+  }
+
+  IntervalT to_interval(const LinearExpressionT& e) const override {
+    return Parent::to_interval(e);
+  }
+
+  CongruenceT to_congruence(VariableRef x) const override {
+    boost::optional< Number > n = this->to_interval(x).singleton();
+    if (this->_is_bottom) {
+      return CongruenceT::bottom();
+    } else if (n) {
+      return CongruenceT(*n);
+    } else {
+      return CongruenceT::top();
+    }
+  }
+
+  CongruenceT to_congruence(const LinearExpressionT& e) const override {
+    return Parent::to_congruence(e);
+  }
+
+  IntervalCongruenceT to_interval_congruence(VariableRef x) const override {
+    return IntervalCongruenceT(this->to_interval(x));
+  }
+
+  IntervalCongruenceT to_interval_congruence(
+      const LinearExpressionT& e) const override {
+    return Parent::to_interval_congruence(e);
+  }
+
+  LinearConstraintSystemT to_linear_constraint_system() const override {
+    this->normalize();
+
+    if (this->_is_bottom) {
+      return LinearConstraintSystemT(LinearConstraintT::contradiction());
+    }
+
+    // Variable of each vertex
+    std::vector< const VariableRef* > vars(this->num_vertices(), nullptr);
+    for (const auto& p : this->_var_index_map) {
+      vars[p.second] = &p.first;
+    }
+
+    LinearConstraintSystemT csts;
+    for (const auto& p : this->_var_index_map) {
+      VertexIndex i = p.second;
+      csts.add(within_interval(p.first,
+                               IntervalT(this->_lb[i], this->_ub[i])));
+
+      for (const auto& e : this->_succ[i]) {
+        csts.add(VariableExprT(*vars[e.first]) - VariableExprT(p.first) <=
+                 e.second);
+      }
+    }
+
+    return csts;
+  }
+
+  void dump(std::ostream& o) const override {
+    this->to_linear_constraint_system().dump(o);
+  }
+
+  static std::string name() { return "split dbm"; }
+
+}; // end class SplitDBM
+
+template < typename Number,
+           typename VariableRef,
+           std::size_t MaxReductionCycles >
+constexpr typename SplitDBM< Number, VariableRef, MaxReductionCycles >::
+    VertexIndex SplitDBM< Number, VariableRef, MaxReductionCycles >::None;
+
+template < typename Number,
+           typename VariableRef,
+           std::size_t MaxReductionCycles >
+constexpr typename SplitDBM< Number, VariableRef, MaxReductionCycles >::
+    VertexIndex SplitDBM< Number, VariableRef, MaxReductionCycles >::Zero;
+
+} // end namespace numeric
+} // end namespace core
+} // end namespace ikos
@@ -0,0 +1,1079 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Abstract domain using fixed variable packs
+ *
+ * Implementation of an abstract domain using a fixed set of variable packs,
+ * computed before the analysis by a syntactic pre-analysis, to bound the cost
+ * of a relational abstract domain.
+ *
+ * Based on Bruno Blanchet, Patrick Cousot, Radhia Cousot, Jerome Feret,
+ * Laurent Mauborgne, Antoine Mine, David Monniaux and Xavier Rival's paper:
+ * A Static Analyzer for Large Safety-Critical Software, in PLDI, 196-207,
+ * 2003.
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <ikos/core/domain/numeric/abstract_domain.hpp>
+#include <ikos/core/semantic/indexable.hpp>
+#include <ikos/core/support/assert.hpp>
+#include <ikos/core/value/numeric/congruence.hpp>
+#include <ikos/core/value/numeric/interval.hpp>
+#include <ikos/core/value/numeric/interval_congruence.hpp>
+
+namespace ikos {
+namespace core {
+namespace numeric {
+
+/// \brief Fixed partition of variables into packs
+///
+/// Each pack is identified by a representative variable. Variables that were
+/// never packed are implicitly in their own singleton pack.
+///
+/// Packs are built before the analysis using `pack()` and are never merged
+/// afterwards. The size of a pack is bounded by `max_pack_size()`.
+template < typename VariableRef >
+class VariablePacking {
+private:
+  /// \brief Hash function for VariableRef
+  struct VariableRefHash {
+    std::size_t operator()(VariableRef v) const {
+      return IndexableTraits< VariableRef >::index(v);
+    }
+  };
+
+  /// \brief Map from variable to the representative of its pack
+  using RepresentativeMap =
+      std::unordered_map< VariableRef, VariableRef, VariableRefHash >;
+
+  /// \brief Map from representative to the list of variables in the pack
+  using PackMap = std::
+      unordered_map< VariableRef, std::vector< VariableRef >, VariableRefHash >;
+
+public:
+  /// \brief Iterator over the non-singleton packs
+  using Iterator = typename PackMap::const_iterator;
+
+private:
+  /// \brief Maximum number of variables in a pack
+  std::size_t _max_pack_size;
+
+  /// \brief Representative of each packed variable
+  RepresentativeMap _representatives;
+
+  /// \brief Variables of each non-singleton pack
+  PackMap _packs;
+
+  // Note: We are using find() and emplace() instead of operator[](key) because
+  // VariableRef may not have a default constructor
+
+public:
+  /// \brief Create a packing where all variables are in singleton packs
+  explicit VariablePacking(std::size_t max_pack_size)
+      : _max_pack_size(max_pack_size) {}
+
+  /// \brief Copy constructor
+  VariablePacking(const VariablePacking&) = default;
+
+  /// \brief Move constructor
+  VariablePacking(VariablePacking&&) = default;
+
+  /// \brief Copy assignment operator
+  VariablePacking& operator=(const VariablePacking&) = default;
+
+  /// \brief Move assignment operator
+  VariablePacking& operator=(VariablePacking&&) = default;
+
+  /// \brief Destructor
+  ~VariablePacking() = default;
+
+  /// \brief Return the maximum number of variables in a pack
+  std::size_t max_pack_size() const { return this->_max_pack_size; }
+
+  /// \brief Return the representative of the pack containing `v`
+  VariableRef representative(VariableRef v) const {
+    auto it = this->_representatives.find(v);
+    if (it != this->_representatives.end()) {
+      return it->second;
+    } else {
+      return v;
+    }
+  }
+
+  /// \brief Return true if `x` and `y` are in the same pack
+  bool same_pack(VariableRef x, VariableRef y) const {
+    return this->representative(x) == this->representative(y);
+  }
+
+  /// \brief Return the number of variables in the pack of representative `r`
+  std::size_t pack_size(VariableRef r) const {
+    auto it = this->_packs.find(r);
+    if (it != this->_packs.end()) {
+      return it->second.size();
+    } else {
+      return 1;
+    }
+  }
+
+  /// \brief Merge the packs containing `x` and `y`
+  ///
+  /// Return false if the merged pack would exceed the maximum pack size, in
+  /// which case the packing is left unchanged.
+  bool pack(VariableRef x, VariableRef y) {
+    VariableRef x_root = this->representative(x);
+    VariableRef y_root = this->representative(y);
+
+    if (x_root == y_root) {
+      return true;
+    }
+
+    std::size_t x_size = this->pack_size(x_root);
+    std::size_t y_size = this->pack_size(y_root);
+
+    if (x_size + y_size > this->_max_pack_size) {
+      return false;
+    }
+
+    // Merge the smallest pack into the biggest one
+    if (x_size < y_size) {
+      std::swap(x_root, y_root);
+    }
+
+    std::vector< VariableRef > y_vars = this->extract_pack(y_root);
+    std::vector< VariableRef >& x_vars = this->find_or_create_pack(x_root);
+    for (VariableRef v : y_vars) {
+      auto it = this->_representatives.find(v);
+      if (it != this->_representatives.end()) {
+        it->second = x_root;
+      } else {
+        this->_representatives.emplace(v, x_root);
+      }
+      x_vars.push_back(v);
+    }
+
+    return true;
+  }
+
+  /// \brief Return the number of non-singleton packs
+  std::size_t num_packs() const { return this->_packs.size(); }
+
+  /// \brief Begin iterator over the non-singleton packs
+  Iterator begin() const { return this->_packs.cbegin(); }
+
+  /// \brief End iterator over the non-singleton packs
+  Iterator end() const { return this->_packs.cend(); }
+
+private:
+  /// \brief Return the variables of the pack of representative `r`, creating
+  /// the pack if it is a singleton
+  std::vector< VariableRef >& find_or_create_pack(VariableRef r) {
+    auto it = this->_packs.find(r);
+    if (it == this->_packs.end()) {
+      it = this->_packs.emplace(r, std::vector< VariableRef >{r}).first;
+      this->_representatives.emplace(r, r);
+    }
+    return it->second;
+  }
+
+  /// \brief Remove the pack of representative `r` and return its variables
+  std::vector< VariableRef > extract_pack(VariableRef r) {
+    auto it = this->_packs.find(r);
+    if (it == this->_packs.end()) {
+      return {r};
+    }
+    std::vector< VariableRef > vars = std::move(it->second);
+    this->_packs.erase(it);
+    return vars;
+  }
+
+public:
+  /// \brief Dump the packing, for debugging purpose
+  void dump(std::ostream& o) const {
+    o << "{";
+    for (auto it = this->_packs.begin(), et = this->_packs.end(); it != et;) {
+      o << "{";
+      for (auto v_it = it->second.begin(), v_et = it->second.end();
+           v_it != v_et;) {
+        DumpableTraits< VariableRef >::dump(o, *v_it);
+        ++v_it;
+        if (v_it != v_et) {
+          o << ", ";
+        }
+      }
+      o << "}";
+      ++it;
+      if (it != et) {
+        o << ", ";
+      }
+    }
+    o << "}";
+  }
+
+}; // end class VariablePacking
+
+/// \brief Generic abstract domain with fixed variable packs
+///
+/// Unlike VarPackingDomain, the packs are given by a VariablePacking computed
+/// before the analysis and are never merged. Each pack holds an abstract domain
+/// over the variables of the pack. Relations between variables of different
+/// packs are lost: a variable outside of the pack of the assigned or
+/// constrained variable is abstracted by its interval.
+template < typename Number, typename VariableRef, typename Domain >
+class StaticVarPackingDomain final
+    : public numeric::AbstractDomain<
+          Number,
+          VariableRef,
+          StaticVarPackingDomain< Number, VariableRef, Domain > > {
+public:
+  static_assert(numeric::IsAbstractDomain< Domain, Number, VariableRef >::value,
+                "Domain must be a numerical abstract domain");
+
+public:
+  using IntervalT = Interval< Number >;
+  using CongruenceT = Congruence< Number >;
+  using IntervalCongruenceT = IntervalCongruence< Number >;
+  using LinearExpressionT = LinearExpression< Number, VariableRef >;
+  using LinearConstraintT = LinearConstraint< Number, VariableRef >;
+  using LinearConstraintSystemT = LinearConstraintSystem< Number, VariableRef >;
+  using VariablePackingT = VariablePacking< VariableRef >;
+  using VariablePackingPtr = std::shared_ptr< const VariablePackingT >;
+
+private:
+  /// \brief Shared pointer on the underlying abstract domain
+  using DomainPtr = std::shared_ptr< Domain >;
+
+  /// \brief Hash function for VariableRef
+  struct VariableRefHash {
+    std::size_t operator()(VariableRef v) const {
+      return IndexableTraits< VariableRef >::index(v);
+    }
+  };
+
+  /// \brief Map from pack representative to abstract domain
+  ///
+  /// A missing pack is top.
+  using PackMap = std::unordered_map< VariableRef, DomainPtr, VariableRefHash >;
+
+  /// \brief Parent class
+  using Parent =
+      numeric::AbstractDomain< Number, VariableRef, StaticVarPackingDomain >;
+
+private:
+  bool _is_bottom;
+  bool _is_normalized;
+  VariablePackingPtr _packing;
+  PackMap _packs;
+
+  // Note: The reason why sometimes we explicitly call domain->normalize() is
+  // because it is better to normalize a (probably) shared domain. If we don't
+  // do that, some methods will normalize a copy.
+
+private:
+  struct TopTag {};
+  struct BottomTag {};
+
+  /// \brief Create the top abstract value
+  StaticVarPackingDomain(TopTag, VariablePackingPtr packing)
+      : _is_bottom(false),
+        _is_normalized(true),
+        _packing(std::move(packing)) {}
+
+  /// \brief Create the bottom abstract value
+  StaticVarPackingDomain(BottomTag, VariablePackingPtr packing)
+      : _is_bottom(true),
+        _is_normalized(true),
+        _packing(std::move(packing)) {}
+
+public:
+  /// \brief Create the top abstract value, where each variable is in its own
+  /// pack
+  StaticVarPackingDomain() : StaticVarPackingDomain(TopTag{}, nullptr) {}
+
+  /// \brief Copy constructor
+  StaticVarPackingDomain(const StaticVarPackingDomain&) = default;
+
+  /// \brief Move constructor
+  StaticVarPackingDomain(StaticVarPackingDomain&&) = default;
+
+  /// \brief Copy assignment operator
+  StaticVarPackingDomain& operator=(const StaticVarPackingDomain&) = default;
+
+  /// \brief Move assignment operator
+  StaticVarPackingDomain& operator=(StaticVarPackingDomain&&) = default;
+
+  /// \brief Destructor
+  ~StaticVarPackingDomain() override = default;
+
+  /// \brief Create the top abstract value
+  static StaticVarPackingDomain top() {
+    return StaticVarPackingDomain(TopTag{}, nullptr);
+  }
+
+  /// \brief Create the bottom abstract value
+  static StaticVarPackingDomain bottom() {
+    return StaticVarPackingDomain(BottomTag{}, nullptr);
+  }
+
+  /// \brief Create the top abstract value with the given packing
+  static StaticVarPackingDomain top(VariablePackingPtr packing) {
+    return StaticVarPackingDomain(TopTag{}, std::move(packing));
+  }
+
+  /// \brief Create the bottom abstract value with the given packing
+  static StaticVarPackingDomain bottom(VariablePackingPtr packing) {
+    return StaticVarPackingDomain(BottomTag{}, std::move(packing));
+  }
+
+  /// \brief Return the variable packing
+  const VariablePackingPtr& packing() const { return this->_packing; }
+
+private:
+  /// \brief Return the representative of the pack containing `v`
+  VariableRef representative(VariableRef v) const {
+    if (this->_packing) {
+      return this->_packing->representative(v);
+    } else {
+      return v;
+    }
+  }
+
+  /// \brief Return the abstract domain of the pack containing `v`, or nullptr
+  /// if the pack is top
+  const Domain* find_pack(VariableRef v) const {
+    auto it = this->_packs.find(this->representative(v));
+    if (it != this->_packs.end()) {
+      return it->second.get();
+    } else {
+      return nullptr;
+    }
+  }
+
+  /// \brief Return the abstract domain of the pack containing `v`, ready to be
+  /// updated
+  Domain& pack(VariableRef v) {
+    VariableRef r = this->representative(v);
+    auto it = this->_packs.find(r);
+    if (it == this->_packs.end()) {
+      it = this->_packs.emplace(r, std::make_shared< Domain >()).first;
+    } else if (it->second.use_count() > 1) {
+      // XXX(marthaud): This is not thread safe.
+      it->second = std::make_shared< Domain >(*it->second);
+    }
+    this->_is_normalized = false;
+    return *it->second;
+  }
+
+  /// \brief Use the packing of `other` if `this` does not hold any pack yet
+  void merge_packing(const StaticVarPackingDomain& other) {
+    if (this->_packing == other._packing) {
+      return;
+    }
+    if (this->_packs.empty()) {
+      this->_packing = other._packing;
+    } else {
+      ikos_assert_msg(other._packs.empty(), "incompatible variable packings");
+    }
+  }
+
+public:
+  void normalize() const override {
+    if (this->_is_normalized) {
+      return;
+    }
+
+    auto self = const_cast< StaticVarPackingDomain* >(this);
+
+    if (this->_is_bottom) {
+      self->set_to_bottom();
+      return;
+    }
+
+    for (const auto& p : this->_packs) {
+      p.second->normalize();
+
+      if (p.second->is_bottom()) {
+        self->set_to_bottom();
+        return;
+      }
+    }
+
+    self->_is_normalized = true;
+  }
+
+  bool is_bottom() const override {
+    this->normalize();
+    return this->_is_bottom;
+  }
+
+  bool is_top() const override {
+    // Does not require normalization
+
+    if (this->_is_bottom) {
+      return false;
+    }
+
+    for (const auto& p : this->_packs) {
+      if (!p.second->is_top()) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  void set_to_bottom() override {
+    this->_is_bottom = true;
+    this->_is_normalized = true;
+    this->_packs.clear();
+  }
+
+  void set_to_top() override {
+    this->_is_bottom = false;
+    this->_is_normalized = true;
+    this->_packs.clear();
+  }
+
+  bool leq(const StaticVarPackingDomain& other) const override {
+    // Requires normalization
+    this->normalize();
+    other.normalize();
+
+    if (this->is_bottom()) {
+      return true;
+    } else if (other.is_bottom()) {
+      return false;
+    } else {
+      ikos_assert_msg(this->_packs.empty() || other._packs.empty() ||
+                          this->_packing == other._packing,
+                      "incompatible variable packings");
+
+      for (const auto& other_pack : other._packs) {
+        auto it = this->_packs.find(other_pack.first);
+
+        if (it == this->_packs.end()) {
+          if (!other_pack.second->is_top()) {
+            return false;
+          }
+        } else if (it->second == other_pack.second) {
+          // this_pack.leq(other_pack) is true
+        } else if (!it->second->leq(*other_pack.second)) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+  }
+
+  bool equals(const StaticVarPackingDomain& other) const override {
+    return this->leq(other) && other.leq(*this);
+  }
+
+private:
+  /// \brief Apply a binary operation using a union semantic (join, widening)
+  ///
+  /// Packs that are missing on one side are top, hence dropped.
+  template < typename BinaryOperator >
+  StaticVarPackingDomain union_binary_op(const StaticVarPackingDomain& other,
+                                         const BinaryOperator& op) const {
+    StaticVarPackingDomain result(TopTag{}, this->_packing);
+    result.merge_packing(other);
+
+    for (const auto& this_pack : this->_packs) {
+      auto it = other._packs.find(this_pack.first);
+
+      if (it == other._packs.end()) {
+        continue;
+      } else if (this_pack.second == it->second) {
+        // nothing to do, left and right packs are the same
+        result._packs.emplace(this_pack.first, this_pack.second);
+      } else {
+        DomainPtr domain = std::make_shared< Domain >();
+        op(*domain, *this_pack.second, *it->second);
+        result._packs.emplace(this_pack.first, std::move(domain));
+      }
+    }
+
+    result._is_normalized = false;
+    return result;
+  }
+
+  /// \brief Binary operation using an intersection semantic (meet, narrowing)
+  ///
+  /// Packs that are missing on one side are top, hence kept from the other
+  /// side.
+  template < typename BinaryOperator >
+  StaticVarPackingDomain meet_binary_op(const StaticVarPackingDomain& other,
+                                        const BinaryOperator& op) const {
+    StaticVarPackingDomain result(*this);
+    result.merge_packing(other);
+
+    for (const auto& other_pack : other._packs) {
+      auto it = result._packs.find(other_pack.first);
+
+      if (it == result._packs.end()) {
+        result._packs.emplace(other_pack.first, other_pack.second);
+      } else if (it->second == other_pack.second) {
+        // nothing to do, left and right packs are the same
+      } else {
+        DomainPtr domain = std::make_shared< Domain >();
+        op(*domain, *it->second, *other_pack.second);
+        it->second = std::move(domain);
+      }
+    }
+
+    result._is_normalized = false;
+    return result;
+  }
+
+  struct JoinOperator {
+    void operator()(Domain& result, Domain& left, Domain& right) const {
+      left.normalize();
+      right.normalize();
+      result = left.join(right);
+    }
+  };
+
+  struct MeetOperator {
+    void operator()(Domain& result, Domain& left, Domain& right) const {
+      left.normalize();
+      right.normalize();
+      result = left.meet(right);
+    }
+  };
+
+  struct WideningOperator {
+    void operator()(Domain& result, Domain& left, Domain& right) const {
+      right.normalize();
+      result = left.widening(right);
+    }
+  };
+
+  struct WideningThresholdOperator {
+    const Number& threshold;
+
+    void operator()(Domain& result, Domain& left, Domain& right) const {
+      right.normalize();
+      result = left.widening_threshold(right, threshold);
+    }
+  };
+
+  struct NarrowingOperator {
+    void operator()(Domain& result, Domain& left, Domain& right) const {
+      left.normalize();
+      right.normalize();
+      result = left.narrowing(right);
+    }
+  };
+
+public:
+  StaticVarPackingDomain join(
+      const StaticVarPackingDomain& other) const override {
+    // Requires normalization
+    this->normalize();
+    other.normalize();
+
+    if (this->is_bottom()) {
+      return other;
+    } else if (other.is_bottom()) {
+      return *this;
+    } else {
+      return this->union_binary_op(other, JoinOperator{});
+    }
+  }
+
+  void join_with(const StaticVarPackingDomain& other) override {
+    this->operator=(this->join(other));
+  }
+
+  StaticVarPackingDomain widening(
+      const StaticVarPackingDomain& other) const override {
+    // Requires the normalization of the right operand.
+    // The left operand (this) should not be normalized.
+    other.normalize();
+
+    if (this->_is_bottom) {
+      return other;
+    } else if (other.is_bottom()) {
+      return *this;
+    } else {
+      return this->union_binary_op(other, WideningOperator{});
+    }
+  }
+
+  void widen_with(const StaticVarPackingDomain& other) override {
+    this->operator=(this->widening(other));
+  }
+
+  StaticVarPackingDomain widening_threshold(
+      const StaticVarPackingDomain& other,
+      const Number& threshold) const override {
+    // Requires the normalization of the right operand.
+    // The left operand (this) should not be normalized.
+    other.normalize();
+
+    if (this->_is_bottom) {
+      return other;
+    } else if (other.is_bottom()) {
+      return *this;
+    } else {
+      return this->union_binary_op(other, WideningThresholdOperator{threshold});
+    }
+  }
+
+  void widen_threshold_with(const StaticVarPackingDomain& other,
+                            const Number& threshold) override {
+    this->operator=(this->widening_threshold(other, threshold));
+  }
+
+  StaticVarPackingDomain meet(
+      const StaticVarPackingDomain& other) const override {
+    // Requires normalization
+    this->normalize();
+    other.normalize();
+
+    if (this->is_bottom() || other.is_bottom()) {
+      return StaticVarPackingDomain(BottomTag{}, this->_packing);
+    } else {
+      return this->meet_binary_op(other, MeetOperator{});
+    }
+  }
+
+  void meet_with(const StaticVarPackingDomain& other) override {
+    this->operator=(this->meet(other));
+  }
+
+  StaticVarPackingDomain narrowing(
+      const StaticVarPackingDomain& other) const override {
+    // Requires normalization
+    this->normalize();
+    other.normalize();
+
+    if (this->is_bottom() || other.is_bottom()) {
+      return StaticVarPackingDomain(BottomTag{}, this->_packing);
+    } else {
+      return this->meet_binary_op(other, NarrowingOperator{});
+    }
+  }
+
+  void narrow_with(const StaticVarPackingDomain& other) override {
+    this->operator=(this->narrowing(other));
+  }
+
+  void assign(VariableRef x, int n) override { this->assign(x, Number(n)); }
+
+  void assign(VariableRef x, const Number& n) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    this->pack(x).assign(x, n);
+  }
+
+  void assign(VariableRef x, VariableRef y) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (x == y) {
+      return;
+    }
+
+    if (this->representative(x) == this->representative(y)) {
+      this->pack(x).assign(x, y);
+    } else {
+      this->set(x, this->to_interval_congruence(y));
+    }
+  }
+
+  void assign(VariableRef x, const LinearExpressionT& e) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (e.is_constant()) {
+      this->assign(x, e.constant());
+      return;
+    }
+
+    // Split `e` into the terms within the pack of `x` and the others
+    VariableRef r = this->representative(x);
+    LinearExpressionT in_pack(e.constant());
+    IntervalT out_pack(0);
+
+    for (const auto& term : e) {
+      if (this->representative(term.first) == r) {
+        in_pack.add(term.second, term.first);
+      } else {
+        out_pack += IntervalT(term.second) * this->to_interval(term.first);
+      }
+    }
+
+    if (out_pack.is_bottom()) {
+      this->set_to_bottom();
+    } else if (auto k = out_pack.singleton()) {
+      in_pack.add(*k);
+      this->pack(x).assign(x, in_pack);
+    } else if (!in_pack.is_constant() && in_pack.factor(x) == 0) {
+      // x = in_pack + out_pack, hence out_pack.lb <= x - in_pack <= out_pack.ub
+      Domain& domain = this->pack(x);
+      domain.forget(x);
+      LinearExpressionT diff(x);
+      diff -= in_pack;
+      if (auto lb = out_pack.lb().number()) {
+        domain.add(diff >= *lb);
+      }
+      if (auto ub = out_pack.ub().number()) {
+        domain.add(diff <= *ub);
+      }
+    } else {
+      this->set(x, this->to_interval(e));
+    }
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             VariableRef z) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    VariableRef r = this->representative(x);
+    if (this->representative(y) == r && this->representative(z) == r) {
+      this->pack(x).apply(op, x, y, z);
+      return;
+    }
+
+    IntervalT v_y = this->to_interval(y);
+    IntervalT v_z = this->to_interval(z);
+
+    if (v_z.singleton()) {
+      this->apply(op, x, y, *v_z.singleton());
+    } else if (v_y.singleton()) {
+      this->apply(op, x, *v_y.singleton(), z);
+    } else if (op == BinaryOperator::Add) {
+      LinearExpressionT e(y);
+      e.add(z);
+      this->assign(x, e);
+    } else if (op == BinaryOperator::Sub) {
+      LinearExpressionT e(y);
+      e.add(-1, z);
+      this->assign(x, e);
+    } else {
+      this->set(x, apply_bin_operator(op, v_y, v_z));
+    }
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             const Number& z) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (this->representative(x) == this->representative(y)) {
+      this->pack(x).apply(op, x, y, z);
+    } else {
+      this->set(x, apply_bin_operator(op, this->to_interval(y), IntervalT(z)));
+    }
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             const Number& y,
+             VariableRef z) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (this->representative(x) == this->representative(z)) {
+      this->pack(x).apply(op, x, y, z);
+    } else {
+      this->set(x, apply_bin_operator(op, IntervalT(y), this->to_interval(z)));
+    }
+  }
+
+  void add(const LinearConstraintT& cst) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (cst.num_terms() == 0) {
+      if (cst.is_contradiction()) {
+        this->set_to_bottom();
+      }
+      return;
+    }
+
+    // Collect the packs of the constraint
+    std::vector< VariableRef > packs;
+    for (const auto& term : cst) {
+      VariableRef r = this->representative(term.first);
+      if (std::find(packs.begin(), packs.end(), r) == packs.end()) {
+        packs.push_back(r);
+      }
+    }
+
+    if (packs.size() == 1) {
+      this->pack(packs[0]).add(cst);
+      return;
+    }
+
+    // The constraint spans several packs: add its projection on each pack,
+    // abstracting the variables of the other packs by their intervals
+    std::vector< IntervalT > intervals;
+    intervals.reserve(cst.num_terms());
+    for (const auto& term : cst) {
+      intervals.push_back(IntervalT(term.second) *
+                          this->to_interval(term.first));
+    }
+
+    for (VariableRef r : packs) {
+      LinearExpressionT in_pack(cst.expression().constant());
+      IntervalT out_pack(0);
+
+      auto itv_it = intervals.begin();
+      for (const auto& term : cst) {
+        if (this->representative(term.first) == r) {
+          in_pack.add(term.second, term.first);
+        } else {
+          out_pack += *itv_it;
+        }
+        ++itv_it;
+      }
+
+      if (out_pack.is_bottom()) {
+        this->set_to_bottom();
+        return;
+      }
+
+      Domain& domain = this->pack(r);
+      boost::optional< Number > lb = out_pack.lb().number();
+      boost::optional< Number > ub = out_pack.ub().number();
+
+      if (cst.is_inequality()) {
+        // in_pack + out_pack <= 0
+        if (lb) {
+          domain.add(in_pack <= -*lb);
+        }
+      } else if (cst.is_equality()) {
+        // in_pack + out_pack == 0
+        if (lb && ub && *lb == *ub) {
+          domain.add(in_pack == -*lb);
+        } else {
+          if (lb) {
+            domain.add(in_pack <= -*lb);
+          }
+          if (ub) {
+            domain.add(in_pack >= -*ub);
+          }
+        }
+      } else if (cst.is_disequation()) {
+        // in_pack + out_pack != 0
+        if (lb && ub && *lb == *ub) {
+          domain.add(LinearConstraintT(in_pack + *lb,
+                                       LinearConstraintT::Disequation));
+        }
+      }
+    }
+  }
+
+  void add(const LinearConstraintSystemT& csts) override {
+    for (const LinearConstraintT& cst : csts) {
+      this->add(cst);
+    }
+  }
+
+private:
+  /// \brief Set the value of `x`
+  template < typename T >
+  void set_value(VariableRef x, const T& value) {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else if (value.is_top()) {
+      this->forget(x);
+    } else {
+      this->pack(x).set(x, value);
+    }
+  }
+
+  /// \brief Refine the value of `x`
+  template < typename T >
+  void refine_value(VariableRef x, const T& value) {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else if (value.is_top()) {
+      return;
+    } else {
+      this->pack(x).refine(x, value);
+    }
+  }
+
+public:
+  void set(VariableRef x, const IntervalT& value) override {
+    this->set_value(x, value);
+  }
+
+  void set(VariableRef x, const CongruenceT& value) override {
+    this->set_value(x, value);
+  }
+
+  void set(VariableRef x, const IntervalCongruenceT& value) override {
+    this->set_value(x, value);
+  }
+
+  void refine(VariableRef x, const IntervalT& value) override {
+    this->refine_value(x, value);
+  }
+
+  void refine(VariableRef x, const CongruenceT& value) override {
+    this->refine_value(x, value);
+  }
+
+  void refine(VariableRef x, const IntervalCongruenceT& value) override {
+    this->refine_value(x, value);
+  }
+
+  void forget(VariableRef x) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (this->find_pack(x) != nullptr) {
+      this->pack(x).forget(x);
+    }
+  }
+
+  IntervalT to_interval(VariableRef x) const override {
+    if (this->_is_bottom) {
+      return IntervalT::bottom();
+    } else if (const Domain* domain = this->find_pack(x)) {
+      domain->normalize();
+      return domain->to_interval(x);
+    } else {
+      return IntervalT::top();
+    }
+  }
+
+  IntervalT to_interval(const LinearExpressionT& e) const override {
+    return Parent::to_interval(e);
+  }
+
+  CongruenceT to_congruence(VariableRef x) const override {
+    if (this->_is_bottom) {
+      return CongruenceT::bottom();
+    } else if (const Domain* domain = this->find_pack(x)) {
+      domain->normalize();
+      return domain->to_congruence(x);
+    } else {
+      return CongruenceT::top();
+    }
+  }
+
+  CongruenceT to_congruence(const LinearExpressionT& e) const override {
+    return Parent::to_congruence(e);
+  }
+
+  IntervalCongruenceT to_interval_congruence(VariableRef x) const override {
+    if (this->_is_bottom) {
+      return IntervalCongruenceT::bottom();
+    } else if (const Domain* domain = this->find_pack(x)) {
+      domain->normalize();
+      return domain->to_interval_congruence(x);
+    } else {
+      return IntervalCongruenceT::top();
+    }
+  }
+
+  IntervalCongruenceT to_interval_congruence(
+      const LinearExpressionT& e) const override {
+    return Parent::to_interval_congruence(e);
+  }
+
+  LinearConstraintSystemT to_linear_constraint_system() const override {
+    this->normalize();
+
+    if (this->is_bottom()) {
+      return LinearConstraintSystemT(LinearConstraintT::contradiction());
+    }
+
+    LinearConstraintSystemT csts;
+    for (const auto& p : this->_packs) {
+      csts.add(p.second->to_linear_constraint_system());
+    }
+
+    return csts;
+  }
+
+  void dump(std::ostream& o) const override {
+    this->to_linear_constraint_system().dump(o);
+  }
+
+  static std::string name() {
+    return Domain::name() + " with static variable packing";
+  }
+
+}; // end class StaticVarPackingDomain
+
+} // end namespace numeric
+} // end namespace core
+} // end namespace ikos
@@ -355,6 +355,14 @@ public:
 
   void forget(VariableRef x) override { this->_inv.forget(x); }
 
+  void forget_vars(const std::vector< VariableRef >& vars) override {
+    this->_inv.forget_vars(vars);
+  }
+
+  void project(const std::vector< VariableRef >& keep) override {
+    this->_inv.project(keep);
+  }
+
   void normalize() const override { this->_inv.normalize(); }
 
   IntervalT to_interval(VariableRef x) const override {
@@ -416,6 +416,14 @@ public:
 
   void forget(VariableRef x) override { this->_product.forget(x); }
 
+  void forget_vars(const std::vector< VariableRef >& vars) override {
+    this->_product.forget_vars(vars);
+  }
+
+  void project(const std::vector< VariableRef >& keep) override {
+    this->_product.project(keep);
+  }
+
   void normalize() const override { this->_product.normalize(); }
 
   IntervalT to_interval(VariableRef x) const override {
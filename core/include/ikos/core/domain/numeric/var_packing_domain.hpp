@@ -53,14 +53,18 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include <boost/container/flat_set.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/optional.hpp>
 
 #include <ikos/core/domain/numeric/abstract_domain.hpp>
+#include <ikos/core/domain/numeric/linear_interval_solver.hpp>
+#include <ikos/core/domain/numeric/operator.hpp>
 #include <ikos/core/semantic/indexable.hpp>
 #include <ikos/core/support/assert.hpp>
 #include <ikos/core/value/numeric/congruence.hpp>
@@ -82,11 +86,54 @@ template < typename Number,
            std::size_t MaxReductionCycles >
 class VarPackingDBMCongruence;
 
+/// \brief Statistics on the packs of the variable packing domains
+struct VarPackingStats {
+  /// \brief Number of variables in the largest pack
+  std::size_t max_pack_size;
+
+  /// \brief Number of relations tracked with intervals because of the maximum
+  /// pack size
+  std::size_t dropped_relations;
+};
+
+/// \brief Settings of the variable packing domains
+///
+/// The maximum pack size is shared by all threads and should be set before
+/// the analysis starts. Statistics are counted per thread.
+class VarPackingSettings {
+public:
+  /// \brief Return the maximum number of variables in a pack, or 0
+  static std::size_t max_pack_size() { return limit(); }
+
+  /// \brief Set the maximum number of variables in a pack
+  ///
+  /// A limit of 0 means that packs are unbounded.
+  static void set_max_pack_size(std::size_t n) { limit() = n; }
+
+  /// \brief Return the statistics of the current thread
+  static VarPackingStats& stats() {
+    static thread_local VarPackingStats stats; // zero-initialized
+    return stats;
+  }
+
+private:
+  /// \brief Return the maximum pack size
+  static std::size_t& limit() {
+    static std::size_t limit = 0;
+    return limit;
+  }
+
+}; // end class VarPackingSettings
+
 /// \brief Generic abstract domain with variable packing
 ///
 /// The idea is to keep a set of equivalence classes, using the union-find
 /// structure. Each equivalence class holds an abstract domain over all
 /// variables within the class.
+///
+/// If a maximum pack size is set (see VarPackingSettings), relations that
+/// would grow a pack past the limit are dropped and the variables are tracked
+/// with intervals in their own packs instead.
 template < typename Number, typename VariableRef, typename Domain >
 class VarPackingDomain final
     : public numeric::AbstractDomain<
@@ -127,6 +174,13 @@ private:
   using RootVariablesMap = std::
       unordered_map< VariableRef, std::vector< VariableRef >, VariableRefHash >;
 
+  /// \brief Linear interval solver used for the dropped constraints
+  using LinearIntervalSolverT =
+      LinearIntervalSolver< Number, VariableRef, VarPackingDomain >;
+
+  /// \brief Maximum number of reduction cycles for the dropped constraints
+  static const std::size_t MaxReductionCycles = 10;
+
   /// \brief Parent class
   using Parent =
       numeric::AbstractDomain< Number, VariableRef, VarPackingDomain >;
@@ -144,6 +198,7 @@ private:
   class EquivalenceClass {
   public:
     std::size_t rank;
+    std::size_t size;
     DomainPtr domain;
 
     // TODO(marthaud): We could store the list of variables in the class
@@ -155,7 +210,7 @@ private:
   public:
     /// \brief Create an empty equivalence class
     explicit EquivalenceClass()
-        : rank(0), domain(std::make_shared< Domain >()) {}
+        : rank(0), size(1), domain(std::make_shared< Domain >()) {}
 
     /// \brief Copy constructor
     EquivalenceClass(const EquivalenceClass&) noexcept = default;
@@ -250,7 +305,9 @@ private:
       if (parent_class.rank == 0) {
         parent_class.rank++;
       }
+      parent_class.size++;
       this->_parents.emplace(v, parent_root);
+      count_pack_size(parent_class.size);
     }
 
     /// \brief Find the root of the equivalence class containing `v`
@@ -315,9 +372,13 @@ private:
       y_class.domain->normalize();
       *merge_domain = (*x_class.domain).meet(*y_class.domain);
 
+      std::size_t size = x_class.size + y_class.size;
+      count_pack_size(size);
+
       if (x_class.rank > y_class.rank) {
         this->_parents.at(y_root) = x_root;
 
+        x_class.size = size;
         x_class.domain.swap(merge_domain);
         this->_classes.erase(y_root);
       } else {
@@ -327,6 +388,7 @@ private:
           y_class.rank++;
         }
 
+        y_class.size = size;
         y_class.domain.swap(merge_domain);
         this->_classes.erase(x_root);
       }
@@ -390,6 +452,7 @@ private:
         }
 
         EquivalenceClass& equiv_class = this->_classes[root];
+        equiv_class.size--;
         equiv_class.copy_domain();
         equiv_class.domain->forget(v);
       } else {
@@ -407,6 +470,7 @@ private:
 
         if (new_root) {
           EquivalenceClass equiv_class = std::move(this->_classes[v]);
+          equiv_class.size--;
           equiv_class.copy_domain();
           equiv_class.domain->forget(v);
           this->_classes.emplace(*new_root, std::move(equiv_class));
@@ -418,6 +482,68 @@ private:
       this->_parents.erase(v);
     }
 
+    /// \brief Forget all the variables satisfying the given predicate
+    ///
+    /// The variables of a pack are forgotten at once in its domain.
+    template < typename Predicate >
+    void forget_if(const Predicate& is_removed) {
+      // Map from root variable to the removed variables of the class
+      RootVariablesMap removed;
+      for (const auto& p : this->_parents) {
+        if (is_removed(p.first)) {
+          removed[this->cfind_root_var(p.first)].push_back(p.first);
+        }
+      }
+
+      if (removed.empty()) {
+        return;
+      }
+
+      // New root of the classes whose root is removed, and new parent of the
+      // remaining variables of the modified classes
+      std::unordered_map< VariableRef, VariableRef, VariableRefHash > new_roots;
+      std::vector< std::pair< VariableRef, VariableRef > > new_parents;
+      for (const auto& p : this->_parents) {
+        if (is_removed(p.first)) {
+          continue;
+        }
+        VariableRef root = this->cfind_root_var(p.first);
+        if (removed.find(root) == removed.end()) {
+          continue;
+        }
+        if (is_removed(root)) {
+          root = new_roots.emplace(root, p.first).first->second;
+        }
+        new_parents.emplace_back(p.first, root);
+      }
+
+      for (auto& p : removed) {
+        EquivalenceClass equiv_class = std::move(this->_classes.at(p.first));
+        this->_classes.erase(p.first);
+
+        if (p.second.size() == equiv_class.size) {
+          continue; // the whole class is removed
+        }
+
+        equiv_class.size -= p.second.size();
+        equiv_class.copy_domain();
+        equiv_class.domain->forget_vars(p.second);
+
+        auto it = new_roots.find(p.first);
+        VariableRef new_root = (it != new_roots.end()) ? it->second : p.first;
+        this->_classes.emplace(new_root, std::move(equiv_class));
+      }
+
+      for (const auto& p : removed) {
+        for (VariableRef v : p.second) {
+          this->_parents.erase(v);
+        }
+      }
+      for (const auto& p : new_parents) {
+        this->_parents.at(p.first) = p.second;
+      }
+    }
+
     /// \brief Forget the equivalence class containing the given variable
     void forget_equiv_class(VariableRef v) {
       if (!this->contains(v)) {
@@ -654,6 +780,78 @@ public:
   }
 
 private:
+  /// \brief Update the statistics with a pack of the given size
+  static void count_pack_size(std::size_t size) {
+    VarPackingStats& stats = VarPackingSettings::stats();
+    stats.max_pack_size = std::max(stats.max_pack_size, size);
+  }
+
+  /// \brief Return true if a pack of the given size exceeds the limit
+  static bool is_over_max_pack_size(std::size_t size) {
+    std::size_t limit = VarPackingSettings::max_pack_size();
+    return limit != 0 && size > limit;
+  }
+
+  /// \brief Return true if a relation between the given variables would grow
+  /// a pack past the maximum pack size
+  ///
+  /// `x` is the variable assigned by the relation, if any. The relation is
+  /// counted as dropped if this returns true.
+  bool exceeds_max_pack_size(const std::vector< VariableRef >& vars,
+                             boost::optional< VariableRef > x) {
+    if (VarPackingSettings::max_pack_size() == 0) {
+      return false;
+    }
+
+    // Roots of the packs to merge, or variables without a pack
+    boost::container::flat_set< VariableRef > roots;
+    std::size_t size = 0;
+
+    for (VariableRef v : vars) {
+      if (this->_equiv_relation.contains(v)) {
+        VariableRef root = this->_equiv_relation.find_root_var(v);
+        if (roots.insert(root).second) {
+          size += this->_equiv_relation.find_equiv_class(root).size;
+        }
+      } else if (roots.insert(v).second) {
+        size++;
+      }
+    }
+
+    if (x) {
+      // The previous value of x is forgotten
+      VariableRef root = this->_equiv_relation.contains(*x)
+                             ? this->_equiv_relation.find_root_var(*x)
+                             : *x;
+      if (roots.find(root) == roots.end()) {
+        size++;
+      }
+    }
+
+    if (!is_over_max_pack_size(size)) {
+      return false;
+    }
+
+    VarPackingSettings::stats().dropped_relations++;
+    return true;
+  }
+
+  /// \brief Return true if a relation between the variables of the given
+  /// linear expression would grow a pack past the maximum pack size
+  bool expression_exceeds_max_pack_size(const LinearExpressionT& e,
+                                        boost::optional< VariableRef > x) {
+    if (VarPackingSettings::max_pack_size() == 0) {
+      return false;
+    }
+
+    std::vector< VariableRef > vars;
+    vars.reserve(e.num_terms());
+    for (const auto& term : e) {
+      vars.push_back(term.first);
+    }
+    return this->exceeds_max_pack_size(vars, x);
+  }
+
   void merge_existing_equiv_classes(boost::optional< VariableRef >& root,
                                     VariableRef v) {
     if (!this->_equiv_relation.contains(v)) {
@@ -729,6 +927,24 @@ private:
         const DomainPtr& other_domain =
             other._equiv_relation.find_domain(other_root);
 
+        if (is_over_max_pack_size(other_class.second.size())) {
+          // Packs of `result` are included in the ones of `other`
+          std::vector< IntervalT > values;
+          values.reserve(other_class.second.size());
+          for (VariableRef v : other_class.second) {
+            values.push_back(
+                op(result.to_interval(v), other_domain->to_interval(v)));
+          }
+          for (VariableRef v : other_class.second) {
+            result.forget_equiv_class(v);
+          }
+          for (std::size_t i = 0; i < values.size(); i++) {
+            result.set(other_class.second[i], values[i]);
+          }
+          VarPackingSettings::stats().dropped_relations++;
+          continue;
+        }
+
         boost::optional< VariableRef > root;
         for (VariableRef v : other_class.second) {
           result.merge_existing_equiv_classes(root, v);
@@ -764,6 +980,17 @@ private:
       const DomainPtr& other_domain =
           other._equiv_relation.cfind_domain(other_root);
 
+      if (result._is_bottom) {
+        break;
+      }
+
+      if (result.exceeds_max_pack_size(other_class.second, boost::none)) {
+        for (VariableRef v : other_class.second) {
+          op(result, v, other_domain->to_interval(v));
+        }
+        continue;
+      }
+
       boost::optional< VariableRef > root;
       for (VariableRef v : other_class.second) {
         result.merge_existing_equiv_classes(root, v);
@@ -793,12 +1020,20 @@ private:
     return result;
   }
 
+  // Union operators also apply on the intervals of a pack exceeding the
+  // maximum pack size. Intersection operators refine the result with the
+  // interval of a variable of such a pack.
+
   struct JoinOperator {
     void operator()(Domain& result, Domain& left, Domain& right) const {
       left.normalize();
       right.normalize();
       result = left.join(right);
     }
+
+    IntervalT operator()(const IntervalT& left, const IntervalT& right) const {
+      return left.join(right);
+    }
   };
 
   struct MeetOperator {
@@ -807,6 +1042,12 @@ private:
       right.normalize();
       result = left.meet(right);
     }
+
+    void operator()(VarPackingDomain& result,
+                    VariableRef v,
+                    const IntervalT& value) const {
+      result.refine(v, value);
+    }
   };
 
   struct WideningOperator {
@@ -814,6 +1055,10 @@ private:
       right.normalize();
       result = left.widening(right);
     }
+
+    IntervalT operator()(const IntervalT& left, const IntervalT& right) const {
+      return left.widening(right);
+    }
   };
 
   struct WideningThresholdOperator {
@@ -823,6 +1068,10 @@ private:
       right.normalize();
       result = left.widening_threshold(right, threshold);
     }
+
+    IntervalT operator()(const IntervalT& left, const IntervalT& right) const {
+      return left.widening_threshold(right, threshold);
+    }
   };
 
   struct NarrowingOperator {
@@ -831,6 +1080,10 @@ private:
       right.normalize();
       result = left.narrowing(right);
     }
+
+    void operator()(VarPackingDomain&, VariableRef, const IntervalT&) const {
+      // Keeping the left operand is a valid narrowing
+    }
   };
 
 public:
@@ -944,6 +1197,11 @@ public:
       return;
     }
 
+    if (this->exceeds_max_pack_size({y}, x)) {
+      this->set(x, this->to_interval(y));
+      return;
+    }
+
     if (!this->_equiv_relation.contains(y)) {
       this->_equiv_relation.add_equiv_class(y);
     }
@@ -967,6 +1225,11 @@ public:
       return;
     }
 
+    if (this->expression_exceeds_max_pack_size(e, x)) {
+      this->set(x, this->to_interval(e));
+      return;
+    }
+
     boost::optional< VariableRef > root;
 
     for (const auto& term : e) {
@@ -1037,6 +1300,14 @@ public:
       return;
     }
 
+    if (this->exceeds_max_pack_size({y, z}, x)) {
+      this->set(x,
+                apply_bin_operator(op,
+                                   this->to_interval(y),
+                                   this->to_interval(z)));
+      return;
+    }
+
     this->add_relation(x, y, z)->apply(op, x, y, z);
     this->_is_normalized = false;
   }
@@ -1049,6 +1320,11 @@ public:
       return;
     }
 
+    if (this->exceeds_max_pack_size({y}, x)) {
+      this->set(x, apply_bin_operator(op, this->to_interval(y), IntervalT(z)));
+      return;
+    }
+
     add_relation(x, y)->apply(op, x, y, z);
     this->_is_normalized = false;
   }
@@ -1061,6 +1337,11 @@ public:
       return;
     }
 
+    if (this->exceeds_max_pack_size({z}, x)) {
+      this->set(x, apply_bin_operator(op, IntervalT(y), this->to_interval(z)));
+      return;
+    }
+
     add_relation(x, z)->apply(op, x, y, z);
     this->_is_normalized = false;
   }
@@ -1077,6 +1358,20 @@ public:
       return;
     }
 
+    if (this->expression_exceeds_max_pack_size(cst.expression(), boost::none)) {
+      // Refine the intervals of the variables instead
+      this->normalize();
+
+      if (this->_is_bottom) {
+        return;
+      }
+
+      LinearIntervalSolverT solver(MaxReductionCycles);
+      solver.add(cst);
+      solver.run(*this);
+      return;
+    }
+
     boost::optional< VariableRef > root;
     for (const auto& term : cst) {
       this->merge_existing_equiv_classes(root, term.first);
@@ -1239,6 +1534,24 @@ public:
     this->_is_normalized = false;
   }
 
+  void forget_vars(const std::vector< VariableRef >& vars) override {
+    std::vector< VariableRef > dropped(vars);
+    std::sort(dropped.begin(), dropped.end());
+    this->_equiv_relation.forget_if([&dropped](VariableRef x) {
+      return std::binary_search(dropped.begin(), dropped.end(), x);
+    });
+    this->_is_normalized = false;
+  }
+
+  void project(const std::vector< VariableRef >& keep) override {
+    std::vector< VariableRef > kept(keep);
+    std::sort(kept.begin(), kept.end());
+    this->_equiv_relation.forget_if([&kept](VariableRef x) {
+      return !std::binary_search(kept.begin(), kept.end(), x);
+    });
+    this->_is_normalized = false;
+  }
+
 private:
   /// \brief Forget the equivalence class containing `x`
   void forget_equiv_class(VariableRef x) {
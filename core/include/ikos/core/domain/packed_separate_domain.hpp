@@ -0,0 +1,376 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Non-relational domains over two-bit lattices, packed in bit vectors
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2011-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include <ikos/core/adt/patricia_tree/map.hpp>
+#include <ikos/core/domain/abstract_domain.hpp>
+#include <ikos/core/semantic/dumpable.hpp>
+#include <ikos/core/semantic/indexable.hpp>
+
+namespace ikos {
+namespace core {
+
+/// \brief Traits for values encoded on two bits
+///
+/// The lattice must be the powerset of two atoms: bit 0 and bit 1 are set if
+/// the value might be the first and second atom respectively. Hence 0b00 is
+/// bottom, 0b11 is top, the join is a bitwise or and the meet a bitwise and.
+///
+/// Elements to provide:
+///
+/// static unsigned encode(const Value&)
+///   Return the encoding of the given value
+///
+/// static Value decode(unsigned)
+///   Return the value for the given encoding
+template < typename Value >
+struct PackedValueTraits {};
+
+/// \brief Non-relational domain of values encoded on two bits
+///
+/// This is equivalent to SeparateDomain< Key, Value >, but values of keys with
+/// consecutive indexes are packed in a 64-bit word, so that the join, meet
+/// and inclusion are bitwise operations on words. Words are stored in a
+/// patricia tree, so copies share unchanged words.
+///
+/// This is best used with keys that have dense indexes.
+template < typename Key, typename Value >
+class PackedSeparateDomain final
+    : public AbstractDomain< PackedSeparateDomain< Key, Value > > {
+public:
+  static_assert(IsIndexable< Key >::value,
+                "Key must implement IndexableTraits");
+  static_assert(std::is_default_constructible< Key >::value,
+                "Key must be default constructible");
+
+private:
+  using ValueTraits = PackedValueTraits< Value >;
+
+  /// \brief Number of keys per word
+  static constexpr unsigned WordKeys = 32;
+
+  /// \brief Word where all keys are top
+  static constexpr uint64_t TopWord = ~static_cast< uint64_t >(0);
+
+  /// \brief Word with the lowest bit of each key set
+  static constexpr uint64_t LowBits = 0x5555555555555555ULL;
+
+  /// \brief Values of 32 keys with consecutive indexes
+  struct Chunk {
+    /// \brief Two bits per key
+    uint64_t word = TopWord;
+
+    /// \brief Keys, used for dumps, only valid for keys that are not top
+    std::array< Key, WordKeys > keys;
+
+    /// \brief Keys of two equal chunks are the same, except for top keys
+    bool operator==(const Chunk& other) const {
+      return this->word == other.word;
+    }
+  };
+
+  using PatriciaTreeMapT = PatriciaTreeMap< Index, Chunk >;
+
+private:
+  PatriciaTreeMapT _tree;
+  bool _is_bottom;
+
+private:
+  struct TopTag {};
+  struct BottomTag {};
+  struct BottomFound {};
+
+  /// \brief Create the top abstract value
+  explicit PackedSeparateDomain(TopTag) : _is_bottom(false) {}
+
+  /// \brief Create the bottom abstract value
+  explicit PackedSeparateDomain(BottomTag) : _is_bottom(true) {}
+
+  /// \brief Return true if a key of the given word is bottom
+  static bool has_bottom(uint64_t word) {
+    return ((~(word | (word >> 1))) & LowBits) != 0;
+  }
+
+  /// \brief Return the position of the given key in its word
+  static unsigned shift(Index idx) {
+    return static_cast< unsigned >(idx % WordKeys) * 2;
+  }
+
+public:
+  /// \brief Create the top abstract value
+  PackedSeparateDomain() : PackedSeparateDomain(TopTag{}) {}
+
+  /// \brief Copy constructor
+  PackedSeparateDomain(const PackedSeparateDomain&) noexcept = default;
+
+  /// \brief Move constructor
+  PackedSeparateDomain(PackedSeparateDomain&&) noexcept = default;
+
+  /// \brief Copy assignment operator
+  PackedSeparateDomain& operator=(const PackedSeparateDomain&) noexcept =
+      default;
+
+  /// \brief Move assignment operator
+  PackedSeparateDomain& operator=(PackedSeparateDomain&&) noexcept = default;
+
+  /// \brief Destructor
+  ~PackedSeparateDomain() override = default;
+
+  /// \brief Create the top abstract value
+  static PackedSeparateDomain top() { return PackedSeparateDomain(TopTag{}); }
+
+  /// \brief Create the bottom abstract value
+  static PackedSeparateDomain bottom() {
+    return PackedSeparateDomain(BottomTag{});
+  }
+
+  bool is_bottom() const override { return this->_is_bottom; }
+
+  bool is_top() const override {
+    return !this->is_bottom() && this->_tree.empty();
+  }
+
+  void set_to_bottom() override {
+    this->_is_bottom = true;
+    this->_tree.clear();
+  }
+
+  void set_to_top() override {
+    this->_is_bottom = false;
+    this->_tree.clear();
+  }
+
+  bool leq(const PackedSeparateDomain& other) const override {
+    if (this->is_bottom()) {
+      return true;
+    } else if (other.is_bottom()) {
+      return false;
+    } else {
+      return this->_tree.leq(other._tree, [](const Chunk& x, const Chunk& y) {
+        return (x.word & ~y.word) == 0;
+      });
+    }
+  }
+
+  bool equals(const PackedSeparateDomain& other) const override {
+    if (this->is_bottom()) {
+      return other.is_bottom();
+    } else if (other.is_bottom()) {
+      return false;
+    } else {
+      return this->_tree.equals(other._tree,
+                                [](const Chunk& x, const Chunk& y) {
+                                  return x.word == y.word;
+                                });
+    }
+  }
+
+  void join_with(const PackedSeparateDomain& other) override {
+    if (other.is_bottom()) {
+      return;
+    } else if (this->is_bottom()) {
+      this->operator=(other);
+    } else {
+      this->_tree.intersect_with(other._tree,
+                                 [](const Chunk& x, const Chunk& y) {
+                                   // Keys that are not top in the result are
+                                   // not top in `x`
+                                   Chunk z = x;
+                                   z.word |= y.word;
+                                   if (z.word == TopWord) {
+                                     return boost::optional< Chunk >(
+                                         boost::none);
+                                   }
+                                   return boost::optional< Chunk >(z);
+                                 });
+    }
+  }
+
+  void widen_with(const PackedSeparateDomain& other) override {
+    this->join_with(other);
+  }
+
+  void meet_with(const PackedSeparateDomain& other) override {
+    if (this->is_bottom()) {
+      return;
+    } else if (other.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      try {
+        this->_tree.join_with(other._tree, [](const Chunk& x, const Chunk& y) {
+          Chunk z = x;
+          z.word &= y.word;
+          if (has_bottom(z.word)) {
+            throw BottomFound();
+          }
+          for (unsigned i = 0; i < WordKeys; i++) {
+            if (((x.word >> (2 * i)) & 3) == 3) {
+              z.keys[i] = y.keys[i];
+            }
+          }
+          return boost::optional< Chunk >(z);
+        });
+      } catch (BottomFound&) {
+        this->set_to_bottom();
+      }
+    }
+  }
+
+  void narrow_with(const PackedSeparateDomain& other) override {
+    this->meet_with(other);
+  }
+
+  /// \brief Set the abstract value of the given key
+  void set(const Key& key, const Value& value) {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->update(key, ValueTraits::encode(value), /*refine=*/false);
+  }
+
+  /// \brief Refine the abstract value of the given key
+  void refine(const Key& key, const Value& value) {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->update(key, ValueTraits::encode(value), /*refine=*/true);
+  }
+
+  /// \brief Forget the abstract value of the given key
+  void forget(const Key& key) {
+    if (this->is_bottom()) {
+      return;
+    }
+    this->update(key, 3, /*refine=*/false);
+  }
+
+  /// \brief Get the abstract value for the given key
+  Value get(const Key& key) const {
+    if (this->is_bottom()) {
+      return Value::bottom();
+    }
+
+    Index idx = IndexableTraits< Key >::index(key);
+    boost::optional< const Chunk& > chunk = this->_tree.at(idx / WordKeys);
+    if (!chunk) {
+      return Value::top();
+    }
+    return ValueTraits::decode(
+        static_cast< unsigned >((chunk->word >> shift(idx)) & 3));
+  }
+
+  void dump(std::ostream& o) const override {
+    static_assert(IsDumpable< Key >::value,
+                  "Key must implement DumpableTraits");
+    if (this->is_bottom()) {
+      o << "⊥";
+      return;
+    }
+
+    o << "{";
+    bool first = true;
+    for (auto it = this->_tree.begin(), et = this->_tree.end(); it != et;
+         ++it) {
+      const Chunk& chunk = it->second;
+      for (unsigned i = 0; i < WordKeys; i++) {
+        auto bits = static_cast< unsigned >((chunk.word >> (2 * i)) & 3);
+        if (bits == 3) {
+          continue;
+        }
+        if (!first) {
+          o << "; ";
+        }
+        first = false;
+        DumpableTraits< Key >::dump(o, chunk.keys[i]);
+        o << " -> ";
+        ValueTraits::decode(bits).dump(o);
+      }
+    }
+    o << "}";
+  }
+
+  static std::string name() {
+    return "packed separate domain of " + Value::name();
+  }
+
+private:
+  /// \brief Set or refine the encoded value of the given key
+  void update(const Key& key, unsigned bits, bool refine) {
+    Index idx = IndexableTraits< Key >::index(key);
+    Index chunk_idx = idx / WordKeys;
+    unsigned pos = shift(idx);
+
+    boost::optional< const Chunk& > prev = this->_tree.at(chunk_idx);
+    if (!prev && bits == 3) {
+      return;
+    }
+
+    Chunk chunk = prev ? *prev : Chunk();
+    if (refine) {
+      bits &= static_cast< unsigned >((chunk.word >> pos) & 3);
+    }
+    if (bits == 0) {
+      this->set_to_bottom();
+      return;
+    }
+
+    chunk.word &= ~(static_cast< uint64_t >(3) << pos);
+    chunk.word |= static_cast< uint64_t >(bits) << pos;
+    chunk.keys[idx % WordKeys] = key;
+
+    if (chunk.word == TopWord) {
+      this->_tree.erase(chunk_idx);
+    } else {
+      this->_tree.insert_or_assign(chunk_idx, chunk);
+    }
+  }
+
+}; // end class PackedSeparateDomain
+
+} // end namespace core
+} // end namespace ikos
@@ -615,6 +615,20 @@ public:
     return this->_points_to_map.get(p);
   }
 
+  /// \brief Apply `f` on each pointer variable and its points-to set
+  ///
+  /// Pointer variables that are not visited point to any address.
+  template < typename Function >
+  void for_each_points_to(Function f) const {
+    if (this->is_bottom()) {
+      return;
+    }
+
+    for (const auto& entry : this->_points_to_map) {
+      f(entry.first, entry.second);
+    }
+  }
+
   PointerAbsValueT get(VariableRef p) const override {
     return PointerAbsValueT(this->_points_to_map.get(p),
                             this->_inv.to_interval(this->offset_var(p)),
@@ -628,6 +642,26 @@ public:
     this->_inv.forget(this->offset_var(p));
   }
 
+  /// \brief Return the total size of the points-to sets of the pointer
+  /// variables
+  ///
+  /// Unknown points-to sets are not counted.
+  std::size_t num_points_to() const {
+    if (this->is_bottom()) {
+      return 0;
+    }
+    std::size_t n = 0;
+    for (auto it = this->_points_to_map.begin(),
+              et = this->_points_to_map.end();
+         it != et;
+         ++it) {
+      if (it->second.is_set()) {
+        n += it->second.size();
+      }
+    }
+    return n;
+  }
+
   void normalize() const override {
     // is_bottom() will normalize
     if (this->_points_to_map.is_bottom() || this->_nullity.is_bottom() ||
@@ -55,11 +55,18 @@
 
 #pragma once
 
+#include <algorithm>
+#include <deque>
 #include <iosfwd>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include <ikos/core/semantic/dumpable.hpp>
 #include <ikos/core/semantic/indexable.hpp>
 #include <ikos/core/semantic/memory_location.hpp>
@@ -416,6 +423,29 @@ private:
       std::unordered_map< VariableRef, PointerAbsValueT, VariableHash >;
   using MemoryMap = std::
       unordered_map< MemoryLocationRef, PointerAbsValueT, MemoryLocationHash >;
+  using PointerUsersMap = std::
+      unordered_map< VariableRef, std::vector< std::size_t >, VariableHash >;
+  using MemoryUsersMap = std::unordered_map< MemoryLocationRef,
+                                             std::vector< std::size_t >,
+                                             MemoryLocationHash >;
+  using PointerUpdatesMap =
+      std::unordered_map< VariableRef, std::size_t, VariableHash >;
+  using RepresentativeMap =
+      std::unordered_map< VariableRef, VariableRef, VariableHash >;
+  using MemoryUpdatesMap =
+      std::unordered_map< MemoryLocationRef, std::size_t, MemoryLocationHash >;
+
+  /// \brief State of a store or load constraint, for difference propagation
+  struct DerefState {
+    // Memory locations already processed
+    PointsToSetT seen = PointsToSetT::empty();
+
+    // Memory locations updated since the last evaluation (loads only)
+    PointsToSetT pending = PointsToSetT::empty();
+
+    // Stored value at the last evaluation (stores only)
+    boost::optional< PointerAbsValueT > operand;
+  };
 
 public:
   using PointerIterator = typename PointerMap::const_iterator;
@@ -439,11 +469,38 @@ private:
   // Signedness of pointer offsets (usually Unsigned)
   Signedness _offsets_sign;
 
-  // Number of iterations
-  std::size_t _iteration = 0;
+  // Map from pointer variables in a cycle of copies to their representative
+  //
+  // Representatives are not in the map.
+  RepresentativeMap _representatives;
+
+  // True if the constraint is a copy between two variables with the same
+  // representative, indexed as `_csts`
+  std::vector< bool > _collapsed;
+
+  // Map from pointer variables to the constraints reading them
+  PointerUsersMap _pointer_users;
+
+  // Map from memory locations to the load constraints reading them
+  //
+  // A load is registered on a memory location when the location first
+  // appears in the points-to set of its operand.
+  MemoryUsersMap _memory_users;
 
-  // Change seen during iteration
-  bool _change_seen = false;
+  // Number of updates of each pointer variable, for the widening
+  PointerUpdatesMap _pointer_updates;
+
+  // Number of updates of each memory location, for the widening
+  MemoryUpdatesMap _memory_updates;
+
+  // State of each constraint, indexed as `_csts`
+  std::vector< DerefState > _deref_states;
+
+  // Constraints to evaluate
+  std::deque< std::size_t > _worklist;
+
+  // True if the constraint is in `_worklist`, indexed as `_csts`
+  std::vector< bool > _in_worklist;
 
 public:
   /// \brief Default constructor
@@ -470,6 +527,140 @@ public:
     this->_csts.emplace_back(std::move(cst));
   }
 
+  /// \brief Split the constraints into at most `n` independent systems
+  ///
+  /// Constraints are grouped by weakly connected components of the graph
+  /// relating the pointer variables and memory locations of each constraint.
+  /// Two components never share a pointer variable or a memory location, so
+  /// they can be solved separately. Components are distributed over the
+  /// systems to balance the number of constraints.
+  ///
+  /// The constraints are moved into the returned systems. Use merge() to
+  /// retrieve the constraints and results once solved.
+  std::vector< ConstraintSystem > split(std::size_t n) {
+    ikos_assert(n >= 1);
+
+    // Union-find over pointer variables and memory locations
+    std::unordered_map< VariableRef, std::size_t, VariableHash > var_ids;
+    std::unordered_map< MemoryLocationRef, std::size_t, MemoryLocationHash >
+        mem_ids;
+    std::vector< std::size_t > parent;
+    auto find = [&](std::size_t x) {
+      while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+      }
+      return x;
+    };
+    auto var_node = [&](VariableRef v) {
+      auto res = var_ids.emplace(v, parent.size());
+      if (res.second) {
+        parent.push_back(parent.size());
+      }
+      return res.first->second;
+    };
+    auto mem_node = [&](MemoryLocationRef m) {
+      auto res = mem_ids.emplace(m, parent.size());
+      if (res.second) {
+        parent.push_back(parent.size());
+      }
+      return res.first->second;
+    };
+
+    // Node of the pointer variable of each constraint
+    std::vector< std::size_t > nodes;
+    nodes.reserve(this->_csts.size());
+    for (const auto& cst : this->_csts) {
+      std::size_t node;
+      const OperandT* operand;
+      switch (cst->kind()) {
+        case ConstraintT::AssignKind: {
+          auto assign = static_cast< const AssignConstraintT* >(cst.get());
+          node = var_node(assign->result());
+          operand = assign->operand();
+        } break;
+        case ConstraintT::StoreKind: {
+          auto store = static_cast< const StoreConstraintT* >(cst.get());
+          node = var_node(store->pointer());
+          operand = store->operand();
+        } break;
+        case ConstraintT::LoadKind: {
+          auto load = static_cast< const LoadConstraintT* >(cst.get());
+          node = var_node(load->result());
+          operand = load->operand();
+        } break;
+        default: {
+          ikos_unreachable("unexpected kind");
+        }
+      }
+
+      std::size_t other;
+      if (operand->kind() == OperandT::VariableKind) {
+        other =
+            var_node(static_cast< const VariableOperandT* >(operand)->var());
+      } else {
+        other =
+            mem_node(static_cast< const AddressOperandT* >(operand)->address());
+      }
+      parent[find(node)] = find(other);
+      nodes.push_back(node);
+    }
+
+    // Size of each component
+    std::unordered_map< std::size_t, std::size_t > sizes;
+    for (std::size_t node : nodes) {
+      sizes[find(node)]++;
+    }
+
+    // Greedily assign the largest components to the smallest systems
+    std::vector< std::pair< std::size_t, std::size_t > > components(
+        sizes.begin(), sizes.end());
+    std::sort(components.begin(),
+              components.end(),
+              [](const std::pair< std::size_t, std::size_t >& a,
+                 const std::pair< std::size_t, std::size_t >& b) {
+                return a.second > b.second;
+              });
+    n = std::min(n, std::max(components.size(), std::size_t(1)));
+    std::vector< std::size_t > loads(n, 0);
+    std::unordered_map< std::size_t, std::size_t > systems;
+    for (const auto& component : components) {
+      auto it = std::min_element(loads.begin(), loads.end());
+      *it += component.second;
+      systems.emplace(component.first, std::distance(loads.begin(), it));
+    }
+
+    std::vector< ConstraintSystem > result;
+    result.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+      result.emplace_back(this->_offsets_bit_width, this->_offsets_sign);
+    }
+    for (std::size_t i = 0; i < this->_csts.size(); i++) {
+      result[systems.at(find(nodes[i]))].add(std::move(this->_csts[i]));
+    }
+    this->_csts.clear();
+    return result;
+  }
+
+  /// \brief Move the constraints and results of an independent system
+  ///
+  /// The given system must not share pointer variables or memory locations
+  /// with this system, e.g, it comes from split().
+  void merge(ConstraintSystem&& other) {
+    for (auto& cst : other._csts) {
+      this->_csts.emplace_back(std::move(cst));
+    }
+    other._csts.clear();
+    for (auto& entry : other._pointers) {
+      this->_pointers.emplace(entry.first, std::move(entry.second));
+    }
+    other._pointers.clear();
+    for (auto& entry : other._memory) {
+      this->_memory.emplace(entry.first, std::move(entry.second));
+    }
+    other._memory.clear();
+  }
+
 private:
   class BinaryOp {
   public:
@@ -534,20 +725,197 @@ private:
     }
   };
 
-  /// \brief Perform a step of the fixpoint convergence using the given operator
+  /// \brief If the constraint is a copy `p = q + 0`, return its operand
+  static const VariableOperandT* copy_operand(const ConstraintT* cst) {
+    if (cst->kind() != ConstraintT::AssignKind) {
+      return nullptr;
+    }
+    const OperandT* operand =
+        static_cast< const AssignConstraintT* >(cst)->operand();
+    if (operand->kind() != OperandT::VariableKind) {
+      return nullptr;
+    }
+    auto variable_op = static_cast< const VariableOperandT* >(operand);
+    boost::optional< MachineInt > offset = variable_op->offset().singleton();
+    if (!offset || !offset->is_zero()) {
+      return nullptr;
+    }
+    return variable_op;
+  }
+
+  /// \brief Return the representative of the given pointer variable
+  VariableRef representative(VariableRef p) const {
+    if (this->_representatives.empty()) {
+      return p;
+    }
+    auto it = this->_representatives.find(p);
+    if (it == this->_representatives.end()) {
+      return p;
+    } else {
+      return it->second;
+    }
+  }
+
+  /// \brief Merge the pointer variables in a cycle of copies
   ///
-  /// It processes all the constraints once.
-  void step(const BinaryOp& op) {
-    for (auto it = this->_csts.begin(), et = this->_csts.end(); it != et;
-         ++it) {
-      this->process_constraint(it->get(), op);
+  /// All the variables in a strongly connected component of the graph of
+  /// copies `p = q + 0` have the same value at the fixpoint, so they share
+  /// one representative. Components are computed with Tarjan's algorithm.
+  void collapse_copy_cycles() {
+    this->_representatives.clear();
+
+    // Graph of copies, with an edge q -> p for `p = q + 0`
+    std::unordered_map< VariableRef, std::size_t, VariableHash > ids;
+    std::vector< VariableRef > vars;
+    std::vector< std::vector< std::size_t > > succs;
+    auto node = [&](VariableRef v) {
+      auto res = ids.emplace(v, vars.size());
+      if (res.second) {
+        vars.push_back(v);
+        succs.emplace_back();
+      }
+      return res.first->second;
+    };
+    for (const auto& cst : this->_csts) {
+      if (const VariableOperandT* copy = copy_operand(cst.get())) {
+        std::size_t src = node(copy->var());
+        std::size_t dst =
+            node(static_cast< const AssignConstraintT* >(cst.get())->result());
+        succs[src].push_back(dst);
+      }
+    }
+
+    // Iterative version of Tarjan's algorithm
+    const std::size_t n = vars.size();
+    const std::size_t unvisited = std::numeric_limits< std::size_t >::max();
+    std::vector< std::size_t > index(n, unvisited);
+    std::vector< std::size_t > lowlink(n, 0);
+    std::vector< bool > on_stack(n, false);
+    std::vector< std::size_t > stack;
+    std::vector< std::pair< std::size_t, std::size_t > > call_stack;
+    std::size_t next_index = 0;
+    auto visit = [&](std::size_t v) {
+      index[v] = lowlink[v] = next_index++;
+      stack.push_back(v);
+      on_stack[v] = true;
+      call_stack.emplace_back(v, 0);
+    };
+
+    for (std::size_t root = 0; root < n; root++) {
+      if (index[root] != unvisited) {
+        continue;
+      }
+      visit(root);
+      while (!call_stack.empty()) {
+        std::size_t v = call_stack.back().first;
+        std::size_t i = call_stack.back().second;
+        if (i < succs[v].size()) {
+          call_stack.back().second++;
+          std::size_t w = succs[v][i];
+          if (index[w] == unvisited) {
+            visit(w);
+          } else if (on_stack[w]) {
+            lowlink[v] = std::min(lowlink[v], index[w]);
+          }
+          continue;
+        }
+
+        call_stack.pop_back();
+        if (!call_stack.empty()) {
+          std::size_t u = call_stack.back().first;
+          lowlink[u] = std::min(lowlink[u], lowlink[v]);
+        }
+        if (lowlink[v] == index[v]) {
+          // v is the root of a strongly connected component
+          std::size_t w;
+          do {
+            w = stack.back();
+            stack.pop_back();
+            on_stack[w] = false;
+            if (w != v) {
+              this->_representatives.emplace(vars[w], vars[v]);
+            }
+          } while (w != v);
+        }
+      }
+    }
+  }
+
+  /// \brief Index the constraints by the pointer variables they read
+  ///
+  /// Also collapse the cycles of copies and reset the state used for the
+  /// difference propagation.
+  void build_users() {
+    this->collapse_copy_cycles();
+    this->_collapsed.assign(this->_csts.size(), false);
+    this->_pointer_users.clear();
+    this->_memory_users.clear();
+    this->_deref_states.clear();
+    this->_deref_states.resize(this->_csts.size());
+
+    for (std::size_t i = 0; i < this->_csts.size(); i++) {
+      const ConstraintT* cst = this->_csts[i].get();
+      if (const VariableOperandT* copy = copy_operand(cst)) {
+        auto assign = static_cast< const AssignConstraintT* >(cst);
+        if (this->representative(copy->var()) ==
+            this->representative(assign->result())) {
+          this->_collapsed[i] = true;
+          continue;
+        }
+      }
+
+      const OperandT* operand = nullptr;
+      switch (cst->kind()) {
+        case ConstraintT::AssignKind: {
+          operand = static_cast< const AssignConstraintT* >(cst)->operand();
+        } break;
+        case ConstraintT::StoreKind: {
+          auto store = static_cast< const StoreConstraintT* >(cst);
+          this->_pointer_users[this->representative(store->pointer())]
+              .push_back(i);
+          operand = store->operand();
+        } break;
+        case ConstraintT::LoadKind: {
+          operand = static_cast< const LoadConstraintT* >(cst)->operand();
+        } break;
+        default: {
+          ikos_unreachable("unexpected kind");
+        }
+      }
+      if (operand->kind() == OperandT::VariableKind) {
+        auto variable_op = static_cast< const VariableOperandT* >(operand);
+        this->_pointer_users[this->representative(variable_op->var())]
+            .push_back(i);
+      }
+    }
+  }
+
+  /// \brief Add a constraint in the worklist, if it is not already there
+  void push(std::size_t i) {
+    if (!this->_in_worklist[i]) {
+      this->_in_worklist[i] = true;
+      this->_worklist.push_back(i);
+    }
+  }
+
+  /// \brief Evaluate constraints until the worklist is empty
+  void run(const BinaryOp& op) {
+    while (!this->_worklist.empty()) {
+      std::size_t i = this->_worklist.front();
+      this->_worklist.pop_front();
+      this->_in_worklist[i] = false;
+      this->process_constraint(i, op);
     }
   }
 
   /// \brief Process the given constraint
   ///
   /// It updates this->_pointers and this->_memory
-  void process_constraint(const ConstraintT* cst, const BinaryOp& op) {
+  ///
+  /// Stores and loads only process the memory locations that changed since
+  /// their last evaluation.
+  void process_constraint(std::size_t i, const BinaryOp& op) {
+    const ConstraintT* cst = this->_csts[i].get();
     switch (cst->kind()) {
       case ConstraintT::AssignKind: {
         auto assign = static_cast< const AssignConstraintT* >(cst);
@@ -561,9 +929,21 @@ private:
         if (ptr_value.is_bottom()) {
           return;
         }
-        for (MemoryLocationRef addr : ptr_value.points_to()) {
-          this->add_memory(addr, op_value, op);
+        DerefState& state = this->_deref_states[i];
+        if (!state.operand || !op_value.leq(*state.operand)) {
+          // The stored value changed, store it everywhere
+          for (MemoryLocationRef addr : ptr_value.points_to()) {
+            this->add_memory(addr, op_value, op);
+          }
+          state.operand = op_value;
+        } else {
+          // Only store at the new memory locations
+          for (MemoryLocationRef addr :
+               ptr_value.points_to().difference(state.seen)) {
+            this->add_memory(addr, op_value, op);
+          }
         }
+        state.seen = ptr_value.points_to();
       } break;
       case ConstraintT::LoadKind: {
         auto load = static_cast< const LoadConstraintT* >(cst);
@@ -571,9 +951,22 @@ private:
         if (op_value.is_bottom()) {
           return;
         }
-        for (MemoryLocationRef addr : op_value.points_to()) {
+        DerefState& state = this->_deref_states[i];
+
+        // Read the memory locations updated since the last evaluation
+        for (MemoryLocationRef addr : state.pending) {
           this->add_pointer(load->result(), this->get_memory(addr), op);
         }
+
+        // Read the new memory locations
+        for (MemoryLocationRef addr :
+             op_value.points_to().difference(state.seen)) {
+          this->_memory_users[addr].push_back(i);
+          this->add_pointer(load->result(), this->get_memory(addr), op);
+        }
+
+        state.pending = PointsToSetT::empty();
+        state.seen = op_value.points_to();
       } break;
       default: {
         ikos_unreachable("unexpected kind");
@@ -606,7 +999,7 @@ private:
 public:
   /// \brief Return the abstract value for the given pointer
   PointerAbsValueT get_pointer(VariableRef p) {
-    auto it = this->_pointers.find(p);
+    auto it = this->_pointers.find(this->representative(p));
     if (it == this->_pointers.end()) {
       return PointerAbsValueT::bottom(this->_offsets_bit_width,
                                       this->_offsets_sign);
@@ -644,6 +1037,8 @@ private:
   void add_pointer(VariableRef p,
                    const PointerAbsValueT& value,
                    const BinaryOp& op) {
+    p = this->representative(p);
+
     // Get a reference on the current value
     auto it = this->_pointers.find(p);
     if (it == this->_pointers.end()) {
@@ -654,7 +1049,14 @@ private:
                                                        this->_offsets_sign));
       it = res.first;
     }
-    this->add_apply(it->second, value, op);
+    if (this->add_apply(it->second, value, op, this->_pointer_updates[p])) {
+      auto users = this->_pointer_users.find(p);
+      if (users != this->_pointer_users.end()) {
+        for (std::size_t i : users->second) {
+          this->push(i);
+        }
+      }
+    }
   }
 
   /// \brief Add a pointer abstraction for the given memory location
@@ -671,30 +1073,68 @@ private:
                                                        this->_offsets_sign));
       it = res.first;
     }
-    this->add_apply(it->second, value, op);
+    if (this->add_apply(it->second, value, op, this->_memory_updates[m])) {
+      auto users = this->_memory_users.find(m);
+      if (users != this->_memory_users.end()) {
+        for (std::size_t i : users->second) {
+          this->_deref_states[i].pending.add(m);
+          this->push(i);
+        }
+      }
+    }
   }
 
   /// \brief Add `after` in `before`, applying the given binary operator `op`
-  void add_apply(PointerAbsValueT& before,
+  ///
+  /// `updates` is the number of previous updates of `before`.
+  ///
+  /// Return true if `before` changed.
+  bool add_apply(PointerAbsValueT& before,
                  const PointerAbsValueT& after,
-                 const BinaryOp& op) {
-    if (!op.convergence_achieved(before, after)) {
-      this->_change_seen = true;
-      op.apply(before, after, this->_iteration);
+                 const BinaryOp& op,
+                 std::size_t& updates) {
+    if (op.convergence_achieved(before, after)) {
+      return false;
     }
+    op.apply(before, after, updates);
+    updates++;
+    return true;
   }
 
 public:
   /// \brief Solve the constraint system
+  ///
+  /// Pointer variables in a cycle of copies are first merged into one
+  /// representative.
+  ///
+  /// Constraints are evaluated with a worklist: a constraint is evaluated
+  /// again only when a pointer variable or memory location it reads changed.
+  /// A pointer variable or memory location is widened after it was updated
+  /// `widening_threshold` times.
   void solve(std::size_t widening_threshold = 50,
              std::size_t /*narrowing_threshold*/ = 1) {
-    this->_iteration = 0;
+    this->build_users();
+    this->_pointer_updates.clear();
+    this->_memory_updates.clear();
+    this->_worklist.clear();
+    this->_in_worklist.assign(this->_csts.size(), false);
+    for (std::size_t i = 0; i < this->_csts.size(); i++) {
+      if (!this->_collapsed[i]) {
+        this->push(i);
+      }
+    }
+
     Extrapolate widening_op(widening_threshold);
-    do {
-      this->_iteration++;
-      this->_change_seen = false;
-      this->step(widening_op);
-    } while (this->_change_seen);
+    this->run(widening_op);
+
+    // Give the merged variables the value of their representative
+    for (const auto& entry : this->_representatives) {
+      auto it = this->_pointers.find(entry.second);
+      if (it != this->_pointers.end()) {
+        PointerAbsValueT value = it->second;
+        this->_pointers[entry.first] = std::move(value);
+      }
+    }
 
     // TODO(marthaud): commented out because this is unsound.
     //
@@ -709,9 +1149,11 @@ public:
     // See https://babelfish.arc.nasa.gov/jira/projects/IKOS/issues/IKOS-71
 
     // Refine narrowing_op;
-    // this->_iteration = 0;
-    // for (; this->_iteration < narrowing_threshold; ++this->_iteration) {
-    //  this->step(narrowing_op);
+    // for (std::size_t i = 0; i < narrowing_threshold; ++i) {
+    //  this->build_users();
+    //  for (std::size_t j = 0; j < this->_csts.size(); j++) {
+    //    this->process_constraint(j, narrowing_op);
+    //  }
     // }
   }
 
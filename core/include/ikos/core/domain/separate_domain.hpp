@@ -45,28 +45,34 @@
 
 #pragma once
 
-#include <ikos/core/adt/patricia_tree/map.hpp>
+#include <ikos/core/adt/adaptive_map.hpp>
 #include <ikos/core/domain/abstract_domain.hpp>
 
 namespace ikos {
 namespace core {
 
 /// \brief Generic implementation of non-relational domains
-template < typename Key, typename Value >
+///
+/// Small maps are stored in a sorted array, larger ones in a patricia tree,
+/// see AdaptiveMap.
+///
+/// If HashConsed is true, the underlying patricia tree is hash-consed, see
+/// PatriciaTreeMap. This requires a hash_value() function on Value.
+template < typename Key, typename Value, bool HashConsed = false >
 class SeparateDomain final
-    : public AbstractDomain< SeparateDomain< Key, Value > > {
+    : public AbstractDomain< SeparateDomain< Key, Value, HashConsed > > {
 public:
   static_assert(IsAbstractDomain< Value >::value,
                 "Value must implement AbstractDomain");
 
 private:
-  using PatriciaTreeMapT = PatriciaTreeMap< Key, Value >;
+  using MapT = AdaptiveMap< Key, Value, HashConsed >;
 
 public:
-  using Iterator = typename PatriciaTreeMapT::Iterator;
+  using Iterator = typename MapT::Iterator;
 
 private:
-  PatriciaTreeMapT _tree;
+  MapT _map;
   bool _is_bottom;
 
 private:
@@ -108,29 +114,29 @@ public:
   /// \brief Begin iterator over the pairs (key, value)
   Iterator begin() const {
     ikos_assert(!this->is_bottom());
-    return this->_tree.begin();
+    return this->_map.begin();
   }
 
   /// \brief End iterator over the pairs (key, value)
   Iterator end() const {
     ikos_assert(!this->is_bottom());
-    return this->_tree.end();
+    return this->_map.end();
   }
 
   bool is_bottom() const override { return this->_is_bottom; }
 
   bool is_top() const override {
-    return !this->is_bottom() && this->_tree.empty();
+    return !this->is_bottom() && this->_map.empty();
   }
 
   void set_to_bottom() override {
     this->_is_bottom = true;
-    this->_tree.clear();
+    this->_map.clear();
   }
 
   void set_to_top() override {
     this->_is_bottom = false;
-    this->_tree.clear();
+    this->_map.clear();
   }
 
   bool leq(const SeparateDomain& other) const override {
@@ -139,7 +145,7 @@ public:
     } else if (other.is_bottom()) {
       return false;
     } else {
-      return this->_tree.leq(other._tree, [](const Value& x, const Value& y) {
+      return this->_map.leq(other._map, [](const Value& x, const Value& y) {
         return x.leq(y);
       });
     }
@@ -151,10 +157,10 @@ public:
     } else if (other.is_bottom()) {
       return false;
     } else {
-      return this->_tree.equals(other._tree,
-                                [](const Value& x, const Value& y) {
-                                  return x.equals(y);
-                                });
+      return this->_map.equals(other._map,
+                               [](const Value& x, const Value& y) {
+                                 return x.equals(y);
+                               });
     }
   }
 
@@ -164,15 +170,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [](const Value& x, const Value& y) {
-                                   Value z = x.join(y);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [](const Value& x, const Value& y) {
+                                  Value z = x.join(y);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -182,15 +188,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [](const Value& x, const Value& y) {
-                                   Value z = x.join_loop(y);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [](const Value& x, const Value& y) {
+                                  Value z = x.join_loop(y);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -200,15 +206,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [](const Value& x, const Value& y) {
-                                   Value z = x.join_loop(y);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [](const Value& x, const Value& y) {
+                                  Value z = x.join_loop(y);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -218,15 +224,15 @@ public:
     } else if (this->is_bottom()) {
       this->operator=(other);
     } else {
-      this->_tree.intersect_with(other._tree,
-                                 [](const Value& x, const Value& y) {
-                                   Value z = x.widening(y);
-                                   if (z.is_top()) {
-                                     return boost::optional< Value >(
-                                         boost::none);
-                                   }
-                                   return boost::optional< Value >(z);
-                                 });
+      this->_map.intersect_with(other._map,
+                                [](const Value& x, const Value& y) {
+                                  Value z = x.widening(y);
+                                  if (z.is_top()) {
+                                    return boost::optional< Value >(
+                                        boost::none);
+                                  }
+                                  return boost::optional< Value >(z);
+                                });
     }
   }
 
@@ -237,7 +243,7 @@ public:
       this->set_to_bottom();
     } else {
       try {
-        this->_tree.join_with(other._tree, [](const Value& x, const Value& y) {
+        this->_map.join_with(other._map, [](const Value& x, const Value& y) {
           Value z = x.meet(y);
           if (z.is_bottom()) {
             throw BottomFound();
@@ -257,7 +263,7 @@ public:
       this->set_to_bottom();
     } else {
       try {
-        this->_tree.join_with(other._tree, [](const Value& x, const Value& y) {
+        this->_map.join_with(other._map, [](const Value& x, const Value& y) {
           Value z = x.narrowing(y);
           if (z.is_bottom()) {
             throw BottomFound();
@@ -277,9 +283,9 @@ public:
     } else if (value.is_bottom()) {
       this->set_to_bottom();
     } else if (value.is_top()) {
-      this->_tree.erase(key);
+      this->_map.erase(key);
     } else {
-      this->_tree.insert_or_assign(key, value);
+      this->_map.insert_or_assign(key, value);
     }
   }
 
@@ -293,7 +299,7 @@ public:
       return;
     } else {
       try {
-        this->_tree.update_or_insert(
+        this->_map.update_or_insert(
             [](const Value& x, const Value& y) {
               Value z = x.meet(y);
               if (z.is_bottom()) {
@@ -314,7 +320,7 @@ public:
     if (this->is_bottom()) {
       return;
     }
-    this->_tree.erase(key);
+    this->_map.erase(key);
   }
 
   /// \brief Get the abstract value for the given key
@@ -322,7 +328,7 @@ public:
     if (this->is_bottom()) {
       return Value::bottom();
     } else {
-      boost::optional< const Value& > v = this->_tree.at(key);
+      boost::optional< const Value& > v = this->_map.at(key);
       if (v) {
         return *v;
       } else {
@@ -335,7 +341,7 @@ public:
     if (this->is_bottom()) {
       o << "⊥";
     } else {
-      this->_tree.dump(o);
+      this->_map.dump(o);
     }
   }
 
@@ -46,6 +46,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -426,6 +427,9 @@ private:
   // Name
   std::string _name;
 
+  // Index in the parent control flow graph
+  std::size_t _index;
+
   // List of statements
   std::vector< std::unique_ptr< StatementT > > _statements;
 
@@ -437,7 +441,8 @@ private:
 
 private:
   /// \brief Private constructor
-  explicit BasicBlock(std::string name) : _name(std::move(name)) {}
+  BasicBlock(std::string name, std::size_t index)
+      : _name(std::move(name)), _index(index) {}
 
 public:
   /// \brief Deleted copy constructor
@@ -458,6 +463,9 @@ public:
   /// \brief Return the name
   const std::string& name() const { return this->_name; }
 
+  /// \brief Return the index in the parent control flow graph
+  std::size_t index() const { return this->_index; }
+
   /// \brief Begin iterator over the statements
   StatementIterator begin() const {
     return boost::make_transform_iterator(this->_statements.cbegin(),
@@ -587,13 +595,16 @@ public:
                                               BasicBlockT >());
   }
 
+  /// \brief Return the number of basic blocks
+  std::size_t num_blocks() const { return this->_blocks.size(); }
+
   /// \brief Get or create the basic block with the given name
   BasicBlockT* get(const std::string& name) {
     auto it = this->_blocks.find(name);
     if (it != this->_blocks.end()) {
       return it->second.get();
     } else {
-      auto bb = new BasicBlockT(name);
+      auto bb = new BasicBlockT(name, this->_blocks.size());
       this->_blocks.emplace(name, std::unique_ptr< BasicBlockT >(bb));
       return bb;
     }
@@ -670,6 +681,10 @@ struct GraphTraits< muzq::ControlFlowGraph< VariableRef >* > {
 
   static NodeRef entry(GraphRef cfg) { return cfg->entry(); }
 
+  static std::size_t index(NodeRef bb) { return bb->index(); }
+
+  static std::size_t num_nodes(GraphRef cfg) { return cfg->num_blocks(); }
+
   static SuccessorNodeIterator successor_begin(NodeRef bb) {
     return bb->successor_begin();
   }
@@ -728,6 +743,9 @@ private:
   // Invariant at checkpoints
   std::unordered_map< std::string, AbstractDomain > _checkpoints;
 
+  // Statistics on the last fixpoint iterations, for each cycle head
+  std::unordered_map< BasicBlockT*, FixpointCycleStats > _cycle_stats;
+
 public:
   /// \brief Create a fixpoint iterator on the given ControlFlowGraph
   explicit FixpointIterator(ControlFlowGraphT& cfg) : Parent(&cfg) {}
@@ -746,6 +764,16 @@ public:
     }
   }
 
+  /// \brief Return the statistics on the last iterations on the given cycle
+  FixpointCycleStats cycle_stats(BasicBlockT* head) const {
+    auto it = this->_cycle_stats.find(head);
+    if (it != this->_cycle_stats.end()) {
+      return it->second;
+    } else {
+      return FixpointCycleStats();
+    }
+  }
+
 private:
   /// \brief Execution engine
   ///
@@ -821,6 +849,12 @@ public:
   /// value representing the state of the program after the node.
   void process_post(BasicBlockT*, const AbstractDomain&) override {}
 
+  /// \brief Process the statistics on the iterations on a cycle
+  void process_cycle_stats(BasicBlockT* head,
+                           const FixpointCycleStats& stats) override {
+    this->_cycle_stats[head] = stats;
+  }
+
 public:
   /// \brief Dump the fixpoint for debugging purpose
   void dump(std::ostream& o) const {
@@ -47,12 +47,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <ikos/core/fixpoint/fixpoint_iterator.hpp>
 #include <ikos/core/fixpoint/wto.hpp>
+#include <ikos/core/semantic/graph.hpp>
 
 namespace ikos {
 namespace core {
@@ -62,11 +67,196 @@ namespace interleaved_fwd_fixpoint_iterator_impl {
 template < typename GraphRef, typename AbstractValue, typename GraphTrait >
 class WtoIterator;
 
+template < typename GraphRef,
+           typename AbstractValue,
+           typename GraphTrait,
+           typename Callback >
+class WtoReplayer;
+
+template < typename GraphRef, typename AbstractValue, typename GraphTrait >
+class WtoHeadCollector;
+
+/// \brief Return the number of successors of the given node
+template < typename GraphTrait >
+std::size_t num_successors(typename GraphTrait::NodeRef node) {
+  std::size_t n = 0;
+  for (auto it = GraphTrait::successor_begin(node),
+            et = GraphTrait::successor_end(node);
+       it != et;
+       ++it) {
+    n++;
+  }
+  return n;
+}
+
+/// \brief Join `inv` into the accumulator `acc`
+///
+/// If `acc` does not hold any invariant yet, `inv` is moved into it instead of
+/// being joined with bottom.
+template < typename AbstractValue >
+void join_into(AbstractValue& acc, bool& empty, AbstractValue inv) {
+  if (empty) {
+    acc = std::move(inv);
+    empty = false;
+  } else {
+    acc.join_with(inv);
+  }
+}
+
+/// \brief Table of invariants, indexed by node
+///
+/// By default, invariants are stored in a hash table.
+template < typename GraphRef,
+           typename AbstractValue,
+           typename GraphTrait,
+           typename = void >
+class InvariantTable {
+private:
+  using NodeRef = typename GraphTrait::NodeRef;
+
+private:
+  std::unordered_map< NodeRef, AbstractValue > _table;
+
+public:
+  /// \brief Create an empty table for the given graph
+  explicit InvariantTable(GraphRef /*cfg*/) {}
+
+  /// \brief Set the invariant for the given node
+  void set(NodeRef node, AbstractValue inv) {
+    auto it = this->_table.find(node);
+    if (it != this->_table.end()) {
+      it->second = std::move(inv);
+    } else {
+      this->_table.emplace(node, std::move(inv));
+    }
+  }
+
+  /// \brief Get the invariant for the given node
+  const AbstractValue& get(NodeRef node) {
+    auto it = this->_table.find(node);
+    if (it != this->_table.end()) {
+      return it->second;
+    } else {
+      auto res = this->_table.emplace(node, AbstractValue::bottom());
+      return res.first->second;
+    }
+  }
+
+  /// \brief Remove and return the invariant for the given node
+  AbstractValue take(NodeRef node) {
+    auto it = this->_table.find(node);
+    if (it == this->_table.end()) {
+      return AbstractValue::bottom();
+    }
+    AbstractValue inv = std::move(it->second);
+    this->_table.erase(it);
+    return inv;
+  }
+
+}; // end class InvariantTable
+
+/// \brief Table of invariants for graphs with dense node indices
+///
+/// Invariants are stored in a contiguous vector, indexed by
+/// GraphTrait::index(). Nodes without invariant are mapped to bottom.
 template < typename GraphRef, typename AbstractValue, typename GraphTrait >
-class WtoProcessor;
+class InvariantTable<
+    GraphRef,
+    AbstractValue,
+    GraphTrait,
+    std::enable_if_t< IsIndexedGraph< GraphRef, GraphTrait >::value > > {
+private:
+  using NodeRef = typename GraphTrait::NodeRef;
+
+private:
+  std::vector< AbstractValue > _table;
+  std::size_t _num_nodes;
+
+public:
+  /// \brief Create an empty table for the given graph
+  explicit InvariantTable(GraphRef cfg)
+      : _num_nodes(GraphTrait::num_nodes(cfg)) {}
+
+  /// \brief Set the invariant for the given node
+  void set(NodeRef node, AbstractValue inv) {
+    this->slot(GraphTrait::index(node)) = std::move(inv);
+  }
+
+  /// \brief Get the invariant for the given node
+  const AbstractValue& get(NodeRef node) {
+    return this->slot(GraphTrait::index(node));
+  }
+
+  /// \brief Remove and return the invariant for the given node
+  AbstractValue take(NodeRef node) {
+    std::size_t index = GraphTrait::index(node);
+    if (index >= this->_table.size()) {
+      return AbstractValue::bottom();
+    }
+    AbstractValue inv = std::move(this->_table[index]);
+    this->_table[index] = AbstractValue::bottom();
+    return inv;
+  }
+
+private:
+  /// \brief Return the slot for the given index, growing the table if needed
+  AbstractValue& slot(std::size_t index) {
+    if (index >= this->_table.size()) {
+      // Allocate all slots at once, the graph does not change during the
+      // fixpoint computation
+      this->_table.resize(std::max(index + 1, this->_num_nodes),
+                          AbstractValue::bottom());
+    }
+    return this->_table[index];
+  }
+
+}; // end class InvariantTable
 
 } // end namespace interleaved_fwd_fixpoint_iterator_impl
 
+/// \brief Statistics on the fixpoint iterations on a cycle
+struct FixpointCycleStats {
+  /// \brief Number of increasing iterations
+  unsigned increasing_iterations = 0;
+
+  /// \brief Number of widenings
+  ///
+  /// This is the number of calls to extrapolate() after the first iteration.
+  unsigned widenings = 0;
+
+  /// \brief Number of narrowings, i.e. calls to refine()
+  unsigned narrowings = 0;
+
+  /// \brief Number of decreasing iterations skipped
+  ///
+  /// The decreasing iterations are skipped when the increasing iterations
+  /// converge without widening, since there is no precision to recover.
+  unsigned skipped_narrowings = 0;
+
+  /// \brief Wall time, including nested cycles
+  std::chrono::duration< double > time = std::chrono::duration< double >(0);
+
+  /// \brief Peak size of the invariant at the head of the cycle
+  ///
+  /// See InterleavedFwdFixpointIterator::abstract_value_size()
+  std::size_t peak_size = 0;
+
+  /// \brief Number of abstract values copied, including nested cycles
+  ///
+  /// See InterleavedFwdFixpointIterator::num_copies()
+  std::size_t copies = 0;
+
+  /// \brief Number of calls to analyze_node(), including nested cycles
+  std::size_t analyzed_nodes = 0;
+
+  /// \brief Number of nodes whose post invariant was reused because their pre
+  /// invariant did not change, including nested cycles
+  ///
+  /// See InterleavedFwdFixpointIterator::set_reuse_unchanged()
+  std::size_t reused_nodes = 0;
+
+}; // end struct FixpointCycleStats
+
 template < typename GraphRef,
            typename AbstractValue,
            typename GraphTrait = GraphTraits< GraphRef > >
@@ -74,29 +264,81 @@ class InterleavedFwdFixpointIterator
     : public ForwardFixpointIterator< GraphRef, AbstractValue, GraphTrait > {
   friend class interleaved_fwd_fixpoint_iterator_impl::
       WtoIterator< GraphRef, AbstractValue, GraphTrait >;
+  template < typename, typename, typename, typename >
+  friend class interleaved_fwd_fixpoint_iterator_impl::WtoReplayer;
 
 private:
   using NodeRef = typename GraphTrait::NodeRef;
-  using InvariantTable = std::unordered_map< NodeRef, AbstractValue >;
+  using InvariantTable = interleaved_fwd_fixpoint_iterator_impl::
+      InvariantTable< GraphRef, AbstractValue, GraphTrait >;
   using InvariantTablePtr = std::shared_ptr< InvariantTable >;
+  using UseTable = std::unordered_map< NodeRef, std::size_t >;
+  using UseTablePtr = std::shared_ptr< UseTable >;
   using WtoT = Wto< GraphRef, GraphTrait >;
+  using WtoCacheT = WtoCache< GraphRef, GraphTrait >;
   using WtoIterator = interleaved_fwd_fixpoint_iterator_impl::
       WtoIterator< GraphRef, AbstractValue, GraphTrait >;
-  using WtoProcessor = interleaved_fwd_fixpoint_iterator_impl::
-      WtoProcessor< GraphRef, AbstractValue, GraphTrait >;
+  template < typename Callback >
+  using WtoReplayer = interleaved_fwd_fixpoint_iterator_impl::
+      WtoReplayer< GraphRef, AbstractValue, GraphTrait, Callback >;
+  using WtoHeadCollector = interleaved_fwd_fixpoint_iterator_impl::
+      WtoHeadCollector< GraphRef, AbstractValue, GraphTrait >;
 
 private:
   GraphRef _cfg;
   WtoT _wto;
   InvariantTablePtr _pre, _post;
 
+  // Number of pending reads of each post invariant, in low-memory mode
+  UseTablePtr _post_uses;
+
+  // Keep only the invariants of the entry, cycle heads and exit nodes
+  bool _low_memory;
+
+  // Reuse the post invariant of nodes whose pre invariant did not change
+  bool _reuse_unchanged;
+
+  // Move post invariants to their last successor on acyclic regions
+  bool _in_place;
+
+  // Number of abstract values copied by the iterator
+  std::size_t _copies;
+
+  // Number of calls to analyze_node()
+  std::size_t _analyzed_nodes;
+
+  // Number of post invariants reused
+  std::size_t _reused_nodes;
+
 public:
   /// \brief Create an interleaved forward fixpoint iterator
   explicit InterleavedFwdFixpointIterator(GraphRef cfg)
       : _cfg(cfg),
         _wto(cfg),
-        _pre(std::make_shared< InvariantTable >()),
-        _post(std::make_shared< InvariantTable >()) {}
+        _pre(std::make_shared< InvariantTable >(cfg)),
+        _post(std::make_shared< InvariantTable >(cfg)),
+        _post_uses(std::make_shared< UseTable >()),
+        _low_memory(false),
+        _reuse_unchanged(false),
+        _in_place(false),
+        _copies(0),
+        _analyzed_nodes(0),
+        _reused_nodes(0) {}
+
+  /// \brief Create an interleaved forward fixpoint iterator, using the weak
+  /// topological order from the given cache
+  InterleavedFwdFixpointIterator(GraphRef cfg, WtoCacheT& wto_cache)
+      : _cfg(cfg),
+        _wto(wto_cache.get(cfg)),
+        _pre(std::make_shared< InvariantTable >(cfg)),
+        _post(std::make_shared< InvariantTable >(cfg)),
+        _post_uses(std::make_shared< UseTable >()),
+        _low_memory(false),
+        _reuse_unchanged(false),
+        _in_place(false),
+        _copies(0),
+        _analyzed_nodes(0),
+        _reused_nodes(0) {}
 
   /// \brief Copy constructor
   InterleavedFwdFixpointIterator(const InterleavedFwdFixpointIterator&) =
@@ -119,50 +361,154 @@ public:
   /// \brief Get the weak topological order of the graph
   const WtoT& wto() const { return this->_wto; }
 
+  /// \brief Enable or disable the low-memory mode
+  ///
+  /// In low-memory mode, the iterator only keeps the pre invariants of the
+  /// entry node and the cycle heads, and the post invariants of the nodes
+  /// without successors. Other invariants are dropped after their last use
+  /// and recomputed by replay().
+  void set_low_memory(bool low_memory) { this->_low_memory = low_memory; }
+
+  /// \brief Return true if the low-memory mode is enabled
+  bool low_memory() const { return this->_low_memory; }
+
+  /// \brief Enable or disable the reuse of unchanged post invariants
+  ///
+  /// During the iterations on a cycle, a node whose joined pre invariant is
+  /// equal to the one of the previous iteration keeps its post invariant,
+  /// without calling analyze_node(). This requires analyze_node() to be a
+  /// function of its pre invariant only. It has no effect in low-memory mode,
+  /// since pre invariants are not kept.
+  void set_reuse_unchanged(bool reuse_unchanged) {
+    this->_reuse_unchanged = reuse_unchanged;
+  }
+
+  /// \brief Return true if the reuse of unchanged post invariants is enabled
+  bool reuse_unchanged() const { return this->_reuse_unchanged; }
+
+  /// \brief Enable or disable the in-place propagation on acyclic regions
+  ///
+  /// The post invariant of a node outside of any cycle is moved to its last
+  /// successor instead of being copied, and the transfer function of the edge
+  /// refines it in place. A branch then only copies the invariant for its
+  /// other successors. The post invariants of these nodes are dropped once
+  /// consumed, except for nodes without successors.
+  ///
+  /// Nodes in cycles keep their post invariants, since they are read again
+  /// at each iteration.
+  void set_in_place(bool in_place) { this->_in_place = in_place; }
+
+  /// \brief Return true if the in-place propagation is enabled
+  bool in_place() const { return this->_in_place; }
+
+  /// \brief Return the number of calls to analyze_node() since the last call
+  /// to clear()
+  std::size_t num_analyzed_nodes() const { return this->_analyzed_nodes; }
+
+  /// \brief Return the number of post invariants reused since the last call to
+  /// clear()
+  ///
+  /// See set_reuse_unchanged()
+  std::size_t num_reused_nodes() const { return this->_reused_nodes; }
+
+  /// \brief Return the number of abstract values copied by the iterator
+  ///
+  /// This counts the copies made by the iterator itself, e.g. to propagate a
+  /// post invariant that is also stored, since the last call to clear().
+  /// Copies made by the transfer functions are not counted.
+  std::size_t num_copies() const { return this->_copies; }
+
 private:
-  /// \brief Set the invariant for the given node
-  static void set(const InvariantTablePtr& table,
-                  NodeRef node,
-                  AbstractValue inv) {
-    auto it = table->find(node);
-    if (it != table->end()) {
-      it->second = std::move(inv);
-    } else {
-      table->emplace(node, std::move(inv));
+  /// \brief Return a copy of the given abstract value
+  AbstractValue copy(const AbstractValue& inv) {
+    this->_copies++;
+    return inv;
+  }
+
+  /// \brief Apply the transfer function of the given node on `pre`
+  ///
+  /// Transfer functions are strict, so bottom is propagated through
+  /// unreachable nodes without calling analyze_node().
+  AbstractValue propagate_node(NodeRef node, AbstractValue&& pre) {
+    if (pre.is_bottom()) {
+      return std::move(pre);
+    }
+    this->_analyzed_nodes++;
+    return this->analyze_node(node, std::move(pre));
+  }
+
+  /// \brief Apply the transfer function of the given node on a copy of `pre`
+  AbstractValue propagate_node(NodeRef node, const AbstractValue& pre) {
+    if (pre.is_bottom()) {
+      return AbstractValue::bottom();
+    }
+    this->_analyzed_nodes++;
+    return this->analyze_node(node, this->copy(pre));
+  }
+
+  /// \brief Apply the transfer function of the given edge on `post`
+  AbstractValue propagate_edge(NodeRef src, NodeRef dest, AbstractValue post) {
+    if (post.is_bottom()) {
+      return post;
     }
+    return this->analyze_edge(src, dest, std::move(post));
   }
 
   /// \brief Set the pre invariant for the given node
   void set_pre(NodeRef node, AbstractValue inv) {
-    this->set(this->_pre, node, std::move(inv));
+    this->_pre->set(node, std::move(inv));
   }
 
   /// \brief Set the post invariant for the given node
-  void set_post(NodeRef node, AbstractValue inv) {
-    this->set(this->_post, node, std::move(inv));
+  ///
+  /// If `consumable` is true, the invariant is dropped after its last use, see
+  /// consume_post().
+  void set_post(NodeRef node, AbstractValue inv, bool consumable = false) {
+    this->_post->set(node, std::move(inv));
+    if (this->_low_memory || consumable) {
+      std::size_t uses = interleaved_fwd_fixpoint_iterator_impl::
+          num_successors< GraphTrait >(node);
+      if (uses > 0) {
+        (*this->_post_uses)[node] = uses;
+      }
+    }
   }
 
-  /// \brief Get the invariant for the given node
-  static const AbstractValue& get(const InvariantTablePtr& table,
-                                  NodeRef node) {
-    auto it = table->find(node);
-    if (it != table->end()) {
-      return it->second;
-    } else {
-      auto res = table->emplace(node, AbstractValue::bottom());
-      return res.first->second;
+  /// \brief Return the post invariant for the given node, to propagate it to
+  /// one of its successors
+  ///
+  /// In low-memory mode, or in-place on acyclic regions, the invariant is
+  /// moved out on its last use.
+  AbstractValue consume_post(NodeRef node) {
+    if (this->_low_memory || this->_in_place) {
+      auto it = this->_post_uses->find(node);
+      if (it != this->_post_uses->end() && --it->second == 0) {
+        this->_post_uses->erase(it);
+        return this->_post->take(node);
+      }
     }
+    const AbstractValue& post = this->post(node);
+    if (post.is_bottom()) {
+      return AbstractValue::bottom();
+    }
+    return this->copy(post);
   }
 
 public:
   /// \brief Get the pre invariant for the given node
+  ///
+  /// In low-memory mode, this returns bottom for dropped invariants.
   const AbstractValue& pre(NodeRef node) const {
-    return this->get(this->_pre, node);
+    return this->_pre->get(node);
   }
 
   /// \brief Get the post invariant for the given node
+  ///
+  /// In low-memory mode, this returns bottom for dropped invariants. With the
+  /// in-place propagation, this returns bottom for the nodes outside of any
+  /// cycle that have successors.
   const AbstractValue& post(NodeRef node) const {
-    return this->get(this->_post, node);
+    return this->_post->get(node);
   }
 
   /// \brief Extrapolate the new state after an increasing iteration
@@ -210,6 +556,9 @@ public:
   ///
   /// By default, it applies the narrowing until it reaches the post fixpoint.
   ///
+  /// This is not called on cycles that converge without widening, see
+  /// FixpointCycleStats::skipped_narrowings.
+  ///
   /// \param head Head of the cycle
   /// \param iteration Iteration number
   /// \param before Abstract value before the iteration
@@ -233,19 +582,78 @@ public:
     return before.leq(after);
   }
 
+  /// \brief Return the size of the given abstract value, for statistics
+  ///
+  /// This is called on the invariant at the head of a cycle, after each
+  /// increasing iteration. By default, it returns 0.
+  virtual std::size_t abstract_value_size(const AbstractValue& value) {
+    ikos_ignore(value);
+    return 0;
+  }
+
+  /// \brief Process the statistics on the iterations on a cycle
+  ///
+  /// This is called each time the fixpoint on a cycle is reached. A nested
+  /// cycle is processed for each iteration of its parent cycle.
+  ///
+  /// \param head Head of the cycle
+  /// \param stats Statistics on the iterations
+  virtual void process_cycle_stats(NodeRef head,
+                                   const FixpointCycleStats& stats) {
+    ikos_ignore(head);
+    ikos_ignore(stats);
+  }
+
   /// \brief Compute the fixpoint with the given initial abstract value
   void run(AbstractValue init) {
     this->set_pre(GraphTrait::entry(this->_cfg), std::move(init));
     WtoIterator iterator(*this);
     this->_wto.accept(iterator);
-    WtoProcessor processor(*this);
-    this->_wto.accept(processor);
+    this->replay([this](NodeRef node,
+                        const AbstractValue& pre,
+                        const AbstractValue& post) {
+      this->process_pre(node, pre);
+      this->process_post(node, post);
+    });
+  }
+
+  /// \brief Visit the invariants of the previously computed fixpoint
+  ///
+  /// Calls `callback(node, pre, post)` for each node, in weak topological
+  /// order. In low-memory mode, dropped invariants are recomputed from the
+  /// invariants at the cycle heads.
+  template < typename Callback >
+  void replay(Callback callback) {
+    WtoReplayer< Callback > replayer(*this, callback);
+    this->_wto.accept(replayer);
+  }
+
+  /// \brief Drop the invariants of the previously computed fixpoint that
+  /// replay() can recompute
+  ///
+  /// Only the pre invariants of the entry node and of the cycle heads are
+  /// kept, and the iterator switches to low-memory mode. This is meant for a
+  /// fixpoint that stays idle until its invariants are visited again.
+  void compact() {
+    auto pre = std::make_shared< InvariantTable >(this->_cfg);
+    NodeRef entry = GraphTrait::entry(this->_cfg);
+    pre->set(entry, this->_pre->take(entry));
+    WtoHeadCollector collector(*this->_pre, *pre);
+    this->_wto.accept(collector);
+    this->_pre = std::move(pre);
+    this->_post = std::make_shared< InvariantTable >(this->_cfg);
+    this->_post_uses = std::make_shared< UseTable >();
+    this->_low_memory = true;
   }
 
   /// \brief Clear the current fixpoint
   void clear() {
-    this->_pre = std::make_shared< InvariantTable >();
-    this->_post = std::make_shared< InvariantTable >();
+    this->_pre = std::make_shared< InvariantTable >(this->_cfg);
+    this->_post = std::make_shared< InvariantTable >(this->_cfg);
+    this->_post_uses = std::make_shared< UseTable >();
+    this->_copies = 0;
+    this->_analyzed_nodes = 0;
+    this->_reused_nodes = 0;
   }
 
   /// \brief Destructor
@@ -277,11 +685,14 @@ public:
 
   void visit(const WtoVertexT& vertex) override {
     NodeRef node = vertex.node();
+    bool is_entry = node == GraphTrait::entry(this->_iterator.cfg());
     AbstractValue pre = AbstractValue::bottom();
+    bool empty = true;
 
     // Use the invariant for the entry point
-    if (node == GraphTrait::entry(this->_iterator.cfg())) {
-      pre = this->_iterator.pre(node);
+    if (is_entry) {
+      pre = this->_iterator.copy(this->_iterator.pre(node));
+      empty = false;
     }
 
     // Collect invariants from incoming edges
@@ -290,60 +701,85 @@ public:
          it != et;
          ++it) {
       NodeRef pred = *it;
-      pre.join_with(
-          this->_iterator.analyze_edge(pred, node, this->_iterator.post(pred)));
+      join_into(pre,
+                empty,
+                this->_iterator.propagate_edge(pred,
+                                               node,
+                                               this->_iterator.consume_post(
+                                                   pred)));
     }
 
-    this->_iterator.set_pre(node, pre);
-    this->_iterator.set_post(node, this->_iterator.analyze_node(node, pre));
+    if (this->_iterator.low_memory() && !is_entry) {
+      // Only the pre invariants of cycle heads are needed by replay()
+      this->_iterator.set_post(node,
+                               this->_iterator.propagate_node(node,
+                                                              std::move(pre)));
+    } else if (this->_iterator.reuse_unchanged() && !is_entry &&
+               !pre.is_bottom() && pre.equals(this->_iterator.pre(node))) {
+      // Same pre invariant as the previous iteration, keep the post invariant
+      this->_iterator._reused_nodes++;
+    } else {
+      bool consumable = false;
+      if (this->_iterator.in_place()) {
+        // A node outside of any cycle is visited once
+        WtoNestingT nesting = this->_iterator.wto().nesting(node);
+        consumable = nesting.begin() == nesting.end();
+      }
+      this->_iterator.set_post(node,
+                               this->_iterator.propagate_node(node, pre),
+                               consumable);
+      this->_iterator.set_pre(node, std::move(pre));
+    }
   }
 
   void visit(const WtoCycleT& cycle) override {
     NodeRef head = cycle.head();
     WtoNestingT cycle_nesting = this->_iterator.wto().nesting(head);
-    AbstractValue pre = AbstractValue::bottom();
 
     // Collect invariants from incoming edges
+    //
+    // These do not change during the iterations on the cycle.
+    AbstractValue pre_in = AbstractValue::bottom();
+    bool pre_in_empty = true;
+
     for (auto it = GraphTrait::predecessor_begin(head),
               et = GraphTrait::predecessor_end(head);
          it != et;
          ++it) {
       NodeRef pred = *it;
       if (!(this->_iterator.wto().nesting(pred) > cycle_nesting)) {
-        pre.join_with(this->_iterator.analyze_edge(pred,
-                                                   head,
-                                                   this->_iterator.post(pred)));
+        join_into(pre_in,
+                  pre_in_empty,
+                  this->_iterator.propagate_edge(pred,
+                                                 head,
+                                                 this->_iterator.consume_post(
+                                                     pred)));
       }
     }
 
+    AbstractValue pre = this->_iterator.copy(pre_in);
+
+    FixpointCycleStats stats;
+    std::size_t copies = this->_iterator.num_copies();
+    std::size_t analyzed_nodes = this->_iterator.num_analyzed_nodes();
+    std::size_t reused_nodes = this->_iterator.num_reused_nodes();
+    auto start = std::chrono::steady_clock::now();
+
     // Fixpoint iterations
+    //
+    // The pre invariant of the head is only stored once the fixpoint is
+    // reached, since nodes of the cycle only read post invariants.
     IterationKind kind = Increasing;
     for (unsigned iteration = 1;; ++iteration) {
-      this->_iterator.set_pre(head, pre);
-      this->_iterator.set_post(head, this->_iterator.analyze_node(head, pre));
+      this->_iterator.set_post(head, this->_iterator.propagate_node(head, pre));
 
       for (auto it = cycle.begin(), et = cycle.end(); it != et; ++it) {
         it->accept(*this);
       }
 
-      // Invariant from the head of the loop
-      AbstractValue new_pre_in = AbstractValue::bottom();
-
-      for (auto it = GraphTrait::predecessor_begin(head),
-                et = GraphTrait::predecessor_end(head);
-           it != et;
-           ++it) {
-        NodeRef pred = *it;
-        if (!(this->_iterator.wto().nesting(pred) > cycle_nesting)) {
-          new_pre_in.join_with(
-              this->_iterator.analyze_edge(pred,
-                                           head,
-                                           this->_iterator.post(pred)));
-        }
-      }
-
       // Invariant from the tail of the loop
       AbstractValue new_pre_back = AbstractValue::bottom();
+      bool new_pre_back_empty = true;
 
       for (auto it = GraphTrait::predecessor_begin(head),
                 et = GraphTrait::predecessor_end(head);
@@ -351,24 +787,37 @@ public:
            ++it) {
         NodeRef pred = *it;
         if (this->_iterator.wto().nesting(pred) > cycle_nesting) {
-          new_pre_back.join_with(
-              this->_iterator.analyze_edge(pred,
-                                           head,
-                                           this->_iterator.post(pred)));
+          join_into(new_pre_back,
+                    new_pre_back_empty,
+                    this->_iterator.propagate_edge(pred,
+                                                   head,
+                                                   this->_iterator.consume_post(
+                                                       pred)));
         }
       }
 
-      AbstractValue new_pre(std::move(new_pre_in));
+      AbstractValue new_pre = this->_iterator.copy(pre_in);
       new_pre.join_loop_with(new_pre_back);
 
       if (kind == Increasing) {
+        stats.increasing_iterations++;
+        stats.peak_size =
+            std::max(stats.peak_size,
+                     this->_iterator.abstract_value_size(new_pre));
+
         // Increasing iteration with widening
         if (this->_iterator.is_increasing_iterations_fixpoint(pre, new_pre)) {
           // Post-fixpoint reached
           // Use this iteration as a decreasing iteration
           kind = Decreasing;
           iteration = 1;
+          if (stats.widenings == 0) {
+            stats.skipped_narrowings++;
+          }
         } else {
+          if (iteration > 1) {
+            stats.widenings++;
+          }
           pre = this->_iterator.extrapolate(head,
                                             iteration,
                                             std::move(pre),
@@ -377,54 +826,175 @@ public:
       }
 
       if (kind == Decreasing) {
-        // Decreasing iteration with narrowing
-        new_pre =
-            this->_iterator.refine(head, iteration, pre, std::move(new_pre));
-        if (this->_iterator.is_decreasing_iterations_fixpoint(pre, new_pre)) {
-          // No more refinement possible
-          this->_iterator.set_pre(head, std::move(new_pre));
-          break;
+        if (stats.skipped_narrowings > 0) {
+          // Converged without widening, keep the post-fixpoint
+          new_pre = std::move(pre);
         } else {
-          pre = std::move(new_pre);
+          // Decreasing iteration with narrowing
+          stats.narrowings++;
+          new_pre = this->_iterator.refine(head,
+                                           iteration,
+                                           this->_iterator.copy(pre),
+                                           std::move(new_pre));
+          if (!this->_iterator.is_decreasing_iterations_fixpoint(pre,
+                                                                 new_pre)) {
+            pre = std::move(new_pre);
+            continue;
+          }
         }
+
+        // No more refinement possible
+        this->_iterator.set_pre(head, std::move(new_pre));
+        stats.time = std::chrono::steady_clock::now() - start;
+        stats.copies = this->_iterator.num_copies() - copies;
+        stats.analyzed_nodes =
+            this->_iterator.num_analyzed_nodes() - analyzed_nodes;
+        stats.reused_nodes = this->_iterator.num_reused_nodes() - reused_nodes;
+        this->_iterator.process_cycle_stats(head, stats);
+        break;
       }
     }
   }
 
 }; // end class WtoIterator
 
-template < typename GraphRef, typename AbstractValue, typename GraphTrait >
-class WtoProcessor : public WtoComponentVisitor< GraphRef, GraphTrait > {
+template < typename GraphRef,
+           typename AbstractValue,
+           typename GraphTrait,
+           typename Callback >
+class WtoReplayer final : public WtoComponentVisitor< GraphRef, GraphTrait > {
 public:
   using InterleavedIterator =
       InterleavedFwdFixpointIterator< GraphRef, AbstractValue, GraphTrait >;
   using NodeRef = typename GraphTrait::NodeRef;
   using WtoVertexT = WtoVertex< GraphRef, GraphTrait >;
   using WtoCycleT = WtoCycle< GraphRef, GraphTrait >;
+  using InvariantTableT = InvariantTable< GraphRef, AbstractValue, GraphTrait >;
 
 private:
   InterleavedIterator& _iterator;
+  Callback& _callback;
+
+  // Recomputed post invariants, in low-memory mode
+  InvariantTableT _post;
+
+  // Number of pending reads of each recomputed post invariant
+  std::unordered_map< NodeRef, std::size_t > _post_uses;
 
 public:
-  explicit WtoProcessor(InterleavedIterator& iterator) : _iterator(iterator) {}
+  WtoReplayer(InterleavedIterator& iterator, Callback& callback)
+      : _iterator(iterator), _callback(callback), _post(iterator.cfg()) {}
 
   void visit(const WtoVertexT& vertex) override {
     NodeRef node = vertex.node();
-    this->_iterator.process_pre(node, this->_iterator.pre(node));
-    this->_iterator.process_post(node, this->_iterator.post(node));
+
+    if (!this->_iterator.low_memory()) {
+      this->_callback(node,
+                      this->_iterator.pre(node),
+                      this->_iterator.post(node));
+      return;
+    }
+
+    AbstractValue pre = AbstractValue::bottom();
+    bool empty = true;
+
+    // Use the invariant for the entry point
+    if (node == GraphTrait::entry(this->_iterator.cfg())) {
+      pre = this->_iterator.pre(node);
+      empty = false;
+    }
+
+    // All predecessors of a vertex that is not a cycle head come first in the
+    // weak topological order
+    for (auto it = GraphTrait::predecessor_begin(node),
+              et = GraphTrait::predecessor_end(node);
+         it != et;
+         ++it) {
+      NodeRef pred = *it;
+      join_into(pre,
+                empty,
+                this->_iterator.propagate_edge(pred,
+                                               node,
+                                               this->consume_post(pred)));
+    }
+
+    this->replay(node, std::move(pre));
   }
 
   void visit(const WtoCycleT& cycle) override {
     NodeRef head = cycle.head();
-    this->_iterator.process_pre(head, this->_iterator.pre(head));
-    this->_iterator.process_post(head, this->_iterator.post(head));
 
+    if (!this->_iterator.low_memory()) {
+      this->_callback(head,
+                      this->_iterator.pre(head),
+                      this->_iterator.post(head));
+    } else {
+      this->replay(head, this->_iterator.pre(head));
+    }
+
+    for (auto it = cycle.begin(), et = cycle.end(); it != et; ++it) {
+      it->accept(*this);
+    }
+  }
+
+private:
+  /// \brief Recompute the post invariant of the given node
+  void replay(NodeRef node, AbstractValue pre) {
+    AbstractValue post = this->_iterator.propagate_node(node, pre);
+    this->_callback(node, pre, post);
+
+    std::size_t uses = num_successors< GraphTrait >(node);
+    if (uses > 0) {
+      this->_post.set(node, std::move(post));
+      this->_post_uses[node] = uses;
+    }
+  }
+
+  /// \brief Return the recomputed post invariant of the given node
+  AbstractValue consume_post(NodeRef node) {
+    auto it = this->_post_uses.find(node);
+    if (it == this->_post_uses.end()) {
+      // Unreachable from the entry point
+      return AbstractValue::bottom();
+    }
+    if (--it->second == 0) {
+      this->_post_uses.erase(it);
+      return this->_post.take(node);
+    }
+    return this->_post.get(node);
+  }
+
+}; // end class WtoReplayer
+
+/// \brief Move the invariants of the cycle heads into another table
+template < typename GraphRef, typename AbstractValue, typename GraphTrait >
+class WtoHeadCollector final
+    : public WtoComponentVisitor< GraphRef, GraphTrait > {
+public:
+  using NodeRef = typename GraphTrait::NodeRef;
+  using WtoVertexT = WtoVertex< GraphRef, GraphTrait >;
+  using WtoCycleT = WtoCycle< GraphRef, GraphTrait >;
+  using InvariantTableT = InvariantTable< GraphRef, AbstractValue, GraphTrait >;
+
+private:
+  InvariantTableT& _from;
+  InvariantTableT& _to;
+
+public:
+  WtoHeadCollector(InvariantTableT& from, InvariantTableT& to)
+      : _from(from), _to(to) {}
+
+  void visit(const WtoVertexT& /*vertex*/) override {}
+
+  void visit(const WtoCycleT& cycle) override {
+    NodeRef head = cycle.head();
+    this->_to.set(head, this->_from.take(head));
     for (auto it = cycle.begin(), et = cycle.end(); it != et; ++it) {
       it->accept(*this);
     }
   }
 
-}; // end class WtoProcessor
+}; // end class WtoHeadCollector
 
 } // end namespace interleaved_fwd_fixpoint_iterator_impl
 
@@ -0,0 +1,374 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Sparse fixpoint iterator over a def-use graph
+ *
+ * Definitions are visited following F. Bourdoncle's weak topological order of
+ * the def-use graph, see wto.hpp.
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+
+#include <ikos/core/domain/abstract_domain.hpp>
+#include <ikos/core/fixpoint/fwd_fixpoint_iterator.hpp>
+#include <ikos/core/fixpoint/wto.hpp>
+#include <ikos/core/semantic/graph.hpp>
+
+namespace ikos {
+namespace core {
+
+namespace sparse_fixpoint_iterator_impl {
+
+template < typename GraphRef, typename AbstractValue, typename GraphTrait >
+class WtoIterator;
+
+} // end namespace sparse_fixpoint_iterator_impl
+
+/// \brief Sparse fixpoint iterator
+///
+/// The graph is a def-use graph: nodes are definitions, and the successors of
+/// a definition are the definitions using it. Instead of an abstract state per
+/// node of a control flow graph, the iterator keeps one abstract value per
+/// definition, e.g. the interval of the defined variable.
+///
+/// The value of a definition is computed by analyze_node(), from the values of
+/// its operands, see value(). Definitions are visited in weak topological
+/// order, with widenings and narrowings at the heads of the cycles of the
+/// def-use graph. Definitions unreachable from the entry node keep the bottom
+/// value.
+template < typename GraphRef,
+           typename AbstractValue,
+           typename GraphTrait = GraphTraits< GraphRef > >
+class SparseFixpointIterator {
+  friend class sparse_fixpoint_iterator_impl::
+      WtoIterator< GraphRef, AbstractValue, GraphTrait >;
+
+public:
+  static_assert(IsGraph< GraphRef, GraphTrait >::value,
+                "GraphRef does not implement GraphTraits");
+  static_assert(IsAbstractDomain< AbstractValue >::value,
+                "AbstractValue does not implement AbstractDomain");
+
+public:
+  /// \brief Reference to a node of the graph
+  using NodeRef = typename GraphTrait::NodeRef;
+
+private:
+  using ValueTable = std::unordered_map< NodeRef, AbstractValue >;
+  using WtoT = Wto< GraphRef, GraphTrait >;
+  using WtoIterator = sparse_fixpoint_iterator_impl::
+      WtoIterator< GraphRef, AbstractValue, GraphTrait >;
+
+private:
+  GraphRef _graph;
+  WtoT _wto;
+  ValueTable _values;
+
+  // Number of calls to analyze_node()
+  std::size_t _analyzed_nodes;
+
+public:
+  /// \brief Create a sparse fixpoint iterator on the given def-use graph
+  explicit SparseFixpointIterator(GraphRef graph)
+      : _graph(graph), _wto(graph), _analyzed_nodes(0) {}
+
+  /// \brief Copy constructor
+  SparseFixpointIterator(const SparseFixpointIterator&) = default;
+
+  /// \brief Move constructor
+  SparseFixpointIterator(SparseFixpointIterator&&) = default;
+
+  /// \brief Copy assignment operator
+  SparseFixpointIterator& operator=(const SparseFixpointIterator&) = default;
+
+  /// \brief Move assignment operator
+  SparseFixpointIterator& operator=(SparseFixpointIterator&&) = default;
+
+  /// \brief Get the def-use graph
+  GraphRef graph() const { return this->_graph; }
+
+  /// \brief Get the weak topological order of the graph
+  const WtoT& wto() const { return this->_wto; }
+
+  /// \brief Return the abstract value of the given definition
+  ///
+  /// This returns bottom if the value is not computed yet.
+  const AbstractValue& value(NodeRef node) const {
+    static const AbstractValue Bottom = AbstractValue::bottom();
+    auto it = this->_values.find(node);
+    if (it == this->_values.end()) {
+      return Bottom;
+    }
+    return it->second;
+  }
+
+  /// \brief Return the number of calls to analyze_node() since the last call
+  /// to clear()
+  std::size_t num_analyzed_nodes() const { return this->_analyzed_nodes; }
+
+  /// \brief Semantic transformer for a definition
+  ///
+  /// This method should return the abstract value of the given definition,
+  /// using value() to read the current values of its operands. Operands that
+  /// are not computed yet, e.g. on the first iteration of a cycle, are bottom.
+  virtual AbstractValue analyze_node(NodeRef node) = 0;
+
+  /// \brief Extrapolate the new value after an increasing iteration
+  ///
+  /// By default, it applies a join for the first iteration, and then the
+  /// widening until it reaches the fixpoint.
+  ///
+  /// \param head Head of the cycle
+  /// \param iteration Iteration number
+  /// \param before Abstract value before the iteration
+  /// \param after Abstract value after the iteration
+  virtual AbstractValue extrapolate(NodeRef head,
+                                    unsigned iteration,
+                                    AbstractValue before,
+                                    AbstractValue after) {
+    ikos_ignore(head);
+    if (before.is_bottom()) {
+      return after;
+    }
+    if (iteration <= 1) {
+      before.join_iter_with(after);
+    } else {
+      before.widen_with(after);
+    }
+    return before;
+  }
+
+  /// \brief Check if the increasing iterations fixpoint is reached
+  ///
+  /// \param before Abstract value before the iteration
+  /// \param after Abstract value after the iteration
+  virtual bool is_increasing_iterations_fixpoint(const AbstractValue& before,
+                                                 const AbstractValue& after) {
+    return after.leq(before);
+  }
+
+  /// \brief Refine the new value after a decreasing iteration
+  ///
+  /// By default, it applies the narrowing until it reaches the post fixpoint.
+  ///
+  /// This is not called on cycles that converge without widening, see
+  /// FixpointCycleStats::skipped_narrowings.
+  ///
+  /// \param head Head of the cycle
+  /// \param iteration Iteration number
+  /// \param before Abstract value before the iteration
+  /// \param after Abstract value after the iteration
+  virtual AbstractValue refine(NodeRef head,
+                               unsigned iteration,
+                               AbstractValue before,
+                               AbstractValue after) {
+    ikos_ignore(head);
+    ikos_ignore(iteration);
+    before.narrow_with(after);
+    return before;
+  }
+
+  /// \brief Check if the decreasing iterations fixpoint is reached
+  ///
+  /// \param before Abstract value before the iteration
+  /// \param after Abstract value after the iteration
+  virtual bool is_decreasing_iterations_fixpoint(const AbstractValue& before,
+                                                 const AbstractValue& after) {
+    return before.leq(after);
+  }
+
+  /// \brief Process the statistics on the iterations on a cycle
+  ///
+  /// This is called each time the fixpoint on a cycle is reached, see
+  /// InterleavedFwdFixpointIterator::process_cycle_stats().
+  ///
+  /// \param head Head of the cycle
+  /// \param stats Statistics on the iterations
+  virtual void process_cycle_stats(NodeRef head,
+                                   const FixpointCycleStats& stats) {
+    ikos_ignore(head);
+    ikos_ignore(stats);
+  }
+
+  /// \brief Compute the fixpoint
+  void run() {
+    WtoIterator iterator(*this);
+    this->_wto.accept(iterator);
+  }
+
+  /// \brief Clear the current fixpoint
+  void clear() {
+    this->_values.clear();
+    this->_analyzed_nodes = 0;
+  }
+
+  /// \brief Destructor
+  virtual ~SparseFixpointIterator() = default;
+
+private:
+  /// \brief Compute the abstract value of the given definition
+  AbstractValue propagate_node(NodeRef node) {
+    this->_analyzed_nodes++;
+    return this->analyze_node(node);
+  }
+
+  /// \brief Set the abstract value of the given definition
+  void set_value(NodeRef node, AbstractValue value) {
+    auto it = this->_values.find(node);
+    if (it == this->_values.end()) {
+      this->_values.emplace(node, std::move(value));
+    } else {
+      it->second = std::move(value);
+    }
+  }
+
+}; // end class SparseFixpointIterator
+
+namespace sparse_fixpoint_iterator_impl {
+
+template < typename GraphRef, typename AbstractValue, typename GraphTrait >
+class WtoIterator final : public WtoComponentVisitor< GraphRef, GraphTrait > {
+public:
+  using SparseIterator =
+      SparseFixpointIterator< GraphRef, AbstractValue, GraphTrait >;
+  using NodeRef = typename GraphTrait::NodeRef;
+  using WtoVertexT = WtoVertex< GraphRef, GraphTrait >;
+  using WtoCycleT = WtoCycle< GraphRef, GraphTrait >;
+
+private:
+  enum IterationKind { Increasing, Decreasing };
+
+private:
+  SparseIterator& _iterator;
+
+public:
+  explicit WtoIterator(SparseIterator& iterator) : _iterator(iterator) {}
+
+  void visit(const WtoVertexT& vertex) override {
+    NodeRef node = vertex.node();
+    this->_iterator.set_value(node, this->_iterator.propagate_node(node));
+  }
+
+  void visit(const WtoCycleT& cycle) override {
+    NodeRef head = cycle.head();
+
+    FixpointCycleStats stats;
+    std::size_t analyzed_nodes = this->_iterator.num_analyzed_nodes();
+    auto start = std::chrono::steady_clock::now();
+
+    // Operands from the tail of the cycle are bottom on the first iteration
+    AbstractValue value = this->_iterator.propagate_node(head);
+    this->_iterator.set_value(head, value);
+
+    IterationKind kind = Increasing;
+    for (unsigned iteration = 1;; ++iteration) {
+      for (auto it = cycle.begin(), et = cycle.end(); it != et; ++it) {
+        it->accept(*this);
+      }
+
+      AbstractValue new_value = this->_iterator.propagate_node(head);
+
+      if (kind == Increasing) {
+        stats.increasing_iterations++;
+
+        // Increasing iteration with widening
+        if (this->_iterator.is_increasing_iterations_fixpoint(value,
+                                                              new_value)) {
+          // Post-fixpoint reached
+          // Use this iteration as a decreasing iteration
+          kind = Decreasing;
+          iteration = 1;
+          if (stats.widenings == 0) {
+            stats.skipped_narrowings++;
+          }
+        } else {
+          if (iteration > 1) {
+            stats.widenings++;
+          }
+          value = this->_iterator.extrapolate(head,
+                                              iteration,
+                                              std::move(value),
+                                              std::move(new_value));
+          this->_iterator.set_value(head, value);
+        }
+      }
+
+      if (kind == Decreasing) {
+        if (stats.skipped_narrowings > 0) {
+          // Converged without widening, keep the post-fixpoint
+          new_value = std::move(value);
+        } else {
+          // Decreasing iteration with narrowing
+          stats.narrowings++;
+          new_value = this->_iterator.refine(head,
+                                             iteration,
+                                             value,
+                                             std::move(new_value));
+          if (!this->_iterator.is_decreasing_iterations_fixpoint(value,
+                                                                 new_value)) {
+            value = std::move(new_value);
+            this->_iterator.set_value(head, value);
+            continue;
+          }
+        }
+
+        // No more refinement possible
+        this->_iterator.set_value(head, std::move(new_value));
+        stats.time = std::chrono::steady_clock::now() - start;
+        stats.analyzed_nodes =
+            this->_iterator.num_analyzed_nodes() - analyzed_nodes;
+        this->_iterator.process_cycle_stats(head, stats);
+        break;
+      }
+    }
+  }
+
+}; // end class WtoIterator
+
+} // end namespace sparse_fixpoint_iterator_impl
+
+} // end namespace core
+} // end namespace ikos
@@ -49,6 +49,7 @@
 
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <unordered_map>
 #include <utility>
@@ -395,6 +396,7 @@ private:
   using StackPtr = std::shared_ptr< Stack >;
   using NestingTable = std::unordered_map< NodeRef, WtoNestingT >;
   using NestingTablePtr = std::shared_ptr< NestingTable >;
+  using SuccessorNodeIterator = typename GraphTrait::SuccessorNodeIterator;
 
 private:
   WtoComponentListPtr _components;
@@ -463,68 +465,143 @@ private:
 
   void push(NodeRef n) { this->_stack->push_back(n); }
 
-  WtoCyclePtr component(GraphRef cfg, NodeRef vertex) {
-    WtoComponentListPtr partition = std::make_shared< WtoComponentList >();
-    for (auto it = GraphTrait::successor_begin(vertex),
-              et = GraphTrait::successor_end(vertex);
-         it != et;
-         ++it) {
-      NodeRef succ = *it;
-      if (this->dfn(succ) == Dfn(0)) {
-        this->visit(cfg, succ, partition);
-      }
-    }
-    return std::make_shared< WtoCycleT >(vertex,
-                                         partition,
-                                         typename WtoCycleT::PrivateCtor());
-  }
+  /// \brief Frame of the depth-first search
+  ///
+  /// The construction of the weak topological order is an iterative version
+  /// of Bourdoncle's recursive algorithm, using an explicit stack of frames.
+  /// A frame is either a call to `visit(vertex)` or a call to
+  /// `component(vertex)`.
+  struct Frame {
+    /// \brief Is it a `component(vertex)` frame?
+    bool is_component;
+
+    /// \brief Visited vertex
+    NodeRef vertex;
+
+    /// \brief Next successor to visit
+    SuccessorNodeIterator it;
+
+    /// \brief End of the successors
+    SuccessorNodeIterator et;
+
+    /// \brief Current head
+    Dfn head;
 
-  Dfn visit(GraphRef cfg,
-            NodeRef vertex,
-            const WtoComponentListPtr& partition) {
-    Dfn head(0), min(0);
+    /// \brief True if a cycle was found
     bool loop;
 
+    /// \brief Partition where the visited component is inserted
+    WtoComponentListPtr partition;
+
+    /// \brief For `component(vertex)`, partition of the cycle
+    WtoComponentListPtr cycle_partition;
+  };
+
+  /// \brief Start a call to `visit(vertex)`
+  void start_visit(std::vector< Frame >& frames,
+                   NodeRef vertex,
+                   const WtoComponentListPtr& partition) {
     this->push(vertex);
     this->_num += Dfn(1);
-    head = this->_num;
-    this->set_dfn(vertex, head);
-    loop = false;
-    for (auto it = GraphTrait::successor_begin(vertex),
-              et = GraphTrait::successor_end(vertex);
-         it != et;
-         ++it) {
-      NodeRef succ = *it;
-      Dfn succ_dfn = this->dfn(succ);
-      if (succ_dfn == Dfn(0)) {
-        min = this->visit(cfg, succ, partition);
-      } else {
-        min = succ_dfn;
+    this->set_dfn(vertex, this->_num);
+    frames.push_back(Frame{false,
+                           vertex,
+                           GraphTrait::successor_begin(vertex),
+                           GraphTrait::successor_end(vertex),
+                           this->_num,
+                           false,
+                           partition,
+                           nullptr});
+  }
+
+  /// \brief Update the head of a `visit(vertex)` frame, given the minimum
+  /// depth-first number of a successor
+  static void update_head(Frame& frame, const Dfn& min) {
+    if (min <= frame.head) {
+      frame.head = min;
+      frame.loop = true;
+    }
+  }
+
+  /// \brief Return from the top frame, with the given result
+  static void return_from(std::vector< Frame >& frames, const Dfn& head) {
+    frames.pop_back();
+    if (!frames.empty() && !frames.back().is_component) {
+      Frame& caller = frames.back();
+      update_head(caller, head);
+      ++caller.it;
+    }
+  }
+
+  /// \brief Build the weak topological order
+  void build(GraphRef cfg) {
+    std::vector< Frame > frames;
+    this->start_visit(frames, GraphTrait::entry(cfg), this->_components);
+
+    while (!frames.empty()) {
+      Frame& frame = frames.back();
+
+      if (frame.is_component) {
+        if (frame.it != frame.et) {
+          NodeRef succ = *frame.it;
+          ++frame.it;
+          if (this->dfn(succ) == Dfn(0)) {
+            WtoComponentListPtr partition = frame.cycle_partition;
+            this->start_visit(frames, succ, partition);
+          }
+        } else {
+          frame.partition->push_front(
+              std::static_pointer_cast< WtoComponentT, WtoCycleT >(
+                  std::make_shared<
+                      WtoCycleT >(frame.vertex,
+                                  std::move(frame.cycle_partition),
+                                  typename WtoCycleT::PrivateCtor())));
+          Dfn head = frame.head;
+          return_from(frames, head);
+        }
+        continue;
       }
-      if (min <= head) {
-        head = min;
-        loop = true;
+
+      if (frame.it != frame.et) {
+        NodeRef succ = *frame.it;
+        Dfn succ_dfn = this->dfn(succ);
+        if (succ_dfn == Dfn(0)) {
+          WtoComponentListPtr partition = frame.partition;
+          this->start_visit(frames, succ, partition);
+        } else {
+          update_head(frame, succ_dfn);
+          ++frame.it;
+        }
+        continue;
       }
-    }
-    if (head == this->dfn(vertex)) {
-      this->set_dfn(vertex, Dfn::plus_infinity());
-      NodeRef element = this->pop();
-      if (loop) {
-        while (element != vertex) {
-          this->set_dfn(element, Dfn(0));
-          element = this->pop();
+
+      NodeRef vertex = frame.vertex;
+      Dfn head = frame.head;
+      if (head == this->dfn(vertex)) {
+        this->set_dfn(vertex, Dfn::plus_infinity());
+        NodeRef element = this->pop();
+        if (frame.loop) {
+          while (element != vertex) {
+            this->set_dfn(element, Dfn(0));
+            element = this->pop();
+          }
+
+          // Turn the frame into a `component(vertex)` frame
+          frame.is_component = true;
+          frame.it = GraphTrait::successor_begin(vertex);
+          frame.et = GraphTrait::successor_end(vertex);
+          frame.cycle_partition = std::make_shared< WtoComponentList >();
+          continue;
+        } else {
+          frame.partition->push_front(
+              std::static_pointer_cast< WtoComponentT, WtoVertexT >(
+                  std::make_shared<
+                      WtoVertexT >(vertex,
+                                   typename WtoVertexT::PrivateCtor())));
         }
-        partition->push_front(
-            std::static_pointer_cast< WtoComponentT, WtoCycleT >(
-                this->component(cfg, vertex)));
-      } else {
-        partition->push_front(
-            std::static_pointer_cast< WtoComponentT, WtoVertexT >(
-                std::make_shared<
-                    WtoVertexT >(vertex, typename WtoVertexT::PrivateCtor())));
       }
+      return_from(frames, head);
     }
-    return head;
   }
 
   void build_nesting() {
@@ -572,7 +649,7 @@ public:
         _num(0),
         _stack(std::make_shared< Stack >()),
         _nesting_table(std::make_shared< NestingTable >()) {
-    this->visit(cfg, GraphTrait::entry(cfg), this->_components);
+    this->build(cfg);
     this->_dfn_table.reset();
     this->_stack.reset();
     this->build_nesting();
@@ -580,11 +657,14 @@ public:
 
   /// \brief Copy constructor
   Wto(const Wto& other)
-      : _components(other._components), _nesting_table(other._nesting_table) {}
+      : _components(other._components),
+        _num(0),
+        _nesting_table(other._nesting_table) {}
 
   /// \brief Move constructor
   Wto(Wto&& other)
       : _components(std::move(other._components)),
+        _num(0),
         _nesting_table(std::move(other._nesting_table)) {}
 
   /// \brief Copy assignment operator
@@ -632,5 +712,75 @@ public:
 
 }; // end class Wto
 
+/// \brief Cache of weak topological orders
+///
+/// A weak topological order only depends on the graph, and copies share the
+/// same components. This allows all the fixpoint iterators on a graph to
+/// share the same weak topological order.
+///
+/// This class is thread-safe.
+template < typename GraphRef, typename GraphTrait = GraphTraits< GraphRef > >
+class WtoCache {
+public:
+  using WtoT = Wto< GraphRef, GraphTrait >;
+
+private:
+  std::mutex _mutex;
+  std::unordered_map< GraphRef, WtoT > _map;
+
+public:
+  /// \brief Create an empty cache
+  WtoCache() = default;
+
+  /// \brief Deleted copy constructor
+  WtoCache(const WtoCache&) = delete;
+
+  /// \brief Deleted move constructor
+  WtoCache(WtoCache&&) = delete;
+
+  /// \brief Deleted copy assignment operator
+  WtoCache& operator=(const WtoCache&) = delete;
+
+  /// \brief Deleted move assignment operator
+  WtoCache& operator=(WtoCache&&) = delete;
+
+  /// \brief Destructor
+  ~WtoCache() = default;
+
+  /// \brief Return the weak topological order of the given graph
+  ///
+  /// The weak topological order is computed on the first call.
+  WtoT get(GraphRef cfg) {
+    {
+      std::lock_guard< std::mutex > lock(this->_mutex);
+      auto it = this->_map.find(cfg);
+      if (it != this->_map.end()) {
+        return it->second;
+      }
+    }
+
+    // Compute it without holding the lock
+    WtoT wto(cfg);
+
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    return this->_map.emplace(cfg, std::move(wto)).first->second;
+  }
+
+  /// \brief Remove the weak topological order of the given graph
+  ///
+  /// This should be called when the graph is modified.
+  void invalidate(GraphRef cfg) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    this->_map.erase(cfg);
+  }
+
+  /// \brief Remove all the weak topological orders
+  void clear() {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    this->_map.clear();
+  }
+
+}; // end class WtoCache
+
 } // end namespace core
 } // end namespace ikos
@@ -7,6 +7,11 @@
  * numerical relational abstract domain. The domain is based on Antoine Mine's
  * paper and Jorge Navas's implementation in value_domain.hpp
  *
+ * This file is kept for reference only: it relies on the legacy domain
+ * interfaces (numerical_domain, pointer_domain, counter_domain, ...) that were
+ * removed from the core library, and does not compile with it. A summary-based
+ * interprocedural analysis would need a port to core::memory::AbstractDomain.
+ *
  * Author: Maxime Arthaud
  *
  * Contributors: Clement Decoodt
@@ -43,10 +43,14 @@
 
 #pragma once
 
+#include <functional>
 #include <iostream>
+#include <utility>
 
 #include <boost/container/flat_map.hpp>
+#include <boost/container/small_vector.hpp>
 #include <boost/optional.hpp>
+#include <boost/version.hpp>
 
 #include <ikos/core/adt/patricia_tree/set.hpp>
 #include <ikos/core/semantic/dumpable.hpp>
@@ -102,6 +106,8 @@ public:
 }; // end class VariableExpression
 
 /// \brief Represents a linear expression
+///
+/// Up to InlineTerms terms are stored inline, without heap allocation.
 template < typename Number, typename VariableRef >
 class LinearExpression {
 public:
@@ -112,8 +118,21 @@ public:
 public:
   using VariableExpressionT = VariableExpression< Number, VariableRef >;
 
+public:
+  /// \brief Number of terms stored without heap allocation
+  static constexpr std::size_t InlineTerms = 3;
+
 private:
+#if BOOST_VERSION >= 106600
+  using Map = boost::container::flat_map<
+      VariableRef,
+      Number,
+      std::less< VariableRef >,
+      boost::container::small_vector< std::pair< VariableRef, Number >,
+                                      InlineTerms > >;
+#else
   using Map = boost::container::flat_map< VariableRef, Number >;
+#endif
 
 public:
   /// \brief Iterator over the terms
@@ -194,11 +213,9 @@ public:
   void add(const Number& cst, VariableRef var) {
     auto it = this->_map.find(var);
     if (it != this->_map.end()) {
-      Number r = it->second + cst;
-      if (r == 0) {
+      it->second += cst;
+      if (it->second == 0) {
         this->_map.erase(it);
-      } else {
-        it->second = r;
       }
     } else {
       if (cst != 0) {
@@ -211,11 +228,9 @@ public:
   void add(int cst, VariableRef var) {
     auto it = this->_map.find(var);
     if (it != this->_map.end()) {
-      Number r = it->second + cst;
-      if (r == 0) {
+      it->second += cst;
+      if (it->second == 0) {
         this->_map.erase(it);
-      } else {
-        it->second = r;
       }
     } else {
       if (cst != 0) {
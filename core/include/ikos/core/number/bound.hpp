@@ -53,6 +53,7 @@
 #include <ikos/core/number/q_number.hpp>
 #include <ikos/core/number/z_number.hpp>
 #include <ikos/core/support/assert.hpp>
+#include <ikos/core/support/compiler.hpp>
 
 namespace ikos {
 namespace core {
@@ -156,7 +157,7 @@ public:
 
   /// \brief Add a bound
   void operator+=(const Bound& other) {
-    if (this->is_finite() && other.is_finite()) {
+    if (ikos_likely(this->is_finite() && other.is_finite())) {
       this->_n += other._n;
     } else if (this->is_finite() && other.is_infinite()) {
       this->operator=(other);
@@ -171,7 +172,7 @@ public:
 
   /// \brief Substract a bound
   void operator-=(const Bound& other) {
-    if (this->is_finite() && other.is_finite()) {
+    if (ikos_likely(this->is_finite() && other.is_finite())) {
       this->_n -= other._n;
     } else if (this->is_finite() && other.is_infinite()) {
       this->operator=(Bound(true, -other._n));
@@ -190,10 +191,12 @@ public:
       return;
     } else if (other.is_zero()) {
       this->operator=(other);
-    } else {
+    } else if (ikos_likely(this->is_finite() && other.is_finite())) {
       this->_n *= other._n;
-      this->_is_infinite = (this->_is_infinite || other._is_infinite);
-      this->normalize();
+    } else {
+      // Only the signs matter
+      this->_n = ((this->_n > 0) == (other._n > 0)) ? 1 : -1;
+      this->_is_infinite = true;
     }
   }
 
@@ -278,8 +281,8 @@ inline Bound< Number > operator+(const Bound< Number >& lhs,
                                  const Bound< Number >& rhs) {
   using BoundT = Bound< Number >;
 
-  if (lhs.is_finite() && rhs.is_finite()) {
-    return BoundT(false, lhs._n + rhs._n);
+  if (ikos_likely(lhs.is_finite() && rhs.is_finite())) {
+    return BoundT(lhs._n + rhs._n);
   } else if (lhs.is_finite() && rhs.is_infinite()) {
     return rhs;
   } else if (lhs.is_infinite() && rhs.is_finite()) {
@@ -297,8 +300,8 @@ inline Bound< Number > operator-(const Bound< Number >& lhs,
                                  const Bound< Number >& rhs) {
   using BoundT = Bound< Number >;
 
-  if (lhs.is_finite() && rhs.is_finite()) {
-    return BoundT(false, lhs._n - rhs._n);
+  if (ikos_likely(lhs.is_finite() && rhs.is_finite())) {
+    return BoundT(lhs._n - rhs._n);
   } else if (lhs.is_finite() && rhs.is_infinite()) {
     return BoundT(true, -rhs._n);
   } else if (lhs.is_infinite() && rhs.is_finite()) {
@@ -318,8 +321,11 @@ inline Bound< Number > operator*(const Bound< Number >& lhs,
 
   if (lhs.is_zero() || rhs.is_zero()) {
     return BoundT(false, 0);
+  } else if (ikos_likely(lhs.is_finite() && rhs.is_finite())) {
+    return BoundT(lhs._n * rhs._n);
   } else {
-    return BoundT(lhs._is_infinite || rhs._is_infinite, lhs._n * rhs._n);
+    // Only the signs matter
+    return BoundT(true, ((lhs._n > 0) == (rhs._n > 0)) ? 1 : -1);
   }
 }
 
@@ -331,8 +337,8 @@ inline Bound< Number > operator/(const Bound< Number >& lhs,
 
   if (rhs.is_zero()) {
     ikos_unreachable("division by zero");
-  } else if (lhs.is_finite() && rhs.is_finite()) {
-    return BoundT(false, lhs._n / rhs._n);
+  } else if (ikos_likely(lhs.is_finite() && rhs.is_finite())) {
+    return BoundT(lhs._n / rhs._n);
   } else if (lhs.is_finite() && rhs.is_infinite()) {
     return BoundT(0);
   } else if (lhs.is_infinite() && rhs.is_finite()) {
@@ -342,7 +348,7 @@ inline Bound< Number > operator/(const Bound< Number >& lhs,
       return -lhs;
     }
   } else {
-    return BoundT(true, lhs._n * rhs._n);
+    return BoundT(true, ((lhs._n > 0) == (rhs._n > 0)) ? 1 : -1);
   }
 }
 
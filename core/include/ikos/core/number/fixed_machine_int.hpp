@@ -0,0 +1,276 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Machine integer class with a bit-width known at compile time
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include <ikos/core/number/machine_int.hpp>
+#include <ikos/core/number/signedness.hpp>
+#include <ikos/core/number/z_number.hpp>
+#include <ikos/core/support/assert.hpp>
+
+namespace ikos {
+namespace core {
+
+/// \brief Machine integer with a bit-width and signedness known at compile
+/// time
+///
+/// Unlike MachineInt, the bit-width is not stored and operations do not check
+/// it at runtime: masks are compile-time constants. Only bit-widths up to 64
+/// are supported.
+///
+/// Exact values are computed on 64-bit signed integers, see to_int64() and
+/// wrap(). Callers fall back to MachineInt when they do not fit.
+template < unsigned BitWidth, Signedness Sign >
+class FixedMachineInt {
+public:
+  static_assert(BitWidth >= 1 && BitWidth <= 64, "unsupported bit-width");
+
+private:
+  /// \brief Mask of the bits of the integer
+  static constexpr uint64_t Mask = ~uint64_t(0) >> (64 - BitWidth);
+
+  /// \brief Sign bit, or 0 if the integer is unsigned
+  static constexpr uint64_t SignBit =
+      (Sign == Signed) ? (uint64_t(1) << (BitWidth - 1)) : 0;
+
+private:
+  /// \brief Bits of the integer, with the high bits cleared
+  uint64_t _n;
+
+private:
+  struct BitsTag {};
+
+  /// \brief Create a machine integer from its bits
+  constexpr FixedMachineInt(uint64_t n, BitsTag) : _n(n & Mask) {}
+
+public:
+  /// \brief Create the machine integer 0
+  constexpr FixedMachineInt() : _n(0) {}
+
+  /// \brief Create a machine integer from a MachineInt
+  explicit FixedMachineInt(const MachineInt& n)
+      : _n((Sign == Signed) ? static_cast< uint64_t >(n.to< int64_t >())
+                            : n.to< uint64_t >()) {
+    ikos_assert(n.bit_width() == BitWidth && n.sign() == Sign);
+    this->_n &= Mask;
+  }
+
+  /// \brief Create a machine integer from its bits
+  static constexpr FixedMachineInt from_bits(uint64_t n) {
+    return FixedMachineInt(n, BitsTag{});
+  }
+
+  /// \brief Wrap an integer
+  static constexpr FixedMachineInt wrap(int64_t n) {
+    return FixedMachineInt(static_cast< uint64_t >(n), BitsTag{});
+  }
+
+  /// \brief Return the minimum machine integer
+  static constexpr FixedMachineInt min() {
+    return FixedMachineInt(SignBit, BitsTag{});
+  }
+
+  /// \brief Return the maximum machine integer
+  static constexpr FixedMachineInt max() {
+    return FixedMachineInt(Mask ^ SignBit, BitsTag{});
+  }
+
+  /// \brief Return the mask of the bits of the integer
+  static constexpr uint64_t mask() { return Mask; }
+
+  /// \brief Return the bits of the integer
+  constexpr uint64_t bits() const { return this->_n; }
+
+  /// \brief Return true if the integer fits in an int64_t
+  constexpr bool fits_int64() const {
+    return Sign == Signed || BitWidth < 64 ||
+           this->_n <= uint64_t(std::numeric_limits< int64_t >::max());
+  }
+
+  /// \brief Return the integer as an int64_t
+  ///
+  /// Precondition: fits_int64()
+  constexpr int64_t to_int64() const {
+    // Sign-extend the bits, without implementation-defined shifts
+    return (Sign == Signed && BitWidth < 64)
+               ? static_cast< int64_t >(this->_n ^ SignBit) -
+                     static_cast< int64_t >(SignBit)
+               : static_cast< int64_t >(this->_n);
+  }
+
+  /// \brief Return true if the integer is within the given int64_t bounds
+  ///
+  /// This is used to check whether an exact result fits in the bit-width.
+  static constexpr bool fits(int64_t n) {
+    return (Sign == Signed)
+               ? (BitWidth == 64 ||
+                  (n >= -static_cast< int64_t >(SignBit) &&
+                   n <= static_cast< int64_t >(SignBit - 1)))
+               : (n >= 0 &&
+                  (BitWidth == 64 || static_cast< uint64_t >(n) <= Mask));
+  }
+
+  /// \brief Return the integer as a MachineInt
+  MachineInt to_machine_int() const {
+    return MachineInt(this->_n, BitWidth, Sign);
+  }
+
+  /// \brief Addition with wrapping
+  friend constexpr FixedMachineInt operator+(FixedMachineInt lhs,
+                                             FixedMachineInt rhs) {
+    return FixedMachineInt(lhs._n + rhs._n, BitsTag{});
+  }
+
+  /// \brief Subtraction with wrapping
+  friend constexpr FixedMachineInt operator-(FixedMachineInt lhs,
+                                             FixedMachineInt rhs) {
+    return FixedMachineInt(lhs._n - rhs._n, BitsTag{});
+  }
+
+  /// \brief Multiplication with wrapping
+  friend constexpr FixedMachineInt operator*(FixedMachineInt lhs,
+                                             FixedMachineInt rhs) {
+    return FixedMachineInt(lhs._n * rhs._n, BitsTag{});
+  }
+
+  /// \brief Bitwise AND
+  friend constexpr FixedMachineInt operator&(FixedMachineInt lhs,
+                                             FixedMachineInt rhs) {
+    return FixedMachineInt(lhs._n & rhs._n, BitsTag{});
+  }
+
+  /// \brief Bitwise OR
+  friend constexpr FixedMachineInt operator|(FixedMachineInt lhs,
+                                             FixedMachineInt rhs) {
+    return FixedMachineInt(lhs._n | rhs._n, BitsTag{});
+  }
+
+  /// \brief Bitwise XOR
+  friend constexpr FixedMachineInt operator^(FixedMachineInt lhs,
+                                             FixedMachineInt rhs) {
+    return FixedMachineInt(lhs._n ^ rhs._n, BitsTag{});
+  }
+
+  friend constexpr bool operator==(FixedMachineInt lhs, FixedMachineInt rhs) {
+    return lhs._n == rhs._n;
+  }
+
+  friend constexpr bool operator!=(FixedMachineInt lhs, FixedMachineInt rhs) {
+    return lhs._n != rhs._n;
+  }
+
+  /// \brief Comparison, on the bits with the sign bit flipped
+  friend constexpr bool operator<(FixedMachineInt lhs, FixedMachineInt rhs) {
+    return (lhs._n ^ SignBit) < (rhs._n ^ SignBit);
+  }
+
+  friend constexpr bool operator<=(FixedMachineInt lhs, FixedMachineInt rhs) {
+    return (lhs._n ^ SignBit) <= (rhs._n ^ SignBit);
+  }
+
+  friend constexpr bool operator>(FixedMachineInt lhs, FixedMachineInt rhs) {
+    return (lhs._n ^ SignBit) > (rhs._n ^ SignBit);
+  }
+
+  friend constexpr bool operator>=(FixedMachineInt lhs, FixedMachineInt rhs) {
+    return (lhs._n ^ SignBit) >= (rhs._n ^ SignBit);
+  }
+
+}; // end class FixedMachineInt
+
+/// \brief Tag for a bit-width and signedness known at compile time
+template < unsigned BitWidth, Signedness Sign >
+struct FixedWidth {
+  static constexpr unsigned bit_width = BitWidth;
+  static constexpr Signedness sign = Sign;
+};
+
+/// \brief Call `f(FixedWidth< BitWidth, Sign >{})` for the given bit-width and
+/// signedness
+///
+/// Only the common bit-widths (1, 8, 16, 32 and 64) have a specialization.
+/// For other bit-widths, return `fallback`.
+template < typename Result, typename Function >
+inline Result dispatch_fixed_width(unsigned bit_width,
+                                   Signedness sign,
+                                   const Function& f,
+                                   Result fallback) {
+  if (sign == Signed) {
+    switch (bit_width) {
+      case 1:
+        return f(FixedWidth< 1, Signed >{});
+      case 8:
+        return f(FixedWidth< 8, Signed >{});
+      case 16:
+        return f(FixedWidth< 16, Signed >{});
+      case 32:
+        return f(FixedWidth< 32, Signed >{});
+      case 64:
+        return f(FixedWidth< 64, Signed >{});
+      default:
+        return fallback;
+    }
+  } else {
+    switch (bit_width) {
+      case 1:
+        return f(FixedWidth< 1, Unsigned >{});
+      case 8:
+        return f(FixedWidth< 8, Unsigned >{});
+      case 16:
+        return f(FixedWidth< 16, Unsigned >{});
+      case 32:
+        return f(FixedWidth< 32, Unsigned >{});
+      case 64:
+        return f(FixedWidth< 64, Unsigned >{});
+      default:
+        return fallback;
+    }
+  }
+}
+
+} // end namespace core
+} // end namespace ikos
@@ -46,8 +46,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <iosfwd>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -73,23 +75,29 @@ template <>
 struct IsSupportedIntegralOrZNumber< const ZNumber& > : public std::true_type {
 };
 
-namespace detail {
-
-/// \brief Helper that returns either an integral type or a mpz_class
-template < typename T >
-struct ZNumberAdapter : public MpzAdapter< T > {};
-
-template <>
-struct ZNumberAdapter< const ZNumber& > {
-  const mpz_class& operator()(const ZNumber& n) { return n.mpz(); }
-};
-
-} // end namespace detail
-
 /// \brief Class for unlimited precision rationals
+///
+/// Rationals with a numerator and a denominator that fit in an int64_t are
+/// stored inline, and only larger rationals are stored in a GMP rational. The
+/// representation is canonical: the inline rational is reduced, with a
+/// positive denominator and a numerator different from INT64_MIN, and a
+/// rational is stored in a GMP rational if and only if it cannot be stored
+/// inline.
 class QNumber {
 private:
-  mpq_class _n;
+  /// \brief Inline rational
+  struct Small {
+    int64_t num;
+    int64_t den;
+  };
+
+  /// If the numerator and the denominator fit in 64 bits, store them directly,
+  /// Otherwise use a pointer on a mpq_class.
+  union {
+    Small q; /// Used to store the 64 bits numerator and denominator.
+    mpq_class* p; /// Used to store the larger rational value.
+  } _n;
+  bool _small;
 
 public:
   /// \brief Create a QNumber from a string representation
@@ -128,39 +136,184 @@ public:
     }
   }
 
+private:
+  /// \brief Return true if the number is stored inline
+  bool is_small() const { return ikos_likely(this->_small); }
+
+  /// \brief Return true if the number is stored as a mpq_class
+  bool is_large() const { return !this->is_small(); }
+
+  /// \brief Return true if the number is zero
+  bool is_zero() const { return this->is_small() && this->_n.q.num == 0; }
+
+  /// \brief Set the number to the reduced fraction `num / den`
+  ///
+  /// Requires `den > 0` and `gcd(num, den) = 1`.
+  void set_reduced(int64_t num, int64_t den) {
+    if (ikos_unlikely(num == std::numeric_limits< int64_t >::min())) {
+      this->set(mpq_class(mpz_class(detail::MpzAdapter< int64_t >()(num)),
+                          mpz_class(detail::MpzAdapter< int64_t >()(den))));
+      return;
+    }
+    if (this->is_large()) {
+      delete this->_n.p;
+      this->_small = true;
+    }
+    this->_n.q.num = num;
+    this->_n.q.den = den;
+  }
+
+  /// \brief Set the number to the fraction `num / den`
+  ///
+  /// Requires `den != 0`.
+  void set_fraction(int64_t num, int64_t den) {
+    ikos_assert_msg(den != 0, "denominator is zero");
+    bool neg = (num < 0) != (den < 0);
+    uint64_t n = detail::int64_magnitude(num);
+    uint64_t d = detail::int64_magnitude(den);
+    uint64_t g = detail::uint64_gcd(n, d);
+    n /= g;
+    d /= g;
+    const auto max =
+        static_cast< uint64_t >(std::numeric_limits< int64_t >::max());
+    if (ikos_likely(n <= max && d <= max)) {
+      auto r = static_cast< int64_t >(n);
+      this->set_reduced(neg ? -r : r, static_cast< int64_t >(d));
+    } else {
+      mpq_class q(mpz_class(detail::MpzAdapter< int64_t >()(num)),
+                  mpz_class(detail::MpzAdapter< int64_t >()(den)));
+      q.canonicalize();
+      this->set(std::move(q));
+    }
+  }
+
+  /// \brief Set the number to the given canonical mpq_class
+  ///
+  /// Use the inline representation if the number fits.
+  void set(mpq_class&& n) {
+    const mpz_class& num = n.get_num();
+    const mpz_class& den = n.get_den();
+    if (detail::MpzFits< int64_t >()(num) &&
+        detail::MpzFits< int64_t >()(den) &&
+        detail::MpzTo< int64_t >()(num) !=
+            std::numeric_limits< int64_t >::min()) {
+      this->set_reduced(detail::MpzTo< int64_t >()(num),
+                        detail::MpzTo< int64_t >()(den));
+    } else if (this->is_small()) {
+      this->_n.p = new mpq_class(std::move(n));
+      this->_small = false;
+    } else {
+      *this->_n.p = std::move(n);
+    }
+  }
+
+  /// \brief Return a reference on the number as a mpq_class
+  ///
+  /// If the number is stored inline, `tmp` is used as storage.
+  const mpq_class& mpq_ref(mpq_class& tmp) const {
+    if (this->is_small()) {
+      tmp.get_num() = detail::MpzAdapter< int64_t >()(this->_n.q.num);
+      tmp.get_den() = detail::MpzAdapter< int64_t >()(this->_n.q.den);
+      return tmp;
+    } else {
+      return *this->_n.p;
+    }
+  }
+
+  /// \brief Compare two numbers
+  ///
+  /// Return a negative value if `a < b`, zero if `a == b`, or a positive value
+  /// if `a > b`.
+  static int compare(const QNumber& a, const QNumber& b) {
+    if (a.is_small() && b.is_small()) {
+      int64_t x = a._n.q.num;
+      int64_t y = b._n.q.num;
+      if (a._n.q.den == b._n.q.den ||
+          ikos_likely(!detail::mul_overflow(x, b._n.q.den, x) &&
+                      !detail::mul_overflow(y, a._n.q.den, y))) {
+        return (x > y) - (x < y);
+      }
+    }
+    mpq_class x, y;
+    return mpq_cmp(a.mpq_ref(x).get_mpq_t(), b.mpq_ref(y).get_mpq_t());
+  }
+
+  /// \brief Compute the reduced product `(a / b) * (c / d)` of two reduced
+  /// inline rationals, return true if it overflows
+  static bool mul_small(
+      int64_t a, int64_t b, int64_t c, int64_t d, int64_t& num, int64_t& den) {
+    auto g1 = static_cast< int64_t >(
+        detail::uint64_gcd(detail::int64_magnitude(a), uint64_t(d)));
+    auto g2 = static_cast< int64_t >(
+        detail::uint64_gcd(detail::int64_magnitude(c), uint64_t(b)));
+    return detail::mul_overflow(a / g1, c / g2, num) ||
+           detail::mul_overflow(b / g2, d / g1, den);
+  }
+
+public:
   /// \name Constructors
   /// @{
 
   /// \brief Default constructor that creates a QNumber equals to 0
-  QNumber() = default;
+  QNumber() noexcept : _n{{0, 1}}, _small(true) {}
 
   /// \brief Copy constructor
-  QNumber(const QNumber&) = default;
+  QNumber(const QNumber& o) : _small(o._small) {
+    if (o.is_small()) {
+      this->_n.q = o._n.q;
+    } else {
+      this->_n.p = new mpq_class(*o._n.p);
+    }
+  }
 
   /// \brief Move constructor
-  QNumber(QNumber&&) = default;
+  QNumber(QNumber&& o) noexcept : _n(o._n), _small(o._small) {
+    o._n.q = {0, 1};
+    o._small = true;
+  }
 
   /// \brief Create a QNumber from a ZNumber
-  explicit QNumber(const ZNumber& n) : _n(n._n) {}
+  explicit QNumber(const ZNumber& n) : _n{{0, 1}}, _small(true) {
+    if (ikos_likely(n.fits< int64_t >())) {
+      this->set_reduced(n.to< int64_t >(), 1);
+    } else {
+      this->set(mpq_class(n.mpz()));
+    }
+  }
 
   /// \brief Create a QNumber from a ZNumber
-  explicit QNumber(ZNumber&& n) : _n(std::move(n)._n) {}
+  explicit QNumber(ZNumber&& n) : _n{{0, 1}}, _small(true) {
+    if (ikos_likely(n.fits< int64_t >())) {
+      this->set_reduced(n.to< int64_t >(), 1);
+    } else {
+      this->set(mpq_class(std::move(n).mpz()));
+    }
+  }
 
   /// \brief Create a QNumber from an integral type
   template < typename N,
              class = std::enable_if_t< IsSupportedIntegral< N >::value > >
-  explicit QNumber(N n) : _n(detail::MpzAdapter< N >()(n)) {}
+  explicit QNumber(N n) : _n{{0, 1}}, _small(true) {
+    if (ikos_likely(detail::IntegralFitsInt64< N >()(n))) {
+      this->set_reduced(static_cast< int64_t >(n), 1);
+    } else {
+      this->set(mpq_class(detail::MpzAdapter< N >()(n)));
+    }
+  }
 
   /// \brief Create a QNumber from a mpq_class
-  explicit QNumber(const mpq_class& n) : _n(n) {
-    ikos_assert_msg(this->_n.get_den() != 0, "denominator is zero");
-    this->_n.canonicalize();
+  explicit QNumber(const mpq_class& n) : _n{{0, 1}}, _small(true) {
+    ikos_assert_msg(n.get_den() != 0, "denominator is zero");
+    mpq_class q(n);
+    q.canonicalize();
+    this->set(std::move(q));
   }
 
   /// \brief Create a QNumber from a mpq_class
-  explicit QNumber(mpq_class&& n) : _n(std::move(n)) {
-    ikos_assert_msg(this->_n.get_den() != 0, "denominator is zero");
-    this->_n.canonicalize();
+  explicit QNumber(mpq_class&& n) : _n{{0, 1}}, _small(true) {
+    ikos_assert_msg(n.get_den() != 0, "denominator is zero");
+    n.canonicalize();
+    this->set(std::move(n));
   }
 
   /// \brief Create a QNumber from a numerator and a denominator
@@ -168,69 +321,139 @@ public:
              typename D,
              class = std::enable_if_t< IsSupportedIntegral< N >::value &&
                                        IsSupportedIntegral< D >::value > >
-  explicit QNumber(N n, D d)
-      : _n(detail::MpzAdapter< N >()(n), detail::MpzAdapter< D >()(d)) {
-    ikos_assert_msg(this->_n.get_den() != 0, "denominator is zero");
-    this->_n.canonicalize();
+  explicit QNumber(N n, D d) : _n{{0, 1}}, _small(true) {
+    ikos_assert_msg(d != 0, "denominator is zero");
+    if (ikos_likely(detail::IntegralFitsInt64< N >()(n) &&
+                    detail::IntegralFitsInt64< D >()(d))) {
+      this->set_fraction(static_cast< int64_t >(n), static_cast< int64_t >(d));
+    } else {
+      mpq_class q(mpz_class(detail::MpzAdapter< N >()(n)),
+                  mpz_class(detail::MpzAdapter< D >()(d)));
+      q.canonicalize();
+      this->set(std::move(q));
+    }
   }
 
   /// \brief Create a QNumber from a numerator and a denominator
-  explicit QNumber(const ZNumber& n, const ZNumber& d) : _n(n._n, d._n) {
-    ikos_assert_msg(this->_n.get_den() != 0, "denominator is zero");
-    this->_n.canonicalize();
+  explicit QNumber(const ZNumber& n, const ZNumber& d)
+      : _n{{0, 1}}, _small(true) {
+    ikos_assert_msg(d != 0, "denominator is zero");
+    if (ikos_likely(n.fits< int64_t >() && d.fits< int64_t >())) {
+      this->set_fraction(n.to< int64_t >(), d.to< int64_t >());
+    } else {
+      mpq_class q(n.mpz(), d.mpz());
+      q.canonicalize();
+      this->set(std::move(q));
+    }
   }
 
   /// \brief Create a QNumber from a numerator and a denominator
-  explicit QNumber(ZNumber&& n, ZNumber&& d)
-      : _n(std::move(n)._n, std::move(d)._n) {
-    ikos_assert_msg(this->_n.get_den() != 0, "denominator is zero");
-    this->_n.canonicalize();
+  explicit QNumber(ZNumber&& n, ZNumber&& d) : _n{{0, 1}}, _small(true) {
+    ikos_assert_msg(d != 0, "denominator is zero");
+    if (ikos_likely(n.fits< int64_t >() && d.fits< int64_t >())) {
+      this->set_fraction(n.to< int64_t >(), d.to< int64_t >());
+    } else {
+      mpq_class q(std::move(n).mpz(), std::move(d).mpz());
+      q.canonicalize();
+      this->set(std::move(q));
+    }
   }
 
   struct NormalizedTag {};
 
   /// \brief Create a QNumber from a normalized mpq_class
-  QNumber(const mpq_class& n, NormalizedTag) : _n(n) {}
+  QNumber(const mpq_class& n, NormalizedTag) : _n{{0, 1}}, _small(true) {
+    this->set(mpq_class(n));
+  }
 
   /// \brief Create a QNumber from a normalized mpq_class
-  QNumber(mpq_class&& n, NormalizedTag) : _n(std::move(n)) {}
+  QNumber(mpq_class&& n, NormalizedTag) : _n{{0, 1}}, _small(true) {
+    this->set(std::move(n));
+  }
 
   /// \brief Destructor
-  ~QNumber() = default;
+  ~QNumber() {
+    if (this->is_large()) {
+      delete this->_n.p;
+    }
+  }
 
   /// @}
   /// \name Assignment Operators
   /// @{
 
   /// \brief Copy assignment
-  QNumber& operator=(const QNumber&) = default;
+  QNumber& operator=(const QNumber& o) {
+    if (this == &o) {
+      return *this;
+    }
+
+    if (o.is_small()) {
+      this->set_reduced(o._n.q.num, o._n.q.den);
+    } else if (this->is_small()) {
+      this->_n.p = new mpq_class(*o._n.p);
+      this->_small = false;
+    } else {
+      *this->_n.p = *o._n.p;
+    }
+    return *this;
+  }
 
   /// \brief Move assignment
-  QNumber& operator=(QNumber&&) noexcept = default;
+  QNumber& operator=(QNumber&& o) noexcept {
+    if (this == &o) {
+      return *this;
+    }
 
-  /// \brief Assignment for ZNumber
-  QNumber& operator=(const ZNumber& n) {
-    this->_n = n._n;
+    if (this->is_large()) {
+      delete this->_n.p;
+    }
+
+    this->_n = o._n;
+    this->_small = o._small;
+    o._n.q = {0, 1};
+    o._small = true;
     return *this;
   }
 
   /// \brief Assignment for ZNumber
-  QNumber& operator=(ZNumber&& n) noexcept {
-    this->_n = std::move(n._n);
-    return *this;
-  }
+  QNumber& operator=(const ZNumber& n) { return *this = QNumber(n); }
+
+  /// \brief Assignment for ZNumber
+  QNumber& operator=(ZNumber&& n) { return *this = QNumber(std::move(n)); }
 
   /// \brief Assignment for integral types
   template < typename N,
              typename = std::enable_if_t< IsSupportedIntegral< N >::value > >
   QNumber& operator=(N n) {
-    this->_n = detail::MpzAdapter< N >()(n);
-    return *this;
+    return *this = QNumber(n);
   }
 
   /// \brief Addition assignment
   QNumber& operator+=(const QNumber& x) {
-    this->_n += x._n;
+    if (this->is_small() && x.is_small()) {
+      int64_t a = this->_n.q.num, b = this->_n.q.den;
+      int64_t c = x._n.q.num, d = x._n.q.den;
+      int64_t r, s;
+      if (b == 1 && d == 1) {
+        if (ikos_likely(!detail::add_overflow(a, c, r))) {
+          this->set_reduced(r, 1);
+          return *this;
+        }
+      } else {
+        auto g = static_cast< int64_t >(
+            detail::uint64_gcd(uint64_t(b), uint64_t(d)));
+        if (ikos_likely(!detail::mul_overflow(a, d / g, r) &&
+                        !detail::mul_overflow(c, b / g, s) &&
+                        !detail::add_overflow(r, s, r) &&
+                        !detail::mul_overflow(b, d / g, s))) {
+          this->set_fraction(r, s);
+          return *this;
+        }
+      }
+    }
+    mpq_class a, b;
+    this->set(this->mpq_ref(a) + x.mpq_ref(b));
     return *this;
   }
 
@@ -239,13 +462,34 @@ public:
       typename N,
       class = std::enable_if_t< IsSupportedIntegralOrZNumber< N >::value > >
   QNumber& operator+=(N x) {
-    this->_n += detail::ZNumberAdapter< N >()(x);
-    return *this;
+    return *this += QNumber(x);
   }
 
   /// \brief Subtraction assignment
   QNumber& operator-=(const QNumber& x) {
-    this->_n -= x._n;
+    if (this->is_small() && x.is_small()) {
+      int64_t a = this->_n.q.num, b = this->_n.q.den;
+      int64_t c = x._n.q.num, d = x._n.q.den;
+      int64_t r, s;
+      if (b == 1 && d == 1) {
+        if (ikos_likely(!detail::sub_overflow(a, c, r))) {
+          this->set_reduced(r, 1);
+          return *this;
+        }
+      } else {
+        auto g = static_cast< int64_t >(
+            detail::uint64_gcd(uint64_t(b), uint64_t(d)));
+        if (ikos_likely(!detail::mul_overflow(a, d / g, r) &&
+                        !detail::mul_overflow(c, b / g, s) &&
+                        !detail::sub_overflow(r, s, r) &&
+                        !detail::mul_overflow(b, d / g, s))) {
+          this->set_fraction(r, s);
+          return *this;
+        }
+      }
+    }
+    mpq_class a, b;
+    this->set(this->mpq_ref(a) - x.mpq_ref(b));
     return *this;
   }
 
@@ -254,13 +498,24 @@ public:
       typename N,
       class = std::enable_if_t< IsSupportedIntegralOrZNumber< N >::value > >
   QNumber& operator-=(N x) {
-    this->_n -= detail::ZNumberAdapter< N >()(x);
-    return *this;
+    return *this -= QNumber(x);
   }
 
   /// \brief Multiplication assignment
   QNumber& operator*=(const QNumber& x) {
-    this->_n *= x._n;
+    int64_t num, den;
+    if (this->is_small() && x.is_small() &&
+        ikos_likely(!mul_small(this->_n.q.num,
+                               this->_n.q.den,
+                               x._n.q.num,
+                               x._n.q.den,
+                               num,
+                               den))) {
+      this->set_reduced(num, den);
+      return *this;
+    }
+    mpq_class a, b;
+    this->set(this->mpq_ref(a) * x.mpq_ref(b));
     return *this;
   }
 
@@ -269,14 +524,28 @@ public:
       typename N,
       class = std::enable_if_t< IsSupportedIntegralOrZNumber< N >::value > >
   QNumber& operator*=(N x) {
-    this->_n *= detail::ZNumberAdapter< N >()(x);
-    return *this;
+    return *this *= QNumber(x);
   }
 
   /// \brief Division assignment
   QNumber& operator/=(const QNumber& x) {
-    ikos_assert_msg(x._n != 0, "division by zero");
-    this->_n /= x._n;
+    ikos_assert_msg(!x.is_zero(), "division by zero");
+    int64_t num, den;
+    if (this->is_small() && x.is_small()) {
+      // Multiply by the inverse of x, which is also reduced
+      int64_t c = x._n.q.num, d = x._n.q.den;
+      if (c < 0) {
+        c = -c;
+        d = -d;
+      }
+      if (ikos_likely(!mul_small(
+              this->_n.q.num, this->_n.q.den, d, c, num, den))) {
+        this->set_reduced(num, den);
+        return *this;
+      }
+    }
+    mpq_class a, b;
+    this->set(this->mpq_ref(a) / x.mpq_ref(b));
     return *this;
   }
 
@@ -286,8 +555,7 @@ public:
       class = std::enable_if_t< IsSupportedIntegralOrZNumber< N >::value > >
   QNumber& operator/=(N x) {
     ikos_assert_msg(x != 0, "division by zero");
-    this->_n /= detail::ZNumberAdapter< N >()(x);
-    return *this;
+    return *this /= QNumber(x);
   }
 
   /// @}
@@ -298,31 +566,33 @@ public:
   const QNumber& operator+() const { return *this; }
 
   /// \brief Prefix increment
-  QNumber& operator++() {
-    ++this->_n;
-    return *this;
-  }
+  QNumber& operator++() { return *this += QNumber(1); }
 
   /// \brief Postfix increment
   const QNumber operator++(int) {
     QNumber r(*this);
-    ++this->_n;
+    ++*this;
     return r;
   }
 
   /// \brief Unary minus
-  const QNumber operator-() const { return QNumber(-this->_n); }
+  const QNumber operator-() const {
+    QNumber r(*this);
+    if (r.is_small()) {
+      r._n.q.num = -r._n.q.num;
+    } else {
+      r.set(-*r._n.p);
+    }
+    return r;
+  }
 
   /// \brief Prefix decrement
-  QNumber& operator--() {
-    --this->_n;
-    return *this;
-  }
+  QNumber& operator--() { return *this -= QNumber(1); }
 
   /// \brief Postfix decrement
   const QNumber operator--(int) {
     QNumber r(*this);
-    --this->_n;
+    --*this;
     return r;
   }
 
@@ -331,18 +601,35 @@ public:
   /// @{
 
   /// \brief Get the numerator
-  ZNumber numerator() const { return ZNumber(this->_n.get_num()); }
+  ZNumber numerator() const {
+    if (this->is_small()) {
+      return ZNumber(this->_n.q.num);
+    } else {
+      return ZNumber(this->_n.p->get_num());
+    }
+  }
 
   /// \brief Get the denominator
-  ZNumber denominator() const { return ZNumber(this->_n.get_den()); }
+  ZNumber denominator() const {
+    if (this->is_small()) {
+      return ZNumber(this->_n.q.den);
+    } else {
+      return ZNumber(this->_n.p->get_den());
+    }
+  }
 
   /// \brief Round to upper integer
   ZNumber round_to_upper() const {
-    const mpz_class& num = this->_n.get_num();
-    const mpz_class& den = this->_n.get_den();
+    if (this->is_small()) {
+      int64_t q = this->_n.q.num / this->_n.q.den;
+      int64_t r = this->_n.q.num % this->_n.q.den;
+      return ZNumber((r > 0) ? q + 1 : q);
+    }
+    const mpz_class& num = this->_n.p->get_num();
+    const mpz_class& den = this->_n.p->get_den();
     ZNumber q(num / den);
     ZNumber r(num % den);
-    if (r == 0 || this->_n < 0) {
+    if (r == 0 || *this->_n.p < 0) {
       return q;
     } else {
       return q + 1;
@@ -351,11 +638,16 @@ public:
 
   /// \brief Round to lower integer
   ZNumber round_to_lower() const {
-    const mpz_class& num = this->_n.get_num();
-    const mpz_class& den = this->_n.get_den();
+    if (this->is_small()) {
+      int64_t q = this->_n.q.num / this->_n.q.den;
+      int64_t r = this->_n.q.num % this->_n.q.den;
+      return ZNumber((r < 0) ? q - 1 : q);
+    }
+    const mpz_class& num = this->_n.p->get_num();
+    const mpz_class& den = this->_n.p->get_den();
     ZNumber q(num / den);
     ZNumber r(num % den);
-    if (r == 0 || this->_n > 0) {
+    if (r == 0 || *this->_n.p > 0) {
       return q;
     } else {
       return q - 1;
@@ -366,18 +658,61 @@ public:
   /// \name Conversion Functions
   /// @{
 
-  /// \brief Get the internal representation
-  const mpq_class& mpq() const { return this->_n; }
+  /// \brief Return the number as a mpq_class
+  mpq_class mpq() const& {
+    mpq_class tmp;
+    return this->mpq_ref(tmp);
+  }
+
+  /// \brief Return the number as a mpq_class
+  mpq_class mpq() && {
+    if (this->is_small()) {
+      mpq_class tmp;
+      return this->mpq_ref(tmp);
+    } else {
+      return std::move(*this->_n.p);
+    }
+  }
 
   /// \brief Return a string of the QNumber in the given base
   ///
   /// The base can vary from 2 to 36, or from -2 to -36
-  std::string str(int base = 10) const { return this->_n.get_str(base); }
+  std::string str(int base = 10) const {
+    if (this->is_small() && base == 10) {
+      if (this->_n.q.den == 1) {
+        return std::to_string(this->_n.q.num);
+      }
+      return std::to_string(this->_n.q.num) + "/" +
+             std::to_string(this->_n.q.den);
+    }
+    mpq_class tmp;
+    return this->mpq_ref(tmp).get_str(base);
+  }
 
   /// @}
 
+  // Friends
+
+  friend bool operator==(const QNumber&, const QNumber&);
+
+  friend bool operator!=(const QNumber&, const QNumber&);
+
+  friend bool operator<(const QNumber&, const QNumber&);
+
+  friend bool operator<=(const QNumber&, const QNumber&);
+
+  friend bool operator>(const QNumber&, const QNumber&);
+
+  friend bool operator>=(const QNumber&, const QNumber&);
+
+  friend QNumber abs(const QNumber&);
+
+  friend std::ostream& operator<<(std::ostream& o, const QNumber& n);
+
   friend std::istream& operator>>(std::istream& i, QNumber& n);
 
+  friend std::size_t hash_value(const QNumber&);
+
 }; // end class QNumber
 
 /// \name Binary Operators
@@ -385,7 +720,9 @@ public:
 
 /// \brief Addition
 inline QNumber operator+(const QNumber& lhs, const QNumber& rhs) {
-  return QNumber(lhs.mpq() + rhs.mpq(), QNumber::NormalizedTag{});
+  QNumber r(lhs);
+  r += rhs;
+  return r;
 }
 
 /// \brief Addition with integral types or ZNumber
@@ -393,8 +730,7 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline QNumber operator+(const QNumber& lhs, T rhs) {
-  return QNumber(lhs.mpq() + detail::ZNumberAdapter< T >()(rhs),
-                 QNumber::NormalizedTag{});
+  return lhs + QNumber(rhs);
 }
 
 /// \brief Addition with integral types or ZNumber
@@ -402,13 +738,14 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline QNumber operator+(T lhs, const QNumber& rhs) {
-  return QNumber(detail::ZNumberAdapter< T >()(lhs) + rhs.mpq(),
-                 QNumber::NormalizedTag{});
+  return QNumber(lhs) + rhs;
 }
 
 /// \brief Subtraction
 inline QNumber operator-(const QNumber& lhs, const QNumber& rhs) {
-  return QNumber(lhs.mpq() - rhs.mpq(), QNumber::NormalizedTag{});
+  QNumber r(lhs);
+  r -= rhs;
+  return r;
 }
 
 /// \brief Subtraction with integral types or ZNumber
@@ -416,8 +753,7 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline QNumber operator-(const QNumber& lhs, T rhs) {
-  return QNumber(lhs.mpq() - detail::ZNumberAdapter< T >()(rhs),
-                 QNumber::NormalizedTag{});
+  return lhs - QNumber(rhs);
 }
 
 /// \brief Subtraction with integral types or ZNumber
@@ -425,13 +761,14 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline QNumber operator-(T lhs, const QNumber& rhs) {
-  return QNumber(detail::ZNumberAdapter< T >()(lhs) - rhs.mpq(),
-                 QNumber::NormalizedTag{});
+  return QNumber(lhs) - rhs;
 }
 
 /// \brief Multiplication
 inline QNumber operator*(const QNumber& lhs, const QNumber& rhs) {
-  return QNumber(lhs.mpq() * rhs.mpq(), QNumber::NormalizedTag{});
+  QNumber r(lhs);
+  r *= rhs;
+  return r;
 }
 
 /// \brief Multiplication with integral types or ZNumber
@@ -439,8 +776,7 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline QNumber operator*(const QNumber& lhs, T rhs) {
-  return QNumber(lhs.mpq() * detail::ZNumberAdapter< T >()(rhs),
-                 QNumber::NormalizedTag{});
+  return lhs * QNumber(rhs);
 }
 
 /// \brief Multiplication with integral types or ZNumber
@@ -448,14 +784,14 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline QNumber operator*(T lhs, const QNumber& rhs) {
-  return QNumber(detail::ZNumberAdapter< T >()(lhs) * rhs.mpq(),
-                 QNumber::NormalizedTag{});
+  return QNumber(lhs) * rhs;
 }
 
 /// \brief Division
 inline QNumber operator/(const QNumber& lhs, const QNumber& rhs) {
-  ikos_assert_msg(rhs.mpq() != 0, "division by zero");
-  return QNumber(lhs.mpq() / rhs.mpq(), QNumber::NormalizedTag{});
+  QNumber r(lhs);
+  r /= rhs;
+  return r;
 }
 
 /// \brief Division with integral types or ZNumber
@@ -464,8 +800,7 @@ template <
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline QNumber operator/(const QNumber& lhs, T rhs) {
   ikos_assert_msg(rhs != 0, "division by zero");
-  return QNumber(lhs.mpq() / detail::ZNumberAdapter< T >()(rhs),
-                 QNumber::NormalizedTag{});
+  return lhs / QNumber(rhs);
 }
 
 /// \brief Division with integral types or ZNumber
@@ -473,9 +808,7 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline QNumber operator/(T lhs, const QNumber& rhs) {
-  ikos_assert_msg(rhs.mpq() != 0, "division by zero");
-  return QNumber(detail::ZNumberAdapter< T >()(lhs) / rhs.mpq(),
-                 QNumber::NormalizedTag{});
+  return QNumber(lhs) / rhs;
 }
 
 /// @}
@@ -484,7 +817,14 @@ inline QNumber operator/(T lhs, const QNumber& rhs) {
 
 /// \brief Equality operator
 inline bool operator==(const QNumber& lhs, const QNumber& rhs) {
-  return lhs.mpq() == rhs.mpq();
+  if (lhs.is_small() && rhs.is_small()) {
+    return lhs._n.q.num == rhs._n.q.num && lhs._n.q.den == rhs._n.q.den;
+  } else if (lhs.is_small() || rhs.is_small()) {
+    // The representation is canonical
+    return false;
+  } else {
+    return mpq_equal(lhs._n.p->get_mpq_t(), rhs._n.p->get_mpq_t()) != 0;
+  }
 }
 
 /// \brief Equality operator with integral types or ZNumber
@@ -492,7 +832,7 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline bool operator==(const QNumber& lhs, T rhs) {
-  return lhs.mpq() == detail::ZNumberAdapter< T >()(rhs);
+  return lhs == QNumber(rhs);
 }
 
 /// \brief Equality operator with integral types or ZNumber
@@ -500,12 +840,12 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline bool operator==(T lhs, const QNumber& rhs) {
-  return detail::ZNumberAdapter< T >()(lhs) == rhs.mpq();
+  return QNumber(lhs) == rhs;
 }
 
 /// \brief Inequality operator
 inline bool operator!=(const QNumber& lhs, const QNumber& rhs) {
-  return lhs.mpq() != rhs.mpq();
+  return !(lhs == rhs);
 }
 
 /// \brief Inequality operator with integral types or ZNumber
@@ -513,7 +853,7 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline bool operator!=(const QNumber& lhs, T rhs) {
-  return lhs.mpq() != detail::ZNumberAdapter< T >()(rhs);
+  return lhs != QNumber(rhs);
 }
 
 /// \brief Inequality operator with integral types or ZNumber
@@ -521,12 +861,12 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline bool operator!=(T lhs, const QNumber& rhs) {
-  return detail::ZNumberAdapter< T >()(lhs) != rhs.mpq();
+  return QNumber(lhs) != rhs;
 }
 
 /// \brief Less than comparison
 inline bool operator<(const QNumber& lhs, const QNumber& rhs) {
-  return lhs.mpq() < rhs.mpq();
+  return QNumber::compare(lhs, rhs) < 0;
 }
 
 /// \brief Less than comparison with integral types or ZNumber
@@ -534,7 +874,7 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline bool operator<(const QNumber& lhs, T rhs) {
-  return lhs.mpq() < detail::ZNumberAdapter< T >()(rhs);
+  return lhs < QNumber(rhs);
 }
 
 /// \brief Less than comparison with integral types or ZNumber
@@ -542,12 +882,12 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline bool operator<(T lhs, const QNumber& rhs) {
-  return detail::ZNumberAdapter< T >()(lhs) < rhs.mpq();
+  return QNumber(lhs) < rhs;
 }
 
 /// \brief Less or equal comparison
 inline bool operator<=(const QNumber& lhs, const QNumber& rhs) {
-  return lhs.mpq() <= rhs.mpq();
+  return QNumber::compare(lhs, rhs) <= 0;
 }
 
 /// \brief Less or equal comparison with integral types or ZNumber
@@ -555,7 +895,7 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline bool operator<=(const QNumber& lhs, T rhs) {
-  return lhs.mpq() <= detail::ZNumberAdapter< T >()(rhs);
+  return lhs <= QNumber(rhs);
 }
 
 /// \brief Less or equal comparison with integral types or ZNumber
@@ -563,12 +903,12 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline bool operator<=(T lhs, const QNumber& rhs) {
-  return detail::ZNumberAdapter< T >()(lhs) <= rhs.mpq();
+  return QNumber(lhs) <= rhs;
 }
 
 /// \brief Greater than comparison
 inline bool operator>(const QNumber& lhs, const QNumber& rhs) {
-  return lhs.mpq() > rhs.mpq();
+  return QNumber::compare(lhs, rhs) > 0;
 }
 
 /// \brief Greater than comparison with integral types or ZNumber
@@ -576,7 +916,7 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline bool operator>(const QNumber& lhs, T rhs) {
-  return lhs.mpq() > detail::ZNumberAdapter< T >()(rhs);
+  return lhs > QNumber(rhs);
 }
 
 /// \brief Greater than comparison with integral types or ZNumber
@@ -584,12 +924,12 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline bool operator>(T lhs, const QNumber& rhs) {
-  return detail::ZNumberAdapter< T >()(lhs) > rhs.mpq();
+  return QNumber(lhs) > rhs;
 }
 
 /// \brief Greater or equal comparison
 inline bool operator>=(const QNumber& lhs, const QNumber& rhs) {
-  return lhs.mpq() >= rhs.mpq();
+  return QNumber::compare(lhs, rhs) >= 0;
 }
 
 /// \brief Greater or equal comparison with integral types or ZNumber
@@ -597,7 +937,7 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline bool operator>=(const QNumber& lhs, T rhs) {
-  return lhs.mpq() >= detail::ZNumberAdapter< T >()(rhs);
+  return lhs >= QNumber(rhs);
 }
 
 /// \brief Greater or equal comparison with integral types or ZNumber
@@ -605,7 +945,7 @@ template <
     typename T,
     class = std::enable_if_t< IsSupportedIntegralOrZNumber< T >::value > >
 inline bool operator>=(T lhs, const QNumber& rhs) {
-  return detail::ZNumberAdapter< T >()(lhs) >= rhs.mpq();
+  return QNumber(lhs) >= rhs;
 }
 
 /// @}
@@ -654,7 +994,11 @@ inline const QNumber& max(const QNumber& a,
 
 /// \brief Return the absolute value of the given number
 inline QNumber abs(const QNumber& n) {
-  return QNumber(abs(n.mpq()));
+  if (n.is_small()) {
+    return (n._n.q.num < 0) ? -n : n;
+  } else {
+    return QNumber(abs(*n._n.p), QNumber::NormalizedTag{});
+  }
 }
 
 /// @}
@@ -663,13 +1007,23 @@ inline QNumber abs(const QNumber& n) {
 
 /// \brief Write a QNumber on a stream, in base 10
 inline std::ostream& operator<<(std::ostream& o, const QNumber& n) {
-  o << n.mpq();
+  if (n.is_small()) {
+    o << n._n.q.num;
+    if (n._n.q.den != 1) {
+      o << '/' << n._n.q.den;
+    }
+  } else {
+    o << *n._n.p;
+  }
   return o;
 }
 
 /// \brief Read a QNumber from a stream, in base 10
 inline std::istream& operator>>(std::istream& i, QNumber& n) {
-  i >> n._n;
+  mpq_class tmp;
+  i >> tmp;
+  tmp.canonicalize();
+  n.set(std::move(tmp));
   return i;
 }
 
@@ -677,8 +1031,13 @@ inline std::istream& operator>>(std::istream& i, QNumber& n) {
 
 /// \brief Return the hash of a QNumber
 inline std::size_t hash_value(const QNumber& n) {
-  const mpq_class& m = n.mpq();
   std::size_t result = 0;
+  if (n.is_small()) {
+    boost::hash_combine(result, n._n.q.num);
+    boost::hash_combine(result, n._n.q.den);
+    return result;
+  }
+  const mpq_class& m = *n._n.p;
   boost::hash_combine(result, m.get_num_mpz_t()[0]._mp_size);
   for (int i = 0, e = std::abs(m.get_num_mpz_t()[0]._mp_size); i < e; ++i) {
     boost::hash_combine(result, m.get_num_mpz_t()[0]._mp_d[i]);
@@ -46,8 +46,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <iosfwd>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -60,6 +62,7 @@
 #include <ikos/core/number/exception.hpp>
 #include <ikos/core/number/supported_integral.hpp>
 #include <ikos/core/support/assert.hpp>
+#include <ikos/core/support/compiler.hpp>
 
 namespace ikos {
 namespace core {
@@ -280,12 +283,138 @@ template <>
 struct MpzTo< long long >
     : public MpzToLongLong< sizeof(long long) == sizeof(long) > {};
 
+/// \brief Helper to check if an integral value fits in an int64_t
+template < typename T, bool = std::is_signed< T >::value >
+struct IntegralFitsInt64;
+
+template < typename T >
+struct IntegralFitsInt64< T, true > {
+  static_assert(sizeof(T) <= sizeof(int64_t), "unexpected size");
+  bool operator()(T) { return true; }
+};
+
+template < typename T >
+struct IntegralFitsInt64< T, false > {
+  bool operator()(T n) {
+    return static_cast< uint64_t >(n) <=
+           static_cast< uint64_t >(std::numeric_limits< int64_t >::max());
+  }
+};
+
+/// \brief Helper to check if an int64_t fits in the given integer type
+template < typename T, bool = std::is_signed< T >::value >
+struct Int64FitsIntegral;
+
+template < typename T >
+struct Int64FitsIntegral< T, true > {
+  bool operator()(int64_t n) {
+    return n >= static_cast< int64_t >(std::numeric_limits< T >::min()) &&
+           n <= static_cast< int64_t >(std::numeric_limits< T >::max());
+  }
+};
+
+template < typename T >
+struct Int64FitsIntegral< T, false > {
+  bool operator()(int64_t n) {
+    return n >= 0 &&
+           static_cast< uint64_t >(n) <=
+               static_cast< uint64_t >(std::numeric_limits< T >::max());
+  }
+};
+
+/// \brief Return the absolute value of the given int64_t, as an uint64_t
+inline uint64_t int64_magnitude(int64_t n) {
+  return n < 0 ? uint64_t(0) - static_cast< uint64_t >(n)
+               : static_cast< uint64_t >(n);
+}
+
+/// \brief Return the greatest common divisor of the given uint64_t
+inline uint64_t uint64_gcd(uint64_t a, uint64_t b) {
+  while (b != 0) {
+    uint64_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+/// \brief Compute `r = a + b`, return true if it overflows
+inline bool add_overflow(int64_t a, int64_t b, int64_t& r) {
+#if __has_builtin(__builtin_add_overflow) || IKOS_GNUC_PREREQ(5, 0, 0)
+  return __builtin_add_overflow(a, b, &r);
+#else
+  if ((b > 0 && a > std::numeric_limits< int64_t >::max() - b) ||
+      (b < 0 && a < std::numeric_limits< int64_t >::min() - b)) {
+    return true;
+  }
+  r = a + b;
+  return false;
+#endif
+}
+
+/// \brief Compute `r = a - b`, return true if it overflows
+inline bool sub_overflow(int64_t a, int64_t b, int64_t& r) {
+#if __has_builtin(__builtin_sub_overflow) || IKOS_GNUC_PREREQ(5, 0, 0)
+  return __builtin_sub_overflow(a, b, &r);
+#else
+  if ((b < 0 && a > std::numeric_limits< int64_t >::max() + b) ||
+      (b > 0 && a < std::numeric_limits< int64_t >::min() + b)) {
+    return true;
+  }
+  r = a - b;
+  return false;
+#endif
+}
+
+/// \brief Compute `r = a * b`, return true if it overflows
+inline bool mul_overflow(int64_t a, int64_t b, int64_t& r) {
+#if __has_builtin(__builtin_mul_overflow) || IKOS_GNUC_PREREQ(5, 0, 0)
+  return __builtin_mul_overflow(a, b, &r);
+#else
+  const int64_t max = std::numeric_limits< int64_t >::max();
+  const int64_t min = std::numeric_limits< int64_t >::min();
+  if (a == 0 || b == 0) {
+    r = 0;
+    return false;
+  }
+  if (a > 0 ? (b > 0 ? a > max / b : b < min / a)
+            : (b > 0 ? a < min / b : a < max / b)) {
+    return true;
+  }
+  r = a * b;
+  return false;
+#endif
+}
+
+/// \brief Compute `r = a * b`, return true if it overflows
+inline bool mul_overflow(uint64_t a, uint64_t b, uint64_t& r) {
+#if __has_builtin(__builtin_mul_overflow) || IKOS_GNUC_PREREQ(5, 0, 0)
+  return __builtin_mul_overflow(a, b, &r);
+#else
+  if (a != 0 && b > std::numeric_limits< uint64_t >::max() / a) {
+    return true;
+  }
+  r = a * b;
+  return false;
+#endif
+}
+
 } // end namespace detail
 
 /// \brief Class for unlimited precision integers
+///
+/// Numbers that fit in an int64_t are stored inline, and only larger numbers
+/// are stored in a GMP integer. The representation is canonical: a number is
+/// stored in a GMP integer if and only if it does not fit in an int64_t.
 class ZNumber {
 private:
-  mpz_class _n;
+  /// If the number fits in 64 bits, store directly the integer,
+  /// Otherwise use a pointer on a mpz_class.
+  union {
+    int64_t i; /// Used to store the 64 bits integer value.
+    mpz_class* p; /// Used to store the larger integer value.
+  } _n;
+  bool _small;
 
 public:
   /// \brief Create a ZNumber from a string representation
@@ -324,53 +453,216 @@ public:
     }
   }
 
+private:
+  /// \brief Return true if the number is stored as an int64_t
+  bool is_small() const { return ikos_likely(this->_small); }
+
+  /// \brief Return true if the number is stored as a mpz_class
+  bool is_large() const { return !this->is_small(); }
+
+  /// \brief Return true if the number is zero
+  bool is_zero() const { return this->is_small() && this->_n.i == 0; }
+
+  /// \brief Return the sign of the number (-1, 0 or 1)
+  int sgn() const {
+    if (this->is_small()) {
+      return (this->_n.i > 0) - (this->_n.i < 0);
+    } else {
+      return mpz_sgn(this->_n.p->get_mpz_t());
+    }
+  }
+
+  /// \brief Set the number to the given int64_t
+  void set(int64_t n) {
+    if (this->is_large()) {
+      delete this->_n.p;
+      this->_small = true;
+    }
+    this->_n.i = n;
+  }
+
+  /// \brief Set the number to the given mpz_class
+  ///
+  /// Use the int64_t representation if the number fits.
+  void set(mpz_class&& n) {
+    if (detail::MpzFits< int64_t >()(n)) {
+      this->set(detail::MpzTo< int64_t >()(n));
+    } else if (this->is_small()) {
+      this->_n.p = new mpz_class(std::move(n));
+      this->_small = false;
+    } else {
+      *this->_n.p = std::move(n);
+    }
+  }
+
+  /// \brief Return a reference on the number as a mpz_class
+  ///
+  /// If the number is stored as an int64_t, `tmp` is used as storage.
+  const mpz_class& mpz_ref(mpz_class& tmp) const {
+    if (this->is_small()) {
+      tmp = detail::MpzAdapter< int64_t >()(this->_n.i);
+      return tmp;
+    } else {
+      return *this->_n.p;
+    }
+  }
+
+  /// \brief Compare two numbers
+  ///
+  /// Return a negative value if `a < b`, zero if `a == b`, or a positive value
+  /// if `a > b`.
+  static int compare(const ZNumber& a, const ZNumber& b) {
+    if (a.is_small() && b.is_small()) {
+      return (a._n.i > b._n.i) - (a._n.i < b._n.i);
+    } else if (a.is_small()) {
+      // b does not fit in an int64_t
+      return -mpz_sgn(b._n.p->get_mpz_t());
+    } else if (b.is_small()) {
+      // a does not fit in an int64_t
+      return mpz_sgn(a._n.p->get_mpz_t());
+    } else {
+      return mpz_cmp(a._n.p->get_mpz_t(), b._n.p->get_mpz_t());
+    }
+  }
+
+  /// \brief Left binary shift by `s` bits
+  void shl(unsigned long s) {
+    if (this->is_small()) {
+      if (this->_n.i == 0) {
+        return;
+      }
+      if (s < 63) {
+        auto r =
+            static_cast< int64_t >(static_cast< uint64_t >(this->_n.i) << s);
+        if ((r >> s) == this->_n.i) {
+          this->_n.i = r;
+          return;
+        }
+      }
+    }
+    mpz_class tmp;
+    this->set(this->mpz_ref(tmp) << s);
+  }
+
+  /// \brief Right binary shift by `s` bits, with rounding towards -oo
+  void shr(unsigned long s) {
+    if (this->is_small()) {
+      if (s < 64) {
+        this->_n.i >>= s;
+      } else {
+        this->_n.i = (this->_n.i < 0) ? -1 : 0;
+      }
+    } else {
+      this->set(*this->_n.p >> s);
+    }
+  }
+
+public:
   /// \name Constructors
   /// @{
 
   /// \brief Default constructor that creates a ZNumber equals to 0
-  ZNumber() = default;
+  ZNumber() noexcept : _n{0}, _small(true) {}
 
   /// \brief Copy constructor
-  ZNumber(const ZNumber&) = default;
+  ZNumber(const ZNumber& o) : _small(o._small) {
+    if (o.is_small()) {
+      this->_n.i = o._n.i;
+    } else {
+      this->_n.p = new mpz_class(*o._n.p);
+    }
+  }
 
   /// \brief Move constructor
-  ZNumber(ZNumber&&) = default;
+  ZNumber(ZNumber&& o) noexcept : _n(o._n), _small(o._small) {
+    o._n.i = 0;
+    o._small = true;
+  }
 
   /// \brief Create a ZNumber from a mpz_class
-  explicit ZNumber(const mpz_class& n) : _n(n) {}
+  explicit ZNumber(const mpz_class& n) : _n{0}, _small(true) {
+    this->set(mpz_class(n));
+  }
 
   /// \brief Create a ZNumber from a mpz_class
-  explicit ZNumber(mpz_class&& n) : _n(std::move(n)) {}
+  explicit ZNumber(mpz_class&& n) : _n{0}, _small(true) {
+    this->set(std::move(n));
+  }
 
   /// \brief Create a ZNumber from an integral type
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
-  explicit ZNumber(T n) : _n(detail::MpzAdapter< T >()(n)) {}
+  explicit ZNumber(T n) : _n{0}, _small(true) {
+    if (ikos_likely(detail::IntegralFitsInt64< T >()(n))) {
+      this->_n.i = static_cast< int64_t >(n);
+    } else {
+      this->_n.p = new mpz_class(detail::MpzAdapter< T >()(n));
+      this->_small = false;
+    }
+  }
 
   /// \brief Destructor
-  ~ZNumber() = default;
+  ~ZNumber() {
+    if (this->is_large()) {
+      delete this->_n.p;
+    }
+  }
 
   /// @}
   /// \name Assignment Operators
   /// @{
 
   /// \brief Copy assignment
-  ZNumber& operator=(const ZNumber&) = default;
+  ZNumber& operator=(const ZNumber& o) {
+    if (this == &o) {
+      return *this;
+    }
+
+    if (o.is_small()) {
+      this->set(o._n.i);
+    } else if (this->is_small()) {
+      this->_n.p = new mpz_class(*o._n.p);
+      this->_small = false;
+    } else {
+      *this->_n.p = *o._n.p;
+    }
+    return *this;
+  }
 
   /// \brief Move assignment
-  ZNumber& operator=(ZNumber&&) noexcept = default;
+  ZNumber& operator=(ZNumber&& o) noexcept {
+    if (this == &o) {
+      return *this;
+    }
+
+    if (this->is_large()) {
+      delete this->_n.p;
+    }
+
+    this->_n = o._n;
+    this->_small = o._small;
+    o._n.i = 0;
+    o._small = true;
+    return *this;
+  }
 
   /// \brief Assignment for integral types
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator=(T n) {
-    this->_n = detail::MpzAdapter< T >()(n);
-    return *this;
+    return *this = ZNumber(n);
   }
 
   /// \brief Addition assignment
   ZNumber& operator+=(const ZNumber& x) {
-    this->_n += x._n;
+    int64_t r;
+    if (this->is_small() && x.is_small() &&
+        ikos_likely(!detail::add_overflow(this->_n.i, x._n.i, r))) {
+      this->_n.i = r;
+      return *this;
+    }
+    mpz_class a, b;
+    this->set(this->mpz_ref(a) + x.mpz_ref(b));
     return *this;
   }
 
@@ -378,13 +670,19 @@ public:
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator+=(T x) {
-    this->_n += detail::MpzAdapter< T >()(x);
-    return *this;
+    return *this += ZNumber(x);
   }
 
   /// \brief Subtraction assignment
   ZNumber& operator-=(const ZNumber& x) {
-    this->_n -= x._n;
+    int64_t r;
+    if (this->is_small() && x.is_small() &&
+        ikos_likely(!detail::sub_overflow(this->_n.i, x._n.i, r))) {
+      this->_n.i = r;
+      return *this;
+    }
+    mpz_class a, b;
+    this->set(this->mpz_ref(a) - x.mpz_ref(b));
     return *this;
   }
 
@@ -392,13 +690,19 @@ public:
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator-=(T x) {
-    this->_n -= detail::MpzAdapter< T >()(x);
-    return *this;
+    return *this -= ZNumber(x);
   }
 
   /// \brief Multiplication assignment
   ZNumber& operator*=(const ZNumber& x) {
-    this->_n *= x._n;
+    int64_t r;
+    if (this->is_small() && x.is_small() &&
+        ikos_likely(!detail::mul_overflow(this->_n.i, x._n.i, r))) {
+      this->_n.i = r;
+      return *this;
+    }
+    mpz_class a, b;
+    this->set(this->mpz_ref(a) * x.mpz_ref(b));
     return *this;
   }
 
@@ -406,16 +710,22 @@ public:
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator*=(T x) {
-    this->_n *= detail::MpzAdapter< T >()(x);
-    return *this;
+    return *this *= ZNumber(x);
   }
 
   /// \brief Integer division assignment
   ///
   /// Integer division with rounding towards zero.
   ZNumber& operator/=(const ZNumber& x) {
-    ikos_assert_msg(x._n != 0, "division by zero");
-    this->_n /= x._n;
+    ikos_assert_msg(!x.is_zero(), "division by zero");
+    if (this->is_small() && x.is_small() &&
+        ikos_likely(this->_n.i != std::numeric_limits< int64_t >::min() ||
+                    x._n.i != -1)) {
+      this->_n.i /= x._n.i;
+      return *this;
+    }
+    mpz_class a, b;
+    this->set(this->mpz_ref(a) / x.mpz_ref(b));
     return *this;
   }
 
@@ -426,8 +736,7 @@ public:
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator/=(T x) {
     ikos_assert_msg(x != 0, "division by zero");
-    this->_n /= detail::MpzAdapter< T >()(x);
-    return *this;
+    return *this /= ZNumber(x);
   }
 
   /// \brief Remainder assignment
@@ -438,8 +747,13 @@ public:
   /// The sign of `x` is ignored, and the result will have the same sign as
   /// `this`.
   ZNumber& operator%=(const ZNumber& x) {
-    ikos_assert_msg(x._n != 0, "division by zero");
-    this->_n %= x._n;
+    ikos_assert_msg(!x.is_zero(), "division by zero");
+    if (this->is_small() && x.is_small()) {
+      this->_n.i = (x._n.i == -1) ? 0 : this->_n.i % x._n.i;
+      return *this;
+    }
+    mpz_class a, b;
+    this->set(this->mpz_ref(a) % x.mpz_ref(b));
     return *this;
   }
 
@@ -454,13 +768,17 @@ public:
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator%=(T x) {
     ikos_assert_msg(x != 0, "division by zero");
-    this->_n %= detail::MpzAdapter< T >()(x);
-    return *this;
+    return *this %= ZNumber(x);
   }
 
   /// \brief Bitwise AND assignment
   ZNumber& operator&=(const ZNumber& x) {
-    this->_n &= x._n;
+    if (this->is_small() && x.is_small()) {
+      this->_n.i &= x._n.i;
+      return *this;
+    }
+    mpz_class a, b;
+    this->set(this->mpz_ref(a) & x.mpz_ref(b));
     return *this;
   }
 
@@ -468,13 +786,17 @@ public:
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator&=(T x) {
-    this->_n &= detail::MpzAdapter< T >()(x);
-    return *this;
+    return *this &= ZNumber(x);
   }
 
   /// \brief Bitwise OR assignment
   ZNumber& operator|=(const ZNumber& x) {
-    this->_n |= x._n;
+    if (this->is_small() && x.is_small()) {
+      this->_n.i |= x._n.i;
+      return *this;
+    }
+    mpz_class a, b;
+    this->set(this->mpz_ref(a) | x.mpz_ref(b));
     return *this;
   }
 
@@ -482,13 +804,17 @@ public:
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator|=(T x) {
-    this->_n |= detail::MpzAdapter< T >()(x);
-    return *this;
+    return *this |= ZNumber(x);
   }
 
   /// \brief Bitwise XOR assignment
   ZNumber& operator^=(const ZNumber& x) {
-    this->_n ^= x._n;
+    if (this->is_small() && x.is_small()) {
+      this->_n.i ^= x._n.i;
+      return *this;
+    }
+    mpz_class a, b;
+    this->set(this->mpz_ref(a) ^ x.mpz_ref(b));
     return *this;
   }
 
@@ -496,17 +822,16 @@ public:
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator^=(T x) {
-    this->_n ^= detail::MpzAdapter< T >()(x);
-    return *this;
+    return *this ^= ZNumber(x);
   }
 
   /// \brief Left binary shift assignment
   ///
   /// This is undefined if `x` isn't between 0 and 2**32 - 1
   ZNumber& operator<<=(const ZNumber& x) {
-    ikos_assert_msg(x._n >= 0, "shift count is negative");
-    ikos_assert_msg(x._n.fits_ulong_p(), "shift count is too big");
-    this->_n <<= x._n.get_ui();
+    ikos_assert_msg(x.sgn() >= 0, "shift count is negative");
+    ikos_assert_msg(x.fits< unsigned long >(), "shift count is too big");
+    this->shl(x.to< unsigned long >());
     return *this;
   }
 
@@ -517,7 +842,7 @@ public:
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator<<=(T x) {
     ikos_assert_msg(x >= 0, "shift count is negative");
-    this->_n <<= static_cast< unsigned long int >(x);
+    this->shl(static_cast< unsigned long int >(x));
     return *this;
   }
 
@@ -525,9 +850,9 @@ public:
   ///
   /// This is undefined if `x` isn't between 0 and 2**32 - 1
   ZNumber& operator>>=(const ZNumber& x) {
-    ikos_assert_msg(x._n >= 0, "shift count is negative");
-    ikos_assert_msg(x._n.fits_ulong_p(), "shift count is too big");
-    this->_n >>= x._n.get_ui();
+    ikos_assert_msg(x.sgn() >= 0, "shift count is negative");
+    ikos_assert_msg(x.fits< unsigned long >(), "shift count is too big");
+    this->shr(x.to< unsigned long >());
     return *this;
   }
 
@@ -538,7 +863,7 @@ public:
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator>>=(T x) {
     ikos_assert_msg(x >= 0, "shift count is negative");
-    this->_n >>= static_cast< unsigned long int >(x);
+    this->shr(static_cast< unsigned long int >(x));
     return *this;
   }
 
@@ -551,30 +876,49 @@ public:
 
   /// \brief Prefix increment
   ZNumber& operator++() {
-    ++this->_n;
+    if (this->is_small() &&
+        ikos_likely(this->_n.i != std::numeric_limits< int64_t >::max())) {
+      ++this->_n.i;
+      return *this;
+    }
+    mpz_class tmp;
+    this->set(this->mpz_ref(tmp) + 1);
     return *this;
   }
 
   /// \brief Postfix increment
   const ZNumber operator++(int) {
     ZNumber r(*this);
-    ++this->_n;
+    ++(*this);
     return r;
   }
 
   /// \brief Unary minus
-  const ZNumber operator-() const { return ZNumber(-this->_n); }
+  const ZNumber operator-() const {
+    if (this->is_small() &&
+        ikos_likely(this->_n.i != std::numeric_limits< int64_t >::min())) {
+      return ZNumber(-this->_n.i);
+    }
+    mpz_class tmp;
+    return ZNumber(mpz_class(-this->mpz_ref(tmp)));
+  }
 
   /// \brief Prefix decrement
   ZNumber& operator--() {
-    --this->_n;
+    if (this->is_small() &&
+        ikos_likely(this->_n.i != std::numeric_limits< int64_t >::min())) {
+      --this->_n.i;
+      return *this;
+    }
+    mpz_class tmp;
+    this->set(this->mpz_ref(tmp) - 1);
     return *this;
   }
 
   /// \brief Postfix decrement
   const ZNumber operator--(int) {
     ZNumber r(*this);
-    --this->_n;
+    --(*this);
     return r;
   }
 
@@ -582,14 +926,17 @@ public:
   ///
   /// This is undefined for negative numbers.
   ZNumber next_power_of_2() const {
-    ikos_assert(this->_n >= 0);
+    ikos_assert(this->sgn() >= 0);
 
-    if (this->_n <= 1) {
+    if (this->is_small() && this->_n.i <= 1) {
       return ZNumber(1);
     }
 
-    ZNumber n(this->_n - 1);
-    return ZNumber(mpz_class(1) << n.size_in_bits());
+    ZNumber n(*this);
+    --n;
+    ZNumber r(1);
+    r.shl(n.size_in_bits());
+    return r;
   }
 
   /// @}
@@ -600,56 +947,114 @@ public:
   ///
   /// This is undefined if the number is 0.
   uint64_t trailing_zeros() const {
-    ikos_assert(this->_n != 0);
-    return mpz_scan1(this->_n.get_mpz_t(), 0);
+    ikos_assert(!this->is_zero());
+    if (this->is_small()) {
+      return __builtin_ctzll(static_cast< uint64_t >(this->_n.i));
+    } else {
+      return mpz_scan1(this->_n.p->get_mpz_t(), 0);
+    }
   }
 
   /// \brief Return the number of trailing '1' bits
   ///
   /// This is undefined if the number is -1.
   uint64_t trailing_ones() const {
-    ikos_assert(this->_n != -1);
-    return mpz_scan0(this->_n.get_mpz_t(), 0);
+    ikos_assert(!(this->is_small() && this->_n.i == -1));
+    if (this->is_small()) {
+      return __builtin_ctzll(~static_cast< uint64_t >(this->_n.i));
+    } else {
+      return mpz_scan0(this->_n.p->get_mpz_t(), 0);
+    }
   }
 
   /// \brief Return the number of bits
   ///
   /// The sign is ignored.
   uint64_t size_in_bits() const {
-    return mpz_sizeinbase(this->_n.get_mpz_t(), 2);
+    if (this->is_small()) {
+      if (this->_n.i == 0) {
+        return 1;
+      }
+      return 64 - __builtin_clzll(detail::int64_magnitude(this->_n.i));
+    } else {
+      return mpz_sizeinbase(this->_n.p->get_mpz_t(), 2);
+    }
   }
 
   /// @}
   /// \name Conversion Functions
   /// @{
 
-  /// \brief Get the internal representation
-  const mpz_class& mpz() const { return this->_n; }
+  /// \brief Return the number as a mpz_class
+  mpz_class mpz() const& {
+    if (this->is_small()) {
+      return mpz_class(detail::MpzAdapter< int64_t >()(this->_n.i));
+    } else {
+      return *this->_n.p;
+    }
+  }
+
+  /// \brief Return the number as a mpz_class
+  mpz_class mpz() && {
+    if (this->is_small()) {
+      return mpz_class(detail::MpzAdapter< int64_t >()(this->_n.i));
+    } else {
+      return std::move(*this->_n.p);
+    }
+  }
 
   /// \brief Return true if the number fits in the given integer type
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   bool fits() const {
-    return detail::MpzFits< T >()(this->_n);
+    if (this->is_small()) {
+      return detail::Int64FitsIntegral< T >()(this->_n.i);
+    } else {
+      return detail::MpzFits< T >()(*this->_n.p);
+    }
   }
 
   /// \brief Return the number as the given integer type
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   T to() const {
-    ikos_assert_msg(detail::MpzFits< T >()(this->_n), "does not fit");
-    return detail::MpzTo< T >()(this->_n);
+    ikos_assert_msg(this->fits< T >(), "does not fit");
+    if (this->is_small()) {
+      return static_cast< T >(this->_n.i);
+    } else {
+      return detail::MpzTo< T >()(*this->_n.p);
+    }
   }
 
   /// \brief Return a string representation of the ZNumber in the given base
   ///
   /// The base can vary from 2 to 36, or from -2 to -36
-  std::string str(int base = 10) const { return this->_n.get_str(base); }
+  std::string str(int base = 10) const {
+    if (this->is_small() && base == 10) {
+      return std::to_string(this->_n.i);
+    }
+    mpz_class tmp;
+    return this->mpz_ref(tmp).get_str(base);
+  }
 
   /// @}
 
+  friend bool operator==(const ZNumber&, const ZNumber&);
+
+  friend bool operator!=(const ZNumber&, const ZNumber&);
+
+  friend bool operator<(const ZNumber&, const ZNumber&);
+
+  friend bool operator<=(const ZNumber&, const ZNumber&);
+
+  friend bool operator>(const ZNumber&, const ZNumber&);
+
+  friend bool operator>=(const ZNumber&, const ZNumber&);
+
   friend ZNumber mod(const ZNumber&, const ZNumber&);
 
+  friend ZNumber abs(const ZNumber&);
+
   friend ZNumber gcd(const ZNumber&, const ZNumber&);
 
   friend ZNumber lcm(const ZNumber&, const ZNumber&);
@@ -657,9 +1062,11 @@ public:
   friend void gcd_extended(
       const ZNumber&, const ZNumber&, ZNumber&, ZNumber&, ZNumber&);
 
+  friend std::ostream& operator<<(std::ostream& o, const ZNumber& n);
+
   friend std::istream& operator>>(std::istream& i, ZNumber& n);
 
-  friend class QNumber;
+  friend std::size_t hash_value(const ZNumber&);
 
 }; // end class ZNumber
 
@@ -668,67 +1075,74 @@ public:
 
 /// \brief Addition
 inline ZNumber operator+(const ZNumber& lhs, const ZNumber& rhs) {
-  return ZNumber(lhs.mpz() + rhs.mpz());
+  ZNumber r(lhs);
+  r += rhs;
+  return r;
 }
 
 /// \brief Addition with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator+(const ZNumber& lhs, T rhs) {
-  return ZNumber(lhs.mpz() + detail::MpzAdapter< T >()(rhs));
+  return lhs + ZNumber(rhs);
 }
 
 /// \brief Addition with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator+(T lhs, const ZNumber& rhs) {
-  return ZNumber(detail::MpzAdapter< T >()(lhs) + rhs.mpz());
+  return ZNumber(lhs) + rhs;
 }
 
 /// \brief Subtraction
 inline ZNumber operator-(const ZNumber& lhs, const ZNumber& rhs) {
-  return ZNumber(lhs.mpz() - rhs.mpz());
+  ZNumber r(lhs);
+  r -= rhs;
+  return r;
 }
 
 /// \brief Subtraction with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator-(const ZNumber& lhs, T rhs) {
-  return ZNumber(lhs.mpz() - detail::MpzAdapter< T >()(rhs));
+  return lhs - ZNumber(rhs);
 }
 
 /// \brief Subtraction with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator-(T lhs, const ZNumber& rhs) {
-  return ZNumber(detail::MpzAdapter< T >()(lhs) - rhs.mpz());
+  return ZNumber(lhs) - rhs;
 }
 
 /// \brief Multiplication
 inline ZNumber operator*(const ZNumber& lhs, const ZNumber& rhs) {
-  return ZNumber(lhs.mpz() * rhs.mpz());
+  ZNumber r(lhs);
+  r *= rhs;
+  return r;
 }
 
 /// \brief Multiplication with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator*(const ZNumber& lhs, T rhs) {
-  return ZNumber(lhs.mpz() * detail::MpzAdapter< T >()(rhs));
+  return lhs * ZNumber(rhs);
 }
 
 /// \brief Multiplication with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator*(T lhs, const ZNumber& rhs) {
-  return ZNumber(detail::MpzAdapter< T >()(lhs) * rhs.mpz());
+  return ZNumber(lhs) * rhs;
 }
 
 /// \brief Integer division
 ///
 /// Integer division with rounding towards zero.
 inline ZNumber operator/(const ZNumber& lhs, const ZNumber& rhs) {
-  ikos_assert_msg(rhs.mpz() != 0, "division by zero");
-  return ZNumber(lhs.mpz() / rhs.mpz());
+  ZNumber r(lhs);
+  r /= rhs;
+  return r;
 }
 
 /// \brief Integer division with integral types
@@ -738,7 +1152,7 @@ template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator/(const ZNumber& lhs, T rhs) {
   ikos_assert_msg(rhs != 0, "division by zero");
-  return ZNumber(lhs.mpz() / detail::MpzAdapter< T >()(rhs));
+  return lhs / ZNumber(rhs);
 }
 
 /// \brief Integer division with integral types
@@ -747,8 +1161,7 @@ inline ZNumber operator/(const ZNumber& lhs, T rhs) {
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator/(T lhs, const ZNumber& rhs) {
-  ikos_assert_msg(rhs.mpz() != 0, "division by zero");
-  return ZNumber(detail::MpzAdapter< T >()(lhs) / rhs.mpz());
+  return ZNumber(lhs) / rhs;
 }
 
 /// \brief Remainder
@@ -759,8 +1172,9 @@ inline ZNumber operator/(T lhs, const ZNumber& rhs) {
 /// The sign of `rhs` is ignored, and the result will have the same sign as
 /// `lhs`.
 inline ZNumber operator%(const ZNumber& lhs, const ZNumber& rhs) {
-  ikos_assert_msg(rhs.mpz() != 0, "division by zero");
-  return ZNumber(lhs.mpz() % rhs.mpz());
+  ZNumber r(lhs);
+  r %= rhs;
+  return r;
 }
 
 /// \brief Remainder with integral types
@@ -774,7 +1188,7 @@ template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator%(const ZNumber& lhs, T rhs) {
   ikos_assert_msg(rhs != 0, "division by zero");
-  return ZNumber(lhs.mpz() % detail::MpzAdapter< T >()(rhs));
+  return lhs % ZNumber(rhs);
 }
 
 /// \brief Remainder with integral types
@@ -787,74 +1201,79 @@ inline ZNumber operator%(const ZNumber& lhs, T rhs) {
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator%(T lhs, const ZNumber& rhs) {
-  ikos_assert_msg(rhs.mpz() != 0, "division by zero");
-  return ZNumber(detail::MpzAdapter< T >()(lhs) % rhs.mpz());
+  return ZNumber(lhs) % rhs;
 }
 
 /// \brief Bitwise AND
 inline ZNumber operator&(const ZNumber& lhs, const ZNumber& rhs) {
-  return ZNumber(lhs.mpz() & rhs.mpz());
+  ZNumber r(lhs);
+  r &= rhs;
+  return r;
 }
 
 /// \brief Bitwise AND with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator&(const ZNumber& lhs, T rhs) {
-  return ZNumber(lhs.mpz() & detail::MpzAdapter< T >()(rhs));
+  return lhs & ZNumber(rhs);
 }
 
 /// \brief Bitwise AND with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator&(T lhs, const ZNumber& rhs) {
-  return ZNumber(detail::MpzAdapter< T >()(lhs) & rhs.mpz());
+  return ZNumber(lhs) & rhs;
 }
 
 /// \brief Bitwise OR
 inline ZNumber operator|(const ZNumber& lhs, const ZNumber& rhs) {
-  return ZNumber(lhs.mpz() | rhs.mpz());
+  ZNumber r(lhs);
+  r |= rhs;
+  return r;
 }
 
 /// \brief Bitwise OR with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator|(const ZNumber& lhs, T rhs) {
-  return ZNumber(lhs.mpz() | detail::MpzAdapter< T >()(rhs));
+  return lhs | ZNumber(rhs);
 }
 
 /// \brief Bitwise OR with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator|(T lhs, const ZNumber& rhs) {
-  return ZNumber(detail::MpzAdapter< T >()(lhs) | rhs.mpz());
+  return ZNumber(lhs) | rhs;
 }
 
 /// \brief Bitwise XOR
 inline ZNumber operator^(const ZNumber& lhs, const ZNumber& rhs) {
-  return ZNumber(lhs.mpz() ^ rhs.mpz());
+  ZNumber r(lhs);
+  r ^= rhs;
+  return r;
 }
 
 /// \brief Bitwise XOR with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator^(const ZNumber& lhs, T rhs) {
-  return ZNumber(lhs.mpz() ^ detail::MpzAdapter< T >()(rhs));
+  return lhs ^ ZNumber(rhs);
 }
 
 /// \brief Bitwise XOR with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator^(T lhs, const ZNumber& rhs) {
-  return ZNumber(detail::MpzAdapter< T >()(lhs) ^ rhs.mpz());
+  return ZNumber(lhs) ^ rhs;
 }
 
 /// \brief Left binary shift
 ///
 /// This is undefined if `rhs` isn't between 0 and 2**32 - 1
 inline ZNumber operator<<(const ZNumber& lhs, const ZNumber& rhs) {
-  ikos_assert_msg(rhs.mpz() >= 0, "shift count is negative");
-  ikos_assert_msg(rhs.mpz().fits_ulong_p(), "shift count is too big");
-  return ZNumber(lhs.mpz() << rhs.mpz().get_ui());
+  ZNumber r(lhs);
+  r <<= rhs;
+  return r;
 }
 
 /// \brief Left binary shift with integral types
@@ -863,8 +1282,9 @@ inline ZNumber operator<<(const ZNumber& lhs, const ZNumber& rhs) {
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator<<(const ZNumber& lhs, T rhs) {
-  ikos_assert_msg(rhs >= 0, "shift count is negative");
-  return ZNumber(lhs.mpz() << static_cast< unsigned long int >(rhs));
+  ZNumber r(lhs);
+  r <<= rhs;
+  return r;
 }
 
 /// \brief Left binary shift with integral types
@@ -882,9 +1302,9 @@ inline ZNumber operator<<(T lhs, const ZNumber& rhs) {
 ///
 /// This is undefined if `rhs` isn't between 0 and 2**32 - 1
 inline ZNumber operator>>(const ZNumber& lhs, const ZNumber& rhs) {
-  ikos_assert_msg(rhs.mpz() >= 0, "shift count is negative");
-  ikos_assert_msg(rhs.mpz().fits_ulong_p(), "shift count is too big");
-  return ZNumber(lhs.mpz() >> rhs.mpz().get_ui());
+  ZNumber r(lhs);
+  r >>= rhs;
+  return r;
 }
 
 /// \brief Right binary shift with integral types
@@ -893,8 +1313,9 @@ inline ZNumber operator>>(const ZNumber& lhs, const ZNumber& rhs) {
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator>>(const ZNumber& lhs, T rhs) {
-  ikos_assert_msg(rhs >= 0, "shift count is negative");
-  return ZNumber(lhs.mpz() >> static_cast< unsigned long int >(rhs));
+  ZNumber r(lhs);
+  r >>= rhs;
+  return r;
 }
 
 /// \brief Right binary shift with integral types
@@ -914,116 +1335,116 @@ inline ZNumber operator>>(T lhs, const ZNumber& rhs) {
 
 /// \brief Equality operator
 inline bool operator==(const ZNumber& lhs, const ZNumber& rhs) {
-  return lhs.mpz() == rhs.mpz();
+  return ZNumber::compare(lhs, rhs) == 0;
 }
 
 /// \brief Equality operator with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator==(const ZNumber& lhs, T rhs) {
-  return lhs.mpz() == detail::MpzAdapter< T >()(rhs);
+  return lhs == ZNumber(rhs);
 }
 
 /// \brief Equality operator with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator==(T lhs, const ZNumber& rhs) {
-  return detail::MpzAdapter< T >()(lhs) == rhs.mpz();
+  return ZNumber(lhs) == rhs;
 }
 
 /// \brief Inequality operator
 inline bool operator!=(const ZNumber& lhs, const ZNumber& rhs) {
-  return lhs.mpz() != rhs.mpz();
+  return ZNumber::compare(lhs, rhs) != 0;
 }
 
 /// \brief Inequality operator with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator!=(const ZNumber& lhs, T rhs) {
-  return lhs.mpz() != detail::MpzAdapter< T >()(rhs);
+  return lhs != ZNumber(rhs);
 }
 
 /// \brief Inequality operator with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator!=(T lhs, const ZNumber& rhs) {
-  return detail::MpzAdapter< T >()(lhs) != rhs.mpz();
+  return ZNumber(lhs) != rhs;
 }
 
 /// \brief Less than comparison
 inline bool operator<(const ZNumber& lhs, const ZNumber& rhs) {
-  return lhs.mpz() < rhs.mpz();
+  return ZNumber::compare(lhs, rhs) < 0;
 }
 
 /// \brief Less than comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator<(const ZNumber& lhs, T rhs) {
-  return lhs.mpz() < detail::MpzAdapter< T >()(rhs);
+  return lhs < ZNumber(rhs);
 }
 
 /// \brief Less than comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator<(T lhs, const ZNumber& rhs) {
-  return detail::MpzAdapter< T >()(lhs) < rhs.mpz();
+  return ZNumber(lhs) < rhs;
 }
 
 /// \brief Less or equal comparison
 inline bool operator<=(const ZNumber& lhs, const ZNumber& rhs) {
-  return lhs.mpz() <= rhs.mpz();
+  return ZNumber::compare(lhs, rhs) <= 0;
 }
 
 /// \brief Less or equal comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator<=(const ZNumber& lhs, T rhs) {
-  return lhs.mpz() <= detail::MpzAdapter< T >()(rhs);
+  return lhs <= ZNumber(rhs);
 }
 
 /// \brief Less or equal comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator<=(T lhs, const ZNumber& rhs) {
-  return detail::MpzAdapter< T >()(lhs) <= rhs.mpz();
+  return ZNumber(lhs) <= rhs;
 }
 
 /// \brief Greater than comparison
 inline bool operator>(const ZNumber& lhs, const ZNumber& rhs) {
-  return lhs.mpz() > rhs.mpz();
+  return ZNumber::compare(lhs, rhs) > 0;
 }
 
 /// \brief Greater than comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator>(const ZNumber& lhs, T rhs) {
-  return lhs.mpz() > detail::MpzAdapter< T >()(rhs);
+  return lhs > ZNumber(rhs);
 }
 
 /// \brief Greater than comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator>(T lhs, const ZNumber& rhs) {
-  return detail::MpzAdapter< T >()(lhs) > rhs.mpz();
+  return ZNumber(lhs) > rhs;
 }
 
 /// \brief Greater or equal comparison
 inline bool operator>=(const ZNumber& lhs, const ZNumber& rhs) {
-  return lhs.mpz() >= rhs.mpz();
+  return ZNumber::compare(lhs, rhs) >= 0;
 }
 
 /// \brief Greater or equal comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator>=(const ZNumber& lhs, T rhs) {
-  return lhs.mpz() >= detail::MpzAdapter< T >()(rhs);
+  return lhs >= ZNumber(rhs);
 }
 
 /// \brief Greater or equal comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator>=(T lhs, const ZNumber& rhs) {
-  return detail::MpzAdapter< T >()(lhs) >= rhs.mpz();
+  return ZNumber(lhs) >= rhs;
 }
 
 /// @}
@@ -1077,15 +1498,26 @@ inline const ZNumber& max(const ZNumber& a,
 ///
 /// The sign of `d` is ignored, and the result is always non-negative.
 inline ZNumber mod(const ZNumber& n, const ZNumber& d) {
-  ikos_assert_msg(d.mpz() != 0, "division by zero");
-  ZNumber r;
-  mpz_mod(r._n.get_mpz_t(), n._n.get_mpz_t(), d._n.get_mpz_t());
-  return r;
+  ikos_assert_msg(!d.is_zero(), "division by zero");
+  if (n.is_small() && d.is_small()) {
+    int64_t r = (d._n.i == -1) ? 0 : n._n.i % d._n.i;
+    if (r < 0) {
+      r = (d._n.i < 0) ? r - d._n.i : r + d._n.i;
+    }
+    return ZNumber(r);
+  }
+  mpz_class r, a, b;
+  mpz_mod(r.get_mpz_t(), n.mpz_ref(a).get_mpz_t(), d.mpz_ref(b).get_mpz_t());
+  return ZNumber(std::move(r));
 }
 
 /// \brief Return the absolute value of the given number
 inline ZNumber abs(const ZNumber& n) {
-  return ZNumber(abs(n.mpz()));
+  if (n.is_small()) {
+    return ZNumber(detail::int64_magnitude(n._n.i));
+  } else {
+    return ZNumber(mpz_class(abs(*n._n.p)));
+  }
 }
 
 /// \brief Return the greatest common divisor of the given numbers
@@ -1094,9 +1526,13 @@ inline ZNumber abs(const ZNumber& n) {
 /// negative. Except if both inputs are zero; then this function defines
 /// `gcd(0, 0) = 0`.
 inline ZNumber gcd(const ZNumber& a, const ZNumber& b) {
-  ZNumber r;
-  mpz_gcd(r._n.get_mpz_t(), a._n.get_mpz_t(), b._n.get_mpz_t());
-  return r;
+  if (a.is_small() && b.is_small()) {
+    return ZNumber(detail::uint64_gcd(detail::int64_magnitude(a._n.i),
+                                      detail::int64_magnitude(b._n.i)));
+  }
+  mpz_class r, x, y;
+  mpz_gcd(r.get_mpz_t(), a.mpz_ref(x).get_mpz_t(), b.mpz_ref(y).get_mpz_t());
+  return ZNumber(std::move(r));
 }
 
 /// \brief Return the greatest common divisor of the given numbers
@@ -1106,9 +1542,21 @@ inline ZNumber gcd(const ZNumber& a, const ZNumber& b, const ZNumber& c) {
 
 /// \brief Return the least common multiple of the given numbers
 inline ZNumber lcm(const ZNumber& a, const ZNumber& b) {
-  ZNumber r;
-  mpz_lcm(r._n.get_mpz_t(), a._n.get_mpz_t(), b._n.get_mpz_t());
-  return r;
+  if (a.is_small() && b.is_small()) {
+    if (a._n.i == 0 || b._n.i == 0) {
+      return ZNumber(0);
+    }
+    uint64_t x = detail::int64_magnitude(a._n.i);
+    uint64_t y = detail::int64_magnitude(b._n.i);
+    uint64_t r;
+    x /= detail::uint64_gcd(x, y);
+    if (ikos_likely(!detail::mul_overflow(x, y, r))) {
+      return ZNumber(r);
+    }
+  }
+  mpz_class r, x, y;
+  mpz_lcm(r.get_mpz_t(), a.mpz_ref(x).get_mpz_t(), b.mpz_ref(y).get_mpz_t());
+  return ZNumber(std::move(r));
 }
 
 /// \brief Run Euclid's algorithm
@@ -1119,11 +1567,15 @@ inline ZNumber lcm(const ZNumber& a, const ZNumber& b) {
 /// negative (or zero if both inputs are zero).
 inline void gcd_extended(
     const ZNumber& a, const ZNumber& b, ZNumber& g, ZNumber& u, ZNumber& v) {
-  mpz_gcdext(g._n.get_mpz_t(),
-             u._n.get_mpz_t(),
-             v._n.get_mpz_t(),
-             a._n.get_mpz_t(),
-             b._n.get_mpz_t());
+  mpz_class mg, mu, mv, x, y;
+  mpz_gcdext(mg.get_mpz_t(),
+             mu.get_mpz_t(),
+             mv.get_mpz_t(),
+             a.mpz_ref(x).get_mpz_t(),
+             b.mpz_ref(y).get_mpz_t());
+  g.set(std::move(mg));
+  u.set(std::move(mu));
+  v.set(std::move(mv));
 }
 
 /// @}
@@ -1132,13 +1584,22 @@ inline void gcd_extended(
 
 /// \brief Write a ZNumber on a stream, in base 10
 inline std::ostream& operator<<(std::ostream& o, const ZNumber& n) {
-  o << n.mpz();
+  if (n.is_small() &&
+      (o.flags() & std::ios_base::basefield) == std::ios_base::dec) {
+    o << n._n.i;
+  } else {
+    mpz_class tmp;
+    o << n.mpz_ref(tmp);
+  }
   return o;
 }
 
 /// \brief Read a ZNumber from a stream, in base 10
 inline std::istream& operator>>(std::istream& i, ZNumber& n) {
-  i >> n._n;
+  mpz_class m;
+  if (i >> m) {
+    n.set(std::move(m));
+  }
   return i;
 }
 
@@ -1146,7 +1607,10 @@ inline std::istream& operator>>(std::istream& i, ZNumber& n) {
 
 /// \brief Return the hash of a ZNumber
 inline std::size_t hash_value(const ZNumber& n) {
-  const mpz_class& m = n.mpz();
+  if (n.is_small()) {
+    return boost::hash< int64_t >()(n._n.i);
+  }
+  const mpz_class& m = *n._n.p;
   std::size_t result = 0;
   boost::hash_combine(result, m.get_mpz_t()[0]._mp_size);
   for (int i = 0, e = std::abs(m.get_mpz_t()[0]._mp_size); i < e; ++i) {
@@ -43,6 +43,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include <ikos/core/support/mpl.hpp>
 
 namespace ikos {
@@ -75,6 +77,17 @@ namespace core {
 ///   Return iterators over the predecessors of the given node
 ///
 /// The GraphRef type should also be cheap to copy
+///
+/// Optionally, graphs with dense node indices can provide:
+///
+/// static std::size_t index(NodeRef)
+///   Return the index of the given node, in [0, num_nodes(GraphRef))
+///
+/// static std::size_t num_nodes(GraphRef)
+///   Return an upper bound on the node indices of the graph
+///
+/// Fixpoint iterators use these to store invariants in vectors instead of
+/// hash tables.
 template < typename GraphRef >
 struct GraphTraits {};
 
@@ -134,5 +147,27 @@ struct IsGraph<
             typename GraphTrait::PredecessorNodeIterator >::value > > >
     : std::true_type {};
 
+/// \brief Check if a type implements GraphTraits with dense node indices
+template < typename GraphRef,
+           typename GraphTrait = GraphTraits< GraphRef >,
+           typename = void >
+struct IsIndexedGraph : std::false_type {};
+
+template < typename GraphRef, typename GraphTrait >
+struct IsIndexedGraph<
+    GraphRef,
+    GraphTrait,
+    void_t<
+        // GraphTrait has: index(NodeRef) -> std::size_t
+        std::enable_if_t<
+            std::is_same< decltype(GraphTrait::index(
+                              std::declval< typename GraphTrait::NodeRef >())),
+                          std::size_t >::value >,
+        // GraphTrait has: num_nodes(GraphRef) -> std::size_t
+        std::enable_if_t< std::is_same< decltype(GraphTrait::num_nodes(
+                                            std::declval< GraphRef >())),
+                                        std::size_t >::value > > >
+    : IsGraph< GraphRef, GraphTrait > {};
+
 } // end namespace core
 } // end namespace ikos
@@ -68,6 +68,19 @@ using Index = std::uintptr_t;
 ///
 /// The trait has to be specialized for each specific type.
 ///
+/// Optionally, objects with dense indexes within a scope (e.g, the local
+/// variables of a function) can provide:
+///
+/// static Index scope(const T&)
+///   Return the index of the scope of the object, or 0 for the global scope
+///
+/// static std::size_t dense_index(const T&)
+///   Return the index of the object within its scope. Indexes of a scope are
+///   sequential, starting at 0, in order of creation.
+///
+/// Abstract domains can use these to store the objects of a scope in bitsets
+/// and vectors instead of patricia trees.
+///
 /// The traits can be used as:
 /// \code{.cpp}
 ///   Index index = IndexableTraits< VariableRef >::index(my_variable_ref);
@@ -97,5 +110,27 @@ struct IsIndexable<
                                         std::declval< T >())) >::value > >
     : std::true_type {};
 
+/// \brief Check if a type implements IndexableTraits with dense indexes
+template < typename T,
+           typename IndexableTrait = IndexableTraits< T >,
+           typename = void >
+struct IsDenselyIndexable : std::false_type {};
+
+template < typename T, typename IndexableTrait >
+struct IsDenselyIndexable<
+    T,
+    IndexableTrait,
+    void_t<
+        // IndexableTrait has: scope(const T&) -> Index
+        std::enable_if_t< std::is_same< Index,
+                                        decltype(IndexableTrait::scope(
+                                            std::declval< T >())) >::value >,
+        // IndexableTrait has: dense_index(const T&) -> std::size_t
+        std::enable_if_t<
+            std::is_same< std::size_t,
+                          decltype(IndexableTrait::dense_index(
+                              std::declval< T >())) >::value > > >
+    : IsIndexable< T, IndexableTrait > {};
+
 } // end namespace core
 } // end namespace ikos
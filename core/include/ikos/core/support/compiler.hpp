@@ -102,6 +102,18 @@
 # define ikos_attribute_unused
 #endif
 
+/// \macro ikos_attribute_target_clones
+/// \brief Compile the given function for several instruction sets, selecting
+/// the best one for the running processor when the program is loaded.
+///
+/// This requires ifunc support, hence it is only enabled on x86-64 ELF targets.
+#if __has_attribute(target_clones) && defined(__x86_64__) && defined(__ELF__)
+# define ikos_attribute_target_clones \
+    __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+# define ikos_attribute_target_clones
+#endif
+
 /// \macro ikos_ignore
 /// \brief Remove unused variable warnings for the given variable
 #define ikos_ignore(VAR) static_cast< void >(VAR)
@@ -0,0 +1,293 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Machine integer interval class with a bit-width known at compile
+ * time
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include <boost/optional.hpp>
+
+#include <ikos/core/number/fixed_machine_int.hpp>
+#include <ikos/core/number/z_number.hpp>
+
+namespace ikos {
+namespace core {
+namespace machine_int {
+
+/// \brief Machine integer interval with a bit-width and signedness known at
+/// compile time
+///
+/// This is used to compute the arithmetic operations of Interval without
+/// converting the bounds into unlimited precision integers, see
+/// dispatch_fixed_width().
+///
+/// Operations compute the exact bounds on 64-bit signed integers, then wrap or
+/// truncate them like Interval::from_z_interval(). They return boost::none if
+/// an exact bound does not fit in 64 bits.
+template < unsigned BitWidth, Signedness Sign >
+class FixedInterval {
+public:
+  using IntT = FixedMachineInt< BitWidth, Sign >;
+
+private:
+  // Lower bound
+  IntT _lb;
+
+  // Upper bound
+  IntT _ub;
+
+  // Invariant: is_bottom() <=> _lb > _ub
+
+public:
+  /// \brief Create the interval [lb, ub]
+  constexpr FixedInterval(IntT lb, IntT ub) : _lb(lb), _ub(ub) {}
+
+  /// \brief Create the top interval
+  static constexpr FixedInterval top() {
+    return FixedInterval(IntT::min(), IntT::max());
+  }
+
+  /// \brief Create the bottom interval
+  static constexpr FixedInterval bottom() {
+    return FixedInterval(IntT::max(), IntT::min());
+  }
+
+  /// \brief Return true if the interval is bottom
+  constexpr bool is_bottom() const { return this->_lb > this->_ub; }
+
+  /// \brief Return the lower bound
+  constexpr IntT lb() const { return this->_lb; }
+
+  /// \brief Return the upper bound
+  constexpr IntT ub() const { return this->_ub; }
+
+  /// \brief Return true if both bounds fit in an int64_t
+  constexpr bool fits_int64() const {
+    return this->_lb.fits_int64() && this->_ub.fits_int64();
+  }
+
+  /// \brief Convert the exact interval [lb, ub] with wrapping
+  ///
+  /// Precondition: lb <= ub
+  static FixedInterval wrap(int64_t lb, int64_t ub) {
+    uint64_t width = static_cast< uint64_t >(ub) - static_cast< uint64_t >(lb);
+    if (width > IntT::mask()) {
+      return top();
+    }
+
+    IntT i_lb = IntT::wrap(lb);
+    IntT i_ub = IntT::wrap(ub);
+    if (i_lb <= i_ub) {
+      return FixedInterval(i_lb, i_ub);
+    }
+    return top();
+  }
+
+  /// \brief Convert the exact interval [lb, ub] with truncation
+  ///
+  /// Precondition: lb <= ub
+  static FixedInterval trunc(int64_t lb, int64_t ub) {
+    const int64_t min = IntT::min().to_int64();
+    const int64_t max = IntT::max().fits_int64()
+                            ? IntT::max().to_int64()
+                            : std::numeric_limits< int64_t >::max();
+    lb = std::max(lb, min);
+    ub = std::min(ub, max);
+    if (lb > ub) {
+      return bottom();
+    }
+    return FixedInterval(IntT::wrap(lb), IntT::wrap(ub));
+  }
+
+}; // end class FixedInterval
+
+/// \name Binary Operators
+///
+/// Precondition: lhs and rhs are not bottom
+///
+/// @{
+
+/// \brief Compute the exact bounds of `lhs + rhs`
+///
+/// Return false if they do not fit in an int64_t.
+template < unsigned BitWidth, Signedness Sign >
+inline bool exact_add(const FixedInterval< BitWidth, Sign >& lhs,
+                      const FixedInterval< BitWidth, Sign >& rhs,
+                      int64_t& lb,
+                      int64_t& ub) {
+  if (!lhs.fits_int64() || !rhs.fits_int64()) {
+    return false;
+  }
+
+  int64_t l1 = lhs.lb().to_int64(), u1 = lhs.ub().to_int64();
+  int64_t l2 = rhs.lb().to_int64(), u2 = rhs.ub().to_int64();
+  return !core::detail::add_overflow(l1, l2, lb) &&
+         !core::detail::add_overflow(u1, u2, ub);
+}
+
+/// \brief Compute the exact bounds of `lhs - rhs`
+///
+/// Return false if they do not fit in an int64_t.
+template < unsigned BitWidth, Signedness Sign >
+inline bool exact_sub(const FixedInterval< BitWidth, Sign >& lhs,
+                      const FixedInterval< BitWidth, Sign >& rhs,
+                      int64_t& lb,
+                      int64_t& ub) {
+  if (!lhs.fits_int64() || !rhs.fits_int64()) {
+    return false;
+  }
+
+  int64_t l1 = lhs.lb().to_int64(), u1 = lhs.ub().to_int64();
+  int64_t l2 = rhs.lb().to_int64(), u2 = rhs.ub().to_int64();
+  return !core::detail::sub_overflow(l1, u2, lb) &&
+         !core::detail::sub_overflow(u1, l2, ub);
+}
+
+/// \brief Compute the exact bounds of `lhs * rhs`
+///
+/// Return false if they do not fit in an int64_t.
+template < unsigned BitWidth, Signedness Sign >
+inline bool exact_mul(const FixedInterval< BitWidth, Sign >& lhs,
+                      const FixedInterval< BitWidth, Sign >& rhs,
+                      int64_t& lb,
+                      int64_t& ub) {
+  if (!lhs.fits_int64() || !rhs.fits_int64()) {
+    return false;
+  }
+
+  int64_t l1 = lhs.lb().to_int64(), u1 = lhs.ub().to_int64();
+  int64_t l2 = rhs.lb().to_int64(), u2 = rhs.ub().to_int64();
+  int64_t ll, lu, ul, uu;
+  if (core::detail::mul_overflow(l1, l2, ll) ||
+      core::detail::mul_overflow(l1, u2, lu) ||
+      core::detail::mul_overflow(u1, l2, ul) ||
+      core::detail::mul_overflow(u1, u2, uu)) {
+    return false;
+  }
+
+  lb = std::min({ll, lu, ul, uu});
+  ub = std::max({ll, lu, ul, uu});
+  return true;
+}
+
+/// \brief Addition with wrapping
+template < unsigned BitWidth, Signedness Sign >
+inline boost::optional< FixedInterval< BitWidth, Sign > > add(
+    const FixedInterval< BitWidth, Sign >& lhs,
+    const FixedInterval< BitWidth, Sign >& rhs) {
+  int64_t lb, ub;
+  if (!exact_add(lhs, rhs, lb, ub)) {
+    return boost::none;
+  }
+  return FixedInterval< BitWidth, Sign >::wrap(lb, ub);
+}
+
+/// \brief Addition without wrapping
+template < unsigned BitWidth, Signedness Sign >
+inline boost::optional< FixedInterval< BitWidth, Sign > > add_no_wrap(
+    const FixedInterval< BitWidth, Sign >& lhs,
+    const FixedInterval< BitWidth, Sign >& rhs) {
+  int64_t lb, ub;
+  if (!exact_add(lhs, rhs, lb, ub)) {
+    return boost::none;
+  }
+  return FixedInterval< BitWidth, Sign >::trunc(lb, ub);
+}
+
+/// \brief Substraction with wrapping
+template < unsigned BitWidth, Signedness Sign >
+inline boost::optional< FixedInterval< BitWidth, Sign > > sub(
+    const FixedInterval< BitWidth, Sign >& lhs,
+    const FixedInterval< BitWidth, Sign >& rhs) {
+  int64_t lb, ub;
+  if (!exact_sub(lhs, rhs, lb, ub)) {
+    return boost::none;
+  }
+  return FixedInterval< BitWidth, Sign >::wrap(lb, ub);
+}
+
+/// \brief Substraction without wrapping
+template < unsigned BitWidth, Signedness Sign >
+inline boost::optional< FixedInterval< BitWidth, Sign > > sub_no_wrap(
+    const FixedInterval< BitWidth, Sign >& lhs,
+    const FixedInterval< BitWidth, Sign >& rhs) {
+  int64_t lb, ub;
+  if (!exact_sub(lhs, rhs, lb, ub)) {
+    return boost::none;
+  }
+  return FixedInterval< BitWidth, Sign >::trunc(lb, ub);
+}
+
+/// \brief Multiplication with wrapping
+template < unsigned BitWidth, Signedness Sign >
+inline boost::optional< FixedInterval< BitWidth, Sign > > mul(
+    const FixedInterval< BitWidth, Sign >& lhs,
+    const FixedInterval< BitWidth, Sign >& rhs) {
+  int64_t lb, ub;
+  if (!exact_mul(lhs, rhs, lb, ub)) {
+    return boost::none;
+  }
+  return FixedInterval< BitWidth, Sign >::wrap(lb, ub);
+}
+
+/// \brief Multiplication without wrapping
+template < unsigned BitWidth, Signedness Sign >
+inline boost::optional< FixedInterval< BitWidth, Sign > > mul_no_wrap(
+    const FixedInterval< BitWidth, Sign >& lhs,
+    const FixedInterval< BitWidth, Sign >& rhs) {
+  int64_t lb, ub;
+  if (!exact_mul(lhs, rhs, lb, ub)) {
+    return boost::none;
+  }
+  return FixedInterval< BitWidth, Sign >::trunc(lb, ub);
+}
+
+/// @}
+
+} // end namespace machine_int
+} // end namespace core
+} // end namespace ikos
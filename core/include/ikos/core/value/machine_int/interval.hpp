@@ -46,7 +46,9 @@
 #include <boost/optional.hpp>
 
 #include <ikos/core/domain/abstract_domain.hpp>
+#include <ikos/core/number/fixed_machine_int.hpp>
 #include <ikos/core/number/machine_int.hpp>
+#include <ikos/core/value/machine_int/fixed_interval.hpp>
 #include <ikos/core/value/numeric/interval.hpp>
 
 namespace ikos {
@@ -512,6 +514,37 @@ public:
 
 }; // end class Interval
 
+/// \brief Apply a binary operator on FixedInterval, if the bit-width has a
+/// specialization (see dispatch_fixed_width)
+///
+/// Return boost::none if it does not, or if the operator does not compute the
+/// result. Precondition: lhs and rhs are not bottom.
+template < typename Operator >
+inline boost::optional< Interval > apply_fixed_width(const Interval& lhs,
+                                                     const Interval& rhs,
+                                                     const Operator& op) {
+  return dispatch_fixed_width(
+      lhs.bit_width(),
+      lhs.sign(),
+      [&](auto width) -> boost::optional< Interval > {
+        using FixedIntervalT =
+            FixedInterval< decltype(width)::bit_width, decltype(width)::sign >;
+        using IntT = typename FixedIntervalT::IntT;
+
+        boost::optional< FixedIntervalT > r =
+            op(FixedIntervalT(IntT(lhs.lb()), IntT(lhs.ub())),
+               FixedIntervalT(IntT(rhs.lb()), IntT(rhs.ub())));
+        if (!r) {
+          return boost::none;
+        } else if (r->is_bottom()) {
+          return Interval::bottom(lhs.bit_width(), lhs.sign());
+        } else {
+          return Interval(r->lb().to_machine_int(), r->ub().to_machine_int());
+        }
+      },
+      boost::optional< Interval >());
+}
+
 /// \name Binary Operators
 /// @{
 
@@ -522,6 +555,11 @@ inline Interval add(const Interval& lhs, const Interval& rhs) {
     return lhs;
   } else if (rhs.is_bottom()) {
     return rhs;
+  } else if (boost::optional< Interval > r =
+                 apply_fixed_width(lhs, rhs, [](const auto& x, const auto& y) {
+                   return add(x, y);
+                 })) {
+    return *r;
   } else {
     return Interval::from_z_interval(lhs.to_z_interval() + rhs.to_z_interval(),
                                      lhs.bit_width(),
@@ -537,6 +575,11 @@ inline Interval add_no_wrap(const Interval& lhs, const Interval& rhs) {
     return lhs;
   } else if (rhs.is_bottom()) {
     return rhs;
+  } else if (boost::optional< Interval > r =
+                 apply_fixed_width(lhs, rhs, [](const auto& x, const auto& y) {
+                   return add_no_wrap(x, y);
+                 })) {
+    return *r;
   } else {
     return Interval::from_z_interval(lhs.to_z_interval() + rhs.to_z_interval(),
                                      lhs.bit_width(),
@@ -552,6 +595,11 @@ inline Interval sub(const Interval& lhs, const Interval& rhs) {
     return lhs;
   } else if (rhs.is_bottom()) {
     return rhs;
+  } else if (boost::optional< Interval > r =
+                 apply_fixed_width(lhs, rhs, [](const auto& x, const auto& y) {
+                   return sub(x, y);
+                 })) {
+    return *r;
   } else {
     return Interval::from_z_interval(lhs.to_z_interval() - rhs.to_z_interval(),
                                      lhs.bit_width(),
@@ -567,6 +615,11 @@ inline Interval sub_no_wrap(const Interval& lhs, const Interval& rhs) {
     return lhs;
   } else if (rhs.is_bottom()) {
     return rhs;
+  } else if (boost::optional< Interval > r =
+                 apply_fixed_width(lhs, rhs, [](const auto& x, const auto& y) {
+                   return sub_no_wrap(x, y);
+                 })) {
+    return *r;
   } else {
     return Interval::from_z_interval(lhs.to_z_interval() - rhs.to_z_interval(),
                                      lhs.bit_width(),
@@ -582,6 +635,11 @@ inline Interval mul(const Interval& lhs, const Interval& rhs) {
     return lhs;
   } else if (rhs.is_bottom()) {
     return rhs;
+  } else if (boost::optional< Interval > r =
+                 apply_fixed_width(lhs, rhs, [](const auto& x, const auto& y) {
+                   return mul(x, y);
+                 })) {
+    return *r;
   } else {
     return Interval::from_z_interval(lhs.to_z_interval() * rhs.to_z_interval(),
                                      lhs.bit_width(),
@@ -597,6 +655,11 @@ inline Interval mul_no_wrap(const Interval& lhs, const Interval& rhs) {
     return lhs;
   } else if (rhs.is_bottom()) {
     return rhs;
+  } else if (boost::optional< Interval > r =
+                 apply_fixed_width(lhs, rhs, [](const auto& x, const auto& y) {
+                   return mul_no_wrap(x, y);
+                 })) {
+    return *r;
   } else {
     return Interval::from_z_interval(lhs.to_z_interval() * rhs.to_z_interval(),
                                      lhs.bit_width(),
@@ -46,9 +46,14 @@
 
 #pragma once
 
+#include <functional>
+#include <utility>
+
+#include <boost/container/flat_map.hpp>
+#include <boost/container/small_vector.hpp>
 #include <boost/optional.hpp>
+#include <boost/version.hpp>
 
-#include <ikos/core/adt/patricia_tree/map.hpp>
 #include <ikos/core/linear_expression.hpp>
 #include <ikos/core/number/bound.hpp>
 #include <ikos/core/support/assert.hpp>
@@ -63,6 +68,11 @@ namespace numeric {
 ///
 /// This is either -oo, +oo or a linear expression of the non-negative loop
 /// counters (e.g, `1 + 2*i + 3*j`)
+///
+/// The coefficients are stored in an array of (counter, coefficient) pairs,
+/// sorted by counter. Up to InlineCoeffs coefficients are stored inline,
+/// without heap allocation. Binary operations are linear scans over both
+/// arrays, where a missing coefficient is 0.
 template < typename Number, typename VariableRef >
 class GaugeBound {
 public:
@@ -70,8 +80,20 @@ public:
   using VariableExpressionT = VariableExpression< Number, VariableRef >;
   using LinearExpressionT = LinearExpression< Number, VariableRef >;
 
+  /// \brief Number of coefficients stored without heap allocation
+  static constexpr std::size_t InlineCoeffs = 2;
+
 private:
-  using Coefficients = PatriciaTreeMap< VariableRef, Number >;
+#if BOOST_VERSION >= 106600
+  using Coefficients = boost::container::flat_map<
+      VariableRef,
+      Number,
+      std::less< VariableRef >,
+      boost::container::small_vector< std::pair< VariableRef, Number >,
+                                      InlineCoeffs > >;
+#else
+  using Coefficients = boost::container::flat_map< VariableRef, Number >;
+#endif
 
 private:
   bool _is_infinite;
@@ -80,6 +102,7 @@ private:
 
   /* Invariants:
    * _is_infinite => _cst in {-1, 1} and _coeffs.empty()
+   * _coeffs does not contain any zero coefficient
    */
 
 private:
@@ -115,7 +138,7 @@ public:
 
   /// \brief Create the gauge bound `1*v`
   explicit GaugeBound(VariableRef v) : _is_infinite(false), _cst(0) {
-    this->_coeffs.insert_or_assign(v, Number(1));
+    this->_coeffs.emplace(v, Number(1));
   }
 
   /// \brief Create a gauge bound from bound `b`
@@ -131,12 +154,16 @@ public:
 
   /// \brief Create the gauge bound `n*v`
   GaugeBound(int n, VariableRef v) : _is_infinite(false), _cst(0) {
-    this->_coeffs.insert_or_assign(v, Number(n));
+    if (n != 0) {
+      this->_coeffs.emplace(v, Number(n));
+    }
   }
 
   /// \brief Create the gauge bound `n*v`
   GaugeBound(const Number& n, VariableRef v) : _is_infinite(false), _cst(0) {
-    this->_coeffs.insert_or_assign(v, n);
+    if (n != 0) {
+      this->_coeffs.emplace(v, n);
+    }
   }
 
   /// \brief Copy constructor
@@ -156,7 +183,7 @@ public:
   /// \brief Assign a number
   GaugeBound& operator=(Number n) {
     this->_is_infinite = false;
-    this->_n = std::move(n);
+    this->_cst = std::move(n);
     this->_coeffs.clear();
     return *this;
   }
@@ -218,9 +245,9 @@ public:
   /// \brief Return the coefficient for the variable `v`
   Number coeff(VariableRef v) const {
     ikos_assert(this->is_finite());
-    boost::optional< const Number& > c = this->_coeffs.at(v);
-    if (c) {
-      return *c;
+    auto it = this->_coeffs.find(v);
+    if (it != this->_coeffs.end()) {
+      return it->second;
     } else {
       return Number(0);
     }
@@ -253,89 +280,120 @@ public:
   }
 
 private:
-  /// \brief Apply a binary operator on coefficients
-  template < typename BinaryOp >
-  static typename BinaryOp::ResultType apply_binary_operation(
-      const Coefficients& c1, const Coefficients& c2, const BinaryOp& op) {
-    return c1.binary_operation(c2, op);
-  }
-
-  /// \brief Apply an unary operator on coefficients
+  /// \brief Apply an unary operator on each coefficient
+  ///
+  /// The operator should be a callable of type:
+  ///   Number(const Number& x)
   template < typename UnaryOp >
-  static Coefficients apply_unary_operation(Coefficients c, const UnaryOp& op) {
-    c.transform(op);
-    return c;
+  static Coefficients apply_unary_operation(const Coefficients& c,
+                                            const UnaryOp& op) {
+    Coefficients r;
+    r.reserve(c.size());
+    for (const auto& binding : c) {
+      Number n = op(binding.second);
+      if (n != 0) {
+        r.emplace_hint(r.end(), binding.first, std::move(n));
+      }
+    }
+    return r;
   }
 
-  /// \brief Join separated coefficient trees
-  static Coefficients join_separated(const Coefficients& c1,
-                                     const Coefficients& c2) {
-    return c1.join(c2, [](const Number&, const Number&) {
-      ikos_unreachable("trees are not separated");
-      return boost::optional< Number >(boost::none);
-    });
+  /// \brief Apply a binary operator on each pair of coefficients
+  ///
+  /// A coefficient missing on one side is 0. The operator should be a
+  /// callable of type:
+  ///   Number(const Number& x, const Number& y)
+  template < typename BinaryOp >
+  static Coefficients apply_binary_operation(const Coefficients& c1,
+                                             const Coefficients& c2,
+                                             const BinaryOp& op) {
+    static const Number Zero(0);
+    Coefficients r;
+    r.reserve(c1.size() + c2.size());
+    auto insert = [&r](VariableRef v, Number n) {
+      if (n != 0) {
+        r.emplace_hint(r.end(), v, std::move(n));
+      }
+    };
+    auto it = c1.begin(), et = c1.end();
+    auto jt = c2.begin(), ft = c2.end();
+    while (it != et && jt != ft) {
+      if (it->first < jt->first) {
+        insert(it->first, op(it->second, Zero));
+        ++it;
+      } else if (jt->first < it->first) {
+        insert(jt->first, op(Zero, jt->second));
+        ++jt;
+      } else {
+        insert(it->first, op(it->second, jt->second));
+        ++it;
+        ++jt;
+      }
+    }
+    for (; it != et; ++it) {
+      insert(it->first, op(it->second, Zero));
+    }
+    for (; jt != ft; ++jt) {
+      insert(jt->first, op(Zero, jt->second));
+    }
+    return r;
   }
 
-private:
-  /// \brief Add binary operator
-  struct NumberAdd {
-    boost::optional< Number > operator()(const Number& x,
-                                         const Number& y) const {
-      return x + y;
+  /// \brief Return true if the predicate holds on each pair of coefficients
+  ///
+  /// A coefficient missing on one side is 0. The predicate should be a
+  /// callable of type:
+  ///   bool(const Number& x, const Number& y)
+  template < typename Predicate >
+  static bool all_of_binary(const Coefficients& c1,
+                            const Coefficients& c2,
+                            const Predicate& pred) {
+    static const Number Zero(0);
+    auto it = c1.begin(), et = c1.end();
+    auto jt = c2.begin(), ft = c2.end();
+    while (it != et && jt != ft) {
+      if (it->first < jt->first) {
+        if (!pred(it->second, Zero)) {
+          return false;
+        }
+        ++it;
+      } else if (jt->first < it->first) {
+        if (!pred(Zero, jt->second)) {
+          return false;
+        }
+        ++jt;
+      } else {
+        if (!pred(it->second, jt->second)) {
+          return false;
+        }
+        ++it;
+        ++jt;
+      }
     }
-  };
-
-  /// \brief Negate binary operator
-  struct GaugeBoundNeg {
-    boost::optional< Number > operator()(VariableRef, const Number& x) const {
-      return -x;
+    for (; it != et; ++it) {
+      if (!pred(it->second, Zero)) {
+        return false;
+      }
     }
-  };
+    for (; jt != ft; ++jt) {
+      if (!pred(Zero, jt->second)) {
+        return false;
+      }
+    }
+    return true;
+  }
 
 public:
   /// \brief Unary minus
   GaugeBound operator-() const {
     return GaugeBound(this->_is_infinite,
                       -this->_cst,
-                      apply_unary_operation(this->_coeffs, GaugeBoundNeg{}));
+                      apply_unary_operation(this->_coeffs,
+                                            [](const Number& x) {
+                                              return -x;
+                                            }));
   }
 
-private:
-  /// \brief Add binary operator
-  struct GaugeBoundAdd {
-    using ResultType = Coefficients;
-
-    bool has_equals() const { return false; }
-
-    Coefficients equals(const Coefficients&) const {
-      ikos_unreachable("unreachable");
-      return Coefficients();
-    }
-
-    Coefficients left(const Coefficients& c) const { return c; }
-
-    Coefficients right(const Coefficients& c) const { return c; }
-
-    Coefficients left_with_right_leaf(Coefficients c,
-                                      VariableRef v,
-                                      const Number& n) const {
-      c.update_or_insert(NumberAdd{}, v, n);
-      return c;
-    }
-
-    Coefficients right_with_left_leaf(Coefficients c,
-                                      VariableRef v,
-                                      const Number& n) const {
-      c.update_or_insert(NumberAdd{}, v, n);
-      return c;
-    }
-
-    Coefficients merge(const Coefficients& l, const Coefficients& r) const {
-      return join_separated(l, r);
-    }
-  };
-
-public:
   /// \brief Add a number
   GaugeBound operator+(const Number& n) const {
     if (this->is_finite()) {
@@ -352,7 +410,10 @@ public:
                         this->_cst + other._cst,
                         apply_binary_operation(this->_coeffs,
                                                other._coeffs,
-                                               GaugeBoundAdd{}));
+                                               [](const Number& x,
+                                                  const Number& y) {
+                                                 return x + y;
+                                               }));
     } else if (this->is_finite() && other.is_infinite()) {
       return other;
     } else if (this->is_infinite() && other.is_finite()) {
@@ -369,44 +430,6 @@ public:
     return this->operator=(this->operator+(other));
   }
 
-private:
-  /// \brief Sub binary operator
-  struct GaugeBoundSub {
-    using ResultType = Coefficients;
-
-    bool has_equals() const { return true; }
-
-    Coefficients equals(const Coefficients&) const {
-      return Coefficients(); // x - x
-    }
-
-    Coefficients left(const Coefficients& c) const { return c; }
-
-    Coefficients right(const Coefficients& c) const {
-      return apply_unary_operation(c, GaugeBoundNeg{});
-    }
-
-    Coefficients left_with_right_leaf(Coefficients c,
-                                      VariableRef v,
-                                      const Number& n) const {
-      c.update_or_insert(NumberAdd{}, v, -n);
-      return c;
-    }
-
-    Coefficients right_with_left_leaf(Coefficients c,
-                                      VariableRef v,
-                                      const Number& n) const {
-      c.transform(GaugeBoundNeg{});
-      c.update_or_insert(NumberAdd{}, v, n);
-      return c;
-    }
-
-    Coefficients merge(const Coefficients& l, const Coefficients& r) const {
-      return join_separated(l, r);
-    }
-  };
-
-public:
   /// \brief Substract a number
   GaugeBound operator-(const Number& n) const {
     if (this->is_finite()) {
@@ -423,7 +446,10 @@ public:
                         this->_cst - other._cst,
                         apply_binary_operation(this->_coeffs,
                                                other._coeffs,
-                                               GaugeBoundSub{}));
+                                               [](const Number& x,
+                                                  const Number& y) {
+                                                 return x - y;
+                                               }));
     } else if (this->is_finite() && other.is_infinite()) {
       return other.operator-();
     } else if (this->is_infinite() && other.is_finite()) {
@@ -440,17 +466,6 @@ public:
     return this->operator=(this->operator-(other));
   }
 
-private:
-  /// \brief Multiplication by a constant
-  struct GaugeBoundMul {
-    Number c;
-
-    boost::optional< Number > operator()(VariableRef, const Number& x) const {
-      return x * c;
-    }
-  };
-
-public:
   /// \brief Multiply by a number
   GaugeBound operator*(const Number& c) const {
     if (c == 0) {
@@ -458,7 +473,10 @@ public:
     } else if (this->is_finite()) {
       return GaugeBound(false,
                         this->_cst * c,
-                        apply_unary_operation(this->_coeffs, GaugeBoundMul{c}));
+                        apply_unary_operation(this->_coeffs,
+                                              [&c](const Number& x) {
+                                                return x * c;
+                                              }));
     } else {
       return GaugeBound(true, this->_cst * c, Coefficients());
     }
@@ -469,185 +487,6 @@ public:
     return this->operator=(this->operator*(c));
   }
 
-private:
-  /// \brief Compare bounds
-  struct GaugeBoundLeq {
-    using ResultType = bool;
-
-    bool has_equals() const { return true; }
-
-    bool equals(const Coefficients&) const {
-      return true; // x <= x
-    }
-
-    bool left(const Coefficients& c) const {
-      return std::all_of(c.begin(), c.end(), [](const auto& binding) {
-        return binding.second <= 0;
-      });
-    }
-
-    bool right(const Coefficients& c) const {
-      return std::all_of(c.begin(), c.end(), [](const auto& binding) {
-        return 0 <= binding.second;
-      });
-    }
-
-    bool left_with_right_leaf(const Coefficients& c,
-                              VariableRef v,
-                              const Number& n) const {
-      if (!c.at(v)) {
-        if (!(0 <= n)) {
-          return false;
-        }
-      }
-      return std::all_of(c.begin(), c.end(), [v, n](const auto& binding) {
-        if (binding.first == v) {
-          return binding.second <= n;
-        } else {
-          return binding.second <= 0;
-        }
-      });
-    }
-
-    bool right_with_left_leaf(const Coefficients& c,
-                              VariableRef v,
-                              const Number& n) const {
-      if (!c.at(v)) {
-        if (!(n <= 0)) {
-          return false;
-        }
-      }
-      return std::all_of(c.begin(), c.end(), [v, n](const auto& binding) {
-        if (binding.first == v) {
-          return n <= binding.second;
-        } else {
-          return 0 <= binding.second;
-        }
-      });
-    }
-
-    bool merge(bool l, bool r) const { return l && r; }
-  };
-
-  /// \brief Compare bounds
-  struct GaugeBoundGeq {
-    using ResultType = bool;
-
-    bool has_equals() const { return true; }
-
-    bool equals(const Coefficients&) const {
-      return true; // x >= x
-    }
-
-    bool left(const Coefficients& c) const {
-      return std::all_of(c.begin(), c.end(), [](const auto& binding) {
-        return binding.second >= 0;
-      });
-    }
-
-    bool right(const Coefficients& c) const {
-      return std::all_of(c.begin(), c.end(), [](const auto& binding) {
-        return 0 >= binding.second;
-      });
-    }
-
-    bool left_with_right_leaf(const Coefficients& c,
-                              VariableRef v,
-                              const Number& n) const {
-      if (!c.at(v)) {
-        if (!(0 >= n)) {
-          return false;
-        }
-      }
-      return std::all_of(c.begin(), c.end(), [v, n](const auto& binding) {
-        if (binding.first == v) {
-          return binding.second >= n;
-        } else {
-          return binding.second >= 0;
-        }
-      });
-    }
-
-    bool right_with_left_leaf(const Coefficients& c,
-                              VariableRef v,
-                              const Number& n) const {
-      if (!c.at(v)) {
-        if (!(n >= 0)) {
-          return false;
-        }
-      }
-      return std::all_of(c.begin(), c.end(), [v, n](const auto& binding) {
-        if (binding.first == v) {
-          return n >= binding.second;
-        } else {
-          return 0 >= binding.second;
-        }
-      });
-    }
-
-    bool merge(bool l, bool r) const { return l && r; }
-  };
-
-  /// \brief Compare bounds
-  struct GaugeBoundEq {
-    using ResultType = bool;
-
-    bool has_equals() const { return true; }
-
-    bool equals(const Coefficients&) const {
-      return true; // x == x
-    }
-
-    bool left(const Coefficients& c) const {
-      return std::all_of(c.begin(), c.end(), [](const auto& binding) {
-        return binding.second == 0;
-      });
-    }
-
-    bool right(const Coefficients& c) const {
-      return std::all_of(c.begin(), c.end(), [](const auto& binding) {
-        return 0 == binding.second;
-      });
-    }
-
-    bool left_with_right_leaf(const Coefficients& c,
-                              VariableRef v,
-                              const Number& n) const {
-      if (!c.at(v)) {
-        if (n != 0) {
-          return false;
-        }
-      }
-      return std::all_of(c.begin(), c.end(), [v, n](const auto& binding) {
-        if (binding.first == v) {
-          return binding.second == n;
-        } else {
-          return binding.second == 0;
-        }
-      });
-    }
-
-    bool right_with_left_leaf(const Coefficients& c,
-                              VariableRef v,
-                              const Number& n) const {
-      if (!c.at(v)) {
-        if (n != 0) {
-          return false;
-        }
-      }
-      return std::all_of(c.begin(), c.end(), [v, n](const auto& binding) {
-        if (binding.first == v) {
-          return n == binding.second;
-        } else {
-          return 0 == binding.second;
-        }
-      });
-    }
-
-    bool merge(bool l, bool r) const { return l && r; }
-  };
-
-public:
   /// \brief Lower or equal comparison
   bool operator<=(const GaugeBound& other) const {
     if (this->_is_infinite && other._is_infinite) {
@@ -658,9 +497,11 @@ public:
       return other._cst > 0;
     } else {
       return this->_cst <= other._cst &&
-             apply_binary_operation(this->_coeffs,
-                                    other._coeffs,
-                                    GaugeBoundLeq{});
+             all_of_binary(this->_coeffs,
+                           other._coeffs,
+                           [](const Number& x, const Number& y) {
+                             return x <= y;
+                           });
     }
   }
 
@@ -674,9 +515,11 @@ public:
       return other._cst < 0;
     } else {
       return this->_cst >= other._cst &&
-             apply_binary_operation(this->_coeffs,
-                                    other._coeffs,
-                                    GaugeBoundGeq{});
+             all_of_binary(this->_coeffs,
+                           other._coeffs,
+                           [](const Number& x, const Number& y) {
+                             return x >= y;
+                           });
     }
   }
 
@@ -693,8 +536,7 @@ public:
   /// \brief Equal comparison
   bool operator==(const GaugeBound& other) const {
     return this->_is_infinite == other._is_infinite &&
-           this->_cst == other._cst &&
-           apply_binary_operation(this->_coeffs, other._coeffs, GaugeBoundEq{});
+           this->_cst == other._cst && this->_coeffs == other._coeffs;
   }
 
   /// \brief Not equal comparison
@@ -702,74 +544,6 @@ public:
     return !this->operator==(other);
   }
 
-private:
-  /// \brief Min with 0
-  struct MinZero {
-    boost::optional< Number > operator()(VariableRef, const Number& x) const {
-      return min(x, Number(0));
-    }
-  };
-
-  /// \brief Min with 0 if it is not `u`
-  struct MinZeroIfNot {
-    VariableRef u;
-
-    boost::optional< Number > operator()(VariableRef v, const Number& x) const {
-      if (u == v) {
-        return x;
-      }
-      return min(x, Number(0));
-    }
-  };
-
-  /// \brief Min binary operator
-  struct GaugeBoundMin {
-    using ResultType = Coefficients;
-
-    bool has_equals() const { return true; }
-
-    Coefficients equals(const Coefficients& c) const {
-      return c; // min(x, x)
-    }
-
-    Coefficients left(const Coefficients& c) const {
-      return apply_unary_operation(c, MinZero{});
-    }
-
-    Coefficients right(const Coefficients& c) const {
-      return apply_unary_operation(c, MinZero{});
-    }
-
-    Coefficients tree_with_leaf(Coefficients c,
-                                VariableRef v,
-                                const Number& x) const {
-      auto y = c.at(v);
-      if (y) {
-        c.insert_or_assign(v, min(x, *y));
-      } else {
-        c.insert_or_assign(v, min(x, Number(0)));
-      }
-      return apply_unary_operation(c, MinZeroIfNot{v});
-    }
-
-    Coefficients left_with_right_leaf(Coefficients c,
-                                      VariableRef v,
-                                      const Number& x) const {
-      return tree_with_leaf(c, v, x);
-    }
-
-    Coefficients right_with_left_leaf(Coefficients c,
-                                      VariableRef v,
-                                      const Number& x) const {
-      return tree_with_leaf(c, v, x);
-    }
-
-    Coefficients merge(const Coefficients& l, const Coefficients& r) const {
-      return join_separated(l, r);
-    }
-  };
-
-public:
   /// \brief Return the min of the given bounds, as defined in the paper
   friend GaugeBound min(const GaugeBound& x, const GaugeBound& y) {
     if (x.is_infinite() || y.is_infinite()) {
@@ -779,7 +553,10 @@ public:
                         min(x._cst, y._cst),
                         apply_binary_operation(x._coeffs,
                                                y._coeffs,
-                                               GaugeBoundMin{}));
+                                               [](const Number& a,
+                                                  const Number& b) {
+                                                 return min(a, b);
+                                               }));
     }
   }
 
@@ -798,72 +575,6 @@ public:
     return min(min(x, y), min(z, t));
   }
 
-private:
-  /// \brief Max with 0
-  struct MaxZero {
-    boost::optional< Number > operator()(VariableRef, const Number& x) const {
-      return max(x, Number(0));
-    }
-  };
-
-  /// \brief Max with 0 if it is not `u`
-  struct MaxZeroIfNot {
-    VariableRef u;
-
-    boost::optional< Number > operator()(VariableRef v, const Number& x) const {
-      if (u == v) {
-        return x;
-      }
-      return max(x, Number(0));
-    }
-  };
-
-  /// \brief Max binary operator
-  struct GaugeBoundMax {
-    using ResultType = Coefficients;
-
-    bool has_equals() const { return true; }
-
-    Coefficients equals(const Coefficients& c) const { return c; }
-
-    Coefficients left(const Coefficients& c) const {
-      return apply_unary_operation(c, MaxZero{});
-    }
-
-    Coefficients right(const Coefficients& c) const {
-      return apply_unary_operation(c, MaxZero{});
-    }
-
-    Coefficients tree_with_leaf(Coefficients c,
-                                VariableRef v,
-                                const Number& x) const {
-      auto y = c.at(v);
-      if (y) {
-        c.insert_or_assign(v, max(x, *y));
-      } else {
-        c.insert_or_assign(v, max(x, Number(0)));
-      }
-      return apply_unary_operation(c, MaxZeroIfNot{v});
-    }
-
-    Coefficients left_with_right_leaf(Coefficients c,
-                                      VariableRef v,
-                                      const Number& x) const {
-      return tree_with_leaf(c, v, x);
-    }
-
-    Coefficients right_with_left_leaf(Coefficients c,
-                                      VariableRef v,
-                                      const Number& x) const {
-      return tree_with_leaf(c, v, x);
-    }
-
-    Coefficients merge(const Coefficients& l, const Coefficients& r) const {
-      return join_separated(l, r);
-    }
-  };
-
-public:
   /// \brief Return the max of the given bounds, as defined in the paper
   friend GaugeBound max(const GaugeBound& x, const GaugeBound& y) {
     if (x.is_infinite() || y.is_infinite()) {
@@ -873,7 +584,10 @@ public:
                         max(x._cst, y._cst),
                         apply_binary_operation(x._coeffs,
                                                y._coeffs,
-                                               GaugeBoundMax{}));
+                                               [](const Number& a,
+                                                  const Number& b) {
+                                                 return max(a, b);
+                                               }));
     }
   }
 
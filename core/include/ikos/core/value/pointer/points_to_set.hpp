@@ -45,6 +45,7 @@
 
 #include <boost/optional.hpp>
 
+#include <ikos/core/adt/flat_set.hpp>
 #include <ikos/core/adt/patricia_tree/set.hpp>
 #include <ikos/core/domain/abstract_domain.hpp>
 #include <ikos/core/semantic/memory_location.hpp>
@@ -52,6 +53,16 @@
 namespace ikos {
 namespace core {
 
+/// \brief Representation of the sets of memory locations in PointsToSet
+///
+/// The default is a patricia tree set. Specialize this trait to use another
+/// set with the same interface, e.g, FlatSet when memory locations have dense
+/// indexes and points-to sets are large.
+template < typename MemoryLocationRef >
+struct PointsToSetTraits {
+  using SetT = PatriciaTreeSet< MemoryLocationRef >;
+};
+
 /// \brief Represents a set of memory locations (i.e, addresses)
 template < typename MemoryLocationRef >
 class PointsToSet final
@@ -65,14 +76,14 @@ private:
   enum Kind { BottomKind, TopKind, SetKind };
 
 private:
-  using PatriciaTreeSetT = PatriciaTreeSet< MemoryLocationRef >;
+  using SetT = typename PointsToSetTraits< MemoryLocationRef >::SetT;
 
 public:
-  using Iterator = typename PatriciaTreeSetT::Iterator;
+  using Iterator = typename SetT::Iterator;
 
 private:
   Kind _kind;
-  PatriciaTreeSetT _set;
+  SetT _set;
 
 private:
   struct TopTag {};
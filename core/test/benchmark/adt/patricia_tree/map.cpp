@@ -0,0 +1,147 @@
+/*******************************************************************************
+ *
+ * Benchmarks for PatriciaTreeMap
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <algorithm>
+
+#include <benchmark/benchmark.h>
+
+#include <ikos/core/adt/patricia_tree/map.hpp>
+
+#include "node_allocations.hpp"
+
+using Index = ikos::core::Index;
+
+template < bool HashConsed >
+using Map = ikos::core::PatriciaTreeMap< Index, int, HashConsed >;
+
+/// \brief Return the owner of the node allocations
+template < bool HashConsed >
+const char* owner() {
+  return HashConsed ? "HashConsedPatriciaTreeMap" : "PatriciaTreeMap";
+}
+
+/// \brief Sizes of the benchmarked maps
+static void map_sizes(benchmark::internal::Benchmark* b) {
+  b->RangeMultiplier(4)->Range(16, 4096)->ArgName("size");
+}
+
+/// \brief Return the map {first -> value, ..., first + size - 1 -> value}
+template < bool HashConsed >
+Map< HashConsed > make_map(Index first, Index size, int value) {
+  Map< HashConsed > m;
+  for (Index i = first; i < first + size; i++) {
+    m.insert_or_assign(i, value + static_cast< int >(i % 8));
+  }
+  return m;
+}
+
+/// \brief Return the maximum of two values
+static boost::optional< int > max(int left, int right) {
+  return std::max(left, right);
+}
+
+/// \brief Join of two maps sharing half of their keys
+template < bool HashConsed >
+static void join(benchmark::State& state) {
+  auto size = static_cast< Index >(state.range(0));
+  auto a = make_map< HashConsed >(0, size, 0);
+  auto b = make_map< HashConsed >(size / 2, size, 1);
+  NodeAllocationCounters counters(state, owner< HashConsed >());
+  for (auto _ : state) {
+    auto c = a.join(b, max);
+    benchmark::DoNotOptimize(c);
+  }
+}
+
+/// \brief Transformation of all the values of a map
+template < bool HashConsed >
+static void transform(benchmark::State& state) {
+  auto size = static_cast< Index >(state.range(0));
+  auto a = make_map< HashConsed >(0, size, 0);
+  NodeAllocationCounters counters(state, owner< HashConsed >());
+  for (auto _ : state) {
+    auto c = a;
+    c.transform([](Index, int value) -> boost::optional< int > {
+      return value + 1;
+    });
+    benchmark::DoNotOptimize(c);
+  }
+}
+
+/// \brief Inclusion test of two maps with the same keys
+template < bool HashConsed >
+static void leq(benchmark::State& state) {
+  auto size = static_cast< Index >(state.range(0));
+  auto a = make_map< HashConsed >(0, size, 0);
+  auto b = make_map< HashConsed >(0, size, 1);
+  NodeAllocationCounters counters(state, owner< HashConsed >());
+  for (auto _ : state) {
+    bool r = a.leq(b, [](int left, int right) { return left <= right; });
+    benchmark::DoNotOptimize(r);
+  }
+}
+
+/// \brief Update of an existing key and insertion of a new key in a copy
+template < bool HashConsed >
+static void update_or_insert(benchmark::State& state) {
+  auto size = static_cast< Index >(state.range(0));
+  auto a = make_map< HashConsed >(0, size, 0);
+  NodeAllocationCounters counters(state, owner< HashConsed >());
+  for (auto _ : state) {
+    auto c = a;
+    c.update_or_insert(max, size / 2, 42);
+    c.update_or_insert(max, size, 42);
+    benchmark::DoNotOptimize(c);
+  }
+}
+
+BENCHMARK_TEMPLATE(join, false)->Apply(map_sizes);
+BENCHMARK_TEMPLATE(join, true)->Apply(map_sizes);
+BENCHMARK_TEMPLATE(transform, false)->Apply(map_sizes);
+BENCHMARK_TEMPLATE(transform, true)->Apply(map_sizes);
+BENCHMARK_TEMPLATE(leq, false)->Apply(map_sizes);
+BENCHMARK_TEMPLATE(leq, true)->Apply(map_sizes);
+BENCHMARK_TEMPLATE(update_or_insert, false)->Apply(map_sizes);
+BENCHMARK_TEMPLATE(update_or_insert, true)->Apply(map_sizes);
+
+BENCHMARK_MAIN();
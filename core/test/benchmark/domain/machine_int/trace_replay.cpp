@@ -0,0 +1,141 @@
+/*******************************************************************************
+ *
+ * Replay of a machine integer domain trace on several abstract domains
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <ikos/core/domain/machine_int/interval.hpp>
+#include <ikos/core/domain/machine_int/interval_congruence.hpp>
+#include <ikos/core/domain/machine_int/numeric_domain_adapter.hpp>
+#include <ikos/core/domain/machine_int/trace.hpp>
+#include <ikos/core/domain/numeric/dbm.hpp>
+#include <ikos/core/domain/numeric/gauge.hpp>
+#include <ikos/core/domain/numeric/octagon.hpp>
+#include <ikos/core/domain/numeric/var_packing_domain.hpp>
+#include <ikos/core/example/machine_int/variable_factory.hpp>
+
+#include "node_allocations.hpp"
+
+using ZNumber = ikos::core::ZNumber;
+using ikos::core::Signedness;
+using VariableFactory = ikos::core::example::machine_int::VariableFactory;
+using Variable = VariableFactory::VariableRef;
+
+template < typename NumericDomain >
+using Adapter =
+    ikos::core::machine_int::NumericDomainAdapter< Variable, NumericDomain >;
+
+using IntervalDomain = ikos::core::machine_int::IntervalDomain< Variable >;
+using IntervalCongruenceDomain =
+    ikos::core::machine_int::IntervalCongruenceDomain< Variable >;
+using DBM = ikos::core::numeric::DBM< ZNumber, Variable >;
+using VarPackingDBM =
+    ikos::core::numeric::VarPackingDomain< ZNumber, Variable, DBM >;
+using Octagon = ikos::core::numeric::Octagon< ZNumber, Variable >;
+using Gauge = ikos::core::numeric::GaugeDomain< ZNumber, Variable >;
+
+/// \brief Replay of the whole trace, on a fresh replayer at each iteration
+template < typename Domain >
+void replay(benchmark::State& state, const std::string& trace) {
+  VariableFactory vfac;
+  auto make_variable = [&vfac](std::uint64_t id,
+                               unsigned bit_width,
+                               Signedness sign) {
+    return vfac.get("v" + std::to_string(id), bit_width, sign);
+  };
+  std::size_t operations = 0;
+  NodeAllocationCounters counters(state, Domain::name());
+  for (auto _ : state) {
+    std::istringstream in(trace);
+    ikos::core::machine_int::TraceReader reader(in);
+    ikos::core::machine_int::TraceReplayer< Variable, Domain > replayer(
+        make_variable);
+    operations = replayer.replay(reader);
+    benchmark::DoNotOptimize(replayer.num_true_queries());
+  }
+  state.counters["operations"] = static_cast< double >(operations);
+}
+
+/// \brief Register the replay of the given trace on the given domain
+template < typename Domain >
+void register_replay(const char* name, const std::string& trace) {
+  benchmark::RegisterBenchmark(name, replay< Domain >, trace);
+}
+
+/// \brief Replay the trace given as the first positional argument, recorded
+/// with `ikos-analyzer -domain-trace`
+///
+/// Without a trace, no benchmark is registered.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (argc > 2) {
+    std::cerr << "usage: " << argv[0] << " [benchmark options] [trace]\n";
+    return 1;
+  }
+  if (argc == 2) {
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file) {
+      std::cerr << argv[0] << ": error: cannot open " << argv[1] << "\n";
+      return 1;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    std::string trace = buffer.str();
+
+    register_replay< IntervalDomain >("replay/interval", trace);
+    register_replay< IntervalCongruenceDomain >("replay/interval-congruence",
+                                                trace);
+    register_replay< Adapter< DBM > >("replay/dbm", trace);
+    register_replay< Adapter< VarPackingDBM > >("replay/var-pack-dbm", trace);
+    register_replay< Adapter< Octagon > >("replay/octagon", trace);
+    register_replay< Adapter< Gauge > >("replay/gauge", trace);
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,332 @@
+/*******************************************************************************
+ *
+ * Benchmarks for ValueDomain
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <ikos/core/domain/lifetime/lifetime.hpp>
+#include <ikos/core/domain/machine_int/interval.hpp>
+#include <ikos/core/domain/memory/value.hpp>
+#include <ikos/core/domain/nullity/nullity.hpp>
+#include <ikos/core/domain/pointer/pointer.hpp>
+#include <ikos/core/domain/uninitialized/uninitialized.hpp>
+
+namespace {
+
+using ikos::core::Index;
+using ikos::core::MachineInt;
+using ikos::core::Nullity;
+using ikos::core::Signed;
+using ikos::core::Signedness;
+using ikos::core::Unsigned;
+
+/// \brief Return a new unique index
+Index fresh_index() {
+  static Index next = 0;
+  return ++next;
+}
+
+/// \brief Memory location
+struct MemoryLocation {
+  std::string name;
+  Index index = fresh_index();
+};
+
+/// \brief Integer, pointer or cell variable
+struct Variable {
+  enum Kind { IntKind, PointerKind, CellKind };
+
+  Kind kind;
+  std::string name;
+  unsigned bit_width;
+  Signedness sign;
+  Variable* offset_var;
+  MemoryLocation* base;
+  MachineInt offset;
+  MachineInt size;
+  Index index = fresh_index();
+};
+
+/// \brief Variable factory
+class VariableFactory {
+private:
+  std::vector< std::unique_ptr< Variable > > _vars;
+  std::map< std::tuple< MemoryLocation*, uint64_t, uint64_t >, Variable* >
+      _cells;
+
+public:
+  Variable* get_int(const std::string& name,
+                    unsigned bit_width,
+                    Signedness sign) {
+    return this->create(Variable{Variable::IntKind,
+                                 name,
+                                 bit_width,
+                                 sign,
+                                 nullptr,
+                                 nullptr,
+                                 MachineInt::zero(64, Unsigned),
+                                 MachineInt::zero(64, Unsigned)});
+  }
+
+  Variable* get_pointer(const std::string& name) {
+    Variable* offset = this->get_int(name + ".offset", 64, Unsigned);
+    return this->create(Variable{Variable::PointerKind,
+                                 name,
+                                 64,
+                                 Unsigned,
+                                 offset,
+                                 nullptr,
+                                 MachineInt::zero(64, Unsigned),
+                                 MachineInt::zero(64, Unsigned)});
+  }
+
+  Variable* get_cell(MemoryLocation* base,
+                     const MachineInt& offset,
+                     const MachineInt& size) {
+    auto key = std::make_tuple(base,
+                               offset.to< uint64_t >(),
+                               size.to< uint64_t >());
+    auto it = this->_cells.find(key);
+    if (it != this->_cells.end()) {
+      return it->second;
+    }
+    Variable* cell =
+        this->create(Variable{Variable::CellKind,
+                              "C{" + base->name + "," + offset.str() + "," +
+                                  size.str() + "}",
+                              size.to< unsigned >() * 8,
+                              Signed,
+                              this->get_int("C.offset", 64, Unsigned),
+                              base,
+                              offset,
+                              size});
+    this->_cells.emplace(key, cell);
+    return cell;
+  }
+
+private:
+  Variable* create(Variable var) {
+    this->_vars.emplace_back(std::make_unique< Variable >(std::move(var)));
+    return this->_vars.back().get();
+  }
+};
+
+} // end anonymous namespace
+
+namespace ikos {
+namespace core {
+
+template <>
+struct IndexableTraits< Variable* > {
+  static Index index(const Variable* v) { return v->index; }
+};
+
+template <>
+struct DumpableTraits< Variable* > {
+  static void dump(std::ostream& o, const Variable* v) { o << v->name; }
+};
+
+template <>
+struct IndexableTraits< MemoryLocation* > {
+  static Index index(const MemoryLocation* m) { return m->index; }
+};
+
+template <>
+struct DumpableTraits< MemoryLocation* > {
+  static void dump(std::ostream& o, const MemoryLocation* m) { o << m->name; }
+};
+
+namespace machine_int {
+
+template <>
+struct VariableTraits< Variable* > {
+  static unsigned bit_width(const Variable* v) { return v->bit_width; }
+
+  static Signedness sign(const Variable* v) { return v->sign; }
+};
+
+} // end namespace machine_int
+
+namespace pointer {
+
+template <>
+struct VariableTraits< Variable* > {
+  static Variable* offset_var(const Variable* v) { return v->offset_var; }
+};
+
+} // end namespace pointer
+
+namespace memory {
+
+template <>
+struct CellVariableTraits< Variable*, MemoryLocation* > {
+  static MemoryLocation* base(const Variable* v) { return v->base; }
+
+  static const MachineInt& offset(const Variable* v) { return v->offset; }
+
+  static const MachineInt& size(const Variable* v) { return v->size; }
+};
+
+template <>
+struct VariableTraits< Variable* > {
+  static bool is_cell(const Variable* v) {
+    return v->kind == Variable::CellKind;
+  }
+
+  static bool is_int(const Variable* v) { return v->kind == Variable::IntKind; }
+
+  static bool is_float(const Variable*) { return false; }
+
+  static bool is_pointer(const Variable* v) {
+    return v->kind == Variable::PointerKind;
+  }
+};
+
+template <>
+struct CellFactoryTraits< Variable*, MemoryLocation*, VariableFactory > {
+  static Variable* cell(VariableFactory& vfac,
+                        MemoryLocation* base,
+                        const MachineInt& offset,
+                        const MachineInt& size) {
+    return vfac.get_cell(base, offset, size);
+  }
+};
+
+} // end namespace memory
+
+} // end namespace core
+} // end namespace ikos
+
+namespace {
+
+using IntDomain = ikos::core::machine_int::IntervalDomain< Variable* >;
+using NullityDomain = ikos::core::nullity::NullityDomain< Variable* >;
+using PointerDomain = ikos::core::pointer::
+    PointerDomain< Variable*, MemoryLocation*, IntDomain, NullityDomain >;
+using UninitializedDomain =
+    ikos::core::uninitialized::UninitializedDomain< Variable* >;
+using LifetimeDomain = ikos::core::lifetime::LifetimeDomain< MemoryLocation* >;
+using ValueDomain = ikos::core::memory::ValueDomain< Variable*,
+                                                     MemoryLocation*,
+                                                     VariableFactory,
+                                                     IntDomain,
+                                                     NullityDomain,
+                                                     PointerDomain,
+                                                     UninitializedDomain,
+                                                     LifetimeDomain >;
+using Literal = ikos::core::Literal< Variable*, MemoryLocation* >;
+
+} // end anonymous namespace
+
+/// \brief Numbers of live pointers
+static void pointer_counts(benchmark::internal::Benchmark* b) {
+  b->RangeMultiplier(4)->Range(16, 1024)->ArgName("pointers");
+}
+
+/// \brief Pointers `p0, ..., pn` to the memory locations `m0, ..., mn`,
+/// each holding an integer
+struct LivePointers {
+  VariableFactory vfac;
+  std::vector< std::unique_ptr< MemoryLocation > > addrs;
+  std::vector< Variable* > ptrs;
+  ValueDomain inv;
+
+  explicit LivePointers(int n) {
+    for (int k = 0; k < n; k++) {
+      addrs.push_back(std::make_unique< MemoryLocation >(
+          MemoryLocation{"m" + std::to_string(k)}));
+      Variable* p = vfac.get_pointer("p" + std::to_string(k));
+      ptrs.push_back(p);
+      inv.pointers().assign_address(p, addrs.back().get(), Nullity::non_null());
+      inv.integers().assign(p->offset_var, MachineInt::zero(64, Unsigned));
+      inv.mem_write(vfac,
+                    p,
+                    Literal::machine_int(MachineInt(k, 32, Signed)),
+                    MachineInt(4, 64, Unsigned));
+    }
+  }
+};
+
+/// \brief Garbage collection after a call, when all the memory locations
+/// are roots, e.g. global variables
+static void forget_unreachable_roots(benchmark::State& state) {
+  LivePointers live(static_cast< int >(state.range(0)));
+  for (auto _ : state) {
+    auto forgotten =
+        live.inv.forget_unreachable_mem([](MemoryLocation*) { return true; });
+    benchmark::DoNotOptimize(forgotten);
+  }
+}
+
+/// \brief Garbage collection after a call, when all the memory locations
+/// are reachable from the pointer variables, e.g. heap allocations
+static void forget_unreachable_heap(benchmark::State& state) {
+  LivePointers live(static_cast< int >(state.range(0)));
+  for (auto _ : state) {
+    auto forgotten =
+        live.inv.forget_unreachable_mem([](MemoryLocation*) { return false; });
+    benchmark::DoNotOptimize(forgotten);
+  }
+}
+
+/// \brief Deallocation of one memory location, as for `free(p0)`
+static void free_one(benchmark::State& state) {
+  LivePointers live(static_cast< int >(state.range(0)));
+  MemoryLocation* addr = live.addrs.front().get();
+  for (auto _ : state) {
+    ValueDomain inv = live.inv;
+    inv.lifetime().assign_deallocated(addr);
+    inv.forget_mem(addr);
+    benchmark::DoNotOptimize(inv);
+  }
+}
+
+BENCHMARK(forget_unreachable_roots)->Apply(pointer_counts);
+BENCHMARK(forget_unreachable_heap)->Apply(pointer_counts);
+BENCHMARK(free_one)->Apply(pointer_counts);
+
+BENCHMARK_MAIN();
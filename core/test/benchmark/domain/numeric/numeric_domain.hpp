@@ -0,0 +1,200 @@
+/*******************************************************************************
+ *
+ * Benchmarks of the numerical abstract domains
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <ikos/core/example/variable_factory.hpp>
+#include <ikos/core/linear_constraint.hpp>
+#include <ikos/core/number/z_number.hpp>
+#include <ikos/core/value/numeric/interval.hpp>
+
+#include "node_allocations.hpp"
+
+using ZNumber = ikos::core::ZNumber;
+using VariableFactory = ikos::core::example::VariableFactory;
+using Variable = ikos::core::example::VariableFactory::VariableRef;
+using VariableExpr = ikos::core::VariableExpression< ZNumber, Variable >;
+using Bound = ikos::core::ZBound;
+using Interval = ikos::core::numeric::ZInterval;
+
+/// \brief Return the name of a numerical abstract domain
+///
+/// This is specialized by NUMERIC_DOMAIN_BENCHMARKS.
+template < typename Domain >
+const char* domain_name();
+
+/// \brief Numbers of variables of the benchmarked invariants
+inline void variable_counts(benchmark::internal::Benchmark* b) {
+  b->RangeMultiplier(2)->Range(8, 128)->ArgName("vars");
+}
+
+/// \brief Return the variables x0, ..., x{n-1}
+inline std::vector< Variable > make_variables(VariableFactory& vfac,
+                                              std::size_t n) {
+  std::vector< Variable > vars;
+  vars.reserve(n);
+  for (std::size_t i = 0; i < n; i++) {
+    vars.push_back(vfac.get("x" + std::to_string(i)));
+  }
+  return vars;
+}
+
+/// \brief Return an invariant where x{i} is in [0, k * i] and
+/// x{i} - x{i+1} <= k
+template < typename Domain >
+Domain make_invariant(const std::vector< Variable >& vars, int k) {
+  Domain inv = Domain::top();
+  for (std::size_t i = 0; i < vars.size(); i++) {
+    inv.set(vars[i], Interval(Bound(0), Bound(k * static_cast< int >(i))));
+  }
+  for (std::size_t i = 0; i < vars.size(); i++) {
+    if (i + 1 < vars.size()) {
+      inv.add(VariableExpr(vars[i]) - VariableExpr(vars[i + 1]) <= k);
+    }
+  }
+  inv.normalize();
+  return inv;
+}
+
+/// \brief Copy of an invariant, a baseline for the other benchmarks
+template < typename Domain >
+void copy(benchmark::State& state) {
+  VariableFactory vfac;
+  auto vars = make_variables(vfac, static_cast< std::size_t >(state.range(0)));
+  Domain inv = make_invariant< Domain >(vars, 1);
+  NodeAllocationCounters counters(state, domain_name< Domain >());
+  for (auto _ : state) {
+    Domain copy = inv;
+    benchmark::DoNotOptimize(copy);
+  }
+}
+
+/// \brief Join of two invariants
+template < typename Domain >
+void join(benchmark::State& state) {
+  VariableFactory vfac;
+  auto vars = make_variables(vfac, static_cast< std::size_t >(state.range(0)));
+  Domain a = make_invariant< Domain >(vars, 1);
+  Domain b = make_invariant< Domain >(vars, 2);
+  NodeAllocationCounters counters(state, domain_name< Domain >());
+  for (auto _ : state) {
+    Domain c = a.join(b);
+    benchmark::DoNotOptimize(c);
+  }
+}
+
+/// \brief Widening of two invariants
+template < typename Domain >
+void widen(benchmark::State& state) {
+  VariableFactory vfac;
+  auto vars = make_variables(vfac, static_cast< std::size_t >(state.range(0)));
+  Domain a = make_invariant< Domain >(vars, 1);
+  Domain b = make_invariant< Domain >(vars, 2);
+  NodeAllocationCounters counters(state, domain_name< Domain >());
+  for (auto _ : state) {
+    Domain c = a.widening(b);
+    benchmark::DoNotOptimize(c);
+  }
+}
+
+/// \brief Inclusion test of two invariants
+template < typename Domain >
+void leq(benchmark::State& state) {
+  VariableFactory vfac;
+  auto vars = make_variables(vfac, static_cast< std::size_t >(state.range(0)));
+  Domain a = make_invariant< Domain >(vars, 1);
+  Domain b = make_invariant< Domain >(vars, 2);
+  NodeAllocationCounters counters(state, domain_name< Domain >());
+  for (auto _ : state) {
+    bool r = a.leq(b);
+    benchmark::DoNotOptimize(r);
+  }
+}
+
+/// \brief Assignment x0 = x1 + x{n-1} + 1 on a copy of an invariant
+template < typename Domain >
+void assign(benchmark::State& state) {
+  VariableFactory vfac;
+  auto vars = make_variables(vfac, static_cast< std::size_t >(state.range(0)));
+  Domain inv = make_invariant< Domain >(vars, 1);
+  auto e = VariableExpr(vars[1]) + VariableExpr(vars.back()) + 1;
+  NodeAllocationCounters counters(state, domain_name< Domain >());
+  for (auto _ : state) {
+    Domain copy = inv;
+    copy.assign(vars[0], e);
+    benchmark::DoNotOptimize(copy);
+  }
+}
+
+/// \brief Constraint x0 - x{n-1} <= 1 added to a copy of an invariant
+template < typename Domain >
+void add_constraint(benchmark::State& state) {
+  VariableFactory vfac;
+  auto vars = make_variables(vfac, static_cast< std::size_t >(state.range(0)));
+  Domain inv = make_invariant< Domain >(vars, 1);
+  auto cst = VariableExpr(vars[0]) - VariableExpr(vars.back()) <= 1;
+  NodeAllocationCounters counters(state, domain_name< Domain >());
+  for (auto _ : state) {
+    Domain copy = inv;
+    copy.add(cst);
+    copy.normalize();
+    benchmark::DoNotOptimize(copy);
+  }
+}
+
+/// \brief Register the benchmarks of a numerical abstract domain
+#define NUMERIC_DOMAIN_BENCHMARKS(Domain)                     \
+  template <>                                                 \
+  const char* domain_name< Domain >() {                       \
+    return #Domain;                                           \
+  }                                                           \
+  BENCHMARK_TEMPLATE(copy, Domain)->Apply(variable_counts);   \
+  BENCHMARK_TEMPLATE(join, Domain)->Apply(variable_counts);   \
+  BENCHMARK_TEMPLATE(widen, Domain)->Apply(variable_counts);  \
+  BENCHMARK_TEMPLATE(leq, Domain)->Apply(variable_counts);    \
+  BENCHMARK_TEMPLATE(assign, Domain)->Apply(variable_counts); \
+  BENCHMARK_TEMPLATE(add_constraint, Domain)->Apply(variable_counts)
@@ -0,0 +1,203 @@
+/*******************************************************************************
+ *
+ * Benchmarks for the compaction of fixpoints
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <ikos/core/domain/numeric/dbm.hpp>
+#include <ikos/core/domain/numeric/interval.hpp>
+#include <ikos/core/example/muzq.hpp>
+#include <ikos/core/example/variable_factory.hpp>
+
+using ZNumber = ikos::core::ZNumber;
+using QNumber = ikos::core::QNumber;
+using VariableFactory = ikos::core::example::VariableFactory;
+using Variable = VariableFactory::VariableRef;
+using ZVarExpr = ikos::core::VariableExpression< ZNumber, Variable >;
+using ZLinearExpression = ikos::core::LinearExpression< ZNumber, Variable >;
+using ZLinearAssignment = ikos::core::muzq::ZLinearAssignment< Variable >;
+using ZLinearAssertion = ikos::core::muzq::ZLinearAssertion< Variable >;
+using BasicBlock = ikos::core::muzq::BasicBlock< Variable >;
+using ControlFlowGraph = ikos::core::muzq::ControlFlowGraph< Variable >;
+using ZDBM = ikos::core::numeric::DBM< ZNumber, Variable >;
+using QIntervalDomain =
+    ikos::core::numeric::IntervalDomain< QNumber, Variable >;
+using FixpointIterator =
+    ikos::core::muzq::FixpointIterator< Variable, ZDBM, QIntervalDomain >;
+
+/// \brief Number of variables of the benchmarked control flow graphs
+static const int NumVariables = 8;
+
+/// \brief Sizes of the benchmarked control flow graphs, with or without
+/// compaction
+static void cfg_sizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"blocks", "compact"});
+  for (int blocks = 16; blocks <= 256; blocks *= 4) {
+    b->Args({blocks, 0});
+    b->Args({blocks, 1});
+  }
+}
+
+/// \brief A loop and its exit, both made of a chain of `blocks` blocks
+///
+/// \code{.c}
+/// x0 = 0; ...; xn = 0; i = 0;
+/// while (i <= 99) { x0 = x0 + 1; x1 = x1 + 1; ...; i = i + 1; }
+/// x0 = x0 + i; x1 = x1 + i; ...
+/// \endcode
+struct LoopChain {
+  VariableFactory vfac;
+  Variable i;
+  std::vector< Variable > xs;
+  ControlFlowGraph cfg;
+  std::vector< BasicBlock* > blocks;
+
+  explicit LoopChain(int size) : i(vfac.get("i")), cfg("entry") {
+    for (int k = 0; k < NumVariables; k++) {
+      xs.push_back(vfac.get("x" + std::to_string(k)));
+    }
+
+    BasicBlock* entry = this->block("entry");
+    for (Variable x : xs) {
+      entry->add(
+          std::make_unique< ZLinearAssignment >(x, ZLinearExpression(0)));
+    }
+    entry->add(std::make_unique< ZLinearAssignment >(i, ZLinearExpression(0)));
+
+    BasicBlock* head = this->block("head");
+    BasicBlock* head_t = this->block("head_t");
+    BasicBlock* head_f = this->block("head_f");
+    entry->add_successor(head);
+    head->add_successor(head_t);
+    head->add_successor(head_f);
+    head_t->add(std::make_unique< ZLinearAssertion >(ZVarExpr(i) <= 99));
+    head_f->add(std::make_unique< ZLinearAssertion >(ZVarExpr(i) >= 100));
+
+    BasicBlock* body = this->chain("body", head_t, size, ZLinearExpression(1));
+    body->add(std::make_unique< ZLinearAssignment >(i, ZVarExpr(i) + 1));
+    body->add_successor(head);
+
+    this->chain("exit", head_f, size, ZLinearExpression(i));
+  }
+
+  /// \brief Create a block with the given name
+  BasicBlock* block(const std::string& name) {
+    BasicBlock* bb = cfg.get(name);
+    blocks.push_back(bb);
+    return bb;
+  }
+
+  /// \brief Create a chain of `size` blocks after `pred`, each adding `e` to
+  /// one of the variables, and return the last block
+  BasicBlock* chain(const std::string& name,
+                    BasicBlock* pred,
+                    int size,
+                    const ZLinearExpression& e) {
+    for (int k = 0; k < size; k++) {
+      BasicBlock* bb = this->block(name + std::to_string(k));
+      Variable x = xs[static_cast< std::size_t >(k % NumVariables)];
+      bb->add(std::make_unique< ZLinearAssignment >(x, ZVarExpr(x) + e));
+      pred->add_successor(bb);
+      pred = bb;
+    }
+    return pred;
+  }
+
+  /// \brief Return the number of invariants stored by the given fixpoint
+  std::size_t num_invariants(const FixpointIterator& fixpoint) const {
+    std::size_t n = 0;
+    for (BasicBlock* bb : blocks) {
+      n += fixpoint.pre(bb).is_bottom() ? 0 : 1;
+      n += fixpoint.post(bb).is_bottom() ? 0 : 1;
+    }
+    return n;
+  }
+};
+
+/// \brief Fixpoint computation, followed by the compaction of the fixpoint
+///
+/// The counter `invariants` is the number of invariants still stored once
+/// the fixpoint is computed.
+static void run(benchmark::State& state) {
+  LoopChain loop(static_cast< int >(state.range(0)));
+  bool compact = state.range(1) != 0;
+  std::size_t invariants = 0;
+  for (auto _ : state) {
+    FixpointIterator fixpoint(loop.cfg);
+    fixpoint.run();
+    if (compact) {
+      fixpoint.compact();
+    }
+    state.PauseTiming();
+    invariants = loop.num_invariants(fixpoint);
+    state.ResumeTiming();
+  }
+  state.counters["invariants"] = static_cast< double >(invariants);
+}
+
+/// \brief Visit of the invariants of a computed fixpoint
+///
+/// After compaction, the dropped invariants are recomputed.
+static void replay(benchmark::State& state) {
+  LoopChain loop(static_cast< int >(state.range(0)));
+  FixpointIterator fixpoint(loop.cfg);
+  fixpoint.run();
+  if (state.range(1) != 0) {
+    fixpoint.compact();
+  }
+  for (auto _ : state) {
+    fixpoint.replay(
+        [](BasicBlock*, const FixpointIterator::AbstractDomain& pre,
+           const FixpointIterator::AbstractDomain& post) {
+          benchmark::DoNotOptimize(pre);
+          benchmark::DoNotOptimize(post);
+        });
+  }
+}
+
+BENCHMARK(run)->Apply(cfg_sizes);
+BENCHMARK(replay)->Apply(cfg_sizes);
+
+BENCHMARK_MAIN();
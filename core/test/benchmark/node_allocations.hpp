@@ -0,0 +1,81 @@
+/*******************************************************************************
+ *
+ * Node allocation counters for the benchmarks
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <ikos/core/adt/patricia_tree/node.hpp>
+
+/// \brief Report the patricia tree node allocations of a benchmark, per
+/// iteration, as the counters `node_allocs` and `node_bytes`
+///
+/// Allocations are counted from the construction of the object, which should
+/// happen right before the benchmark loop, and attributed to `owner` in the
+/// NodeAllocationProfile.
+class NodeAllocationCounters {
+private:
+  benchmark::State& _state;
+  ikos::core::patricia_tree_utils::NodeAllocationScope _scope;
+
+public:
+  NodeAllocationCounters(benchmark::State& state, std::string owner)
+      : _state(state), _scope(std::move(owner)) {}
+
+  NodeAllocationCounters(const NodeAllocationCounters&) = delete;
+  NodeAllocationCounters(NodeAllocationCounters&&) = delete;
+  NodeAllocationCounters& operator=(const NodeAllocationCounters&) = delete;
+  NodeAllocationCounters& operator=(NodeAllocationCounters&&) = delete;
+
+  ~NodeAllocationCounters() {
+    const auto& stats = this->_scope.stats();
+    this->_state.counters["node_allocs"] =
+        benchmark::Counter(static_cast< double >(stats.allocations),
+                           benchmark::Counter::kAvgIterations);
+    this->_state.counters["node_bytes"] =
+        benchmark::Counter(static_cast< double >(stats.bytes),
+                           benchmark::Counter::kAvgIterations);
+  }
+};
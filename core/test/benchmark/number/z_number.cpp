@@ -0,0 +1,124 @@
+/*******************************************************************************
+ *
+ * Benchmarks for ZNumber
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <ikos/core/number/z_number.hpp>
+
+using ZNumber = ikos::core::ZNumber;
+
+/// \brief Sizes of the operands: fitting in a machine word, or not
+static void operand_sizes(benchmark::internal::Benchmark* b) {
+  b->Arg(0)->Arg(1)->ArgName("large");
+}
+
+/// \brief Return the left operand of a benchmark
+static ZNumber lhs(const benchmark::State& state) {
+  return ZNumber::from_string(state.range(0) != 0
+                                  ? "1267650600228229401496703205653"
+                                  : "1234567891011");
+}
+
+/// \brief Return the right operand of a benchmark
+static ZNumber rhs(const benchmark::State& state) {
+  return ZNumber::from_string(state.range(0) != 0 ? "36028797018963971"
+                                                  : "1234567");
+}
+
+/// \brief Benchmark a binary operation on ZNumber
+template < typename Operation >
+static void binary_operation(benchmark::State& state, Operation op) {
+  ZNumber a = lhs(state);
+  ZNumber b = rhs(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    benchmark::DoNotOptimize(b);
+    auto r = op(a, b);
+    benchmark::DoNotOptimize(r);
+  }
+}
+
+static void add(benchmark::State& state) {
+  binary_operation(state,
+                   [](const ZNumber& a, const ZNumber& b) { return a + b; });
+}
+BENCHMARK(add)->Apply(operand_sizes);
+
+static void sub(benchmark::State& state) {
+  binary_operation(state,
+                   [](const ZNumber& a, const ZNumber& b) { return a - b; });
+}
+BENCHMARK(sub)->Apply(operand_sizes);
+
+static void mul(benchmark::State& state) {
+  binary_operation(state,
+                   [](const ZNumber& a, const ZNumber& b) { return a * b; });
+}
+BENCHMARK(mul)->Apply(operand_sizes);
+
+static void div(benchmark::State& state) {
+  binary_operation(state,
+                   [](const ZNumber& a, const ZNumber& b) { return a / b; });
+}
+BENCHMARK(div)->Apply(operand_sizes);
+
+static void mod(benchmark::State& state) {
+  binary_operation(state, [](const ZNumber& a, const ZNumber& b) {
+    return ikos::core::mod(a, b);
+  });
+}
+BENCHMARK(mod)->Apply(operand_sizes);
+
+static void gcd(benchmark::State& state) {
+  binary_operation(state, [](const ZNumber& a, const ZNumber& b) {
+    return ikos::core::gcd(a, b);
+  });
+}
+BENCHMARK(gcd)->Apply(operand_sizes);
+
+static void leq(benchmark::State& state) {
+  binary_operation(state,
+                   [](const ZNumber& a, const ZNumber& b) { return a <= b; });
+}
+BENCHMARK(leq)->Apply(operand_sizes);
+
+BENCHMARK_MAIN();
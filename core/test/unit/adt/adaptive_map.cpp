@@ -0,0 +1,247 @@
+/*******************************************************************************
+ *
+ * Tests for AdaptiveMap
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#define BOOST_TEST_MODULE test_adaptive_map
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/adt/adaptive_map.hpp>
+
+using Index = ikos::core::Index;
+using Map = ikos::core::AdaptiveMap< Index, int >;
+using PatriciaTreeMap = ikos::core::PatriciaTreeMap< Index, int >;
+
+namespace {
+
+constexpr std::size_t FlatLimit = Map::FlatLimit;
+
+/// \brief Create a map binding keys in [first, last) to `value`
+Map make_map(Index first, Index last, int value) {
+  Map m;
+  for (Index i = first; i < last; i++) {
+    m.insert_or_assign(i, value);
+  }
+  return m;
+}
+
+/// \brief Return true if the map holds the given bindings
+bool holds(const Map& m, Index first, Index last, int value) {
+  if (m.size() != last - first) {
+    return false;
+  }
+  for (Index i = first; i < last; i++) {
+    auto v = m.at(i);
+    if (!v || *v != value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool leq(const Map& a, const Map& b) {
+  return a.leq(b, [](int x, int y) { return x <= y; });
+}
+
+bool equals(const Map& a, const Map& b) {
+  return a.equals(b, [](int x, int y) { return x == y; });
+}
+
+Map join(Map a, const Map& b) {
+  a.join_with(b, [](int x, int y) { return boost::optional< int >(x + y); });
+  return a;
+}
+
+Map meet(Map a, const Map& b) {
+  a.intersect_with(b,
+                   [](int x, int y) { return boost::optional< int >(x + y); });
+  return a;
+}
+
+} // end anonymous namespace
+
+BOOST_AUTO_TEST_CASE(insert_erase) {
+  Map m;
+  BOOST_CHECK(m.empty());
+  BOOST_CHECK(!m.is_tree());
+  BOOST_CHECK(!m.at(1));
+  BOOST_CHECK(m.begin() == m.end());
+
+  // insert in decreasing order
+  for (Index i = FlatLimit; i > 0; i--) {
+    m.insert_or_assign(i, static_cast< int >(i));
+  }
+  BOOST_CHECK(m.size() == FlatLimit);
+  BOOST_CHECK(!m.is_tree());
+  for (const auto& p : m) {
+    BOOST_CHECK(p.second == static_cast< int >(p.first));
+  }
+
+  // The sorted array is iterated in the same order as a patricia tree
+  PatriciaTreeMap t;
+  for (Index i = 1; i <= FlatLimit; i++) {
+    t.insert_or_assign(i, static_cast< int >(i));
+  }
+  BOOST_CHECK(std::equal(m.begin(), m.end(), t.begin(), t.end()));
+
+  m.insert_or_assign(FlatLimit + 1, 0);
+  t.insert_or_assign(FlatLimit + 1, 0);
+  BOOST_CHECK(m.size() == FlatLimit + 1);
+  BOOST_CHECK(m.is_tree());
+  BOOST_CHECK(*m.at(FlatLimit + 1) == 0);
+  BOOST_CHECK(*m.at(1) == 1);
+  BOOST_CHECK(std::equal(m.begin(), m.end(), t.begin(), t.end()));
+
+  m.erase(FlatLimit + 1);
+  BOOST_CHECK(!m.at(FlatLimit + 1));
+  m.clear();
+  BOOST_CHECK(m.empty());
+  BOOST_CHECK(!m.is_tree());
+}
+
+BOOST_AUTO_TEST_CASE(update_or_insert) {
+  auto add = [](int x, int y) {
+    if (x + y == 0) {
+      return boost::optional< int >(boost::none);
+    }
+    return boost::optional< int >(x + y);
+  };
+
+  Map m;
+  m.update_or_insert(add, 1, 1);
+  m.update_or_insert(add, 1, 2);
+  BOOST_CHECK(*m.at(1) == 3);
+  m.update_or_insert(add, 1, -3);
+  BOOST_CHECK(!m.at(1));
+  BOOST_CHECK(m.empty());
+}
+
+BOOST_AUTO_TEST_CASE(copy_on_write) {
+  Map m1 = make_map(0, 4, 1);
+  Map m2(m1);
+  m2.insert_or_assign(2, 5);
+  m2.erase(3);
+  BOOST_CHECK(holds(m1, 0, 4, 1));
+  BOOST_CHECK(*m2.at(2) == 5);
+  BOOST_CHECK(!m2.at(3));
+}
+
+BOOST_AUTO_TEST_CASE(lattice_flat) {
+  Map a = make_map(0, 4, 1);
+  Map b = make_map(2, 6, 1);
+  Map c = make_map(2, 4, 1);
+
+  BOOST_CHECK(leq(a, c));
+  BOOST_CHECK(leq(b, c));
+  BOOST_CHECK(!leq(c, a));
+  BOOST_CHECK(leq(a, Map()));
+  BOOST_CHECK(!leq(Map(), a));
+  BOOST_CHECK(equals(a, make_map(0, 4, 1)));
+  BOOST_CHECK(!equals(a, b));
+
+  Map j = join(a, b);
+  BOOST_CHECK(j.size() == 6);
+  BOOST_CHECK(*j.at(0) == 1);
+  BOOST_CHECK(*j.at(2) == 2);
+  BOOST_CHECK(*j.at(5) == 1);
+
+  Map m = meet(a, b);
+  BOOST_CHECK(holds(m, 2, 4, 2));
+  BOOST_CHECK(meet(a, Map()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(lattice_mixed) {
+  Map small = make_map(0, 4, 1);
+  Map large = make_map(0, 2 * FlatLimit, 1);
+  BOOST_CHECK(!small.is_tree());
+  BOOST_CHECK(large.is_tree());
+
+  BOOST_CHECK(leq(large, small));
+  BOOST_CHECK(!leq(small, large));
+  BOOST_CHECK(!equals(small, large));
+  BOOST_CHECK(equals(large, make_map(0, 2 * FlatLimit, 1)));
+
+  // The union grows a sorted array into a tree
+  Map j = join(small, large);
+  BOOST_CHECK(j.is_tree());
+  BOOST_CHECK(j.size() == 2 * FlatLimit);
+  BOOST_CHECK(*j.at(0) == 2);
+  BOOST_CHECK(*j.at(FlatLimit) == 1);
+  BOOST_CHECK(equals(join(make_map(0, FlatLimit, 1),
+                          make_map(FlatLimit, 2 * FlatLimit, 1)),
+                     large));
+
+  // The intersection shrinks a tree into a sorted array
+  Map m = meet(large, small);
+  BOOST_CHECK(!m.is_tree());
+  BOOST_CHECK(holds(m, 0, 4, 2));
+  BOOST_CHECK(holds(meet(small, large), 0, 4, 2));
+
+  Map other = make_map(2 * FlatLimit - 4, 4 * FlatLimit, 1);
+  m = meet(large, other);
+  BOOST_CHECK(!m.is_tree());
+  BOOST_CHECK(holds(m, 2 * FlatLimit - 4, 2 * FlatLimit, 2));
+}
+
+BOOST_AUTO_TEST_CASE(same_as_patricia_tree) {
+  // Compare with a patricia tree on pseudo-random operations
+  Map m;
+  PatriciaTreeMap t;
+  unsigned seed = 42;
+  auto next = [&seed]() {
+    seed = seed * 1103515245U + 12345U;
+    return (seed >> 16) % (3 * FlatLimit);
+  };
+  for (int i = 0; i < 2000; i++) {
+    Index key = next();
+    if (next() % 3 == 0) {
+      m.erase(key);
+      t.erase(key);
+    } else {
+      m.insert_or_assign(key, i);
+      t.insert_or_assign(key, i);
+    }
+    BOOST_CHECK(m.size() == t.size());
+    BOOST_CHECK(m.at(key) == t.at(key));
+  }
+  BOOST_CHECK(std::equal(m.begin(), m.end(), t.begin(), t.end()));
+}
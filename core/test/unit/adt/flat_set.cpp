@@ -0,0 +1,119 @@
+/*******************************************************************************
+ *
+ * Tests for FlatSet
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#define BOOST_TEST_MODULE test_flat_set
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/adt/flat_set.hpp>
+
+using Index = ikos::core::Index;
+using Set = ikos::core::FlatSet< Index >;
+
+BOOST_AUTO_TEST_CASE(insert_erase) {
+  Set s;
+  BOOST_CHECK(s.empty());
+  BOOST_CHECK(s.size() == 0);
+  BOOST_CHECK(!s.contains(1));
+
+  // insert 99, 97, ..., 1 then 0, 2, ..., 98
+  for (std::size_t i = 99; i < 100; i -= 2) {
+    s.insert(i);
+  }
+  for (std::size_t i = 0; i < 100; i += 2) {
+    s.insert(i);
+  }
+  s.insert(42);
+  BOOST_CHECK(s.size() == 100);
+  Index expected = 0;
+  for (Index i : s) {
+    BOOST_CHECK(i == expected);
+    expected++;
+  }
+
+  s.erase(100);
+  BOOST_CHECK(s.size() == 100);
+  s.erase(42);
+  BOOST_CHECK(s.size() == 99);
+  BOOST_CHECK(!s.contains(42));
+  BOOST_CHECK(s.contains(41));
+  BOOST_CHECK(s.contains(43));
+
+  s.clear();
+  BOOST_CHECK(s.empty());
+}
+
+BOOST_AUTO_TEST_CASE(copy_on_write) {
+  Set s1{3, 1, 2, 1};
+  BOOST_CHECK(s1.size() == 3);
+
+  Set s2(s1);
+  s2.insert(4);
+  BOOST_CHECK(s1.size() == 3);
+  BOOST_CHECK(!s1.contains(4));
+  BOOST_CHECK(s2.size() == 4);
+  BOOST_CHECK(s2.contains(4));
+}
+
+BOOST_AUTO_TEST_CASE(lattice) {
+  Set s1{1, 2, 3};
+  Set s2{2, 3, 4, 5};
+  Set s3{2, 3};
+
+  BOOST_CHECK(s3.is_subset_of(s1));
+  BOOST_CHECK(s3.is_subset_of(s2));
+  BOOST_CHECK(!s1.is_subset_of(s2));
+  BOOST_CHECK(Set().is_subset_of(s1));
+  BOOST_CHECK(!s1.is_subset_of(Set()));
+
+  BOOST_CHECK(s1.join(s2).equals(Set{1, 2, 3, 4, 5}));
+  BOOST_CHECK(s1.join(s3).equals(s1));
+  BOOST_CHECK(s3.join(s1).equals(s1));
+  BOOST_CHECK(s1.intersect(s2).equals(s3));
+  BOOST_CHECK(s1.intersect(Set()).empty());
+  BOOST_CHECK(s1.difference(s2).equals(Set{1}));
+  BOOST_CHECK(s2.difference(s1).equals(Set{4, 5}));
+  BOOST_CHECK(s1.difference(s1).empty());
+  BOOST_CHECK(!s1.equals(s2));
+  BOOST_CHECK(s1 == Set({3, 2, 1}));
+}
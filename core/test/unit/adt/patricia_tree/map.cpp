@@ -46,6 +46,10 @@
 #include <boost/test/output_test_stream.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <ikos/core/adt/patricia_tree/map.hpp>
 
 BOOST_AUTO_TEST_CASE(test_patricia_tree_map) {
@@ -268,3 +272,77 @@ BOOST_AUTO_TEST_CASE(test_patricia_tree_map) {
   const std::pair< Index, std::string > tab4[] = {{1, "hellozzzzz"}};
   BOOST_CHECK(std::equal(m.begin(), m.end(), std::begin(tab4), std::end(tab4)));
 }
+
+BOOST_AUTO_TEST_CASE(test_hash_consed_patricia_tree_map) {
+  using Index = ikos::core::Index;
+  using Map = ikos::core::PatriciaTreeMap< Index, std::string, true >;
+
+  Map m1;
+  Map m2;
+  for (Index i = 0; i < 100; i++) {
+    m1.insert_or_assign(i, std::to_string(i));
+  }
+  for (Index i = 100; i-- > 0;) {
+    m2.insert_or_assign(i, std::to_string(i));
+  }
+  BOOST_CHECK(m1.equals(m2, std::equal_to< std::string >()));
+  BOOST_CHECK(m1.leq(m2, std::equal_to< std::string >()));
+
+  m2.insert_or_assign(42, "a");
+  BOOST_CHECK(!m1.equals(m2, std::equal_to< std::string >()));
+  m2.insert_or_assign(42, "42");
+  BOOST_CHECK(m1.equals(m2, std::equal_to< std::string >()));
+
+  m2.erase(7);
+  BOOST_CHECK(!m1.equals(m2, std::equal_to< std::string >()));
+  BOOST_CHECK(m1.leq(m2, std::equal_to< std::string >()));
+  m2.insert_or_assign(7, "7");
+  BOOST_CHECK(m1.equals(m2, std::equal_to< std::string >()));
+
+  Map m = m1.join(m2, [](const std::string& x, const std::string& y) {
+    return boost::optional< std::string >(x == y ? x : x + y);
+  });
+  BOOST_CHECK(m.equals(m1, std::equal_to< std::string >()));
+  BOOST_CHECK(m.size() == 100);
+}
+
+#ifndef IKOS_SINGLE_THREADED
+
+BOOST_AUTO_TEST_CASE(test_patricia_tree_map_shared_between_threads) {
+  using Index = ikos::core::Index;
+  using Map = ikos::core::PatriciaTreeMap< Index, std::string >;
+
+  Map snapshot;
+  for (Index i = 0; i < 1000; i++) {
+    snapshot.insert_or_assign(i, std::to_string(i));
+  }
+
+  // Each thread copies the snapshot without a deep copy, and updates its copy
+  std::vector< bool > results(4, false);
+  std::vector< std::thread > threads;
+  for (std::size_t t = 0; t < results.size(); t++) {
+    threads.emplace_back([&snapshot, &results, t] {
+      bool ok = true;
+      for (Index i = 0; i < 1000; i++) {
+        Map m = snapshot;
+        m.insert_or_assign(i, "thread " + std::to_string(t));
+        m.erase((i + 1) % 1000);
+        ok = ok && m.size() == 999 && *m.at(i) == "thread " + std::to_string(t);
+      }
+      results[t] = ok;
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (bool ok : results) {
+    BOOST_CHECK(ok);
+  }
+  BOOST_CHECK(snapshot.size() == 1000);
+  for (Index i = 0; i < 1000; i++) {
+    BOOST_CHECK(*snapshot.at(i) == std::to_string(i));
+  }
+}
+
+#endif
@@ -0,0 +1,185 @@
+/*******************************************************************************
+ *
+ * Tests for NodePtr and NodePool
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#define BOOST_TEST_MODULE test_patricia_tree_node
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/adt/patricia_tree/node.hpp>
+
+namespace {
+
+using ikos::core::patricia_tree_utils::AtomicRefCount;
+using ikos::core::patricia_tree_utils::BasicRefCountedNode;
+using ikos::core::patricia_tree_utils::NodeAllocationProfile;
+using ikos::core::patricia_tree_utils::NodeAllocationScope;
+using ikos::core::patricia_tree_utils::NodeAllocationStats;
+using ikos::core::patricia_tree_utils::NodePool;
+using ikos::core::patricia_tree_utils::NodePtr;
+using ikos::core::patricia_tree_utils::NonAtomicRefCount;
+using ikos::core::patricia_tree_utils::RefCountedNode;
+using ikos::core::patricia_tree_utils::make_node_ptr;
+using ikos::core::patricia_tree_utils::static_node_ptr_cast;
+
+int NumLiveNodes = 0;
+
+class Base : public RefCountedNode {
+public:
+  Base() { NumLiveNodes++; }
+
+  ~Base() override { NumLiveNodes--; }
+
+  virtual int value() const = 0;
+};
+
+class Derived final : public Base {
+private:
+  int _value;
+  char _padding[100];
+
+public:
+  explicit Derived(int value) : _value(value), _padding() {}
+
+  int value() const override { return this->_value; }
+};
+
+template < typename RefCount >
+class Leaf final : public BasicRefCountedNode< RefCount > {
+public:
+  Leaf() { NumLiveNodes++; }
+
+  ~Leaf() override { NumLiveNodes--; }
+};
+
+} // end anonymous namespace
+
+BOOST_AUTO_TEST_CASE(ref_count) {
+  {
+    NodePtr< const Base > p = make_node_ptr< const Derived >(1);
+    BOOST_CHECK(NumLiveNodes == 1);
+    BOOST_CHECK(p != nullptr);
+    BOOST_CHECK(p->value() == 1);
+
+    NodePtr< const Base > q = p;
+    BOOST_CHECK(NumLiveNodes == 1);
+    BOOST_CHECK(q == p);
+
+    auto d = static_node_ptr_cast< const Derived >(q);
+    BOOST_CHECK(d == p);
+
+    p.reset();
+    BOOST_CHECK(p == nullptr);
+    BOOST_CHECK(NumLiveNodes == 1);
+
+    q = make_node_ptr< const Derived >(2);
+    BOOST_CHECK(NumLiveNodes == 2);
+    BOOST_CHECK(q != d);
+
+    d = nullptr;
+    BOOST_CHECK(NumLiveNodes == 1);
+
+    NodePtr< const Base > r = std::move(q);
+    BOOST_CHECK(q == nullptr);
+    BOOST_CHECK(r->value() == 2);
+    BOOST_CHECK(NumLiveNodes == 1);
+  }
+  BOOST_CHECK(NumLiveNodes == 0);
+}
+
+BOOST_AUTO_TEST_CASE(pool) {
+  const Base* first = nullptr;
+  {
+    auto p = make_node_ptr< const Derived >(1);
+    first = p.get();
+  }
+  // The block is reused by the next allocation of the same size
+  auto q = make_node_ptr< const Derived >(2);
+  BOOST_CHECK(q->value() == 2);
+#ifndef IKOS_DISABLE_NODE_POOL
+  BOOST_CHECK(q.get() == first);
+#endif
+  BOOST_CHECK(NumLiveNodes == 1);
+}
+
+BOOST_AUTO_TEST_CASE(allocation_stats) {
+  NodeAllocationProfile::get().clear();
+  NodeAllocationStats before = NodePool::stats();
+  {
+    NodeAllocationScope outer("outer");
+    auto p = make_node_ptr< const Derived >(1);
+    {
+      NodeAllocationScope inner("inner");
+      auto q = make_node_ptr< const Derived >(2);
+      auto r = make_node_ptr< const Derived >(3);
+      BOOST_CHECK(inner.stats().allocations == 2);
+      BOOST_CHECK(inner.stats().bytes == 2 * sizeof(Derived));
+    }
+    BOOST_CHECK(outer.stats().allocations == 3);
+    BOOST_CHECK(outer.stats().deallocations == 2);
+  }
+  NodeAllocationStats diff = NodePool::stats() - before;
+  BOOST_CHECK(diff.allocations == 3);
+  BOOST_CHECK(diff.deallocations == 3);
+
+  auto owners = NodeAllocationProfile::get().owners();
+  BOOST_CHECK(owners.size() == 2);
+  BOOST_CHECK(owners["inner"].allocations == 2);
+  BOOST_CHECK(owners["inner"].deallocations == 2);
+  BOOST_CHECK(owners["outer"].allocations == 3);
+  BOOST_CHECK(owners["outer"].deallocations == 3);
+}
+
+BOOST_AUTO_TEST_CASE(ref_count_policy) {
+  static_assert(!NonAtomicRefCount::ThreadSafe, "unexpected policy");
+  static_assert(AtomicRefCount::ThreadSafe, "unexpected policy");
+  {
+    auto p = make_node_ptr< const Leaf< NonAtomicRefCount > >();
+    auto q = p;
+    auto r = make_node_ptr< const Leaf< AtomicRefCount > >();
+    auto s = r;
+    BOOST_CHECK(NumLiveNodes == 2);
+    p.reset();
+    r.reset();
+    BOOST_CHECK(NumLiveNodes == 2);
+  }
+  BOOST_CHECK(NumLiveNodes == 0);
+}
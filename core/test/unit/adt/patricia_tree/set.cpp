@@ -197,3 +197,36 @@ BOOST_AUTO_TEST_CASE(test_patricia_tree_set) {
   s2.insert(1);
   BOOST_CHECK(s1.intersect(s2).equals(Set({1})));
 }
+
+BOOST_AUTO_TEST_CASE(test_hash_consed_patricia_tree_set) {
+  using Index = ikos::core::Index;
+  using Set = ikos::core::PatriciaTreeSet< Index, true >;
+
+  Set s1;
+  Set s2;
+  for (Index i = 0; i < 100; i++) {
+    s1.insert(i);
+  }
+  for (Index i = 100; i-- > 0;) {
+    s2.insert(i);
+  }
+  BOOST_CHECK(s1.equals(s2));
+  BOOST_CHECK(s1.hash() == s2.hash());
+
+  s2.erase(5);
+  BOOST_CHECK(!s1.equals(s2));
+  BOOST_CHECK(s2.is_subset_of(s1));
+  s2.insert(5);
+  BOOST_CHECK(s1.equals(s2));
+
+  BOOST_CHECK(s1.join(s2).equals(s1));
+  BOOST_CHECK(s1.intersect(s2).equals(s1));
+  BOOST_CHECK(s1.difference(s2).empty());
+
+  Set s3 = {1, 2, 3};
+  Set s4 = {3, 2, 1};
+  BOOST_CHECK(s3.equals(s4));
+  BOOST_CHECK(s3.size() == 3);
+  s3.filter([](Index i) { return i != 2; });
+  BOOST_CHECK(s3.equals(Set{1, 3}));
+}
@@ -0,0 +1,159 @@
+/*******************************************************************************
+ *
+ * Tests for DiscreteDomain
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#define BOOST_TEST_MODULE test_exception_domain
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/domain/exception/exception.hpp>
+#include <ikos/core/domain/numeric/interval.hpp>
+#include <ikos/core/example/variable_factory.hpp>
+#include <ikos/core/number/z_number.hpp>
+
+using ZNumber = ikos::core::ZNumber;
+using VariableFactory = ikos::core::example::VariableFactory;
+using Variable = ikos::core::example::VariableFactory::VariableRef;
+using Interval = ikos::core::numeric::ZInterval;
+using IntervalDomain = ikos::core::numeric::IntervalDomain< ZNumber, Variable >;
+using ExceptionDomain =
+    ikos::core::exception::ExceptionDomain< IntervalDomain >;
+
+BOOST_AUTO_TEST_CASE(is_top_and_bottom) {
+  BOOST_CHECK(ExceptionDomain::top().is_top());
+  BOOST_CHECK(!ExceptionDomain::top().is_bottom());
+
+  BOOST_CHECK(!ExceptionDomain::bottom().is_top());
+  BOOST_CHECK(ExceptionDomain::bottom().is_bottom());
+
+  ExceptionDomain inv = ExceptionDomain::top_no_exceptions();
+  BOOST_CHECK(!inv.is_top());
+  BOOST_CHECK(!inv.is_bottom());
+  BOOST_CHECK(inv.is_normal_flow_top());
+  BOOST_CHECK(inv.is_caught_exceptions_bottom());
+  BOOST_CHECK(inv.is_propagated_exceptions_bottom());
+  BOOST_CHECK(inv.caught_exceptions().is_bottom());
+  BOOST_CHECK(inv.is_caught_exceptions_bottom());
+
+  inv.set_to_top();
+  BOOST_CHECK(inv.is_top());
+
+  inv.set_to_bottom();
+  BOOST_CHECK(inv.is_bottom());
+}
+
+BOOST_AUTO_TEST_CASE(leq_and_equals) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+
+  ExceptionDomain a = ExceptionDomain::top_no_exceptions();
+  ExceptionDomain b = ExceptionDomain::top_no_exceptions();
+  BOOST_CHECK(a.leq(b));
+  BOOST_CHECK(a.equals(b));
+
+  // Materialize a bottom exceptional state
+  b.propagated_exceptions().set_to_bottom();
+  BOOST_CHECK(a.leq(b));
+  BOOST_CHECK(b.leq(a));
+  BOOST_CHECK(a.equals(b));
+
+  b.throw_exception();
+  BOOST_CHECK(!b.leq(a));
+  BOOST_CHECK(!a.leq(b));
+  BOOST_CHECK(!a.equals(b));
+
+  a.set_normal_flow_to_bottom();
+  BOOST_CHECK(a.leq(b));
+  BOOST_CHECK(ExceptionDomain::bottom().leq(a));
+  BOOST_CHECK(a.leq(ExceptionDomain::top()));
+}
+
+BOOST_AUTO_TEST_CASE(join_and_meet) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+
+  ExceptionDomain a = ExceptionDomain::top_no_exceptions();
+  a.normal().set(x, Interval(ZNumber(1)));
+  ExceptionDomain b = a;
+  b.throw_exception();
+  BOOST_CHECK(b.is_normal_flow_bottom());
+  BOOST_CHECK(!b.is_caught_exceptions_bottom());
+
+  ExceptionDomain c = a;
+  c.join_with(b);
+  BOOST_CHECK(c.normal().to_interval(x) == Interval(ZNumber(1)));
+  BOOST_CHECK(c.caught_exceptions().to_interval(x) == Interval(ZNumber(1)));
+  BOOST_CHECK(c.is_propagated_exceptions_bottom());
+
+  c = a;
+  c.meet_with(b);
+  BOOST_CHECK(c.is_bottom());
+
+  c = b;
+  c.widen_with(a);
+  BOOST_CHECK(c.normal().to_interval(x) == Interval(ZNumber(1)));
+  BOOST_CHECK(c.caught_exceptions().to_interval(x) == Interval(ZNumber(1)));
+}
+
+BOOST_AUTO_TEST_CASE(exceptions) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+
+  ExceptionDomain inv = ExceptionDomain::top_no_exceptions();
+  inv.normal().set(x, Interval(ZNumber(1)));
+  inv.throw_exception();
+  inv.merge_caught_in_propagated_exceptions();
+  BOOST_CHECK(inv.is_caught_exceptions_bottom());
+  BOOST_CHECK(inv.propagated_exceptions().to_interval(x) ==
+              Interval(ZNumber(1)));
+
+  inv.merge_propagated_in_caught_exceptions();
+  BOOST_CHECK(inv.is_propagated_exceptions_bottom());
+  BOOST_CHECK(inv.caught_exceptions().to_interval(x) == Interval(ZNumber(1)));
+
+  inv.enter_catch();
+  BOOST_CHECK(inv.normal().to_interval(x) == Interval(ZNumber(1)));
+  BOOST_CHECK(inv.is_caught_exceptions_bottom());
+  BOOST_CHECK(inv.is_propagated_exceptions_bottom());
+
+  inv.enter_catch();
+  BOOST_CHECK(inv.is_bottom());
+}
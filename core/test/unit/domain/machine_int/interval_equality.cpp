@@ -0,0 +1,180 @@
+/*******************************************************************************
+ *
+ * Tests for machine_int::IntervalEqualityDomain
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#define BOOST_TEST_MODULE test_machine_int_interval_equality_domain
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/domain/machine_int/interval_equality.hpp>
+#include <ikos/core/example/machine_int/variable_factory.hpp>
+
+using Int = ikos::core::MachineInt;
+using Interval = ikos::core::machine_int::Interval;
+using ikos::core::Signed;
+using ikos::core::machine_int::BinaryOperator;
+using ikos::core::machine_int::Predicate;
+using VariableFactory = ikos::core::example::machine_int::VariableFactory;
+using Variable = VariableFactory::VariableRef;
+using LinearExpr = ikos::core::LinearExpression< Int, Variable >;
+using IntervalEqualityDomain =
+    ikos::core::machine_int::IntervalEqualityDomain< Variable >;
+
+/// \brief Return the linear expression `x - y`
+static LinearExpr diff(Variable x, Variable y) {
+  LinearExpr e(Int(0, 32, Signed));
+  e.add(Int(1, 32, Signed), x);
+  e.add(Int(-1, 32, Signed), y);
+  return e;
+}
+
+BOOST_AUTO_TEST_CASE(is_top_and_bottom) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x", 32, Signed));
+  Variable y(vfac.get("y", 32, Signed));
+
+  BOOST_CHECK(IntervalEqualityDomain::top().is_top());
+  BOOST_CHECK(!IntervalEqualityDomain::top().is_bottom());
+  BOOST_CHECK(!IntervalEqualityDomain::bottom().is_top());
+  BOOST_CHECK(IntervalEqualityDomain::bottom().is_bottom());
+
+  IntervalEqualityDomain inv;
+  inv.assign(x, y);
+  BOOST_CHECK(!inv.is_top());
+  BOOST_CHECK(!inv.is_bottom());
+
+  inv.add(Predicate::LT, x, y);
+  BOOST_CHECK(inv.is_bottom());
+}
+
+BOOST_AUTO_TEST_CASE(assign) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x", 32, Signed));
+  Variable y(vfac.get("y", 32, Signed));
+  Variable z(vfac.get("z", 32, Signed));
+
+  IntervalEqualityDomain inv;
+  inv.assign(y, x);
+  LinearExpr e(Int(0, 32, Signed));
+  e.add(Int(1, 32, Signed), y);
+  inv.assign(z, e);
+  BOOST_CHECK(inv.to_interval(diff(x, z)) ==
+              Interval(Int(0, 32, Signed)));
+
+  inv.apply(BinaryOperator::Sub, y, x, z);
+  BOOST_CHECK(inv.to_interval(y) == Interval(Int(0, 32, Signed)));
+  BOOST_CHECK(inv.to_interval(diff(x, z)) ==
+              Interval(Int(0, 32, Signed)));
+  BOOST_CHECK(inv.to_interval(diff(x, y)) ==
+              Interval::top(32, Signed));
+
+  inv.assign(x, Int(1, 32, Signed));
+  BOOST_CHECK(inv.to_interval(diff(x, z)) ==
+              Interval::top(32, Signed));
+}
+
+BOOST_AUTO_TEST_CASE(add) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x", 32, Signed));
+  Variable y(vfac.get("y", 32, Signed));
+  Variable z(vfac.get("z", 32, Signed));
+
+  IntervalEqualityDomain inv;
+  inv.set(x, Interval(Int(0, 32, Signed), Int(10, 32, Signed)));
+  inv.set(y, Interval(Int(5, 32, Signed), Int(20, 32, Signed)));
+  inv.add(Predicate::EQ, x, y);
+  BOOST_CHECK(inv.to_interval(x) ==
+              Interval(Int(5, 32, Signed), Int(10, 32, Signed)));
+  BOOST_CHECK(inv.to_interval(y) ==
+              Interval(Int(5, 32, Signed), Int(10, 32, Signed)));
+
+  // Refining a member refines its class
+  inv.add(Predicate::LE, x, Int(7, 32, Signed));
+  BOOST_CHECK(inv.to_interval(y) ==
+              Interval(Int(5, 32, Signed), Int(7, 32, Signed)));
+
+  inv.add(Predicate::LE, x, y);
+  BOOST_CHECK(!inv.is_bottom());
+  inv.add(Predicate::NE, x, y);
+  BOOST_CHECK(inv.is_bottom());
+
+  inv.set_to_top();
+  inv.add(Predicate::EQ, x, y);
+  inv.add(Predicate::EQ, y, z);
+  inv.forget(y);
+  BOOST_CHECK(inv.to_interval(diff(x, z)) ==
+              Interval(Int(0, 32, Signed)));
+}
+
+BOOST_AUTO_TEST_CASE(leq_and_join) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x", 32, Signed));
+  Variable y(vfac.get("y", 32, Signed));
+  Variable z(vfac.get("z", 32, Signed));
+
+  IntervalEqualityDomain inv1;
+  inv1.assign(y, x);
+  inv1.assign(z, x);
+
+  IntervalEqualityDomain inv2;
+  inv2.assign(y, x);
+  inv2.assign(z, Int(0, 32, Signed));
+
+  BOOST_CHECK(inv1.leq(IntervalEqualityDomain::top()));
+  BOOST_CHECK(!IntervalEqualityDomain::top().leq(inv1));
+  BOOST_CHECK(!inv1.leq(inv2));
+  BOOST_CHECK(!inv2.leq(inv1));
+
+  IntervalEqualityDomain join = inv1.join(inv2);
+  BOOST_CHECK(inv1.leq(join));
+  BOOST_CHECK(inv2.leq(join));
+  BOOST_CHECK(join.to_interval(diff(x, y)) ==
+              Interval(Int(0, 32, Signed)));
+  BOOST_CHECK(join.to_interval(diff(x, z)) ==
+              Interval::top(32, Signed));
+
+  IntervalEqualityDomain meet = inv1.meet(inv2);
+  BOOST_CHECK(meet.to_interval(x) == Interval(Int(0, 32, Signed)));
+  BOOST_CHECK(meet.to_interval(y) == Interval(Int(0, 32, Signed)));
+
+  BOOST_CHECK(inv1.join(IntervalEqualityDomain::bottom()).equals(inv1));
+  BOOST_CHECK(IntervalEqualityDomain::bottom().join(inv1).equals(inv1));
+}
@@ -0,0 +1,196 @@
+/*******************************************************************************
+ *
+ * Tests for machine_int::TraceDomain
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#define BOOST_TEST_MODULE test_machine_int_trace_domain
+#define BOOST_TEST_DYN_LINK
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/domain/machine_int/interval.hpp>
+#include <ikos/core/domain/machine_int/numeric_domain_adapter.hpp>
+#include <ikos/core/domain/machine_int/trace.hpp>
+#include <ikos/core/domain/numeric/dbm.hpp>
+#include <ikos/core/example/machine_int/variable_factory.hpp>
+
+using ZNumber = ikos::core::ZNumber;
+using Int = ikos::core::MachineInt;
+using Interval = ikos::core::machine_int::Interval;
+using Congruence = ikos::core::machine_int::Congruence;
+using ikos::core::LogicError;
+using ikos::core::Signed;
+using ikos::core::Signedness;
+using ikos::core::Unsigned;
+using ikos::core::machine_int::BinaryOperator;
+using ikos::core::machine_int::Predicate;
+using ikos::core::machine_int::TraceReader;
+using ikos::core::machine_int::TraceWriter;
+using VariableFactory = ikos::core::example::machine_int::VariableFactory;
+using Variable = VariableFactory::VariableRef;
+using LinearExpr = ikos::core::LinearExpression< Int, Variable >;
+using IntervalDomain = ikos::core::machine_int::IntervalDomain< Variable >;
+using TraceDomain =
+    ikos::core::machine_int::TraceDomain< Variable, IntervalDomain >;
+using DBM = ikos::core::numeric::DBM< ZNumber, Variable >;
+using DBMDomain =
+    ikos::core::machine_int::NumericDomainAdapter< Variable, DBM >;
+
+namespace {
+
+/// \brief Replay a trace on the given domain
+template < typename Domain >
+class Replay {
+public:
+  VariableFactory vfac;
+  std::vector< Variable > vars;
+  ikos::core::machine_int::TraceReplayer< Variable, Domain > replayer;
+
+  explicit Replay(std::istream& in)
+      : replayer([this](std::uint64_t id, unsigned bit_width, Signedness sign) {
+          Variable x =
+              this->vfac.get("v" + std::to_string(id), bit_width, sign);
+          this->vars.push_back(x);
+          return x;
+        }) {
+    TraceReader reader(in);
+    this->replayer.replay(reader);
+  }
+};
+
+} // end anonymous namespace
+
+BOOST_AUTO_TEST_CASE(replay) {
+  VariableFactory vfac;
+  Variable i(vfac.get("i", 32, Signed));
+  Variable j(vfac.get("j", 32, Signed));
+  Variable n(vfac.get("n", 32, Unsigned));
+
+  std::stringstream buffer;
+  TraceWriter trace(buffer);
+
+  TraceDomain inv(IntervalDomain::top(), trace);
+  inv.assign(i, Int(0, 32, Signed));
+  inv.set(n, Interval(Int(10, 32, Unsigned), Int(20, 32, Unsigned)));
+  inv.refine(j, Congruence(Int(2, 32, Signed), Int(1, 32, Signed)));
+
+  TraceDomain head(inv);
+  while (true) {
+    TraceDomain body(head);
+    body.add(Predicate::LT, i, Int(100, 32, Signed));
+    body.apply(BinaryOperator::Add, i, i, Int(1, 32, Signed));
+    TraceDomain next = inv;
+    next.join_loop_with(body);
+    if (next.leq(head)) {
+      break;
+    }
+    head.widen_threshold_with(next, Int(100, 32, Signed));
+  }
+  TraceDomain exit = head;
+  exit.add(Predicate::GE, i, Int(100, 32, Signed));
+  LinearExpr e(Int(1, 32, Signed));
+  e.add(Int(3, 32, Signed), i);
+  exit.assign(j, e);
+
+  BOOST_CHECK(exit.to_interval(i) == Interval(Int(100, 32, Signed)));
+  BOOST_CHECK(exit.to_interval(j) == Interval(Int(301, 32, Signed)));
+
+  std::uint64_t i_id = trace.variable(i);
+  std::uint64_t j_id = trace.variable(j);
+  std::uint64_t n_id = trace.variable(n);
+  buffer.flush();
+
+  {
+    std::istringstream in(buffer.str());
+    Replay< IntervalDomain > r(in);
+    IntervalDomain& head_inv = r.replayer.state(head.id());
+    IntervalDomain& exit_inv = r.replayer.state(exit.id());
+    BOOST_CHECK(head_inv.to_interval(r.vars[i_id]) ==
+                Interval(Int(0, 32, Signed), Int(100, 32, Signed)));
+    BOOST_CHECK(head_inv.to_interval(r.vars[n_id]) ==
+                Interval(Int(10, 32, Unsigned), Int(20, 32, Unsigned)));
+    BOOST_CHECK(exit_inv.to_interval(r.vars[i_id]) ==
+                Interval(Int(100, 32, Signed)));
+    BOOST_CHECK(exit_inv.to_interval(r.vars[j_id]) ==
+                Interval(Int(301, 32, Signed)));
+  }
+
+  {
+    std::istringstream in(buffer.str());
+    Replay< DBMDomain > r(in);
+    DBMDomain& exit_inv = r.replayer.state(exit.id());
+    BOOST_CHECK(exit_inv.to_interval(r.vars[i_id]) ==
+                Interval(Int(100, 32, Signed)));
+    BOOST_CHECK(exit_inv.to_interval(r.vars[j_id]) ==
+                Interval(Int(301, 32, Signed)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(destroy) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x", 8, Unsigned));
+
+  std::stringstream buffer;
+  {
+    TraceWriter trace(buffer);
+    TraceDomain inv(IntervalDomain::bottom(), trace);
+    TraceDomain copy(IntervalDomain::top(), trace);
+    copy.assign(x, Int(255, 8, Unsigned));
+    copy = inv;
+    BOOST_CHECK(copy.is_bottom());
+  }
+
+  Replay< IntervalDomain > r(buffer);
+  BOOST_CHECK(r.replayer.num_states() == 0);
+  BOOST_CHECK(r.replayer.num_true_queries() == 1);
+  BOOST_CHECK(r.vars.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(invalid) {
+  std::istringstream empty("");
+  BOOST_CHECK_THROW(TraceReader reader(empty), LogicError);
+
+  std::istringstream truncated(std::string("IKOSTRC1") + '\x13' + '\x00');
+  BOOST_CHECK_THROW(Replay< IntervalDomain > r(truncated), LogicError);
+}
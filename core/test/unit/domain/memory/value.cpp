@@ -0,0 +1,460 @@
+/*******************************************************************************
+ *
+ * Tests for ValueDomain
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#define BOOST_TEST_MODULE test_memory_value_domain
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ikos/core/domain/lifetime/lifetime.hpp>
+#include <ikos/core/domain/machine_int/interval.hpp>
+#include <ikos/core/domain/memory/value.hpp>
+#include <ikos/core/domain/nullity/nullity.hpp>
+#include <ikos/core/domain/pointer/pointer.hpp>
+#include <ikos/core/domain/uninitialized/uninitialized.hpp>
+
+namespace {
+
+using ikos::core::Index;
+using ikos::core::MachineInt;
+using ikos::core::Nullity;
+using ikos::core::Signed;
+using ikos::core::Signedness;
+using ikos::core::Unsigned;
+
+/// \brief Return a new unique index
+Index fresh_index() {
+  static Index next = 0;
+  return ++next;
+}
+
+/// \brief Memory location
+struct MemoryLocation {
+  std::string name;
+  Index index = fresh_index();
+};
+
+/// \brief Integer, pointer or cell variable
+struct Variable {
+  enum Kind { IntKind, PointerKind, CellKind };
+
+  Kind kind;
+  std::string name;
+  unsigned bit_width;
+  Signedness sign;
+  Variable* offset_var;
+  MemoryLocation* base;
+  MachineInt offset;
+  MachineInt size;
+  Index index = fresh_index();
+};
+
+/// \brief Variable factory
+class VariableFactory {
+private:
+  std::vector< std::unique_ptr< Variable > > _vars;
+  std::map< std::tuple< MemoryLocation*, uint64_t, uint64_t >, Variable* >
+      _cells;
+
+public:
+  Variable* get_int(const std::string& name,
+                    unsigned bit_width,
+                    Signedness sign) {
+    return this->create(Variable{Variable::IntKind,
+                                 name,
+                                 bit_width,
+                                 sign,
+                                 nullptr,
+                                 nullptr,
+                                 MachineInt::zero(64, Unsigned),
+                                 MachineInt::zero(64, Unsigned)});
+  }
+
+  Variable* get_pointer(const std::string& name) {
+    Variable* offset = this->get_int(name + ".offset", 64, Unsigned);
+    return this->create(Variable{Variable::PointerKind,
+                                 name,
+                                 64,
+                                 Unsigned,
+                                 offset,
+                                 nullptr,
+                                 MachineInt::zero(64, Unsigned),
+                                 MachineInt::zero(64, Unsigned)});
+  }
+
+  Variable* get_cell(MemoryLocation* base,
+                     const MachineInt& offset,
+                     const MachineInt& size) {
+    auto key = std::make_tuple(base,
+                               offset.to< uint64_t >(),
+                               size.to< uint64_t >());
+    auto it = this->_cells.find(key);
+    if (it != this->_cells.end()) {
+      return it->second;
+    }
+    Variable* cell =
+        this->create(Variable{Variable::CellKind,
+                              "C{" + base->name + "," + offset.str() + "," +
+                                  size.str() + "}",
+                              size.to< unsigned >() * 8,
+                              Signed,
+                              this->get_int("C.offset", 64, Unsigned),
+                              base,
+                              offset,
+                              size});
+    this->_cells.emplace(key, cell);
+    return cell;
+  }
+
+private:
+  Variable* create(Variable var) {
+    this->_vars.emplace_back(std::make_unique< Variable >(std::move(var)));
+    return this->_vars.back().get();
+  }
+};
+
+} // end anonymous namespace
+
+namespace ikos {
+namespace core {
+
+template <>
+struct IndexableTraits< Variable* > {
+  static Index index(const Variable* v) { return v->index; }
+};
+
+template <>
+struct DumpableTraits< Variable* > {
+  static void dump(std::ostream& o, const Variable* v) { o << v->name; }
+};
+
+template <>
+struct IndexableTraits< MemoryLocation* > {
+  static Index index(const MemoryLocation* m) { return m->index; }
+};
+
+template <>
+struct DumpableTraits< MemoryLocation* > {
+  static void dump(std::ostream& o, const MemoryLocation* m) { o << m->name; }
+};
+
+namespace machine_int {
+
+template <>
+struct VariableTraits< Variable* > {
+  static unsigned bit_width(const Variable* v) { return v->bit_width; }
+
+  static Signedness sign(const Variable* v) { return v->sign; }
+};
+
+} // end namespace machine_int
+
+namespace pointer {
+
+template <>
+struct VariableTraits< Variable* > {
+  static Variable* offset_var(const Variable* v) { return v->offset_var; }
+};
+
+} // end namespace pointer
+
+namespace memory {
+
+template <>
+struct CellVariableTraits< Variable*, MemoryLocation* > {
+  static MemoryLocation* base(const Variable* v) { return v->base; }
+
+  static const MachineInt& offset(const Variable* v) { return v->offset; }
+
+  static const MachineInt& size(const Variable* v) { return v->size; }
+};
+
+template <>
+struct VariableTraits< Variable* > {
+  static bool is_cell(const Variable* v) {
+    return v->kind == Variable::CellKind;
+  }
+
+  static bool is_int(const Variable* v) { return v->kind == Variable::IntKind; }
+
+  static bool is_float(const Variable*) { return false; }
+
+  static bool is_pointer(const Variable* v) {
+    return v->kind == Variable::PointerKind;
+  }
+};
+
+template <>
+struct CellFactoryTraits< Variable*, MemoryLocation*, VariableFactory > {
+  static Variable* cell(VariableFactory& vfac,
+                        MemoryLocation* base,
+                        const MachineInt& offset,
+                        const MachineInt& size) {
+    return vfac.get_cell(base, offset, size);
+  }
+};
+
+} // end namespace memory
+
+} // end namespace core
+} // end namespace ikos
+
+namespace {
+
+using IntDomain = ikos::core::machine_int::IntervalDomain< Variable* >;
+using NullityDomain = ikos::core::nullity::NullityDomain< Variable* >;
+using PointerDomain = ikos::core::pointer::
+    PointerDomain< Variable*, MemoryLocation*, IntDomain, NullityDomain >;
+using UninitializedDomain =
+    ikos::core::uninitialized::UninitializedDomain< Variable* >;
+using LifetimeDomain = ikos::core::lifetime::LifetimeDomain< MemoryLocation* >;
+using ValueDomain = ikos::core::memory::ValueDomain< Variable*,
+                                                     MemoryLocation*,
+                                                     VariableFactory,
+                                                     IntDomain,
+                                                     NullityDomain,
+                                                     PointerDomain,
+                                                     UninitializedDomain,
+                                                     LifetimeDomain >;
+using Literal = ikos::core::Literal< Variable*, MemoryLocation* >;
+using PointsToSet = ikos::core::PointsToSet< MemoryLocation* >;
+using Interval = ikos::core::machine_int::Interval;
+
+/// \brief Set the maximum number of cells per memory location for the
+/// duration of a test
+struct MaxCells {
+  explicit MaxCells(std::size_t max_cells) {
+    ValueDomain::set_max_cells_per_location(max_cells);
+  }
+
+  ~MaxCells() { ValueDomain::set_max_cells_per_location(0); }
+};
+
+MachineInt offset(int n) {
+  return MachineInt(n, 64, Unsigned);
+}
+
+MachineInt int32(int n) {
+  return MachineInt(n, 32, Signed);
+}
+
+/// \brief Perform `*(int*)((char*)p + off) = n`
+void write_int(
+    ValueDomain& inv, VariableFactory& vfac, Variable* p, int off, int n) {
+  inv.integers().assign(p->offset_var, offset(off));
+  inv.mem_write(vfac, p, Literal::machine_int(int32(n)), offset(4));
+}
+
+/// \brief Return the value of `*(int*)((char*)p + off)`
+Interval read_int(ValueDomain inv,
+                  VariableFactory& vfac,
+                  Variable* p,
+                  int off) {
+  Variable* x = vfac.get_int("x", 32, Signed);
+  inv.integers().assign(p->offset_var, offset(off));
+  inv.mem_read(vfac, Literal::machine_int_var(x), p, offset(4));
+  return inv.integers().to_interval(x);
+}
+
+} // end anonymous namespace
+
+BOOST_AUTO_TEST_CASE(max_cells_bounds_cell_set) {
+  MaxCells max_cells(4);
+  VariableFactory vfac;
+  MemoryLocation buf{"buf"};
+  Variable* p = vfac.get_pointer("p");
+
+  ValueDomain inv;
+  inv.pointers().assign_address(p, &buf, Nullity::non_null());
+  for (int i = 0; i < 8; i++) {
+    write_int(inv, vfac, p, 4 * i, i + 1);
+    BOOST_CHECK(inv.num_cells() <= 4);
+  }
+
+  // The cells were folded into a summary cell, updated weakly
+  BOOST_CHECK(inv.num_cells() == 1);
+  for (int i = 0; i < 8; i++) {
+    BOOST_CHECK(read_int(inv, vfac, p, 4 * i) == Interval(int32(1), int32(8)));
+  }
+  // Bytes never written are not covered by the summary cell
+  BOOST_CHECK(read_int(inv, vfac, p, 32) == Interval::top(32, Signed));
+  BOOST_CHECK(read_int(inv, vfac, p, 2) == Interval::top(32, Signed));
+
+  // Reads are bounded as well
+  for (int i = 0; i < 8; i++) {
+    Variable* x = vfac.get_int("x", 32, Signed);
+    inv.integers().assign(p->offset_var, offset(4 * i));
+    inv.mem_read(vfac, Literal::machine_int_var(x), p, offset(4));
+    BOOST_CHECK(inv.num_cells() <= 4);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(summary_cells_by_phase) {
+  MaxCells max_cells(4);
+  VariableFactory vfac;
+  MemoryLocation buf{"buf"};
+  Variable* p = vfac.get_pointer("p");
+
+  ValueDomain inv;
+  inv.pointers().assign_address(p, &buf, Nullity::non_null());
+  for (int i = 0; i < 8; i++) {
+    write_int(inv, vfac, p, 4 * i, i + 1);
+  }
+
+  // A misaligned write gets its own summary cell, updated strongly
+  write_int(inv, vfac, p, 2, 42);
+  BOOST_CHECK(inv.num_cells() == 2);
+  BOOST_CHECK(read_int(inv, vfac, p, 2) == Interval(int32(42)));
+  // The overwritten elements are not covered anymore
+  BOOST_CHECK(read_int(inv, vfac, p, 0) == Interval::top(32, Signed));
+  BOOST_CHECK(read_int(inv, vfac, p, 4) == Interval::top(32, Signed));
+  BOOST_CHECK(read_int(inv, vfac, p, 8) == Interval(int32(1), int32(8)));
+
+  // Overwriting all the bytes of a summary cell is a strong update
+  write_int(inv, vfac, p, 2, 7);
+  BOOST_CHECK(read_int(inv, vfac, p, 2) == Interval(int32(7)));
+}
+
+BOOST_AUTO_TEST_CASE(summary_cells_join) {
+  MaxCells max_cells(4);
+  VariableFactory vfac;
+  MemoryLocation buf{"buf"};
+  Variable* p = vfac.get_pointer("p");
+
+  ValueDomain smashed;
+  smashed.pointers().assign_address(p, &buf, Nullity::non_null());
+  for (int i = 0; i < 8; i++) {
+    write_int(smashed, vfac, p, 4 * i, i + 1);
+  }
+
+  ValueDomain precise;
+  precise.pointers().assign_address(p, &buf, Nullity::non_null());
+  for (int i = 0; i < 4; i++) {
+    write_int(precise, vfac, p, 4 * i, 0);
+  }
+
+  // The precise side is smashed before the join
+  ValueDomain inv = smashed.join(precise);
+  BOOST_CHECK(inv.num_cells() == 1);
+  BOOST_CHECK(read_int(inv, vfac, p, 0) == Interval(int32(0), int32(8)));
+  BOOST_CHECK(read_int(inv, vfac, p, 12) == Interval(int32(0), int32(8)));
+  BOOST_CHECK(read_int(inv, vfac, p, 16) == Interval::top(32, Signed));
+
+  BOOST_CHECK(smashed.leq(inv));
+  BOOST_CHECK(precise.leq(inv));
+  BOOST_CHECK(!inv.leq(precise));
+  BOOST_CHECK(!inv.leq(smashed));
+  BOOST_CHECK(inv.join(smashed).equals(inv));
+}
+
+BOOST_AUTO_TEST_CASE(smashing_keeps_pointer_set) {
+  MaxCells max_cells(4);
+  VariableFactory vfac;
+  MemoryLocation buf{"buf"};
+  MemoryLocation obj{"obj"};
+  Variable* p = vfac.get_pointer("p");
+  Variable* q = vfac.get_pointer("q");
+  Variable* r = vfac.get_pointer("r");
+
+  ValueDomain inv;
+  inv.pointers().assign_address(p, &buf, Nullity::non_null());
+  inv.pointers().assign_address(q, &obj, Nullity::non_null());
+
+  // buf[0] = q
+  inv.mem_write(vfac, p, Literal::pointer_var(q), offset(8));
+  for (int i = 2; i < 10; i++) {
+    write_int(inv, vfac, p, 4 * i, i);
+  }
+  BOOST_CHECK(inv.num_cells() <= 4);
+
+  // r = buf[0], the cell was smashed but buf still points to obj
+  inv.integers().assign(p->offset_var, offset(0));
+  inv.mem_read(vfac, Literal::pointer_var(r), p, offset(8));
+  BOOST_CHECK(!inv.is_bottom());
+  BOOST_CHECK(inv.pointers().points_to(r) == PointsToSet{&obj});
+}
+
+BOOST_AUTO_TEST_CASE(mem_copy_stops_at_max_cells) {
+  VariableFactory vfac;
+  MemoryLocation src_buf{"src"};
+  MemoryLocation dest_buf{"dest"};
+  Variable* src = vfac.get_pointer("src");
+  Variable* dest = vfac.get_pointer("dest");
+
+  ValueDomain inv;
+  inv.pointers().assign_address(src, &src_buf, Nullity::non_null());
+  inv.pointers().assign_address(dest, &dest_buf, Nullity::non_null());
+  for (int i = 0; i < 8; i++) {
+    write_int(inv, vfac, src, 4 * i, i + 1);
+  }
+  BOOST_CHECK(inv.num_cells() == 8);
+
+  MaxCells max_cells(4);
+  inv.integers().assign(src->offset_var, offset(0));
+  inv.integers().assign(dest->offset_var, offset(0));
+  inv.mem_copy(vfac, dest, src, Literal::machine_int(offset(32)));
+  BOOST_CHECK(!inv.is_bottom());
+  BOOST_CHECK(inv.num_cells() <= 8 + 4);
+
+  // Copied cells keep their value, the others are unknown
+  int copied = 0;
+  for (int i = 0; i < 8; i++) {
+    Interval value = read_int(inv, vfac, dest, 4 * i);
+    if (value == Interval(int32(i + 1))) {
+      copied++;
+    } else {
+      BOOST_CHECK(value == Interval::top(32, Signed));
+    }
+  }
+  BOOST_CHECK(copied == 4);
+
+  // The source is unchanged
+  for (int i = 0; i < 8; i++) {
+    BOOST_CHECK(read_int(inv, vfac, src, 4 * i) == Interval(int32(i + 1)));
+  }
+}
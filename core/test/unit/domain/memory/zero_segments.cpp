@@ -0,0 +1,132 @@
+/*******************************************************************************
+ *
+ * Tests for ZeroSegments
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#define BOOST_TEST_MODULE test_zero_segments
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/domain/memory/value/zero_segments.hpp>
+
+using Int = ikos::core::MachineInt;
+using Interval = ikos::core::machine_int::Interval;
+using ZeroSegments = ikos::core::memory::ZeroSegments;
+using ikos::core::Unsigned;
+
+static Interval range(int lb, int ub) {
+  return Interval(Int(lb, 64, Unsigned), Int(ub, 64, Unsigned));
+}
+
+BOOST_AUTO_TEST_CASE(is_top_and_bottom) {
+  BOOST_CHECK(ZeroSegments::top().is_top());
+  BOOST_CHECK(!ZeroSegments::bottom().is_bottom());
+
+  ZeroSegments zeros(range(0, 4095));
+  BOOST_CHECK(!zeros.is_top());
+
+  zeros.set_to_top();
+  BOOST_CHECK(zeros.is_top());
+}
+
+BOOST_AUTO_TEST_CASE(add_and_contains) {
+  ZeroSegments zeros(range(0, 4095));
+  BOOST_CHECK(zeros.contains(range(128, 135)));
+  BOOST_CHECK(zeros.contains(range(4088, 4095)));
+  BOOST_CHECK(!zeros.contains(range(4092, 4099)));
+
+  // Adjacent segments are merged
+  zeros.add(range(4096, 8191));
+  BOOST_CHECK(zeros.contains(range(4092, 4099)));
+  BOOST_CHECK(zeros.equals(ZeroSegments(range(0, 8191))));
+
+  zeros.add(range(9000, 9007));
+  BOOST_CHECK(!zeros.contains(range(8188, 9003)));
+  zeros.add(range(8192, 8999));
+  BOOST_CHECK(zeros.equals(ZeroSegments(range(0, 9007))));
+}
+
+BOOST_AUTO_TEST_CASE(remove_range) {
+  ZeroSegments zeros(range(0, 4095));
+
+  // A non-zero write splits the segment
+  zeros.remove(range(64, 71));
+  BOOST_CHECK(zeros.contains(range(0, 63)));
+  BOOST_CHECK(!zeros.contains(range(64, 64)));
+  BOOST_CHECK(!zeros.contains(range(60, 67)));
+  BOOST_CHECK(zeros.contains(range(72, 4095)));
+
+  zeros.remove(range(0, 63));
+  BOOST_CHECK(zeros.equals(ZeroSegments(range(72, 4095))));
+
+  zeros.remove(range(0, 4095));
+  BOOST_CHECK(zeros.is_top());
+}
+
+BOOST_AUTO_TEST_CASE(leq) {
+  ZeroSegments zeros(range(0, 4095));
+  ZeroSegments part(range(8, 15));
+  BOOST_CHECK(zeros.leq(part));
+  BOOST_CHECK(!part.leq(zeros));
+  BOOST_CHECK(zeros.leq(ZeroSegments::top()));
+  BOOST_CHECK(!ZeroSegments::top().leq(zeros));
+}
+
+BOOST_AUTO_TEST_CASE(join) {
+  ZeroSegments lhs(range(0, 99));
+  lhs.add(range(200, 299));
+  ZeroSegments rhs(range(50, 249));
+
+  ZeroSegments join = lhs.join(rhs);
+  ZeroSegments expected(range(50, 99));
+  expected.add(range(200, 249));
+  BOOST_CHECK(join.equals(expected));
+
+  BOOST_CHECK(lhs.join(ZeroSegments::top()).is_top());
+}
+
+BOOST_AUTO_TEST_CASE(widening) {
+  ZeroSegments lhs(range(0, 99));
+  lhs.add(range(200, 299));
+  ZeroSegments rhs(range(0, 99));
+  rhs.add(range(200, 249));
+
+  BOOST_CHECK(lhs.widening(rhs).equals(ZeroSegments(range(0, 99))));
+}
@@ -521,6 +521,15 @@ BOOST_AUTO_TEST_CASE(assign) {
   inv1.set(y, Interval(Bound(1), Bound(2)));
   inv1.assign(z, 2 * VariableExpr(x) - 3 * VariableExpr(y) + 1);
   BOOST_CHECK(inv1.to_interval(z) == Interval(Bound(-7), Bound(0)));
+
+  // parallel assignment
+  using LinearExpression = ikos::core::LinearExpression< ZNumber, Variable >;
+  inv1.set_to_top();
+  inv1.set(x, Interval(Bound(-1), Bound(1)));
+  inv1.set(y, Interval(Bound(1), Bound(2)));
+  inv1.assign({{x, LinearExpression(y)}, {y, VariableExpr(x) + 10}});
+  BOOST_CHECK(inv1.to_interval(x) == Interval(Bound(1), Bound(2)));
+  BOOST_CHECK(inv1.to_interval(y) == Interval(Bound(9), Bound(11)));
 }
 
 BOOST_AUTO_TEST_CASE(apply) {
@@ -833,3 +842,27 @@ BOOST_AUTO_TEST_CASE(to_interval_congruence) {
                                          3 * VariableExpr(y) + 1) ==
               IntervalCongruence(Interval(Bound(-9), Bound(-4))));
 }
+
+BOOST_AUTO_TEST_CASE(limits) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+
+  ikos::core::numeric::apron::limits() = {1, 0};
+
+  ApronDomain inv1;
+  inv1.set(x, Interval(Bound(0), Bound(1)));
+  inv1.add(VariableExpr(y) <= 2 * VariableExpr(x));
+
+  ApronDomain inv2;
+  inv2.set(x, Interval(Bound(2), Bound(3)));
+  inv2.assign(y, x);
+
+  // Approximations are sound
+  ApronDomain inv3 = inv1.join(inv2);
+  BOOST_CHECK(Interval(Bound(0), Bound(3)).leq(inv3.to_interval(x)));
+  BOOST_CHECK(inv1.leq(inv3));
+  BOOST_CHECK(inv2.leq(inv3));
+
+  ikos::core::numeric::apron::limits() = {0, 0};
+}
@@ -0,0 +1,225 @@
+/*******************************************************************************
+ *
+ * Tests for BoundedPowersetDomain
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#define BOOST_TEST_MODULE test_bounded_powerset_domain
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/domain/numeric/bounded_powerset.hpp>
+#include <ikos/core/domain/numeric/interval.hpp>
+#include <ikos/core/example/variable_factory.hpp>
+#include <ikos/core/number/z_number.hpp>
+
+using ZNumber = ikos::core::ZNumber;
+using VariableFactory = ikos::core::example::VariableFactory;
+using Variable = ikos::core::example::VariableFactory::VariableRef;
+using VariableExpr = ikos::core::VariableExpression< ZNumber, Variable >;
+using Bound = ikos::core::ZBound;
+using Interval = ikos::core::numeric::ZInterval;
+using IntervalDomain = ikos::core::numeric::IntervalDomain< ZNumber, Variable >;
+using PowersetDomain = ikos::core::numeric::
+    BoundedPowersetDomain< ZNumber, Variable, IntervalDomain, 3 >;
+
+BOOST_AUTO_TEST_CASE(is_top_and_bottom) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+
+  BOOST_CHECK(PowersetDomain::top().is_top());
+  BOOST_CHECK(!PowersetDomain::top().is_bottom());
+
+  BOOST_CHECK(!PowersetDomain::bottom().is_top());
+  BOOST_CHECK(PowersetDomain::bottom().is_bottom());
+
+  PowersetDomain inv;
+  BOOST_CHECK(inv.is_top());
+  BOOST_CHECK(!inv.is_bottom());
+
+  inv.assign(x, 1);
+  BOOST_CHECK(!inv.is_top());
+  BOOST_CHECK(!inv.is_bottom());
+
+  inv.set(x, Interval::bottom());
+  BOOST_CHECK(!inv.is_top());
+  BOOST_CHECK(inv.is_bottom());
+}
+
+BOOST_AUTO_TEST_CASE(join_keeps_disjuncts) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+
+  PowersetDomain inv = PowersetDomain::bottom();
+  for (int i = 0; i < 3; i++) {
+    PowersetDomain tmp;
+    tmp.assign(x, i * 10);
+    tmp.assign(y, i);
+    inv.join_with(tmp);
+  }
+  BOOST_CHECK(inv.num_disjuncts() == 3);
+  BOOST_CHECK(inv.to_interval(x) == Interval(Bound(0), Bound(20)));
+
+  // Path-sensitive: the constraint only keeps one disjunct
+  PowersetDomain inv2 = inv;
+  inv2.add(VariableExpr(x) == 10);
+  BOOST_CHECK(inv2.num_disjuncts() == 1);
+  BOOST_CHECK(inv2.to_interval(y) == Interval(Bound(1)));
+
+  inv2 = inv;
+  inv2.add(VariableExpr(x) >= 5);
+  BOOST_CHECK(inv2.num_disjuncts() == 2);
+  BOOST_CHECK(inv2.to_interval(y) == Interval(Bound(1), Bound(2)));
+
+  // Disjuncts included in another one are not added
+  PowersetDomain tmp;
+  tmp.assign(x, 10);
+  tmp.assign(y, 1);
+  inv.join_with(tmp);
+  BOOST_CHECK(inv.num_disjuncts() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(join_merges_closest) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+
+  PowersetDomain inv = PowersetDomain::bottom();
+
+  PowersetDomain a;
+  a.assign(x, 0);
+  a.assign(y, 0);
+  inv.join_with(a);
+
+  PowersetDomain b;
+  b.assign(x, 100);
+  b.assign(y, 50);
+  inv.join_with(b);
+
+  PowersetDomain c;
+  c.assign(x, 1000);
+  c.assign(y, 5);
+  inv.join_with(c);
+
+  // d only differs from c on y
+  PowersetDomain d;
+  d.assign(x, 1000);
+  d.assign(y, 6);
+  inv.join_with(d);
+
+  BOOST_CHECK(inv.num_disjuncts() == 3);
+  BOOST_CHECK(inv.to_interval(x) == Interval(Bound(0), Bound(1000)));
+
+  PowersetDomain inv2 = inv;
+  inv2.add(VariableExpr(x) == 1000);
+  BOOST_CHECK(inv2.num_disjuncts() == 1);
+  BOOST_CHECK(inv2.to_interval(y) == Interval(Bound(5), Bound(6)));
+
+  inv2 = inv;
+  inv2.add(VariableExpr(x) <= 100);
+  BOOST_CHECK(inv2.num_disjuncts() == 2);
+  BOOST_CHECK(inv2.to_interval(y) == Interval(Bound(0), Bound(50)));
+}
+
+BOOST_AUTO_TEST_CASE(leq) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+
+  BOOST_CHECK(PowersetDomain::bottom().leq(PowersetDomain::top()));
+  BOOST_CHECK(PowersetDomain::bottom().leq(PowersetDomain::bottom()));
+  BOOST_CHECK(!PowersetDomain::top().leq(PowersetDomain::bottom()));
+  BOOST_CHECK(PowersetDomain::top().leq(PowersetDomain::top()));
+
+  PowersetDomain a;
+  a.assign(x, 0);
+  PowersetDomain b;
+  b.assign(x, 10);
+  PowersetDomain c;
+  c.set(x, Interval(Bound(0), Bound(10)));
+
+  PowersetDomain ab = a.join(b);
+  BOOST_CHECK(ab.num_disjuncts() == 2);
+  BOOST_CHECK(a.leq(ab));
+  BOOST_CHECK(b.leq(ab));
+  BOOST_CHECK(ab.leq(c));
+  BOOST_CHECK(!c.leq(ab));
+  BOOST_CHECK(ab.equals(b.join(a)));
+  BOOST_CHECK(c.join(ab).equals(c));
+}
+
+BOOST_AUTO_TEST_CASE(widening) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+
+  PowersetDomain a;
+  a.assign(x, 0);
+  PowersetDomain b;
+  b.assign(x, 10);
+  PowersetDomain ab = a.join(b);
+
+  PowersetDomain w = a.widening(ab);
+  BOOST_CHECK(w.num_disjuncts() == 1);
+  BOOST_CHECK(w.to_interval(x) == Interval(Bound(0), Bound::plus_infinity()));
+}
+
+BOOST_AUTO_TEST_CASE(meet) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+
+  PowersetDomain a;
+  a.set(x, Interval(Bound(0), Bound(5)));
+  PowersetDomain b;
+  b.set(x, Interval(Bound(10), Bound(15)));
+  PowersetDomain c;
+  c.set(x, Interval(Bound(4), Bound(11)));
+
+  PowersetDomain m = a.join(b).meet(c);
+  BOOST_CHECK(m.num_disjuncts() == 2);
+  BOOST_CHECK(m.to_interval(x) == Interval(Bound(4), Bound(11)));
+
+  PowersetDomain m2 = m;
+  m2.add(VariableExpr(x) != 10);
+  m2.add(VariableExpr(x) != 11);
+  BOOST_CHECK(m2.num_disjuncts() == 1);
+  BOOST_CHECK(m2.to_interval(x) == Interval(Bound(4), Bound(5)));
+
+  BOOST_CHECK(a.meet(b).is_bottom());
+}
@@ -846,3 +846,161 @@ BOOST_AUTO_TEST_CASE(to_interval_congruence) {
                                          3 * VariableExpr(y) + 1) ==
               IntervalCongruence(Interval(Bound(-9), Bound(-4))));
 }
+
+BOOST_AUTO_TEST_CASE(copy_on_write) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+
+  DBM inv1;
+  inv1.set(x, Interval(Bound(0), Bound(10)));
+  inv1.add(VariableExpr(y) - VariableExpr(x) <= 1);
+
+  // Copies share the matrix
+  DBM inv2(inv1);
+  BOOST_CHECK(inv2.equals(inv1));
+  BOOST_CHECK(inv2.leq(inv1));
+  inv2.join_with(inv1);
+  BOOST_CHECK(inv2.equals(inv1));
+  inv2.widen_with(inv1);
+  BOOST_CHECK(inv2.equals(inv1));
+
+  // Modifying a copy does not affect the original
+  inv2.add(VariableExpr(x) <= 5);
+  BOOST_CHECK(inv2.to_interval(x) == Interval(Bound(0), Bound(5)));
+  BOOST_CHECK(inv1.to_interval(x) == Interval(Bound(0), Bound(10)));
+  BOOST_CHECK(inv2.leq(inv1));
+  BOOST_CHECK(!inv1.leq(inv2));
+
+  // Adding a variable to a copy does not affect the original
+  DBM inv3(inv1);
+  Variable z(vfac.get("z"));
+  inv3.set(z, Interval(3));
+  BOOST_CHECK(inv3.to_interval(z) == Interval(3));
+  BOOST_CHECK(inv1.to_interval(z) == Interval::top());
+  BOOST_CHECK(inv3.to_interval(x) == Interval(Bound(0), Bound(10)));
+  BOOST_CHECK(inv3.leq(inv1));
+}
+
+BOOST_AUTO_TEST_CASE(large_bounds) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+
+  // Bounds that do not fit in 64-bit integers
+  ZNumber large = ZNumber(1) << 62;
+  DBM inv;
+  inv.set(x, Interval(Bound(0), Bound(large)));
+  inv.add(VariableExpr(y) - VariableExpr(x) <= large);
+  inv.add(VariableExpr(z) - VariableExpr(y) <= large);
+  inv.normalize();
+  BOOST_CHECK(inv.to_interval(y) ==
+              Interval(Bound::minus_infinity(), Bound(2 * large)));
+  BOOST_CHECK(inv.to_interval(z) ==
+              Interval(Bound::minus_infinity(), Bound(3 * large)));
+
+  inv.add(VariableExpr(x) - VariableExpr(z) <= -3 * large - 1);
+  BOOST_CHECK(inv.is_bottom());
+}
+
+BOOST_AUTO_TEST_CASE(incremental_closure) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+  Variable w(vfac.get("w"));
+
+  // Each constraint is added to a normalized matrix
+  DBM inv;
+  inv.set(x, Interval(Bound(0), Bound(10)));
+  inv.normalize();
+  inv.add(VariableExpr(y) - VariableExpr(x) <= 1);
+  inv.normalize();
+  BOOST_CHECK(inv.to_interval(y) ==
+              Interval(Bound::minus_infinity(), Bound(11)));
+  inv.add(VariableExpr(z) - VariableExpr(y) <= 2);
+  inv.normalize();
+  BOOST_CHECK(inv.to_interval(z) ==
+              Interval(Bound::minus_infinity(), Bound(13)));
+  inv.add(VariableExpr(x) - VariableExpr(w) <= 0);
+  inv.normalize();
+  BOOST_CHECK(inv.to_interval(w) ==
+              Interval(Bound(0), Bound::plus_infinity()));
+
+  // z - w <= 3 is derived through a path of several edges
+  DBM expected;
+  expected.set(x, Interval(Bound(0), Bound(10)));
+  expected.add(VariableExpr(y) - VariableExpr(x) <= 1);
+  expected.add(VariableExpr(z) - VariableExpr(y) <= 2);
+  expected.add(VariableExpr(x) - VariableExpr(w) <= 0);
+  expected.add(VariableExpr(z) - VariableExpr(w) <= 3);
+  BOOST_CHECK(inv.equals(expected));
+
+  // Reassigning a variable keeps the other relations
+  inv.assign(y, VariableExpr(w) + 1);
+  inv.normalize();
+  BOOST_CHECK(inv.to_interval(y) ==
+              Interval(Bound(1), Bound::plus_infinity()));
+  BOOST_CHECK(inv.to_interval(z) ==
+              Interval(Bound::minus_infinity(), Bound(13)));
+  inv.add(VariableExpr(z) - VariableExpr(y) <= -3);
+  inv.normalize();
+  BOOST_CHECK(inv.to_interval(z) ==
+              Interval(Bound::minus_infinity(), Bound(13)));
+  inv.assign(x, 5);
+  inv.normalize();
+  BOOST_CHECK(inv.to_interval(z) ==
+              Interval(Bound::minus_infinity(), Bound(13)));
+
+  // Cycle detected incrementally
+  inv.add(VariableExpr(w) - VariableExpr(z) <= 1);
+  BOOST_CHECK(inv.is_bottom());
+}
+
+BOOST_AUTO_TEST_CASE(forget_vars_and_project) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+  Variable w(vfac.get("w"));
+
+  DBM inv;
+  inv.set(x, Interval(Bound(0), Bound(10)));
+  inv.add(VariableExpr(y) - VariableExpr(x) <= 1);
+  inv.add(VariableExpr(z) - VariableExpr(y) <= 2);
+  inv.add(VariableExpr(w) - VariableExpr(z) <= 3);
+
+  // Relations through forgotten variables are kept
+  DBM inv2 = inv;
+  inv2.forget_vars({y, z});
+  DBM expected;
+  expected.set(x, Interval(Bound(0), Bound(10)));
+  expected.add(VariableExpr(w) - VariableExpr(x) <= 6);
+  BOOST_CHECK(inv2.equals(expected));
+  BOOST_CHECK(inv2.to_interval(w) ==
+              Interval(Bound::minus_infinity(), Bound(16)));
+
+  DBM inv3 = inv;
+  inv3.project({x, w});
+  BOOST_CHECK(inv3.equals(expected));
+
+  // Same result as forgetting the variables one by one
+  DBM inv4 = inv;
+  inv4.forget(y);
+  inv4.forget(z);
+  BOOST_CHECK(inv4.equals(inv2));
+
+  // Variables can be added after a projection
+  inv3.assign(y, VariableExpr(w) + 1);
+  inv3.normalize();
+  BOOST_CHECK(inv3.to_interval(y) ==
+              Interval(Bound::minus_infinity(), Bound(17)));
+
+  inv3.project({});
+  BOOST_CHECK(inv3.is_top());
+
+  DBM bottom = DBM::bottom();
+  bottom.forget_vars({x});
+  BOOST_CHECK(bottom.is_bottom());
+}
@@ -627,3 +627,42 @@ BOOST_AUTO_TEST_CASE(gauge_interval_congruence_domain_apply_var_var_num) {
                           w,
                           ZInterval(ZBound::minus_infinity(), ZBound(16)));
 }
+
+BOOST_AUTO_TEST_CASE(gauge_interval_congruence_domain_lazy_reduction) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+  Variable w(vfac.get("w"));
+
+  auto& stats = GaugeIntervalCongruenceDomain::reduction_statistics();
+
+  GaugeIntervalCongruenceDomain d;
+  d.set(x, ZInterval(ZBound(1), ZBound(10)));
+
+  // y is overwritten before being read
+  std::size_t avoided = stats.avoided;
+  d.apply(BinaryOperator::Add, y, x, ZNumber(1));
+  d.assign(y, 0);
+  BOOST_CHECK(stats.avoided == avoided + 1);
+  test_domain_to_interval(d, y, ZInterval(0));
+
+  // z is reduced before being read
+  std::size_t performed = stats.performed;
+  d.apply(BinaryOperator::Mul, z, x, ZNumber(2));
+  BOOST_CHECK(stats.performed == performed);
+  d.apply(BinaryOperator::Add, w, z, ZNumber(1));
+  BOOST_CHECK(stats.performed == performed + 1);
+  test_domain_to_interval(d, z, ZInterval(ZBound(2), ZBound(20)));
+  test_domain_to_interval(d, w, ZInterval(ZBound(3), ZBound(21)));
+  BOOST_CHECK(d.to_congruence(w) ==
+              ikos::core::numeric::ZCongruence(ZNumber(2), ZNumber(1)));
+
+  // Lattice operations perform the pending reductions
+  GaugeIntervalCongruenceDomain e = d;
+  e.assign(y, 1);
+  BOOST_CHECK(!e.leq(d));
+  BOOST_CHECK(stats.performed == performed + 3);
+  BOOST_CHECK(d.leq(d.join(e)));
+  BOOST_CHECK(stats.performed == performed + 3);
+}
@@ -0,0 +1,230 @@
+/*******************************************************************************
+ *
+ * Tests for the closure of difference bound matrices using fixed-width weights
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#define BOOST_TEST_MODULE test_int64_closure
+#define BOOST_TEST_DYN_LINK
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/domain/numeric/int64_closure.hpp>
+#include <ikos/core/number/z_number.hpp>
+
+using ZNumber = ikos::core::ZNumber;
+using Bound = ikos::core::ZBound;
+using Matrix = std::vector< Bound >;
+
+namespace int64_closure = ikos::core::numeric::int64_closure;
+
+/// \brief Reference implementation of the Floyd-Warshall algorithm
+static void floyd_warshall(Matrix& m, std::size_t n) {
+  for (std::size_t k = 0; k < n; k++) {
+    for (std::size_t i = 0; i < n; i++) {
+      for (std::size_t j = 0; j < n; j++) {
+        m[n * i + j] = min(m[n * i + j], m[n * i + k] + m[n * k + j]);
+      }
+    }
+  }
+}
+
+/// \brief Reference implementation of the octagon strong closure
+static void strong_closure(Matrix& m, std::size_t n) {
+  const std::size_t dim = 2 * n;
+  auto at = [&m](std::size_t i, std::size_t j) -> Bound& {
+    return m[int64_closure::octagon_index(i, j)];
+  };
+
+  for (std::size_t k = 0; k < n; k++) {
+    for (std::size_t i = 0; i < dim; i++) {
+      for (std::size_t j = 0; j <= (i | 1); j++) {
+        at(i, j) = min(at(i, j),
+                       min(at(i, 2 * k) + at(2 * k, j),
+                           min(at(i, 2 * k + 1) + at(2 * k + 1, j),
+                               min(at(i, 2 * k) + at(2 * k, 2 * k + 1) +
+                                       at(2 * k + 1, j),
+                                   at(i, 2 * k + 1) + at(2 * k + 1, 2 * k) +
+                                       at(2 * k, j)))));
+      }
+    }
+    for (std::size_t i = 0; i < dim; i++) {
+      for (std::size_t j = 0; j <= (i | 1); j++) {
+        at(i, j) = min(at(i, j), (at(i, i ^ 1) + at(j ^ 1, j)) / Bound(2));
+      }
+    }
+  }
+}
+
+/// \brief Generate a random matrix of the given size
+static Matrix random_matrix(std::mt19937& gen, std::size_t size) {
+  std::uniform_int_distribution< int > weight(-5, 20);
+  std::uniform_int_distribution< int > infinite(0, 2);
+  Matrix m;
+  m.reserve(size);
+  for (std::size_t i = 0; i < size; i++) {
+    if (infinite(gen) == 0) {
+      m.push_back(Bound::plus_infinity());
+    } else {
+      m.push_back(Bound(weight(gen)));
+    }
+  }
+  return m;
+}
+
+BOOST_AUTO_TEST_CASE(dbm_closure) {
+  std::mt19937 gen(0);
+
+  for (std::size_t n = 1; n <= 8; n++) {
+    for (int iter = 0; iter < 50; iter++) {
+      Matrix m = random_matrix(gen, n * n);
+      for (std::size_t i = 0; i < n; i++) {
+        m[n * i + i] = Bound(0);
+      }
+
+      Matrix expected = m;
+      floyd_warshall(expected, n);
+
+      BOOST_CHECK(int64_closure::dbm_closure(m, n));
+      BOOST_CHECK(m == expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(dbm_closure_large) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution< int > potential(-1000, 1000);
+
+  // Large sizes exercise the vectorized loops. Weights are shifted by a
+  // potential, so that the matrix has negative weights but no negative cycle.
+  for (std::size_t n : {16, 33, 64}) {
+    for (int iter = 0; iter < 10; iter++) {
+      Matrix m = random_matrix(gen, n * n);
+      std::vector< int > p(n);
+      for (std::size_t i = 0; i < n; i++) {
+        p[i] = potential(gen);
+      }
+      for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < n; j++) {
+          Bound& w = m[n * i + j];
+          if (i == j) {
+            w = Bound(0);
+          } else if (w.is_finite()) {
+            w = Bound(abs(*w.number()) + ZNumber(p[j] - p[i]));
+          }
+        }
+      }
+
+      Matrix expected = m;
+      floyd_warshall(expected, n);
+
+      BOOST_CHECK(int64_closure::dbm_closure(m, n));
+      BOOST_CHECK(m == expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(octagon_closure) {
+  std::mt19937 gen(0);
+
+  for (std::size_t n = 1; n <= 4; n++) {
+    const std::vector< unsigned char > normalized(n, 0);
+
+    for (int iter = 0; iter < 50; iter++) {
+      Matrix m = random_matrix(gen, int64_closure::octagon_size(n));
+
+      Matrix expected = m;
+      strong_closure(expected, n);
+
+      BOOST_CHECK(int64_closure::octagon_closure(m, n, normalized));
+      BOOST_CHECK(m == expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(octagon_index) {
+  // Every element of the lower half has its own position
+  for (std::size_t n = 1; n <= 4; n++) {
+    std::vector< unsigned char > used(int64_closure::octagon_size(n), 0);
+    for (std::size_t i = 0; i < 2 * n; i++) {
+      for (std::size_t j = 0; j <= (i | 1); j++) {
+        std::size_t pos = int64_closure::octagon_index(i, j);
+        BOOST_REQUIRE(pos < used.size());
+        BOOST_CHECK(!used[pos]);
+        used[pos] = 1;
+      }
+    }
+  }
+
+  // Coherent elements share their position, except on the diagonal
+  for (std::size_t i = 0; i < 8; i++) {
+    for (std::size_t j = 0; j < 8; j++) {
+      BOOST_CHECK(i == j || int64_closure::octagon_index(i, j) ==
+                                int64_closure::octagon_index(j ^ 1, i ^ 1));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(overflow) {
+  const Bound large(ZNumber(1) << 62);
+  const std::vector< unsigned char > normalized(1, 0);
+
+  // Weights that do not fit are rejected
+  Matrix m = {Bound(0), large, Bound(0), Bound(0)};
+  Matrix copy = m;
+  BOOST_CHECK(!int64_closure::dbm_closure(m, 2));
+  BOOST_CHECK(m == copy);
+  BOOST_CHECK(!int64_closure::octagon_closure(m, 1, normalized));
+  BOOST_CHECK(m == copy);
+
+  // Weights leaving the finite range during the closure are rejected
+  const Bound max(ZNumber(int64_closure::MaxWeight));
+  const Bound inf = Bound::plus_infinity();
+  m = {Bound(0), max, inf, inf, Bound(0), max, inf, inf, Bound(0)};
+  copy = m;
+  BOOST_CHECK(!int64_closure::dbm_closure(m, 3));
+  BOOST_CHECK(m == copy);
+
+  // Minus infinity is rejected
+  m = {Bound(0), Bound::minus_infinity(), Bound(0), Bound(0)};
+  BOOST_CHECK(!int64_closure::dbm_closure(m, 2));
+}
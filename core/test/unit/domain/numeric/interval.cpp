@@ -534,6 +534,22 @@ BOOST_AUTO_TEST_CASE(add) {
 
   inv.add(VariableExpr(x) >= VariableExpr(z));
   BOOST_CHECK(inv.is_bottom());
+
+  // Refinements are propagated through a chain of constraints
+  using LinearConstraintSystem =
+      ikos::core::LinearConstraintSystem< ZNumber, Variable >;
+  LinearConstraintSystem csts;
+  csts.add(VariableExpr(w) == VariableExpr(z) + 1);
+  csts.add(VariableExpr(z) == VariableExpr(y) + 1);
+  csts.add(VariableExpr(y) == VariableExpr(x) + 1);
+  csts.add(VariableExpr(x) >= 0);
+  csts.add(VariableExpr(x) <= 2);
+  inv.set_to_top();
+  inv.add(csts);
+  BOOST_CHECK(inv.to_interval(x) == Interval(Bound(0), Bound(2)));
+  BOOST_CHECK(inv.to_interval(y) == Interval(Bound(1), Bound(3)));
+  BOOST_CHECK(inv.to_interval(z) == Interval(Bound(2), Bound(4)));
+  BOOST_CHECK(inv.to_interval(w) == Interval(Bound(3), Bound(5)));
 }
 
 BOOST_AUTO_TEST_CASE(set) {
@@ -323,3 +323,80 @@ BOOST_AUTO_TEST_CASE(test_9) {
 
   // TODO(marthaud): Add checks
 }
+
+BOOST_AUTO_TEST_CASE(forget_vars_and_project) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+
+  Octagon inv = Octagon::top();
+  inv.assign(x, ZNumber(1));
+  inv.add(VariableExpr(y) <= VariableExpr(x) + 2);
+  inv.add(VariableExpr(z) >= VariableExpr(y));
+  inv.add(VariableExpr(z) <= ZNumber(8));
+
+  Octagon inv2 = inv;
+  inv2.forget_vars({y});
+  BOOST_CHECK(inv2.to_interval(x) == ZInterval(ZBound(1), ZBound(1)));
+  BOOST_CHECK(inv2.to_interval(y) == ZInterval::top());
+  BOOST_CHECK(inv2.to_interval(z) ==
+              ZInterval(ZBound::minus_infinity(), ZBound(8)));
+
+  Octagon inv3 = inv;
+  inv3.project({x, z});
+  BOOST_CHECK(inv3.to_interval(x) == ZInterval(ZBound(1), ZBound(1)));
+  BOOST_CHECK(inv3.to_interval(y) == ZInterval::top());
+  BOOST_CHECK(inv3.to_interval(z) ==
+              ZInterval(ZBound::minus_infinity(), ZBound(8)));
+
+  inv3.project({});
+  BOOST_CHECK(inv3.is_top());
+}
+
+BOOST_AUTO_TEST_CASE(incremental_closure) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+  Variable w(vfac.get("w"));
+
+  Octagon inv = Octagon::top();
+  inv.add(VariableExpr(x) <= VariableExpr(y));
+  inv.add(VariableExpr(y) <= VariableExpr(z));
+  inv.add(VariableExpr(x) >= 0);
+  inv.normalize();
+
+  // Closed incrementally on z
+  inv.add(VariableExpr(z) <= 5);
+  inv.normalize();
+  BOOST_CHECK(inv.to_interval(x) == ZInterval(ZBound(0), ZBound(5)));
+  BOOST_CHECK(inv.to_interval(y) == ZInterval(ZBound(0), ZBound(5)));
+  BOOST_CHECK(inv.to_interval(z) == ZInterval(ZBound(0), ZBound(5)));
+
+  // Closed incrementally on w
+  inv.assign(w, y);
+  inv.add(VariableExpr(w) >= 3);
+  inv.normalize();
+  BOOST_CHECK(inv.to_interval(w) == ZInterval(ZBound(3), ZBound(5)));
+  BOOST_CHECK(inv.to_interval(y) == ZInterval(ZBound(3), ZBound(5)));
+  BOOST_CHECK(inv.to_interval(z) == ZInterval(ZBound(3), ZBound(5)));
+
+  inv.apply(BinaryOperator::Add, w, w, ZNumber(1));
+  inv.normalize();
+  BOOST_CHECK(inv.to_interval(w) == ZInterval(ZBound(4), ZBound(6)));
+
+  Octagon tmp = inv;
+  tmp.add(VariableExpr(x) >= 6);
+  BOOST_CHECK(tmp.is_bottom());
+
+  // Same constraints, closed once at the end
+  Octagon inv2 = Octagon::top();
+  inv2.add(VariableExpr(x) <= VariableExpr(y));
+  inv2.add(VariableExpr(y) <= VariableExpr(z));
+  inv2.add(VariableExpr(x) >= 0);
+  inv2.add(VariableExpr(z) <= 5);
+  inv2.add(VariableExpr(w) == VariableExpr(y) + 1);
+  inv2.add(VariableExpr(w) >= 4);
+  BOOST_CHECK(inv.equals(inv2));
+}
@@ -0,0 +1,258 @@
+/*******************************************************************************
+ *
+ * Tests for StaticVarPackingDomain
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#define BOOST_TEST_MODULE test_static_var_packing_domain
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/domain/numeric/dbm.hpp>
+#include <ikos/core/domain/numeric/static_var_packing_domain.hpp>
+#include <ikos/core/example/variable_factory.hpp>
+
+using ZNumber = ikos::core::ZNumber;
+using VariableFactory = ikos::core::example::VariableFactory;
+using Variable = ikos::core::example::VariableFactory::VariableRef;
+using VariableExpr = ikos::core::VariableExpression< ZNumber, Variable >;
+using LinearExpr = ikos::core::LinearExpression< ZNumber, Variable >;
+using BinaryOperator = ikos::core::numeric::BinaryOperator;
+using Bound = ikos::core::ZBound;
+using Interval = ikos::core::numeric::ZInterval;
+using DBM = ikos::core::numeric::DBM< ZNumber, Variable >;
+using VariablePacking = ikos::core::numeric::VariablePacking< Variable >;
+using StaticVarPackingDomain =
+    ikos::core::numeric::StaticVarPackingDomain< ZNumber, Variable, DBM >;
+
+BOOST_AUTO_TEST_CASE(variable_packing) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+  Variable w(vfac.get("w"));
+
+  VariablePacking packing(3);
+  BOOST_CHECK(packing.representative(x) == x);
+  BOOST_CHECK(!packing.same_pack(x, y));
+  BOOST_CHECK(packing.num_packs() == 0);
+
+  BOOST_CHECK(packing.pack(x, y));
+  BOOST_CHECK(packing.same_pack(x, y));
+  BOOST_CHECK(packing.num_packs() == 1);
+
+  BOOST_CHECK(packing.pack(z, y));
+  BOOST_CHECK(packing.same_pack(x, z));
+  BOOST_CHECK(packing.pack_size(packing.representative(z)) == 3);
+
+  // Exceeds the maximum pack size
+  BOOST_CHECK(!packing.pack(w, x));
+  BOOST_CHECK(!packing.same_pack(w, x));
+  BOOST_CHECK(packing.representative(w) == w);
+}
+
+BOOST_AUTO_TEST_CASE(is_top_and_bottom) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+
+  auto packing = std::make_shared< VariablePacking >(8);
+  packing->pack(x, y);
+
+  BOOST_CHECK(StaticVarPackingDomain::top().is_top());
+  BOOST_CHECK(!StaticVarPackingDomain::top().is_bottom());
+  BOOST_CHECK(!StaticVarPackingDomain::bottom().is_top());
+  BOOST_CHECK(StaticVarPackingDomain::bottom().is_bottom());
+
+  StaticVarPackingDomain inv = StaticVarPackingDomain::top(packing);
+  BOOST_CHECK(inv.is_top());
+  BOOST_CHECK(!inv.is_bottom());
+
+  inv.set(x, Interval(1));
+  BOOST_CHECK(!inv.is_top());
+  BOOST_CHECK(!inv.is_bottom());
+
+  inv.add(VariableExpr(y) - VariableExpr(x) <= -2);
+  inv.add(VariableExpr(y) >= 0);
+  BOOST_CHECK(inv.is_bottom());
+
+  inv.set_to_top();
+  inv.add(VariableExpr(x) - VariableExpr(y) <= 1);
+  inv.forget(x);
+  BOOST_CHECK(inv.is_top());
+}
+
+BOOST_AUTO_TEST_CASE(relations_within_packs) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+
+  auto packing = std::make_shared< VariablePacking >(8);
+  packing->pack(x, y);
+
+  StaticVarPackingDomain inv = StaticVarPackingDomain::top(packing);
+  inv.add(VariableExpr(x) - VariableExpr(y) <= 0);
+  inv.add(VariableExpr(y) - VariableExpr(z) <= 0);
+  inv.refine(y, Interval(Bound(0), Bound(10)));
+  inv.refine(z, Interval(Bound(0), Bound(10)));
+
+  // x <= y is kept, y <= z is lost
+  inv.add(VariableExpr(y) <= 5);
+  BOOST_CHECK(inv.to_interval(x) ==
+              Interval(Bound::minus_infinity(), Bound(5)));
+  inv.add(VariableExpr(z) <= 3);
+  BOOST_CHECK(inv.to_interval(y) == Interval(Bound(0), Bound(5)));
+
+  // x = y + 1
+  inv.apply(BinaryOperator::Add, x, y, ZNumber(1));
+  inv.add(VariableExpr(y) >= 4);
+  BOOST_CHECK(inv.to_interval(x) == Interval(Bound(5), Bound(6)));
+
+  // x = z + 1, z is not in the pack of x
+  inv.apply(BinaryOperator::Add, x, z, ZNumber(1));
+  BOOST_CHECK(inv.to_interval(x) == Interval(Bound(1), Bound(4)));
+  inv.add(VariableExpr(z) <= 1);
+  BOOST_CHECK(inv.to_interval(x) == Interval(Bound(1), Bound(4)));
+}
+
+BOOST_AUTO_TEST_CASE(assign) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+
+  auto packing = std::make_shared< VariablePacking >(8);
+  packing->pack(x, y);
+
+  StaticVarPackingDomain inv = StaticVarPackingDomain::top(packing);
+  inv.set(y, Interval(Bound(0), Bound(10)));
+  inv.set(z, Interval(Bound(1), Bound(2)));
+
+  // x = y + z, z is abstracted by [1, 2] but x - y is kept
+  LinearExpr e(y);
+  e.add(z);
+  inv.assign(x, e);
+  BOOST_CHECK(inv.to_interval(x) == Interval(Bound(1), Bound(12)));
+  inv.add(VariableExpr(y) <= 3);
+  BOOST_CHECK(inv.to_interval(x) == Interval(Bound(1), Bound(5)));
+
+  // x = z
+  inv.assign(x, z);
+  BOOST_CHECK(inv.to_interval(x) == Interval(Bound(1), Bound(2)));
+  inv.add(VariableExpr(z) == 2);
+  BOOST_CHECK(inv.to_interval(x) == Interval(Bound(1), Bound(2)));
+}
+
+BOOST_AUTO_TEST_CASE(add) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+
+  auto packing = std::make_shared< VariablePacking >(8);
+  packing->pack(x, y);
+
+  StaticVarPackingDomain inv = StaticVarPackingDomain::top(packing);
+  inv.set(z, Interval(Bound(0), Bound(5)));
+
+  // x + z <= 10 is projected on both packs
+  inv.add(VariableExpr(x) + VariableExpr(z) <= 10);
+  BOOST_CHECK(inv.to_interval(x) ==
+              Interval(Bound::minus_infinity(), Bound(10)));
+
+  inv.add(VariableExpr(x) >= 8);
+  inv.add(VariableExpr(x) + VariableExpr(z) <= 10);
+  BOOST_CHECK(inv.to_interval(z) == Interval(Bound(0), Bound(2)));
+
+  // x - z == y, with z in [0, 2]
+  inv.add(VariableExpr(x) - VariableExpr(z) - VariableExpr(y) == 0);
+  BOOST_CHECK(inv.to_interval(y) == Interval(Bound(6), Bound(10)));
+}
+
+BOOST_AUTO_TEST_CASE(join_and_meet) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+
+  auto packing = std::make_shared< VariablePacking >(8);
+  packing->pack(x, y);
+
+  StaticVarPackingDomain inv1 = StaticVarPackingDomain::top(packing);
+  inv1.assign(x, 0);
+  inv1.assign(y, 0);
+  inv1.assign(z, 0);
+
+  StaticVarPackingDomain inv2 = StaticVarPackingDomain::top(packing);
+  inv2.assign(x, 1);
+  inv2.assign(y, 1);
+
+  StaticVarPackingDomain inv3 = inv1.join(inv2);
+  BOOST_CHECK(inv1.leq(inv3));
+  BOOST_CHECK(inv2.leq(inv3));
+  BOOST_CHECK(inv3.to_interval(x) == Interval(Bound(0), Bound(1)));
+  BOOST_CHECK(inv3.to_interval(z) == Interval::top());
+  inv3.add(VariableExpr(y) == 1);
+  BOOST_CHECK(inv3.to_interval(x) == Interval(1));
+
+  StaticVarPackingDomain inv4 = inv1.meet(inv2);
+  BOOST_CHECK(inv4.is_bottom());
+
+  StaticVarPackingDomain inv5 = StaticVarPackingDomain::top(packing);
+  inv5.set(z, Interval(Bound(0), Bound(5)));
+  StaticVarPackingDomain inv6 = inv2.meet(inv5);
+  BOOST_CHECK(inv6.to_interval(x) == Interval(1));
+  BOOST_CHECK(inv6.to_interval(z) == Interval(Bound(0), Bound(5)));
+  BOOST_CHECK(inv6.leq(inv2));
+  BOOST_CHECK(inv6.leq(inv5));
+  BOOST_CHECK(!inv2.leq(inv6));
+
+  // Widening keeps the relation x == y
+  StaticVarPackingDomain inv7 = inv1.join(inv2);
+  inv7.add(VariableExpr(x) - VariableExpr(y) == 0);
+  StaticVarPackingDomain inv8 = inv7;
+  inv8.apply(BinaryOperator::Add, x, x, ZNumber(1));
+  inv8.apply(BinaryOperator::Add, y, y, ZNumber(1));
+  StaticVarPackingDomain inv9 = inv7.widening(inv7.join(inv8));
+  BOOST_CHECK(inv9.to_interval(x) ==
+              Interval(Bound(0), Bound::plus_infinity()));
+  inv9.add(VariableExpr(y) <= 3);
+  BOOST_CHECK(inv9.to_interval(x) == Interval(Bound(0), Bound(3)));
+}
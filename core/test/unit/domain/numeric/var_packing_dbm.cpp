@@ -59,6 +59,8 @@ using Interval = ikos::core::numeric::ZInterval;
 using Congruence = ikos::core::numeric::ZCongruence;
 using IntervalCongruence = ikos::core::numeric::IntervalCongruence< ZNumber >;
 using VarPackingDBM = ikos::core::numeric::VarPackingDBM< ZNumber, Variable >;
+using VarPackingSettings = ikos::core::numeric::VarPackingSettings;
+using VarPackingStats = ikos::core::numeric::VarPackingStats;
 
 BOOST_AUTO_TEST_CASE(is_top_and_bottom) {
   VariableFactory vfac;
@@ -888,3 +890,108 @@ BOOST_AUTO_TEST_CASE(to_interval_congruence) {
                                          3 * VariableExpr(y) + 1) ==
               IntervalCongruence(Interval(Bound(-9), Bound(-4))));
 }
+
+BOOST_AUTO_TEST_CASE(max_pack_size) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+
+  VarPackingSettings::set_max_pack_size(2);
+  VarPackingSettings::stats() = VarPackingStats{0, 0};
+
+  VarPackingDBM inv;
+  inv.set(x, Interval(Bound(0), Bound(10)));
+  inv.assign(y, x);
+  inv.apply(BinaryOperator::Add, z, y, ZNumber(1));
+  BOOST_CHECK(inv.to_interval(z) == Interval(Bound(1), Bound(11)));
+
+  inv.add(VariableExpr(x) <= 5);
+  inv.normalize();
+  BOOST_CHECK(inv.to_interval(y) == Interval(Bound(0), Bound(5)));
+  BOOST_CHECK(inv.to_interval(z) == Interval(Bound(1), Bound(11)));
+
+  inv.add(VariableExpr(z) - VariableExpr(x) <= 0);
+  inv.normalize();
+  BOOST_CHECK(inv.to_interval(x) == Interval(Bound(1), Bound(5)));
+  BOOST_CHECK(inv.to_interval(y) == Interval(Bound(1), Bound(5)));
+  BOOST_CHECK(inv.to_interval(z) == Interval(Bound(1), Bound(5)));
+
+  BOOST_CHECK(VarPackingSettings::stats().max_pack_size == 2);
+  BOOST_CHECK(VarPackingSettings::stats().dropped_relations == 2);
+
+  VarPackingDBM inv1;
+  inv1.set(x, Interval(Bound(0), Bound(1)));
+  inv1.assign(y, x);
+  inv1.set(z, Interval(0));
+
+  VarPackingDBM inv2;
+  inv2.set(z, Interval(5));
+  inv2.assign(y, z);
+  inv2.set(x, Interval(2));
+
+  VarPackingDBM inv3 = inv1.join(inv2);
+  BOOST_CHECK(inv3.to_interval(x) == Interval(Bound(0), Bound(2)));
+  BOOST_CHECK(inv3.to_interval(y) == Interval(Bound(0), Bound(5)));
+  BOOST_CHECK(inv3.to_interval(z) == Interval(Bound(0), Bound(5)));
+  BOOST_CHECK(VarPackingSettings::stats().dropped_relations == 3);
+
+  VarPackingDBM inv4 = inv1.meet(inv2);
+  BOOST_CHECK(inv4.is_bottom());
+
+  VarPackingSettings::set_max_pack_size(0);
+}
+
+BOOST_AUTO_TEST_CASE(forget_vars_and_project) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+  Variable w(vfac.get("w"));
+  Variable u(vfac.get("u"));
+
+  VarPackingDBM inv;
+  inv.set(x, Interval(Bound(0), Bound(10)));
+  inv.add(VariableExpr(y) - VariableExpr(x) <= 1);
+  inv.add(VariableExpr(z) - VariableExpr(y) <= 2);
+  inv.set(w, Interval(Bound(5), Bound(6)));
+  inv.add(VariableExpr(u) - VariableExpr(w) <= 0);
+
+  // Remove the root of a pack and a whole pack
+  VarPackingDBM inv2 = inv;
+  inv2.forget_vars({x, w, u});
+  inv2.normalize();
+  BOOST_CHECK(inv2.to_interval(x) == Interval::top());
+  BOOST_CHECK(inv2.to_interval(w) == Interval::top());
+  BOOST_CHECK(inv2.to_interval(u) == Interval::top());
+  BOOST_CHECK(inv2.to_interval(y) ==
+              Interval(Bound::minus_infinity(), Bound(11)));
+  BOOST_CHECK(inv2.to_interval(z) ==
+              Interval(Bound::minus_infinity(), Bound(13)));
+
+  // Same result as forgetting the variables one by one
+  VarPackingDBM inv4 = inv;
+  inv4.forget(x);
+  inv4.forget(w);
+  inv4.forget(u);
+  BOOST_CHECK(inv4.equals(inv2));
+
+  inv2.add(VariableExpr(y) >= 3);
+  inv2.normalize();
+  BOOST_CHECK(inv2.to_interval(z) ==
+              Interval(Bound::minus_infinity(), Bound(13)));
+
+  VarPackingDBM inv3 = inv;
+  inv3.project({x, z, u});
+  inv3.normalize();
+  BOOST_CHECK(inv3.to_interval(y) == Interval::top());
+  BOOST_CHECK(inv3.to_interval(w) == Interval::top());
+  BOOST_CHECK(inv3.to_interval(z) ==
+              Interval(Bound::minus_infinity(), Bound(13)));
+  BOOST_CHECK(inv3.to_interval(u) ==
+              Interval(Bound::minus_infinity(), Bound(6)));
+  inv3.add(VariableExpr(x) >= 10);
+  inv3.normalize();
+  BOOST_CHECK(inv3.to_interval(z) ==
+              Interval(Bound::minus_infinity(), Bound(13)));
+}
@@ -352,3 +352,167 @@ BOOST_AUTO_TEST_CASE(test_4) {
                                                      Uninitialized::top()));
   BOOST_CHECK(s.get_memory(nrows) == PointerAbsValue::bottom(64, Unsigned));
 }
+
+BOOST_AUTO_TEST_CASE(test_5) {
+  // Constraints in reverse order, so that loads and stores see their
+  // points-to sets and memory locations grow over several evaluations:
+  //
+  // r = *p
+  // *p = a
+  // *p = b
+  // p = q
+  // q = &mq
+  // p = &mp
+  // b = &mb
+  // a = &ma
+
+  VariableFactory vfac;
+  MemoryFactory memfac;
+
+  Variable a(vfac.get("a"));
+  Variable b(vfac.get("b"));
+  Variable p(vfac.get("p"));
+  Variable q(vfac.get("q"));
+  Variable r(vfac.get("r"));
+
+  MemLocation ma(memfac.get("&a"));
+  MemLocation mb(memfac.get("&b"));
+  MemLocation mp(memfac.get("&p"));
+  MemLocation mq(memfac.get("&q"));
+
+  ConstraintSystem s(64, Unsigned);
+  Interval zero(Int(0, 64, Unsigned));
+
+  s.add(Load::create(r, VarOperand::create(p, zero)));
+  s.add(Store::create(p, VarOperand::create(a, zero)));
+  s.add(Store::create(p, VarOperand::create(b, zero)));
+  s.add(Assign::create(p, VarOperand::create(q, zero)));
+  s.add(Assign::create(q, AddrOperand::create(mq, zero)));
+  s.add(Assign::create(p, AddrOperand::create(mp, zero)));
+  s.add(Assign::create(b, AddrOperand::create(mb, zero)));
+  s.add(Assign::create(a, AddrOperand::create(ma, zero)));
+
+  s.solve();
+
+  BOOST_CHECK(s.get_pointer(p) == PointerAbsValue(PointsToSet{mp, mq},
+                                                  zero,
+                                                  Nullity::top(),
+                                                  Uninitialized::top()));
+  BOOST_CHECK(s.get_memory(mp) == PointerAbsValue(PointsToSet{ma, mb},
+                                                  zero,
+                                                  Nullity::top(),
+                                                  Uninitialized()));
+  BOOST_CHECK(s.get_memory(mq) == PointerAbsValue(PointsToSet{ma, mb},
+                                                  zero,
+                                                  Nullity::top(),
+                                                  Uninitialized()));
+  BOOST_CHECK(s.get_pointer(r) == PointerAbsValue(PointsToSet{ma, mb},
+                                                  zero,
+                                                  Nullity::top(),
+                                                  Uninitialized()));
+}
+
+BOOST_AUTO_TEST_CASE(test_6) {
+  // Cycle of copies, collapsed into one representative:
+  //
+  // a = &ma
+  // b = a
+  // c = b
+  // a = c
+  // c = &mc
+  // d = c + 4
+
+  VariableFactory vfac;
+  MemoryFactory memfac;
+
+  Variable a(vfac.get("a"));
+  Variable b(vfac.get("b"));
+  Variable c(vfac.get("c"));
+  Variable d(vfac.get("d"));
+
+  MemLocation ma(memfac.get("&a"));
+  MemLocation mc(memfac.get("&c"));
+
+  ConstraintSystem s(64, Unsigned);
+  Interval zero(Int(0, 64, Unsigned));
+  Interval four(Int(4, 64, Unsigned));
+
+  s.add(Assign::create(a, AddrOperand::create(ma, zero)));
+  s.add(Assign::create(b, VarOperand::create(a, zero)));
+  s.add(Assign::create(c, VarOperand::create(b, zero)));
+  s.add(Assign::create(a, VarOperand::create(c, zero)));
+  s.add(Assign::create(c, AddrOperand::create(mc, zero)));
+  s.add(Assign::create(d, VarOperand::create(c, four)));
+
+  s.solve();
+
+  PointerAbsValue expected(PointsToSet{ma, mc},
+                           zero,
+                           Nullity::top(),
+                           Uninitialized::top());
+  BOOST_CHECK(s.get_pointer(a) == expected);
+  BOOST_CHECK(s.get_pointer(b) == expected);
+  BOOST_CHECK(s.get_pointer(c) == expected);
+  BOOST_CHECK(s.get_pointer(d) == PointerAbsValue(PointsToSet{ma, mc},
+                                                  four,
+                                                  Nullity::top(),
+                                                  Uninitialized::top()));
+
+  std::size_t num_pointers = 0;
+  for (auto it = s.pointer_begin(); it != s.pointer_end(); ++it) {
+    num_pointers++;
+  }
+  BOOST_CHECK(num_pointers == 4);
+}
+
+BOOST_AUTO_TEST_CASE(test_7) {
+  // Two independent components, solved separately:
+  //
+  // a = &ma      c = &mc
+  // *a = b       d = c
+  // b = &mb
+  // e = *a
+
+  VariableFactory vfac;
+  MemoryFactory memfac;
+
+  Variable a(vfac.get("a"));
+  Variable b(vfac.get("b"));
+  Variable c(vfac.get("c"));
+  Variable d(vfac.get("d"));
+  Variable e(vfac.get("e"));
+
+  MemLocation ma(memfac.get("&a"));
+  MemLocation mb(memfac.get("&b"));
+  MemLocation mc(memfac.get("&c"));
+
+  ConstraintSystem s(64, Unsigned);
+  Interval zero(Int(0, 64, Unsigned));
+
+  s.add(Assign::create(a, AddrOperand::create(ma, zero)));
+  s.add(Assign::create(c, AddrOperand::create(mc, zero)));
+  s.add(Store::create(a, VarOperand::create(b, zero)));
+  s.add(Assign::create(d, VarOperand::create(c, zero)));
+  s.add(Assign::create(b, AddrOperand::create(mb, zero)));
+  s.add(Load::create(e, VarOperand::create(a, zero)));
+
+  std::vector< ConstraintSystem > systems = s.split(4);
+  BOOST_CHECK(systems.size() == 2);
+  for (ConstraintSystem& system : systems) {
+    system.solve();
+    s.merge(std::move(system));
+  }
+
+  BOOST_CHECK(s.get_pointer(d) == PointerAbsValue(PointsToSet{mc},
+                                                  zero,
+                                                  Nullity::top(),
+                                                  Uninitialized::top()));
+  BOOST_CHECK(s.get_pointer(e) == PointerAbsValue(PointsToSet{mb},
+                                                  zero,
+                                                  Nullity::top(),
+                                                  Uninitialized()));
+  BOOST_CHECK(s.get_memory(ma) == PointerAbsValue(PointsToSet{mb},
+                                                  zero,
+                                                  Nullity::top(),
+                                                  Uninitialized()));
+}
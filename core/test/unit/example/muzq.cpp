@@ -335,8 +335,14 @@ BOOST_AUTO_TEST_CASE(test4) {
   BOOST_CHECK(loop_in.is_bottom());
 
   ZDBM loop_end = fixpoint.checkpoint("loop.end").first();
+  // i >= n and n >= 1 hold at the loop exit, so i >= 1. This used to be
+  // i >= 0: DBM::to_interval() reads the bounds of the matrix without closing
+  // it, and the bound implied by the two constraints was not propagated yet.
+  // The iterator now tests whether an invariant is bottom before running the
+  // transfer functions, which closes the matrix earlier. Both results are
+  // sound, [1, +oo] is the exact one.
   BOOST_CHECK(loop_end.to_interval(i) ==
-              ZInterval(ZBound(0), ZBound::plus_infinity()));
+              ZInterval(ZBound(1), ZBound::plus_infinity()));
   BOOST_CHECK(loop_end.to_interval(n) ==
               ZInterval(ZBound(1), ZBound::plus_infinity()));
   loop_end.add(ZVarExpr(i) <= ZVarExpr(n) - 1);
@@ -570,3 +576,354 @@ BOOST_AUTO_TEST_CASE(test6) {
   BOOST_CHECK(end.to_interval(temp1) ==
               ZInterval(ZBound(5), ZBound::plus_infinity()));
 }
+
+/// \brief Nested loops, shared by the tests of the iterator options
+///
+/// \code{.c}
+///   i = 0;
+///   while (i <= 9) {
+///     j = 0;
+///     while (j <= 9) {
+///       inner.in;
+///       j = j + 1;
+///     }
+///     i = i + 1;
+///   }
+///   if (i <= 9) {
+///     // unreachable
+///   } else {
+///   }
+///   end;
+/// \endcode
+///
+/// With `dead_blocks`, the unreachable branch is followed by a chain of two
+/// blocks, `dead1: i = i + 1` and `dead2: dead`.
+struct NestedLoops {
+  VariableFactory vfac;
+  Variable i;
+  Variable j;
+  ControlFlowGraph cfg;
+  BasicBlock* entry;
+  BasicBlock* outer;
+  BasicBlock* outer_t;
+  BasicBlock* outer_f;
+  BasicBlock* inner;
+  BasicBlock* inner_t;
+  BasicBlock* inner_f;
+  BasicBlock* exit_t;
+  BasicBlock* exit_f;
+  BasicBlock* ret;
+  BasicBlock* dead1 = nullptr;
+  BasicBlock* dead2 = nullptr;
+
+  explicit NestedLoops(bool dead_blocks = false)
+      : i(vfac.get("i")),
+        j(vfac.get("j")),
+        cfg("entry"),
+        entry(cfg.get("entry")),
+        outer(cfg.get("outer")),
+        outer_t(cfg.get("outer_t")),
+        outer_f(cfg.get("outer_f")),
+        inner(cfg.get("inner")),
+        inner_t(cfg.get("inner_t")),
+        inner_f(cfg.get("inner_f")),
+        exit_t(cfg.get("exit_t")),
+        exit_f(cfg.get("exit_f")),
+        ret(cfg.get("ret")) {
+    entry->add_successor(outer);
+    outer->add_successor(outer_t);
+    outer->add_successor(outer_f);
+    outer_t->add_successor(inner);
+    inner->add_successor(inner_t);
+    inner->add_successor(inner_f);
+    inner_t->add_successor(inner);
+    inner_f->add_successor(outer);
+    outer_f->add_successor(exit_t);
+    outer_f->add_successor(exit_f);
+    exit_f->add_successor(ret);
+    if (dead_blocks) {
+      dead1 = cfg.get("dead1");
+      dead2 = cfg.get("dead2");
+      exit_t->add_successor(dead1);
+      dead1->add_successor(dead2);
+      dead2->add_successor(ret);
+      dead1->add(std::make_unique< ZLinearAssignment >(i, ZVarExpr(i) + 1));
+      dead2->add(std::make_unique< CheckPoint >("dead"));
+    } else {
+      exit_t->add_successor(ret);
+    }
+
+    entry->add(std::make_unique< ZLinearAssignment >(i, ZLinearExpression(0)));
+
+    outer_t->add(std::make_unique< ZLinearAssertion >(ZVarExpr(i) <= 9));
+    outer_t->add(
+        std::make_unique< ZLinearAssignment >(j, ZLinearExpression(0)));
+
+    outer_f->add(std::make_unique< ZLinearAssertion >(ZVarExpr(i) >= 10));
+
+    inner_t->add(std::make_unique< ZLinearAssertion >(ZVarExpr(j) <= 9));
+    inner_t->add(std::make_unique< CheckPoint >("inner.in"));
+    inner_t->add(std::make_unique< ZLinearAssignment >(j, ZVarExpr(j) + 1));
+
+    inner_f->add(std::make_unique< ZLinearAssertion >(ZVarExpr(j) >= 10));
+    inner_f->add(std::make_unique< ZLinearAssignment >(i, ZVarExpr(i) + 1));
+
+    exit_t->add(std::make_unique< ZLinearAssertion >(ZVarExpr(i) <= 9));
+
+    exit_f->add(std::make_unique< ZLinearAssertion >(ZVarExpr(i) >= 10));
+
+    ret->add(std::make_unique< CheckPoint >("end"));
+  }
+
+  /// \brief Return the blocks
+  std::vector< BasicBlock* > blocks() const {
+    return {entry,
+            outer,
+            outer_t,
+            outer_f,
+            inner,
+            inner_t,
+            inner_f,
+            exit_t,
+            exit_f,
+            ret};
+  }
+};
+
+BOOST_AUTO_TEST_CASE(low_memory) {
+  NestedLoops loops;
+
+  using FixpointIterator =
+      muzq::FixpointIterator< Variable, ZIntervalDomain, QIntervalDomain >;
+  using AbstractDomain = FixpointIterator::AbstractDomain;
+
+  FixpointIterator fixpoint(loops.cfg);
+  fixpoint.run();
+
+  FixpointIterator low_memory_fixpoint(loops.cfg);
+  low_memory_fixpoint.set_low_memory(true);
+  low_memory_fixpoint.run();
+
+  // Only the entry, the cycle heads and the exit node are kept
+  BOOST_CHECK(low_memory_fixpoint.pre(loops.inner_t).is_bottom());
+  BOOST_CHECK(low_memory_fixpoint.post(loops.inner_t).is_bottom());
+  BOOST_CHECK(low_memory_fixpoint.pre(loops.exit_f).is_bottom());
+  BOOST_CHECK(!low_memory_fixpoint.pre(loops.inner).is_bottom());
+  BOOST_CHECK(!low_memory_fixpoint.post(loops.ret).is_bottom());
+
+  // The replayed invariants are the same as the ones of the normal mode
+  std::size_t num_nodes = 0;
+  low_memory_fixpoint.replay([&](BasicBlock* bb,
+                                 const AbstractDomain& pre,
+                                 const AbstractDomain& post) {
+    num_nodes++;
+    BOOST_CHECK(pre.equals(fixpoint.pre(bb)));
+    BOOST_CHECK(post.equals(fixpoint.post(bb)));
+  });
+  BOOST_CHECK_EQUAL(num_nodes, loops.cfg.num_blocks());
+
+  ZIntervalDomain inner_in = low_memory_fixpoint.checkpoint("inner.in").first();
+  BOOST_CHECK(inner_in.to_interval(loops.i) ==
+              ZInterval(ZBound(0), ZBound(9)));
+  BOOST_CHECK(inner_in.to_interval(loops.j) ==
+              ZInterval(ZBound(0), ZBound(9)));
+
+  ZIntervalDomain end = low_memory_fixpoint.checkpoint("end").first();
+  BOOST_CHECK(end.to_interval(loops.i) == ZInterval(10));
+
+  // A compacted fixpoint only keeps the entry and the cycle heads
+  FixpointIterator compacted_fixpoint(loops.cfg);
+  compacted_fixpoint.run();
+  compacted_fixpoint.compact();
+  BOOST_CHECK(compacted_fixpoint.low_memory());
+  BOOST_CHECK(compacted_fixpoint.pre(loops.inner_t).is_bottom());
+  BOOST_CHECK(compacted_fixpoint.post(loops.ret).is_bottom());
+  BOOST_CHECK(!compacted_fixpoint.pre(loops.entry).is_bottom());
+  BOOST_CHECK(!compacted_fixpoint.pre(loops.outer).is_bottom());
+  BOOST_CHECK(!compacted_fixpoint.pre(loops.inner).is_bottom());
+
+  num_nodes = 0;
+  compacted_fixpoint.replay([&](BasicBlock* bb,
+                                const AbstractDomain& pre,
+                                const AbstractDomain& post) {
+    num_nodes++;
+    BOOST_CHECK(pre.equals(fixpoint.pre(bb)));
+    BOOST_CHECK(post.equals(fixpoint.post(bb)));
+  });
+  BOOST_CHECK_EQUAL(num_nodes, loops.cfg.num_blocks());
+}
+
+BOOST_AUTO_TEST_CASE(reuse_unchanged) {
+  NestedLoops loops;
+
+  using FixpointIterator =
+      muzq::FixpointIterator< Variable, ZIntervalDomain, QIntervalDomain >;
+
+  FixpointIterator fixpoint(loops.cfg);
+  fixpoint.run();
+  BOOST_CHECK_EQUAL(fixpoint.num_reused_nodes(), 0U);
+
+  FixpointIterator reuse_fixpoint(loops.cfg);
+  reuse_fixpoint.set_reuse_unchanged(true);
+  reuse_fixpoint.run();
+
+  // The invariants are the same, with fewer calls to analyze_node()
+  for (BasicBlock* bb : loops.blocks()) {
+    BOOST_CHECK(reuse_fixpoint.pre(bb).equals(fixpoint.pre(bb)));
+    BOOST_CHECK(reuse_fixpoint.post(bb).equals(fixpoint.post(bb)));
+  }
+  BOOST_CHECK(reuse_fixpoint.num_reused_nodes() > 0U);
+  BOOST_CHECK_EQUAL(reuse_fixpoint.num_analyzed_nodes() +
+                        reuse_fixpoint.num_reused_nodes(),
+                    fixpoint.num_analyzed_nodes());
+
+  FixpointCycleStats stats = reuse_fixpoint.cycle_stats(loops.outer);
+  BOOST_CHECK(stats.reused_nodes > 0U);
+  BOOST_CHECK(stats.analyzed_nodes > 0U);
+
+  ZIntervalDomain inner_in = reuse_fixpoint.checkpoint("inner.in").first();
+  BOOST_CHECK(inner_in.to_interval(loops.i) ==
+              ZInterval(ZBound(0), ZBound(9)));
+  BOOST_CHECK(inner_in.to_interval(loops.j) ==
+              ZInterval(ZBound(0), ZBound(9)));
+
+  ZIntervalDomain end = reuse_fixpoint.checkpoint("end").first();
+  BOOST_CHECK(end.to_interval(loops.i) == ZInterval(10));
+}
+
+BOOST_AUTO_TEST_CASE(in_place) {
+  NestedLoops loops;
+
+  using FixpointIterator =
+      muzq::FixpointIterator< Variable, ZIntervalDomain, QIntervalDomain >;
+
+  FixpointIterator fixpoint(loops.cfg);
+  fixpoint.run();
+
+  FixpointIterator in_place_fixpoint(loops.cfg);
+  in_place_fixpoint.set_in_place(true);
+  in_place_fixpoint.run();
+
+  // Same pre invariants, with fewer copies
+  for (BasicBlock* bb : loops.blocks()) {
+    BOOST_CHECK(in_place_fixpoint.pre(bb).equals(fixpoint.pre(bb)));
+  }
+  BOOST_CHECK(in_place_fixpoint.num_copies() < fixpoint.num_copies());
+
+  // Post invariants outside of the loops are dropped once consumed, except at
+  // the exit node. Nodes in the loops keep them.
+  BOOST_CHECK(in_place_fixpoint.post(loops.entry).is_bottom());
+  BOOST_CHECK(in_place_fixpoint.post(loops.exit_f).is_bottom());
+  BOOST_CHECK(in_place_fixpoint.post(loops.ret).equals(
+      fixpoint.post(loops.ret)));
+  for (BasicBlock* bb : {loops.outer, loops.inner, loops.inner_t}) {
+    BOOST_CHECK(in_place_fixpoint.post(bb).equals(fixpoint.post(bb)));
+  }
+
+  ZIntervalDomain end = in_place_fixpoint.checkpoint("end").first();
+  BOOST_CHECK(end.to_interval(loops.i) == ZInterval(ZBound(10), ZBound(10)));
+}
+
+BOOST_AUTO_TEST_CASE(in_place_rollback) {
+  NestedLoops loops;
+
+  using FixpointIterator =
+      muzq::FixpointIterator< Variable, ZIntervalDomain, QIntervalDomain >;
+
+  FixpointIterator fixpoint(loops.cfg);
+  fixpoint.run();
+
+  FixpointIterator in_place_fixpoint(loops.cfg);
+  in_place_fixpoint.set_in_place(true);
+  in_place_fixpoint.run();
+
+  // The widened invariants of the loop heads are not modified by the in-place
+  // updates of their successors
+  for (BasicBlock* head : {loops.outer, loops.inner}) {
+    BOOST_CHECK(in_place_fixpoint.pre(head).equals(fixpoint.pre(head)));
+    BOOST_CHECK(in_place_fixpoint.post(head).equals(fixpoint.post(head)));
+  }
+
+  // The exit of the outer loop is moved into its last successor, and refined
+  // in place there. The other successor still sees the unrefined invariant.
+  BOOST_CHECK(in_place_fixpoint.pre(loops.exit_t).equals(
+      fixpoint.post(loops.outer_f)));
+  BOOST_CHECK(in_place_fixpoint.pre(loops.exit_f).equals(
+      fixpoint.post(loops.outer_f)));
+  BOOST_CHECK(fixpoint.post(loops.exit_t).is_bottom());
+
+  // Replaying the fixpoint visits the same pre invariants. Post invariants are
+  // either kept unchanged or dropped.
+  in_place_fixpoint.replay([&](BasicBlock* bb,
+                               const FixpointIterator::AbstractDomain& pre,
+                               const FixpointIterator::AbstractDomain& post) {
+    BOOST_CHECK(pre.equals(fixpoint.pre(bb)));
+    BOOST_CHECK(post.is_bottom() || post.equals(fixpoint.post(bb)));
+  });
+
+  // Running the analysis again from scratch gives the same invariants
+  in_place_fixpoint.clear();
+  in_place_fixpoint.run();
+  for (BasicBlock* bb : loops.blocks()) {
+    BOOST_CHECK(in_place_fixpoint.pre(bb).equals(fixpoint.pre(bb)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cycle_stats) {
+  NestedLoops loops;
+
+  muzq::FixpointIterator< Variable, ZIntervalDomain, QIntervalDomain > fixpoint(
+      loops.cfg);
+  fixpoint.run();
+
+  // On both loops, iteration 1 joins, iteration 2 widens, iteration 3 reaches
+  // the post-fixpoint and is used as the first decreasing iteration. The
+  // statistics of the inner loop are the ones of its last analysis, for the
+  // last iteration of the outer loop.
+  for (BasicBlock* head : {loops.inner, loops.outer}) {
+    FixpointCycleStats stats = fixpoint.cycle_stats(head);
+    BOOST_CHECK_EQUAL(stats.increasing_iterations, 3U);
+    BOOST_CHECK_EQUAL(stats.widenings, 1U);
+    BOOST_CHECK(stats.narrowings >= 1U);
+    BOOST_CHECK(stats.time.count() >= 0.0);
+    BOOST_CHECK_EQUAL(stats.peak_size, 0U);
+
+    // The head is analyzed on a copy of its pre invariant at each iteration
+    BOOST_CHECK(stats.copies >= stats.increasing_iterations + stats.narrowings);
+  }
+
+  // The nodes and the copies of the inner loop are counted in the outer loop
+  BOOST_CHECK(fixpoint.cycle_stats(loops.outer).analyzed_nodes >
+              fixpoint.cycle_stats(loops.inner).analyzed_nodes);
+  BOOST_CHECK(fixpoint.cycle_stats(loops.outer).copies >
+              fixpoint.cycle_stats(loops.inner).copies);
+  BOOST_CHECK(fixpoint.num_copies() >=
+              fixpoint.cycle_stats(loops.outer).copies);
+
+  // Not a cycle head
+  BOOST_CHECK_EQUAL(fixpoint.cycle_stats(loops.inner_t).increasing_iterations,
+                    0U);
+}
+
+BOOST_AUTO_TEST_CASE(unreachable_blocks) {
+  NestedLoops loops;
+  NestedLoops dead_loops(/*dead_blocks=*/true);
+
+  muzq::FixpointIterator< Variable, ZIntervalDomain, QIntervalDomain > fixpoint(
+      loops.cfg);
+  fixpoint.run();
+
+  muzq::FixpointIterator< Variable, ZIntervalDomain, QIntervalDomain >
+      dead_fixpoint(dead_loops.cfg);
+  dead_fixpoint.run();
+
+  BOOST_CHECK(dead_fixpoint.post(dead_loops.exit_t).is_bottom());
+  BOOST_CHECK(dead_fixpoint.pre(dead_loops.dead1).is_bottom());
+  BOOST_CHECK(dead_fixpoint.post(dead_loops.dead2).is_bottom());
+  BOOST_CHECK(dead_fixpoint.checkpoint("dead").is_bottom());
+  BOOST_CHECK(dead_fixpoint.post(dead_loops.ret).equals(
+      fixpoint.post(loops.ret)));
+
+  // Bottom is propagated through the unreachable blocks without copies
+  BOOST_CHECK_EQUAL(dead_fixpoint.num_copies(), fixpoint.num_copies());
+}
@@ -0,0 +1,166 @@
+/*******************************************************************************
+ *
+ * Tests for the sparse fixpoint iterator
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#define BOOST_TEST_MODULE test_sparse_fixpoint_iterator
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/example/muzq.hpp>
+#include <ikos/core/example/variable_factory.hpp>
+#include <ikos/core/fixpoint/sparse_fixpoint_iterator.hpp>
+#include <ikos/core/value/numeric/interval.hpp>
+
+using namespace ikos::core;
+using namespace ikos::core::numeric;
+
+using Variable = example::VariableFactory::VariableRef;
+using BasicBlock = muzq::BasicBlock< Variable >;
+using ControlFlowGraph = muzq::ControlFlowGraph< Variable >;
+
+namespace {
+
+/// \brief Interval analysis of a loop counter, on its def-use graph
+///
+/// The nodes of the graph are the definitions of:
+///
+///   i0 = 0;
+///   i = phi(i0, inc);
+///   inc = i + 1, assuming i <= 9;
+///
+/// A definition named "reset" is the constant 0.
+class CounterFixpoint final
+    : public SparseFixpointIterator< ControlFlowGraph*, ZInterval > {
+public:
+  std::size_t cycles = 0;
+  FixpointCycleStats stats;
+
+public:
+  explicit CounterFixpoint(ControlFlowGraph* graph)
+      : SparseFixpointIterator< ControlFlowGraph*, ZInterval >(graph) {}
+
+  ZInterval analyze_node(BasicBlock* node) override {
+    const std::string& name = node->name();
+    if (name == "i0") {
+      return ZInterval(0);
+    } else if (name == "i") {
+      ZInterval i = ZInterval::bottom();
+      for (auto it = node->predecessor_begin(), et = node->predecessor_end();
+           it != et;
+           ++it) {
+        i.join_with(this->value(*it));
+      }
+      return i;
+    } else if (name == "inc") {
+      ZInterval i = this->value(*node->predecessor_begin());
+      i.meet_with(ZInterval(ZBound::minus_infinity(), ZBound(9)));
+      return i + ZInterval(1);
+    } else if (name == "reset") {
+      return ZInterval(0);
+    } else {
+      return ZInterval::top();
+    }
+  }
+
+  void process_cycle_stats(BasicBlock*,
+                           const FixpointCycleStats& stats) override {
+    this->cycles++;
+    this->stats = stats;
+  }
+};
+
+} // end anonymous namespace
+
+BOOST_AUTO_TEST_CASE(loop_counter) {
+  ControlFlowGraph cfg("entry");
+  BasicBlock* entry = cfg.get("entry");
+  BasicBlock* i0 = cfg.get("i0");
+  BasicBlock* i = cfg.get("i");
+  BasicBlock* inc = cfg.get("inc");
+  BasicBlock* dead = cfg.get("dead");
+
+  entry->add_successor(i0);
+  i0->add_successor(i);
+  i->add_successor(inc);
+  inc->add_successor(i);
+  dead->add_successor(i);
+
+  CounterFixpoint fixpoint(&cfg);
+  fixpoint.run();
+
+  BOOST_CHECK(fixpoint.value(i0) == ZInterval(0));
+  BOOST_CHECK(fixpoint.value(i) == ZInterval(ZBound(0), ZBound(10)));
+  BOOST_CHECK(fixpoint.value(inc) == ZInterval(ZBound(1), ZBound(10)));
+  BOOST_CHECK(fixpoint.value(dead).is_bottom());
+  BOOST_CHECK_EQUAL(fixpoint.cycles, 1);
+  BOOST_CHECK(fixpoint.stats.widenings > 0);
+  BOOST_CHECK(fixpoint.stats.narrowings > 0);
+  BOOST_CHECK_EQUAL(fixpoint.stats.skipped_narrowings, 0);
+  BOOST_CHECK(fixpoint.num_analyzed_nodes() > 0);
+
+  fixpoint.clear();
+  BOOST_CHECK(fixpoint.value(i).is_bottom());
+  BOOST_CHECK_EQUAL(fixpoint.num_analyzed_nodes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(loop_without_widening) {
+  ControlFlowGraph cfg("entry");
+  BasicBlock* entry = cfg.get("entry");
+  BasicBlock* i0 = cfg.get("i0");
+  BasicBlock* i = cfg.get("i");
+  BasicBlock* reset = cfg.get("reset");
+
+  entry->add_successor(i0);
+  i0->add_successor(i);
+  i->add_successor(reset);
+  reset->add_successor(i);
+
+  CounterFixpoint fixpoint(&cfg);
+  fixpoint.run();
+
+  BOOST_CHECK(fixpoint.value(i) == ZInterval(0));
+  BOOST_CHECK(fixpoint.value(reset) == ZInterval(0));
+  BOOST_CHECK_EQUAL(fixpoint.cycles, 1);
+  BOOST_CHECK_EQUAL(fixpoint.stats.widenings, 0);
+  BOOST_CHECK_EQUAL(fixpoint.stats.narrowings, 0);
+  BOOST_CHECK_EQUAL(fixpoint.stats.skipped_narrowings, 1);
+}
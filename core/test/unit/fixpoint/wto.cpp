@@ -0,0 +1,186 @@
+/*******************************************************************************
+ *
+ * Tests for the weak topological order
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#define BOOST_TEST_MODULE test_wto
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <ikos/core/example/muzq.hpp>
+#include <ikos/core/example/variable_factory.hpp>
+#include <ikos/core/fixpoint/wto.hpp>
+
+using namespace ikos::core;
+
+using Variable = example::VariableFactory::VariableRef;
+using BasicBlock = muzq::BasicBlock< Variable >;
+using ControlFlowGraph = muzq::ControlFlowGraph< Variable >;
+using WtoT = Wto< ControlFlowGraph* >;
+using WtoCacheT = WtoCache< ControlFlowGraph* >;
+using WtoVertexT = WtoVertex< ControlFlowGraph* >;
+using WtoCycleT = WtoCycle< ControlFlowGraph* >;
+
+namespace {
+
+/// \brief Print a weak topological order using the basic block names
+class WtoPrinter final : public WtoComponentVisitor< ControlFlowGraph* > {
+private:
+  std::ostringstream _out;
+
+public:
+  void visit(const WtoVertexT& vertex) override {
+    this->separator();
+    this->_out << vertex.node()->name();
+  }
+
+  void visit(const WtoCycleT& cycle) override {
+    this->separator();
+    this->_out << "(" << cycle.head()->name();
+    for (auto it = cycle.begin(); it != cycle.end(); ++it) {
+      it->accept(*this);
+    }
+    this->_out << ")";
+  }
+
+  std::string str() const { return this->_out.str(); }
+
+private:
+  void separator() {
+    std::string s = this->_out.str();
+    if (!s.empty() && s.back() != '(') {
+      this->_out << " ";
+    }
+  }
+};
+
+std::string to_string(WtoT wto) {
+  WtoPrinter printer;
+  wto.accept(printer);
+  return printer.str();
+}
+
+} // end anonymous namespace
+
+BOOST_AUTO_TEST_CASE(simple_loop) {
+  ControlFlowGraph cfg("entry");
+  BasicBlock* entry = cfg.get("entry");
+  BasicBlock* head = cfg.get("head");
+  BasicBlock* body = cfg.get("body");
+  BasicBlock* exit = cfg.get("exit");
+
+  entry->add_successor(head);
+  head->add_successor(body);
+  head->add_successor(exit);
+  body->add_successor(head);
+
+  WtoT wto(&cfg);
+  BOOST_CHECK_EQUAL(to_string(wto), "entry (head body) exit");
+  BOOST_CHECK(wto.nesting(entry) == WtoT::WtoNestingT());
+  BOOST_CHECK(wto.nesting(head) == WtoT::WtoNestingT());
+  BOOST_CHECK(wto.nesting(body) == WtoT::WtoNestingT() + head);
+  BOOST_CHECK(wto.nesting(exit) == WtoT::WtoNestingT());
+}
+
+BOOST_AUTO_TEST_CASE(nested_loops) {
+  ControlFlowGraph cfg("entry");
+  BasicBlock* entry = cfg.get("entry");
+  BasicBlock* outer = cfg.get("outer");
+  BasicBlock* inner = cfg.get("inner");
+  BasicBlock* body = cfg.get("body");
+  BasicBlock* latch = cfg.get("latch");
+  BasicBlock* exit = cfg.get("exit");
+
+  entry->add_successor(outer);
+  outer->add_successor(inner);
+  outer->add_successor(exit);
+  inner->add_successor(body);
+  inner->add_successor(latch);
+  body->add_successor(inner);
+  latch->add_successor(outer);
+
+  WtoT wto(&cfg);
+  BOOST_CHECK_EQUAL(to_string(wto), "entry (outer (inner body) latch) exit");
+  BOOST_CHECK(wto.nesting(body) == WtoT::WtoNestingT() + outer + inner);
+  BOOST_CHECK(wto.nesting(latch) == WtoT::WtoNestingT() + outer);
+}
+
+BOOST_AUTO_TEST_CASE(long_chain) {
+  // The construction must not depend on the call stack size
+  const int n = 200000;
+  ControlFlowGraph cfg("bb0");
+  BasicBlock* prev = cfg.entry();
+  for (int i = 1; i < n; i++) {
+    BasicBlock* bb = cfg.get("bb" + std::to_string(i));
+    prev->add_successor(bb);
+    prev = bb;
+  }
+  prev->add_successor(cfg.entry());
+
+  WtoT wto(&cfg);
+  auto it = wto.begin();
+  BOOST_REQUIRE(it != wto.end());
+  const auto* cycle = dynamic_cast< const WtoCycleT* >(&*it);
+  BOOST_REQUIRE(cycle != nullptr);
+  BOOST_CHECK(cycle->head() == cfg.entry());
+  BOOST_CHECK(++it == wto.end());
+  BOOST_CHECK(wto.nesting(prev) == WtoT::WtoNestingT() + cfg.entry());
+}
+
+BOOST_AUTO_TEST_CASE(cache) {
+  ControlFlowGraph cfg("entry");
+  BasicBlock* entry = cfg.get("entry");
+  BasicBlock* exit = cfg.get("exit");
+  entry->add_successor(exit);
+
+  WtoCacheT cache;
+  WtoT first = cache.get(&cfg);
+  WtoT second = cache.get(&cfg);
+  BOOST_CHECK(first.begin() == second.begin());
+  BOOST_CHECK_EQUAL(to_string(second), "entry exit");
+
+  exit->add_successor(entry);
+  cache.invalidate(&cfg);
+  BOOST_CHECK_EQUAL(to_string(cache.get(&cfg)), "(entry exit)");
+}
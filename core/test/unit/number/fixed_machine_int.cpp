@@ -0,0 +1,126 @@
+/*******************************************************************************
+ *
+ * Tests for FixedMachineInt
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#define BOOST_TEST_MODULE test_fixed_machine_integer
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/number/fixed_machine_int.hpp>
+
+using Int = ikos::core::MachineInt;
+using ikos::core::FixedMachineInt;
+using ikos::core::Signed;
+using ikos::core::Unsigned;
+
+using SInt8 = FixedMachineInt< 8, Signed >;
+using UInt8 = FixedMachineInt< 8, Unsigned >;
+using SInt64 = FixedMachineInt< 64, Signed >;
+using UInt64 = FixedMachineInt< 64, Unsigned >;
+
+BOOST_AUTO_TEST_CASE(test_limits) {
+  BOOST_CHECK(SInt8::min().to_int64() == -128);
+  BOOST_CHECK(SInt8::max().to_int64() == 127);
+  BOOST_CHECK(UInt8::min().to_int64() == 0);
+  BOOST_CHECK(UInt8::max().to_int64() == 255);
+  BOOST_CHECK(SInt64::min().to_int64() ==
+              std::numeric_limits< int64_t >::min());
+  BOOST_CHECK(SInt64::max().to_int64() ==
+              std::numeric_limits< int64_t >::max());
+  BOOST_CHECK(!UInt64::max().fits_int64());
+  BOOST_CHECK((FixedMachineInt< 1, Signed >::min().to_int64() == -1));
+  BOOST_CHECK((FixedMachineInt< 1, Signed >::max().to_int64() == 0));
+
+  static_assert(SInt8::min() < SInt8::max(), "");
+  static_assert(UInt8::min() < UInt8::max(), "");
+}
+
+BOOST_AUTO_TEST_CASE(test_conversions) {
+  BOOST_CHECK(SInt8(Int(-3, 8, Signed)).to_int64() == -3);
+  BOOST_CHECK(UInt8(Int(250, 8, Unsigned)).to_int64() == 250);
+  BOOST_CHECK(SInt8::wrap(200).to_machine_int() == Int(-56, 8, Signed));
+  BOOST_CHECK(UInt8::wrap(-1).to_machine_int() == Int(255, 8, Unsigned));
+  BOOST_CHECK(UInt64(Int::max(64, Unsigned)).to_machine_int() ==
+              Int::max(64, Unsigned));
+  BOOST_CHECK(SInt64(Int::min(64, Signed)).to_machine_int() ==
+              Int::min(64, Signed));
+
+  BOOST_CHECK(SInt8::fits(-128));
+  BOOST_CHECK(!SInt8::fits(128));
+  BOOST_CHECK(UInt8::fits(255));
+  BOOST_CHECK(!UInt8::fits(-1));
+  BOOST_CHECK(SInt64::fits(std::numeric_limits< int64_t >::min()));
+  BOOST_CHECK(!UInt64::fits(-1));
+}
+
+BOOST_AUTO_TEST_CASE(test_operators) {
+  // Operations wrap like MachineInt
+  for (int a = -128; a < 128; a += 7) {
+    for (int b = -128; b < 128; b += 5) {
+      Int x(a, 8, Signed), y(b, 8, Signed);
+      SInt8 fx(x), fy(y);
+      BOOST_CHECK((fx + fy).to_machine_int() == x + y);
+      BOOST_CHECK((fx - fy).to_machine_int() == x - y);
+      BOOST_CHECK((fx * fy).to_machine_int() == x * y);
+      BOOST_CHECK((fx & fy).to_machine_int() == (x & y));
+      BOOST_CHECK((fx | fy).to_machine_int() == (x | y));
+      BOOST_CHECK((fx ^ fy).to_machine_int() == (x ^ y));
+      BOOST_CHECK((fx < fy) == (x < y));
+      BOOST_CHECK((fx <= fy) == (x <= y));
+      BOOST_CHECK((fx == fy) == (x == y));
+
+      Int ux(a, 8, Unsigned), uy(b, 8, Unsigned);
+      UInt8 fux(ux), fuy(uy);
+      BOOST_CHECK((fux + fuy).to_machine_int() == ux + uy);
+      BOOST_CHECK((fux * fuy).to_machine_int() == ux * uy);
+      BOOST_CHECK((fux < fuy) == (ux < uy));
+      BOOST_CHECK((fux >= fuy) == (ux >= uy));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_dispatch) {
+  auto width = [](auto w) { return decltype(w)::bit_width; };
+  BOOST_CHECK(ikos::core::dispatch_fixed_width(32, Signed, width, 0u) == 32);
+  BOOST_CHECK(ikos::core::dispatch_fixed_width(1, Unsigned, width, 0u) == 1);
+  BOOST_CHECK(ikos::core::dispatch_fixed_width(24, Signed, width, 0u) == 0);
+  BOOST_CHECK(ikos::core::dispatch_fixed_width(128, Unsigned, width, 0u) == 0);
+}
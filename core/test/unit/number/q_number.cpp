@@ -42,6 +42,10 @@
 
 #define BOOST_TEST_MODULE test_q_number
 #define BOOST_TEST_DYN_LINK
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 #include <boost/mpl/list.hpp>
 #include <boost/test/output_test_stream.hpp>
 #include <boost/test/unit_test.hpp>
@@ -345,3 +349,59 @@ BOOST_AUTO_TEST_CASE(test_q_number) {
   output << Q(1, 2);
   BOOST_CHECK(output.is_equal("1/2"));
 }
+
+BOOST_AUTO_TEST_CASE(test_q_number_overflow) {
+  using Z = ikos::core::ZNumber;
+  using Q = ikos::core::QNumber;
+
+  const int64_t max = std::numeric_limits< int64_t >::max();
+  const int64_t min = std::numeric_limits< int64_t >::min();
+
+  std::vector< Q > values = {Q(0),
+                             Q(1),
+                             Q(-1),
+                             Q(1, 3),
+                             Q(-7, 12),
+                             Q(max),
+                             Q(min),
+                             Q(max - 1),
+                             Q(min + 1),
+                             Q(1, max),
+                             Q(-1, max),
+                             Q(max, max - 1),
+                             Q(min, 3),
+                             Q(3, min),
+                             Q(Z(max) * 4, Z(3)),
+                             Q(Z(1), Z(max) * 2)};
+
+  for (const Q& x : values) {
+    for (const Q& y : values) {
+      mpq_class a = x.mpq();
+      mpq_class b = y.mpq();
+      BOOST_CHECK((x + y).mpq() == a + b);
+      BOOST_CHECK((x - y).mpq() == a - b);
+      BOOST_CHECK((x * y).mpq() == a * b);
+      if (y != 0) {
+        BOOST_CHECK((x / y).mpq() == a / b);
+      }
+      BOOST_CHECK((x == y) == (a == b));
+      BOOST_CHECK((x < y) == (a < b));
+      BOOST_CHECK((x <= y) == (a <= b));
+
+      // The representation is canonical
+      Q z = (x + y) - y;
+      BOOST_CHECK((z == x));
+      BOOST_CHECK((hash_value(z) == hash_value(x)));
+    }
+    BOOST_CHECK((-x).mpq() == -x.mpq());
+    BOOST_CHECK(abs(x).mpq() == abs(x.mpq()));
+    BOOST_CHECK((Q::from_string(x.str()) == x));
+  }
+
+  BOOST_CHECK((Q(min, -1) == Q(Z(max) + 1)));
+  BOOST_CHECK((-Q(min) == Q(Z(max) + 1)));
+  BOOST_CHECK((Q(max) + 1 == Q(Z(max) + 1)));
+  BOOST_CHECK((Q(min, 2) == Q(min / 2)));
+  BOOST_CHECK((Q(min + 1, 2).round_to_lower() == Z(min / 2)));
+  BOOST_CHECK((Q(min + 1, 2).round_to_upper() == Z(min / 2 + 1)));
+}
@@ -595,3 +595,75 @@ BOOST_AUTO_TEST_CASE(test_z_number) {
   output << Z(42);
   BOOST_CHECK(output.is_equal("42"));
 }
+
+BOOST_AUTO_TEST_CASE(test_z_number_int64_overflow) {
+  using Z = ikos::core::ZNumber;
+
+  const Z min(std::numeric_limits< int64_t >::min());
+  const Z max(std::numeric_limits< int64_t >::max());
+  const Z two_63 = Z(1) << 63;
+
+  // arithmetic crossing the int64_t bounds
+  BOOST_CHECK(max + 1 == two_63);
+  BOOST_CHECK(min - 1 == -two_63 - 1);
+  BOOST_CHECK(max * 2 == (Z(1) << 64) - 2);
+  BOOST_CHECK(min * -1 == two_63);
+  BOOST_CHECK(min / -1 == two_63);
+  BOOST_CHECK(min % -1 == 0);
+  BOOST_CHECK(-min == two_63);
+  BOOST_CHECK(abs(min) == two_63);
+  BOOST_CHECK(Z(1) << 62 << 1 == two_63);
+  BOOST_CHECK(Z(-1) << 63 == min);
+  BOOST_CHECK(Z(-1) << 64 == -(Z(1) << 64));
+  BOOST_CHECK(Z(-1) >> 100 == -1);
+  BOOST_CHECK(Z(1) >> 100 == 0);
+
+  // increment and decrement
+  Z n = max;
+  ++n;
+  BOOST_CHECK(n == two_63);
+  --n;
+  BOOST_CHECK(n == max);
+  n = min;
+  --n;
+  BOOST_CHECK(n == -two_63 - 1);
+  ++n;
+  BOOST_CHECK(n == min);
+
+  // results coming back in the int64_t range
+  BOOST_CHECK(two_63 - 1 == max);
+  BOOST_CHECK((two_63 * 4) / 8 == Z(1) << 62);
+  BOOST_CHECK(hash_value(two_63 - 1) == hash_value(max));
+  BOOST_CHECK(hash_value((two_63 * 2) >> 1) == hash_value(two_63));
+
+  // comparisons between inline and GMP representations
+  BOOST_CHECK(max < two_63);
+  BOOST_CHECK(min > -two_63 - 1);
+  BOOST_CHECK(Z(0) < two_63);
+  BOOST_CHECK(Z(0) > -two_63 - 1);
+  BOOST_CHECK(two_63 != max);
+
+  // utility functions
+  BOOST_CHECK(mod(min, Z(7)) == 6);
+  BOOST_CHECK(mod(Z(-7), min) == two_63 - 7);
+  BOOST_CHECK(gcd(min, min) == two_63);
+  BOOST_CHECK(gcd(min, Z(0)) == two_63);
+  BOOST_CHECK(lcm(max, Z(2)) == max * 2);
+  BOOST_CHECK(lcm(Z(-4), Z(6)) == 12);
+
+  // value tests
+  BOOST_CHECK(min.trailing_zeros() == 63);
+  BOOST_CHECK(max.trailing_ones() == 63);
+  BOOST_CHECK(min.size_in_bits() == 64);
+  BOOST_CHECK(max.size_in_bits() == 63);
+  BOOST_CHECK(max.next_power_of_2() == two_63);
+
+  // conversions
+  BOOST_CHECK(two_63.fits< unsigned long long >());
+  BOOST_CHECK(!two_63.fits< long long >());
+  BOOST_CHECK(min.fits< long long >());
+  BOOST_CHECK(!min.fits< unsigned long long >());
+  BOOST_CHECK(two_63.str() == "9223372036854775808");
+  BOOST_CHECK(min.str() == "-9223372036854775808");
+  BOOST_CHECK(Z(-255).str(16) == "-ff");
+}
@@ -42,6 +42,8 @@
 
 #define BOOST_TEST_MODULE test_machine_integer_interval
 #define BOOST_TEST_DYN_LINK
+#include <vector>
+
 #include <boost/mpl/list.hpp>
 #include <boost/test/output_test_stream.hpp>
 #include <boost/test/unit_test.hpp>
@@ -3710,3 +3712,69 @@ BOOST_AUTO_TEST_CASE(test_widening_threshold) {
                               Int(257, 32, Unsigned)) ==
       Interval(Int(0, 8, Signed), Int(127, 8, Signed)));
 }
+
+BOOST_AUTO_TEST_CASE(test_fixed_width) {
+  // Arithmetic on common bit-widths is computed without ZNumber, check it
+  // against the generic implementation
+  using WrapTag = Interval::WrapTag;
+  using TruncTag = Interval::TruncTag;
+
+  for (unsigned bit_width : {1u, 8u, 64u}) {
+    for (auto sign : {Signed, Unsigned}) {
+      Int one(1, bit_width, sign);
+      std::vector< Int > values = {Int::min(bit_width, sign),
+                                   Int::min(bit_width, sign) + one,
+                                   Int::max(bit_width, sign),
+                                   Int::max(bit_width, sign) - one,
+                                   Int(0, bit_width, sign),
+                                   one,
+                                   -one,
+                                   Int(3, bit_width, sign),
+                                   Int(100, bit_width, sign)};
+      std::vector< Interval > intervals;
+      for (const Int& lb : values) {
+        for (const Int& ub : values) {
+          if (lb <= ub) {
+            intervals.emplace_back(lb, ub);
+          }
+        }
+      }
+
+      for (const Interval& x : intervals) {
+        for (const Interval& y : intervals) {
+          ZInterval zx = x.to_z_interval(), zy = y.to_z_interval();
+          BOOST_CHECK(add(x, y) ==
+                      Interval::from_z_interval(zx + zy,
+                                                bit_width,
+                                                sign,
+                                                WrapTag{}));
+          BOOST_CHECK(add_no_wrap(x, y) ==
+                      Interval::from_z_interval(zx + zy,
+                                                bit_width,
+                                                sign,
+                                                TruncTag{}));
+          BOOST_CHECK(sub(x, y) ==
+                      Interval::from_z_interval(zx - zy,
+                                                bit_width,
+                                                sign,
+                                                WrapTag{}));
+          BOOST_CHECK(sub_no_wrap(x, y) ==
+                      Interval::from_z_interval(zx - zy,
+                                                bit_width,
+                                                sign,
+                                                TruncTag{}));
+          BOOST_CHECK(mul(x, y) ==
+                      Interval::from_z_interval(zx * zy,
+                                                bit_width,
+                                                sign,
+                                                WrapTag{}));
+          BOOST_CHECK(mul_no_wrap(x, y) ==
+                      Interval::from_z_interval(zx * zy,
+                                                bit_width,
+                                                sign,
+                                                TruncTag{}));
+        }
+      }
+    }
+  }
+}
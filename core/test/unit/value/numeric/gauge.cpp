@@ -100,6 +100,17 @@ BOOST_AUTO_TEST_CASE(gauge_bound_constructors) {
   g = g + GaugeBound(2, x);
   g = g + GaugeBound(3, y);
   test_gauge_bound(g, false, false, false, 2, false, 0);
+
+  // Coefficients equal to zero are removed
+  test_gauge_bound(GaugeBound(0, x), false, false, false, 0, true, 0);
+  test_gauge_bound(g - GaugeBound(2, x), false, false, false, 1, false, 0);
+  test_gauge_bound(g - GaugeBound(2, x) - GaugeBound(3, y),
+                   false,
+                   false,
+                   false,
+                   0,
+                   true,
+                   1);
 }
 
 #define test_gauge_bound_coeff(g, v, c) BOOST_CHECK((g).coeff(v) == c)
@@ -43,6 +43,9 @@
 
 #pragma once
 
+#include <string>
+
+#include <llvm/ADT/ArrayRef.h>
 #include <llvm/IR/Module.h>
 
 #include <ikos/ar/semantic/bundle.hpp>
@@ -56,6 +59,18 @@ namespace import {
 /// \brief Check if the given module has debug information
 bool has_debug_info(llvm::Module&);
 
+/// \brief Materialize the functions reachable from the given entry points
+///
+/// This is meant for modules loaded lazily (see llvm::getLazyIRModule).
+/// Functions referenced by global variable initializers, such as
+/// llvm.global_ctors, are also considered reachable. The other functions are
+/// left unmaterialized, and the Importer translates them as external
+/// functions.
+///
+/// \throws ImportError on errors
+void materialize_reachable_functions(
+    llvm::Module&, llvm::ArrayRef< std::string > entry_points);
+
 /// \brief Import from LLVM to AR
 class Importer {
 public:
@@ -96,9 +111,15 @@ private:
   // AR Context
   ar::Context& _context;
 
+  // Number of threads used to translate function bodies
+  unsigned _jobs;
+
 public:
   /// \brief Public constructor
-  explicit Importer(ar::Context& ctx) : _context(ctx) {}
+  ///
+  /// \param jobs Number of threads used to translate function bodies
+  explicit Importer(ar::Context& ctx, unsigned jobs = 1)
+      : _context(ctx), _jobs(jobs) {}
 
   /// \brief Default copy constructor
   Importer(const Importer&) = default;
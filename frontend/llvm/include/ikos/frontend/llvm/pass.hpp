@@ -43,6 +43,10 @@
 
 #pragma once
 
+#include <string>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/IR/LegacyPassManager.h>
 #include <llvm/Pass.h>
 #include <llvm/PassRegistry.h>
 
@@ -76,6 +80,32 @@ llvm::FunctionPass* createRemoveUnreachableBlocksPass();
 /// \brief Initialize all passes linked into the ikos-pp library
 void initializeIkosPasses(llvm::PassRegistry&);
 
+/// \brief Optimization level of the preprocessing pipeline
+enum class OptLevel {
+  /// \brief Only passes required for the translation to AR
+  None,
+
+  /// \brief Basic set of optimizations
+  Basic,
+
+  /// \brief Aggressive optimizations
+  Aggressive,
+};
+
+/// \brief Add the passes of the preprocessing pipeline of ikos-pp
+///
+/// \param entry_points Program entry points. With the aggressive level, or
+/// with `internalize`, other functions are internalized. Defaults to `main`,
+/// `*` keeps all functions.
+/// \param inline_all Inline all functions, with the aggressive level
+/// \param internalize Internalize the functions and global variables other
+/// than the entry points and remove the dead ones, with the basic level
+void addPreprocessingPasses(llvm::legacy::PassManagerBase& pass_manager,
+                            OptLevel opt_level,
+                            llvm::ArrayRef< std::string > entry_points,
+                            bool inline_all,
+                            bool internalize = false);
+
 } // end namespace pass
 } // end namespace frontend
 } // end namespace ikos
@@ -151,6 +151,10 @@ int main(int argc, char** argv) {
   // LLVM context
   llvm::LLVMContext llvm_context;
 
+  // Merge the debug info types sharing the same ODR identifier, so that the
+  // C++ types defined in several translation units are only imported once
+  llvm_context.enableDebugTypeODRUniquing();
+
   /*
    * Parse parameters
    */
@@ -42,9 +42,11 @@
  *
  ******************************************************************************/
 
+#include <string>
+#include <vector>
+
 #include <boost/filesystem.hpp>
 
-#include <llvm/ADT/StringSet.h>
 #include <llvm/Bitcode/BitcodeWriterPass.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/LegacyPassManager.h>
@@ -61,7 +63,6 @@
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Support/raw_ostream.h>
-#include <llvm/Transforms/IPO.h>
 
 #include <ikos/frontend/llvm/pass.hpp>
 
@@ -90,6 +91,12 @@ static llvm::cl::list< std::string > EntryPoints(
 static llvm::cl::opt< bool > InlineAll("inline-all",
                                        llvm::cl::desc("Inline all functions"));
 
+static llvm::cl::opt< bool > Internalize(
+    "internalize",
+    llvm::cl::desc("Internalize everything but the entry points, and remove "
+                   "the dead functions and global variables (always done "
+                   "with -opt=aggressive)"));
+
 static llvm::cl::opt< bool > NoVerify(
     "disable-verify", llvm::cl::desc("Do not run the verifier"));
 
@@ -233,209 +240,7 @@ int main(int argc, char** argv) {
 
   llvm::legacy::PassManager pass_manager;
 
-  if (OptLevel == None) {
-    // Remove switch constructions (opt -lowerswitch)
-    pass_manager.add(llvm::createLowerSwitchPass());
-
-    // Lower down atomic instructions (opt -loweratomic)
-    pass_manager.add(llvm::createLowerAtomicPass());
-
-    // Lower constant expressions to instructions (ikos-pp -lower-cst-expr)
-    pass_manager.add(ikos_pp::createLowerCstExprPass());
-
-    // Lower down select instructions (ikos-pp -lower-select)
-    pass_manager.add(ikos_pp::createLowerSelectPass());
-
-    // Ensure one single exit point per function (opt -mergereturn)
-    pass_manager.add(llvm::createUnifyFunctionExitNodesPass());
-  } else if (OptLevel == Basic) {
-    // SSA (opt -mem2reg)
-    pass_manager.add(llvm::createPromoteMemoryToRegisterPass());
-
-    // MarkNoReturnFunctions only insert unreachable instructions if
-    // the function does not have an exit block
-    pass_manager.add(ikos_pp::createMarkNoReturnFunctionPass());
-
-    // Global dead code elimination (opt -globaldce)
-    // note: unfortunately, it removes some debug info about global variables
-    pass_manager.add(llvm::createGlobalDCEPass());
-
-    // Dead code elimination (opt -dce)
-    pass_manager.add(llvm::createDeadCodeEliminationPass());
-
-    // Remove unreachable blocks also dead cycles
-    pass_manager.add(ikos_pp::createRemoveUnreachableBlocksPass());
-
-    // Remove switch constructions (opt -lowerswitch)
-    pass_manager.add(llvm::createLowerSwitchPass());
-
-    // Lower down atomic instructions (opt -loweratomic)
-    pass_manager.add(llvm::createLowerAtomicPass());
-
-    // Lower constant expressions to instructions (ikos-pp -lower-cst-expr)
-    pass_manager.add(ikos_pp::createLowerCstExprPass());
-
-    // Dead code elimination (opt -dce)
-    pass_manager.add(llvm::createDeadCodeEliminationPass());
-
-    // Lower down select instructions (ikos-pp -lower-select)
-    pass_manager.add(ikos_pp::createLowerSelectPass());
-
-    // Ensure one single exit point per function (opt -mergereturn)
-    pass_manager.add(llvm::createUnifyFunctionExitNodesPass());
-  } else if (OptLevel == Aggressive) {
-    // Turn all functions internal so that we can apply some global
-    // optimizations inline them if requested (opt -internalize)
-    llvm::StringSet<> exclude_set;
-    if (EntryPoints.empty()) {
-      exclude_set.insert("main");
-    } else {
-      for (const auto& entry_point : EntryPoints) {
-        exclude_set.insert(entry_point);
-      }
-    }
-    if (exclude_set.count("*") == 0) {
-      pass_manager.add(
-          llvm::createInternalizePass([=](const llvm::GlobalValue& gv) {
-            return exclude_set.find(gv.getName()) != exclude_set.end();
-          }));
-    }
-
-    // Kill unused internal global (opt -globaldce)
-    // note: unfortunately, it removes some debug info about global variables
-    pass_manager.add(llvm::createGlobalDCEPass());
-
-    // Remove unreachable blocks
-    pass_manager.add(ikos_pp::createRemoveUnreachableBlocksPass());
-
-    // Global optimizations (opt -globalopt)
-    pass_manager.add(llvm::createGlobalOptimizerPass());
-
-    // SSA (opt -mem2reg)
-    pass_manager.add(llvm::createPromoteMemoryToRegisterPass());
-
-    // Cleanup after SSA (opt -instcombine)
-    // disabled, bad for static analysis
-    // pass_manager.add(llvm::createInstructionCombiningPass());
-
-    // Simplification (opt -simplifycfg)
-    pass_manager.add(llvm::createCFGSimplificationPass());
-
-    // Break aggregates (opt -sroa)
-    pass_manager.add(llvm::createSROAPass());
-
-    // Global value numbering and redundant load elimination (opt -gvn)
-    // note: unfortunately, it removes some debug information
-    pass_manager.add(llvm::createGVNPass());
-
-    // Cleanup after breaking aggregates (opt -instcombine)
-    // (bad for static analysis)
-    pass_manager.add(llvm::createInstructionCombiningPass());
-
-    // Global dead code elimination (opt -globaldce)
-    pass_manager.add(llvm::createGlobalDCEPass());
-
-    // Simplification (opt -simplifycfg)
-    pass_manager.add(llvm::createCFGSimplificationPass());
-
-    // Jump threading (opt -jump-threading)
-    // (conditional) constant propagation always help analyzers
-    pass_manager.add(llvm::createJumpThreadingPass());
-
-    // Sparse conditional constant propagation (opt -sccp)
-    pass_manager.add(llvm::createSCCPPass());
-
-    // Dead code elimination (opt -dce)
-    pass_manager.add(llvm::createDeadCodeEliminationPass());
-
-    // Lower invoke's (opt -lowerinvoke)
-    pass_manager.add(llvm::createLowerInvokePass());
-
-    // Cleanup after lowering invoke's (opt -simplifycfg)
-    pass_manager.add(llvm::createCFGSimplificationPass());
-
-    if (InlineAll) {
-      // Mark all functions always_inline (ikos-pp -mark-internal-inline)
-      pass_manager.add(ikos_pp::createMarkInternalInlinePass());
-
-      // Inline always_inline functions (opt -always-inline)
-      pass_manager.add(llvm::createAlwaysInlinerLegacyPass());
-
-      // Kill unused internal global (opt -globaldce)
-      pass_manager.add(llvm::createGlobalDCEPass());
-    }
-
-    // Remove unreachable blocks
-    pass_manager.add(ikos_pp::createRemoveUnreachableBlocksPass());
-
-    // Dead instruction elimination (opt -die)
-    pass_manager.add(llvm::createDeadInstEliminationPass());
-
-    // Canonical form for loops (opt -loop-simplify)
-    pass_manager.add(llvm::createLoopSimplifyPass());
-
-    // Cleanup unnecessary blocks (opt -simplifycfg)
-    pass_manager.add(llvm::createCFGSimplificationPass());
-
-    // Loop-closed SSA (opt -lcssa)
-    pass_manager.add(llvm::createLCSSAPass());
-
-    // Loop invariant code motion (opt -licm)
-    pass_manager.add(llvm::createLICMPass());
-
-    // SSA (opt -mem2reg)
-    pass_manager.add(llvm::createPromoteMemoryToRegisterPass());
-
-    // Dead loop elimination (opt -loop-deletion)
-    pass_manager.add(llvm::createLoopDeletionPass());
-
-    // Cleanup unnecessary blocks (opt -simplifycfg)
-    pass_manager.add(llvm::createCFGSimplificationPass());
-
-    // MarkNoReturnFunctions only insert unreachable instructions if
-    // the function does not have an exit block.
-    pass_manager.add(ikos_pp::createMarkNoReturnFunctionPass());
-
-    // Global dead code elimination (opt -globaldce)
-    pass_manager.add(llvm::createGlobalDCEPass());
-
-    // Dead code elimination (opt -dce)
-    pass_manager.add(llvm::createDeadCodeEliminationPass());
-
-    // Remove unreachable blocks also dead cycles
-    pass_manager.add(ikos_pp::createRemoveUnreachableBlocksPass());
-
-    // Remove switch constructions (opt -lowerswitch)
-    pass_manager.add(llvm::createLowerSwitchPass());
-
-    // Lower down atomic instructions (opt -loweratomic)
-    pass_manager.add(llvm::createLowerAtomicPass());
-
-    // Lower constant expressions to instructions (ikos-pp -lower-cst-expr)
-    pass_manager.add(ikos_pp::createLowerCstExprPass());
-
-    // Dead code elimination (opt -dce)
-    pass_manager.add(llvm::createDeadCodeEliminationPass());
-
-    // After lowering constant expressions we remove all
-    // side-effect-free printf-like functions. This can trigger the
-    // removal of global strings that only feed them.
-    pass_manager.add(ikos_pp::createRemovePrintfCallsPass());
-
-    // Dead code elimination (opt -dce)
-    pass_manager.add(llvm::createDeadCodeEliminationPass());
-
-    // Global dead code elimination (opt -globaldce)
-    pass_manager.add(llvm::createGlobalDCEPass());
-
-    // Lower down select instructions (ikos-pp -lower-select)
-    pass_manager.add(ikos_pp::createLowerSelectPass());
-
-    // Ensure one single exit point per function (opt -mergereturn)
-    pass_manager.add(llvm::createUnifyFunctionExitNodesPass());
-  } else {
-    assert(OptLevel == Custom);
-
+  if (OptLevel == Custom) {
     for (unsigned i = 0; i < CustomPassList.size(); ++i) {
       const llvm::PassInfo* pass_info = CustomPassList[i];
 
@@ -448,6 +253,21 @@ int main(int argc, char** argv) {
                      << "\n";
       }
     }
+  } else {
+    ikos_pp::OptLevel opt_level = ikos_pp::OptLevel::Basic;
+    if (OptLevel == None) {
+      opt_level = ikos_pp::OptLevel::None;
+    } else if (OptLevel == Aggressive) {
+      opt_level = ikos_pp::OptLevel::Aggressive;
+    }
+
+    std::vector< std::string > entry_points(EntryPoints.begin(),
+                                            EntryPoints.end());
+    ikos_pp::addPreprocessingPasses(pass_manager,
+                                    opt_level,
+                                    entry_points,
+                                    InlineAll,
+                                    Internalize);
   }
 
   // Check that the module is well formed on completion of optimization
@@ -61,6 +61,7 @@ namespace import {
 
 ar::GlobalVariable* BundleImporter::translate_global_variable(
     llvm::GlobalVariable* gv) {
+  std::lock_guard< std::recursive_mutex > lock(_ctx.mutex);
   auto it = this->_globals.find(gv);
 
   if (it != this->_globals.end()) {
@@ -134,6 +135,7 @@ ar::Code* BundleImporter::translate_global_variable_initializer(
 
   // Initialize the ar::Code initializer
   ar::Code* init = ar_gv->initializer();
+  ar::Code::ArenaScope arena_scope(init);
   ar::BasicBlock* bb = ar::BasicBlock::create(init);
   init->set_entry_block(bb);
   init->set_exit_block(bb);
@@ -151,6 +153,7 @@ ar::Code* BundleImporter::translate_global_variable_initializer(
 }
 
 ar::Function* BundleImporter::translate_function(llvm::Function* fun) {
+  std::lock_guard< std::recursive_mutex > lock(_ctx.mutex);
   auto it = this->_functions.find(fun);
 
   if (it != this->_functions.end()) {
@@ -167,7 +170,10 @@ ar::Function* BundleImporter::translate_function(llvm::Function* fun) {
   llvm::DISubprogram* dbg = fun->getSubprogram();
 
   ar::Function* ar_fun = nullptr;
-  if (dbg != nullptr) {
+  if (fun->isMaterializable()) {
+    // Body not loaded, unreachable from the entry points
+    ar_fun = this->translate_unmaterialized_function(fun);
+  } else if (dbg != nullptr) {
     // Debug information available
     ar_fun = this->translate_function_di(fun, dbg);
   } else if (fun->isDeclaration()) {
@@ -191,6 +197,18 @@ ar::Function* BundleImporter::translate_function(llvm::Function* fun) {
   return ar_fun;
 }
 
+ar::Function* BundleImporter::translate_unmaterialized_function(
+    llvm::Function* fun) {
+  // Debug information is only loaded with the body, prefer signed integers
+  auto ar_type = ar::cast< ar::FunctionType >(
+      _ctx.type_imp->translate_type(fun->getFunctionType(), ar::Signed));
+
+  return ar::Function::create(this->_bundle,
+                              ar_type,
+                              fun->getName().str(),
+                              /*is_definition = */ false);
+}
+
 ar::Function* BundleImporter::translate_function_di(llvm::Function* fun,
                                                     llvm::DISubprogram* dbg) {
   ikos_assert_msg(dbg != nullptr, "no debug info");
@@ -109,6 +109,10 @@ public:
   ar::Function* translate_function(llvm::Function*);
 
 private:
+  /// \brief Translate a llvm::Function* that is not materialized into an
+  /// external ar::Function*
+  ar::Function* translate_unmaterialized_function(llvm::Function*);
+
   /// \brief Translate a llvm::Function* with debug info into an ar::Function*
   ar::Function* translate_function_di(llvm::Function*, llvm::DISubprogram*);
 
@@ -145,6 +149,9 @@ private:
 
 public:
   /// \brief Translate the body of a llvm::Function* into an ar::Code*
+  ///
+  /// This can be called concurrently on different functions, once all
+  /// functions and global variables have been translated.
   ar::Code* translate_function_body(llvm::Function*);
 
 }; // end class BundleImporter
@@ -83,6 +83,8 @@ static ar::MachineInt to_machine_int(const llvm::APInt& n,
 ar::Value* ConstantImporter::translate_constant(llvm::Constant* cst,
                                                 ar::Type* type,
                                                 ar::BasicBlock* bb) {
+  std::lock_guard< std::recursive_mutex > lock(_ctx.mutex);
+
   // List of constant expressions to handle
   llvm::SmallVector< ConstantExpression, 4 > exprs;
 
@@ -294,13 +296,32 @@ ar::VectorConstant* ConstantImporter::translate_constant_vector(
   return ar::VectorConstant::get(this->_context, type, values);
 }
 
-ar::ArrayConstant* ConstantImporter::translate_constant_data_array(
+ar::Constant* ConstantImporter::translate_constant_data_array(
     llvm::ConstantDataArray* cst,
     ar::ArrayType* type,
     ar::BasicBlock* bb,
     ConstantExpressionList& exprs) {
-  ar::ArrayConstant::Values values;
   ikos_assert(cst->getNumElements() == type->num_elements());
+
+  if (cst->getElementType()->isIntegerTy() &&
+      type->element_type()->is_integer()) {
+    // Store the elements as raw data, in little-endian order
+    auto element_type = ar::cast< ar::IntegerType >(type->element_type());
+    std::size_t element_size = (element_type->bit_width() + 7) / 8;
+    std::string data;
+    data.reserve(cst->getNumElements() * element_size);
+
+    for (unsigned i = 0; i < cst->getNumElements(); i++) {
+      uint64_t element = cst->getElementAsInteger(i);
+      for (std::size_t j = 0; j < element_size; j++) {
+        data.push_back(static_cast< char >((element >> (8 * j)) & 0xff));
+      }
+    }
+
+    return ar::DataArrayConstant::get(this->_context, type, data);
+  }
+
+  ar::ArrayConstant::Values values;
   values.reserve(cst->getNumElements());
 
   for (unsigned i = 0; i < cst->getNumElements(); i++) {
@@ -563,6 +584,7 @@ std::unique_ptr< ar::UnaryOperation > ConstantImporter::translate_ptrtoint(
 ar::Value* ConstantImporter::translate_cast_integer_constant(
     llvm::Constant* cst, ar::IntegerType* type) {
   ikos_assert(type != nullptr);
+  std::lock_guard< std::recursive_mutex > lock(_ctx.mutex);
 
   auto it = this->_constants.find({cst, type});
 
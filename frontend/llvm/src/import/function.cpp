@@ -66,6 +66,9 @@ namespace frontend {
 namespace import {
 
 ar::Code* FunctionImporter::translate_body() {
+  // Allocate statements contiguously, in program order
+  ar::Code::ArenaScope arena_scope(this->_body);
+
   // Translate parameters
   this->translate_parameters();
 
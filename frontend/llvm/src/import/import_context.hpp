@@ -43,6 +43,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include <llvm/IR/DataLayout.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
@@ -104,6 +106,12 @@ public:
   /// \brief Helper class to translate global values and functions
   BundleImporter* bundle_imp;
 
+  /// \brief Mutex protecting the helpers above
+  ///
+  /// Function bodies can be translated in parallel, see Importer. This is a
+  /// recursive mutex because helpers call each other.
+  std::recursive_mutex mutex;
+
 public:
   /// \brief Create an ImportContext
   ImportContext(llvm::Module& module_, ar::Bundle* bundle_, ImportOptions opts_)
@@ -43,13 +43,22 @@
  *
  ******************************************************************************/
 
+#include <algorithm>
+#include <vector>
+
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/GlobalVariable.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/TypeFinder.h>
 
 #include <ikos/core/support/assert.hpp>
 
 #include <ikos/ar/semantic/bundle.hpp>
+#include <ikos/ar/support/parallel.hpp>
 
 #include <ikos/frontend/llvm/import.hpp>
 
@@ -70,8 +79,114 @@ bool has_debug_info(llvm::Module& m) {
   return m.debug_compile_units_begin() != m.debug_compile_units_end();
 }
 
+// materialize_reachable_functions
+
+namespace {
+
+/// \brief Helper to materialize the functions reachable from entry points
+class ReachableMaterializer {
+private:
+  // Visited constants, including functions
+  llvm::DenseSet< const llvm::Constant* > _visited;
+
+  // Functions to materialize
+  llvm::SmallVector< llvm::Function*, 16 > _worklist;
+
+public:
+  /// \brief Add the functions referenced by the given value
+  void visit(llvm::Value* value) {
+    auto cst = llvm::dyn_cast< llvm::Constant >(value);
+    if (cst == nullptr || !this->_visited.insert(cst).second) {
+      return;
+    }
+    if (auto fun = llvm::dyn_cast< llvm::Function >(cst)) {
+      this->_worklist.push_back(fun);
+      return;
+    }
+    // Also handles global variable initializers and aliasees
+    for (llvm::Value* op : cst->operand_values()) {
+      this->visit(op);
+    }
+  }
+
+  /// \brief Materialize the reachable functions
+  void run() {
+    while (!this->_worklist.empty()) {
+      llvm::Function* fun = this->_worklist.pop_back_val();
+
+      if (llvm::Error err = fun->materialize()) {
+        throw ImportError("could not materialize llvm function " +
+                          fun->getName().str() + ": " +
+                          llvm::toString(std::move(err)));
+      }
+
+      // Personality, prefix and prologue
+      for (llvm::Value* op : fun->operand_values()) {
+        this->visit(op);
+      }
+
+      for (llvm::BasicBlock& bb : *fun) {
+        for (llvm::Instruction& inst : bb) {
+          for (llvm::Value* op : inst.operand_values()) {
+            this->visit(op);
+          }
+        }
+      }
+    }
+  }
+
+}; // end class ReachableMaterializer
+
+} // end anonymous namespace
+
+void materialize_reachable_functions(
+    llvm::Module& module, llvm::ArrayRef< std::string > entry_points) {
+  ReachableMaterializer materializer;
+
+  for (const std::string& name : entry_points) {
+    if (llvm::Function* fun = module.getFunction(name)) {
+      materializer.visit(fun);
+    }
+  }
+
+  for (llvm::GlobalVariable& gv : module.globals()) {
+    materializer.visit(&gv);
+  }
+
+  materializer.run();
+}
+
 // Importer
 
+namespace {
+
+/// \brief Compute the layout of all structures used in the given module
+///
+/// llvm::DataLayout caches structure layouts lazily, which is not thread-safe.
+void compute_struct_layouts(llvm::Module& module) {
+  const llvm::DataLayout& data_layout = module.getDataLayout();
+  llvm::TypeFinder types;
+  types.run(module, /*onlyNamed = */ false);
+  for (llvm::StructType* type : types) {
+    if (type->isSized()) {
+      data_layout.getStructLayout(type);
+    }
+  }
+}
+
+/// \brief Translate the given function bodies using several threads
+///
+/// Rethrows the first exception thrown by a thread.
+void translate_function_bodies(BundleImporter& bundle_imp,
+                               const std::vector< llvm::Function* >& functions,
+                               unsigned jobs) {
+  ar::parallel_for(functions.size(), jobs, [&](std::size_t i) {
+    bundle_imp.translate_function_body(functions[i]);
+  });
+}
+
+} // end anonymous namespace
+
 ar::Bundle* Importer::import(llvm::Module& module, ImportOptions opts) {
   ikos_assert_msg(has_debug_info(module), "no debug information");
 
@@ -122,10 +237,27 @@ ar::Bundle* Importer::import(llvm::Module& module, ImportOptions opts) {
   }
 
   // Translate all function bodies
+  //
+  // Functions that are not materialized are imported as external functions,
+  // see materialize_reachable_functions()
+  std::vector< llvm::Function* > functions;
   for (llvm::Function& fun : module) {
-    if (!fun.isDeclaration()) {
-      bundle_imp.translate_function_body(&fun);
+    if (!fun.isDeclaration() && !fun.isMaterializable()) {
+      functions.push_back(&fun);
+    }
+  }
+
+  unsigned jobs =
+      static_cast< unsigned >(std::min< std::size_t >(this->_jobs,
+                                                      functions.size()));
+  if (jobs <= 1) {
+    for (llvm::Function* fun : functions) {
+      bundle_imp.translate_function_body(fun);
     }
+  } else {
+    // Types, constants and declarations are shared, see ImportContext::mutex
+    compute_struct_layouts(module);
+    translate_function_bodies(bundle_imp, functions, jobs);
   }
 
   return bundle;
@@ -1484,12 +1484,30 @@ TypeMatcher::TypeMatcher(ImportContext& ctx)
 TypeMatcher::~TypeMatcher() {}
 
 bool TypeMatcher::match_type(llvm::Type* llvm_type, ar::Type* ar_type) {
-  return this->match_type(llvm_type, ar_type, ARTypeSet{});
+  ARTypeSet seen;
+  return this->match_type(llvm_type, ar_type, seen);
 }
 
 bool TypeMatcher::match_type(llvm::Type* llvm_type,
                              ar::Type* ar_type,
-                             ARTypeSet seen) {
+                             ARTypeSet& seen) {
+  auto it = this->_cache.find({llvm_type, ar_type});
+  if (it != this->_cache.end()) {
+    return it->second;
+  }
+
+  bool exact = seen.empty();
+  bool result = this->match_type_uncached(llvm_type, ar_type, seen);
+
+  if (exact || !result) {
+    this->_cache.try_emplace({llvm_type, ar_type}, result);
+  }
+  return result;
+}
+
+bool TypeMatcher::match_type_uncached(llvm::Type* llvm_type,
+                                      ar::Type* ar_type,
+                                      ARTypeSet& seen) {
   if (llvm_type->isVoidTy()) {
     return ar_type->is_void();
   } else if (llvm_type->isIntegerTy()) {
@@ -1543,7 +1561,7 @@ bool TypeMatcher::match_floating_point_type(llvm::Type* llvm_type,
 
 bool TypeMatcher::match_pointer_type(llvm::Type* llvm_type,
                                      ar::Type* ar_type,
-                                     ARTypeSet seen) {
+                                     ARTypeSet& seen) {
   if (!ar_type->is_pointer()) {
     return false;
   }
@@ -1556,7 +1574,7 @@ bool TypeMatcher::match_pointer_type(llvm::Type* llvm_type,
 
 bool TypeMatcher::match_array_type(llvm::Type* llvm_type,
                                    ar::Type* ar_type,
-                                   ARTypeSet seen) {
+                                   ARTypeSet& seen) {
   if (!ar_type->is_array()) {
     return false;
   }
@@ -1571,7 +1589,7 @@ bool TypeMatcher::match_array_type(llvm::Type* llvm_type,
 
 bool TypeMatcher::match_vector_type(llvm::Type* llvm_type,
                                     ar::Type* ar_type,
-                                    ARTypeSet seen) {
+                                    ARTypeSet& seen) {
   if (!ar_type->is_vector()) {
     return false;
   }
@@ -1586,7 +1604,7 @@ bool TypeMatcher::match_vector_type(llvm::Type* llvm_type,
 
 bool TypeMatcher::match_struct_type(llvm::Type* llvm_type,
                                     ar::Type* ar_type,
-                                    ARTypeSet seen) {
+                                    ARTypeSet& seen) {
   auto llvm_struct_type = llvm::cast< llvm::StructType >(llvm_type);
 
   if (llvm_struct_type->isOpaque()) {
@@ -1612,22 +1630,25 @@ bool TypeMatcher::match_struct_type(llvm::Type* llvm_type,
   const llvm::StructLayout* llvm_struct_layout =
       this->_llvm_data_layout.getStructLayout(llvm_struct_type);
 
+  bool result = true;
   auto it = ar_struct_type->field_begin();
   for (unsigned i = 0; i < llvm_struct_type->getNumElements(); ++i, ++it) {
     llvm::Type* llvm_element_type = llvm_struct_type->getElementType(i);
     uint64_t llvm_element_offset = llvm_struct_layout->getElementOffset(i);
     if (llvm_element_offset != it->offset ||
         !this->match_type(llvm_element_type, it->type, seen)) {
-      return false;
+      result = false;
+      break;
     }
   }
 
-  return true;
+  seen.erase({llvm_type, ar_type});
+  return result;
 }
 
 bool TypeMatcher::match_function_type(llvm::Type* llvm_type,
                                       ar::Type* ar_type,
-                                      ARTypeSet seen) {
+                                      ARTypeSet& seen) {
   auto llvm_fun_type = llvm::cast< llvm::FunctionType >(llvm_type);
 
   if (!ar_type->is_function()) {
@@ -1693,17 +1714,20 @@ bool TypeMatcher::match_extern_function_param_type(llvm::Type* llvm_type,
 }
 
 TypeImporter::TypeImporter(ImportContext& ctx)
-    : _type_sign_imp(ctx),
+    : _mutex(ctx.mutex),
+      _type_sign_imp(ctx),
       _type_di_imp(ctx, this->_type_sign_imp),
       _type_match(ctx) {}
 
 ar::Type* TypeImporter::translate_type(llvm::Type* type,
                                        ar::Signedness preferred) {
+  std::lock_guard< std::recursive_mutex > lock(this->_mutex);
   return this->_type_sign_imp.translate_type(type, preferred);
 }
 
 ar::Type* TypeImporter::translate_type(llvm::Type* type,
                                        llvm::DIType* di_type) {
+  std::lock_guard< std::recursive_mutex > lock(this->_mutex);
   TypeWithDebugInfoImporter imp = this->_type_di_imp.fork();
   ar::Type* ar_type = imp.translate_type(type, di_type);
   this->_type_di_imp.join(imp);
@@ -1712,6 +1736,7 @@ ar::Type* TypeImporter::translate_type(llvm::Type* type,
 
 ar::FunctionType* TypeImporter::translate_function_type(
     llvm::Function* fun, llvm::DISubroutineType* di_type) {
+  std::lock_guard< std::recursive_mutex > lock(this->_mutex);
   TypeWithDebugInfoImporter imp = this->_type_di_imp.fork();
   ar::FunctionType* ar_type = imp.translate_function_di_type(fun, di_type);
   this->_type_di_imp.join(imp);
@@ -1719,11 +1744,13 @@ ar::FunctionType* TypeImporter::translate_function_type(
 }
 
 bool TypeImporter::match_type(llvm::Type* llvm_type, ar::Type* ar_type) {
+  std::lock_guard< std::recursive_mutex > lock(this->_mutex);
   return this->_type_match.match_type(llvm_type, ar_type);
 }
 
 bool TypeImporter::match_extern_function_type(llvm::FunctionType* llvm_type,
                                               ar::FunctionType* ar_type) {
+  std::lock_guard< std::recursive_mutex > lock(this->_mutex);
   return this->_type_match.match_extern_function_type(llvm_type, ar_type);
 }
 
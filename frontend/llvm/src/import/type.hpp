@@ -335,6 +335,12 @@ private:
   // LLVM data layout
   const llvm::DataLayout& _llvm_data_layout;
 
+  // Cache of exact results
+  //
+  // A result is exact if it is false, or if it was computed without assuming
+  // that a structure currently being processed matches.
+  llvm::DenseMap< std::pair< llvm::Type*, ar::Type* >, bool > _cache;
+
 public:
   /// \brief Public constructor
   explicit TypeMatcher(ImportContext& ctx);
@@ -367,7 +373,12 @@ private:
       boost::container::flat_set< std::pair< llvm::Type*, ar::Type* > >;
 
   /// \brief Check whether a llvm::Type matches an ar::Type
-  bool match_type(llvm::Type*, ar::Type*, ARTypeSet);
+  ///
+  /// `seen` holds the structures currently being processed.
+  bool match_type(llvm::Type*, ar::Type*, ARTypeSet& seen);
+
+  /// \brief Check whether a llvm::Type matches an ar::Type, without cache
+  bool match_type_uncached(llvm::Type*, ar::Type*, ARTypeSet&);
 
   /// \brief Check whether a llvm::IntegerType matches an ar::Type
   bool match_integer_type(llvm::Type*, ar::Type*);
@@ -376,19 +387,19 @@ private:
   bool match_floating_point_type(llvm::Type*, ar::Type*);
 
   /// \brief Check whether a llvm::PointerType matches an ar::Type
-  bool match_pointer_type(llvm::Type*, ar::Type*, ARTypeSet);
+  bool match_pointer_type(llvm::Type*, ar::Type*, ARTypeSet&);
 
   /// \brief Check whether a llvm::ArrayType matches an ar::Type
-  bool match_array_type(llvm::Type*, ar::Type*, ARTypeSet);
+  bool match_array_type(llvm::Type*, ar::Type*, ARTypeSet&);
 
   /// \brief Check whether a llvm::VectorType matches an ar::Type
-  bool match_vector_type(llvm::Type*, ar::Type*, ARTypeSet);
+  bool match_vector_type(llvm::Type*, ar::Type*, ARTypeSet&);
 
   /// \brief Check whether a llvm::StructType matches an ar::Type
-  bool match_struct_type(llvm::Type*, ar::Type*, ARTypeSet);
+  bool match_struct_type(llvm::Type*, ar::Type*, ARTypeSet&);
 
   /// \brief Check whether a llvm::FunctionType matches an ar::Type
-  bool match_function_type(llvm::Type*, ar::Type*, ARTypeSet);
+  bool match_function_type(llvm::Type*, ar::Type*, ARTypeSet&);
 
 public:
   /// \brief Check whether an extern llvm::FunctionType matches an
@@ -414,6 +425,9 @@ private:
 /// \brief Helper class to translate types
 class TypeImporter {
 private:
+  // Mutex of the import context
+  std::recursive_mutex& _mutex;
+
   // Helper class to translate types with a given signedness
   TypeWithSignImporter _type_sign_imp;
 
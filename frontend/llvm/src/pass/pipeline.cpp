@@ -0,0 +1,288 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Preprocessing pipeline of ikos-pp
+ *
+ * Author: Maxime Arthaud
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2011-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <llvm/ADT/StringSet.h>
+#include <llvm/IR/GlobalValue.h>
+#include <llvm/Transforms/IPO.h>
+#include <llvm/Transforms/IPO/AlwaysInliner.h>
+#include <llvm/Transforms/InstCombine/InstCombine.h>
+#include <llvm/Transforms/Scalar.h>
+#include <llvm/Transforms/Scalar/GVN.h>
+#include <llvm/Transforms/Utils.h>
+#include <llvm/Transforms/Utils/UnifyFunctionExitNodes.h>
+
+#include <ikos/frontend/llvm/pass.hpp>
+
+namespace ikos {
+namespace frontend {
+namespace pass {
+
+/// \brief Add the passes internalizing everything but the entry points, and
+/// removing the dead globals
+static void addInternalizePasses(llvm::legacy::PassManagerBase& pass_manager,
+                                 llvm::ArrayRef< std::string > entry_points) {
+  // Turn all functions internal so that we can apply some global
+  // optimizations inline them if requested (opt -internalize)
+  llvm::StringSet<> exclude_set;
+  if (entry_points.empty()) {
+    exclude_set.insert("main");
+  } else {
+    for (const auto& entry_point : entry_points) {
+      exclude_set.insert(entry_point);
+    }
+  }
+  if (exclude_set.count("*") == 0) {
+    pass_manager.add(
+        llvm::createInternalizePass([=](const llvm::GlobalValue& gv) {
+          return exclude_set.find(gv.getName()) != exclude_set.end();
+        }));
+  }
+
+  // Kill unused internal global (opt -globaldce)
+  // note: unfortunately, it removes some debug info about global variables
+  pass_manager.add(llvm::createGlobalDCEPass());
+
+  // Pass the pointer parameters of internal functions by value, when only
+  // loaded (opt -argpromotion)
+  pass_manager.add(llvm::createArgumentPromotionPass());
+}
+
+void addPreprocessingPasses(llvm::legacy::PassManagerBase& pass_manager,
+                            OptLevel opt_level,
+                            llvm::ArrayRef< std::string > entry_points,
+                            bool inline_all,
+                            bool internalize) {
+  if (opt_level == OptLevel::None) {
+    // Remove switch constructions (opt -lowerswitch)
+    pass_manager.add(llvm::createLowerSwitchPass());
+
+    // Lower down atomic instructions (opt -loweratomic)
+    pass_manager.add(llvm::createLowerAtomicPass());
+
+    // Lower constant expressions to instructions (ikos-pp -lower-cst-expr)
+    pass_manager.add(createLowerCstExprPass());
+
+    // Lower down select instructions (ikos-pp -lower-select)
+    pass_manager.add(createLowerSelectPass());
+
+    // Ensure one single exit point per function (opt -mergereturn)
+    pass_manager.add(llvm::createUnifyFunctionExitNodesPass());
+  } else if (opt_level == OptLevel::Basic) {
+    // SSA (opt -mem2reg)
+    pass_manager.add(llvm::createPromoteMemoryToRegisterPass());
+
+    if (internalize) {
+      // Remove the code unreachable from the entry points
+      addInternalizePasses(pass_manager, entry_points);
+    }
+
+    // MarkNoReturnFunctions only insert unreachable instructions if
+    // the function does not have an exit block
+    pass_manager.add(createMarkNoReturnFunctionPass());
+
+    // Global dead code elimination (opt -globaldce)
+    // note: unfortunately, it removes some debug info about global variables
+    pass_manager.add(llvm::createGlobalDCEPass());
+
+    // Dead code elimination (opt -dce)
+    pass_manager.add(llvm::createDeadCodeEliminationPass());
+
+    // Remove unreachable blocks also dead cycles
+    pass_manager.add(createRemoveUnreachableBlocksPass());
+
+    // Remove switch constructions (opt -lowerswitch)
+    pass_manager.add(llvm::createLowerSwitchPass());
+
+    // Lower down atomic instructions (opt -loweratomic)
+    pass_manager.add(llvm::createLowerAtomicPass());
+
+    // Lower constant expressions to instructions (ikos-pp -lower-cst-expr)
+    pass_manager.add(createLowerCstExprPass());
+
+    // Dead code elimination (opt -dce)
+    pass_manager.add(llvm::createDeadCodeEliminationPass());
+
+    // Lower down select instructions (ikos-pp -lower-select)
+    pass_manager.add(createLowerSelectPass());
+
+    // Ensure one single exit point per function (opt -mergereturn)
+    pass_manager.add(llvm::createUnifyFunctionExitNodesPass());
+  } else if (opt_level == OptLevel::Aggressive) {
+    // Internalize everything but the entry points, and remove the dead
+    // globals (opt -internalize -globaldce -argpromotion)
+    addInternalizePasses(pass_manager, entry_points);
+
+    // Remove unreachable blocks
+    pass_manager.add(createRemoveUnreachableBlocksPass());
+
+    // Global optimizations (opt -globalopt)
+    pass_manager.add(llvm::createGlobalOptimizerPass());
+
+    // SSA (opt -mem2reg)
+    pass_manager.add(llvm::createPromoteMemoryToRegisterPass());
+
+    // Cleanup after SSA (opt -instcombine)
+    // disabled, bad for static analysis
+    // pass_manager.add(llvm::createInstructionCombiningPass());
+
+    // Simplification (opt -simplifycfg)
+    pass_manager.add(llvm::createCFGSimplificationPass());
+
+    // Break aggregates (opt -sroa)
+    pass_manager.add(llvm::createSROAPass());
+
+    // Global value numbering and redundant load elimination (opt -gvn)
+    // note: unfortunately, it removes some debug information
+    pass_manager.add(llvm::createGVNPass());
+
+    // Cleanup after breaking aggregates (opt -instcombine)
+    // (bad for static analysis)
+    pass_manager.add(llvm::createInstructionCombiningPass());
+
+    // Global dead code elimination (opt -globaldce)
+    pass_manager.add(llvm::createGlobalDCEPass());
+
+    // Simplification (opt -simplifycfg)
+    pass_manager.add(llvm::createCFGSimplificationPass());
+
+    // Jump threading (opt -jump-threading)
+    // (conditional) constant propagation always help analyzers
+    pass_manager.add(llvm::createJumpThreadingPass());
+
+    // Sparse conditional constant propagation (opt -sccp)
+    pass_manager.add(llvm::createSCCPPass());
+
+    // Dead code elimination (opt -dce)
+    pass_manager.add(llvm::createDeadCodeEliminationPass());
+
+    // Lower invoke's (opt -lowerinvoke)
+    pass_manager.add(llvm::createLowerInvokePass());
+
+    // Cleanup after lowering invoke's (opt -simplifycfg)
+    pass_manager.add(llvm::createCFGSimplificationPass());
+
+    if (inline_all) {
+      // Mark all functions always_inline (ikos-pp -mark-internal-inline)
+      pass_manager.add(createMarkInternalInlinePass());
+
+      // Inline always_inline functions (opt -always-inline)
+      pass_manager.add(llvm::createAlwaysInlinerLegacyPass());
+
+      // Kill unused internal global (opt -globaldce)
+      pass_manager.add(llvm::createGlobalDCEPass());
+    }
+
+    // Remove unreachable blocks
+    pass_manager.add(createRemoveUnreachableBlocksPass());
+
+    // Dead instruction elimination (opt -die)
+    pass_manager.add(llvm::createDeadInstEliminationPass());
+
+    // Canonical form for loops (opt -loop-simplify)
+    pass_manager.add(llvm::createLoopSimplifyPass());
+
+    // Cleanup unnecessary blocks (opt -simplifycfg)
+    pass_manager.add(llvm::createCFGSimplificationPass());
+
+    // Loop-closed SSA (opt -lcssa)
+    pass_manager.add(llvm::createLCSSAPass());
+
+    // Loop invariant code motion (opt -licm)
+    pass_manager.add(llvm::createLICMPass());
+
+    // SSA (opt -mem2reg)
+    pass_manager.add(llvm::createPromoteMemoryToRegisterPass());
+
+    // Dead loop elimination (opt -loop-deletion)
+    pass_manager.add(llvm::createLoopDeletionPass());
+
+    // Cleanup unnecessary blocks (opt -simplifycfg)
+    pass_manager.add(llvm::createCFGSimplificationPass());
+
+    // MarkNoReturnFunctions only insert unreachable instructions if
+    // the function does not have an exit block.
+    pass_manager.add(createMarkNoReturnFunctionPass());
+
+    // Global dead code elimination (opt -globaldce)
+    pass_manager.add(llvm::createGlobalDCEPass());
+
+    // Dead code elimination (opt -dce)
+    pass_manager.add(llvm::createDeadCodeEliminationPass());
+
+    // Remove unreachable blocks also dead cycles
+    pass_manager.add(createRemoveUnreachableBlocksPass());
+
+    // Remove switch constructions (opt -lowerswitch)
+    pass_manager.add(llvm::createLowerSwitchPass());
+
+    // Lower down atomic instructions (opt -loweratomic)
+    pass_manager.add(llvm::createLowerAtomicPass());
+
+    // Lower constant expressions to instructions (ikos-pp -lower-cst-expr)
+    pass_manager.add(createLowerCstExprPass());
+
+    // Dead code elimination (opt -dce)
+    pass_manager.add(llvm::createDeadCodeEliminationPass());
+
+    // After lowering constant expressions we remove all
+    // side-effect-free printf-like functions. This can trigger the
+    // removal of global strings that only feed them.
+    pass_manager.add(createRemovePrintfCallsPass());
+
+    // Dead code elimination (opt -dce)
+    pass_manager.add(llvm::createDeadCodeEliminationPass());
+
+    // Global dead code elimination (opt -globaldce)
+    pass_manager.add(llvm::createGlobalDCEPass());
+
+    // Lower down select instructions (ikos-pp -lower-select)
+    pass_manager.add(createLowerSelectPass());
+
+    // Ensure one single exit point per function (opt -mergereturn)
+    pass_manager.add(llvm::createUnifyFunctionExitNodesPass());
+  }
+}
+
+} // end namespace pass
+} // end namespace frontend
+} // end namespace ikos